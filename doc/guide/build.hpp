@@ -133,6 +133,9 @@ The full list of options mlpack allows:
  - ARMA_EXTRA_DEBUG=(ON/OFF): compile with extra Armadillo debugging symbols
        (default OFF)
  - BUILD_TESTS=(ON/OFF): compile the \c mlpack_test program (default ON)
+ - BUILD_BENCHMARKS=(ON/OFF): compile the \c mlpack_benchmarks program, which
+       requires Google Benchmark; the \c run_benchmarks target runs it and
+       writes the results to \c benchmarks.json (default OFF)
  - BUILD_CLI_EXECUTABLES=(ON/OFF): compile the mlpack command-line executables
        (i.e. \c mlpack_knn, \c mlpack_kfn, \c mlpack_logistic_regression, etc.)
        (default ON)
@@ -0,0 +1,123 @@
+/**
+ * @file ann_layer_benchmark.cpp
+ *
+ * Benchmarks of the forward and backward passes of the layers of the neural
+ * networks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+using namespace mlpack::ann;
+
+/**
+ * Time the forward pass of the given layer on a batch of random inputs,
+ * followed by the backward pass of a random error.
+ *
+ * @param state The benchmark state.
+ * @param layer The layer to run, with its parameters set.
+ * @param inputSize The number of elements of each input.
+ * @param batchSize The number of inputs of the batch.
+ */
+template<typename LayerType>
+static void ForwardBackward(benchmark::State& state,
+                            LayerType& layer,
+                            const size_t inputSize,
+                            const size_t batchSize)
+{
+  const arma::mat input = arma::randu<arma::mat>(inputSize, batchSize);
+  arma::mat output, delta;
+
+  // Run the forward pass once to get the size of the output.
+  layer.Forward(std::move(input), std::move(output));
+  arma::mat error = arma::randu<arma::mat>(arma::size(output));
+
+  for (auto _ : state)
+  {
+    layer.Forward(std::move(input), std::move(output));
+    layer.Backward(std::move(output), std::move(error), std::move(delta));
+    benchmark::DoNotOptimize(delta.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+/**
+ * Benchmark a Linear layer.  The arguments are the input size, the output size
+ * and the batch size.
+ */
+static void LinearLayer(benchmark::State& state)
+{
+  Linear<> layer(state.range(0), state.range(1));
+  layer.Parameters().randu();
+  layer.Reset();
+  ForwardBackward(state, layer, state.range(0), state.range(2));
+}
+
+BENCHMARK(LinearLayer)->Args({ 256, 256, 64 })->Args({ 1024, 1024, 64 })
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Benchmark an activation layer.  The arguments are the input size and the
+ * batch size.
+ */
+template<typename LayerType>
+static void ActivationLayer(benchmark::State& state)
+{
+  LayerType layer;
+  ForwardBackward(state, layer, state.range(0), state.range(1));
+}
+
+BENCHMARK_TEMPLATE(ActivationLayer, SigmoidLayer<>)->Args({ 1024, 64 })
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(ActivationLayer, TanHLayer<>)->Args({ 1024, 64 })
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(ActivationLayer, ReLULayer<>)->Args({ 1024, 64 })
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(ActivationLayer, LogSoftMax<>)->Args({ 1024, 64 })
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(ActivationLayer, Dropout<>)->Args({ 1024, 64 })
+    ->Unit(benchmark::kMicrosecond);
+
+/**
+ * Benchmark a Convolution layer with 3x3 filters and padding.  The arguments
+ * are the width (and height) of the input, the number of input maps, the
+ * number of output maps and the batch size.
+ */
+static void ConvolutionLayer(benchmark::State& state)
+{
+  const size_t size = state.range(0);
+  Convolution<> layer(state.range(1), state.range(2), 3, 3, 1, 1, 1, 1, size,
+      size);
+  layer.Parameters().randu();
+  layer.Reset();
+  ForwardBackward(state, layer, size * size * state.range(1),
+      state.range(3));
+}
+
+BENCHMARK(ConvolutionLayer)->Args({ 28, 1, 16, 16 })->Args({ 14, 16, 32, 16 })
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Benchmark a MaxPooling layer with 2x2 windows.  The arguments are the width
+ * (and height) of the input, the number of input maps and the batch size.
+ */
+static void MaxPoolingLayer(benchmark::State& state)
+{
+  const size_t size = state.range(0);
+  MaxPooling<> layer(2, 2, 2, 2);
+  layer.InputWidth() = size;
+  layer.InputHeight() = size;
+  ForwardBackward(state, layer, size * size * state.range(1),
+      state.range(2));
+}
+
+BENCHMARK(MaxPoolingLayer)->Args({ 28, 16, 16 })
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,34 @@
+/**
+ * @file benchmark_main.cpp
+ *
+ * Entry point of the mlpack benchmarks.  The benchmarks are written with
+ * Google Benchmark, so all of its options are available; for instance,
+ *
+ * @code
+ * $ mlpack_benchmarks --benchmark_filter=KDTree \
+ *       --benchmark_out=results.json --benchmark_out_format=json
+ * @endcode
+ *
+ * runs the benchmarks of kd-trees and writes their results in JSON.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#include <benchmark/benchmark.h>
+
+int main(int argc, char** argv)
+{
+  // Use the same data for each run, so that results can be compared.
+  mlpack::math::RandomSeed(42);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file gmm_benchmark.cpp
+ *
+ * Benchmarks of the training of Gaussian mixture models with EMFit.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/gmm/diagonal_constraint.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+using namespace mlpack::gmm;
+
+/**
+ * Fit a GMM with ten iterations of EM to points drawn around random centers.
+ * The initial model is given by k-means, which is timed too.  The arguments
+ * are the number of points, their dimensionality and the number of Gaussians.
+ */
+template<typename CovarianceConstraintPolicy>
+static void EMFitTrain(benchmark::State& state)
+{
+  const size_t points = state.range(0);
+  const size_t dimensionality = state.range(1);
+  const size_t gaussians = state.range(2);
+
+  const arma::mat centers = 10 * arma::randu<arma::mat>(dimensionality,
+      gaussians);
+  arma::mat data = arma::randn<arma::mat>(dimensionality, points);
+  for (size_t i = 0; i < points; ++i)
+    data.col(i) += centers.col(i % gaussians);
+
+  typedef EMFit<kmeans::KMeans<>, CovarianceConstraintPolicy> FitterType;
+  for (auto _ : state)
+  {
+    GMM gmm(gaussians, dimensionality);
+    benchmark::DoNotOptimize(gmm.Train(data, 1, false,
+        FitterType(10, 1e-10, kmeans::KMeans<>(10))));
+  }
+
+  state.SetItemsProcessed(state.iterations() * points);
+}
+
+BENCHMARK_TEMPLATE(EMFitTrain, PositiveDefiniteConstraint)
+    ->Args({ 10000, 5, 5 })->Args({ 10000, 20, 10 })
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(EMFitTrain, DiagonalConstraint)
+    ->Args({ 10000, 5, 5 })->Args({ 10000, 20, 10 })
+    ->Unit(benchmark::kMillisecond);
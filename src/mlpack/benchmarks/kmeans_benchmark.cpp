@@ -0,0 +1,67 @@
+/**
+ * @file kmeans_benchmark.cpp
+ *
+ * Benchmarks of the Lloyd iterations of k-means, for each step type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/elkan_kmeans.hpp>
+#include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
+#include <mlpack/methods/kmeans/naive_kmeans.hpp>
+#include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+using namespace mlpack::kmeans;
+
+/**
+ * Run ten Lloyd iterations of k-means on points drawn around random centers,
+ * starting from the same centroids each time.  The arguments are the number of
+ * points, their dimensionality and the number of clusters.
+ */
+template<template<typename, typename> class LloydStepType>
+static void KMeansIterations(benchmark::State& state)
+{
+  const size_t points = state.range(0);
+  const size_t dimensionality = state.range(1);
+  const size_t clusters = state.range(2);
+
+  const arma::mat centers = 10 * arma::randu<arma::mat>(dimensionality,
+      clusters);
+  arma::mat data = arma::randn<arma::mat>(dimensionality, points);
+  for (size_t i = 0; i < points; ++i)
+    data.col(i) += centers.col(i % clusters);
+  const arma::mat initialCentroids = data.cols(0, clusters - 1);
+
+  KMeans<metric::EuclideanDistance, SampleInitialization,
+      MaxVarianceNewCluster, LloydStepType> kmeans(10);
+  arma::mat centroids;
+  for (auto _ : state)
+  {
+    centroids = initialCentroids;
+    kmeans.Cluster(data, clusters, centroids, true);
+    benchmark::DoNotOptimize(centroids.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * 10 * points);
+}
+
+BENCHMARK_TEMPLATE(KMeansIterations, NaiveKMeans)
+    ->Args({ 100000, 10, 20 })->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansIterations, ElkanKMeans)
+    ->Args({ 100000, 10, 20 })->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansIterations, HamerlyKMeans)
+    ->Args({ 100000, 10, 20 })->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansIterations, PellegMooreKMeans)
+    ->Args({ 100000, 10, 20 })->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansIterations, DefaultDualTreeKMeans)
+    ->Args({ 100000, 10, 20 })->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(KMeansIterations, CoverTreeDualTreeKMeans)
+    ->Args({ 100000, 10, 20 })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,70 @@
+/**
+ * @file load_save_benchmark.cpp
+ *
+ * Benchmarks of data::Load() and data::Save() for matrices, in text and
+ * binary formats.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <cstdio>
+
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+
+/**
+ * Load a matrix of uniform random values from a file of the format given by
+ * the extension.  The file is written beforehand, in the working directory.
+ * The arguments are the number of points and their dimensionality.
+ */
+static void LoadMatrix(benchmark::State& state, const std::string& extension)
+{
+  const std::string filename = "mlpack_benchmark_load" + extension;
+  const arma::mat data = arma::randu<arma::mat>(state.range(1),
+      state.range(0));
+  data::Save(filename, data, true);
+
+  arma::mat loaded;
+  for (auto _ : state)
+  {
+    data::Load(filename, loaded, true);
+    benchmark::DoNotOptimize(loaded.memptr());
+  }
+
+  state.SetBytesProcessed(state.iterations() * data.n_elem * sizeof(double));
+  std::remove(filename.c_str());
+}
+
+BENCHMARK_CAPTURE(LoadMatrix, csv, std::string(".csv"))
+    ->Args({ 100000, 10 })->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(LoadMatrix, txt, std::string(".txt"))
+    ->Args({ 100000, 10 })->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(LoadMatrix, arma_binary, std::string(".bin"))
+    ->Args({ 100000, 10 })->Unit(benchmark::kMillisecond);
+
+/**
+ * Save a matrix of uniform random values to a file of the format given by the
+ * extension, in the working directory.  The arguments are the number of
+ * points and their dimensionality.
+ */
+static void SaveMatrix(benchmark::State& state, const std::string& extension)
+{
+  const std::string filename = "mlpack_benchmark_save" + extension;
+  const arma::mat data = arma::randu<arma::mat>(state.range(1),
+      state.range(0));
+
+  for (auto _ : state)
+    data::Save(filename, data, true);
+
+  state.SetBytesProcessed(state.iterations() * data.n_elem * sizeof(double));
+  std::remove(filename.c_str());
+}
+
+BENCHMARK_CAPTURE(SaveMatrix, csv, std::string(".csv"))
+    ->Args({ 100000, 10 })->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(SaveMatrix, arma_binary, std::string(".bin"))
+    ->Args({ 100000, 10 })->Unit(benchmark::kMillisecond);
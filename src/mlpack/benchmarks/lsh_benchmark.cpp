@@ -0,0 +1,67 @@
+/**
+ * @file lsh_benchmark.cpp
+ *
+ * Benchmarks of the training of LSHSearch and of approximate nearest neighbor
+ * search with it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/lsh/lsh_search.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * Build the hash tables of LSHSearch on uniform random points.  The arguments
+ * are the number of points, their dimensionality, the number of projections
+ * and the number of tables.
+ */
+static void LSHTrain(benchmark::State& state)
+{
+  const arma::mat reference = arma::randu<arma::mat>(state.range(1),
+      state.range(0));
+
+  for (auto _ : state)
+  {
+    LSHSearch<> lsh(reference, state.range(2), state.range(3));
+    benchmark::DoNotOptimize(lsh.SecondHashTable().memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * reference.n_cols);
+}
+
+BENCHMARK(LSHTrain)->Args({ 100000, 10, 10, 30 })
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Find the approximate k nearest neighbors of uniform random query points
+ * among uniform random reference points.  The arguments are the number of
+ * reference points, the number of query points, their dimensionality and k.
+ */
+static void LSHSearchQuery(benchmark::State& state)
+{
+  const arma::mat reference = arma::randu<arma::mat>(state.range(2),
+      state.range(0));
+  const arma::mat query = arma::randu<arma::mat>(state.range(2),
+      state.range(1));
+
+  LSHSearch<> lsh(reference, 10, 30);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  for (auto _ : state)
+  {
+    lsh.Search(query, state.range(3), neighbors, distances);
+    benchmark::DoNotOptimize(distances.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * query.n_cols);
+}
+
+BENCHMARK(LSHSearchQuery)->Args({ 100000, 10000, 10, 5 })
+    ->Unit(benchmark::kMillisecond);
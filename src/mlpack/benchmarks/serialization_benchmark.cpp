@@ -0,0 +1,93 @@
+/**
+ * @file serialization_benchmark.cpp
+ *
+ * Benchmarks of the serialization of models and matrices with
+ * boost::serialization archives.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/xml_iarchive.hpp>
+#include <boost/archive/xml_oarchive.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+using namespace boost::archive;
+
+//! Build a matrix of the given number of random points.
+static void BuildModel(arma::mat& model, const size_t points)
+{
+  model = arma::randu<arma::mat>(10, points);
+}
+
+//! Build a k-nearest-neighbor model, with its kd-tree, on random points.
+static void BuildModel(neighbor::KNN& model, const size_t points)
+{
+  model.Train(arma::randu<arma::mat>(10, points));
+}
+
+//! Build a GMM with ten Gaussians on random points.
+static void BuildModel(gmm::GMM& model, const size_t points)
+{
+  model = gmm::GMM(10, 10);
+  model.Train(arma::randu<arma::mat>(10, points), 1, false,
+      gmm::EMFit<>(5, 1e-10, kmeans::KMeans<>(5)));
+}
+
+/**
+ * Save a model to an archive in memory, and load it back.  The size of the
+ * archive is reported in the "bytes" counter.  The argument is the number of
+ * points the model is built on.
+ */
+template<typename ModelType, typename OArchiveType, typename IArchiveType>
+static void SerializeModel(benchmark::State& state)
+{
+  ModelType model;
+  BuildModel(model, state.range(0));
+
+  size_t bytes = 0;
+  for (auto _ : state)
+  {
+    std::stringstream stream;
+    {
+      OArchiveType ar(stream);
+      ar << BOOST_SERIALIZATION_NVP(model);
+    }
+    bytes = stream.str().size();
+
+    ModelType loaded;
+    {
+      IArchiveType ar(stream);
+      ar >> BOOST_SERIALIZATION_NVP(loaded);
+    }
+    benchmark::DoNotOptimize(&loaded);
+  }
+
+  state.counters["bytes"] = bytes;
+}
+
+BENCHMARK_TEMPLATE(SerializeModel, arma::mat, binary_oarchive,
+    binary_iarchive)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(SerializeModel, arma::mat, text_oarchive, text_iarchive)
+    ->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(SerializeModel, arma::mat, xml_oarchive, xml_iarchive)
+    ->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(SerializeModel, neighbor::KNN, binary_oarchive,
+    binary_iarchive)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(SerializeModel, neighbor::KNN, xml_oarchive, xml_iarchive)
+    ->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(SerializeModel, gmm::GMM, binary_oarchive,
+    binary_iarchive)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(SerializeModel, gmm::GMM, xml_oarchive, xml_iarchive)
+    ->Arg(10000)->Unit(benchmark::kMillisecond);
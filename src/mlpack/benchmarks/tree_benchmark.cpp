@@ -0,0 +1,91 @@
+/**
+ * @file tree_benchmark.cpp
+ *
+ * Benchmarks of the construction of kd-trees and cover trees, and of
+ * nearest neighbor search with them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include <benchmark/benchmark.h>
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+/**
+ * Build a tree on uniform random points.  The arguments are the number of
+ * points and their dimensionality.
+ */
+template<template<typename, typename, typename> class TreeType>
+static void TreeBuild(benchmark::State& state)
+{
+  const arma::mat data = arma::randu<arma::mat>(state.range(1),
+      state.range(0));
+
+  typedef TreeType<metric::EuclideanDistance, tree::EmptyStatistic, arma::mat>
+      Tree;
+  for (auto _ : state)
+  {
+    Tree tree(data);
+    benchmark::DoNotOptimize(tree.NumDescendants());
+  }
+
+  state.SetItemsProcessed(state.iterations() * data.n_cols);
+}
+
+BENCHMARK_TEMPLATE(TreeBuild, tree::KDTree)
+    ->Args({ 10000, 3 })->Args({ 100000, 3 })->Args({ 10000, 30 })
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(TreeBuild, tree::StandardCoverTree)
+    ->Args({ 10000, 3 })->Args({ 100000, 3 })->Args({ 10000, 30 })
+    ->Unit(benchmark::kMillisecond);
+
+/**
+ * Find the k nearest neighbors of uniform random query points among uniform
+ * random reference points, with dual-tree or single-tree search.  The
+ * reference tree is built beforehand; the query tree is built by each search.
+ * The arguments are the number of reference points, the number of query
+ * points, their dimensionality and k.
+ */
+template<template<typename, typename, typename> class TreeType,
+         NeighborSearchMode Mode>
+static void TreeSearch(benchmark::State& state)
+{
+  const arma::mat reference = arma::randu<arma::mat>(state.range(2),
+      state.range(0));
+  const arma::mat query = arma::randu<arma::mat>(state.range(2),
+      state.range(1));
+  const size_t k = state.range(3);
+
+  NeighborSearch<NearestNeighborSort, metric::EuclideanDistance, arma::mat,
+      TreeType> knn(reference, Mode);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  for (auto _ : state)
+  {
+    knn.Search(query, k, neighbors, distances);
+    benchmark::DoNotOptimize(distances.memptr());
+  }
+
+  state.SetItemsProcessed(state.iterations() * query.n_cols);
+}
+
+BENCHMARK_TEMPLATE(TreeSearch, tree::KDTree, DUAL_TREE_MODE)
+    ->Args({ 100000, 10000, 3, 5 })->Args({ 10000, 10000, 30, 5 })
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(TreeSearch, tree::KDTree, SINGLE_TREE_MODE)
+    ->Args({ 100000, 10000, 3, 5 })->Args({ 10000, 10000, 30, 5 })
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(TreeSearch, tree::StandardCoverTree, DUAL_TREE_MODE)
+    ->Args({ 100000, 10000, 3, 5 })->Args({ 10000, 10000, 30, 5 })
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(TreeSearch, tree::StandardCoverTree, SINGLE_TREE_MODE)
+    ->Args({ 100000, 10000, 3, 5 })->Args({ 10000, 10000, 30, 5 })
+    ->Unit(benchmark::kMillisecond);
@@ -30,6 +30,8 @@
 #include "get_printable_param_value.hpp"
 #include "get_allocated_memory.hpp"
 #include "delete_allocated_memory.hpp"
+#include "load_param.hpp"
+#include "save_param.hpp"
 
 namespace mlpack {
 namespace bindings {
@@ -160,6 +162,8 @@ class CLIOption
         &GetAllocatedMemory<N>;
     CLI::GetSingleton().functionMap[tname]["DeleteAllocatedMemory"] =
         &DeleteAllocatedMemory<N>;
+    CLI::GetSingleton().functionMap[tname]["StartLoading"] = &StartLoading<N>;
+    CLI::GetSingleton().functionMap[tname]["StartSaving"] = &StartSaving<N>;
   }
 };
 
@@ -14,6 +14,10 @@
 #define MLPACK_BINDINGS_CLI_END_PROGRAM_HPP
 
 #include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/async_log_sink.hpp>
+
+#include <fstream>
+#include <future>
 
 namespace mlpack {
 namespace bindings {
@@ -25,22 +29,42 @@ namespace cli {
  */
 inline void EndProgram()
 {
-  // Stop the CLI timers.
+  // Make sure that no input is still being loaded, then stop the CLI timers.
+  CLI::WaitForPendingLoads();
   CLI::GetSingleton().timer.StopAllTimers();
 
-  // Print any output.
+  // Save the output files concurrently in the background, and print the other
+  // outputs once they are saved.
   const std::map<std::string, util::ParamData>& parameters = CLI::Parameters();
   std::map<std::string, util::ParamData>::const_iterator it =
       parameters.begin();
+  std::vector<std::future<void>> saves;
+  std::vector<const util::ParamData*> printed;
   while (it != parameters.end())
   {
     const util::ParamData& d = it->second;
     if (!d.input)
-      CLI::GetSingleton().functionMap[d.tname]["OutputParam"](d, NULL, NULL);
+    {
+      std::future<void> save;
+      CLI::GetSingleton().functionMap[d.tname]["StartSaving"](d, NULL,
+          (void*) &save);
+      if (save.valid())
+        saves.push_back(std::move(save));
+      else
+        printed.push_back(&d);
+    }
 
     ++it;
   }
 
+  for (size_t i = 0; i < saves.size(); ++i)
+    saves[i].get();
+  for (size_t i = 0; i < printed.size(); ++i)
+  {
+    CLI::GetSingleton().functionMap[printed[i]->tname]["OutputParam"](
+        *printed[i], NULL, NULL);
+  }
+
   if (CLI::HasParam("verbose"))
   {
     Log::Info << std::endl << "Execution parameters:" << std::endl;
@@ -71,8 +95,28 @@ inline void EndProgram()
       Log::Info << "  " << it2.first << ": ";
       CLI::GetSingleton().timer.PrintTimer(it2.first);
     }
+
+    if (!Timer::Statistics().empty())
+    {
+      Log::Info << "Scoped timers:" << std::endl;
+      CLI::GetSingleton().timer.PrintStatistics();
+    }
+  }
+
+  if (CLI::HasParam("timers_file"))
+  {
+    const std::string timersFile = CLI::GetParam<std::string>("timers_file");
+    std::ofstream stream(timersFile);
+    if (stream.is_open())
+      Timer::WriteJSON(stream);
+    else
+      Log::Warn << "Cannot open '" << timersFile << "' to write the timers."
+          << std::endl;
   }
 
+  // Write any log messages still held by the asynchronous sink.
+  util::AsyncLogSink::Stop();
+
   // Lastly clean up any memory.  If we are holding any pointers, then we "own"
   // them.  But we may hold the same pointer twice, so we have to be careful to
   // not delete it multiple times.
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "parameter_type.hpp"
+#include "load_param.hpp"
 
 namespace mlpack {
 namespace bindings {
@@ -50,19 +51,18 @@ T& GetParam(
   // If the matrix is an input matrix, we have to load the matrix.  'value'
   // contains the filename.  It's possible we could load empty matrices many
   // times, but I am not bothered by that---it shouldn't be something that
-  // happens.
+  // happens.  The load may already have been started in the background.
   typedef std::tuple<T, typename ParameterType<T>::type> TupleType;
   TupleType& tuple = *boost::any_cast<TupleType>(&d.value);
-  const std::string& value = std::get<1>(tuple);
   T& matrix = std::get<0>(tuple);
   if (d.input && !d.loaded)
   {
-    // Call correct data::Load() function.
-    if (arma::is_Row<T>::value || arma::is_Col<T>::value)
-      data::Load(value, matrix, true);
-    else
-      data::Load(value, matrix, true, !d.noTranspose);
-    d.loaded = true;
+    WaitForLoad(d);
+    if (!d.loaded)
+    {
+      LoadParamImpl<T>(d, true);
+      d.loaded = true;
+    }
   }
 
   return matrix;
@@ -83,12 +83,15 @@ T& GetParam(
   // dataset info.
   typedef std::tuple<T, std::string> TupleType;
   TupleType* tuple = boost::any_cast<TupleType>(&d.value);
-  const std::string& value = std::get<1>(*tuple);
   T& t = std::get<0>(*tuple);
   if (d.input && !d.loaded)
   {
-    data::Load(value, std::get<1>(t), std::get<0>(t), true, !d.noTranspose);
-    d.loaded = true;
+    WaitForLoad(d);
+    if (!d.loaded)
+    {
+      LoadParamImpl<T>(d, true);
+      d.loaded = true;
+    }
   }
 
   return t;
@@ -106,16 +109,18 @@ T*& GetParam(
     const typename boost::enable_if<data::HasSerialize<T>>::type* = 0)
 {
   // If the model is an input model, we have to load it from file.  'value'
-  // contains the filename.
+  // contains the filename.  The load may already have been started in the
+  // background.
   typedef std::tuple<T*, std::string> TupleType;
   TupleType* tuple = boost::any_cast<TupleType>(&d.value);
-  const std::string& value = std::get<1>(*tuple);
   if (d.input && !d.loaded)
   {
-    T* model = new T();
-    data::Load(value, "model", *model, true);
-    d.loaded = true;
-    std::get<0>(*tuple) = model;
+    WaitForLoad(d);
+    if (!d.loaded)
+    {
+      LoadParamImpl<T>(d, true);
+      d.loaded = true;
+    }
   }
   return std::get<0>(*tuple);
 }
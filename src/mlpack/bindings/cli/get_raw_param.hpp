@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include "parameter_type.hpp"
+#include "load_param.hpp"
 
 namespace mlpack {
 namespace bindings {
@@ -47,7 +48,12 @@ T& GetRawParam(
         std::is_same<T, std::tuple<mlpack::data::DatasetInfo,
                                    arma::mat>>::value>::type* = 0)
 {
-  // Don't load the matrix.
+  // Don't load the matrix.  The program may modify it (e.g. set the dataset
+  // info) before it is loaded, so a load made in the background is discarded,
+  // and GetParam() loads it again.
+  if (WaitForLoad(d))
+    d.loaded = false;
+
   typedef std::tuple<T, std::string> TupleType;
   T& value = std::get<0>(*boost::any_cast<TupleType>(&d.value));
   return value;
@@ -62,9 +68,16 @@ T*& GetRawParam(
     const typename boost::disable_if<arma::is_arma_type<T>>::type* = 0,
     const typename boost::enable_if<data::HasSerialize<T>>::type* = 0)
 {
-  // Don't load the model.
+  // Don't load the model; a model loaded in the background is discarded, and
+  // GetParam() loads it again.
   typedef std::tuple<T*, std::string> TupleType;
   T*& value = std::get<0>(*boost::any_cast<TupleType>(&d.value));
+  if (WaitForLoad(d) && d.loaded)
+  {
+    delete value;
+    value = NULL;
+    d.loaded = false;
+  }
   return value;
 }
 
@@ -0,0 +1,206 @@
+/**
+ * @file load_param.hpp
+ *
+ * Load the matrices, datasets and models given as input parameters.  The loads
+ * of all the input files are started in the background by ParseCommandLine()
+ * and kept in CLI::pendingLoads, and GetParam() waits for the load of the
+ * parameter it returns.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_LOAD_PARAM_HPP
+#define MLPACK_BINDINGS_CLI_LOAD_PARAM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/data/load.hpp>
+#include <mlpack/core/util/timers.hpp>
+#include "parameter_type.hpp"
+
+#include <future>
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Whether parameters of the given type are given on the command line as the
+ * name of the file that holds them (matrices, datasets and models).
+ */
+template<typename T>
+struct IsFileParam
+{
+  static const bool value = !std::is_same<T,
+      typename ParameterType<T>::type>::value;
+};
+
+/**
+ * Load a matrix parameter from its file.
+ *
+ * @param d ParamData object of the parameter.
+ * @param fatal Whether a failure is fatal.
+ * @return Whether the matrix was loaded.
+ */
+template<typename T>
+bool LoadParamImpl(
+    util::ParamData& d,
+    const bool fatal,
+    const typename boost::enable_if<arma::is_arma_type<T>>::type* = 0)
+{
+  typedef std::tuple<T, typename ParameterType<T>::type> TupleType;
+  TupleType& tuple = *boost::any_cast<TupleType>(&d.value);
+  const std::string& value = std::get<1>(tuple);
+  T& matrix = std::get<0>(tuple);
+
+  // Call correct data::Load() function.
+  if (arma::is_Row<T>::value || arma::is_Col<T>::value)
+    return data::Load(value, matrix, fatal);
+  else
+    return data::Load(value, matrix, fatal, !d.noTranspose);
+}
+
+/**
+ * Load a matrix/dataset info parameter from its file.
+ *
+ * @param d ParamData object of the parameter.
+ * @param fatal Whether a failure is fatal.
+ * @return Whether the dataset was loaded.
+ */
+template<typename T>
+bool LoadParamImpl(
+    util::ParamData& d,
+    const bool fatal,
+    const typename boost::enable_if<std::is_same<T,
+        std::tuple<mlpack::data::DatasetInfo, arma::mat>>>::type* = 0)
+{
+  typedef std::tuple<T, std::string> TupleType;
+  TupleType* tuple = boost::any_cast<TupleType>(&d.value);
+  const std::string& value = std::get<1>(*tuple);
+  T& t = std::get<0>(*tuple);
+
+  return data::Load(value, std::get<1>(t), std::get<0>(t), fatal,
+      !d.noTranspose);
+}
+
+/**
+ * Load a serializable object from its file.
+ *
+ * @param d ParamData object of the parameter.
+ * @param fatal Whether a failure is fatal.
+ * @return Whether the model was loaded.
+ */
+template<typename T>
+bool LoadParamImpl(
+    util::ParamData& d,
+    const bool fatal,
+    const typename boost::disable_if<arma::is_arma_type<T>>::type* = 0,
+    const typename boost::enable_if<data::HasSerialize<T>>::type* = 0)
+{
+  typedef std::tuple<T*, std::string> TupleType;
+  TupleType* tuple = boost::any_cast<TupleType>(&d.value);
+  const std::string& value = std::get<1>(*tuple);
+
+  T* model = new T();
+  if (!data::Load(value, "model", *model, fatal))
+  {
+    delete model;
+    return false;
+  }
+
+  std::get<0>(*tuple) = model;
+  return true;
+}
+
+/**
+ * Wait for the background load of the given parameter, if there is one.  If the
+ * load failed, the parameter is left unloaded, so that GetParam() loads it
+ * again and reports the error.
+ *
+ * @param d ParamData object of the parameter.
+ * @return Whether the parameter was loaded in the background.
+ */
+inline bool WaitForLoad(const util::ParamData& d)
+{
+  std::map<std::string, std::future<void>>& loads =
+      CLI::GetSingleton().pendingLoads;
+  std::map<std::string, std::future<void>>::iterator it = loads.find(d.name);
+  if (it == loads.end())
+    return false;
+
+  try
+  {
+    it->second.get();
+  }
+  catch (std::exception& /* e */)
+  {
+    // The error is reported by the load in GetParam().
+  }
+  loads.erase(it);
+  return true;
+}
+
+/**
+ * Parameters that aren't stored in files have nothing to load.
+ *
+ * @param d ParamData object of the parameter.
+ */
+template<typename T>
+void StartLoadingImpl(
+    util::ParamData& /* d */,
+    const typename boost::disable_if<IsFileParam<T>>::type* = 0)
+{
+  // Nothing to do.
+}
+
+/**
+ * Start loading the given input parameter in the background, timing the load
+ * with the "loading_<name>" timer.  Failures are not fatal here: they are
+ * reported when the program gets the parameter.
+ *
+ * @param d ParamData object of the parameter.
+ */
+template<typename T>
+void StartLoadingImpl(
+    util::ParamData& d,
+    const typename boost::enable_if<IsFileParam<T>>::type* = 0)
+{
+  util::ParamData* param = &d;
+  std::future<void>& load = CLI::GetSingleton().pendingLoads[d.name];
+  load = std::async(std::launch::async, [param]()
+  {
+    Timer::Start("loading_" + param->name);
+    const bool loaded = LoadParamImpl<T>(*param, false);
+    Timer::Stop("loading_" + param->name);
+    param->loaded = loaded;
+  });
+}
+
+/**
+ * Start loading the given parameter in the background, if it is an input
+ * parameter stored in a file that was given on the command line.  This is the
+ * function that will be called by ParseCommandLine().
+ *
+ * @param d ParamData object of the parameter.
+ * @param input Unused parameter.
+ * @param output Unused parameter.
+ */
+template<typename T>
+void StartLoading(const util::ParamData& d,
+                  const void* /* input */,
+                  void* /* output */)
+{
+  if (d.input && d.wasPassed && !d.loaded)
+  {
+    StartLoadingImpl<typename std::remove_pointer<T>::type>(
+        const_cast<util::ParamData&>(d));
+  }
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
@@ -27,6 +27,18 @@ PARAM_STRING_IN("info", "Print help on a specific option.", "", "");
 PARAM_FLAG("verbose", "Display informational messages and the full list of "
     "parameters and timers at the end of execution.", "v");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_INT_IN("threads", "Maximum number of threads to use (0 uses one thread "
+    "per processor).", "", 0);
+PARAM_STRING_IN("timers_file", "File to write the program timers to, as JSON.",
+    "", "");
+PARAM_FLAG("async_log", "Write log messages from a background thread, so that "
+    "logging does not slow down the computation.", "");
+PARAM_STRING_IN("thread_affinity", "How to pin the threads to processors: "
+    "'none', 'compact' (fill one socket at a time) or 'spread' (spread "
+    "threads over the sockets).", "", "none");
+PARAM_STRING_IN("memory_placement", "How to place loaded matrices in memory "
+    "on machines with several NUMA nodes: 'default', 'first_touch' or "
+    "'interleave'.", "", "default");
 
 /**
  * Parse the command line, setting all of the options inside of the CLI object
@@ -174,6 +186,53 @@ void ParseCommandLine(int argc, char** argv)
     Log::Info.ignoreInput = false;
   }
 
+  // Bound the number of threads before anything runs in parallel.  If the
+  // option is not given, the OpenMP defaults (e.g. OMP_NUM_THREADS) are kept.
+  if (CLI::HasParam("threads"))
+  {
+    const int threads = CLI::GetParam<int>("threads");
+    if (threads < 0)
+    {
+      Log::Fatal << "Invalid value for --threads: " << threads << "; must be "
+          << "at least 0." << std::endl;
+    }
+    SetNumThreads((size_t) threads);
+  }
+
+  // Pin the threads and set how loaded matrices are placed, before any data
+  // is loaded.
+  const std::string affinity = CLI::GetParam<std::string>("thread_affinity");
+  if (affinity == "compact" || affinity == "spread")
+  {
+    if (!SetThreadAffinity(affinity == "compact" ? ThreadAffinity::COMPACT :
+        ThreadAffinity::SPREAD))
+    {
+      Log::Warn << "Could not pin the threads to processors; continuing "
+          << "without --thread_affinity." << std::endl;
+    }
+  }
+  else if (affinity != "none")
+  {
+    Log::Fatal << "Invalid value for --thread_affinity: '" << affinity
+        << "'; must be 'none', 'compact' or 'spread'." << std::endl;
+  }
+
+  const std::string placement = CLI::GetParam<std::string>("memory_placement");
+  if (placement == "first_touch")
+    SetMemoryPlacement(MemoryPlacement::FIRST_TOUCH);
+  else if (placement == "interleave")
+    SetMemoryPlacement(MemoryPlacement::INTERLEAVE);
+  else if (placement != "default")
+  {
+    Log::Fatal << "Invalid value for --memory_placement: '" << placement
+        << "'; must be 'default', 'first_touch' or 'interleave'." << std::endl;
+  }
+
+  // Hand the log output to a background thread if requested.  It is stopped,
+  // and the pending messages are written, in EndProgram().
+  if (CLI::HasParam("async_log"))
+    util::AsyncLogSink::Start();
+
   // Now, issue an error if we forgot any required options.
   for (std::map<std::string, util::ParamData>::const_iterator iter =
        parameters.begin(); iter != parameters.end(); ++iter)
@@ -192,6 +251,15 @@ void ParseCommandLine(int argc, char** argv)
       }
     }
   }
+
+  // Start loading all the given input files concurrently in the background;
+  // GetParam() waits for the load of the parameter it returns.
+  for (std::map<std::string, util::ParamData>::const_iterator iter =
+       parameters.begin(); iter != parameters.end(); ++iter)
+  {
+    const util::ParamData& d = iter->second;
+    CLI::GetSingleton().functionMap[d.tname]["StartLoading"](d, NULL, NULL);
+  }
 }
 
 } // namespace cli
@@ -0,0 +1,87 @@
+/**
+ * @file save_param.hpp
+ *
+ * Save the matrices, datasets and models given as output parameters in the
+ * background, so that the outputs of a program are written concurrently.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SAVE_PARAM_HPP
+#define MLPACK_BINDINGS_CLI_SAVE_PARAM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/param_data.hpp>
+#include <mlpack/core/util/timers.hpp>
+#include "load_param.hpp"
+#include "output_param.hpp"
+
+#include <future>
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Parameters that aren't stored in files are printed by OutputParam() instead.
+ *
+ * @param d ParamData object of the parameter.
+ * @param save Left invalid.
+ */
+template<typename T>
+void StartSavingImpl(
+    const util::ParamData& /* d */,
+    std::future<void>& /* save */,
+    const typename boost::disable_if<IsFileParam<T>>::type* = 0)
+{
+  // Nothing to do.
+}
+
+/**
+ * Start saving the given output parameter to its file in the background,
+ * timing the save with the "saving_<name>" timer.
+ *
+ * @param d ParamData object of the parameter.
+ * @param save Set to the running save.
+ */
+template<typename T>
+void StartSavingImpl(
+    const util::ParamData& d,
+    std::future<void>& save,
+    const typename boost::enable_if<IsFileParam<T>>::type* = 0)
+{
+  const util::ParamData* param = &d;
+  save = std::async(std::launch::async, [param]()
+  {
+    Timer::Start("saving_" + param->name);
+    OutputParamImpl<T>(*param);
+    Timer::Stop("saving_" + param->name);
+  });
+}
+
+/**
+ * Start saving the given output parameter in the background, if it is stored in
+ * a file.  This is the function that will be called by EndProgram(); it sets
+ * the std::future<void> pointed to by output to the running save, or leaves it
+ * invalid if the parameter must be printed with OutputParam().
+ *
+ * @param d ParamData object of the parameter.
+ * @param input Unused parameter.
+ * @param output Pointer to the std::future<void> to set.
+ */
+template<typename T>
+void StartSaving(const util::ParamData& d,
+                 const void* /* input */,
+                 void* output)
+{
+  StartSavingImpl<typename std::remove_pointer<T>::type>(d,
+      *((std::future<void>*) output));
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
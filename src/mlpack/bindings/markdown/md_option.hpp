@@ -62,7 +62,10 @@ class MDOption
     data.loaded = false;
     // Several options from Python and CLI bindings are persistent.
     if (identifier == "verbose" || identifier == "copy_all_inputs" ||
-        identifier == "help" || identifier == "info" || identifier == "version")
+        identifier == "help" || identifier == "info" ||
+        identifier == "version" || identifier == "threads" ||
+        identifier == "timers_file" || identifier == "async_log" ||
+        identifier == "thread_affinity" || identifier == "memory_placement")
       data.persistent = true;
     else
       data.persistent = false;
@@ -96,7 +99,10 @@ class MDOption
     // Add the option.
     CLI::Add(std::move(data));
     if (identifier != "verbose" && identifier != "copy_all_inputs" &&
-        identifier != "help" && identifier != "info" && identifier != "version")
+        identifier != "help" && identifier != "info" &&
+        identifier != "version" && identifier != "threads" &&
+        identifier != "timers_file" && identifier != "async_log" &&
+        identifier != "thread_affinity" && identifier != "memory_placement")
       CLI::StoreSettings(bindingName);
     CLI::ClearSettings();
   }
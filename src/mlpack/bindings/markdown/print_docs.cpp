@@ -114,7 +114,11 @@ void PrintDocs(const std::string& bindingName,
         continue;
       if (languages[i] != "cli" &&
           (it->second.name == "help" || it->second.name == "info" ||
-           it->second.name == "version"))
+           it->second.name == "version" || it->second.name == "threads" ||
+           it->second.name == "timers_file" ||
+           it->second.name == "async_log" ||
+           it->second.name == "thread_affinity" ||
+           it->second.name == "memory_placement"))
         continue;
 
       // Print name, type, description, default.
@@ -124,7 +128,11 @@ void PrintDocs(const std::string& bindingName,
       cout << it->second.desc; // just a string
       // Print whether or not it's a "special" language-only parameter.
       if (it->second.name == "copy_all_inputs" || it->second.name == "help" ||
-          it->second.name == "info" || it->second.name == "version")
+          it->second.name == "info" || it->second.name == "version" ||
+          it->second.name == "threads" || it->second.name == "timers_file" ||
+          it->second.name == "async_log" ||
+          it->second.name == "thread_affinity" ||
+          it->second.name == "memory_placement")
       {
         cout << "  <span class=\"special\">Only exists in "
             << PrintLanguage(languages[i]) << " binding.</span>";
@@ -161,7 +169,11 @@ void PrintDocs(const std::string& bindingName,
       cout << it->second.desc;
       // Print whether or not it's a "special" language-only parameter.
       if (it->second.name == "copy_all_inputs" || it->second.name == "help" ||
-          it->second.name == "info" || it->second.name == "version")
+          it->second.name == "info" || it->second.name == "version" ||
+          it->second.name == "threads" || it->second.name == "timers_file" ||
+          it->second.name == "async_log" ||
+          it->second.name == "thread_affinity" ||
+          it->second.name == "memory_placement")
       {
         cout << "  <span class=\"special\">Only exists in "
             << PrintLanguage(languages[i]) << " binding.</span>";
@@ -6,6 +6,11 @@ This file defines the to_matrix() function, which can be used to convert Pandas
 dataframes or other types of array-like objects to numpy ndarrays for use in
 mlpack bindings.
 
+mlpack stores matrices in column-major order with one point per column, so a
+C-contiguous (row-major) ndarray with one point per row has exactly the layout
+of the Armadillo matrix, and is given to mlpack without a copy.  Any other
+input is converted with a single copy.
+
 mlpack is free software; you may redistribute it and/or modify it under the
 terms of the 3-clause BSD license.  You should have received a copy of the
 3-clause BSD license along with mlpack.  If not, see
@@ -13,6 +18,9 @@ http://www.opensource.org/licenses/BSD-3-Clause for more information.
 """
 import numpy as np
 import pandas as pd
+import os
+import tempfile
+import threading
 # The CategoricalDtype class has moved multiple times, so this insanity is
 # necessary to import the right version.
 if int(pd.__version__.split('.')[0]) > 0 or \
@@ -37,9 +45,28 @@ try:
 except:
   buffer = memoryview
 
+# The parameters of the bindings are held by one global object, so only one
+# binding may run at a time.  The bindings hold this lock while they run, but
+# release the GIL during the computation, so other Python threads keep running.
+binding_lock = threading.RLock()
+
+def shared_segment(name):
+  """
+  Return the path of the shared segment with the given name that models are
+  exported to: a file in /dev/shm (which is backed by memory) if it exists, and
+  in the temporary directory otherwise.  Paths are returned unchanged.
+  """
+  if os.path.isabs(name):
+    return name
+  directory = '/dev/shm' if os.path.isdir('/dev/shm') else tempfile.gettempdir()
+  return os.path.join(directory, name)
+
 def to_matrix(x, dtype=np.double, copy=False):
   """
-  Given some array-like X, return a numpy ndarray of the same type.
+  Given some array-like X, return a C-contiguous numpy ndarray of the given
+  dtype, and whether it is a new array that the binding may take ownership of.
+  C-contiguous ndarrays of the right dtype are returned as-is, unless copy is
+  True; anything else is converted with a single copy.
   """
   # Make sure it's array-like at all.
   if not hasattr(x, '__len__') and \
@@ -52,21 +79,16 @@ def to_matrix(x, dtype=np.double, copy=False):
       return x.copy("C"), True
     else:
       return x, False
-  elif (isinstance(x, np.ndarray) and x.dtype == dtype and x.flags.f_contiguous):
-    if copy: # Copy the matrix if required.
-      return np.ndarray(x.shape, buffer=x.flatten(), dtype=dtype, order='C').copy("C"), True
-    else:
-      return np.ndarray(x.shape, buffer=x.flatten(), dtype=dtype, order='C'), False
+  elif isinstance(x, np.ndarray):
+    # Other layouts and dtypes (e.g. Fortran-ordered or float32 arrays) need
+    # one conversion; the result is new, so the binding can own it.
+    return np.array(x, copy=True, dtype=dtype, order='C'), True
+  elif isinstance(x, pd.core.series.Series) or isinstance(x, pd.DataFrame):
+    # The values of a numeric dataframe are often usable as-is.
+    return to_matrix(x.values, dtype=dtype, copy=copy)
   else:
-    if isinstance(x, pd.core.series.Series) or isinstance(x, pd.DataFrame):
-      y = x.values
-      if copy: # Copy the matrix if required.
-        return np.ndarray(y.shape, buffer=y.flatten(), dtype=dtype, order='C').copy("C"), True
-      else:
-        return np.ndarray(y.shape, buffer=y.flatten(), dtype=dtype, order='C'), False
-    else:
-      return np.array(x, copy=True, dtype=dtype, order='C'), True
-    
+    return np.array(x, copy=True, dtype=dtype, order='C'), True
+
 
 def to_matrix_with_info(x, dtype, copy=False):
   """
@@ -83,11 +105,9 @@ def to_matrix_with_info(x, dtype, copy=False):
     # It is already an ndarray, so the vector of info is all 0s (all numeric).
     d = np.zeros([x.shape[1]], dtype=np.bool)
 
-    # Copy the matrix if needed.
-    if copy:
-      return (x.copy(order="C"), True, d)
-    else:
-      return (x, False, d)
+    # Convert the matrix only if needed.
+    t = to_matrix(x, dtype=dtype, copy=copy)
+    return (t[0], t[1], d)
 
   if isinstance(x, pd.DataFrame) or isinstance(x, pd.Series):
     # It's a pandas dataframe.  So we need to see if any of the dtypes are
@@ -13,6 +13,10 @@
 #define MLPACK_BINDINGS_PYTHON_MLPACK_SERIALIZATION_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
+
+#include <cstdio>
+#include <fstream>
 
 namespace mlpack {
 namespace bindings {
@@ -39,6 +43,90 @@ void SerializeIn(T* t, const std::string& str, const std::string& name)
   b >> boost::serialization::make_nvp(name.c_str(), *t);
 }
 
+/**
+ * A read-only stream buffer over memory that is owned by someone else, so that
+ * a model can be deserialized straight from a mapping.
+ */
+class MemoryBuffer : public std::streambuf
+{
+ public:
+  MemoryBuffer(const char* data, const size_t size)
+  {
+    char* begin = const_cast<char*>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+
+/**
+ * Serialize the given model into the given shared segment: a file, usually in
+ * a memory-backed file system such as /dev/shm, that other processes can map.
+ * The file is written under a temporary name and then renamed, so a process
+ * that opens the segment never sees a partial model.  A std::runtime_error is
+ * thrown if the segment can't be written.
+ *
+ * @param t Model to export.
+ * @param name Name of the model type (used by the archive).
+ * @param segment Path of the segment.
+ */
+template<typename T>
+void SerializeOutShared(T* t, const std::string& name,
+                        const std::string& segment)
+{
+  const std::string temporary = segment + ".tmp";
+  {
+    std::ofstream ofs(temporary, std::ios::binary);
+    if (!ofs.is_open())
+    {
+      std::ostringstream oss;
+      oss << "SerializeOutShared(): cannot open '" << temporary << "' for "
+          << "writing";
+      throw std::runtime_error(oss.str());
+    }
+
+    boost::archive::binary_oarchive b(ofs);
+    b << boost::serialization::make_nvp(name.c_str(), *t);
+  }
+
+  if (std::rename(temporary.c_str(), segment.c_str()) != 0)
+  {
+    std::remove(temporary.c_str());
+    std::ostringstream oss;
+    oss << "SerializeOutShared(): cannot create '" << segment << "'";
+    throw std::runtime_error(oss.str());
+  }
+}
+
+/**
+ * Load the given model from a shared segment written by SerializeOutShared().
+ * The segment is mapped, not read into a buffer, so its pages are shared by
+ * all the processes that load it and the model's matrices are filled directly
+ * from them.  A std::runtime_error is thrown if the segment can't be mapped.
+ *
+ * @param t Model to load into.
+ * @param segment Path of the segment.
+ * @param name Name of the model type (used by the archive).
+ */
+template<typename T>
+void SerializeInShared(T* t, const std::string& segment,
+                       const std::string& name)
+{
+  data::MappedFile file(segment);
+  MemoryBuffer buffer(file.Data(), file.Size());
+  std::istream stream(&buffer);
+  boost::archive::binary_iarchive b(stream);
+
+  b >> boost::serialization::make_nvp(name.c_str(), *t);
+}
+
+/**
+ * Remove the given shared segment.  Processes that have already loaded a model
+ * from it are not affected.
+ */
+inline void RemoveShared(const std::string& segment)
+{
+  std::remove(segment.c_str());
+}
+
 } // namespace python
 } // namespace bindings
 } // namespace mlpack
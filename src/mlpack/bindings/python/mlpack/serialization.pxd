@@ -12,3 +12,6 @@ from libcpp.string cimport string
 cdef extern from "serialization.hpp" namespace "mlpack::bindings::python" nogil:
   string SerializeOut[T](T* t, string name) nogil
   void SerializeIn[T](T* t, string str, string name) nogil
+  void SerializeOutShared[T](T* t, string name, string segment) nogil except +
+  void SerializeInShared[T](T* t, string segment, string name) nogil except +
+  void RemoveShared(string segment) nogil
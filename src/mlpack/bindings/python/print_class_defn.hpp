@@ -76,6 +76,18 @@ void PrintClassDefn(
    *
    *   def __reduce_ex__(self):
    *     return (self.__class__, (), self.__getstate__())
+   *
+   *   def export_shared(self, name):
+   *     segment = shared_segment(name)
+   *     SerializeOutShared(self.modelptr, "<ModelType>", segment.encode())
+   *     return segment
+   *
+   *   def import_shared(self, segment):
+   *     SerializeInShared(self.modelptr, segment.encode(), "<ModelType>")
+   *
+   *   @staticmethod
+   *   def remove_shared(segment):
+   *     RemoveShared(segment.encode())
    */
   std::cout << "cdef class " << strippedType << "Type:" << std::endl;
   std::cout << "  cdef " << printedType << "* modelptr" << std::endl;
@@ -98,6 +110,38 @@ void PrintClassDefn(
   std::cout << "    return (self.__class__, (), self.__getstate__())"
       << std::endl;
   std::cout << std::endl;
+
+  // Models can also be exported to a shared segment, which other processes map
+  // instead of unpickling a copy of the model.
+  std::cout << "  def export_shared(self, name):" << std::endl;
+  std::cout << "    \"\"\"" << std::endl;
+  std::cout << "    Export the model to the shared segment with the given name,"
+      << std::endl;
+  std::cout << "    and return the handle that other processes can give to"
+      << std::endl;
+  std::cout << "    import_shared()." << std::endl;
+  std::cout << "    \"\"\"" << std::endl;
+  std::cout << "    segment = shared_segment(name)" << std::endl;
+  std::cout << "    SerializeOutShared(self.modelptr, \"" << printedType
+      << "\", segment.encode())" << std::endl;
+  std::cout << "    return segment" << std::endl;
+  std::cout << std::endl;
+  std::cout << "  def import_shared(self, segment):" << std::endl;
+  std::cout << "    \"\"\"" << std::endl;
+  std::cout << "    Load the model from the shared segment with the given "
+      << "handle." << std::endl;
+  std::cout << "    \"\"\"" << std::endl;
+  std::cout << "    SerializeInShared(self.modelptr, segment.encode(), \""
+      << printedType << "\")" << std::endl;
+  std::cout << std::endl;
+  std::cout << "  @staticmethod" << std::endl;
+  std::cout << "  def remove_shared(segment):" << std::endl;
+  std::cout << "    \"\"\"" << std::endl;
+  std::cout << "    Remove the shared segment with the given handle."
+      << std::endl;
+  std::cout << "    \"\"\"" << std::endl;
+  std::cout << "    RemoveShared(segment.encode())" << std::endl;
+  std::cout << std::endl;
 }
 
 /**
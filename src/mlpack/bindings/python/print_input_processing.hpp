@@ -250,7 +250,8 @@ void PrintInputProcessing(
    *       dereference(param_name_mat), &param_name_tuple[1][0])
    *   CLI.SetPassed(<const string> 'param_name')
    */
-  std::cout << prefix << "cdef np.ndarray " << d.name << "_dims" << std::endl;
+  // The "cdef np.ndarray param_name_dims" declaration is printed by PrintPyx(),
+  // at the top of the function, since Cython does not allow it in a block.
   std::cout << prefix << "# Detect if the parameter was passed; set if so."
       << std::endl;
   if (!d.required)
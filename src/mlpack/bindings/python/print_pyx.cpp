@@ -80,8 +80,10 @@ void PrintPYX(const ProgramDoc& programInfo,
       << "GetParamPtr" << endl;
   cout << "from cli cimport EnableVerbose, DisableVerbose, DisableBacktrace, "
       << "ResetTimers, EnableTimers" << endl;
-  cout << "from matrix_utils import to_matrix, to_matrix_with_info" << endl;
-  cout << "from serialization cimport SerializeIn, SerializeOut" << endl;
+  cout << "from matrix_utils import to_matrix, to_matrix_with_info, "
+      << "binding_lock, shared_segment" << endl;
+  cout << "from serialization cimport SerializeIn, SerializeOut, "
+      << "SerializeInShared, SerializeOutShared, RemoveShared" << endl;
   cout << endl;
   cout << "import numpy as np" << endl;
   cout << "cimport numpy as np" << endl;
@@ -175,64 +177,79 @@ void PrintPYX(const ProgramDoc& programInfo,
       << "returned." << endl;
   cout << "  \"\"\"" << endl;
 
+  // Declare the dataset information arrays of matrices with info here, since
+  // Cython does not allow cdef statements inside of the block below.
+  typedef std::tuple<data::DatasetInfo, arma::mat> TupleType;
+  for (size_t i = 0; i < inputOptions.size(); ++i)
+  {
+    const util::ParamData& d = parameters.at(inputOptions[i]);
+    if (d.tname == TYPENAME(TupleType))
+      cout << "  cdef np.ndarray " << d.name << "_dims" << endl;
+  }
+
+  // Only one binding may use the parameters at a time.
+  cout << "  with binding_lock:" << endl;
+
   // Reset any timers and disable backtraces.
-  cout << "  ResetTimers()" << endl;
-  cout << "  EnableTimers()" << endl;
-  cout << "  DisableBacktrace()" << endl;
-  cout << "  DisableVerbose()" << endl;
+  cout << "    ResetTimers()" << endl;
+  cout << "    EnableTimers()" << endl;
+  cout << "    DisableBacktrace()" << endl;
+  cout << "    DisableVerbose()" << endl;
 
   // Restore the parameters.
-  cout << "  CLI.RestoreSettings(\"" << programInfo.programName << "\")"
+  cout << "    CLI.RestoreSettings(\"" << programInfo.programName << "\")"
       << endl;
 
   // Determine whether or not we need to copy parameters.
-  cout << "  if copy_all_inputs:" << endl;
-  cout << "    SetParam[bool](<const string> 'copy_all_inputs', "
+  cout << "    if copy_all_inputs:" << endl;
+  cout << "      SetParam[bool](<const string> 'copy_all_inputs', "
       << "copy_all_inputs)" << endl;
-  cout << "    CLI.SetPassed(<const string> 'copy_all_inputs')" << endl;
+  cout << "      CLI.SetPassed(<const string> 'copy_all_inputs')" << endl;
 
   // Do any input processing.
   for (size_t i = 0; i < inputOptions.size(); ++i)
   {
     const util::ParamData& d = parameters.at(inputOptions[i]);
 
-    size_t indent = 2;
+    size_t indent = 4;
     CLI::GetSingleton().functionMap[d.tname]["PrintInputProcessing"](d,
         (void*) &indent, NULL);
   }
 
   // Set all output options as passed.
-  cout << "  # Mark all output options as passed." << endl;
+  cout << "    # Mark all output options as passed." << endl;
   for (size_t i = 0; i < outputOptions.size(); ++i)
   {
     const util::ParamData& d = parameters.at(outputOptions[i]);
-    cout << "  CLI.SetPassed(<const string> '" << d.name << "')" << endl;
+    cout << "    CLI.SetPassed(<const string> '" << d.name << "')" << endl;
   }
 
-  // Call the method.
-  cout << "  # Call the mlpack program." << endl;
-  cout << "  mlpackMain()" << endl;
+  // Call the method.  It does not touch any Python object, so other Python
+  // threads may run in the meantime.
+  cout << "    # Call the mlpack program." << endl;
+  cout << "    with nogil:" << endl;
+  cout << "      mlpackMain()" << endl;
 
   // Do any output processing and return.
-  cout << "  # Initialize result dictionary." << endl;
-  cout << "  result = {}" << endl;
+  cout << "    # Initialize result dictionary." << endl;
+  cout << "    result = {}" << endl;
   cout << endl;
 
   for (size_t i = 0; i < outputOptions.size(); ++i)
   {
     const util::ParamData& d = parameters.at(outputOptions[i]);
 
-    std::tuple<size_t, bool> t = std::make_tuple(2, false);
+    std::tuple<size_t, bool> t = std::make_tuple(4, false);
     CLI::GetSingleton().functionMap[d.tname]["PrintOutputProcessing"](d,
         (void*) &t, NULL);
   }
 
   // Clear the parameters.
   cout << endl;
-  cout << "  CLI.ClearSettings()" << endl;
+  cout << "    CLI.ClearSettings()" << endl;
   cout << endl;
 
-  cout << "  return result" << endl;
+  cout << "    return result" << endl;
 }
 
 } // namespace python
@@ -13,6 +13,7 @@ import unittest
 import pandas as pd
 import numpy as np
 import copy
+import threading
 
 from mlpack.test_python_binding import test_python_binding
 
@@ -713,6 +714,28 @@ class TestPythonBinding(unittest.TestCase):
 
     self.assertEqual(output2['model_bw_out'], 20.0)
 
+  def testSharedModel(self):
+    """
+    Export a GaussianKernel object to a shared segment, load it into a new
+    object, and make sure that we get the right double value with it.
+    """
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 build_model=True)
+
+    handle = output['model_out'].export_shared('mlpack_test_shared_model')
+    model = type(output['model_out'])()
+    model.import_shared(handle)
+    type(model).remove_shared(handle)
+
+    output2 = test_python_binding(string_in='hello',
+                                  int_in=12,
+                                  double_in=4.0,
+                                  model_in=model)
+
+    self.assertEqual(output2['model_bw_out'], 20.0)
+
   def testModelForceCopy(self):
     """
     First create a GaussianKernel object, then send it back and make sure we get
@@ -737,5 +760,52 @@ class TestPythonBinding(unittest.TestCase):
     self.assertEqual(output2['model_bw_out'], 20.0)
     self.assertEqual(output3['model_bw_out'], 20.0)
 
+  def testNumpyFloat32Matrix(self):
+    """
+    A float32 matrix should be converted, and we should get back the third
+    dimension doubled and the fifth forgotten.
+    """
+    x = np.random.rand(100, 5).astype(np.float32)
+
+    output = test_python_binding(string_in='hello',
+                                 int_in=12,
+                                 double_in=4.0,
+                                 matrix_in=x)
+
+    self.assertEqual(output['matrix_out'].shape[0], 100)
+    self.assertEqual(output['matrix_out'].shape[1], 4)
+    self.assertEqual(output['matrix_out'].dtype, np.double)
+    for i in [0, 1, 3]:
+      for j in range(100):
+        self.assertEqual(np.double(x[j, i]), output['matrix_out'][j, i])
+
+    for j in range(100):
+      self.assertEqual(2 * np.double(x[j, 2]), output['matrix_out'][j, 2])
+
+  def testThreadedBindings(self):
+    """
+    Bindings called from several Python threads at once should each get their
+    own parameters.
+    """
+    results = [None] * 8
+    def run(i):
+      output = test_python_binding(string_in='hello',
+                                   int_in=12,
+                                   double_in=4.0,
+                                   matrix_in=np.full((50, 5), float(i)))
+      results[i] = output['matrix_out']
+
+    threads = [threading.Thread(target=run, args=(i,)) for i in range(8)]
+    for t in threads:
+      t.start()
+    for t in threads:
+      t.join()
+
+    for i in range(8):
+      self.assertEqual(results[i].shape[0], 50)
+      self.assertEqual(results[i].shape[1], 4)
+      self.assertTrue(np.all(results[i][:, [0, 1, 3]] == i))
+      self.assertTrue(np.all(results[i][:, 2] == 2 * i))
+
 if __name__ == '__main__':
   unittest.main()
@@ -71,8 +71,10 @@
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/deprecated.hpp>
+#include <mlpack/core/util/rate_limiter.hpp>
 #include <mlpack/core/data/load.hpp>
 #include <mlpack/core/data/save.hpp>
+#include <mlpack/core/data/matrix_reader.hpp>
 #include <mlpack/core/data/normalize_labels.hpp>
 #include <mlpack/core/math/clamp.hpp>
 #include <mlpack/core/math/random.hpp>
@@ -84,6 +86,7 @@
 #include <mlpack/core/math/make_alias.hpp>
 #include <mlpack/core/dists/discrete_distribution.hpp>
 #include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
 #include <mlpack/core/dists/laplace_distribution.hpp>
 #include <mlpack/core/dists/gamma_distribution.hpp>
 
@@ -106,11 +109,6 @@
 #include <mlpack/core/kernels/triangular_kernel.hpp>
 #include <mlpack/core/kernels/cauchy_kernel.hpp>
 
-// Use OpenMP if compiled with -DHAS_OPENMP.
-#ifdef HAS_OPENMP
-  #include <omp.h>
-#endif
-
 // Use Armadillo's C++ version detection.
 #ifdef ARMA_USE_CXX11
   #define MLPACK_USE_CX11
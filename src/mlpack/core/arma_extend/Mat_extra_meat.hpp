@@ -25,6 +25,34 @@ void Mat<eT>::serialize(Archive& ar, const unsigned int /* version */)
   ar & make_nvp("n_elem", access::rw(n_elem));
   ar & make_nvp("vec_state", access::rw(vec_state));
 
+  // In a model saved with format::mapped, a large matrix is stored in its own
+  // block after the archive, and is loaded by using the memory of the block
+  // in the mapping of the file.
+  mlpack::data::MatrixBlocks* blocks = mlpack::data::MatrixBlocks::Current();
+  const size_t bytes = n_elem * sizeof(eT);
+  if (blocks != NULL && bytes >= mlpack::data::MatrixBlocks::minBlockSize)
+  {
+    size_t offset = 0;
+    if (Archive::is_saving::value)
+      offset = blocks->Add(mem, bytes);
+    ar & make_nvp("offset", offset);
+
+    if (Archive::is_loading::value)
+    {
+      if (mem_state == 0 && mem != NULL &&
+          old_n_elem > arma_config::mat_prealloc)
+      {
+        memory::release(access::rw(mem));
+      }
+
+      // The memory is not owned by the matrix, but it can still be resized.
+      access::rw(mem) = (eT*) blocks->Get(offset, bytes);
+      access::rw(mem_state) = 1;
+    }
+
+    return;
+  }
+
   // mem_state will always be 0 on load, so we don't need to save it.
   if (Archive::is_loading::value)
   {
@@ -49,6 +49,9 @@
 #include <boost/serialization/nvp.hpp>
 #include <boost/serialization/array.hpp>
 
+// The blocks of the large matrices of models saved with format::mapped.
+#include <mlpack/core/data/matrix_blocks.hpp>
+
 #include <armadillo>
 
 namespace arma {
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_CV_CV_BASE_HPP
 
 #include <mlpack/core/cv/meta_info_extractor.hpp>
+#include <mlpack/core/cv/warm_start_traits.hpp>
 
 namespace mlpack {
 namespace cv {
@@ -98,6 +99,18 @@ class CVBase
                     const WeightsType& weights,
                     const MLAlgorithmArgs&... args);
 
+  /**
+   * Retrain the given model with given data points, predictions, and
+   * hyperparameters, starting from its current parameters, if MLAlgorithm
+   * supports warm starts (see WarmStartTraits).  Otherwise the model is
+   * replaced by a model trained from scratch.
+   */
+  template<typename... MLAlgorithmArgs>
+  void TrainFrom(MLAlgorithm& model,
+                 const MatType& xs,
+                 const PredictionsType& ys,
+                 const MLAlgorithmArgs&... args);
+
  private:
   static_assert(MIE::IsSupported,
       "The given MLAlgorithm is not supported by MetaInfoExtractor");
@@ -196,6 +209,47 @@ class CVBase
                          const WeightsType& weights,
                          const MLAlgorithmArgs&... args);
 
+  /**
+   * Replace the given model by a model trained from scratch if MLAlgorithm
+   * doesn't support warm starts.
+   */
+  template<typename... MLAlgorithmArgs,
+           bool Enabled = !WarmStartTraits<MLAlgorithm>::IsSupported,
+           typename = typename std::enable_if<Enabled>::type>
+  void WarmTrainModel(MLAlgorithm& model,
+                      const MatType& xs,
+                      const PredictionsType& ys,
+                      const MLAlgorithmArgs&... args);
+
+  /**
+   * Retrain the given model if MLAlgorithm supports warm starts and doesn't
+   * take the numClasses parameter.
+   */
+  template<typename... MLAlgorithmArgs,
+           bool Enabled = WarmStartTraits<MLAlgorithm>::IsSupported &
+               !MIE::TakesNumClasses,
+           typename = typename std::enable_if<Enabled>::type,
+           typename = void>
+  void WarmTrainModel(MLAlgorithm& model,
+                      const MatType& xs,
+                      const PredictionsType& ys,
+                      const MLAlgorithmArgs&... args);
+
+  /**
+   * Retrain the given model if MLAlgorithm supports warm starts and takes the
+   * numClasses parameter.
+   */
+  template<typename... MLAlgorithmArgs,
+           bool Enabled = WarmStartTraits<MLAlgorithm>::IsSupported &
+               MIE::TakesNumClasses,
+           typename = typename std::enable_if<Enabled>::type,
+           typename = void,
+           typename = void>
+  void WarmTrainModel(MLAlgorithm& model,
+                      const MatType& xs,
+                      const PredictionsType& ys,
+                      const MLAlgorithmArgs&... args);
+
   /**
    * When MLAlgorithm supports a data::DatasetInfo parameter, training should be
    * treated separately - there are models that can be constructed with and
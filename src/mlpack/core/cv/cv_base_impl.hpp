@@ -94,6 +94,22 @@ MLAlgorithm CVBase<MLAlgorithm,
   return TrainModel(xs, ys, weights, args...);
 }
 
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::TrainFrom(MLAlgorithm& model,
+                                    const MatType& xs,
+                                    const PredictionsType& ys,
+                                    const MLAlgorithmArgs&... args)
+{
+  WarmTrainModel(model, xs, ys, args...);
+}
+
 template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
@@ -137,6 +153,55 @@ void CVBase<MLAlgorithm,
   }
 }
 
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs, bool Enabled, typename>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::WarmTrainModel(MLAlgorithm& model,
+                                         const MatType& xs,
+                                         const PredictionsType& ys,
+                                         const MLAlgorithmArgs&... args)
+{
+  model = Train(xs, ys, args...);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs, bool Enabled, typename, typename>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::WarmTrainModel(MLAlgorithm& model,
+                                         const MatType& xs,
+                                         const PredictionsType& ys,
+                                         const MLAlgorithmArgs&... args)
+{
+  WarmStartTraits<MLAlgorithm>::Train(model, xs, ys, args...);
+}
+
+template<typename MLAlgorithm,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs, bool Enabled, typename, typename,
+    typename>
+void CVBase<MLAlgorithm,
+            MatType,
+            PredictionsType,
+            WeightsType>::WarmTrainModel(MLAlgorithm& model,
+                                         const MatType& xs,
+                                         const PredictionsType& ys,
+                                         const MLAlgorithmArgs&... args)
+{
+  WarmStartTraits<MLAlgorithm>::Train(model, xs, ys, numClasses, args...);
+}
+
 template<typename MLAlgorithm,
          typename MatType,
          typename PredictionsType,
@@ -44,6 +44,18 @@ namespace cv {
  * the @c Shuffle() function.  Shuffling is performed at construction time if
  * the parameter @c shuffle is set to @c true in the constructor.
  *
+ * By default the folds are trained and evaluated one after another, on one
+ * copy of the dataset.  If @c MaxConcurrentFolds() is set to more than one
+ * (or to zero, for as many folds as there are threads), up to that many folds
+ * are trained and evaluated at the same time with OpenMP.  Each of them then
+ * holds a copy of its training subset and a model, so the setting bounds the
+ * memory used at the same time.
+ *
+ * @code
+ * cv.MaxConcurrentFolds() = 4;
+ * double softmaxAccuracy = cv.Evaluate(lambda);
+ * @endcode
+ *
  * @tparam MLAlgorithm A machine learning algorithm.
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam MatType The type of data.
@@ -180,6 +192,36 @@ class KFoldCV
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get the maximum number of folds run at the same time (0 for no limit).
+  size_t MaxConcurrentFolds() const { return maxConcurrentFolds; }
+  //! Modify the maximum number of folds run at the same time (0 for no limit).
+  size_t& MaxConcurrentFolds() { return maxConcurrentFolds; }
+
+  /**
+   * Get the threshold for stopping an evaluation early.  When the folds run
+   * one after another and the mean of the first half of the folds is above the
+   * threshold, the remaining folds are skipped: Evaluate() returns that mean,
+   * and Model() is not updated.  The default is the largest double, so that
+   * every fold is evaluated.
+   */
+  double StopThreshold() const { return stopThreshold; }
+  //! Modify the threshold for stopping an evaluation early.
+  double& StopThreshold() { return stopThreshold; }
+
+  /**
+   * Get whether the models of each fold are trained from the models of the
+   * same fold in the previous call to Evaluate(), in the case of non-weighted
+   * learning.  This only makes a difference for algorithms that support warm
+   * starts (see WarmStartTraits), for which evaluating a sequence of close
+   * hyperparameters (like a regularization path) is then much cheaper.  The
+   * models of the k folds are kept between calls to Evaluate().
+   *
+   * The default value is false.
+   */
+  bool WarmStart() const { return warmStart; }
+  //! Modify whether the models of each fold are warm-started.
+  bool& WarmStart() { return warmStart; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -209,19 +251,34 @@ class KFoldCV
   //! The number of bins in the dataset.
   const size_t k;
 
-  //! The extended (by repeating the first k - 2 bins) data points.
+  //! The data points, rotated so that the current validation bin is last.
   MatType xs;
-  //! The extended (by repeating the first k - 2 bins) predictions.
+  //! The predictions, rotated like the data points.
   PredictionsType ys;
-  //! The extended (by repeating the first k - 2 bins) weights.
+  //! The weights, rotated like the data points.
   WeightsType weights;
 
-  //! The original size of the dataset.
+  //! The size of the last bin, which also holds the points left over.
   size_t lastBinSize;
 
   //! The size of each bin in terms of data points.
   size_t binSize;
 
+  //! The number of columns the dataset is rotated left by.
+  size_t rotation;
+
+  //! The maximum number of folds run at the same time (0 for no limit).
+  size_t maxConcurrentFolds;
+
+  //! The threshold for stopping an evaluation early.
+  double stopThreshold;
+
+  //! Whether the models of each fold are warm-started.
+  bool warmStart;
+
+  //! The models of each fold from the last evaluation, for warm starts.
+  std::vector<std::unique_ptr<MLAlgorithm>> warmStartModels;
+
   //! A pointer to a model from the last run of k-fold cross-validation.
   std::unique_ptr<MLAlgorithm> modelPtr;
 
@@ -247,12 +304,50 @@ class KFoldCV
           const bool shuffle);
 
   /**
-   * Initialize the given destination matrix with the given source joined with
-   * its first k - 2 bins.
+   * Initialize the given destination matrix with the given source, and the
+   * sizes of the bins.
    */
   template<typename DataType>
   void InitKFoldCVMat(const DataType& source, DataType& destination);
 
+  /**
+   * Rotate the given matrix, which is rotated left by 'rotation' columns, so
+   * that it is rotated left by the given number of columns instead.  Every
+   * training subset is then a block of contiguous columns, followed by its
+   * validation subset, so that no subset has to be copied.
+   */
+  template<typename DataType>
+  void Rotate(DataType& m, const size_t newRotation);
+
+  /**
+   * Calculate the number of folds to run at the same time, which is at most
+   * the number of threads.
+   */
+  inline size_t FoldConcurrency();
+
+  /**
+   * Draw a seed for the random stream of each fold, when the folds are run at
+   * the same time.  The results then don't depend on the order in which the
+   * threads run the folds.
+   */
+  inline std::vector<std::mt19937::result_type> FoldSeeds();
+
+  /**
+   * Check whether the evaluation should stop after the ith fold, given the
+   * evaluations of the folds so far.
+   */
+  inline bool StopEarly(const arma::vec& evaluations, const size_t i);
+
+  /**
+   * Train a model on the ith training subset, starting from the model of the
+   * ith fold of the previous evaluation if warm starts are enabled.
+   */
+  template<typename... MLAlgorithmArgs>
+  MLAlgorithm TrainFold(const size_t i,
+                        const MatType& trainingXs,
+                        const PredictionsType& trainingYs,
+                        const MLAlgorithmArgs&... args);
+
   /**
    * Train and run evaluation in the case of non-weighted learning.
    */
@@ -271,40 +366,82 @@ class KFoldCV
   double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
   /**
-   * Calculate the index of the first column of the ith validation subset.
+   * Calculate the number of columns the dataset has to be rotated left by for
+   * the ith training and validation subsets.
    *
-   * We take the ith validation subset after the ith training subset if
-   * i < k - 1 and before it otherwise.
+   * The ith validation subset is the (i - 1)th bin if i > 0 and the last bin
+   * otherwise; the ith training subset is made of the following bins.
+   */
+  inline size_t FoldRotation(const size_t i);
+
+  /**
+   * Calculate the size of the ith validation subset.
    */
-  inline size_t ValidationSubsetFirstCol(const size_t i);
+  inline size_t ValidationSubsetSize(const size_t i);
 
   /**
-   * Get the ith training subset from a variable of a matrix type.
+   * Get the ith training subset from a variable of a matrix type, which must
+   * be rotated for the ith fold.
    */
   template<typename ElementType>
   inline arma::Mat<ElementType> GetTrainingSubset(arma::Mat<ElementType>& m,
                                                   const size_t i);
 
   /**
-   * Get the ith training subset from a variable of a row type.
+   * Get the ith training subset from a variable of a row type, which must be
+   * rotated for the ith fold.
    */
   template<typename ElementType>
   inline arma::Row<ElementType> GetTrainingSubset(arma::Row<ElementType>& r,
                                                   const size_t i);
 
   /**
-   * Get the ith validation subset from a variable of a matrix type.
+   * Get the ith validation subset from a variable of a matrix type, which must
+   * be rotated for the ith fold.
    */
   template<typename ElementType>
   inline arma::Mat<ElementType> GetValidationSubset(arma::Mat<ElementType>& m,
                                                     const size_t i);
 
   /**
-   * Get the ith validation subset from a variable of a row type.
+   * Get the ith validation subset from a variable of a row type, which must be
+   * rotated for the ith fold.
    */
   template<typename ElementType>
   inline arma::Row<ElementType> GetValidationSubset(arma::Row<ElementType>& r,
                                                     const size_t i);
+
+  /**
+   * Copy the ith training subset from the given matrix or row, which must not
+   * be rotated.  The points are in the same order as in GetTrainingSubset(),
+   * so that the trained models are the same.
+   */
+  template<typename DataType>
+  DataType CopyTrainingSubset(const DataType& m, const size_t i);
+
+  /**
+   * Calculate the index of the first point of the ith validation subset in the
+   * dataset of the given size, when the dataset is not rotated.
+   */
+  inline size_t ValidationSubsetStart(const size_t i, const size_t n);
+
+  /**
+   * Get the ith validation subset from a variable of a matrix type, which must
+   * not be rotated.
+   */
+  template<typename ElementType>
+  inline arma::Mat<ElementType> GetUnrotatedValidationSubset(
+      arma::Mat<ElementType>& m,
+      const size_t i);
+
+  /**
+   * Get the ith validation subset from a variable of a row type, which must
+   * not be rotated.
+   */
+  template<typename ElementType>
+  inline arma::Row<ElementType> GetUnrotatedValidationSubset(
+      arma::Row<ElementType>& r,
+      const size_t i);
 };
 
 } // namespace cv
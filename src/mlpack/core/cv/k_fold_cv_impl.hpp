@@ -135,7 +135,10 @@ KFoldCV<MLAlgorithm,
                               const PredictionsType& ys,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    maxConcurrentFolds(1),
+    stopThreshold(std::numeric_limits<double>::max()),
+    warmStart(false)
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -166,7 +169,10 @@ KFoldCV<MLAlgorithm,
                               const WeightsType& weights,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    maxConcurrentFolds(1),
+    stopThreshold(std::numeric_limits<double>::max()),
+    warmStart(false)
 {
   Base::AssertWeightsConsistency(xs, weights);
 
@@ -227,9 +233,118 @@ void KFoldCV<MLAlgorithm,
 {
   binSize = source.n_cols / k;
   lastBinSize = source.n_cols - ((k - 1) * binSize);
+  rotation = 0;
 
-  destination = (k == 2) ? source : arma::join_rows(source,
-      source.cols(0, source.n_cols - lastBinSize - 1));
+  destination = source;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename DataType>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::Rotate(DataType& m, const size_t newRotation)
+{
+  if (m.n_cols == 0)
+    return;
+
+  // The columns are contiguous, so rotating the columns is rotating the
+  // elements.
+  const size_t shift = (newRotation + m.n_cols - rotation) % m.n_cols;
+  std::rotate(m.memptr(), m.memptr() + shift * m.n_rows,
+      m.memptr() + m.n_elem);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::FoldConcurrency()
+{
+  const size_t limit = (maxConcurrentFolds == 0) ? k : maxConcurrentFolds;
+  return std::min(std::min(limit, k), NumThreads());
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+std::vector<std::mt19937::result_type> KFoldCV<MLAlgorithm,
+                                               Metric,
+                                               MatType,
+                                               PredictionsType,
+                                               WeightsType>::FoldSeeds()
+{
+  std::vector<std::mt19937::result_type> seeds(k);
+  for (size_t i = 0; i < k; ++i)
+    seeds[i] = math::randGen();
+
+  return seeds;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+bool KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::StopEarly(const arma::vec& evaluations,
+                                     const size_t i)
+{
+  // Like a round of successive halving, the configuration only gets the
+  // remaining folds if it does well enough on the first half.
+  const size_t halfFolds = (k + 1) / 2;
+  if (i + 1 != halfFolds || halfFolds == k)
+    return false;
+
+  return arma::mean(evaluations.head(halfFolds)) > stopThreshold;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+MLAlgorithm KFoldCV<MLAlgorithm,
+                    Metric,
+                    MatType,
+                    PredictionsType,
+                    WeightsType>::TrainFold(const size_t i,
+                                            const MatType& trainingXs,
+                                            const PredictionsType& trainingYs,
+                                            const MLAlgorithmArgs&... args)
+{
+  if (!warmStart)
+    return base.Train(trainingXs, trainingYs, args...);
+
+  // Only the ith fold uses the ith model, so this is safe when the folds run
+  // at the same time.
+  if (warmStartModels[i] == nullptr)
+  {
+    warmStartModels[i].reset(new MLAlgorithm(base.Train(trainingXs,
+        trainingYs, args...)));
+  }
+  else
+  {
+    base.TrainFrom(*warmStartModels[i], trainingXs, trainingYs, args...);
+  }
+
+  return MLAlgorithm(*warmStartModels[i]);
 }
 
 template<typename MLAlgorithm,
@@ -245,18 +360,60 @@ double KFoldCV<MLAlgorithm,
                 WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
 {
   arma::vec evaluations(k);
+  if (warmStart)
+    warmStartModels.resize(k);
+
+  const size_t concurrency = FoldConcurrency();
+  if (concurrency > 1)
+  {
+    // Every fold copies its training subset out of the unrotated dataset, so
+    // that the folds can run at the same time.
+    const std::vector<std::mt19937::result_type> seeds = FoldSeeds();
+
+    #pragma omp parallel for schedule(dynamic) num_threads(concurrency)
+    for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
+    {
+      math::RandomStream stream(seeds[i]);
+
+      MLAlgorithm&& model = TrainFold(i, CopyTrainingSubset(xs, i),
+          CopyTrainingSubset(ys, i), args...);
+      evaluations(i) = Metric::Evaluate(model,
+          GetUnrotatedValidationSubset(xs, i),
+          GetUnrotatedValidationSubset(ys, i));
+      if ((size_t) i == k - 1)
+        modelPtr.reset(new MLAlgorithm(std::move(model)));
+    }
+
+    return arma::mean(evaluations);
+  }
 
+  size_t evaluated = k;
   for (size_t i = 0; i < k; ++i)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
+    Rotate(xs, FoldRotation(i));
+    Rotate(ys, FoldRotation(i));
+    rotation = FoldRotation(i);
+
+    MLAlgorithm&& model = TrainFold(i, GetTrainingSubset(xs, i),
         GetTrainingSubset(ys, i), args...);
     evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
         GetValidationSubset(ys, i));
     if (i == k - 1)
       modelPtr.reset(new MLAlgorithm(std::move(model)));
+
+    if (StopEarly(evaluations, i))
+    {
+      evaluated = i + 1;
+      break;
+    }
   }
 
-  return arma::mean(evaluations);
+  // Restore the original order of the dataset.
+  Rotate(xs, 0);
+  Rotate(ys, 0);
+  rotation = 0;
+
+  return arma::mean(evaluations.head(evaluated));
 }
 
 template<typename MLAlgorithm,
@@ -273,8 +430,42 @@ double KFoldCV<MLAlgorithm,
 {
   arma::vec evaluations(k);
 
+  const size_t concurrency = FoldConcurrency();
+  if (concurrency > 1)
+  {
+    // Every fold copies its training subset out of the unrotated dataset, so
+    // that the folds can run at the same time.
+    const std::vector<std::mt19937::result_type> seeds = FoldSeeds();
+
+    #pragma omp parallel for schedule(dynamic) num_threads(concurrency)
+    for (omp_size_t i = 0; i < (omp_size_t) k; ++i)
+    {
+      math::RandomStream stream(seeds[i]);
+
+      MLAlgorithm&& model = (weights.n_elem > 0) ?
+          base.Train(CopyTrainingSubset(xs, i), CopyTrainingSubset(ys, i),
+              CopyTrainingSubset(weights, i), args...) :
+          base.Train(CopyTrainingSubset(xs, i), CopyTrainingSubset(ys, i),
+              args...);
+      evaluations(i) = Metric::Evaluate(model,
+          GetUnrotatedValidationSubset(xs, i),
+          GetUnrotatedValidationSubset(ys, i));
+      if ((size_t) i == k - 1)
+        modelPtr.reset(new MLAlgorithm(std::move(model)));
+    }
+
+    return arma::mean(evaluations);
+  }
+
+  size_t evaluated = k;
   for (size_t i = 0; i < k; ++i)
   {
+    Rotate(xs, FoldRotation(i));
+    Rotate(ys, FoldRotation(i));
+    if (weights.n_elem > 0)
+      Rotate(weights, FoldRotation(i));
+    rotation = FoldRotation(i);
+
     MLAlgorithm&& model = (weights.n_elem > 0) ?
         base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
             GetTrainingSubset(weights, i), args...) :
@@ -284,9 +475,22 @@ double KFoldCV<MLAlgorithm,
         GetValidationSubset(ys, i));
     if (i == k - 1)
       modelPtr.reset(new MLAlgorithm(std::move(model)));
+
+    if (StopEarly(evaluations, i))
+    {
+      evaluated = i + 1;
+      break;
+    }
   }
 
-  return arma::mean(evaluations);
+  // Restore the original order of the dataset.
+  Rotate(xs, 0);
+  Rotate(ys, 0);
+  if (weights.n_elem > 0)
+    Rotate(weights, 0);
+  rotation = 0;
+
+  return arma::mean(evaluations.head(evaluated));
 }
 
 template<typename MLAlgorithm,
@@ -301,14 +505,11 @@ void KFoldCV<MLAlgorithm,
              PredictionsType,
              WeightsType>::Shuffle()
 {
-  MatType xsOrig = xs.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  PredictionsType ysOrig = ys.cols(0, (k - 1) * binSize + lastBinSize - 1);
-
-  // Now shuffle the data.
-  math::ShuffleData(xsOrig, ysOrig, xsOrig, ysOrig);
-
-  InitKFoldCVMat(xsOrig, xs);
-  InitKFoldCVMat(ysOrig, ys);
+  // The points are shuffled, so their rotation doesn't matter, and the models
+  // of the folds can't be warm-started anymore.
+  math::ShuffleDataInPlace(xs, ys);
+  rotation = 0;
+  warmStartModels.clear();
 }
 
 template<typename MLAlgorithm,
@@ -323,22 +524,29 @@ void KFoldCV<MLAlgorithm,
              PredictionsType,
              WeightsType>::Shuffle()
 {
-  MatType xsOrig = xs.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  PredictionsType ysOrig = ys.cols(0, (k - 1) * binSize + lastBinSize - 1);
-  WeightsType weightsOrig;
-  if (weights.n_elem > 0)
-    weightsOrig = weights.cols(0, (k - 1) * binSize + lastBinSize - 1);
-
-  // Now shuffle the data.
+  // The points are shuffled, so their rotation doesn't matter, and the models
+  // of the folds can't be warm-started anymore.
   if (weights.n_elem > 0)
-    math::ShuffleData(xsOrig, ysOrig, weightsOrig, xsOrig, ysOrig, weightsOrig);
+    math::ShuffleDataInPlace(xs, ys, weights);
   else
-    math::ShuffleData(xsOrig, ysOrig, xsOrig, ysOrig);
+    math::ShuffleDataInPlace(xs, ys);
+  rotation = 0;
+  warmStartModels.clear();
+}
 
-  InitKFoldCVMat(xsOrig, xs);
-  InitKFoldCVMat(ysOrig, ys);
-  if (weights.n_elem > 0)
-    InitKFoldCVMat(weightsOrig, weights);
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::FoldRotation(const size_t i)
+{
+  // The bins before the ith training subset all have binSize points.
+  return binSize * i;
 }
 
 template<typename MLAlgorithm,
@@ -350,10 +558,9 @@ size_t KFoldCV<MLAlgorithm,
                Metric,
                MatType,
                PredictionsType,
-               WeightsType>::ValidationSubsetFirstCol(const size_t i)
+               WeightsType>::ValidationSubsetSize(const size_t i)
 {
-  // Use as close to the beginning of the dataset as we can.
-  return (i == 0) ? binSize * (k - 1) : binSize * (i - 1);
+  return (i == 0) ? lastBinSize : binSize;
 }
 
 template<typename MLAlgorithm,
@@ -370,14 +577,8 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
     arma::Mat<ElementType>& m,
     const size_t i)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
-
-  return arma::Mat<ElementType>(m.colptr(binSize * i), m.n_rows, subsetSize,
-      false, true);
+  return arma::Mat<ElementType>(m.memptr(), m.n_rows,
+      m.n_cols - ValidationSubsetSize(i), false, true);
 }
 
 template<typename MLAlgorithm,
@@ -394,13 +595,8 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
     arma::Row<ElementType>& r,
     const size_t i)
 {
-  // If this is not the first fold, we have to handle it a little bit
-  // differently, since the last fold may contain slightly more than 'binSize'
-  // points.
-  const size_t subsetSize = (i != 0) ? lastBinSize + (k - 2) * binSize :
-      (k - 1) * binSize;
-
-  return arma::Row<ElementType>(r.colptr(binSize * i), subsetSize, false, true);
+  return arma::Row<ElementType>(r.memptr(), r.n_cols - ValidationSubsetSize(i),
+      false, true);
 }
 
 template<typename MLAlgorithm,
@@ -417,8 +613,8 @@ arma::Mat<ElementType> KFoldCV<MLAlgorithm,
     arma::Mat<ElementType>& m,
     const size_t i)
 {
-  const size_t subsetSize = (i == 0) ? lastBinSize : binSize;
-  return arma::Mat<ElementType>(m.colptr(ValidationSubsetFirstCol(i)), m.n_rows,
+  const size_t subsetSize = ValidationSubsetSize(i);
+  return arma::Mat<ElementType>(m.colptr(m.n_cols - subsetSize), m.n_rows,
       subsetSize, false, true);
 }
 
@@ -436,9 +632,89 @@ arma::Row<ElementType> KFoldCV<MLAlgorithm,
     arma::Row<ElementType>& r,
     const size_t i)
 {
-  const size_t subsetSize = (i == 0) ? lastBinSize : binSize;
-  return arma::Row<ElementType>(r.colptr(ValidationSubsetFirstCol(i)),
-      subsetSize, false, true);
+  const size_t subsetSize = ValidationSubsetSize(i);
+  return arma::Row<ElementType>(r.colptr(r.n_cols - subsetSize), subsetSize,
+      false, true);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename DataType>
+DataType KFoldCV<MLAlgorithm,
+                 Metric,
+                 MatType,
+                 PredictionsType,
+                 WeightsType>::CopyTrainingSubset(const DataType& m,
+                                                  const size_t i)
+{
+  // The 0th training subset is made of the first bins.
+  const size_t subsetSize = m.n_cols - ValidationSubsetSize(i);
+  if (i == 0)
+    return m.cols(0, subsetSize - 1);
+
+  // Otherwise it is made of the bins after the validation subset, followed by
+  // the bins before it, as in the rotated dataset.
+  DataType subset(m.n_rows, subsetSize);
+  const size_t after = m.n_cols - FoldRotation(i);
+  subset.cols(0, after - 1) = m.cols(FoldRotation(i), m.n_cols - 1);
+  if (after < subsetSize)
+    subset.cols(after, subsetSize - 1) = m.cols(0, subsetSize - after - 1);
+
+  return subset;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+size_t KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::ValidationSubsetStart(const size_t i,
+                                                   const size_t n)
+{
+  return (i == 0) ? n - lastBinSize : FoldRotation(i) - binSize;
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename ElementType>
+arma::Mat<ElementType> KFoldCV<MLAlgorithm,
+                               Metric,
+                               MatType,
+                               PredictionsType,
+                               WeightsType>::GetUnrotatedValidationSubset(
+    arma::Mat<ElementType>& m,
+    const size_t i)
+{
+  return arma::Mat<ElementType>(m.colptr(ValidationSubsetStart(i, m.n_cols)),
+      m.n_rows, ValidationSubsetSize(i), false, true);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename ElementType>
+arma::Row<ElementType> KFoldCV<MLAlgorithm,
+                               Metric,
+                               MatType,
+                               PredictionsType,
+                               WeightsType>::GetUnrotatedValidationSubset(
+    arma::Row<ElementType>& r,
+    const size_t i)
+{
+  return arma::Row<ElementType>(r.colptr(ValidationSubsetStart(i, r.n_cols)),
+      ValidationSubsetSize(i), false, true);
 }
 
 } // namespace cv
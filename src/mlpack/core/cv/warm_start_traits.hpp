@@ -0,0 +1,56 @@
+/**
+ * @file warm_start_traits.hpp
+ *
+ * The WarmStartTraits class, which tells the cross-validation classes how to
+ * retrain a model from a previously trained one.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CV_WARM_START_TRAITS_HPP
+#define MLPACK_CORE_CV_WARM_START_TRAITS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace cv {
+
+/**
+ * By default, models of the given MLAlgorithm are always trained from scratch.
+ * Iterative algorithms can opt in to warm starts by specializing this class
+ * with IsSupported set to true and a static Train() function:
+ *
+ * @code
+ * template<>
+ * struct WarmStartTraits<MyAlgorithm>
+ * {
+ *   static const bool IsSupported = true;
+ *
+ *   // Set the hyperparameters on the model, and train it from its current
+ *   // parameters.  The arguments are the ones that the constructor of
+ *   // MyAlgorithm would take.
+ *   static void Train(MyAlgorithm& model,
+ *                     const arma::mat& xs,
+ *                     const arma::Row<size_t>& ys,
+ *                     const double lambda = 0.1);
+ * };
+ * @endcode
+ *
+ * The model passed to Train() was trained on the same fold, with other
+ * hyperparameters.
+ *
+ * @tparam MLAlgorithm A machine learning algorithm.
+ */
+template<typename MLAlgorithm>
+struct WarmStartTraits
+{
+  //! Whether a model can be retrained from a previously trained model.
+  static const bool IsSupported = false;
+};
+
+} // namespace cv
+} // namespace mlpack
+
+#endif
@@ -86,6 +86,61 @@ void Binarize(const arma::Mat<T>& input,
     output(dimension, i) = input(dimension, i) > threshold;
 }
 
+/**
+ * Given an input dataset and threshold, set values greater than threshold to
+ * 1 and values less than or equal to the threshold to 0, in place.  This
+ * overload applies the changes to all dimensions.
+ *
+ * @code
+ * arma::Mat<double> input = loadData();
+ * double threshold = 0.5;
+ *
+ * // Binarize the whole Matrix without making a copy of it.
+ * Binarize<double>(input, threshold);
+ * @endcode
+ *
+ * @param input Input matrix to Binarize; it is overwritten with the result.
+ * @param threshold Threshold can by any number.
+ */
+template<typename T>
+void Binarize(arma::Mat<T>& input, const double threshold)
+{
+  T *ptr = input.memptr();
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_elem; ++i)
+    ptr[i] = ptr[i] > threshold;
+}
+
+/**
+ * Given an input dataset and threshold, set values greater than threshold to
+ * 1 and values less than or equal to the threshold to 0, in place.  This
+ * overload takes a dimension and applys the changes to the given dimension;
+ * the other dimensions are left untouched.
+ *
+ * @code
+ * arma::Mat<double> input = loadData();
+ * double threshold = 0.5;
+ * size_t dimension = 0;
+ *
+ * // Binarize the first dimension without making a copy of the matrix.
+ * Binarize<double>(input, threshold, dimension);
+ * @endcode
+ *
+ * @param input Input matrix to Binarize; it is overwritten with the result.
+ * @param threshold Threshold can by any number.
+ * @param dimension Feature to apply the Binarize function.
+ */
+template<typename T>
+void Binarize(arma::Mat<T>& input,
+              const double threshold,
+              const size_t dimension)
+{
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    input(dimension, i) = input(dimension, i) > threshold;
+}
+
 } // namespace data
 } // namespace mlpack
 
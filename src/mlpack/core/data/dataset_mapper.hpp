@@ -19,6 +19,7 @@
 #include <unordered_map>
 
 #include "map_policies/increment_policy.hpp"
+#include "mapping_table.hpp"
 
 namespace mlpack {
 namespace data {
@@ -87,6 +88,20 @@ class DatasetMapper
   T MapString(const InputType& input,
               const size_t dimension);
 
+  /**
+   * Given the characters of an input and the dimension to which it belongs,
+   * return its numeric mapping, like MapString(const InputType&, size_t).  An
+   * input that is already mapped is looked up without building a std::string,
+   * so this is only available when InputType is std::string.
+   *
+   * @tparam T Numeric type to map to (int/double/float/etc.).
+   * @param begin First character of the input.
+   * @param end Character after the last character of the input.
+   * @param dimension Index of the dimension of the string.
+   */
+  template<typename T>
+  T MapString(const char* begin, const char* end, const size_t dimension);
+
   /**
    * Return the input that corresponds to a given value in a given dimension.
    * If the value is not a valid mapping in the given dimension, a
@@ -151,11 +166,7 @@ class DatasetMapper
    * Serialize the dataset information.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */)
-  {
-    ar & BOOST_SERIALIZATION_NVP(types);
-    ar & BOOST_SERIALIZATION_NVP(maps);
-  }
+  void serialize(Archive& ar, const unsigned int /* version */);
 
   //! Return the policy of the mapper.
   const PolicyType& Policy() const;
@@ -169,20 +180,12 @@ class DatasetMapper
   //! Types of each dimension.
   std::vector<Datatype> types;
 
-  // Forward mapping type.
-  using ForwardMapType = typename std::unordered_map<InputType, typename
-      PolicyType::MappedType>;
-
-  // Reverse mapping type.  Multiple inputs may map to a single output, hence
-  // the need for std::vector.
-  using ReverseMapType = std::unordered_map<typename PolicyType::MappedType,
-      std::vector<InputType>>;
+  // Mappings from inputs to values of a single dimension.
+  using TableType = MappingTable<InputType, typename PolicyType::MappedType>;
 
-  // Mappings from strings to integers.
-  // Map entries will only exist for dimensions that are categorical.
-  // MapType = map<dimension, pair<bimap<string, MappedType>, numMappings>>
-  using MapType = std::unordered_map<size_t, std::pair<ForwardMapType,
-      ReverseMapType>>;
+  // Mappings from strings to integers, indexed by dimension.
+  // Tables will only be non-empty for dimensions that are categorical.
+  using MapType = std::vector<TableType>;
 
   //! maps object stores string and numerical pairs.
   MapType maps;
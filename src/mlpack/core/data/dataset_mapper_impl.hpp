@@ -89,36 +89,17 @@ inline T DatasetMapper<PolicyType, InputType>::MapString(
   return policy.template MapString<MapType, T>(input, dimension, maps, types);
 }
 
-/**
- * A safe version of isnan() that only gets called when the type has a NaN at
- * all.  This is a workaround for Visual Studio, which doesn't seem to support
- * isnan(size_t).
- */
+template<typename PolicyType, typename InputType>
 template<typename T>
-inline bool isnanSafe(const T& /* t */)
-{
-  return false;
-}
-
-template<>
-inline bool isnanSafe(const double& t)
-{
-  return std::isnan(t);
-}
-
-template<>
-inline bool isnanSafe(const float& t)
-{
-  return std::isnan(t);
-}
-
-template<>
-inline bool isnanSafe(const long double& t)
+inline T DatasetMapper<PolicyType, InputType>::MapString(
+    const char* begin,
+    const char* end,
+    const size_t dimension)
 {
-  return std::isnan(t);
+  return policy.template MapString<MapType, T>(begin, end, dimension, maps,
+      types);
 }
 
-
 // Return the input corresponding to a value in a given dimension.
 template<typename PolicyType, typename InputType>
 template<typename T>
@@ -127,14 +108,10 @@ inline const InputType& DatasetMapper<PolicyType, InputType>::UnmapString(
     const size_t dimension,
     const size_t unmappingIndex) const
 {
-  // If the value is std::numeric_limits<T>::quiet_NaN(), we can't use it as a
-  // key---so we will use something else...
-  const T usedValue = isnanSafe(value) ?
-      std::nexttoward(std::numeric_limits<T>::max(), T(0)) :
-      value;
+  const size_t numUnmappings = NumUnmappings(value, dimension);
 
   // Throw an exception if the value doesn't exist.
-  if (maps.at(dimension).second.count(usedValue) == 0)
+  if (numUnmappings == 0)
   {
     std::ostringstream oss;
     oss << "DatasetMapper<PolicyType, InputType>::UnmapString(): value '"
@@ -142,17 +119,16 @@ inline const InputType& DatasetMapper<PolicyType, InputType>::UnmapString(
     throw std::invalid_argument(oss.str());
   }
 
-  if (unmappingIndex >= maps.at(dimension).second.at(usedValue).size())
+  if (unmappingIndex >= numUnmappings)
   {
     std::ostringstream oss;
     oss << "DatasetMapper<PolicyType, InputType>::UnmapString(): value '"
-        << value << "' only has "
-        << maps.at(dimension).second.at(usedValue).size()
-        << " unmappings, but unmappingIndex is " << unmappingIndex << "!";
+        << value << "' only has " << numUnmappings << " unmappings, but "
+        << "unmappingIndex is " << unmappingIndex << "!";
     throw std::invalid_argument(oss.str());
   }
 
-  return maps.at(dimension).second.at(usedValue)[unmappingIndex];
+  return maps[dimension].Unmap(value, unmappingIndex);
 }
 
 template<typename PolicyType, typename InputType>
@@ -161,15 +137,10 @@ inline size_t DatasetMapper<PolicyType, InputType>::NumUnmappings(
     const T value,
     const size_t dimension) const
 {
-  // If the value is std::numeric_limits<T>::quiet_NaN(), we can't use it as a
-  // key---so we will use something else...
-  if (isnanSafe(value))
-  {
-    const T newValue = std::nexttoward(std::numeric_limits<T>::max(), T(0));
-    return maps.at(dimension).second.at(newValue).size();
-  }
+  if (dimension >= maps.size())
+    return 0;
 
-  return maps.at(dimension).second.at(value).size();
+  return maps[dimension].NumUnmappings(value);
 }
 
 // Return the value corresponding to an input in a given dimension.
@@ -179,8 +150,11 @@ DatasetMapper<PolicyType, InputType>::UnmapValue(
     const InputType& input,
     const size_t dimension)
 {
+  const typename PolicyType::MappedType* value = (dimension < maps.size()) ?
+      maps[dimension].Find(input) : NULL;
+
   // Throw an exception if the value doesn't exist.
-  if (maps[dimension].first.count(input) == 0)
+  if (value == NULL)
   {
     std::ostringstream oss;
     oss << "DatasetMapper<PolicyType, InputType>::UnmapValue(): input '"
@@ -188,7 +162,7 @@ DatasetMapper<PolicyType, InputType>::UnmapValue(
     throw std::invalid_argument(oss.str());
   }
 
-  return maps[dimension].first.at(input);
+  return *value;
 }
 
 // Get the type of a particular dimension.
@@ -221,7 +195,7 @@ template<typename PolicyType, typename InputType>
 inline size_t
 DatasetMapper<PolicyType, InputType>::NumMappings(const size_t dimension) const
 {
-  return (maps.count(dimension) == 0) ? 0 : maps.at(dimension).first.size();
+  return (dimension < maps.size()) ? maps[dimension].Size() : 0;
 }
 
 template<typename PolicyType, typename InputType>
@@ -230,6 +204,68 @@ inline size_t DatasetMapper<PolicyType, InputType>::Dimensionality() const
   return types.size();
 }
 
+template<typename PolicyType, typename InputType>
+template<typename Archive>
+void DatasetMapper<PolicyType, InputType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  using MappedType = typename PolicyType::MappedType;
+
+  // The mappings are serialized as a forward and a reverse map for each
+  // dimension, so that the archives of earlier versions can still be loaded.
+  // NaN can't be a key of the reverse map, so it is replaced by the largest
+  // value before the maximum.
+  using ForwardMapType = std::unordered_map<InputType, MappedType>;
+  using ReverseMapType = std::unordered_map<MappedType,
+      std::vector<InputType>>;
+  const MappedType nanValue = std::nexttoward(
+      std::numeric_limits<MappedType>::max(), MappedType(0));
+
+  std::unordered_map<size_t, std::pair<ForwardMapType, ReverseMapType>>
+      oldMaps;
+  if (Archive::is_saving::value)
+  {
+    for (size_t d = 0; d < maps.size(); ++d)
+    {
+      for (size_t i = 0; i < maps[d].Size(); ++i)
+      {
+        const MappedType& value = maps[d].Value(i);
+        oldMaps[d].first[maps[d].Key(i)] = value;
+        oldMaps[d].second[isnanSafe(value) ? nanValue : value].push_back(
+            maps[d].Key(i));
+      }
+    }
+  }
+
+  ar & BOOST_SERIALIZATION_NVP(types);
+  ar & boost::serialization::make_nvp("maps", oldMaps);
+
+  if (Archive::is_loading::value)
+  {
+    maps.clear();
+    for (auto& dimensionMaps : oldMaps)
+    {
+      if (dimensionMaps.first >= maps.size())
+        maps.resize(dimensionMaps.first + 1);
+
+      // Insert the keys in the order of the reverse mappings, which is the
+      // order they were mapped in.
+      std::vector<MappedType> values;
+      for (const auto& reverse : dimensionMaps.second.second)
+        values.push_back(reverse.first);
+      std::sort(values.begin(), values.end());
+
+      TableType& table = maps[dimensionMaps.first];
+      for (const MappedType& value : values)
+      {
+        for (const InputType& key : dimensionMaps.second.second.at(value))
+          table.Insert(key, dimensionMaps.second.first.at(key));
+      }
+    }
+  }
+}
+
 template<typename PolicyType, typename InputType>
 inline const PolicyType& DatasetMapper<PolicyType, InputType>::Policy() const
 {
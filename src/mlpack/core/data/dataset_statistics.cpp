@@ -0,0 +1,85 @@
+/**
+ * @file dataset_statistics.cpp
+ *
+ * Implementation of the DatasetStatistics class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "dataset_statistics.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+DatasetStatistics::DatasetStatistics(const size_t dimensionality,
+                                     const size_t sketchSize) :
+    sketchSize(sketchSize),
+    count(0),
+    moments(dimensionality),
+    sketches(dimensionality, QuantileSketch(sketchSize))
+{
+  // Nothing to do.
+}
+
+void DatasetStatistics::Add(const arma::mat& points)
+{
+  if (points.n_rows != moments.size())
+  {
+    std::ostringstream oss;
+    oss << "DatasetStatistics::Add(): points have " << points.n_rows
+        << " dimensions, but statistics have " << moments.size()
+        << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t numBlocks = (points.n_cols + blockSize - 1) / blockSize;
+  if (numBlocks == 0)
+    return;
+
+  // The statistics of each block are computed from scratch, and merged into
+  // these ones in order.
+  std::vector<DatasetStatistics> blocks(numBlocks,
+      DatasetStatistics(moments.size(), sketchSize));
+
+  #pragma omp parallel for schedule(dynamic) if (numBlocks > 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) points.n_cols);
+    DatasetStatistics& block = blocks[b];
+    for (size_t i = begin; i < end; ++i)
+    {
+      const double* point = points.colptr(i);
+      for (size_t d = 0; d < points.n_rows; ++d)
+      {
+        block.moments[d].Add(point[d]);
+        block.sketches[d].Add(point[d]);
+      }
+    }
+    block.count = end - begin;
+  }
+
+  for (size_t b = 0; b < numBlocks; ++b)
+    Merge(blocks[b]);
+}
+
+void DatasetStatistics::Merge(const DatasetStatistics& other)
+{
+  if (other.moments.size() != moments.size())
+  {
+    std::ostringstream oss;
+    oss << "DatasetStatistics::Merge(): other statistics have "
+        << other.moments.size() << " dimensions, but statistics have "
+        << moments.size() << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  for (size_t d = 0; d < moments.size(); ++d)
+  {
+    moments[d].Merge(other.moments[d]);
+    sketches[d].Merge(other.sketches[d]);
+  }
+  count += other.count;
+}
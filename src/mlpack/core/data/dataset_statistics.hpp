@@ -0,0 +1,117 @@
+/**
+ * @file dataset_statistics.hpp
+ *
+ * Definition of the DatasetStatistics class, which computes the descriptive
+ * statistics of each dimension of a dataset in one pass over chunks of
+ * points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_DATASET_STATISTICS_HPP
+#define MLPACK_CORE_DATA_DATASET_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "quantile_sketch.hpp"
+#include "running_moments.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Keep the moments (see RunningMoments) and a quantile sketch (see
+ * QuantileSketch) of each dimension of the points added so far, so that the
+ * descriptive statistics of a dataset that doesn't fit in memory can be
+ * computed in one pass:
+ *
+ * @code
+ * data::MatrixReader reader("dataset.csv");
+ * data::DatasetStatistics statistics(reader.Dimensionality());
+ * arma::mat batch;
+ * while (reader.NextBatch(batch, 100000))
+ *   statistics.Add(batch);
+ *
+ * const double mean = statistics.Moments(0).Mean();
+ * const double median = statistics.Quantiles(0).Quantile(0.5);
+ * @endcode
+ *
+ * Each chunk passed to Add() is split into blocks of points whose statistics
+ * are computed in parallel with OpenMP, and then merged in the order of the
+ * blocks, so the results don't depend on the number of threads.
+ */
+class DatasetStatistics
+{
+ public:
+  /**
+   * Create empty statistics for points of the given dimensionality.
+   *
+   * @param dimensionality Number of dimensions of each point.
+   * @param sketchSize The capacity of the quantile sketches; see
+   *     QuantileSketch.
+   */
+  DatasetStatistics(const size_t dimensionality = 0,
+                    const size_t sketchSize = 200);
+
+  /**
+   * Add the given points to the statistics.
+   *
+   * @param points Matrix of points, one per column.
+   */
+  void Add(const arma::mat& points);
+
+  /**
+   * Merge the statistics of other points into these ones.  The other
+   * statistics must have the same dimensionality.
+   *
+   * @param other Statistics to merge.
+   */
+  void Merge(const DatasetStatistics& other);
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return moments.size(); }
+  //! Get the capacity of the quantile sketches.
+  size_t SketchSize() const { return sketchSize; }
+  //! Get the number of points added so far.
+  size_t Count() const { return count; }
+
+  //! Get the moments of the given dimension.
+  const RunningMoments& Moments(const size_t dimension) const
+  { return moments[dimension]; }
+  //! Get the quantile sketch of the given dimension.
+  const QuantileSketch& Quantiles(const size_t dimension) const
+  { return sketches[dimension]; }
+
+  /**
+   * Serialize the statistics, so that a pass over the data can be resumed.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(sketchSize);
+    ar & BOOST_SERIALIZATION_NVP(count);
+    ar & BOOST_SERIALIZATION_NVP(moments);
+    ar & BOOST_SERIALIZATION_NVP(sketches);
+  }
+
+ private:
+  //! Number of points in each block whose statistics are computed by one
+  //! thread.
+  static const size_t blockSize = 4096;
+
+  //! The capacity of the quantile sketches.
+  size_t sketchSize;
+  //! The number of points.
+  size_t count;
+  //! The moments of each dimension.
+  std::vector<RunningMoments> moments;
+  //! The quantile sketch of each dimension.
+  std::vector<QuantileSketch> sketches;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -22,7 +22,8 @@ enum format
   autodetect,
   text,
   xml,
-  binary
+  binary,
+  mapped
 };
 
 } // namespace data
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_CUSTOM_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "replace_missing.hpp"
 
 namespace mlpack {
 namespace data {
@@ -46,29 +47,26 @@ class CustomImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    // replace the target value to custom value
-    if (columnMajor)
-    {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          input(dimension, i) = customValue;
-        }
-      }
-    }
-    else
-    {
-      for (size_t i = 0; i < input.n_rows; ++i)
-      {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          input(i, dimension) = customValue;
-        }
-      }
-    }
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
+
+  /**
+   * Replace the missing values of each of the given dimensions with the custom
+   * value, in a single parallel pass over the input.
+   *
+   * @param input Matrix that contains the missing values.
+   * @param mappedValues The mapped value of each dimension.
+   * @param dimensions The dimensions to impute; they must be distinct.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    ReplaceMissing(input, mappedValues, dimensions,
+        std::vector<T>(dimensions.size(), customValue), columnMajor);
   }
 
  private:
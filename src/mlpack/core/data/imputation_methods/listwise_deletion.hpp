@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_LISTWISE_DELETION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "replace_missing.hpp"
 
 namespace mlpack {
 namespace data {
@@ -39,31 +40,74 @@ class ListwiseDeletion
               const size_t dimension,
               const bool columnMajor = true)
   {
-    std::vector<arma::uword> colsToKeep;
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
+
+  /**
+   * Remove every point that has a missing value in any of the given
+   * dimensions.  The missing values are found in parallel, and the points that
+   * are kept are then moved to the front of the input, in place, before the
+   * input is shrunk once.
+   *
+   * @param input Matrix that contains the missing values.
+   * @param mappedValues The mapped value of each dimension.
+   * @param dimensions The dimensions to look for missing values in.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+    std::vector<char> keep(numPoints);
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) numPoints; ++i)
+    {
+      keep[i] = true;
+      for (size_t d = 0; d < dimensions.size() && keep[i]; ++d)
+      {
+        const T value = columnMajor ? input(dimensions[d], i) :
+            input(i, dimensions[d]);
+        keep[i] = !IsMissing(value, mappedValues[d]);
+      }
+    }
+
+    const size_t numKept = std::count(keep.begin(), keep.end(), true);
+    if (numKept == numPoints)
+      return;
 
     if (columnMajor)
     {
+      size_t kept = 0;
       for (size_t i = 0; i < input.n_cols; ++i)
       {
-         if (!(input(dimension, i) == mappedValue ||
-             std::isnan(input(dimension, i))))
-         {
-           colsToKeep.push_back(i);
-         }
+        if (!keep[i])
+          continue;
+        if (kept != i)
+          std::copy(input.colptr(i), input.colptr(i) + input.n_rows,
+              input.colptr(kept));
+        ++kept;
       }
-      input = input.cols(arma::uvec(colsToKeep));
+      input.resize(input.n_rows, numKept);
     }
     else
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      // Each column is compacted on its own.
+      #pragma omp parallel for
+      for (omp_size_t j = 0; j < (omp_size_t) input.n_cols; ++j)
       {
-        if (!(input(i, dimension) == mappedValue ||
-             std::isnan(input(i, dimension))))
+        T* column = input.colptr(j);
+        size_t kept = 0;
+        for (size_t i = 0; i < input.n_rows; ++i)
         {
-           colsToKeep.push_back(i);
+          if (keep[i])
+            column[kept++] = column[i];
         }
       }
-      input = input.rows(arma::uvec(colsToKeep));
+      input.resize(numKept, input.n_cols);
     }
   }
 }; // class ListwiseDeletion
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_MEAN_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "replace_missing.hpp"
 
 namespace mlpack {
 namespace data {
@@ -39,62 +40,88 @@ class MeanImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    double sum = 0;
-    size_t elems = 0; // excluding nan or missing target
-
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
 
+  /**
+   * Replace the missing values of each of the given dimensions with the mean
+   * of the dimension.  The means of all the dimensions are computed in a
+   * single parallel pass over the input, and the missing values are replaced
+   * in a second one.
+   *
+   * @param input Matrix that contains the missing values.
+   * @param mappedValues The mapped value of each dimension.
+   * @param dimensions The dimensions to impute; they must be distinct.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    arma::vec sums(dimensions.size(), arma::fill::zeros);
+    arma::uvec elems(dimensions.size(), arma::fill::zeros);
 
-    // calculate number of elements and sum of them excluding mapped value or
-    // nan. while doing that, remember where mappedValue or NaN exists.
+    // Calculate the number of elements and the sum of each dimension,
+    // excluding the mapped value and NaN.
     if (columnMajor)
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
+      #pragma omp parallel
       {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
+        arma::vec localSums(dimensions.size(), arma::fill::zeros);
+        arma::uvec localElems(dimensions.size(), arma::fill::zeros);
+
+        #pragma omp for
+        for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
         {
-          targets.emplace_back(dimension, i);
+          for (size_t d = 0; d < dimensions.size(); ++d)
+          {
+            const T value = input(dimensions[d], i);
+            if (!IsMissing(value, mappedValues[d]))
+            {
+              localSums[d] += value;
+              ++localElems[d];
+            }
+          }
         }
-        else
+
+        #pragma omp critical
         {
-          elems++;
-          sum += input(dimension, i);
+          sums += localSums;
+          elems += localElems;
         }
       }
     }
     else
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
+        const T* column = input.colptr(dimensions[d]);
+        for (size_t i = 0; i < input.n_rows; ++i)
         {
-          elems++;
-          sum += input(i, dimension);
+          if (!IsMissing(column[i], mappedValues[d]))
+          {
+            sums[d] += column[i];
+            ++elems[d];
+          }
         }
       }
     }
 
-    if (elems == 0)
-      Log::Fatal << "it is impossible to calculate mean; no valid elements in "
-          << "the dimension" << std::endl;
-
-    // calculate mean;
-    const double mean = sum / elems;
-
-    // Now replace the calculated mean to the missing variables
-    // It only needs to loop through targets vector, not the whole matrix.
-    for (const PairType& target : targets)
+    std::vector<T> means(dimensions.size());
+    for (size_t d = 0; d < dimensions.size(); ++d)
     {
-      input(target.first, target.second) = mean;
+      if (elems[d] == 0)
+        Log::Fatal << "it is impossible to calculate mean; no valid elements "
+            << "in the dimension" << std::endl;
+
+      means[d] = sums[d] / elems[d];
     }
+
+    // Now replace the missing values by the calculated means.
+    ReplaceMissing(input, mappedValues, dimensions, means, columnMajor);
   }
 }; // class MeanImputation
 
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_MEDIAN_IMPUTATION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "replace_missing.hpp"
 
 namespace mlpack {
 namespace data {
@@ -40,50 +41,78 @@ class MedianImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
-    // good elements are kept inside this vector.
-    std::vector<double> elemsToKeep;
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
+
+  /**
+   * Replace the missing values of each of the given dimensions with the median
+   * of the dimension.  The dimensions are processed in parallel; the valid
+   * elements of each dimension are gathered once, and the median is found with
+   * a partial sort.  Then the missing values are replaced in a single parallel
+   * pass.
+   *
+   * @param input Matrix that contains the missing values.
+   * @param mappedValues The mapped value of each dimension.
+   * @param dimensions The dimensions to impute; they must be distinct.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+    std::vector<T> medians(dimensions.size());
+    std::vector<char> empty(dimensions.size(), false);
 
-    if (columnMajor)
+    #pragma omp parallel
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
+      // Good elements are kept inside this vector.
+      std::vector<T> elemsToKeep;
+      elemsToKeep.reserve(numPoints);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
       {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
+        elemsToKeep.clear();
+        for (size_t i = 0; i < numPoints; ++i)
         {
-          targets.emplace_back(dimension, i);
+          const T value = columnMajor ? input(dimensions[d], i) :
+              input(i, dimensions[d]);
+          if (!IsMissing(value, mappedValues[d]))
+            elemsToKeep.push_back(value);
         }
-        else
-        {
-          elemsToKeep.push_back(input(dimension, i));
-        }
-      }
-    }
-    else
-    {
-      for (size_t i = 0; i < input.n_rows; ++i)
-      {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
+
+        if (elemsToKeep.empty())
         {
-          targets.emplace_back(i, dimension);
+          empty[d] = true;
+          continue;
         }
-        else
+
+        // The median is the middle element, or the average of the two middle
+        // elements.
+        const size_t middle = elemsToKeep.size() / 2;
+        std::nth_element(elemsToKeep.begin(), elemsToKeep.begin() + middle,
+            elemsToKeep.end());
+        double median = elemsToKeep[middle];
+        if (elemsToKeep.size() % 2 == 0)
         {
-           elemsToKeep.push_back(input(i, dimension));
+          median = (median + *std::max_element(elemsToKeep.begin(),
+              elemsToKeep.begin() + middle)) / 2.0;
         }
+        medians[d] = median;
       }
     }
 
-    // calculate median
-    const double median = arma::median(arma::vec(elemsToKeep));
-
-    for (const PairType& target : targets)
+    for (size_t d = 0; d < dimensions.size(); ++d)
     {
-       input(target.first, target.second) = median;
+      if (empty[d])
+        Log::Fatal << "it is impossible to calculate median; no valid elements "
+            << "in the dimension" << std::endl;
     }
+
+    ReplaceMissing(input, mappedValues, dimensions, medians, columnMajor);
   }
 }; // class MedianImputation
 
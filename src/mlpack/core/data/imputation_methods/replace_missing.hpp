@@ -0,0 +1,81 @@
+/**
+ * @file replace_missing.hpp
+ *
+ * Utility functions shared by the imputation strategies to find and replace
+ * the missing values of several dimensions at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_IMPUTE_STRATEGIES_REPLACE_MISSING_HPP
+#define MLPACK_CORE_DATA_IMPUTE_STRATEGIES_REPLACE_MISSING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Return whether the given value is missing, that is whether it is the mapped
+ * value or NaN.
+ */
+template<typename T>
+inline bool IsMissing(const T& value, const T& mappedValue)
+{
+  return value == mappedValue || std::isnan(value);
+}
+
+/**
+ * Replace the missing values of the given dimensions by the given values, in
+ * parallel.  If the input is column-major, this is a single pass over the
+ * points; otherwise the dimensions are the columns of the input, and they are
+ * processed one per thread.  The dimensions must be distinct.
+ *
+ * @param input Matrix that contains the missing values.
+ * @param mappedValues The mapped value of each dimension.
+ * @param dimensions The dimensions to replace the missing values of.
+ * @param replacements The value to replace the missing values of each
+ *     dimension with.
+ * @param columnMajor State of whether the input matrix is columnMajor or not.
+ */
+template<typename T>
+void ReplaceMissing(arma::Mat<T>& input,
+                    const std::vector<T>& mappedValues,
+                    const std::vector<size_t>& dimensions,
+                    const std::vector<T>& replacements,
+                    const bool columnMajor)
+{
+  if (columnMajor)
+  {
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) input.n_cols; ++i)
+    {
+      for (size_t d = 0; d < dimensions.size(); ++d)
+      {
+        T& value = input(dimensions[d], i);
+        if (IsMissing(value, mappedValues[d]))
+          value = replacements[d];
+      }
+    }
+  }
+  else
+  {
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t d = 0; d < (omp_size_t) dimensions.size(); ++d)
+    {
+      T* column = input.colptr(dimensions[d]);
+      for (size_t i = 0; i < input.n_rows; ++i)
+      {
+        if (IsMissing(column[i], mappedValues[d]))
+          column[i] = replacements[d];
+      }
+    }
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -41,6 +41,16 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5, denoted by .hdf, .hdf5, .h5, or .he5
  *
+ * mlpack's mapped matrix format, denoted by .mmat, is also supported.  This
+ * file holds the matrix as it is in memory, and it is mapped into memory
+ * instead of being read: the matrix then uses the mapped file as its memory,
+ * its pages are only read when they are accessed, and several processes that
+ * load the same file share them.  The mapping is copy-on-write, so modifying
+ * the matrix never modifies the file, and it is kept until the program exits.
+ * Since the file is already in mlpack's column-major layout, it is never
+ * transposed, and the element type of the matrix must be the one it was saved
+ * with.
+ *
  * If the file extension is not one of those types, an error will be given.
  * This is preferable to Armadillo's default behavior of loading an unknown
  * filetype as raw_binary, which can have very confusing effects.
@@ -255,6 +265,57 @@ extern template bool Load<double, IncrementPolicy>(
  * @endcond
  */
 
+/**
+ * Load a sparse matrix from a file, guessing the filetype from the extension.
+ * The supported types of files are:
+ *
+ *  - LibSVM (or SVMlight), denoted by .svm, .libsvm or .svmlight; each point
+ *    becomes a column of the matrix, and the labels are dropped
+ *  - coordinate lists, denoted by .csv, .tsv, .txt or .coo: each line holds the
+ *    row, the column and the value of an element, with 0-based indices, as
+ *    written by Armadillo's coord_ascii format
+ *  - Armadillo binary (arma_binary), denoted by .bin
+ *
+ * The text formats are parsed in parallel; see LoadLibSVM() and
+ * LoadCoordinates().  If the parameter 'transpose' is true, the rows given in
+ * a coordinate list or an Armadillo binary file become the columns of the
+ * matrix, as for dense matrices; it has no effect on LibSVM files.
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the matrix does not load successfully.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Sparse matrix to load contents of file into.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @param transpose If true, transpose the matrix after loading.
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::string& filename,
+          arma::SpMat<eT>& matrix,
+          const bool fatal = false,
+          const bool transpose = true);
+
+/**
+ * Load a sparse dataset and its labels from a file in the LibSVM (or
+ * SVMlight) format, whatever its extension.  Each point becomes a column of
+ * the matrix, and its label the element of the labels with the same index.
+ *
+ * If the parameter 'fatal' is set to true, a std::runtime_error exception will
+ * be thrown if the matrix does not load successfully.
+ *
+ * @param filename Name of file to load.
+ * @param matrix Sparse matrix to load the points into.
+ * @param labels Row vector to load the labels into.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::string& filename,
+          arma::SpMat<eT>& matrix,
+          arma::rowvec& labels,
+          const bool fatal = false);
+
 /**
  * Load a model from a file, guessing the filetype from the extension, or,
  * optionally, loading the specified format.  If automatic extension detection
@@ -267,8 +328,16 @@ extern template bool Load<double, IncrementPolicy>(
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
  *
+ * A model can also be saved in mlpack's mapped format, denoted by .mbin: the
+ * matrices of at least MatrixBlocks::minBlockSize bytes are stored as aligned
+ * raw blocks after a binary archive of the rest of the model, and once the
+ * file is mapped into memory they are used in place, so loading a large model
+ * costs little more than reading its pages.  The mappings of loaded files
+ * live until the program exits.
+ *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary', and
+ * 'format::mapped'.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
@@ -294,5 +363,7 @@ bool Load(const std::string& filename,
 #include "load_model_impl.hpp"
 // Include implementation of Load() for vectors.
 #include "load_vec_impl.hpp"
+// Include implementation of Load() for sparse matrices.
+#include "load_sparse.hpp"
 
 #endif
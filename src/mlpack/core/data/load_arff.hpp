@@ -39,6 +39,12 @@ void LoadARFF(const std::string& filename, arma::Mat<eT>& matrix);
  * constructor or otherwise, so that info.Dimensionality() is 0), it will be set
  * to the right dimensionality.
  *
+ * The file is mapped into memory and its @data section is parsed in parallel
+ * chunks of whole lines.  The tokens of each categorical dimension are
+ * collected per chunk, and mapped with the DatasetInfo in the order of the
+ * file afterwards, so the mappings are the same as if the file had been parsed
+ * line by line.  Empty lines and comments in the @data section are skipped.
+ *
  * This ability to pass in pre-existing DatasetInfo objects is very necessary
  * when, e.g., loading a test set after training.  If the same DatasetInfo from
  * loading the training set is not used, then the test set may be loaded with
@@ -16,39 +16,127 @@
 #include "load_arff.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
+#include <unordered_map>
 #include "is_naninf.hpp"
+#include "mapped_file.hpp"
+#include "read_number.hpp"
 
 namespace mlpack {
 namespace data {
 
+/**
+ * Split the given line of the @data section of an ARFF file into its tokens,
+ * as a boost::escaped_list_separator with the escape character '\', the
+ * separator ',' and the quote '"' would, and call the given functor on each
+ * token with its first and one past its last character, without the
+ * whitespace on either side.
+ *
+ * @param begin The first character of the line.
+ * @param end One past the last character of the line.
+ * @param token Buffer for the tokens that have quotes or escapes.
+ * @param tokenFunctor Functor to call on each token.
+ * @return The error message if the line can't be split; empty otherwise.
+ */
+template<typename TokenFunctor>
+std::string SplitARFFLine(const char* begin,
+                          const char* end,
+                          std::string& token,
+                          TokenFunctor tokenFunctor)
+{
+  const char* current = begin;
+  while (current < end)
+  {
+    // Find the end of the token; most tokens have no quote or escape, and are
+    // passed straight from the file.
+    const char* tokenEnd = current;
+    while (tokenEnd < end && *tokenEnd != ',' && *tokenEnd != '"' &&
+        *tokenEnd != '\\')
+      ++tokenEnd;
+
+    const char* tokenBegin = current;
+    if (tokenEnd < end && *tokenEnd != ',')
+    {
+      token.assign(current, tokenEnd);
+      bool inQuote = false;
+      for (current = tokenEnd; current < end; ++current)
+      {
+        if (*current == '\\')
+        {
+          if (++current == end)
+            return "cannot end with escape";
+          if (*current == 'n')
+            token += '\n';
+          else if (*current == '\\' || *current == '"' || *current == ',')
+            token += *current;
+          else
+            return "unknown escape sequence";
+        }
+        else if (*current == '"')
+        {
+          inQuote = !inQuote;
+        }
+        else if (*current == ',' && !inQuote)
+        {
+          break;
+        }
+        else
+        {
+          token += *current;
+        }
+      }
+
+      tokenBegin = token.data();
+      tokenEnd = tokenBegin + token.size();
+    }
+    else
+    {
+      current = tokenEnd;
+    }
+
+    while (tokenBegin < tokenEnd && std::isspace((unsigned char) *tokenBegin))
+      ++tokenBegin;
+    while (tokenEnd > tokenBegin &&
+        std::isspace((unsigned char) *(tokenEnd - 1)))
+      --tokenEnd;
+    tokenFunctor(tokenBegin, tokenEnd);
+
+    // A separator at the end of the line is followed by an empty token.
+    if (current < end && ++current == end)
+      tokenFunctor(end, end);
+  }
+
+  return "";
+}
+
 template<typename eT, typename PolicyType>
 void LoadARFF(const std::string& filename,
               arma::Mat<eT>& matrix,
               DatasetMapper<PolicyType>& info)
 {
-  // First, open the file.
-  std::ifstream ifs;
-  ifs.open(filename, std::ios::in | std::ios::binary);
-
-  // if file is not open throw an error (file not found).
-  if (!ifs.is_open())
-  {
-    Log::Fatal << "Cannot open file '" << filename << "'. " << std::endl;
-  }
+  // First, map the file.  This throws if the file can't be opened.
+  MappedFile file(filename);
+  const char* data = file.Data();
+  const char* dataEnd = data + file.Size();
 
   std::string line;
   size_t dimensionality = 0;
   std::vector<bool> types;
   size_t headerLines = 0;
-  while (ifs.good())
+  bool foundData = false;
+  const char* lineBegin = data;
+  while (lineBegin < dataEnd)
   {
     // Read the next line, then strip whitespace from either side.
-    std::getline(ifs, line, '\n');
+    const char* newline = (const char*) std::memchr(lineBegin, '\n',
+        dataEnd - lineBegin);
+    const char* lineEnd = (newline == NULL) ? dataEnd : newline;
+    line.assign(lineBegin, lineEnd);
+    lineBegin = (newline == NULL) ? dataEnd : newline + 1;
     boost::trim(line);
     ++headerLines;
 
     // Is the first character a comment, or is the line empty?
-    if (line[0] == '%' || line.empty())
+    if (line.empty() || line[0] == '%')
       continue; // Ignore this line.
 
     // If the first character is @, we are looking at @relation, @attribute, or
@@ -96,6 +184,7 @@ void LoadARFF(const std::string& filename,
       else if (annotation == "@data")
       {
         // We are in the data section.  So we can move out of this loop.
+        foundData = true;
         break;
       }
       else
@@ -106,7 +195,7 @@ void LoadARFF(const std::string& filename,
     }
   }
 
-  if (ifs.eof())
+  if (!foundData)
     throw std::runtime_error("no @data section found");
 
   // Reset the DatasetInfo object, if needed.
@@ -131,103 +220,208 @@ void LoadARFF(const std::string& filename,
       info.Type(i) = Datatype::numeric;
   }
 
-  // We need to find out how many lines of data are in the file.
-  std::streampos pos = ifs.tellg();
-  size_t row = 0;
-  while (ifs.good())
+  // The categorical dimensions get their own rows in the matrix of the local
+  // indices of their tokens.
+  std::vector<size_t> categoricalRows(dimensionality, size_t(-1));
+  size_t numCategorical = 0;
+  for (size_t i = 0; i < dimensionality; ++i)
+    if (info.Type(i) == Datatype::categorical)
+      categoricalRows[i] = numCategorical++;
+
+  // Split the @data section into chunks of whole lines.
+  const std::vector<const char*> starts = SplitLineChunks(lineBegin, dataEnd);
+  const size_t numChunks = starts.size() - 1;
+
+  // Count the lines and the points of each chunk in parallel.  Empty lines and
+  // comments are not points.
+  std::vector<size_t> chunkLines(numChunks, 0), chunkPoints(numChunks, 0);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numChunks; ++i)
   {
-    std::getline(ifs, line, '\n');
-    ++row;
+    const char* begin = starts[i];
+    while (begin < starts[i + 1])
+    {
+      const char* newline = (const char*) std::memchr(begin, '\n',
+          starts[i + 1] - begin);
+      const char* end = (newline == NULL) ? starts[i + 1] : newline;
+      while (begin < end && std::isspace((unsigned char) *begin))
+        ++begin;
+
+      ++chunkLines[i];
+      if (begin < end && *begin != '%')
+        ++chunkPoints[i];
+      begin = end + 1;
+    }
   }
-  // Uncount the EOF row.
-  --row;
 
-  // Since we've hit the EOF, we have to call clear() so we can seek again.
-  ifs.clear();
-  ifs.seekg(pos);
+  std::vector<size_t> firstLines(numChunks), firstPoints(numChunks);
+  size_t points = 0;
+  for (size_t i = 0, lines = headerLines; i < numChunks; ++i)
+  {
+    firstLines[i] = lines;
+    firstPoints[i] = points;
+    lines += chunkLines[i];
+    points += chunkPoints[i];
+  }
 
   // Now, set the size of the matrix.
-  matrix.set_size(dimensionality, row);
+  matrix.set_size(dimensionality, points);
+  arma::Mat<size_t> localIndices(numCategorical, points);
 
-  // Now we are looking at the @data section.
-  row = 0;
-  while (ifs.good())
+  // Parse the chunks in parallel.  Each line of the @data section must be a
+  // CSV (except sparse data, which we will handle later).  The '?'
+  // representing a missing value is not allowed, so if that occurs the load
+  // fails.  It also fails if any piece of data does not match its type
+  // (categorical or numeric).  The numbers are stored in the matrix; the
+  // tokens of the categorical dimensions are given local indices in their
+  // chunk, in the order they appear, and are mapped afterwards.
+  typedef std::unordered_map<std::string, size_t> LocalMap;
+  std::vector<std::vector<LocalMap>> localMaps(numChunks,
+      std::vector<LocalMap>(numCategorical));
+  std::vector<std::vector<std::vector<std::string>>> localTokens(numChunks,
+      std::vector<std::vector<std::string>>(numCategorical));
+  std::vector<std::string> errors(numChunks);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numChunks; ++i)
   {
-    std::getline(ifs, line, '\n');
-    boost::trim(line);
-    // Each line of the @data section must be a CSV (except sparse data, which
-    // we will handle later).  So now we can tokenize the
-    // CSV and parse it.  The '?' representing a missing value is not allowed,
-    // so if that occurs we throw an exception.  We also throw an exception if
-    // any piece of data does not match its type (categorical or numeric).
-
-    // If the first character is {, it is sparse data, and we can just say this
-    // is not handled for now...
-    if (line[0] == '{')
-      throw std::runtime_error("cannot yet parse sparse ARFF data");
-
-    // Tokenize the line.
-    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
-    boost::escaped_list_separator<char> sep("\\", ",", "\"");
-    Tokenizer tok(line, sep);
-
-    size_t col = 0;
-    std::stringstream token;
-    for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
+    std::string token, tokenString;
+    std::stringstream tokenStream;
+    std::ostringstream error;
+    size_t lineNumber = firstLines[i];
+    size_t col = firstPoints[i];
+    const char* begin = starts[i];
+    for (; begin < starts[i + 1] && errors[i].empty(); ++lineNumber)
     {
-      // Check that we are not too many columns in.
-      if (col >= matrix.n_rows)
+      const char* newline = (const char*) std::memchr(begin, '\n',
+          starts[i + 1] - begin);
+      const char* end = (newline == NULL) ? starts[i + 1] : newline;
+      const char* lineStart = begin;
+      begin = end + 1;
+      while (lineStart < end && std::isspace((unsigned char) *lineStart))
+        ++lineStart;
+
+      if (lineStart == end || *lineStart == '%')
+        continue;
+
+      // If the first character is {, it is sparse data, and we can just say
+      // this is not handled for now...
+      if (*lineStart == '{')
       {
-        std::stringstream error;
-        error << "Too many columns in line " << (headerLines + row) << ".";
-        throw std::runtime_error(error.str());
+        errors[i] = "cannot yet parse sparse ARFF data";
+        break;
       }
 
-      // What should this token be?
-      if (info.Type(col) == Datatype::categorical)
+      size_t dim = 0;
+      const std::string splitError = SplitARFFLine(lineStart, end, token,
+          [&](const char* tokenBegin, const char* tokenEnd)
+          {
+            // Check that we are not too many columns in.
+            if (dim >= dimensionality)
+            {
+              if (dim++ == dimensionality)
+                error << "Too many columns in line " << lineNumber << ".";
+              return;
+            }
+
+            if (categoricalRows[dim] != size_t(-1))
+            {
+              const size_t row = categoricalRows[dim];
+              tokenString.assign(tokenBegin, tokenEnd);
+              std::pair<LocalMap::iterator, bool> inserted =
+                  localMaps[i][row].insert(std::make_pair(tokenString,
+                  localTokens[i][row].size()));
+              if (inserted.second)
+                localTokens[i][row].push_back(tokenString);
+              localIndices(row, col) = inserted.first->second;
+            }
+            else if (!std::is_floating_point<eT>::value ||
+                !ReadNumber(tokenBegin, tokenEnd, matrix(dim, col)))
+            {
+              // Attempt to read as numeric.
+              tokenStream.clear();
+              tokenStream.str(std::string(tokenBegin, tokenEnd));
+
+              eT val = eT(0);
+              tokenStream >> val;
+
+              if (tokenStream.fail())
+              {
+                // Check for NaN or inf.
+                if (!IsNaNInf(val, tokenStream.str()) && error.tellp() == 0)
+                {
+                  // Okay, it's not NaN or inf.  If it's '?', we issue a
+                  // specific error, otherwise we issue a general error.
+                  if (tokenStream.str() == "?")
+                    error << "Missing values ('?') not supported, ";
+                  else
+                    error << "Parse error ";
+                  error << "at line " << lineNumber << " token " << dim
+                      << ": \"" << tokenStream.str() << "\".";
+                }
+              }
+
+              // If we made it to here, we have a value.
+              matrix(dim, col) = val;
+            }
+
+            ++dim;
+          });
+
+      if (!splitError.empty())
+        errors[i] = splitError;
+      else if (error.tellp() > 0)
+        errors[i] = error.str();
+      else if (dim < dimensionality)
+        errors[i] = "Too few columns in line " +
+            std::to_string(lineNumber) + ".";
+
+      ++col;
+    }
+  }
+
+  // Report the first error of the file.
+  for (size_t i = 0; i < numChunks; ++i)
+    if (!errors[i].empty())
+      throw std::runtime_error(errors[i]);
+
+  // Map the tokens of the categorical dimensions in the order of the file, so
+  // that the mappings are the same as if the file had been parsed line by
+  // line; a token is only mapped once per chunk.
+  std::vector<std::vector<std::vector<eT>>> mappedTokens(numChunks,
+      std::vector<std::vector<eT>>(numCategorical));
+  for (size_t i = 0; i < numChunks; ++i)
+  {
+    for (size_t dim = 0; dim < dimensionality; ++dim)
+    {
+      const size_t row = categoricalRows[dim];
+      if (row == size_t(-1))
+        continue;
+
+      for (size_t j = 0; j < localTokens[i][row].size(); ++j)
       {
-        // Strip spaces before mapping.
-        std::string token = *it;
-        boost::trim(token);
-        // We load transposed.
-        matrix(col, row) = info.template MapString<eT>(token, col);
+        mappedTokens[i][row].push_back(info.template MapString<eT>(
+            localTokens[i][row][j], dim));
       }
-      else if (info.Type(col) == Datatype::numeric)
-      {
-        // Attempt to read as numeric.
-        token.clear();
-        token.str(*it);
-
-        eT val = eT(0);
-        token >> val;
+    }
+  }
 
-        if (token.fail())
+  // Store the mapped values, in parallel again.
+  if (numCategorical > 0)
+  {
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) numChunks; ++i)
+    {
+      for (size_t col = firstPoints[i]; col < firstPoints[i] + chunkPoints[i];
+          ++col)
+      {
+        for (size_t dim = 0; dim < dimensionality; ++dim)
         {
-          // Check for NaN or inf.
-          if (!IsNaNInf(val, token.str()))
-          {
-            // Okay, it's not NaN or inf.  If it's '?', we issue a specific
-            // error, otherwise we issue a general error.
-            std::stringstream error;
-            std::string tokenStr = token.str();
-            boost::trim(tokenStr);
-            if (tokenStr == "?")
-              error << "Missing values ('?') not supported, ";
-            else
-              error << "Parse error ";
-            error << "at line " << (headerLines + row) << " token " << col
-                << ": \"" << tokenStr << "\".";
-            throw std::runtime_error(error.str());
-          }
+          const size_t row = categoricalRows[dim];
+          if (row != size_t(-1))
+            matrix(dim, col) = mappedTokens[i][row][localIndices(row, col)];
         }
-
-        // If we made it to here, we have a value.
-        matrix(col, row) = val; // We load transposed.
       }
-
-      ++col;
     }
-    ++row;
   }
 }
 
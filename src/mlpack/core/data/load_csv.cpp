@@ -2,7 +2,7 @@
  * @file load_csv.cpp
  * @author Tham Ngap Wei
  *
- * A CSV reader that uses boost::spirit.
+ * A CSV reader that parses a memory-mapped file in parallel.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -11,62 +11,77 @@
  */
 #include "load_csv.hpp"
 
-using namespace boost::spirit;
+#include <cstring>
 
 namespace mlpack {
 namespace data {
 
 LoadCSV::LoadCSV(const std::string& file) :
-  extension(Extension(file)),
-  filename(file),
-  inFile(file)
+    extension(Extension(file)),
+    filename(file),
+    delimiter(extension == "csv" ? ',' : (extension == "txt" ? ' ' : '\t')),
+    mappedFile(file),
+    lines(0)
 {
-  // Attempt to open stream.
-  CheckOpen();
+  SplitChunks();
+}
 
-  // Set rules.
-  if (extension == "csv" || extension == "txt")
-  {
-    // Match all characters that are not ',', '\r', or '\n'.
-    stringRule = qi::raw[*~qi::char_(" ,\r\n")];
-  }
-  else
-  {
-    // Match all characters that are not '\t', '\r', or '\n'.
-    stringRule = qi::raw[*~qi::char_(" \t\r\n")];
-  }
+void LoadCSV::SplitChunks()
+{
+  const char* data = mappedFile.Data();
+  const size_t size = mappedFile.Size();
 
-  if (extension == "csv")
-  {
-    // Extract a single comma as the delimiter, catching whitespace on either
-    // side.
-    delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_(",") >>
-        *qi::char_(" "))];
-  }
-  else if (extension == "txt")
+  const std::vector<const char*> starts = SplitLineChunks(data, data + size);
+  const size_t numChunks = starts.size() - 1;
+
+  // Count the lines of each chunk in parallel.  Every line of a chunk ends
+  // with a newline, except maybe the last line of the file.
+  std::vector<size_t> chunkLines(numChunks, 0);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numChunks; ++i)
   {
-    // This one is a little more difficult, we need to catch any number of
-    // spaces more than one.
-    delimiterRule = qi::raw[+qi::char_(" ")];
+    const char* begin = starts[i];
+    const char* end = starts[i + 1];
+    while (begin < end)
+    {
+      const char* newline = (const char*) std::memchr(begin, '\n',
+          end - begin);
+      ++chunkLines[i];
+      begin = (newline == NULL) ? end : newline + 1;
+    }
   }
-  else // TSV.
+
+  chunks.resize(numChunks);
+  lines = 0;
+  for (size_t i = 0; i < numChunks; ++i)
   {
-    // Catch a tab character, possibly with whitespace on either side.
-    delimiterRule = qi::raw[(*qi::char_(" ") >> qi::char_("\t") >>
-        *qi::char_(" "))];
+    chunks[i].begin = starts[i];
+    chunks[i].end = starts[i + 1];
+    chunks[i].firstLine = lines;
+    lines += chunkLines[i];
   }
 }
 
-void LoadCSV::CheckOpen()
+size_t LoadCSV::FirstLineWidth() const
 {
-  if (!inFile.is_open())
-  {
-    std::ostringstream oss;
-    oss << "Cannot open file '" << filename << "'. " << std::endl;
-    throw std::runtime_error(oss.str());
-  }
+  if (lines == 0)
+    return 0;
 
-  inFile.unsetf(std::ios::skipws);
+  const char* begin = mappedFile.Data();
+  const char* end = begin + mappedFile.Size();
+  const char* newline = (const char*) std::memchr(begin, '\n', end - begin);
+
+  size_t width = 0;
+  ParseLine(begin, (newline == NULL) ? end : newline,
+      [&width](const char*, const char*) { ++width; });
+  return width;
+}
+
+void LoadCSV::ThrowFirstError(const std::vector<std::string>& errors)
+{
+  for (size_t i = 0; i < errors.size(); ++i)
+    if (!errors[i].empty())
+      throw std::runtime_error(errors[i]);
 }
 
 } // namespace data
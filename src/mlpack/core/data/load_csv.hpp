@@ -12,11 +12,9 @@
 #ifndef MLPACK_CORE_DATA_LOAD_CSV_HPP
 #define MLPACK_CORE_DATA_LOAD_CSV_HPP
 
-#include <boost/spirit/include/qi.hpp>
-#include <boost/algorithm/string/trim.hpp>
-
 #include <mlpack/core.hpp>
 #include <mlpack/core/util/log.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 
 #include <set>
 #include <string>
@@ -24,21 +22,35 @@
 #include "extension.hpp"
 #include "format.hpp"
 #include "dataset_mapper.hpp"
+#include "mapped_file.hpp"
+#include "read_number.hpp"
 
 namespace mlpack {
 namespace data {
 
 /**
- *Load the csv file.This class use boost::spirit
- *to implement the parser, please refer to following link
- *http://theboostcpplibraries.com/boost.spirit for quick review.
+ * Load the csv file.  The file is mapped into memory and split into chunks of
+ * whole lines, which are parsed in parallel.  The tokens that are numbers (in
+ * a numeric dimension) are written directly into the matrix; the other tokens
+ * are kept aside, and are passed to the DatasetMapper in the order of the file
+ * once all the chunks are parsed, so that the mappings are the same as if the
+ * file had been parsed line by line.
+ *
+ * The tokens are separated by a comma for .csv files, by a tab for .tsv files
+ * and by spaces for .txt files; spaces around the separators and at either end
+ * of a line are ignored.
+ *
+ * The parallel parse is only used for floating-point matrices, and if the map
+ * policy has a MapsNumericTokens() method that returns false, meaning that a
+ * number in a numeric dimension is never mapped.  Otherwise, every token is
+ * passed to the DatasetMapper, one line after the other.
  */
 class LoadCSV
 {
  public:
   /**
-   * Construct the LoadCSV object on the given file.  This will construct the
-   * rules necessary for loading and attempt to open the file.
+   * Construct the LoadCSV object on the given file.  This will map the file
+   * and find its lines.
    */
   LoadCSV(const std::string& file);
 
@@ -52,17 +64,9 @@ class LoadCSV
    *     (default).
    */
   template<typename T, typename PolicyType>
-  void Load(arma::Mat<T> &inout,
-            DatasetMapper<PolicyType> &infoSet,
-            const bool transpose = true)
-  {
-    CheckOpen();
-
-    if (transpose)
-      TransposeParse(inout, infoSet);
-    else
-      NonTransposeParse(inout, infoSet);
-  }
+  void Load(arma::Mat<T>& inout,
+            DatasetMapper<PolicyType>& infoSet,
+            const bool transpose = true);
 
   /**
    * Peek at the file to determine the number of rows and columns in the matrix,
@@ -75,67 +79,9 @@ class LoadCSV
    * @param info DatasetMapper object to use for first pass.
    */
   template<typename T, typename MapPolicy>
-  void GetMatrixSize(size_t& rows, size_t& cols, DatasetMapper<MapPolicy>& info)
-  {
-    using namespace boost::spirit;
-
-    // Take a pass through the file.  If the DatasetMapper policy requires it,
-    // we will pass everything string through MapString().  This might be useful
-    // if, e.g., the MapPolicy needs to find which dimensions are numeric or
-    // categorical.
-
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-    cols = 0;
-
-    // First, count the number of rows in the file (this is the dimensionality).
-    std::string line;
-    while (std::getline(inFile, line))
-    {
-      ++rows;
-    }
-    info = DatasetMapper<MapPolicy>(rows);
-
-    // Now, jump back to the beginning of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-
-    while (std::getline(inFile, line))
-    {
-      ++rows;
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      if (rows == 1)
-      {
-        // Extract the number of columns.
-        auto findColSize = [&cols](iter_type) { ++cols; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findColSize] % delimiterRule);
-      }
-
-      // I guess this is technically a second pass, but that's ok... still the
-      // same idea...
-      if (MapPolicy::NeedsFirstPass)
-      {
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
-        {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), rows - 1);
-        };
-
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
-      }
-    }
-  }
+  void GetMatrixSize(size_t& rows,
+                     size_t& cols,
+                     DatasetMapper<MapPolicy>& info);
 
   /**
    * Peek at the file to determine the number of rows and columns in the matrix,
@@ -150,227 +96,131 @@ class LoadCSV
   template<typename T, typename MapPolicy>
   void GetTransposeMatrixSize(size_t& rows,
                               size_t& cols,
-                              DatasetMapper<MapPolicy>& info)
-  {
-    using namespace boost::spirit;
-
-    // Take a pass through the file.  If the DatasetMapper policy requires it,
-    // we will pass everything string through MapString().  This might be useful
-    // if, e.g., the MapPolicy needs to find which dimensions are numeric or
-    // categorical.
-
-    // Reset to the start of the file.
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-    rows = 0;
-    cols = 0;
-
-    std::string line;
-    while (std::getline(inFile, line))
-    {
-      ++cols;
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      if (cols == 1)
-      {
-        // Extract the number of dimensions.
-        auto findRowSize = [&rows](iter_type) { ++rows; };
-        qi::parse(line.begin(), line.end(),
-            stringRule[findRowSize] % delimiterRule);
-
-        // Now that we know the dimensionality, initialize the DatasetMapper.
-        info.SetDimensionality(rows);
-      }
-
-      // If we need to do a first pass for the DatasetMapper, do it.
-      if (MapPolicy::NeedsFirstPass)
-      {
-        size_t dim = 0;
-
-        // In this case we must pass everything we parse to the MapPolicy.
-        auto firstPassMap = [&](const iter_type& iter)
-        {
-          std::string str(iter.begin(), iter.end());
-          boost::trim(str);
-
-          info.template MapFirstPass<T>(std::move(str), dim++);
-        };
-
-        // Now parse the line.
-        qi::parse(line.begin(), line.end(),
-            stringRule[firstPassMap] % delimiterRule);
-      }
-    }
-  }
+                              DatasetMapper<MapPolicy>& info);
 
  private:
-  using iter_type = boost::iterator_range<std::string::iterator>;
+  //! A range of whole lines of the file.
+  struct Chunk
+  {
+    //! The first character of the chunk.
+    const char* begin;
+    //! One past the last character of the chunk.
+    const char* end;
+    //! The index of the first line of the chunk in the file.
+    size_t firstLine;
+  };
+
+  //! A token that has to be passed to the DatasetMapper.
+  struct Token
+  {
+    //! The row of the token in the matrix; this is also its dimension.
+    size_t row;
+    //! The column of the token in the matrix.
+    size_t col;
+    //! The first character of the token, in the file.
+    const char* begin;
+    //! One past the last character of the token.
+    const char* end;
+  };
 
   /**
-   * Check whether or not the file has successfully opened; throw an exception
-   * if not.
+   * Split the file into chunks of whole lines, and count the lines.
    */
-  void CheckOpen();
+  void SplitChunks();
 
   /**
-   * Parse a non-transposed matrix.
-   *
-   * @param inout Matrix to load into.
-   * @param infoSet DatasetMapper object to load with.
+   * Get the number of tokens on the first line of the file; this is 0 if the
+   * file is empty.
    */
-  template<typename T, typename PolicyType>
-  void NonTransposeParse(arma::Mat<T>& inout,
-                         DatasetMapper<PolicyType>& infoSet)
-  {
-    using namespace boost::spirit;
-
-    // Get the size of the matrix.
-    size_t rows, cols;
-    GetMatrixSize<T>(rows, cols, infoSet);
-
-    // Set up output matrix.
-    inout.set_size(rows, cols);
-    size_t row = 0;
-    size_t col = 0;
-
-    // Reset file position.
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
-
-    auto setCharClass = [&](iter_type const &iter)
-    {
-      std::string str(iter.begin(), iter.end());
-      if (str == "\t")
-      {
-        str.clear();
-      }
-      boost::trim(str);
-
-      inout(row, col++) = infoSet.template MapString<T>(std::move(str), row);
-    };
-
-    while (std::getline(inFile, line))
-    {
-      // Remove whitespace from either side.
-      boost::trim(line);
-
-      // Parse the numbers from a line (ex: 1,2,3,4); if the parser finds a
-      // number it will execute the setNum function.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[setCharClass] % delimiterRule);
-
-      // Make sure we got the right number of rows.
-      if (col != cols)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): wrong number of dimensions ("
-            << col << ") on line " << row << "; should be " << cols
-            << " dimensions.";
-        throw std::runtime_error(oss.str());
-      }
-
-      if (!canParse)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::NonTransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
-      }
-
-      ++row; col = 0;
-    }
-  }
+  size_t FirstLineWidth() const;
 
   /**
-   * Parse a transposed matrix.
+   * Split the given line into tokens, and call the given functor on each
+   * token with its first and one past its last character.
    *
-   * @param inout Matrix to load into.
-   * @param infoSet DatasetMapper to load with.
+   * @param begin The first character of the line.
+   * @param end One past the last character of the line.
+   * @param tokenFunctor Functor to call on each token.
+   * @return Whether the whole line was made of tokens and separators.
    */
-  template<typename T, typename PolicyType>
-  void TransposeParse(arma::Mat<T>& inout, DatasetMapper<PolicyType>& infoSet)
-  {
-    using namespace boost::spirit;
-
-    // Get matrix size.  This also initializes infoSet correctly.
-    size_t rows, cols;
-    GetTransposeMatrixSize<T>(rows, cols, infoSet);
-
-    // Set the matrix size.
-    inout.set_size(rows, cols);
-
-    // Initialize auxiliary variables.
-    size_t row = 0;
-    size_t col = 0;
-    std::string line;
-    inFile.clear();
-    inFile.seekg(0, std::ios::beg);
+  template<typename TokenFunctor>
+  bool ParseLine(const char* begin,
+                 const char* end,
+                 TokenFunctor tokenFunctor) const;
 
-    /**
-     * This is the parse rule for strings.  When we get a string we have to pass
-     * it to the DatasetMapper.
-     */
-    auto parseString = [&](iter_type const &iter)
-    {
-      // All parsed values must be mapped.
-      std::string str(iter.begin(), iter.end());
-      boost::trim(str);
-
-      inout(row, col) = infoSet.template MapString<T>(std::move(str), row);
-      ++row;
-    };
-
-    while (std::getline(inFile, line))
-    {
-      // Remove whitespace from either side.
-      boost::trim(line);
+  /**
+   * Parse the lines of the given chunk, and call the given functor on each
+   * token with its row and column in the matrix, and its first and one past
+   * its last character.  The parse stops at the first line that doesn't have
+   * the given number of tokens or can't be parsed.
+   *
+   * @param chunk The chunk to parse.
+   * @param width The number of tokens of each line.
+   * @param transpose Whether each line is a column of the matrix.
+   * @param tokenFunctor Functor to call on each token.
+   * @return The error message of the first bad line; empty if there is none.
+   */
+  template<typename TokenFunctor>
+  std::string ParseChunk(const Chunk& chunk,
+                         const size_t width,
+                         const bool transpose,
+                         TokenFunctor tokenFunctor) const;
 
-      // Reset the row we are looking at.  (Remember this is transposed.)
-      row = 0;
+  /**
+   * Pass every token of the file to MapFirstPass(), one line after the other.
+   */
+  template<typename T, typename PolicyType>
+  void FirstPass(DatasetMapper<PolicyType>& infoSet,
+                 const size_t width,
+                 const bool transpose) const;
 
-      // Now use boost::spirit to parse the characters of the line;
-      // parseString() will be called when a token is detected.
-      const bool canParse = qi::parse(line.begin(), line.end(),
-          stringRule[parseString] % delimiterRule);
+  /**
+   * Parse the chunks in parallel, and map the tokens that aren't numbers
+   * afterwards.
+   */
+  template<typename T, typename PolicyType>
+  void ParallelParse(arma::Mat<T>& inout,
+                     DatasetMapper<PolicyType>& infoSet,
+                     const size_t width,
+                     const bool transpose) const;
 
-      // Make sure we got the right number of rows.
-      if (row != rows)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): wrong number of dimensions (" << row
-            << ") on line " << col << "; should be " << rows << " dimensions.";
-        throw std::runtime_error(oss.str());
-      }
+  /**
+   * Map every token of the file, one line after the other.
+   */
+  template<typename T, typename PolicyType>
+  void SerialParse(arma::Mat<T>& inout,
+                   DatasetMapper<PolicyType>& infoSet,
+                   const size_t width,
+                   const bool transpose) const;
 
-      if (!canParse)
-      {
-        std::ostringstream oss;
-        oss << "LoadCSV::TransposeParse(): parsing error on line " << col
-            << "!";
-        throw std::runtime_error(oss.str());
-      }
+  //! Throw the first error of the given ones, if any.
+  static void ThrowFirstError(const std::vector<std::string>& errors);
 
-      // Increment the column index.
-      ++col;
-    }
+  //! Whether the given character ends a token.
+  bool IsTokenEnd(const char c) const
+  {
+    return c == ' ' || c == '\r' || c == '\n' ||
+        c == (delimiter == '\t' ? '\t' : ',');
   }
 
-  //! Spirit rule for parsing.
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> stringRule;
-  //! Spirit rule for delimiters (i.e. ',' for CSVs).
-  boost::spirit::qi::rule<std::string::iterator, iter_type()> delimiterRule;
-
   //! Extension (type) of file.
   std::string extension;
   //! Name of file.
   std::string filename;
-  //! Opened stream for reading.
-  std::ifstream inFile;
+  //! The separator of the tokens; ' ' means one or more spaces.
+  char delimiter;
+  //! The mapped file.
+  MappedFile mappedFile;
+  //! The chunks of the file, in order.
+  std::vector<Chunk> chunks;
+  //! The number of lines of the file.
+  size_t lines;
 };
 
 } // namespace data
 } // namespace mlpack
 
+// Include implementation.
+#include "load_csv_impl.hpp"
+
 #endif
@@ -0,0 +1,321 @@
+/**
+ * @file load_csv_impl.hpp
+ *
+ * Implementation of the templated parts of the LoadCSV class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_CSV_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_CSV_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_csv.hpp"
+
+#include <cctype>
+#include <cstring>
+
+namespace mlpack {
+namespace data {
+
+HAS_MEM_FUNC(MapsNumericTokens, HasMapsNumericTokens);
+
+/**
+ * Return whether the given map policy may map a token that is a number, in a
+ * numeric dimension.
+ */
+template<typename PolicyType>
+typename std::enable_if<HasMapsNumericTokens<PolicyType,
+    bool(PolicyType::*)() const>::value, bool>::type
+MapsNumericTokens(const PolicyType& policy)
+{
+  return policy.MapsNumericTokens();
+}
+
+/**
+ * A map policy that doesn't say whether it maps numbers may map any token.
+ */
+template<typename PolicyType>
+typename std::enable_if<!HasMapsNumericTokens<PolicyType,
+    bool(PolicyType::*)() const>::value, bool>::type
+MapsNumericTokens(const PolicyType& /* policy */)
+{
+  return true;
+}
+
+template<typename T, typename PolicyType>
+void LoadCSV::Load(arma::Mat<T>& inout,
+                   DatasetMapper<PolicyType>& infoSet,
+                   const bool transpose)
+{
+  const size_t width = FirstLineWidth();
+  const size_t rows = transpose ? width : lines;
+  const size_t cols = transpose ? lines : width;
+
+  // The dimensions are the rows of the matrix.
+  infoSet.SetDimensionality(rows);
+  inout.set_size(rows, cols);
+
+  if (std::is_floating_point<T>::value &&
+      !MapsNumericTokens(infoSet.Policy()))
+    ParallelParse(inout, infoSet, width, transpose);
+  else
+    SerialParse(inout, infoSet, width, transpose);
+}
+
+template<typename T, typename MapPolicy>
+void LoadCSV::GetMatrixSize(size_t& rows,
+                            size_t& cols,
+                            DatasetMapper<MapPolicy>& info)
+{
+  rows = lines;
+  cols = FirstLineWidth();
+  info.SetDimensionality(rows);
+  FirstPass<T>(info, cols, false);
+}
+
+template<typename T, typename MapPolicy>
+void LoadCSV::GetTransposeMatrixSize(size_t& rows,
+                                     size_t& cols,
+                                     DatasetMapper<MapPolicy>& info)
+{
+  rows = FirstLineWidth();
+  cols = lines;
+  info.SetDimensionality(rows);
+  FirstPass<T>(info, rows, true);
+}
+
+template<typename TokenFunctor>
+bool LoadCSV::ParseLine(const char* begin,
+                        const char* end,
+                        TokenFunctor tokenFunctor) const
+{
+  // Remove whitespace from either side.
+  while (begin < end && std::isspace((unsigned char) *begin))
+    ++begin;
+  while (end > begin && std::isspace((unsigned char) *(end - 1)))
+    --end;
+
+  const char* current = begin;
+  while (true)
+  {
+    const char* tokenEnd = current;
+    while (tokenEnd < end && !IsTokenEnd(*tokenEnd))
+      ++tokenEnd;
+
+    tokenFunctor(current, tokenEnd);
+    current = tokenEnd;
+    if (current == end)
+      return true;
+
+    // Skip the separator, with the spaces on either side.
+    if (delimiter == ' ')
+    {
+      if (*current != ' ')
+        return false;
+    }
+    else
+    {
+      while (current < end && *current == ' ')
+        ++current;
+      if (current == end || *current != delimiter)
+        return false;
+      ++current;
+    }
+
+    while (current < end && *current == ' ')
+      ++current;
+  }
+}
+
+template<typename TokenFunctor>
+std::string LoadCSV::ParseChunk(const Chunk& chunk,
+                                const size_t width,
+                                const bool transpose,
+                                TokenFunctor tokenFunctor) const
+{
+  size_t line = chunk.firstLine;
+  const char* begin = chunk.begin;
+  while (begin < chunk.end)
+  {
+    const char* newline = (const char*) std::memchr(begin, '\n',
+        chunk.end - begin);
+    const char* end = (newline == NULL) ? chunk.end : newline;
+
+    size_t token = 0;
+    const bool canParse = ParseLine(begin, end,
+        [&](const char* tokenBegin, const char* tokenEnd)
+        {
+          if (token < width)
+          {
+            if (transpose)
+              tokenFunctor(token, line, tokenBegin, tokenEnd);
+            else
+              tokenFunctor(line, token, tokenBegin, tokenEnd);
+          }
+          ++token;
+        });
+
+    // Make sure we got the right number of dimensions.
+    if (token != width)
+    {
+      std::ostringstream oss;
+      oss << "LoadCSV::Load(): wrong number of dimensions (" << token
+          << ") on line " << line << "; should be " << width
+          << " dimensions.";
+      return oss.str();
+    }
+
+    if (!canParse)
+    {
+      std::ostringstream oss;
+      oss << "LoadCSV::Load(): parsing error on line " << line << "!";
+      return oss.str();
+    }
+
+    ++line;
+    begin = end + 1;
+  }
+
+  return std::string();
+}
+
+template<typename T, typename PolicyType>
+void LoadCSV::FirstPass(DatasetMapper<PolicyType>& infoSet,
+                        const size_t width,
+                        const bool transpose) const
+{
+  if (!PolicyType::NeedsFirstPass)
+    return;
+
+  for (size_t i = 0; i < chunks.size(); ++i)
+  {
+    const std::string error = ParseChunk(chunks[i], width, transpose,
+        [&](const size_t row, const size_t /* col */, const char* begin,
+            const char* end)
+        {
+          infoSet.template MapFirstPass<T>(std::string(begin, end), row);
+        });
+
+    if (!error.empty())
+      throw std::runtime_error(error);
+  }
+}
+
+template<typename T, typename PolicyType>
+void LoadCSV::ParallelParse(arma::Mat<T>& inout,
+                            DatasetMapper<PolicyType>& infoSet,
+                            const size_t width,
+                            const bool transpose) const
+{
+  // Read the numbers of each chunk directly into the matrix, and keep the
+  // other tokens aside.
+  std::vector<std::vector<Token>> others(chunks.size());
+  std::vector<std::string> errors(chunks.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) chunks.size(); ++i)
+  {
+    errors[i] = ParseChunk(chunks[i], width, transpose,
+        [&](const size_t row, const size_t col, const char* begin,
+            const char* end)
+        {
+          if (!ReadNumber(begin, end, inout(row, col)))
+            others[i].push_back(Token { row, col, begin, end });
+        });
+  }
+  ThrowFirstError(errors);
+
+  // A number doesn't change the type of its dimension, so the first pass only
+  // needs the other tokens, in the order of the file.
+  if (PolicyType::NeedsFirstPass)
+  {
+    for (size_t i = 0; i < others.size(); ++i)
+    {
+      for (size_t j = 0; j < others[i].size(); ++j)
+      {
+        const Token& token = others[i][j];
+        infoSet.template MapFirstPass<T>(std::string(token.begin, token.end),
+            token.row);
+      }
+    }
+  }
+
+  // Every token of a categorical dimension is mapped, numbers included, so
+  // collect them in a second parse of the file, in the order of the file.
+  std::vector<char> categorical(inout.n_rows);
+  bool anyCategorical = false;
+  for (size_t row = 0; row < inout.n_rows; ++row)
+  {
+    categorical[row] = (infoSet.Type(row) == Datatype::categorical);
+    anyCategorical = anyCategorical || categorical[row];
+  }
+
+  if (anyCategorical)
+  {
+    std::vector<std::vector<Token>> mapped(chunks.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) chunks.size(); ++i)
+    {
+      ParseChunk(chunks[i], width, transpose,
+          [&](const size_t row, const size_t col, const char* begin,
+              const char* end)
+          {
+            if (categorical[row])
+              mapped[i].push_back(Token { row, col, begin, end });
+          });
+    }
+
+    for (size_t i = 0; i < mapped.size(); ++i)
+    {
+      for (size_t j = 0; j < mapped[i].size(); ++j)
+      {
+        const Token& token = mapped[i][j];
+        inout(token.row, token.col) =
+            infoSet.template MapString<T>(token.begin, token.end, token.row);
+      }
+    }
+  }
+
+  // The other tokens of the numeric dimensions are mapped on their own.
+  for (size_t i = 0; i < others.size(); ++i)
+  {
+    for (size_t j = 0; j < others[i].size(); ++j)
+    {
+      const Token& token = others[i][j];
+      if (!categorical[token.row])
+      {
+        inout(token.row, token.col) =
+            infoSet.template MapString<T>(token.begin, token.end, token.row);
+      }
+    }
+  }
+}
+
+template<typename T, typename PolicyType>
+void LoadCSV::SerialParse(arma::Mat<T>& inout,
+                          DatasetMapper<PolicyType>& infoSet,
+                          const size_t width,
+                          const bool transpose) const
+{
+  FirstPass<T>(infoSet, width, transpose);
+
+  for (size_t i = 0; i < chunks.size(); ++i)
+  {
+    const std::string error = ParseChunk(chunks[i], width, transpose,
+        [&](const size_t row, const size_t col, const char* begin,
+            const char* end)
+        {
+          inout(row, col) = infoSet.template MapString<T>(begin, end, row);
+        });
+
+    if (!error.empty())
+      throw std::runtime_error(error);
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -17,10 +17,12 @@
 #include <exception>
 #include <algorithm>
 #include <mlpack/core/util/timers.hpp>
+#include <mlpack/core/util/numa.hpp>
 
 #include "load_csv.hpp"
 #include "load.hpp"
 #include "extension.hpp"
+#include "mapped_matrix.hpp"
 
 #include <boost/algorithm/string/trim.hpp>
 #include <boost/tokenizer.hpp>
@@ -107,6 +109,33 @@ bool Load(const std::string& filename,
     return false;
   }
 
+  // A mapped matrix becomes the memory of the matrix, without being copied; it
+  // is never transposed, since it is stored as it is in memory.
+  if (extension == "mmat")
+  {
+    Log::Info << "Mapping '" << filename << "' as mapped matrix data.  "
+        << std::flush;
+    try
+    {
+      LoadMappedMatrix(filename, matrix);
+    }
+    catch (std::exception& e)
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols << ".\n";
+    Timer::Stop("loading_data");
+    return true;
+  }
+
   bool unknownType = false;
   arma::file_type loadType;
   std::string stringType;
@@ -293,6 +322,9 @@ bool Load(const std::string& filename,
     inplace_transpose(matrix);
   }
 
+  // Move the matrix to memory placed with the NUMA policy, if one is set.
+  PlaceMatrix(matrix);
+
   Timer::Stop("loading_data");
 
   // Finally, return the success indicator.
@@ -388,6 +420,8 @@ bool Load(const std::string& filename,
   Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
       << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
 
+  PlaceMatrix(matrix);
+
   Timer::Stop("loading_data");
 
   return true;
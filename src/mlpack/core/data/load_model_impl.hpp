@@ -19,6 +19,7 @@
 #include <mlpack/core/util/timers.hpp>
 
 #include "extension.hpp"
+#include "mapped_archive.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/algorithm/string/trim.hpp>
@@ -49,6 +50,8 @@ bool Load(const std::string& filename,
       f = format::binary;
     else if (extension == "txt")
       f = format::text;
+    else if (extension == "mbin")
+      f = format::mapped;
     else
     {
       if (fatal)
@@ -62,6 +65,26 @@ bool Load(const std::string& filename,
     }
   }
 
+  // A mapped model is read from the mapping of the file.
+  if (f == format::mapped)
+  {
+    try
+    {
+      LoadMappedArchive(filename, name, t);
+    }
+    catch (std::exception& e)
+    {
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    return true;
+  }
+
   // Now load the given format.
   std::ifstream ifs;
 #ifdef _WIN32 // Open non-text in binary mode on Windows.
@@ -0,0 +1,73 @@
+/**
+ * @file load_sparse.hpp
+ *
+ * Parallel loaders of sparse datasets in the LibSVM format and in coordinate
+ * lists, which build an arma::SpMat directly.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_SPARSE_HPP
+#define MLPACK_CORE_DATA_LOAD_SPARSE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Load a dataset in the LibSVM (or SVMlight) format, where each line is a
+ * point: its label followed by the nonzero values of the point, as
+ * "index:value" pairs with 1-based indices in increasing order.
+ *
+ * @code
+ * 1 1:0.5 4:2 10:-1
+ * -1 2:1.5 4:1 # comment
+ * @endcode
+ *
+ * Each point becomes a column of the matrix, and the matrix has as many rows
+ * as the largest index.  Comments start with '#'; "qid:" ranking tokens are
+ * ignored.  The file is mapped into memory and its lines are parsed in
+ * parallel chunks; the matrix is then built in compressed sparse column form
+ * at once.  A std::runtime_error is thrown if the file can't be parsed.
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Matrix to load the points into.
+ * @param labels Row vector to load the labels into.
+ */
+template<typename eT>
+void LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::rowvec& labels);
+
+/**
+ * Load a sparse matrix from a coordinate list, where each line holds the row,
+ * the column and the value of an element, separated by whitespace or commas,
+ * with 0-based indices, as written by Armadillo's coord_ascii format.  The
+ * elements can be in any order; the values of repeated elements are added.
+ * Lines starting with '%' or '#' are comments.  The matrix has as many rows and
+ * columns as needed to hold the largest indices.
+ *
+ * The file is mapped into memory and its lines are parsed in parallel chunks;
+ * the matrix is then built from all the elements at once.  A
+ * std::runtime_error is thrown if the file can't be parsed.
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Matrix to load the elements into.
+ * @param transpose If true, the rows given in the file become the columns of
+ *     the matrix, as the points of a dense text file do.
+ */
+template<typename eT>
+void LoadCoordinates(const std::string& filename,
+                     arma::SpMat<eT>& matrix,
+                     const bool transpose = true);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "load_sparse_impl.hpp"
+
+#endif
@@ -0,0 +1,492 @@
+/**
+ * @file load_sparse_impl.hpp
+ *
+ * Implementation of the sparse loaders, and of the overloads of data::Load()
+ * for sparse matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_LOAD_SPARSE_IMPL_HPP
+#define MLPACK_CORE_DATA_LOAD_SPARSE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "load_sparse.hpp"
+
+#include <cctype>
+#include <cstring>
+#include <mlpack/core/util/log.hpp>
+#include <mlpack/core/util/timers.hpp>
+
+#include "extension.hpp"
+#include "mapped_file.hpp"
+#include "read_number.hpp"
+
+namespace mlpack {
+namespace data {
+
+namespace details {
+
+//! The elements parsed from a chunk of lines of a sparse file.
+template<typename eT>
+struct SparseChunk
+{
+  SparseChunk() : maxRow(0), maxCol(0), lines(0) { }
+
+  //! The rows of the elements.
+  std::vector<arma::uword> rows;
+  //! The columns of the elements; not used for LibSVM files.
+  std::vector<arma::uword> cols;
+  //! The values of the elements.
+  std::vector<eT> values;
+  //! The number of elements of each point of a LibSVM file.
+  std::vector<arma::uword> pointSizes;
+  //! The labels of the points of a LibSVM file.
+  std::vector<double> labels;
+  //! One past the largest row of the elements.
+  arma::uword maxRow;
+  //! One past the largest column of the elements.
+  arma::uword maxCol;
+  //! The number of lines that were parsed.
+  size_t lines;
+  //! The first error of the chunk; empty if there is none.
+  std::string error;
+};
+
+/**
+ * Split the given line into the tokens separated by the given characters, and
+ * call the given functor on each token with its first and one past its last
+ * character, until it returns false.
+ */
+template<typename TokenFunctor>
+void SplitSparseLine(const char* begin,
+                     const char* end,
+                     const char* separators,
+                     TokenFunctor tokenFunctor)
+{
+  while (begin < end)
+  {
+    while (begin < end && std::strchr(separators, *begin) != NULL)
+      ++begin;
+    if (begin == end)
+      return;
+
+    const char* tokenEnd = begin;
+    while (tokenEnd < end && std::strchr(separators, *tokenEnd) == NULL)
+      ++tokenEnd;
+    if (!tokenFunctor(begin, tokenEnd))
+      return;
+
+    begin = tokenEnd;
+  }
+}
+
+//! Read the given token as an index; false if it isn't made of digits.
+inline bool ReadIndex(const char* begin, const char* end, arma::uword& index)
+{
+  index = 0;
+  if (begin == end || end - begin > 18)
+    return false;
+
+  for (; begin < end; ++begin)
+  {
+    if (!std::isdigit((unsigned char) *begin))
+      return false;
+    index = 10 * index + (*begin - '0');
+  }
+
+  return true;
+}
+
+//! Read the given token as a number; false if it isn't one.
+template<typename eT>
+bool ReadValue(const char* begin, const char* end, eT& value)
+{
+  if (ReadNumber(begin, end, value))
+    return true;
+
+  // Other numbers, like "nan" or "1e999", are read by the C library.
+  const std::string token(begin, end);
+  char* tokenEnd;
+  const double number = std::strtod(token.c_str(), &tokenEnd);
+  if (token.empty() || *tokenEnd != '\0')
+    return false;
+
+  value = eT(number);
+  return true;
+}
+
+/**
+ * Parse the lines of the given chunk of a LibSVM file.  The parse stops at the
+ * first line with an error.
+ */
+template<typename eT>
+void ParseLibSVMChunk(const char* begin,
+                      const char* end,
+                      SparseChunk<eT>& chunk)
+{
+  while (begin < end && chunk.error.empty())
+  {
+    const char* newline = (const char*) std::memchr(begin, '\n', end - begin);
+    const char* lineEnd = (newline == NULL) ? end : newline;
+    const char* comment = (const char*) std::memchr(begin, '#',
+        lineEnd - begin);
+    const char* lineBegin = begin;
+    begin = lineEnd + 1;
+    ++chunk.lines;
+
+    bool first = true;
+    arma::uword lastIndex = 0;
+    const size_t oldSize = chunk.values.size();
+    SplitSparseLine(lineBegin, (comment == NULL) ? lineEnd : comment, " \t\r",
+        [&](const char* tokenBegin, const char* tokenEnd)
+        {
+          if (first)
+          {
+            first = false;
+            double label;
+            if (!ReadValue(tokenBegin, tokenEnd, label))
+            {
+              chunk.error = "bad label '" + std::string(tokenBegin, tokenEnd) +
+                  "'";
+              return false;
+            }
+
+            chunk.labels.push_back(label);
+            return true;
+          }
+
+          const char* colon = (const char*) std::memchr(tokenBegin, ':',
+              tokenEnd - tokenBegin);
+          if (colon != NULL && colon - tokenBegin == 3 &&
+              std::strncmp(tokenBegin, "qid", 3) == 0)
+            return true;
+
+          arma::uword index;
+          eT value;
+          if (colon == NULL || !ReadIndex(tokenBegin, colon, index) ||
+              !ReadValue(colon + 1, tokenEnd, value))
+          {
+            chunk.error = "bad element '" + std::string(tokenBegin, tokenEnd) +
+                "'";
+            return false;
+          }
+
+          if (index <= lastIndex)
+          {
+            chunk.error = "the indices must be positive and increasing";
+            return false;
+          }
+
+          lastIndex = index;
+          chunk.maxRow = std::max(chunk.maxRow, index);
+          if (value != eT(0))
+          {
+            chunk.rows.push_back(index - 1);
+            chunk.values.push_back(value);
+          }
+          return true;
+        });
+
+    // Lines without a label are empty.
+    if (!first && chunk.error.empty())
+      chunk.pointSizes.push_back(chunk.values.size() - oldSize);
+  }
+}
+
+/**
+ * Parse the lines of the given chunk of a coordinate list.  The parse stops at
+ * the first line with an error.
+ */
+template<typename eT>
+void ParseCoordinateChunk(const char* begin,
+                          const char* end,
+                          const bool transpose,
+                          SparseChunk<eT>& chunk)
+{
+  while (begin < end && chunk.error.empty())
+  {
+    const char* newline = (const char*) std::memchr(begin, '\n', end - begin);
+    const char* lineEnd = (newline == NULL) ? end : newline;
+    const char* lineBegin = begin;
+    begin = lineEnd + 1;
+    ++chunk.lines;
+
+    while (lineBegin < lineEnd && std::isspace((unsigned char) *lineBegin))
+      ++lineBegin;
+    if (lineBegin == lineEnd || *lineBegin == '%' || *lineBegin == '#')
+      continue;
+
+    size_t token = 0;
+    arma::uword indices[2];
+    eT value = eT(0);
+    SplitSparseLine(lineBegin, lineEnd, " \t\r,",
+        [&](const char* tokenBegin, const char* tokenEnd)
+        {
+          if ((token < 2 && !ReadIndex(tokenBegin, tokenEnd, indices[token])) ||
+              (token == 2 && !ReadValue(tokenBegin, tokenEnd, value)))
+          {
+            chunk.error = "bad token '" + std::string(tokenBegin, tokenEnd) +
+                "'";
+            return false;
+          }
+
+          return (++token <= 3);
+        });
+
+    if (!chunk.error.empty())
+      break;
+
+    if (token != 3)
+    {
+      std::ostringstream oss;
+      oss << "wrong number of tokens (" << token << "); should be 3";
+      chunk.error = oss.str();
+      break;
+    }
+
+    const arma::uword row = transpose ? indices[1] : indices[0];
+    const arma::uword col = transpose ? indices[0] : indices[1];
+    chunk.maxRow = std::max(chunk.maxRow, row + 1);
+    chunk.maxCol = std::max(chunk.maxCol, col + 1);
+    if (value != eT(0))
+    {
+      chunk.rows.push_back(row);
+      chunk.cols.push_back(col);
+      chunk.values.push_back(value);
+    }
+  }
+}
+
+/**
+ * Map the given file and parse its chunks in parallel with the given
+ * function, then throw the first error of the file, if any.
+ */
+template<typename eT, typename ParseFunction>
+std::vector<SparseChunk<eT>> ParseSparseFile(const std::string& filename,
+                                             ParseFunction parse)
+{
+  MappedFile file(filename);
+  const char* data = file.Data();
+  const std::vector<const char*> starts = SplitLineChunks(data,
+      data + file.Size());
+  const size_t numChunks = starts.size() - 1;
+
+  std::vector<SparseChunk<eT>> chunks(numChunks);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numChunks; ++i)
+    parse(starts[i], starts[i + 1], chunks[i]);
+
+  // The chunks before the first error are complete, so the line of the error
+  // is known.
+  size_t lines = 0;
+  for (size_t i = 0; i < numChunks; ++i)
+  {
+    lines += chunks[i].lines;
+    if (!chunks[i].error.empty())
+    {
+      std::ostringstream oss;
+      oss << "error on line " << lines << " of '" << filename << "': "
+          << chunks[i].error;
+      throw std::runtime_error(oss.str());
+    }
+  }
+
+  return chunks;
+}
+
+} // namespace details
+
+template<typename eT>
+void LoadLibSVM(const std::string& filename,
+                arma::SpMat<eT>& matrix,
+                arma::rowvec& labels)
+{
+  std::vector<details::SparseChunk<eT>> chunks =
+      details::ParseSparseFile<eT>(filename,
+      [](const char* begin, const char* end, details::SparseChunk<eT>& chunk)
+      {
+        details::ParseLibSVMChunk(begin, end, chunk);
+      });
+
+  // Find where the points and the elements of each chunk start.
+  const size_t numChunks = chunks.size();
+  std::vector<size_t> firstPoints(numChunks + 1, 0);
+  arma::uword numRows = 0;
+  for (size_t i = 0; i < numChunks; ++i)
+  {
+    firstPoints[i + 1] = firstPoints[i] + chunks[i].labels.size();
+    numRows = std::max(numRows, chunks[i].maxRow);
+  }
+
+  const size_t numPoints = firstPoints[numChunks];
+  arma::uvec colPtrs(numPoints + 1);
+  colPtrs[0] = 0;
+  for (size_t i = 0, col = 0; i < numChunks; ++i)
+    for (size_t j = 0; j < chunks[i].pointSizes.size(); ++j, ++col)
+      colPtrs[col + 1] = colPtrs[col] + chunks[i].pointSizes[j];
+
+  // Copy the elements of the chunks in compressed sparse column form, in
+  // parallel; the points are already in order, and so are their elements.
+  arma::uvec rowIndices(colPtrs[numPoints]);
+  arma::Col<eT> values(colPtrs[numPoints]);
+  labels.set_size(numPoints);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numChunks; ++i)
+  {
+    const size_t offset = colPtrs[firstPoints[i]];
+    std::copy(chunks[i].rows.begin(), chunks[i].rows.end(),
+        rowIndices.begin() + offset);
+    std::copy(chunks[i].values.begin(), chunks[i].values.end(),
+        values.begin() + offset);
+    std::copy(chunks[i].labels.begin(), chunks[i].labels.end(),
+        labels.begin() + firstPoints[i]);
+  }
+
+  matrix = arma::SpMat<eT>(rowIndices, colPtrs, values, numRows, numPoints);
+}
+
+template<typename eT>
+void LoadCoordinates(const std::string& filename,
+                     arma::SpMat<eT>& matrix,
+                     const bool transpose)
+{
+  std::vector<details::SparseChunk<eT>> chunks =
+      details::ParseSparseFile<eT>(filename,
+      [transpose](const char* begin, const char* end,
+                  details::SparseChunk<eT>& chunk)
+      {
+        details::ParseCoordinateChunk(begin, end, transpose, chunk);
+      });
+
+  const size_t numChunks = chunks.size();
+  std::vector<size_t> offsets(numChunks + 1, 0);
+  arma::uword numRows = 0, numCols = 0;
+  for (size_t i = 0; i < numChunks; ++i)
+  {
+    offsets[i + 1] = offsets[i] + chunks[i].values.size();
+    numRows = std::max(numRows, chunks[i].maxRow);
+    numCols = std::max(numCols, chunks[i].maxCol);
+  }
+
+  arma::umat locations(2, offsets[numChunks]);
+  arma::Col<eT> values(offsets[numChunks]);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numChunks; ++i)
+  {
+    for (size_t j = 0; j < chunks[i].values.size(); ++j)
+    {
+      locations(0, offsets[i] + j) = chunks[i].rows[j];
+      locations(1, offsets[i] + j) = chunks[i].cols[j];
+      values[offsets[i] + j] = chunks[i].values[j];
+    }
+  }
+
+  // The elements are sorted, and repeated elements added, by the batch
+  // constructor.
+  matrix = arma::SpMat<eT>(true, locations, values, numRows, numCols, true,
+      true);
+}
+
+template<typename eT>
+bool Load(const std::string& filename,
+          arma::SpMat<eT>& matrix,
+          const bool fatal,
+          const bool transpose)
+{
+  Timer::Start("loading_data");
+
+  const std::string extension = Extension(filename);
+  try
+  {
+    if (extension == "svm" || extension == "libsvm" || extension == "svmlight")
+    {
+      Log::Info << "Loading '" << filename << "' as LibSVM data.  "
+          << std::flush;
+      arma::rowvec labels;
+      LoadLibSVM(filename, matrix, labels);
+    }
+    else if (extension == "csv" || extension == "tsv" || extension == "txt" ||
+        extension == "coo")
+    {
+      Log::Info << "Loading '" << filename << "' as coordinate list data.  "
+          << std::flush;
+      LoadCoordinates(filename, matrix, transpose);
+    }
+    else if (extension == "bin")
+    {
+      Log::Info << "Loading '" << filename << "' as Armadillo binary "
+          << "formatted data.  " << std::flush;
+      if (!matrix.load(filename, arma::arma_binary))
+      {
+        std::ostringstream oss;
+        oss << "Loading from '" << filename << "' failed.";
+        throw std::runtime_error(oss.str());
+      }
+
+      if (transpose)
+        matrix = matrix.t();
+    }
+    else
+    {
+      std::ostringstream oss;
+      oss << "Unable to detect type of '" << filename << "'; incorrect "
+          << "extension?";
+      throw std::runtime_error(oss.str());
+    }
+  }
+  catch (std::exception& e)
+  {
+    Log::Info << std::endl;
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols << ", "
+      << matrix.n_nonzero << " nonzero elements.\n";
+  Timer::Stop("loading_data");
+  return true;
+}
+
+template<typename eT>
+bool Load(const std::string& filename,
+          arma::SpMat<eT>& matrix,
+          arma::rowvec& labels,
+          const bool fatal)
+{
+  Timer::Start("loading_data");
+  Log::Info << "Loading '" << filename << "' as LibSVM data.  " << std::flush;
+
+  try
+  {
+    LoadLibSVM(filename, matrix, labels);
+  }
+  catch (std::exception& e)
+  {
+    Log::Info << std::endl;
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << e.what() << std::endl;
+    else
+      Log::Warn << e.what() << std::endl;
+
+    return false;
+  }
+
+  Log::Info << "Size is " << matrix.n_rows << " x " << matrix.n_cols << ", "
+      << matrix.n_nonzero << " nonzero elements.\n";
+  Timer::Stop("loading_data");
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -42,6 +42,12 @@ class IncrementPolicy
   //! We do need a first pass over the data to set the dimension types right.
   static const bool NeedsFirstPass = true;
 
+  /**
+   * Return whether a token that is a number may be mapped even though its
+   * dimension is numeric; this is only the case if all tokens are mapped.
+   */
+  bool MapsNumericTokens() const { return forceAllMappings; }
+
   /**
    * Determine if the dimension is numeric or categorical.
    */
@@ -80,10 +86,10 @@ class IncrementPolicy
    * the given dimension. This function is used as a helper function for
    * DatasetMapper class.
    *
-   * @tparam MapType Type of unordered_map that contains mapped value pairs
+   * @tparam MapType Type of the mappings given by the DatasetMapper.
    * @param input Input to find/create mapping for.
    * @param dimension Index of the dimension of the input.
-   * @param maps Unordered map given by the DatasetMapper.
+   * @param maps Mappings given by the DatasetMapper.
    * @param types Vector containing the type information about each dimensions.
    */
   template<typename MapType, typename T, typename InputType>
@@ -109,37 +115,55 @@ class IncrementPolicy
       // Otherwise, we must map.
     }
 
-    // If this condition is true, either we have no mapping for the given input
-    // or we have no mappings for the given dimension at all.  In either case,
-    // we create a mapping.
-    if (maps.count(dimension) == 0 ||
-        maps[dimension].first.count(input) == 0)
-    {
-      // This input does not exist yet.
-      size_t numMappings = maps[dimension].first.size();
+    if (maps.size() <= dimension)
+      maps.resize(dimension + 1);
 
-      // Change type of the feature to categorical.
-      if (numMappings == 0)
-        types[dimension] = Datatype::categorical;
+    // If the input already exists in the mapping, return its value.
+    const MappedType* value = maps[dimension].Find(input);
+    if (value != NULL)
+      return T(*value);
 
-      typedef typename std::pair<InputType, MappedType> PairType;
-      maps[dimension].first.insert(PairType(input, numMappings));
+    // Otherwise this input does not exist yet, so we create a mapping.
+    const size_t numMappings = maps[dimension].Size();
 
-      // Do we need to create the second map?
-      if (maps[dimension].second.count(numMappings) == 0)
-      {
-        maps[dimension].second.insert(std::make_pair(numMappings,
-            std::vector<InputType>()));
-      }
-      maps[dimension].second[numMappings].push_back(input);
+    // Change type of the feature to categorical.
+    if (numMappings == 0)
+      types[dimension] = Datatype::categorical;
 
-      return T(numMappings);
-    }
-    else
+    maps[dimension].Insert(input, numMappings);
+    return T(numMappings);
+  }
+
+  /**
+   * Given the characters of a string input and the dimension to which it
+   * belongs, return its numeric mapping, like the overload that takes the
+   * input.  In a categorical dimension, an input that is already mapped is
+   * found without building a std::string.
+   *
+   * @tparam MapType Type of the mappings given by the DatasetMapper.
+   * @param begin First character of the input.
+   * @param end Character after the last character of the input.
+   * @param dimension Index of the dimension of the input.
+   * @param maps Mappings given by the DatasetMapper.
+   * @param types Vector containing the type information about each dimensions.
+   */
+  template<typename MapType, typename T>
+  T MapString(const char* begin,
+              const char* end,
+              const size_t dimension,
+              MapType& maps,
+              std::vector<Datatype>& types)
+  {
+    if ((types[dimension] == Datatype::categorical || forceAllMappings) &&
+        dimension < maps.size())
     {
-      // This input already exists in the mapping.
-      return maps[dimension].first.at(input);
+      const MappedType* value = maps[dimension].Find(begin, end - begin);
+      if (value != NULL)
+        return T(*value);
     }
+
+    return MapString<MapType, T>(std::string(begin, end), dimension, maps,
+        types);
   }
 
  private:
@@ -54,6 +54,24 @@ class MissingPolicy
   //! This doesn't need a first pass over the data to set up.
   static const bool NeedsFirstPass = false;
 
+  /**
+   * Return whether a token that is a number may be mapped; this is the case if
+   * one of the strings of the missingSet is a number.
+   */
+  bool MapsNumericTokens() const
+  {
+    for (const std::string& string : missingSet)
+    {
+      std::stringstream token(string);
+      double value;
+      token >> value;
+      if (!token.fail() && token.eof())
+        return true;
+    }
+
+    return false;
+  }
+
   /**
    * There is nothing for us to do here, but this is required by the MapPolicy
    * type.
@@ -72,10 +90,10 @@ class MissingPolicy
    * dimension. This function is used as a helper function for DatasetMapper
    * class.
    *
-   * @tparam MapType Type of unordered_map that contains mapped value pairs
+   * @tparam MapType Type of the mappings given by the DatasetMapper.
    * @param string String to find/create mapping for.
    * @param dimension Index of the dimension of the string.
-   * @param maps Unordered map given by the DatasetMapper.
+   * @param maps Mappings given by the DatasetMapper.
    * @param types Vector containing the type information about each dimensions.
    */
   template<typename MapType, typename T>
@@ -94,10 +112,6 @@ class MissingPolicy
     token >> t; // Could be sped up by only doing this if we need to.
 
     MappedType value = std::numeric_limits<MappedType>::quiet_NaN();
-    // But we can't use that for the map, so we need some other thing that will
-    // represent quiet_NaN().
-    const MappedType mapValue = std::nexttoward(
-        std::numeric_limits<MappedType>::max(), MappedType(0));
 
     // If extraction of the value fails, or if it is a value that is supposed to
     // be mapped, then do mapping.
@@ -106,22 +120,10 @@ class MissingPolicy
     {
       // Everything is mapped to NaN.  However we must still keep track of
       // everything that we have mapped, so we add it to the maps if needed.
-      if (maps.count(dimension) == 0 ||
-          maps[dimension].first.count(string) == 0)
-      {
-        // This string does not exist yet.
-        typedef std::pair<std::string, MappedType> PairType;
-        maps[dimension].first.insert(PairType(string, value));
-
-        // Insert right mapping too.
-        if (maps[dimension].second.count(mapValue) == 0)
-        {
-          // Create new element in reverse map.
-          maps[dimension].second.insert(std::make_pair(mapValue,
-              std::vector<std::string>()));
-        }
-        maps[dimension].second[mapValue].push_back(string);
-      }
+      if (maps.size() <= dimension)
+        maps.resize(dimension + 1);
+      if (maps[dimension].Find(string) == NULL)
+        maps[dimension].Insert(string, value);
 
       return value;
     }
@@ -132,6 +134,34 @@ class MissingPolicy
     }
   }
 
+  /**
+   * Given the characters of a string and the dimension to which it belongs,
+   * return its numeric mapping, like the overload that takes the string.  A
+   * string that is already mapped is found without building a std::string.
+   *
+   * @tparam MapType Type of the mappings given by the DatasetMapper.
+   * @param begin First character of the string.
+   * @param end Character after the last character of the string.
+   * @param dimension Index of the dimension of the string.
+   * @param maps Mappings given by the DatasetMapper.
+   * @param types Vector containing the type information about each dimensions.
+   */
+  template<typename MapType, typename T>
+  T MapString(const char* begin,
+              const char* end,
+              const size_t dimension,
+              MapType& maps,
+              std::vector<Datatype>& types)
+  {
+    // Everything that is mapped is mapped to NaN.
+    if (dimension < maps.size() &&
+        maps[dimension].Find(begin, end - begin) != NULL)
+      return std::numeric_limits<MappedType>::quiet_NaN();
+
+    return MapString<MapType, T>(std::string(begin, end), dimension, maps,
+        types);
+  }
+
  private:
   // Note that missingSet and maps are different.
   // missingSet specifies which value/string should be mapped and may be a
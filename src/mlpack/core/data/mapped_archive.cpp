@@ -0,0 +1,62 @@
+/**
+ * @file mapped_archive.cpp
+ *
+ * Mapping of model files in the mapped format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "mapped_archive.hpp"
+#include "mapped_file.hpp"
+
+#include <memory>
+#include <mutex>
+
+namespace mlpack {
+namespace data {
+
+char* MapArchiveFile(const std::string& filename, MappedArchiveHeader& header)
+{
+  // The mappings live until the program exits.
+  static std::mutex mappingsMutex;
+  static std::vector<std::unique_ptr<MappedFile>> mappings;
+
+  std::unique_ptr<MappedFile> file(new MappedFile(filename, true));
+  if (file->Size() < sizeof(header))
+  {
+    std::ostringstream oss;
+    oss << "MapArchiveFile(): '" << filename << "' is too short to be a "
+        << "mapped model";
+    throw std::runtime_error(oss.str());
+  }
+  std::memcpy(&header, file->Data(), sizeof(header));
+
+  if (std::strncmp(header.magic, "MLPACK_MBIN", sizeof(header.magic)) != 0)
+  {
+    std::ostringstream oss;
+    oss << "MapArchiveFile(): '" << filename << "' is not a mapped model";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (header.archiveOffset > file->Size() ||
+      header.archiveSize > file->Size() - header.archiveOffset ||
+      header.blocksOffset % MatrixBlocks::alignment != 0 ||
+      header.blocksOffset > file->Size() ||
+      header.blocksSize > file->Size() - header.blocksOffset)
+  {
+    std::ostringstream oss;
+    oss << "MapArchiveFile(): '" << filename << "' is truncated or corrupt";
+    throw std::runtime_error(oss.str());
+  }
+
+  char* memory = file->Data();
+
+  std::lock_guard<std::mutex> lock(mappingsMutex);
+  mappings.push_back(std::move(file));
+  return memory;
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,144 @@
+/**
+ * @file mapped_archive.hpp
+ *
+ * Saving and loading of models in the mapped format, where the large matrices
+ * are stored as aligned raw blocks that are used in place once the file is
+ * mapped into memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_ARCHIVE_HPP
+#define MLPACK_CORE_DATA_MAPPED_ARCHIVE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <cstdint>
+#include <streambuf>
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+
+#include "matrix_blocks.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The 64-byte header of a model file in the mapped format.  It is followed by
+ * a boost::serialization binary archive of the model, and then by the blocks
+ * of its large matrices (see MatrixBlocks), which start at an aligned offset.
+ */
+struct MappedArchiveHeader
+{
+  //! "MLPACK_MBIN", padded with zeros.
+  char magic[16];
+  //! The offset of the archive in the file.
+  std::uint64_t archiveOffset;
+  //! The size of the archive.
+  std::uint64_t archiveSize;
+  //! The offset of the blocks in the file; a multiple of the alignment.
+  std::uint64_t blocksOffset;
+  //! The size of the blocks.
+  std::uint64_t blocksSize;
+  //! Unused; zero.
+  std::uint64_t reserved[2];
+};
+
+/**
+ * Map the given model file into memory, copy-on-write, and check its header.
+ * The mapping lives until the program exits, since the loaded matrices use it.
+ * A std::runtime_error is thrown if the file can't be mapped, or is not a
+ * model in the mapped format.
+ *
+ * @param filename Name of the file to map.
+ * @param header Set to the header of the file.
+ * @return The start of the mapping.
+ */
+char* MapArchiveFile(const std::string& filename, MappedArchiveHeader& header);
+
+/**
+ * A read-only stream buffer over the given memory, so that an archive can be
+ * read from a mapping without copying it.
+ */
+class MemoryBuffer : public std::streambuf
+{
+ public:
+  //! Read from the given memory.
+  MemoryBuffer(char* memory, const size_t size)
+  {
+    setg(memory, memory, memory + size);
+  }
+};
+
+/**
+ * Save the given model to the given stream in the mapped format.  The archive
+ * is written to memory first; the matrices that get their own blocks are
+ * written straight from their memory afterwards.
+ *
+ * @param stream Stream to save to, opened in binary mode.
+ * @param name Name of the model in the archive.
+ * @param t Model to save.
+ */
+template<typename T>
+void SaveMappedArchive(std::ostream& stream, const std::string& name, T& t)
+{
+  MatrixBlocks blocks;
+  std::ostringstream archive;
+  {
+    MatrixBlocks::Scope scope(blocks);
+    boost::archive::binary_oarchive ar(archive);
+    ar << boost::serialization::make_nvp(name.c_str(), t);
+  }
+  const std::string archiveBytes = archive.str();
+
+  MappedArchiveHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::strncpy(header.magic, "MLPACK_MBIN", sizeof(header.magic));
+  header.archiveOffset = sizeof(header);
+  header.archiveSize = archiveBytes.size();
+  header.blocksOffset = (sizeof(header) + archiveBytes.size() +
+      MatrixBlocks::alignment - 1) / MatrixBlocks::alignment *
+      MatrixBlocks::alignment;
+  header.blocksSize = blocks.Size();
+
+  const char padding[MatrixBlocks::alignment] = { 0 };
+  stream.write((const char*) &header, sizeof(header));
+  stream.write(archiveBytes.data(), archiveBytes.size());
+  stream.write(padding, header.blocksOffset - sizeof(header) -
+      archiveBytes.size());
+  blocks.Write(stream);
+}
+
+/**
+ * Load the given model from the given file in the mapped format.  The file is
+ * mapped into memory; the matrices that have their own blocks use the memory
+ * of the mapping, without being copied, and the rest of the model is read
+ * from the archive.  The mapping is copy-on-write, so the matrices can be
+ * modified (or resized) without modifying the file.
+ *
+ * @param filename Name of the file to load.
+ * @param name Name of the model in the archive.
+ * @param t Model to load.
+ */
+template<typename T>
+void LoadMappedArchive(const std::string& filename,
+                       const std::string& name,
+                       T& t)
+{
+  MappedArchiveHeader header;
+  char* data = MapArchiveFile(filename, header);
+
+  MatrixBlocks blocks(data + header.blocksOffset, header.blocksSize);
+  MatrixBlocks::Scope scope(blocks);
+  MemoryBuffer buffer(data + header.archiveOffset, header.archiveSize);
+  std::istream stream(&buffer);
+  boost::archive::binary_iarchive ar(stream);
+  ar >> boost::serialization::make_nvp(name.c_str(), t);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
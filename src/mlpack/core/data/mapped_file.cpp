@@ -0,0 +1,143 @@
+/**
+ * @file mapped_file.cpp
+ *
+ * Implementation of the MappedFile class, with mmap() on POSIX systems and
+ * file mappings on Windows.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "mapped_file.hpp"
+
+#include <cstring>
+
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+MappedFile::MappedFile(const std::string& filename, const bool copyOnWrite) :
+    data(NULL),
+    size(0),
+    mapping(NULL)
+{
+  std::ostringstream oss;
+  oss << "MappedFile::MappedFile(): cannot map file '" << filename << "'";
+
+#ifdef _WIN32
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+      NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+    throw std::runtime_error(oss.str());
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize))
+  {
+    CloseHandle(file);
+    throw std::runtime_error(oss.str());
+  }
+  size = (size_t) fileSize.QuadPart;
+
+  // An empty file can't be mapped, and doesn't need to be.
+  if (size > 0)
+  {
+    mapping = CreateFileMappingA(file, NULL,
+        copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+    if (mapping != NULL)
+    {
+      data = (char*) MapViewOfFile(mapping,
+          copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+    }
+  }
+  CloseHandle(file);
+
+  if (size > 0 && data == NULL)
+  {
+    if (mapping != NULL)
+      CloseHandle(mapping);
+    throw std::runtime_error(oss.str());
+  }
+#else
+  const int file = open(filename.c_str(), O_RDONLY);
+  if (file < 0)
+    throw std::runtime_error(oss.str());
+
+  struct stat status;
+  if (fstat(file, &status) != 0)
+  {
+    close(file);
+    throw std::runtime_error(oss.str());
+  }
+  size = (size_t) status.st_size;
+
+  // An empty file can't be mapped, and doesn't need to be.
+  if (size > 0)
+  {
+    void* address = mmap(NULL, size,
+        copyOnWrite ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_PRIVATE, file,
+        0);
+    if (address == MAP_FAILED)
+    {
+      close(file);
+      throw std::runtime_error(oss.str());
+    }
+
+    data = (char*) address;
+  }
+  close(file);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+  if (data == NULL)
+    return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(data);
+  CloseHandle(mapping);
+#else
+  munmap(data, size);
+#endif
+}
+
+std::vector<const char*> SplitLineChunks(const char* begin, const char* end)
+{
+  const size_t size = end - begin;
+  const size_t minChunkSize = 1 << 20;
+  const size_t numChunks = std::max(size_t(1),
+      std::min(4 * NumThreads(), size / minChunkSize));
+
+  // Move the start of each chunk to the start of a line.
+  std::vector<const char*> starts(numChunks + 1, end);
+  starts[0] = begin;
+  for (size_t i = 1; i < numChunks; ++i)
+  {
+    const char* start = std::max(begin + i * (size / numChunks),
+        starts[i - 1]);
+    if (start > begin && start < end && *(start - 1) != '\n')
+    {
+      const char* newline = (const char*) std::memchr(start, '\n',
+          end - start);
+      start = (newline == NULL) ? end : newline + 1;
+    }
+    starts[i] = start;
+  }
+
+  return starts;
+}
+
+} // namespace data
+} // namespace mlpack
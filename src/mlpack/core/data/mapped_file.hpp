@@ -0,0 +1,82 @@
+/**
+ * @file mapped_file.hpp
+ *
+ * Definition of the MappedFile class, which maps a file into memory for
+ * reading.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_FILE_HPP
+#define MLPACK_CORE_DATA_MAPPED_FILE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A memory mapping of a whole file.  The contents of the file are read by the
+ * operating system as they are accessed, so that several threads can read
+ * different parts of a large file without copying it into a buffer first, and
+ * several processes that map the same file share its pages.  The mapping is
+ * released when the object is destroyed.
+ *
+ * A copy-on-write mapping can also be written to: the pages that are written
+ * are copied for this mapping only, and the file itself is never modified.
+ */
+class MappedFile
+{
+ public:
+  /**
+   * Map the given file into memory.  A std::runtime_error is thrown if the
+   * file can't be opened or mapped.
+   *
+   * @param filename Name of the file to map.
+   * @param copyOnWrite Whether the mapping can be written to.
+   */
+  MappedFile(const std::string& filename, const bool copyOnWrite = false);
+
+  //! Release the mapping.
+  ~MappedFile();
+
+  //! Get the contents of the file; this is NULL if the file is empty.
+  const char* Data() const { return data; }
+  //! Modify the contents of the mapping; only for copy-on-write mappings.
+  char* Data() { return data; }
+
+  //! Get the size of the file in bytes.
+  size_t Size() const { return size; }
+
+ private:
+  // A mapping can't be copied.
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+
+  //! The contents of the file.
+  char* data;
+
+  //! The size of the file in bytes.
+  size_t size;
+
+  //! The handle of the mapping; only used on Windows.
+  void* mapping;
+};
+
+/**
+ * Split the given text into chunks of whole lines, so that the chunks can be
+ * parsed in parallel.  Each thread gets a few chunks of at least 1MB, so that
+ * the threads stay busy even if some lines are longer than others.
+ *
+ * @param begin The first character of the text.
+ * @param end One past the last character of the text.
+ * @return The first character of each chunk, followed by end.
+ */
+std::vector<const char*> SplitLineChunks(const char* begin, const char* end);
+
+} // namespace data
+} // namespace mlpack
+
+#endif
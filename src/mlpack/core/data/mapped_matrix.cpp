@@ -0,0 +1,83 @@
+/**
+ * @file mapped_matrix.cpp
+ *
+ * Mapping of mapped matrix files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "mapped_matrix.hpp"
+#include "mapped_file.hpp"
+
+#include <memory>
+#include <mutex>
+
+namespace mlpack {
+namespace data {
+
+char* MapMatrixFile(const std::string& filename,
+                    const std::uint32_t elemType,
+                    size_t& rows,
+                    size_t& cols)
+{
+  // The mappings live until the program exits.
+  static std::mutex mappingsMutex;
+  static std::vector<std::unique_ptr<MappedFile>> mappings;
+
+  std::unique_ptr<MappedFile> file(new MappedFile(filename, true));
+
+  MappedMatrixHeader header;
+  if (file->Size() < sizeof(header))
+  {
+    std::ostringstream oss;
+    oss << "MapMatrixFile(): '" << filename << "' is too short to be a mapped "
+        << "matrix";
+    throw std::runtime_error(oss.str());
+  }
+  std::memcpy(&header, file->Data(), sizeof(header));
+
+  if (std::strncmp(header.magic, "MLPACK_MMAT", sizeof(header.magic)) != 0)
+  {
+    std::ostringstream oss;
+    oss << "MapMatrixFile(): '" << filename << "' is not a mapped matrix";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (header.byteOrder != 0x01020304)
+  {
+    std::ostringstream oss;
+    oss << "MapMatrixFile(): '" << filename << "' was saved with another byte "
+        << "order";
+    throw std::runtime_error(oss.str());
+  }
+
+  if (header.elemType != elemType)
+  {
+    std::ostringstream oss;
+    oss << "MapMatrixFile(): '" << filename << "' holds elements of type 0x"
+        << std::hex << header.elemType << ", not 0x" << elemType;
+    throw std::runtime_error(oss.str());
+  }
+
+  const std::uint64_t payload = header.rows * header.cols * (elemType & 0xff);
+  if (file->Size() - sizeof(header) < payload)
+  {
+    std::ostringstream oss;
+    oss << "MapMatrixFile(): '" << filename << "' is too short for a "
+        << header.rows << "x" << header.cols << " matrix";
+    throw std::runtime_error(oss.str());
+  }
+
+  rows = (size_t) header.rows;
+  cols = (size_t) header.cols;
+  char* memory = file->Data() + sizeof(header);
+
+  std::lock_guard<std::mutex> lock(mappingsMutex);
+  mappings.push_back(std::move(file));
+  return memory;
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,126 @@
+/**
+ * @file mapped_matrix.hpp
+ *
+ * Loading and saving of matrices in the mapped matrix format (.mmat), which
+ * data::Load() maps into memory instead of reading.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <cstdint>
+#include <cstring>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The header of a mapped matrix file.  It is followed by the elements of the
+ * matrix in column-major order, that is in the layout of an arma::Mat, so that
+ * the matrix can use the mapped file as its memory.  The header is 64 bytes
+ * long, so that the elements are aligned in the mapping.
+ */
+struct MappedMatrixHeader
+{
+  //! The magic string, "MLPACK_MMAT" padded with zeros.
+  char magic[16];
+  //! 0x01020304 in the byte order of the machine that saved the file.
+  std::uint32_t byteOrder;
+  //! The type of the elements, as given by MappedMatrixElemType().
+  std::uint32_t elemType;
+  //! The number of rows of the matrix.
+  std::uint64_t rows;
+  //! The number of columns of the matrix.
+  std::uint64_t cols;
+  //! Unused; zero.
+  std::uint64_t reserved[3];
+};
+
+static_assert(sizeof(MappedMatrixHeader) == 64,
+    "MappedMatrixHeader must be 64 bytes long.");
+
+/**
+ * Get the code of the given element type in a mapped matrix header: its size,
+ * plus 0x100 for floating-point types and 0x200 for signed types.
+ */
+template<typename eT>
+std::uint32_t MappedMatrixElemType()
+{
+  return std::uint32_t(sizeof(eT)) +
+      (std::is_floating_point<eT>::value ? 0x100 : 0) +
+      (std::is_signed<eT>::value ? 0x200 : 0);
+}
+
+/**
+ * Map the given mapped matrix file into memory, and check its header.  The
+ * mapping is copy-on-write, so that the matrix can be modified without
+ * modifying the file, and it is kept until the program exits, since the
+ * matrices that use it don't own their memory.  A std::runtime_error is thrown
+ * if the file can't be mapped, or isn't a mapped matrix of the given element
+ * type.
+ *
+ * @param filename Name of the file to map.
+ * @param elemType The expected type of the elements.
+ * @param rows Set to the number of rows of the matrix.
+ * @param cols Set to the number of columns of the matrix.
+ * @return The first element of the matrix in the mapping.
+ */
+char* MapMatrixFile(const std::string& filename,
+                    const std::uint32_t elemType,
+                    size_t& rows,
+                    size_t& cols);
+
+/**
+ * Make the given matrix use the memory of the given mapped matrix file,
+ * without copying it.  The pages of the file are read as they are accessed,
+ * and are shared by all the processes that map the file.  A std::runtime_error
+ * is thrown on errors.
+ *
+ * @param filename Name of the file to map.
+ * @param matrix Matrix to use the file as memory.
+ */
+template<typename eT>
+void LoadMappedMatrix(const std::string& filename, arma::Mat<eT>& matrix)
+{
+  size_t rows, cols;
+  eT* memory = (eT*) MapMatrixFile(filename, MappedMatrixElemType<eT>(), rows,
+      cols);
+
+  // The temporary is moved into the matrix, which takes over its (auxiliary)
+  // memory.
+  matrix = arma::Mat<eT>(memory, rows, cols, false, false);
+}
+
+/**
+ * Write the given matrix to the given stream in the mapped matrix format.
+ *
+ * @param stream Stream to write to; it should be opened in binary mode.
+ * @param matrix Matrix to write.
+ * @return Whether the matrix was written.
+ */
+template<typename eT>
+bool SaveMappedMatrix(std::ostream& stream, const arma::Mat<eT>& matrix)
+{
+  MappedMatrixHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::strncpy(header.magic, "MLPACK_MMAT", sizeof(header.magic));
+  header.byteOrder = 0x01020304;
+  header.elemType = MappedMatrixElemType<eT>();
+  header.rows = matrix.n_rows;
+  header.cols = matrix.n_cols;
+
+  stream.write((const char*) &header, sizeof(header));
+  stream.write((const char*) matrix.memptr(),
+      std::streamsize(sizeof(eT) * matrix.n_elem));
+  return stream.good();
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,283 @@
+/**
+ * @file mapping_table.hpp
+ *
+ * Definition of the MappingTable class, the open-addressing hash table that
+ * DatasetMapper uses to store the mappings of a dimension.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPING_TABLE_HPP
+#define MLPACK_CORE_DATA_MAPPING_TABLE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <cstring>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A safe version of isnan() that only gets called when the type has a NaN at
+ * all.  This is a workaround for Visual Studio, which doesn't seem to support
+ * isnan(size_t).
+ */
+template<typename T>
+inline bool isnanSafe(const T& /* t */)
+{
+  return false;
+}
+
+template<>
+inline bool isnanSafe(const double& t)
+{
+  return std::isnan(t);
+}
+
+template<>
+inline bool isnanSafe(const float& t)
+{
+  return std::isnan(t);
+}
+
+template<>
+inline bool isnanSafe(const long double& t)
+{
+  return std::isnan(t);
+}
+
+/**
+ * Hash the given bytes, eight at a time.
+ */
+inline uint64_t HashBytes(const char* data, const size_t length)
+{
+  uint64_t hash = 0xcbf29ce484222325ULL ^ length;
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8)
+  {
+    uint64_t word;
+    std::memcpy(&word, data + i, 8);
+    hash = (hash ^ word) * 0x100000001b3ULL;
+    hash ^= hash >> 29;
+  }
+
+  for (; i < length; ++i)
+    hash = (hash ^ (unsigned char) data[i]) * 0x100000001b3ULL;
+
+  return hash ^ (hash >> 32);
+}
+
+//! Hash a key of the mappings.
+template<typename KeyType>
+inline uint64_t HashKey(const KeyType& key)
+{
+  return std::hash<KeyType>()(key);
+}
+
+//! Hash a string key of the mappings, like a range of characters.
+inline uint64_t HashKey(const std::string& key)
+{
+  return HashBytes(key.data(), key.size());
+}
+
+/**
+ * A MappingTable holds the mappings of one dimension of a DatasetMapper: the
+ * distinct keys (the inputs that were mapped), and the value each of them is
+ * mapped to.  Each key is stored once, in the order of insertion, and the hash
+ * table only holds the indices of the keys, with open addressing and linear
+ * probing, so inserting a key doesn't allocate anything but the key itself.
+ *
+ * A string key can be looked up from a range of characters, without building
+ * a std::string.  The reverse mappings, from a value to the keys mapped to it,
+ * are a vector of the indices of the keys sorted by value; NaN values are
+ * sorted last, so they can be unmapped too.
+ *
+ * @tparam KeyType Type of the inputs that are mapped.
+ * @tparam ValueType Type of the values the inputs are mapped to.
+ */
+template<typename KeyType, typename ValueType>
+class MappingTable
+{
+ public:
+  //! Create an empty table.
+  MappingTable() : mask(0) { }
+
+  //! Get the number of keys in the table.
+  size_t Size() const { return keys.size(); }
+
+  //! Get the key with the given index; keys are indexed by insertion order.
+  const KeyType& Key(const size_t index) const { return keys[index]; }
+  //! Get the value of the key with the given index.
+  const ValueType& Value(const size_t index) const { return values[index]; }
+
+  /**
+   * Find the value of the given key.
+   *
+   * @param key Key to look up.
+   * @return A pointer to the value, or NULL if the key is not in the table.
+   */
+  const ValueType* Find(const KeyType& key) const
+  {
+    const size_t index = FindIndex(HashKey(key),
+        [&](const KeyType& other) { return other == key; });
+    return (index == keys.size()) ? NULL : &values[index];
+  }
+
+  /**
+   * Find the value of the string key made of the given characters.  This is
+   * only available when KeyType is std::string.
+   *
+   * @param data First character of the key.
+   * @param length Number of characters of the key.
+   * @return A pointer to the value, or NULL if the key is not in the table.
+   */
+  const ValueType* Find(const char* data, const size_t length) const
+  {
+    const size_t index = FindIndex(HashBytes(data, length),
+        [&](const KeyType& other)
+        {
+          return other.size() == length &&
+              std::memcmp(other.data(), data, length) == 0;
+        });
+    return (index == keys.size()) ? NULL : &values[index];
+  }
+
+  /**
+   * Add the given key, which must not be in the table yet, with the given
+   * value.
+   *
+   * @param key Key to add.
+   * @param value Value the key is mapped to.
+   */
+  void Insert(const KeyType& key, const ValueType& value)
+  {
+    // Keep the load of the hash table under one half.
+    if (2 * (keys.size() + 1) > slots.size())
+      Rehash(std::max(size_t(16), 2 * slots.size()));
+
+    const uint64_t hash = HashKey(key);
+    size_t slot = Slot(hash);
+    while (slots[slot] != 0)
+      slot = (slot + 1) & mask;
+    slots[slot] = keys.size() + 1;
+
+    // Values are usually inserted in increasing order, so the reverse
+    // mappings are only shifted for values that aren't.
+    size_t position = order.size();
+    if (!order.empty() && ValueLess(value, values[order.back()]))
+    {
+      position = std::upper_bound(order.begin(), order.end(), value,
+          [&](const ValueType& v, const size_t i)
+          { return ValueLess(v, values[i]); }) - order.begin();
+    }
+    order.insert(order.begin() + position, keys.size());
+
+    keys.push_back(key);
+    values.push_back(value);
+    hashes.push_back(hash);
+  }
+
+  //! Get the number of keys that are mapped to the given value.
+  size_t NumUnmappings(const ValueType& value) const
+  {
+    return UpperBound(value) - LowerBound(value);
+  }
+
+  /**
+   * Get a key that is mapped to the given value.  Keys that are mapped to the
+   * same value are ordered by insertion.
+   *
+   * @param value Value to unmap.
+   * @param unmappingIndex Index of the key among the keys of the value,
+   *     smaller than NumUnmappings(value).
+   */
+  const KeyType& Unmap(const ValueType& value,
+                       const size_t unmappingIndex) const
+  {
+    return keys[order[LowerBound(value) + unmappingIndex]];
+  }
+
+ private:
+  //! Return whether a value is ordered before another; NaN is last.
+  static bool ValueLess(const ValueType& a, const ValueType& b)
+  {
+    return !isnanSafe(a) && (isnanSafe(b) || a < b);
+  }
+
+  //! Get the position of the first key of the value in the reverse mappings.
+  size_t LowerBound(const ValueType& value) const
+  {
+    return std::lower_bound(order.begin(), order.end(), value,
+        [&](const size_t i, const ValueType& v)
+        { return ValueLess(values[i], v); }) - order.begin();
+  }
+
+  //! Get the position after the last key of the value in the reverse
+  //! mappings.
+  size_t UpperBound(const ValueType& value) const
+  {
+    return std::upper_bound(order.begin(), order.end(), value,
+        [&](const ValueType& v, const size_t i)
+        { return ValueLess(v, values[i]); }) - order.begin();
+  }
+
+  //! Get the first slot to probe for the given hash.
+  size_t Slot(const uint64_t hash) const
+  {
+    // Mix the bits of the hash, since std::hash is often the identity.
+    return size_t((hash * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+  }
+
+  /**
+   * Find the index of the key with the given hash that the given predicate
+   * accepts, or Size() if there is none.
+   */
+  template<typename EqualType>
+  size_t FindIndex(const uint64_t hash, EqualType equal) const
+  {
+    if (slots.empty())
+      return keys.size();
+
+    for (size_t slot = Slot(hash); slots[slot] != 0; slot = (slot + 1) & mask)
+    {
+      const size_t index = slots[slot] - 1;
+      if (hashes[index] == hash && equal(keys[index]))
+        return index;
+    }
+
+    return keys.size();
+  }
+
+  //! Rebuild the hash table with the given number of slots, a power of two.
+  void Rehash(const size_t numSlots)
+  {
+    slots.assign(numSlots, 0);
+    mask = numSlots - 1;
+    for (size_t i = 0; i < keys.size(); ++i)
+    {
+      size_t slot = Slot(hashes[i]);
+      while (slots[slot] != 0)
+        slot = (slot + 1) & mask;
+      slots[slot] = i + 1;
+    }
+  }
+
+  //! The keys, in the order of insertion.
+  std::vector<KeyType> keys;
+  //! The value of each key.
+  std::vector<ValueType> values;
+  //! The hash of each key.
+  std::vector<uint64_t> hashes;
+  //! The hash table: the index of a key plus one, or zero for an empty slot.
+  std::vector<size_t> slots;
+  //! The number of slots minus one.
+  size_t mask;
+  //! The indices of the keys, sorted by value and then by insertion.
+  std::vector<size_t> order;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
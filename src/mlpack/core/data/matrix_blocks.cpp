@@ -0,0 +1,66 @@
+/**
+ * @file matrix_blocks.cpp
+ *
+ * Implementation of the MatrixBlocks class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "matrix_blocks.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+namespace mlpack {
+namespace data {
+
+thread_local MatrixBlocks* MatrixBlocks::current = NULL;
+
+MatrixBlocks::MatrixBlocks() : memory(NULL), size(0)
+{
+  // Nothing to do.
+}
+
+MatrixBlocks::MatrixBlocks(char* memory, const size_t size) :
+    memory(memory),
+    size(size)
+{
+  // Nothing to do.
+}
+
+size_t MatrixBlocks::Add(const void* memory, const size_t bytes)
+{
+  const size_t offset = size;
+  blocks.push_back(std::make_pair(memory, bytes));
+  size += (bytes + alignment - 1) / alignment * alignment;
+  return offset;
+}
+
+void MatrixBlocks::Write(std::ostream& stream) const
+{
+  const char padding[alignment] = { 0 };
+  for (size_t i = 0; i < blocks.size(); ++i)
+  {
+    stream.write((const char*) blocks[i].first, blocks[i].second);
+    stream.write(padding, (alignment - blocks[i].second % alignment) %
+        alignment);
+  }
+}
+
+char* MatrixBlocks::Get(const size_t offset, const size_t bytes) const
+{
+  if (offset % alignment != 0 || offset > size || bytes > size - offset)
+  {
+    std::ostringstream oss;
+    oss << "MatrixBlocks::Get(): a block of " << bytes << " bytes at offset "
+        << offset << " is not inside the " << size << " bytes of the blocks";
+    throw std::runtime_error(oss.str());
+  }
+
+  return memory + offset;
+}
+
+} // namespace data
+} // namespace mlpack
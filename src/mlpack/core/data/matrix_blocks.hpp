@@ -0,0 +1,123 @@
+/**
+ * @file matrix_blocks.hpp
+ *
+ * Definition of the MatrixBlocks class, which stores the large matrices of a
+ * model saved in the mapped format outside of its archive.
+ *
+ * This file is included before Armadillo, so that the serialization of
+ * matrices can use it; it can't use Armadillo itself.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MATRIX_BLOCKS_HPP
+#define MLPACK_CORE_DATA_MATRIX_BLOCKS_HPP
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * In a model saved with format::mapped, the elements of each large matrix are
+ * stored in their own block after the boost::serialization archive, aligned
+ * so that they can be used in place once the file is mapped into memory; the
+ * archive only holds the offset of the block.  While such a model is saved or
+ * loaded on a thread, the MatrixBlocks object of the file is the current one
+ * of the thread, and the serialization of arma::Mat uses it.
+ */
+class MatrixBlocks
+{
+ public:
+  //! The smallest matrix, in bytes, that gets its own block; smaller matrices
+  //! stay in the archive.
+  static const size_t minBlockSize = 4096;
+
+  //! The alignment of the blocks in the file, in bytes.
+  static const size_t alignment = 64;
+
+  /**
+   * Create empty blocks, to save a model.
+   */
+  MatrixBlocks();
+
+  /**
+   * Use the blocks in the given memory, to load a model.  The memory must be
+   * aligned, and must stay valid as long as the loaded matrices use it.
+   *
+   * @param memory The blocks.
+   * @param size The size of the blocks, in bytes.
+   */
+  MatrixBlocks(char* memory, const size_t size);
+
+  /**
+   * Add a block to save.  The memory is only read by Write(), so it must stay
+   * valid until then.
+   *
+   * @param memory The memory of the block.
+   * @param bytes The size of the block.
+   * @return The offset of the block.
+   */
+  size_t Add(const void* memory, const size_t bytes);
+
+  /**
+   * Write the added blocks to the given stream, each padded to the
+   * alignment.
+   */
+  void Write(std::ostream& stream) const;
+
+  /**
+   * Get the block at the given offset, to load it.  A std::runtime_error is
+   * thrown if the block is not inside the memory.
+   *
+   * @param offset The offset of the block.
+   * @param bytes The size of the block.
+   */
+  char* Get(const size_t offset, const size_t bytes) const;
+
+  //! Get the size of the blocks, in bytes, with the padding.
+  size_t Size() const { return size; }
+
+  //! Get the blocks of the model that is saved or loaded on this thread;
+  //! NULL if there is none.
+  static MatrixBlocks* Current() { return current; }
+
+  /**
+   * Make the given blocks the current ones of this thread, as long as the
+   * scope exists.
+   */
+  class Scope
+  {
+   public:
+    //! Make the given blocks current.
+    Scope(MatrixBlocks& blocks) : previous(current) { current = &blocks; }
+    //! Restore the previous blocks.
+    ~Scope() { current = previous; }
+
+   private:
+    //! The blocks that were current before.
+    MatrixBlocks* previous;
+  };
+
+ private:
+  //! The memory and the size of each block to save.
+  std::vector<std::pair<const void*, size_t>> blocks;
+
+  //! The memory of the blocks that are loaded.
+  char* memory;
+
+  //! The size of the blocks, with the padding.
+  size_t size;
+
+  //! The current blocks of this thread.
+  static thread_local MatrixBlocks* current;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
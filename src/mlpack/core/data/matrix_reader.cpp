@@ -0,0 +1,494 @@
+/**
+ * @file matrix_reader.cpp
+ *
+ * Implementation of the MatrixReader class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "matrix_reader.hpp"
+#include "extension.hpp"
+#include "mapped_matrix.hpp"
+
+#include <cstring>
+
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/tokenizer.hpp>
+
+namespace mlpack {
+namespace data {
+
+namespace {
+
+//! Convert the given raw elements of the given type to doubles.
+template<typename eT>
+void ConvertElements(const char* raw, double* elements, const size_t count)
+{
+  for (size_t i = 0; i < count; ++i)
+  {
+    eT element;
+    std::memcpy(&element, raw + i * sizeof(eT), sizeof(eT));
+    elements[i] = double(element);
+  }
+}
+
+} // namespace
+
+MatrixReader::MatrixReader(const std::string& filename) :
+    filename(filename),
+    delimiter(' '),
+    dataLine(0),
+    line(0),
+    dimensionality(0),
+    elemType(0),
+    numPoints(0),
+    nextPoint(0),
+    done(false)
+{
+  const std::string extension = Extension(filename);
+  if (extension == "csv" || extension == "tsv" || extension == "txt")
+  {
+    format = text;
+    delimiter = (extension == "csv") ? ',' : ((extension == "tsv") ? '\t' :
+        ' ');
+  }
+  else if (extension == "arff")
+  {
+    format = arff;
+  }
+  else if (extension == "bin")
+  {
+    format = armaBinary;
+  }
+  else if (extension == "mmat")
+  {
+    format = mappedMatrix;
+  }
+  else
+  {
+    std::ostringstream oss;
+    oss << "MatrixReader::MatrixReader(): unable to detect the type of '"
+        << filename << "'; incorrect extension?";
+    throw std::runtime_error(oss.str());
+  }
+
+  stream.open(filename, std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    std::ostringstream oss;
+    oss << "MatrixReader::MatrixReader(): cannot open file '" << filename
+        << "'";
+    throw std::runtime_error(oss.str());
+  }
+
+  ReadHeader();
+  Rewind();
+}
+
+MatrixReader::~MatrixReader()
+{
+  if (prefetch.valid())
+    prefetch.wait();
+}
+
+bool MatrixReader::NextBatch(arma::mat& batch, const size_t maxCols)
+{
+  if (maxCols == 0)
+  {
+    throw std::invalid_argument("MatrixReader::NextBatch(): the batches must "
+        "have at least one point");
+  }
+
+  // Take the points of the background read; this rethrows its exception, if
+  // any.
+  if (prefetch.valid())
+  {
+    prefetch.get();
+    buffer = buffer.is_empty() ? std::move(next) :
+        arma::mat(arma::join_rows(buffer, next));
+  }
+
+  // The first batch (or a larger batch than the previous ones) is read
+  // synchronously.
+  if (buffer.n_cols < maxCols && !done)
+  {
+    ReadPoints(next, maxCols - buffer.n_cols);
+    buffer = buffer.is_empty() ? std::move(next) :
+        arma::mat(arma::join_rows(buffer, next));
+  }
+
+  const size_t cols = std::min(maxCols, size_t(buffer.n_cols));
+  if (cols == buffer.n_cols)
+  {
+    batch = std::move(buffer);
+    buffer.set_size(dimensionality, 0);
+  }
+  else
+  {
+    batch = buffer.cols(0, cols - 1);
+    buffer.shed_cols(0, cols - 1);
+  }
+
+  // Read the next batch while this one is processed.
+  if (!done)
+  {
+    prefetch = std::async(std::launch::async, [this, maxCols]()
+    {
+      ReadPoints(next, maxCols);
+    });
+  }
+
+  return cols > 0;
+}
+
+void MatrixReader::Reset()
+{
+  // The points of the background read are dropped, with its exception, if
+  // any.
+  if (prefetch.valid())
+  {
+    prefetch.wait();
+    prefetch = std::future<void>();
+  }
+
+  buffer.set_size(dimensionality, 0);
+  Rewind();
+}
+
+void MatrixReader::ReadHeader()
+{
+  if (format == text)
+  {
+    // The dimensionality is the number of tokens of the first line.
+    std::string str;
+    std::vector<std::string> tokens;
+    while (std::getline(stream, str))
+    {
+      boost::trim(str);
+      if (!str.empty())
+      {
+        Tokenize(str, tokens);
+        dimensionality = tokens.size();
+        break;
+      }
+    }
+
+    dataStart = 0;
+    dataLine = 0;
+    info = DatasetInfo(dimensionality);
+  }
+  else if (format == arff)
+  {
+    std::vector<bool> categorical;
+    std::string str;
+    bool foundData = false;
+    while (!foundData && std::getline(stream, str))
+    {
+      ++dataLine;
+      boost::trim(str);
+
+      // Skip comments and empty lines.
+      if (str.empty() || str[0] == '%')
+        continue;
+
+      typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
+      boost::escaped_list_separator<char> sep("\\", " \t%", "{\"");
+      Tokenizer tok(str, sep);
+      std::vector<std::string> tokens;
+      for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
+        if (!it->empty())
+          tokens.push_back(*it);
+
+      std::string annotation = tokens[0];
+      std::transform(annotation.begin(), annotation.end(), annotation.begin(),
+          ::tolower);
+
+      if (annotation == "@relation")
+        continue;
+
+      if (annotation == "@data")
+      {
+        foundData = true;
+      }
+      else if (annotation == "@attribute" && tokens.size() >= 3)
+      {
+        std::string type = tokens[2];
+        std::transform(type.begin(), type.end(), type.begin(), ::tolower);
+
+        if (type == "numeric" || type == "integer" || type == "real")
+        {
+          categorical.push_back(false);
+        }
+        else if (type == "string")
+        {
+          categorical.push_back(true);
+        }
+        else
+        {
+          std::ostringstream oss;
+          oss << "MatrixReader::MatrixReader(): unsupported ARFF attribute "
+              << "type '" << tokens[2] << "' in '" << filename << "'";
+          throw std::runtime_error(oss.str());
+        }
+      }
+      else
+      {
+        std::ostringstream oss;
+        oss << "MatrixReader::MatrixReader(): unknown ARFF annotation '"
+            << tokens[0] << "' in '" << filename << "'";
+        throw std::runtime_error(oss.str());
+      }
+    }
+
+    if (!foundData)
+    {
+      std::ostringstream oss;
+      oss << "MatrixReader::MatrixReader(): no @data section found in '"
+          << filename << "'";
+      throw std::runtime_error(oss.str());
+    }
+
+    dataStart = stream.tellg();
+    dimensionality = categorical.size();
+    info = DatasetInfo(dimensionality);
+    for (size_t i = 0; i < dimensionality; ++i)
+      info.Type(i) = categorical[i] ? Datatype::categorical : Datatype::numeric;
+  }
+  else if (format == armaBinary)
+  {
+    // The header is "ARMA_MAT_BIN_" followed by the element type, then the
+    // size of the stored matrix, which holds one point per row.
+    std::string header;
+    size_t rows = 0, cols = 0;
+    stream >> header >> rows >> cols;
+    stream.get();
+
+    const std::string prefix = "ARMA_MAT_BIN_";
+    const std::string code = (header.compare(0, prefix.size(), prefix) == 0 &&
+        header.size() == prefix.size() + 5) ? header.substr(prefix.size()) :
+        "";
+    const std::uint32_t size = (code.empty()) ? 0 :
+        std::uint32_t(std::atoi(code.substr(2).c_str()));
+    if (code.compare(0, 2, "FN") == 0 && (size == 4 || size == 8))
+      elemType = 0x300 + size;
+    else if (code.compare(0, 2, "IS") == 0 && size > 0 && size <= 8)
+      elemType = 0x200 + size;
+    else if (code.compare(0, 2, "IU") == 0 && size > 0 && size <= 8)
+      elemType = size;
+
+    if (!stream.good() || elemType == 0)
+    {
+      std::ostringstream oss;
+      oss << "MatrixReader::MatrixReader(): '" << filename << "' is not an "
+          << "Armadillo binary file of real numbers";
+      throw std::runtime_error(oss.str());
+    }
+
+    dataStart = stream.tellg();
+    numPoints = rows;
+    dimensionality = cols;
+    info = DatasetInfo(dimensionality);
+  }
+  else
+  {
+    MappedMatrixHeader header;
+    stream.read((char*) &header, sizeof(header));
+    if (!stream.good() ||
+        std::strncmp(header.magic, "MLPACK_MMAT", sizeof(header.magic)) != 0 ||
+        header.byteOrder != 0x01020304)
+    {
+      std::ostringstream oss;
+      oss << "MatrixReader::MatrixReader(): '" << filename << "' is not a "
+          << "mapped matrix of this byte order";
+      throw std::runtime_error(oss.str());
+    }
+
+    dataStart = sizeof(header);
+    elemType = header.elemType;
+    numPoints = (size_t) header.cols;
+    dimensionality = (size_t) header.rows;
+    info = DatasetInfo(dimensionality);
+  }
+}
+
+void MatrixReader::Rewind()
+{
+  stream.clear();
+  stream.seekg(dataStart);
+  line = dataLine;
+  nextPoint = 0;
+  done = (format == armaBinary || format == mappedMatrix) ?
+      (numPoints == 0) : (dimensionality == 0);
+}
+
+void MatrixReader::ReadPoints(arma::mat& points, const size_t maxCols)
+{
+  if (format == text || format == arff)
+    ReadTextPoints(points, maxCols);
+  else
+    ReadBinaryPoints(points, maxCols);
+}
+
+void MatrixReader::ReadTextPoints(arma::mat& points, const size_t maxCols)
+{
+  points.set_size(dimensionality, maxCols);
+
+  size_t count = 0;
+  std::string str;
+  std::vector<std::string> tokens;
+  while (count < maxCols && std::getline(stream, str))
+  {
+    ++line;
+    boost::trim(str);
+    if (str.empty() || (format == arff && str[0] == '%'))
+      continue;
+
+    if (format == arff && str[0] == '{')
+    {
+      std::ostringstream oss;
+      oss << "MatrixReader::NextBatch(): line " << line << " of '" << filename
+          << "' is sparse ARFF data, which is not supported";
+      throw std::runtime_error(oss.str());
+    }
+
+    Tokenize(str, tokens);
+    if (tokens.size() != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "MatrixReader::NextBatch(): line " << line << " of '" << filename
+          << "' has " << tokens.size() << " dimensions, but should have "
+          << dimensionality;
+      throw std::runtime_error(oss.str());
+    }
+
+    for (size_t i = 0; i < dimensionality; ++i)
+    {
+      if (info.Type(i) == Datatype::categorical)
+      {
+        points(i, count) = info.MapString<double>(tokens[i], i);
+        continue;
+      }
+
+      char* end;
+      points(i, count) = std::strtod(tokens[i].c_str(), &end);
+      if (tokens[i].empty() || *end != '\0')
+      {
+        std::ostringstream oss;
+        oss << "MatrixReader::NextBatch(): '" << tokens[i] << "' on line "
+            << line << " of '" << filename << "' is not a number";
+        throw std::runtime_error(oss.str());
+      }
+    }
+
+    ++count;
+  }
+
+  // The loop only stops early at the end of the file.
+  if (count < maxCols)
+  {
+    done = true;
+    points.resize(dimensionality, count);
+  }
+}
+
+void MatrixReader::ReadBinaryPoints(arma::mat& points, const size_t maxCols)
+{
+  const size_t cols = std::min(maxCols, numPoints - nextPoint);
+  const size_t elemSize = elemType & 0xff;
+  points.set_size(dimensionality, cols);
+
+  if (format == mappedMatrix)
+  {
+    // The points are the columns of the stored matrix.
+    stream.seekg(dataStart + std::streamoff(nextPoint * dimensionality *
+        elemSize));
+    ReadElements(points.memptr(), points.n_elem);
+  }
+  else
+  {
+    // The points are the rows of the stored matrix, so each dimension of the
+    // batch is contiguous.
+    arma::rowvec dimension(cols);
+    for (size_t i = 0; i < dimensionality; ++i)
+    {
+      stream.seekg(dataStart + std::streamoff((i * numPoints + nextPoint)
+          * elemSize));
+      ReadElements(dimension.memptr(), cols);
+      points.row(i) = dimension;
+    }
+  }
+
+  nextPoint += cols;
+  done = (nextPoint == numPoints);
+}
+
+void MatrixReader::ReadElements(double* elements, const size_t count)
+{
+  const size_t elemSize = elemType & 0xff;
+  std::vector<char> raw(count * elemSize);
+  stream.read(raw.data(), std::streamsize(raw.size()));
+  if (!stream.good())
+  {
+    std::ostringstream oss;
+    oss << "MatrixReader::NextBatch(): '" << filename << "' is too short";
+    throw std::runtime_error(oss.str());
+  }
+
+  switch (elemType)
+  {
+    case 0x304: ConvertElements<float>(raw.data(), elements, count); break;
+    case 0x308: ConvertElements<double>(raw.data(), elements, count); break;
+    case 0x201: ConvertElements<int8_t>(raw.data(), elements, count); break;
+    case 0x202: ConvertElements<int16_t>(raw.data(), elements, count); break;
+    case 0x204: ConvertElements<int32_t>(raw.data(), elements, count); break;
+    case 0x208: ConvertElements<int64_t>(raw.data(), elements, count); break;
+    case 0x001: ConvertElements<uint8_t>(raw.data(), elements, count); break;
+    case 0x002: ConvertElements<uint16_t>(raw.data(), elements, count); break;
+    case 0x004: ConvertElements<uint32_t>(raw.data(), elements, count); break;
+    case 0x008: ConvertElements<uint64_t>(raw.data(), elements, count); break;
+    default:
+    {
+      std::ostringstream oss;
+      oss << "MatrixReader::NextBatch(): '" << filename << "' holds elements "
+          << "of unsupported type 0x" << std::hex << elemType;
+      throw std::runtime_error(oss.str());
+    }
+  }
+}
+
+void MatrixReader::Tokenize(const std::string& str,
+                            std::vector<std::string>& tokens)
+{
+  tokens.clear();
+  if (format == arff)
+  {
+    typedef boost::tokenizer<boost::escaped_list_separator<char>> Tokenizer;
+    boost::escaped_list_separator<char> sep("\\", ",", "\"");
+    Tokenizer tok(str, sep);
+    for (Tokenizer::iterator it = tok.begin(); it != tok.end(); ++it)
+      tokens.push_back(boost::trim_copy(*it));
+  }
+  else if (delimiter == ' ')
+  {
+    std::istringstream tokenStream(str);
+    std::string token;
+    while (tokenStream >> token)
+      tokens.push_back(token);
+  }
+  else
+  {
+    std::istringstream tokenStream(str);
+    std::string token;
+    while (std::getline(tokenStream, token, delimiter))
+      tokens.push_back(boost::trim_copy(token));
+
+    // A trailing separator ends with an empty token.
+    if (!str.empty() && str.back() == delimiter)
+      tokens.push_back("");
+  }
+}
+
+} // namespace data
+} // namespace mlpack
@@ -0,0 +1,178 @@
+/**
+ * @file matrix_reader.hpp
+ *
+ * Definition of the MatrixReader class, which reads a dataset from a file in
+ * batches of points, for algorithms that process data that doesn't fit in
+ * memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MATRIX_READER_HPP
+#define MLPACK_CORE_DATA_MATRIX_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <cstdint>
+#include <fstream>
+#include <future>
+
+#include "dataset_mapper.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The MatrixReader class reads a dataset one batch of points at a time, so
+ * that only a batch has to be in memory.  The points are the columns of the
+ * batches, as they would be the columns of the matrix given by data::Load()
+ * with its default parameters.  While a batch is processed, the next one is
+ * read by a background thread.
+ *
+ * @code
+ * data::MatrixReader reader("dataset.csv");
+ * arma::mat batch;
+ * while (reader.NextBatch(batch, 10000))
+ * {
+ *   // Process the batch...
+ * }
+ * @endcode
+ *
+ * The supported formats are:
+ *
+ *  - numeric CSV, denoted by .csv, with one point per line;
+ *  - numeric TSV and whitespace-separated text, denoted by .tsv and .txt;
+ *  - ARFF, denoted by .arff; the string attributes are mapped with Info(), as
+ *    they would be by data::Load();
+ *  - Armadillo binary (arma_binary), denoted by .bin, with one point per row
+ *    of the stored matrix, as data::Save() writes it;
+ *  - mlpack's mapped matrix format, denoted by .mmat, with one point per
+ *    column of the stored matrix.
+ *
+ * A std::runtime_error is thrown if the file can't be read, either by the
+ * constructor or by the NextBatch() call that would return the bad points.
+ */
+class MatrixReader
+{
+ public:
+  /**
+   * Open the given file, and read its header (or its first line, for text
+   * formats) to find the dimensionality of the points.
+   *
+   * @param filename Name of the file to read.
+   */
+  MatrixReader(const std::string& filename);
+
+  //! Wait for the background read, if any.
+  ~MatrixReader();
+
+  /**
+   * Get the next batch of points.  The batch has at most the given number of
+   * points; it is empty once all points have been read.
+   *
+   * @param batch Matrix to store the points in.
+   * @param maxCols Largest number of points in the batch.
+   * @return Whether the batch has points.
+   */
+  bool NextBatch(arma::mat& batch, const size_t maxCols);
+
+  /**
+   * Start reading the points again from the first one, for instance for
+   * another pass over the dataset.  The mappings of Info() are kept.
+   */
+  void Reset();
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return dimensionality; }
+
+  /**
+   * Get the types and mappings of the dimensions; they are all numeric, except
+   * for the string attributes of ARFF files.  The mappings are extended as the
+   * points are read, also by the background thread, so they should only be
+   * used once all the points have been read.
+   */
+  const DatasetInfo& Info() const { return info; }
+
+ private:
+  //! The formats of the files that can be read.
+  enum FileFormat
+  {
+    text,
+    arff,
+    armaBinary,
+    mappedMatrix
+  };
+
+  // A reader can't be copied.
+  MatrixReader(const MatrixReader&);
+  MatrixReader& operator=(const MatrixReader&);
+
+  //! Read the header of the file.
+  void ReadHeader();
+
+  //! Go to the first point.
+  void Rewind();
+
+  /**
+   * Read the next points of the file, synchronously.
+   *
+   * @param points Matrix to store the points in.
+   * @param maxCols Largest number of points to read.
+   */
+  void ReadPoints(arma::mat& points, const size_t maxCols);
+
+  //! Read the next points of a text or ARFF file.
+  void ReadTextPoints(arma::mat& points, const size_t maxCols);
+
+  //! Read the next points of a binary file.
+  void ReadBinaryPoints(arma::mat& points, const size_t maxCols);
+
+  //! Read the given number of elements of the stored type from the file.
+  void ReadElements(double* elements, const size_t count);
+
+  //! Split the given line into its tokens.
+  void Tokenize(const std::string& line, std::vector<std::string>& tokens);
+
+  //! Name of the file.
+  std::string filename;
+  //! Format of the file.
+  FileFormat format;
+  //! The separator of the tokens of a text file; ' ' means any whitespace.
+  char delimiter;
+  //! The opened file.
+  std::ifstream stream;
+  //! Position of the first point in the file.
+  std::streampos dataStart;
+  //! Number of the line of the first point in the file.
+  size_t dataLine;
+  //! Number of the last line that was read, for error messages.
+  size_t line;
+
+  //! The dimensionality of the points.
+  size_t dimensionality;
+  //! The types and mappings of the dimensions.
+  DatasetInfo info;
+
+  //! The type of the stored elements of a binary file, as given by
+  //! MappedMatrixElemType().
+  std::uint32_t elemType;
+  //! The number of points of a binary file.
+  size_t numPoints;
+  //! The index of the next point to read from a binary file.
+  size_t nextPoint;
+
+  //! The points that were read but not returned yet.
+  arma::mat buffer;
+  //! The points read by the background thread.
+  arma::mat next;
+  //! The background read of the next points.
+  std::future<void> prefetch;
+  //! Whether all points were read from the file.
+  bool done;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,199 @@
+/**
+ * @file quantile_sketch.hpp
+ *
+ * Definition of the QuantileSketch class, which estimates the quantiles of a
+ * stream of values in bounded memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_QUANTILE_SKETCH_HPP
+#define MLPACK_CORE_DATA_QUANTILE_SKETCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * A QuantileSketch holds a small summary of a stream of values, from which
+ * any quantile of the values can be estimated.  This is the KLL sketch: the
+ * values are kept in levels, and a value of level h stands for 2^h values of
+ * the stream.  When a level is full, it is sorted and every other value moves
+ * to the next level; the capacities of the levels shrink by a factor of 2/3
+ * from the top one, which holds k values, so the sketch keeps O(k) values no
+ * matter how many are added.  The rank of an estimated quantile is off by
+ * about n / k values for n added values.  Sketches built on different parts of
+ * the data can be merged.
+ *
+ * @code
+ * @inproceedings{karnin2016optimal,
+ *   title     = {Optimal Quantile Approximation in Streams},
+ *   author    = {Karnin, Zohar and Lang, Kevin and Liberty, Edo},
+ *   booktitle = {Proceedings of the 57th Annual Symposium on Foundations of
+ *                Computer Science (FOCS '16)},
+ *   pages     = {71--78},
+ *   year      = {2016}
+ * }
+ * @endcode
+ *
+ * Instead of a random one, each compaction keeps the values at the other
+ * parity than the previous one, so the sketch is deterministic.
+ */
+class QuantileSketch
+{
+ public:
+  /**
+   * Create an empty sketch.
+   *
+   * @param k The capacity of the top level, which sets the accuracy.
+   */
+  QuantileSketch(const size_t k = 200) :
+      k(std::max(k, size_t(2))),
+      count(0),
+      parity(0),
+      levels(1)
+  { /* Nothing to do. */ }
+
+  /**
+   * Add a value to the sketch.
+   *
+   * @param value Value to add.
+   */
+  void Add(const double value)
+  {
+    levels[0].push_back(value);
+    ++count;
+    if (levels[0].size() >= Capacity(0))
+      Compress();
+  }
+
+  /**
+   * Merge the values of another sketch into this one.
+   *
+   * @param other Sketch to merge.
+   */
+  void Merge(const QuantileSketch& other)
+  {
+    if (other.levels.size() > levels.size())
+      levels.resize(other.levels.size());
+    for (size_t h = 0; h < other.levels.size(); ++h)
+    {
+      levels[h].insert(levels[h].end(), other.levels[h].begin(),
+          other.levels[h].end());
+    }
+    count += other.count;
+    Compress();
+  }
+
+  /**
+   * Estimate the given quantile of the values, that is the smallest value
+   * whose rank is at least q times the number of values.  NaN is returned if
+   * the sketch is empty.
+   *
+   * @param q The quantile to estimate, between 0 and 1; 0.5 is the median.
+   */
+  double Quantile(const double q) const
+  {
+    if (q < 0.0 || q > 1.0)
+    {
+      std::ostringstream oss;
+      oss << "QuantileSketch::Quantile(): quantile " << q << " is not between "
+          << "0 and 1!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (count == 0)
+      return std::numeric_limits<double>::quiet_NaN();
+
+    std::vector<std::pair<double, size_t>> values;
+    for (size_t h = 0; h < levels.size(); ++h)
+      for (size_t i = 0; i < levels[h].size(); ++i)
+        values.push_back(std::make_pair(levels[h][i], size_t(1) << h));
+    std::sort(values.begin(), values.end());
+
+    const double target = q * count;
+    size_t rank = 0;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+      rank += values[i].second;
+      if (rank >= target)
+        return values[i].first;
+    }
+
+    return values.back().first;
+  }
+
+  //! Get the number of values added to the sketch.
+  size_t Count() const { return count; }
+  //! Get the capacity of the top level.
+  size_t K() const { return k; }
+
+  //! Get the number of values kept by the sketch.
+  size_t Size() const
+  {
+    size_t size = 0;
+    for (size_t h = 0; h < levels.size(); ++h)
+      size += levels[h].size();
+    return size;
+  }
+
+  /**
+   * Serialize the sketch, so that a pass over the data can be resumed.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(k);
+    ar & BOOST_SERIALIZATION_NVP(count);
+    ar & BOOST_SERIALIZATION_NVP(parity);
+    ar & BOOST_SERIALIZATION_NVP(levels);
+  }
+
+ private:
+  //! Get the capacity of the given level.
+  size_t Capacity(const size_t level) const
+  {
+    const size_t depth = levels.size() - 1 - level;
+    return std::max(size_t(2),
+        (size_t) std::ceil(k * std::pow(2.0 / 3.0, (double) depth)));
+  }
+
+  //! Compact the full levels, from the bottom one.
+  void Compress()
+  {
+    for (size_t h = 0; h < levels.size(); ++h)
+    {
+      if (levels[h].size() < Capacity(h))
+        continue;
+
+      if (h + 1 == levels.size())
+        levels.resize(levels.size() + 1);
+
+      // If the level has an odd number of values, the smallest one stays.
+      std::vector<double>& level = levels[h];
+      std::sort(level.begin(), level.end());
+      const size_t kept = level.size() % 2;
+      for (size_t i = kept + parity; i < level.size(); i += 2)
+        levels[h + 1].push_back(level[i]);
+      level.resize(kept);
+      parity = 1 - parity;
+    }
+  }
+
+  //! The capacity of the top level.
+  size_t k;
+  //! The number of values added to the sketch.
+  size_t count;
+  //! The parity of the values kept by the next compaction.
+  size_t parity;
+  //! The values of each level.
+  std::vector<std::vector<double>> levels;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
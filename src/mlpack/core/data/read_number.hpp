@@ -0,0 +1,124 @@
+/**
+ * @file read_number.hpp
+ *
+ * Fast conversion of the tokens of a text file that are plain decimal numbers,
+ * shared by the parallel CSV and ARFF parsers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_READ_NUMBER_HPP
+#define MLPACK_CORE_DATA_READ_NUMBER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace mlpack {
+namespace data {
+
+//! Convert a null-terminated number with the C library.
+inline void ToNumber(const char* str, float& value)
+{
+  value = std::strtof(str, NULL);
+}
+
+//! Convert a null-terminated number with the C library.
+inline void ToNumber(const char* str, double& value)
+{
+  value = std::strtod(str, NULL);
+}
+
+//! Convert a null-terminated number with the C library.
+inline void ToNumber(const char* str, long double& value)
+{
+  value = std::strtold(str, NULL);
+}
+
+//! Non-floating-point matrices never read numbers directly.
+template<typename T>
+inline void ToNumber(const char* str, T& value)
+{
+  value = T(std::strtod(str, NULL));
+}
+
+/**
+ * Read the given token as a number, if it is a plain decimal number, that a
+ * stringstream would extract to the same value.  Anything else (including
+ * numbers that overflow) is left to the caller.
+ *
+ * @param begin The first character of the token.
+ * @param end One past the last character of the token.
+ * @param value Set to the number, if the token is one.
+ * @return Whether the token was read as a number.
+ */
+template<typename T>
+bool ReadNumber(const char* begin, const char* end, T& value)
+{
+  // Longer tokens are rare enough to be left to the caller.
+  const size_t length = end - begin;
+  char buffer[64];
+  if (length == 0 || length >= sizeof(buffer))
+    return false;
+
+  // Only accept [+-](digits[.digits]|.digits)[(e|E)[+-]digits].
+  const char* current = begin;
+  if (*current == '+' || *current == '-')
+    ++current;
+
+  size_t digits = 0;
+  while (current < end && std::isdigit((unsigned char) *current))
+  {
+    ++current;
+    ++digits;
+  }
+
+  if (current < end && *current == '.')
+  {
+    ++current;
+    while (current < end && std::isdigit((unsigned char) *current))
+    {
+      ++current;
+      ++digits;
+    }
+  }
+
+  if (digits == 0)
+    return false;
+
+  if (current < end && (*current == 'e' || *current == 'E'))
+  {
+    ++current;
+    if (current < end && (*current == '+' || *current == '-'))
+      ++current;
+
+    const char* exponent = current;
+    while (current < end && std::isdigit((unsigned char) *current))
+      ++current;
+
+    if (current == exponent)
+      return false;
+  }
+
+  if (current != end)
+    return false;
+
+  std::memcpy(buffer, begin, length);
+  buffer[length] = '\0';
+
+  // A number that overflows (or underflows) is left to the caller, as the
+  // extraction from a stringstream may fail on it.
+  errno = 0;
+  ToNumber(buffer, value);
+  return errno != ERANGE;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
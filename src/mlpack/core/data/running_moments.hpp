@@ -0,0 +1,223 @@
+/**
+ * @file running_moments.hpp
+ *
+ * Definition of the RunningMoments class, which computes the mean, variance,
+ * skewness and kurtosis of a stream of values in one pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_RUNNING_MOMENTS_HPP
+#define MLPACK_CORE_DATA_RUNNING_MOMENTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * RunningMoments keeps the number of values seen so far, their minimum,
+ * maximum and mean, and the sums of the second, third and fourth powers of
+ * their deviations from the mean.  Values are added one at a time with the
+ * numerically stable updates of Welford, and two sets of moments computed on
+ * different parts of the data (for instance by different threads) are merged
+ * with the pairwise formulas of Chan et al., extended to the third and fourth
+ * moments by Pebay:
+ *
+ * @code
+ * @techreport{pebay2008formulas,
+ *   title       = {Formulas for Robust, One-Pass Parallel Computation of
+ *                  Covariances and Arbitrary-Order Statistical Moments},
+ *   author      = {Pebay, Philippe},
+ *   institution = {Sandia National Laboratories},
+ *   number      = {SAND2008-6212},
+ *   year        = {2008}
+ * }
+ * @endcode
+ *
+ * The statistics are the same as the ones computed from all of the values at
+ * once, up to rounding.
+ */
+class RunningMoments
+{
+ public:
+  //! Create empty moments.
+  RunningMoments() :
+      count(0),
+      mean(0.0),
+      m2(0.0),
+      m3(0.0),
+      m4(0.0),
+      min(std::numeric_limits<double>::infinity()),
+      max(-std::numeric_limits<double>::infinity())
+  { /* Nothing to do. */ }
+
+  /**
+   * Add a value to the moments.
+   *
+   * @param value Value to add.
+   */
+  void Add(const double value)
+  {
+    const double n1 = (double) count;
+    ++count;
+    const double n = (double) count;
+    const double delta = value - mean;
+    const double deltaN = delta / n;
+    const double deltaN2 = deltaN * deltaN;
+    const double term = delta * deltaN * n1;
+
+    mean += deltaN;
+    m4 += term * deltaN2 * (n * n - 3 * n + 3) + 6 * deltaN2 * m2 -
+        4 * deltaN * m3;
+    m3 += term * deltaN * (n - 2) - 3 * deltaN * m2;
+    m2 += term;
+
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+
+  /**
+   * Merge the moments of other values into these ones.
+   *
+   * @param other Moments to merge.
+   */
+  void Merge(const RunningMoments& other)
+  {
+    if (other.count == 0)
+      return;
+    if (count == 0)
+    {
+      *this = other;
+      return;
+    }
+
+    const double na = (double) count;
+    const double nb = (double) other.count;
+    const double n = na + nb;
+    const double delta = other.mean - mean;
+    const double delta2 = delta * delta;
+
+    const double newM4 = m4 + other.m4 +
+        delta2 * delta2 * na * nb * (na * na - na * nb + nb * nb) /
+        (n * n * n) +
+        6 * delta2 * (na * na * other.m2 + nb * nb * m2) / (n * n) +
+        4 * delta * (na * other.m3 - nb * m3) / n;
+    const double newM3 = m3 + other.m3 +
+        delta2 * delta * na * nb * (na - nb) / (n * n) +
+        3 * delta * (na * other.m2 - nb * m2) / n;
+    m2 += other.m2 + delta2 * na * nb / n;
+    m3 = newM3;
+    m4 = newM4;
+    mean += delta * nb / n;
+    count += other.count;
+
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+  }
+
+  //! Get the number of values.
+  size_t Count() const { return count; }
+  //! Get the mean of the values.
+  double Mean() const { return mean; }
+  //! Get the smallest value.
+  double Min() const { return min; }
+  //! Get the largest value.
+  double Max() const { return max; }
+
+  /**
+   * Get the variance of the values; it is zero if there is only one value.
+   *
+   * @param population If true, the values are the whole population;
+   *     otherwise they are a sample of it.
+   */
+  double Variance(const bool population = false) const
+  {
+    if (count < 2)
+      return 0.0;
+    return m2 / (population ? count : count - 1);
+  }
+
+  /**
+   * Get the standard deviation of the values.
+   *
+   * @param population If true, the values are the whole population;
+   *     otherwise they are a sample of it.
+   */
+  double Stddev(const bool population = false) const
+  {
+    return std::sqrt(Variance(population));
+  }
+
+  /**
+   * Get the skewness of the values.
+   *
+   * @param population If true, the values are the whole population;
+   *     otherwise they are a sample of it.
+   */
+  double Skewness(const bool population = false) const
+  {
+    const double n = (double) count;
+    const double s3 = std::pow(Stddev(population), 3);
+    if (population)
+      return m3 / (n * s3);
+    else
+      return n * m3 / ((n - 1) * (n - 2) * s3);
+  }
+
+  /**
+   * Get the excess kurtosis of the values.
+   *
+   * @param population If true, the values are the whole population;
+   *     otherwise they are a sample of it.
+   */
+  double Kurtosis(const bool population = false) const
+  {
+    const double n = (double) count;
+    if (population)
+      return n * m4 / (m2 * m2) - 3;
+
+    const double s4 = std::pow(Stddev(population), 4);
+    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
+    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
+    return normC * m4 / s4 - norm3;
+  }
+
+  /**
+   * Serialize the moments, so that a pass over the data can be resumed.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(count);
+    ar & BOOST_SERIALIZATION_NVP(mean);
+    ar & BOOST_SERIALIZATION_NVP(m2);
+    ar & BOOST_SERIALIZATION_NVP(m3);
+    ar & BOOST_SERIALIZATION_NVP(m4);
+    ar & BOOST_SERIALIZATION_NVP(min);
+    ar & BOOST_SERIALIZATION_NVP(max);
+  }
+
+ private:
+  //! The number of values.
+  size_t count;
+  //! The mean of the values.
+  double mean;
+  //! The sum of the squared deviations from the mean.
+  double m2;
+  //! The sum of the cubed deviations from the mean.
+  double m3;
+  //! The sum of the fourth powers of the deviations from the mean.
+  double m4;
+  //! The smallest value.
+  double min;
+  //! The largest value.
+  double max;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -39,6 +39,10 @@ namespace data /** Functions to load and save matrices. */ {
  *  - Armadillo binary (arma_binary), denoted by .bin
  *  - HDF5 (hdf5_binary), denoted by .hdf5, .hdf, .h5, or .he5
  *
+ * mlpack's mapped matrix format, denoted by .mmat, is also supported; the
+ * matrix is saved as it is in memory, so that data::Load() can map it into
+ * memory without copying it.  It is never transposed.
+ *
  * If the file extension is not one of those types, an error will be given.  If
  * the 'fatal' parameter is set to true, a std::runtime_error exception will be
  * thrown upon failure.  If the 'transpose' parameter is set to true, the matrix
@@ -70,8 +74,16 @@ bool Save(const std::string& filename,
  *  - xml, denoted by .xml
  *  - binary, denoted by .bin
  *
+ * A model can also be saved in mlpack's mapped format, denoted by .mbin: the
+ * matrices of at least MatrixBlocks::minBlockSize bytes are stored as aligned
+ * raw blocks after a binary archive of the rest of the model, and once the
+ * file is mapped into memory they are used in place, so loading a large model
+ * costs little more than reading its pages.  The mappings of loaded files
+ * live until the program exits.
+ *
  * The format parameter can take any of the values in the 'format' enum:
- * 'format::autodetect', 'format::text', 'format::xml', and 'format::binary'.
+ * 'format::autodetect', 'format::text', 'format::xml', 'format::binary', and
+ * 'format::mapped'.
  * The autodetect functionality operates on the file extension (so, "file.txt"
  * would be autodetected as text).
  *
@@ -15,6 +15,8 @@
 // In case it hasn't already been included.
 #include "save.hpp"
 #include "extension.hpp"
+#include "mapped_archive.hpp"
+#include "mapped_matrix.hpp"
 
 #include <boost/serialization/serialization.hpp>
 #include <boost/archive/xml_oarchive.hpp>
@@ -84,6 +86,27 @@ bool Save(const std::string& filename,
     return false;
   }
 
+  // A mapped matrix is saved as it is in memory, so that data::Load() can map
+  // it without copying; it is never transposed.
+  if (extension == "mmat")
+  {
+    Log::Info << "Saving mapped matrix data to '" << filename << "'."
+        << std::endl;
+    if (!SaveMappedMatrix(stream, matrix))
+    {
+      Timer::Stop("saving_data");
+      if (fatal)
+        Log::Fatal << "Save to '" << filename << "' failed." << std::endl;
+      else
+        Log::Warn << "Save to '" << filename << "' failed." << std::endl;
+
+      return false;
+    }
+
+    Timer::Stop("saving_data");
+    return true;
+  }
+
   bool unknownType = false;
   arma::file_type saveType;
   std::string stringType;
@@ -215,14 +238,16 @@ bool Save(const std::string& filename,
       f = format::binary;
     else if (extension == "txt")
       f = format::text;
+    else if (extension == "mbin")
+      f = format::mapped;
     else
     {
       if (fatal)
         Log::Fatal << "Unable to detect type of '" << filename << "'; incorrect"
-            << " extension? (allowed: xml/bin/txt)" << std::endl;
+            << " extension? (allowed: xml/bin/txt/mbin)" << std::endl;
       else
         Log::Warn << "Unable to detect type of '" << filename << "'; save "
-            << "failed.  Incorrect extension? (allowed: xml/bin/txt)"
+            << "failed.  Incorrect extension? (allowed: xml/bin/txt/mbin)"
             << std::endl;
 
       return false;
@@ -232,7 +257,8 @@ bool Save(const std::string& filename,
   // Open the file to save to.
   std::ofstream ofs;
 #ifdef _WIN32
-  if (f == format::binary) // Open non-text types in binary mode on Windows.
+  // Open non-text types in binary mode on Windows.
+  if (f == format::binary || f == format::mapped)
     ofs.open(filename, std::ofstream::out | std::ofstream::binary);
   else
     ofs.open(filename, std::ofstream::out);
@@ -269,6 +295,10 @@ bool Save(const std::string& filename,
       boost::archive::binary_oarchive ar(ofs);
       ar << boost::serialization::make_nvp(name.c_str(), t);
     }
+    else if (f == format::mapped)
+    {
+      SaveMappedArchive(ofs, name, t);
+    }
 
     return true;
   }
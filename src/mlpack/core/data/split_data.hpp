@@ -192,6 +192,132 @@ Split(const arma::Mat<T>& input,
                          std::move(testData));
 }
 
+/**
+ * Reorder the columns of the given matrix in place, so that its ith column is
+ * the column order[i] of the original matrix.  The permutation is applied
+ * cycle by cycle, so that only one column is copied aside at a time.
+ *
+ * @param m Matrix to reorder.
+ * @param order The new order of the columns; a permutation of 0 to n_cols - 1.
+ */
+template<typename T>
+void PermuteColumns(arma::Mat<T>& m, const arma::Col<size_t>& order)
+{
+  std::vector<bool> done(m.n_cols, false);
+  arma::Col<T> first(m.n_rows);
+  for (size_t start = 0; start < m.n_cols; ++start)
+  {
+    if (done[start] || order[start] == start)
+      continue;
+
+    std::copy(m.colptr(start), m.colptr(start) + m.n_rows, first.memptr());
+    size_t i = start;
+    while (order[i] != start)
+    {
+      std::copy(m.colptr(order[i]), m.colptr(order[i]) + m.n_rows,
+          m.colptr(i));
+      done[i] = true;
+      i = order[i];
+    }
+    std::copy(first.memptr(), first.memptr() + m.n_rows, m.colptr(i));
+    done[i] = true;
+  }
+}
+
+/**
+ * Given an input dataset and labels, shuffle them in place and split them into
+ * a training set and a test set, without copying any point.  The points of the
+ * training set are the first columns of the shuffled input, and the points of
+ * the test set are the last ones; the four output parameters are set to
+ * aliases of these columns, so they are only valid as long as the input and
+ * the labels are not modified.  With the same random seed, the split is the
+ * same as the one of Split().
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::Row<size_t> label = loadLabel();
+ * arma::mat trainData, testData;
+ * arma::Row<size_t> trainLabel, testLabel;
+ *
+ * // Hold out 30% of the data for the test set, without using any more memory.
+ * SplitInPlace(input, label, trainData, testData, trainLabel, testLabel, 0.3);
+ * @endcode
+ *
+ * @param input Input dataset to shuffle and split.
+ * @param inputLabel Input labels to shuffle and split.
+ * @param trainData Matrix to set to the training data.
+ * @param testData Matrix to set to the test data.
+ * @param trainLabel Vector to set to the training labels.
+ * @param testLabel Vector to set to the test labels.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ */
+template<typename T, typename U>
+void SplitInPlace(arma::Mat<T>& input,
+                  arma::Row<U>& inputLabel,
+                  arma::Mat<T>& trainData,
+                  arma::Mat<T>& testData,
+                  arma::Row<U>& trainLabel,
+                  arma::Row<U>& testLabel,
+                  const double testRatio)
+{
+  const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
+  const size_t trainSize = input.n_cols - testSize;
+
+  const arma::Col<size_t> order =
+      arma::shuffle(arma::linspace<arma::Col<size_t>>(0, input.n_cols - 1,
+                                                      input.n_cols));
+  PermuteColumns(input, order);
+  PermuteColumns(inputLabel, order);
+
+  trainData = arma::Mat<T>(input.memptr(), input.n_rows, trainSize, false,
+      false);
+  testData = arma::Mat<T>(input.colptr(trainSize), input.n_rows, testSize,
+      false, false);
+  trainLabel = arma::Row<U>(inputLabel.memptr(), trainSize, false, false);
+  testLabel = arma::Row<U>(inputLabel.memptr() + trainSize, testSize, false,
+      false);
+}
+
+/**
+ * Given an input dataset, shuffle it in place and split it into a training set
+ * and a test set, without copying any point.  The two output parameters are
+ * set to aliases of the first and the last columns of the shuffled input, so
+ * they are only valid as long as the input is not modified.  With the same
+ * random seed, the split is the same as the one of Split().
+ *
+ * @code
+ * arma::mat input = loadData();
+ * arma::mat trainData, testData;
+ *
+ * // Hold out 30% of the data for the test set, without using any more memory.
+ * SplitInPlace(input, trainData, testData, 0.3);
+ * @endcode
+ *
+ * @param input Input dataset to shuffle and split.
+ * @param trainData Matrix to set to the training data.
+ * @param testData Matrix to set to the test data.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ */
+template<typename T>
+void SplitInPlace(arma::Mat<T>& input,
+                  arma::Mat<T>& trainData,
+                  arma::Mat<T>& testData,
+                  const double testRatio)
+{
+  const size_t testSize = static_cast<size_t>(input.n_cols * testRatio);
+  const size_t trainSize = input.n_cols - testSize;
+
+  const arma::Col<size_t> order =
+      arma::shuffle(arma::linspace<arma::Col<size_t>>(0, input.n_cols - 1,
+                                                      input.n_cols));
+  PermuteColumns(input, order);
+
+  trainData = arma::Mat<T>(input.memptr(), input.n_rows, trainSize, false,
+      false);
+  testData = arma::Mat<T>(input.colptr(trainSize), input.n_rows, testSize,
+      false, false);
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -50,6 +50,63 @@ arma::vec DiscreteDistribution::Random() const
   return result;
 }
 
+/**
+ * Calculate the probability of each observation, one dimension at a time.
+ */
+void DiscreteDistribution::Probability(const arma::mat& x,
+                                       arma::vec& probabilities) const
+{
+  probabilities.ones(x.n_cols);
+  for (size_t d = 0; d < this->probabilities.size(); ++d)
+    probabilities %= this->probabilities[d].elem(ObservationIndices(x, d));
+}
+
+/**
+ * Calculate the log probability of each observation, one dimension at a time.
+ */
+void DiscreteDistribution::LogProbability(const arma::mat& x,
+                                          arma::vec& logProbabilities) const
+{
+  logProbabilities.zeros(x.n_cols);
+  for (size_t d = 0; d < probabilities.size(); ++d)
+  {
+    const arma::vec logProbs = arma::log(probabilities[d]);
+    logProbabilities += logProbs.elem(ObservationIndices(x, d));
+  }
+}
+
+arma::uvec DiscreteDistribution::ObservationIndices(const arma::mat& x,
+                                                    const size_t dimension)
+    const
+{
+  // Ensure the observations have the same dimension as the probabilities.
+  if (x.n_rows != probabilities.size())
+  {
+    Log::Fatal << "DiscreteDistribution::Probability(): observation has "
+        << "incorrect dimension " << x.n_rows << " but should have"
+        << " dimension " << probabilities.size() << "!" << std::endl;
+  }
+
+  // Adding 0.5 helps ensure that we cast the floating point to a size_t
+  // correctly.
+  arma::uvec indices(x.n_cols);
+  for (size_t i = 0; i < x.n_cols; ++i)
+  {
+    indices[i] = size_t(x(dimension, i) + 0.5);
+
+    // Ensure that the observation is within the bounds.
+    if (indices[i] >= probabilities[dimension].n_elem)
+    {
+      Log::Fatal << "DiscreteDistribution::Probability(): received "
+          << "observation " << indices[i] << "; observation must be in [0, "
+          << probabilities[dimension].n_elem << "] for this distribution."
+          << std::endl;
+    }
+  }
+
+  return indices;
+}
+
 /**
  * Estimate the probability distribution directly from the given observations.
  */
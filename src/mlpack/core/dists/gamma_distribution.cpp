@@ -74,21 +74,12 @@ void GammaDistribution::Train(const arma::mat& rdata,
   if (arma::size(rdata) == arma::size(arma::mat()))
     return;
 
-  arma::vec meanLogxVec(rdata.n_rows, arma::fill::zeros);
-  arma::vec meanxVec(rdata.n_rows, arma::fill::zeros);
-  arma::vec logMeanxVec(rdata.n_rows, arma::fill::zeros);
-
-  for (size_t i = 0; i < rdata.n_cols; i++)
-  {
-    meanLogxVec += probabilities(i) * arma::log(rdata.col(i));
-    meanxVec += probabilities(i) * rdata.col(i);
-  }
-
-  double totProbability = arma::accu(probabilities);
-
-  meanLogxVec /= totProbability;
-  meanxVec /= totProbability;
-  logMeanxVec = arma::log(meanxVec);
+  // Compute the weighted statistics of all observations at once.
+  const double totProbability = arma::accu(probabilities);
+  const arma::vec meanLogxVec = (arma::log(rdata) * probabilities) /
+      totProbability;
+  const arma::vec meanxVec = (rdata * probabilities) / totProbability;
+  const arma::vec logMeanxVec = arma::log(meanxVec);
 
   // Call the statistics-only GammaDistribution::Train() function to fit the
   // parameters. That function does all the work so we're done.
@@ -118,8 +109,11 @@ void GammaDistribution::Train(const arma::vec& logMeanxVec,
   alpha.set_size(ndim);
   beta.set_size(ndim);
 
-  // Treat each dimension (i.e. row) independently.
-  for (size_t row = 0; row < ndim; ++row)
+  // Treat each dimension (i.e. row) independently, in parallel.  Exceptions
+  // can't leave the parallel region, so the first error is thrown after it.
+  std::string error;
+  #pragma omp parallel for
+  for (omp_size_t row = 0; row < (omp_size_t) ndim; ++row)
   {
     // Statistics for this row.
     const double meanLogx = meanLogxVec(row);
@@ -132,6 +126,7 @@ void GammaDistribution::Train(const arma::vec& logMeanxVec,
 
     // Newton's method: In each step, make an update to aEst. If value didn't
     // change much (abs(aNew - aEst) / aEst < tol), then stop.
+    std::string rowError;
     do
     {
       // Needed for convergence test.
@@ -143,93 +138,81 @@ void GammaDistribution::Train(const arma::vec& logMeanxVec,
 
       // Protect against division by 0.
       if (denominator == 0)
-        throw std::logic_error("GammaDistribution::Train() attempted division"
-            " by 0.");
+      {
+        rowError = "GammaDistribution::Train() attempted division by 0.";
+        break;
+      }
 
       aEst = 1.0 / ((1.0 / aEst) + nominator / denominator);
 
       // Protect against nan values (aEst will be passed to logarithm).
       if (aEst <= 0)
-        throw std::logic_error("GammaDistribution::Train(): estimated invalid "
-            "negative value for parameter alpha!");
+      {
+        rowError = "GammaDistribution::Train(): estimated invalid negative "
+            "value for parameter alpha!";
+        break;
+      }
     } while (!Converged(aEst, aOld, tol));
 
+    if (!rowError.empty())
+    {
+      #pragma omp critical(GammaDistributionTrain)
+      {
+        if (error.empty())
+          error = rowError;
+      }
+      continue;
+    }
+
     alpha(row) = aEst;
     beta(row) = meanx / aEst;
   }
+
+  if (!error.empty())
+    throw std::logic_error(error);
 }
 
 // Returns the probability of the provided observations.
 void GammaDistribution::Probability(const arma::mat& observations,
                                     arma::vec& probabilities) const
 {
-  size_t numObs = observations.n_cols;
-
-  // Set all equal to 1 (multiplication neutral).
-  probabilities.ones(numObs);
-
-  // Compute denominator only once for each dimension.
-  arma::vec denominators(alpha.n_elem);
-  for (size_t d = 0; d < alpha.n_elem; ++d)
-    denominators(d) = std::tgamma(alpha(d)) * std::pow(beta(d), alpha(d));
-
-  // Compute probability of each observation.
-  for (size_t i = 0; i < numObs; ++i)
-  {
-    for (size_t d = 0; d < observations.n_rows; ++d)
-    {
-      // Compute probability using Multiplication Law.
-      double factor = std::exp(-observations(d, i) / beta(d));
-      double numerator = std::pow(observations(d, i), alpha(d) - 1);
-
-      probabilities(i) *= factor * numerator / denominators(d);
-    }
-  }
+  // Computing the probabilities in log space avoids overflow of the gamma
+  // function for large alpha.
+  LogProbability(observations, probabilities);
+  probabilities = arma::exp(probabilities);
 }
 
 // Returns the probability of one observation (x) for one of the Gamma's
 // dimensions.
 double GammaDistribution::Probability(double x, size_t dim) const
 {
-  return std::pow(x, alpha(dim) - 1) * std::exp(-x / beta(dim)) /
-      (std::tgamma(alpha(dim)) * std::pow(beta(dim), alpha(dim)));
+  return std::exp(LogProbability(x, dim));
 }
 
 // Returns the log probability of the provided observations.
 void GammaDistribution::LogProbability(const arma::mat& observations,
                                        arma::vec& logProbabilities) const
 {
-  size_t numObs = observations.n_cols;
-
-  // Set all equal to 0 (addition neutral).
-  logProbabilities.zeros(numObs);
-
-  // Compute denominator only once for each dimension.
-  arma::vec denominators(alpha.n_elem);
+  // The log probability of x in dimension d is
+  //   (alpha_d - 1) log(x) - x / beta_d - lgamma(alpha_d) - alpha_d log(beta_d)
+  // so, with the normalizing constants computed once for each dimension, the
+  // log probabilities of all observations are a matrix product.  The product
+  // rule becomes the sum over the dimensions.
+  arma::vec constants(alpha.n_elem);
   for (size_t d = 0; d < alpha.n_elem; ++d)
-    denominators(d) = std::tgamma(alpha(d)) * std::pow(beta(d), alpha(d));
-
-  // Compute probability of each observation.
-  for (size_t i = 0; i < numObs; ++i)
-  {
-    for (size_t d = 0; d < observations.n_rows; ++d)
-    {
-      // Compute probability using Multiplication Law and Logarithm addition
-      // property.
-      double factor = std::exp(-observations(d, i) / beta(d));
-      double numerator = std::pow(observations(d, i), alpha(d) - 1);
+    constants(d) = std::lgamma(alpha(d)) + alpha(d) * std::log(beta(d));
 
-      logProbabilities(i) += std::log(numerator * factor / denominators(d));
-    }
-  }
+  logProbabilities = arma::log(observations).t() * (alpha - 1) -
+      observations.t() * (1 / beta);
+  logProbabilities -= arma::accu(constants);
 }
 
 // Returns the log probability of one observation (x) for one of the Gamma's
 // dimensions.
 double GammaDistribution::LogProbability(double x, size_t dim) const
 {
-  return std::log(std::pow(x, alpha(dim) - 1) * std::exp(-x / beta(dim)) /
-      (std::tgamma(alpha(dim)) * std::pow(beta(dim), alpha(dim))));
+  return (alpha(dim) - 1) * std::log(x) - x / beta(dim) -
+      std::lgamma(alpha(dim)) - alpha(dim) * std::log(beta(dim));
 }
 
 // Returns a gamma-random d-dimensional vector.
@@ -240,8 +223,8 @@ arma::vec GammaDistribution::Random() const
   for (size_t d = 0; d < alpha.n_elem; ++d)
   {
     std::gamma_distribution<double> dist(alpha(d), beta(d));
-    // Use the mlpack random object.
-    randVec(d) = dist(mlpack::math::randGen);
+    // Use the mlpack random object (of this thread, in a parallel region).
+    randVec(d) = dist(mlpack::math::ThreadGenerator());
   }
 
   return randVec;
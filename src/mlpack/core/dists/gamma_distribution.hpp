@@ -112,6 +112,7 @@ class GammaDistribution
   /**
    * This function trains (fits distribution parameters) to a dataset with
    * pre-computed statistics logMeanx, meanLogx, meanx for each dimension.
+   * The dimensions are fitted in parallel.
    *
    * @param logMeanxVec Is each dimension's logarithm of the mean
    *     (log(mean(x))).
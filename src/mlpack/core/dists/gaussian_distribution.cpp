@@ -73,6 +73,24 @@ double GaussianDistribution::LogProbability(const arma::vec& observation) const
   return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * v(0);
 }
 
+void GaussianDistribution::LogProbability(const arma::mat& x,
+                                          arma::vec& logProbabilities) const
+{
+  // Column i of 'diffs' is the difference between x.col(i) and the mean.
+  arma::mat diffs = x;
+  diffs.each_col() -= mean;
+
+  // Since cov = L * L^T, the squared Mahalanobis distance of each point is the
+  // squared norm of L^-1 * diff.  Solving the triangular system for the whole
+  // block at once lets LAPACK use level-3 BLAS instead of one matrix-vector
+  // product per point.
+  const arma::mat whitened = arma::solve(arma::trimatl(covLower), diffs);
+
+  logProbabilities = arma::trans(arma::sum(arma::square(whitened), 0));
+  logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov -
+      0.5 * logProbabilities;
+}
+
 arma::vec GaussianDistribution::Random() const
 {
   return covLower * arma::randn<arma::vec>(mean.n_elem) + mean;
@@ -36,11 +36,31 @@ double LaplaceDistribution::LogProbability(const arma::vec& observation) const
 void LaplaceDistribution::Probability(const arma::mat& x,
                                       arma::vec& probabilities) const
 {
-  probabilities.set_size(x.n_cols);
-  for (size_t i = 0; i < x.n_cols; i++)
-  {
-    probabilities(i) = Probability(x.unsafe_col(i));
-  }
+  LogProbability(x, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
+/**
+ * Evaluate log probability density function of given observations, computing
+ * the distances to the mean of all observations at once.
+ *
+ * @param x List of observations.
+ * @param logProbabilities Output log probabilities for each input observation.
+ */
+void LaplaceDistribution::LogProbability(const arma::mat& x,
+                                         arma::vec& logProbabilities) const
+{
+  logProbabilities = -log(2. * scale) - arma::trans(Distances(x)) / scale;
+}
+
+/**
+ * Compute the distance of each observation to the mean.
+ */
+arma::rowvec LaplaceDistribution::Distances(const arma::mat& x) const
+{
+  arma::mat centered = x;
+  centered.each_col() -= mean;
+  return arma::sqrt(arma::sum(arma::square(centered), 0));
 }
 
 /**
@@ -70,10 +90,7 @@ void LaplaceDistribution::Estimate(const arma::mat& observations)
 
   // The maximum likelihood estimate of the scale parameter is the mean
   // deviation from the mean.
-  scale = 0.0;
-  for (size_t i = 0; i < observations.n_cols; ++i)
-    scale += arma::norm(observations.col(i) - mean, 2);
-  scale /= observations.n_cols;
+  scale = arma::mean(Distances(observations));
 }
 
 /**
@@ -86,16 +103,11 @@ void LaplaceDistribution::Estimate(const arma::mat& observations,
 {
   // I am not completely sure that this change results in a valid maximum
   // likelihood estimator given probabilities of points.
-  mean.zeros(observations.n_rows);
-  for (size_t i = 0; i < observations.n_cols; ++i)
-    mean += observations.col(i) * probabilities(i);
-  mean /= arma::accu(probabilities);
+  mean = (observations * probabilities) / arma::accu(probabilities);
 
   // This is the same formula as the previous function, but here we are
   // multiplying by the probability that the point is actually from
   // this distribution.
-  scale = 0.0;
-  for (size_t i = 0; i < observations.n_cols; ++i)
-    scale += probabilities(i) * arma::norm(observations.col(i) - mean, 2);
-  scale /= arma::accu(probabilities);
+  scale = arma::as_scalar(Distances(observations) * probabilities) /
+      arma::accu(probabilities);
 }
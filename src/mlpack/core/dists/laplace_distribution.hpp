@@ -110,14 +110,7 @@ class LaplaceDistribution
    * @param x List of observations.
    * @param logProbabilities Output probabilities for each input observation.
    */
-  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const
-  {
-    logProbabilities.set_size(x.n_cols);
-    for (size_t i = 0; i < x.n_cols; i++)
-    {
-      logProbabilities(i) = LogProbability(x.unsafe_col(i));
-    }
-  }
+  void LogProbability(const arma::mat& x, arma::vec& logProbabilities) const;
 
   /**
    * Return a randomly generated observation according to the probability
@@ -180,6 +173,9 @@ class LaplaceDistribution
   }
 
  private:
+  //! Compute the distance of each observation to the mean.
+  arma::rowvec Distances(const arma::mat& x) const;
+
   //! Mean of the distribution.
   arma::vec mean;
   //! Scale parameter of the distribution.
@@ -65,6 +65,21 @@ double RegressionDistribution::Probability(const arma::vec& observation) const
   return err.Probability(observation(0)-fitted.t());
 }
 
+void RegressionDistribution::Probability(const arma::mat& observations,
+                                         arma::vec& probabilities) const
+{
+  LogProbability(observations, probabilities);
+  probabilities = arma::exp(probabilities);
+}
+
+void RegressionDistribution::LogProbability(const arma::mat& observations,
+                                            arma::vec& logProbabilities) const
+{
+  arma::rowvec fitted;
+  rf.Predict(observations.rows(1, observations.n_rows - 1), fitted);
+  err.LogProbability(observations.row(0) - fitted, logProbabilities);
+}
+
 void RegressionDistribution::Predict(const arma::mat& points,
                                      arma::vec& predictions) const
 {
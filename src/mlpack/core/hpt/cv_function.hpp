@@ -17,6 +17,8 @@
 namespace mlpack {
 namespace hpt {
 
+HAS_MEM_FUNC(StopThreshold, HasStopThresholdCheck);
+
 /**
  * This wrapper serves for adapting the interface of the cross-validation
  * classes to the one that can be utilized by the mlpack optimizers.
@@ -24,6 +26,9 @@ namespace hpt {
  * This class is not supposed to be used directly by users. To tune
  * hyper-parameters see HyperParameterTuner.
  *
+ * The objective of each set of parameters is cached, so a set of parameters
+ * that the optimizer passes again is not cross-validated again.
+ *
  * @tparam CVType A cross-validation strategy.
  * @tparam MLAlgorithm The machine learning algorithm used in cross-validation.
  * @tparam TotalArgs The total number of arguments that are supposed to be
@@ -86,6 +91,15 @@ class CVFunction
   //! Access and modify the best model so far.
   MLAlgorithm& BestModel() { return bestModel; }
 
+  /**
+   * Get whether cross-validation of a set of parameters can stop early when it
+   * is already worse than the best objective so far (this needs a CVType with
+   * StopThreshold(), such as KFoldCV).
+   */
+  bool EarlyStopping() const { return earlyStopping; }
+  //! Modify whether cross-validation can stop early.
+  bool& EarlyStopping() { return earlyStopping; }
+
  private:
   //! The type of tuples of BoundArgs.
   using BoundArgsTupleType = std::tuple<BoundArgs...>;
@@ -125,6 +139,27 @@ class CVFunction
   //! Minimum absolute increase of arguments for calculation of gradient.
   double minDelta;
 
+  //! Whether cross-validation can stop early.
+  bool earlyStopping;
+
+  //! The objectives of the sets of parameters evaluated so far.
+  std::map<std::vector<double>, double> objectives;
+
+  /**
+   * Set the threshold for stopping cross-validation early, if the CVType
+   * supports it.
+   */
+  template<typename T = CVType>
+  typename std::enable_if<
+      HasStopThresholdCheck<T, double&(T::*)()>::value>::type
+  SetStopThreshold(const double threshold) { cv.StopThreshold() = threshold; }
+
+  //! Ignore the threshold, since the CVType can not stop early.
+  template<typename T = CVType>
+  typename std::enable_if<
+      !HasStopThresholdCheck<T, double&(T::*)()>::value>::type
+  SetStopThreshold(const double /* threshold */) { }
+
   /**
    * Collect all arguments and run cross-validation.
    */
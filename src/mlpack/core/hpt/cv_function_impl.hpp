@@ -55,7 +55,8 @@ CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::CVFunction(
     boundArgs(args...),
     bestObjective(std::numeric_limits<double>::max()),
     relativeDelta(relativeDelta),
-    minDelta(minDelta)
+    minDelta(minDelta),
+    earlyStopping(false)
 { /* Nothing left to do. */ }
 
 template<typename CVType,
@@ -65,7 +66,21 @@ template<typename CVType,
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& parameters)
 {
-  return Evaluate<0, 0>(parameters);
+  const std::vector<double> key(parameters.begin(), parameters.end());
+  const auto it = objectives.find(key);
+  if (it != objectives.end())
+    return it->second;
+
+  // An evaluation that is stopped early returns an objective above the best
+  // one, so it never gives the best model.
+  if (earlyStopping)
+    SetStopThreshold(bestObjective);
+
+  const double objective = Evaluate<0, 0>(parameters);
+  SetStopThreshold(std::numeric_limits<double>::max());
+
+  objectives[key] = objective;
+  return objective;
 }
 
 template<typename CVType,
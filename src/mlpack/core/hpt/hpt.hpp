@@ -109,6 +109,20 @@ class HyperParameterTuner
   //! Access and modify the optimizer.
   OptimizerType& Optimizer() { return optimizer; }
 
+  /**
+   * Get whether the cross-validation of a set of hyper-parameters stops after
+   * half of the folds when their mean is already worse than the best objective
+   * so far (see KFoldCV::StopThreshold()).  The best objective and model are
+   * always from a complete cross-validation.
+   *
+   * The default value is false.
+   */
+  bool EarlyStopping() const { return earlyStopping; }
+
+  //! Modify whether the cross-validation of a set of hyper-parameters can stop
+  //! early.
+  bool& EarlyStopping() { return earlyStopping; }
+
   /**
    * Get relative increase of arguments for calculation of partial
    * derivatives (by the definition) in gradient-based optimization. The exact
@@ -205,7 +219,14 @@ class HyperParameterTuner
       CV<MLAlgorithm, Negated<Metric>, MatType, PredictionsType,
           WeightsType>>::type;
 
+ public:
+  /**
+   * Access and modify the cross-validation object, for instance to let
+   * KFoldCV run folds at the same time with MaxConcurrentFolds().
+   */
+  CVType& CrossValidation() { return cv; }
 
+ private:
   //! The cross-validation object for assessing sets of hyper-parameters.
   CVType cv;
 
@@ -230,6 +251,9 @@ class HyperParameterTuner
    */
   double minDelta;
 
+  //! Whether the cross-validation of a set of hyper-parameters can stop early.
+  bool earlyStopping;
+
   /**
    * A type function to check whether the element I of the tuple type is a
    * PreFixedArg.
@@ -32,7 +32,10 @@ HyperParameterTuner<MLAlgorithm,
                     MatType,
                     PredictionsType,
                     WeightsType>::HyperParameterTuner(const CVArgs&... args) :
-    cv(args...), relativeDelta(0.01), minDelta(1e-10) {}
+    cv(args...),
+    relativeDelta(0.01),
+    minDelta(1e-10),
+    earlyStopping(false) { }
 
 template<typename MLAlgorithm,
          typename Metric,
@@ -104,6 +107,7 @@ void HyperParameterTuner<MLAlgorithm,
 
   CVFunction<CVType, MLAlgorithm, totalArgs, FixedArgs...>
       cvFunction(cv, datasetInfo, relativeDelta, minDelta, fixedArgs...);
+  cvFunction.EarlyStopping() = earlyStopping;
   bestObjective = Metric::NeedsMinimization ? optimizer.Optimize(cvFunction,
       bestParams, categoricalDimensions, numCategories) :
       -optimizer.Optimize(cvFunction, bestParams, categoricalDimensions,
@@ -0,0 +1,119 @@
+/**
+ * @file batch_kernels.hpp
+ *
+ * Utilities to evaluate a kernel between every column of one matrix and every
+ * column of another at once.  Kernels that have a batch Evaluate() (see
+ * KernelTraits::HasBatchEvaluate) compute the whole block of kernel values
+ * with a single matrix multiplication followed by an elementwise
+ * transformation; the kernel values of the other kernels are evaluated one at
+ * a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_BATCH_KERNELS_HPP
+#define MLPACK_CORE_KERNELS_BATCH_KERNELS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "kernel_traits.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * 'value' is true if blocks of kernel values for the given kernel and matrix
+ * type can be computed with BatchKernels().  This is the case for the kernels
+ * whose KernelTraits have HasBatchEvaluate set (such as the linear,
+ * polynomial, Gaussian, Laplacian and cosine kernels), on dense matrices.
+ */
+template<typename KernelType, typename MatType>
+struct SupportsBatchKernels
+{
+  static const bool value = KernelTraits<KernelType>::HasBatchEvaluate &&
+      !arma::is_arma_sparse_type<MatType>::value;
+};
+
+/**
+ * Evaluate the kernel between each column of a and each column of b, with the
+ * batch Evaluate() of the kernel.
+ *
+ * @param kernel The kernel to evaluate.
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param kernels Matrix to store the kernel values in; element (i, j) will be
+ *     K(a.col(i), b.col(j)).
+ */
+template<typename KernelType, typename MatTypeA, typename MatTypeB>
+void BatchKernels(const KernelType& kernel,
+                  const MatTypeA& a,
+                  const MatTypeB& b,
+                  arma::mat& kernels)
+{
+  kernel.Evaluate(a, b, kernels);
+}
+
+/**
+ * Compute the kernel matrix between the columns of a and the columns of b,
+ * for a kernel that supports BatchKernels().  The kernel values are computed
+ * with matrix multiplications.
+ *
+ * @param kernel The kernel to evaluate.
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param kernels Matrix to store the kernel values in; element (i, j) will be
+ *     K(a.col(i), b.col(j)).
+ */
+template<typename KernelType, typename MatType>
+void KernelMatrix(KernelType& kernel,
+                  const MatType& a,
+                  const MatType& b,
+                  arma::mat& kernels,
+                  const typename std::enable_if_t<
+                      SupportsBatchKernels<KernelType, MatType>::value>* = 0)
+{
+  BatchKernels(kernel, a, b, kernels);
+}
+
+/**
+ * Compute the kernel matrix between the columns of a and the columns of b,
+ * for any other kernel.  Each kernel value is evaluated separately, and the
+ * columns of the kernel matrix are computed in parallel.  If a and b are the
+ * same matrix, only the upper triangular part of the kernel matrix is
+ * evaluated, since it is symmetric.
+ *
+ * @param kernel The kernel to evaluate.
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param kernels Matrix to store the kernel values in; element (i, j) will be
+ *     K(a.col(i), b.col(j)).
+ */
+template<typename KernelType, typename MatType>
+void KernelMatrix(KernelType& kernel,
+                  const MatType& a,
+                  const MatType& b,
+                  arma::mat& kernels,
+                  const typename std::enable_if_t<
+                      !SupportsBatchKernels<KernelType, MatType>::value>* = 0)
+{
+  const bool symmetric = (&a == &b);
+  kernels.set_size(a.n_cols, b.n_cols);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
+  {
+    const size_t end = symmetric ? (size_t) j + 1 : (size_t) a.n_cols;
+    for (size_t i = 0; i < end; ++i)
+      kernels(i, j) = kernel.Evaluate(a.col(i), b.col(j));
+  }
+
+  // Copy to the lower triangular part of the matrix.
+  if (symmetric)
+    kernels = arma::symmatu(kernels);
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
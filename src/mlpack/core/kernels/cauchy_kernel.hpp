@@ -68,6 +68,11 @@ class CauchyKernel
         std::pow(metric::EuclideanDistance::Evaluate(a, b) / bandwidth, 2)));
   }
 
+  //! Get the bandwidth.
+  double Bandwidth() const { return bandwidth; }
+  //! Modify the bandwidth.
+  double& Bandwidth() { return bandwidth; }
+
   /**
    * Serialize the kernel.
    */
@@ -89,6 +94,10 @@ class KernelTraits<CauchyKernel>
  public:
   //! The Cauchy kernel is normalized: K(x, x) = 1 for all x.
   static const bool IsNormalized = true;
+  //! The Cauchy kernel evaluates kernel values one at a time.
+  static const bool HasBatchEvaluate = false;
+  //! The Cauchy kernel does not have finite support.
+  static const bool HasFiniteSupport = false;
 };
 
 } // namespace kernel
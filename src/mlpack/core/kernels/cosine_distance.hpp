@@ -41,6 +41,21 @@ class CosineDistance
   template<typename VecTypeA, typename VecTypeB>
   static double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Computes the cosine distance between each column of a and each column of
+   * b.  The dot products are obtained from one matrix multiplication, and are
+   * then divided by the norms of the columns.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernels Matrix to store the kernel values in; element (i, j) will
+   *     be d(a.col(i), b.col(j)).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       arma::mat& kernels);
+
   //! Serialize the class (there's nothing to save).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
@@ -56,6 +71,11 @@ class KernelTraits<CosineDistance>
 
   //! The cosine kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+
+  //! The cosine kernel can evaluate blocks of kernel values at once.
+  static const bool HasBatchEvaluate = true;
+  //! The cosine kernel does not have finite support.
+  static const bool HasFiniteSupport = false;
 };
 
 } // namespace kernel
@@ -32,6 +32,23 @@ double CosineDistance::Evaluate(const VecTypeA& a, const VecTypeB& b)
     return dot(a, b) / denominator;
 }
 
+template<typename MatTypeA, typename MatTypeB>
+void CosineDistance::Evaluate(const MatTypeA& a,
+                              const MatTypeB& b,
+                              arma::mat& kernels)
+{
+  // As above, columns with zero norm have cosine similarity 0 with every
+  // other column, so their inverse norm is taken to be 0.
+  arma::vec aNorms = arma::trans(arma::sqrt(arma::sum(arma::square(a), 0)));
+  arma::rowvec bNorms = arma::sqrt(arma::sum(arma::square(b), 0));
+  aNorms.transform([](const double n) { return (n == 0.0) ? 0.0 : 1.0 / n; });
+  bNorms.transform([](const double n) { return (n == 0.0) ? 0.0 : 1.0 / n; });
+
+  kernels = a.t() * b;
+  kernels.each_col() %= aNorms;
+  kernels.each_row() %= bNorms;
+}
+
 } // namespace kernel
 } // namespace mlpack
 
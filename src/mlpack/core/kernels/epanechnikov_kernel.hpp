@@ -89,6 +89,9 @@ class EpanechnikovKernel
    */
   double Normalizer(const size_t dimension);
 
+  //! Get the bandwidth of the kernel.
+  double Bandwidth() const { return bandwidth; }
+
   /**
    * Serialize the kernel.
    */
@@ -111,6 +114,10 @@ class KernelTraits<EpanechnikovKernel>
   static const bool IsNormalized = true;
   //! The Epanechnikov kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Epanechnikov kernel evaluates kernel values one at a time.
+  static const bool HasBatchEvaluate = false;
+  //! The Epanechnikov kernel is zero beyond its bandwidth.
+  static const bool HasFiniteSupport = true;
 };
 
 } // namespace kernel
@@ -68,6 +68,31 @@ class GaussianKernel
     return exp(gamma * metric::SquaredEuclideanDistance::Evaluate(a, b));
   }
 
+  /**
+   * Evaluate the Gaussian kernel between each column of a and each column of
+   * b.  The squared distances are obtained from one matrix multiplication, as
+   * ||a_i||^2 + ||b_j||^2 - 2 a_i^T b_j, and the exponential is then taken
+   * over the whole block at once.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernels Matrix to store the kernel values in; element (i, j) will
+   *     be K(a.col(i), b.col(j)).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a,
+                const MatTypeB& b,
+                arma::mat& kernels) const
+  {
+    kernels = -2.0 * (a.t() * b);
+    kernels.each_col() += arma::trans(arma::sum(arma::square(a), 0));
+    kernels.each_row() += arma::sum(arma::square(b), 0);
+
+    // Rounding can make the squared distance of close points slightly
+    // negative.
+    kernels = arma::exp(gamma * arma::clamp(kernels, 0.0, DBL_MAX));
+  }
+
   /**
    * Evaluation of the Gaussian kernel given the distance between two points.
    *
@@ -171,6 +196,10 @@ class KernelTraits<GaussianKernel>
   static const bool IsNormalized = true;
   //! The Gaussian kernel includes a squared distance.
   static const bool UsesSquaredDistance = true;
+  //! The Gaussian kernel can evaluate blocks of kernel values at once.
+  static const bool HasBatchEvaluate = true;
+  //! The Gaussian kernel does not have finite support.
+  static const bool HasFiniteSupport = false;
 };
 
 } // namespace kernel
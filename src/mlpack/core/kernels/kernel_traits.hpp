@@ -36,6 +36,19 @@ class KernelTraits
    * If true, then the kernel include a squared distance, ||x - y||^2 .
    */
   static const bool UsesSquaredDistance = false;
+
+  /**
+   * If true, then the kernel can evaluate the kernel values between every
+   * column of one matrix and every column of another at once, with
+   * Evaluate(a, b, kernels).
+   */
+  static const bool HasBatchEvaluate = false;
+
+  /**
+   * If true, then the kernel has finite support: K(x, y) = 0 whenever ||x - y||
+   * is greater than the bandwidth of the kernel, given by Bandwidth().
+   */
+  static const bool HasFiniteSupport = false;
 };
 
 } // namespace kernel
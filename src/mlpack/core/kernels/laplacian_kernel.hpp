@@ -64,6 +64,32 @@ class LaplacianKernel
     return exp(-metric::EuclideanDistance::Evaluate(a, b) / bandwidth);
   }
 
+  /**
+   * Evaluate the Laplacian kernel between each column of a and each column of
+   * b.  The squared distances are obtained from one matrix multiplication, as
+   * ||a_i||^2 + ||b_j||^2 - 2 a_i^T b_j, and the square root and exponential
+   * are then taken over the whole block at once.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernels Matrix to store the kernel values in; element (i, j) will
+   *     be K(a.col(i), b.col(j)).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a,
+                const MatTypeB& b,
+                arma::mat& kernels) const
+  {
+    kernels = -2.0 * (a.t() * b);
+    kernels.each_col() += arma::trans(arma::sum(arma::square(a), 0));
+    kernels.each_row() += arma::sum(arma::square(b), 0);
+
+    // Rounding can make the squared distance of close points slightly
+    // negative.
+    kernels = arma::exp(-arma::sqrt(arma::clamp(kernels, 0.0, DBL_MAX)) /
+        bandwidth);
+  }
+
   /**
    * Evaluation of the Laplacian kernel given the distance between two points.
    *
@@ -117,6 +143,10 @@ class KernelTraits<LaplacianKernel>
   static const bool IsNormalized = true;
   //! The Laplacian kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The Laplacian kernel can evaluate blocks of kernel values at once.
+  static const bool HasBatchEvaluate = true;
+  //! The Laplacian kernel does not have finite support.
+  static const bool HasFiniteSupport = false;
 };
 
 } // namespace kernel
@@ -15,6 +15,7 @@
 #define MLPACK_CORE_KERNELS_LINEAR_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
 
 namespace mlpack {
 namespace kernel {
@@ -55,11 +56,43 @@ class LinearKernel
     return arma::dot(a, b);
   }
 
+  /**
+   * Evaluate the linear kernel between each column of a and each column of b.
+   * This is a single matrix multiplication.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param kernels Matrix to store the kernel values in; element (i, j) will
+   *     be K(a.col(i), b.col(j)).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void Evaluate(const MatTypeA& a,
+                       const MatTypeB& b,
+                       arma::mat& kernels)
+  {
+    kernels = a.t() * b;
+  }
+
   //! Serialize the kernel (it has no members... do nothing).
   template<typename Archive>
   void serialize(Archive& /* ar */, const unsigned int /* version */) { }
 };
 
+//! Kernel traits for the linear kernel.
+template<>
+class KernelTraits<LinearKernel>
+{
+ public:
+  //! The linear kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The linear kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The linear kernel can evaluate blocks of kernel values at once.
+  static const bool HasBatchEvaluate = true;
+  //! The linear kernel does not have finite support.
+  static const bool HasFiniteSupport = false;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
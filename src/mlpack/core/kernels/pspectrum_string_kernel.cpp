@@ -19,6 +19,9 @@ using namespace std;
 using namespace mlpack;
 using namespace mlpack::kernel;
 
+// The definition of the static constant, since it is bound to a reference.
+const size_t PSpectrumStringKernel::MaxExactP;
+
 /**
  * Initialize the PSpectrumStringKernel with the given string datasets.  For
  * more information on this, see the general class documentation.
@@ -37,51 +40,155 @@ mlpack::kernel::PSpectrumStringKernel::PSpectrumStringKernel(
       << std::endl;
 
   // Resize for number of datasets.
-  counts.resize(datasets.size());
+  codes.resize(datasets.size());
+  codeCounts.resize(datasets.size());
+  offsets.resize(datasets.size());
 
   for (size_t dataset = 0; dataset < datasets.size(); ++dataset)
   {
     const std::vector<std::string>& set = datasets[dataset];
 
-    // Resize for number of strings in dataset.
-    counts[dataset].resize(set.size());
-
-    // Inspect each string in the dataset.
-    for (size_t index = 0; index < set.size(); ++index)
+    // Find the sorted codes of the substrings of each string in parallel.
+    std::vector<std::vector<uint64_t> > stringCodes(set.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t index = 0; index < (omp_size_t) set.size(); ++index)
     {
       // Convenience references.
       const std::string& str = set[index];
-      std::map<std::string, int>& mapping = counts[dataset][index];
+      std::vector<uint64_t>& strCodes = stringCodes[index];
 
-      size_t start = 0;
-      while ((start + p) <= str.length())
+      for (size_t start = 0; (start + p) <= str.length(); ++start)
       {
-        string sub = str.substr(start, p);
-
-        // Convert all characters to lowercase.
+        // Only consider substrings with alphanumerics.  All characters are
+        // converted to lowercase.
         bool invalid = false;
-        for (size_t j = 0; j < p; ++j)
+        uint64_t code = (p <= MaxExactP) ? 0 : 14695981039346656037ULL;
+        for (size_t j = start; j < start + p; ++j)
         {
-          if (!isalnum(sub[j]))
+          if (!isalnum((unsigned char) str[j]))
           {
             invalid = true;
-            break; // Only consider substrings with alphanumerics.
+            break;
           }
 
-          sub[j] = tolower(sub[j]);
+          const char c = tolower((unsigned char) str[j]);
+          if (p <= MaxExactP)
+          {
+            // One base-36 digit for each character, so that the codes sort
+            // like the substrings.
+            code = 36 * code + (isdigit(c) ? (c - '0') : (c - 'a' + 10));
+          }
+          else
+          {
+            // FNV-1a hash.
+            code = (code ^ (unsigned char) c) * 1099511628211ULL;
+          }
         }
 
-        // Increment position in string.
-        ++start;
-
         if (!invalid)
+          strCodes.push_back(code);
+      }
+
+      std::sort(strCodes.begin(), strCodes.end());
+    }
+
+    // Store the distinct codes of each string with their counts.
+    offsets[dataset].resize(set.size() + 1);
+    offsets[dataset][0] = 0;
+    for (size_t index = 0; index < set.size(); ++index)
+    {
+      const std::vector<uint64_t>& strCodes = stringCodes[index];
+      for (size_t k = 0; k < strCodes.size(); ++k)
+      {
+        if (k > 0 && strCodes[k] == strCodes[k - 1])
+        {
+          ++codeCounts[dataset].back();
+        }
+        else
         {
-          // Add to the map.
-          ++mapping[sub];
+          codes[dataset].push_back(strCodes[k]);
+          codeCounts[dataset].push_back(1);
         }
       }
+
+      offsets[dataset][index + 1] = codes[dataset].size();
+      std::vector<uint64_t>().swap(stringCodes[index]);
     }
   }
 
   Log::Info << "Substring extraction complete." << std::endl;
 }
+
+/**
+ * Decode the counts of all substrings.
+ */
+std::vector<std::vector<std::map<std::string, int> > >
+mlpack::kernel::PSpectrumStringKernel::Counts() const
+{
+  if (p > MaxExactP)
+  {
+    std::ostringstream oss;
+    oss << "PSpectrumStringKernel::Counts(): substrings of length " << p
+        << " are hashed and cannot be decoded (p must be at most " << MaxExactP
+        << ")!";
+    throw std::logic_error(oss.str());
+  }
+
+  const std::string digits = "0123456789abcdefghijklmnopqrstuvwxyz";
+  std::vector<std::vector<std::map<std::string, int> > > counts(codes.size());
+  for (size_t dataset = 0; dataset < codes.size(); ++dataset)
+  {
+    counts[dataset].resize(offsets[dataset].size() - 1);
+    for (size_t index = 0; index < counts[dataset].size(); ++index)
+    {
+      for (size_t k = offsets[dataset][index];
+           k < offsets[dataset][index + 1]; ++k)
+      {
+        std::string sub(p, '0');
+        uint64_t code = codes[dataset][k];
+        for (size_t j = p; j > 0; --j)
+        {
+          sub[j - 1] = digits[code % 36];
+          code /= 36;
+        }
+
+        counts[dataset][index][sub] = (int) codeCounts[dataset][k];
+      }
+    }
+  }
+
+  return counts;
+}
+
+/**
+ * Compute the kernel value with a merge of the sorted codes of the strings.
+ */
+double mlpack::kernel::PSpectrumStringKernel::EvaluateStrings(
+    const size_t aDataset,
+    const size_t aIndex,
+    const size_t bDataset,
+    const size_t bIndex) const
+{
+  const std::vector<uint64_t>& aCodes = codes[aDataset];
+  const std::vector<uint64_t>& bCodes = codes[bDataset];
+  const std::vector<size_t>& aCounts = codeCounts[aDataset];
+  const std::vector<size_t>& bCounts = codeCounts[bDataset];
+
+  size_t i = offsets[aDataset][aIndex];
+  size_t j = offsets[bDataset][bIndex];
+  const size_t aEnd = offsets[aDataset][aIndex + 1];
+  const size_t bEnd = offsets[bDataset][bIndex + 1];
+
+  double eval = 0;
+  while (i < aEnd && j < bEnd)
+  {
+    if (aCodes[i] == bCodes[j]) // The same substring.
+      eval += aCounts[i++] * bCounts[j++];
+    else if (aCodes[i] > bCodes[j])
+      ++j; // bCodes[j] is behind, so increment j to catch up.
+    else
+      ++i; // aCodes[i] is behind, so increment i to catch up.
+  }
+
+  return eval;
+}
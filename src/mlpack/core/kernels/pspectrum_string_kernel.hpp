@@ -16,12 +16,14 @@
 #ifndef MLPACK_CORE_KERNELS_PSPECTRUM_STRING_KERNEL_HPP
 #define MLPACK_CORE_KERNELS_PSPECTRUM_STRING_KERNEL_HPP
 
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/log.hpp>
+#include "kernel_traits.hpp"
 
 namespace mlpack {
 namespace kernel {
@@ -61,6 +63,15 @@ namespace kernel {
  * the data according to the fake data matrix -- resulting in a meaningless
  * tree.  This kernel was originally written for the FastMKS method; so, at the
  * very least, it will work with that.
+ *
+ * At construction time, each substring of length p is encoded as an integer:
+ * for p <= MaxExactP, the code is exact (each of the 36 lowercase alphanumeric
+ * characters is a base-36 digit), and for longer substrings it is a 64-bit
+ * hash.  The distinct codes of each string are stored in sorted order with
+ * their counts, in flat arrays for each dataset, so a kernel evaluation is a
+ * linear merge of two integer arrays.  Blocks of kernel values can be computed
+ * at once (and in parallel) with Evaluate(a, b, kernels), which KernelPCA and
+ * FastMKS use through BatchKernels().
  */
 class PSpectrumStringKernel
 {
@@ -89,12 +100,44 @@ class PSpectrumStringKernel
   template<typename VecType>
   double Evaluate(const VecType& a, const VecType& b) const;
 
-  //! Access the lists of substrings.
-  const std::vector<std::vector<std::map<std::string, int> > >& Counts() const
-  { return counts; }
-  //! Modify the lists of substrings.
-  std::vector<std::vector<std::map<std::string, int> > >& Counts()
-  { return counts; }
+  /**
+   * Evaluate the kernel between the strings of each column of a and the
+   * strings of each column of b.  The columns of the result are computed in
+   * parallel, and if a and b are the same matrix, only half of the kernel
+   * values are evaluated.
+   *
+   * @param a Indices of datasets and strings of the first set of strings.
+   * @param b Indices of datasets and strings of the second set of strings.
+   * @param kernels Matrix to store the kernel values in; element (i, j) will
+   *     be K(a.col(i), b.col(j)).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void Evaluate(const MatTypeA& a,
+                const MatTypeB& b,
+                arma::mat& kernels) const;
+
+  /**
+   * Return the counts of the substrings of each string of each dataset.  The
+   * maps are decoded from the integer codes when this is called, so this is
+   * slow, and it is only possible when p <= MaxExactP (otherwise a
+   * std::logic_error is thrown).
+   */
+  std::vector<std::vector<std::map<std::string, int> > > Counts() const;
+
+  //! Get the sorted codes of the distinct substrings of all strings of the
+  //! given dataset; the codes of string i are [Offsets()[i], Offsets()[i + 1]).
+  const std::vector<uint64_t>& Codes(const size_t dataset) const
+  { return codes[dataset]; }
+  //! Get the number of times each substring of Codes() appears in its string.
+  const std::vector<size_t>& CodeCounts(const size_t dataset) const
+  { return codeCounts[dataset]; }
+  //! Get the offsets of the substrings of each string of the given dataset in
+  //! Codes() and CodeCounts().
+  const std::vector<size_t>& Offsets(const size_t dataset) const
+  { return offsets[dataset]; }
+
+  //! The longest substrings with exact codes.
+  static const size_t MaxExactP = 12;
 
   //! Access the value of p.
   size_t P() const { return p; }
@@ -102,14 +145,40 @@ class PSpectrumStringKernel
   size_t& P() { return p; }
 
  private:
-  //! Mappings of the datasets to counts of substrings.  Such a huge structure
-  //! is not wonderful...
-  std::vector<std::vector<std::map<std::string, int> > > counts;
+  //! Compute the kernel value between two strings from their codes.
+  double EvaluateStrings(const size_t aDataset,
+                         const size_t aIndex,
+                         const size_t bDataset,
+                         const size_t bIndex) const;
+
+  //! The sorted codes of the distinct substrings of the strings of each
+  //! dataset.
+  std::vector<std::vector<uint64_t> > codes;
+  //! The counts of the substrings of the strings of each dataset.
+  std::vector<std::vector<size_t> > codeCounts;
+  //! The offsets of the codes of each string of each dataset.
+  std::vector<std::vector<size_t> > offsets;
 
   //! The value of p to use in calculation.
   size_t p;
 };
 
+//! Kernel traits for the p-spectrum string kernel.
+template<>
+class KernelTraits<PSpectrumStringKernel>
+{
+ public:
+  //! The p-spectrum string kernel is not normalized.
+  static const bool IsNormalized = false;
+  //! The p-spectrum string kernel doesn't include a squared distance.
+  static const bool UsesSquaredDistance = false;
+  //! The p-spectrum string kernel can evaluate blocks of kernel values at
+  //! once.
+  static const bool HasBatchEvaluate = true;
+  //! The p-spectrum string kernel does not have finite support.
+  static const bool HasFiniteSupport = false;
+};
+
 } // namespace kernel
 } // namespace mlpack
 
@@ -36,44 +36,38 @@ template<typename VecType>
 double PSpectrumStringKernel::Evaluate(const VecType& a,
                                        const VecType& b) const
 {
-  // Get the map of substrings for the two strings we are interested in.
-  const std::map<std::string, int>& aMap = counts[a[0]][a[1]];
-  const std::map<std::string, int>& bMap = counts[b[0]][b[1]];
-
-  double eval = 0;
+  return EvaluateStrings((size_t) a[0], (size_t) a[1], (size_t) b[0],
+      (size_t) b[1]);
+}
 
-  // Loop through the two maps (which, when iterated through, are sorted
-  // alphabetically).
-  std::map<std::string, int>::const_iterator aIt = aMap.begin();
-  std::map<std::string, int>::const_iterator bIt = bMap.begin();
+/**
+ * Evaluate the kernel between the strings of each column of a and the strings
+ * of each column of b.
+ */
+template<typename MatTypeA, typename MatTypeB>
+void PSpectrumStringKernel::Evaluate(const MatTypeA& a,
+                                     const MatTypeB& b,
+                                     arma::mat& kernels) const
+{
+  const bool symmetric = ((const void*) &a == (const void*) &b);
+  kernels.set_size(a.n_cols, b.n_cols);
 
-  while ((aIt != aMap.end()) && (bIt != bMap.end()))
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t j = 0; j < (omp_size_t) b.n_cols; ++j)
   {
-    // Compare alphabetically (this is how std::map is ordered).
-    int result = (*aIt).first.compare((*bIt).first);
-
-    if (result == 0) // The same substring.
+    const size_t end = symmetric ? (size_t) j + 1 : (size_t) a.n_cols;
+    for (size_t i = 0; i < end; ++i)
     {
-      eval += ((*aIt).second * (*bIt).second);
-
-      // Now increment both.
-      ++aIt;
-      ++bIt;
-    }
-    else if (result > 0)
-    {
-      // aIt is "ahead" of bIt (alphabetically); so increment bIt to "catch up".
-      ++bIt;
-    }
-    else
-    {
-      // bIt is "ahead" of aIt (alphabetically); so increment aIt to "catch up".
-      ++aIt;
+      kernels(i, j) = EvaluateStrings((size_t) a(0, i), (size_t) a(1, i),
+          (size_t) b(0, j), (size_t) b(1, j));
     }
   }
 
-  return eval;
+  // Copy to the lower triangular part of the matrix.
+  if (symmetric)
+    kernels = arma::symmatu(kernels);
 }
+
 } // namespace kernel
 } // namespace mlpack
 
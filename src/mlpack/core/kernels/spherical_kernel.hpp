@@ -105,6 +105,9 @@ class SphericalKernel
     return t == bandwidth ? arma::datum::nan : 0.0;
   }
 
+  //! Get the bandwidth of the kernel.
+  double Bandwidth() const { return bandwidth; }
+
   //! Serialize the object.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */)
@@ -127,6 +130,10 @@ class KernelTraits<SphericalKernel>
   static const bool IsNormalized = true;
   //! The spherical kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The spherical kernel evaluates kernel values one at a time.
+  static const bool HasBatchEvaluate = false;
+  //! The spherical kernel is zero beyond its bandwidth.
+  static const bool HasFiniteSupport = true;
 };
 
 } // namespace kernel
@@ -112,6 +112,10 @@ class KernelTraits<TriangularKernel>
   static const bool IsNormalized = true;
   //! The triangular kernel doesn't include a squared distance.
   static const bool UsesSquaredDistance = false;
+  //! The triangular kernel evaluates kernel values one at a time.
+  static const bool HasBatchEvaluate = false;
+  //! The triangular kernel is zero beyond its bandwidth.
+  static const bool HasFiniteSupport = true;
 };
 
 } // namespace kernel
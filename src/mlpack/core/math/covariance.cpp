@@ -0,0 +1,124 @@
+/**
+ * @file covariance.cpp
+ *
+ * Implementation of the streaming covariance computation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "covariance.hpp"
+
+using namespace mlpack;
+using namespace mlpack::math;
+
+CovarianceAccumulator::CovarianceAccumulator(const size_t dimensionality) :
+    count(0),
+    mean(dimensionality, arma::fill::zeros),
+    coMoment(dimensionality, dimensionality, arma::fill::zeros)
+{
+  // Nothing to do.
+}
+
+void CovarianceAccumulator::Update(const arma::mat& chunk)
+{
+  if (chunk.n_cols == 0)
+    return;
+
+  if (chunk.n_rows != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "CovarianceAccumulator::Update(): the points have "
+        << chunk.n_rows << " dimensions, but the accumulator has "
+        << mean.n_elem;
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Center the chunk on its own mean, and merge its statistics.
+  CovarianceAccumulator chunkStatistics;
+  chunkStatistics.count = chunk.n_cols;
+  chunkStatistics.mean = arma::sum(chunk, 1) / chunk.n_cols;
+
+  arma::mat centered = chunk;
+  centered.each_col() -= chunkStatistics.mean;
+  chunkStatistics.coMoment = centered * centered.t();
+
+  Merge(chunkStatistics);
+}
+
+void CovarianceAccumulator::Merge(const CovarianceAccumulator& other)
+{
+  if (other.count == 0)
+    return;
+
+  if (count == 0)
+  {
+    *this = other;
+    return;
+  }
+
+  if (other.mean.n_elem != mean.n_elem)
+  {
+    std::ostringstream oss;
+    oss << "CovarianceAccumulator::Merge(): the accumulators have "
+        << mean.n_elem << " and " << other.mean.n_elem << " dimensions";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const double n = count + other.count;
+  const arma::vec delta = other.mean - mean;
+
+  mean += delta * (other.count / n);
+  coMoment += other.coMoment;
+  coMoment += (delta * delta.t()) * ((count * (double) other.count) / n);
+  count += other.count;
+}
+
+void CovarianceAccumulator::Covariance(arma::mat& covariance,
+                                       const size_t normType) const
+{
+  const double norm = (normType == 0) ?
+      ((count > 1) ? (count - 1.0) : 1.0) :
+      ((count > 0) ? (double) count : 1.0);
+
+  covariance = coMoment / norm;
+}
+
+void mlpack::math::Covariance(const arma::mat& x,
+                              arma::vec& mean,
+                              arma::mat& covariance,
+                              const size_t normType,
+                              const size_t chunkSize)
+{
+  // One contiguous range of columns per thread.
+  const size_t numBlocks = std::max((size_t) 1,
+      std::min(NumThreads(), (size_t) x.n_cols));
+  std::vector<CovarianceAccumulator> accumulators(numBlocks,
+      CovarianceAccumulator(x.n_rows));
+  const size_t step = std::max((size_t) 1, chunkSize);
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * x.n_cols / numBlocks;
+    const size_t end = (b + 1) * x.n_cols / numBlocks;
+    for (size_t i = begin; i < end; i += step)
+    {
+      const size_t last = std::min(i + step, end) - 1;
+      // Make an alias of the chunk, to avoid a copy.
+      const arma::mat chunk(const_cast<double*>(x.colptr(i)), x.n_rows,
+          last - i + 1, false, true);
+      accumulators[b].Update(chunk);
+    }
+  }
+
+  // Merge the accumulators pairwise, so that statistics over similar numbers
+  // of points are combined.
+  for (size_t width = 1; width < numBlocks; width *= 2)
+    for (size_t b = 0; b + width < numBlocks; b += 2 * width)
+      accumulators[b].Merge(accumulators[b + width]);
+
+  mean = accumulators[0].Mean();
+  accumulators[0].Covariance(covariance, normType);
+}
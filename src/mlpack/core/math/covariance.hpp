@@ -0,0 +1,119 @@
+/**
+ * @file covariance.hpp
+ *
+ * Streaming computation of the mean and covariance of a dataset, one chunk of
+ * points at a time, without a centered copy of the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_COVARIANCE_HPP
+#define MLPACK_CORE_MATH_COVARIANCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace math {
+
+/**
+ * The CovarianceAccumulator holds the number of points, the mean and the
+ * co-moment (the sum of the outer products of the centered points) of the
+ * points given so far.  Chunks of points are added with Update(), and two
+ * accumulators over disjoint sets of points are combined with Merge(), using
+ * the pairwise update of Chan, Golub and LeVeque:
+ *
+ * @code
+ * @article{chan1983algorithms,
+ *   title={Algorithms for computing the sample variance: analysis and
+ *       recommendations},
+ *   author={Chan, T.F. and Golub, G.H. and LeVeque, R.J.},
+ *   journal={The American Statistician},
+ *   volume={37},
+ *   number={3},
+ *   pages={242--247},
+ *   year={1983}
+ * }
+ * @endcode
+ *
+ * Each chunk is centered on its own mean in a temporary matrix of the size of
+ * the chunk, so the memory used is that of one chunk plus the d x d co-moment;
+ * that is also more accurate than the sum of the outer products of the
+ * uncentered points.
+ */
+class CovarianceAccumulator
+{
+ public:
+  /**
+   * Create an empty accumulator for points of the given dimensionality.
+   *
+   * @param dimensionality Dimensionality of the points.
+   */
+  CovarianceAccumulator(const size_t dimensionality = 0);
+
+  /**
+   * Add the given chunk of points (one per column).
+   *
+   * @param chunk Points to add.
+   */
+  void Update(const arma::mat& chunk);
+
+  /**
+   * Add the points of another accumulator, which must be over points disjoint
+   * from the ones of this accumulator.
+   *
+   * @param other Accumulator to merge into this one.
+   */
+  void Merge(const CovarianceAccumulator& other);
+
+  /**
+   * Get the covariance of the points added so far.
+   *
+   * @param covariance Matrix to store the covariance in.
+   * @param normType 0 to normalize by N - 1 (the default, as with ccov()), or
+   *     1 to normalize by N.
+   */
+  void Covariance(arma::mat& covariance, const size_t normType = 0) const;
+
+  //! Get the number of points added so far.
+  size_t Count() const { return count; }
+  //! Get the mean of the points added so far.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the co-moment of the points added so far.
+  const arma::mat& CoMoment() const { return coMoment; }
+
+ private:
+  //! The number of points.
+  size_t count;
+  //! The mean of the points.
+  arma::vec mean;
+  //! The sum of the outer products of the centered points.
+  arma::mat coMoment;
+};
+
+/**
+ * Compute the mean and covariance of the given points (one per column).  The
+ * columns are split into one contiguous range per thread, each thread streams
+ * its range in chunks of the given number of points into a
+ * CovarianceAccumulator, and the accumulators of the threads are merged
+ * pairwise.  The peak memory is one chunk and one d x d matrix per thread, on
+ * top of the data.
+ *
+ * @param x Points.
+ * @param mean Vector to store the mean of the points in.
+ * @param covariance Matrix to store the covariance of the points in.
+ * @param normType 0 to normalize by N - 1 (the default, as with ccov()), or 1
+ *     to normalize by N.
+ * @param chunkSize Number of points centered at once.
+ */
+void Covariance(const arma::mat& x,
+                arma::vec& mean,
+                arma::mat& covariance,
+                const size_t normType = 0,
+                const size_t chunkSize = 1024);
+
+} // namespace math
+} // namespace mlpack
+
+#endif
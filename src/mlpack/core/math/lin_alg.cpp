@@ -45,22 +45,32 @@ void mlpack::math::Center(const arma::mat& x, arma::mat& xCentered)
   // Get the mean of the elements in each row.
   arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
 
-  xCentered = x - arma::repmat(rowMean, 1, x.n_cols);
+  xCentered = x;
+  xCentered.each_col() -= rowMean;
 }
 
 /**
- * Whitens a matrix using the singular value decomposition of the covariance
- * matrix. Whitening means the covariance matrix of the result is the identity
- * matrix.
+ * Centers the given matrix in place, by subtracting the mean of the columns
+ * from each column.
  */
-void mlpack::math::WhitenUsingSVD(const arma::mat& x,
-                                  arma::mat& xWhitened,
-                                  arma::mat& whiteningMatrix)
+void mlpack::math::CenterInPlace(arma::mat& x)
+{
+  // Get the mean of the elements in each row.
+  arma::vec rowMean = arma::sum(x, 1) / x.n_cols;
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) x.n_cols; ++i)
+    x.col(i) -= rowMean;
+}
+
+//! Compute the whitening matrix of x from the SVD of its covariance.
+static void SVDWhiteningMatrix(const arma::mat& x, arma::mat& whiteningMatrix)
 {
-  arma::mat covX, u, v, invSMatrix, temp1;
-  arma::vec sVector;
+  arma::mat covX, u, v, invSMatrix;
+  arma::vec sVector, mean;
 
-  covX = ccov(x);
+  // Streaming the covariance avoids a centered copy of x.
+  Covariance(x, mean, covX);
 
   svd(u, sVector, v, covX);
 
@@ -69,23 +79,18 @@ void mlpack::math::WhitenUsingSVD(const arma::mat& x,
   invSMatrix.diag() = 1 / sqrt(sVector);
 
   whiteningMatrix = v * invSMatrix * trans(u);
-
-  xWhitened = whiteningMatrix * x;
 }
 
-/**
- * Whitens a matrix using the eigendecomposition of the covariance matrix.
- * Whitening means the covariance matrix of the result is the identity matrix.
- */
-void mlpack::math::WhitenUsingEig(const arma::mat& x,
-                                  arma::mat& xWhitened,
-                                  arma::mat& whiteningMatrix)
+//! Compute the whitening matrix of x from the eigendecomposition of its
+//! covariance.
+static void EigWhiteningMatrix(const arma::mat& x, arma::mat& whiteningMatrix)
 {
-  arma::mat diag, eigenvectors;
-  arma::vec eigenvalues;
+  arma::mat covX, diag, eigenvectors;
+  arma::vec eigenvalues, mean;
 
   // Get eigenvectors of covariance of input matrix.
-  eig_sym(eigenvalues, eigenvectors, ccov(x));
+  Covariance(x, mean, covX);
+  eig_sym(eigenvalues, eigenvectors, covX);
 
   // Generate diagonal matrix using 1 / sqrt(eigenvalues) for each value.
   VectorPower(eigenvalues, -0.5);
@@ -94,11 +99,85 @@ void mlpack::math::WhitenUsingEig(const arma::mat& x,
 
   // Our whitening matrix is diag(1 / sqrt(eigenvectors)) * eigenvalues.
   whiteningMatrix = diag * trans(eigenvectors);
+}
+
+/**
+ * Whitens a matrix using the singular value decomposition of the covariance
+ * matrix. Whitening means the covariance matrix of the result is the identity
+ * matrix.
+ */
+void mlpack::math::WhitenUsingSVD(const arma::mat& x,
+                                  arma::mat& xWhitened,
+                                  arma::mat& whiteningMatrix)
+{
+  SVDWhiteningMatrix(x, whiteningMatrix);
+  xWhitened = whiteningMatrix * x;
+}
+
+/**
+ * Whitens a matrix in place using the singular value decomposition of the
+ * covariance matrix.
+ */
+void mlpack::math::WhitenUsingSVD(arma::mat& x, arma::mat& whiteningMatrix)
+{
+  SVDWhiteningMatrix(x, whiteningMatrix);
+  TransformInPlace(whiteningMatrix, x);
+}
+
+/**
+ * Whitens a matrix using the eigendecomposition of the covariance matrix.
+ * Whitening means the covariance matrix of the result is the identity matrix.
+ */
+void mlpack::math::WhitenUsingEig(const arma::mat& x,
+                                  arma::mat& xWhitened,
+                                  arma::mat& whiteningMatrix)
+{
+  EigWhiteningMatrix(x, whiteningMatrix);
 
   // Now apply the whitening matrix.
   xWhitened = whiteningMatrix * x;
 }
 
+/**
+ * Whitens a matrix in place using the eigendecomposition of the covariance
+ * matrix.
+ */
+void mlpack::math::WhitenUsingEig(arma::mat& x, arma::mat& whiteningMatrix)
+{
+  EigWhiteningMatrix(x, whiteningMatrix);
+  TransformInPlace(whiteningMatrix, x);
+}
+
+/**
+ * Multiplies a matrix in place by a square transformation, one block of
+ * columns at a time.
+ */
+void mlpack::math::TransformInPlace(const arma::mat& transformation,
+                                    arma::mat& x,
+                                    const size_t blockSize)
+{
+  if (transformation.n_rows != x.n_rows || transformation.n_cols != x.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "TransformInPlace(): transformation is " << transformation.n_rows
+        << "x" << transformation.n_cols << ", but the matrix has " << x.n_rows
+        << " rows";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t step = std::max((size_t) 1, blockSize);
+  const size_t numBlocks = (x.n_cols + step - 1) / step;
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * step;
+    const size_t end = std::min(begin + step, (size_t) x.n_cols) - 1;
+    const arma::mat block = transformation * x.cols(begin, end);
+    x.cols(begin, end) = block;
+  }
+}
+
 /**
  * Overwrites a dimension-N vector to a random vector on the unit sphere in R^N.
  */
@@ -125,34 +204,44 @@ void mlpack::math::RandVector(arma::vec& v)
   v /= sqrt(dot(v, v));
 }
 
-/**
- * Orthogonalize x and return the result in W, using eigendecomposition.
- * We will be using the formula \f$ W = x (x^T x)^{-0.5} \f$.
- */
-void mlpack::math::Orthogonalize(const arma::mat& x, arma::mat& W)
+//! Compute the matrix that orthogonalizes x.
+static void OrthogonalizationMatrix(const arma::mat& x, arma::mat& at)
 {
   // For a matrix A, A^N = V * D^N * V', where VDV' is the
   // eigendecomposition of the matrix A.
-  arma::mat eigenvalues, eigenvectors;
-  arma::vec egval;
-  eig_sym(egval, eigenvectors, ccov(x));
+  arma::mat eigenvalues, eigenvectors, covX;
+  arma::vec egval, mean;
+  Covariance(x, mean, covX);
+  eig_sym(egval, eigenvectors, covX);
   VectorPower(egval, -0.5);
 
   eigenvalues.zeros(egval.n_elem, egval.n_elem);
   eigenvalues.diag() = egval;
 
-  arma::mat at = (eigenvectors * eigenvalues * trans(eigenvectors));
+  at = (eigenvectors * eigenvalues * trans(eigenvectors));
+}
+
+/**
+ * Orthogonalize x and return the result in W, using eigendecomposition.
+ * We will be using the formula \f$ W = x (x^T x)^{-0.5} \f$.
+ */
+void mlpack::math::Orthogonalize(const arma::mat& x, arma::mat& W)
+{
+  arma::mat at;
+  OrthogonalizationMatrix(x, at);
 
   W = at * x;
 }
 
 /**
- * Orthogonalize x in-place.  This could be sped up by a custom
- * implementation.
+ * Orthogonalize x in-place, one block of columns at a time.
  */
 void mlpack::math::Orthogonalize(arma::mat& x)
 {
-  Orthogonalize(x, x);
+  arma::mat at;
+  OrthogonalizationMatrix(x, at);
+
+  TransformInPlace(at, x);
 }
 
 /**
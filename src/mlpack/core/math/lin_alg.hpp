@@ -13,6 +13,7 @@
 #define MLPACK_CORE_MATH_LIN_ALG_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "covariance.hpp"
 
 /**
  * Linear algebra utility functions, generally performed on matrices or vectors.
@@ -36,6 +37,15 @@ void VectorPower(arma::vec& vec, const double power);
  */
 void Center(const arma::mat& x, arma::mat& xCentered);
 
+/**
+ * Centers the given matrix in place, by subtracting the mean of the columns
+ * from each column.  Unlike Center(), this doesn't need a second matrix of the
+ * same size.
+ *
+ * @param x Matrix to center.
+ */
+void CenterInPlace(arma::mat& x);
+
 /**
  * Whitens a matrix using the singular value decomposition of the covariance
  * matrix. Whitening means the covariance matrix of the result is the identity
@@ -45,6 +55,17 @@ void WhitenUsingSVD(const arma::mat& x,
                     arma::mat& xWhitened,
                     arma::mat& whiteningMatrix);
 
+/**
+ * Whitens a matrix in place using the singular value decomposition of the
+ * covariance matrix.  The covariance is streamed (see math::Covariance()) and
+ * the whitening matrix is applied one block of columns at a time, so no other
+ * matrix of the size of x is needed.
+ *
+ * @param x Matrix to whiten.
+ * @param whiteningMatrix Matrix to store the whitening matrix in.
+ */
+void WhitenUsingSVD(arma::mat& x, arma::mat& whiteningMatrix);
+
 /**
  * Whitens a matrix using the eigendecomposition of the covariance matrix.
  * Whitening means the covariance matrix of the result is the identity matrix.
@@ -53,6 +74,28 @@ void WhitenUsingEig(const arma::mat& x,
                     arma::mat& xWhitened,
                     arma::mat& whiteningMatrix);
 
+/**
+ * Whitens a matrix in place using the eigendecomposition of the covariance
+ * matrix, like the in-place WhitenUsingSVD().
+ *
+ * @param x Matrix to whiten.
+ * @param whiteningMatrix Matrix to store the whitening matrix in.
+ */
+void WhitenUsingEig(arma::mat& x, arma::mat& whiteningMatrix);
+
+/**
+ * Multiplies a matrix in place by the given square transformation, one block of
+ * columns at a time, in parallel over the blocks.  Only a temporary matrix of
+ * the size of a block is needed per thread.
+ *
+ * @param transformation Square matrix to multiply x by.
+ * @param x Matrix to transform.
+ * @param blockSize Number of columns transformed at once.
+ */
+void TransformInPlace(const arma::mat& transformation,
+                      arma::mat& x,
+                      const size_t blockSize = 1024);
+
 /**
  * Overwrites a dimension-N vector to a random vector on the unit sphere in R^N.
  */
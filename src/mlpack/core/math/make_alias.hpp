@@ -42,6 +42,23 @@ arma::Mat<ElemType> MakeAlias(arma::Mat<ElemType>& input,
       strict);
 }
 
+/**
+ * Make an alias of the count contiguous columns of a dense matrix that start at
+ * column begin, instead of a copy as with input.cols().  The columns are not
+ * const in the alias, so it must only be used for reading.  If strict is true,
+ * then the alias cannot be resized or pointed at new memory.
+ */
+template<typename ElemType>
+arma::Mat<ElemType> MakeColsAlias(const arma::Mat<ElemType>& input,
+                                  const size_t begin,
+                                  const size_t count,
+                                  const bool strict = true)
+{
+  // Use the advanced constructor.
+  return arma::Mat<ElemType>(const_cast<ElemType*>(input.colptr(begin)),
+      input.n_rows, count, false, strict);
+}
+
 /**
  * Make an alias of a dense row.  If strict is true, then the alias cannot be
  * resized or pointed at new memory.
@@ -20,6 +20,10 @@ MLPACK_EXPORT std::mt19937 randGen;
 MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist(0.0, 1.0);
 // Global normal distribution.
 MLPACK_EXPORT std::normal_distribution<> randNormalDist(0.0, 1.0);
+// The seed given to the last call to RandomSeed().
+MLPACK_EXPORT size_t randSeed = 0;
+// The number of calls to RandomSeed().
+MLPACK_EXPORT size_t randSeedEpoch = 0;
 
 } // namespace math
 } // namespace mlpack
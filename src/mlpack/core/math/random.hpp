@@ -29,17 +29,164 @@ extern MLPACK_EXPORT std::mt19937 randGen;
 extern MLPACK_EXPORT std::uniform_real_distribution<> randUniformDist;
 // Global normal distribution.
 extern MLPACK_EXPORT std::normal_distribution<> randNormalDist;
+// The seed given to the last call to RandomSeed().
+extern MLPACK_EXPORT size_t randSeed;
+// The number of calls to RandomSeed(); thread generators are reseeded when it
+// changes.
+extern MLPACK_EXPORT size_t randSeedEpoch;
+
+/**
+ * The random state of a thread: a generator and the distributions that are
+ * used with it.  This is used by the random functions inside of parallel
+ * regions and RandomStreams; it should not be needed directly.
+ */
+struct RandomState
+{
+  RandomState() :
+      uniformDist(0.0, 1.0),
+      normalDist(0.0, 1.0),
+      epoch((size_t) -1),
+      streams(0)
+  { }
+
+  //! The generator.
+  std::mt19937 generator;
+  //! The uniform distribution on [0, 1).
+  std::uniform_real_distribution<> uniformDist;
+  //! The standard normal distribution.
+  std::normal_distribution<> normalDist;
+  //! The value of randSeedEpoch when the generator was seeded.
+  size_t epoch;
+  //! The number of active RandomStreams of the thread.
+  size_t streams;
+};
+
+/**
+ * Get the random state of the calling thread.
+ */
+inline RandomState& ThreadRandomState()
+{
+  static thread_local RandomState state;
+  return state;
+}
+
+/**
+ * Get the random state that the random functions should use on the calling
+ * thread, or NULL if they should use the global objects (randGen,
+ * randUniformDist and randNormalDist).
+ *
+ * Outside of parallel regions the global objects are used, so serial code sees
+ * the same sequence as before.  Inside of a parallel region each thread uses
+ * its own generator, so that no generator is shared between threads; the
+ * generator of a thread is seeded from the last seed given to RandomSeed() and
+ * the index of the thread.  Its values are therefore reproducible as long as
+ * the work is assigned to the threads in the same way (e.g. with a static
+ * schedule and the same number of threads).  For results that do not depend on
+ * the schedule, use a RandomStream for each unit of work.
+ */
+inline RandomState* CurrentRandomState()
+{
+  RandomState& state = ThreadRandomState();
+  if (state.streams > 0)
+    return &state;
+  if (!InParallel())
+    return NULL;
+
+  if (state.epoch != randSeedEpoch)
+  {
+    const uint64_t seed = randSeed;
+    const uint64_t thread = ThreadNum();
+    std::seed_seq sequence({ (uint32_t) seed, (uint32_t) (seed >> 32),
+        (uint32_t) thread, (uint32_t) (thread >> 32) });
+    state.generator.seed(sequence);
+    state.uniformDist.reset();
+    state.normalDist.reset();
+    state.epoch = randSeedEpoch;
+  }
+
+  return &state;
+}
+
+/**
+ * Get the generator that the random functions use on the calling thread:
+ * randGen outside of parallel regions, and the generator of the thread inside
+ * of them (see CurrentRandomState()).  This can be given to the distributions
+ * of the standard library from parallel code.
+ */
+inline std::mt19937& ThreadGenerator()
+{
+  RandomState* state = CurrentRandomState();
+  return (state == NULL) ? randGen : state->generator;
+}
+
+/**
+ * While a RandomStream exists, the random functions called by the thread that
+ * created it (Random(), RandInt(), RandNormal(), ThreadGenerator(), ...) use a
+ * generator seeded with the given seed, even outside of parallel regions.  When
+ * it is destroyed, the previous generator of the thread is restored.
+ *
+ * This makes a unit of work reproducible no matter which thread runs it: draw
+ * one seed per unit from randGen before the parallel region, and create a
+ * RandomStream with that seed at the start of the unit.
+ *
+ * @code
+ * std::vector<std::mt19937::result_type> seeds(numTrees);
+ * for (size_t i = 0; i < numTrees; ++i)
+ *   seeds[i] = math::randGen();
+ *
+ * #pragma omp parallel for schedule(dynamic)
+ * for (omp_size_t i = 0; i < (omp_size_t) numTrees; ++i)
+ * {
+ *   math::RandomStream stream(seeds[i]);
+ *   // ... math::RandInt() etc. only depend on seeds[i] here ...
+ * }
+ * @endcode
+ */
+class RandomStream
+{
+ public:
+  //! Make the calling thread use a generator seeded with the given seed.
+  RandomStream(const size_t seed)
+  {
+    RandomState& state = ThreadRandomState();
+    saved = state;
+
+    const uint64_t s = seed;
+    std::seed_seq sequence({ (uint32_t) s, (uint32_t) (s >> 32) });
+    state.generator.seed(sequence);
+    state.uniformDist.reset();
+    state.normalDist.reset();
+    ++state.streams;
+  }
+
+  //! Restore the previous generator of the thread.
+  ~RandomStream()
+  {
+    ThreadRandomState() = saved;
+  }
+
+ private:
+  // A stream is bound to its thread, so it may not be copied.
+  RandomStream(const RandomStream& other);
+  RandomStream& operator=(const RandomStream& other);
+
+  //! The random state of the thread before the stream was created.
+  RandomState saved;
+};
 
 /**
  * Set the random seed used by the random functions (Random() and RandInt()).
  * The seed is casted to a 32-bit integer before being given to the random
  * number generator, but a size_t is taken as a parameter for API consistency.
+ * The generators of the threads of parallel regions are reseeded from it too.
  *
  * @param seed Seed for the random number generator.
  */
 inline void RandomSeed(const size_t seed)
 {
   #if (!defined(BINDING_TYPE) || BINDING_TYPE != BINDING_TYPE_TEST)
+    randSeed = seed;
+    ++randSeedEpoch;
     randGen.seed((uint32_t) seed);
     srand((unsigned int) seed);
     arma::arma_rng::set_seed(seed);
@@ -59,6 +206,8 @@ inline void RandomSeed(const size_t seed)
 inline void FixedRandomSeed()
 {
   const static size_t seed = rand();
+  randSeed = seed;
+  ++randSeedEpoch;
   randGen.seed((uint32_t) seed);
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed);
@@ -70,7 +219,9 @@ inline void FixedRandomSeed()
  */
 inline double Random()
 {
-  return randUniformDist(randGen);
+  RandomState* state = CurrentRandomState();
+  return (state == NULL) ? randUniformDist(randGen) :
+      state->uniformDist(state->generator);
 }
 
 /**
@@ -78,7 +229,7 @@ inline double Random()
  */
 inline double Random(const double lo, const double hi)
 {
-  return lo + (hi - lo) * randUniformDist(randGen);
+  return lo + (hi - lo) * Random();
 }
 
 /**
@@ -97,7 +248,7 @@ inline double RandBernoulli(const double input)
  */
 inline int RandInt(const int hiExclusive)
 {
-  return (int) std::floor((double) hiExclusive * randUniformDist(randGen));
+  return (int) std::floor((double) hiExclusive * Random());
 }
 
 /**
@@ -105,8 +256,7 @@ inline int RandInt(const int hiExclusive)
  */
 inline int RandInt(const int lo, const int hiExclusive)
 {
-  return lo + (int) std::floor((double) (hiExclusive - lo)
-                               * randUniformDist(randGen));
+  return lo + (int) std::floor((double) (hiExclusive - lo) * Random());
 }
 
 /**
@@ -114,7 +264,9 @@ inline int RandInt(const int lo, const int hiExclusive)
  */
 inline double RandNormal()
 {
-  return randNormalDist(randGen);
+  RandomState* state = CurrentRandomState();
+  return (state == NULL) ? randNormalDist(randGen) :
+      state->normalDist(state->generator);
 }
 
 /**
@@ -126,22 +278,27 @@ inline double RandNormal()
  */
 inline double RandNormal(const double mean, const double variance)
 {
-  return variance * randNormalDist(randGen) + mean;
+  return variance * RandNormal() + mean;
 }
 
 /**
- * Obtains no more than maxNumSamples distinct samples. Each sample belongs to
- * [loInclusive, hiExclusive).
+ * Obtains no more than maxNumSamples distinct samples, using the given random
+ * number generator.  Each sample belongs to [loInclusive, hiExclusive).  This
+ * can be used with a separate generator in each thread, since the global random
+ * objects are not thread-safe.
  *
  * @param loInclusive The lower bound (inclusive).
  * @param hiExclusive The high bound (exclusive).
  * @param maxNumSamples The maximum number of samples to obtain.
  * @param distinctSamples The samples that will be obtained.
+ * @param generator The random number generator to use.
  */
+template<typename GeneratorType>
 inline void ObtainDistinctSamples(const size_t loInclusive,
                                   const size_t hiExclusive,
                                   const size_t maxNumSamples,
-                                  arma::uvec& distinctSamples)
+                                  arma::uvec& distinctSamples,
+                                  GeneratorType& generator)
 {
   const size_t samplesRangeSize = hiExclusive - loInclusive;
 
@@ -151,8 +308,9 @@ inline void ObtainDistinctSamples(const size_t loInclusive,
 
     samples.zeros(samplesRangeSize);
 
+    std::uniform_real_distribution<> uniformDist;
     for (size_t i = 0; i < maxNumSamples; i++)
-      samples [ (size_t) math::RandInt(samplesRangeSize) ]++;
+      samples[(size_t) std::floor(samplesRangeSize * uniformDist(generator))]++;
 
     distinctSamples = arma::find(samples > 0);
 
@@ -167,6 +325,97 @@ inline void ObtainDistinctSamples(const size_t loInclusive,
   }
 }
 
+/**
+ * Obtains no more than maxNumSamples distinct samples. Each sample belongs to
+ * [loInclusive, hiExclusive).
+ *
+ * @param loInclusive The lower bound (inclusive).
+ * @param hiExclusive The high bound (exclusive).
+ * @param maxNumSamples The maximum number of samples to obtain.
+ * @param distinctSamples The samples that will be obtained.
+ */
+inline void ObtainDistinctSamples(const size_t loInclusive,
+                                  const size_t hiExclusive,
+                                  const size_t maxNumSamples,
+                                  arma::uvec& distinctSamples)
+{
+  ObtainDistinctSamples(loInclusive, hiExclusive, maxNumSamples,
+      distinctSamples, ThreadGenerator());
+}
+
+/**
+ * Fill the given matrix (or vector) with uniform random numbers in [lo, hi).
+ * This is faster than calling Random() for each element: large matrices are
+ * filled in parallel, in blocks with their own generators, whose seeds are
+ * drawn from the generator of the calling thread.  The values only depend on
+ * that generator and on the size of the matrix, not on the number of threads.
+ *
+ * @param x Matrix to fill (it keeps its size).
+ * @param lo Lower bound of the values.
+ * @param hi Upper bound of the values (exclusive).
+ */
+template<typename MatType>
+inline void RandomFill(MatType& x, const double lo = 0.0, const double hi = 1.0)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  const size_t blockSize = 16384;
+  const size_t numBlocks = (x.n_elem + blockSize - 1) / blockSize;
+  std::vector<std::mt19937::result_type> seeds(numBlocks);
+  std::mt19937& generator = ThreadGenerator();
+  for (size_t b = 0; b < numBlocks; ++b)
+    seeds[b] = generator();
+
+  ElemType* values = x.memptr();
+  #pragma omp parallel for if (numBlocks > 1 && !InParallel())
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    std::mt19937 blockGenerator(seeds[b]);
+    std::uniform_real_distribution<> dist(lo, hi);
+    const size_t end = std::min((size_t) (b + 1) * blockSize,
+        (size_t) x.n_elem);
+    for (size_t i = b * blockSize; i < end; ++i)
+      values[i] = (ElemType) dist(blockGenerator);
+  }
+}
+
+/**
+ * Fill the given matrix (or vector) with normally distributed random numbers
+ * with the given mean and standard deviation.  Like RandomFill(), large
+ * matrices are filled in parallel, and the values do not depend on the number
+ * of threads.
+ *
+ * @param x Matrix to fill (it keeps its size).
+ * @param mean Mean of the values.
+ * @param stddev Standard deviation of the values.
+ */
+template<typename MatType>
+inline void RandNormalFill(MatType& x,
+                           const double mean = 0.0,
+                           const double stddev = 1.0)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  const size_t blockSize = 16384;
+  const size_t numBlocks = (x.n_elem + blockSize - 1) / blockSize;
+  std::vector<std::mt19937::result_type> seeds(numBlocks);
+  std::mt19937& generator = ThreadGenerator();
+  for (size_t b = 0; b < numBlocks; ++b)
+    seeds[b] = generator();
+
+  ElemType* values = x.memptr();
+  #pragma omp parallel for if (numBlocks > 1 && !InParallel())
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    std::mt19937 blockGenerator(seeds[b]);
+    std::normal_distribution<> dist(mean, stddev);
+    const size_t end = std::min((size_t) (b + 1) * blockSize,
+        (size_t) x.n_elem);
+    for (size_t i = b * blockSize; i < end; ++i)
+      values[i] = (ElemType) dist(blockGenerator);
+  }
+}
+
 } // namespace math
 } // namespace mlpack
 
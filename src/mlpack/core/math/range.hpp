@@ -57,6 +57,15 @@ class RangeType
    */
   inline RangeType(const T lo, const T hi);
 
+  /**
+   * Initialize to the same range as a range holding a different element type
+   * (for instance, to use distances computed in single precision).
+   *
+   * @param other Range to copy.
+   */
+  template<typename U>
+  inline RangeType(const RangeType<U>& other);
+
   //! Get the lower bound.
   inline T Lo() const { return lo; }
   //! Modify the lower bound.
@@ -17,6 +17,155 @@
 namespace mlpack {
 namespace math {
 
+/**
+ * Gather the given columns of a sparse matrix, in the given order.  The
+ * compressed columns of the result are built directly, so that unlike
+ * arma::SpMat batch insertion no coordinate list is built or sorted.
+ *
+ * @param matrix Matrix to gather the columns of.
+ * @param indices Indices of the columns to gather (may repeat).
+ */
+template<typename eT>
+arma::SpMat<eT> GatherColumns(const arma::SpMat<eT>& matrix,
+                              const arma::uvec& indices)
+{
+  // Count the nonzero elements of the gathered columns only, so that gathering
+  // a small batch of a large matrix is cheap.
+  arma::uvec colPtrs(indices.n_elem + 1);
+  colPtrs[0] = 0;
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    size_t count = 0;
+    for (typename arma::SpMat<eT>::const_iterator it =
+         matrix.begin_col(indices[i]); it != matrix.end_col(indices[i]); ++it)
+      ++count;
+    colPtrs[i + 1] = colPtrs[i] + count;
+  }
+
+  arma::uvec rowIndices(colPtrs[indices.n_elem]);
+  arma::Col<eT> values(colPtrs[indices.n_elem]);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    size_t k = colPtrs[i];
+    for (typename arma::SpMat<eT>::const_iterator it =
+         matrix.begin_col(indices[i]); it != matrix.end_col(indices[i]);
+         ++it, ++k)
+    {
+      rowIndices[k] = it.row();
+      values[k] = (*it);
+    }
+  }
+
+  return arma::SpMat<eT>(rowIndices, colPtrs, values, matrix.n_rows,
+      indices.n_elem);
+}
+
+/**
+ * Gather the given columns of a dense matrix, in the given order.
+ *
+ * @param matrix Matrix to gather the columns of.
+ * @param indices Indices of the columns to gather (may repeat).
+ */
+template<typename eT>
+arma::Mat<eT> GatherColumns(const arma::Mat<eT>& matrix,
+                            const arma::uvec& indices)
+{
+  return matrix.cols(indices);
+}
+
+/**
+ * Reorder the columns of a dense matrix in place, so that column i becomes the
+ * old column ordering[i].  The permutation is applied by following its cycles,
+ * so only one column and one bit per column are used as temporary storage.
+ *
+ * @param matrix Matrix to reorder.
+ * @param ordering The permutation of the columns.
+ */
+template<typename eT>
+void PermuteColumns(arma::Mat<eT>& matrix, const arma::uvec& ordering)
+{
+  const size_t rows = matrix.n_rows;
+  std::vector<bool> done(matrix.n_cols, false);
+  arma::Col<eT> first(rows);
+  for (size_t start = 0; start < matrix.n_cols; ++start)
+  {
+    if (done[start])
+      continue;
+
+    // Shift the columns of the cycle of start, which ends by moving start.
+    std::copy(matrix.colptr(start), matrix.colptr(start) + rows,
+        first.memptr());
+    size_t i = start;
+    while (ordering[i] != start)
+    {
+      std::copy(matrix.colptr(ordering[i]), matrix.colptr(ordering[i]) + rows,
+          matrix.colptr(i));
+      done[i] = true;
+      i = ordering[i];
+    }
+
+    std::copy(first.memptr(), first.memptr() + rows, matrix.colptr(i));
+    done[i] = true;
+  }
+}
+
+/**
+ * Reorder the columns of a sparse matrix, so that column i becomes the old
+ * column ordering[i].  The columns of a sparse matrix have different lengths,
+ * so the matrix is rebuilt with GatherColumns().
+ *
+ * @param matrix Matrix to reorder.
+ * @param ordering The permutation of the columns.
+ */
+template<typename eT>
+void PermuteColumns(arma::SpMat<eT>& matrix, const arma::uvec& ordering)
+{
+  matrix = GatherColumns(matrix, ordering);
+}
+
+/**
+ * Shuffle a dataset and associated labels (or responses) in place.  It is
+ * expected that points and labels have the same number of columns (so, be sure
+ * that labels, if it is a vector, is a row vector).  Dense matrices are
+ * permuted without a copy (see PermuteColumns()), so this should be preferred
+ * to ShuffleData() when the input and the output are the same objects.
+ *
+ * @param points Dataset to shuffle.
+ * @param labels Labels (or responses) to shuffle along with the dataset.
+ */
+template<typename MatType, typename LabelsType>
+void ShuffleDataInPlace(MatType& points, LabelsType& labels)
+{
+  const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+      points.n_cols - 1, points.n_cols));
+
+  PermuteColumns(points, ordering);
+  PermuteColumns(labels, ordering);
+}
+
+/**
+ * Shuffle a dataset and associated labels (or responses) and weights in place.
+ * It is expected that points, labels and weights have the same number of
+ * columns (so, be sure that labels and weights, if they are vectors, are row
+ * vectors).
+ *
+ * @param points Dataset to shuffle.
+ * @param labels Labels (or responses) to shuffle along with the dataset.
+ * @param weights Weights to shuffle along with the dataset.
+ */
+template<typename MatType, typename LabelsType, typename WeightsType>
+void ShuffleDataInPlace(MatType& points,
+                        LabelsType& labels,
+                        WeightsType& weights)
+{
+  const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+      points.n_cols - 1, points.n_cols));
+
+  PermuteColumns(points, ordering);
+  PermuteColumns(labels, ordering);
+  PermuteColumns(weights, ordering);
+}
+
 /**
  * Shuffle a dataset and associated labels (or responses).  It is expected that
  * inputPoints and inputLabels have the same number of columns (so, be sure that
@@ -59,37 +208,8 @@ void ShuffleData(const MatType& inputPoints,
   arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
       inputPoints.n_cols - 1, inputPoints.n_cols));
 
-  // Extract coordinate list representation.
-  arma::umat locations(2, inputPoints.n_nonzero);
-  arma::Col<typename MatType::elem_type> values(inputPoints.n_nonzero);
-  typename MatType::const_iterator it = inputPoints.begin();
-  size_t index = 0;
-  while (it != inputPoints.end())
-  {
-    locations(0, index) = it.row();
-    locations(1, index) = ordering[it.col()];
-    values(index) = (*it);
-    ++it;
-    ++index;
-  }
-
-  if (&inputPoints == &outputPoints || &inputLabels == &outputLabels)
-  {
-    MatType newOutputPoints(locations, values, inputPoints.n_rows,
-        inputPoints.n_cols, true);
-    LabelsType newOutputLabels(inputLabels.n_elem);
-    newOutputLabels.cols(ordering) = inputLabels;
-
-    outputPoints = std::move(newOutputPoints);
-    outputLabels = std::move(newOutputLabels);
-  }
-  else
-  {
-    outputPoints = MatType(locations, values, inputPoints.n_rows,
-        inputPoints.n_cols, true);
-    outputLabels.set_size(inputLabels.n_elem);
-    outputLabels.cols(ordering) = inputLabels;
-  }
+  outputLabels = inputLabels.cols(ordering);
+  outputPoints = GatherColumns(inputPoints, ordering);
 }
 
 /**
@@ -198,43 +318,9 @@ void ShuffleData(const MatType& inputPoints,
   arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
       inputPoints.n_cols - 1, inputPoints.n_cols));
 
-  // Extract coordinate list representation.
-  arma::umat locations(2, inputPoints.n_nonzero);
-  arma::Col<typename MatType::elem_type> values(inputPoints.n_nonzero);
-  typename MatType::const_iterator it = inputPoints.begin();
-  size_t index = 0;
-  while (it != inputPoints.end())
-  {
-    locations(0, index) = it.row();
-    locations(1, index) = ordering[it.col()];
-    values(index) = (*it);
-    ++it;
-    ++index;
-  }
-
-  if (&inputPoints == &outputPoints || &inputLabels == &outputLabels ||
-      &inputWeights == &outputWeights)
-  {
-    MatType newOutputPoints(locations, values, inputPoints.n_rows,
-        inputPoints.n_cols, true);
-    LabelsType newOutputLabels(inputLabels.n_elem);
-    WeightsType newOutputWeights(inputWeights.n_elem);
-    newOutputLabels.cols(ordering) = inputLabels;
-    newOutputWeights.cols(ordering) = inputWeights;
-
-    outputPoints = std::move(newOutputPoints);
-    outputLabels = std::move(newOutputLabels);
-    outputWeights = std::move(newOutputWeights);
-  }
-  else
-  {
-    outputPoints = MatType(locations, values, inputPoints.n_rows,
-        inputPoints.n_cols, true);
-    outputLabels.set_size(inputLabels.n_elem);
-    outputLabels.cols(ordering) = inputLabels;
-    outputWeights.set_size(inputWeights.n_elem);
-    outputWeights.cols(ordering) = inputWeights;
-  }
+  outputLabels = inputLabels.cols(ordering);
+  outputWeights = inputWeights.cols(ordering);
+  outputPoints = GatherColumns(inputPoints, ordering);
 }
 
 } // namespace math
@@ -54,6 +54,65 @@ typename VecTypeA::elem_type LMetric<1, false>::Evaluate(
   return arma::accu(abs(a - b));
 }
 
+/**
+ * Compute the squared L2 distance between two dense vectors with a
+ * compile-time number of dimensions, so that the loop can be unrolled and no
+ * Armadillo expression has to be evaluated.
+ */
+template<size_t Dim, typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type FixedDimSquaredL2Distance(
+    const VecTypeA& a,
+    const VecTypeB& b)
+{
+  typename VecTypeA::elem_type sum = 0;
+  for (size_t i = 0; i < Dim; i++)
+  {
+    const typename VecTypeA::elem_type diff = a[i] - b[i];
+    sum += diff * diff;
+  }
+
+  return sum;
+}
+
+/**
+ * Compute the squared L2 distance between two dense vectors.  Two- and
+ * three-dimensional points are by far the most common low-dimensional case,
+ * and for them the overhead of arma::accu(arma::square(a - b)) dominates, so
+ * they are handled with FixedDimSquaredL2Distance().
+ */
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type SquaredL2Distance(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if_t<
+        IsVector<VecTypeA>::value && IsVector<VecTypeB>::value &&
+        !arma::is_arma_sparse_type<VecTypeA>::value &&
+        !arma::is_arma_sparse_type<VecTypeB>::value>* = 0)
+{
+  switch (a.n_elem)
+  {
+    case 2:
+      return FixedDimSquaredL2Distance<2>(a, b);
+    case 3:
+      return FixedDimSquaredL2Distance<3>(a, b);
+    default:
+      return arma::accu(arma::square(a - b));
+  }
+}
+
+//! Compute the squared L2 distance between two sparse vectors or expressions.
+template<typename VecTypeA, typename VecTypeB>
+inline typename VecTypeA::elem_type SquaredL2Distance(
+    const VecTypeA& a,
+    const VecTypeB& b,
+    const typename std::enable_if_t<
+        !IsVector<VecTypeA>::value || !IsVector<VecTypeB>::value ||
+        arma::is_arma_sparse_type<VecTypeA>::value ||
+        arma::is_arma_sparse_type<VecTypeB>::value>* = 0)
+{
+  return arma::accu(arma::square(a - b));
+}
+
 // L2-metric specializations.
 template<>
 template<typename VecTypeA, typename VecTypeB>
@@ -61,7 +120,7 @@ typename VecTypeA::elem_type LMetric<2, true>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return sqrt(arma::accu(square(a - b)));
+  return sqrt(SquaredL2Distance(a, b));
 }
 
 template<>
@@ -70,7 +129,7 @@ typename VecTypeA::elem_type LMetric<2, false>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  return accu(arma::square(a - b));
+  return SquaredL2Distance(a, b);
 }
 
 // L3-metric specialization (not very likely to be used, but just in case).
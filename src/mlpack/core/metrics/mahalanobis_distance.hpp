@@ -37,10 +37,25 @@ namespace metric {
  *
  * If you wish to use the KNN class or other tree-based algorithms with this
  * distance, it is recommended to instead stretch the dataset first, by
- * decomposing Q = L^T L (perhaps via a Cholesky decomposition), and then
- * multiply the data by L.  If you still wish to use the KNN class with a custom
- * distance anyway, you will need to use a different tree type than the default
- * KDTree, which only works with the LMetric class.
+ * decomposing Q = L^T L, and then multiply the data by L; Transformation()
+ * computes L, and Transform() stretches a dataset.  The Mahalanobis distance
+ * between two points is then the Euclidean distance between the stretched
+ * points, so the default KDTree and EuclideanDistance can be used, and each
+ * distance evaluation takes O(d) time instead of O(d^2):
+ *
+ * @code
+ * MahalanobisDistance<> md(covariance);
+ * arma::mat stretchedReference, stretchedQuery;
+ * md.Transform(referenceSet, stretchedReference);
+ * md.Transform(querySet, stretchedQuery);
+ *
+ * neighbor::KNN knn(std::move(stretchedReference));
+ * knn.Search(stretchedQuery, k, neighbors, distances);
+ * @endcode
+ *
+ * If you still wish to use the KNN class with a custom distance anyway, you
+ * will need to use a different tree type than the default KDTree, which only
+ * works with the LMetric class.
  *
  * Similar to the LMetric class, this offers a template parameter TakeRoot
  * which, when set to false, will instead evaluate the distance
@@ -96,6 +111,28 @@ class MahalanobisDistance
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Compute the matrix L such that the covariance matrix is Q = L^T L, so that
+   * the distance between a and b is the Euclidean distance between L a and
+   * L b.  L is the Cholesky factor of Q if Q is positive definite; otherwise,
+   * it is obtained from the eigendecomposition of Q, and negative eigenvalues
+   * (which can only come from rounding) are taken to be zero.
+   *
+   * @param transformation Matrix to store L in.
+   */
+  void Transformation(arma::mat& transformation) const;
+
+  /**
+   * Stretch the given dataset by L, where Q = L^T L, so that the Euclidean
+   * distance between two stretched points is the Mahalanobis distance between
+   * the original points.  L is only computed once for the whole dataset.
+   *
+   * @param data Dataset to stretch, with one point per column.
+   * @param transformedData Matrix to store the stretched dataset in.
+   */
+  template<typename MatType>
+  void Transform(const MatType& data, arma::mat& transformedData) const;
+
   /**
    * Access the covariance matrix.
    *
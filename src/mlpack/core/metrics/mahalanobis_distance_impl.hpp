@@ -47,6 +47,35 @@ double MahalanobisDistance<true>::Evaluate(const VecTypeA& a,
   return sqrt(out[0]);
 }
 
+template<bool TakeRoot>
+void MahalanobisDistance<TakeRoot>::Transformation(
+    arma::mat& transformation) const
+{
+  // The Cholesky factor is upper triangular with Q = L^T L, but it only exists
+  // if Q is positive definite.
+  if (arma::chol(transformation, covariance))
+    return;
+
+  // Otherwise, Q = V diag(lambda) V^T, so L = diag(sqrt(lambda)) V^T.
+  arma::vec eigval;
+  arma::mat eigvec;
+  arma::eig_sym(eigval, eigvec, covariance);
+
+  transformation = eigvec.t();
+  transformation.each_col() %= arma::sqrt(arma::clamp(eigval, 0.0, DBL_MAX));
+}
+
+template<bool TakeRoot>
+template<typename MatType>
+void MahalanobisDistance<TakeRoot>::Transform(const MatType& data,
+                                              arma::mat& transformedData) const
+{
+  arma::mat transformation;
+  Transformation(transformation);
+
+  transformedData = transformation * data;
+}
+
 // Serialize the Mahalanobis distance.
 template<bool TakeRoot>
 template<typename Archive>
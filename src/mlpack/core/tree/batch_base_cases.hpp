@@ -0,0 +1,184 @@
+/**
+ * @file batch_base_cases.hpp
+ *
+ * Utilities for rules that can evaluate the base cases between a set of query
+ * points and a contiguous range of reference points at once.  At leaf-leaf
+ * combinations, a dual-tree traverser can then hand the whole block of base
+ * cases to the rules instead of calling BaseCase() once per pair.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BATCH_BASE_CASES_HPP
+#define MLPACK_CORE_TREE_BATCH_BASE_CASES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace tree {
+
+HAS_MEM_FUNC(BatchBaseCases, HasBatchBaseCasesCheck);
+
+/**
+ * 'value' is true if the RuleType class has a member
+ * BatchBaseCases(const std::vector<size_t>& queryIndices,
+ *                const size_t referenceBegin,
+ *                const size_t referenceCount),
+ * which performs the base cases between each of the given query points and
+ * each reference point in [referenceBegin, referenceBegin + referenceCount).
+ */
+template<typename RuleType>
+struct HasBatchBaseCases
+{
+  static const bool value = HasBatchBaseCasesCheck<RuleType,
+      void(RuleType::*)(const std::vector<size_t>&,
+                        const size_t,
+                        const size_t)>::value;
+};
+
+/**
+ * BatchDistanceTraits describes whether blocks of distances for a metric can be
+ * computed with BatchDistances().  This is only the case for the Euclidean and
+ * squared Euclidean distances.
+ */
+template<typename MetricType>
+struct BatchDistanceTraits
+{
+  //! Whether BatchDistances() can be used with this metric.
+  static const bool IsSupported = false;
+  //! Whether the square root of the squared Euclidean distance is taken.
+  static const bool TakeRoot = false;
+};
+
+template<bool TTakeRoot>
+struct BatchDistanceTraits<metric::LMetric<2, TTakeRoot>>
+{
+  static const bool IsSupported = true;
+  static const bool TakeRoot = TTakeRoot;
+};
+
+/**
+ * 'value' is true if BatchDistances() can be used with the given metric and
+ * matrix type.  Sparse matrices are not supported.
+ */
+template<typename MetricType, typename MatType>
+struct SupportsBatchDistances
+{
+  static const bool value = BatchDistanceTraits<MetricType>::IsSupported &&
+      !arma::is_arma_sparse_type<MatType>::value;
+};
+
+/**
+ * Compute the squared norms of the points in [begin, begin + count), for use
+ * with BatchDistances().  If batched distances are not supported for this
+ * metric and matrix type, or if the dimensionality is so small that evaluating
+ * the metric point by point is faster, norms is left empty instead.
+ *
+ * @param data Dataset.
+ * @param begin Index of the first point.
+ * @param count Number of points.
+ * @param norms Vector to store the squared norms in.
+ */
+template<typename MetricType, typename MatType>
+void BatchNorms(const MatType& data,
+                const size_t begin,
+                const size_t count,
+                arma::Col<typename MatType::elem_type>& norms,
+                const typename std::enable_if_t<
+                    SupportsBatchDistances<MetricType, MatType>::value>* = 0)
+{
+  if (data.n_rows > 16 && count > 0)
+    norms = arma::sum(arma::square(data.cols(begin, begin + count - 1)), 0).t();
+  else
+    norms.reset();
+}
+
+template<typename MetricType, typename MatType>
+void BatchNorms(const MatType& /* data */,
+                const size_t /* begin */,
+                const size_t /* count */,
+                arma::Col<typename MatType::elem_type>& norms,
+                const typename std::enable_if_t<
+                    !SupportsBatchDistances<MetricType, MatType>::value>* = 0)
+{
+  norms.reset();
+}
+
+/**
+ * Compute the distances between each of the given query points and each of the
+ * reference points in [referenceBegin, referenceBegin + referenceCount), using
+ * the expansion ||q - r||^2 = ||q||^2 + ||r||^2 - 2 q^T r.  Almost all of the
+ * work is then a single matrix multiplication.  The squared norms of the query
+ * and reference points, as given by BatchNorms(), must be given (in the same
+ * order as the points).
+ *
+ * @param querySet Set of query points.
+ * @param queryIndices Indices of the query points to use.
+ * @param queryNorms Squared norms of the query points to use.
+ * @param referenceSet Set of reference points.
+ * @param referenceBegin Index of the first reference point to use.
+ * @param referenceCount Number of reference points to use.
+ * @param referenceNorms Squared norms of the reference points to use.
+ * @param distances Matrix to store the distances in; element (i, j) will be
+ *     the distance between query point queryIndices[i] and reference point
+ *     referenceBegin + j.
+ */
+template<typename MetricType,
+         typename MatType,
+         typename QueryNormsType,
+         typename ReferenceNormsType>
+void BatchDistances(const MatType& querySet,
+                    const arma::uvec& queryIndices,
+                    const QueryNormsType& queryNorms,
+                    const MatType& referenceSet,
+                    const size_t referenceBegin,
+                    const size_t referenceCount,
+                    const ReferenceNormsType& referenceNorms,
+                    arma::Mat<typename MatType::elem_type>& distances,
+                    const typename std::enable_if_t<
+                        SupportsBatchDistances<MetricType, MatType>::value>* =
+                        0)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  distances = -2 * querySet.cols(queryIndices).t() *
+      referenceSet.cols(referenceBegin, referenceBegin + referenceCount - 1);
+  distances.each_col() += queryNorms;
+  distances.each_row() += referenceNorms.t();
+
+  // Rounding errors can make the distances between close points negative.
+  distances = arma::clamp(distances, ElemType(0),
+      std::numeric_limits<ElemType>::max());
+  if (BatchDistanceTraits<MetricType>::TakeRoot)
+    distances = arma::sqrt(distances);
+}
+
+//! BatchDistances() is never called if it is not supported, since BatchNorms()
+//! leaves the norms empty; this overload only exists so that callers compile.
+template<typename MetricType,
+         typename MatType,
+         typename QueryNormsType,
+         typename ReferenceNormsType>
+void BatchDistances(const MatType& /* querySet */,
+                    const arma::uvec& /* queryIndices */,
+                    const QueryNormsType& /* queryNorms */,
+                    const MatType& /* referenceSet */,
+                    const size_t /* referenceBegin */,
+                    const size_t /* referenceCount */,
+                    const ReferenceNormsType& /* referenceNorms */,
+                    arma::Mat<typename MatType::elem_type>& distances,
+                    const typename std::enable_if_t<
+                        !SupportsBatchDistances<MetricType, MatType>::value>* =
+                        0)
+{
+  distances.reset();
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file best_first_single_tree_traverser.hpp
+ *
+ * A single-tree traverser that visits the nodes of the reference tree in order
+ * of their score, with a priority queue, and can stop after a given number of
+ * leaves or base cases.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <unordered_set>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A best-first single-tree traverser.  The scored nodes of the reference tree
+ * are kept in a priority queue, and the node with the best (lowest) score is
+ * always visited next; nodes are rescored when they are taken from the queue.
+ * Without a budget the traversal is exact, like the depth-first traversers.
+ *
+ * With a budget, the traversal stops once it has visited the given number of
+ * leaves or computed the given number of base cases, which bounds the work
+ * done for each query point: since the most promising nodes are visited first,
+ * the results are usually good even when the traversal stops early.  The
+ * traversal never stops before MinBaseCases() base cases (for instance k, for
+ * k-nearest-neighbor search) have been computed.
+ *
+ * The traverser works with any tree type.  If the tree can hold a point in
+ * several nodes (as a spill tree does), each point is only used once for each
+ * query point.
+ *
+ * @tparam TreeType Type of the reference tree.
+ * @tparam RuleType Type of the rules; must implement BaseCase(), Score() and
+ *     Rescore().
+ */
+template<typename TreeType, typename RuleType>
+class BestFirstSingleTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the best-first single-tree traverser with the given rule set.
+   * There is no budget by default.
+   */
+  BestFirstSingleTreeTraverser(RuleType& rule);
+
+  /**
+   * Traverse the tree with the given point.
+   *
+   * @param queryIndex The index of the point in the query set which is being
+   *     used as the query point.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const size_t queryIndex, TreeType& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Get the number of traversals that stopped because of the budget.
+  size_t NumStopped() const { return numStopped; }
+
+  //! Get the maximum number of leaves visited for each query point (0 means no
+  //! limit).
+  size_t MaxLeaves() const { return maxLeaves; }
+  //! Modify the maximum number of leaves visited for each query point (0 means
+  //! no limit).
+  size_t& MaxLeaves() { return maxLeaves; }
+
+  //! Get the maximum number of base cases for each query point (0 means no
+  //! limit).
+  size_t MaxBaseCases() const { return maxBaseCases; }
+  //! Modify the maximum number of base cases for each query point (0 means no
+  //! limit).
+  size_t& MaxBaseCases() { return maxBaseCases; }
+
+  //! Get the number of base cases computed before the budget applies.
+  size_t MinBaseCases() const { return minBaseCases; }
+  //! Modify the number of base cases computed before the budget applies.
+  size_t& MinBaseCases() { return minBaseCases; }
+
+ private:
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+  //! The number of traversals that stopped because of the budget.
+  size_t numStopped;
+
+  //! The maximum number of leaves visited for each query point.
+  size_t maxLeaves;
+  //! The maximum number of base cases for each query point.
+  size_t maxBaseCases;
+  //! The number of base cases computed before the budget applies.
+  size_t minBaseCases;
+
+  //! Return whether the budget is spent after the given leaves and base cases.
+  bool BudgetSpent(const size_t leaves, const size_t baseCases) const
+  {
+    return (baseCases >= minBaseCases) &&
+        ((maxLeaves > 0 && leaves >= maxLeaves) ||
+         (maxBaseCases > 0 && baseCases >= maxBaseCases));
+  }
+
+  /**
+   * Compute the base case of the query point with the given point, unless the
+   * point was already used.  Return false if the budget of base cases is
+   * spent.
+   */
+  bool PointBaseCase(const size_t queryIndex,
+                     const size_t point,
+                     std::unordered_set<size_t>& usedPoints,
+                     size_t& baseCases);
+
+  //! An entry of the priority queue: a node and its score.
+  typedef std::pair<double, TreeType*> QueueEntry;
+
+  //! Put the entry with the lowest score at the top of the priority queue.
+  struct QueueComparator
+  {
+    bool operator()(const QueueEntry& a, const QueueEntry& b) const
+    {
+      return a.first > b.first;
+    }
+  };
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "best_first_single_tree_traverser_impl.hpp"
+
+#endif
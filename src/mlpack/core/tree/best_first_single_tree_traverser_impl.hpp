@@ -0,0 +1,133 @@
+/**
+ * @file best_first_single_tree_traverser_impl.hpp
+ *
+ * Implementation of the best-first single-tree traverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "best_first_single_tree_traverser.hpp"
+
+#include <queue>
+#include "tree_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename TreeType, typename RuleType>
+BestFirstSingleTreeTraverser<TreeType, RuleType>::BestFirstSingleTreeTraverser(
+    RuleType& rule) :
+    rule(rule),
+    numPrunes(0),
+    numStopped(0),
+    maxLeaves(0),
+    maxBaseCases(0),
+    minBaseCases(0)
+{ /* Nothing to do. */ }
+
+template<typename TreeType, typename RuleType>
+void BestFirstSingleTreeTraverser<TreeType, RuleType>::Traverse(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  // If the first point of a node is its centroid, the rules usually compute
+  // its base case when the node is scored, so we compute it (again) right
+  // after the score, while the rules still have it cached.
+  const bool centroidFirst = TreeTraits<TreeType>::FirstPointIsCentroid;
+
+  // The points that were already used, if a point can be in several nodes.
+  std::unordered_set<size_t> usedPoints;
+  size_t leaves = 0;
+  size_t baseCases = 0;
+
+  const double rootScore = rule.Score(queryIndex, referenceNode);
+  if (rootScore == DBL_MAX)
+  {
+    ++numPrunes;
+    return;
+  }
+  if (centroidFirst)
+    PointBaseCase(queryIndex, referenceNode.Point(0), usedPoints, baseCases);
+
+  std::priority_queue<QueueEntry, std::vector<QueueEntry>, QueueComparator>
+      queue;
+  queue.push(QueueEntry(rootScore, &referenceNode));
+
+  while (!queue.empty())
+  {
+    if (BudgetSpent(leaves, baseCases))
+    {
+      ++numStopped;
+      return;
+    }
+
+    TreeType* node = queue.top().second;
+    const double score = queue.top().first;
+    queue.pop();
+
+    // The bound may have improved since the node was scored.
+    if (rule.Rescore(queryIndex, *node, score) == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    // Run the base cases of the points held in the node, stopping in the
+    // middle of the node if the budget of base cases is spent.
+    for (size_t i = (centroidFirst ? 1 : 0); i < node->NumPoints(); ++i)
+      if (!PointBaseCase(queryIndex, node->Point(i), usedPoints, baseCases))
+        break;
+
+    if (node->IsLeaf())
+    {
+      ++leaves;
+      continue;
+    }
+
+    // Score the children, and queue those that can't be pruned.
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+    {
+      TreeType& child = node->Child(i);
+      const double childScore = rule.Score(queryIndex, child);
+      if (childScore == DBL_MAX)
+      {
+        ++numPrunes;
+        continue;
+      }
+
+      if (centroidFirst)
+        PointBaseCase(queryIndex, child.Point(0), usedPoints, baseCases);
+      queue.push(QueueEntry(childScore, &child));
+    }
+  }
+}
+
+template<typename TreeType, typename RuleType>
+bool BestFirstSingleTreeTraverser<TreeType, RuleType>::PointBaseCase(
+    const size_t queryIndex,
+    const size_t point,
+    std::unordered_set<size_t>& usedPoints,
+    size_t& baseCases)
+{
+  if (maxBaseCases > 0 && baseCases >= std::max(maxBaseCases, minBaseCases))
+    return false;
+
+  if (TreeTraits<TreeType>::HasDuplicatedPoints &&
+      !usedPoints.insert(point).second)
+    return true;
+
+  rule.BaseCase(queryIndex, point);
+  ++baseCases;
+  return true;
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -23,6 +23,8 @@
 #include "binary_space_tree/binary_space_tree.hpp"
 #include "binary_space_tree/single_tree_traverser.hpp"
 #include "binary_space_tree/single_tree_traverser_impl.hpp"
+#include "binary_space_tree/block_single_tree_traverser.hpp"
+#include "binary_space_tree/block_single_tree_traverser_impl.hpp"
 #include "binary_space_tree/dual_tree_traverser.hpp"
 #include "binary_space_tree/dual_tree_traverser_impl.hpp"
 #include "binary_space_tree/breadth_first_dual_tree_traverser.hpp"
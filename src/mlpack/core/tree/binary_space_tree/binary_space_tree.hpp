@@ -19,6 +19,26 @@
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
 
+/**
+ * Get the type of the bound held by each node of a BinarySpaceTree, so that
+ * the bound uses the same element type as the data.  Most bounds take the
+ * element type as their second template parameter; BallBound takes the vector
+ * type instead.
+ */
+template<template<typename BoundMetricType, typename...> class BoundType,
+         typename MetricType,
+         typename ElemType>
+struct BinarySpaceTreeBound
+{
+  typedef BoundType<MetricType, ElemType> Type;
+};
+
+template<typename MetricType, typename ElemType>
+struct BinarySpaceTreeBound<bound::BallBound, MetricType, ElemType>
+{
+  typedef bound::BallBound<MetricType, arma::Col<ElemType>> Type;
+};
+
 /**
  * A binary space partitioning tree, such as a KD-tree or a ball tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -59,7 +79,11 @@ class BinarySpaceTree
   //! The type of element held in MatType.
   typedef typename MatType::elem_type ElemType;
 
-  typedef SplitType<BoundType<MetricType>, MatType> Split;
+  //! The bound type of each node, holding elements of type ElemType.
+  typedef typename BinarySpaceTreeBound<BoundType, MetricType, ElemType>::Type
+      TreeBoundType;
+
+  typedef SplitType<TreeBoundType, MatType> Split;
 
  private:
   //! The left child node.
@@ -75,7 +99,7 @@ class BinarySpaceTree
   //! children).
   size_t count;
   //! The bound object for this node.
-  BoundType<MetricType> bound;
+  TreeBoundType bound;
   //! Any extra data contained in the node.
   StatisticType stat;
   //! The distance from the centroid of this node to the centroid of the parent.
@@ -89,12 +113,33 @@ class BinarySpaceTree
   //! delete it.
   MatType* dataset;
 
+  //! A block of memory holding nodes of the tree.
+  struct NodeBlock
+  {
+    //! The nodes held in the block.
+    BinarySpaceTree* nodes;
+    //! The number of nodes constructed in the block.
+    size_t size;
+    //! The number of nodes the block can hold.
+    size_t capacity;
+  };
+
+  //! If this is the root, the blocks holding all of its descendant nodes.
+  //! This is empty if the descendants were allocated one by one (for instance
+  //! when the tree was copied).
+  std::vector<NodeBlock> nodeBlocks;
+
  public:
   //! A single-tree traverser for binary space trees; see
   //! single_tree_traverser.hpp for implementation.
   template<typename RuleType>
   class SingleTreeTraverser;
 
+  //! A single-tree traverser that traverses the tree once for a block of query
+  //! points; see block_single_tree_traverser.hpp.
+  template<typename RuleType>
+  class BlockSingleTreeTraverser;
+
   //! A dual-tree traverser for binary space trees; see dual_tree_traverser.hpp.
   template<typename RuleType>
   class DualTreeTraverser;
@@ -211,7 +256,7 @@ class BinarySpaceTree
   BinarySpaceTree(BinarySpaceTree* parent,
                   const size_t begin,
                   const size_t count,
-                  SplitType<BoundType<MetricType>, MatType>& splitter,
+                  Split& splitter,
                   const size_t maxLeafSize = 20);
 
   /**
@@ -237,7 +282,7 @@ class BinarySpaceTree
                   const size_t begin,
                   const size_t count,
                   std::vector<size_t>& oldFromNew,
-                  SplitType<BoundType<MetricType>, MatType>& splitter,
+                  Split& splitter,
                   const size_t maxLeafSize = 20);
 
   /**
@@ -266,7 +311,7 @@ class BinarySpaceTree
                   const size_t count,
                   std::vector<size_t>& oldFromNew,
                   std::vector<size_t>& newFromOld,
-                  SplitType<BoundType<MetricType>, MatType>& splitter,
+                  Split& splitter,
                   const size_t maxLeafSize = 20);
 
   /**
@@ -277,6 +322,23 @@ class BinarySpaceTree
    */
   BinarySpaceTree(const BinarySpaceTree& other);
 
+  /**
+   * Create a binary space tree with the same structure as the given tree, which
+   * holds another type of statistic.  No node is split: the bounds and the
+   * order of the points are copied, and only the statistics are built, children
+   * first, as when the tree is built.  This is much faster than building the
+   * tree again; TreeCache uses it to share one tree structure between
+   * algorithms that need different statistics.  The dataset is copied.
+   *
+   * @param other Tree whose structure is copied.
+   */
+  template<typename OtherStatisticType>
+  explicit BinarySpaceTree(const BinarySpaceTree<MetricType,
+                                                 OtherStatisticType,
+                                                 MatType,
+                                                 BoundType,
+                                                 SplitType>& other);
+
   /**
    * Move constructor for a BinarySpaceTree; possess all the members of the
    * given tree.
@@ -300,10 +362,23 @@ class BinarySpaceTree
    */
   ~BinarySpaceTree();
 
+  /**
+   * Relay all the descendants of this node in a single contiguous array, in
+   * depth-first (pre-order) order, so that traversals touch consecutive memory
+   * as they descend the tree.  The structure of the tree and the TreeType API
+   * are unchanged, but pointers to descendant nodes taken before the call are
+   * invalidated.  This can only be called on the root of the tree.
+   */
+  void Compact();
+
+  //! Return whether all the descendants of this node are held in a single
+  //! contiguous array.
+  bool IsCompact() const { return nodeBlocks.size() == 1; }
+
   //! Return the bound object for this node.
-  const BoundType<MetricType>& Bound() const { return bound; }
+  const TreeBoundType& Bound() const { return bound; }
   //! Return the bound object for this node.
-  BoundType<MetricType>& Bound() { return bound; }
+  TreeBoundType& Bound() { return bound; }
 
   //! Return the statistic object for this node.
   const StatisticType& Stat() const { return stat; }
@@ -490,7 +565,18 @@ class BinarySpaceTree
   size_t& Count() { return count; }
 
   //! Store the center of the bounding region in the given vector.
-  void Center(arma::vec& center) const { bound.Center(center); }
+  void Center(arma::Col<ElemType>& center) const { bound.Center(center); }
+
+  /**
+   * Recompute the bound of this node from its points, after the points have
+   * been changed in the dataset (but not reordered), along with everything
+   * that depends on the bound: the furthest descendant distance, the parent
+   * distances of the children, and the statistic, which is rebuilt.  If the
+   * points of the children have changed too, the children must be refit
+   * first.  The tree is valid afterwards, but it may split the changed points
+   * less evenly than a tree built on them would.
+   */
+  void RefitBound();
 
  private:
   /**
@@ -500,7 +586,7 @@ class BinarySpaceTree
    * @param splitter Instantiated SplitType object.
    */
   void SplitNode(const size_t maxLeafSize,
-                 SplitType<BoundType<MetricType>, MatType>& splitter);
+                 Split& splitter);
 
   /**
    * Splits the current node, assigning its left and right children recursively.
@@ -512,7 +598,39 @@ class BinarySpaceTree
    */
   void SplitNode(std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize,
-                 SplitType<BoundType<MetricType>, MatType>& splitter);
+                 Split& splitter);
+
+  /**
+   * Create the left and right children of the current node, which are split
+   * recursively.  If OpenMP is available and the node is large enough, the two
+   * subtrees are built concurrently.
+   *
+   * @param splitCol Index of the first point that belongs to the right child.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   * @param oldFromNew Vector holding permuted indices, or NULL if the mapping
+   *     is not needed.
+   */
+  void BuildChildren(const size_t splitCol,
+                     const size_t maxLeafSize,
+                     Split& splitter,
+                     std::vector<size_t>* oldFromNew);
+
+  /**
+   * Create a child of the current node holding the given points.
+   *
+   * @param childBegin Index of the first point held by the child.
+   * @param childCount Number of points held by the child.
+   * @param maxLeafSize Maximum number of points held in a leaf.
+   * @param splitter Instantiated SplitType object.
+   * @param oldFromNew Vector holding permuted indices, or NULL if the mapping
+   *     is not needed.
+   */
+  BinarySpaceTree* NewChild(const size_t childBegin,
+                            const size_t childCount,
+                            const size_t maxLeafSize,
+                            Split& splitter,
+                            std::vector<size_t>* oldFromNew);
 
   /**
    * Update the bound of the current node. This method does not take into
@@ -529,7 +647,23 @@ class BinarySpaceTree
    *
    * @param boundToUpdate The bound to update.
    */
-  void UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate);
+  void UpdateBound(bound::HollowBallBound<MetricType, ElemType>&
+      boundToUpdate);
+
+  /**
+   * Get memory for one node from the node blocks owned by the root of the
+   * tree.  This is safe to call while subtrees are built in parallel.
+   *
+   * @param maxLeafSize Maximum number of points held in a leaf; used to size
+   *     new blocks.
+   */
+  void* AllocateNode(const size_t maxLeafSize);
+
+  /**
+   * Delete the children of this node (and their descendants), whether they
+   * were allocated individually or held in the array created by Compact().
+   */
+  void DeleteChildren();
 
  protected:
   /**
@@ -554,6 +688,31 @@ class BinarySpaceTree
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the BinarySpaceTree class.  Version 1
+//! stores the descendants of the root as a flat list instead of through
+//! pointers.
+//! BOOST_TEMPLATE_CLASS_VERSION() cannot be used here, because the template
+//! signature contains commas.
+namespace boost {
+namespace serialization {
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+struct version<mlpack::tree::BinarySpaceTree<MetricType, StatisticType,
+    MatType, BoundType, SplitType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "binary_space_tree_impl.hpp"
 
@@ -17,6 +17,7 @@
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/log.hpp>
 #include <queue>
+#include <stack>
 
 namespace mlpack {
 namespace tree {
@@ -43,7 +44,7 @@ BinarySpaceTree(
     dataset(new MatType(data)) // Copies the dataset.
 {
   // Do the actual splitting of this node.
-  SplitType<BoundType<MetricType>, MatType> splitter;
+  Split splitter;
   SplitNode(maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
@@ -76,7 +77,7 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
+  Split splitter;
   SplitNode(oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
@@ -110,7 +111,7 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
+  Split splitter;
   SplitNode(oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
@@ -140,7 +141,7 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     dataset(new MatType(std::move(data)))
 {
   // Do the actual splitting of this node.
-  SplitType<BoundType<MetricType>, MatType> splitter;
+  Split splitter;
   SplitNode(maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
@@ -173,7 +174,7 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
+  Split splitter;
   SplitNode(oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
@@ -207,7 +208,7 @@ BinarySpaceTree(
     oldFromNew[i] = i; // Fill with unharmed indices.
 
   // Now do the actual splitting.
-  SplitType<BoundType<MetricType>, MatType> splitter;
+  Split splitter;
   SplitNode(oldFromNew, maxLeafSize, splitter);
 
   // Create the statistic depending on if we are a leaf or not.
@@ -230,7 +231,7 @@ BinarySpaceTree(
     BinarySpaceTree* parent,
     const size_t begin,
     const size_t count,
-    SplitType<BoundType<MetricType>, MatType>& splitter,
+    Split& splitter,
     const size_t maxLeafSize) :
     left(NULL),
     right(NULL),
@@ -259,7 +260,7 @@ BinarySpaceTree(
     const size_t begin,
     const size_t count,
     std::vector<size_t>& oldFromNew,
-    SplitType<BoundType<MetricType>, MatType>& splitter,
+    Split& splitter,
     const size_t maxLeafSize) :
     left(NULL),
     right(NULL),
@@ -293,7 +294,7 @@ BinarySpaceTree(
     const size_t count,
     std::vector<size_t>& oldFromNew,
     std::vector<size_t>& newFromOld,
-    SplitType<BoundType<MetricType>, MatType>& splitter,
+    Split& splitter,
     const size_t maxLeafSize) :
     left(NULL),
     right(NULL),
@@ -379,6 +380,72 @@ BinarySpaceTree(
   }
 }
 
+/**
+ * Create a binary space tree with the structure of a tree that holds another
+ * type of statistic.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename OtherStatisticType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BinarySpaceTree(
+    const BinarySpaceTree<MetricType, OtherStatisticType, MatType, BoundType,
+        SplitType>& other) :
+    left(NULL),
+    right(NULL),
+    parent(NULL),
+    begin(other.Begin()),
+    count(other.Count()),
+    bound(other.Bound()),
+    parentDistance(other.ParentDistance()),
+    furthestDescendantDistance(other.FurthestDescendantDistance()),
+    minimumBoundDistance(other.MinimumBoundDistance()),
+    // Copy matrix, but only if we are the root.
+    dataset((other.Parent() == NULL) ? new MatType(other.Dataset()) : NULL)
+{
+  // Create left and right children (if any).
+  if (other.Left())
+  {
+    left = new BinarySpaceTree(*other.Left());
+    left->Parent() = this;
+  }
+
+  if (other.Right())
+  {
+    right = new BinarySpaceTree(*other.Right());
+    right->Parent() = this;
+  }
+
+  // Once the whole tree is copied, the root propagates the matrix and builds
+  // the statistics.  The statistics may look at the dataset and at the
+  // statistics of the children, so they are built in reverse pre-order.
+  if (other.Parent() == NULL)
+  {
+    std::vector<BinarySpaceTree*> order;
+    std::stack<BinarySpaceTree*> stack;
+    stack.push(this);
+    while (!stack.empty())
+    {
+      BinarySpaceTree* node = stack.top();
+      stack.pop();
+      order.push_back(node);
+
+      node->dataset = dataset;
+      if (node->right)
+        stack.push(node->right);
+      if (node->left)
+        stack.push(node->left);
+    }
+
+    for (size_t i = order.size(); i > 0; --i)
+      order[i - 1]->stat = StatisticType(*order[i - 1]);
+  }
+}
+
 /**
  * Move constructor.
  */
@@ -400,12 +467,14 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    nodeBlocks(std::move(other.nodeBlocks))
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
   other.left = NULL;
   other.right = NULL;
+  other.nodeBlocks.clear();
   other.begin = 0;
   other.count = 0;
   other.parentDistance = 0.0;
@@ -455,14 +524,164 @@ template<typename MetricType,
 BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  DeleteChildren();
 
   // If we're the root, delete the matrix.
   if (!parent)
     delete dataset;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    DeleteChildren()
+{
+  if (!nodeBlocks.empty())
+  {
+    // The descendants are held in the node blocks, so they must not delete
+    // their children individually.
+    for (size_t b = 0; b < nodeBlocks.size(); ++b)
+    {
+      for (size_t i = 0; i < nodeBlocks[b].size; ++i)
+      {
+        nodeBlocks[b].nodes[i].left = NULL;
+        nodeBlocks[b].nodes[i].right = NULL;
+        nodeBlocks[b].nodes[i].~BinarySpaceTree();
+      }
+
+      ::operator delete(nodeBlocks[b].nodes);
+    }
+
+    nodeBlocks.clear();
+    left = NULL;
+    right = NULL;
+  }
+
+  delete left;
+  delete right;
+  left = NULL;
+  right = NULL;
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    Compact()
+{
+  if (parent)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Compact(): only the root of "
+        "the tree can be compacted");
+  }
+
+  // Collect the descendants in depth-first pre-order.
+  std::vector<BinarySpaceTree*> order;
+  std::stack<BinarySpaceTree*> stack;
+  if (right)
+    stack.push(right);
+  if (left)
+    stack.push(left);
+  while (!stack.empty())
+  {
+    BinarySpaceTree* node = stack.top();
+    stack.pop();
+    order.push_back(node);
+
+    if (node->right)
+      stack.push(node->right);
+    if (node->left)
+      stack.push(node->left);
+  }
+
+  if (order.empty())
+    return;
+
+  // The nodes may already be held in node blocks; those are freed at the end.
+  std::vector<NodeBlock> oldBlocks;
+  oldBlocks.swap(nodeBlocks);
+
+  NodeBlock block;
+  block.nodes = static_cast<BinarySpaceTree*>(
+      ::operator new(order.size() * sizeof(BinarySpaceTree)));
+  block.size = order.size();
+  block.capacity = order.size();
+
+  // Because of the pre-order, the parent of each node has already been moved
+  // when we reach it.  The move constructor points the children of the moved
+  // node to their new parent, so we only need to fix the child pointer of the
+  // parent.
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    BinarySpaceTree* node = new (block.nodes + i)
+        BinarySpaceTree(std::move(*order[i]));
+
+    if (node->parent->left == order[i])
+      node->parent->left = node;
+    else
+      node->parent->right = node;
+
+    // The old node has no children anymore, so it can be destroyed safely.
+    if (!oldBlocks.empty())
+      order[i]->~BinarySpaceTree();
+    else
+      delete order[i];
+  }
+
+  nodeBlocks.push_back(block);
+
+  for (size_t b = 0; b < oldBlocks.size(); ++b)
+    ::operator delete(oldBlocks[b].nodes);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void*
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    AllocateNode(const size_t maxLeafSize)
+{
+  void* memory;
+
+  // Children may be built in parallel, but all of them allocate from the root.
+  #pragma omp critical(BinarySpaceTreeAllocateNode)
+  {
+    BinarySpaceTree* root = this;
+    while (root->parent)
+      root = root->parent;
+
+    if (root->nodeBlocks.empty() ||
+        root->nodeBlocks.back().size == root->nodeBlocks.back().capacity)
+    {
+      // Size the blocks so that most trees fit in the first block (leaves
+      // typically hold between half and all of maxLeafSize points).
+      NodeBlock block;
+      block.capacity = 4 * (root->count / std::max(maxLeafSize, size_t(1))) +
+          1;
+      block.size = 0;
+      block.nodes = static_cast<BinarySpaceTree*>(
+          ::operator new(block.capacity * sizeof(BinarySpaceTree)));
+      root->nodeBlocks.push_back(block);
+    }
+
+    NodeBlock& block = root->nodeBlocks.back();
+    memory = block.nodes + block.size;
+    ++block.size;
+  }
+
+  return memory;
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -745,7 +964,7 @@ template<typename MetricType,
              class SplitType>
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
     SplitNode(const size_t maxLeafSize,
-              SplitType<BoundType<MetricType>, MatType>& splitter)
+              Split& splitter)
 {
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
@@ -765,8 +984,12 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   // Find the partition of the node. This method does not perform the split.
   typename Split::SplitInfo splitInfo;
 
-  const bool split = splitter.SplitNode(bound, *dataset, begin, count,
-      splitInfo);
+  // Split policies may use the global random number generator (or keep state
+  // of their own), so when subtrees are built in parallel only one thread at a
+  // time may look for a split.
+  bool split;
+  #pragma omp critical(BinarySpaceTreeSplitNode)
+  split = splitter.SplitNode(bound, *dataset, begin, count, splitInfo);
 
   // The node may not be always split. For instance, if all the points are the
   // same, we can't split them.
@@ -783,13 +1006,10 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
-      maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      splitter, maxLeafSize);
+  BuildChildren(splitCol, maxLeafSize, splitter, NULL);
 
   // Calculate parent distances for those two nodes.
-  arma::vec center, leftCenter, rightCenter;
+  arma::Col<ElemType> center, leftCenter, rightCenter;
   Center(center);
   left->Center(leftCenter);
   right->Center(rightCenter);
@@ -812,7 +1032,7 @@ template<typename MetricType,
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
 SplitNode(std::vector<size_t>& oldFromNew,
           const size_t maxLeafSize,
-          SplitType<BoundType<MetricType>, MatType>& splitter)
+          Split& splitter)
 {
   // We need to expand the bounds of this node properly.
   UpdateBound(bound);
@@ -832,8 +1052,12 @@ SplitNode(std::vector<size_t>& oldFromNew,
   // Find the partition of the node. This method does not perform the split.
   typename Split::SplitInfo splitInfo;
 
-  const bool split = splitter.SplitNode(bound, *dataset, begin, count,
-      splitInfo);
+  // Split policies may use the global random number generator (or keep state
+  // of their own), so when subtrees are built in parallel only one thread at a
+  // time may look for a split.
+  bool split;
+  #pragma omp critical(BinarySpaceTreeSplitNode)
+  split = splitter.SplitNode(bound, *dataset, begin, count, splitInfo);
 
   // The node may not be always split. For instance, if all the points are the
   // same, we can't split them.
@@ -851,13 +1075,10 @@ SplitNode(std::vector<size_t>& oldFromNew,
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
-      splitter, maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      oldFromNew, splitter, maxLeafSize);
+  BuildChildren(splitCol, maxLeafSize, splitter, &oldFromNew);
 
   // Calculate parent distances for those two nodes.
-  arma::vec center, leftCenter, rightCenter;
+  arma::Col<ElemType> center, leftCenter, rightCenter;
   Center(center);
   left->Center(leftCenter);
   right->Center(rightCenter);
@@ -871,6 +1092,98 @@ SplitNode(std::vector<size_t>& oldFromNew,
   right->ParentDistance() = rightParentDistance;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BuildChildren(const size_t splitCol,
+              const size_t maxLeafSize,
+              Split& splitter,
+              std::vector<size_t>* oldFromNew)
+{
+  const size_t leftCount = splitCol - begin;
+  const size_t rightCount = begin + count - splitCol;
+
+#ifdef HAS_OPENMP
+  // Below this number of points, the overhead of creating a task is not worth
+  // it.
+  const size_t parallelBuildThreshold = 10000;
+
+  // The two subtrees hold disjoint ranges of the dataset (and of oldFromNew),
+  // so they can be built at the same time.  The exception is the hollow ball
+  // bound, where the right child needs the bound of the left child.
+  const bool hollowBound = std::is_same<TreeBoundType,
+      bound::HollowBallBound<MetricType, ElemType>>::value;
+  if (!hollowBound && count >= parallelBuildThreshold &&
+      NumThreads() > 1)
+  {
+    if (!InParallel())
+    {
+      // This is the first parallel split; create the threads that will work
+      // through the tasks of the rest of the tree.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        {
+          #pragma omp task shared(splitter)
+          left = NewChild(begin, leftCount, maxLeafSize, splitter, oldFromNew);
+
+          right = NewChild(splitCol, rightCount, maxLeafSize, splitter,
+              oldFromNew);
+
+          #pragma omp taskwait
+        }
+      }
+    }
+    else
+    {
+      #pragma omp task shared(splitter)
+      left = NewChild(begin, leftCount, maxLeafSize, splitter, oldFromNew);
+
+      right = NewChild(splitCol, rightCount, maxLeafSize, splitter,
+          oldFromNew);
+
+      #pragma omp taskwait
+    }
+
+    return;
+  }
+#endif
+
+  left = NewChild(begin, leftCount, maxLeafSize, splitter, oldFromNew);
+  right = NewChild(splitCol, rightCount, maxLeafSize, splitter, oldFromNew);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>*
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+NewChild(const size_t childBegin,
+         const size_t childCount,
+         const size_t maxLeafSize,
+         Split& splitter,
+         std::vector<size_t>* oldFromNew)
+{
+  // The node is constructed in memory owned by the root, so the whole tree is
+  // freed at once and nodes built one after the other sit next to each other.
+  void* memory = AllocateNode(maxLeafSize);
+  if (oldFromNew)
+  {
+    return new (memory) BinarySpaceTree(this, childBegin, childCount,
+        *oldFromNew, splitter, maxLeafSize);
+  }
+
+  return new (memory) BinarySpaceTree(this, childBegin, childCount, splitter,
+      maxLeafSize);
+}
+
 template<typename MetricType,
          typename StatisticType,
          typename MatType,
@@ -892,7 +1205,7 @@ template<typename MetricType,
          template<typename SplitBoundType, typename SplitMatType>
              class SplitType>
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
-UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate)
+UpdateBound(bound::HollowBallBound<MetricType, ElemType>& boundToUpdate)
 {
   if (!parent)
   {
@@ -911,6 +1224,35 @@ UpdateBound(bound::HollowBallBound<MetricType>& boundToUpdate)
     boundToUpdate |= dataset->cols(begin, begin + count - 1);
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+    RefitBound()
+{
+  bound = TreeBoundType(dataset->n_rows);
+  UpdateBound(bound);
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  if (left && right)
+  {
+    // The center of this node may have moved, so the distances to the centers
+    // of the children have to be computed again.
+    arma::Col<ElemType> center, leftCenter, rightCenter;
+    Center(center);
+    left->Center(leftCenter);
+    right->Center(rightCenter);
+
+    left->ParentDistance() = bound.Metric().Evaluate(center, leftCenter);
+    right->ParentDistance() = bound.Metric().Evaluate(center, rightCenter);
+  }
+
+  stat = StatisticType(*this);
+}
+
 // Default constructor (private), for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -944,15 +1286,12 @@ template<typename MetricType,
              class SplitType>
 template<typename Archive>
 void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
-    serialize(Archive& ar, const unsigned int /* version */)
+    serialize(Archive& ar, const unsigned int version)
 {
   // If we're loading, and we have children, they need to be deleted.
   if (Archive::is_loading::value)
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    DeleteChildren();
     if (!parent)
       delete dataset;
 
@@ -970,24 +1309,124 @@ void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
   ar & BOOST_SERIALIZATION_NVP(furthestDescendantDistance);
   ar & BOOST_SERIALIZATION_NVP(dataset);
 
-  // Save children last; otherwise boost::serialization gets confused.
-  bool hasLeft = (left != NULL);
-  bool hasRight = (right != NULL);
+  // Version 0 stored every child through a pointer.  We still need to be able
+  // to load these archives.
+  if (version == 0)
+  {
+    // Save children last; otherwise boost::serialization gets confused.
+    bool hasLeft = (left != NULL);
+    bool hasRight = (right != NULL);
+
+    ar & BOOST_SERIALIZATION_NVP(hasLeft);
+    ar & BOOST_SERIALIZATION_NVP(hasRight);
+    if (hasLeft)
+      ar & BOOST_SERIALIZATION_NVP(left);
+    if (hasRight)
+      ar & BOOST_SERIALIZATION_NVP(right);
+
+    if (Archive::is_loading::value)
+    {
+      if (left)
+        left->parent = this;
+      if (right)
+        right->parent = this;
+    }
 
-  ar & BOOST_SERIALIZATION_NVP(hasLeft);
-  ar & BOOST_SERIALIZATION_NVP(hasRight);
-  if (hasLeft)
-    ar & BOOST_SERIALIZATION_NVP(left);
-  if (hasRight)
-    ar & BOOST_SERIALIZATION_NVP(right);
+    return;
+  }
 
-  if (Archive::is_loading::value)
+  // Otherwise, the descendants are stored in pre-order as a flat list of
+  // nodes, each followed by whether or not it has children.  This avoids the
+  // pointer tracking of boost::serialization, which is slow for large trees,
+  // and lets us load all the descendants into a single node block.
+  std::vector<BinarySpaceTree*> order;
+  if (Archive::is_saving::value)
   {
-    if (left)
-      left->parent = this;
+    std::stack<BinarySpaceTree*> stack;
     if (right)
-      right->parent = this;
+      stack.push(right);
+    if (left)
+      stack.push(left);
+    while (!stack.empty())
+    {
+      BinarySpaceTree* node = stack.top();
+      stack.pop();
+      order.push_back(node);
+
+      if (node->right)
+        stack.push(node->right);
+      if (node->left)
+        stack.push(node->left);
+    }
+  }
+
+  size_t numDescendants = order.size();
+  bool hasChildren = (left != NULL);
+  ar & BOOST_SERIALIZATION_NVP(numDescendants);
+  ar & BOOST_SERIALIZATION_NVP(hasChildren);
+
+  if (Archive::is_loading::value && numDescendants > 0)
+  {
+    NodeBlock block;
+    block.nodes = static_cast<BinarySpaceTree*>(
+        ::operator new(numDescendants * sizeof(BinarySpaceTree)));
+    block.size = 0;
+    block.capacity = numDescendants;
+    nodeBlocks.push_back(block);
   }
+
+  // The nodes whose right child has not been seen yet, when loading.
+  std::stack<BinarySpaceTree*> parents;
+  if (hasChildren)
+    parents.push(this);
+
+  for (size_t i = 0; i < numDescendants; ++i)
+  {
+    if (Archive::is_loading::value)
+    {
+      if (parents.empty())
+        throw std::runtime_error("BinarySpaceTree::serialize(): invalid tree "
+            "structure in archive");
+
+      // Link the node to its parent right away, so that it never owns the
+      // dataset, even if loading fails.
+      NodeBlock& block = nodeBlocks.back();
+      BinarySpaceTree* node = new (block.nodes + i) BinarySpaceTree();
+      ++block.size;
+
+      node->parent = parents.top();
+      node->dataset = dataset;
+      if (node->parent->left == NULL)
+      {
+        node->parent->left = node;
+      }
+      else
+      {
+        node->parent->right = node;
+        parents.pop();
+      }
+
+      order.push_back(node);
+    }
+
+    BinarySpaceTree& node = *order[i];
+    ar & boost::serialization::make_nvp("begin", node.begin);
+    ar & boost::serialization::make_nvp("count", node.count);
+    ar & boost::serialization::make_nvp("bound", node.bound);
+    ar & boost::serialization::make_nvp("stat", node.stat);
+    ar & boost::serialization::make_nvp("parentDistance", node.parentDistance);
+    ar & boost::serialization::make_nvp("furthestDescendantDistance",
+        node.furthestDescendantDistance);
+
+    hasChildren = (node.left != NULL);
+    ar & BOOST_SERIALIZATION_NVP(hasChildren);
+    if (Archive::is_loading::value && hasChildren)
+      parents.push(&node);
+  }
+
+  if (Archive::is_loading::value && !parents.empty())
+    throw std::runtime_error("BinarySpaceTree::serialize(): invalid tree "
+        "structure in archive");
 }
 
 } // namespace tree
@@ -0,0 +1,118 @@
+/**
+ * @file block_single_tree_traverser.hpp
+ *
+ * A nested class of BinarySpaceTree which traverses the reference tree once
+ * for a block of query points, instead of once for each of them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_BLOCK_SINGLE_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_BLOCK_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/core/tree/batch_base_cases.hpp>
+
+#include "binary_space_tree.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The BlockSingleTreeTraverser is a depth-first single-tree traverser that
+ * visits the reference tree once with a whole block of query points.  Each
+ * node is visited with the query points of the block that could not be pruned
+ * at its parent; both children are scored for all of those query points, the
+ * child that most of them score best is visited first, and the other child is
+ * then rescored and visited with the query points that still can't be pruned.
+ * At the leaves, the base cases of all the remaining query points are done at
+ * once, with RuleType::BatchBaseCases() if the rules have it.
+ *
+ * The nodes of the upper levels of the tree are then fetched once for the
+ * block instead of once per query point, so when the query points of the block
+ * are close to each other (see BlockSingleTreeTraversal()), the traversal
+ * makes much better use of the cache than SingleTreeTraverser, without the
+ * cost of building a query tree.  The scores and base cases are the same as
+ * those of SingleTreeTraverser, except that a query point may visit the
+ * children of a node in a different order, so the rules must not depend on
+ * the order in which the query points are interleaved (for instance by
+ * caching values for the last query point in the tree statistics).
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
+                      SplitType>::BlockSingleTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the traverser with the given rule set.
+   */
+  BlockSingleTreeTraverser(RuleType& rule);
+
+  /**
+   * Traverse the tree with the given block of query points.
+   *
+   * @param queryIndices The indices of the query points in the query set.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const std::vector<size_t>& queryIndices,
+                BinarySpaceTree& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+ private:
+  //! Traverse the given node with the query points of the given depth.
+  void Traverse(BinarySpaceTree& referenceNode, const size_t depth);
+
+  /**
+   * Perform the base cases of the query points of the given depth with a
+   * leaf, one pair at a time.
+   */
+  template<typename Rule = RuleType>
+  void LeafBaseCases(BinarySpaceTree& referenceNode,
+                     const size_t depth,
+                     const typename std::enable_if_t<
+                         !HasBatchBaseCases<Rule>::value>* = 0);
+
+  /**
+   * Perform the base cases of the query points of the given depth with a
+   * leaf, with a single call to RuleType::BatchBaseCases().
+   */
+  template<typename Rule = RuleType>
+  void LeafBaseCases(BinarySpaceTree& referenceNode,
+                     const size_t depth,
+                     const typename std::enable_if_t<
+                         HasBatchBaseCases<Rule>::value>* = 0);
+
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+
+  //! The query points that visit the node of each depth of the traversal.
+  std::vector<std::vector<size_t>> queries;
+
+  //! The scores of the children of the node of each depth, for each of its
+  //! query points: the child visited first, then the other one.
+  std::vector<std::vector<double>> firstScores, secondScores;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "block_single_tree_traverser_impl.hpp"
+
+#endif
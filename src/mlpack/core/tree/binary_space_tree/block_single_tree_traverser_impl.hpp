@@ -0,0 +1,180 @@
+/**
+ * @file block_single_tree_traverser_impl.hpp
+ *
+ * Implementation of the BlockSingleTreeTraverser for BinarySpaceTree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BINARY_SPACE_TREE_BLOCK_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BINARY_SPACE_TREE_BLOCK_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "block_single_tree_traverser.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BlockSingleTreeTraverser<RuleType>::BlockSingleTreeTraverser(RuleType& rule) :
+    rule(rule),
+    numPrunes(0)
+{ /* Nothing to do. */ }
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BlockSingleTreeTraverser<RuleType>::Traverse(
+    const std::vector<size_t>& queryIndices,
+    BinarySpaceTree& referenceNode)
+{
+  if (queryIndices.empty())
+    return;
+
+  if (queries.empty())
+    queries.resize(1);
+  queries[0] = queryIndices;
+
+  Traverse(referenceNode, 0);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BlockSingleTreeTraverser<RuleType>::Traverse(
+    BinarySpaceTree& referenceNode,
+    const size_t depth)
+{
+  // If we are a leaf, run the base cases of the remaining query points.
+  if (referenceNode.IsLeaf())
+  {
+    LeafBaseCases(referenceNode, depth);
+    return;
+  }
+
+  // The buffers of the deeper levels are reused by the whole traversal.  They
+  // may be reallocated by the recursion, so they are only accessed by index.
+  if (queries.size() < depth + 2)
+  {
+    queries.resize(depth + 2);
+    firstScores.resize(depth + 2);
+    secondScores.resize(depth + 2);
+  }
+
+  // Score both children for each query point; a score of DBL_MAX is a prune.
+  const size_t numQueries = queries[depth].size();
+  firstScores[depth].resize(numQueries);
+  secondScores[depth].resize(numQueries);
+  size_t numLeftFirst = 0;
+  for (size_t i = 0; i < numQueries; ++i)
+  {
+    const size_t queryIndex = queries[depth][i];
+    firstScores[depth][i] = rule.Score(queryIndex, *referenceNode.Left());
+    secondScores[depth][i] = rule.Score(queryIndex, *referenceNode.Right());
+
+    // Like SingleTreeTraverser, ties go to the left child.
+    if (firstScores[depth][i] <= secondScores[depth][i])
+      ++numLeftFirst;
+  }
+
+  // Visit first the child that most query points would visit first.
+  BinarySpaceTree* first = referenceNode.Left();
+  BinarySpaceTree* second = referenceNode.Right();
+  if (2 * numLeftFirst < numQueries)
+  {
+    std::swap(first, second);
+    firstScores[depth].swap(secondScores[depth]);
+  }
+
+  queries[depth + 1].clear();
+  for (size_t i = 0; i < numQueries; ++i)
+  {
+    if (firstScores[depth][i] != DBL_MAX)
+      queries[depth + 1].push_back(queries[depth][i]);
+    else
+      ++numPrunes;
+  }
+
+  if (!queries[depth + 1].empty())
+    Traverse(*first, depth + 1);
+
+  // Is it still valid to visit the other child?
+  queries[depth + 1].clear();
+  for (size_t i = 0; i < numQueries; ++i)
+  {
+    const size_t queryIndex = queries[depth][i];
+    if (secondScores[depth][i] != DBL_MAX &&
+        rule.Rescore(queryIndex, *second, secondScores[depth][i]) != DBL_MAX)
+      queries[depth + 1].push_back(queryIndex);
+    else
+      ++numPrunes;
+  }
+
+  if (!queries[depth + 1].empty())
+    Traverse(*second, depth + 1);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+template<typename Rule>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BlockSingleTreeTraverser<RuleType>::LeafBaseCases(
+    BinarySpaceTree& referenceNode,
+    const size_t depth,
+    const typename std::enable_if_t<!HasBatchBaseCases<Rule>::value>*)
+{
+  const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
+  for (size_t i = 0; i < queries[depth].size(); ++i)
+    for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
+      rule.BaseCase(queries[depth][i], ref);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType>
+template<typename Rule>
+void BinarySpaceTree<MetricType, StatisticType, MatType, BoundType, SplitType>::
+BlockSingleTreeTraverser<RuleType>::LeafBaseCases(
+    BinarySpaceTree& referenceNode,
+    const size_t depth,
+    const typename std::enable_if_t<HasBatchBaseCases<Rule>::value>*)
+{
+  if (referenceNode.Count() > 0)
+  {
+    rule.BatchBaseCases(queries[depth], referenceNode.Begin(),
+        referenceNode.Count());
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -17,6 +17,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include <mlpack/core/tree/batch_base_cases.hpp>
+
 #include "binary_space_tree.hpp"
 
 namespace mlpack {
@@ -69,6 +71,26 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   size_t& NumBaseCases() { return numBaseCases; }
 
  private:
+  /**
+   * Perform the base cases between two leaves, one pair at a time.  This is
+   * used when the rules cannot perform base cases in batches.
+   */
+  template<typename Rule = RuleType>
+  void LeafBaseCases(BinarySpaceTree& queryNode,
+                     BinarySpaceTree& referenceNode,
+                     const typename std::enable_if_t<
+                         !HasBatchBaseCases<Rule>::value>* = 0);
+
+  /**
+   * Perform the base cases between two leaves with a single call to
+   * RuleType::BatchBaseCases() for all query points that cannot be pruned.
+   */
+  template<typename Rule = RuleType>
+  void LeafBaseCases(BinarySpaceTree& queryNode,
+                     BinarySpaceTree& referenceNode,
+                     const typename std::enable_if_t<
+                         HasBatchBaseCases<Rule>::value>* = 0);
+
   //! Reference to the rules with which the trees will be traversed.
   RuleType& rule;
 
@@ -87,6 +109,10 @@ class BinarySpaceTree<MetricType, StatisticType, MatType, BoundType,
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
+
+  //! The query points of a leaf that need base cases, held in the class so
+  //! that it isn't continually being reallocated.
+  std::vector<size_t> queryIndices;
 };
 
 } // namespace tree
@@ -0,0 +1,205 @@
+/**
+ * @file block_single_tree_traversal.hpp
+ *
+ * Single-tree traversal of a range of query points in blocks of spatially
+ * close query points, with the BlockSingleTreeTraverser of the reference tree
+ * when it has one.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BLOCK_SINGLE_TREE_TRAVERSAL_HPP
+#define MLPACK_CORE_TREE_BLOCK_SINGLE_TREE_TRAVERSAL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "binary_space_tree.hpp"
+#include "instrumented_rules.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Whether trees of the given type have a BlockSingleTreeTraverser.  Binary
+ * space trees do, unless the first point of each node is its centroid, since
+ * then the rules save the last base case of each query point in the reference
+ * nodes, which queries of the same block would overwrite.
+ */
+template<typename TreeType>
+struct HasBlockSingleTreeTraverser
+{
+  static const bool value = false;
+};
+
+//! Binary space trees have a BlockSingleTreeTraverser.
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+struct HasBlockSingleTreeTraverser<BinarySpaceTree<MetricType, StatisticType,
+    MatType, BoundType, SplitType>>
+{
+  static const bool value = !TreeTraits<BinarySpaceTree<MetricType,
+      StatisticType, MatType, BoundType, SplitType>>::FirstPointIsCentroid;
+};
+
+/**
+ * Order the indices order[begin, end) so that each block of blockSize
+ * consecutive indices (counted from begin) holds query points that are close
+ * to each other: the range is split on its widest dimension, at a multiple of
+ * blockSize, until it fits in a block.  That is like building a kd-tree on the
+ * query points, but without the tree, the bounds or the copy of the points.
+ */
+template<typename MatType>
+void BlockQueryOrder(const MatType& querySet,
+                     std::vector<size_t>& order,
+                     const size_t begin,
+                     const size_t end,
+                     const size_t blockSize)
+{
+  if (end - begin <= blockSize)
+    return;
+
+  // Find the widest dimension of the query points of the range.
+  size_t splitDimension = 0;
+  double maxWidth = -1.0;
+  for (size_t d = 0; d < querySet.n_rows; ++d)
+  {
+    double minValue = DBL_MAX, maxValue = -DBL_MAX;
+    for (size_t i = begin; i < end; ++i)
+    {
+      const double value = querySet(d, order[i]);
+      minValue = std::min(minValue, value);
+      maxValue = std::max(maxValue, value);
+    }
+
+    if (maxValue - minValue > maxWidth)
+    {
+      maxWidth = maxValue - minValue;
+      splitDimension = d;
+    }
+  }
+
+  // Split the blocks of the range in half.
+  const size_t numBlocks = (end - begin + blockSize - 1) / blockSize;
+  const size_t middle = begin + (numBlocks / 2) * blockSize;
+  std::nth_element(order.begin() + begin, order.begin() + middle,
+      order.begin() + end, [&](const size_t a, const size_t b)
+      {
+        return querySet(splitDimension, a) < querySet(splitDimension, b);
+      });
+
+  BlockQueryOrder(querySet, order, begin, middle, blockSize);
+  BlockQueryOrder(querySet, order, middle, end, blockSize);
+}
+
+/**
+ * Traverse the given reference tree with each of the given range of query
+ * points, like SingleTreeTraversal(), when the reference tree has no
+ * BlockSingleTreeTraverser.
+ */
+template<template<typename> class TraverserType,
+         typename RuleType,
+         typename MatType,
+         typename TreeType>
+void BlockSingleTreeTraversal(
+    RuleType& rules,
+    const MatType& /* querySet */,
+    const size_t queryBegin,
+    const size_t queryCount,
+    TreeType& referenceNode,
+    const size_t /* blockSize */,
+    TraversalStatistics* statistics = NULL,
+    const typename std::enable_if_t<
+        !HasBlockSingleTreeTraverser<TreeType>::value>* = 0)
+{
+  SingleTreeTraversal<TraverserType>(rules, queryBegin, queryCount,
+      referenceNode, statistics);
+}
+
+/**
+ * Traverse the given reference tree with each of the given range of query
+ * points, in blocks of blockSize query points: the range is ordered with
+ * BlockQueryOrder(), and each block traverses the tree at once with its
+ * BlockSingleTreeTraverser.  The rules must allow the query points to be
+ * interleaved (see BlockSingleTreeTraverser).  Blocks give the same results as
+ * the default SingleTreeTraverser of the tree, so if the given traverser type
+ * is another one (for instance a greedy traverser), or if blockSize is at most
+ * 1, the tree is traversed with the given traverser type instead, as with
+ * SingleTreeTraversal().  If statistics is not NULL, the rules are
+ * instrumented and the statistics of the traversal are added to it.
+ *
+ * @param rules Rules of the traversal.
+ * @param querySet Set of query points.
+ * @param queryBegin Index of the first query point.
+ * @param queryCount Number of query points.
+ * @param referenceNode Root of the reference tree.
+ * @param blockSize Number of query points of each block.
+ * @param statistics Statistics to add to, or NULL.
+ */
+template<template<typename> class TraverserType,
+         typename RuleType,
+         typename MatType,
+         typename TreeType>
+void BlockSingleTreeTraversal(
+    RuleType& rules,
+    const MatType& querySet,
+    const size_t queryBegin,
+    const size_t queryCount,
+    TreeType& referenceNode,
+    const size_t blockSize,
+    TraversalStatistics* statistics = NULL,
+    const typename std::enable_if_t<
+        HasBlockSingleTreeTraverser<TreeType>::value>* = 0)
+{
+  if (blockSize <= 1 || !std::is_same<TraverserType<RuleType>,
+      typename TreeType::template SingleTreeTraverser<RuleType>>::value)
+  {
+    SingleTreeTraversal<TraverserType>(rules, queryBegin, queryCount,
+        referenceNode, statistics);
+    return;
+  }
+
+  std::vector<size_t> order(queryCount);
+  for (size_t i = 0; i < queryCount; ++i)
+    order[i] = queryBegin + i;
+  BlockQueryOrder(querySet, order, 0, queryCount, blockSize);
+
+  if (statistics)
+  {
+    InstrumentedRules<RuleType> instrumentedRules(rules);
+    typename TreeType::template BlockSingleTreeTraverser<
+        InstrumentedRules<RuleType>> traverser(instrumentedRules);
+
+    std::vector<size_t> block;
+    for (size_t i = 0; i < queryCount; i += blockSize)
+    {
+      block.assign(order.begin() + i,
+          order.begin() + std::min(i + blockSize, queryCount));
+      traverser.Traverse(block, referenceNode);
+    }
+
+    statistics->Merge(instrumentedRules.Statistics());
+  }
+  else
+  {
+    typename TreeType::template BlockSingleTreeTraverser<RuleType>
+        traverser(rules);
+
+    std::vector<size_t> block;
+    for (size_t i = 0; i < queryCount; i += blockSize)
+    {
+      block.assign(order.begin() + i,
+          order.begin() + std::min(i + blockSize, queryCount));
+      traverser.Traverse(block, referenceNode);
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
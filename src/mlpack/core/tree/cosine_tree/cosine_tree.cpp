@@ -17,6 +17,22 @@
 namespace mlpack {
 namespace tree {
 
+/**
+ * Collect the basis vectors of the nodes in the given queue into the columns of
+ * a matrix, so that projections onto all of them can be computed at once.
+ */
+static void QueueBasis(const CosineNodeQueue& treeQueue,
+                       const size_t dimensionality,
+                       arma::mat& currentBasis)
+{
+  currentBasis.set_size(dimensionality, treeQueue.size());
+
+  size_t j = 0;
+  CosineNodeQueue::const_iterator i = treeQueue.begin();
+  for ( ; i != treeQueue.end(); i++, j++)
+    currentBasis.col(j) = (*i)->BasisVector();
+}
+
 CosineTree::CosineTree(const arma::mat& dataset) :
     dataset(dataset),
     parent(NULL),
@@ -29,11 +45,11 @@ CosineTree::CosineTree(const arma::mat& dataset) :
   l2NormsSquared.zeros(numColumns);
 
   // Set indices and calculate squared norms of the columns.
-  for (size_t i = 0; i < numColumns; i++)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     indices[i] = i;
-    double l2Norm = arma::norm(dataset.col(i), 2);
-    l2NormsSquared(i) = l2Norm * l2Norm;
+    l2NormsSquared(i) = arma::dot(dataset.col(i), dataset.col(i));
   }
 
   // Frobenius norm of columns in the node.
@@ -123,11 +139,16 @@ CosineTree::CosineTree(const arma::mat& dataset,
     currentLeft = currentNode->Left();
     currentRight = currentNode->Right();
 
+    // Collect the current basis once, so that the projections below are
+    // matrix products instead of one dot product per node in the queue.
+    arma::mat currentBasis;
+    QueueBasis(treeQueue, dataset.n_rows, currentBasis);
+
     // Calculate basis vectors of left and right children.
     arma::vec lBasisVector, rBasisVector;
 
-    ModifiedGramSchmidt(treeQueue, currentLeft->Centroid(), lBasisVector);
-    ModifiedGramSchmidt(treeQueue, currentRight->Centroid(), rBasisVector,
+    ModifiedGramSchmidt(currentBasis, currentLeft->Centroid(), lBasisVector);
+    ModifiedGramSchmidt(currentBasis, currentRight->Centroid(), rBasisVector,
                         &lBasisVector);
 
     // Add basis vectors to their respective nodes.
@@ -135,15 +156,17 @@ CosineTree::CosineTree(const arma::mat& dataset,
     currentRight->BasisVector(rBasisVector);
 
     // Calculate Monte Carlo error estimates for child nodes.
-    MonteCarloError(currentLeft, treeQueue, &lBasisVector, &rBasisVector);
-    MonteCarloError(currentRight, treeQueue, &lBasisVector, &rBasisVector);
+    MonteCarloError(currentLeft, currentBasis, &lBasisVector, &rBasisVector);
+    MonteCarloError(currentRight, currentBasis, &lBasisVector, &rBasisVector);
 
     // Push child nodes into the priority queue.
     treeQueue.push(currentLeft);
     treeQueue.push(currentRight);
 
-    // Calculate Monte Carlo error estimate for the root node.
-    monteCarloError = MonteCarloError(&root, treeQueue);
+    // Calculate Monte Carlo error estimate for the root node.  The basis of the
+    // queue is now the current basis and the two new basis vectors.
+    monteCarloError = MonteCarloError(&root, currentBasis, &lBasisVector,
+        &rBasisVector);
   }
 
   // Construct the subspace basis from the current priority queue.
@@ -163,22 +186,23 @@ void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
                                      arma::vec& newBasisVector,
                                      arma::vec* addBasisVector)
 {
-  // Set new basis vector to centroid.
-  newBasisVector = centroid;
+  arma::mat currentBasis;
+  QueueBasis(treeQueue, centroid.n_elem, currentBasis);
 
-  // Variables for iterating throught the priority queue.
-  CosineTree *currentNode;
-  CosineNodeQueue::const_iterator i = treeQueue.begin();
-
-  // For every vector in the current basis, remove its projection from the
-  // centroid.
-  for ( ; i != treeQueue.end(); i++)
-  {
-    currentNode = *i;
+  ModifiedGramSchmidt(currentBasis, centroid, newBasisVector, addBasisVector);
+}
 
-    double projection = arma::dot(currentNode->BasisVector(), centroid);
-    newBasisVector -= projection * currentNode->BasisVector();
-  }
+void CosineTree::ModifiedGramSchmidt(const arma::mat& currentBasis,
+                                     const arma::vec& centroid,
+                                     arma::vec& newBasisVector,
+                                     const arma::vec* addBasisVector)
+{
+  // Remove the projection of the centroid onto every vector in the current
+  // basis.
+  if (currentBasis.n_cols > 0)
+    newBasisVector = centroid - currentBasis * (currentBasis.t() * centroid);
+  else
+    newBasisVector = centroid;
 
   // If additional basis vector is passed, take it into account.
   if (addBasisVector)
@@ -188,14 +212,26 @@ void CosineTree::ModifiedGramSchmidt(CosineNodeQueue& treeQueue,
   }
 
   // Normalize the modified centroid vector.
-  if (arma::norm(newBasisVector, 2))
-    newBasisVector /= arma::norm(newBasisVector, 2);
+  const double norm = arma::norm(newBasisVector, 2);
+  if (norm)
+    newBasisVector /= norm;
 }
 
 double CosineTree::MonteCarloError(CosineTree* node,
                                    CosineNodeQueue& treeQueue,
                                    arma::vec* addBasisVector1,
                                    arma::vec* addBasisVector2)
+{
+  arma::mat currentBasis;
+  QueueBasis(treeQueue, node->GetDataset().n_rows, currentBasis);
+
+  return MonteCarloError(node, currentBasis, addBasisVector1, addBasisVector2);
+}
+
+double CosineTree::MonteCarloError(CosineTree* node,
+                                   const arma::mat& currentBasis,
+                                   const arma::vec* addBasisVector1,
+                                   const arma::vec* addBasisVector2)
 {
   std::vector<size_t> sampledIndices;
   arma::vec probabilities;
@@ -205,57 +241,33 @@ double CosineTree::MonteCarloError(CosineTree* node,
   size_t numSamples = log(node->NumColumns()) + 1;
   node->ColumnSamplesLS(sampledIndices, probabilities, numSamples);
 
-  // Get pointer to the original dataset.
-  arma::mat dataset = node->GetDataset();
+  // Get reference to the original dataset.
+  const arma::mat& dataset = node->GetDataset();
 
-  // Initialize weighted projection magnitudes as zeros.
-  arma::vec weightedMagnitudes;
-  weightedMagnitudes.zeros(numSamples);
+  // Gather the sampled columns, so that their projections onto the current
+  // basis can be computed with a single matrix product.
+  arma::mat samples(dataset.n_rows, numSamples);
+  for (size_t i = 0; i < numSamples; i++)
+    samples.col(i) = dataset.col(sampledIndices[i]);
 
-  // Set size of projection vector, depending on whether additional basis
-  // vectors are passed.
-  size_t projectionSize;
-  if (addBasisVector1 && addBasisVector2)
-    projectionSize = treeQueue.size() + 2;
+  // Calculate the squared norm of the projection of each sample onto the
+  // current basis.
+  arma::rowvec projectionsSquared;
+  if (currentBasis.n_cols > 0)
+    projectionsSquared = arma::sum(arma::square(currentBasis.t() * samples), 0);
   else
-    projectionSize = treeQueue.size();
+    projectionsSquared.zeros(numSamples);
 
-  // For each sample, calculate the weighted projection onto the current basis.
-  for (size_t i = 0; i < numSamples; i++)
+  // If two additional vectors are passed, take their projections.
+  if (addBasisVector1 && addBasisVector2)
   {
-    // Initialize projection as a vector of zeros.
-    arma::vec projection;
-    projection.zeros(projectionSize);
-
-    CosineTree *currentNode;
-    CosineNodeQueue::const_iterator j = treeQueue.begin();
-
-    size_t k = 0;
-    // Compute the projection of the sampled vector onto the existing subspace.
-    for ( ; j != treeQueue.end(); j++, k++)
-    {
-      currentNode = *j;
-
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
-    }
-    // If two additional vectors are passed, take their projections.
-    if (addBasisVector1 && addBasisVector2)
-    {
-      projection(k++) = arma::dot(dataset.col(sampledIndices[i]),
-                                  *addBasisVector1);
-      projection(k) = arma::dot(dataset.col(sampledIndices[i]),
-                                *addBasisVector2);
-    }
-
-    // Calculate the Frobenius norm squared of the projected vector.
-    double frobProjection = arma::norm(projection, "frob");
-    double frobProjectionSquared = frobProjection * frobProjection;
-
-    // Calculate the weighted projection magnitude.
-    weightedMagnitudes(i) = frobProjectionSquared / probabilities(i);
+    projectionsSquared += arma::square(addBasisVector1->t() * samples);
+    projectionsSquared += arma::square(addBasisVector2->t() * samples);
   }
 
+  // Calculate the weighted projection magnitudes.
+  arma::vec weightedMagnitudes = projectionsSquared.t() / probabilities;
+
   // Compute mean and standard deviation of the weighted samples.
   double mu = arma::mean(weightedMagnitudes);
   double sigma = arma::stddev(weightedMagnitudes);
@@ -424,19 +436,21 @@ void CosineTree::CalculateCosines(arma::vec& cosines)
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
-  for (size_t i = 0; i < numColumns; i++)
+  // The squared norms of the columns are already known, so only the dot
+  // products with the splitting point have to be computed.
+  const arma::vec splitPoint = dataset.col(indices[splitPointIndex]);
+  const double splitNorm = std::sqrt(l2NormsSquared(splitPointIndex));
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
     // between two vectors.
-    if (l2NormsSquared(i) == 0)
-    {
-      cosines(i) = 0;
-    }
-    else
+    const double denominator = splitNorm * std::sqrt(l2NormsSquared(i));
+    if (denominator > 0)
     {
-      cosines(i) =
-          std::abs(arma::norm_dot(dataset.col(indices[splitPointIndex]),
-                                  dataset.col(indices[i])));
+      cosines(i) = std::abs(arma::dot(splitPoint, dataset.col(indices[i]))) /
+          denominator;
     }
   }
 }
@@ -446,10 +460,18 @@ void CosineTree::CalculateCentroid()
   // Initialize centroid as vector of zeros.
   centroid.zeros(dataset.n_rows);
 
-  // Calculate centroid of columns in the node.
-  for (size_t i = 0; i < numColumns; i++)
+  // Calculate centroid of columns in the node.  Each thread sums its own
+  // columns, and the partial sums are then added together.
+  #pragma omp parallel
   {
-    centroid += dataset.col(indices[i]);
+    arma::vec threadCentroid(dataset.n_rows, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) numColumns; i++)
+      threadCentroid += dataset.col(indices[i]);
+
+    #pragma omp critical
+    centroid += threadCentroid;
   }
   centroid /= numColumns;
 }
@@ -87,6 +87,22 @@ class CosineTree
                            arma::vec& newBasisVector,
                            arma::vec* addBasisVector = NULL);
 
+  /**
+   * Calculates the orthonormalization of the passed centroid, with respect to
+   * the subspace spanned by the columns of the given orthonormal basis.  The
+   * projections onto all the basis vectors are computed at once, as a
+   * matrix-vector product.
+   *
+   * @param currentBasis Orthonormal basis of the current vector subspace.
+   * @param centroid Centroid of the node being added to the basis.
+   * @param newBasisVector Orthonormalized centroid of the node.
+   * @param addBasisVector Address to additional basis vector.
+   */
+  void ModifiedGramSchmidt(const arma::mat& currentBasis,
+                           const arma::vec& centroid,
+                           arma::vec& newBasisVector,
+                           const arma::vec* addBasisVector = NULL);
+
   /**
    * Estimates the squared error of the projection of the input node's matrix
    * onto the current vector subspace. A normal distribution is fit using
@@ -104,6 +120,22 @@ class CosineTree
                          arma::vec* addBasisVector1 = NULL,
                          arma::vec* addBasisVector2 = NULL);
 
+  /**
+   * Estimates the squared error of the projection of the input node's matrix
+   * onto the subspace spanned by the columns of the given orthonormal basis
+   * (and the additional basis vectors, if given).  The projections of all the
+   * samples are computed at once, as a matrix product.
+   *
+   * @param node Node for which Monte Carlo estimate is calculated.
+   * @param currentBasis Orthonormal basis of the current vector subspace.
+   * @param addBasisVector1 Address to first additional basis vector.
+   * @param addBasisVector2 Address to second additional basis vector.
+   */
+  double MonteCarloError(CosineTree* node,
+                         const arma::mat& currentBasis,
+                         const arma::vec* addBasisVector1 = NULL,
+                         const arma::vec* addBasisVector2 = NULL);
+
   /**
    * Constructs the final basis matrix, after the cosine tree construction.
    *
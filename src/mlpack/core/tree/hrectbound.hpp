@@ -234,6 +234,31 @@ class HRectBound
   ElemType minWidth;
   //! Instantiated metric (likely has size 0).
   MetricType metric;
+
+  /**
+   * The distance calculations are implemented for a compile-time number of
+   * dimensions FixedDim, so that for the common case of two- and
+   * three-dimensional bounds the loops over the dimensions can be unrolled.
+   * The public methods dispatch to FixedDim = 2 or 3 when possible, and to
+   * FixedDim = 0 (meaning that dim is used) otherwise.
+   */
+  template<size_t FixedDim, typename VecType>
+  ElemType MinDistanceImpl(const VecType& point) const;
+  //! Implementation of MinDistance() for bounds; see above.
+  template<size_t FixedDim>
+  ElemType MinDistanceImpl(const HRectBound& other) const;
+  //! Implementation of MaxDistance() for points; see above.
+  template<size_t FixedDim, typename VecType>
+  ElemType MaxDistanceImpl(const VecType& point) const;
+  //! Implementation of MaxDistance() for bounds; see above.
+  template<size_t FixedDim>
+  ElemType MaxDistanceImpl(const HRectBound& other) const;
+  //! Implementation of RangeDistance() for points; see above.
+  template<size_t FixedDim, typename VecType>
+  math::RangeType<ElemType> RangeDistanceImpl(const VecType& point) const;
+  //! Implementation of RangeDistance() for bounds; see above.
+  template<size_t FixedDim>
+  math::RangeType<ElemType> RangeDistanceImpl(const HRectBound& other) const;
 };
 
 // A specialization of BoundTraits for this class.
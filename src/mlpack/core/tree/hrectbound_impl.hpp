@@ -166,13 +166,34 @@ template<typename VecType>
 inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
+{
+  switch (dim)
+  {
+    case 2:
+      return MinDistanceImpl<2>(point);
+    case 3:
+      return MinDistanceImpl<3>(point);
+    default:
+      return MinDistanceImpl<0>(point);
+  }
+}
+
+/**
+ * MinDistance() with a compile-time number of dimensions FixedDim (or dim
+ * dimensions if FixedDim is 0).
+ */
+template<typename MetricType, typename ElemType>
+template<size_t FixedDim, typename VecType>
+inline ElemType HRectBound<MetricType, ElemType>::MinDistanceImpl(
+    const VecType& point) const
 {
   Log::Assert(point.n_elem == dim);
 
   ElemType sum = 0;
 
   ElemType lower, higher;
-  for (size_t d = 0; d < dim; d++)
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
+  for (size_t d = 0; d < n; d++)
   {
     lower = bounds[d].Lo() - point[d];
     higher = point[d] - bounds[d].Hi();
@@ -223,6 +244,26 @@ inline ElemType HRectBound<MetricType, ElemType>::MinDistance(
 template<typename MetricType, typename ElemType>
 ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
     const
+{
+  switch (dim)
+  {
+    case 2:
+      return MinDistanceImpl<2>(other);
+    case 3:
+      return MinDistanceImpl<3>(other);
+    default:
+      return MinDistanceImpl<0>(other);
+  }
+}
+
+/**
+ * MinDistance() with a compile-time number of dimensions FixedDim (or dim
+ * dimensions if FixedDim is 0).
+ */
+template<typename MetricType, typename ElemType>
+template<size_t FixedDim>
+inline ElemType HRectBound<MetricType, ElemType>::MinDistanceImpl(
+    const HRectBound& other) const
 {
   Log::Assert(dim == other.dim);
 
@@ -231,7 +272,8 @@ ElemType HRectBound<MetricType, ElemType>::MinDistance(const HRectBound& other)
   const math::RangeType<ElemType>* obound = other.bounds;
 
   ElemType lower, higher;
-  for (size_t d = 0; d < dim; d++)
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
+  for (size_t d = 0; d < n; d++)
   {
     lower = obound->Lo() - mbound->Hi();
     higher = mbound->Lo() - obound->Hi();
@@ -286,12 +328,33 @@ template<typename VecType>
 inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
+{
+  switch (dim)
+  {
+    case 2:
+      return MaxDistanceImpl<2>(point);
+    case 3:
+      return MaxDistanceImpl<3>(point);
+    default:
+      return MaxDistanceImpl<0>(point);
+  }
+}
+
+/**
+ * MaxDistance() with a compile-time number of dimensions FixedDim (or dim
+ * dimensions if FixedDim is 0).
+ */
+template<typename MetricType, typename ElemType>
+template<size_t FixedDim, typename VecType>
+inline ElemType HRectBound<MetricType, ElemType>::MaxDistanceImpl(
+    const VecType& point) const
 {
   ElemType sum = 0;
 
   Log::Assert(point.n_elem == dim);
 
-  for (size_t d = 0; d < dim; d++)
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
+  for (size_t d = 0; d < n; d++)
   {
     ElemType v = std::max(fabs(point[d] - bounds[d].Lo()),
         fabs(bounds[d].Hi() - point[d]));
@@ -326,13 +389,34 @@ template<typename MetricType, typename ElemType>
 inline ElemType HRectBound<MetricType, ElemType>::MaxDistance(
     const HRectBound& other)
     const
+{
+  switch (dim)
+  {
+    case 2:
+      return MaxDistanceImpl<2>(other);
+    case 3:
+      return MaxDistanceImpl<3>(other);
+    default:
+      return MaxDistanceImpl<0>(other);
+  }
+}
+
+/**
+ * MaxDistance() with a compile-time number of dimensions FixedDim (or dim
+ * dimensions if FixedDim is 0).
+ */
+template<typename MetricType, typename ElemType>
+template<size_t FixedDim>
+inline ElemType HRectBound<MetricType, ElemType>::MaxDistanceImpl(
+    const HRectBound& other) const
 {
   ElemType sum = 0;
 
   Log::Assert(dim == other.dim);
 
   ElemType v;
-  for (size_t d = 0; d < dim; d++)
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
+  for (size_t d = 0; d < n; d++)
   {
     v = std::max(fabs(other.bounds[d].Hi() - bounds[d].Lo()),
         fabs(bounds[d].Hi() - other.bounds[d].Lo()));
@@ -367,6 +451,27 @@ template<typename MetricType, typename ElemType>
 inline math::RangeType<ElemType>
 HRectBound<MetricType, ElemType>::RangeDistance(
     const HRectBound& other) const
+{
+  switch (dim)
+  {
+    case 2:
+      return RangeDistanceImpl<2>(other);
+    case 3:
+      return RangeDistanceImpl<3>(other);
+    default:
+      return RangeDistanceImpl<0>(other);
+  }
+}
+
+/**
+ * RangeDistance() with a compile-time number of dimensions FixedDim (or dim
+ * dimensions if FixedDim is 0).
+ */
+template<typename MetricType, typename ElemType>
+template<size_t FixedDim>
+inline math::RangeType<ElemType>
+HRectBound<MetricType, ElemType>::RangeDistanceImpl(
+    const HRectBound& other) const
 {
   ElemType loSum = 0;
   ElemType hiSum = 0;
@@ -374,7 +479,8 @@ HRectBound<MetricType, ElemType>::RangeDistance(
   Log::Assert(dim == other.dim);
 
   ElemType v1, v2, vLo, vHi;
-  for (size_t d = 0; d < dim; d++)
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
+  for (size_t d = 0; d < n; d++)
   {
     v1 = other.bounds[d].Lo() - bounds[d].Hi();
     v2 = bounds[d].Lo() - other.bounds[d].Hi();
@@ -435,6 +541,27 @@ inline math::RangeType<ElemType>
 HRectBound<MetricType, ElemType>::RangeDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
+{
+  switch (dim)
+  {
+    case 2:
+      return RangeDistanceImpl<2>(point);
+    case 3:
+      return RangeDistanceImpl<3>(point);
+    default:
+      return RangeDistanceImpl<0>(point);
+  }
+}
+
+/**
+ * RangeDistance() with a compile-time number of dimensions FixedDim (or dim
+ * dimensions if FixedDim is 0).
+ */
+template<typename MetricType, typename ElemType>
+template<size_t FixedDim, typename VecType>
+inline math::RangeType<ElemType>
+HRectBound<MetricType, ElemType>::RangeDistanceImpl(
+    const VecType& point) const
 {
   ElemType loSum = 0;
   ElemType hiSum = 0;
@@ -442,7 +569,8 @@ HRectBound<MetricType, ElemType>::RangeDistance(
   Log::Assert(point.n_elem == dim);
 
   ElemType v1, v2, vLo, vHi;
-  for (size_t d = 0; d < dim; d++)
+  const size_t n = (FixedDim == 0) ? dim : FixedDim;
+  for (size_t d = 0; d < n; d++)
   {
     v1 = bounds[d].Lo() - point[d]; // Negative if point[d] > lo.
     v2 = point[d] - bounds[d].Hi(); // Negative if point[d] < hi.
@@ -0,0 +1,261 @@
+/**
+ * @file instrumented_rules.hpp
+ *
+ * InstrumentedRules wraps the rules of a tree traversal and records what the
+ * traversal does with a statistics policy, without changing the traversal.
+ * Any traverser (single-tree, dual-tree, breadth-first, cover tree, rectangle
+ * tree, ...) can be used with the wrapped rules.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_INSTRUMENTED_RULES_HPP
+#define MLPACK_CORE_TREE_INSTRUMENTED_RULES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "batch_base_cases.hpp"
+#include "traversal_statistics.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Rules that forward every call of a traverser to the given rules, and record
+ * the base cases, scores and prunes with the given statistics policy.  A score
+ * (or a rescore) of DBL_MAX is a prune.  With NullTraversalStatistics nothing
+ * is recorded and the calls compile down to the calls to the wrapped rules.
+ *
+ * If the wrapped rules have BatchBaseCases(), so do the instrumented rules, so
+ * that the traversal is the same with and without instrumentation.
+ *
+ * @code
+ * typedef NeighborSearchRules<NearestNS, EuclideanDistance, KDTree<>>
+ *     RuleType;
+ * RuleType rules(...);
+ * InstrumentedRules<RuleType> instrumentedRules(rules);
+ *
+ * KDTree<>::DualTreeTraverser<InstrumentedRules<RuleType>>
+ *     traverser(instrumentedRules);
+ * traverser.Traverse(queryTree, referenceTree);
+ *
+ * instrumentedRules.Statistics().Print(Log::Info);
+ * @endcode
+ *
+ * @tparam RuleType Type of the wrapped rules.
+ * @tparam StatisticsType Statistics policy (TraversalStatistics or
+ *     NullTraversalStatistics).
+ */
+template<typename RuleType,
+         typename StatisticsType = TraversalStatistics,
+         bool HasBatch = HasBatchBaseCases<RuleType>::value>
+class InstrumentedRules
+{
+ public:
+  //! The traversal info type of the wrapped rules.
+  typedef typename RuleType::TraversalInfoType TraversalInfoType;
+
+  //! Wrap the given rules.  They must outlive this object.
+  InstrumentedRules(RuleType& rule) : rule(rule) { }
+
+  //! Compute the base case and count it.
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex)
+  {
+    statistics.AddBaseCases(1);
+    return rule.BaseCase(queryIndex, referenceIndex);
+  }
+
+  //! Score the given query point against the given reference node.
+  template<typename TreeType>
+  double Score(const size_t queryIndex, TreeType& referenceNode)
+  {
+    const double score = rule.Score(queryIndex, referenceNode);
+    statistics.AddScore(referenceNode, score == DBL_MAX);
+    return score;
+  }
+
+  //! Rescore the given query point against the given reference node.
+  template<typename TreeType>
+  double Rescore(const size_t queryIndex,
+                 TreeType& referenceNode,
+                 const double oldScore)
+  {
+    const double score = rule.Rescore(queryIndex, referenceNode, oldScore);
+    if (score == DBL_MAX && oldScore != DBL_MAX)
+      statistics.AddPrune(referenceNode);
+    return score;
+  }
+
+  //! Score the given query node against the given reference node.
+  template<typename TreeType>
+  double Score(TreeType& queryNode, TreeType& referenceNode)
+  {
+    const double score = rule.Score(queryNode, referenceNode);
+    statistics.AddScore(referenceNode, score == DBL_MAX);
+    return score;
+  }
+
+  //! Rescore the given query node against the given reference node.
+  template<typename TreeType>
+  double Rescore(TreeType& queryNode,
+                 TreeType& referenceNode,
+                 const double oldScore)
+  {
+    const double score = rule.Rescore(queryNode, referenceNode, oldScore);
+    if (score == DBL_MAX && oldScore != DBL_MAX)
+      statistics.AddPrune(referenceNode);
+    return score;
+  }
+
+  //! Get the best child of the given reference node (for greedy traversals).
+  template<typename QueryType, typename TreeType>
+  size_t GetBestChild(QueryType& query, TreeType& referenceNode)
+  {
+    return rule.GetBestChild(query, referenceNode);
+  }
+
+  //! Get the traversal info of the wrapped rules.
+  const TraversalInfoType& TraversalInfo() const
+  { return rule.TraversalInfo(); }
+  //! Modify the traversal info of the wrapped rules.
+  TraversalInfoType& TraversalInfo() { return rule.TraversalInfo(); }
+
+  //! Get the wrapped rules.
+  RuleType& Rules() { return rule; }
+
+  //! Get the recorded statistics.
+  const StatisticsType& Statistics() const { return statistics; }
+  //! Modify the recorded statistics.
+  StatisticsType& Statistics() { return statistics; }
+
+ protected:
+  //! The wrapped rules.
+  RuleType& rule;
+  //! The recorded statistics.
+  StatisticsType statistics;
+};
+
+/**
+ * InstrumentedRules for rules that compute blocks of base cases with
+ * BatchBaseCases().
+ */
+template<typename RuleType, typename StatisticsType>
+class InstrumentedRules<RuleType, StatisticsType, true> :
+    public InstrumentedRules<RuleType, StatisticsType, false>
+{
+ public:
+  //! Wrap the given rules.  They must outlive this object.
+  InstrumentedRules(RuleType& rule) :
+      InstrumentedRules<RuleType, StatisticsType, false>(rule) { }
+
+  //! Compute a block of base cases and count them.
+  void BatchBaseCases(const std::vector<size_t>& queryIndices,
+                      const size_t referenceBegin,
+                      const size_t referenceCount)
+  {
+    this->statistics.AddBaseCases(queryIndices.size() * referenceCount);
+    this->rule.BatchBaseCases(queryIndices, referenceBegin, referenceCount);
+  }
+};
+
+/**
+ * Traverse the given reference tree with each of the query points in the range
+ * [queryBegin, queryBegin + queryCount), using a single-tree traverser of the
+ * given type.  If statistics is not NULL, the rules are instrumented and the
+ * statistics of the traversal are added to it; otherwise the rules are used
+ * directly.
+ *
+ * @param rules Rules of the traversal.
+ * @param queryBegin Index of the first query point.
+ * @param queryCount Number of query points.
+ * @param referenceNode Root of the reference tree.
+ * @param statistics Statistics to add to, or NULL.
+ */
+template<template<typename> class TraverserType,
+         typename RuleType,
+         typename TreeType>
+void SingleTreeTraversal(RuleType& rules,
+                         const size_t queryBegin,
+                         const size_t queryCount,
+                         TreeType& referenceNode,
+                         TraversalStatistics* statistics = NULL)
+{
+  if (statistics)
+  {
+    InstrumentedRules<RuleType> instrumentedRules(rules);
+    TraverserType<InstrumentedRules<RuleType>> traverser(instrumentedRules);
+    for (size_t i = queryBegin; i < queryBegin + queryCount; ++i)
+      traverser.Traverse(i, referenceNode);
+
+    statistics->Merge(instrumentedRules.Statistics());
+  }
+  else
+  {
+    TraverserType<RuleType> traverser(rules);
+    for (size_t i = queryBegin; i < queryBegin + queryCount; ++i)
+      traverser.Traverse(i, referenceNode);
+  }
+}
+
+/**
+ * Traverse the given reference tree with each of the first numQueries query
+ * points, using a single-tree traverser of the given type.  If statistics is
+ * not NULL, the rules are instrumented and the statistics of the traversal
+ * are added to it; otherwise the rules are used directly.
+ *
+ * @param rules Rules of the traversal.
+ * @param numQueries Number of query points.
+ * @param referenceNode Root of the reference tree.
+ * @param statistics Statistics to add to, or NULL.
+ */
+template<template<typename> class TraverserType,
+         typename RuleType,
+         typename TreeType>
+void SingleTreeTraversal(RuleType& rules,
+                         const size_t numQueries,
+                         TreeType& referenceNode,
+                         TraversalStatistics* statistics = NULL)
+{
+  SingleTreeTraversal<TraverserType>(rules, 0, numQueries, referenceNode,
+      statistics);
+}
+
+/**
+ * Traverse the given query and reference trees with a dual-tree traverser of
+ * the given type.  If statistics is not NULL, the rules are instrumented and
+ * the statistics of the traversal are added to it; otherwise the rules are used
+ * directly.
+ *
+ * @param rules Rules of the traversal.
+ * @param queryNode Root of the query tree.
+ * @param referenceNode Root of the reference tree.
+ * @param statistics Statistics to add to, or NULL.
+ */
+template<template<typename> class TraverserType,
+         typename RuleType,
+         typename TreeType>
+void DualTreeTraversal(RuleType& rules,
+                       TreeType& queryNode,
+                       TreeType& referenceNode,
+                       TraversalStatistics* statistics = NULL)
+{
+  if (statistics)
+  {
+    InstrumentedRules<RuleType> instrumentedRules(rules);
+    TraverserType<InstrumentedRules<RuleType>> traverser(instrumentedRules);
+    traverser.Traverse(queryNode, referenceNode);
+
+    statistics->Merge(instrumentedRules.Statistics());
+  }
+  else
+  {
+    TraverserType<RuleType> traverser(rules);
+    traverser.Traverse(queryNode, referenceNode);
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
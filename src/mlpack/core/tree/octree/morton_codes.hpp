@@ -0,0 +1,229 @@
+/**
+ * @file morton_codes.hpp
+ *
+ * Utilities for the Morton-sorted construction of the Octree: the computation
+ * of the octree codes (Morton codes of the quantized points) of a dataset, and
+ * a radix sort of the codes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_OCTREE_MORTON_CODES_HPP
+#define MLPACK_CORE_TREE_OCTREE_MORTON_CODES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/threads.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Return the number of levels of the octree codes of points of the given
+ * dimensionality, that is the number of bits each coordinate is quantized to.
+ * At least 21 bits are used for each coordinate, and as many more as fit in
+ * the 64-bit words the code takes anyway, up to 32.
+ */
+inline size_t OctreeCodeLevels(const size_t dimensionality)
+{
+  const size_t words = (21 * dimensionality + 63) / 64;
+  return std::min((size_t) 32, 64 * words / dimensionality);
+}
+
+/**
+ * Compute the octree code of each point of the dataset.  Each coordinate is
+ * quantized to the given number of levels inside the cube of the given width
+ * whose lowest corner is lo, and the bits of the coordinates are interleaved,
+ * from the highest level down (so the code is the Morton code of the
+ * quantized point).  At each level the bit of dimension d has weight 2^d in
+ * the digit of the level, which is the index of the child of the octree node
+ * holding the point.
+ *
+ * The codes are stored as columns of 64-bit words, the first word holding the
+ * most significant bits, so sorting the columns lexicographically sorts the
+ * points in depth-first order of the octree.  The codes are computed in
+ * parallel.
+ *
+ * @param dataset Points to compute the codes of.
+ * @param lo Lowest corner of the cube to quantize in.
+ * @param width Width of the cube to quantize in.
+ * @param levels Number of levels (bits of each quantized coordinate).
+ * @param codes Filled with the code of each point.
+ */
+template<typename MatType>
+void OctreeCodes(const MatType& dataset,
+                 const arma::vec& lo,
+                 const double width,
+                 const size_t levels,
+                 arma::Mat<uint64_t>& codes)
+{
+  const size_t dims = dataset.n_rows;
+  const size_t words = (dims * levels + 63) / 64;
+  const double cells = std::ldexp(1.0, (int) levels);
+  const double scale = (width > 0.0) ? cells / width : 0.0;
+  const uint64_t maxCell = ((uint64_t) 1 << levels) - 1;
+
+  codes.zeros(words, dataset.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+  {
+    uint64_t* code = codes.colptr(i);
+    for (size_t d = 0; d < dims; ++d)
+    {
+      // Quantize the coordinate; the points on the upper faces of the cube go
+      // in the last cell.
+      const double x = std::floor((dataset(d, i) - lo[d]) * scale);
+      const uint64_t q = (x <= 0.0) ? 0 :
+          std::min((uint64_t) x, maxCell);
+
+      for (size_t l = 0; l < levels; ++l)
+      {
+        if (((q >> (levels - 1 - l)) & 1) == 0)
+          continue;
+
+        const size_t pos = l * dims + (dims - 1 - d);
+        code[pos / 64] |= (uint64_t) 1 << (63 - pos % 64);
+      }
+    }
+  }
+}
+
+/**
+ * Return the digit of the given octree code at the given level: the index of
+ * the child that holds the point at that level.
+ *
+ * @param code Code of the point.
+ * @param dims Dimensionality of the points.
+ * @param level Level to extract the digit of.
+ */
+inline size_t OctreeCodeDigit(const uint64_t* code,
+                              const size_t dims,
+                              const size_t level)
+{
+  size_t digit = 0;
+  for (size_t d = 0; d < dims; ++d)
+  {
+    const size_t pos = level * dims + (dims - 1 - d);
+    if ((code[pos / 64] >> (63 - pos % 64)) & 1)
+      digit |= (size_t) 1 << d;
+  }
+
+  return digit;
+}
+
+/**
+ * Return the first level at which the two given octree codes differ, or
+ * SIZE_MAX if they are equal.
+ *
+ * @param a First code.
+ * @param b Second code.
+ * @param words Number of words of the codes.
+ * @param dims Dimensionality of the points.
+ */
+inline size_t OctreeCodeSplitLevel(const uint64_t* a,
+                                   const uint64_t* b,
+                                   const size_t words,
+                                   const size_t dims)
+{
+  for (size_t w = 0; w < words; ++w)
+  {
+    uint64_t x = a[w] ^ b[w];
+    if (x == 0)
+      continue;
+
+    size_t pos = 64 * w;
+    while ((x >> 63) == 0)
+    {
+      x <<= 1;
+      ++pos;
+    }
+
+    return pos / dims;
+  }
+
+  return SIZE_MAX;
+}
+
+/**
+ * Sort the columns of the given keys lexicographically with a least
+ * significant digit radix sort, and fill order with the index of each key in
+ * sorted order.  The sort is stable.  Each pass over a byte of the keys counts
+ * and scatters contiguous chunks of the keys in parallel; passes over bytes
+ * that are equal in all the keys are skipped.
+ *
+ * @param keys Keys to sort (one column of words per key, the first word being
+ *     the most significant).
+ * @param order Filled with the index of each key, in sorted order.
+ */
+inline void RadixSort(const arma::Mat<uint64_t>& keys,
+                      std::vector<size_t>& order)
+{
+  const size_t n = keys.n_cols;
+  order.resize(n);
+  for (size_t i = 0; i < n; ++i)
+    order[i] = i;
+
+  const size_t chunks = std::max((size_t) 1, std::min(NumThreads(),
+      n / 65536));
+  const size_t chunkSize = (n + chunks - 1) / chunks;
+  std::vector<size_t> counts(256 * chunks);
+  std::vector<size_t> sorted(n);
+
+  for (size_t w = keys.n_rows; w > 0; --w)
+  {
+    for (size_t shift = 0; shift < 64; shift += 8)
+    {
+      const uint64_t* word = keys.memptr() + (w - 1);
+      const size_t stride = keys.n_rows;
+
+      // Count the keys in each bucket, for each chunk.
+      std::fill(counts.begin(), counts.end(), 0);
+      #pragma omp parallel for num_threads(chunks)
+      for (omp_size_t c = 0; c < (omp_size_t) chunks; ++c)
+      {
+        size_t* chunkCounts = counts.data() + 256 * c;
+        const size_t end = std::min(n, (c + 1) * chunkSize);
+        for (size_t i = c * chunkSize; i < end; ++i)
+          ++chunkCounts[(word[order[i] * stride] >> shift) & 0xFF];
+      }
+
+      // Turn the counts into the position of the first key of each bucket
+      // and chunk.
+      size_t offset = 0;
+      bool skip = false;
+      for (size_t b = 0; b < 256 && !skip; ++b)
+      {
+        const size_t first = offset;
+        for (size_t c = 0; c < chunks; ++c)
+        {
+          const size_t chunkCount = counts[256 * c + b];
+          counts[256 * c + b] = offset;
+          offset += chunkCount;
+        }
+
+        skip = (first == 0 && offset == n);
+      }
+
+      if (skip)
+        continue;
+
+      #pragma omp parallel for num_threads(chunks)
+      for (omp_size_t c = 0; c < (omp_size_t) chunks; ++c)
+      {
+        size_t* chunkOffsets = counts.data() + 256 * c;
+        const size_t end = std::min(n, (c + 1) * chunkSize);
+        for (size_t i = c * chunkSize; i < end; ++i)
+          sorted[chunkOffsets[(word[order[i] * stride] >> shift) & 0xFF]++] =
+              order[i];
+      }
+
+      order.swap(sorted);
+    }
+  }
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
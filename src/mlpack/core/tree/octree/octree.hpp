@@ -19,6 +19,12 @@
 namespace mlpack {
 namespace tree {
 
+/**
+ * A tag that selects the Morton-sorted construction of the Octree: see the
+ * constructors that take a MortonBuild.
+ */
+struct MortonBuild { };
+
 template<typename MetricType = metric::EuclideanDistance,
          typename StatisticType = EmptyStatistic,
          typename MatType = arma::mat>
@@ -157,6 +163,49 @@ class Octree
          std::vector<size_t>& newFromOld,
          const size_t maxLeafSize = 20);
 
+  /**
+   * Construct this as the root node of an octree on the given dataset, with
+   * the Morton-sorted construction.  This copies the dataset.  The octree
+   * code (the Morton code of the point quantized in the bounding cube of the
+   * dataset) of each point is computed in parallel, the points are sorted by
+   * code once with a radix sort, and then the points of each node are a
+   * contiguous range of the sorted codes and the children of the node are
+   * found from the code prefixes, without permuting the points again.  The
+   * children of the root are built in parallel.
+   *
+   * Each node is split at the first level of the octree where the codes of its
+   * points differ, so nodes with a single child are never created; points with
+   * equal codes stay in the same leaf, even if there are more than
+   * maxLeafSize of them.  The bounds of the nodes are the bounding boxes of
+   * their points, as with the other constructors.
+   *
+   * @param data Dataset to create tree from.  This will be copied!
+   * @param oldFromNew Vector which will be filled with the old positions for
+   *      each new point.
+   * @param build Tag selecting the Morton-sorted construction.
+   * @param maxLeafSize Maximum number of points in a leaf node.
+   */
+  Octree(const MatType& data,
+         std::vector<size_t>& oldFromNew,
+         const MortonBuild build,
+         const size_t maxLeafSize = 20);
+
+  /**
+   * Construct this as the root node of an octree on the given dataset, with
+   * the Morton-sorted construction (see the constructor above).  This will
+   * take ownership of the dataset.
+   *
+   * @param data Dataset to create tree from.
+   * @param oldFromNew Vector which will be filled with the old positions for
+   *      each new point.
+   * @param build Tag selecting the Morton-sorted construction.
+   * @param maxLeafSize Maximum number of points in a leaf node.
+   */
+  Octree(MatType&& data,
+         std::vector<size_t>& oldFromNew,
+         const MortonBuild build,
+         const size_t maxLeafSize = 20);
+
   /**
    * Construct this node as a child of the given parent, starting at column
    * begin and using count points.  The ordering of that subset of points in the
@@ -205,6 +254,23 @@ class Octree
          const double width,
          const size_t maxLeafSize = 20);
 
+  /**
+   * Construct this node as a child of the given parent, with the
+   * Morton-sorted construction, starting at column begin and using count
+   * points, whose octree codes are the same columns of the given codes.
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of point to start tree construction with.
+   * @param count Number of points to use to construct tree.
+   * @param codes Octree codes of all the points of the dataset.
+   * @param maxLeafSize Maximum number of points in a leaf node.
+   */
+  Octree(Octree* parent,
+         const size_t begin,
+         const size_t count,
+         const arma::Mat<uint64_t>& codes,
+         const size_t maxLeafSize);
+
   /**
    * Copy the given tree.  Be careful!  This may use a lot of memory.
    *
@@ -425,6 +491,28 @@ class Octree
                  std::vector<size_t>& oldFromNew,
                  const size_t maxLeafSize);
 
+  /**
+   * Build the tree below this root node with the Morton-sorted construction:
+   * compute the octree codes, sort the dataset by code, and split the node.
+   *
+   * @param oldFromNew Filled with the old positions of each new point.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void MortonBuildRoot(std::vector<size_t>& oldFromNew,
+                       const size_t maxLeafSize);
+
+  /**
+   * Split the node at the first level where the octree codes of its points
+   * differ.  The points must be sorted by code.
+   *
+   * @param codes Octree codes of all the points of the dataset.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   * @param parallel Whether to build the children in parallel.
+   */
+  void SplitNodeByCodes(const arma::Mat<uint64_t>& codes,
+                        const size_t maxLeafSize,
+                        const bool parallel);
+
   /**
    * This is used for sorting points while splitting.
    */
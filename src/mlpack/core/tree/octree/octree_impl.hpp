@@ -14,6 +14,7 @@
 
 #include "octree.hpp"
 #include <mlpack/core/tree/perform_split.hpp>
+#include "morton_codes.hpp"
 #include <stack>
 
 namespace mlpack {
@@ -271,6 +272,46 @@ Octree<MetricType, StatisticType, MatType>::Octree(
     newFromOld[oldFromNew[i]] = i;
 }
 
+//! Construct the tree with the Morton-sorted construction.
+template<typename MetricType, typename StatisticType, typename MatType>
+Octree<MetricType, StatisticType, MatType>::Octree(
+    const MatType& dataset,
+    std::vector<size_t>& oldFromNew,
+    const MortonBuild /* build */,
+    const size_t maxLeafSize) :
+    begin(0),
+    count(dataset.n_cols),
+    bound(dataset.n_rows),
+    dataset(new MatType(dataset)),
+    parent(NULL),
+    parentDistance(0.0)
+{
+  MortonBuildRoot(oldFromNew, maxLeafSize);
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
+//! Construct the tree with the Morton-sorted construction.
+template<typename MetricType, typename StatisticType, typename MatType>
+Octree<MetricType, StatisticType, MatType>::Octree(
+    MatType&& dataset,
+    std::vector<size_t>& oldFromNew,
+    const MortonBuild /* build */,
+    const size_t maxLeafSize) :
+    begin(0),
+    count(dataset.n_cols),
+    bound(dataset.n_rows),
+    dataset(new MatType(std::move(dataset))),
+    parent(NULL),
+    parentDistance(0.0)
+{
+  MortonBuildRoot(oldFromNew, maxLeafSize);
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
 //! Construct a child node.
 template<typename MetricType, typename StatisticType, typename MatType>
 Octree<MetricType, StatisticType, MatType>::Octree(
@@ -340,6 +381,39 @@ Octree<MetricType, StatisticType, MatType>::Octree(
   stat = StatisticType(*this);
 }
 
+//! Construct a child node with the Morton-sorted construction.
+template<typename MetricType, typename StatisticType, typename MatType>
+Octree<MetricType, StatisticType, MatType>::Octree(
+    Octree* parent,
+    const size_t begin,
+    const size_t count,
+    const arma::Mat<uint64_t>& codes,
+    const size_t maxLeafSize) :
+    begin(begin),
+    count(count),
+    bound(parent->dataset->n_rows),
+    dataset(parent->dataset),
+    parent(parent)
+{
+  // Calculate empirical center of data.
+  bound |= dataset->cols(begin, begin + count - 1);
+
+  // Now split the node.
+  SplitNodeByCodes(codes, maxLeafSize, false);
+
+  // Calculate the distance from the empirical center of this node to the
+  // empirical center of the parent.
+  arma::vec trueCenter, parentCenter;
+  bound.Center(trueCenter);
+  parent->Bound().Center(parentCenter);
+  parentDistance = metric.Evaluate(trueCenter, parentCenter);
+
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
 //! Copy the given tree.
 template<typename MetricType, typename StatisticType, typename MatType>
 Octree<MetricType, StatisticType, MatType>::Octree(const Octree& other) :
@@ -867,6 +941,99 @@ void Octree<MetricType, StatisticType, MatType>::SplitNode(
   }
 }
 
+//! Build the tree with the Morton-sorted construction.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::MortonBuildRoot(
+    std::vector<size_t>& oldFromNew,
+    const size_t maxLeafSize)
+{
+  if (count == 0)
+  {
+    oldFromNew.clear();
+    furthestDescendantDistance = 0.0;
+    return;
+  }
+
+  // The codes are computed in the bounding cube of the data.
+  bound |= *dataset;
+  arma::vec lo(bound.Dim());
+  double maxWidth = 0.0;
+  for (size_t i = 0; i < bound.Dim(); ++i)
+  {
+    lo[i] = bound[i].Lo();
+    if (bound[i].Hi() - bound[i].Lo() > maxWidth)
+      maxWidth = bound[i].Hi() - bound[i].Lo();
+  }
+
+  arma::Mat<uint64_t> codes;
+  OctreeCodes(*dataset, lo, maxWidth, OctreeCodeLevels(dataset->n_rows),
+      codes);
+  RadixSort(codes, oldFromNew);
+
+  // Sort the points and their codes; after this, the points of every node are
+  // contiguous and no more permutation is needed.
+  MatType sortedData(dataset->n_rows, dataset->n_cols);
+  arma::Mat<uint64_t> sortedCodes(codes.n_rows, codes.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) count; ++i)
+  {
+    sortedData.col(i) = dataset->col(oldFromNew[i]);
+    sortedCodes.col(i) = codes.col(oldFromNew[i]);
+  }
+
+  *dataset = std::move(sortedData);
+  codes.reset();
+
+  SplitNodeByCodes(sortedCodes, maxLeafSize, true);
+
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+}
+
+//! Split the node at the first level where the codes of its points differ.
+template<typename MetricType, typename StatisticType, typename MatType>
+void Octree<MetricType, StatisticType, MatType>::SplitNodeByCodes(
+    const arma::Mat<uint64_t>& codes,
+    const size_t maxLeafSize,
+    const bool parallel)
+{
+  // No need to split if we have fewer than the maximum number of points in this
+  // node.
+  if (count <= maxLeafSize)
+    return;
+
+  // The points are sorted by code, so the codes of all the points share the
+  // prefix where the codes of the first and the last point agree.  If all the
+  // codes are equal, the points can't be split.
+  const size_t dims = dataset->n_rows;
+  const size_t level = OctreeCodeSplitLevel(codes.colptr(begin),
+      codes.colptr(begin + count - 1), codes.n_rows, dims);
+  if (level == SIZE_MAX)
+    return;
+
+  // The points of each child are contiguous; find where each child begins.
+  std::vector<size_t> childBegins(1, begin);
+  size_t digit = OctreeCodeDigit(codes.colptr(begin), dims, level);
+  for (size_t i = begin + 1; i < begin + count; ++i)
+  {
+    const size_t nextDigit = OctreeCodeDigit(codes.colptr(i), dims, level);
+    if (nextDigit != digit)
+    {
+      childBegins.push_back(i);
+      digit = nextDigit;
+    }
+  }
+  childBegins.push_back(begin + count);
+
+  // Now we can create the children.
+  children.resize(childBegins.size() - 1);
+  #pragma omp parallel for schedule(dynamic) if (parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) children.size(); ++i)
+  {
+    children[i] = new Octree(this, childBegins[i],
+        childBegins[i + 1] - childBegins[i], codes, maxLeafSize);
+  }
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -0,0 +1,89 @@
+/**
+ * @file query_subtrees.hpp
+ *
+ * Split a query tree into disjoint subtrees that can be traversed
+ * independently, so that a dual-tree algorithm can traverse each of them
+ * against the reference tree in a different thread.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_QUERY_SUBTREES_HPP
+#define MLPACK_CORE_TREE_QUERY_SUBTREES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "tree_traits.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Split the query tree into (at most) the given number of disjoint subtrees
+ * that can be traversed independently, by repeatedly splitting the largest
+ * non-leaf subtree.  The range of query points held by each subtree is stored
+ * in ranges as (begin, count).  This is only possible for binary trees that
+ * rearrange the dataset, since each node then holds a contiguous range of
+ * points.
+ */
+template<typename TreeType>
+void GetQuerySubtrees(
+    TreeType& queryTree,
+    const size_t numSubtrees,
+    std::vector<TreeType*>& subtrees,
+    std::vector<std::pair<size_t, size_t>>& ranges,
+    typename std::enable_if_t<
+        TreeTraits<TreeType>::RearrangesDataset &&
+        TreeTraits<TreeType>::BinaryTree
+    >* = 0)
+{
+  subtrees.clear();
+  subtrees.push_back(&queryTree);
+  while (subtrees.size() < numSubtrees)
+  {
+    size_t largest = subtrees.size();
+    for (size_t i = 0; i < subtrees.size(); ++i)
+    {
+      if (!subtrees[i]->IsLeaf() && (largest == subtrees.size() ||
+          subtrees[i]->NumDescendants() > subtrees[largest]->NumDescendants()))
+        largest = i;
+    }
+
+    // Every subtree is a leaf, so we can't split any further.
+    if (largest == subtrees.size())
+      break;
+
+    TreeType* node = subtrees[largest];
+    subtrees[largest] = node->Left();
+    subtrees.push_back(node->Right());
+  }
+
+  ranges.clear();
+  for (size_t i = 0; i < subtrees.size(); ++i)
+    ranges.push_back(std::make_pair(subtrees[i]->Begin(),
+        subtrees[i]->Count()));
+}
+
+//! For other trees, the whole query tree must be traversed at once.
+template<typename TreeType>
+void GetQuerySubtrees(
+    TreeType& queryTree,
+    const size_t /* numSubtrees */,
+    std::vector<TreeType*>& subtrees,
+    std::vector<std::pair<size_t, size_t>>& ranges,
+    const typename std::enable_if_t<
+        !TreeTraits<TreeType>::RearrangesDataset ||
+        !TreeTraits<TreeType>::BinaryTree
+    >* = 0)
+{
+  subtrees.clear();
+  subtrees.push_back(&queryTree);
+  ranges.clear();
+  ranges.push_back(std::make_pair(size_t(0), queryTree.Dataset().n_cols));
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * @file bulk_load_traits.hpp
+ *
+ * Definition of the BulkLoadTraits class, which describes whether a
+ * RectangleTree with a given split type may be built by Sort-Tile-Recursive
+ * bulk loading instead of by inserting the points one at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_TRAITS_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_BULK_LOAD_TRAITS_HPP
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * BulkLoadTraits describes whether a RectangleTree that uses the given split
+ * type can be bulk loaded.  Bulk loading only produces the bounds, points and
+ * children of each node, so it is not supported for trees whose split keeps
+ * additional invariants (such as the Hilbert ordering of the Hilbert R tree, or
+ * the maximum bounding rectangles of the R++ tree).  Such trees are always
+ * built by inserting the points one at a time.
+ *
+ * @tparam SplitType The split type of the RectangleTree.
+ */
+template<typename SplitType>
+struct BulkLoadTraits
+{
+  //! Whether trees with this split type can be bulk loaded.
+  static const bool IsSupported = true;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
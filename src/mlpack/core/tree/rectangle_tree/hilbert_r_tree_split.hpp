@@ -14,6 +14,7 @@
 #define MLPACK_CORE_TREE_RECTANGLE_TREE_HILBERT_R_TREE_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "bulk_load_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -90,6 +91,16 @@ class HilbertRTreeSplit
                                        const size_t lastSibling);
 };
 
+/**
+ * The Hilbert R tree keeps the points and children of each node ordered by
+ * their Hilbert values, so it can't be bulk loaded.
+ */
+template<size_t splitOrder>
+struct BulkLoadTraits<HilbertRTreeSplit<splitOrder>>
+{
+  static const bool IsSupported = false;
+};
+
 } // namespace tree
 } // namespace mlpack
 
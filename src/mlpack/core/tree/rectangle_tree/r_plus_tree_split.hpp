@@ -14,6 +14,7 @@
 #define MLPACK_CORE_TREE_RECTANGLE_TREE_R_PLUS_TREE_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "bulk_load_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -125,6 +126,18 @@ class RPlusTreeSplit
   static void InsertNodeIntoTree(TreeType* destTree, TreeType* srcNode);
 };
 
+/**
+ * The R+ and R++ trees must not have overlapping children (and the R++ tree
+ * also maintains the maximum bounding rectangle of each node), so they can't
+ * be bulk loaded.
+ */
+template<typename SplitPolicyType,
+         template<typename> class SweepType>
+struct BulkLoadTraits<RPlusTreeSplit<SplitPolicyType, SweepType>>
+{
+  static const bool IsSupported = false;
+};
+
 } // namespace tree
 } // namespace mlpack
 
@@ -20,6 +20,7 @@
 #include "r_tree_split.hpp"
 #include "r_tree_descent_heuristic.hpp"
 #include "no_auxiliary_information.hpp"
+#include "bulk_load_traits.hpp"
 
 namespace mlpack {
 namespace tree /** Trees and tree-building procedures. */ {
@@ -127,13 +128,18 @@ class RectangleTree
    *      have.
    * @param firstDataIndex The index of the first data point.  UNUSED UNLESS WE
    *      ADD SUPPORT FOR HAVING A "CENTERAL" DATA MATRIX.
+   * @param bulkLoad If true, build the tree with Sort-Tile-Recursive bulk
+   *      loading instead of inserting the points one at a time.  This is much
+   *      faster and gives nearly full nodes, but it is ignored for tree types
+   *      that can't be bulk loaded (see BulkLoadTraits).
    */
   RectangleTree(const MatType& data,
                 const size_t maxLeafSize = 20,
                 const size_t minLeafSize = 8,
                 const size_t maxNumChildren = 5,
                 const size_t minNumChildren = 2,
-                const size_t firstDataIndex = 0);
+                const size_t firstDataIndex = 0,
+                const bool bulkLoad = false);
 
   /**
    * Construct this as the root node of a rectangle tree type using the given
@@ -148,13 +154,18 @@ class RectangleTree
    *      have.
    * @param firstDataIndex The index of the first data point.  UNUSED UNLESS WE
    *      ADD SUPPORT FOR HAVING A "CENTERAL" DATA MATRIX.
+   * @param bulkLoad If true, build the tree with Sort-Tile-Recursive bulk
+   *      loading instead of inserting the points one at a time.  This is much
+   *      faster and gives nearly full nodes, but it is ignored for tree types
+   *      that can't be bulk loaded (see BulkLoadTraits).
    */
   RectangleTree(MatType&& data,
                 const size_t maxLeafSize = 20,
                 const size_t minLeafSize = 8,
                 const size_t maxNumChildren = 5,
                 const size_t minNumChildren = 2,
-                const size_t firstDataIndex = 0);
+                const size_t firstDataIndex = 0,
+                const bool bulkLoad = false);
 
   /**
    * Construct this as an empty node with the specified parent.  Copying the
@@ -542,6 +553,43 @@ class RectangleTree
    */
   void SplitNode(std::vector<bool>& relevels);
 
+  /**
+   * Build the subtree rooted at this (empty) node from the given points, using
+   * Sort-Tile-Recursive packing.  The points are split into as few children as
+   * possible, each child receiving a contiguous tile of roughly the same number
+   * of points, so that all nodes are nearly full and all leaves are on the same
+   * level.
+   *
+   * @param indices Indices of the points; the range that is used is reordered.
+   * @param first Index of the first point of the range in indices.
+   * @param numPoints Number of points in the range.
+   * @param height Height of the subtree (1 if this node is a leaf).
+   */
+  void BulkLoad(std::vector<size_t>& indices,
+                const size_t first,
+                const size_t numPoints,
+                const size_t height);
+
+  /**
+   * Partition the given range of point indices into numGroups contiguous tiles
+   * of roughly equal size: sort along the given dimension, cut into slabs, and
+   * recurse on each slab with the next dimension.  The index of the first point
+   * of each tile is appended to tileBegins.
+   *
+   * @param indices Indices of the points; the range that is used is reordered.
+   * @param first Index of the first point of the range in indices.
+   * @param numPoints Number of points in the range.
+   * @param numGroups Number of tiles to partition the range into.
+   * @param dim Dimension to sort along.
+   * @param tileBegins Vector to append the beginnings of the tiles to.
+   */
+  void SortTileRecursive(std::vector<size_t>& indices,
+                         const size_t first,
+                         const size_t numPoints,
+                         const size_t numGroups,
+                         const size_t dim,
+                         std::vector<size_t>& tileBegins) const;
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
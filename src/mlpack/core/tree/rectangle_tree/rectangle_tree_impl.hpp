@@ -34,7 +34,8 @@ RectangleTree(const MatType& data,
               const size_t minLeafSize,
               const size_t maxNumChildren,
               const size_t minNumChildren,
-              const size_t firstDataIndex) :
+              const size_t firstDataIndex,
+              const bool bulkLoad) :
     maxNumChildren(maxNumChildren),
     minNumChildren(minNumChildren),
     numChildren(0),
@@ -54,6 +55,22 @@ RectangleTree(const MatType& data,
 {
   stat = StatisticType(*this);
 
+  if (bulkLoad && BulkLoadTraits<SplitType>::IsSupported)
+  {
+    std::vector<size_t> indices(dataset->n_cols - firstDataIndex);
+    for (size_t i = 0; i < indices.size(); i++)
+      indices[i] = firstDataIndex + i;
+
+    // Find the smallest height that can hold all of the points.
+    size_t height = 1;
+    for (size_t capacity = maxLeafSize; capacity < indices.size();
+        capacity *= maxNumChildren)
+      height++;
+
+    BulkLoad(indices, 0, indices.size(), height);
+    return;
+  }
+
   // For now, just insert the points in order.
   RectangleTree* root = this;
 
@@ -74,7 +91,8 @@ RectangleTree(MatType&& data,
               const size_t minLeafSize,
               const size_t maxNumChildren,
               const size_t minNumChildren,
-              const size_t firstDataIndex) :
+              const size_t firstDataIndex,
+              const bool bulkLoad) :
     maxNumChildren(maxNumChildren),
     minNumChildren(minNumChildren),
     numChildren(0),
@@ -94,6 +112,22 @@ RectangleTree(MatType&& data,
 {
   stat = StatisticType(*this);
 
+  if (bulkLoad && BulkLoadTraits<SplitType>::IsSupported)
+  {
+    std::vector<size_t> indices(dataset->n_cols - firstDataIndex);
+    for (size_t i = 0; i < indices.size(); i++)
+      indices[i] = firstDataIndex + i;
+
+    // Find the smallest height that can hold all of the points.
+    size_t height = 1;
+    for (size_t capacity = maxLeafSize; capacity < indices.size();
+        capacity *= maxNumChildren)
+      height++;
+
+    BulkLoad(indices, 0, indices.size(), height);
+    return;
+  }
+
   // For now, just insert the points in order.
   RectangleTree* root = this;
 
@@ -234,6 +268,127 @@ RectangleTree(RectangleTree&& other) :
   other.ownsDataset = false;
 }
 
+/**
+ * Build the subtree rooted at this node from the given range of points, using
+ * Sort-Tile-Recursive packing.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    BulkLoad(std::vector<size_t>& indices,
+             const size_t first,
+             const size_t numPoints,
+             const size_t height)
+{
+  if (height == 1)
+  {
+    for (size_t i = 0; i < numPoints; i++)
+    {
+      points[i] = indices[first + i];
+      bound |= dataset->col(points[i]);
+    }
+    count = numPoints;
+  }
+  else
+  {
+    // Each child holds at most childCapacity points, so use as few children as
+    // possible and give all of them roughly the same number of points.
+    size_t childCapacity = maxLeafSize;
+    for (size_t i = 2; i < height; i++)
+      childCapacity *= maxNumChildren;
+    const size_t numGroups = (numPoints + childCapacity - 1) / childCapacity;
+
+    std::vector<size_t> tileBegins;
+    SortTileRecursive(indices, first, numPoints, numGroups, 0, tileBegins);
+    tileBegins.push_back(first + numPoints);
+
+    for (size_t i = 0; i < numGroups; i++)
+    {
+      children[i] = new RectangleTree(this);
+      numChildren++;
+      children[i]->BulkLoad(indices, tileBegins[i],
+          tileBegins[i + 1] - tileBegins[i], height - 1);
+      bound |= children[i]->Bound();
+    }
+  }
+
+  numDescendants = numPoints;
+
+  // The statistic can only be computed once the node is complete.
+  stat = StatisticType(*this);
+}
+
+/**
+ * Partition the given range of points into numGroups tiles of roughly equal
+ * size.
+ */
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<MetricType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+    SortTileRecursive(std::vector<size_t>& indices,
+                      const size_t first,
+                      const size_t numPoints,
+                      const size_t numGroups,
+                      const size_t dim,
+                      std::vector<size_t>& tileBegins) const
+{
+  if (numGroups == 1)
+  {
+    tileBegins.push_back(first);
+    return;
+  }
+
+  // Use the smallest number of slabs such that the remaining dimensions can
+  // be tiled with the same number of slabs each.  In the last dimension, each
+  // slab is a tile.
+  const size_t remainingDims = dataset->n_rows - dim;
+  size_t numSlabs = numGroups;
+  if (remainingDims > 1)
+  {
+    numSlabs = 1;
+    while (std::pow((double) numSlabs, (double) remainingDims) <
+        (double) numGroups)
+      numSlabs++;
+  }
+
+  const MatType& data = *dataset;
+  std::sort(indices.begin() + first, indices.begin() + first + numPoints,
+      [&data, dim](const size_t a, const size_t b)
+      {
+        return data(dim, a) < data(dim, b);
+      });
+
+  // The first (numPoints % numGroups) tiles get one extra point, so that the
+  // sizes of all tiles differ by at most one.
+  const size_t tileSize = numPoints / numGroups;
+  const size_t numLargeTiles = numPoints % numGroups;
+  size_t groupBegin = 0;
+  for (size_t i = 0; i < numSlabs; i++)
+  {
+    const size_t groupEnd = groupBegin + numGroups / numSlabs +
+        (i < numGroups % numSlabs ? 1 : 0);
+    const size_t slabBegin = groupBegin * tileSize +
+        std::min(groupBegin, numLargeTiles);
+    const size_t slabEnd = groupEnd * tileSize +
+        std::min(groupEnd, numLargeTiles);
+
+    SortTileRecursive(indices, first + slabBegin, slabEnd - slabBegin,
+        groupEnd - groupBegin, dim + 1, tileBegins);
+
+    groupBegin = groupEnd;
+  }
+}
+
 /**
  * Construct the tree from a boost::serialization archive.
  */
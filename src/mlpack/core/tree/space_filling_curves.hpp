@@ -0,0 +1,126 @@
+/**
+ * @file space_filling_curves.hpp
+ *
+ * Functions that reorder the points of a dataset along a space-filling curve
+ * (the Morton, or Z-order, curve and the Hilbert curve), so that points that
+ * are close in space are also close in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_SPACE_FILLING_CURVES_HPP
+#define MLPACK_CORE_TREE_SPACE_FILLING_CURVES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "address.hpp"
+#include "rectangle_tree/discrete_hilbert_value.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * Sort the points of the dataset by the given keys (one column of words per
+ * point, compared lexicographically), and permute the dataset accordingly.
+ *
+ * @param dataset Dataset to reorder.
+ * @param keys Key of each point.
+ * @param oldFromNew Filled with the index in the original dataset of each
+ *     point of the reordered dataset.
+ */
+template<typename MatType, typename KeyElemType>
+void ReorderByKeys(MatType& dataset,
+                   const arma::Mat<KeyElemType>& keys,
+                   std::vector<size_t>& oldFromNew)
+{
+  oldFromNew.resize(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    oldFromNew[i] = i;
+
+  // A stable sort keeps identical points in their original order.
+  const size_t words = keys.n_rows;
+  std::stable_sort(oldFromNew.begin(), oldFromNew.end(),
+      [&keys, words](const size_t a, const size_t b)
+      {
+        return std::lexicographical_compare(keys.colptr(a),
+            keys.colptr(a) + words, keys.colptr(b), keys.colptr(b) + words);
+      });
+
+  MatType reordered(dataset.n_rows, dataset.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    reordered.col(i) = dataset.col(oldFromNew[i]);
+
+  dataset = std::move(reordered);
+}
+
+/**
+ * Reorder the points of the dataset along the Morton (Z-order) curve.  The
+ * key of each point is its address (see bound::addr::PointToAddress(), which
+ * is also used by UBTreeSplit), which interleaves the bits of all of its
+ * coordinates at their full precision.  The keys are computed in parallel.
+ *
+ * Trees built on a dataset in this order, and traversals with queries in this
+ * order, access memory with much more locality.  Reorder both the reference
+ * and the query sets before building trees on them; results (which refer to
+ * the points of the reordered sets) are mapped back with oldFromNew.
+ *
+ * @param dataset Dataset to reorder.
+ * @param oldFromNew Filled with the index in the original dataset of each
+ *     point of the reordered dataset.
+ */
+template<typename MatType>
+void MortonOrder(MatType& dataset, std::vector<size_t>& oldFromNew)
+{
+  typedef typename MatType::elem_type ElemType;
+  typedef typename std::conditional<sizeof(ElemType) * CHAR_BIT <= 32,
+                                    uint32_t,
+                                    uint64_t>::type AddressElemType;
+
+  arma::Mat<AddressElemType> keys(dataset.n_rows, dataset.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+  {
+    arma::Col<AddressElemType> address(keys.colptr(i), keys.n_rows, false,
+        true);
+    bound::addr::PointToAddress(address, dataset.col(i));
+  }
+
+  ReorderByKeys(dataset, keys, oldFromNew);
+}
+
+/**
+ * Reorder the points of the dataset along the Hilbert curve.  The key of each
+ * point is its discrete Hilbert value, at the full precision of its
+ * coordinates (see DiscreteHilbertValue, which is also used by the Hilbert
+ * R tree).  The keys are computed in parallel.
+ *
+ * Consecutive points on the Hilbert curve are always in neighboring cells, so
+ * the Hilbert order has somewhat better locality than the Morton order, but
+ * its keys take longer to compute.  Reorder both the reference and the query
+ * sets before building trees on them; results (which refer to the points of
+ * the reordered sets) are mapped back with oldFromNew.
+ *
+ * @param dataset Dataset to reorder.
+ * @param oldFromNew Filled with the index in the original dataset of each
+ *     point of the reordered dataset.
+ */
+template<typename MatType>
+void HilbertOrder(MatType& dataset, std::vector<size_t>& oldFromNew)
+{
+  typedef DiscreteHilbertValue<typename MatType::elem_type> HilbertValueType;
+  typedef typename HilbertValueType::HilbertElemType HilbertElemType;
+
+  arma::Mat<HilbertElemType> keys(dataset.n_rows, dataset.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    keys.col(i) = HilbertValueType::CalculateValue(dataset.col(i));
+
+  ReorderByKeys(dataset, keys, oldFromNew);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
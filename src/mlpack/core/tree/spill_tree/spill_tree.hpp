@@ -91,8 +91,12 @@ class SpillTree
   //! children).
   size_t count;
   //! The list of indexes of points contained in this node (non-null for
-  //! leaf nodes).
+  //! leaf nodes).  In a tree that was built or loaded, this is an alias of a
+  //! range of sharedPointsIndex.
   arma::Col<size_t>* pointsIndex;
+  //! The indexes of the points of all the leaves, stored contiguously in
+  //! depth-first order (only held by the root; NULL for other nodes).
+  arma::Col<size_t>* sharedPointsIndex;
   //! Flag to distinguish overlapping nodes from non-overlapping nodes.
   bool overlappingNode;
   //! Splitting hyperplane represented by this node.
@@ -176,6 +180,24 @@ class SpillTree
             const size_t maxLeafSize = 20,
             const double rho = 0.7);
 
+  /**
+   * Construct this as the root node of a hybrid spill tree that only holds the
+   * given points of the dataset.  The tree keeps the indexes of the points in
+   * the dataset, so several trees can be built (for instance in parallel) on
+   * disjoint parts of the same dataset.
+   *
+   * @param data Dataset to create tree from.
+   * @param points Indexes of the points to be included in the tree.
+   * @param tau Overlapping size.
+   * @param maxLeafSize Size of each leaf in the tree.
+   * @param rho Balance threshold.
+   */
+  SpillTree(const MatType& data,
+            const arma::Col<size_t>& points,
+            const double tau = 0,
+            const size_t maxLeafSize = 20,
+            const double rho = 0.7);
+
   /**
    * Construct this node as a child of the given parent, including the given
    * list of points.  This is used for recursive tree-building by the other
@@ -426,6 +448,7 @@ class SpillTree
  private:
   /**
    * Splits the current node, assigning its left and right children recursively.
+   * The children of large nodes are built in parallel.
    *
    * @param points Vector of indexes of points to be included in this node.
    * @param maxLeafSize Maximum number of points held in a leaf.
@@ -452,6 +475,17 @@ class SpillTree
                    const arma::Col<size_t>& points,
                    arma::Col<size_t>& leftPoints,
                    arma::Col<size_t>& rightPoints);
+
+  /**
+   * Move the indexes of the points of all the leaves into one array held by
+   * the root (sharedPointsIndex), in depth-first order, so that the leaves
+   * don't each own a separate allocation and leaves that are traversed one
+   * after the other read neighboring memory.  Points shared by overlapping
+   * leaves are stored once for each leaf, as before.  This must only be called
+   * on the root.
+   */
+  void CompactPointsIndex();
+
  protected:
   /**
    * A default constructor.  This is meant to only be used with
@@ -15,6 +15,7 @@
 #include "spill_tree.hpp"
 
 #include <queue>
+#include <stack>
 
 namespace mlpack {
 namespace tree {
@@ -36,6 +37,7 @@ SpillTree(
     parent(NULL),
     count(0),
     pointsIndex(NULL),
+    sharedPointsIndex(NULL),
     overlappingNode(false),
     hyperplane(),
     bound(data.n_rows),
@@ -51,6 +53,7 @@ SpillTree(
 
   // Do the actual splitting of this node.
   SplitNode(points, maxLeafSize, tau, rho);
+  CompactPointsIndex();
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -73,6 +76,7 @@ SpillTree(
     parent(NULL),
     count(0),
     pointsIndex(NULL),
+    sharedPointsIndex(NULL),
     overlappingNode(false),
     hyperplane(),
     bound(data.n_rows),
@@ -88,6 +92,44 @@ SpillTree(
 
   // Do the actual splitting of this node.
   SplitNode(points, maxLeafSize, tau, rho);
+  CompactPointsIndex();
+
+  // Create the statistic depending on if we are a leaf or not.
+  stat = StatisticType(*this);
+}
+
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+SpillTree(
+    const MatType& data,
+    const arma::Col<size_t>& points,
+    const double tau,
+    const size_t maxLeafSize,
+    const double rho) :
+    left(NULL),
+    right(NULL),
+    parent(NULL),
+    count(0),
+    pointsIndex(NULL),
+    sharedPointsIndex(NULL),
+    overlappingNode(false),
+    hyperplane(),
+    bound(data.n_rows),
+    parentDistance(0), // Parent distance for the root is 0: it has no parent.
+    dataset(&data),
+    localDataset(false)
+{
+  // SplitNode() consumes the list of points, so split a copy of it.
+  arma::Col<size_t> nodePoints(points);
+
+  // Do the actual splitting of this node.
+  SplitNode(nodePoints, maxLeafSize, tau, rho);
+  CompactPointsIndex();
 
   // Create the statistic depending on if we are a leaf or not.
   stat = StatisticType(*this);
@@ -111,6 +153,7 @@ SpillTree(
     parent(parent),
     count(0),
     pointsIndex(NULL),
+    sharedPointsIndex(NULL),
     overlappingNode(false),
     hyperplane(),
     bound(parent->Dataset().n_rows),
@@ -141,6 +184,7 @@ SpillTree(const SpillTree& other) :
     parent(other.parent),
     count(other.count),
     pointsIndex(NULL),
+    sharedPointsIndex(NULL),
     overlappingNode(other.overlappingNode),
     hyperplane(other.hyperplane),
     bound(other.bound),
@@ -170,6 +214,10 @@ SpillTree(const SpillTree& other) :
   if (other.pointsIndex)
     pointsIndex = new arma::Col<size_t>(*other.pointsIndex);
 
+  // The root gathers the copied indexes of the leaves.
+  if (parent == NULL)
+    CompactPointsIndex();
+
   // Propagate matrix, but only if we are the root.
   if (parent == NULL && localDataset)
   {
@@ -208,6 +256,7 @@ SpillTree(SpillTree&& other) :
     parent(other.parent),
     count(other.count),
     pointsIndex(other.pointsIndex),
+    sharedPointsIndex(other.sharedPointsIndex),
     overlappingNode(other.overlappingNode),
     hyperplane(other.hyperplane),
     bound(std::move(other.bound)),
@@ -224,6 +273,7 @@ SpillTree(SpillTree&& other) :
   other.right = NULL;
   other.count = 0;
   other.pointsIndex = NULL;
+  other.sharedPointsIndex = NULL;
   other.parentDistance = 0.0;
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
@@ -275,6 +325,7 @@ SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   delete left;
   delete right;
   delete pointsIndex;
+  delete sharedPointsIndex;
 
   // If we're the root and we own the dataset, delete it.
   if (!parent && localDataset)
@@ -616,8 +667,49 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
 
   // Now we will recursively split the children by calling their constructors
   // (which perform this splitting process).
-  left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
-  right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+#ifdef HAS_OPENMP
+  // Below this number of points, the overhead of creating a task is not worth
+  // it.
+  const size_t parallelBuildThreshold = 10000;
+
+  // The children only read the dataset and each split their own list of
+  // points, so they can be built at the same time.
+  if (leftPoints.n_elem + rightPoints.n_elem >= parallelBuildThreshold &&
+      NumThreads() > 1)
+  {
+    if (!InParallel())
+    {
+      // This is the first parallel split; create the threads that will work
+      // through the tasks of the rest of the tree.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        {
+          #pragma omp task shared(leftPoints)
+          left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
+
+          right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+
+          #pragma omp taskwait
+        }
+      }
+    }
+    else
+    {
+      #pragma omp task shared(leftPoints)
+      left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
+
+      right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+
+      #pragma omp taskwait
+    }
+  }
+  else
+#endif
+  {
+    left = new SpillTree(this, leftPoints, tau, maxLeafSize, rho);
+    right = new SpillTree(this, rightPoints, tau, maxLeafSize, rho);
+  }
 
   // Update count number, to represent the number of descendant points.
   count = left->NumDescendants() + right->NumDescendants();
@@ -710,6 +802,53 @@ bool SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
   return false;
 }
 
+template<typename MetricType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneMetricType> class HyperplaneType,
+         template<typename SplitMetricType, typename SplitMatType>
+             class SplitType>
+void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
+    CompactPointsIndex()
+{
+  delete sharedPointsIndex;
+  sharedPointsIndex = NULL;
+
+  // The count of each node is the sum of the counts of its children, so the
+  // count of the root is the number of indexes held by all the leaves.
+  if (count == 0)
+    return;
+
+  sharedPointsIndex = new arma::Col<size_t>(count);
+  size_t offset = 0;
+
+  std::stack<SpillTree*> nodes;
+  nodes.push(this);
+  while (!nodes.empty())
+  {
+    SpillTree* node = nodes.top();
+    nodes.pop();
+
+    if (!node->IsLeaf())
+    {
+      // Push the right child first, so that the left subtree comes first.
+      nodes.push(node->right);
+      nodes.push(node->left);
+      continue;
+    }
+
+    const size_t numPoints = node->pointsIndex->n_elem;
+    size_t* nodeIndex = sharedPointsIndex->memptr() + offset;
+    std::copy(node->pointsIndex->begin(), node->pointsIndex->end(), nodeIndex);
+
+    // The leaf now refers to its range of the shared array.
+    delete node->pointsIndex;
+    node->pointsIndex = new arma::Col<size_t>(nodeIndex, numPoints, false,
+        true);
+    offset += numPoints;
+  }
+}
+
 // Default constructor (private), for boost::serialization.
 template<typename MetricType,
          typename StatisticType,
@@ -724,6 +863,7 @@ SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
     parent(NULL),
     count(0),
     pointsIndex(NULL),
+    sharedPointsIndex(NULL),
     overlappingNode(false),
     stat(*this),
     parentDistance(0),
@@ -756,10 +896,12 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
       delete right;
     if (!parent && localDataset)
       delete dataset;
+    delete sharedPointsIndex;
 
     parent = NULL;
     left = NULL;
     right = NULL;
+    sharedPointsIndex = NULL;
   }
 
   ar & BOOST_SERIALIZATION_NVP(count);
@@ -800,6 +942,11 @@ void SpillTree<MetricType, StatisticType, MatType, HyperplaneType, SplitType>::
       right->parent = this;
       right->localDataset = false;
     }
+
+    // Once the whole tree is loaded, the root gathers the indexes of the
+    // leaves.
+    if (!parent)
+      CompactPointsIndex();
   }
 }
 
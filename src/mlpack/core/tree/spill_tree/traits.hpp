@@ -40,6 +40,12 @@ class TreeTraits<SpillTree<MetricType, StatisticType, MatType, HyperplaneType,
    */
   static const bool HasOverlappingChildren = true;
 
+  /**
+   * Overlapping children share points, so points can be included in more than
+   * one node.
+   */
+  static const bool HasDuplicatedPoints = true;
+
   /**
    * There is no guarantee that the first point in a node is its centroid.
    */
@@ -0,0 +1,175 @@
+/**
+ * @file traversal_statistics.hpp
+ *
+ * Policies that record what a tree traversal did: the number of base cases,
+ * and the number of node combinations that were scored and pruned at each
+ * depth of the reference tree.  These are used by InstrumentedRules.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <numeric>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * A statistics policy that records nothing.  All of its methods are empty, so
+ * a traversal with InstrumentedRules<RuleType, NullTraversalStatistics> costs
+ * the same as a traversal with RuleType itself.
+ */
+class NullTraversalStatistics
+{
+ public:
+  //! Record that the given reference node was scored.
+  template<typename TreeType>
+  void AddScore(const TreeType& /* referenceNode */, const bool /* pruned */)
+  { }
+
+  //! Record that the given reference node was pruned when it was rescored.
+  template<typename TreeType>
+  void AddPrune(const TreeType& /* referenceNode */) { }
+
+  //! Record the given number of base cases.
+  void AddBaseCases(const size_t /* count */) { }
+
+  //! Merge the statistics of another traversal.
+  void Merge(const NullTraversalStatistics& /* other */) { }
+};
+
+/**
+ * A statistics policy that counts the base cases of a traversal and, for each
+ * depth of the reference tree, the number of node combinations that were
+ * visited (scored) and the number that were pruned.  The depth of a node is
+ * the number of its ancestors, so the root is at depth 0.
+ *
+ * The per-depth counts show where a traversal spends its time: if few prunes
+ * happen above the leaves, the leaves may be too large or the tree type may be
+ * a poor fit for the data.
+ */
+class TraversalStatistics
+{
+ public:
+  //! Create an empty set of statistics.
+  TraversalStatistics() : baseCases(0) { }
+
+  /**
+   * Record that the given reference node was scored, and whether the score
+   * pruned it.
+   */
+  template<typename TreeType>
+  void AddScore(const TreeType& referenceNode, const bool pruned)
+  {
+    const size_t depth = Grow(referenceNode);
+    ++visits[depth];
+    if (pruned)
+      ++prunes[depth];
+  }
+
+  //! Record that the given reference node was pruned when it was rescored.
+  template<typename TreeType>
+  void AddPrune(const TreeType& referenceNode)
+  {
+    ++prunes[Grow(referenceNode)];
+  }
+
+  //! Record the given number of base cases.
+  void AddBaseCases(const size_t count) { baseCases += count; }
+
+  //! Merge the statistics of another traversal into these.
+  void Merge(const TraversalStatistics& other)
+  {
+    if (other.visits.size() > visits.size())
+    {
+      visits.resize(other.visits.size(), 0);
+      prunes.resize(other.prunes.size(), 0);
+    }
+
+    for (size_t i = 0; i < other.visits.size(); ++i)
+    {
+      visits[i] += other.visits[i];
+      prunes[i] += other.prunes[i];
+    }
+    baseCases += other.baseCases;
+  }
+
+  //! Clear the statistics.
+  void Reset()
+  {
+    visits.clear();
+    prunes.clear();
+    baseCases = 0;
+  }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the total number of visited node combinations.
+  size_t Visits() const
+  {
+    return std::accumulate(visits.begin(), visits.end(), size_t(0));
+  }
+  //! Get the total number of pruned node combinations.
+  size_t Prunes() const
+  {
+    return std::accumulate(prunes.begin(), prunes.end(), size_t(0));
+  }
+
+  //! Get the number of depths at which nodes were visited.
+  size_t Depths() const { return visits.size(); }
+  //! Get the number of node combinations visited at each depth.
+  const std::vector<size_t>& VisitsByDepth() const { return visits; }
+  //! Get the number of node combinations pruned at each depth.
+  const std::vector<size_t>& PrunesByDepth() const { return prunes; }
+
+  /**
+   * Print the statistics to the given stream (for instance Log::Info), with
+   * one line for each depth.
+   */
+  template<typename StreamType>
+  void Print(StreamType& stream) const
+  {
+    stream << "Traversal statistics: " << baseCases << " base cases, "
+        << Visits() << " node visits, " << Prunes() << " prunes." << std::endl;
+    for (size_t i = 0; i < visits.size(); ++i)
+    {
+      stream << "  depth " << i << ": " << visits[i] << " visits, " << prunes[i]
+          << " prunes." << std::endl;
+    }
+  }
+
+ private:
+  //! The number of node combinations visited at each depth.
+  std::vector<size_t> visits;
+  //! The number of node combinations pruned at each depth.
+  std::vector<size_t> prunes;
+  //! The number of base cases.
+  size_t baseCases;
+
+  //! Get the depth of the given node, making room for it in the counts.
+  template<typename TreeType>
+  size_t Grow(const TreeType& node)
+  {
+    size_t depth = 0;
+    for (const TreeType* n = node.Parent(); n != NULL; n = n->Parent())
+      ++depth;
+
+    if (depth >= visits.size())
+    {
+      visits.resize(depth + 1, 0);
+      prunes.resize(depth + 1, 0);
+    }
+
+    return depth;
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * @file tree_cache.cpp
+ *
+ * Implementation of the process-wide cache of tree structures.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "tree_cache.hpp"
+
+#include <atomic>
+#include <list>
+#include <mutex>
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace std;
+
+//! The state of the cache.
+struct TreeCache::CacheState
+{
+  CacheState() : enabled(false), maxTrees(0), hits(0), misses(0) { }
+
+  //! Whether the cache is enabled.
+  atomic<bool> enabled;
+  //! The number of trees the cache can hold.
+  size_t maxTrees;
+  //! The number of hits.
+  atomic<size_t> hits;
+  //! The number of misses.
+  atomic<size_t> misses;
+  //! The cached trees, the most recently used first.
+  list<shared_ptr<const Entry>> entries;
+  //! The lock protecting maxTrees and entries.
+  mutex lock;
+};
+
+TreeCache::CacheState& TreeCache::State()
+{
+  static CacheState state;
+  return state;
+}
+
+void TreeCache::Enable(const size_t maxTrees)
+{
+  CacheState& state = State();
+  lock_guard<mutex> guard(state.lock);
+  state.maxTrees = max((size_t) 1, maxTrees);
+  while (state.entries.size() > state.maxTrees)
+    state.entries.pop_back();
+  state.enabled = true;
+}
+
+void TreeCache::Disable()
+{
+  CacheState& state = State();
+  lock_guard<mutex> guard(state.lock);
+  state.enabled = false;
+  state.entries.clear();
+}
+
+bool TreeCache::Enabled()
+{
+  return State().enabled;
+}
+
+void TreeCache::Clear()
+{
+  CacheState& state = State();
+  lock_guard<mutex> guard(state.lock);
+  state.entries.clear();
+  state.hits = 0;
+  state.misses = 0;
+}
+
+size_t TreeCache::NumTrees()
+{
+  CacheState& state = State();
+  lock_guard<mutex> guard(state.lock);
+  return state.entries.size();
+}
+
+size_t TreeCache::Hits()
+{
+  return State().hits;
+}
+
+size_t TreeCache::Misses()
+{
+  return State().misses;
+}
+
+shared_ptr<const TreeCache::Entry> TreeCache::Find(const Entry& key)
+{
+  CacheState& state = State();
+  lock_guard<mutex> guard(state.lock);
+  for (auto it = state.entries.begin(); it != state.entries.end(); ++it)
+  {
+    const shared_ptr<const Entry> entry = *it;
+    if (entry->type == key.type && entry->rows == key.rows &&
+        entry->cols == key.cols && entry->maxLeafSize == key.maxLeafSize &&
+        entry->hash == key.hash)
+    {
+      // This is now the most recently used tree.
+      state.entries.splice(state.entries.begin(), state.entries, it);
+      return entry;
+    }
+  }
+
+  return shared_ptr<const Entry>();
+}
+
+void TreeCache::Insert(shared_ptr<const Entry> entry)
+{
+  CacheState& state = State();
+  lock_guard<mutex> guard(state.lock);
+
+  // The cache may have been disabled while the tree was built.
+  if (!state.enabled)
+    return;
+
+  state.entries.push_front(entry);
+  while (state.entries.size() > state.maxTrees)
+    state.entries.pop_back();
+}
+
+void TreeCache::Count(const bool hit)
+{
+  if (hit)
+    ++State().hits;
+  else
+    ++State().misses;
+}
@@ -0,0 +1,263 @@
+/**
+ * @file tree_cache.hpp
+ *
+ * A process-wide cache of tree structures, so that algorithms that need trees
+ * with different statistics (for instance NeighborSearch, RangeSearch, KDE,
+ * DBSCAN and DualTreeBoruvka) on the same dataset only split it once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TREE_CACHE_HPP
+#define MLPACK_CORE_TREE_TREE_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <memory>
+#include <typeinfo>
+#include "binary_space_tree/binary_space_tree.hpp"
+#include "statistic.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The structure type of a tree type: the same tree type with an
+ * EmptyStatistic, and whether trees of the type can be built from a tree of
+ * their structure type.  Only binary space trees on dense matrices can be.
+ */
+template<typename TreeType>
+struct TreeStructure
+{
+  //! Whether the structure of the tree type can be cached.
+  static const bool Cacheable = false;
+};
+
+//! Binary space trees can be rebuilt from a tree with another statistic.
+template<typename MetricType,
+         typename StatisticType,
+         typename ElemType,
+         template<typename BoundMetricType, typename...> class BoundType,
+         template<typename SplitBoundType, typename SplitMatType>
+             class SplitType>
+struct TreeStructure<BinarySpaceTree<MetricType, StatisticType,
+    arma::Mat<ElemType>, BoundType, SplitType>>
+{
+  //! Whether the structure of the tree type can be cached.
+  static const bool Cacheable = true;
+
+  //! The type of the cached trees.
+  typedef BinarySpaceTree<MetricType, EmptyStatistic, arma::Mat<ElemType>,
+      BoundType, SplitType> Type;
+};
+
+/**
+ * A process-wide cache of tree structures.  When the cache is enabled, the
+ * algorithms that build trees that rearrange the dataset (NeighborSearch,
+ * RangeSearch, KDE, DualTreeBoruvka, and DBSCAN through RangeSearch) build
+ * them with BuildTree().  The first time a tree of a given structure (the tree
+ * type without its statistic, see TreeStructure) is built on a dataset, a tree
+ * of the structure type is built and kept in the cache; this and every later
+ * request for a tree of that structure on the same dataset only copies the
+ * cached tree, with the statistics of the requested type (see the
+ * corresponding BinarySpaceTree constructor), and the cached mapping of the
+ * points.
+ *
+ * Datasets are matched by their dimensions and a hash of their contents, and a
+ * match is then checked point by point, so a dataset that was modified is
+ * never given a stale tree.  The cache holds a copy of each dataset it holds a
+ * tree for; the least recently used trees are evicted when it is full.
+ *
+ * @code
+ * tree::TreeCache::Enable();
+ *
+ * KNN knn(dataset);                  // The tree is built...
+ * RangeSearch<> rangeSearch(dataset);  // ...and reused here...
+ * DBSCAN<> dbscan(0.5, 5);
+ * dbscan.Cluster(dataset, assignments);  // ...and here.
+ *
+ * tree::TreeCache::Disable();
+ * @endcode
+ *
+ * The cache is safe to use from several threads.
+ */
+class TreeCache
+{
+ public:
+  /**
+   * Enable the cache.  If it is already enabled, only its capacity changes.
+   *
+   * @param maxTrees Number of trees the cache can hold; when it is full, the
+   *     least recently used tree is evicted.
+   */
+  static void Enable(const size_t maxTrees = 4);
+
+  //! Disable the cache, and free the trees it holds.
+  static void Disable();
+
+  //! Return whether the cache is enabled.
+  static bool Enabled();
+
+  //! Free the trees held by the cache, and reset the hit and miss counts.
+  static void Clear();
+
+  //! Get the number of trees held by the cache.
+  static size_t NumTrees();
+
+  //! Get the number of requested trees whose structure was already cached.
+  static size_t Hits();
+
+  //! Get the number of requested trees whose structure had to be built.
+  static size_t Misses();
+
+  /**
+   * Build a tree of the given type on the given dataset, filling oldFromNew
+   * with the mapping of the points, as the tree constructor does.  When the
+   * cache is enabled and the tree type can be cached, the tree is copied from
+   * the cached tree of the same structure on the same dataset, which is built
+   * and cached first if there is none.  Otherwise, the tree is simply built.
+   *
+   * @param dataset Dataset to build the tree on.
+   * @param oldFromNew Filled with the index in the dataset of each point of
+   *     the tree.
+   * @param maxLeafSize Maximum number of points in each leaf.
+   */
+  template<typename TreeType, typename MatType>
+  static TreeType* BuildTree(MatType&& dataset,
+                             std::vector<size_t>& oldFromNew,
+                             const size_t maxLeafSize = 20)
+  {
+    typedef TreeStructure<TreeType> Structure;
+    return BuildTree<TreeType>(std::forward<MatType>(dataset), oldFromNew,
+        maxLeafSize, std::integral_constant<bool, Structure::Cacheable>());
+  }
+
+ private:
+  //! A cached tree, and what it was built on.
+  struct Entry
+  {
+    //! The name of the type of the cached tree.
+    std::string type;
+    //! The number of dimensions of the dataset.
+    size_t rows;
+    //! The number of points of the dataset.
+    size_t cols;
+    //! The maximum leaf size the tree was built with.
+    size_t maxLeafSize;
+    //! The hash of the contents of the dataset.
+    size_t hash;
+    //! The cached tree.
+    std::shared_ptr<void> tree;
+    //! The mapping of the points of the tree.
+    std::vector<size_t> oldFromNew;
+  };
+
+  //! The state of the cache; see tree_cache.cpp.
+  struct CacheState;
+
+  //! Get the state of the cache.
+  static CacheState& State();
+
+  /**
+   * Find the cached tree matching the given entry (on everything but the tree
+   * itself and the mapping), and mark it as the most recently used.  NULL is
+   * returned if there is none.
+   */
+  static std::shared_ptr<const Entry> Find(const Entry& key);
+
+  //! Cache the given tree, evicting the least recently used tree if needed.
+  static void Insert(std::shared_ptr<const Entry> entry);
+
+  //! Count a hit (if hit is true) or a miss.
+  static void Count(const bool hit);
+
+  //! Hash the contents of the given matrix.
+  template<typename ElemType>
+  static size_t Hash(const arma::Mat<ElemType>& dataset)
+  {
+    // FNV-1a, on the bytes of the elements.
+    const unsigned char* bytes = (const unsigned char*) dataset.memptr();
+    const size_t numBytes = dataset.n_elem * sizeof(ElemType);
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < numBytes; ++i)
+    {
+      hash ^= bytes[i];
+      hash *= 1099511628211ULL;
+    }
+
+    return (size_t) hash;
+  }
+
+  //! Build a tree that can be built from a cached tree.
+  template<typename TreeType, typename MatType>
+  static TreeType* BuildTree(MatType&& dataset,
+                             std::vector<size_t>& oldFromNew,
+                             const size_t maxLeafSize,
+                             std::true_type /* cacheable */)
+  {
+    typedef typename TreeStructure<TreeType>::Type StructureType;
+
+    if (!Enabled())
+      return new TreeType(std::forward<MatType>(dataset), oldFromNew,
+          maxLeafSize);
+
+    Entry key;
+    key.type = typeid(StructureType).name();
+    key.rows = dataset.n_rows;
+    key.cols = dataset.n_cols;
+    key.maxLeafSize = maxLeafSize;
+    key.hash = Hash(dataset);
+
+    std::shared_ptr<const Entry> entry = Find(key);
+    if (entry)
+    {
+      // Make sure the dataset is the one the tree was built on.
+      const StructureType& tree = *static_cast<const StructureType*>(
+          entry->tree.get());
+      bool same = true;
+      for (size_t i = 0; i < dataset.n_cols && same; ++i)
+      {
+        same = arma::all(dataset.col(entry->oldFromNew[i]) ==
+            tree.Dataset().col(i));
+      }
+
+      if (!same)
+      {
+        Count(false);
+        return new TreeType(std::forward<MatType>(dataset), oldFromNew,
+            maxLeafSize);
+      }
+
+      Count(true);
+    }
+    else
+    {
+      Count(false);
+      std::shared_ptr<Entry> newEntry = std::make_shared<Entry>(key);
+      newEntry->tree = std::make_shared<StructureType>(
+          std::forward<MatType>(dataset), newEntry->oldFromNew, maxLeafSize);
+      Insert(newEntry);
+      entry = newEntry;
+    }
+
+    oldFromNew = entry->oldFromNew;
+    return new TreeType(*static_cast<const StructureType*>(entry->tree.get()));
+  }
+
+  //! Build a tree that can't be built from a cached tree.
+  template<typename TreeType, typename MatType>
+  static TreeType* BuildTree(MatType&& dataset,
+                             std::vector<size_t>& oldFromNew,
+                             const size_t maxLeafSize,
+                             std::false_type /* cacheable */)
+  {
+    return new TreeType(std::forward<MatType>(dataset), oldFromNew,
+        maxLeafSize);
+  }
+};
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
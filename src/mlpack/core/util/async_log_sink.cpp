@@ -0,0 +1,310 @@
+/**
+ * @file async_log_sink.cpp
+ *
+ * Implementation of the asynchronous log sink.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "async_log_sink.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace mlpack;
+using namespace mlpack::util;
+using namespace std;
+
+atomic<bool> AsyncLogSink::enabled(false);
+
+namespace {
+
+//! A line to write, and where to write it.
+struct LogEntry
+{
+  ostream* destination;
+  string text;
+};
+
+/**
+ * A single-producer, single-consumer ring buffer of log entries.  Only the
+ * thread that owns the ring pushes, and only the writer thread pops, so no
+ * lock is needed.  The strings of popped entries are swapped back into their
+ * slots, so that their memory is reused.
+ */
+class LogRing
+{
+ public:
+  LogRing(const size_t capacity) :
+      orphaned(false),
+      entries(capacity + 1),
+      head(0),
+      tail(0)
+  { }
+
+  //! Push the given entry; return false if the ring is full.
+  bool Push(LogEntry& entry)
+  {
+    const size_t t = tail.load(memory_order_relaxed);
+    const size_t next = (t + 1) % entries.size();
+    if (next == head.load(memory_order_acquire))
+      return false;
+
+    entries[t].destination = entry.destination;
+    entries[t].text.swap(entry.text);
+    tail.store(next, memory_order_release);
+    return true;
+  }
+
+  //! Pop an entry into the given entry; return false if the ring is empty.
+  bool Pop(LogEntry& entry)
+  {
+    const size_t h = head.load(memory_order_relaxed);
+    if (h == tail.load(memory_order_acquire))
+      return false;
+
+    entry.destination = entries[h].destination;
+    entry.text.swap(entries[h].text);
+    head.store((h + 1) % entries.size(), memory_order_release);
+    return true;
+  }
+
+  //! Return whether the ring is empty.
+  bool Empty() const
+  {
+    return head.load(memory_order_acquire) == tail.load(memory_order_acquire);
+  }
+
+  //! Set when the owning thread has exited.
+  atomic<bool> orphaned;
+
+ private:
+  //! The slots (one is always left empty).
+  vector<LogEntry> entries;
+  //! The next slot to pop.
+  atomic<size_t> head;
+  //! The next slot to push.
+  atomic<size_t> tail;
+};
+
+//! The state shared by the logging threads and the writer thread.
+struct SinkState
+{
+  SinkState() : capacity(4096), running(false), pushed(0), written(0) { }
+
+  //! Protects the list of rings.
+  mutex ringsMutex;
+  //! The rings of all threads that have logged.
+  vector<shared_ptr<LogRing>> rings;
+  //! Serializes Start() and Stop().
+  mutex controlMutex;
+  //! The writer thread.
+  thread writer;
+  //! The capacity of new rings.
+  size_t capacity;
+  //! Whether the writer thread should keep running.
+  atomic<bool> running;
+  //! The number of entries pushed so far.
+  atomic<size_t> pushed;
+  //! The number of entries written so far.
+  atomic<size_t> written;
+};
+
+SinkState& State()
+{
+  static SinkState state;
+  return state;
+}
+
+/**
+ * The ring and the partial lines of a thread.  When the thread exits, its
+ * partial lines are pushed and its ring is left for the writer to drain and
+ * discard.
+ */
+struct ThreadLog
+{
+  ~ThreadLog();
+
+  //! Push the partial lines.
+  void PushPending();
+
+  //! The ring of the thread, created when it first logs.
+  shared_ptr<LogRing> ring;
+  //! The partial line of each stream, and its destination.
+  unordered_map<const void*, pair<ostream*, string>> pending;
+};
+
+// Trivially destructible, so it can still be read after the ThreadLog of the
+// thread is destroyed (e.g. by Stop() when the program exits).
+thread_local bool threadLogDestroyed = false;
+
+ThreadLog& LocalLog()
+{
+  thread_local ThreadLog log;
+  return log;
+}
+
+//! Push the given entry to the ring of the given thread, waiting if it is full.
+void Push(ThreadLog& log, LogEntry& entry)
+{
+  SinkState& state = State();
+  if (!log.ring)
+  {
+    log.ring = make_shared<LogRing>(state.capacity);
+    lock_guard<mutex> lock(state.ringsMutex);
+    state.rings.push_back(log.ring);
+  }
+
+  while (!log.ring->Push(entry))
+    this_thread::yield();
+  state.pushed.fetch_add(1, memory_order_release);
+}
+
+void ThreadLog::PushPending()
+{
+  for (auto& p : pending)
+  {
+    if (p.second.second.empty())
+      continue;
+
+    LogEntry entry;
+    entry.destination = p.second.first;
+    entry.text.swap(p.second.second);
+    Push(*this, entry);
+  }
+}
+
+ThreadLog::~ThreadLog()
+{
+  if (AsyncLogSink::Enabled())
+    PushPending();
+  if (ring)
+    ring->orphaned.store(true, memory_order_release);
+  threadLogDestroyed = true;
+}
+
+//! Drain the rings until the sink is stopped and everything is written.
+void WriterLoop()
+{
+  SinkState& state = State();
+  LogEntry entry;
+  vector<ostream*> destinations;
+  while (true)
+  {
+    size_t count = 0;
+    {
+      lock_guard<mutex> lock(state.ringsMutex);
+      for (size_t i = 0; i < state.rings.size(); ++i)
+      {
+        while (state.rings[i]->Pop(entry))
+        {
+          entry.destination->write(entry.text.data(), entry.text.size());
+          if (std::find(destinations.begin(), destinations.end(),
+              entry.destination) == destinations.end())
+            destinations.push_back(entry.destination);
+          ++count;
+        }
+      }
+
+      // Discard the drained rings of threads that have exited.
+      state.rings.erase(std::remove_if(state.rings.begin(), state.rings.end(),
+          [](const shared_ptr<LogRing>& ring)
+          {
+            return ring->orphaned.load(memory_order_acquire) && ring->Empty();
+          }), state.rings.end());
+    }
+
+    // Flush once per batch, not once per line.
+    for (size_t i = 0; i < destinations.size(); ++i)
+      destinations[i]->flush();
+    destinations.clear();
+    state.written.fetch_add(count, memory_order_release);
+
+    if (count == 0)
+    {
+      if (!state.running.load(memory_order_acquire))
+        break;
+      this_thread::sleep_for(chrono::milliseconds(1));
+    }
+  }
+}
+
+} // anonymous namespace
+
+void AsyncLogSink::Start(const size_t capacity)
+{
+  SinkState& state = State();
+  lock_guard<mutex> lock(state.controlMutex);
+  if (state.running.load())
+    return;
+
+  // Make sure the pending lines are written when the program exits.
+  static bool registered = false;
+  if (!registered)
+  {
+    std::atexit(AsyncLogSink::Stop);
+    registered = true;
+  }
+
+  state.capacity = std::max(capacity, (size_t) 1);
+  state.running.store(true, memory_order_release);
+  state.writer = thread(WriterLoop);
+  enabled.store(true, memory_order_release);
+}
+
+void AsyncLogSink::Stop()
+{
+  SinkState& state = State();
+  lock_guard<mutex> lock(state.controlMutex);
+  if (!state.running.load())
+    return;
+
+  if (!threadLogDestroyed)
+    LocalLog().PushPending();
+
+  // Anything logged from now on is written directly.
+  enabled.store(false, memory_order_release);
+  state.running.store(false, memory_order_release);
+  state.writer.join();
+}
+
+void AsyncLogSink::Flush()
+{
+  if (!Enabled())
+    return;
+
+  SinkState& state = State();
+  const size_t target = state.pushed.load(memory_order_acquire);
+  while (state.written.load(memory_order_acquire) < target)
+    this_thread::sleep_for(chrono::microseconds(100));
+}
+
+void AsyncLogSink::Write(ostream& destination, string&& text)
+{
+  if (!Enabled() || threadLogDestroyed)
+  {
+    destination.write(text.data(), text.size());
+    destination.flush();
+    return;
+  }
+
+  LogEntry entry;
+  entry.destination = &destination;
+  entry.text.swap(text);
+  Push(LocalLog(), entry);
+}
+
+string& AsyncLogSink::PendingLine(const void* stream, ostream& destination)
+{
+  pair<ostream*, string>& pending = LocalLog().pending[stream];
+  pending.first = &destination;
+  return pending.second;
+}
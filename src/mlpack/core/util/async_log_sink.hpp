@@ -0,0 +1,93 @@
+/**
+ * @file async_log_sink.hpp
+ *
+ * An optional asynchronous backend for the Log streams.  When it is started,
+ * Log::Info, Log::Warn and Log::Debug no longer write to their destination
+ * stream on the calling thread: each complete line is put into a per-thread
+ * ring buffer, and one background thread drains the ring buffers and writes
+ * the lines.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_ASYNC_LOG_SINK_HPP
+#define MLPACK_CORE_UTIL_ASYNC_LOG_SINK_HPP
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <mlpack/mlpack_export.hpp>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * The asynchronous log sink.  Logging threads only format their output and
+ * push whole lines into their own single-producer, single-consumer ring
+ * buffer, without taking any lock; the writer thread polls the ring buffers,
+ * writes the lines, and flushes the destination streams once per batch
+ * instead of once per line.  Since lines are written whole, lines logged
+ * concurrently by several (e.g. OpenMP) threads are never interleaved.  The
+ * lines of one thread are written in order; lines of different threads may be
+ * reordered by a few milliseconds.
+ *
+ * Log::Fatal is always written synchronously, after all the pending lines.
+ *
+ * @code
+ * util::AsyncLogSink::Start();
+ * // ... run something that logs from inner loops ...
+ * util::AsyncLogSink::Stop();
+ * @endcode
+ *
+ * The command-line programs start the sink when --async_log is given.
+ */
+class AsyncLogSink
+{
+ public:
+  /**
+   * Start the writer thread.  If the sink is already running, nothing
+   * happens.
+   *
+   * @param capacity Number of lines each thread's ring buffer can hold.  A
+   *     thread whose ring buffer is full waits for the writer.
+   */
+  static void Start(const size_t capacity = 4096);
+
+  /**
+   * Write all the pending lines, and stop the writer thread.  The pending
+   * partial line of the calling thread, if any, is written too.  No other
+   * thread should log while Stop() runs.
+   */
+  static void Stop();
+
+  //! Wait until all the lines pushed so far have been written.
+  static void Flush();
+
+  //! Return whether the sink is running.
+  static bool Enabled() { return enabled.load(std::memory_order_acquire); }
+
+  /**
+   * Push the given text (usually a complete line) to be written to the given
+   * stream.  If the sink is not running, the text is written directly.
+   */
+  static void Write(std::ostream& destination, std::string&& text);
+
+  /**
+   * Get the partial line that the calling thread is building with the given
+   * stream (a PrefixedOutStream) for the given destination.  Partial lines are
+   * pushed by Stop() and when their thread exits.
+   */
+  static std::string& PendingLine(const void* stream,
+                                  std::ostream& destination);
+
+ private:
+  //! Whether the sink is running.
+  static MLPACK_EXPORT std::atomic<bool> enabled;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -171,9 +171,31 @@ void CLI::SetPassed(const std::string& name)
   GetSingleton().parameters[name].wasPassed = true;
 }
 
+// Wait for the loads running in the background.
+void CLI::WaitForPendingLoads()
+{
+  std::map<std::string, std::future<void>>& loads =
+      GetSingleton().pendingLoads;
+  for (std::map<std::string, std::future<void>>::iterator it = loads.begin();
+       it != loads.end(); ++it)
+  {
+    try
+    {
+      it->second.get();
+    }
+    catch (std::exception& /* e */)
+    {
+      // The error is reported when the parameter is used.
+    }
+  }
+  loads.clear();
+}
+
 // Store settings.
 void CLI::StoreSettings(const std::string& name)
 {
+  WaitForPendingLoads();
+
   // Take all of the parameters and put them in the map.  Clear anything old
   // first.
   std::get<0>(GetSingleton().storageMap[name]) = GetSingleton().parameters;
@@ -186,6 +208,8 @@ void CLI::StoreSettings(const std::string& name)
 // Restore settings.
 void CLI::RestoreSettings(const std::string& name, const bool fatal)
 {
+  WaitForPendingLoads();
+
   if (GetSingleton().storageMap.count(name) == 0 && fatal)
   {
     throw std::invalid_argument("no settings stored under the name '" + name
@@ -207,6 +231,8 @@ void CLI::RestoreSettings(const std::string& name, const bool fatal)
 // Clear settings.
 void CLI::ClearSettings()
 {
+  WaitForPendingLoads();
+
   // Check for any parameters we need to keep.
   std::map<std::string, util::ParamData> persistent;
   std::map<char, std::string> persistentAliases;
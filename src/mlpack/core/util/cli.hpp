@@ -14,6 +14,7 @@
 #ifndef MLPACK_CORE_UTIL_CLI_HPP
 #define MLPACK_CORE_UTIL_CLI_HPP
 
+#include <future>
 #include <list>
 #include <iostream>
 #include <map>
@@ -276,6 +277,13 @@ class CLI
    */
   static void ClearSettings();
 
+  /**
+   * Wait for all the loads of input files that run in the background (see
+   * pendingLoads).  Their errors are ignored: the load of a parameter is
+   * repeated, and its error reported, when the parameter is used.
+   */
+  static void WaitForPendingLoads();
+
  private:
   //! Convenience map from alias values to names.
   std::map<char, std::string> aliases;
@@ -305,6 +313,11 @@ class CLI
   //! Holds the timer objects.
   Timers timer;
 
+  //! The loads of the input files of a command-line program that run in the
+  //! background, by name of the parameter.  They write to the parameters, so
+  //! they are waited for before the parameters are stored or cleared.
+  std::map<std::string, std::future<void>> pendingLoads;
+
   //! So that Timer::Start() and Timer::Stop() can access the timer variable.
   friend class Timer;
 
@@ -61,10 +61,12 @@ static void mlpackMain(); // This is typically defined after this include.
 
 int main(int argc, char** argv)
 {
-  // Parse the command-line options; put them into CLI.
-  mlpack::bindings::cli::ParseCommandLine(argc, argv);
-  // Enable timing.
+  // Enable timing, so that the loads of the input files started while parsing
+  // are timed.
   mlpack::Timer::EnableTiming();
+  // Parse the command-line options; put them into CLI.  This starts loading
+  // the input files in the background.
+  mlpack::bindings::cli::ParseCommandLine(argc, argv);
 
   // A "total_time" timer is run by default for each mlpack program.
   mlpack::Timer::Start("total_time");
@@ -203,6 +205,18 @@ PARAM_FLAG("verbose", "Display informational messages and the full list of "
 PARAM_FLAG("help", "Default help info.", "h");
 PARAM_STRING_IN("info", "Print help on a specific option.", "", "");
 PARAM_FLAG("version", "Display the version of mlpack.", "V");
+PARAM_INT_IN("threads", "Maximum number of threads to use (0 uses one thread "
+    "per processor).", "", 0);
+PARAM_STRING_IN("timers_file", "File to write the program timers to, as JSON.",
+    "", "");
+PARAM_FLAG("async_log", "Write log messages from a background thread, so that "
+    "logging does not slow down the computation.", "");
+PARAM_STRING_IN("thread_affinity", "How to pin the threads to processors: "
+    "'none', 'compact' (fill one socket at a time) or 'spread' (spread "
+    "threads over the sockets).", "", "none");
+PARAM_STRING_IN("memory_placement", "How to place loaded matrices in memory "
+    "on machines with several NUMA nodes: 'default', 'first_touch' or "
+    "'interleave'.", "", "default");
 
 // Python-specific parameters.
 PARAM_FLAG("copy_all_inputs", "If specified, all input parameters will be deep"
@@ -0,0 +1,171 @@
+/**
+ * @file numa.cpp
+ *
+ * Implementation of thread pinning and of the global memory placement
+ * settings.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "numa.hpp"
+
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#ifdef __linux__
+  #include <sched.h>
+  #include <sys/mman.h>
+  #include <unistd.h>
+#endif
+
+using namespace mlpack;
+using namespace std;
+
+namespace {
+
+//! The policy that data::Load() places matrices with.
+MemoryPlacement memoryPlacement = MemoryPlacement::DEFAULT;
+//! The size above which placed matrices use huge pages (0 for never).
+size_t hugePageThreshold = 0;
+
+#ifdef __linux__
+
+/**
+ * Get the processors the process was allowed to run on when this was first
+ * called, in the order that threads should be pinned to them with the given
+ * policy.
+ */
+vector<int> OrderedProcessors(const ThreadAffinity affinity)
+{
+  static bool saved = false;
+  static cpu_set_t allowed;
+  if (!saved)
+  {
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0)
+      return vector<int>();
+    saved = true;
+  }
+
+  // Group the processors by socket.  If the topology can't be read, they are
+  // all taken to be on the same socket.
+  map<int, vector<int>> sockets;
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+  {
+    if (!CPU_ISSET(cpu, &allowed))
+      continue;
+
+    ostringstream path;
+    path << "/sys/devices/system/cpu/cpu" << cpu
+        << "/topology/physical_package_id";
+    ifstream file(path.str());
+    int socket = 0;
+    if (!(file >> socket))
+      socket = 0;
+    sockets[socket].push_back(cpu);
+  }
+
+  vector<int> processors;
+  if (affinity == ThreadAffinity::SPREAD)
+  {
+    // Take one processor of each socket in turn.
+    for (size_t i = 0; processors.size() < (size_t) CPU_COUNT(&allowed); ++i)
+    {
+      for (map<int, vector<int>>::const_iterator it = sockets.begin();
+           it != sockets.end(); ++it)
+      {
+        if (i < it->second.size())
+          processors.push_back(it->second[i]);
+      }
+    }
+  }
+  else
+  {
+    for (map<int, vector<int>>::const_iterator it = sockets.begin();
+         it != sockets.end(); ++it)
+      processors.insert(processors.end(), it->second.begin(), it->second.end());
+  }
+
+  return processors;
+}
+
+#endif
+
+} // namespace
+
+bool mlpack::SetThreadAffinity(const ThreadAffinity affinity)
+{
+#ifdef __linux__
+  const vector<int> processors = OrderedProcessors(affinity);
+  if (processors.empty())
+    return false;
+
+  bool success = true;
+  #pragma omp parallel reduction(&&:success)
+  {
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (affinity == ThreadAffinity::NONE)
+    {
+      for (size_t i = 0; i < processors.size(); ++i)
+        CPU_SET(processors[i], &mask);
+    }
+    else
+    {
+      CPU_SET(processors[ThreadNum() % processors.size()], &mask);
+    }
+
+    // On Linux, a pid of 0 sets the affinity of the calling thread only.
+    success = (sched_setaffinity(0, sizeof(cpu_set_t), &mask) == 0);
+  }
+
+  return success;
+#else
+  (void) affinity;
+  return false;
+#endif
+}
+
+void mlpack::SetMemoryPlacement(const MemoryPlacement placement)
+{
+  memoryPlacement = placement;
+}
+
+MemoryPlacement mlpack::GetMemoryPlacement()
+{
+  return memoryPlacement;
+}
+
+void mlpack::SetHugePageThreshold(const size_t bytes)
+{
+  hugePageThreshold = bytes;
+}
+
+size_t mlpack::HugePageThreshold()
+{
+  return hugePageThreshold;
+}
+
+void mlpack::AdviseHugePages(void* memory, const size_t bytes)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // madvise() needs page-aligned memory, so only advise the whole pages inside
+  // of the given memory.
+  const size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+  const size_t start = (size_t) memory;
+  const size_t alignedStart = (start + pageSize - 1) / pageSize * pageSize;
+  const size_t alignedEnd = (start + bytes) / pageSize * pageSize;
+  if (alignedEnd > alignedStart)
+  {
+    // A failure only means that normal pages are used.
+    madvise((void*) alignedStart, alignedEnd - alignedStart, MADV_HUGEPAGE);
+  }
+#else
+  (void) memory;
+  (void) bytes;
+#endif
+}
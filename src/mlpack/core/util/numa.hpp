@@ -0,0 +1,132 @@
+/**
+ * @file numa.hpp
+ *
+ * Control over where the threads of mlpack run and where the memory of large
+ * matrices is placed, for machines with several NUMA nodes.  On such machines
+ * a page of memory lives on the node of the thread that first writes to it, so
+ * a matrix that is filled by one thread (for instance, while it is loaded from
+ * a file) ends up on a single node, and the parallel loops that read it later
+ * have to go across the interconnect for most of their reads.
+ *
+ * The functions here can pin the threads of mlpack to processors, and copy a
+ * matrix into memory that is first touched by the threads that will read it.
+ * data::Load() places every matrix it loads with the global policy set by
+ * SetMemoryPlacement(); the default policy leaves matrices where they are.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_NUMA_HPP
+#define MLPACK_CORE_UTIL_NUMA_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * The ways that the threads of mlpack can be pinned to processors.
+ */
+enum class ThreadAffinity
+{
+  //! Threads may run on any processor allowed for the process.
+  NONE,
+  //! Consecutive threads are pinned to consecutive processors of each socket,
+  //! filling one socket before the next one is used.
+  COMPACT,
+  //! Consecutive threads are pinned to processors of different sockets, so
+  //! that every socket (and its memory) is used even with few threads.
+  SPREAD
+};
+
+/**
+ * The ways that the memory of a matrix can be placed on the NUMA nodes.
+ */
+enum class MemoryPlacement
+{
+  //! Leave the matrix where it is.
+  DEFAULT,
+  //! Copy the matrix so that each thread of a static parallel loop over the
+  //! columns first touches (and so owns) the columns it will be given.
+  FIRST_TOUCH,
+  //! Copy the matrix so that its pages are first touched by the threads in
+  //! turn, spreading them over the nodes that the threads are pinned to.  This
+  //! suits matrices that are read in no particular order, like the reference
+  //! set of a tree search.
+  INTERLEAVE
+};
+
+/**
+ * Pin each thread of mlpack's thread pool (see SetNumThreads()) to a processor
+ * with the given policy, or unpin them all with ThreadAffinity::NONE.  The
+ * processors are those the process was allowed to run on when this was first
+ * called.  This should be called outside of any parallel region, after
+ * SetNumThreads(); OpenMP reuses the same threads for later parallel regions
+ * of the same size, so they stay pinned.  The command-line programs call it
+ * with the value of the --thread_affinity option.
+ *
+ * Pinning is only supported on Linux; elsewhere this does nothing and returns
+ * false.
+ *
+ * @param affinity Policy to pin the threads with.
+ * @return Whether the threads could be pinned.
+ */
+bool SetThreadAffinity(const ThreadAffinity affinity);
+
+/**
+ * Set the policy that data::Load() places loaded matrices with.  Placing a
+ * matrix costs one copy of it, so this is only worth it for large data that is
+ * read by many threads.  The command-line programs call this with the value of
+ * the --memory_placement option.
+ */
+void SetMemoryPlacement(const MemoryPlacement placement);
+
+//! Get the policy that data::Load() places loaded matrices with.
+MemoryPlacement GetMemoryPlacement();
+
+/**
+ * Set the size, in bytes, above which a placed matrix is backed by huge pages
+ * (transparent huge pages, on Linux), which reduces the TLB misses of random
+ * reads of large matrices.  If 0 (the default), huge pages are never
+ * requested.  This only applies to matrices copied by PlaceMatrix().
+ */
+void SetHugePageThreshold(const size_t bytes);
+
+//! Get the size above which placed matrices are backed by huge pages.
+size_t HugePageThreshold();
+
+/**
+ * Ask the operating system to back the given memory with huge pages.  This
+ * must be called before the memory is first touched to have any effect, and
+ * does nothing if huge pages are not supported.
+ *
+ * @param memory Start of the memory.
+ * @param bytes Size of the memory in bytes.
+ */
+void AdviseHugePages(void* memory, const size_t bytes);
+
+/**
+ * Copy the given matrix into new memory placed with the given policy, and
+ * replace the matrix with the copy.  Matrices that use memory they don't own
+ * (aliases of other memory) and matrices smaller than a page are left alone.
+ * If the matrix is larger than HugePageThreshold(), the new memory is backed by
+ * huge pages.
+ *
+ * The placement only helps if the threads that later read the matrix are
+ * pinned (see SetThreadAffinity()), and if the number of threads has not
+ * changed since.
+ *
+ * @param matrix Matrix to place.
+ * @param placement Policy to place the matrix with.
+ */
+template<typename eT>
+void PlaceMatrix(arma::Mat<eT>& matrix,
+                 const MemoryPlacement placement = GetMemoryPlacement());
+
+} // namespace mlpack
+
+// Include implementation.
+#include "numa_impl.hpp"
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file numa_impl.hpp
+ *
+ * Implementation of PlaceMatrix().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_NUMA_IMPL_HPP
+#define MLPACK_CORE_UTIL_NUMA_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "numa.hpp"
+
+namespace mlpack {
+
+template<typename eT>
+void PlaceMatrix(arma::Mat<eT>& matrix, const MemoryPlacement placement)
+{
+  // We assume pages of 4kB; only the granularity of the interleaving depends
+  // on it.
+  const size_t pageSize = 4096;
+  const size_t bytes = matrix.n_elem * sizeof(eT);
+
+  // Memory that the matrix does not own can't be replaced, and small matrices
+  // use memory inside of the object.
+  if (placement == MemoryPlacement::DEFAULT || matrix.mem_state != 0 ||
+      bytes < pageSize)
+    return;
+
+  // The memory of a large allocation is not touched before we write to it, so
+  // each page ends up on the node of whichever thread writes it first.
+  arma::Mat<eT> placed(matrix.n_rows, matrix.n_cols, arma::fill::none);
+  if (HugePageThreshold() > 0 && bytes > HugePageThreshold())
+    AdviseHugePages(placed.memptr(), bytes);
+
+  const size_t rows = matrix.n_rows;
+  if (placement == MemoryPlacement::FIRST_TOUCH)
+  {
+    // This gives each thread the same columns as a static parallel loop over
+    // the points.
+    #pragma omp parallel for schedule(static)
+    for (omp_size_t i = 0; i < (omp_size_t) matrix.n_cols; ++i)
+      std::copy(matrix.colptr(i), matrix.colptr(i) + rows, placed.colptr(i));
+  }
+  else
+  {
+    // Hand out about a page of columns to each thread in turn.
+    const size_t columnBytes = std::max(rows * sizeof(eT), (size_t) 1);
+    const int chunk = (int) std::max(pageSize / columnBytes, (size_t) 1);
+    (void) chunk; // Unused without OpenMP.
+
+    #pragma omp parallel for schedule(static, chunk)
+    for (omp_size_t i = 0; i < (omp_size_t) matrix.n_cols; ++i)
+      std::copy(matrix.colptr(i), matrix.colptr(i) + rows, placed.colptr(i));
+  }
+
+  matrix = std::move(placed);
+}
+
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 #define MLPACK_CORE_UTIL_PREFIXEDOUTSTREAM_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "async_log_sink.hpp"
 
 namespace mlpack {
 namespace util {
@@ -42,6 +43,9 @@ namespace util {
  *
  * These objects are used for the mlpack::Log levels (DEBUG, INFO, WARN, and
  * FATAL).
+ *
+ * If the AsyncLogSink is running, the lines of non-fatal streams are handed to
+ * it, instead of being written to the destination directly.
  */
 class PrefixedOutStream
 {
@@ -155,6 +159,18 @@ class PrefixedOutStream
    */
   inline void PrefixIfNeeded();
 
+  /**
+   * Write the given text to the destination, or append it to the pending line
+   * of the calling thread if the AsyncLogSink is running.
+   */
+  inline void Write(const std::string& text);
+
+  //! End the current line.
+  inline void EndLine();
+
+  //! Return whether the lines of this stream go to the AsyncLogSink.
+  bool Async() const { return !fatal && AsyncLogSink::Enabled(); }
+
   //! Contains the prefix we must prepend to each line.
   std::string prefix;
 
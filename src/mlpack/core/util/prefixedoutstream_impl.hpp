@@ -38,6 +38,10 @@ template<typename T>
 typename std::enable_if<!arma::is_arma_type<T>::value>::type
 PrefixedOutStream::BaseLogic(const T& val)
 {
+  // Don't bother converting anything if nothing will be printed.
+  if (ignoreInput && !fatal)
+    return;
+
   // We will use this to track whether or not we need to terminate at the end of
   // this call (only for streams which terminate after a newline).
   bool newlined = false;
@@ -57,8 +61,9 @@ PrefixedOutStream::BaseLogic(const T& val)
     PrefixIfNeeded();
     if (!ignoreInput)
     {
-      destination << "Failed type conversion to string for output; output not "
-          "shown." << std::endl;
+      Write("Failed type conversion to string for output; output not "
+          "shown.");
+      EndLine();
       newlined = true;
     }
   }
@@ -71,7 +76,10 @@ PrefixedOutStream::BaseLogic(const T& val)
     if (line.length() == 0)
     {
       // The prefix cannot be necessary at this point.
-      if (!ignoreInput) // Only if the user wants it.
+      // Only if the user wants it.  The asynchronous sink flushes by itself,
+      // and std::flush must not touch a stream the writer thread is using.
+      if (!ignoreInput && !(AsyncLogSink::Enabled() &&
+          std::is_same<T, std::ostream& (*)(std::ostream&)>::value))
         destination << val;
 
       return;
@@ -87,12 +95,13 @@ PrefixedOutStream::BaseLogic(const T& val)
       // Only output if the user wants it.
       if (!ignoreInput)
       {
-        destination << line.substr(pos, nl - pos);
-        destination << std::endl;
+        Write(line.substr(pos, nl - pos));
+        EndLine();
       }
 
       newlined = true; // Ensure this is set for the fatal exception if needed.
-      carriageReturned = true; // Regardless of whether or not we display it.
+      if (!Async()) // The asynchronous sink tracks lines per thread.
+        carriageReturned = true; // Regardless of whether or not we display it.
 
       pos = nl + 1;
     }
@@ -101,7 +110,7 @@ PrefixedOutStream::BaseLogic(const T& val)
     {
       PrefixIfNeeded();
       if (!ignoreInput)
-        destination << line.substr(pos);
+        Write(line.substr(pos));
     }
   }
 
@@ -109,7 +118,7 @@ PrefixedOutStream::BaseLogic(const T& val)
   if (fatal && newlined)
   {
     if (!ignoreInput)
-      destination << std::endl;
+      EndLine();
 
     // Print a backtrace, if we can.
 #ifdef HAS_BFD_DL
@@ -126,8 +135,8 @@ PrefixedOutStream::BaseLogic(const T& val)
 
         if (!ignoreInput)
         {
-          destination << btLine.substr(pos, nl - pos);
-          destination << std::endl;
+          Write(btLine.substr(pos, nl - pos));
+          EndLine();
         }
 
         carriageReturned = true; // Regardless of whether or not we display it.
@@ -146,6 +155,10 @@ template<typename T>
 typename std::enable_if<arma::is_arma_type<T>::value>::type
 PrefixedOutStream::BaseLogic(const T& val)
 {
+  // Don't bother converting anything if nothing will be printed.
+  if (ignoreInput && !fatal)
+    return;
+
   // Extract printable object from the input.
   const arma::Mat<typename T::elem_type>& printVal(val);
 
@@ -190,8 +203,9 @@ PrefixedOutStream::BaseLogic(const T& val)
     PrefixIfNeeded();
     if (!ignoreInput)
     {
-      destination << "Failed type conversion to string for output; output not "
-          "shown." << std::endl;
+      Write("Failed type conversion to string for output; output not "
+          "shown.");
+      EndLine();
       newlined = true;
     }
   }
@@ -204,7 +218,10 @@ PrefixedOutStream::BaseLogic(const T& val)
     if (line.length() == 0)
     {
       // The prefix cannot be necessary at this point.
-      if (!ignoreInput) // Only if the user wants it.
+      // Only if the user wants it.  The asynchronous sink flushes by itself,
+      // and std::flush must not touch a stream the writer thread is using.
+      if (!ignoreInput && !(AsyncLogSink::Enabled() &&
+          std::is_same<T, std::ostream& (*)(std::ostream&)>::value))
         destination << val;
 
       return;
@@ -220,12 +237,13 @@ PrefixedOutStream::BaseLogic(const T& val)
       // Only output if the user wants it.
       if (!ignoreInput)
       {
-        destination << line.substr(pos, nl - pos);
-        destination << std::endl;
+        Write(line.substr(pos, nl - pos));
+        EndLine();
       }
 
       newlined = true; // Ensure this is set for the fatal exception if needed.
-      carriageReturned = true; // Regardless of whether or not we display it.
+      if (!Async()) // The asynchronous sink tracks lines per thread.
+        carriageReturned = true; // Regardless of whether or not we display it.
 
       pos = nl + 1;
     }
@@ -234,7 +252,7 @@ PrefixedOutStream::BaseLogic(const T& val)
     {
       PrefixIfNeeded();
       if (!ignoreInput)
-        destination << line.substr(pos);
+        Write(line.substr(pos));
     }
   }
 
@@ -242,7 +260,7 @@ PrefixedOutStream::BaseLogic(const T& val)
   if (fatal && newlined)
   {
     if (!ignoreInput)
-      destination << std::endl;
+      EndLine();
 
     // Print a backtrace, if we can.
 #ifdef HAS_BFD_DL
@@ -259,8 +277,8 @@ PrefixedOutStream::BaseLogic(const T& val)
 
         if (!ignoreInput)
         {
-          destination << btLine.substr(pos, nl - pos);
-          destination << std::endl;
+          Write(btLine.substr(pos, nl - pos));
+          EndLine();
         }
 
         carriageReturned = true; // Regardless of whether or not we display it.
@@ -277,16 +295,58 @@ PrefixedOutStream::BaseLogic(const T& val)
 // This is an inline function (that is why it is here and not in .cc).
 void PrefixedOutStream::PrefixIfNeeded()
 {
+  // With the asynchronous sink, each thread builds its own line, so a prefix is
+  // needed whenever the line of the calling thread is empty.
+  if (Async())
+  {
+    std::string& line = AsyncLogSink::PendingLine(this, destination);
+    if (!ignoreInput && line.empty())
+      line = prefix;
+    return;
+  }
+
   // If we need to, output a prefix.
   if (carriageReturned)
   {
     if (!ignoreInput) // But only if we are allowed to.
-      destination << prefix;
+      Write(prefix);
 
     carriageReturned = false; // Denote that the prefix has been displayed.
   }
 }
 
+void PrefixedOutStream::Write(const std::string& text)
+{
+  if (Async())
+  {
+    AsyncLogSink::PendingLine(this, destination) += text;
+  }
+  else
+  {
+    // Fatal output comes after everything that was logged before it.
+    if (fatal)
+      AsyncLogSink::Flush();
+    destination << text;
+  }
+}
+
+void PrefixedOutStream::EndLine()
+{
+  if (Async())
+  {
+    std::string& line = AsyncLogSink::PendingLine(this, destination);
+    line += '\n';
+    AsyncLogSink::Write(destination, std::move(line));
+    line.clear();
+  }
+  else
+  {
+    if (fatal)
+      AsyncLogSink::Flush();
+    destination << std::endl;
+  }
+}
+
 } // namespace util
 } // namespace mlpack
 
@@ -0,0 +1,106 @@
+/**
+ * @file rate_limiter.hpp
+ *
+ * A simple rate limiter for progress messages.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_RATE_LIMITER_HPP
+#define MLPACK_CORE_UTIL_RATE_LIMITER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace mlpack {
+namespace util {
+
+/**
+ * Decide whether a progress message should be printed, so that messages from
+ * an inner loop are printed at most once per interval.  The first call to
+ * Ready() always succeeds.  Ready() may be called from several threads; only
+ * one of them succeeds per interval.
+ *
+ * @code
+ * util::RateLimiter progress(1.0);
+ * for (size_t i = 0; i < maxIterations; ++i)
+ * {
+ *   // ... do an iteration ...
+ *   if (progress.Ready())
+ *     Log::Info << "Iteration " << i << "; objective " << objective << ".\n";
+ * }
+ * @endcode
+ */
+class RateLimiter
+{
+ public:
+  /**
+   * Create a rate limiter.
+   *
+   * @param interval Minimum time between two messages, in seconds.
+   */
+  RateLimiter(const double interval = 1.0) :
+      interval(int64_t(interval * 1e9)),
+      next(0),
+      suppressed(0)
+  { }
+
+  //! Copy the given rate limiter.
+  RateLimiter(const RateLimiter& other) :
+      interval(other.interval),
+      next(other.next.load()),
+      suppressed(other.suppressed.load())
+  { }
+
+  //! Copy the given rate limiter.
+  RateLimiter& operator=(const RateLimiter& other)
+  {
+    interval = other.interval;
+    next = other.next.load();
+    suppressed = other.suppressed.load();
+    return *this;
+  }
+
+  /**
+   * Return true if a message may be printed now; otherwise, count it as
+   * suppressed and return false.
+   */
+  bool Ready()
+  {
+    const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t expected = next.load(std::memory_order_relaxed);
+    if (now >= expected &&
+        next.compare_exchange_strong(expected, now + interval))
+      return true;
+
+    suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  //! Let the next message through, and clear the count of suppressed ones.
+  void Reset()
+  {
+    next = 0;
+    suppressed = 0;
+  }
+
+  //! Get the number of messages suppressed so far.
+  size_t Suppressed() const { return suppressed.load(); }
+
+ private:
+  //! The minimum time between two messages, in nanoseconds.
+  int64_t interval;
+  //! The time after which the next message may be printed, in nanoseconds.
+  std::atomic<int64_t> next;
+  //! The number of suppressed messages.
+  std::atomic<size_t> suppressed;
+};
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file threads.hpp
+ *
+ * Control over the number of threads used by mlpack.  All of mlpack's parallel
+ * code is written with OpenMP: flat loops use parallel for loops, and recursive
+ * work (such as building the two subtrees of a tree node) uses OpenMP tasks,
+ * which the OpenMP runtime schedules on a shared pool of threads with work
+ * stealing.  The functions here set and query that pool, so that a program
+ * embedding mlpack can bound the number of threads that mlpack uses.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_THREADS_HPP
+#define MLPACK_CORE_UTIL_THREADS_HPP
+
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+namespace mlpack {
+
+/**
+ * Set the number of threads that the parallel parts of mlpack may use.  This
+ * should be called outside of any parallel region, typically once at the start
+ * of the program; the command-line programs call it with the value of the
+ * --threads option.
+ *
+ * This also disables nested parallel regions: a parallel region that is
+ * encountered inside of another one (for instance, a tree being built inside of
+ * a parallel loop) runs on the thread that encountered it instead of starting
+ * another set of threads.  Nested work should be expressed with OpenMP tasks,
+ * which are run by the threads of the enclosing parallel region.
+ *
+ * If mlpack was compiled without OpenMP, this does nothing.
+ *
+ * @param numThreads Number of threads to use; if 0, one thread per processor
+ *     is used.
+ */
+inline void SetNumThreads(const size_t numThreads)
+{
+#ifdef HAS_OPENMP
+  omp_set_num_threads((numThreads > 0) ? (int) numThreads :
+      omp_get_num_procs());
+  omp_set_max_active_levels(1);
+#else
+  (void) numThreads;
+#endif
+}
+
+/**
+ * Get the number of threads that a parallel region started by mlpack would
+ * use.  This is 1 if mlpack was compiled without OpenMP.
+ */
+inline size_t NumThreads()
+{
+#ifdef HAS_OPENMP
+  return (size_t) omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+/**
+ * Get the index of the calling thread in the innermost parallel region, which
+ * is less than NumThreads().  This is 0 outside of a parallel region, and if
+ * mlpack was compiled without OpenMP.  It can be used to give each thread its
+ * own slot of a result, instead of updating a shared result in a critical
+ * section.
+ */
+inline size_t ThreadNum()
+{
+#ifdef HAS_OPENMP
+  return (size_t) omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+/**
+ * Return whether the calling code is already running inside of a parallel
+ * region.  Parallel code that may be called from inside another parallel
+ * algorithm should then create tasks instead of a new parallel region.
+ */
+inline bool InParallel()
+{
+#ifdef HAS_OPENMP
+  return omp_in_parallel();
+#else
+  return false;
+#endif
+}
+
+} // namespace mlpack
+
+#endif
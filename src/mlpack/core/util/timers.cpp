@@ -15,13 +15,291 @@
 #include "cli.hpp"
 #include "log.hpp"
 
+#include <algorithm>
+#include <iomanip>
 #include <map>
+#include <sstream>
 #include <string>
+#include <unordered_map>
+
+#if defined(_WIN32)
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <time.h>
+#endif
 
 using namespace mlpack;
 using namespace std;
 using namespace chrono;
 
+namespace mlpack {
+
+/**
+ * A node of the tree of the scoped timers that ran on a thread.  The root of
+ * the tree is node 0; the parent of the node of a timer is the node of the
+ * timer it was nested in.
+ */
+struct TimerNode
+{
+  TimerNode(const size_t id, const size_t parent) :
+      id(id),
+      parent(parent),
+      count(0),
+      total(0),
+      min(nanoseconds::max()),
+      max(0),
+      cpu(0)
+  { }
+
+  //! The identifier of the timer.
+  size_t id;
+  //! The node of the timer this one is nested in.
+  size_t parent;
+  //! The nodes of the timers nested in this one.
+  vector<size_t> children;
+  //! The number of runs.
+  size_t count;
+  //! The total wall time of the runs.
+  nanoseconds total;
+  //! The wall time of the shortest run.
+  nanoseconds min;
+  //! The wall time of the longest run.
+  nanoseconds max;
+  //! The total CPU time of the runs.
+  nanoseconds cpu;
+};
+
+/**
+ * The scoped timers of a thread.  Only the thread itself modifies them; the
+ * mutex is only contended while the statistics are collected.  When the
+ * thread exits, its statistics are kept by the registry.
+ */
+class ThreadTimers
+{
+ public:
+  ThreadTimers();
+  ~ThreadTimers();
+
+  //! The mutex that protects the nodes.
+  mutex nodesMutex;
+  //! The tree of the timers.
+  vector<TimerNode> nodes;
+  //! The node of the innermost running timer, or 0 if none is running.
+  size_t current;
+};
+
+} // namespace mlpack
+
+namespace {
+
+/**
+ * The names of the scoped timers, the timers of each running thread, and the
+ * statistics of the threads that exited.
+ */
+struct TimerRegistry
+{
+  mutex registryMutex;
+  vector<string> names;
+  unordered_map<string, size_t> ids;
+  vector<ThreadTimers*> threads;
+  map<string, TimerStatistics> retired;
+};
+
+TimerRegistry& Registry()
+{
+  static TimerRegistry registry;
+  return registry;
+}
+
+ThreadTimers& LocalTimers()
+{
+  thread_local ThreadTimers timers;
+  return timers;
+}
+
+//! Get the CPU time used by the calling thread.
+nanoseconds ThreadCPUTime()
+{
+#if defined(_WIN32)
+  FILETIME creation, exit, kernel, user;
+  GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+  const uint64_t ticks =
+      ((((uint64_t) kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime) +
+      ((((uint64_t) user.dwHighDateTime) << 32) | user.dwLowDateTime);
+  // FILETIME ticks are 100 nanoseconds.
+  return nanoseconds(ticks * 100);
+#else
+  timespec time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return seconds(time.tv_sec) + nanoseconds(time.tv_nsec);
+#endif
+}
+
+/**
+ * Add the statistics of the given thread to the given statistics, by path.
+ * The registry and the thread must be locked.
+ */
+void CollectStatistics(const ThreadTimers& timers,
+                       const vector<string>& names,
+                       map<string, TimerStatistics>& statistics)
+{
+  // A node is always created after its parent.
+  vector<string> paths(timers.nodes.size());
+  for (size_t i = 1; i < timers.nodes.size(); ++i)
+  {
+    const TimerNode& node = timers.nodes[i];
+    paths[i] = (node.parent == 0) ? names[node.id] :
+        paths[node.parent] + "/" + names[node.id];
+    if (node.count == 0)
+      continue;
+
+    map<string, TimerStatistics>::iterator it = statistics.find(paths[i]);
+    if (it == statistics.end())
+    {
+      TimerStatistics& s = statistics[paths[i]];
+      s.path = paths[i];
+      s.count = node.count;
+      s.total = node.total;
+      s.min = node.min;
+      s.max = node.max;
+      s.cpu = node.cpu;
+      s.threads = 1;
+    }
+    else
+    {
+      TimerStatistics& s = it->second;
+      s.count += node.count;
+      s.total += node.total;
+      s.min = std::min(s.min, node.min);
+      s.max = std::max(s.max, node.max);
+      s.cpu += node.cpu;
+      ++s.threads;
+    }
+  }
+}
+
+//! Write the given string as a JSON string.
+void WriteJSONString(ostream& stream, const string& str)
+{
+  stream << '"';
+  for (size_t i = 0; i < str.size(); ++i)
+  {
+    const unsigned char c = str[i];
+    if (c == '"' || c == '\\')
+      stream << '\\' << c;
+    else if (c < 0x20)
+      stream << "\\u" << hex << setw(4) << setfill('0') << (int) c << dec;
+    else
+      stream << c;
+  }
+  stream << '"';
+}
+
+//! Write the given duration in microseconds.
+void WriteMicroseconds(ostream& stream, const nanoseconds time)
+{
+  ostringstream oss;
+  oss << fixed << setprecision(3) << (time.count() / 1000.0);
+  stream << oss.str();
+}
+
+} // anonymous namespace
+
+ThreadTimers::ThreadTimers() : current(0)
+{
+  nodes.push_back(TimerNode(0, 0));
+
+  TimerRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.registryMutex);
+  registry.threads.push_back(this);
+}
+
+ThreadTimers::~ThreadTimers()
+{
+  TimerRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.registryMutex);
+  {
+    lock_guard<mutex> nodesLock(nodesMutex);
+    CollectStatistics(*this, registry.names, registry.retired);
+  }
+  registry.threads.erase(std::find(registry.threads.begin(),
+      registry.threads.end(), this));
+}
+
+TimerHandle::TimerHandle(const string& name)
+{
+  TimerRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.registryMutex);
+  unordered_map<string, size_t>::const_iterator it = registry.ids.find(name);
+  if (it != registry.ids.end())
+  {
+    id = it->second;
+  }
+  else
+  {
+    id = registry.names.size();
+    registry.names.push_back(name);
+    registry.ids[name] = id;
+  }
+}
+
+ScopedTimer::ScopedTimer(const TimerHandle& handle) : timers(NULL), node(0)
+{
+  // Don't do anything if we aren't timing.
+  if (!CLI::GetSingleton().timer.Enabled())
+    return;
+
+  timers = &LocalTimers();
+  {
+    lock_guard<mutex> lock(timers->nodesMutex);
+    const size_t parent = timers->current;
+    const vector<size_t>& children = timers->nodes[parent].children;
+    for (size_t i = 0; i < children.size(); ++i)
+    {
+      if (timers->nodes[children[i]].id == handle.Id())
+      {
+        node = children[i];
+        break;
+      }
+    }
+
+    // If the timer runs here for the first time.
+    if (node == 0)
+    {
+      node = timers->nodes.size();
+      timers->nodes.push_back(TimerNode(handle.Id(), parent));
+      timers->nodes[parent].children.push_back(node);
+    }
+
+    timers->current = node;
+  }
+
+  cpuStart = ThreadCPUTime();
+  wallStart = steady_clock::now();
+}
+
+ScopedTimer::~ScopedTimer()
+{
+  if (!timers)
+    return;
+
+  const nanoseconds wall = duration_cast<nanoseconds>(steady_clock::now() -
+      wallStart);
+  const nanoseconds cpu = ThreadCPUTime() - cpuStart;
+
+  lock_guard<mutex> lock(timers->nodesMutex);
+  TimerNode& timerNode = timers->nodes[node];
+  ++timerNode.count;
+  timerNode.total += wall;
+  timerNode.min = std::min(timerNode.min, wall);
+  timerNode.max = std::max(timerNode.max, wall);
+  timerNode.cpu += cpu;
+  timers->current = timerNode.parent;
+}
+
 /**
  * Start the given timer.
  */
@@ -64,12 +342,87 @@ void Timer::ResetAll()
   CLI::GetSingleton().timer.Reset();
 }
 
+vector<TimerStatistics> Timer::Statistics()
+{
+  TimerRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.registryMutex);
+
+  map<string, TimerStatistics> statistics = registry.retired;
+  for (size_t i = 0; i < registry.threads.size(); ++i)
+  {
+    lock_guard<mutex> nodesLock(registry.threads[i]->nodesMutex);
+    CollectStatistics(*registry.threads[i], registry.names, statistics);
+  }
+
+  vector<TimerStatistics> result;
+  for (map<string, TimerStatistics>::const_iterator it = statistics.begin();
+       it != statistics.end(); ++it)
+    result.push_back(it->second);
+
+  return result;
+}
+
+void Timer::WriteJSON(ostream& stream)
+{
+  stream << "{" << endl << "  \"timers\": {";
+  const map<string, microseconds> timers =
+      CLI::GetSingleton().timer.GetAllTimers();
+  for (map<string, microseconds>::const_iterator it = timers.begin();
+       it != timers.end(); ++it)
+  {
+    stream << ((it == timers.begin()) ? "" : ",") << endl << "    ";
+    WriteJSONString(stream, it->first);
+    stream << ": " << it->second.count();
+  }
+  stream << endl << "  }," << endl << "  \"scoped_timers\": [";
+
+  const vector<TimerStatistics> statistics = Statistics();
+  for (size_t i = 0; i < statistics.size(); ++i)
+  {
+    const TimerStatistics& s = statistics[i];
+    stream << ((i == 0) ? "" : ",") << endl << "    { \"path\": ";
+    WriteJSONString(stream, s.path);
+    stream << ", \"count\": " << s.count << ", \"total\": ";
+    WriteMicroseconds(stream, s.total);
+    stream << ", \"min\": ";
+    WriteMicroseconds(stream, s.min);
+    stream << ", \"max\": ";
+    WriteMicroseconds(stream, s.max);
+    stream << ", \"cpu\": ";
+    WriteMicroseconds(stream, s.cpu);
+    stream << ", \"threads\": " << s.threads << " }";
+  }
+  stream << endl << "  ]" << endl << "}" << endl;
+}
+
 // Reset a Timers object.
 void Timers::Reset()
 {
-  lock_guard<mutex> lock(timersMutex);
-  timers.clear();
-  timerStartTime.clear();
+  {
+    lock_guard<mutex> lock(timersMutex);
+    timers.clear();
+    timerStartTime.clear();
+  }
+
+  // Reset the statistics of the scoped timers.  The nodes are kept, since
+  // running scoped timers refer to them.
+  TimerRegistry& registry = Registry();
+  lock_guard<mutex> lock(registry.registryMutex);
+  registry.retired.clear();
+  for (size_t i = 0; i < registry.threads.size(); ++i)
+  {
+    ThreadTimers& threadTimers = *registry.threads[i];
+    lock_guard<mutex> nodesLock(threadTimers.nodesMutex);
+    for (size_t j = 0; j < threadTimers.nodes.size(); ++j)
+    {
+      TimerNode& node = threadTimers.nodes[j];
+      node.count = 0;
+      node.total = nanoseconds(0);
+      node.min = nanoseconds::max();
+      node.max = nanoseconds(0);
+      node.cpu = nanoseconds(0);
+    }
+  }
 }
 
 map<string, microseconds> Timers::GetAllTimers()
@@ -157,6 +510,24 @@ void Timers::PrintTimer(const string& timerName)
   Log::Info << endl;
 }
 
+void Timers::PrintStatistics()
+{
+  const vector<TimerStatistics> statistics = Timer::Statistics();
+  for (size_t i = 0; i < statistics.size(); ++i)
+  {
+    const TimerStatistics& s = statistics[i];
+    const duration<double> total = s.total, min = s.min, max = s.max,
+        cpu = s.cpu;
+    ostringstream oss;
+    oss << fixed << setprecision(6) << s.path << ": " << total.count()
+        << "s in " << s.count << " run" << ((s.count == 1) ? "" : "s")
+        << " (min " << min.count() << "s, max " << max.count() << "s, cpu "
+        << cpu.count() << "s, " << s.threads << " thread"
+        << ((s.threads == 1) ? "" : "s") << ")";
+    Log::Info << "  " << oss.str() << endl;
+  }
+}
+
 void Timers::StopAllTimers()
 {
   // Terminate the program timers.  Don't use StopTimer() since that modifies
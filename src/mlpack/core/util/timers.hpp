@@ -21,6 +21,8 @@
 #include <mutex>
 #include <list>
 #include <atomic>
+#include <ostream>
+#include <vector>
 
 #if defined(_WIN32)
   // uint64_t isn't defined on every windows.
@@ -35,12 +37,113 @@
 
 namespace mlpack {
 
+/**
+ * The statistics of a scoped timer (see ScopedTimer), aggregated over all the
+ * threads it ran on.
+ */
+struct TimerStatistics
+{
+  //! The names of the timer and of the timers it is nested in, from the
+  //! outermost, separated by '/'.
+  std::string path;
+  //! The number of times the timer ran.
+  size_t count;
+  //! The total wall time of the runs, summed over the threads.
+  std::chrono::nanoseconds total;
+  //! The wall time of the shortest run.
+  std::chrono::nanoseconds min;
+  //! The wall time of the longest run.
+  std::chrono::nanoseconds max;
+  //! The total CPU time of the runs, summed over the threads.
+  std::chrono::nanoseconds cpu;
+  //! The number of threads the timer ran on.
+  size_t threads;
+};
+
+/**
+ * A TimerHandle identifies a scoped timer by its name.  The name is only
+ * looked up when the handle is created, so handles should be created once,
+ * for instance as static variables, and then used by each ScopedTimer:
+ *
+ * @code
+ * void TrainTree()
+ * {
+ *   static const TimerHandle treeBuilding("tree_building");
+ *   ScopedTimer timer(treeBuilding);
+ *   // Build the tree...
+ * }
+ * @endcode
+ */
+class TimerHandle
+{
+ public:
+  /**
+   * Get the handle of the timer with the given name; handles with the same
+   * name refer to the same timer.
+   *
+   * @param name Name of the timer.
+   */
+  explicit TimerHandle(const std::string& name);
+
+  //! Get the identifier of the timer.
+  size_t Id() const { return id; }
+
+ private:
+  //! The identifier of the timer.
+  size_t id;
+};
+
+//! The scoped timers of a thread; see timers.cpp.
+class ThreadTimers;
+
+/**
+ * A ScopedTimer times its scope: the timer given by its handle is started by
+ * the constructor and stopped by the destructor.  Each thread stores its own
+ * timers, so scoped timers can run on any number of threads at once without
+ * contention, and a scoped timer that starts while another one runs on the
+ * same thread is nested in it: its statistics are kept apart from the ones of
+ * the same timer elsewhere, under the path "outer/inner".
+ *
+ * For each path, the number of runs, and their total, shortest and longest
+ * wall time are recorded, along with the CPU time of the thread.  The
+ * statistics of all threads are aggregated by Timer::Statistics().  Nothing is
+ * recorded if timing is disabled (see Timer::EnableTiming()).
+ */
+class ScopedTimer
+{
+ public:
+  /**
+   * Start the given timer.
+   *
+   * @param handle Handle of the timer.
+   */
+  explicit ScopedTimer(const TimerHandle& handle);
+
+  //! Stop the timer.
+  ~ScopedTimer();
+
+ private:
+  // A scoped timer can't be copied.
+  ScopedTimer(const ScopedTimer&);
+  ScopedTimer& operator=(const ScopedTimer&);
+
+  //! The timers of the thread, or NULL if timing is disabled.
+  ThreadTimers* timers;
+  //! The node of the timer in the timers of the thread.
+  size_t node;
+  //! The wall time the timer started at.
+  std::chrono::steady_clock::time_point wallStart;
+  //! The CPU time of the thread when the timer started.
+  std::chrono::nanoseconds cpuStart;
+};
+
 /**
  * The timer class provides a way for mlpack methods to be timed.  The three
  * methods contained in this class allow a named timer to be started and
  * stopped, and its value to be obtained.  A named timer is specific to the
  * thread it is running on, so if you start a timer in one thread, it cannot be
- * stopped from a different thread.
+ * stopped from a different thread.  For timers in parallel or frequently run
+ * code, prefer ScopedTimer, which doesn't look up the timer by its name.
  */
 class Timer
 {
@@ -89,9 +192,24 @@ class Timer
 
   /**
    * Stop and reset all running timers.  This removes all knowledge of any
-   * existing timers.
+   * existing timers, and resets the statistics of the scoped timers.
    */
   static void ResetAll();
+
+  /**
+   * Get the statistics of the scoped timers, aggregated over all threads and
+   * sorted by path.  Runs that haven't finished are not counted.
+   */
+  static std::vector<TimerStatistics> Statistics();
+
+  /**
+   * Write the values of the named timers and the statistics of the scoped
+   * timers to the given stream, as a JSON object.  The times are given in
+   * microseconds.
+   *
+   * @param stream Stream to write to.
+   */
+  static void WriteJSON(std::ostream& stream);
 };
 
 class Timers
@@ -157,6 +275,11 @@ class Timers
   bool GetState(const std::string& timerName,
                 const std::thread::id& threadId = std::thread::id());
 
+  /**
+   * Prints the statistics of the scoped timers, one path per line.
+   */
+  void PrintStatistics();
+
   /**
    * Stop all timers.
    */
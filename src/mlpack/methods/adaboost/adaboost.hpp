@@ -150,7 +150,9 @@ class AdaBoost
                const double tolerance = 1e-6);
 
   /**
-   * Classify the given test points.
+   * Classify the given test points.  The points are processed in blocks, in
+   * parallel if OpenMP is enabled; each block is classified by all of the weak
+   * learners at once.
    *
    * @param test Testing data.
    * @param predictedLabels Vector in which to the predicted labels of the test
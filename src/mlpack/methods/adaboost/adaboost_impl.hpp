@@ -88,52 +88,36 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
   // To be used for prediction by the weak learner.
   arma::Row<size_t> predictedLabels(labels.n_cols);
 
-  // Use tempData to modify input data for incorporating weights.
-  MatType tempData(data);
-
-  // This matrix is a helper matrix used to calculate the final hypothesis.
-  arma::mat sumFinalH = arma::zeros<arma::mat>(numClasses,
-      predictedLabels.n_cols);
-
   // Load the initial weights into a 2-D matrix.
   const double initWeight = 1.0 / double(data.n_cols * numClasses);
   arma::mat D(numClasses, data.n_cols);
   D.fill(initWeight);
 
-  // Weights are stored in this row vector.
-  arma::rowvec weights(predictedLabels.n_cols);
-
-  // This is the final hypothesis.
-  arma::Row<size_t> finalH(predictedLabels.n_cols);
+  // The weight of each point is the sum of its column of D.
+  arma::rowvec weights = arma::sum(D);
 
   // Now, start the boosting rounds.
   for (size_t i = 0; i < iterations; i++)
   {
-    // Initialized to zero in every round.  rt is used for calculation of
-    // alphat; it is the weighted error.
+    // Use the existing weak learner to train a new one with new weights.  After
+    // the first round, the previous weak learner is used, so that anything it
+    // has computed about the data (like the sort order of each dimension for
+    // decision stumps) can be reused.
+    const WeakLearnerType& previous = wl.empty() ? other : wl.back();
+    WeakLearnerType w(previous, data, labels, numClasses, weights);
+    w.Classify(data, predictedLabels);
+
+    // Now, calculate alpha(t) using ht.  rt is used for calculation of alphat;
+    // it is the weighted error.
     // rt = (sum) D(i) y(i) ht(xi)
     rt = 0.0;
-
-    // zt is used for weight normalization.
-    zt = 0.0;
-
-    // Build the weight vectors.
-    weights = arma::sum(D);
-
-    // Use the existing weak learner to train a new one with new weights.
-    WeakLearnerType w(other, tempData, labels, numClasses, weights);
-    w.Classify(tempData, predictedLabels);
-
-    // Now from predictedLabels, build ht, the weak hypothesis
-    // buildClassificationMatrix(ht, predictedLabels);
-
-    // Now, calculate alpha(t) using ht.
-    for (size_t j = 0; j < D.n_cols; j++) // instead of D, ht
+    #pragma omp parallel for reduction(+:rt)
+    for (omp_size_t j = 0; j < D.n_cols; j++)
     {
       if (predictedLabels(j) == labels(j))
-        rt += arma::accu(D.col(j));
+        rt += weights(j);
       else
-        rt -= arma::accu(D.col(j));
+        rt -= weights(j);
     }
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
@@ -157,45 +141,30 @@ double AdaBoost<WeakLearnerType, MatType>::Train(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
-    for (size_t j = 0; j < D.n_cols; j++)
+    // Now modify the weights, computing zt (the normalization constant) and
+    // the weight of each point for the next round in the same pass.
+    const double expo = exp(alphat);
+    zt = 0.0;
+    #pragma omp parallel for reduction(+:zt)
+    for (omp_size_t j = 0; j < D.n_cols; j++)
     {
-      const double expo = exp(alphat);
-      if (predictedLabels(j) == labels(j))
+      // The weights are scaled by exp(-1 * alphat * yt(j,k) * ht(j,k)).
+      const double scale = (predictedLabels(j) == labels(j)) ? (1.0 / expo) :
+          expo;
+      double columnSum = 0.0;
+      for (size_t k = 0; k < D.n_rows; k++)
       {
-        for (size_t k = 0; k < D.n_rows; k++)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) /= expo;
-          zt += D(k, j); // * exp(-1 * alphat * yt(j,k) * ht(j,k));
-
-          // Add to the final hypothesis matrix.
-          // sumFinalH(k, j) += (alphat * ht(k, j));
-          if (k == labels(j))
-            sumFinalH(k, j) += (alphat); // * ht(k, j));
-          else
-            sumFinalH(k, j) -= (alphat);
-        }
-      }
-      else
-      {
-        for (size_t k = 0; k < D.n_rows; k++)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) *= expo;
-          zt += D(k, j);
-
-          // Add to the final hypothesis matrix.
-          if (k == labels(j))
-            sumFinalH(k, j) += alphat; // * ht(k, j));
-          else
-            sumFinalH(k, j) -= alphat;
-        }
+        D(k, j) *= scale;
+        columnSum += D(k, j);
       }
+
+      weights(j) = columnSum;
+      zt += columnSum;
     }
 
     // Normalize D.
     D /= zt;
+    weights /= zt;
 
     // Accumulate the value of zt for the Hamming loss bound.
     ztProduct *= zt;
@@ -211,28 +180,36 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::Row<size_t> tempPredictedLabels(test.n_cols);
-  arma::mat cMatrix(numClasses, test.n_cols);
-
-  cMatrix.zeros();
   predictedLabels.set_size(test.n_cols);
 
-  for (size_t i = 0; i < wl.size(); i++)
+  // Each block of points is classified by all of the weak learners before
+  // moving on to the next block, so that the votes of a block stay small.
+  const size_t blockSize = 256;
+  const size_t numBlocks = (test.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < numBlocks; ++b)
   {
-    wl[i].Classify(test, tempPredictedLabels);
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) test.n_cols);
+    const MatType block = test.cols(begin, end - 1);
 
-    for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
-      cMatrix(tempPredictedLabels(j), j) += alpha[i];
-  }
+    arma::Row<size_t> tempPredictedLabels(block.n_cols);
+    arma::mat cMatrix(numClasses, block.n_cols, arma::fill::zeros);
+    for (size_t i = 0; i < wl.size(); i++)
+    {
+      wl[i].Classify(block, tempPredictedLabels);
 
-  arma::colvec cMRow;
-  arma::uword maxIndex = 0;
+      for (size_t j = 0; j < tempPredictedLabels.n_cols; j++)
+        cMatrix(tempPredictedLabels(j), j) += alpha[i];
+    }
 
-  for (size_t i = 0; i < predictedLabels.n_cols; i++)
-  {
-    cMRow = cMatrix.unsafe_col(i);
-    cMRow.max(maxIndex);
-    predictedLabels(i) = maxIndex;
+    for (size_t j = 0; j < block.n_cols; j++)
+    {
+      arma::uword maxIndex = 0;
+      cMatrix.unsafe_col(j).max(maxIndex);
+      predictedLabels(begin + j) = maxIndex;
+    }
   }
 }
 
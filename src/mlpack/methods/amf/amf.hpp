@@ -25,6 +25,8 @@
 #include <mlpack/methods/amf/update_rules/svd_batch_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_incomplete_incremental_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_complete_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/svd_parallel_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/weighted_als.hpp>
 
 #include <mlpack/methods/amf/init_rules/random_init.hpp>
 #include <mlpack/methods/amf/init_rules/random_acol_init.hpp>
@@ -142,6 +144,18 @@ typedef amf::AMF<amf::SimpleResidueTermination,
                  amf::RandomAcolInitialization<>,
                  amf::NMFALSUpdate> NMFALSFactorizer;
 
+/**
+ * WeightedALSFactorizer factorizes given matrix V into two matrices W and H by
+ * alternating least squares with weighted-lambda regularization.  For sparse
+ * matrices, only the nonzero elements are fitted, and the least squares
+ * problems of the rows of W and the columns of H are solved in parallel.
+ *
+ * @see WeightedALSUpdate
+ */
+typedef amf::AMF<amf::SimpleResidueTermination,
+                 amf::RandomAcolInitialization<>,
+                 amf::WeightedALSUpdate> WeightedALSFactorizer;
+
 //! Convenience typedefs.
 
 /**
@@ -183,6 +197,19 @@ using SVDCompleteIncrementalFactorizer = amf::AMF<
     amf::SimpleResidueTermination,
     amf::RandomAcolInitialization<>,
     amf::SVDCompleteIncrementalLearning<MatType>>;
+
+/**
+ * SVDParallelIncrementalFactorizer factorizes given matrix V into two matrices
+ * W and H by incremental gradient descent on several threads, with the
+ * stratified scheme of Gemulla et al.  Each iteration is a pass over all the
+ * nonzero elements of V.
+ *
+ * @see SVDParallelIncrementalLearning
+ */
+typedef amf::AMF<amf::SimpleResidueTermination,
+                 amf::RandomAcolInitialization<>,
+                 amf::SVDParallelIncrementalLearning>
+    SVDParallelIncrementalFactorizer;
 } // namespace amf
 } // namespace mlpack
 
@@ -13,6 +13,7 @@
 #define _MLPACK_METHODS_AMF_SIMPLERESIDUETERMINATION_HPP_INCLUDED
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/rate_limiter.hpp>
 
 namespace mlpack {
 namespace amf {
@@ -26,6 +27,12 @@ namespace amf {
  * IsConverged() will return true.  This class is meant for use with the AMF
  * (alternating matrix factorization) class.
  *
+ * The norm of WH is computed from the Gram matrix W^T W, so each check costs
+ * O((m + n) r^2) instead of O(m n r) for an m x n input of rank r.  Because
+ * the residue of a single iteration is often not needed, it can be computed
+ * only every few iterations with the checkInterval parameter; the residue is
+ * then the relative change of the norm since the last check.
+ *
  * @see AMF
  */
 class SimpleResidueTermination
@@ -34,14 +41,20 @@ class SimpleResidueTermination
   /**
    * Construct the SimpleResidueTermination object with the given minimum
    * residue (or the default) and the given maximum number of iterations (or the
-   * default).  0 indicates no iteration limit.
+   * default).  0 indicates no iteration limit.  The residue is computed every
+   * checkInterval iterations.
    *
    * @param minResidue Minimum residue for termination.
    * @param maxIterations Maximum number of iterations.
+   * @param checkInterval Number of iterations between computations of the
+   *     residue.
    */
   SimpleResidueTermination(const double minResidue = 1e-5,
-                           const size_t maxIterations = 10000)
-      : minResidue(minResidue), maxIterations(maxIterations) { }
+                           const size_t maxIterations = 10000,
+                           const size_t checkInterval = 1)
+      : minResidue(minResidue),
+        maxIterations(maxIterations),
+        checkInterval(std::max(checkInterval, (size_t) 1)) { }
 
   /**
    * Initializes the termination policy before stating the factorization.
@@ -57,6 +70,7 @@ class SimpleResidueTermination
     nm = V.n_rows * V.n_cols;
     // Remove history.
     normOld = 0;
+    progress.Reset();
   }
 
   /**
@@ -67,19 +81,30 @@ class SimpleResidueTermination
    */
   bool IsConverged(arma::mat& W, arma::mat& H)
   {
-    // Calculate the norm and compute the residue, but do it by hand, so as to
-    // avoid calculating (W*H), which may be very large.
+    // Increment iteration count
+    iteration++;
+
+    // Only compute the residue every checkInterval iterations.
+    if (iteration % checkInterval != 0)
+      return (iteration == maxIterations);
+
+    // The norm of column j of WH is sqrt(h_j^T (W^T W) h_j), so we never need
+    // to calculate (W*H), which may be very large.
+    const arma::mat gram = W.t() * W;
+    const arma::rowvec squaredNorms = arma::sum(H % (gram * H), 0);
     double norm = 0.0;
-    for (size_t j = 0; j < H.n_cols; ++j)
-      norm += arma::norm(W * H.col(j), "fro");
+    for (size_t j = 0; j < squaredNorms.n_elem; ++j)
+      norm += std::sqrt(std::max(squaredNorms[j], 0.0));
     residue = fabs(normOld - norm) / normOld;
 
     // Store the norm.
     normOld = norm;
 
-    // Increment iteration count
-    iteration++;
-    Log::Info << "Iteration " << iteration << "; residue " << residue << ".\n";
+    if (progress.Ready())
+    {
+      Log::Info << "Iteration " << iteration << "; residue " << residue
+          << ".\n";
+    }
 
     // Check if termination criterion is met.
     // If maxIterations == 0, there is no iteration limit.
@@ -100,11 +125,17 @@ class SimpleResidueTermination
   const double& MinResidue() const { return minResidue; }
   double& MinResidue() { return minResidue; }
 
+  //! Access the number of iterations between computations of the residue.
+  const size_t& CheckInterval() const { return checkInterval; }
+  size_t& CheckInterval() { return checkInterval; }
+
  public:
   //! residue threshold
   double minResidue;
   //! iteration threshold
   size_t maxIterations;
+  //! number of iterations between computations of the residue
+  size_t checkInterval;
 
   //! current value of residue
   double residue;
@@ -114,6 +145,9 @@ class SimpleResidueTermination
   double normOld;
 
   size_t nm;
+
+  //! limits the iteration messages to one per second
+  util::RateLimiter progress;
 }; // class SimpleResidueTermination
 
 } // namespace amf
@@ -13,6 +13,7 @@
 #define _MLPACK_METHODS_AMF_SIMPLE_TOLERANCE_TERMINATION_HPP_INCLUDED
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/rate_limiter.hpp>
 
 namespace mlpack {
 namespace amf {
@@ -58,6 +59,7 @@ class SimpleToleranceTermination
     c_indexOld = 0;
 
     reverseStepCount = 0;
+    progress.Reset();
   }
 
   /**
@@ -97,8 +99,11 @@ class SimpleToleranceTermination
 
     // increment iteration count
     iteration++;
-    Log::Info << "Iteration " << iteration << "; residue "
-        << ((residueOld - residue) / residueOld) << ".\n";
+    if (progress.Ready())
+    {
+      Log::Info << "Iteration " << iteration << "; residue "
+          << ((residueOld - residue) / residueOld) << ".\n";
+    }
 
     // if residue tolerance is not satisfied
     if ((residueOld - residue) / residueOld < tolerance && iteration > 4)
@@ -190,6 +195,9 @@ class SimpleToleranceTermination
   arma::mat H;
   double c_indexOld;
   double c_index;
+
+  //! limits the iteration messages to one per second
+  util::RateLimiter progress;
 }; // class SimpleToleranceTermination
 
 } // namespace amf
@@ -113,11 +113,8 @@ class ValidationRMSETermination
    */
   bool IsConverged(arma::mat& W, arma::mat& H)
   {
-    arma::mat WH;
-
-    WH = W * H;
-
-    // compute validation RMSE
+    // compute validation RMSE; only the entries of the validation set are
+    // needed, so (W*H), which may be very large, is never calculated
     if (iteration != 0)
     {
       rmseOld = rmse;
@@ -127,7 +124,7 @@ class ValidationRMSETermination
         size_t t_row = test_points(i, 0);
         size_t t_col = test_points(i, 1);
         double t_val = test_points(i, 2);
-        double temp = (t_val - WH(t_row, t_col));
+        double temp = (t_val - arma::dot(W.row(t_row), H.col(t_col)));
         temp *= temp;
         rmse += temp;
       }
@@ -0,0 +1,352 @@
+/**
+ * @file svd_parallel_incremental_learning.hpp
+ *
+ * Parallel SVD factorizer used in AMF (Alternating Matrix Factorization).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_SVD_PARALLEL_INCREMENTAL_LEARNING_HPP
+#define MLPACK_METHODS_AMF_SVD_PARALLEL_INCREMENTAL_LEARNING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack
+{
+namespace amf
+{
+
+/**
+ * This class computes SVD with incremental learning (see
+ * SVDCompleteIncrementalLearning and SVDIncompleteIncrementalLearning) on
+ * several threads, using the stratified scheme of the following paper:
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *   title={Large-scale matrix factorization with distributed stochastic
+ *       gradient descent},
+ *   author={Gemulla, Rainer and Nijkamp, Erik and Haas, Peter J. and
+ *       Sismanis, Yannis},
+ *   booktitle={Proceedings of the 17th ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={69--77},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * The rows and the columns of the input matrix (V) are split into p blocks
+ * each, where p is the number of threads, so that the blocks hold about the
+ * same number of nonzero elements.  An epoch then consists of p strata; in
+ * stratum s, thread t runs the incremental updates of the elements in row
+ * block (t + s) mod p and column block t.  The threads of a stratum never
+ * touch the same rows of W or the same columns of H, so they need no locks,
+ * and every element of V is visited once per epoch.
+ *
+ * With complete incremental learning, W and H are updated after each element,
+ * as in SVDCompleteIncrementalLearning.  With incomplete incremental learning,
+ * the part of a column of V inside a block is handled like a column in
+ * SVDIncompleteIncrementalLearning, and the regularization of each column of H
+ * is applied once per epoch.  With one thread, complete incremental learning
+ * gives the same result as one pass of SVDCompleteIncrementalLearning<sp_mat>
+ * over the nonzero elements, and incomplete incremental learning without
+ * regularization the same result as a pass of SVDIncompleteIncrementalLearning
+ * over the columns.
+ *
+ * Unlike the other incremental update rules, each call to WUpdate() runs a
+ * whole epoch and updates both W and H; HUpdate() does nothing.  So, one
+ * iteration of AMF visits every element of V, and the termination policy
+ * should not be wrapped in CompleteIncrementalTermination or
+ * IncompleteIncrementalTermination.
+ *
+ * @see SVDCompleteIncrementalLearning, SVDIncompleteIncrementalLearning
+ */
+class SVDParallelIncrementalLearning
+{
+ public:
+  /**
+   * Initialize the parameters of SVDParallelIncrementalLearning.
+   *
+   * @param u Step value used in incremental learning.
+   * @param kw Regularization constant for W matrix.
+   * @param kh Regularization constant for H matrix.
+   * @param complete Whether to use complete incremental learning (otherwise,
+   *     incomplete incremental learning is used).
+   */
+  SVDParallelIncrementalLearning(const double u = 0.001,
+                                 const double kw = 0,
+                                 const double kh = 0,
+                                 const bool complete = true) :
+      u(u), kw(kw), kh(kh), complete(complete)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Initialize parameters before factorization.  This function must be called
+   * before a new factorization.  It splits the nonzero elements of the input
+   * matrix into strata for the current number of threads (see NumThreads()).
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param rank rank of factorization
+   */
+  template<typename MatType>
+  void Initialize(const MatType& dataset, const size_t /* rank */)
+  {
+    arma::umat locations(2, arma::accu(dataset != 0));
+    arma::vec values(locations.n_cols);
+    size_t k = 0;
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+    {
+      for (size_t i = 0; i < dataset.n_rows; ++i)
+      {
+        if (dataset(i, j) != 0)
+        {
+          locations(0, k) = i;
+          locations(1, k) = j;
+          values[k++] = dataset(i, j);
+        }
+      }
+    }
+
+    Stratify(dataset.n_rows, dataset.n_cols, locations, values);
+  }
+
+  /**
+   * Initialize parameters before factorization.  This is a specialization for
+   * sparse matrices.
+   *
+   * @param dataset Input matrix to be factorized.
+   * @param rank rank of factorization
+   */
+  void Initialize(const arma::sp_mat& dataset, const size_t /* rank */)
+  {
+    arma::umat locations(2, dataset.n_nonzero);
+    arma::vec values(dataset.n_nonzero);
+    size_t k = 0;
+    for (arma::sp_mat::const_iterator it = dataset.begin();
+         it != dataset.end(); ++it, ++k)
+    {
+      locations(0, k) = it.row();
+      locations(1, k) = it.col();
+      values[k] = *it;
+    }
+
+    Stratify(dataset.n_rows, dataset.n_cols, locations, values);
+  }
+
+  /**
+   * Run one epoch of incremental learning, which updates both W and H.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& /* V */,
+                      arma::mat& W,
+                      arma::mat& H)
+  {
+    const size_t p = colBounds.n_elem - 1;
+    for (size_t s = 0; s < p; ++s)
+    {
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t t = 0; t < (omp_size_t) p; ++t)
+      {
+        const size_t c = (size_t) t;
+        const size_t b = ((c + s) % p) * p + c;
+
+        // Regularize the columns of H of this block once per epoch.
+        if (!complete && s == 0 && kh != 0)
+          H.cols(colBounds[c], colBounds[c + 1] - 1) *= (1 - u * kh);
+
+        if (complete)
+          CompleteUpdate(blockLocations[b], blockValues[b], W, H);
+        else
+          IncompleteUpdate(blockLocations[b], blockValues[b], W, H);
+      }
+    }
+  }
+
+  /**
+   * Does nothing, since H is updated by WUpdate().
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& /* V */,
+                      const arma::mat& /* W */,
+                      arma::mat& /* H */)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the number of strata of an epoch.
+  size_t Strata() const { return colBounds.n_elem - 1; }
+
+ private:
+  /**
+   * Split the nonzero elements, given in column-major order, into p x p
+   * blocks.  The bounds of the row and column blocks are chosen so that each
+   * holds about the same number of elements.
+   */
+  void Stratify(const size_t n,
+                const size_t m,
+                const arma::umat& locations,
+                const arma::vec& values)
+  {
+    const size_t p = std::max(std::min((size_t) NumThreads(),
+        (size_t) std::min(n, m)), (size_t) 1);
+
+    const arma::Col<size_t> rowBounds = Bounds(n, p, locations.row(0));
+    colBounds = Bounds(m, p, locations.row(1));
+
+    // Find the block of each element.
+    arma::Col<size_t> rowBlock(n), colBlock(m);
+    for (size_t i = 0; i < p; ++i)
+    {
+      rowBlock.subvec(rowBounds[i], rowBounds[i + 1] - 1).fill(i);
+      colBlock.subvec(colBounds[i], colBounds[i + 1] - 1).fill(i);
+    }
+
+    arma::Col<size_t> counts(p * p, arma::fill::zeros);
+    for (size_t k = 0; k < values.n_elem; ++k)
+      ++counts[rowBlock[locations(0, k)] * p + colBlock[locations(1, k)]];
+
+    blockLocations.resize(p * p);
+    blockValues.resize(p * p);
+    for (size_t b = 0; b < p * p; ++b)
+    {
+      blockLocations[b].set_size(2, counts[b]);
+      blockValues[b].set_size(counts[b]);
+    }
+
+    // The elements of each block stay in column-major order.
+    counts.zeros();
+    for (size_t k = 0; k < values.n_elem; ++k)
+    {
+      const size_t b = rowBlock[locations(0, k)] * p +
+          colBlock[locations(1, k)];
+      blockLocations[b].col(counts[b]) = locations.col(k);
+      blockValues[b][counts[b]++] = values[k];
+    }
+  }
+
+  /**
+   * Split [0, n) into p nonempty ranges that hold about the same number of the
+   * given indices, and return the p + 1 bounds of the ranges.
+   */
+  static arma::Col<size_t> Bounds(const size_t n,
+                                  const size_t p,
+                                  const arma::urowvec& indices)
+  {
+    arma::Col<size_t> counts(n, arma::fill::zeros);
+    for (size_t k = 0; k < indices.n_elem; ++k)
+      ++counts[indices[k]];
+
+    arma::Col<size_t> bounds(p + 1);
+    bounds[0] = 0;
+    bounds[p] = n;
+    size_t seen = 0;
+    size_t end = 0;
+    for (size_t i = 1; i < p; ++i)
+    {
+      // Leave at least one index for each of the following ranges.
+      const size_t target = (indices.n_elem * i) / p;
+      while (end < n - (p - i) && (end < bounds[i - 1] + 1 || seen < target))
+        seen += counts[end++];
+      bounds[i] = end;
+    }
+
+    return bounds;
+  }
+
+  //! Run complete incremental learning on the elements of one block.
+  void CompleteUpdate(const arma::umat& locations,
+                      const arma::vec& values,
+                      arma::mat& W,
+                      arma::mat& H) const
+  {
+    for (size_t k = 0; k < values.n_elem; ++k)
+    {
+      const size_t i = locations(0, k);
+      const size_t j = locations(1, k);
+
+      arma::rowvec deltaW = (values[k] - arma::dot(W.row(i), H.col(j))) *
+          H.col(j).t();
+      if (kw != 0)
+        deltaW -= kw * W.row(i);
+      W.row(i) += u * deltaW;
+
+      arma::vec deltaH = (values[k] - arma::dot(W.row(i), H.col(j))) *
+          W.row(i).t();
+      if (kh != 0)
+        deltaH -= kh * H.col(j);
+      H.col(j) += u * deltaH;
+    }
+  }
+
+  //! Run incomplete incremental learning on the elements of one block.
+  void IncompleteUpdate(const arma::umat& locations,
+                        const arma::vec& values,
+                        arma::mat& W,
+                        arma::mat& H) const
+  {
+    size_t start = 0;
+    while (start < values.n_elem)
+    {
+      // Find the elements of the current column.
+      const size_t j = locations(1, start);
+      size_t end = start;
+      while (end < values.n_elem && locations(1, end) == j)
+        ++end;
+
+      // Each row only depends on itself and the column of H, so the rows can
+      // be updated in place.
+      for (size_t k = start; k < end; ++k)
+      {
+        const size_t i = locations(0, k);
+        arma::rowvec deltaW = (values[k] - arma::dot(W.row(i), H.col(j))) *
+            H.col(j).t();
+        if (kw != 0)
+          deltaW -= kw * W.row(i);
+        W.row(i) += u * deltaW;
+      }
+
+      arma::vec deltaH(H.n_rows, arma::fill::zeros);
+      for (size_t k = start; k < end; ++k)
+      {
+        const size_t i = locations(0, k);
+        deltaH += (values[k] - arma::dot(W.row(i), H.col(j))) *
+            W.row(i).t();
+      }
+      H.col(j) += u * deltaH;
+
+      start = end;
+    }
+  }
+
+  //! Step size of incremental learning.
+  double u;
+  //! Regularization parameter for W matrix.
+  double kw;
+  //! Regularization parameter for H matrix.
+  double kh;
+  //! Whether to use complete incremental learning.
+  bool complete;
+
+  //! The bounds of the column blocks.
+  arma::Col<size_t> colBounds;
+  //! The locations of the elements of each block, in column-major order.
+  std::vector<arma::umat> blockLocations;
+  //! The values of the elements of each block.
+  std::vector<arma::vec> blockValues;
+};
+
+} // namespace amf
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,300 @@
+/**
+ * @file weighted_als.hpp
+ *
+ * Update rules for alternating least squares with weighted-lambda
+ * regularization, which only fits the observed entries of sparse matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_WEIGHTED_ALS_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_WEIGHTED_ALS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace amf {
+
+/**
+ * This class implements alternating least squares with weighted-lambda
+ * regularization (ALS-WR), as described in the following paper:
+ *
+ * @code
+ * @inproceedings{zhou2008large,
+ *   title={Large-scale parallel collaborative filtering for the Netflix
+ *       prize},
+ *   author={Zhou, Y. and Wilkinson, D. and Schreiber, R. and Pan, R.},
+ *   booktitle={International Conference on Algorithmic Applications in
+ *       Management},
+ *   pages={337--348},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * It minimizes
+ *
+ * \f[
+ * \sum_{(i, j) \in I} (V_{ij} - W_i H_j)^2 + \lambda \left( \sum_i n_i
+ *     \| W_i \|^2 + \sum_j m_j \| H_j \|^2 \right)
+ * \f]
+ *
+ * where \f$ I \f$ is the set of observed entries of V, \f$ n_i \f$ is the
+ * number of observed entries in row i and \f$ m_j \f$ is the number of
+ * observed entries in column j.  When W is held fixed, each column of H is the
+ * solution of an independent r x r least squares problem that only involves
+ * the observed entries of the corresponding column of V (and vice versa for
+ * the rows of W), so these problems are solved in parallel with OpenMP.
+ *
+ * For sparse matrices, only the nonzero elements are considered observed.
+ * Each small system is solved with a Cholesky decomposition, or, if
+ * conjugate gradient is enabled, with a few conjugate gradient steps started
+ * from the current solution; the conjugate gradient steps never form the
+ * system matrix, which is cheaper when the rank is large.  For dense matrices,
+ * every entry is observed, and all the columns share the same system, which is
+ * solved only once.
+ *
+ * Unlike NMFALSUpdate, the factors are not constrained to be non-negative.
+ */
+class WeightedALSUpdate
+{
+ public:
+  /**
+   * Create the update rule with the given parameters.
+   *
+   * @param lambda Regularization parameter; each row of W and column of H is
+   *     penalized by lambda times its number of observed entries.
+   * @param conjugateGradient If true, use conjugate gradient steps instead of
+   *     the Cholesky decomposition for sparse matrices.
+   * @param cgIterations Number of conjugate gradient steps for each least
+   *     squares problem.
+   */
+  WeightedALSUpdate(const double lambda = 0.01,
+                    const bool conjugateGradient = false,
+                    const size_t cgIterations = 3) :
+      lambda(lambda),
+      conjugateGradient(conjugateGradient),
+      cgIterations(cgIterations)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Set initial values for the factorization.  In this case, we don't need to
+   * set anything.
+   */
+  template<typename MatType>
+  void Initialize(const MatType& /* dataset */, const size_t /* rank */)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * The update rule for the basis matrix W.  For dense matrices, every entry
+   * is observed, so the formula used is
+   *
+   * \f[
+   * W^T = (H H^T + \lambda m I)^{-1} H V^T
+   * \f]
+   *
+   * where m is the number of columns of V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename MatType>
+  inline void WUpdate(const MatType& V,
+                      arma::mat& W,
+                      const arma::mat& H)
+  {
+    arma::mat gram = H * H.t();
+    gram.diag() += lambda * V.n_cols;
+    W = arma::solve(gram, H * V.t()).t();
+  }
+
+  /**
+   * The update rule for the encoding matrix H.  For dense matrices, every
+   * entry is observed, so the formula used is
+   *
+   * \f[
+   * H = (W^T W + \lambda n I)^{-1} W^T V
+   * \f]
+   *
+   * where n is the number of rows of V.
+   *
+   * @param V Input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename MatType>
+  inline void HUpdate(const MatType& V,
+                      const arma::mat& W,
+                      arma::mat& H)
+  {
+    arma::mat gram = W.t() * W;
+    gram.diag() += lambda * V.n_rows;
+    H = arma::solve(gram, W.t() * V);
+  }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get whether conjugate gradient is used for sparse matrices.
+  bool ConjugateGradient() const { return conjugateGradient; }
+  //! Modify whether conjugate gradient is used for sparse matrices.
+  bool& ConjugateGradient() { return conjugateGradient; }
+
+  //! Get the number of conjugate gradient steps.
+  size_t CGIterations() const { return cgIterations; }
+  //! Modify the number of conjugate gradient steps.
+  size_t& CGIterations() { return cgIterations; }
+
+  //! Serialize the update rule.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(lambda);
+    ar & BOOST_SERIALIZATION_NVP(conjugateGradient);
+    ar & BOOST_SERIALIZATION_NVP(cgIterations);
+  }
+
+ private:
+  /**
+   * Solve the least squares problem of each column of the given factor, using
+   * only the nonzero elements of the corresponding column of the data.  The
+   * columns are solved in parallel.
+   *
+   * @param data Sparse data, with one column for each column of the factor.
+   * @param fixed Fixed factor, with one column for each row of the data.
+   * @param factor Factor to be updated.
+   */
+  inline void Solve(const arma::sp_mat& data,
+                    const arma::mat& fixed,
+                    arma::mat& factor) const;
+
+  //! Regularization parameter.
+  double lambda;
+  //! Whether to use conjugate gradient for sparse matrices.
+  bool conjugateGradient;
+  //! Number of conjugate gradient steps.
+  size_t cgIterations;
+}; // class WeightedALSUpdate
+
+/**
+ * WUpdate function specialization for sparse matrices.  Each row of W is
+ * fitted to the nonzero elements of the corresponding row of V.
+ */
+template<>
+inline void WeightedALSUpdate::WUpdate<arma::sp_mat>(const arma::sp_mat& V,
+                                                     arma::mat& W,
+                                                     const arma::mat& H)
+{
+  // The rows of V are the columns of its transpose, which are much faster to
+  // iterate over.
+  const arma::sp_mat vt = V.t();
+  arma::mat wt = W.t();
+  Solve(vt, H, wt);
+  W = wt.t();
+}
+
+/**
+ * HUpdate function specialization for sparse matrices.  Each column of H is
+ * fitted to the nonzero elements of the corresponding column of V.
+ */
+template<>
+inline void WeightedALSUpdate::HUpdate<arma::sp_mat>(const arma::sp_mat& V,
+                                                     const arma::mat& W,
+                                                     arma::mat& H)
+{
+  const arma::mat wt = W.t();
+  Solve(V, wt, H);
+}
+
+inline void WeightedALSUpdate::Solve(const arma::sp_mat& data,
+                                     const arma::mat& fixed,
+                                     arma::mat& factor) const
+{
+  #pragma omp parallel
+  {
+    // Buffers for the observed entries of each column, reused by each thread.
+    std::vector<arma::uword> rows;
+    std::vector<double> values;
+    arma::mat gram, cholesky;
+    arma::vec x, residual, direction, product;
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t j = 0; j < (omp_size_t) data.n_cols; ++j)
+    {
+      rows.clear();
+      values.clear();
+      for (arma::sp_mat::const_iterator it = data.begin_col(j);
+           it != data.end_col(j); ++it)
+      {
+        rows.push_back(it.row());
+        values.push_back(*it);
+      }
+
+      // Without observed entries, the regularized solution is zero.
+      if (rows.empty())
+      {
+        factor.col(j).zeros();
+        continue;
+      }
+
+      const arma::uvec indices(rows.data(), rows.size(), false, true);
+      const arma::vec observed(values.data(), values.size(), false, true);
+      const arma::mat local = fixed.cols(indices);
+      const double penalty = lambda * rows.size();
+      const arma::vec b = local * observed;
+
+      if (!conjugateGradient)
+      {
+        gram = local * local.t();
+        gram.diag() += penalty;
+
+        // The system is symmetric positive definite unless lambda is zero and
+        // the column has fewer observed entries than the rank.
+        if (arma::chol(cholesky, gram))
+        {
+          factor.col(j) = arma::solve(arma::trimatu(cholesky),
+              arma::solve(arma::trimatl(cholesky.t()), b));
+        }
+        else
+        {
+          factor.col(j) = arma::solve(gram, b);
+        }
+      }
+      else
+      {
+        // Take a few conjugate gradient steps from the current solution.
+        x = factor.col(j);
+        residual = b - local * (local.t() * x) - penalty * x;
+        direction = residual;
+        double residualNorm = arma::dot(residual, residual);
+
+        for (size_t k = 0; k < cgIterations && residualNorm > 0.0; ++k)
+        {
+          product = local * (local.t() * direction) + penalty * direction;
+          const double alpha = residualNorm / arma::dot(direction, product);
+          x += alpha * direction;
+          residual -= alpha * product;
+
+          const double newResidualNorm = arma::dot(residual, residual);
+          direction = residual + (newResidualNorm / residualNorm) * direction;
+          residualNorm = newResidualNorm;
+        }
+
+        factor.col(j) = x;
+      }
+    }
+  }
+}
+
+} // namespace amf
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_AMF_UPDATE_RULES_WEIGHTED_ALS_HPP
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_LOGISTIC_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "fast_math.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -61,6 +62,20 @@ class LogisticFunction
     y = (1.0 / (1 + arma::exp(-x)));
   }
 
+  /**
+   * Computes the logistic function of a whole matrix, with the vectorized
+   * approximation of FastMath.
+   *
+   * @param x Input data.
+   * @param y The resulting output activation.
+   */
+  template<typename eT>
+  static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
+  {
+    y.set_size(x.n_rows, x.n_cols);
+    FastMath::Logistic<FastMath::Accurate>(x.memptr(), y.memptr(), x.n_elem);
+  }
+
   /**
    * Computes the first derivative of the logistic function.
    *
@@ -27,6 +27,7 @@
 #define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_SOFTPLUS_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "fast_math.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -71,6 +72,20 @@ class SoftplusFunction
       y(i) = Fn(x(i));
   }
 
+  /**
+   * Computes the softplus function of a whole matrix, with the vectorized
+   * approximation of FastMath.
+   *
+   * @param x Input data.
+   * @param y The resulting output activation.
+   */
+  template<typename eT>
+  static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
+  {
+    y.set_size(x.n_rows, x.n_cols);
+    FastMath::Softplus<FastMath::Accurate>(x.memptr(), y.memptr(), x.n_elem);
+  }
+
   /**
    * Computes the first derivative of the softplus function.
    *
@@ -94,6 +109,20 @@ class SoftplusFunction
     x = 1.0 / (1 + arma::exp(-y));
   }
 
+  /**
+   * Computes the first derivatives of the softplus function of a whole
+   * matrix, with the vectorized approximation of FastMath.
+   *
+   * @param y Input activations.
+   * @param x The resulting derivatives.
+   */
+  template<typename eT>
+  static void Deriv(const arma::Mat<eT>& y, arma::Mat<eT>& x)
+  {
+    x.set_size(y.n_rows, y.n_cols);
+    FastMath::Logistic<FastMath::Accurate>(y.memptr(), x.memptr(), y.n_elem);
+  }
+
   /**
    * Computes the inverse of the softplus function.
    *
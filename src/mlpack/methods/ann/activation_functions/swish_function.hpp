@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_SWISH_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "fast_math.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -42,7 +43,8 @@ class SwishFunction
   }
 
   /**
-   * Computes the swish function using a matrix as input.
+   * Computes the swish function using a matrix as input, with the vectorized
+   * approximation of FastMath.
    *
    * @param x Input data.
    * @param y The resulting output activation.
@@ -50,7 +52,8 @@ class SwishFunction
   template<typename eT>
   static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
   {
-    y = x / (1.0 + arma::exp(-x));
+    y.set_size(x.n_rows, x.n_cols);
+    FastMath::Swish<FastMath::Accurate>(x.memptr(), y.memptr(), x.n_elem);
   }
 
   /**
@@ -92,6 +95,22 @@ class SwishFunction
     x = y / (1 + arma::exp(-y)) + (1 - y / (1 + arma::exp(-y))) /
                                            (1 + arma::exp(-y));
   }
+
+  /**
+   * Computes the first derivatives of the swish function using a matrix as
+   * input, with the vectorized approximation of FastMath.
+   *
+   * @param y Input activations.
+   * @param x The resulting derivatives.
+   */
+  template<typename eT>
+  static void Deriv(const arma::Mat<eT>& y, arma::Mat<eT>& x)
+  {
+    arma::Mat<eT> sigmoid(y.n_rows, y.n_cols);
+    FastMath::Logistic<FastMath::Accurate>(y.memptr(), sigmoid.memptr(),
+        y.n_elem);
+    x = y % sigmoid + sigmoid % (1 - y % sigmoid);
+  }
 }; // class SwishFunction
 
 } // namespace ann
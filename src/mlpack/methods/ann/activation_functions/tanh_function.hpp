@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_TANH_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "fast_math.hpp"
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -52,6 +53,20 @@ class TanhFunction
     y = arma::tanh(x);
   }
 
+  /**
+   * Computes the tanh function of a whole matrix, with the vectorized
+   * approximation of FastMath.
+   *
+   * @param x Input data.
+   * @param y The resulting output activation.
+   */
+  template<typename eT>
+  static void Fn(const arma::Mat<eT>& x, arma::Mat<eT>& y)
+  {
+    y.set_size(x.n_rows, x.n_cols);
+    FastMath::Tanh<FastMath::Accurate>(x.memptr(), y.memptr(), x.n_elem);
+  }
+
   /**
    * Computes the first derivative of the tanh function.
    *
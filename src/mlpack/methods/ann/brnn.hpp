@@ -33,6 +33,9 @@ namespace ann /** Artificial Neural Network. */ {
 
 /**
  * Implementation of a standard bidirectional recurrent neural network container.
+ * The forward and the backward RNN are independent until their outputs are
+ * merged, so their forward passes and their BPTT passes run as parallel
+ * sections when OpenMP is enabled.
  *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
@@ -54,6 +57,13 @@ class BRNN
                            InitializationRuleType,
                            CustomLayers...>;
 
+  //! The matrix type of the network, given by the output layer.
+  typedef typename std::remove_reference<decltype(
+      std::declval<OutputLayerType&>().OutputParameter())>::type MatType;
+
+  //! The cube type of the sequences given to the network.
+  typedef arma::Cube<typename MatType::elem_type> CubeType;
+
   /**
    * Create the BRNN object.
    *
@@ -100,8 +110,8 @@ class BRNN
    * @param optimizer Instantiated optimizer used to train the model.
    */
   template<typename OptimizerType>
-  void Train(arma::cube predictors,
-             arma::cube responses,
+  void Train(CubeType predictors,
+             CubeType responses,
              OptimizerType& optimizer);
 
   /**
@@ -128,7 +138,7 @@ class BRNN
    * @param responses Outputs results from input training variables.
    */
   template<typename OptimizerType = ens::StandardSGD>
-  void Train(arma::cube predictors, arma::cube responses);
+  void Train(CubeType predictors, CubeType responses);
 
   /**
    * Predict the responses to a given set of predictors. The responses will
@@ -149,8 +159,8 @@ class BRNN
    * @param results Matrix to put output predictions of responses into.
    * @param batchSize Number of points to predict at once.
    */
-  void Predict(arma::cube predictors,
-               arma::cube& results,
+  void Predict(CubeType predictors,
+               CubeType& results,
                const size_t batchSize = 256);
 
   /**
@@ -166,7 +176,7 @@ class BRNN
    * @param deterministic Whether or not to train or test the model. Note some
    *        layer act differently in training or testing mode.
    */
-  double Evaluate(const arma::mat& parameters,
+  double Evaluate(const MatType& parameters,
                   const size_t begin,
                   const size_t batchSize,
                   const bool deterministic);
@@ -183,7 +193,7 @@ class BRNN
    * @param batchSize Number of points to be passed at a time to use for
    *        objective function evaluation.
    */
-  double Evaluate(const arma::mat& parameters,
+  double Evaluate(const MatType& parameters,
                   const size_t begin,
                   const size_t batchSize);
 
@@ -201,7 +211,7 @@ class BRNN
    *        objective function evaluation.
    */
   template<typename GradType>
-  double EvaluateWithGradient(const arma::mat& parameters,
+  double EvaluateWithGradient(const MatType& parameters,
                               const size_t begin,
                               GradType& gradient,
                               const size_t batchSize);
@@ -219,9 +229,9 @@ class BRNN
    * @param batchSize Number of points to be processed as a batch for objective
    *        function gradient evaluation.
    */
-  void Gradient(const arma::mat& parameters,
+  void Gradient(const MatType& parameters,
                 const size_t begin,
-                arma::mat& gradient,
+                MatType& gradient,
                 const size_t batchSize);
 
   /**
@@ -243,15 +253,15 @@ class BRNN
    *
    * @param layer The Layer to be added to the model.
    */
-  void Add(LayerTypes<CustomLayers...> layer);
+  void Add(TypedLayerTypes<MatType, CustomLayers...> layer);
 
   //! Return the number of separable functions. (number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
   //! Return the initial point for the optimization.
-  const arma::mat& Parameters() const { return parameter; }
+  const MatType& Parameters() const { return parameter; }
   //! Modify the initial point for the optimization.
-  arma::mat& Parameters() { return parameter; }
+  MatType& Parameters() { return parameter; }
 
   //! Return the maximum length of backpropagation through time.
   const size_t& Rho() const { return rho; }
@@ -259,14 +269,14 @@ class BRNN
   size_t& Rho() { return rho; }
 
   //! Get the matrix of responses to the input data points.
-  const arma::cube& Responses() const { return responses; }
+  const CubeType& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
-  arma::cube& Responses() { return responses; }
+  CubeType& Responses() { return responses; }
 
   //! Get the matrix of data points (predictors).
-  const arma::cube& Predictors() const { return predictors; }
+  const CubeType& Predictors() const { return predictors; }
   //! Modify the matrix of data points (predictors).
-  arma::cube& Predictors() { return predictors; }
+  CubeType& Predictors() { return predictors; }
 
   /**
    * Reset the state of the network.  This ensures that all internally-held
@@ -299,10 +309,10 @@ class BRNN
   OutputLayerType outputLayer;
 
   //! Locally-stored merge Layer
-  LayerTypes<CustomLayers...> mergeLayer;
+  TypedLayerTypes<MatType, CustomLayers...> mergeLayer;
 
   //! Locally-stored merge Layer
-  LayerTypes<CustomLayers...> mergeOutput;
+  TypedLayerTypes<MatType, CustomLayers...> mergeOutput;
 
   //! Instantiated InitializationRule object for initializing the network
   //! parameter.
@@ -324,31 +334,31 @@ class BRNN
   bool single;
 
   //! The matrix of data points (predictors).
-  arma::cube predictors;
+  CubeType predictors;
 
   //! The matrix of responses to the input data points.
-  arma::cube responses;
+  CubeType responses;
 
   //! Matrix of (trained) parameters.
-  arma::mat parameter;
+  MatType parameter;
 
   //! The number of separable functions (the number of predictor points).
   size_t numFunctions;
 
   //! The current error for the backward pass.
-  arma::mat error;
+  MatType error;
 
   //! Locally-stored delta visitor.
-  DeltaVisitor deltaVisitor;
+  DeltaVisitor<MatType> deltaVisitor;
 
   //! Locally-stored output parameter visitor.
-  OutputParameterVisitor outputParameterVisitor;
+  OutputParameterVisitor<MatType> outputParameterVisitor;
 
   //! All output parameters for the backward pass (BBTT) for forward RNN.
-  std::vector<arma::mat> forwardRNNOutputParameter;
+  std::vector<MatType> forwardRNNOutputParameter;
 
   //! All output parameters for the backward pass (BBTT) for backward RNN.
-  std::vector<arma::mat> backwardRNNOutputParameter;
+  std::vector<MatType> backwardRNNOutputParameter;
 
   //! Locally-stored weight size visitor.
   WeightSizeVisitor weightSizeVisitor;
@@ -360,19 +370,16 @@ class BRNN
   DeleteVisitor deleteVisitor;
 
   //! Locally-stored delete visitor.
-  CopyVisitor<CustomLayers...> copyVisitor;
+  CopyVisitor<MatType, CustomLayers...> copyVisitor;
 
   //! The current evaluation mode (training or testing).
   bool deterministic;
 
   //! The current gradient for the gradient pass for forward RNN.
-  arma::mat forwardGradient;
+  MatType forwardGradient;
 
   //! The current gradient for the gradient pass for backward RNN.
-  arma::mat backwardGradient;
-
-  //! The total gradient from each gradient pass.
-  arma::mat totalGradient;
+  MatType backwardGradient;
 
   //! Forward RNN
   RNN<OutputLayerType, InitializationRuleType, CustomLayers...> forwardRNN;
@@ -66,8 +66,8 @@ template<typename OutputLayerType, typename MergeLayerType,
 template<typename OptimizerType>
 void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     InitializationRuleType, CustomLayers...>::Train(
-    arma::cube predictors,
-    arma::cube responses,
+    CubeType predictors,
+    CubeType responses,
     OptimizerType& optimizer)
 {
   numFunctions = responses.n_cols;
@@ -98,8 +98,8 @@ template<typename OutputLayerType, typename MergeLayerType,
 template<typename OptimizerType>
 void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     InitializationRuleType, CustomLayers...>::Train(
-    arma::cube predictors,
-    arma::cube responses)
+    CubeType predictors,
+    CubeType responses)
 {
   numFunctions = responses.n_cols;
 
@@ -128,7 +128,7 @@ template<typename OutputLayerType, typename MergeLayerType,
          typename... CustomLayers>
 void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     InitializationRuleType, CustomLayers...>::Predict(
-    arma::cube predictors, arma::cube& results, const size_t batchSize)
+    CubeType predictors, CubeType& results, const size_t batchSize)
 {
   forwardRNN.rho = backwardRNN.rho = rho;
 
@@ -147,49 +147,59 @@ void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
 
   if (std::is_same<MergeLayerType, Concat<>>::value)
   {
-    results = arma::zeros<arma::cube>(outputSize * 2, predictors.n_cols, rho);
+    results = arma::zeros<CubeType>(outputSize * 2, predictors.n_cols, rho);
   }
   else
   {
-    results = arma::zeros<arma::cube>(outputSize, predictors.n_cols, rho);
+    results = arma::zeros<CubeType>(outputSize, predictors.n_cols, rho);
   }
 
-  std::vector<arma::mat> results1, results2;
-  arma::mat input;
+  std::vector<MatType> results1, results2;
+  MatType input;
 
   // Forward both RNN's from opposite directions.
   for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
   {
     const size_t effectiveBatchSize = std::min(batchSize,
         size_t(predictors.n_cols - begin));
-    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    // The directions are independent until the merge layer, so they run as
+    // parallel sections, each saving its outputs into its own buffer.
+    #pragma omp parallel sections
     {
-      forwardRNN.Forward(std::move(arma::mat(
-          predictors.slice(seqNum).colptr(begin),
-          predictors.n_rows, effectiveBatchSize, false, true)));
-      backwardRNN.Forward(std::move(arma::mat(
-          predictors.slice(rho - seqNum - 1).colptr(begin),
-          predictors.n_rows, effectiveBatchSize, false, true)));
-
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          std::move(results1)), forwardRNN.network.back());
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          std::move(results2)), backwardRNN.network.back());
+      #pragma omp section
+      for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+      {
+        forwardRNN.Forward(std::move(MatType(
+            predictors.slice(seqNum).colptr(begin),
+            predictors.n_rows, effectiveBatchSize, false, true)));
+        boost::apply_visitor(SaveOutputParameterVisitor<MatType>(
+            std::move(results1)), forwardRNN.network.back());
+      }
+
+      #pragma omp section
+      for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+      {
+        backwardRNN.Forward(std::move(MatType(
+            predictors.slice(rho - seqNum - 1).colptr(begin),
+            predictors.n_rows, effectiveBatchSize, false, true)));
+        boost::apply_visitor(SaveOutputParameterVisitor<MatType>(
+            std::move(results2)), backwardRNN.network.back());
+      }
     }
     reverse(results1.begin(), results1.end());
 
     // Forward outputs from both RNN's through merge layer for each time step.
     for (size_t seqNum = 0; seqNum < rho; ++seqNum)
     {
-      boost::apply_visitor(LoadOutputParameterVisitor(
+      boost::apply_visitor(LoadOutputParameterVisitor<MatType>(
           std::move(results1)), forwardRNN.network.back());
-      boost::apply_visitor(LoadOutputParameterVisitor(
+      boost::apply_visitor(LoadOutputParameterVisitor<MatType>(
           std::move(results2)), backwardRNN.network.back());
 
-      boost::apply_visitor(ForwardVisitor(std::move(input),
+      boost::apply_visitor(ForwardVisitor<MatType>(std::move(input),
           std::move(boost::apply_visitor(outputParameterVisitor, mergeLayer))),
           mergeLayer);
-      boost::apply_visitor(ForwardVisitor(
+      boost::apply_visitor(ForwardVisitor<MatType>(
           std::move(boost::apply_visitor(outputParameterVisitor, mergeLayer)),
           std::move(boost::apply_visitor(outputParameterVisitor, mergeOutput))),
           mergeOutput);
@@ -205,7 +215,7 @@ template<typename OutputLayerType, typename MergeLayerType,
          typename... CustomLayers>
 double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     InitializationRuleType, CustomLayers...>::Evaluate(
-    const arma::mat& /* parameters */,
+    const MatType& /* parameters */,
     const size_t begin,
     const size_t batchSize,
     const bool deterministic)
@@ -238,20 +248,29 @@ double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
   double performance = 0;
   size_t responseSeq = 0;
 
-  std::vector<arma::mat> results1, results2;
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  // Forward both directions in parallel; see Predict().
+  std::vector<MatType> results1, results2;
+  #pragma omp parallel sections
   {
-    forwardRNN.Forward(std::move(arma::mat(
-        predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true)));
-    backwardRNN.Forward(std::move(arma::mat(
-        predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true)));
-
-    boost::apply_visitor(SaveOutputParameterVisitor(
-        std::move(results1)), forwardRNN.network.back());
-    boost::apply_visitor(SaveOutputParameterVisitor(
-        std::move(results2)), backwardRNN.network.back());
+    #pragma omp section
+    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    {
+      forwardRNN.Forward(std::move(MatType(
+          predictors.slice(seqNum).colptr(begin),
+          predictors.n_rows, batchSize, false, true)));
+      boost::apply_visitor(SaveOutputParameterVisitor<MatType>(
+          std::move(results1)), forwardRNN.network.back());
+    }
+
+    #pragma omp section
+    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    {
+      backwardRNN.Forward(std::move(MatType(
+          predictors.slice(rho - seqNum - 1).colptr(begin),
+          predictors.n_rows, batchSize, false, true)));
+      boost::apply_visitor(SaveOutputParameterVisitor<MatType>(
+          std::move(results2)), backwardRNN.network.back());
+    }
   }
   if (outputSize == 0)
   {
@@ -262,28 +281,28 @@ double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
   reverse(results1.begin(), results1.end());
 
   // Performance calculation after forwarding through merge layer.
-  arma::mat input;
+  MatType input;
   for (size_t seqNum = 0; seqNum < rho; ++seqNum)
   {
     if (!single)
     {
       responseSeq = seqNum;
     }
-    boost::apply_visitor(LoadOutputParameterVisitor(
+    boost::apply_visitor(LoadOutputParameterVisitor<MatType>(
         std::move(results1)), forwardRNN.network.back());
-    boost::apply_visitor(LoadOutputParameterVisitor(
+    boost::apply_visitor(LoadOutputParameterVisitor<MatType>(
         std::move(results2)), backwardRNN.network.back());
 
-    boost::apply_visitor(ForwardVisitor(std::move(input),
+    boost::apply_visitor(ForwardVisitor<MatType>(std::move(input),
         std::move(boost::apply_visitor(outputParameterVisitor, mergeLayer))),
         mergeLayer);
-    boost::apply_visitor(ForwardVisitor(
+    boost::apply_visitor(ForwardVisitor<MatType>(
         std::move(boost::apply_visitor(outputParameterVisitor, mergeLayer)),
         std::move(boost::apply_visitor(outputParameterVisitor, mergeOutput))),
         mergeOutput);
     performance += outputLayer.Forward(std::move(
         boost::apply_visitor(outputParameterVisitor, mergeOutput)),
-        std::move(arma::mat(responses.slice(responseSeq).colptr(begin),
+        std::move(MatType(responses.slice(responseSeq).colptr(begin),
         responses.n_rows, batchSize, false, true)));
   }
   return performance;
@@ -294,7 +313,7 @@ template<typename OutputLayerType, typename MergeLayerType,
          typename... CustomLayers>
 double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     InitializationRuleType, CustomLayers...>::Evaluate(
-    const arma::mat& parameters,
+    const MatType& parameters,
     const size_t begin,
     const size_t batchSize)
 {
@@ -307,7 +326,7 @@ template<typename OutputLayerType, typename MergeLayerType,
 template<typename GradType>
 double BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     InitializationRuleType, CustomLayers...>::
-EvaluateWithGradient(const arma::mat& /* parameters */,
+EvaluateWithGradient(const MatType& /* parameters */,
                      const size_t begin,
                      GradType& gradient,
                      const size_t batchSize)
@@ -319,7 +338,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     {
       ResetParameters();
     }
-    gradient = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+    gradient = arma::zeros<MatType>(parameter.n_rows, parameter.n_cols);
   }
   else
   {
@@ -328,10 +347,10 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   if (backwardGradient.is_empty())
   {
-    backwardGradient = arma::zeros<arma::mat>(
+    backwardGradient = arma::zeros<MatType>(
         parameter.n_rows/ 2,
         parameter.n_cols);
-    forwardGradient = arma::zeros<arma::mat>(
+    forwardGradient = arma::zeros<MatType>(
         parameter.n_rows/ 2,
         parameter.n_cols);
   }
@@ -355,28 +374,39 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   backwardRNN.ResetCells();
   size_t networkSize = backwardRNN.network.size();
 
-  // Forward propogation from both directions.
-  std::vector<arma::mat> results1, results2;
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  // Forward propogation from both directions, in parallel; see Predict().
+  std::vector<MatType> results1, results2;
+  #pragma omp parallel sections
   {
-    forwardRNN.Forward(std::move(arma::mat(
-        predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true)));
-    backwardRNN.Forward(std::move(arma::mat(
-        predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true)));
-
-    for (size_t l = 0; l < networkSize; ++l)
+    #pragma omp section
+    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    {
+      forwardRNN.Forward(std::move(MatType(
+          predictors.slice(seqNum).colptr(begin),
+          predictors.n_rows, batchSize, false, true)));
+      for (size_t l = 0; l < networkSize; ++l)
+      {
+        boost::apply_visitor(SaveOutputParameterVisitor<MatType>(
+            std::move(forwardRNNOutputParameter)), forwardRNN.network[l]);
+      }
+      boost::apply_visitor(SaveOutputParameterVisitor<MatType>(
+          std::move(results1)), forwardRNN.network.back());
+    }
+
+    #pragma omp section
+    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
     {
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          std::move(forwardRNNOutputParameter)), forwardRNN.network[l]);
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          std::move(backwardRNNOutputParameter)), backwardRNN.network[l]);
+      backwardRNN.Forward(std::move(MatType(
+          predictors.slice(rho - seqNum - 1).colptr(begin),
+          predictors.n_rows, batchSize, false, true)));
+      for (size_t l = 0; l < networkSize; ++l)
+      {
+        boost::apply_visitor(SaveOutputParameterVisitor<MatType>(
+            std::move(backwardRNNOutputParameter)), backwardRNN.network[l]);
+      }
+      boost::apply_visitor(SaveOutputParameterVisitor<MatType>(
+          std::move(results2)), backwardRNN.network.back());
     }
-    boost::apply_visitor(SaveOutputParameterVisitor(
-        std::move(results1)), forwardRNN.network.back());
-    boost::apply_visitor(SaveOutputParameterVisitor(
-        std::move(results2)), backwardRNN.network.back());
   }
   if (outputSize == 0)
   {
@@ -385,19 +415,19 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     forwardRNN.outputSize = backwardRNN.outputSize = outputSize;
   }
 
-  arma::cube results;
+  CubeType results;
   if (std::is_same<MergeLayerType, Concat<>>::value)
   {
-    results = arma::zeros<arma::cube>(outputSize * 2, batchSize, rho);
+    results = arma::zeros<CubeType>(outputSize * 2, batchSize, rho);
   }
   else
   {
-    results = arma::zeros<arma::cube>(outputSize, batchSize, rho);
+    results = arma::zeros<CubeType>(outputSize, batchSize, rho);
   }
 
   double performance = 0;
   size_t responseSeq = 0;
-  arma::mat input;
+  MatType input;
 
   reverse(results1.begin(), results1.end());
   // Performance calculation here.
@@ -407,24 +437,24 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     {
       responseSeq = seqNum;
     }
-    boost::apply_visitor(LoadOutputParameterVisitor(
+    boost::apply_visitor(LoadOutputParameterVisitor<MatType>(
           std::move(results1)), forwardRNN.network.back());
-    boost::apply_visitor(LoadOutputParameterVisitor(
+    boost::apply_visitor(LoadOutputParameterVisitor<MatType>(
           std::move(results2)), backwardRNN.network.back());
-    boost::apply_visitor(ForwardVisitor(std::move(input),
+    boost::apply_visitor(ForwardVisitor<MatType>(std::move(input),
         std::move(boost::apply_visitor(outputParameterVisitor, mergeLayer))),
         mergeLayer);
-    boost::apply_visitor(ForwardVisitor(
+    boost::apply_visitor(ForwardVisitor<MatType>(
         std::move(boost::apply_visitor(outputParameterVisitor, mergeLayer)),
         std::move(results.slice(seqNum))), mergeOutput);
     performance += outputLayer.Forward(std::move(results.slice(seqNum)),
-        std::move(arma::mat(responses.slice(responseSeq).colptr(begin),
+        std::move(MatType(responses.slice(responseSeq).colptr(begin),
         responses.n_rows, batchSize, false, true)));
   }
 
   // Calculate and storing delta parameters from output for t = 1 to T.
-  arma::mat delta;
-  std::vector<arma::mat> allDelta;
+  MatType delta;
+  std::vector<MatType> allDelta;
 
   for (size_t seqNum = 0; seqNum < rho; ++seqNum)
   {
@@ -435,101 +465,118 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     else if (single && seqNum == 0)
     {
       outputLayer.Backward(std::move(results.slice(seqNum)),
-          std::move(arma::mat(responses.slice(0).colptr(begin),
+          std::move(MatType(responses.slice(0).colptr(begin),
           responses.n_rows, batchSize, false, true)), std::move(error));
     }
     else
     {
       outputLayer.Backward(std::move(results.slice(seqNum)),
-          std::move(arma::mat(responses.slice(seqNum).colptr(begin),
+          std::move(MatType(responses.slice(seqNum).colptr(begin),
           responses.n_rows, batchSize, false, true)), std::move(error));
     }
 
-    boost::apply_visitor(BackwardVisitor(std::move(results.slice(seqNum)),
-        std::move(error), std::move(delta)), mergeOutput);
-    allDelta.push_back(arma::mat(delta));
+    boost::apply_visitor(BackwardVisitor<MatType>(std::move(
+        results.slice(seqNum)), std::move(error), std::move(delta)),
+        mergeOutput);
+    allDelta.push_back(MatType(delta));
   }
 
-  // BPTT ForwardRNN from t = T to 1.
-  totalGradient = arma::mat(gradient.memptr(),
-      parameter.n_elem/2, 1, false, false);
-
   forwardGradient.zeros();
   forwardRNN.ResetGradients(forwardGradient);
   backwardGradient.zeros();
   backwardRNN.ResetGradients(backwardGradient);
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  // The two BPTT passes write disjoint halves of the gradient and only share
+  // the (read-only) output deltas, so they run as parallel sections, each with
+  // its own delta buffer.
+  #pragma omp parallel sections
   {
-    forwardGradient.zeros();
-    for (size_t l = 0; l < networkSize; ++l)
+    #pragma omp section
     {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          std::move(forwardRNNOutputParameter)),
-          forwardRNN.network[networkSize - 1 - l]);
+      // BPTT ForwardRNN from t = T to 1.
+      MatType totalGradient(gradient.memptr(), parameter.n_elem / 2, 1, false,
+          false);
+      MatType forwardDelta;
+
+      for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+      {
+        forwardGradient.zeros();
+        for (size_t l = 0; l < networkSize; ++l)
+        {
+          boost::apply_visitor(LoadOutputParameterVisitor<MatType>(
+              std::move(forwardRNNOutputParameter)),
+              forwardRNN.network[networkSize - 1 - l]);
+        }
+        boost::apply_visitor(BackwardVisitor<MatType>(std::move(
+            boost::apply_visitor(outputParameterVisitor,
+            forwardRNN.network.back())), std::move(allDelta[rho - seqNum - 1]),
+            std::move(forwardDelta), 0), mergeLayer);
+
+        for (size_t i = 2; i < networkSize; ++i)
+        {
+          boost::apply_visitor(BackwardVisitor<MatType>(
+              std::move(boost::apply_visitor(outputParameterVisitor,
+              forwardRNN.network[networkSize - i])),
+              std::move(boost::apply_visitor(deltaVisitor,
+              forwardRNN.network[networkSize - i + 1])), std::move(
+              boost::apply_visitor(deltaVisitor,
+              forwardRNN.network[networkSize - i]))),
+              forwardRNN.network[networkSize - i]);
+        }
+        forwardRNN.Gradient(std::move(
+            MatType(predictors.slice(rho - seqNum - 1).colptr(begin),
+            predictors.n_rows, batchSize, false, true)));
+        boost::apply_visitor(GradientVisitor<MatType>(
+            std::move(boost::apply_visitor(outputParameterVisitor,
+            forwardRNN.network[networkSize - 2])),
+            std::move(allDelta[rho - seqNum - 1]), 0), mergeLayer);
+        totalGradient += forwardGradient;
+      }
     }
-    boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, forwardRNN.network.back())),
-        std::move(allDelta[rho - seqNum - 1]), std::move(delta), 0),
-        mergeLayer);
 
-    for (size_t i = 2; i < networkSize; ++i)
+    #pragma omp section
     {
-      boost::apply_visitor(BackwardVisitor(
-          std::move(boost::apply_visitor(outputParameterVisitor,
-          forwardRNN.network[networkSize - i])),
-          std::move(boost::apply_visitor(deltaVisitor,
-          forwardRNN.network[networkSize - i + 1])), std::move(
-          boost::apply_visitor(deltaVisitor,
-          forwardRNN.network[networkSize - i]))),
-          forwardRNN.network[networkSize - i]);
+      // BPTT BackwardRNN from t = 1 to T.
+      MatType totalGradient(gradient.memptr() + parameter.n_elem / 2,
+          parameter.n_elem / 2, 1, false, false);
+      MatType backwardDelta;
+
+      for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+      {
+        backwardGradient.zeros();
+        for (size_t l = 0; l < networkSize; ++l)
+        {
+          boost::apply_visitor(LoadOutputParameterVisitor<MatType>(
+              std::move(backwardRNNOutputParameter)),
+              backwardRNN.network[networkSize - 1 - l]);
+        }
+        boost::apply_visitor(BackwardVisitor<MatType>(std::move(
+            boost::apply_visitor(outputParameterVisitor,
+            backwardRNN.network.back())),
+            std::move(allDelta[seqNum]), std::move(backwardDelta), 1),
+            mergeLayer);
+        for (size_t i = 2; i < networkSize; ++i)
+        {
+          boost::apply_visitor(BackwardVisitor<MatType>(
+            std::move(boost::apply_visitor(outputParameterVisitor,
+            backwardRNN.network[networkSize - i])), std::move(
+            boost::apply_visitor(deltaVisitor,
+            backwardRNN.network[networkSize - i + 1])), std::move(
+            boost::apply_visitor(deltaVisitor,
+            backwardRNN.network[networkSize - i]))),
+            backwardRNN.network[networkSize - i]);
+        }
+
+        backwardRNN.Gradient(std::move(
+            MatType(predictors.slice(seqNum).colptr(begin),
+            predictors.n_rows, batchSize, false, true)));
+        boost::apply_visitor(GradientVisitor<MatType>(
+            std::move(boost::apply_visitor(outputParameterVisitor,
+            backwardRNN.network[networkSize - 2])),
+            std::move(allDelta[seqNum]), 1), mergeLayer);
+        totalGradient += backwardGradient;
+      }
     }
-    forwardRNN.Gradient(std::move(
-        arma::mat(predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true)));
-    boost::apply_visitor(GradientVisitor(
-        std::move(boost::apply_visitor(outputParameterVisitor,
-        forwardRNN.network[networkSize - 2])),
-        std::move(allDelta[rho - seqNum - 1]), 0), mergeLayer);
-    totalGradient += forwardGradient;
-  }
-
-  // BPTT BackwardRNN from t = 1 to T.
-  totalGradient = arma::mat(gradient.memptr() + parameter.n_elem/2,
-      parameter.n_elem/2, 1, false, false);
-
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-  {
-    backwardGradient.zeros();
-    for (size_t l = 0; l < networkSize; ++l)
-    {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          std::move(backwardRNNOutputParameter)),
-          backwardRNN.network[networkSize - 1 - l]);
-    }
-    boost::apply_visitor(BackwardVisitor(std::move(
-        boost::apply_visitor(outputParameterVisitor,
-        backwardRNN.network.back())),
-        std::move(allDelta[seqNum]), std::move(delta), 1), mergeLayer);
-    for (size_t i = 2; i < networkSize; ++i)
-    {
-      boost::apply_visitor(BackwardVisitor(
-        std::move(boost::apply_visitor(outputParameterVisitor,
-        backwardRNN.network[networkSize - i])), std::move(boost::apply_visitor(
-        deltaVisitor, backwardRNN.network[networkSize - i + 1])), std::move(
-        boost::apply_visitor(deltaVisitor,
-        backwardRNN.network[networkSize - i]))),
-        backwardRNN.network[networkSize - i]);
-    }
-
-    backwardRNN.Gradient(std::move(
-        arma::mat(predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true)));
-    boost::apply_visitor(GradientVisitor(
-        std::move(boost::apply_visitor(outputParameterVisitor,
-        backwardRNN.network[networkSize - 2])),
-        std::move(allDelta[seqNum]), 1), mergeLayer);
-    totalGradient += backwardGradient;
   }
   return performance;
 }
@@ -539,9 +586,9 @@ template<typename OutputLayerType, typename MergeLayerType,
          typename... CustomLayers>
 void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     InitializationRuleType, CustomLayers...>::Gradient(
-    const arma::mat& parameters,
+    const MatType& parameters,
     const size_t begin,
-    arma::mat& gradient,
+    MatType& gradient,
     const size_t batchSize)
 {
   this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
@@ -553,7 +600,7 @@ template<typename OutputLayerType, typename MergeLayerType,
 void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  arma::cube newPredictors, newResponses;
+  CubeType newPredictors, newResponses;
   math::ShuffleData(predictors, responses, newPredictors, newResponses);
 
   predictors = std::move(newPredictors);
@@ -576,7 +623,7 @@ template<typename OutputLayerType, typename MergeLayerType,
          typename... CustomLayers>
 void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
     InitializationRuleType, CustomLayers...>::
-Add(LayerTypes<CustomLayers...> layer)
+Add(TypedLayerTypes<MatType, CustomLayers...> layer)
 {
   forwardRNN.network.push_back(layer);
   backwardRNN.network.push_back(boost::apply_visitor(copyVisitor, layer));
@@ -590,9 +637,9 @@ void BRNN<OutputLayerType, MergeLayerType, MergeOutputType,
 {
   if (!reset)
   {
-    boost::apply_visitor(AddVisitor<CustomLayers...>(
+    boost::apply_visitor(AddVisitor<MatType, CustomLayers...>(
         forwardRNN.network.back()), mergeLayer);
-    boost::apply_visitor(AddVisitor<CustomLayers...>(
+    boost::apply_visitor(AddVisitor<MatType, CustomLayers...>(
         backwardRNN.network.back()), mergeLayer);
     boost::apply_visitor(RunSetVisitor(false), mergeLayer);
   }
@@ -0,0 +1,402 @@
+/**
+ * @file im2col_convolution.hpp
+ *
+ * Implementation of the convolution through lowering to a matrix product
+ * (im2col).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Computes the two-dimensional convolution by lowering the input to a matrix
+ * whose rows are the receptive fields of the output positions (im2col), so that
+ * the convolution becomes a matrix product.  This class can be used like
+ * NaiveConvolution, with the valid border type or the full border type
+ * (default).
+ *
+ * The main use of this class is in the Convolution and AtrousConvolution
+ * layers.  When their forward rule is Im2ColConvolution<ValidConvolution>,
+ * their backward rule is Im2ColConvolution<FullConvolution>, or their gradient
+ * rule is Im2ColConvolution<ValidConvolution>, the corresponding pass lowers
+ * all of the input maps of an image with Im2Col() at once, and then computes
+ * all of the output maps (or the error of all of the input maps, or the
+ * gradient of all of the filters) with a single matrix multiplication:
+ *
+ * @code
+ * Convolution<Im2ColConvolution<ValidConvolution>,
+ *             Im2ColConvolution<FullConvolution>,
+ *             Im2ColConvolution<ValidConvolution>> layer(3, 16, 5, 5);
+ * @endcode
+ *
+ * This uses O(kW * kH * inSize * outputWidth * outputHeight) extra memory for
+ * each image, and the matrix product is done by BLAS.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /*
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    const size_t outputWidth = (input.n_rows - (filter.n_rows - 1) *
+        dilationW - 1) / dW + 1;
+    const size_t outputHeight = (input.n_cols - (filter.n_cols - 1) *
+        dilationH - 1) / dH + 1;
+
+    // Use the input as a cube with one slice, without copying it.
+    const arma::Cube<eT> inputCube(const_cast<eT*>(input.memptr()),
+        input.n_rows, input.n_cols, 1, false, true);
+
+    arma::Mat<eT> columns;
+    Im2Col(inputCube, 0, 1, filter.n_rows, filter.n_cols, dW, dH, 0, 0,
+        dilationW, dilationH, outputWidth, outputHeight, columns);
+
+    // The output may be a slice of a cube, so write it in place.
+    output.set_size(outputWidth, outputHeight);
+    arma::Col<eT> outputVector(output.memptr(), output.n_elem, false, true);
+    outputVector = columns * arma::vectorise(filter);
+  }
+
+  /*
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT, typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const arma::Mat<eT>& input,
+              const arma::Mat<eT>& filter,
+              arma::Mat<eT>& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1)
+  {
+    // Use the same working shape as NaiveConvolution.
+    size_t outputRows = (input.n_rows - 1) * dW + 2 * (filter.n_rows - 1)
+        * dilationW + 1;
+    size_t outputCols = (input.n_cols - 1) * dH + 2 * (filter.n_cols - 1)
+        * dilationH + 1;
+
+    for (size_t i = 0; i < dW; i++)
+    {
+      if (((((i + outputRows - 2 * (filter.n_rows - 1) * dilationW - 1) % dW)
+          + dW) % dW) == i)
+      {
+        outputRows += i;
+        break;
+      }
+    }
+    for (size_t i = 0; i < dH; i++)
+    {
+      if (((((i + outputCols - 2 * (filter.n_cols - 1) * dilationH - 1) % dH)
+          + dH) % dH) == i)
+      {
+        outputCols += i;
+        break;
+      }
+    }
+
+    // Pad the input to the working output shape.
+    arma::Mat<eT> inputPadded = arma::zeros<arma::Mat<eT> >(outputRows,
+        outputCols);
+    inputPadded.submat((filter.n_rows - 1) * dilationW, (filter.n_cols - 1)
+        * dilationH, (filter.n_rows - 1) * dilationW + input.n_rows - 1,
+        (filter.n_cols - 1) * dilationH + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, 1, 1, dilationW, dilationH);
+  }
+
+  /*
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Mat<eT>& input,
+                          const arma::Cube<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        filter.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /*
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   */
+  template<typename eT>
+  static void Convolution(const arma::Cube<eT>& input,
+                          const arma::Mat<eT>& filter,
+                          arma::Cube<eT>& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1)
+  {
+    arma::Mat<eT> convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH);
+
+    output = arma::Cube<eT>(convOutput.n_rows, convOutput.n_cols,
+        input.n_slices);
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; i++)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH);
+    }
+  }
+
+  /**
+   * Lower the given slices of the input into a matrix with one row for each
+   * output position, and one column for each filter element of each slice:
+   * element (i + j * outputWidth, ki + kW * (kj + kH * s)) is the element
+   * (i * dW + ki * dilationW - padW, j * dH + kj * dilationH - padH) of slice
+   * firstSlice + s of the input, or 0 if that is in the padding.  Filters of
+   * kW x kH x numSlices elements, stored in column-major order, can then be
+   * applied to every output position with a matrix product.
+   *
+   * @param input Input maps.
+   * @param firstSlice First slice of the input to lower.
+   * @param numSlices Number of slices of the input to lower.
+   * @param kW Width of the filter.
+   * @param kH Height of the filter.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param padW Zero padding on each side of the input in the x direction.
+   * @param padH Zero padding on each side of the input in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param outputWidth Width of the output maps.
+   * @param outputHeight Height of the output maps.
+   * @param columns Matrix to store the lowered input in.
+   */
+  template<typename eT>
+  static void Im2Col(const arma::Cube<eT>& input,
+                     const size_t firstSlice,
+                     const size_t numSlices,
+                     const size_t kW,
+                     const size_t kH,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t padW,
+                     const size_t padH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     const size_t outputWidth,
+                     const size_t outputHeight,
+                     arma::Mat<eT>& columns)
+  {
+    columns.set_size(outputWidth * outputHeight, kW * kH * numSlices);
+
+    for (size_t s = 0; s < numSlices; ++s)
+    {
+      for (size_t kj = 0; kj < kH; ++kj)
+      {
+        for (size_t ki = 0; ki < kW; ++ki)
+        {
+          eT* columnPtr = columns.colptr(ki + kW * (kj + kH * s));
+          for (size_t j = 0; j < outputHeight; ++j)
+          {
+            const size_t col = j * dH + kj * dilationH;
+            if (col < padH || col - padH >= input.n_cols)
+            {
+              std::fill(columnPtr, columnPtr + outputWidth, eT(0));
+              columnPtr += outputWidth;
+              continue;
+            }
+
+            const eT* inputPtr = input.slice_colptr(firstSlice + s,
+                col - padH);
+            for (size_t i = 0; i < outputWidth; ++i, ++columnPtr)
+            {
+              const size_t row = i * dW + ki * dilationW;
+              *columnPtr = (row < padW || row - padW >= input.n_rows) ? eT(0) :
+                  inputPtr[row - padW];
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Add each element of the given lowered matrix to the element of the input
+   * maps it was taken from by Im2Col(); elements taken from the padding are
+   * ignored.  This is the transpose of Im2Col(), and it is used to pass the
+   * error of a lowered convolution back to its input.  The parameters have the
+   * same meaning as for Im2Col().
+   *
+   * @param columns Lowered matrix.
+   * @param firstSlice First slice of the output to add to.
+   * @param numSlices Number of slices of the output to add to.
+   * @param kW Width of the filter.
+   * @param kH Height of the filter.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param padW Zero padding on each side of the input in the x direction.
+   * @param padH Zero padding on each side of the input in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param outputWidth Width of the output maps of the convolution.
+   * @param outputHeight Height of the output maps of the convolution.
+   * @param output Maps to add the lowered matrix to.
+   */
+  template<typename eT>
+  static void Col2Im(const arma::Mat<eT>& columns,
+                     const size_t firstSlice,
+                     const size_t numSlices,
+                     const size_t kW,
+                     const size_t kH,
+                     const size_t dW,
+                     const size_t dH,
+                     const size_t padW,
+                     const size_t padH,
+                     const size_t dilationW,
+                     const size_t dilationH,
+                     const size_t outputWidth,
+                     const size_t outputHeight,
+                     arma::Cube<eT>& output)
+  {
+    for (size_t s = 0; s < numSlices; ++s)
+    {
+      for (size_t kj = 0; kj < kH; ++kj)
+      {
+        for (size_t ki = 0; ki < kW; ++ki)
+        {
+          const eT* columnPtr = columns.colptr(ki + kW * (kj + kH * s));
+          for (size_t j = 0; j < outputHeight; ++j)
+          {
+            const size_t col = j * dH + kj * dilationH;
+            if (col < padH || col - padH >= output.n_cols)
+            {
+              columnPtr += outputWidth;
+              continue;
+            }
+
+            eT* outputPtr = output.slice_colptr(firstSlice + s, col - padH);
+            for (size_t i = 0; i < outputWidth; ++i, ++columnPtr)
+            {
+              const size_t row = i * dW + ki * dilationW;
+              if (row >= padW && row - padW < output.n_rows)
+                outputPtr[row - padW] += *columnPtr;
+            }
+          }
+        }
+      }
+    }
+  }
+};  // class Im2ColConvolution
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -26,10 +26,13 @@
 #include "visitor/loss_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "network_profile.hpp"
+#include "training_checkpoint.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/init_rules/random_init.hpp>
+#include <mlpack/methods/ann/loss_functions/softmax_cross_entropy_error.hpp>
 #include <ensmallen.hpp>
 
 namespace mlpack {
@@ -38,6 +41,27 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard feed forward network.
  *
+ * The matrix type of the network (the type of the data, the parameters and the
+ * gradients) is the output parameter type of the output layer, so that for
+ * instance a single-precision network can be trained with
+ *
+ * @code
+ * FFN<NegativeLogLikelihood<arma::fmat, arma::fmat> > model;
+ * model.Add<Linear<arma::fmat, arma::fmat> >(10, 3);
+ * model.Add<LogSoftMax<arma::fmat, arma::fmat> >();
+ * @endcode
+ *
+ * All the layers of the network must then use the same matrix type.
+ *
+ * For classification, the LogSoftMax layer and the NegativeLogLikelihood
+ * output layer can be replaced by the fused SoftmaxCrossEntropyError output
+ * layer, which computes the loss and its gradient directly from the scores:
+ *
+ * @code
+ * FFN<SoftmaxCrossEntropyError<> > model;
+ * model.Add<Linear<> >(10, 3);
+ * @endcode
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  * @tparam CustomLayers Any set of custom layers that could be a part of the
@@ -54,6 +78,10 @@ class FFN
   //! Convenience typedef for the internal model construction.
   using NetworkType = FFN<OutputLayerType, InitializationRuleType>;
 
+  //! The matrix type of the network, given by the output layer.
+  typedef typename std::remove_reference<decltype(
+      std::declval<OutputLayerType&>().OutputParameter())>::type MatType;
+
   /**
    * Create the FFN object.
    *
@@ -100,8 +128,8 @@ class FFN
    * @return The final objective of the trained model (NaN or Inf on error).
    */
   template<typename OptimizerType>
-  double Train(arma::mat predictors,
-               arma::mat responses,
+  double Train(MatType predictors,
+               MatType responses,
                OptimizerType& optimizer);
 
   /**
@@ -122,20 +150,69 @@ class FFN
    * @return The final objective of the trained model (NaN or Inf on error).
    */
   template<typename OptimizerType = ens::RMSProp>
-  double Train(arma::mat predictors, arma::mat responses);
+  double Train(MatType predictors, MatType responses);
+
+  /**
+   * Train the feedforward network on a dataset that doesn't fit in memory,
+   * which is read chunk by chunk from the given data source (for instance a
+   * FileDataSource).  In each epoch the chunks are visited in a new random
+   * order, and the optimizer is run on each chunk in turn, starting from the
+   * current parameters.  While the network is trained on a chunk, the next
+   * chunk is loaded by a background thread, so that the loading overlaps with
+   * the computation, and at most two chunks are held in memory (plus the
+   * shuffled copy of the current chunk that the optimizer may make).
+   *
+   * Since the optimizer is run once per chunk, it should be set up for one
+   * pass over a chunk: a maximum number of iterations equal to the number of
+   * points of a chunk for the ensmallen SGD-type optimizers, and no reset of
+   * the state of the optimizer between runs (such as resetPolicy = false) for
+   * the adaptive ones.
+   *
+   * The data source must provide
+   *
+   * @code
+   * size_t NumChunks() const;
+   * void Load(const size_t chunk, MatType& predictors, MatType& responses);
+   * @endcode
+   *
+   * Load() is called from the background thread, for one chunk at a time;
+   * the exceptions it throws are rethrown by TrainFromSource().
+   *
+   * @tparam DataSourceType Type of the data source.
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param source The data source the chunks are loaded from.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param epochs Number of passes over all the chunks.
+   * @return The objective of the trained model on the last chunk.
+   */
+  template<typename DataSourceType, typename OptimizerType>
+  double TrainFromSource(DataSourceType& source,
+                         OptimizerType& optimizer,
+                         const size_t epochs);
 
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
    * output layer function.
    *
-   * If you want to pass in a parameter and discard the original parameter
-   * object, be sure to use std::move to avoid unnecessary copy.
+   * The predictors are not copied; they are passed through the network in
+   * batches of batchSize points, and only the forward pass is performed.  The
+   * output of a layer is only needed until the next layer has been evaluated,
+   * so once the sizes of the outputs are known for the batch size, the layers
+   * write their outputs alternately to the two halves of one buffer that is
+   * kept between calls, and the last layer writes its output directly to
+   * results.  So the memory used for the outputs is that of the two largest
+   * outputs of a batch, whatever the number of layers.  Larger batches make
+   * better use of BLAS, but need a larger buffer.
    *
    * @param predictors Input predictors.
    * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points passed through the network at once; 0
+   *      passes all of the points at once.
    */
-  void Predict(arma::mat predictors, arma::mat& results);
+  void Predict(const MatType& predictors,
+               MatType& results,
+               const size_t batchSize = 128);
 
   /**
    * Evaluate the feedforward network with the given predictors and responses.
@@ -144,7 +221,7 @@ class FFN
    * @param predictors Input variables.
    * @param responses Target outputs for input variables.
    */
-  double Evaluate(arma::mat predictors, arma::mat responses);
+  double Evaluate(MatType predictors, MatType responses);
 
   /**
    * Evaluate the feedforward network with the given parameters. This function
@@ -154,7 +231,7 @@ class FFN
    * @param deterministic Whether or not to train or test the model. Note some
    *        layer act differently in training or testing mode.
    */
-  double Evaluate(const arma::mat& parameters);
+  double Evaluate(const MatType& parameters);
 
    /**
    * Evaluate the feedforward network with the given parameters, but using only
@@ -169,7 +246,7 @@ class FFN
    * @param deterministic Whether or not to train or test the model. Note some
    *        layer act differently in training or testing mode.
    */
-  double Evaluate(const arma::mat& parameters,
+  double Evaluate(const MatType& parameters,
                   const size_t begin,
                   const size_t batchSize,
                   const bool deterministic);
@@ -186,7 +263,7 @@ class FFN
    * @param batchSize Number of points to be passed at a time to use for
    *        objective function evaluation.
    */
-  double Evaluate(const arma::mat& parameters,
+  double Evaluate(const MatType& parameters,
                   const size_t begin,
                   const size_t batchSize);
 
@@ -199,7 +276,7 @@ class FFN
    * @param gradient Matrix to output gradient into.
    */
   template<typename GradType>
-  double EvaluateWithGradient(const arma::mat& parameters, GradType& gradient);
+  double EvaluateWithGradient(const MatType& parameters, GradType& gradient);
 
    /**
    * Evaluate the feedforward network with the given parameters, but using only
@@ -214,7 +291,7 @@ class FFN
    *        objective function evaluation.
    */
   template<typename GradType>
-  double EvaluateWithGradient(const arma::mat& parameters,
+  double EvaluateWithGradient(const MatType& parameters,
                               const size_t begin,
                               GradType& gradient,
                               const size_t batchSize);
@@ -231,9 +308,9 @@ class FFN
    * @param batchSize Number of points to be processed as a batch for objective
    *        function gradient evaluation.
    */
-  void Gradient(const arma::mat& parameters,
+  void Gradient(const MatType& parameters,
                 const size_t begin,
-                arma::mat& gradient,
+                MatType& gradient,
                 const size_t batchSize);
 
   /**
@@ -255,31 +332,121 @@ class FFN
    *
    * @param layer The Layer to be added to the model.
    */
-  void Add(LayerTypes<CustomLayers...> layer) { network.push_back(layer); }
+  void Add(TypedLayerTypes<MatType, CustomLayers...> layer)
+  {
+    network.push_back(layer);
+  }
+
+  //! Get the layers of the network.
+  const std::vector<TypedLayerTypes<MatType, CustomLayers...> >& Model() const
+  {
+    return network;
+  }
 
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
   //! Return the initial point for the optimization.
-  const arma::mat& Parameters() const { return parameter; }
+  const MatType& Parameters() const { return parameter; }
   //! Modify the initial point for the optimization.
-  arma::mat& Parameters() { return parameter; }
+  MatType& Parameters() { return parameter; }
 
   //! Get the matrix of responses to the input data points.
-  const arma::mat& Responses() const { return responses; }
+  const MatType& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
-  arma::mat& Responses() { return responses; }
+  MatType& Responses() { return responses; }
 
   //! Get the matrix of data points (predictors).
-  const arma::mat& Predictors() const { return predictors; }
+  const MatType& Predictors() const { return predictors; }
   //! Modify the matrix of data points (predictors).
-  arma::mat& Predictors() { return predictors; }
+  MatType& Predictors() { return predictors; }
+
+  /**
+   * Get the number of workers that EvaluateWithGradient() splits each
+   * mini-batch across.  Each worker runs the forward and backward passes of its
+   * part of the batch on its own replica of the layers, which uses the
+   * parameters of this network, and the gradients of the workers are summed.
+   * The output layer is always evaluated on the whole batch, so the objective
+   * and the gradient are those of a single worker, up to rounding; but layers
+   * that use statistics of the whole batch (such as BatchNorm) or that keep
+   * state across batches (such as the recurrent layers) only see the points
+   * of their worker.  0 means one worker per thread (see NumThreads()).
+   */
+  size_t Workers() const { return workers; }
+  //! Modify the number of workers that EvaluateWithGradient() uses.
+  size_t& Workers() { return workers; }
+
+  /**
+   * Get whether EvaluateWithGradient() computes row-sparse gradients.  Then
+   * only the parts of the gradient given by GradientRanges() are written: the
+   * whole gradient of the layers with dense gradients, and only the looked up
+   * entries of the Lookup layers, so that the cost of a batch doesn't depend
+   * on the size of the embedding tables.  The rest of the gradient is zero as
+   * long as the same gradient matrix is passed to every call and is not
+   * modified in between, as the ensmallen optimizers do.  The SparseUpdate and
+   * SparseAdaGradUpdate policies of ens::SGD only update the parameters in
+   * GradientRanges().  A single worker is used in this mode.
+   */
+  bool SparseGradient() const { return sparseGradient; }
+  //! Modify whether EvaluateWithGradient() computes row-sparse gradients.
+  bool& SparseGradient() { return sparseGradient; }
+
+  /**
+   * Get the ranges of the parameters whose gradient was written by the last
+   * call to EvaluateWithGradient() with SparseGradient() set, as one column
+   * per range with the index of its first parameter and its length.
+   */
+  const arma::Mat<size_t>& GradientRanges() const { return gradientRanges; }
+
+  /**
+   * Get the profile of the layers of the network.  Enable it to record the
+   * time spent in the forward, backward and gradient pass of each layer.
+   */
+  const NetworkProfile& Profile() const { return profile; }
+  //! Modify the profile of the layers of the network.
+  NetworkProfile& Profile() { return profile; }
+
+  /**
+   * Get the checkpoint of the training.  Set its path and its interval to
+   * write the parameters to disk periodically while the network is trained.
+   */
+  const TrainingCheckpoint& Checkpoint() const { return checkpoint; }
+  //! Modify the checkpoint of the training.
+  TrainingCheckpoint& Checkpoint() { return checkpoint; }
 
   /**
    * Reset the module infomration (weights/parameters).
    */
   void ResetParameters();
 
+  /**
+   * Fold every BatchNorm layer that directly follows a Linear layer into the
+   * weights and the bias of the Linear layer, and remove it from the network.
+   * The scale and the shift use the statistics of the training data, so the
+   * predictions of the network don't change, but each folded block saves a
+   * pass over its output.  Since the batch statistics are not used anymore,
+   * this is meant for a trained network that is used for prediction.  The
+   * parameters of the network are rebuilt without the folded layers.
+   *
+   * @return The number of BatchNorm layers that were folded.
+   */
+  size_t FoldBatchNorm();
+
+  /**
+   * Quantize the network for prediction: replace every Linear and LinearNoBias
+   * layer with a QuantizedLinear layer, whose weights are 8-bit integers with
+   * one scale per output unit.  The scale of the input of each layer is
+   * calibrated on the given sample of points, which should cover the range of
+   * the data the network will see.  The quantized layers have no trainable
+   * parameters, so the parameters of the network are rebuilt without them.
+   * QuantizationAgreement() can be used to compare the predictions of the
+   * quantized network with those of a copy of the original network.
+   *
+   * @param calibration Sample of points used to calibrate the inputs.
+   * @return The number of layers that were quantized.
+   */
+  size_t Quantize(const MatType& calibration);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
@@ -294,7 +461,7 @@ class FFN
    * @param inputs The input data.
    * @param results The predicted results.
    */
-  void Forward(arma::mat inputs, arma::mat& results);
+  void Forward(MatType inputs, MatType& results);
 
   /**
    * Perform a partial forward pass of the data.
@@ -307,8 +474,8 @@ class FFN
    * @param begin The index of the first layer.
    * @param end The index of the last layer.
    */
-  void Forward(arma::mat inputs,
-               arma::mat& results,
+  void Forward(MatType inputs,
+               MatType& results,
                const size_t begin,
                const size_t end);
 
@@ -323,7 +490,7 @@ class FFN
    * @param gradients Computed gradients.
    * @return Training error of the current pass.
    */
-  double Backward(arma::mat targets, arma::mat& gradients);
+  double Backward(MatType targets, MatType& gradients);
 
  private:
   // Helper functions.
@@ -333,7 +500,7 @@ class FFN
    *
    * @param input Data sequence to compute probabilities for.
    */
-  void Forward(arma::mat&& input);
+  void Forward(MatType&& input);
 
   /**
    * Prepare the network for the given data.
@@ -342,7 +509,7 @@ class FFN
    * @param predictors Input data variables.
    * @param responses Outputs results from input data variables.
    */
-  void ResetData(arma::mat predictors, arma::mat responses);
+  void ResetData(MatType predictors, MatType responses);
 
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
@@ -354,7 +521,7 @@ class FFN
    * Iterate through all layer modules and update the the gradient using the
    * layer defined optimizer.
    */
-  void Gradient(arma::mat&& input);
+  void Gradient(MatType&& input);
 
   /**
    * Reset the module status by setting the current deterministic parameter
@@ -365,7 +532,71 @@ class FFN
   /**
    * Reset the gradient for all modules that implement the Gradient function.
    */
-  void ResetGradients(arma::mat& gradient);
+  void ResetGradients(MatType& gradient);
+
+  /**
+   * Set the gradient ranges to the parts of the gradient that the layers
+   * wrote in the last gradient pass.
+   */
+  void ResetGradientRanges();
+
+  /**
+   * Replace the layers of the network with the given layers, and rebuild the
+   * parameters from the parameters of the layers that are kept.
+   *
+   * @param layers The new layers; the layers that are not kept must have been
+   *     deleted.
+   * @param offsets The offset of the parameters of each new layer in the
+   *     current parameters, for the layers that have parameters.
+   */
+  void ReplaceLayers(std::vector<TypedLayerTypes<MatType, CustomLayers...> >&
+                         layers,
+                     const std::vector<size_t>& offsets);
+
+  /**
+   * Evaluate the objective and the gradient of the given mini-batch by
+   * splitting it into the given number of parts, which are processed in
+   * parallel by this network and its replicas.
+   */
+  double ParallelEvaluateWithGradient(const size_t begin,
+                                      MatType& gradient,
+                                      const size_t batchSize,
+                                      const size_t numWorkers);
+
+  /**
+   * Make sure that there are at least the given number of replicas of the
+   * network, whose layers use the parameters of this network.
+   */
+  void ResetReplicas(const size_t numReplicas);
+
+  //! Delete the replicas of the network.
+  void DeleteReplicas();
+
+  /**
+   * Make the outputs of the layers use the memory planned for Predict(), if
+   * the plan is for inputs of the given size.  The output of the last layer
+   * uses the given columns of results.
+   *
+   * @param inputRows Number of rows of the input of the network.
+   * @param points Number of points in the batch.
+   * @param results Matrix that holds the predictions.
+   * @param begin Index of the first point of the batch.
+   * @return Whether the planned memory is used.
+   */
+  bool SharePredictionBuffers(const size_t inputRows,
+                              const size_t points,
+                              MatType& results,
+                              const size_t begin);
+
+  /**
+   * Record the sizes of the outputs of the layers after a forward pass of the
+   * given batch, and make sure that the buffer used by Predict() can hold
+   * them.
+   */
+  void PlanPredictionBuffers(const size_t inputRows, const size_t points);
+
+  //! Make the outputs of the layers use their own memory again.
+  void ReleasePredictionBuffers();
 
   /**
    * Swap the content of this network with given network.
@@ -391,31 +622,31 @@ class FFN
   bool reset;
 
   //! Locally-stored model modules.
-  std::vector<LayerTypes<CustomLayers...> > network;
+  std::vector<TypedLayerTypes<MatType, CustomLayers...> > network;
 
   //! The matrix of data points (predictors).
-  arma::mat predictors;
+  MatType predictors;
 
   //! The matrix of responses to the input data points.
-  arma::mat responses;
+  MatType responses;
 
   //! Matrix of (trained) parameters.
-  arma::mat parameter;
+  MatType parameter;
 
   //! The number of separable functions (the number of predictor points).
   size_t numFunctions;
 
   //! The current error for the backward pass.
-  arma::mat error;
+  MatType error;
 
   //! THe current input of the forward/backward pass.
-  arma::mat currentInput;
+  MatType currentInput;
 
   //! Locally-stored delta visitor.
-  DeltaVisitor deltaVisitor;
+  DeltaVisitor<MatType> deltaVisitor;
 
   //! Locally-stored output parameter visitor.
-  OutputParameterVisitor outputParameterVisitor;
+  OutputParameterVisitor<MatType> outputParameterVisitor;
 
   //! Locally-stored weight size visitor.
   WeightSizeVisitor weightSizeVisitor;
@@ -438,20 +669,49 @@ class FFN
   //! The current evaluation mode (training or testing).
   bool deterministic;
 
-  //! Locally-stored delta object.
-  arma::mat delta;
+  //! Locally-stored gradient parameter.
+  MatType gradient;
 
-  //! Locally-stored input parameter object.
-  arma::mat inputParameter;
+  //! Locally-stored copy visitor
+  CopyVisitor<MatType, CustomLayers...> copyVisitor;
 
-  //! Locally-stored output parameter object.
-  arma::mat outputParameter;
+  //! The number of workers used by EvaluateWithGradient().
+  size_t workers;
 
-  //! Locally-stored gradient parameter.
-  arma::mat gradient;
+  //! Replicas of the network used by the workers other than the first.
+  std::vector<FFN*> replicas;
 
-  //! Locally-stored copy visitor
-  CopyVisitor<CustomLayers...> copyVisitor;
+  //! Memory shared by the outputs of the layers in Predict(); the layers use
+  //! the two columns in turn.
+  MatType predictionBuffers;
+
+  //! The sizes of the outputs of the layers (one column per layer) for the
+  //! batches that predictionBuffers was planned for.
+  arma::Mat<size_t> outputSizes;
+
+  //! The number of rows of the input that predictionBuffers was planned for.
+  size_t plannedInputRows;
+
+  //! The number of points per batch that predictionBuffers was planned for.
+  size_t plannedPoints;
+
+  //! Whether the outputs of the layers use predictionBuffers.
+  bool sharedPredictionBuffers;
+
+  //! The profile of the layers.
+  NetworkProfile profile;
+
+  //! The checkpoint of the training.
+  TrainingCheckpoint checkpoint;
+
+  //! Whether EvaluateWithGradient() computes row-sparse gradients.
+  bool sparseGradient;
+
+  //! The parts of the gradient written by the last gradient pass.
+  arma::Mat<size_t> gradientRanges;
+
+  //! The memory of the gradient of the last call to EvaluateWithGradient().
+  const typename MatType::elem_type* lastGradient;
 
   // The GAN class should have access to internal members.
   template<
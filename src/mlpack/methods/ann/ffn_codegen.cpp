@@ -0,0 +1,359 @@
+/**
+ * @file ffn_codegen.cpp
+ *
+ * Implementation of the FFNCodeGenerator class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "ffn_codegen.hpp"
+
+#include <cctype>
+#include <iomanip>
+
+using namespace mlpack;
+using namespace mlpack::ann;
+
+//! The kernels of the layers in the generated code.
+static const char* const kernels =
+    "//! y = W x + b, with the row-major Out x In matrix W.\n"
+    "template<std::size_t In, std::size_t Out>\n"
+    "inline void Linear(const double* weights, const double* bias,\n"
+    "                   const double* x, double* y)\n"
+    "{\n"
+    "  for (std::size_t o = 0; o < Out; ++o)\n"
+    "  {\n"
+    "    double sum = bias[o];\n"
+    "    for (std::size_t i = 0; i < In; ++i)\n"
+    "      sum += weights[o * In + i] * x[i];\n"
+    "    y[o] = sum;\n"
+    "  }\n"
+    "}\n"
+    "\n"
+    "//! y = W x, with the row-major Out x In matrix W.\n"
+    "template<std::size_t In, std::size_t Out>\n"
+    "inline void LinearNoBias(const double* weights, const double* x,\n"
+    "                         double* y)\n"
+    "{\n"
+    "  for (std::size_t o = 0; o < Out; ++o)\n"
+    "  {\n"
+    "    double sum = 0.0;\n"
+    "    for (std::size_t i = 0; i < In; ++i)\n"
+    "      sum += weights[o * In + i] * x[i];\n"
+    "    y[o] = sum;\n"
+    "  }\n"
+    "}\n"
+    "\n"
+    "template<std::size_t N>\n"
+    "inline void Logistic(double* x)\n"
+    "{\n"
+    "  for (std::size_t i = 0; i < N; ++i)\n"
+    "    x[i] = 1.0 / (1.0 + std::exp(-x[i]));\n"
+    "}\n"
+    "\n"
+    "template<std::size_t N>\n"
+    "inline void Tanh(double* x)\n"
+    "{\n"
+    "  for (std::size_t i = 0; i < N; ++i)\n"
+    "    x[i] = std::tanh(x[i]);\n"
+    "}\n"
+    "\n"
+    "template<std::size_t N>\n"
+    "inline void Rectifier(double* x)\n"
+    "{\n"
+    "  for (std::size_t i = 0; i < N; ++i)\n"
+    "    x[i] = (x[i] > 0.0) ? x[i] : 0.0;\n"
+    "}\n"
+    "\n"
+    "template<std::size_t N>\n"
+    "inline void Softplus(double* x)\n"
+    "{\n"
+    "  for (std::size_t i = 0; i < N; ++i)\n"
+    "  {\n"
+    "    const double y = std::log(1.0 + std::exp(x[i]));\n"
+    "    x[i] = std::isfinite(y) ? y : x[i];\n"
+    "  }\n"
+    "}\n"
+    "\n"
+    "template<std::size_t N>\n"
+    "inline void LeakyReLU(double* x, const double alpha)\n"
+    "{\n"
+    "  for (std::size_t i = 0; i < N; ++i)\n"
+    "    x[i] = (x[i] > alpha * x[i]) ? x[i] : alpha * x[i];\n"
+    "}\n"
+    "\n"
+    "template<std::size_t N>\n"
+    "inline void HardTanH(double* x, const double minValue,\n"
+    "                     const double maxValue)\n"
+    "{\n"
+    "  for (std::size_t i = 0; i < N; ++i)\n"
+    "    x[i] = (x[i] > maxValue) ? maxValue :\n"
+    "        ((x[i] < minValue) ? minValue : x[i]);\n"
+    "}\n"
+    "\n"
+    "//! The same approximation of exp(-x) as the LogSoftMax layer of mlpack.\n"
+    "inline double NegativeExp(const double x)\n"
+    "{\n"
+    "  if (x >= 13.0)\n"
+    "    return 0.0;\n"
+    "\n"
+    "  double y = 1.0 + x * (0.125 + x * (0.0078125 + x * (0.00032552083 +\n"
+    "      x * 1.0172526e-5)));\n"
+    "  y *= y;\n"
+    "  y *= y;\n"
+    "  y *= y;\n"
+    "  return 1.0 / y;\n"
+    "}\n"
+    "\n"
+    "template<std::size_t N>\n"
+    "inline void LogSoftMax(double* x)\n"
+    "{\n"
+    "  double maxValue = x[0];\n"
+    "  for (std::size_t i = 1; i < N; ++i)\n"
+    "    maxValue = (x[i] > maxValue) ? x[i] : maxValue;\n"
+    "\n"
+    "  double sum = 0.0;\n"
+    "  for (std::size_t i = 0; i < N; ++i)\n"
+    "    sum += NegativeExp(maxValue - x[i]);\n"
+    "\n"
+    "  const double offset = maxValue + std::log(sum);\n"
+    "  for (std::size_t i = 0; i < N; ++i)\n"
+    "    x[i] -= offset;\n"
+    "}\n"
+    "\n"
+    "template<std::size_t N>\n"
+    "inline void Copy(const double* x, double* y)\n"
+    "{\n"
+    "  for (std::size_t i = 0; i < N; ++i)\n"
+    "    y[i] = x[i];\n"
+    "}\n";
+
+FFNCodeGenerator::FFNCodeGenerator(const std::string& name) :
+    name(name),
+    layer(0),
+    inputSize(0),
+    size(0),
+    maxSize(0),
+    current("input"),
+    buffers(0)
+{
+  bool valid = !name.empty() && !std::isdigit((unsigned char) name[0]);
+  for (size_t i = 0; i < name.size(); ++i)
+    valid = valid && (std::isalnum((unsigned char) name[i]) || name[i] == '_');
+
+  if (!valid)
+  {
+    std::ostringstream oss;
+    oss << "FFNCodeGenerator::FFNCodeGenerator(): '" << name << "' is not a "
+        << "valid C++ identifier";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+void FFNCodeGenerator::operator()(Linear<>* layer)
+{
+  FullyConnected("Linear", layer->Parameters(), layer->InputSize(),
+      layer->OutputSize(), true);
+}
+
+void FFNCodeGenerator::operator()(LinearNoBias<>* layer)
+{
+  FullyConnected("LinearNoBias", layer->Parameters(), layer->InputSize(),
+      layer->OutputSize(), false);
+}
+
+void FFNCodeGenerator::operator()(SigmoidLayer<>* /* layer */)
+{
+  Elementwise("Logistic");
+}
+
+void FFNCodeGenerator::operator()(TanHLayer<>* /* layer */)
+{
+  Elementwise("Tanh");
+}
+
+void FFNCodeGenerator::operator()(ReLULayer<>* /* layer */)
+{
+  Elementwise("Rectifier");
+}
+
+void FFNCodeGenerator::operator()(SoftPlusLayer<>* /* layer */)
+{
+  Elementwise("Softplus");
+}
+
+void FFNCodeGenerator::operator()(IdentityLayer<>* /* layer */)
+{
+  Elementwise("");
+}
+
+void FFNCodeGenerator::operator()(LeakyReLU<>* layer)
+{
+  std::ostringstream arguments;
+  arguments << std::setprecision(17) << layer->Alpha();
+  Elementwise("LeakyReLU", arguments.str());
+}
+
+void FFNCodeGenerator::operator()(HardTanH<>* layer)
+{
+  std::ostringstream arguments;
+  arguments << std::setprecision(17) << layer->MinValue() << ", "
+      << layer->MaxValue();
+  Elementwise("HardTanH", arguments.str());
+}
+
+void FFNCodeGenerator::operator()(LogSoftMax<>* /* layer */)
+{
+  Elementwise("LogSoftMax");
+}
+
+void FFNCodeGenerator::operator()(Dropout<>* /* layer */)
+{
+  Elementwise("");
+}
+
+void FFNCodeGenerator::operator()(AlphaDropout<>* /* layer */)
+{
+  Elementwise("");
+}
+
+void FFNCodeGenerator::FullyConnected(const std::string& kernel,
+                                      const arma::mat& parameters,
+                                      const size_t inSize,
+                                      const size_t outSize,
+                                      const bool bias)
+{
+  if (inputSize == 0)
+  {
+    inputSize = inSize;
+    size = inSize;
+  }
+
+  if (inSize != size)
+  {
+    std::ostringstream oss;
+    oss << "FFNCodeGenerator::Generate(): layer " << layer << " has "
+        << inSize << " inputs, but the previous layer has " << size
+        << " outputs";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The weights are stored column-major, and written row-major so that each
+  // output is a contiguous dot product.
+  const arma::mat weight(const_cast<double*>(parameters.memptr()), outSize,
+      inSize, false, true);
+  const arma::mat weightRows = weight.t();
+
+  std::ostringstream prefix;
+  prefix << "layer" << layer;
+  WriteArray(prefix.str() + "Weight", std::vector<double>(weightRows.begin(),
+      weightRows.end()));
+  if (bias)
+  {
+    WriteArray(prefix.str() + "Bias", std::vector<double>(
+        parameters.begin() + weight.n_elem, parameters.begin() + weight.n_elem
+        + outSize));
+  }
+
+  // Alternate between the two buffers.
+  const std::string next = (current == "a") ? "b" : "a";
+  buffers = std::max(buffers, (size_t) ((next == "a") ? 1 : 2));
+
+  body << "  detail::" << kernel << "<" << inSize << ", " << outSize
+      << ">(detail::" << prefix.str() << "Weight, ";
+  if (bias)
+    body << "detail::" << prefix.str() << "Bias, ";
+  body << current << ", " << next << ");\n";
+
+  current = next;
+  size = outSize;
+  maxSize = std::max(maxSize, outSize);
+}
+
+void FFNCodeGenerator::Elementwise(const std::string& kernel,
+                                   const std::string& arguments)
+{
+  if (inputSize == 0)
+  {
+    std::ostringstream oss;
+    oss << "FFNCodeGenerator::Generate(): the first layer must be a Linear or "
+        << "LinearNoBias layer, but layer " << layer << " is not";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Layers without a kernel are the identity at inference.
+  if (kernel.empty())
+    return;
+
+  body << "  detail::" << kernel << "<" << size << ">(" << current;
+  if (!arguments.empty())
+    body << ", " << arguments;
+  body << ");\n";
+}
+
+void FFNCodeGenerator::WriteArray(const std::string& arrayName,
+                                  const std::vector<double>& values)
+{
+  arrays << "constexpr double " << arrayName << "[" << values.size()
+      << "] = {";
+  for (size_t i = 0; i < values.size(); ++i)
+  {
+    arrays << ((i % 3 == 0) ? "\n    " : " ") << std::setprecision(17)
+        << values[i] << ((i + 1 < values.size()) ? "," : "");
+  }
+  arrays << "\n};\n\n";
+}
+
+void FFNCodeGenerator::Write(std::ostream& out) const
+{
+  std::string guard;
+  for (size_t i = 0; i < name.size(); ++i)
+    guard += (char) std::toupper((unsigned char) name[i]);
+  guard += "_FFN_HPP";
+
+  out << "/**\n"
+      << " * Inference code of a feed forward network, generated by mlpack's\n"
+      << " * FFNCodeGenerator.  Do not edit.\n"
+      << " */\n"
+      << "#ifndef " << guard << "\n"
+      << "#define " << guard << "\n"
+      << "\n"
+      << "#include <cmath>\n"
+      << "#include <cstddef>\n"
+      << "\n"
+      << "namespace " << name << " {\n"
+      << "\n"
+      << "//! The number of input units of the network.\n"
+      << "constexpr std::size_t InputSize = " << inputSize << ";\n"
+      << "//! The number of output units of the network.\n"
+      << "constexpr std::size_t OutputSize = " << size << ";\n"
+      << "\n"
+      << "namespace detail {\n"
+      << "\n"
+      << kernels
+      << "\n"
+      << arrays.str()
+      << "} // namespace detail\n"
+      << "\n"
+      << "/**\n"
+      << " * Compute the output of the network for one point.\n"
+      << " *\n"
+      << " * @param input The point (InputSize values).\n"
+      << " * @param output The output of the network (OutputSize values).\n"
+      << " */\n"
+      << "inline void Predict(const double* input, double* output)\n"
+      << "{\n";
+  if (buffers > 0)
+    out << "  double a[" << maxSize << "];\n";
+  if (buffers > 1)
+    out << "  double b[" << maxSize << "];\n";
+  out << body.str()
+      << "  detail::Copy<OutputSize>(" << current << ", output);\n"
+      << "}\n"
+      << "\n"
+      << "} // namespace " << name << "\n"
+      << "\n"
+      << "#endif\n";
+}
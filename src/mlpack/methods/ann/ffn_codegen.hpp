@@ -0,0 +1,163 @@
+/**
+ * @file ffn_codegen.hpp
+ *
+ * Definition of the FFNCodeGenerator class, which writes the inference code of
+ * a trained feed forward network as a standalone C++ header.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_CODEGEN_HPP
+#define MLPACK_METHODS_ANN_FFN_CODEGEN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "visitor/layer_name_visitor.hpp"
+
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+#include <mlpack/methods/ann/layer/layer.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The FFNCodeGenerator class writes the forward pass of a trained FFN as a
+ * standalone C++ header, which only depends on the standard library:
+ *
+ * @code
+ * std::ofstream header("model.hpp");
+ * FFNCodeGenerator("model").Generate(network, header);
+ * @endcode
+ *
+ * The generated header defines, in the namespace of the given name, the
+ * InputSize and OutputSize constants and the function
+ *
+ * @code
+ * inline void Predict(const double* input, double* output);
+ * @endcode
+ *
+ * which computes the output of the network for one point, like FFN::Predict().
+ * The weights are compiled in as constexpr arrays, the layers are templates
+ * whose sizes are compile-time constants (so that the compiler can unroll and
+ * vectorize them), and the activations are kept in two fixed-size buffers on
+ * the stack; there is no dynamic allocation and no dispatch between the
+ * layers.
+ *
+ * The network must start with a Linear or LinearNoBias layer, and may then use
+ * the Linear, LinearNoBias, SigmoidLayer, TanHLayer, ReLULayer, SoftPlusLayer,
+ * IdentityLayer, LeakyReLU, HardTanH, LogSoftMax, Dropout and AlphaDropout
+ * layers (the dropout layers are the identity at inference); other layers
+ * throw a std::invalid_argument.  The activation functions are computed with
+ * the standard library, so the outputs match FFN::Predict() up to the accuracy
+ * of the fast activation kernels of mlpack (see FastMath).
+ */
+class FFNCodeGenerator : public boost::static_visitor<void>
+{
+ public:
+  /**
+   * Create the code generator.
+   *
+   * @param name The namespace of the generated code; it must be a valid C++
+   *     identifier.
+   */
+  FFNCodeGenerator(const std::string& name);
+
+  /**
+   * Write the inference code of the given network.
+   *
+   * @param network The trained network.
+   * @param out Stream to write the header to.
+   */
+  template<typename NetworkType>
+  void Generate(const NetworkType& network, std::ostream& out);
+
+  //! Write the code of a Linear layer.
+  void operator()(Linear<>* layer);
+  //! Write the code of a LinearNoBias layer.
+  void operator()(LinearNoBias<>* layer);
+  //! Write the code of a SigmoidLayer.
+  void operator()(SigmoidLayer<>* layer);
+  //! Write the code of a TanHLayer.
+  void operator()(TanHLayer<>* layer);
+  //! Write the code of a ReLULayer.
+  void operator()(ReLULayer<>* layer);
+  //! Write the code of a SoftPlusLayer.
+  void operator()(SoftPlusLayer<>* layer);
+  //! The IdentityLayer has no code.
+  void operator()(IdentityLayer<>* layer);
+  //! Write the code of a LeakyReLU layer.
+  void operator()(LeakyReLU<>* layer);
+  //! Write the code of a HardTanH layer.
+  void operator()(HardTanH<>* layer);
+  //! Write the code of a LogSoftMax layer.
+  void operator()(LogSoftMax<>* layer);
+  //! The Dropout layer has no code at inference.
+  void operator()(Dropout<>* layer);
+  //! The AlphaDropout layer has no code at inference.
+  void operator()(AlphaDropout<>* layer);
+
+  //! Throw a std::invalid_argument for the unsupported layers.
+  template<typename LayerType>
+  void operator()(LayerType* layer);
+
+ private:
+  /**
+   * Write the code of a fully-connected layer.
+   *
+   * @param kernel The kernel of the layer in the generated code.
+   * @param parameters The parameters of the layer.
+   * @param inSize The number of input units.
+   * @param outSize The number of output units.
+   * @param bias Whether the parameters end with a bias.
+   */
+  void FullyConnected(const std::string& kernel,
+                      const arma::mat& parameters,
+                      const size_t inSize,
+                      const size_t outSize,
+                      const bool bias);
+
+  /**
+   * Write the code of a layer that is applied in place to the activations.
+   *
+   * @param kernel The kernel of the layer in the generated code.
+   * @param arguments The arguments of the kernel after the activations.
+   */
+  void Elementwise(const std::string& kernel,
+                   const std::string& arguments = "");
+
+  //! Write the array of the given values.
+  void WriteArray(const std::string& arrayName,
+                  const std::vector<double>& values);
+
+  //! Write the header, once all the layers are visited.
+  void Write(std::ostream& out) const;
+
+  //! The namespace of the generated code.
+  std::string name;
+  //! The index of the visited layer.
+  size_t layer;
+  //! The number of input units of the network.
+  size_t inputSize;
+  //! The number of units of the current activations.
+  size_t size;
+  //! The number of units of the largest activations.
+  size_t maxSize;
+  //! The buffer holding the current activations.
+  std::string current;
+  //! The number of activation buffers used by the code.
+  size_t buffers;
+  //! The definitions of the weights.
+  std::ostringstream arrays;
+  //! The body of the Predict() function.
+  std::ostringstream body;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "ffn_codegen_impl.hpp"
+
+#endif
@@ -0,0 +1,61 @@
+/**
+ * @file ffn_codegen_impl.hpp
+ *
+ * Implementation of the templated functions of the FFNCodeGenerator class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_CODEGEN_IMPL_HPP
+#define MLPACK_METHODS_ANN_FFN_CODEGEN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ffn_codegen.hpp"
+
+namespace mlpack {
+namespace ann {
+
+template<typename NetworkType>
+void FFNCodeGenerator::Generate(const NetworkType& network, std::ostream& out)
+{
+  if (network.Parameters().is_empty())
+  {
+    throw std::invalid_argument("FFNCodeGenerator::Generate(): the network "
+        "has no parameters");
+  }
+
+  inputSize = 0;
+  size = 0;
+  maxSize = 0;
+  current = "input";
+  buffers = 0;
+  arrays.str("");
+  body.str("");
+
+  for (layer = 0; layer < network.Model().size(); ++layer)
+    boost::apply_visitor(*this, network.Model()[layer]);
+
+  if (inputSize == 0)
+  {
+    throw std::invalid_argument("FFNCodeGenerator::Generate(): the network "
+        "has no layers");
+  }
+
+  Write(out);
+}
+
+template<typename LayerType>
+void FFNCodeGenerator::operator()(LayerType* layer)
+{
+  std::ostringstream oss;
+  oss << "FFNCodeGenerator::Generate(): layer " << this->layer << " ("
+      << LayerNameVisitor()(layer) << ") is not supported";
+  throw std::invalid_argument(oss.str());
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
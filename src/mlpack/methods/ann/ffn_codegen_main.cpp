@@ -0,0 +1,77 @@
+/**
+ * @file ffn_codegen_main.cpp
+ *
+ * A CLI executable to generate the standalone inference code of a trained
+ * feed forward network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/load.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/ffn_codegen.hpp>
+
+#include <fstream>
+
+using namespace mlpack;
+using namespace mlpack::ann;
+using namespace mlpack::util;
+using namespace std;
+
+PROGRAM_INFO("FFN Code Generator",
+    // Short description.
+    "A utility to write the inference code of a trained feed forward network "
+    "as a standalone C++ header, which doesn't depend on mlpack.",
+    // Long description.
+    "This utility loads a trained FFN from the file given with the " +
+    PRINT_PARAM_STRING("model_file") + " parameter, which must have been "
+    "saved with data::Save() under the name 'model', and writes its forward "
+    "pass as a C++ header to the file given with the " +
+    PRINT_PARAM_STRING("header_file") + " parameter.  The header only uses "
+    "the standard library; it defines, in the namespace given by the " +
+    PRINT_PARAM_STRING("name") + " parameter, the constants InputSize and "
+    "OutputSize and the function"
+    "\n\n"
+    "  inline void Predict(const double* input, double* output);"
+    "\n\n"
+    "which computes the output of the network for one point.  The weights are "
+    "compiled in as constexpr arrays and the sizes of the layers are "
+    "compile-time constants, so the compiler can unroll and vectorize the "
+    "layers."
+    "\n\n"
+    "The network must start with a Linear or LinearNoBias layer, and may then "
+    "use the Linear, LinearNoBias, SigmoidLayer, TanHLayer, ReLULayer, "
+    "SoftPlusLayer, IdentityLayer, LeakyReLU, HardTanH, LogSoftMax, Dropout "
+    "and AlphaDropout layers."
+    "\n\n"
+    "For instance, to write the network saved in 'network.xml' to the header "
+    "'network.hpp' in the namespace 'network', run"
+    "\n\n"
+    "$ mlpack_ffn_codegen --model_file network.xml --header_file network.hpp "
+    "--name network");
+
+PARAM_STRING_IN_REQ("model_file", "File containing the trained FFN.", "m");
+PARAM_STRING_IN_REQ("header_file", "File to write the generated header to.",
+    "o");
+PARAM_STRING_IN("name", "Namespace of the generated code.", "n", "model");
+
+static void mlpackMain()
+{
+  // The output layer and the initialization rule are not serialized.
+  FFN<NegativeLogLikelihood<>, RandomInitialization> network;
+  data::Load(CLI::GetParam<string>("model_file"), "model", network, true);
+
+  const string headerFile = CLI::GetParam<string>("header_file");
+  ofstream header(headerFile);
+  if (!header.is_open())
+    Log::Fatal << "Could not open '" << headerFile << "' for writing." << endl;
+
+  FFNCodeGenerator generator(CLI::GetParam<string>("name"));
+  generator.Generate(network, header);
+  Log::Info << "Wrote the inference code to '" << headerFile << "'." << endl;
+}
@@ -15,6 +15,8 @@
 // In case it hasn't been included yet.
 #include "ffn.hpp"
 
+#include <mlpack/core/math/make_alias.hpp>
+
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
@@ -25,6 +27,8 @@
 
 #include <boost/serialization/variant.hpp>
 
+#include <future>
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -39,7 +43,13 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     height(0),
     reset(false),
     numFunctions(0),
-    deterministic(true)
+    deterministic(true),
+    workers(1),
+    plannedInputRows(0),
+    plannedPoints(0),
+    sharedPredictionBuffers(false),
+    sparseGradient(false),
+    lastGradient(NULL)
 {
   /* Nothing to do here */
 }
@@ -48,6 +58,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::~FFN()
 {
+  DeleteReplicas();
   std::for_each(network.begin(), network.end(),
       boost::apply_visitor(deleteVisitor));
 }
@@ -55,8 +66,9 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::~FFN()
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::ResetData(
-    arma::mat predictors, arma::mat responses)
+    MatType predictors, MatType responses)
 {
+  DeleteReplicas();
   numFunctions = responses.n_cols;
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
@@ -71,8 +83,8 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename OptimizerType>
 double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
-      arma::mat predictors,
-      arma::mat responses,
+      MatType predictors,
+      MatType responses,
       OptimizerType& optimizer)
 {
   ResetData(std::move(predictors), std::move(responses));
@@ -80,6 +92,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   // Train the model.
   Timer::Start("ffn_optimization");
   const double out = optimizer.Optimize(*this, parameter);
+  checkpoint.Finish(parameter);
   Timer::Stop("ffn_optimization");
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
@@ -91,7 +104,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename OptimizerType>
 double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
-    arma::mat predictors, arma::mat responses)
+    MatType predictors, MatType responses)
 {
   ResetData(std::move(predictors), std::move(responses));
 
@@ -100,6 +113,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   // Train the model.
   Timer::Start("ffn_optimization");
   const double out = optimizer.Optimize(*this, parameter);
+  checkpoint.Finish(parameter);
   Timer::Stop("ffn_optimization");
 
   Log::Info << "FFN::FFN(): final objective of trained model is " << out
@@ -107,10 +121,68 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   return out;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename DataSourceType, typename OptimizerType>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+TrainFromSource(DataSourceType& source,
+                OptimizerType& optimizer,
+                const size_t epochs)
+{
+  const size_t numChunks = source.NumChunks();
+  if (numChunks == 0)
+  {
+    throw std::invalid_argument("FFN::TrainFromSource(): the data source has "
+        "no chunks");
+  }
+
+  // The chunk that is being loaded, while the network is trained on the
+  // previous one.
+  MatType nextPredictors, nextResponses;
+
+  double out = 0;
+  Timer::Start("ffn_optimization");
+  for (size_t epoch = 0; epoch < epochs; ++epoch)
+  {
+    const arma::uvec order = arma::shuffle(arma::linspace<arma::uvec>(0,
+        numChunks - 1, numChunks));
+
+    std::future<void> loading = std::async(std::launch::async, [&]()
+    {
+      source.Load(order[0], nextPredictors, nextResponses);
+    });
+
+    for (size_t i = 0; i < numChunks; ++i)
+    {
+      // Wait for the chunk, and rethrow the exception of the loader, if any.
+      loading.get();
+      MatType chunkPredictors = std::move(nextPredictors);
+      MatType chunkResponses = std::move(nextResponses);
+
+      if (i + 1 < numChunks)
+      {
+        loading = std::async(std::launch::async, [&, i]()
+        {
+          source.Load(order[i + 1], nextPredictors, nextResponses);
+        });
+      }
+
+      ResetData(std::move(chunkPredictors), std::move(chunkResponses));
+      out = optimizer.Optimize(*this, parameter);
+    }
+  }
+  checkpoint.Finish(parameter);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::TrainFromSource(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
-    arma::mat inputs, arma::mat& results)
+    MatType inputs, MatType& results)
 {
   if (parameter.is_empty())
     ResetParameters();
@@ -129,15 +201,15 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
-    arma::mat inputs, arma::mat& results, const size_t begin, const size_t end)
+    MatType inputs, MatType& results, const size_t begin, const size_t end)
 {
-  boost::apply_visitor(ForwardVisitor(std::move(inputs), std::move(
+  boost::apply_visitor(ForwardVisitor<MatType>(std::move(inputs), std::move(
       boost::apply_visitor(outputParameterVisitor, network[begin]))),
       network[begin]);
 
   for (size_t i = 1; i < end - begin + 1; ++i)
   {
-    boost::apply_visitor(ForwardVisitor(std::move(boost::apply_visitor(
+    boost::apply_visitor(ForwardVisitor<MatType>(std::move(boost::apply_visitor(
         outputParameterVisitor, network[begin + i - 1])), std::move(
         boost::apply_visitor(outputParameterVisitor, network[begin + i]))),
         network[begin + i]);
@@ -149,7 +221,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Forward(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
-    arma::mat targets, arma::mat& gradients)
+    MatType targets, MatType& gradients)
 {
   double res = outputLayer.Forward(std::move(boost::apply_visitor(
       outputParameterVisitor, network.back())), std::move(targets));
@@ -162,7 +234,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
   outputLayer.Backward(std::move(boost::apply_visitor(outputParameterVisitor,
       network.back())), std::move(targets), std::move(error));
 
-  gradients = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+  gradients = arma::zeros<MatType>(parameter.n_rows, parameter.n_cols);
 
   Backward();
   ResetGradients(gradients);
@@ -174,7 +246,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
-    arma::mat predictors, arma::mat& results)
+    const MatType& predictors, MatType& results, const size_t batchSize)
 {
   if (parameter.is_empty())
     ResetParameters();
@@ -185,30 +257,132 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  arma::mat resultsTemp;
-  Forward(std::move(arma::mat(predictors.colptr(0),
-      predictors.n_rows, 1, false, true)));
-  resultsTemp = boost::apply_visitor(outputParameterVisitor,
-      network.back()).col(0);
-
-  results = arma::mat(resultsTemp.n_elem, predictors.n_cols);
-  results.col(0) = resultsTemp.col(0);
+  if (predictors.n_cols == 0)
+  {
+    results.reset();
+    return;
+  }
 
-  for (size_t i = 1; i < predictors.n_cols; i++)
+  const size_t effectiveBatchSize = (batchSize == 0) ? predictors.n_cols :
+      std::min(batchSize, (size_t) predictors.n_cols);
+  for (size_t i = 0; i < predictors.n_cols; i += effectiveBatchSize)
   {
-    Forward(std::move(arma::mat(predictors.colptr(i),
-        predictors.n_rows, 1, false, true)));
+    const size_t end = std::min(i + effectiveBatchSize,
+        (size_t) predictors.n_cols) - 1;
+    const size_t points = end - i + 1;
+
+    // The sizes of the outputs are only known once a batch of this size has
+    // been passed through the network.
+    if (i == 0 && plannedPoints == points && plannedInputRows ==
+        predictors.n_rows && outputSizes.n_cols == network.size())
+    {
+      results.set_size(outputSizes(0, network.size() - 1), predictors.n_cols);
+    }
+
+    const bool shared = SharePredictionBuffers(predictors.n_rows, points,
+        results, i);
+
+    // Use an alias of the predictors as the input of the first layer, so that
+    // they are not copied.
+    Forward(math::MakeColsAlias(predictors, i, points));
 
-    resultsTemp = boost::apply_visitor(outputParameterVisitor,
+    const MatType& output = boost::apply_visitor(outputParameterVisitor,
         network.back());
-    results.col(i) = resultsTemp.col(0);
+    if (results.n_rows != output.n_rows || results.n_cols != predictors.n_cols)
+      results.set_size(output.n_rows, predictors.n_cols);
+
+    // A layer that doesn't produce the planned size uses its own memory.
+    if (output.memptr() != results.colptr(i))
+      results.cols(i, end) = output;
+
+    if (!shared)
+      PlanPredictionBuffers(predictors.n_rows, points);
+  }
+
+  // The layers must not keep using the shared memory, which is overwritten by
+  // the next layers and which may be released with results.
+  ReleasePredictionBuffers();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::SharePredictionBuffers(const size_t inputRows,
+                                                  const size_t points,
+                                                  MatType& results,
+                                                  const size_t begin)
+{
+  if (plannedPoints != points || plannedInputRows != inputRows ||
+      outputSizes.n_cols != network.size() || results.n_cols < begin + points)
+  {
+    ReleasePredictionBuffers();
+    return false;
+  }
+
+  // The output of a layer is only needed by the next layer, so the layers
+  // alternate between the two columns of the buffer.
+  const size_t last = network.size() - 1;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    typename MatType::elem_type* memory = predictionBuffers.colptr(i % 2);
+    if (i == last && outputSizes(0, i) == results.n_rows &&
+        outputSizes(1, i) == points)
+    {
+      memory = results.colptr(begin);
+    }
+
+    boost::apply_visitor(outputParameterVisitor, network[i]) = MatType(memory,
+        outputSizes(0, i), outputSizes(1, i), false, false);
+  }
+
+  sharedPredictionBuffers = true;
+  return true;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PlanPredictionBuffers(const size_t inputRows,
+                                                 const size_t points)
+{
+  size_t elements = 0;
+  outputSizes.set_size(2, network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const MatType& output = boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    outputSizes(0, i) = output.n_rows;
+    outputSizes(1, i) = output.n_cols;
+    elements = std::max(elements, (size_t) output.n_elem);
   }
+
+  // The buffer is only ever enlarged, so that alternating batch sizes don't
+  // allocate it again.
+  if (predictionBuffers.n_rows < elements)
+    predictionBuffers.set_size(elements, 2);
+
+  plannedInputRows = inputRows;
+  plannedPoints = points;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ReleasePredictionBuffers()
+{
+  if (!sharedPredictionBuffers)
+    return;
+
+  for (size_t i = 0; i < network.size(); ++i)
+    boost::apply_visitor(outputParameterVisitor, network[i]).reset();
+
+  sharedPredictionBuffers = false;
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
-    arma::mat predictors, arma::mat responses)
+    MatType predictors, MatType responses)
 {
   if (parameter.is_empty())
     ResetParameters();
@@ -235,7 +409,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
-    const arma::mat& parameters)
+    const MatType& parameters)
 {
   double res = 0;
   for (size_t i = 0; i < predictors.n_cols; ++i)
@@ -247,7 +421,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
-    const arma::mat& /* parameters */,
+    const MatType& /* parameters */,
     const size_t begin,
     const size_t batchSize,
     const bool deterministic)
@@ -261,10 +435,11 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     ResetDeterministic();
   }
 
-  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  // Aliases of the batch are passed to the network, so that it is not copied.
+  Forward(math::MakeColsAlias(predictors, begin, batchSize));
   double res = outputLayer.Forward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)));
+      math::MakeColsAlias(responses, begin, batchSize));
 
   for (size_t i = 0; i < network.size(); ++i)
   {
@@ -277,7 +452,7 @@ double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
-    const arma::mat& parameters, const size_t begin, const size_t batchSize)
+    const MatType& parameters, const size_t begin, const size_t batchSize)
 {
   return Evaluate(parameters, begin, batchSize, true);
 }
@@ -286,7 +461,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename GradType>
 double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
-EvaluateWithGradient(const arma::mat& parameters, GradType& gradient)
+EvaluateWithGradient(const MatType& parameters, GradType& gradient)
 {
   double res = 0;
   for (size_t i = 0; i < predictors.n_cols; ++i)
@@ -299,7 +474,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename GradType>
 double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
-EvaluateWithGradient(const arma::mat& /* parameters */,
+EvaluateWithGradient(const MatType& /* parameters */,
                      const size_t begin,
                      GradType& gradient,
                      const size_t batchSize)
@@ -309,7 +484,17 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     if (parameter.is_empty())
       ResetParameters();
 
-    gradient = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+    gradient = arma::zeros<MatType>(parameter.n_rows, parameter.n_cols);
+  }
+  else if (sparseGradient && gradient.memptr() == lastGradient &&
+      gradient.n_elem == parameter.n_elem)
+  {
+    // Only the parts that were written by the last call are nonzero.
+    for (size_t i = 0; i < gradientRanges.n_cols; ++i)
+    {
+      gradient.rows(gradientRanges(0, i), gradientRanges(0, i) +
+          gradientRanges(1, i) - 1).zeros();
+    }
   }
   else
   {
@@ -322,10 +507,18 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
-  Forward(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  checkpoint.Update(parameter);
+
+  const size_t numWorkers = sparseGradient ? 1 : std::min((workers == 0) ?
+      NumThreads() : workers, batchSize);
+  if (numWorkers > 1)
+    return ParallelEvaluateWithGradient(begin, gradient, batchSize, numWorkers);
+
+  // Aliases of the batch are passed to the network, so that it is not copied.
+  Forward(math::MakeColsAlias(predictors, begin, batchSize));
   double res = outputLayer.Forward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)));
+      math::MakeColsAlias(responses, begin, batchSize));
 
   for (size_t i = 0; i < network.size(); ++i)
   {
@@ -334,22 +527,151 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 
   outputLayer.Backward(
       std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
-      std::move(responses.cols(begin, begin + batchSize - 1)),
-      std::move(error));
+      math::MakeColsAlias(responses, begin, batchSize), std::move(error));
 
   Backward();
   ResetGradients(gradient);
-  Gradient(std::move(predictors.cols(begin, begin + batchSize - 1)));
+  Gradient(math::MakeColsAlias(predictors, begin, batchSize));
+
+  if (sparseGradient)
+  {
+    ResetGradientRanges();
+    lastGradient = gradient.memptr();
+  }
 
   return res;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ParallelEvaluateWithGradient(const size_t begin,
+                             MatType& gradient,
+                             const size_t batchSize,
+                             const size_t numWorkers)
+{
+  ResetReplicas(numWorkers - 1);
+
+  // Worker k processes the points bounds[k] to bounds[k + 1] - 1.  The first
+  // worker is this network.
+  std::vector<size_t> bounds(numWorkers + 1);
+  for (size_t k = 0; k <= numWorkers; ++k)
+    bounds[k] = begin + k * batchSize / numWorkers;
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t k = 0; k < (omp_size_t) numWorkers; ++k)
+  {
+    FFN& worker = (k == 0) ? *this : *replicas[k - 1];
+    worker.Forward(math::MakeColsAlias(predictors, bounds[k],
+        bounds[k + 1] - bounds[k]));
+  }
+
+  // The output layer is evaluated on the whole batch, so that the objective
+  // doesn't depend on the number of workers whatever the loss function.
+  MatType output(boost::apply_visitor(outputParameterVisitor,
+      network.back()).n_rows, batchSize);
+  double res = 0;
+  for (size_t k = 0; k < numWorkers; ++k)
+  {
+    FFN& worker = (k == 0) ? *this : *replicas[k - 1];
+    output.cols(bounds[k] - begin, bounds[k + 1] - begin - 1) =
+        boost::apply_visitor(outputParameterVisitor, worker.network.back());
+
+    for (size_t i = 0; i < worker.network.size(); ++i)
+      res += boost::apply_visitor(lossVisitor, worker.network[i]);
+  }
+
+  res += outputLayer.Forward(std::move(output),
+      math::MakeColsAlias(responses, begin, batchSize));
+
+  MatType batchError;
+  outputLayer.Backward(std::move(output),
+      math::MakeColsAlias(responses, begin, batchSize), std::move(batchError));
+
+  // The replicas accumulate their gradients in their own gradient matrix.
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t k = 0; k < (omp_size_t) numWorkers; ++k)
+  {
+    FFN& worker = (k == 0) ? *this : *replicas[k - 1];
+    worker.error = batchError.cols(bounds[k] - begin,
+        bounds[k + 1] - begin - 1);
+
+    if (k > 0)
+      worker.gradient.zeros(parameter.n_rows, parameter.n_cols);
+
+    worker.Backward();
+    worker.ResetGradients((k == 0) ? gradient : worker.gradient);
+    worker.Gradient(math::MakeColsAlias(predictors, bounds[k],
+        bounds[k + 1] - bounds[k]));
+  }
+
+  for (size_t k = 1; k < numWorkers; ++k)
+    gradient += replicas[k - 1]->gradient;
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetReplicas(const size_t numReplicas)
+{
+  // Layers may have been added since the replicas were built.
+  if (!replicas.empty() && replicas[0]->network.size() != network.size())
+    DeleteReplicas();
+
+  while (replicas.size() < numReplicas)
+  {
+    FFN* replica = new FFN(outputLayer, initializeRule);
+    replica->width = width;
+    replica->height = height;
+    replica->reset = reset;
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      replica->network.push_back(boost::apply_visitor(copyVisitor,
+          network[i]));
+    }
+
+    // The layers of the replica use the parameters of this network.
+    size_t offset = 0;
+    for (size_t i = 0; i < replica->network.size(); ++i)
+    {
+      offset += boost::apply_visitor(WeightSetVisitor<MatType>(
+          std::move(parameter), offset), replica->network[i]);
+
+      boost::apply_visitor(resetVisitor, replica->network[i]);
+    }
+
+    replicas.push_back(replica);
+  }
+
+  for (size_t i = 0; i < replicas.size(); ++i)
+  {
+    if (replicas[i]->deterministic != deterministic)
+    {
+      replicas[i]->deterministic = deterministic;
+      replicas[i]->ResetDeterministic();
+    }
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::DeleteReplicas()
+{
+  for (size_t i = 0; i < replicas.size(); ++i)
+    delete replicas[i];
+
+  replicas.clear();
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
-    const arma::mat& parameters,
+    const MatType& parameters,
     const size_t begin,
-    arma::mat& gradient,
+    MatType& gradient,
     const size_t batchSize)
 {
   this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
@@ -359,7 +681,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  math::ShuffleData(predictors, responses, predictors, responses);
+  math::ShuffleDataInPlace(predictors, responses);
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -367,6 +689,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::ResetParameters()
 {
+  DeleteReplicas();
   ResetDeterministic();
 
   // Reset the network parameter with the given initialization rule.
@@ -375,6 +698,171 @@ void FFN<OutputLayerType, InitializationRuleType,
   networkInit.Initialize(network, parameter);
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t FFN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::FoldBatchNorm()
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  DeleteReplicas();
+
+  std::vector<TypedLayerTypes<MatType, CustomLayers...> > folded;
+  std::vector<size_t> offsets;
+  size_t offset = 0, foldedLayers = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    folded.push_back(network[i]);
+    offsets.push_back(offset);
+    offset += boost::apply_visitor(weightSizeVisitor, network[i]);
+
+    Linear<MatType, MatType>** linear =
+        boost::get<Linear<MatType, MatType>*>(&network[i]);
+    BatchNorm<MatType, MatType>** batchNorm = (i + 1 < network.size()) ?
+        boost::get<BatchNorm<MatType, MatType>*>(&network[i + 1]) : NULL;
+    if (linear == NULL || batchNorm == NULL)
+      continue;
+
+    // y = gamma % (W * x + b - mean) / sqrt(variance + eps) + beta.
+    const MatType& batchNormParameters = (*batchNorm)->Parameters();
+    const size_t outSize = batchNormParameters.n_elem / 2;
+    const MatType scale = batchNormParameters.rows(0, outSize - 1) /
+        arma::sqrt((*batchNorm)->TrainingVariance() + (*batchNorm)->Epsilon());
+
+    MatType& linearParameters = (*linear)->Parameters();
+    const size_t inSize = (linearParameters.n_elem - outSize) / outSize;
+    MatType weight(linearParameters.memptr(), outSize, inSize, false, true);
+    MatType bias(linearParameters.memptr() + weight.n_elem, outSize, 1, false,
+        true);
+
+    weight.each_col() %= scale;
+    bias = (bias - (*batchNorm)->TrainingMean()) % scale +
+        batchNormParameters.rows(outSize, 2 * outSize - 1);
+
+    // Skip the parameters of the BatchNorm layer.
+    offset += boost::apply_visitor(weightSizeVisitor, network[i + 1]);
+    boost::apply_visitor(deleteVisitor, network[i + 1]);
+    ++foldedLayers;
+    ++i;
+  }
+
+  if (foldedLayers > 0)
+    ReplaceLayers(folded, offsets);
+
+  return foldedLayers;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t FFN<OutputLayerType, InitializationRuleType,
+           CustomLayers...>::Quantize(const MatType& calibration)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  DeleteReplicas();
+  deterministic = true;
+  ResetDeterministic();
+
+  // Compute the input of every layer on the calibration points.
+  Forward(std::move(MatType(calibration)));
+
+  std::vector<TypedLayerTypes<MatType, CustomLayers...> > quantized;
+  std::vector<size_t> offsets;
+  size_t offset = 0, quantizedLayers = 0;
+  size_t inSize = calibration.n_rows;
+  double inputRange = arma::abs(calibration).max();
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const MatType& output = boost::apply_visitor(outputParameterVisitor,
+        network[i]);
+    const size_t outputRows = output.n_rows;
+    const double outputRange = output.is_empty() ? 0.0 :
+        arma::abs(output).max();
+
+    offsets.push_back(offset);
+    offset += boost::apply_visitor(weightSizeVisitor, network[i]);
+
+    Linear<MatType, MatType>** linear =
+        boost::get<Linear<MatType, MatType>*>(&network[i]);
+    LinearNoBias<MatType, MatType>** linearNoBias =
+        boost::get<LinearNoBias<MatType, MatType>*>(&network[i]);
+    if (linear != NULL || linearNoBias != NULL)
+    {
+      MatType& layerParameters = (linear != NULL) ? (*linear)->Parameters() :
+          (*linearNoBias)->Parameters();
+      const size_t outSize = layerParameters.n_elem /
+          ((linear != NULL) ? inSize + 1 : inSize);
+
+      const MatType weight(layerParameters.memptr(), outSize, inSize, false,
+          true);
+      const MatType bias = (linear != NULL) ? MatType(
+          layerParameters.memptr() + weight.n_elem, outSize, 1, false, true) :
+          MatType();
+
+      quantized.push_back(new QuantizedLinear<MatType, MatType>(weight, bias,
+          inputRange));
+      boost::apply_visitor(deleteVisitor, network[i]);
+      ++quantizedLayers;
+    }
+    else
+    {
+      quantized.push_back(network[i]);
+    }
+
+    inSize = outputRows;
+    inputRange = outputRange;
+  }
+
+  if (quantizedLayers > 0)
+    ReplaceLayers(quantized, offsets);
+
+  return quantizedLayers;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::
+ReplaceLayers(std::vector<TypedLayerTypes<MatType, CustomLayers...> >& layers,
+              const std::vector<size_t>& offsets)
+{
+  std::vector<size_t> sizes;
+  size_t size = 0;
+  for (size_t i = 0; i < layers.size(); ++i)
+  {
+    sizes.push_back(boost::apply_visitor(weightSizeVisitor, layers[i]));
+    size += sizes.back();
+  }
+
+  MatType values(size, 1);
+  for (size_t i = 0, j = 0; i < layers.size(); j += sizes[i], ++i)
+  {
+    if (sizes[i] > 0)
+    {
+      values.rows(j, j + sizes[i] - 1) =
+          parameter.rows(offsets[i], offsets[i] + sizes[i] - 1);
+    }
+  }
+
+  // Point the layers to the new parameters before the values are copied,
+  // because some layers (like BatchNorm) initialize their parameters when they
+  // are reset.
+  network = std::move(layers);
+  parameter.set_size(size, 1);
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offset += boost::apply_visitor(WeightSetVisitor<MatType>(std::move(
+        parameter), offset), network[i]);
+    boost::apply_visitor(resetVisitor, network[i]);
+  }
+  std::copy(values.begin(), values.end(), parameter.begin());
+
+  ResetDeterministic();
+  plannedPoints = 0;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
@@ -388,25 +876,81 @@ void FFN<OutputLayerType, InitializationRuleType,
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
-         CustomLayers...>::ResetGradients(arma::mat& gradient)
+         CustomLayers...>::ResetGradients(MatType& gradient)
 {
   size_t offset = 0;
   for (size_t i = 0; i < network.size(); ++i)
   {
-    offset += boost::apply_visitor(GradientSetVisitor(std::move(gradient),
-        offset), network[i]);
+    offset += boost::apply_visitor(GradientSetVisitor<MatType>(std::move(
+        gradient), offset), network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void FFN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetGradientRanges()
+{
+  std::vector<size_t> begins, lengths;
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t size = boost::apply_visitor(weightSizeVisitor, network[i]);
+    if (size == 0)
+      continue;
+
+    // A Lookup layer only writes the columns of the entries it looked up.
+    Lookup<MatType, MatType>** lookup =
+        boost::get<Lookup<MatType, MatType>*>(&network[i]);
+    const size_t rows = (lookup != NULL) ? (*lookup)->Parameters().n_rows : 0;
+    const size_t numRanges = (lookup != NULL) ?
+        (*lookup)->Indices().n_elem : 1;
+    for (size_t j = 0; j < numRanges; ++j)
+    {
+      const size_t begin = (lookup != NULL) ?
+          offset + (*lookup)->Indices()[j] * rows : offset;
+      const size_t length = (lookup != NULL) ? rows : size;
+
+      // Merge the contiguous ranges.
+      if (!begins.empty() && begins.back() + lengths.back() == begin)
+      {
+        lengths.back() += length;
+      }
+      else
+      {
+        begins.push_back(begin);
+        lengths.push_back(length);
+      }
+    }
+
+    offset += size;
+  }
+
+  gradientRanges.set_size(2, begins.size());
+  for (size_t i = 0; i < begins.size(); ++i)
+  {
+    gradientRanges(0, i) = begins[i];
+    gradientRanges(1, i) = lengths[i];
   }
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
-         CustomLayers...>::Forward(arma::mat&& input)
+         CustomLayers...>::Forward(MatType&& input)
 {
-  boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
+  const bool profiling = profile.Enabled();
+  NetworkProfile::Clock::time_point begin;
+  if (profiling)
+    begin = NetworkProfile::Clock::now();
+
+  boost::apply_visitor(ForwardVisitor<MatType>(std::move(input), std::move(
       boost::apply_visitor(outputParameterVisitor, network.front()))),
       network.front());
 
+  if (profiling)
+    profile.Record<MatType>(0, NetworkProfile::FORWARD, begin, network.front());
+
   if (!reset)
   {
     if (boost::apply_visitor(outputWidthVisitor, network.front()) != 0)
@@ -431,10 +975,16 @@ void FFN<OutputLayerType, InitializationRuleType,
       boost::apply_visitor(SetInputHeightVisitor(height), network[i]);
     }
 
-    boost::apply_visitor(ForwardVisitor(std::move(boost::apply_visitor(
+    if (profiling)
+      begin = NetworkProfile::Clock::now();
+
+    boost::apply_visitor(ForwardVisitor<MatType>(std::move(boost::apply_visitor(
         outputParameterVisitor, network[i - 1])), std::move(
         boost::apply_visitor(outputParameterVisitor, network[i]))), network[i]);
 
+    if (profiling)
+      profile.Record<MatType>(i, NetworkProfile::FORWARD, begin, network[i]);
+
     if (!reset)
     {
       // Get the output width.
@@ -459,38 +1009,86 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
-  boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
+  const bool profiling = profile.Enabled();
+  NetworkProfile::Clock::time_point begin;
+  if (profiling)
+    begin = NetworkProfile::Clock::now();
+
+  boost::apply_visitor(BackwardVisitor<MatType>(std::move(boost::apply_visitor(
       outputParameterVisitor, network.back())), std::move(error), std::move(
       boost::apply_visitor(deltaVisitor, network.back()))), network.back());
 
+  if (profiling)
+  {
+    profile.Record<MatType>(network.size() - 1, NetworkProfile::BACKWARD,
+        begin, network.back());
+  }
+
   for (size_t i = 2; i < network.size(); ++i)
   {
-    boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, network[network.size() - i])), std::move(
-        boost::apply_visitor(deltaVisitor, network[network.size() - i + 1])),
-        std::move(boost::apply_visitor(deltaVisitor,
-        network[network.size() - i]))), network[network.size() - i]);
+    if (profiling)
+      begin = NetworkProfile::Clock::now();
+
+    boost::apply_visitor(BackwardVisitor<MatType>(std::move(
+        boost::apply_visitor(outputParameterVisitor,
+        network[network.size() - i])), std::move(boost::apply_visitor(
+        deltaVisitor, network[network.size() - i + 1])), std::move(
+        boost::apply_visitor(deltaVisitor, network[network.size() - i]))),
+        network[network.size() - i]);
+
+    if (profiling)
+    {
+      profile.Record<MatType>(network.size() - i, NetworkProfile::BACKWARD,
+          begin, network[network.size() - i]);
+    }
   }
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void FFN<OutputLayerType, InitializationRuleType,
-         CustomLayers...>::Gradient(arma::mat&& input)
+         CustomLayers...>::Gradient(MatType&& input)
 {
-  boost::apply_visitor(GradientVisitor(std::move(input), std::move(
+  const bool profiling = profile.Enabled();
+  NetworkProfile::Clock::time_point begin;
+  if (profiling)
+    begin = NetworkProfile::Clock::now();
+
+  boost::apply_visitor(GradientVisitor<MatType>(std::move(input), std::move(
       boost::apply_visitor(deltaVisitor, network[1]))), network.front());
 
+  if (profiling)
+  {
+    profile.Record<MatType>(0, NetworkProfile::GRADIENT, begin,
+        network.front());
+  }
+
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
-    boost::apply_visitor(GradientVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, network[i - 1])), std::move(
-        boost::apply_visitor(deltaVisitor, network[i + 1]))), network[i]);
+    if (profiling)
+      begin = NetworkProfile::Clock::now();
+
+    boost::apply_visitor(GradientVisitor<MatType>(std::move(
+        boost::apply_visitor(outputParameterVisitor, network[i - 1])),
+        std::move(boost::apply_visitor(deltaVisitor, network[i + 1]))),
+        network[i]);
+
+    if (profiling)
+      profile.Record<MatType>(i, NetworkProfile::GRADIENT, begin, network[i]);
   }
 
-  boost::apply_visitor(GradientVisitor(std::move(boost::apply_visitor(
+  if (profiling)
+    begin = NetworkProfile::Clock::now();
+
+  boost::apply_visitor(GradientVisitor<MatType>(std::move(boost::apply_visitor(
       outputParameterVisitor, network[network.size() - 2])), std::move(error)),
       network[network.size() - 1]);
+
+  if (profiling)
+  {
+    profile.Record<MatType>(network.size() - 1, NetworkProfile::GRADIENT,
+        begin, network.back());
+  }
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -514,6 +1112,7 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
   // Be sure to clear other layers before loading.
   if (Archive::is_loading::value)
   {
+    DeleteReplicas();
     std::for_each(network.begin(), network.end(),
         boost::apply_visitor(deleteVisitor));
     network.clear();
@@ -532,8 +1131,8 @@ void FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
     size_t offset = 0;
     for (size_t i = 0; i < network.size(); ++i)
     {
-      offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
-          offset), network[i]);
+      offset += boost::apply_visitor(WeightSetVisitor<MatType>(std::move(
+          parameter), offset), network[i]);
 
       boost::apply_visitor(resetVisitor, network[i]);
     }
@@ -548,6 +1147,11 @@ template<typename OutputLayerType, typename InitializationRuleType,
 void FFN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Swap(FFN& network)
 {
+  // The replicas use the parameters of their network, which may be copied
+  // instead of moved by the swap.
+  DeleteReplicas();
+  network.DeleteReplicas();
+
   std::swap(outputLayer, network.outputLayer);
   std::swap(initializeRule, network.initializeRule);
   std::swap(width, network.width);
@@ -561,10 +1165,17 @@ void FFN<OutputLayerType, InitializationRuleType,
   std::swap(error, network.error);
   std::swap(currentInput, network.currentInput);
   std::swap(deterministic, network.deterministic);
-  std::swap(delta, network.delta);
-  std::swap(inputParameter, network.inputParameter);
-  std::swap(outputParameter, network.outputParameter);
   std::swap(gradient, network.gradient);
+  std::swap(workers, network.workers);
+  std::swap(predictionBuffers, network.predictionBuffers);
+  std::swap(outputSizes, network.outputSizes);
+  std::swap(plannedInputRows, network.plannedInputRows);
+  std::swap(plannedPoints, network.plannedPoints);
+  std::swap(profile, network.profile);
+  std::swap(checkpoint, network.checkpoint);
+  std::swap(sparseGradient, network.sparseGradient);
+  std::swap(gradientRanges, network.gradientRanges);
+  std::swap(lastGradient, network.lastGradient);
 };
 
 template<typename OutputLayerType, typename InitializationRuleType,
@@ -583,10 +1194,15 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     error(network.error),
     currentInput(network.currentInput),
     deterministic(network.deterministic),
-    delta(network.delta),
-    inputParameter(network.inputParameter),
-    outputParameter(network.outputParameter),
-    gradient(network.gradient)
+    gradient(network.gradient),
+    workers(network.workers),
+    plannedInputRows(0),
+    plannedPoints(0),
+    sharedPredictionBuffers(false),
+    profile(network.profile),
+    checkpoint(network.checkpoint),
+    sparseGradient(network.sparseGradient),
+    lastGradient(NULL)
 {
   // Build new layers according to source network
   for (size_t i = 0; i < network.network.size(); ++i)
@@ -612,10 +1228,16 @@ FFN<OutputLayerType, InitializationRuleType, CustomLayers...>::FFN(
     error(std::move(network.error)),
     currentInput(std::move(network.currentInput)),
     deterministic(network.deterministic),
-    delta(std::move(network.delta)),
-    inputParameter(std::move(network.inputParameter)),
-    outputParameter(std::move(network.outputParameter)),
-    gradient(std::move(network.gradient))
+    gradient(std::move(network.gradient)),
+    workers(network.workers),
+    plannedInputRows(0),
+    plannedPoints(0),
+    sharedPredictionBuffers(false),
+    profile(std::move(network.profile)),
+    checkpoint(std::move(network.checkpoint)),
+    sparseGradient(network.sparseGradient),
+    gradientRanges(std::move(network.gradientRanges)),
+    lastGradient(network.lastGradient)
 {
   this->network = std::move(network.network);
 };
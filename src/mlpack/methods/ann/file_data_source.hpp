@@ -0,0 +1,102 @@
+/**
+ * @file file_data_source.hpp
+ *
+ * Definition of the FileDataSource class, which loads the chunks of a dataset
+ * that is split across several files.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FILE_DATA_SOURCE_HPP
+#define MLPACK_METHODS_ANN_FILE_DATA_SOURCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/load.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The FileDataSource class is a data source for FFN::TrainFromSource(), for
+ * datasets that don't fit in memory.  The dataset is split in chunks, and the
+ * predictors and the responses of each chunk are stored in their own files,
+ * in any format that data::Load() supports, with one point per column once
+ * loaded.
+ *
+ * @code
+ * std::vector<std::string> predictors = { "x0.bin", "x1.bin", "x2.bin" };
+ * std::vector<std::string> responses = { "y0.bin", "y1.bin", "y2.bin" };
+ * FileDataSource<> source(predictors, responses);
+ * model.TrainFromSource(source, optimizer, 10);
+ * @endcode
+ *
+ * A data source only has to provide NumChunks() and Load(); Load() is called
+ * from a background thread, one chunk at a time.
+ *
+ * @tparam MatType Matrix type of the predictors and the responses.
+ */
+template<typename MatType = arma::mat>
+class FileDataSource
+{
+ public:
+  /**
+   * Create the data source from the names of the files of the chunks.
+   *
+   * @param predictorFiles The file of the predictors of each chunk.
+   * @param responseFiles The file of the responses of each chunk.
+   */
+  FileDataSource(const std::vector<std::string>& predictorFiles,
+                 const std::vector<std::string>& responseFiles) :
+      predictorFiles(predictorFiles),
+      responseFiles(responseFiles)
+  {
+    if (predictorFiles.size() != responseFiles.size())
+    {
+      std::ostringstream oss;
+      oss << "FileDataSource::FileDataSource(): " << predictorFiles.size()
+          << " predictor files were given, but " << responseFiles.size()
+          << " response files";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  //! Get the number of chunks.
+  size_t NumChunks() const { return predictorFiles.size(); }
+
+  /**
+   * Load the given chunk.  A std::runtime_error is thrown if one of the files
+   * can't be loaded, or if they don't have the same number of points.
+   *
+   * @param chunk Index of the chunk to load.
+   * @param predictors Matrix to load the predictors into.
+   * @param responses Matrix to load the responses into.
+   */
+  void Load(const size_t chunk, MatType& predictors, MatType& responses) const
+  {
+    data::Load(predictorFiles[chunk], predictors, true);
+    data::Load(responseFiles[chunk], responses, true);
+
+    if (predictors.n_cols != responses.n_cols)
+    {
+      std::ostringstream oss;
+      oss << "FileDataSource::Load(): '" << predictorFiles[chunk] << "' has "
+          << predictors.n_cols << " points, but '" << responseFiles[chunk]
+          << "' has " << responses.n_cols;
+      throw std::runtime_error(oss.str());
+    }
+  }
+
+ private:
+  //! The file of the predictors of each chunk.
+  std::vector<std::string> predictorFiles;
+
+  //! The file of the responses of each chunk.
+  std::vector<std::string> responseFiles;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -303,6 +303,33 @@ class GAN
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Run the Discriminator forward on the given batch and backpropagate the
+   * error with respect to the given targets, storing the gradient of the
+   * Discriminator in the given matrix.  The activations of the batch are kept
+   * by the Discriminator, so that GeneratorGradient() can reuse them.
+   *
+   * @param input The batch to run the Discriminator on.
+   * @param target The targets of the batch.
+   * @param gradient Matrix to store the gradient of the Discriminator in.
+   * @return The objective of the Discriminator on the batch.
+   */
+  double DiscriminatorGradient(arma::mat&& input,
+                               arma::mat&& target,
+                               arma::mat& gradient);
+
+  /**
+   * Compute the gradient of the Generator for the generated batch that the
+   * Discriminator was last run on by DiscriminatorGradient(), by
+   * backpropagating the error with respect to the given targets through the
+   * Discriminator and then through the Generator.  The forward passes of both
+   * networks are reused, and the gradient of the Discriminator isn't
+   * computed.
+   *
+   * @param target The targets of the generated batch.
+   */
+  void GeneratorGradient(arma::mat&& target);
+
   //! Locally stored parameter for training data + noise data.
   arma::mat predictors;
   //! Locally stored parameters of the network.
@@ -338,7 +365,7 @@ class GAN
   //! Locally stored reset parameter.
   bool reset;
   //! Locally stored delta visitor.
-  DeltaVisitor deltaVisitor;
+  DeltaVisitor<> deltaVisitor;
   //! Locally stored responses.
   arma::mat responses;
   //! Locally stored current input.
@@ -346,7 +373,7 @@ class GAN
   //! Locally stored current target.
   arma::mat currentTarget;
   //! Locally-stored output parameter visitor.
-  OutputParameterVisitor outputParameterVisitor;
+  OutputParameterVisitor<> outputParameterVisitor;
   //! Locally-stored weight size visitor.
   WeightSizeVisitor weightSizeVisitor;
   //! Locally-stored reset visitor.
@@ -359,6 +386,9 @@ class GAN
   arma::mat noiseGradientDiscriminator;
   //! Locally stored norm of the gradient of Discriminator.
   arma::mat normGradientDiscriminator;
+  //! Locally stored interpolation between the real and the generated batch
+  //! for the gradient penalty.
+  arma::mat penaltyInput;
   //! Locally stored noise using the noise function.
   arma::mat noise;
   //! Locally stored gradient for Generator.
@@ -51,19 +51,21 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   noise.imbue( [&]() { return noiseFunction();} );
   generator.Forward(std::move(noise));
 
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  discriminator.Forward(std::move(discriminator.predictors.cols(numFunctions,
-      numFunctions + batchSize - 1)));
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
-
-  currentTarget = arma::mat(discriminator.responses.memptr() + numFunctions,
-      1, batchSize, false, false);
+  // The generated batch is stored in place in the last columns of the
+  // predictors of the Discriminator.
+  arma::mat fakeData(discriminator.predictors.colptr(numFunctions),
+      discriminator.predictors.n_rows, batchSize, false, true);
+  arma::mat fakeTarget(discriminator.responses.colptr(numFunctions), 1,
+      batchSize, false, true);
+  fakeData = boost::apply_visitor(outputParameterVisitor,
+      generator.network.back());
+  fakeTarget.fill(-1);
+
+  discriminator.Forward(std::move(fakeData));
   res += discriminator.outputLayer.Forward(
       std::move(boost::apply_visitor(
       outputParameterVisitor,
-      discriminator.network.back())), std::move(currentTarget));
+      discriminator.network.back())), std::move(fakeTarget));
 
   return res;
 }
@@ -94,16 +96,6 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   else
     gradient.zeros();
 
-  if (noiseGradientDiscriminator.is_empty())
-  {
-    noiseGradientDiscriminator = arma::zeros<arma::mat>(
-        gradientDiscriminator.n_elem, 1);
-  }
-  else
-  {
-    noiseGradientDiscriminator.zeros();
-  }
-
   gradientGenerator = arma::mat(gradient.memptr(),
       generator.Parameters().n_elem, 1, false, false);
 
@@ -111,20 +103,27 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
+  if (noiseGradientDiscriminator.n_elem != gradientDiscriminator.n_elem)
+    noiseGradientDiscriminator.zeros(gradientDiscriminator.n_elem, 1);
+
   // Get the gradients of the Discriminator.
   double res = discriminator.EvaluateWithGradient(discriminator.parameter,
       i, gradientDiscriminator, batchSize);
 
+  // The generated batch is stored in place in the last columns of the
+  // predictors of the Discriminator.
   noise.imbue( [&]() { return noiseFunction();} );
   generator.Forward(std::move(noise));
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      boost::apply_visitor(outputParameterVisitor, generator.network.back());
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
-
-  // Get the gradients of the Generator.
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
+  arma::mat fakeData(discriminator.predictors.colptr(numFunctions),
+      discriminator.predictors.n_rows, batchSize, false, true);
+  arma::mat fakeTarget(discriminator.responses.colptr(numFunctions), 1,
+      batchSize, false, true);
+  fakeData = boost::apply_visitor(outputParameterVisitor,
+      generator.network.back());
+  fakeTarget.fill(-1);
+
+  res += DiscriminatorGradient(std::move(fakeData), std::move(fakeTarget),
+      noiseGradientDiscriminator);
   gradientDiscriminator += noiseGradientDiscriminator;
   gradientDiscriminator = arma::clamp(gradientDiscriminator,
       -clippingParameter, clippingParameter);
@@ -132,17 +131,10 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   if (currentBatch % generatorUpdateStep == 0 && preTrainSize == 0)
   {
     // Minimize -D(G(noise)).
-    // Pass the error from Discriminator to Generator.
-    discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-        arma::ones(1, batchSize);
-    discriminator.Gradient(discriminator.parameter, numFunctions,
-        noiseGradientDiscriminator, batchSize);
-    generator.error = boost::apply_visitor(deltaVisitor,
-        discriminator.network[1]);
-
-    generator.Predictors() = noise;
-    generator.ResetGradients(gradientGenerator);
-    generator.Gradient(generator.parameter, 0, gradientGenerator, batchSize);
+    // Pass the error from Discriminator to Generator, reusing the forward
+    // passes of the generated batch.
+    fakeTarget.ones();
+    GeneratorGradient(std::move(fakeTarget));
 
     gradientGenerator *= multiplier;
   }
@@ -52,30 +52,30 @@ GAN<Model, InitializationRuleType, Noise, PolicyType>::Evaluate(
   noise.imbue( [&]() { return noiseFunction();} );
   generator.Forward(std::move(noise));
 
-  arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
+  // The generated batch is stored in place in the last columns of the
+  // predictors of the Discriminator.
+  arma::mat fakeData(discriminator.predictors.colptr(numFunctions),
+      discriminator.predictors.n_rows, batchSize, false, true);
+  arma::mat fakeTarget(discriminator.responses.colptr(numFunctions), 1,
+      batchSize, false, true);
+  fakeData = boost::apply_visitor(outputParameterVisitor,
       generator.network.back());
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      generatedData;
-  discriminator.Forward(std::move(discriminator.predictors.cols(numFunctions,
-      numFunctions + batchSize - 1)));
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
-
-  currentTarget = arma::mat(discriminator.responses.memptr() + numFunctions,
-      1, batchSize, false, false);
+  fakeTarget.fill(-1);
+
+  discriminator.Forward(std::move(fakeData));
   res += discriminator.outputLayer.Forward(
       std::move(boost::apply_visitor(
       outputParameterVisitor,
-      discriminator.network.back())), std::move(currentTarget));
+      discriminator.network.back())), std::move(fakeTarget));
+
+  // Gradient Penalty is calculated here, on the whole interpolated batch.
+  if (normGradientDiscriminator.n_elem != discriminator.Parameters().n_elem)
+    normGradientDiscriminator.zeros(discriminator.Parameters().n_elem, 1);
 
-  // Gradient Penalty is calculated here.
   double epsilon = math::Random();
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
-  discriminator.Gradient(discriminator.parameter, numFunctions,
-      normGradientDiscriminator, batchSize);
+  penaltyInput = (epsilon * currentInput) + ((1.0 - epsilon) * fakeData);
+  DiscriminatorGradient(std::move(penaltyInput), std::move(fakeTarget),
+      normGradientDiscriminator);
   res += lambda * std::pow(arma::norm(normGradientDiscriminator, 2) - 1, 2);
 
   return res;
@@ -108,16 +108,6 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   else
     gradient.zeros();
 
-  if (noiseGradientDiscriminator.is_empty())
-  {
-    noiseGradientDiscriminator = arma::zeros<arma::mat>(
-        gradientDiscriminator.n_elem, 1);
-  }
-  else
-  {
-    noiseGradientDiscriminator.zeros();
-  }
-
   gradientGenerator = arma::mat(gradient.memptr(),
       generator.Parameters().n_elem, 1, false, false);
 
@@ -125,6 +115,12 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       gradientGenerator.n_elem,
       discriminator.Parameters().n_elem, 1, false, false);
 
+  if (noiseGradientDiscriminator.n_elem != gradientDiscriminator.n_elem)
+  {
+    noiseGradientDiscriminator.zeros(gradientDiscriminator.n_elem, 1);
+    normGradientDiscriminator.zeros(gradientDiscriminator.n_elem, 1);
+  }
+
   currentInput = arma::mat(predictors.memptr() + (i * predictors.n_rows),
       predictors.n_rows, batchSize, false, false);
 
@@ -132,41 +128,38 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
   double res = discriminator.EvaluateWithGradient(discriminator.parameter,
       i, gradientDiscriminator, batchSize);
 
+  // The generated batch is stored in place in the last columns of the
+  // predictors of the Discriminator.
   noise.imbue( [&]() { return noiseFunction();} );
   generator.Forward(std::move(noise));
-  arma::mat generatedData = boost::apply_visitor(outputParameterVisitor,
+  arma::mat fakeData(discriminator.predictors.colptr(numFunctions),
+      discriminator.predictors.n_rows, batchSize, false, true);
+  arma::mat fakeTarget(discriminator.responses.colptr(numFunctions), 1,
+      batchSize, false, true);
+  fakeData = boost::apply_visitor(outputParameterVisitor,
       generator.network.back());
+  fakeTarget.fill(-1);
 
-  // Gradient Penalty is calculated here.
+  // Gradient Penalty is calculated here, on the whole interpolated batch.  It
+  // is computed first, so that the activations of the generated batch are
+  // still there for the Generator.
   double epsilon = math::Random();
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      (epsilon * currentInput) + ((1.0 - epsilon) * generatedData);
-  discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-      -arma::ones(1, batchSize);
-  discriminator.Gradient(discriminator.parameter, numFunctions,
-      normGradientDiscriminator, batchSize);
+  penaltyInput = (epsilon * currentInput) + ((1.0 - epsilon) * fakeData);
+  DiscriminatorGradient(std::move(penaltyInput), std::move(fakeTarget),
+      normGradientDiscriminator);
   res += lambda * std::pow(arma::norm(normGradientDiscriminator, 2) - 1, 2);
 
-  discriminator.predictors.cols(numFunctions, numFunctions + batchSize - 1) =
-      generatedData;
-  res += discriminator.EvaluateWithGradient(discriminator.parameter,
-      numFunctions, noiseGradientDiscriminator, batchSize);
+  res += DiscriminatorGradient(std::move(fakeData), std::move(fakeTarget),
+      noiseGradientDiscriminator);
   gradientDiscriminator += noiseGradientDiscriminator;
 
   if (currentBatch % generatorUpdateStep == 0 && preTrainSize == 0)
   {
     // Minimize -D(G(noise)).
-    // Pass the error from Discriminator to Generator.
-    discriminator.responses.cols(numFunctions, numFunctions + batchSize - 1) =
-        arma::ones(1, batchSize);
-    discriminator.Gradient(discriminator.parameter, numFunctions,
-        noiseGradientDiscriminator, batchSize);
-    generator.error = boost::apply_visitor(deltaVisitor,
-        discriminator.network[1]);
-
-    generator.Predictors() = noise;
-    generator.ResetGradients(gradientGenerator);
-    generator.Gradient(generator.parameter, 0, gradientGenerator, batchSize);
+    // Pass the error from Discriminator to Generator, reusing the forward
+    // passes of the generated batch.
+    fakeTarget.ones();
+    GeneratorGradient(std::move(fakeTarget));
 
     gradientGenerator *= multiplier;
   }
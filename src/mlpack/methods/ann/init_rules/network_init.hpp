@@ -49,11 +49,15 @@ class NetworkInitialization
    * Initialize the specified network and store the results in the given
    * parameter.
    *
+   * @tparam MatType Matrix type of the network.
    * @param network Network that should be initialized.
    * @param parameter The network parameter.
    */
-  void Initialize(const std::vector<LayerTypes<CustomLayers...> >& network,
-                  arma::mat& parameter, size_t parameterOffset = 0)
+  template<typename MatType>
+  void Initialize(
+      const std::vector<TypedLayerTypes<MatType, CustomLayers...> >& network,
+      MatType& parameter,
+      size_t parameterOffset = 0)
   {
     // Determine the number of parameter/weights of the given network.
     if (parameter.is_empty())
@@ -73,7 +77,7 @@ class NetworkInitialization
         // initialization rule.
         const size_t weight = boost::apply_visitor(weightSizeVisitor,
             network[i]);
-        arma::mat tmp = arma::mat(parameter.memptr() + offset,
+        MatType tmp = MatType(parameter.memptr() + offset,
             weight, 1, false, false);
         initializeRule.Initialize(tmp, tmp.n_elem, 1);
 
@@ -92,8 +96,8 @@ class NetworkInitialization
     // hold various other modules.
     for (size_t i = 0, offset = parameterOffset; i < network.size(); ++i)
     {
-      offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
-          offset), network[i]);
+      offset += boost::apply_visitor(WeightSetVisitor<MatType>(
+          std::move(parameter), offset), network[i]);
 
       boost::apply_visitor(resetVisitor, network[i]);
     }
@@ -132,7 +132,10 @@ class AddMerge
    *
    * @param layer The Layer to be added to the model.
    */
-  void Add(LayerTypes<CustomLayers...> layer) { network.push_back(layer); }
+  void Add(TypedLayerTypes<OutputDataType, CustomLayers...> layer)
+  {
+    network.push_back(layer);
+  }
 
   //! Get the input parameter.
   InputDataType const& InputParameter() const { return inputParameter; }
@@ -150,7 +153,7 @@ class AddMerge
   OutputDataType& Delta() { return delta; }
 
   //! Return the model modules.
-  std::vector<LayerTypes<CustomLayers...> >& Model()
+  std::vector<TypedLayerTypes<OutputDataType, CustomLayers...> >& Model()
   {
     if (model)
     {
@@ -188,19 +191,19 @@ class AddMerge
   bool ownsLayer;
 
   //! Locally-stored network modules.
-  std::vector<LayerTypes<CustomLayers...> > network;
+  std::vector<TypedLayerTypes<OutputDataType, CustomLayers...> > network;
 
   //! Locally-stored empty list of modules.
-  std::vector<LayerTypes<CustomLayers...> > empty;
+  std::vector<TypedLayerTypes<OutputDataType, CustomLayers...> > empty;
 
   //! Locally-stored delete visitor module object.
   DeleteVisitor deleteVisitor;
 
   //! Locally-stored output parameter visitor module object.
-  OutputParameterVisitor outputParameterVisitor;
+  OutputParameterVisitor<OutputDataType> outputParameterVisitor;
 
   //! Locally-stored delta visitor module object.
-  DeltaVisitor deltaVisitor;
+  DeltaVisitor<OutputDataType> deltaVisitor;
 
   //! Locally-stored delta object.
   OutputDataType delta;
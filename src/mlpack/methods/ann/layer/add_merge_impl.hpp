@@ -53,8 +53,8 @@ void AddMerge<InputDataType, OutputDataType, CustomLayers...>::Forward(
   {
     for (size_t i = 0; i < network.size(); ++i)
     {
-      boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
-          boost::apply_visitor(outputParameterVisitor, network[i]))),
+      boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(input),
+          std::move(boost::apply_visitor(outputParameterVisitor, network[i]))),
           network[i]);
     }
   }
@@ -76,9 +76,10 @@ void AddMerge<InputDataType, OutputDataType, CustomLayers...>::Backward(
   {
     for (size_t i = 0; i < network.size(); ++i)
     {
-      boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-          outputParameterVisitor, network[i])), std::move(gy), std::move(
-          boost::apply_visitor(deltaVisitor, network[i]))), network[i]);
+      boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+          boost::apply_visitor(outputParameterVisitor, network[i])), std::move(
+          gy), std::move(boost::apply_visitor(deltaVisitor, network[i]))),
+          network[i]);
     }
 
     g = boost::apply_visitor(deltaVisitor, network[0]);
@@ -98,9 +99,10 @@ void AddMerge<InputDataType, OutputDataType, CustomLayers...>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g,
     const size_t index)
 {
-  boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-      outputParameterVisitor, network[index])), std::move(gy), std::move(
-      boost::apply_visitor(deltaVisitor, network[index]))), network[index]);
+  boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+      boost::apply_visitor(outputParameterVisitor, network[index])), std::move(
+      gy), std::move(boost::apply_visitor(deltaVisitor, network[index]))),
+      network[index]);
   g = boost::apply_visitor(deltaVisitor, network[index]);
 }
 
@@ -116,8 +118,8 @@ void AddMerge<InputDataType, OutputDataType, CustomLayers...>::Gradient(
   {
     for (size_t i = 0; i < network.size(); ++i)
     {
-      boost::apply_visitor(GradientVisitor(std::move(input), std::move(error)),
-          network[i]);
+      boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(input),
+          std::move(error)), network[i]);
     }
   }
 }
@@ -131,8 +133,8 @@ void AddMerge<InputDataType, OutputDataType, CustomLayers...>::Gradient(
     arma::Mat<eT>&& /* gradient */,
     const size_t index)
 {
-  boost::apply_visitor(GradientVisitor(std::move(input), std::move(error)),
-      network[index]);
+  boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(input),
+      std::move(error)), network[index]);
 }
 
 template<typename InputDataType, typename OutputDataType,
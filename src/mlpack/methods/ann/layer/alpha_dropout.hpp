@@ -18,6 +18,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "dropout_mask.hpp"
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -107,8 +109,13 @@ class AlphaDropout
   //! Value of alphaDash.
   double AlphaDash() const {return alphaDash; }
 
-  //! Get the mask.
-  OutputDataType const& Mask() const {return mask;}
+  //! Get the mask of the last forward pass, as zeros and ones.
+  OutputDataType Mask() const
+  {
+    OutputDataType denseMask;
+    mask.Mask(denseMask);
+    return denseMask;
+  }
 
   //! Modify the probability of setting a value to alphaDash. As
   //! 'a' and 'b' depend on 'ratio', modify them as well.
@@ -132,8 +139,8 @@ class AlphaDropout
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored mast object.
-  OutputDataType mask;
+  //! Locally-stored mask object.
+  DropoutMask mask;
 
   //! The probability of setting a value to aplhaDash.
   double ratio;
@@ -49,9 +49,8 @@ void AlphaDropout<InputDataType, OutputDataType>::Forward(
     // Set values to alphaDash with probability ratio.  Then apply affine
     // transformation so as to keep mean and variance of outputs to their
     // original values.
-    mask = arma::randu< arma::Mat<eT> >(input.n_rows, input.n_cols);
-    mask.transform( [&](double val) { return (val > ratio); } );
-    output = (input % mask + alphaDash * (1 - mask)) * a + b;
+    mask.Generate(input.n_rows, input.n_cols, ratio);
+    mask.Apply(input, output, a, b, alphaDash * a + b);
   }
 }
 
@@ -60,7 +59,7 @@ template<typename eT>
 void AlphaDropout<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  g = gy % mask * a;
+  mask.Apply(gy, g, a);
 }
 
 template<typename InputDataType, typename OutputDataType>
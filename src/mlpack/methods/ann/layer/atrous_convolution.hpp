@@ -19,6 +19,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include "layer_types.hpp"
 
@@ -32,6 +33,10 @@ namespace ann /** Artificial Neural Network. */ {
  * spaces included between the kernel cells, in order to capture a larger
  * field of reception, without having to increase dicrete kernel sizes.
  *
+ * If Im2ColConvolution rules are used, the input maps of each image are lowered
+ * to a matrix, and each pass is computed for all of the maps of an image with a
+ * single matrix product; see Im2ColConvolution.
+ *
  * @tparam ForwardConvolutionRule Atrous Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Atrous Convolution to perform backward process.
  * @tparam GradientConvolutionRule Atrous Convolution to calculate gradient.
@@ -237,7 +242,8 @@ class AtrousConvolution
     if (output.n_rows != input.n_rows + wPad * 2 ||
         output.n_cols != input.n_cols + hPad * 2)
     {
-      output = arma::zeros(input.n_rows + wPad * 2, input.n_cols + hPad * 2);
+      output = arma::zeros<arma::Mat<eT> >(input.n_rows + wPad * 2,
+          input.n_cols + hPad * 2);
     }
 
     output.submat(wPad, hPad, wPad + input.n_rows - 1,
@@ -258,15 +264,27 @@ class AtrousConvolution
            size_t hPad,
            arma::Cube<eT>& output)
   {
-    output = arma::zeros(input.n_rows + wPad * 2,
+    output = arma::zeros<arma::Cube<eT> >(input.n_rows + wPad * 2,
         input.n_cols + hPad * 2, input.n_slices);
 
     for (size_t i = 0; i < input.n_slices; ++i)
     {
-      Pad<double>(input.slice(i), wPad, hPad, output.slice(i));
+      Pad<eT>(input.slice(i), wPad, hPad, output.slice(i));
     }
   }
 
+  //! Whether the forward pass is computed with matrix products.
+  static const bool forwardIm2Col = std::is_same<ForwardConvolutionRule,
+      Im2ColConvolution<ValidConvolution>>::value;
+
+  //! Whether the backward pass is computed with matrix products.
+  static const bool backwardIm2Col = std::is_same<BackwardConvolutionRule,
+      Im2ColConvolution<FullConvolution>>::value;
+
+  //! Whether the gradient is computed with matrix products.
+  static const bool gradientIm2Col = std::is_same<GradientConvolutionRule,
+      Im2ColConvolution<ValidConvolution>>::value;
+
   //! Locally-stored number of input channels.
   size_t inSize;
 
@@ -298,10 +316,10 @@ class AtrousConvolution
   OutputDataType weights;
 
   //! Locally-stored weight object.
-  arma::cube weight;
+  arma::Cube<typename OutputDataType::elem_type> weight;
 
   //! Locally-stored bias term object.
-  arma::mat bias;
+  OutputDataType bias;
 
   //! Locally-stored input width.
   size_t inputWidth;
@@ -322,19 +340,19 @@ class AtrousConvolution
   size_t dilationH;
 
   //! Locally-stored transformed output parameter.
-  arma::cube outputTemp;
+  arma::Cube<typename OutputDataType::elem_type> outputTemp;
 
   //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
+  arma::Cube<typename OutputDataType::elem_type> inputTemp;
 
   //! Locally-stored transformed padded input parameter.
-  arma::cube inputPaddedTemp;
+  arma::Cube<typename OutputDataType::elem_type> inputPaddedTemp;
 
   //! Locally-stored transformed error parameter.
-  arma::cube gTemp;
+  arma::Cube<typename OutputDataType::elem_type> gTemp;
 
   //! Locally-stored transformed gradient parameter.
-  arma::cube gradientTemp;
+  arma::Cube<typename OutputDataType::elem_type> gradientTemp;
 
   //! Locally-stored delta object.
   OutputDataType delta;
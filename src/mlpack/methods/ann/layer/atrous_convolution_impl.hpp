@@ -96,9 +96,9 @@ void AtrousConvolution<
     OutputDataType
 >::Reset()
 {
-    weight = arma::cube(weights.memptr(), kW, kH,
-        outSize * inSize, false, false);
-    bias = arma::mat(weights.memptr() + weight.n_elem,
+    weight = arma::Cube<typename OutputDataType::elem_type>(weights.memptr(),
+        kW, kH, outSize * inSize, false, false);
+    bias = OutputDataType(weights.memptr() + weight.n_elem,
         outSize, 1, false, false);
 }
 
@@ -119,10 +119,11 @@ void AtrousConvolution<
 >::Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
   batchSize = input.n_cols;
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&&>(input).memptr(),
+  inputTemp = arma::Cube<eT>(const_cast<arma::Mat<eT>&&>(input).memptr(),
       inputWidth, inputHeight, inSize * batchSize, false, false);
 
-  if (padW != 0 || padH != 0)
+  // The padded input is only used by the rules that are not lowered.
+  if ((padW != 0 || padH != 0) && !(forwardIm2Col && gradientIm2Col))
   {
     Pad(inputTemp, padW, padH, inputPaddedTemp);
   }
@@ -133,38 +134,62 @@ void AtrousConvolution<
   output.set_size(wConv * hConv * outSize, batchSize);
   outputTemp = arma::Cube<eT>(output.memptr(), wConv, hConv,
       outSize * batchSize, false, false);
-  outputTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  if (forwardIm2Col)
   {
-    if (outMap != 0 && outMap % outSize == 0)
+    // Lower the input maps of each image, so that all of its output maps are
+    // computed with one matrix product; the filters of each output map are
+    // the columns of the weights.  The padding is applied while lowering.
+    const arma::Mat<eT> weightMatrix(weights.memptr(), kW * kH * inSize,
+        outSize, false, true);
+    arma::Mat<eT> columns;
+    for (size_t b = 0; b < batchSize; ++b)
     {
-      batchCount++;
-      outMapIdx = 0;
+      Im2ColConvolution<ValidConvolution>::Im2Col(inputTemp, b * inSize,
+          inSize, kW, kH, dW, dH, padW, padH, dilationW, dilationH, wConv,
+          hConv, columns);
+
+      arma::Mat<eT> outputMaps(output.colptr(b), wConv * hConv, outSize,
+          false, true);
+      outputMaps = columns * weightMatrix;
+      outputMaps.each_row() += arma::trans(bias);
     }
+  }
+  else
+  {
+    outputTemp.zeros();
 
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+    for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
+        outSize * batchSize; outMap++)
     {
-      arma::Mat<eT> convOutput;
-
-      if (padW != 0 || padH != 0)
+      if (outMap != 0 && outMap % outSize == 0)
       {
-        ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
-            dilationW, dilationH);
+        batchCount++;
+        outMapIdx = 0;
       }
-      else
+
+      for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
       {
-        ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
-            batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
-            dilationW, dilationH);
+        arma::Mat<eT> convOutput;
+
+        if (padW != 0 || padH != 0)
+        {
+          ForwardConvolutionRule::Convolution(inputPaddedTemp.slice(inMap +
+              batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
+              dilationW, dilationH);
+        }
+        else
+        {
+          ForwardConvolutionRule::Convolution(inputTemp.slice(inMap +
+              batchCount * inSize), weight.slice(outMapIdx), convOutput, dW, dH,
+              dilationW, dilationH);
+        }
+
+        outputTemp.slice(outMap) += convOutput;
       }
 
-      outputTemp.slice(outMap) += convOutput;
+      outputTemp.slice(outMap) += bias(outMap % outSize);
     }
-
-    outputTemp.slice(outMap) += bias(outMap % outSize);
   }
 
   outputWidth = outputTemp.n_rows;
@@ -188,7 +213,7 @@ void AtrousConvolution<
 >::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  arma::cube mappedError(gy.memptr(), outputWidth, outputHeight,
+  arma::Cube<eT> mappedError(gy.memptr(), outputWidth, outputHeight,
       outSize * batchSize, false, false);
 
   g.set_size(inputTemp.n_rows * inputTemp.n_cols * inSize, batchSize);
@@ -196,32 +221,54 @@ void AtrousConvolution<
       inputTemp.n_cols, inputTemp.n_slices, false, false);
   gTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  if (backwardIm2Col)
   {
-    if (outMap != 0 && outMap % outSize == 0)
+    // The error of the lowered input of each image is the product of the
+    // error of its output maps with the filters; each element of it is then
+    // added to the element of the input that it was taken from.
+    const arma::Mat<eT> weightMatrix(weights.memptr(), kW * kH * inSize,
+        outSize, false, true);
+    arma::Mat<eT> columns;
+    for (size_t b = 0; b < batchSize; ++b)
     {
-      batchCount++;
-      outMapIdx = 0;
-    }
+      const arma::Mat<eT> errorMaps(gy.colptr(b), outputWidth * outputHeight,
+          outSize, false, true);
+      columns = errorMaps * weightMatrix.t();
 
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+      Im2ColConvolution<ValidConvolution>::Col2Im(columns, b * inSize, inSize,
+          kW, kH, dW, dH, padW, padH, dilationW, dilationH, outputWidth,
+          outputHeight, gTemp);
+    }
+  }
+  else
+  {
+    for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
+        outSize * batchSize; outMap++)
     {
-      arma::Mat<eT> output, rotatedFilter;
-      Rotate180(weight.slice(outMapIdx), rotatedFilter);
-
-      BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
-          rotatedFilter, output, dW, dH, dilationW, dilationH);
-
-      if (padW != 0 || padH != 0)
+      if (outMap != 0 && outMap % outSize == 0)
       {
-        gTemp.slice(inMap + batchCount * inSize) += output.submat(padW, padH,
-            padW + gTemp.n_rows - 1,
-            padH + gTemp.n_cols - 1);
+        batchCount++;
+        outMapIdx = 0;
       }
-      else
+
+      for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
       {
-        gTemp.slice(inMap + batchCount * inSize) += output;
+        arma::Mat<eT> output, rotatedFilter;
+        Rotate180(weight.slice(outMapIdx), rotatedFilter);
+
+        BackwardConvolutionRule::Convolution(mappedError.slice(outMap),
+            rotatedFilter, output, dW, dH, dilationW, dilationH);
+
+        if (padW != 0 || padH != 0)
+        {
+          gTemp.slice(inMap + batchCount * inSize) += output.submat(padW, padH,
+              padW + gTemp.n_rows - 1,
+              padH + gTemp.n_cols - 1);
+        }
+        else
+        {
+          gTemp.slice(inMap + batchCount * inSize) += output;
+        }
       }
     }
   }
@@ -246,7 +293,7 @@ void AtrousConvolution<
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  arma::cube mappedError(error.memptr(), outputWidth, outputHeight,
+  arma::Cube<eT> mappedError(error.memptr(), outputWidth, outputHeight,
       outSize * batchSize, false, false);
 
   gradient.set_size(weights.n_elem, 1);
@@ -254,66 +301,90 @@ void AtrousConvolution<
       weight.n_cols, weight.n_slices, false, false);
   gradientTemp.zeros();
 
-  for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
-      outSize * batchSize; outMap++)
+  if (gradientIm2Col)
   {
-    if (outMap != 0 && outMap % outSize == 0)
+    // The gradient of the filters is the product of the lowered input of
+    // each image with the error of its output maps, summed over the images.
+    arma::Mat<eT> weightGradient(gradient.memptr(), kW * kH * inSize, outSize,
+        false, true);
+    gradient.rows(weight.n_elem, weight.n_elem + outSize - 1).zeros();
+    arma::Mat<eT> columns;
+    for (size_t b = 0; b < batchSize; ++b)
     {
-      batchCount++;
-      outMapIdx = 0;
+      Im2ColConvolution<ValidConvolution>::Im2Col(inputTemp, b * inSize,
+          inSize, kW, kH, dW, dH, padW, padH, dilationW, dilationH,
+          outputWidth, outputHeight, columns);
+
+      const arma::Mat<eT> errorMaps(error.colptr(b),
+          outputWidth * outputHeight, outSize, false, true);
+      weightGradient += columns.t() * errorMaps;
+      gradient.rows(weight.n_elem, weight.n_elem + outSize - 1) +=
+          arma::trans(arma::sum(errorMaps, 0));
     }
-
-    for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
+  }
+  else
+  {
+    for (size_t outMap = 0, outMapIdx = 0, batchCount = 0; outMap <
+        outSize * batchSize; outMap++)
     {
-      arma::Mat<eT> inputSlice;
-      if (padW != 0 || padH != 0)
+      if (outMap != 0 && outMap % outSize == 0)
       {
-        inputSlice = inputPaddedTemp.slice(inMap + batchCount * inSize);
+        batchCount++;
+        outMapIdx = 0;
       }
-      else
+
+      for (size_t inMap = 0; inMap < inSize; inMap++, outMapIdx++)
       {
-        inputSlice = inputTemp.slice(inMap + batchCount * inSize);
-      }
+        arma::Mat<eT> inputSlice;
+        if (padW != 0 || padH != 0)
+        {
+          inputSlice = inputPaddedTemp.slice(inMap + batchCount * inSize);
+        }
+        else
+        {
+          inputSlice = inputTemp.slice(inMap + batchCount * inSize);
+        }
 
-      arma::Mat<eT> deltaSlice = mappedError.slice(outMap);
+        arma::Mat<eT> deltaSlice = mappedError.slice(outMap);
 
-      arma::Mat<eT> output;
-      GradientConvolutionRule::Convolution(inputSlice, deltaSlice,
-          output, dW, dH, 1, 1);
+        arma::Mat<eT> output;
+        GradientConvolutionRule::Convolution(inputSlice, deltaSlice,
+            output, dW, dH, 1, 1);
 
-      if (dilationH > 1)
-      {
-        for (size_t i = 1; i < output.n_cols; i++){
-          output.shed_cols(i, i + dilationH - 2);
+        if (dilationH > 1)
+        {
+          for (size_t i = 1; i < output.n_cols; i++){
+            output.shed_cols(i, i + dilationH - 2);
+          }
         }
-      }
-      if (dilationW > 1)
-      {
-        for (size_t i = 1; i < output.n_rows; i++){
-          output.shed_rows(i, i + dilationW - 2);
+        if (dilationW > 1)
+        {
+          for (size_t i = 1; i < output.n_rows; i++){
+            output.shed_rows(i, i + dilationW - 2);
+          }
         }
-      }
 
-      if (gradientTemp.n_rows < output.n_rows ||
-          gradientTemp.n_cols < output.n_cols)
-      {
-        gradientTemp.slice(outMapIdx) += output.submat(0, 0,
-            gradientTemp.n_rows - 1, gradientTemp.n_cols - 1);
-      }
-      else if (gradientTemp.n_rows > output.n_rows ||
-          gradientTemp.n_cols > output.n_cols)
-      {
-        gradientTemp.slice(outMapIdx).submat(0, 0, output.n_rows - 1,
-            output.n_cols - 1) += output;
-      }
-      else
-      {
-        gradientTemp.slice(outMapIdx) += output;
+        if (gradientTemp.n_rows < output.n_rows ||
+            gradientTemp.n_cols < output.n_cols)
+        {
+          gradientTemp.slice(outMapIdx) += output.submat(0, 0,
+              gradientTemp.n_rows - 1, gradientTemp.n_cols - 1);
+        }
+        else if (gradientTemp.n_rows > output.n_rows ||
+            gradientTemp.n_cols > output.n_cols)
+        {
+          gradientTemp.slice(outMapIdx).submat(0, 0, output.n_rows - 1,
+              output.n_cols - 1) += output;
+        }
+        else
+        {
+          gradientTemp.slice(outMapIdx) += output;
+        }
       }
-    }
 
-    gradient.submat(weight.n_elem + (outMap % outSize), 0, weight.n_elem +
-        (outMap % outSize), 0) = arma::accu(mappedError.slice(outMap));
+      gradient.submat(weight.n_elem + (outMap % outSize), 0, weight.n_elem +
+          (outMap % outSize), 0) = arma::accu(mappedError.slice(outMap));
+    }
   }
 }
 
@@ -132,6 +132,9 @@ class BatchNorm
   //! Modify the value of deterministic parameter.
   bool& Deterministic() { return deterministic; }
 
+  //! Get the value used for numerical stability.
+  double Epsilon() const { return eps; }
+
   //! Get the mean over the training data.
   OutputDataType TrainingMean() { return runningMean; }
 
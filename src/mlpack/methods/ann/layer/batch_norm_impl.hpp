@@ -46,8 +46,8 @@ BatchNorm<InputDataType, OutputDataType>::BatchNorm(
 template<typename InputDataType, typename OutputDataType>
 void BatchNorm<InputDataType, OutputDataType>::Reset()
 {
-  gamma = arma::mat(weights.memptr(), size, 1, false, false);
-  beta = arma::mat(weights.memptr() + gamma.n_elem, size, 1, false, false);
+  gamma = OutputDataType(weights.memptr(), size, 1, false, false);
+  beta = OutputDataType(weights.memptr() + gamma.n_elem, size, 1, false, false);
 
   if (!loading)
   {
@@ -106,14 +106,14 @@ template<typename eT>
 void BatchNorm<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  const arma::mat inputMean = input.each_col() - mean;
-  const arma::mat stdInv = 1.0 / arma::sqrt(variance + eps);
+  const arma::Mat<eT> inputMean = input.each_col() - mean;
+  const arma::Mat<eT> stdInv = 1.0 / arma::sqrt(variance + eps);
 
   // Step 1: dl / dxhat
-  const arma::mat norm = gy.each_col() % gamma;
+  const arma::Mat<eT> norm = gy.each_col() % gamma;
 
   // Step 2: sum dl / dxhat * (x - mu) * -0.5 * stdInv^3.
-  const arma::mat var = arma::sum(norm % inputMean, 1) %
+  const arma::Mat<eT> var = arma::sum(norm % inputMean, 1) %
       arma::pow(stdInv, 3.0) * -0.5;
 
   // Step 4: dl / dxhat * 1 / stdInv + variance * 2 * (x - mu) / m +
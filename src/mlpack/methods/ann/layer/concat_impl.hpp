@@ -47,19 +47,29 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Forward(
 {
   if (run)
   {
-    for (size_t i = 0; i < network.size(); ++i)
+    // The modules only share the input, and each one writes its own output,
+    // so they are evaluated in parallel.
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (omp_size_t i = 0; i < (omp_size_t) network.size(); ++i)
     {
-      boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
-          boost::apply_visitor(outputParameterVisitor, network[i]))),
+      boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(input),
+          std::move(boost::apply_visitor(outputParameterVisitor, network[i]))),
           network[i]);
     }
   }
+
   // Vertically concatentate output from each layer.
-  output = boost::apply_visitor(outputParameterVisitor, network.front());
-  for (size_t i = 1; i < network.size(); ++i)
+  std::vector<size_t> offsets;
+  RowOffsets(offsets);
+  output.set_size(offsets.back(), boost::apply_visitor(outputParameterVisitor,
+      network.front()).n_cols);
+  for (size_t i = 0; i < network.size(); ++i)
   {
-    output = arma::join_cols(output,
-        boost::apply_visitor(outputParameterVisitor, network[i]));
+    if (offsets[i + 1] > offsets[i])
+    {
+      output.rows(offsets[i], offsets[i + 1] - 1) =
+          boost::apply_visitor(outputParameterVisitor, network[i]);
+    }
   }
 }
 
@@ -69,21 +79,20 @@ template<typename eT>
 void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  size_t rowCount = 0;
   if (run)
   {
-    arma::mat delta;
-    for (size_t i = 0; i < network.size(); ++i)
+    std::vector<size_t> offsets;
+    RowOffsets(offsets);
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (omp_size_t i = 0; i < (omp_size_t) network.size(); ++i)
     {
       // Use rows from the error corresponding to the output from each layer.
-      size_t rows = boost::apply_visitor(
-          outputParameterVisitor, network[i]).n_rows;
-      delta = gy.rows(rowCount, rowCount + rows - 1);
-      boost::apply_visitor(BackwardVisitor(std::move(
+      arma::Mat<eT> delta = gy.rows(offsets[i], offsets[i + 1] - 1);
+      boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
           boost::apply_visitor(outputParameterVisitor,
           network[i])), std::move(delta), std::move(
           boost::apply_visitor(deltaVisitor, network[i]))), network[i]);
-      rowCount += rows;
     }
 
     g = boost::apply_visitor(deltaVisitor, network[0]);
@@ -111,10 +120,11 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Backward(
     rowCount += boost::apply_visitor(outputParameterVisitor, network[i]).n_rows;
   }
   rows = boost::apply_visitor(outputParameterVisitor, network[index]).n_rows;
-  arma::mat delta = gy.rows(rowCount, rowCount + rows - 1);
-  boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-      outputParameterVisitor, network[index])), std::move(delta), std::move(
-      boost::apply_visitor(deltaVisitor, network[index]))), network[index]);
+  arma::Mat<eT> delta = gy.rows(rowCount, rowCount + rows - 1);
+  boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+      boost::apply_visitor(outputParameterVisitor, network[index])), std::move(
+      delta), std::move(boost::apply_visitor(deltaVisitor, network[index]))),
+      network[index]);
 
   g = boost::apply_visitor(deltaVisitor, network[index]);
 }
@@ -129,18 +139,32 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Gradient(
 {
   if (run)
   {
-    size_t rowCount = 0;
-    for (size_t i = 0; i < network.size(); ++i)
+    std::vector<size_t> offsets;
+    RowOffsets(offsets);
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (omp_size_t i = 0; i < (omp_size_t) network.size(); ++i)
     {
-      size_t rows = boost::apply_visitor(
-          outputParameterVisitor, network[i]).n_rows;
-      boost::apply_visitor(GradientVisitor(std::move(input),
-          std::move(error.rows(rowCount, rowCount + rows - 1))), network[i]);
-      rowCount += rows;
+      boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(input),
+          std::move(error.rows(offsets[i], offsets[i + 1] - 1))), network[i]);
     }
   }
 }
 
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+void Concat<InputDataType, OutputDataType, CustomLayers...>::RowOffsets(
+    std::vector<size_t>& offsets)
+{
+  offsets.resize(network.size() + 1);
+  offsets[0] = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    offsets[i + 1] = offsets[i] + boost::apply_visitor(outputParameterVisitor,
+        network[i]).n_rows;
+  }
+}
+
 template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 template<typename eT>
@@ -157,7 +181,7 @@ void Concat<InputDataType, OutputDataType, CustomLayers...>::Gradient(
   }
   size_t rows = boost::apply_visitor(
       outputParameterVisitor, network[index]).n_rows;
-  boost::apply_visitor(GradientVisitor(std::move(input),
+  boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(input),
       std::move(error.rows(rowCount, rowCount + rows - 1))), network[index]);
 }
 
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "dropout_mask.hpp"
 #include "layer_types.hpp"
 #include "add_merge.hpp"
 #include "linear.hpp"
@@ -113,7 +114,7 @@ class DropConnect
                 arma::Mat<eT>&& /* gradient */);
 
   //! Get the model modules.
-  std::vector<LayerTypes<> >& Model() { return network; }
+  std::vector<TypedLayerTypes<OutputDataType> >& Model() { return network; }
 
   //! Get the parameters.
   OutputDataType const& Parameters() const { return parameters; }
@@ -177,7 +178,7 @@ class DropConnect
   OutputDataType outputParameter;
 
   //! Locally-stored mask object.
-  OutputDataType mask;
+  DropoutMask mask;
 
   //! If true dropout and scaling is disabled, see notes above.
   bool deterministic;
@@ -186,10 +187,10 @@ class DropConnect
   OutputDataType denoise;
 
   //! Locally-stored layer module.
-  LayerTypes<> baseLayer;
+  TypedLayerTypes<OutputDataType> baseLayer;
 
   //! Locally-stored network modules.
-  std::vector<LayerTypes<> > network;
+  std::vector<TypedLayerTypes<OutputDataType> > network;
 }; // class DropConnect.
 
 }  // namespace ann
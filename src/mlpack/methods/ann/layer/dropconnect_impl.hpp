@@ -64,24 +64,26 @@ void DropConnect<InputDataType, OutputDataType>::Forward(
   // (during testing).
   if (deterministic)
   {
-    boost::apply_visitor(ForwardVisitor(std::move(input), std::move(output)),
-        baseLayer);
+    boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(input),
+        std::move(output)), baseLayer);
   }
   else
   {
     // Save weights for denoising.
-    boost::apply_visitor(ParametersVisitor(std::move(denoise)), baseLayer);
+    boost::apply_visitor(ParametersVisitor<OutputDataType>(std::move(denoise)),
+        baseLayer);
 
     // Scale with input / (1 - ratio) and set values to zero with
     // probability ratio.
-    mask = arma::randu<arma::Mat<eT> >(denoise.n_rows, denoise.n_cols);
-    mask.transform([&](double val) { return (val > ratio); });
+    mask.Generate(denoise.n_rows, denoise.n_cols, ratio);
+    OutputDataType maskedWeights;
+    mask.Apply(denoise, maskedWeights, 1.0);
 
-    boost::apply_visitor(ParametersSetVisitor(std::move(denoise % mask)),
-        baseLayer);
+    boost::apply_visitor(ParametersSetVisitor<OutputDataType>(
+        std::move(maskedWeights)), baseLayer);
 
-    boost::apply_visitor(ForwardVisitor(std::move(input), std::move(output)),
-        baseLayer);
+    boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(input),
+        std::move(output)), baseLayer);
 
     output = output * scale;
   }
@@ -94,8 +96,8 @@ void DropConnect<InputDataType, OutputDataType>::Backward(
     arma::Mat<eT>&& gy,
     arma::Mat<eT>&& g)
 {
-  boost::apply_visitor(BackwardVisitor(std::move(input), std::move(gy),
-      std::move(g)), baseLayer);
+  boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(input),
+      std::move(gy), std::move(g)), baseLayer);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -105,11 +107,12 @@ void DropConnect<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& /* gradient */)
 {
-  boost::apply_visitor(GradientVisitor(std::move(input), std::move(error)),
-      baseLayer);
+  boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(input),
+      std::move(error)), baseLayer);
 
   // Denoise the weights.
-  boost::apply_visitor(ParametersSetVisitor(std::move(denoise)), baseLayer);
+  boost::apply_visitor(ParametersSetVisitor<OutputDataType>(std::move(denoise)),
+      baseLayer);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -15,6 +15,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "dropout_mask.hpp"
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -118,8 +120,8 @@ class Dropout
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored mast object.
-  OutputDataType mask;
+  //! Locally-stored mask object.
+  DropoutMask mask;
 
   //! The probability of setting a value to zero.
   double ratio;
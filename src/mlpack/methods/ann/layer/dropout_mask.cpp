@@ -0,0 +1,59 @@
+/**
+ * @file dropout_mask.cpp
+ *
+ * Implementation of the generation of DropoutMask.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "dropout_mask.hpp"
+
+#include <mlpack/core/math/random.hpp>
+
+using namespace mlpack;
+using namespace mlpack::ann;
+
+//! The SplitMix64 finalizer, a bijective hash of 64-bit counters.
+static inline uint64_t Mix(uint64_t z)
+{
+  z += 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
+}
+
+void DropoutMask::Generate(const size_t rows,
+                           const size_t cols,
+                           const double ratio)
+{
+  this->rows = rows;
+  this->cols = cols;
+
+  std::mt19937& generator = math::ThreadGenerator();
+  const uint64_t seed = ((uint64_t) generator() << 32) ^ generator();
+
+  // An element is kept if its 32-bit uniform value is at least the threshold,
+  // so with probability 1 - ratio.
+  const double scaledRatio = std::min(std::max(ratio, 0.0), 1.0) *
+      4294967296.0;
+  const uint64_t threshold = (uint64_t) scaledRatio;
+
+  const size_t numElements = rows * cols;
+  const size_t numWords = (numElements + 63) / 64;
+  bits.resize(numWords);
+
+  #pragma omp parallel for if (numWords >= 4096)
+  for (omp_size_t w = 0; w < (omp_size_t) numWords; ++w)
+  {
+    uint64_t word = 0;
+    for (size_t j = 0; j < 64; j += 2)
+    {
+      const uint64_t r = Mix(seed + 32 * (uint64_t) w + j / 2);
+      word |= (uint64_t) ((r & 0xFFFFFFFFULL) >= threshold) << j;
+      word |= (uint64_t) ((r >> 32) >= threshold) << (j + 1);
+    }
+    bits[w] = word;
+  }
+}
@@ -0,0 +1,92 @@
+/**
+ * @file dropout_mask.hpp
+ *
+ * Definition of the DropoutMask class, a bit mask of the units kept by the
+ * dropout layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_DROPOUT_MASK_HPP
+#define MLPACK_METHODS_ANN_LAYER_DROPOUT_MASK_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The DropoutMask class holds one bit per element of a matrix, set if the
+ * element is kept by a dropout layer, instead of a dense matrix of zeros and
+ * ones.  The mask is generated with a counter-based generator: each pair of
+ * elements gets two 32-bit uniform values from a hash of a per-mask seed and
+ * its index, so words of the mask can be generated independently (in
+ * parallel, for large masks) and the mask only depends on the seed, which is
+ * drawn from the random generator of the calling thread.  Apply() then
+ * computes the masked and scaled (and possibly shifted) matrix in a single
+ * pass, and is used in the forward and in the backward pass.
+ */
+class DropoutMask
+{
+ public:
+  //! Create an empty mask.
+  DropoutMask() : rows(0), cols(0) { }
+
+  /**
+   * Generate a new mask of the given size, where each element is dropped
+   * with the given probability.
+   *
+   * @param rows Number of rows of the masked matrices.
+   * @param cols Number of columns of the masked matrices.
+   * @param ratio The probability of dropping an element.
+   */
+  void Generate(const size_t rows, const size_t cols, const double ratio);
+
+  //! Get whether the given element (in column-major order) is kept.
+  bool Kept(const size_t i) const { return (bits[i / 64] >> (i % 64)) & 1; }
+
+  /**
+   * Set output to input * scale + shift for the kept elements, and to
+   * droppedValue for the others.  The input must have the size of the mask;
+   * the output may be the input.
+   *
+   * @param input Matrix to mask.
+   * @param output Masked matrix.
+   * @param scale Scale of the kept elements.
+   * @param shift Shift of the kept elements.
+   * @param droppedValue Value of the dropped elements.
+   */
+  template<typename eT>
+  void Apply(const arma::Mat<eT>& input,
+             arma::Mat<eT>& output,
+             const double scale,
+             const double shift = 0.0,
+             const double droppedValue = 0.0) const;
+
+  //! Store the mask as a dense matrix of zeros and ones.
+  template<typename MatType>
+  void Mask(MatType& mask) const;
+
+  //! Get the number of rows of the mask.
+  size_t Rows() const { return rows; }
+  //! Get the number of columns of the mask.
+  size_t Cols() const { return cols; }
+
+ private:
+  //! Number of rows of the mask.
+  size_t rows;
+  //! Number of columns of the mask.
+  size_t cols;
+  //! The bits of the mask, 64 elements per word.
+  std::vector<uint64_t> bits;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "dropout_mask_impl.hpp"
+
+#endif
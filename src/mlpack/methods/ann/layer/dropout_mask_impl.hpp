@@ -0,0 +1,55 @@
+/**
+ * @file dropout_mask_impl.hpp
+ *
+ * Implementation of the templated functions of the DropoutMask class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_DROPOUT_MASK_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_DROPOUT_MASK_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "dropout_mask.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename eT>
+void DropoutMask::Apply(const arma::Mat<eT>& input,
+                        arma::Mat<eT>& output,
+                        const double scale,
+                        const double shift,
+                        const double droppedValue) const
+{
+  output.set_size(input.n_rows, input.n_cols);
+
+  const eT s = (eT) scale;
+  const eT t = (eT) shift;
+  const eT dropped = (eT) droppedValue;
+  const eT* in = input.memptr();
+  eT* out = output.memptr();
+  for (size_t w = 0; w < bits.size(); ++w)
+  {
+    const uint64_t word = bits[w];
+    const size_t begin = 64 * w;
+    const size_t end = std::min(begin + 64, (size_t) input.n_elem);
+    for (size_t i = begin; i < end; ++i)
+      out[i] = ((word >> (i - begin)) & 1) ? in[i] * s + t : dropped;
+  }
+}
+
+template<typename MatType>
+void DropoutMask::Mask(MatType& mask) const
+{
+  mask.set_size(rows, cols);
+  for (size_t i = 0; i < mask.n_elem; ++i)
+    mask[i] = Kept(i) ? 1 : 0;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -243,7 +243,7 @@ class ELU
   OutputDataType outputParameter;
 
   //! Locally stored first derivative of the activation function.
-  arma::mat derivative;
+  OutputDataType derivative;
 
   //! ELU Hyperparameter (0 < alpha)
   //! SELU parameter fixed to 1.6732632423543774 for normalized inputs.
@@ -139,7 +139,7 @@ class Glimpse
 
   //! Set the locationthe x and y coordinate of the center of the output
   //! glimpse.
-  void Location(const arma::mat& location)
+  void Location(const OutputDataType& location)
   {
     this->location = location;
   }
@@ -181,9 +181,10 @@ class Glimpse
    *
    * @param w The input matrix used to perform the transformation.
    */
-  void Transform(arma::mat& w)
+  template<typename eT>
+  void Transform(arma::Mat<eT>& w)
   {
-    arma::mat t = w;
+    arma::Mat<eT> t = w;
 
     for (size_t i = 0, k = 0; i < w.n_elem; k++)
     {
@@ -199,11 +200,12 @@ class Glimpse
    *
    * @param w The input matrix used to perform the transformation.
    */
-  void Transform(arma::cube& w)
+  template<typename eT>
+  void Transform(arma::Cube<eT>& w)
   {
     for (size_t i = 0; i < w.n_slices; i++)
     {
-      arma::mat t = w.slice(i);
+      arma::Mat<eT> t = w.slice(i);
       Transform(t);
       w.slice(i) = t;
     }
@@ -395,22 +397,22 @@ class Glimpse
   size_t inputDepth;
 
   //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
+  arma::Cube<typename OutputDataType::elem_type> inputTemp;
 
   //! Locally-stored transformed output parameter.
-  arma::cube outputTemp;
+  arma::Cube<typename OutputDataType::elem_type> outputTemp;
 
   //! The x and y coordinate of the center of the output glimpse.
-  arma::mat location;
+  OutputDataType location;
 
   //! Locally-stored object to perform the mean pooling operation.
   MeanPoolingRule pooling;
 
   //! Location-stored module location parameter.
-  std::vector<arma::mat> locationParameter;
+  std::vector<OutputDataType> locationParameter;
 
   //! Location-stored transformed gradient paramter.
-  arma::cube gTemp;
+  arma::Cube<typename OutputDataType::elem_type> gTemp;
 
   //! If true use maximum a posteriori during the forward pass.
   bool deterministic;
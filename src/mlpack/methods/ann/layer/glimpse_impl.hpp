@@ -47,7 +47,7 @@ template<typename eT>
 void Glimpse<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
-  inputTemp = arma::cube(input.colptr(0), inputWidth, inputHeight, inSize);
+  inputTemp = arma::Cube<eT>(input.colptr(0), inputWidth, inputHeight, inSize);
   outputTemp = arma::Cube<eT>(size, size, depth * inputTemp.n_slices);
 
   location = input.submat(0, 1, 1, 1);
@@ -132,7 +132,7 @@ void Glimpse<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
   // Generate a cube using the backpropagated error matrix.
-  arma::Cube<eT> mappedError = arma::zeros<arma::cube>(outputWidth,
+  arma::Cube<eT> mappedError = arma::zeros<arma::Cube<eT> >(outputWidth,
       outputHeight, 1);
 
   location = locationParameter.back();
@@ -147,7 +147,7 @@ void Glimpse<InputDataType, OutputDataType>::Backward(
     }
   }
 
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows, inputTemp.n_cols,
+  gTemp = arma::zeros<arma::Cube<eT> >(inputTemp.n_rows, inputTemp.n_cols,
       inputTemp.n_slices);
 
   for (size_t inputIdx = 0; inputIdx < inSize; inputIdx++)
@@ -211,7 +211,7 @@ void Glimpse<InputDataType, OutputDataType>::Backward(
   }
 
   Transform(gTemp);
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem, 1);
+  g = arma::Mat<eT>(gTemp.memptr(), gTemp.n_elem, 1);
 }
 
 template<typename InputDataType, typename OutputDataType>
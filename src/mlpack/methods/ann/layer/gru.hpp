@@ -151,7 +151,7 @@ class GRU
   OutputDataType& Gradient() { return gradient; }
 
   //! Get the model modules.
-  std::vector<LayerTypes<> >& Model() { return network; }
+  std::vector<TypedLayerTypes<OutputDataType> >& Model() { return network; }
 
   /**
    * Serialize the layer
@@ -176,34 +176,34 @@ class GRU
   OutputDataType weights;
 
   //! Locally-stored input 2 gate module.
-  LayerTypes<> input2GateModule;
+  TypedLayerTypes<OutputDataType> input2GateModule;
 
   //! Locally-stored output 2 gate module.
-  LayerTypes<> output2GateModule;
+  TypedLayerTypes<OutputDataType> output2GateModule;
 
   //! Locally-stored output hidden state 2 gate module.
-  LayerTypes<> outputHidden2GateModule;
+  TypedLayerTypes<OutputDataType> outputHidden2GateModule;
 
   //! Locally-stored input gate module.
-  LayerTypes<> inputGateModule;
+  TypedLayerTypes<OutputDataType> inputGateModule;
 
   //! Locally-stored hidden state module.
-  LayerTypes<> hiddenStateModule;
+  TypedLayerTypes<OutputDataType> hiddenStateModule;
 
   //! Locally-stored forget gate module.
-  LayerTypes<> forgetGateModule;
+  TypedLayerTypes<OutputDataType> forgetGateModule;
 
   //! Locally-stored output parameter visitor.
-  OutputParameterVisitor outputParameterVisitor;
+  OutputParameterVisitor<OutputDataType> outputParameterVisitor;
 
   //! Locally-stored delta visitor.
-  DeltaVisitor deltaVisitor;
+  DeltaVisitor<OutputDataType> deltaVisitor;
 
   //! Locally-stored delete visitor.
   DeleteVisitor deleteVisitor;
 
   //! Locally-stored list of network modules.
-  std::vector<LayerTypes<> > network;
+  std::vector<TypedLayerTypes<OutputDataType> > network;
 
   //! Locally-stored number of forward steps.
   size_t forwardStep;
@@ -215,22 +215,22 @@ class GRU
   size_t gradientStep;
 
   //! Locally-stored output parameters.
-  std::list<arma::mat> outParameter;
+  std::list<OutputDataType> outParameter;
 
   //! Matrix of all zeroes to initialize the output
-  arma::mat allZeros;
+  OutputDataType allZeros;
 
   //! Iterator pointed to the last output produced by the cell
-  std::list<arma::mat>::iterator prevOutput;
+  std::list<OutputDataType>::iterator prevOutput;
 
   //! Iterator pointed to the last output processed by backward
-  std::list<arma::mat>::iterator backIterator;
+  std::list<OutputDataType>::iterator backIterator;
 
   //! Iterator pointed to the last output processed by gradient
-  std::list<arma::mat>::iterator gradIterator;
+  std::list<OutputDataType>::iterator gradIterator;
 
   //! Locally-stored previous error.
-  arma::mat prevError;
+  OutputDataType prevError;
 
   //! If true dropout and scaling is disabled, see notes above.
   bool deterministic;
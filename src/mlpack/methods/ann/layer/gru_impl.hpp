@@ -44,31 +44,34 @@ GRU<InputDataType, OutputDataType>::GRU(
     deterministic(false)
 {
   // Input specific linear layers(for zt, rt, ot).
-  input2GateModule = new Linear<>(inSize, 3 * outSize);
+  input2GateModule = new Linear<InputDataType, OutputDataType>(inSize,
+      3 * outSize);
 
   // Previous output gates (for zt and rt).
-  output2GateModule = new LinearNoBias<>(outSize, 2 * outSize);
+  output2GateModule = new LinearNoBias<InputDataType, OutputDataType>(outSize,
+      2 * outSize);
 
   // Previous output gate for ot.
-  outputHidden2GateModule = new LinearNoBias<>(outSize, outSize);
+  outputHidden2GateModule = new LinearNoBias<InputDataType, OutputDataType>(
+      outSize, outSize);
 
   network.push_back(input2GateModule);
   network.push_back(output2GateModule);
   network.push_back(outputHidden2GateModule);
 
-  inputGateModule = new SigmoidLayer<>();
-  forgetGateModule = new SigmoidLayer<>();
-  hiddenStateModule = new TanHLayer<>();
+  inputGateModule = new SigmoidLayer<InputDataType, OutputDataType>();
+  forgetGateModule = new SigmoidLayer<InputDataType, OutputDataType>();
+  hiddenStateModule = new TanHLayer<InputDataType, OutputDataType>();
 
   network.push_back(inputGateModule);
   network.push_back(hiddenStateModule);
   network.push_back(forgetGateModule);
 
-  prevError = arma::zeros<arma::mat>(3 * outSize, batchSize);
+  prevError = arma::zeros<OutputDataType>(3 * outSize, batchSize);
 
-  allZeros = arma::zeros<arma::mat>(outSize, batchSize);
+  allZeros = arma::zeros<OutputDataType>(outSize, batchSize);
 
-  outParameter.push_back(std::move(arma::mat(allZeros.memptr(),
+  outParameter.push_back(std::move(OutputDataType(allZeros.memptr(),
       allZeros.n_rows, allZeros.n_cols, false, true)));
 
   prevOutput = outParameter.begin();
@@ -105,7 +108,7 @@ void GRU<InputDataType, OutputDataType>::Forward(
     }
 
     outParameter.clear();
-    outParameter.push_back(std::move(arma::mat(allZeros.memptr(),
+    outParameter.push_back(std::move(OutputDataType(allZeros.memptr(),
         allZeros.n_rows, allZeros.n_cols, false, true)));
 
     prevOutput = outParameter.begin();
@@ -114,14 +117,14 @@ void GRU<InputDataType, OutputDataType>::Forward(
   }
 
   // Process the input linearly(zt, rt, ot).
-  boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
-      boost::apply_visitor(outputParameterVisitor, input2GateModule))),
-      input2GateModule);
+  boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(input),
+      std::move(boost::apply_visitor(outputParameterVisitor,
+      input2GateModule))), input2GateModule);
 
   // Process the output(zt, rt) linearly.
-  boost::apply_visitor(ForwardVisitor(std::move(*prevOutput), std::move(
-      boost::apply_visitor(outputParameterVisitor, output2GateModule))),
-      output2GateModule);
+  boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(*prevOutput),
+      std::move(boost::apply_visitor(outputParameterVisitor,
+      output2GateModule))), output2GateModule);
 
   // Merge the outputs(zt and rt).
   output = (boost::apply_visitor(outputParameterVisitor,
@@ -129,33 +132,33 @@ void GRU<InputDataType, OutputDataType>::Forward(
       boost::apply_visitor(outputParameterVisitor, output2GateModule));
 
   // Pass the first outSize through inputGate(it).
-  boost::apply_visitor(ForwardVisitor(std::move(output.submat(
+  boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(output.submat(
       0, 0, 1 * outSize - 1, batchSize - 1)), std::move(boost::apply_visitor(
       outputParameterVisitor, inputGateModule))), inputGateModule);
 
   // Pass the second through forgetGate.
-  boost::apply_visitor(ForwardVisitor(std::move(output.submat(
+  boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(output.submat(
       1 * outSize, 0, 2 * outSize - 1, batchSize - 1)), std::move(
       boost::apply_visitor(outputParameterVisitor, forgetGateModule))),
       forgetGateModule);
 
-  arma::mat modInput = (boost::apply_visitor(outputParameterVisitor,
+  OutputDataType modInput = (boost::apply_visitor(outputParameterVisitor,
       forgetGateModule) % *prevOutput);
 
   // Pass that through the outputHidden2GateModule.
-  boost::apply_visitor(ForwardVisitor(std::move(modInput), std::move(
-      boost::apply_visitor(outputParameterVisitor, outputHidden2GateModule))),
-      outputHidden2GateModule);
+  boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(modInput),
+      std::move(boost::apply_visitor(outputParameterVisitor,
+      outputHidden2GateModule))), outputHidden2GateModule);
 
   // Merge for ot.
-  arma::mat outputH = boost::apply_visitor(outputParameterVisitor,
+  OutputDataType outputH = boost::apply_visitor(outputParameterVisitor,
       input2GateModule).submat(2 * outSize, 0, 3 * outSize - 1, batchSize - 1) +
       boost::apply_visitor(outputParameterVisitor, outputHidden2GateModule);
 
   // Pass it through hiddenGate.
-  boost::apply_visitor(ForwardVisitor(std::move(outputH), std::move(
-      boost::apply_visitor(outputParameterVisitor, hiddenStateModule))),
-      hiddenStateModule);
+  boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(outputH),
+      std::move(boost::apply_visitor(outputParameterVisitor,
+      hiddenStateModule))), hiddenStateModule);
 
   // Update the output (nextOutput): cmul1 + cmul2
   // Where cmul1 is input gate * prevOutput and
@@ -171,13 +174,13 @@ void GRU<InputDataType, OutputDataType>::Forward(
     forwardStep = 0;
     if (!deterministic)
     {
-      outParameter.push_back(std::move(arma::mat(allZeros.memptr(),
+      outParameter.push_back(std::move(OutputDataType(allZeros.memptr(),
           allZeros.n_rows, allZeros.n_cols, false, true)));
       prevOutput = --outParameter.end();
     }
     else
     {
-      *prevOutput = std::move(arma::mat(allZeros.memptr(),
+      *prevOutput = std::move(OutputDataType(allZeros.memptr(),
           allZeros.n_rows, allZeros.n_cols, false, true));
     }
   }
@@ -220,7 +223,7 @@ void GRU<InputDataType, OutputDataType>::Backward(
     }
 
     outParameter.clear();
-    outParameter.push_back(std::move(arma::mat(allZeros.memptr(),
+    outParameter.push_back(std::move(OutputDataType(allZeros.memptr(),
         allZeros.n_rows, allZeros.n_cols, false, true)));
 
     prevOutput = outParameter.begin();
@@ -239,42 +242,42 @@ void GRU<InputDataType, OutputDataType>::Backward(
   }
 
   // Delta zt.
-  arma::mat dZt = gy % (*backIterator -
+  OutputDataType dZt = gy % (*backIterator -
       boost::apply_visitor(outputParameterVisitor,
       hiddenStateModule));
 
   // Delta ot.
-  arma::mat dOt = gy % (arma::ones<arma::mat>(outSize, batchSize) -
+  OutputDataType dOt = gy % (arma::ones<OutputDataType>(outSize, batchSize) -
       boost::apply_visitor(outputParameterVisitor, inputGateModule));
 
   // Delta of input gate.
-  boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-      outputParameterVisitor, inputGateModule)), std::move(dZt),
-      std::move(boost::apply_visitor(deltaVisitor, inputGateModule))),
+  boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+      boost::apply_visitor(outputParameterVisitor, inputGateModule)), std::move(
+      dZt), std::move(boost::apply_visitor(deltaVisitor, inputGateModule))),
       inputGateModule);
 
   // Delta of hidden gate.
-  boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-      outputParameterVisitor, hiddenStateModule)), std::move(dOt),
-      std::move(boost::apply_visitor(deltaVisitor, hiddenStateModule))),
-      hiddenStateModule);
+  boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+      boost::apply_visitor(outputParameterVisitor, hiddenStateModule)),
+      std::move(dOt), std::move(boost::apply_visitor(deltaVisitor,
+      hiddenStateModule))), hiddenStateModule);
 
   // Delta of outputHidden2GateModule.
-  boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-      outputParameterVisitor, outputHidden2GateModule)),
+  boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+      boost::apply_visitor(outputParameterVisitor, outputHidden2GateModule)),
       std::move(boost::apply_visitor(deltaVisitor, hiddenStateModule)),
       std::move(boost::apply_visitor(deltaVisitor, outputHidden2GateModule))),
       outputHidden2GateModule);
 
   // Delta rt.
-  arma::mat dRt = boost::apply_visitor(deltaVisitor, outputHidden2GateModule) %
-      *backIterator;
+  OutputDataType dRt = boost::apply_visitor(deltaVisitor,
+      outputHidden2GateModule) % *backIterator;
 
   // Delta of forget gate.
-  boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-      outputParameterVisitor, forgetGateModule)), std::move(dRt),
-      std::move(boost::apply_visitor(deltaVisitor, forgetGateModule))),
-      forgetGateModule);
+  boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+      boost::apply_visitor(outputParameterVisitor, forgetGateModule)),
+      std::move(dRt), std::move(boost::apply_visitor(deltaVisitor,
+      forgetGateModule))), forgetGateModule);
 
   // Put delta zt.
   prevError.submat(0, 0, 1 * outSize - 1, batchSize - 1) = boost::apply_visitor(
@@ -289,8 +292,8 @@ void GRU<InputDataType, OutputDataType>::Backward(
       boost::apply_visitor(deltaVisitor, hiddenStateModule);
 
   // Get delta ht - 1 for input gate and forget gate.
-  boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-      outputParameterVisitor, input2GateModule)),
+  boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+      boost::apply_visitor(outputParameterVisitor, input2GateModule)),
       std::move(prevError.submat(0, 0, 2 * outSize - 1, batchSize - 1)),
       std::move(boost::apply_visitor(deltaVisitor, output2GateModule))),
       output2GateModule);
@@ -305,10 +308,10 @@ void GRU<InputDataType, OutputDataType>::Backward(
       boost::apply_visitor(outputParameterVisitor, inputGateModule);
 
   // Get delta input.
-  boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-      outputParameterVisitor, input2GateModule)), std::move(prevError),
-      std::move(boost::apply_visitor(deltaVisitor, input2GateModule))),
-      input2GateModule);
+  boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+      boost::apply_visitor(outputParameterVisitor, input2GateModule)),
+      std::move(prevError), std::move(boost::apply_visitor(deltaVisitor,
+      input2GateModule))), input2GateModule);
 
   backwardStep++;
   backIterator--;
@@ -336,7 +339,7 @@ void GRU<InputDataType, OutputDataType>::Gradient(
     }
 
     outParameter.clear();
-    outParameter.push_back(std::move(arma::mat(allZeros.memptr(),
+    outParameter.push_back(std::move(OutputDataType(allZeros.memptr(),
         allZeros.n_rows, allZeros.n_cols, false, true)));
 
     prevOutput = outParameter.begin();
@@ -349,15 +352,15 @@ void GRU<InputDataType, OutputDataType>::Gradient(
     gradIterator = --(--outParameter.end());
   }
 
-  boost::apply_visitor(GradientVisitor(std::move(input), std::move(prevError)),
-      input2GateModule);
+  boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(input),
+      std::move(prevError)), input2GateModule);
 
-  boost::apply_visitor(GradientVisitor(
+  boost::apply_visitor(GradientVisitor<OutputDataType>(
       std::move(*gradIterator),
       std::move(prevError.submat(0, 0, 2 * outSize - 1, batchSize - 1))),
       output2GateModule);
 
-  boost::apply_visitor(GradientVisitor(
+  boost::apply_visitor(GradientVisitor<OutputDataType>(
       *gradIterator % boost::apply_visitor(outputParameterVisitor,
       forgetGateModule),
       std::move(prevError.submat(2 * outSize, 0, 3 * outSize - 1,
@@ -370,7 +373,7 @@ template<typename InputDataType, typename OutputDataType>
 void GRU<InputDataType, OutputDataType>::ResetCell(const size_t /* size */)
 {
   outParameter.clear();
-  outParameter.push_back(std::move(arma::mat(allZeros.memptr(),
+  outParameter.push_back(std::move(OutputDataType(allZeros.memptr(),
     allZeros.n_rows, allZeros.n_cols, false, true)));
 
   prevOutput = outParameter.begin();
@@ -27,6 +27,7 @@
 #include "multiply_merge.hpp"
 #include "gru.hpp"
 #include "fast_lstm.hpp"
+#include "quantized_linear.hpp"
 #include "recurrent.hpp"
 #include "recurrent_attention.hpp"
 #include "reparametrization.hpp"
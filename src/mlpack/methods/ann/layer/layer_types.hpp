@@ -58,6 +58,7 @@ template<typename InputDataType, typename OutputDataType> class LayerNorm;
 template<typename InputDataType, typename OutputDataType> class Linear;
 template<typename InputDataType, typename OutputDataType> class LinearNoBias;
 template<typename InputDataType, typename OutputDataType> class LSTM;
+template<typename InputDataType, typename OutputDataType> class QuantizedLinear;
 template<typename InputDataType, typename OutputDataType> class GRU;
 template<typename InputDataType, typename OutputDataType> class FastLSTM;
 template<typename InputDataType, typename OutputDataType> class VRClassReward;
@@ -139,67 +140,78 @@ template<typename InputDataType,
 >
 class MultiplyMerge;
 
-template <typename... CustomLayers>
-using LayerTypes = boost::variant<
-    Add<arma::mat, arma::mat>*,
-    AddMerge<arma::mat, arma::mat>*,
+/**
+ * The variant of all the layers whose input and output have the given matrix
+ * type (such as arma::mat or arma::fmat), together with the given custom
+ * layers.
+ */
+template <typename MatType, typename... CustomLayers>
+using TypedLayerTypes = boost::variant<
+    Add<MatType, MatType>*,
+    AddMerge<MatType, MatType>*,
     AtrousConvolution<NaiveConvolution<ValidConvolution>,
                       NaiveConvolution<FullConvolution>,
                       NaiveConvolution<ValidConvolution>,
-                      arma::mat, arma::mat>*,
-    BaseLayer<LogisticFunction, arma::mat, arma::mat>*,
-    BaseLayer<IdentityFunction, arma::mat, arma::mat>*,
-    BaseLayer<TanhFunction, arma::mat, arma::mat>*,
-    BaseLayer<RectifierFunction, arma::mat, arma::mat>*,
-    BaseLayer<SoftplusFunction, arma::mat, arma::mat>*,
-    BatchNorm<arma::mat, arma::mat>*,
-    BilinearInterpolation<arma::mat, arma::mat>*,
-    Concat<arma::mat, arma::mat>*,
-    Concatenate<arma::mat, arma::mat>*,
-    ConcatPerformance<NegativeLogLikelihood<arma::mat, arma::mat>,
-                      arma::mat, arma::mat>*,
-    Constant<arma::mat, arma::mat>*,
+                      MatType, MatType>*,
+    BaseLayer<LogisticFunction, MatType, MatType>*,
+    BaseLayer<IdentityFunction, MatType, MatType>*,
+    BaseLayer<TanhFunction, MatType, MatType>*,
+    BaseLayer<RectifierFunction, MatType, MatType>*,
+    BaseLayer<SoftplusFunction, MatType, MatType>*,
+    BatchNorm<MatType, MatType>*,
+    BilinearInterpolation<MatType, MatType>*,
+    Concat<MatType, MatType>*,
+    Concatenate<MatType, MatType>*,
+    ConcatPerformance<NegativeLogLikelihood<MatType, MatType>,
+                      MatType, MatType>*,
+    Constant<MatType, MatType>*,
     Convolution<NaiveConvolution<ValidConvolution>,
                 NaiveConvolution<FullConvolution>,
-                NaiveConvolution<ValidConvolution>, arma::mat, arma::mat>*,
+                NaiveConvolution<ValidConvolution>, MatType, MatType>*,
     TransposedConvolution<NaiveConvolution<ValidConvolution>,
             NaiveConvolution<FullConvolution>,
-            NaiveConvolution<ValidConvolution>, arma::mat, arma::mat>*,
-    DropConnect<arma::mat, arma::mat>*,
-    Dropout<arma::mat, arma::mat>*,
-    AlphaDropout<arma::mat, arma::mat>*,
-    ELU<arma::mat, arma::mat>*,
-    FlexibleReLU<arma::mat, arma::mat>*,
-    Glimpse<arma::mat, arma::mat>*,
-    HardTanH<arma::mat, arma::mat>*,
-    Join<arma::mat, arma::mat>*,
-    LayerNorm<arma::mat, arma::mat>*,
-    LeakyReLU<arma::mat, arma::mat>*,
-    Linear<arma::mat, arma::mat>*,
-    LinearNoBias<arma::mat, arma::mat>*,
-    LogSoftMax<arma::mat, arma::mat>*,
-    Lookup<arma::mat, arma::mat>*,
-    LSTM<arma::mat, arma::mat>*,
-    GRU<arma::mat, arma::mat>*,
-    FastLSTM<arma::mat, arma::mat>*,
-    MaxPooling<arma::mat, arma::mat>*,
-    MeanPooling<arma::mat, arma::mat>*,
-    MultiplyConstant<arma::mat, arma::mat>*,
-    MultiplyMerge<arma::mat, arma::mat>*,
-    NegativeLogLikelihood<arma::mat, arma::mat>*,
-    PReLU<arma::mat, arma::mat>*,
-    Recurrent<arma::mat, arma::mat>*,
-    RecurrentAttention<arma::mat, arma::mat>*,
-    ReinforceNormal<arma::mat, arma::mat>*,
-    Reparametrization<arma::mat, arma::mat>*,
-    Select<arma::mat, arma::mat>*,
-    Sequential<arma::mat, arma::mat, false>*,
-    Sequential<arma::mat, arma::mat, true>*,
-    Subview<arma::mat, arma::mat>*,
-    VRClassReward<arma::mat, arma::mat>*,
+            NaiveConvolution<ValidConvolution>, MatType, MatType>*,
+    DropConnect<MatType, MatType>*,
+    Dropout<MatType, MatType>*,
+    AlphaDropout<MatType, MatType>*,
+    ELU<MatType, MatType>*,
+    FlexibleReLU<MatType, MatType>*,
+    Glimpse<MatType, MatType>*,
+    HardTanH<MatType, MatType>*,
+    Join<MatType, MatType>*,
+    LayerNorm<MatType, MatType>*,
+    LeakyReLU<MatType, MatType>*,
+    Linear<MatType, MatType>*,
+    LinearNoBias<MatType, MatType>*,
+    LogSoftMax<MatType, MatType>*,
+    Lookup<MatType, MatType>*,
+    LSTM<MatType, MatType>*,
+    GRU<MatType, MatType>*,
+    FastLSTM<MatType, MatType>*,
+    MaxPooling<MatType, MatType>*,
+    MeanPooling<MatType, MatType>*,
+    MultiplyConstant<MatType, MatType>*,
+    MultiplyMerge<MatType, MatType>*,
+    NegativeLogLikelihood<MatType, MatType>*,
+    PReLU<MatType, MatType>*,
+    QuantizedLinear<MatType, MatType>*,
+    Recurrent<MatType, MatType>*,
+    RecurrentAttention<MatType, MatType>*,
+    ReinforceNormal<MatType, MatType>*,
+    Reparametrization<MatType, MatType>*,
+    Select<MatType, MatType>*,
+    Sequential<MatType, MatType, false>*,
+    Sequential<MatType, MatType, true>*,
+    Subview<MatType, MatType>*,
+    VRClassReward<MatType, MatType>*,
     CustomLayers*...
 >;
 
+//! The variant of all the layers that use arma::mat, together with the given
+//! custom layers.
+template <typename... CustomLayers>
+using LayerTypes = TypedLayerTypes<arma::mat, CustomLayers...>;
+
 } // namespace ann
 } // namespace mlpack
 
@@ -38,8 +38,8 @@ Linear<InputDataType, OutputDataType>::Linear(
 template<typename InputDataType, typename OutputDataType>
 void Linear<InputDataType, OutputDataType>::Reset()
 {
-  weight = arma::mat(weights.memptr(), outSize, inSize, false, false);
-  bias = arma::mat(weights.memptr() + weight.n_elem,
+  weight = OutputDataType(weights.memptr(), outSize, inSize, false, false);
+  bias = OutputDataType(weights.memptr() + weight.n_elem,
       outSize, 1, false, false);
 }
 
@@ -48,8 +48,11 @@ template<typename eT>
 void Linear<InputDataType, OutputDataType>::Forward(
     const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
-  output = weight * input;
-  output.each_col() += bias;
+  // Start from the bias, so the bias add is fused into the GEMM (which then
+  // accumulates into the output) instead of being another pass over it.
+  output.set_size(weight.n_rows, input.n_cols);
+  output.each_col() = bias;
+  output += weight * input;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -100,6 +100,13 @@ class Lookup
   //! Modify the gradient.
   OutputDataType& Gradient() { return gradient; }
 
+  /**
+   * Get the columns of the weights (the entries of the table) that were looked
+   * up in the last call to Gradient(), in increasing order.  The other columns
+   * of the gradient are zero.
+   */
+  const arma::uvec& Indices() const { return indices; }
+
   /**
    * Serialize the layer
    */
@@ -124,6 +131,12 @@ class Lookup
 
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
+
+  //! The columns that were set in the last call to Gradient().
+  arma::uvec indices;
+
+  //! The memory of the gradient of the last call to Gradient().
+  const typename OutputDataType::elem_type* lastGradient;
 }; // class Lookup
 
 // Alias for using as embedding layer.
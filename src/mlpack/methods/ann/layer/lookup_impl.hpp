@@ -24,7 +24,8 @@ Lookup<InputDataType, OutputDataType>::Lookup(
     const size_t inSize,
     const size_t outSize) :
     inSize(inSize),
-    outSize(outSize)
+    outSize(outSize),
+    lastGradient(NULL)
 {
   weights.set_size(outSize, inSize);
 }
@@ -54,8 +55,26 @@ void Lookup<InputDataType, OutputDataType>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& gradient)
 {
-  gradient = arma::zeros<arma::Mat<eT> >(weights.n_rows, weights.n_cols);
-  gradient.cols(arma::conv_to<arma::uvec>::from(input) - 1) = error;
+  // Only the columns that are looked up are nonzero.  If the gradient is the
+  // one of the last call, only the columns that were set then are cleared, so
+  // that the cost doesn't depend on the size of the table.
+  if (gradient.memptr() == lastGradient && gradient.n_elem == weights.n_elem)
+  {
+    for (size_t i = 0; i < indices.n_elem; ++i)
+      gradient.col(indices[i]).zeros();
+  }
+  else
+  {
+    gradient.zeros(weights.n_rows, weights.n_cols);
+  }
+
+  // An entry that is looked up several times gets the sum of the errors.
+  const arma::uvec columns = arma::conv_to<arma::uvec>::from(input) - 1;
+  for (size_t i = 0; i < columns.n_elem; ++i)
+    gradient.col(columns[i]) += error.col(i);
+
+  indices = arma::unique(columns);
+  lastGradient = gradient.memptr();
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -48,8 +48,12 @@ namespace ann /** Artificial Neural Network. */ {
  * }
  * @endcode
  *
- * \see FastLSTM for a faster LSTM version which combines the calculation of the
- * input, forget, output gates and hidden state in a single step.
+ * The pre-activations of the input, forget and output gates and of the hidden
+ * state are computed together, with one matrix product for the input and one
+ * for the previous output at each step.
+ *
+ * \see FastLSTM for a faster LSTM version without peephole connections, which
+ * also combines the activations of the gates.
  *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
@@ -114,6 +118,16 @@ class LSTM
    */
   void ResetCell(const size_t size);
 
+  /*
+   * Start the next window of truncated BPTT from the state after the given
+   * step of the current window.  Like ResetCell(), this breaks the BPTT chain,
+   * but the cell and the output of that step are used as the previous state
+   * of the first step of the next window.
+   *
+   * @param step Number of steps of the current window before the next one.
+   */
+  void CarryState(const size_t step);
+
   /*
    * Calculate the gradient using the output delta and the input activation.
    *
@@ -158,6 +172,14 @@ class LSTM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Pack the input, bias and output weights of the four gates into the fused
+   * matrices, so that each step computes all the pre-activations with a
+   * single product per input.  The weights don't change during a sequence,
+   * so this is done once at the start of every sequence.
+   */
+  void PackWeights();
+
   //! Locally-stored number of input units.
   size_t inSize;
 
@@ -240,17 +262,19 @@ class LSTM
   //! Weights between cell and output gate.
   OutputDataType cell2GateOutputWeight;
 
-  //! Locally-stored input gate parameter.
-  OutputDataType inputGate;
+  //! Weights between the input and all the gates, packed in the order of the
+  //! output gate, the forget gate, the input gate and the hidden layer.
+  OutputDataType input2GateWeight;
 
-  //! Locally-stored forget gate parameter.
-  OutputDataType forgetGate;
+  //! Bias between the input and all the gates, in the same order.
+  OutputDataType input2GateBias;
 
-  //! Locally-stored hidden layer parameter.
-  OutputDataType hiddenLayer;
+  //! Weights between the output and all the gates, in the same order.
+  OutputDataType output2GateWeight;
 
-  //! Locally-stored output gate parameter.
-  OutputDataType outputGate;
+  //! Locally-stored pre-activations of the output gate, the forget gate, the
+  //! input gate and the hidden layer, stacked in this order.
+  OutputDataType gate;
 
   //! Locally-stored input gate activation.
   OutputDataType inputGateActivation;
@@ -276,14 +300,16 @@ class LSTM
   //! Locally-stored cell parameter.
   OutputDataType cell;
 
+  //! Locally-stored cell of the step before the first step, carried over from
+  //! the last window, or empty if the cell starts from zero.
+  OutputDataType prevCell;
+
   //! Locally-stored cell activation error.
   OutputDataType cellActivation;
 
-  //! Locally-stored forget gate error.
-  OutputDataType forgetGateError;
-
-  //! Locally-stored output gate error.
-  OutputDataType outputGateError;
+  //! Locally-stored errors of the output gate, the forget gate, the input gate
+  //! and the hidden layer, stacked in this order.
+  OutputDataType gateError;
 
   //! Locally-stored previous error.
   OutputDataType prevError;
@@ -294,12 +320,6 @@ class LSTM
   //! Locally-stored input cell error parameter.
   OutputDataType inputCellError;
 
-  //! Locally-stored input gate error.
-  OutputDataType inputGateError;
-
-  //! Locally-stored hidden layer error.
-  OutputDataType hiddenError;
-
   //! Locally-stored current rho size.
   size_t rhoSize;
 
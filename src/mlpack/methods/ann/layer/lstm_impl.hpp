@@ -61,12 +61,9 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
   gradientStep = batchSize * size - 1;
 
   const size_t rhoBatchSize = size * batchSize;
-  if (inputGate.is_empty() || inputGate.n_cols < rhoBatchSize)
+  if (gate.is_empty() || gate.n_cols < rhoBatchSize)
   {
-    inputGate.set_size(outSize, rhoBatchSize);
-    forgetGate.set_size(outSize, rhoBatchSize);
-    hiddenLayer.set_size(outSize, rhoBatchSize);
-    outputGate.set_size(outSize, rhoBatchSize);
+    gate.set_size(4 * outSize, rhoBatchSize);
 
     inputGateActivation.set_size(outSize, rhoBatchSize);
     forgetGateActivation.set_size(outSize, rhoBatchSize);
@@ -78,7 +75,7 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
 
     if (cell.is_empty())
     {
-      cell = arma::zeros(outSize, size * batchSize);
+      cell = arma::zeros<OutputDataType>(outSize, size * batchSize);
       outParameter = arma::zeros<OutputDataType>(
           outSize, (size + 1) * batchSize);
     }
@@ -91,6 +88,30 @@ void LSTM<InputDataType, OutputDataType>::ResetCell(const size_t size)
       outParameter.resize(outSize, (size + 1) * batchSize);
     }
   }
+
+  // A carried state doesn't survive a new sequence.
+  outParameter.cols(0, batchSize - 1).zeros();
+  prevCell.reset();
+}
+
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::CarryState(const size_t step)
+{
+  if (batchSize == 0 || step == 0 || step > bpttSteps)
+  {
+    ResetCell(rhoSize);
+    return;
+  }
+
+  // The first columns of the outputs hold the output of the previous step.
+  prevCell = cell.cols((step - 1) * batchSize, step * batchSize - 1);
+  outParameter.cols(0, batchSize - 1) = outParameter.cols(step * batchSize,
+      (step + 1) * batchSize - 1);
+
+  forwardStep = 0;
+  gradientStepIdx = 0;
+  backwardStep = batchSize * rhoSize - 1;
+  gradientStep = batchSize * rhoSize - 1;
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -159,6 +180,29 @@ void LSTM<InputDataType, OutputDataType>::Reset()
       offset, outSize, 1, false, false);
 }
 
+template<typename InputDataType, typename OutputDataType>
+void LSTM<InputDataType, OutputDataType>::PackWeights()
+{
+  input2GateWeight.set_size(4 * outSize, inSize);
+  input2GateWeight.rows(0, outSize - 1) = input2GateOutputWeight;
+  input2GateWeight.rows(outSize, 2 * outSize - 1) = input2GateForgetWeight;
+  input2GateWeight.rows(2 * outSize, 3 * outSize - 1) = input2GateInputWeight;
+  input2GateWeight.rows(3 * outSize, 4 * outSize - 1) = input2HiddenWeight;
+
+  input2GateBias.set_size(4 * outSize, 1);
+  input2GateBias.rows(0, outSize - 1) = input2GateOutputBias;
+  input2GateBias.rows(outSize, 2 * outSize - 1) = input2GateForgetBias;
+  input2GateBias.rows(2 * outSize, 3 * outSize - 1) = input2GateInputBias;
+  input2GateBias.rows(3 * outSize, 4 * outSize - 1) = input2HiddenBias;
+
+  output2GateWeight.set_size(4 * outSize, outSize);
+  output2GateWeight.rows(0, outSize - 1) = output2GateOutputWeight;
+  output2GateWeight.rows(outSize, 2 * outSize - 1) = output2GateForgetWeight;
+  output2GateWeight.rows(2 * outSize, 3 * outSize - 1) =
+      output2GateInputWeight;
+  output2GateWeight.rows(3 * outSize, 4 * outSize - 1) = output2HiddenWeight;
+}
+
 template<typename InputDataType, typename OutputDataType>
 template<typename InputType, typename OutputType>
 void LSTM<InputDataType, OutputDataType>::Forward(
@@ -173,50 +217,61 @@ void LSTM<InputDataType, OutputDataType>::Forward(
     ResetCell(rhoSize);
   }
 
-  inputGate.cols(forwardStep, forwardStep + batchStep) = input2GateInputWeight *
-      input + output2GateInputWeight * outParameter.cols(forwardStep,
-      forwardStep + batchStep);
-  inputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateInputBias;
+  // The parameters may have been updated since the last sequence.
+  if (forwardStep == 0 || input2GateWeight.n_rows != 4 * outSize)
+    PackWeights();
 
-  forgetGate.cols(forwardStep, forwardStep + batchStep) = input2GateForgetWeight
-      * input + output2GateForgetWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-  forgetGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateForgetBias;
+  // The pre-activations of all the gates: output gate, forget gate, input gate
+  // and hidden layer.
+  gate.cols(forwardStep, forwardStep + batchStep) = input2GateWeight * input +
+      output2GateWeight * outParameter.cols(forwardStep,
+      forwardStep + batchStep);
+  gate.cols(forwardStep, forwardStep + batchStep).each_col() += input2GateBias;
 
   if (forwardStep > 0)
   {
-    inputGate.cols(forwardStep, forwardStep + batchStep) +=
-        arma::repmat(cell2GateInputWeight, 1, batchSize) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
-
-    forgetGate.cols(forwardStep, forwardStep + batchStep) +=
-        arma::repmat(cell2GateForgetWeight, 1, batchSize) %
-        cell.cols(forwardStep - batchSize, forwardStep - batchSize + batchStep);
+    gate.submat(outSize, forwardStep, 2 * outSize - 1,
+        forwardStep + batchStep) += cell.cols(forwardStep - batchSize,
+        forwardStep - batchSize + batchStep).each_col() %
+        cell2GateForgetWeight;
+
+    gate.submat(2 * outSize, forwardStep, 3 * outSize - 1,
+        forwardStep + batchStep) += cell.cols(forwardStep - batchSize,
+        forwardStep - batchSize + batchStep).each_col() %
+        cell2GateInputWeight;
+  }
+  else if (!prevCell.is_empty())
+  {
+    gate.submat(outSize, 0, 2 * outSize - 1, batchStep) +=
+        prevCell.each_col() % cell2GateForgetWeight;
+    gate.submat(2 * outSize, 0, 3 * outSize - 1, batchStep) +=
+        prevCell.each_col() % cell2GateInputWeight;
   }
 
   inputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-inputGate.cols(forwardStep, forwardStep + batchStep)));
+      (1 + arma::exp(-gate.submat(2 * outSize, forwardStep, 3 * outSize - 1,
+      forwardStep + batchStep)));
 
   forgetGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-forgetGate.cols(forwardStep, forwardStep + batchStep)));
-
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep) = input2HiddenWeight *
-      input + output2HiddenWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep);
-
-  hiddenLayer.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2HiddenBias;
+      (1 + arma::exp(-gate.submat(outSize, forwardStep, 2 * outSize - 1,
+      forwardStep + batchStep)));
 
   hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep) =
-      arma::tanh(hiddenLayer.cols(forwardStep, forwardStep + batchStep));
+      arma::tanh(gate.submat(3 * outSize, forwardStep, 4 * outSize - 1,
+      forwardStep + batchStep));
 
   if (forwardStep == 0)
   {
     cell.cols(forwardStep, forwardStep + batchStep) =
         inputGateActivation.cols(forwardStep, forwardStep + batchStep) %
         hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
+
+    if (!prevCell.is_empty())
+    {
+      cell.cols(forwardStep, forwardStep + batchStep) +=
+          forgetGateActivation.cols(forwardStep, forwardStep + batchStep) %
+          prevCell;
+    }
   }
   else
   {
@@ -227,16 +282,14 @@ void LSTM<InputDataType, OutputDataType>::Forward(
         hiddenLayerActivation.cols(forwardStep, forwardStep + batchStep);
   }
 
-  outputGate.cols(forwardStep, forwardStep + batchStep) = input2GateOutputWeight
-      * input + output2GateOutputWeight * outParameter.cols(
-      forwardStep, forwardStep + batchStep) + cell.cols(forwardStep,
-      forwardStep + batchStep).each_col() % cell2GateOutputWeight;
-
-  outputGate.cols(forwardStep, forwardStep + batchStep).each_col() +=
-      input2GateOutputBias;
+  // The output gate looks at the updated cell.
+  gate.submat(0, forwardStep, outSize - 1, forwardStep + batchStep) +=
+      cell.cols(forwardStep, forwardStep + batchStep).each_col() %
+      cell2GateOutputWeight;
 
   outputGateActivation.cols(forwardStep, forwardStep + batchStep) = 1.0 /
-      (1 + arma::exp(-outputGate.cols(forwardStep, forwardStep + batchStep)));
+      (1 + arma::exp(-gate.submat(0, forwardStep, outSize - 1,
+      forwardStep + batchStep)));
 
   cellActivation.cols(forwardStep, forwardStep + batchStep) =
       arma::tanh(cell.cols(forwardStep, forwardStep + batchStep));
@@ -266,7 +319,10 @@ void LSTM<InputDataType, OutputDataType>::Backward(
     gy += prevError;
   }
 
-  outputGateError =
+  gateError.set_size(4 * outSize, batchSize);
+
+  // Output gate error.
+  gateError.rows(0, outSize - 1) =
       gy % cellActivation.cols(backwardStep - batchStep, backwardStep) %
       (outputGateActivation.cols(backwardStep - batchStep, backwardStep) %
       (1.0 - outputGateActivation.cols(backwardStep - batchStep,
@@ -275,48 +331,55 @@ void LSTM<InputDataType, OutputDataType>::Backward(
   OutputDataType cellError = gy %
       outputGateActivation.cols(backwardStep - batchStep, backwardStep) %
       (1 - arma::pow(cellActivation.cols(backwardStep -
-      batchStep, backwardStep), 2)) + outputGateError.each_col() %
-      cell2GateOutputWeight;
+      batchStep, backwardStep), 2)) + gateError.rows(0,
+      outSize - 1).each_col() % cell2GateOutputWeight;
 
   if (gradientStepIdx > 0)
   {
     cellError += inputCellError;
   }
 
+  // Forget gate error.
   if (backwardStep > batchStep)
   {
-    forgetGateError = cell.cols((backwardStep - batchSize) - batchStep,
-      (backwardStep - batchSize)) % cellError % (forgetGateActivation.cols(
-      backwardStep - batchStep, backwardStep) % (1.0 -
-      forgetGateActivation.cols(backwardStep - batchStep, backwardStep)));
+    gateError.rows(outSize, 2 * outSize - 1) = cell.cols(
+      (backwardStep - batchSize) - batchStep, (backwardStep - batchSize)) %
+      cellError % (forgetGateActivation.cols(backwardStep - batchStep,
+      backwardStep) % (1.0 - forgetGateActivation.cols(
+      backwardStep - batchStep, backwardStep)));
+  }
+  else if (!prevCell.is_empty())
+  {
+    gateError.rows(outSize, 2 * outSize - 1) = prevCell % cellError %
+        (forgetGateActivation.cols(backwardStep - batchStep, backwardStep) %
+        (1.0 - forgetGateActivation.cols(backwardStep - batchStep,
+        backwardStep)));
   }
   else
   {
-    forgetGateError.zeros();
+    gateError.rows(outSize, 2 * outSize - 1).zeros();
   }
 
-  inputGateError = hiddenLayerActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError %
+  // Input gate error.
+  gateError.rows(2 * outSize, 3 * outSize - 1) = hiddenLayerActivation.cols(
+      backwardStep - batchStep, backwardStep) % cellError %
       (inputGateActivation.cols(backwardStep - batchStep, backwardStep) %
       (1.0 - inputGateActivation.cols(backwardStep - batchStep, backwardStep)));
 
-  hiddenError = inputGateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError % (1 - arma::pow(hiddenLayerActivation.cols(
-      backwardStep - batchStep, backwardStep), 2));
+  // Hidden layer error.
+  gateError.rows(3 * outSize, 4 * outSize - 1) = inputGateActivation.cols(
+      backwardStep - batchStep, backwardStep) % cellError %
+      (1 - arma::pow(hiddenLayerActivation.cols(backwardStep - batchStep,
+      backwardStep), 2));
 
   inputCellError = forgetGateActivation.cols(backwardStep - batchStep,
-      backwardStep) % cellError + forgetGateError.each_col() %
-      cell2GateForgetWeight + inputGateError.each_col() % cell2GateInputWeight;
+      backwardStep) % cellError + gateError.rows(outSize,
+      2 * outSize - 1).each_col() % cell2GateForgetWeight +
+      gateError.rows(2 * outSize, 3 * outSize - 1).each_col() %
+      cell2GateInputWeight;
 
-  g = input2GateInputWeight.t() * inputGateError +
-      input2HiddenWeight.t() * hiddenError +
-      input2GateForgetWeight.t() * forgetGateError +
-      input2GateOutputWeight.t() * outputGateError;
-
-  prevError = output2GateOutputWeight.t() * outputGateError +
-      output2GateForgetWeight.t() * forgetGateError +
-      output2GateInputWeight.t() * inputGateError +
-      output2HiddenWeight.t() * hiddenError;
+  g = input2GateWeight.t() * gateError;
+  prevError = output2GateWeight.t() * gateError;
 
   backwardStep -= batchSize;
   gradientStepIdx++;
@@ -332,65 +395,37 @@ template<typename InputType, typename ErrorType, typename GradientType>
 void LSTM<InputDataType, OutputDataType>::Gradient(
     InputType&& input, ErrorType&& /* error */, GradientType&& gradient)
 {
-  // Input2GateOutputWeight and input2GateOutputBias gradients.
-  gradient.submat(0, 0, input2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError * input.t());
-  gradient.submat(input2GateOutputWeight.n_elem, 0,
-      input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem - 1, 0) =
-      arma::sum(outputGateError, 1);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // Input2GateForgetWeight and input2GateForgetBias gradients.
-  gradient.submat(offset, 0, offset + input2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError * input.t());
-  gradient.submat(offset + input2GateForgetWeight.n_elem, 0,
-      offset + input2GateForgetWeight.n_elem +
-      input2GateForgetBias.n_elem - 1, 0) = arma::sum(forgetGateError, 1);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // Input2GateInputWeight and input2GateInputBias gradients.
-  gradient.submat(offset, 0, offset + input2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError * input.t());
-  gradient.submat(offset + input2GateInputWeight.n_elem, 0,
-      offset + input2GateInputWeight.n_elem +
-      input2GateInputBias.n_elem - 1, 0) = arma::sum(inputGateError, 1);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // Input2HiddenWeight and input2HiddenBias gradients.
-  gradient.submat(offset, 0, offset + input2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError * input.t());
-  gradient.submat(offset + input2HiddenWeight.n_elem, 0,
-      offset + input2HiddenWeight.n_elem + input2HiddenBias.n_elem - 1, 0) =
-      arma::sum(hiddenError, 1);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // Output2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateOutputWeight.n_elem - 1, 0) =
-      arma::vectorise(outputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateOutputWeight.n_elem;
-
-  // Output2GateForgetWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateForgetWeight.n_elem - 1, 0) =
-      arma::vectorise(forgetGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateForgetWeight.n_elem;
-
-  // Output2GateInputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateInputWeight.n_elem - 1, 0) =
-      arma::vectorise(inputGateError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2GateInputWeight.n_elem;
+  // The gradients of the fused input and output weights, which are scattered
+  // to the layout of the parameters: the input weights and the bias of each
+  // gate, followed by the output weights of each gate.
+  const OutputDataType input2GateGradient = gateError * input.t();
+  const OutputDataType output2GateGradient = gateError *
+      outParameter.cols(gradientStep - batchStep, gradientStep).t();
+
+  size_t offset = 0;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    gradient.submat(offset, 0, offset + outSize * inSize - 1, 0) =
+        arma::vectorise(input2GateGradient.rows(i * outSize,
+        (i + 1) * outSize - 1));
+    offset += outSize * inSize;
+
+    gradient.submat(offset, 0, offset + outSize - 1, 0) = arma::sum(
+        gateError.rows(i * outSize, (i + 1) * outSize - 1), 1);
+    offset += outSize;
+  }
 
-  // Output2HiddenWeight gradients.
-  gradient.submat(offset, 0, offset + output2HiddenWeight.n_elem - 1, 0) =
-      arma::vectorise(hiddenError *
-      outParameter.cols(gradientStep - batchStep, gradientStep).t());
-  offset += output2HiddenWeight.n_elem;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    gradient.submat(offset, 0, offset + outSize * outSize - 1, 0) =
+        arma::vectorise(output2GateGradient.rows(i * outSize,
+        (i + 1) * outSize - 1));
+    offset += outSize * outSize;
+  }
 
   // Cell2GateOutputWeight gradients.
   gradient.submat(offset, 0, offset + cell2GateOutputWeight.n_elem - 1, 0) =
-      arma::sum(outputGateError %
+      arma::sum(gateError.rows(0, outSize - 1) %
       cell.cols(gradientStep - batchStep, gradientStep), 1);
   offset += cell2GateOutputWeight.n_elem;
 
@@ -398,15 +433,23 @@ void LSTM<InputDataType, OutputDataType>::Gradient(
   if (gradientStep > batchStep)
   {
     gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
-        arma::sum(forgetGateError %
+        arma::sum(gateError.rows(outSize, 2 * outSize - 1) %
                   cell.cols((gradientStep - batchSize) - batchStep,
                             (gradientStep - batchSize)), 1);
     gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
         cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
-        arma::sum(inputGateError %
+        arma::sum(gateError.rows(2 * outSize, 3 * outSize - 1) %
                   cell.cols((gradientStep - batchSize) - batchStep,
                             (gradientStep - batchSize)), 1);
   }
+  else if (!prevCell.is_empty())
+  {
+    gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
+        arma::sum(gateError.rows(outSize, 2 * outSize - 1) % prevCell, 1);
+    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
+        cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
+        arma::sum(gateError.rows(2 * outSize, 3 * outSize - 1) % prevCell, 1);
+  }
   else
   {
     gradient.submat(offset, 0, offset +
@@ -15,6 +15,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "pooling_windows.hpp"
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
@@ -38,7 +40,10 @@ class MaxPoolingRule
 };
 
 /**
- * Implementation of the MaxPooling layer.
+ * Implementation of the MaxPooling layer.  The windows are described by an
+ * index table that is computed once per input shape (see PoolingWindows), and
+ * the backward pass scatters the error to the maxima through the indices that
+ * were found in the forward pass.
  *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
@@ -136,58 +141,6 @@ class MaxPooling
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
- /**
-   * Apply pooling to the input and store the results.
-   *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
-   */
-  template<typename eT>
-  void PoolingOperation(const arma::Mat<eT>& input,
-                        arma::Mat<eT>& output,
-                        arma::Mat<eT>& poolingIndices)
-  {
-    for (size_t j = 0, colidx = 0; j < output.n_cols; ++j, colidx += dW)
-    {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dH)
-      {
-        arma::mat subInput = input(arma::span(rowidx, rowidx + kW - 1 - offset),
-            arma::span(colidx, colidx + kH - 1 - offset));
-
-        const size_t idx = pooling.Pooling(subInput);
-        output(i, j) = subInput(idx);
-
-        if (!deterministic)
-        {
-          arma::Mat<size_t> subIndices = indices(arma::span(rowidx,
-              rowidx + kW - 1 - offset),
-              arma::span(colidx, colidx + kH - 1 - offset));
-
-          poolingIndices(i, j) = subIndices(idx);
-        }
-      }
-    }
-  }
-
-  /**
-   * Apply unpooling to the input and store the results.
-   *
-   * @param error The backward error.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
-   */
-  template<typename eT>
-  void Unpooling(const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output,
-                 arma::Mat<eT>& poolingIndices)
-  {
-    for (size_t i = 0; i < poolingIndices.n_elem; ++i)
-    {
-      output(poolingIndices(i)) += error(i);
-    }
-  }
-
   //! Locally-stored width of the pooling window.
   size_t kW;
 
@@ -209,9 +162,6 @@ class MaxPooling
   //! Locally-stored number of output channels.
   size_t outSize;
 
-  //! Locally-stored reset parameter used to initialize the module once.
-  bool reset;
-
   //! Locally-stored input width.
   size_t inputWidth;
 
@@ -234,16 +184,13 @@ class MaxPooling
   size_t batchSize;
 
   //! Locally-stored output parameter.
-  arma::cube outputTemp;
+  arma::Cube<typename OutputDataType::elem_type> outputTemp;
 
   //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
+  arma::Cube<typename OutputDataType::elem_type> inputTemp;
 
   //! Locally-stored transformed output parameter.
-  arma::cube gTemp;
-
-  //! Locally-stored pooling strategy.
-  MaxPoolingRule pooling;
+  arma::Cube<typename OutputDataType::elem_type> gTemp;
 
   //! Locally-stored delta object.
   OutputDataType delta;
@@ -254,14 +201,12 @@ class MaxPooling
   //! Locally-stored output parameter object.
   OutputDataType outputParameter;
 
-  //! Locally-stored indices matrix parameter.
-  arma::Mat<size_t> indices;
-
-  //! Locally-stored indices column parameter.
-  arma::Col<size_t> indicesCol;
+  //! Locally-stored index table of the pooling windows.
+  PoolingWindows windows;
 
-  //! Locally-stored pooling indicies.
-  std::vector<arma::cube> poolingIndices;
+  //! Locally-stored pooling indices, the index of the maximum of each window
+  //! in its slice, with one column per slice, for each forward pass.
+  std::vector<arma::Mat<size_t> > poolingIndices;
 }; // class MaxPooling
 
 } // namespace ann
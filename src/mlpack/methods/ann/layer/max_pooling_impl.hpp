@@ -39,7 +39,6 @@ MaxPooling<InputDataType, OutputDataType>::MaxPooling(
     floor(floor),
     inSize(0),
     outSize(0),
-    reset(false),
     inputWidth(0),
     inputHeight(0),
     outputWidth(0),
@@ -58,7 +57,7 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
 {
   batchSize = input.n_cols;
   inSize = input.n_elem / (inputWidth * inputHeight * batchSize);
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&&>(input).memptr(),
+  inputTemp = arma::Cube<eT>(const_cast<arma::Mat<eT>&&>(input).memptr(),
       inputWidth, inputHeight, batchSize * inSize, false, false);
 
   if (floor)
@@ -74,36 +73,39 @@ void MaxPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
+  outputTemp.set_size(outputWidth, outputHeight, batchSize * inSize);
+  windows.Reset(inputWidth, inputHeight, outputWidth, outputHeight, kW, kH,
+      dW, dH, offset);
 
   if (!deterministic)
-  {
-    poolingIndices.push_back(outputTemp);
-  }
-
-  if (!reset)
-  {
-    size_t elements = inputWidth * inputHeight;
-    indicesCol = arma::linspace<arma::Col<size_t> >(0, (elements - 1),
-        elements);
-
-    indices = arma::Mat<size_t>(indicesCol.memptr(), inputWidth, inputHeight);
+    poolingIndices.push_back(arma::Mat<size_t>(outputWidth * outputHeight,
+        outputTemp.n_slices));
 
-    reset = true;
-  }
+  const size_t* begins = windows.Begins().memptr();
+  const size_t* windowIndices = windows.Indices().memptr();
+  const size_t outputs = outputWidth * outputHeight;
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) inputTemp.n_slices; ++s)
   {
-    if (!deterministic)
-    {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-        poolingIndices.back().slice(s));
-    }
-    else
+    const eT* in = inputTemp.slice_memptr(s);
+    eT* out = outputTemp.slice_memptr(s);
+    size_t* maxIndices = deterministic ? NULL :
+        poolingIndices.back().colptr(s);
+
+    for (size_t o = 0; o < outputs; ++o)
     {
-      PoolingOperation(inputTemp.slice(s), outputTemp.slice(s),
-          inputTemp.slice(s));
+      // The first maximum of the window is taken.
+      size_t maxIndex = windowIndices[begins[o]];
+      for (size_t k = begins[o] + 1; k < begins[o + 1]; ++k)
+      {
+        if (in[windowIndices[k]] > in[maxIndex])
+          maxIndex = windowIndices[k];
+      }
+
+      out[o] = in[maxIndex];
+      if (maxIndices != NULL)
+        maxIndices[o] = maxIndex;
     }
   }
 
@@ -120,21 +122,27 @@ template<typename eT>
 void MaxPooling<InputDataType, OutputDataType>::Backward(
     const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
 {
-  arma::cube mappedError = arma::cube(gy.memptr(), outputWidth,
+  arma::Cube<eT> mappedError = arma::Cube<eT>(gy.memptr(), outputWidth,
       outputHeight, outSize, false, false);
 
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
+  gTemp = arma::zeros<arma::Cube<eT> >(inputTemp.n_rows,
       inputTemp.n_cols, inputTemp.n_slices);
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  const arma::Mat<size_t>& maxIndices = poolingIndices.back();
+
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) mappedError.n_slices; ++s)
   {
-    Unpooling(mappedError.slice(s), gTemp.slice(s),
-        poolingIndices.back().slice(s));
+    const eT* error = mappedError.slice_memptr(s);
+    const size_t* sliceIndices = maxIndices.colptr(s);
+    eT* out = gTemp.slice_memptr(s);
+    for (size_t o = 0; o < maxIndices.n_rows; ++o)
+      out[sliceIndices[o]] += error[o];
   }
 
   poolingIndices.pop_back();
 
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
+  g = arma::Mat<eT>(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
 }
 
 template<typename InputDataType, typename OutputDataType>
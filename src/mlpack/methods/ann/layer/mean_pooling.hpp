@@ -15,11 +15,16 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "pooling_windows.hpp"
+
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
 
 /**
- * Implementation of the MeanPooling.
+ * Implementation of the MeanPooling.  The windows are described by an index
+ * table that is computed once per input shape (see PoolingWindows), which is
+ * used to average the inputs in the forward pass and to spread the error
+ * evenly over the same inputs in the backward pass.
  *
  * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
@@ -116,62 +121,6 @@ class MeanPooling
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
-  /**
-   * Apply pooling to the input and store the results.
-   *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
-   */
-  template<typename eT>
-  void Pooling(const arma::Mat<eT>& input, arma::Mat<eT>& output)
-  {
-    const size_t rStep = kW;
-    const size_t cStep = kH;
-
-    for (size_t j = 0, colidx = 0; j < output.n_cols; ++j, colidx += dH)
-    {
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; ++i, rowidx += dW)
-      {
-        arma::mat subInput = input(
-            arma::span(rowidx, rowidx + rStep - 1 - offset),
-            arma::span(colidx, colidx + cStep - 1 - offset));
-
-        output(i, j) = arma::mean(arma::mean(subInput));
-      }
-    }
-  }
-
-  /**
-   * Apply unpooling to the input and store the results.
-   *
-   * @param input The input to be apply the unpooling rule.
-   * @param output The pooled result.
-   */
-  template<typename eT>
-  void Unpooling(const arma::Mat<eT>& input,
-                 const arma::Mat<eT>& error,
-                 arma::Mat<eT>& output)
-  {
-    const size_t rStep = input.n_rows / error.n_rows - offset;
-    const size_t cStep = input.n_cols / error.n_cols - offset;
-
-    arma::Mat<eT> unpooledError;
-    for (size_t j = 0; j < input.n_cols - cStep; j += cStep)
-    {
-      for (size_t i = 0; i < input.n_rows - rStep; i += rStep)
-      {
-        const arma::Mat<eT>& inputArea = input(arma::span(i, i + rStep - 1),
-            arma::span(j, j + cStep - 1));
-
-        unpooledError = arma::Mat<eT>(inputArea.n_rows, inputArea.n_cols);
-        unpooledError.fill(error(i / rStep, j / cStep) / inputArea.n_elem);
-
-        output(arma::span(i, i + rStep - 1 - offset),
-            arma::span(j, j + cStep - 1 - offset)) += unpooledError;
-      }
-    }
-  }
-
   //! Locally-stored width of the pooling window.
   size_t kW;
 
@@ -217,14 +166,17 @@ class MeanPooling
   //! Locally-stored number of input units.
   size_t batchSize;
 
+  //! Locally-stored index table of the pooling windows.
+  PoolingWindows windows;
+
   //! Locally-stored output parameter.
-  arma::cube outputTemp;
+  arma::Cube<typename OutputDataType::elem_type> outputTemp;
 
   //! Locally-stored transformed input parameter.
-  arma::cube inputTemp;
+  arma::Cube<typename OutputDataType::elem_type> inputTemp;
 
   //! Locally-stored transformed output parameter.
-  arma::cube gTemp;
+  arma::Cube<typename OutputDataType::elem_type> gTemp;
 
   //! Locally-stored delta object.
   OutputDataType delta;
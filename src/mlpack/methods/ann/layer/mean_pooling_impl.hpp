@@ -58,7 +58,7 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
 {
   batchSize = input.n_cols;
   inSize = input.n_elem / (inputWidth * inputHeight * batchSize);
-  inputTemp = arma::cube(const_cast<arma::Mat<eT>&&>(input).memptr(),
+  inputTemp = arma::Cube<eT>(const_cast<arma::Mat<eT>&&>(input).memptr(),
       inputWidth, inputHeight, batchSize * inSize, false, false);
 
   if (floor)
@@ -76,11 +76,28 @@ void MeanPooling<InputDataType, OutputDataType>::Forward(
     offset = 1;
   }
 
-  outputTemp = arma::zeros<arma::Cube<eT> >(outputWidth, outputHeight,
-      batchSize * inSize);
+  outputTemp.set_size(outputWidth, outputHeight, batchSize * inSize);
+  windows.Reset(inputWidth, inputHeight, outputWidth, outputHeight, kW, kH,
+      dW, dH, offset);
 
-  for (size_t s = 0; s < inputTemp.n_slices; s++)
-    Pooling(inputTemp.slice(s), outputTemp.slice(s));
+  const size_t* begins = windows.Begins().memptr();
+  const size_t* windowIndices = windows.Indices().memptr();
+  const size_t outputs = outputWidth * outputHeight;
+
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) inputTemp.n_slices; ++s)
+  {
+    const eT* in = inputTemp.slice_memptr(s);
+    eT* out = outputTemp.slice_memptr(s);
+    for (size_t o = 0; o < outputs; ++o)
+    {
+      eT sum = 0;
+      for (size_t k = begins[o]; k < begins[o + 1]; ++k)
+        sum += in[windowIndices[k]];
+
+      out[o] = sum / (begins[o + 1] - begins[o]);
+    }
+  }
 
   output = arma::Mat<eT>(outputTemp.memptr(), outputTemp.n_elem / batchSize,
       batchSize);
@@ -97,18 +114,30 @@ void MeanPooling<InputDataType, OutputDataType>::Backward(
   arma::Mat<eT>&& gy,
   arma::Mat<eT>&& g)
 {
-  arma::cube mappedError = arma::cube(gy.memptr(), outputWidth,
+  arma::Cube<eT> mappedError = arma::Cube<eT>(gy.memptr(), outputWidth,
       outputHeight, outSize, false, false);
 
-  gTemp = arma::zeros<arma::cube>(inputTemp.n_rows,
+  gTemp = arma::zeros<arma::Cube<eT> >(inputTemp.n_rows,
       inputTemp.n_cols, inputTemp.n_slices);
 
-  for (size_t s = 0; s < mappedError.n_slices; s++)
+  const size_t* begins = windows.Begins().memptr();
+  const size_t* windowIndices = windows.Indices().memptr();
+  const size_t outputs = outputWidth * outputHeight;
+
+  #pragma omp parallel for
+  for (omp_size_t s = 0; s < (omp_size_t) mappedError.n_slices; ++s)
   {
-    Unpooling(inputTemp.slice(s), mappedError.slice(s), gTemp.slice(s));
+    const eT* error = mappedError.slice_memptr(s);
+    eT* out = gTemp.slice_memptr(s);
+    for (size_t o = 0; o < outputs; ++o)
+    {
+      const eT unpooledError = error[o] / (begins[o + 1] - begins[o]);
+      for (size_t k = begins[o]; k < begins[o + 1]; ++k)
+        out[windowIndices[k]] += unpooledError;
+    }
   }
 
-  g = arma::mat(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
+  g = arma::Mat<eT>(gTemp.memptr(), gTemp.n_elem / batchSize, batchSize);
 }
 
 template<typename InputDataType, typename OutputDataType>
@@ -102,7 +102,10 @@ class MultiplyMerge
    *
    * @param layer The Layer to be added to the model.
    */
-  void Add(LayerTypes<CustomLayers...> layer) { network.push_back(layer); }
+  void Add(TypedLayerTypes<OutputDataType, CustomLayers...> layer)
+  {
+    network.push_back(layer);
+  }
 
   //! Get the output parameter.
   OutputDataType const& OutputParameter() const { return outputParameter; }
@@ -120,7 +123,7 @@ class MultiplyMerge
   OutputDataType& Gradient() { return gradient; }
 
   //! Return the model modules.
-  std::vector<LayerTypes<CustomLayers...> >& Model()
+  std::vector<TypedLayerTypes<OutputDataType, CustomLayers...> >& Model()
   {
     if (model)
     {
@@ -153,19 +156,19 @@ class MultiplyMerge
   bool ownsLayer;
 
   //! Locally-stored network modules.
-  std::vector<LayerTypes<CustomLayers...> > network;
+  std::vector<TypedLayerTypes<OutputDataType, CustomLayers...> > network;
 
   //! Locally-stored empty list of modules.
-  std::vector<LayerTypes<CustomLayers...> > empty;
+  std::vector<TypedLayerTypes<OutputDataType, CustomLayers...> > empty;
 
   //! Locally-stored delete visitor module object.
   DeleteVisitor deleteVisitor;
 
   //! Locally-stored output parameter visitor module object.
-  OutputParameterVisitor outputParameterVisitor;
+  OutputParameterVisitor<OutputDataType> outputParameterVisitor;
 
   //! Locally-stored delta visitor module object.
-  DeltaVisitor deltaVisitor;
+  DeltaVisitor<OutputDataType> deltaVisitor;
 
   //! Locally-stored delta object.
   OutputDataType delta;
@@ -53,8 +53,8 @@ void MultiplyMerge<InputDataType, OutputDataType, CustomLayers...>::Forward(
   {
     for (size_t i = 0; i < network.size(); ++i)
     {
-      boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
-          boost::apply_visitor(outputParameterVisitor, network[i]))),
+      boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(input),
+          std::move(boost::apply_visitor(outputParameterVisitor, network[i]))),
           network[i]);
     }
   }
@@ -76,9 +76,10 @@ void MultiplyMerge<InputDataType, OutputDataType, CustomLayers...>::Backward(
   {
     for (size_t i = 0; i < network.size(); ++i)
     {
-      boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-          outputParameterVisitor, network[i])), std::move(gy), std::move(
-          boost::apply_visitor(deltaVisitor, network[i]))), network[i]);
+      boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+          boost::apply_visitor(outputParameterVisitor, network[i])), std::move(
+          gy), std::move(boost::apply_visitor(deltaVisitor, network[i]))),
+          network[i]);
     }
 
     g = boost::apply_visitor(deltaVisitor, network[0]);
@@ -103,8 +104,8 @@ void MultiplyMerge<InputDataType, OutputDataType, CustomLayers...>::Gradient(
   {
     for (size_t i = 0; i < network.size(); ++i)
     {
-      boost::apply_visitor(GradientVisitor(std::move(input), std::move(error)),
-          network[i]);
+      boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(input),
+          std::move(error)), network[i]);
     }
   }
 }
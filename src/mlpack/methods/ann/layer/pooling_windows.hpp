@@ -0,0 +1,140 @@
+/**
+ * @file pooling_windows.hpp
+ *
+ * Definition of the PoolingWindows class, the index table of the pooling
+ * windows used by the MaxPooling and MeanPooling layers.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_POOLING_WINDOWS_HPP
+#define MLPACK_METHODS_ANN_LAYER_POOLING_WINDOWS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The PoolingWindows class holds, for each output of a pooling layer, the
+ * indices of the inputs in its window, relative to the start of a slice (an
+ * inputWidth x inputHeight map of one channel of one point).  The table only
+ * depends on the shape of the input, so it is computed once and then applied
+ * to every slice of every batch, in the forward pass as well as in the
+ * backward pass.
+ *
+ * The window of output (i, j) covers the rows i * dW to
+ * i * dW + kW - 1 - offset and the columns j * dH to j * dH + kH - 1 - offset
+ * of the slice, clamped to the slice.  The indices of a window are in
+ * column-major order.  The window and the stride of a layer don't change, so
+ * the table is only recomputed when the shapes change.
+ */
+class PoolingWindows
+{
+ public:
+  //! Create an empty table.
+  PoolingWindows() :
+      inputWidth(0),
+      inputHeight(0),
+      outputWidth(0),
+      outputHeight(0)
+  { }
+
+  /**
+   * Compute the table for the given shapes, unless it was already computed
+   * for them.  The window, the stride and the offset must be the same for all
+   * calls.
+   *
+   * @param inputWidth Width of the input slices.
+   * @param inputHeight Height of the input slices.
+   * @param outputWidth Width of the output slices.
+   * @param outputHeight Height of the output slices.
+   * @param kW Width of the pooling window.
+   * @param kH Height of the pooling window.
+   * @param dW Width of the stride operation.
+   * @param dH Height of the stride operation.
+   * @param offset Number of elements to drop at the end of each window.
+   */
+  void Reset(const size_t inputWidth,
+             const size_t inputHeight,
+             const size_t outputWidth,
+             const size_t outputHeight,
+             const size_t kW,
+             const size_t kH,
+             const size_t dW,
+             const size_t dH,
+             const size_t offset)
+  {
+    if (!begins.is_empty() && inputWidth == this->inputWidth &&
+        inputHeight == this->inputHeight && outputWidth == this->outputWidth &&
+        outputHeight == this->outputHeight)
+    {
+      return;
+    }
+
+    this->inputWidth = inputWidth;
+    this->inputHeight = inputHeight;
+    this->outputWidth = outputWidth;
+    this->outputHeight = outputHeight;
+
+    const size_t rows = std::max(kW, offset + 1) - offset;
+    const size_t cols = std::max(kH, offset + 1) - offset;
+
+    begins.set_size(outputWidth * outputHeight + 1);
+    indices.set_size(outputWidth * outputHeight * rows * cols);
+    size_t n = 0;
+    for (size_t j = 0; j < outputHeight; ++j)
+    {
+      const size_t colBegin = std::min(j * dH, inputHeight - 1);
+      const size_t colEnd = std::min(colBegin + cols, inputHeight);
+      for (size_t i = 0; i < outputWidth; ++i)
+      {
+        const size_t rowBegin = std::min(i * dW, inputWidth - 1);
+        const size_t rowEnd = std::min(rowBegin + rows, inputWidth);
+
+        begins[j * outputWidth + i] = n;
+        for (size_t c = colBegin; c < colEnd; ++c)
+          for (size_t r = rowBegin; r < rowEnd; ++r)
+            indices[n++] = c * inputWidth + r;
+      }
+    }
+
+    begins[outputWidth * outputHeight] = n;
+    indices.resize(n);
+  }
+
+  /**
+   * Get where the window of each output starts in Indices(); the window of
+   * output k ends where the window of output k + 1 starts.
+   */
+  const arma::Col<size_t>& Begins() const { return begins; }
+
+  //! Get the indices of the inputs of all the windows.
+  const arma::Col<size_t>& Indices() const { return indices; }
+
+ private:
+  //! The input width the table was computed for.
+  size_t inputWidth;
+
+  //! The input height the table was computed for.
+  size_t inputHeight;
+
+  //! The output width the table was computed for.
+  size_t outputWidth;
+
+  //! The output height the table was computed for.
+  size_t outputHeight;
+
+  //! Where the window of each output starts.
+  arma::Col<size_t> begins;
+
+  //! The indices of the inputs of all the windows.
+  arma::Col<size_t> indices;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
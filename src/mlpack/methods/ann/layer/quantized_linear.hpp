@@ -0,0 +1,170 @@
+/**
+ * @file quantized_linear.hpp
+ *
+ * Definition of the QuantizedLinear layer class, an inference-only linear
+ * layer with 8-bit integer weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of the QuantizedLinear layer class, the post-training
+ * quantized version of a Linear or a LinearNoBias layer used for prediction.
+ * The weights are stored as 8-bit integers, with one scale per output unit
+ * (symmetric quantization), and the input is quantized to 8-bit integers with
+ * a single scale that is calibrated on sample inputs.  The products are
+ * accumulated in 32-bit integers, so that
+ *
+ * @f[
+ * y_i = s_i s_x \sum_j W_{ij} x_j + b_i,
+ * @f]
+ *
+ * where @f$ W @f$ and @f$ x @f$ are the quantized weights and input, and
+ * @f$ s_i @f$ and @f$ s_x @f$ are their scales.  The inputs outside of the
+ * calibrated range are clamped.  The bias stays in floating point.
+ *
+ * The layer has no trainable parameters; its backward pass uses the
+ * dequantized weights.  FFN::Quantize() replaces the Linear and LinearNoBias
+ * layers of a trained network with QuantizedLinear layers.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class QuantizedLinear
+{
+ public:
+  //! Create the QuantizedLinear object.
+  QuantizedLinear();
+
+  /**
+   * Create the QuantizedLinear layer object by quantizing the given weights.
+   *
+   * @param weight The weights of the linear layer (outSize x inSize).
+   * @param bias The bias of the linear layer (outSize x 1), or an empty matrix
+   *     for a layer without bias.
+   * @param inputRange The largest absolute value of the inputs of the layer,
+   *     as seen on the calibration data.
+   */
+  QuantizedLinear(const OutputDataType& weight,
+                  const OutputDataType& bias,
+                  const double inputRange);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  template<typename eT>
+  void Forward(const arma::Mat<eT>&& input, arma::Mat<eT>&& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f, with the dequantized weights.
+   *
+   * @param input The propagated input activation.
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  template<typename eT>
+  void Backward(const arma::Mat<eT>&& /* input */,
+                arma::Mat<eT>&& gy,
+                arma::Mat<eT>&& g);
+
+  //! Get the number of input units.
+  size_t InputSize() const { return inSize; }
+
+  //! Get the number of output units.
+  size_t OutputSize() const { return outSize; }
+
+  //! Get the quantized weights, stored row by row.
+  const std::vector<int8_t>& Weights() const { return weights; }
+
+  //! Get the scale of the weights of each output unit.
+  OutputDataType const& WeightScales() const { return weightScales; }
+
+  //! Get the scale of the input.
+  double InputScale() const { return inputScale; }
+
+  //! Get the bias (empty if the layer has no bias).
+  OutputDataType const& Bias() const { return bias; }
+
+  /**
+   * Get the weights as floating point values, that is the quantized weights
+   * multiplied by their scales.
+   */
+  OutputDataType DequantizedWeight() const;
+
+  //! Get the output parameter.
+  OutputDataType const& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType const& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  /**
+   * Serialize the layer
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Quantize the given value with the given scale, to [-127, 127].
+  static int8_t Quantize(const double value, const double scale);
+
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! The quantized weights, stored row by row so that each output unit is a
+  //! contiguous dot product.
+  std::vector<int8_t> weights;
+
+  //! The scale of the weights of each output unit.
+  OutputDataType weightScales;
+
+  //! The scale of the input.
+  double inputScale;
+
+  //! Locally-stored bias term parameters.
+  OutputDataType bias;
+
+  //! The quantized input of the last forward pass.
+  std::vector<int8_t> quantizedInput;
+
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class QuantizedLinear
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_linear_impl.hpp"
+
+#endif
@@ -0,0 +1,132 @@
+/**
+ * @file quantized_linear_impl.hpp
+ *
+ * Implementation of the QuantizedLinear layer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_linear.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear() :
+    inSize(0),
+    outSize(0),
+    inputScale(1.0)
+{
+  // Nothing to do here.
+}
+
+template<typename InputDataType, typename OutputDataType>
+QuantizedLinear<InputDataType, OutputDataType>::QuantizedLinear(
+    const OutputDataType& weight,
+    const OutputDataType& bias,
+    const double inputRange) :
+    inSize(weight.n_cols),
+    outSize(weight.n_rows),
+    inputScale((inputRange > 0) ? inputRange / 127.0 : 1.0),
+    bias(bias)
+{
+  if (!bias.is_empty() && bias.n_elem != outSize)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedLinear::QuantizedLinear(): the bias has " << bias.n_elem
+        << " elements, but the weights have " << outSize << " rows";
+    throw std::invalid_argument(oss.str());
+  }
+
+  weightScales.set_size(outSize, 1);
+  weights.resize(outSize * inSize);
+  for (size_t i = 0; i < outSize; ++i)
+  {
+    const double range = (inSize > 0) ? arma::abs(weight.row(i)).max() : 0.0;
+    weightScales[i] = (range > 0) ? range / 127.0 : 1.0;
+
+    for (size_t j = 0; j < inSize; ++j)
+      weights[i * inSize + j] = Quantize(weight(i, j), weightScales[i]);
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+int8_t QuantizedLinear<InputDataType, OutputDataType>::Quantize(
+    const double value, const double scale)
+{
+  const double quantized = std::round(value / scale);
+  return (int8_t) std::max(-127.0, std::min(127.0, quantized));
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Forward(
+    const arma::Mat<eT>&& input, arma::Mat<eT>&& output)
+{
+  quantizedInput.resize(input.n_elem);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    quantizedInput[i] = Quantize(input[i], inputScale);
+
+  output.set_size(outSize, input.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) input.n_cols; ++j)
+  {
+    const int8_t* x = quantizedInput.data() + j * inSize;
+    for (size_t i = 0; i < outSize; ++i)
+    {
+      const int8_t* w = weights.data() + i * inSize;
+      int32_t sum = 0;
+      for (size_t k = 0; k < inSize; ++k)
+        sum += int32_t(w[k]) * int32_t(x[k]);
+
+      output(i, j) = weightScales[i] * inputScale * sum;
+      if (!bias.is_empty())
+        output(i, j) += bias[i];
+    }
+  }
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename eT>
+void QuantizedLinear<InputDataType, OutputDataType>::Backward(
+    const arma::Mat<eT>&& /* input */, arma::Mat<eT>&& gy, arma::Mat<eT>&& g)
+{
+  g = DequantizedWeight().t() * gy;
+}
+
+template<typename InputDataType, typename OutputDataType>
+OutputDataType
+QuantizedLinear<InputDataType, OutputDataType>::DequantizedWeight() const
+{
+  OutputDataType weight(outSize, inSize);
+  for (size_t i = 0; i < outSize; ++i)
+    for (size_t j = 0; j < inSize; ++j)
+      weight(i, j) = weightScales[i] * weights[i * inSize + j];
+
+  return weight;
+}
+
+template<typename InputDataType, typename OutputDataType>
+template<typename Archive>
+void QuantizedLinear<InputDataType, OutputDataType>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(inSize);
+  ar & BOOST_SERIALIZATION_NVP(outSize);
+  ar & BOOST_SERIALIZATION_NVP(weights);
+  ar & BOOST_SERIALIZATION_NVP(weightScales);
+  ar & BOOST_SERIALIZATION_NVP(inputScale);
+  ar & BOOST_SERIALIZATION_NVP(bias);
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
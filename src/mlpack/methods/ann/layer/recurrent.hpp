@@ -111,8 +111,19 @@ class Recurrent
                 arma::Mat<eT>&& error,
                 arma::Mat<eT>&& /* gradient */);
 
+  /*
+   * Resets the cell to accept a new input. This breaks the BPTT chain starts a
+   * new one.
+   *
+   * @param size The current maximum number of steps through time.
+   */
+  void ResetCell(const size_t size);
+
   //! Get the model modules.
-  std::vector<LayerTypes<CustomLayers...> >& Model() { return network; }
+  std::vector<TypedLayerTypes<OutputDataType, CustomLayers...> >& Model()
+  {
+    return network;
+  }
 
     //! The value of the deterministic parameter.
   bool Deterministic() const { return deterministic; }
@@ -150,23 +161,26 @@ class Recurrent
   DeleteVisitor deleteVisitor;
 
   //! Locally-stored copy visitor
-  CopyVisitor<CustomLayers...> copyVisitor;
+  CopyVisitor<OutputDataType, CustomLayers...> copyVisitor;
 
   //! Locally-stored start module.
-  LayerTypes<CustomLayers...> startModule;
+  TypedLayerTypes<OutputDataType, CustomLayers...> startModule;
 
   //! Locally-stored input module.
-  LayerTypes<CustomLayers...> inputModule;
+  TypedLayerTypes<OutputDataType, CustomLayers...> inputModule;
 
   //! Locally-stored feedback module.
-  LayerTypes<CustomLayers...> feedbackModule;
+  TypedLayerTypes<OutputDataType, CustomLayers...> feedbackModule;
 
   //! Locally-stored transfer module.
-  LayerTypes<CustomLayers...> transferModule;
+  TypedLayerTypes<OutputDataType, CustomLayers...> transferModule;
 
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
 
+  //! Number of steps of the current sequences (at most rho).
+  size_t rhoSize;
+
   //! Locally-stored number of forward steps.
   size_t forwardStep;
 
@@ -187,25 +201,25 @@ class Recurrent
   OutputDataType parameters;
 
   //! Locally-stored initial module.
-  LayerTypes<CustomLayers...> initialModule;
+  TypedLayerTypes<OutputDataType, CustomLayers...> initialModule;
 
   //! Locally-stored recurrent module.
-  LayerTypes<CustomLayers...> recurrentModule;
+  TypedLayerTypes<OutputDataType, CustomLayers...> recurrentModule;
 
   //! Locally-stored model modules.
-  std::vector<LayerTypes<CustomLayers...> > network;
+  std::vector<TypedLayerTypes<OutputDataType, CustomLayers...> > network;
 
   //! Locally-stored merge module.
-  LayerTypes<CustomLayers...> mergeModule;
+  TypedLayerTypes<OutputDataType, CustomLayers...> mergeModule;
 
   //! Locally-stored delta visitor.
-  DeltaVisitor deltaVisitor;
+  DeltaVisitor<OutputDataType> deltaVisitor;
 
   //! Locally-stored output parameter visitor.
-  OutputParameterVisitor outputParameterVisitor;
+  OutputParameterVisitor<OutputDataType> outputParameterVisitor;
 
   //! Locally-stored feedback output parameters.
-  std::vector<arma::mat> feedbackOutputParameter;
+  std::vector<OutputDataType> feedbackOutputParameter;
 
   //! Locally-stored delta object.
   OutputDataType delta;
@@ -217,7 +231,7 @@ class Recurrent
   OutputDataType outputParameter;
 
   //! Locally-stored recurrent error parameter.
-  arma::mat recurrentError;
+  OutputDataType recurrentError;
 }; // class Recurrent
 
 } // namespace ann
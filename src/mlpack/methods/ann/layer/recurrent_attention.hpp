@@ -112,7 +112,7 @@ class RecurrentAttention
                 arma::Mat<eT>&& /* gradient */);
 
   //! Get the model modules.
-  std::vector<LayerTypes<>>& Model() { return network; }
+  std::vector<TypedLayerTypes<OutputDataType>>& Model() { return network; }
 
     //! The value of the deterministic parameter.
   bool Deterministic() const { return deterministic; }
@@ -154,20 +154,20 @@ class RecurrentAttention
     // Gradient of the action module.
     if (backwardStep == (rho - 1))
     {
-      boost::apply_visitor(GradientVisitor(std::move(initialInput),
-          std::move(actionError)), actionModule);
+      boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(
+          initialInput), std::move(actionError)), actionModule);
     }
     else
     {
-      boost::apply_visitor(GradientVisitor(std::move(boost::apply_visitor(
-          outputParameterVisitor, actionModule)), std::move(actionError)),
-          actionModule);
+      boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(
+          boost::apply_visitor(outputParameterVisitor, actionModule)),
+          std::move(actionError)), actionModule);
     }
 
     // Gradient of the recurrent module.
-    boost::apply_visitor(GradientVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, rnnModule)), std::move(recurrentError)),
-        rnnModule);
+    boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(
+        boost::apply_visitor(outputParameterVisitor, rnnModule)), std::move(
+        recurrentError)), rnnModule);
 
     attentionGradient += intermediateGradient;
   }
@@ -176,10 +176,10 @@ class RecurrentAttention
   size_t outSize;
 
   //! Locally-stored start module.
-  LayerTypes<> rnnModule;
+  TypedLayerTypes<OutputDataType> rnnModule;
 
   //! Locally-stored input module.
-  LayerTypes<> actionModule;
+  TypedLayerTypes<OutputDataType> actionModule;
 
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
@@ -197,22 +197,22 @@ class RecurrentAttention
   OutputDataType parameters;
 
   //! Locally-stored model modules.
-  std::vector<LayerTypes<>> network;
+  std::vector<TypedLayerTypes<OutputDataType>> network;
 
   //! Locally-stored weight size visitor.
   WeightSizeVisitor weightSizeVisitor;
 
   //! Locally-stored delta visitor.
-  DeltaVisitor deltaVisitor;
+  DeltaVisitor<OutputDataType> deltaVisitor;
 
   //! Locally-stored output parameter visitor.
-  OutputParameterVisitor outputParameterVisitor;
+  OutputParameterVisitor<OutputDataType> outputParameterVisitor;
 
   //! Locally-stored feedback output parameters.
-  std::vector<arma::mat> feedbackOutputParameter;
+  std::vector<OutputDataType> feedbackOutputParameter;
 
   //! List of all module parameters for the backward pass (BBTT).
-  std::vector<arma::mat> moduleOutputParameter;
+  std::vector<OutputDataType> moduleOutputParameter;
 
   //! Locally-stored delta object.
   OutputDataType delta;
@@ -224,28 +224,28 @@ class RecurrentAttention
   OutputDataType outputParameter;
 
   //! Locally-stored recurrent error parameter.
-  arma::mat recurrentError;
+  OutputDataType recurrentError;
 
   //! Locally-stored action error parameter.
-  arma::mat actionError;
+  OutputDataType actionError;
 
   //! Locally-stored action delta.
-  arma::mat actionDelta;
+  OutputDataType actionDelta;
 
   //! Locally-stored recurrent delta.
-  arma::mat rnnDelta;
+  OutputDataType rnnDelta;
 
   //! Locally-stored initial action input.
-  arma::mat initialInput;
+  OutputDataType initialInput;
 
   //! Locally-stored reset visitor.
   ResetVisitor resetVisitor;
 
   //! Locally-stored attention gradient.
-  arma::mat attentionGradient;
+  OutputDataType attentionGradient;
 
   //! Locally-stored intermediate gradient for the attention module.
-  arma::mat intermediateGradient;
+  OutputDataType intermediateGradient;
 }; // class RecurrentAttention
 
 } // namespace ann
@@ -28,6 +28,7 @@ template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 Recurrent<InputDataType, OutputDataType, CustomLayers...>::Recurrent() :
     rho(0),
+    rhoSize(0),
     forwardStep(0),
     backwardStep(0),
     gradientStep(0),
@@ -69,30 +70,32 @@ Recurrent<InputDataType, OutputDataType, CustomLayers...>::Recurrent(
     feedbackModule(new FeedbackModuleType(feedback)),
     transferModule(new TransferModuleType(transfer)),
     rho(rho),
+    rhoSize(rho),
     forwardStep(0),
     backwardStep(0),
     gradientStep(0),
     deterministic(false),
     ownsLayer(true)
 {
-  initialModule = new Sequential<>();
-  mergeModule = new AddMerge<>(false, false);
-  recurrentModule = new Sequential<>(false);
+  initialModule = new Sequential<InputDataType, OutputDataType>();
+  mergeModule = new AddMerge<InputDataType, OutputDataType>(false, false);
+  recurrentModule = new Sequential<InputDataType, OutputDataType>(false);
 
-  boost::apply_visitor(AddVisitor<CustomLayers...>(inputModule),
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(inputModule),
                        initialModule);
-  boost::apply_visitor(AddVisitor<CustomLayers...>(startModule),
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(startModule),
                        initialModule);
-  boost::apply_visitor(AddVisitor<CustomLayers...>(transferModule),
-                       initialModule);
-
-  boost::apply_visitor(AddVisitor<CustomLayers...>(inputModule), mergeModule);
-  boost::apply_visitor(AddVisitor<CustomLayers...>(feedbackModule),
-                       mergeModule);
-  boost::apply_visitor(AddVisitor<CustomLayers...>(mergeModule),
-                       recurrentModule);
-  boost::apply_visitor(AddVisitor<CustomLayers...>(transferModule),
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+      transferModule), initialModule);
+
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(inputModule),
+      mergeModule);
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+      feedbackModule), mergeModule);
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(mergeModule),
                        recurrentModule);
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+      transferModule), recurrentModule);
 
   network.push_back(initialModule);
   network.push_back(mergeModule);
@@ -105,6 +108,7 @@ template<typename InputDataType, typename OutputDataType,
 Recurrent<InputDataType, OutputDataType, CustomLayers...>::Recurrent(
     const Recurrent& network) :
     rho(network.rho),
+    rhoSize(network.rhoSize),
     forwardStep(network.forwardStep),
     backwardStep(network.backwardStep),
     gradientStep(network.gradientStep),
@@ -115,24 +119,25 @@ Recurrent<InputDataType, OutputDataType, CustomLayers...>::Recurrent(
   inputModule = boost::apply_visitor(copyVisitor, network.inputModule);
   feedbackModule = boost::apply_visitor(copyVisitor, network.feedbackModule);
   transferModule = boost::apply_visitor(copyVisitor, network.transferModule);
-  initialModule = new Sequential<>();
-  mergeModule = new AddMerge<>(false, false);
-  recurrentModule = new Sequential<>(false);
+  initialModule = new Sequential<InputDataType, OutputDataType>();
+  mergeModule = new AddMerge<InputDataType, OutputDataType>(false, false);
+  recurrentModule = new Sequential<InputDataType, OutputDataType>(false);
 
-  boost::apply_visitor(AddVisitor<CustomLayers...>(inputModule),
-                       initialModule);
-  boost::apply_visitor(AddVisitor<CustomLayers...>(startModule),
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(inputModule),
                        initialModule);
-  boost::apply_visitor(AddVisitor<CustomLayers...>(transferModule),
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(startModule),
                        initialModule);
-
-  boost::apply_visitor(AddVisitor<CustomLayers...>(inputModule), mergeModule);
-  boost::apply_visitor(AddVisitor<CustomLayers...>(feedbackModule),
-                       mergeModule);
-  boost::apply_visitor(AddVisitor<CustomLayers...>(mergeModule),
-                       recurrentModule);
-  boost::apply_visitor(AddVisitor<CustomLayers...>(transferModule),
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+      transferModule), initialModule);
+
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(inputModule),
+      mergeModule);
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+      feedbackModule), mergeModule);
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(mergeModule),
                        recurrentModule);
+  boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+      transferModule), recurrentModule);
   this->network.push_back(initialModule);
   this->network.push_back(mergeModule);
   this->network.push_back(feedbackModule);
@@ -147,22 +152,22 @@ void Recurrent<InputDataType, OutputDataType, CustomLayers...>::Forward(
 {
   if (forwardStep == 0)
   {
-    boost::apply_visitor(ForwardVisitor(std::move(input), std::move(output)),
-        initialModule);
+    boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(input),
+        std::move(output)), initialModule);
   }
   else
   {
-    boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
-        boost::apply_visitor(outputParameterVisitor, inputModule))),
+    boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(input),
+        std::move(boost::apply_visitor(outputParameterVisitor, inputModule))),
         inputModule);
 
-    boost::apply_visitor(ForwardVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, transferModule)), std::move(
-        boost::apply_visitor(outputParameterVisitor, feedbackModule))),
-        feedbackModule);
+    boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(
+        boost::apply_visitor(outputParameterVisitor, transferModule)),
+        std::move(boost::apply_visitor(outputParameterVisitor,
+        feedbackModule))), feedbackModule);
 
-    boost::apply_visitor(ForwardVisitor(std::move(input), std::move(output)),
-        recurrentModule);
+    boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(input),
+        std::move(output)), recurrentModule);
   }
 
   output = boost::apply_visitor(outputParameterVisitor, transferModule);
@@ -174,7 +179,7 @@ void Recurrent<InputDataType, OutputDataType, CustomLayers...>::Forward(
   }
 
   forwardStep++;
-  if (forwardStep == rho)
+  if (forwardStep == rhoSize)
   {
     forwardStep = 0;
     backwardStep = 0;
@@ -201,28 +206,29 @@ void Recurrent<InputDataType, OutputDataType, CustomLayers...>::Backward(
     recurrentError = gy;
   }
 
-  if (backwardStep < (rho - 1))
+  if (backwardStep < (rhoSize - 1))
   {
-    boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, recurrentModule)), std::move(recurrentError),
-        std::move(boost::apply_visitor(deltaVisitor, recurrentModule))),
-        recurrentModule);
+    boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+        boost::apply_visitor(outputParameterVisitor, recurrentModule)),
+        std::move(recurrentError), std::move(boost::apply_visitor(deltaVisitor,
+        recurrentModule))), recurrentModule);
 
-    boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, inputModule)), std::move(
+    boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+        boost::apply_visitor(outputParameterVisitor, inputModule)), std::move(
         boost::apply_visitor(deltaVisitor, recurrentModule)), std::move(g)),
         inputModule);
 
-    boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, feedbackModule)), std::move(
-        boost::apply_visitor(deltaVisitor, recurrentModule)), std::move(
-        boost::apply_visitor(deltaVisitor, feedbackModule))), feedbackModule);
+    boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+        boost::apply_visitor(outputParameterVisitor, feedbackModule)),
+        std::move(boost::apply_visitor(deltaVisitor, recurrentModule)),
+        std::move(boost::apply_visitor(deltaVisitor, feedbackModule))),
+        feedbackModule);
   }
   else
   {
-    boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, initialModule)), std::move(recurrentError),
-        std::move(g)), initialModule);
+    boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+        boost::apply_visitor(outputParameterVisitor, initialModule)), std::move(
+        recurrentError), std::move(g)), initialModule);
   }
 
   recurrentError = boost::apply_visitor(deltaVisitor, feedbackModule);
@@ -237,37 +243,59 @@ void Recurrent<InputDataType, OutputDataType, CustomLayers...>::Gradient(
     arma::Mat<eT>&& error,
     arma::Mat<eT>&& /* gradient */)
 {
-  if (gradientStep < (rho - 1))
+  if (gradientStep < (rhoSize - 1))
   {
-    boost::apply_visitor(GradientVisitor(std::move(input), std::move(error)),
-        recurrentModule);
+    boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(input),
+        std::move(error)), recurrentModule);
 
-    boost::apply_visitor(GradientVisitor(std::move(input), std::move(
-        boost::apply_visitor(deltaVisitor, mergeModule))), inputModule);
+    boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(input),
+        std::move(boost::apply_visitor(deltaVisitor, mergeModule))),
+        inputModule);
 
-    boost::apply_visitor(GradientVisitor(std::move(
+    boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(
         feedbackOutputParameter[feedbackOutputParameter.size() - 2 -
         gradientStep]), std::move(boost::apply_visitor(deltaVisitor,
         mergeModule))), feedbackModule);
   }
   else
   {
-    boost::apply_visitor(GradientZeroVisitor(), recurrentModule);
-    boost::apply_visitor(GradientZeroVisitor(), inputModule);
-    boost::apply_visitor(GradientZeroVisitor(), feedbackModule);
+    boost::apply_visitor(GradientZeroVisitor<OutputDataType>(),
+        recurrentModule);
+    boost::apply_visitor(GradientZeroVisitor<OutputDataType>(), inputModule);
+    boost::apply_visitor(GradientZeroVisitor<OutputDataType>(), feedbackModule);
 
-    boost::apply_visitor(GradientVisitor(std::move(input), std::move(
-        boost::apply_visitor(deltaVisitor, startModule))), initialModule);
+    boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(input),
+        std::move(boost::apply_visitor(deltaVisitor, startModule))),
+        initialModule);
   }
 
   gradientStep++;
-  if (gradientStep == rho)
+  if (gradientStep == rhoSize)
   {
     gradientStep = 0;
     feedbackOutputParameter.clear();
   }
 }
 
+template<typename InputDataType, typename OutputDataType,
+         typename... CustomLayers>
+void Recurrent<InputDataType, OutputDataType, CustomLayers...>::ResetCell(
+    const size_t size)
+{
+  // Shorter sequences end the BPTT chain early.
+  rhoSize = std::min(rho, size);
+
+  forwardStep = 0;
+  backwardStep = 0;
+  gradientStep = 0;
+  feedbackOutputParameter.clear();
+
+  if (!recurrentError.is_empty())
+  {
+    recurrentError.zeros();
+  }
+}
+
 template<typename InputDataType, typename OutputDataType,
          typename... CustomLayers>
 template<typename Archive>
@@ -291,28 +319,31 @@ void Recurrent<InputDataType, OutputDataType, CustomLayers...>::serialize(
   ar & BOOST_SERIALIZATION_NVP(rho);
   ar & BOOST_SERIALIZATION_NVP(ownsLayer);
 
+  if (Archive::is_loading::value)
+    rhoSize = rho;
+
   // Set up the network.
   if (Archive::is_loading::value)
   {
-    initialModule = new Sequential<>();
-    mergeModule = new AddMerge<>(false, false);
-    recurrentModule = new Sequential<>(false);
-
-    boost::apply_visitor(AddVisitor<CustomLayers...>(inputModule),
-                         initialModule);
-    boost::apply_visitor(AddVisitor<CustomLayers...>(startModule),
-                         initialModule);
-    boost::apply_visitor(AddVisitor<CustomLayers...>(transferModule),
-                         initialModule);
-
-    boost::apply_visitor(AddVisitor<CustomLayers...>(inputModule),
-                         mergeModule);
-    boost::apply_visitor(AddVisitor<CustomLayers...>(feedbackModule),
-                         mergeModule);
-    boost::apply_visitor(AddVisitor<CustomLayers...>(mergeModule),
-                         recurrentModule);
-    boost::apply_visitor(AddVisitor<CustomLayers...>(transferModule),
-                         recurrentModule);
+    initialModule = new Sequential<InputDataType, OutputDataType>();
+    mergeModule = new AddMerge<InputDataType, OutputDataType>(false, false);
+    recurrentModule = new Sequential<InputDataType, OutputDataType>(false);
+
+    boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+        inputModule), initialModule);
+    boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+        startModule), initialModule);
+    boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+        transferModule), initialModule);
+
+    boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+        inputModule), mergeModule);
+    boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+        feedbackModule), mergeModule);
+    boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+        mergeModule), recurrentModule);
+    boost::apply_visitor(AddVisitor<OutputDataType, CustomLayers...>(
+        transferModule), recurrentModule);
 
     network.push_back(initialModule);
     network.push_back(mergeModule);
@@ -103,7 +103,7 @@ class ReinforceNormal
   OutputDataType outputParameter;
 
   //!  Locally-stored output module parameter parameters.
-  std::vector<arma::mat> moduleInputParameter;
+  std::vector<InputDataType> moduleInputParameter;
 
   //! If true use maximum a posteriori during the forward pass.
   bool deterministic;
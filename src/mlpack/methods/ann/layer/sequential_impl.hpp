@@ -16,6 +16,8 @@
 // In case it hasn't yet been included.
 #include "sequential.hpp"
 
+#include <mlpack/core/math/make_alias.hpp>
+
 #include "../visitor/forward_visitor.hpp"
 #include "../visitor/backward_visitor.hpp"
 #include "../visitor/gradient_visitor.hpp"
@@ -41,7 +43,7 @@ Sequential<
 {
   if (!model)
   {
-    for (LayerTypes<CustomLayers...>& layer : network)
+    for (TypedLayerTypes<OutputDataType, CustomLayers...>& layer : network)
       boost::apply_visitor(deleteVisitor, layer);
   }
 }
@@ -53,8 +55,8 @@ void Sequential<
     InputDataType, OutputDataType, Residual, CustomLayers...>::Forward(
         arma::Mat<eT>&& input, arma::Mat<eT>&& output)
 {
-  boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
-      boost::apply_visitor(outputParameterVisitor, network.front()))),
+  boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(input),
+      std::move(boost::apply_visitor(outputParameterVisitor, network.front()))),
       network.front());
 
   if (!reset)
@@ -81,9 +83,9 @@ void Sequential<
       boost::apply_visitor(SetInputHeightVisitor(height), network[i]);
     }
 
-    boost::apply_visitor(ForwardVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, network[i - 1])), std::move(
-        boost::apply_visitor(outputParameterVisitor, network[i]))),
+    boost::apply_visitor(ForwardVisitor<OutputDataType>(std::move(
+        boost::apply_visitor(outputParameterVisitor, network[i - 1])),
+        std::move(boost::apply_visitor(outputParameterVisitor, network[i]))),
         network[i]);
 
     if (!reset)
@@ -107,10 +109,9 @@ void Sequential<
     reset = true;
   }
 
-  output = boost::apply_visitor(outputParameterVisitor, network.back());
-
   if (Residual)
   {
+    output = boost::apply_visitor(outputParameterVisitor, network.back());
     if (arma::size(output) != arma::size(input))
     {
       Log::Fatal << "The sizes of the output and input matrices of the Residual"
@@ -119,6 +120,13 @@ void Sequential<
     }
     output += input;
   }
+  else
+  {
+    // The output is an alias of the output of the last layer, which is only
+    // changed by the next forward pass, so that it is not copied.
+    output = math::MakeAlias(boost::apply_visitor(outputParameterVisitor,
+        network.back()), false);
+  }
 }
 
 template<typename InputDataType, typename OutputDataType, bool Residual,
@@ -130,26 +138,32 @@ void Sequential<
         arma::Mat<eT>&& gy,
         arma::Mat<eT>&& g)
 {
-  boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-      outputParameterVisitor, network.back())), std::move(gy),
-      std::move(boost::apply_visitor(deltaVisitor, network.back()))),
+  boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+      boost::apply_visitor(outputParameterVisitor, network.back())), std::move(
+      gy), std::move(boost::apply_visitor(deltaVisitor, network.back()))),
       network.back());
 
   for (size_t i = 2; i < network.size() + 1; ++i)
   {
-    boost::apply_visitor(BackwardVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, network[network.size() - i])), std::move(
-        boost::apply_visitor(deltaVisitor, network[network.size() - i + 1])),
-        std::move(boost::apply_visitor(deltaVisitor,
-        network[network.size() - i]))), network[network.size() - i]);
+    boost::apply_visitor(BackwardVisitor<OutputDataType>(std::move(
+        boost::apply_visitor(outputParameterVisitor,
+        network[network.size() - i])), std::move(boost::apply_visitor(
+        deltaVisitor, network[network.size() - i + 1])), std::move(
+        boost::apply_visitor(deltaVisitor, network[network.size() - i]))),
+        network[network.size() - i]);
   }
 
-  g = boost::apply_visitor(deltaVisitor, network.front());
-
   if (Residual)
   {
+    g = boost::apply_visitor(deltaVisitor, network.front());
     g += gy;
   }
+  else
+  {
+    // As in Forward(), alias the delta of the first layer.
+    g = math::MakeAlias(boost::apply_visitor(deltaVisitor, network.front()),
+        false);
+  }
 }
 
 template<typename InputDataType, typename OutputDataType, bool Residual,
@@ -161,20 +175,22 @@ void Sequential<
         arma::Mat<eT>&& error,
         arma::Mat<eT>&& /* gradient */)
 {
-  boost::apply_visitor(GradientVisitor(std::move(boost::apply_visitor(
-      outputParameterVisitor, network[network.size() - 2])), std::move(error)),
-      network.back());
+  boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(
+      boost::apply_visitor(outputParameterVisitor,
+      network[network.size() - 2])), std::move(error)), network.back());
 
   for (size_t i = 2; i < network.size(); ++i)
   {
-    boost::apply_visitor(GradientVisitor(std::move(boost::apply_visitor(
-        outputParameterVisitor, network[network.size() - i - 1])), std::move(
-        boost::apply_visitor(deltaVisitor, network[network.size() - i + 1]))),
+    boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(
+        boost::apply_visitor(outputParameterVisitor,
+        network[network.size() - i - 1])), std::move(boost::apply_visitor(
+        deltaVisitor, network[network.size() - i + 1]))),
         network[network.size() - i]);
   }
 
-  boost::apply_visitor(GradientVisitor(std::move(input), std::move(
-      boost::apply_visitor(deltaVisitor, network[1]))), network.front());
+  boost::apply_visitor(GradientVisitor<OutputDataType>(std::move(input),
+      std::move(boost::apply_visitor(deltaVisitor, network[1]))),
+      network.front());
 }
 
 template <typename InputDataType, typename OutputDataType, bool Residual,
@@ -184,7 +200,7 @@ void Sequential<
 {
   if (model == true)
   {
-    for (LayerTypes<CustomLayers...>& layer : network)
+    for (TypedLayerTypes<OutputDataType, CustomLayers...>& layer : network)
     {
       boost::apply_visitor(deleteVisitor, layer);
     }
@@ -201,7 +217,7 @@ void Sequential<
   // If loading, delete the old layers.
   if (Archive::is_loading::value)
   {
-    for (LayerTypes<CustomLayers...>& layer : network)
+    for (TypedLayerTypes<OutputDataType, CustomLayers...>& layer : network)
     {
       boost::apply_visitor(deleteVisitor, layer);
     }
@@ -0,0 +1,118 @@
+/**
+ * @file softmax_cross_entropy_error.hpp
+ *
+ * Definition of the softmax cross-entropy performance function, which fuses
+ * the LogSoftMax layer and the NegativeLogLikelihood output layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LOSS_FUNCTION_SOFTMAX_CROSS_ENTROPY_ERROR_HPP
+#define MLPACK_METHODS_ANN_LOSS_FUNCTION_SOFTMAX_CROSS_ENTROPY_ERROR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The SoftmaxCrossEntropyError performance function computes the negative log
+ * likelihood of the softmax of its input, so a network ending with
+ * LogSoftMax<> and trained with NegativeLogLikelihood<> can instead end with
+ * its last linear layer and be trained with this output layer.  The loss of
+ * a column x with target class t is computed in a numerically stable way as
+ *
+ * \f$ \log \sum_j e^{x_j - m} + m - x_t, \quad m = \max_j x_j, \f$
+ *
+ * and the gradient is directly p - y, the softmax p of x minus the one-hot
+ * target y, so no log-probabilities or intermediate deltas are stored and
+ * each column is visited once per pass; the columns are processed in
+ * parallel.  As with NegativeLogLikelihood, the target contains class indices
+ * in the range between 1 and the number of classes.
+ *
+ * Since the network no longer ends with LogSoftMax, FFN::Predict() returns
+ * the unnormalized scores; the predicted class (the largest score) is the
+ * same.
+ *
+ * @tparam InputDataType Type of the input data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ * @tparam OutputDataType Type of the output data (arma::colvec, arma::mat,
+ *         arma::sp_mat or arma::cube).
+ */
+template <
+    typename InputDataType = arma::mat,
+    typename OutputDataType = arma::mat
+>
+class SoftmaxCrossEntropyError
+{
+ public:
+  /**
+   * Create the SoftmaxCrossEntropyError object.
+   */
+  SoftmaxCrossEntropyError();
+
+  /**
+   * Computes the softmax cross-entropy of the input.
+   *
+   * @param input Input scores used for evaluating the specified function.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   */
+  template<typename InputType, typename TargetType>
+  double Forward(const InputType&& input, TargetType&& target);
+
+  /**
+   * Ordinary feed backward pass of a neural network, which computes the
+   * softmax of the input minus the one-hot target.
+   *
+   * @param input The propagated input activation.
+   * @param target The target vector, that contains the class index in the range
+   *        between 1 and the number of classes.
+   * @param output The calculated error.
+   */
+  template<typename InputType, typename TargetType, typename OutputType>
+  void Backward(const InputType&& input,
+                const TargetType&& target,
+                OutputType&& output);
+
+  //! Get the input parameter.
+  InputDataType& InputParameter() const { return inputParameter; }
+  //! Modify the input parameter.
+  InputDataType& InputParameter() { return inputParameter; }
+
+  //! Get the output parameter.
+  OutputDataType& OutputParameter() const { return outputParameter; }
+  //! Modify the output parameter.
+  OutputDataType& OutputParameter() { return outputParameter; }
+
+  //! Get the delta.
+  OutputDataType& Delta() const { return delta; }
+  //! Modify the delta.
+  OutputDataType& Delta() { return delta; }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& /* ar */, const unsigned int /* version */);
+
+ private:
+  //! Locally-stored delta object.
+  OutputDataType delta;
+
+  //! Locally-stored input parameter object.
+  InputDataType inputParameter;
+
+  //! Locally-stored output parameter object.
+  OutputDataType outputParameter;
+}; // class SoftmaxCrossEntropyError
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "softmax_cross_entropy_error_impl.hpp"
+
+#endif
@@ -0,0 +1,140 @@
+/**
+ * @file network_profile.cpp
+ *
+ * Implementation of the NetworkProfile class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "network_profile.hpp"
+
+#include <iomanip>
+
+using namespace mlpack;
+using namespace mlpack::ann;
+
+NetworkProfile::NetworkProfile(const size_t maxEvents) :
+    enabled(false),
+    maxEvents(maxEvents)
+{
+  Clear();
+}
+
+void NetworkProfile::Clear()
+{
+  origin = Clock::now();
+  names.clear();
+  calls.set_size(3, 0);
+  seconds.set_size(3, 0);
+  flops.set_size(3, 0);
+  bytes.set_size(0);
+  events.clear();
+}
+
+void NetworkProfile::AddLayer(const size_t index, const std::string& name)
+{
+  // The new elements are set to zero by resize().
+  if (index >= names.size())
+  {
+    names.resize(index + 1);
+    calls.resize(3, index + 1);
+    seconds.resize(3, index + 1);
+    flops.resize(3, index + 1);
+    bytes.resize(index + 1);
+  }
+
+  names[index] = name;
+}
+
+void NetworkProfile::RecordCall(const size_t index,
+                                const Pass pass,
+                                const Clock::time_point begin,
+                                const Clock::time_point end,
+                                const double callFlops,
+                                const size_t callBytes)
+{
+  const double duration = std::chrono::duration<double>(end - begin).count();
+
+  ++calls(pass, index);
+  seconds(pass, index) += duration;
+  flops(pass, index) += callFlops;
+  bytes[index] = std::max(bytes[index], callBytes);
+
+  if (events.size() < maxEvents)
+  {
+    Event event;
+    event.layer = index;
+    event.pass = pass;
+    event.begin = std::chrono::duration<double, std::micro>(begin -
+        origin).count();
+    event.duration = 1e6 * duration;
+    events.push_back(event);
+  }
+}
+
+void NetworkProfile::PrintTable(std::ostream& stream) const
+{
+  const std::ios_base::fmtflags flags = stream.flags();
+  const std::streamsize precision = stream.precision();
+  const double total = arma::accu(seconds);
+
+  stream << std::right << std::setw(5) << "index" << "  " << std::left
+      << std::setw(20) << "layer" << std::right
+      << std::setw(10) << "calls"
+      << std::setw(14) << "forward (s)"
+      << std::setw(14) << "backward (s)"
+      << std::setw(14) << "gradient (s)"
+      << std::setw(9) << "time %"
+      << std::setw(12) << "GFLOP"
+      << std::setw(10) << "GFLOP/s"
+      << std::setw(13) << "memory (MB)" << std::endl;
+
+  for (size_t i = 0; i < names.size(); ++i)
+  {
+    const double layerSeconds = arma::accu(seconds.col(i));
+    const double layerFlops = arma::accu(flops.col(i));
+
+    stream << std::right << std::setw(5) << i << "  " << std::left
+        << std::setw(20) << names[i] << std::right
+        << std::setw(10) << calls(FORWARD, i)
+        << std::fixed << std::setprecision(6)
+        << std::setw(14) << seconds(FORWARD, i)
+        << std::setw(14) << seconds(BACKWARD, i)
+        << std::setw(14) << seconds(GRADIENT, i)
+        << std::setprecision(2)
+        << std::setw(9) << ((total > 0) ? 100.0 * layerSeconds / total : 0.0)
+        << std::setprecision(3)
+        << std::setw(12) << 1e-9 * layerFlops
+        << std::setw(10) << ((layerSeconds > 0) ? 1e-9 * layerFlops /
+            layerSeconds : 0.0)
+        << std::setw(13) << bytes[i] / (1024.0 * 1024.0) << std::endl;
+  }
+
+  stream << "total time: " << std::setprecision(6) << total << " s"
+      << std::endl;
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
+void NetworkProfile::PrintChromeTrace(std::ostream& stream) const
+{
+  const std::ios_base::fmtflags flags = stream.flags();
+  const std::streamsize precision = stream.precision();
+  const char* passNames[] = { "forward", "backward", "gradient" };
+
+  stream << "{\"traceEvents\": [";
+  for (size_t i = 0; i < events.size(); ++i)
+  {
+    const Event& event = events[i];
+    stream << ((i == 0) ? "\n" : ",\n") << "  {\"name\": \""
+        << names[event.layer] << " (" << event.layer << ")\", \"cat\": \""
+        << passNames[event.pass] << "\", \"ph\": \"X\", \"ts\": "
+        << std::fixed << std::setprecision(3) << event.begin << ", \"dur\": "
+        << event.duration << ", \"pid\": 0, \"tid\": 0}";
+  }
+  stream << "\n], \"displayTimeUnit\": \"ms\"}" << std::endl;
+  stream.flags(flags);
+  stream.precision(precision);
+}
@@ -0,0 +1,209 @@
+/**
+ * @file network_profile.hpp
+ *
+ * Definition of the NetworkProfile class, which records the time spent in each
+ * layer of a neural network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_NETWORK_PROFILE_HPP
+#define MLPACK_METHODS_ANN_NETWORK_PROFILE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <chrono>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The NetworkProfile class records, for each layer of a network and for each
+ * of the forward, backward and gradient passes, the number of calls, the wall
+ * time, an estimate of the number of floating point operations, and the memory
+ * held by the output and the delta of the layer.  FFN and RNN hold a
+ * NetworkProfile, which records nothing until it is enabled:
+ *
+ * @code
+ * model.Profile().Enabled() = true;
+ * model.Train(trainData, trainLabels);
+ *
+ * model.Profile().PrintTable(std::cout);
+ *
+ * std::ofstream trace("trace.json");
+ * model.Profile().PrintChromeTrace(trace);
+ * @endcode
+ *
+ * PrintChromeTrace() writes every call as an event in the Chrome trace event
+ * format, which can be loaded in chrome://tracing or in Perfetto.  Only the
+ * first MaxEvents() calls are kept as events; the totals include all the
+ * calls.
+ *
+ * The number of floating point operations is a dense estimate: two per weight
+ * and per point for the layers with weights, and otherwise one per element of
+ * the output (forward pass) or of the delta (backward pass).  Layers that share
+ * their weights across a point, like convolutions, are underestimated.
+ */
+class NetworkProfile
+{
+ public:
+  //! The passes of the layers that are profiled.
+  enum Pass
+  {
+    FORWARD = 0,
+    BACKWARD = 1,
+    GRADIENT = 2
+  };
+
+  //! The clock used to time the layers.
+  typedef std::chrono::steady_clock Clock;
+
+  /**
+   * Create an empty, disabled profile.
+   *
+   * @param maxEvents The maximum number of calls kept as events for
+   *     PrintChromeTrace().
+   */
+  NetworkProfile(const size_t maxEvents = 1000000);
+
+  //! Get whether the networks record their layers in the profile.
+  bool Enabled() const { return enabled; }
+  //! Modify whether the networks record their layers in the profile.
+  bool& Enabled() { return enabled; }
+
+  //! Get the maximum number of calls kept as events.
+  size_t MaxEvents() const { return maxEvents; }
+  //! Modify the maximum number of calls kept as events.
+  size_t& MaxEvents() { return maxEvents; }
+
+  //! Remove everything that was recorded, and restart the clock of the events.
+  void Clear();
+
+  /**
+   * Record a pass of the layer with the given index that started at the given
+   * time and ends now.
+   *
+   * @tparam MatType Matrix type of the network.
+   * @tparam LayerVariantType Type of the variant holding the layer.
+   * @param index Index of the layer in the network.
+   * @param pass The pass that was run.
+   * @param begin The time at which the pass started.
+   * @param layer The layer.
+   */
+  template<typename MatType, typename LayerVariantType>
+  void Record(const size_t index,
+              const Pass pass,
+              const Clock::time_point begin,
+              LayerVariantType& layer);
+
+  //! Get the number of layers that were recorded.
+  size_t NumLayers() const { return names.size(); }
+
+  //! Get the name of the type of the given layer.
+  const std::string& Name(const size_t index) const { return names[index]; }
+
+  //! Get the number of calls of the given pass of the given layer.
+  size_t Calls(const size_t index, const Pass pass) const
+  {
+    return calls(pass, index);
+  }
+
+  //! Get the time in seconds spent in the given pass of the given layer.
+  double Seconds(const size_t index, const Pass pass) const
+  {
+    return seconds(pass, index);
+  }
+
+  //! Get the estimated number of floating point operations of the given pass
+  //! of the given layer.
+  double Flops(const size_t index, const Pass pass) const
+  {
+    return flops(pass, index);
+  }
+
+  //! Get the largest number of bytes held by the output and the delta of the
+  //! given layer.
+  size_t Bytes(const size_t index) const { return bytes[index]; }
+
+  //! Get the number of calls kept as events.
+  size_t NumEvents() const { return events.size(); }
+
+  /**
+   * Print a table of the layers, with their number of calls, their time in
+   * each pass, their share of the total time, their estimated floating point
+   * operations and their memory.
+   *
+   * @param stream Stream to print the table to.
+   */
+  void PrintTable(std::ostream& stream) const;
+
+  /**
+   * Print the calls in the JSON trace event format of Chrome, with one event
+   * per call.
+   *
+   * @param stream Stream to print the trace to.
+   */
+  void PrintChromeTrace(std::ostream& stream) const;
+
+ private:
+  //! A recorded call of a pass of a layer.
+  struct Event
+  {
+    //! The index of the layer.
+    size_t layer;
+    //! The pass.
+    Pass pass;
+    //! The start of the call, in microseconds since the clock was started.
+    double begin;
+    //! The duration of the call, in microseconds.
+    double duration;
+  };
+
+  //! Record a call, once the layer has been described.
+  void RecordCall(const size_t index,
+                  const Pass pass,
+                  const Clock::time_point begin,
+                  const Clock::time_point end,
+                  const double callFlops,
+                  const size_t callBytes);
+
+  //! Make room for the given layer, with the given name.
+  void AddLayer(const size_t index, const std::string& name);
+
+  //! Whether the networks record their layers.
+  bool enabled;
+
+  //! The maximum number of calls kept as events.
+  size_t maxEvents;
+
+  //! The time at which the clock of the events was started.
+  Clock::time_point origin;
+
+  //! The names of the layers.
+  std::vector<std::string> names;
+
+  //! The number of calls of each pass (rows) of each layer (columns).
+  arma::Mat<size_t> calls;
+
+  //! The time in seconds of each pass (rows) of each layer (columns).
+  arma::mat seconds;
+
+  //! The estimated operations of each pass (rows) of each layer (columns).
+  arma::mat flops;
+
+  //! The largest memory held by each layer.
+  arma::Col<size_t> bytes;
+
+  //! The recorded calls.
+  std::vector<Event> events;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "network_profile_impl.hpp"
+
+#endif
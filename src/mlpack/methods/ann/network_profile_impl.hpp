@@ -0,0 +1,57 @@
+/**
+ * @file network_profile_impl.hpp
+ *
+ * Implementation of the templated functions of the NetworkProfile class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_NETWORK_PROFILE_IMPL_HPP
+#define MLPACK_METHODS_ANN_NETWORK_PROFILE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "network_profile.hpp"
+
+#include "visitor/delta_visitor.hpp"
+#include "visitor/layer_name_visitor.hpp"
+#include "visitor/output_parameter_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename MatType, typename LayerVariantType>
+void NetworkProfile::Record(const size_t index,
+                            const Pass pass,
+                            const Clock::time_point begin,
+                            LayerVariantType& layer)
+{
+  // Stop the clock before the layer is described.
+  const Clock::time_point end = Clock::now();
+
+  if (index >= names.size() || names[index].empty())
+    AddLayer(index, boost::apply_visitor(LayerNameVisitor(), layer));
+
+  const MatType& output = boost::apply_visitor(
+      OutputParameterVisitor<MatType>(), layer);
+  const MatType& delta = boost::apply_visitor(DeltaVisitor<MatType>(), layer);
+  const size_t weights = boost::apply_visitor(WeightSizeVisitor(), layer);
+
+  double callFlops = 0;
+  if (weights > 0)
+    callFlops = 2.0 * weights * output.n_cols;
+  else if (pass == FORWARD)
+    callFlops = output.n_elem;
+  else if (pass == BACKWARD)
+    callFlops = delta.n_elem;
+
+  RecordCall(index, pass, begin, end, callFlops, (output.n_elem +
+      delta.n_elem) * sizeof(typename MatType::elem_type));
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @file quantization_agreement.hpp
+ *
+ * Comparison of the predictions of a quantized network with those of the
+ * original network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZATION_AGREEMENT_HPP
+#define MLPACK_METHODS_ANN_QUANTIZATION_AGREEMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Compare the predictions of a network quantized with FFN::Quantize() with
+ * those of the original network on the given points.
+ *
+ * @code
+ * FFN<> quantized(model);
+ * quantized.Quantize(calibration);
+ *
+ * double maxError;
+ * const double agreement = QuantizationAgreement(model, quantized, testData,
+ *     maxError);
+ * @endcode
+ *
+ * @param original The original network.
+ * @param quantized The quantized network.
+ * @param data The points to predict.
+ * @param maxError Set to the largest absolute difference between the outputs
+ *     of the two networks.
+ * @return The fraction of the points for which both networks predict the same
+ *     class, that is the same row for the largest output.
+ */
+template<typename OriginalNetworkType,
+         typename QuantizedNetworkType,
+         typename MatType>
+double QuantizationAgreement(OriginalNetworkType& original,
+                             QuantizedNetworkType& quantized,
+                             const MatType& data,
+                             double& maxError)
+{
+  MatType originalPredictions, quantizedPredictions;
+  original.Predict(data, originalPredictions);
+  quantized.Predict(data, quantizedPredictions);
+
+  if (originalPredictions.n_rows != quantizedPredictions.n_rows ||
+      originalPredictions.n_cols != quantizedPredictions.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "QuantizationAgreement(): the original network predicts "
+        << originalPredictions.n_rows << "x" << originalPredictions.n_cols
+        << " outputs, but the quantized network predicts "
+        << quantizedPredictions.n_rows << "x" << quantizedPredictions.n_cols;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols == 0)
+  {
+    maxError = 0.0;
+    return 1.0;
+  }
+
+  maxError = arma::abs(originalPredictions - quantizedPredictions).max();
+
+  size_t agreeing = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    arma::uword originalClass, quantizedClass;
+    originalPredictions.col(i).max(originalClass);
+    quantizedPredictions.col(i).max(quantizedClass);
+    if (originalClass == quantizedClass)
+      ++agreeing;
+  }
+
+  return double(agreeing) / data.n_cols;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
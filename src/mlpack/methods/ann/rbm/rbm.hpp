@@ -13,6 +13,7 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/ann/rbm/rbm_policies.hpp>
+#include <mlpack/methods/ann/rbm/rbm_sampling.hpp>
 
 namespace mlpack {
 namespace ann /** Artificial Neural Network. */ {
@@ -375,6 +376,20 @@ class RBM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Replace each element of the given matrix by a sample drawn with the given
+   * function, called as sample(generator, value) with a std::mt19937.  Large
+   * matrices are split in fixed blocks of elements that are sampled in
+   * parallel, each with its own generator seeded in order from math::randGen,
+   * so the samples only depend on the random seed, not on the number of
+   * threads.
+   *
+   * @param values The values to replace by their samples.
+   * @param sample The function that draws the sample of a value.
+   */
+  template<typename SampleFunctionType>
+  void Sample(arma::Mat<ElemType>& values, const SampleFunctionType& sample);
+
   //! Locally stored parameters of the network.
   arma::Mat<ElemType> parameter;
   //! The matrix of data points (predictors).
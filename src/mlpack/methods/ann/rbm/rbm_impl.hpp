@@ -156,6 +156,43 @@ double RBM<InitializationRuleType, DataType, PolicyType>::Evaluate(
       i + batchSize - 1))) - FreeEnergy(std::move(negativeSamples)));
 }
 
+template<
+  typename InitializationRuleType,
+  typename DataType,
+  typename PolicyType
+>
+template<typename SampleFunctionType>
+void RBM<InitializationRuleType, DataType, PolicyType>::Sample(
+    arma::Mat<ElemType>& values,
+    const SampleFunctionType& sample)
+{
+  const size_t blockSize = 4096;
+  if (values.n_elem <= blockSize)
+  {
+    for (size_t i = 0; i < values.n_elem; ++i)
+      values[i] = sample(math::randGen, values[i]);
+
+    return;
+  }
+
+  // The blocks don't depend on the number of threads, and their seeds are
+  // drawn before sampling, so the samples only depend on the random seed.
+  const size_t numBlocks = (values.n_elem + blockSize - 1) / blockSize;
+  std::vector<std::mt19937::result_type> seeds(numBlocks);
+  for (size_t b = 0; b < numBlocks; ++b)
+    seeds[b] = math::randGen();
+
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    std::mt19937 generator(seeds[b]);
+    const size_t end = std::min((size_t) (b + 1) * blockSize,
+        (size_t) values.n_elem);
+    for (size_t i = b * blockSize; i < end; ++i)
+      values[i] = sample(generator, values[i]);
+  }
+}
+
 template<
   typename InitializationRuleType,
   typename DataType,
@@ -169,10 +206,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleHidden(
 {
   HiddenMean(std::move(input), std::move(output));
 
-  for (size_t i = 0; i < output.n_elem; i++)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  Sample(output, BernoulliSample<ElemType>());
 }
 
 template<
@@ -188,10 +222,7 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
 {
   VisibleMean(std::move(input), std::move(output));
 
-  for (size_t i = 0; i < output.n_elem; i++)
-  {
-    output(i) = math::RandBernoulli(output(i));
-  }
+  Sample(output, BernoulliSample<ElemType>());
 }
 
 template<
@@ -275,7 +306,7 @@ void RBM<InitializationRuleType, DataType, PolicyType>::Gradient(
   Phase(std::move(predictors.cols(i, i + batchSize - 1)),
       std::move(positiveGradient));
 
-  for (size_t i = 0; i < negSteps; i++)
+  for (size_t j = 0; j < negSteps; j++)
   {
     Gibbs(std::move(predictors.cols(i, i + batchSize - 1)),
         std::move(negativeSamples));
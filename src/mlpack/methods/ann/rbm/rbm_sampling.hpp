@@ -0,0 +1,82 @@
+/**
+ * @file rbm_sampling.hpp
+ *
+ * Definition of the functions used by the RBM to sample its units from their
+ * means.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license. You should have received a copy of the
+ * 3-clause BSD license along with mlpack. If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_RBM_RBM_SAMPLING_HPP
+#define MLPACK_METHODS_ANN_RBM_RBM_SAMPLING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Draw a sample from a Bernoulli distribution with the given mean, that is 1
+ * with the given probability and 0 otherwise.
+ *
+ * @tparam ElemType Type of the samples.
+ */
+template<typename ElemType>
+class BernoulliSample
+{
+ public:
+  /**
+   * Draw a sample with the given generator.
+   *
+   * @param generator The random number generator to use.
+   * @param mean The probability of drawing 1.
+   */
+  template<typename GeneratorType>
+  ElemType operator()(GeneratorType& generator, const ElemType mean) const
+  {
+    std::uniform_real_distribution<> uniform;
+    return (uniform(generator) < mean) ? 1 : 0;
+  }
+};
+
+/**
+ * Draw a sample from a normal distribution with the given mean and a fixed
+ * standard deviation.
+ *
+ * @tparam ElemType Type of the samples.
+ */
+template<typename ElemType>
+class NormalSample
+{
+ public:
+  /**
+   * Create the function with the given standard deviation.
+   *
+   * @param stddev The standard deviation of the samples.
+   */
+  NormalSample(const ElemType stddev) : stddev(stddev) { }
+
+  /**
+   * Draw a sample with the given generator.
+   *
+   * @param generator The random number generator to use.
+   * @param mean The mean of the distribution.
+   */
+  template<typename GeneratorType>
+  ElemType operator()(GeneratorType& generator, const ElemType mean) const
+  {
+    std::normal_distribution<> normal;
+    return mean + stddev * normal(generator);
+  }
+
+ private:
+  //! The standard deviation of the samples.
+  ElemType stddev;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
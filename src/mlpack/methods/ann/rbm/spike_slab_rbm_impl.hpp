@@ -109,11 +109,11 @@ RBM<InitializationRuleType, DataType, PolicyType>::Phase(
   SampleSpike(std::move(spikeMean), std::move(spikeSamples));
   SlabMean(std::move(input), std::move(spikeSamples), std::move(slabMean));
 
+  // The sum over the points is taken before the outer product with the slab
+  // means, which are the same for all points.
+  const DataType inputSum = arma::sum(input, 1);
   for (size_t i = 0 ; i < hiddenSize; i++)
-  {
-    weightGrad.slice(i) = input * arma::repmat(slabMean.col(i).t(),
-        input.n_cols, 1) * spikeMean(i);
-  }
+    weightGrad.slice(i) = inputSum * slabMean.col(i).t() * spikeMean(i);
 
   spikeBiasGrad = spikeMean;
 
@@ -163,10 +163,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleVisible(
 
   for (k = 0; k < numMaxTrials; k++)
   {
-    for (size_t i = 0; i < visibleSize; i++)
-    {
-      output(i) = math::RandNormal(visibleMean(i), 1.0 / visiblePenalty(0));
-    }
+    output = visibleMean;
+    Sample(output, NormalSample<ElemType>(1.0 / visiblePenalty(0)));
     if (arma::norm(output, 2) < radius)
     {
       break;
@@ -240,11 +238,15 @@ RBM<InitializationRuleType, DataType, PolicyType>::SpikeMean(
     DataType&& visible,
     DataType&& spikeMean)
 {
+  // The sum of visible.t() * W * W.t() * visible over all the pairs of
+  // points, divided by the squared number of points, is the squared norm of
+  // W.t() times the mean of the points.
+  const DataType pointMean = arma::mean(visible, 1);
   for (size_t i = 0; i < hiddenSize; i++)
   {
-    spikeMean(i) = LogisticFunction::Fn(0.5 * (1.0 / slabPenalty) * arma::accu(
-        visible.t() * (weight.slice(i) * weight.slice(i).t()) * visible)
-        / std::pow(visible.n_cols, 2) + spikeBias(i));
+    spikeMean(i) = LogisticFunction::Fn(0.5 * (1.0 / slabPenalty) *
+        arma::accu(arma::square(weight.slice(i).t() * pointMean)) +
+        spikeBias(i));
   }
 }
 
@@ -259,10 +261,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSpike(
     DataType&& spikeMean,
     DataType&& spike)
 {
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    spike(i) = math::RandBernoulli(spikeMean(i));
-  }
+  spike = spikeMean;
+  Sample(spike, BernoulliSample<ElemType>());
 }
 
 template<
@@ -277,10 +277,11 @@ RBM<InitializationRuleType, DataType, PolicyType>::SlabMean(
     DataType&& spike,
     DataType&& slabMean)
 {
+  const DataType pointMean = arma::mean(visible, 1);
   for (size_t i = 0; i < hiddenSize; i++)
   {
-    slabMean.col(i) = arma::mean((1.0 / slabPenalty) * spike(i) *
-        weight.slice(i).t() * visible, 1);
+    slabMean.col(i) = (1.0 / slabPenalty) * spike(i) * weight.slice(i).t() *
+        pointMean;
   }
 }
 
@@ -295,13 +296,8 @@ RBM<InitializationRuleType, DataType, PolicyType>::SampleSlab(
     DataType&& slabMean,
     DataType&& slab)
 {
-  for (size_t i = 0; i < hiddenSize; i++)
-  {
-    for (size_t j = 0; j < poolSize; j++)
-    {
-      slab(j, i) = math::RandNormal(slabMean(j, i), 1.0 / slabPenalty);
-    }
-  }
+  slab = slabMean;
+  Sample(slab, NormalSample<ElemType>(1.0 / slabPenalty));
 }
 
 } // namespace ann
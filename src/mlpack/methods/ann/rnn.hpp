@@ -20,6 +20,8 @@
 #include "visitor/reset_visitor.hpp"
 
 #include "init_rules/network_init.hpp"
+#include "network_profile.hpp"
+#include "training_checkpoint.hpp"
 
 #include <mlpack/methods/ann/layer/layer_types.hpp>
 #include <mlpack/methods/ann/layer/layer.hpp>
@@ -33,6 +35,9 @@ namespace ann /** Artificial Neural Network. */ {
 /**
  * Implementation of a standard recurrent neural network container.
  *
+ * As with the FFN class, the matrix type of the network is the output parameter
+ * type of the output layer, and all the layers must use it.
+ *
  * @tparam OutputLayerType The output layer type used to evaluate the network.
  * @tparam InitializationRuleType Rule used to initialize the weight matrix.
  */
@@ -49,6 +54,13 @@ class RNN
                           InitializationRuleType,
                           CustomLayers...>;
 
+  //! The matrix type of the network, given by the output layer.
+  typedef typename std::remove_reference<decltype(
+      std::declval<OutputLayerType&>().OutputParameter())>::type MatType;
+
+  //! The cube type of the sequences given to the network.
+  typedef arma::Cube<typename MatType::elem_type> CubeType;
+
   /**
    * Create the RNN object.
    *
@@ -97,8 +109,8 @@ class RNN
    * @return The final objective of the trained model (NaN or Inf on error).
    */
   template<typename OptimizerType>
-  double Train(arma::cube predictors,
-               arma::cube responses,
+  double Train(CubeType predictors,
+               CubeType responses,
                OptimizerType& optimizer);
 
   /**
@@ -126,7 +138,46 @@ class RNN
    * @return The final objective of the trained model (NaN or Inf on error).
    */
   template<typename OptimizerType = ens::StandardSGD>
-  double Train(arma::cube predictors, arma::cube responses);
+  double Train(CubeType predictors, CubeType responses);
+
+  /**
+   * Train the recurrent neural network on packed sequences of variable length
+   * using the given optimizer.  Sequence i has sequenceLengths[i] steps, at
+   * most rho; the slices after its end are padding, which is ignored.  The
+   * sequences are sorted by decreasing length, so that the sequences of each
+   * batch have similar lengths, and each batch is only run up to its longest
+   * sequence.  The loss and its error are masked, so each sequence is only
+   * scored at its own steps (or, with single responses, at its last step).
+   * Packed sequences can't be combined with a nonzero Stride().
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables, padded to rho steps.
+   * @param responses Outputs results from input training variables.
+   * @param sequenceLengths The number of steps of each sequence.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType>
+  double Train(CubeType predictors,
+               CubeType responses,
+               arma::urowvec sequenceLengths,
+               OptimizerType& optimizer);
+
+  /**
+   * Train the recurrent neural network on packed sequences of variable length;
+   * see the other overload.  By default, the SGD optimization algorithm is
+   * used, but others can be specified (such as ens::RMSprop).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables, padded to rho steps.
+   * @param responses Outputs results from input training variables.
+   * @param sequenceLengths The number of steps of each sequence.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::StandardSGD>
+  double Train(CubeType predictors,
+               CubeType responses,
+               arma::urowvec sequenceLengths);
 
   /**
    * Predict the responses to a given set of predictors. The responses will
@@ -147,8 +198,8 @@ class RNN
    * @param results Matrix to put output predictions of responses into.
    * @param batchSize Number of points to predict at once.
    */
-  void Predict(arma::cube predictors,
-               arma::cube& results,
+  void Predict(CubeType predictors,
+               CubeType& results,
                const size_t batchSize = 256);
 
   /**
@@ -163,7 +214,7 @@ class RNN
    * @param deterministic Whether or not to train or test the model. Note some
    *        layer act differently in training or testing mode.
    */
-  double Evaluate(const arma::mat& parameters,
+  double Evaluate(const MatType& parameters,
                   const size_t begin,
                   const size_t batchSize,
                   const bool deterministic);
@@ -179,7 +230,7 @@ class RNN
    * @param batchSize Number of points to be passed at a time to use for
    *        objective function evaluation.
    */
-  double Evaluate(const arma::mat& parameters,
+  double Evaluate(const MatType& parameters,
                   const size_t begin,
                   const size_t batchSize);
 
@@ -195,7 +246,7 @@ class RNN
    *        objective function evaluation.
    */
   template<typename GradType>
-  double EvaluateWithGradient(const arma::mat& parameters,
+  double EvaluateWithGradient(const MatType& parameters,
                               const size_t begin,
                               GradType& gradient,
                               const size_t batchSize);
@@ -213,9 +264,9 @@ class RNN
    * @param batchSize Number of points to be processed as a batch for objective
    *        function gradient evaluation.
    */
-  void Gradient(const arma::mat& parameters,
+  void Gradient(const MatType& parameters,
                 const size_t begin,
-                arma::mat& gradient,
+                MatType& gradient,
                 const size_t batchSize);
 
   /**
@@ -237,30 +288,57 @@ class RNN
    *
    * @param layer The Layer to be added to the model.
    */
-  void Add(LayerTypes<CustomLayers...> layer) { network.push_back(layer); }
+  void Add(TypedLayerTypes<MatType, CustomLayers...> layer)
+  {
+    network.push_back(layer);
+  }
 
   //! Return the number of separable functions (the number of predictor points).
   size_t NumFunctions() const { return numFunctions; }
 
   //! Return the initial point for the optimization.
-  const arma::mat& Parameters() const { return parameter; }
+  const MatType& Parameters() const { return parameter; }
   //! Modify the initial point for the optimization.
-  arma::mat& Parameters() { return parameter; }
+  MatType& Parameters() { return parameter; }
 
   //! Return the maximum length of backpropagation through time.
   const size_t& Rho() const { return rho; }
   //! Modify the maximum length of backpropagation through time.
   size_t& Rho() { return rho; }
 
+  /**
+   * Get the forward stride of truncated backpropagation through time.  If it
+   * is zero (the default), the sequences have rho steps.  Otherwise, the
+   * sequences can have any number of steps of at least rho, and they are
+   * processed in windows of rho steps, each starting stride steps after the
+   * previous one (the last window ends at the last step).  Backpropagation
+   * through time runs over each window separately, so the memory doesn't
+   * depend on the length of the sequences, and the cells that implement
+   * CarryState(), such as LSTM, start each window from the state of the last
+   * window at that step; the other cells are reset.  Each step is scored once,
+   * by the first window that contains it.  The stride must not be larger than
+   * rho.
+   */
+  size_t Stride() const { return stride; }
+  //! Modify the forward stride of truncated backpropagation through time.
+  size_t& Stride() { return stride; }
+
+  /**
+   * Get the number of steps of each training sequence, or an empty vector if
+   * all the sequences have rho steps.  The lengths are given to Train() and
+   * kept in the packed order of the sequences.
+   */
+  const arma::urowvec& SequenceLengths() const { return sequenceLengths; }
+
   //! Get the matrix of responses to the input data points.
-  const arma::cube& Responses() const { return responses; }
+  const CubeType& Responses() const { return responses; }
   //! Modify the matrix of responses to the input data points.
-  arma::cube& Responses() { return responses; }
+  CubeType& Responses() { return responses; }
 
   //! Get the matrix of data points (predictors).
-  const arma::cube& Predictors() const { return predictors; }
+  const CubeType& Predictors() const { return predictors; }
   //! Modify the matrix of data points (predictors).
-  arma::cube& Predictors() { return predictors; }
+  CubeType& Predictors() { return predictors; }
 
   /**
    * Reset the state of the network.  This ensures that all internally-held
@@ -269,6 +347,23 @@ class RNN
    */
   void Reset();
 
+  /**
+   * Get the profile of the layers of the network.  Enable it to record the
+   * time spent in the forward, backward and gradient pass of each layer, for
+   * every time step.
+   */
+  const NetworkProfile& Profile() const { return profile; }
+  //! Modify the profile of the layers of the network.
+  NetworkProfile& Profile() { return profile; }
+
+  /**
+   * Get the checkpoint of the training.  Set its path and its interval to
+   * write the parameters to disk periodically while the network is trained.
+   */
+  const TrainingCheckpoint& Checkpoint() const { return checkpoint; }
+  //! Modify the checkpoint of the training.
+  TrainingCheckpoint& Checkpoint() { return checkpoint; }
+
   /**
    * Reset the module information (weights/parameters).
    */
@@ -286,13 +381,110 @@ class RNN
    *
    * @param input Data sequence to compute probabilities for.
    */
-  void Forward(arma::mat&& input);
+  void Forward(MatType&& input);
 
   /**
    * Reset the state of RNN cells in the network for new input sequence.
    */
   void ResetCells();
 
+  /**
+   * Reset the state of RNN cells in the network for new input sequences with
+   * the given number of steps.
+   *
+   * @param steps The number of steps of the sequences.
+   */
+  void ResetCells(const size_t steps);
+
+  /**
+   * Start the next window of truncated BPTT from the state after the given
+   * step of the current window.
+   *
+   * @param step Number of steps of the current window before the next one.
+   */
+  void CarryState(const size_t step);
+
+  /**
+   * Get the number of steps of the given sequences that are processed, and
+   * check that they can be split in windows.
+   *
+   * @param sequences The sequences, one time step per slice.
+   */
+  size_t SequenceLength(const CubeType& sequences) const;
+
+  /**
+   * Get the first step of each window of truncated BPTT, for sequences with
+   * the given number of steps.
+   *
+   * @param steps The number of steps of the sequences.
+   */
+  std::vector<size_t> WindowStarts(const size_t steps) const;
+
+  /**
+   * Check that the packed sequence lengths match the training data, and sort
+   * the sequences by decreasing length.
+   */
+  void PackSequences();
+
+  /**
+   * Reorder the training sequences (and their lengths, if any).
+   *
+   * @param order The new order of the sequences.
+   */
+  void PermuteSequences(const arma::uvec& order);
+
+  /**
+   * Get the number of steps to run for the given batch: rho, or the length of
+   * the longest sequence of the batch if the sequences are packed.
+   *
+   * @param begin Index of the first sequence of the batch.
+   * @param batchSize Number of sequences in the batch.
+   */
+  size_t BatchSteps(const size_t begin, const size_t batchSize) const;
+
+  /**
+   * Find the sequences of the batch that are scored at the given step.
+   *
+   * @param begin Index of the first sequence of the batch.
+   * @param batchSize Number of sequences in the batch.
+   * @param step The time step.
+   * @param active The indices in the batch of the scored sequences, if not
+   *        all of them are scored.
+   * @return Whether all the sequences of the batch are scored.
+   */
+  bool ActiveSequences(const size_t begin,
+                       const size_t batchSize,
+                       const size_t step,
+                       arma::uvec& active) const;
+
+  /**
+   * Compute the loss of the current output of the network at the given step,
+   * masked to the sequences that are scored at that step.
+   *
+   * @param begin Index of the first sequence of the batch.
+   * @param batchSize Number of sequences in the batch.
+   * @param step The time step.
+   * @param responseSeq The slice of the responses to use.
+   */
+  double StepLoss(const size_t begin,
+                  const size_t batchSize,
+                  const size_t step,
+                  const size_t responseSeq);
+
+  /**
+   * Compute the error of the current output of the network at the given step
+   * into error, masked to the sequences that are scored at that step.
+   *
+   * @param begin Index of the first sequence of the batch.
+   * @param batchSize Number of sequences in the batch.
+   * @param step The time step.
+   * @param responseSeq The slice of the responses to use.
+   */
+  void StepError(const size_t begin,
+                 const size_t batchSize,
+                 const size_t step,
+                 const size_t responseSeq);
+
   /**
    * The Backward algorithm (part of the Forward-Backward algorithm). Computes
    * backward pass for module.
@@ -315,11 +507,15 @@ class RNN
   /**
    * Reset the gradient for all modules that implement the Gradient function.
    */
-  void ResetGradients(arma::mat& gradient);
+  void ResetGradients(MatType& gradient);
 
   //! Number of steps to backpropagate through time (BPTT).
   size_t rho;
 
+  //! The forward stride of truncated BPTT, or 0 if the sequences have rho
+  //! steps.
+  size_t stride;
+
   //! Instantiated outputlayer used to evaluate the network.
   OutputLayerType outputLayer;
 
@@ -343,31 +539,34 @@ class RNN
   bool single;
 
   //! Locally-stored model modules.
-  std::vector<LayerTypes<CustomLayers...> > network;
+  std::vector<TypedLayerTypes<MatType, CustomLayers...> > network;
 
   //! The matrix of data points (predictors).
-  arma::cube predictors;
+  CubeType predictors;
 
   //! The matrix of responses to the input data points.
-  arma::cube responses;
+  CubeType responses;
+
+  //! The number of steps of each packed sequence (empty if all have rho).
+  arma::urowvec sequenceLengths;
 
   //! Matrix of (trained) parameters.
-  arma::mat parameter;
+  MatType parameter;
 
   //! The number of separable functions (the number of predictor points).
   size_t numFunctions;
 
   //! The current error for the backward pass.
-  arma::mat error;
+  MatType error;
 
   //! Locally-stored delta visitor.
-  DeltaVisitor deltaVisitor;
+  DeltaVisitor<MatType> deltaVisitor;
 
   //! Locally-stored output parameter visitor.
-  OutputParameterVisitor outputParameterVisitor;
+  OutputParameterVisitor<MatType> outputParameterVisitor;
 
   //! List of all module parameters for the backward pass (BBTT).
-  std::vector<arma::mat> moduleOutputParameter;
+  std::vector<MatType> moduleOutputParameter;
 
   //! Locally-stored weight size visitor.
   WeightSizeVisitor weightSizeVisitor;
@@ -382,7 +581,13 @@ class RNN
   bool deterministic;
 
   //! The current gradient for the gradient pass.
-  arma::mat currentGradient;
+  MatType currentGradient;
+
+  //! The profile of the layers.
+  NetworkProfile profile;
+
+  //! The checkpoint of the training.
+  TrainingCheckpoint checkpoint;
 
   // The BRN class should have access to internal members.
   template<
@@ -409,7 +614,7 @@ template<typename OutputLayerType,
 struct version<
     mlpack::ann::RNN<OutputLayerType, InitializationRuleType, CustomLayer...>>
 {
-  BOOST_STATIC_CONSTANT(int, value = 1);
+  BOOST_STATIC_CONSTANT(int, value = 2);
 };
 
 } // namespace serialization
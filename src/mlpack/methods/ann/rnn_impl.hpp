@@ -19,6 +19,7 @@
 #include "visitor/save_output_parameter_visitor.hpp"
 #include "visitor/forward_visitor.hpp"
 #include "visitor/backward_visitor.hpp"
+#include "visitor/carry_state_visitor.hpp"
 #include "visitor/reset_cell_visitor.hpp"
 #include "visitor/deterministic_set_visitor.hpp"
 #include "visitor/gradient_set_visitor.hpp"
@@ -38,6 +39,7 @@ RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::RNN(
     OutputLayerType outputLayer,
     InitializationRuleType initializeRule) :
     rho(rho),
+    stride(0),
     outputLayer(std::move(outputLayer)),
     initializeRule(std::move(initializeRule)),
     inputSize(0),
@@ -55,7 +57,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::~RNN()
 {
-  for (LayerTypes<CustomLayers...>& layer : network)
+  for (TypedLayerTypes<MatType, CustomLayers...>& layer : network)
   {
     boost::apply_visitor(deleteVisitor, layer);
   }
@@ -65,14 +67,15 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename OptimizerType>
 double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
-    arma::cube predictors,
-    arma::cube responses,
+    CubeType predictors,
+    CubeType responses,
     OptimizerType& optimizer)
 {
   numFunctions = responses.n_cols;
 
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  sequenceLengths.reset();
 
   this->deterministic = true;
   ResetDeterministic();
@@ -85,6 +88,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   // Train the model.
   Timer::Start("rnn_optimization");
   const double out = optimizer.Optimize(*this, parameter);
+  checkpoint.Finish(parameter);
   Timer::Stop("rnn_optimization");
 
   Log::Info << "RNN::RNN(): final objective of trained model is " << out
@@ -92,28 +96,288 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   return out;
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType>
+double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    CubeType predictors,
+    CubeType responses,
+    arma::urowvec sequenceLengths,
+    OptimizerType& optimizer)
+{
+  numFunctions = responses.n_cols;
+
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  this->sequenceLengths = std::move(sequenceLengths);
+  PackSequences();
+
+  this->deterministic = true;
+  ResetDeterministic();
+
+  if (!reset)
+  {
+    ResetParameters();
+  }
+
+  // Train the model.
+  Timer::Start("rnn_optimization");
+  const double out = optimizer.Optimize(*this, parameter);
+  checkpoint.Finish(parameter);
+  Timer::Stop("rnn_optimization");
+
+  Log::Info << "RNN::RNN(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+template<typename OptimizerType>
+double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
+    CubeType predictors,
+    CubeType responses,
+    arma::urowvec sequenceLengths)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses),
+      std::move(sequenceLengths), optimizer);
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::ResetCells()
+{
+  ResetCells(rho);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ResetCells(const size_t steps)
 {
   for (size_t i = 1; i < network.size(); ++i)
   {
-    boost::apply_visitor(ResetCellVisitor(rho), network[i]);
+    boost::apply_visitor(ResetCellVisitor(steps), network[i]);
   }
 }
 
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::CarryState(const size_t step)
+{
+  for (size_t i = 1; i < network.size(); ++i)
+  {
+    boost::apply_visitor(CarryStateVisitor(step, rho), network[i]);
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::SequenceLength(const CubeType& sequences) const
+{
+  if (stride == 0)
+    return rho;
+
+  if (stride > rho)
+  {
+    std::ostringstream oss;
+    oss << "RNN::SequenceLength(): the stride (" << stride << ") must not be "
+        << "larger than rho (" << rho << ")";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (sequences.n_slices < rho)
+  {
+    std::ostringstream oss;
+    oss << "RNN::SequenceLength(): the sequences have " << sequences.n_slices
+        << " steps, but rho is " << rho;
+    throw std::invalid_argument(oss.str());
+  }
+
+  return sequences.n_slices;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+std::vector<size_t> RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::WindowStarts(const size_t steps) const
+{
+  std::vector<size_t> starts(1, 0);
+  if (stride == 0)
+    return starts;
+
+  while (starts.back() + rho < steps)
+    starts.push_back(std::min(starts.back() + stride, steps - rho));
+
+  return starts;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PackSequences()
+{
+  if (sequenceLengths.n_elem != predictors.n_cols ||
+      responses.n_cols != predictors.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "RNN::Train(): " << sequenceLengths.n_elem << " sequence lengths "
+        << "given for " << predictors.n_cols << " predictors and "
+        << responses.n_cols << " responses";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (stride != 0)
+  {
+    throw std::invalid_argument("RNN::Train(): packed sequences can't be "
+        "used with a nonzero stride");
+  }
+
+  if (sequenceLengths.n_elem > 0 && (sequenceLengths.min() == 0 ||
+      sequenceLengths.max() > rho || predictors.n_slices < rho))
+  {
+    std::ostringstream oss;
+    oss << "RNN::Train(): the sequence lengths must be between 1 and rho ("
+        << rho << "), and the predictors must have rho steps";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The sort is stable, so shuffled sequences of the same length stay
+  // shuffled.
+  PermuteSequences(arma::stable_sort_index(sequenceLengths, "descend"));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::PermuteSequences(const arma::uvec& order)
+{
+  for (size_t s = 0; s < predictors.n_slices; ++s)
+  {
+    const MatType permuted = predictors.slice(s).cols(order);
+    predictors.slice(s) = permuted;
+  }
+
+  for (size_t s = 0; s < responses.n_slices; ++s)
+  {
+    const MatType permuted = responses.slice(s).cols(order);
+    responses.slice(s) = permuted;
+  }
+
+  if (!sequenceLengths.is_empty())
+  {
+    const arma::urowvec permuted = sequenceLengths.cols(order);
+    sequenceLengths = permuted;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+size_t RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::BatchSteps(const size_t begin,
+                                      const size_t batchSize) const
+{
+  if (sequenceLengths.is_empty())
+    return rho;
+
+  return sequenceLengths.subvec(begin, begin + batchSize - 1).max();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+bool RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::ActiveSequences(const size_t begin,
+                                           const size_t batchSize,
+                                           const size_t step,
+                                           arma::uvec& active) const
+{
+  if (sequenceLengths.is_empty())
+    return true;
+
+  // A single response is scored at the last step of each sequence, and the
+  // other responses at every step of the sequence.
+  const arma::urowvec lengths = sequenceLengths.subvec(begin,
+      begin + batchSize - 1);
+  if (single)
+    active = arma::find(lengths == step + 1);
+  else
+    active = arma::find(lengths > step);
+
+  return (active.n_elem == batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+double RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::StepLoss(const size_t begin,
+                                    const size_t batchSize,
+                                    const size_t step,
+                                    const size_t responseSeq)
+{
+  MatType& output = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  MatType stepResponses(responses.slice(responseSeq).colptr(begin),
+      responses.n_rows, batchSize, false, true);
+
+  arma::uvec active;
+  if (ActiveSequences(begin, batchSize, step, active))
+    return outputLayer.Forward(std::move(output), std::move(stepResponses));
+
+  if (active.is_empty())
+    return 0.0;
+
+  return outputLayer.Forward(std::move(MatType(output.cols(active))),
+      std::move(MatType(stepResponses.cols(active))));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... CustomLayers>
+void RNN<OutputLayerType, InitializationRuleType,
+         CustomLayers...>::StepError(const size_t begin,
+                                     const size_t batchSize,
+                                     const size_t step,
+                                     const size_t responseSeq)
+{
+  MatType& output = boost::apply_visitor(outputParameterVisitor,
+      network.back());
+  MatType stepResponses(responses.slice(responseSeq).colptr(begin),
+      responses.n_rows, batchSize, false, true);
+
+  arma::uvec active;
+  if (ActiveSequences(begin, batchSize, step, active))
+  {
+    outputLayer.Backward(std::move(output), std::move(stepResponses),
+        std::move(error));
+    return;
+  }
+
+  // The sequences that are not scored at this step get no error.
+  error.zeros(output.n_rows, output.n_cols);
+  if (active.is_empty())
+    return;
+
+  MatType activeError;
+  outputLayer.Backward(std::move(MatType(output.cols(active))),
+      std::move(MatType(stepResponses.cols(active))), std::move(activeError));
+  error.cols(active) = activeError;
+}
+
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename OptimizerType>
 double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
-    arma::cube predictors,
-    arma::cube responses)
+    CubeType predictors,
+    CubeType responses)
 {
   numFunctions = responses.n_cols;
 
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
+  sequenceLengths.reset();
 
   this->deterministic = true;
   ResetDeterministic();
@@ -128,6 +392,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
   // Train the model.
   Timer::Start("rnn_optimization");
   const double out = optimizer.Optimize(*this, parameter);
+  checkpoint.Finish(parameter);
   Timer::Stop("rnn_optimization");
 
   Log::Info << "RNN::RNN(): final objective of trained model is " << out
@@ -138,7 +403,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Train(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
-    arma::cube predictors, arma::cube& results, const size_t batchSize)
+    CubeType predictors, CubeType& results, const size_t batchSize)
 {
   ResetCells();
 
@@ -153,20 +418,38 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
     ResetDeterministic();
   }
 
-  results = arma::zeros<arma::cube>(outputSize, predictors.n_cols, rho);
+  const size_t steps = SequenceLength(predictors);
+  const std::vector<size_t> starts = WindowStarts(steps);
+
+  results = arma::zeros<CubeType>(outputSize, predictors.n_cols, steps);
   // Process in accordance with the given batch size.
   for (size_t begin = 0; begin < predictors.n_cols; begin += batchSize)
   {
+    if (begin > 0 && starts.size() > 1)
+      ResetCells();
+
     const size_t effectiveBatchSize = std::min(batchSize,
         size_t(predictors.n_cols - begin));
-    for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+    for (size_t w = 0; w < starts.size(); ++w)
     {
-      Forward(std::move(arma::mat(predictors.slice(seqNum).colptr(begin),
-          predictors.n_rows, effectiveBatchSize, false, true)));
-
-      results.slice(seqNum).submat(0, begin, results.n_rows - 1, begin +
-          effectiveBatchSize - 1) = boost::apply_visitor(outputParameterVisitor,
-          network.back());
+      if (w > 0)
+        CarryState(starts[w] - starts[w - 1]);
+
+      // The steps before this one were predicted by the last window.
+      const size_t first = (w == 0) ? 0 : starts[w - 1] + rho;
+      for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+      {
+        const size_t step = starts[w] + seqNum;
+        Forward(std::move(MatType(predictors.slice(step).colptr(begin),
+            predictors.n_rows, effectiveBatchSize, false, true)));
+
+        if (step < first)
+          continue;
+
+        results.slice(step).submat(0, begin, results.n_rows - 1, begin +
+            effectiveBatchSize - 1) = boost::apply_visitor(
+            outputParameterVisitor, network.back());
+      }
     }
   }
 }
@@ -174,7 +457,7 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Predict(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
-    const arma::mat& /* parameters */,
+    const MatType& /* parameters */,
     const size_t begin,
     const size_t batchSize,
     const bool deterministic)
@@ -200,26 +483,41 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
+  const size_t steps = SequenceLength(predictors);
+  const std::vector<size_t> starts = WindowStarts(steps);
+
+  // Packed sequences are only run up to the longest one of the batch.
+  const size_t windowSteps = BatchSteps(begin, batchSize);
+  ResetCells(windowSteps);
 
   double performance = 0;
   size_t responseSeq = 0;
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  for (size_t w = 0; w < starts.size(); ++w)
   {
-    // Wrap a matrix around our data to avoid a copy.
-    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true);
-    Forward(std::move(stepData));
-    if (!single)
+    if (w > 0)
+      CarryState(starts[w] - starts[w - 1]);
+
+    // The steps before this one were scored by the last window.
+    const size_t first = (w == 0) ? 0 : starts[w - 1] + rho;
+    for (size_t seqNum = 0; seqNum < windowSteps; ++seqNum)
     {
-      responseSeq = seqNum;
-    }
+      const size_t step = starts[w] + seqNum;
 
-    performance += outputLayer.Forward(std::move(boost::apply_visitor(
-        outputParameterVisitor, network.back())),
-        std::move(arma::mat(responses.slice(responseSeq).colptr(begin),
-            responses.n_rows, batchSize, false, true)));
+      // Wrap a matrix around our data to avoid a copy.
+      MatType stepData(predictors.slice(step).colptr(begin),
+          predictors.n_rows, batchSize, false, true);
+      Forward(std::move(stepData));
+      if (step < first)
+        continue;
+
+      if (!single)
+      {
+        responseSeq = step;
+      }
+
+      performance += StepLoss(begin, batchSize, step, responseSeq);
+    }
   }
 
   if (outputSize == 0)
@@ -234,7 +532,7 @@ double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Evaluate(
-    const arma::mat& parameters,
+    const MatType& parameters,
     const size_t begin,
     const size_t batchSize)
 {
@@ -245,7 +543,7 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 template<typename GradType>
 double RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::
-EvaluateWithGradient(const arma::mat& /* parameters */,
+EvaluateWithGradient(const MatType& /* parameters */,
                      const size_t begin,
                      GradType& gradient,
                      const size_t batchSize)
@@ -258,7 +556,7 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
       ResetParameters();
     }
 
-    gradient = arma::zeros<arma::mat>(parameter.n_rows, parameter.n_cols);
+    gradient = arma::zeros<MatType>(parameter.n_rows, parameter.n_cols);
   }
   else
   {
@@ -271,6 +569,8 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     ResetDeterministic();
   }
 
+  checkpoint.Update(parameter);
+
   if (!inputSize)
   {
     inputSize = predictors.n_rows;
@@ -281,83 +581,92 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
     targetSize = responses.n_rows;
   }
 
-  ResetCells();
+  const size_t steps = SequenceLength(predictors);
+  const std::vector<size_t> starts = WindowStarts(steps);
+
+  // Packed sequences are only run up to the longest one of the batch.
+  const size_t windowSteps = BatchSteps(begin, batchSize);
+  ResetCells(windowSteps);
 
   double performance = 0;
   size_t responseSeq = 0;
 
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
-  {
-    // Wrap a matrix around our data to avoid a copy.
-    arma::mat stepData(predictors.slice(seqNum).colptr(begin),
-        predictors.n_rows, batchSize, false, true);
-    Forward(std::move(stepData));
-    if (!single)
-    {
-      responseSeq = seqNum;
-    }
-
-    for (size_t l = 0; l < network.size(); ++l)
-    {
-      boost::apply_visitor(SaveOutputParameterVisitor(
-          std::move(moduleOutputParameter)), network[l]);
-    }
-
-    performance += outputLayer.Forward(std::move(boost::apply_visitor(
-        outputParameterVisitor, network.back())),
-        std::move(arma::mat(responses.slice(responseSeq).colptr(begin),
-            responses.n_rows, batchSize, false, true)));
-  }
-
-  if (outputSize == 0)
-  {
-    outputSize = boost::apply_visitor(outputParameterVisitor,
-        network.back()).n_elem / batchSize;
-  }
-
   // Initialize current/working gradient.
   if (currentGradient.is_empty())
   {
-    currentGradient = arma::zeros<arma::mat>(parameter.n_rows,
+    currentGradient = arma::zeros<MatType>(parameter.n_rows,
         parameter.n_cols);
   }
 
-  ResetGradients(currentGradient);
-
-  for (size_t seqNum = 0; seqNum < rho; ++seqNum)
+  for (size_t w = 0; w < starts.size(); ++w)
   {
-    currentGradient.zeros();
+    if (w > 0)
+      CarryState(starts[w] - starts[w - 1]);
 
-    for (size_t l = 0; l < network.size(); ++l)
+    // The steps before this one were scored by the last window, so they only
+    // backpropagate the errors of the later steps.
+    const size_t first = (w == 0) ? 0 : starts[w - 1] + rho;
+    for (size_t seqNum = 0; seqNum < windowSteps; ++seqNum)
     {
-      boost::apply_visitor(LoadOutputParameterVisitor(
-          std::move(moduleOutputParameter)), network[network.size() - 1 - l]);
+      const size_t step = starts[w] + seqNum;
+
+      // Wrap a matrix around our data to avoid a copy.
+      MatType stepData(predictors.slice(step).colptr(begin),
+          predictors.n_rows, batchSize, false, true);
+      Forward(std::move(stepData));
+      if (!single)
+      {
+        responseSeq = step;
+      }
+
+      for (size_t l = 0; l < network.size(); ++l)
+      {
+        boost::apply_visitor(SaveOutputParameterVisitor<MatType>(
+            std::move(moduleOutputParameter)), network[l]);
+      }
+
+      if (step >= first)
+        performance += StepLoss(begin, batchSize, step, responseSeq);
     }
 
-    if (single && seqNum > 0)
-    {
-      error.zeros();
-    }
-    else if (single && seqNum == 0)
+    if (outputSize == 0)
     {
-      outputLayer.Backward(std::move(boost::apply_visitor(
-          outputParameterVisitor, network.back())),
-          std::move(arma::mat(responses.slice(0).colptr(begin),
-          responses.n_rows, batchSize, false, true)), std::move(error));
+      outputSize = boost::apply_visitor(outputParameterVisitor,
+          network.back()).n_elem / batchSize;
     }
-    else
+
+    ResetGradients(currentGradient);
+
+    for (size_t seqNum = 0; seqNum < windowSteps; ++seqNum)
     {
-      outputLayer.Backward(std::move(boost::apply_visitor(
-          outputParameterVisitor, network.back())),
-          std::move(arma::mat(responses.slice(rho - seqNum - 1).colptr(begin),
-          responses.n_rows, batchSize, false, true)), std::move(error));
+      const size_t step = starts[w] + windowSteps - seqNum - 1;
+      currentGradient.zeros();
+
+      for (size_t l = 0; l < network.size(); ++l)
+      {
+        boost::apply_visitor(LoadOutputParameterVisitor<MatType>(
+            std::move(moduleOutputParameter)), network[network.size() - 1 - l]);
+      }
+
+      // With a single response, only the last step of the sequences has an
+      // error (packed sequences are masked by StepError()).
+      if ((single && sequenceLengths.is_empty() && step != steps - 1) ||
+          step < first)
+      {
+        const MatType& output = boost::apply_visitor(outputParameterVisitor,
+            network.back());
+        error.zeros(output.n_rows, output.n_cols);
+      }
+      else
+      {
+        StepError(begin, batchSize, step, single ? 0 : step);
+      }
+
+      Backward();
+      Gradient(std::move(MatType(predictors.slice(step).colptr(begin),
+          predictors.n_rows, batchSize, false, true)));
+      gradient += currentGradient;
     }
-
-    Backward();
-    Gradient(std::move(
-        arma::mat(predictors.slice(rho - seqNum - 1).colptr(begin),
-        predictors.n_rows, batchSize, false, true)));
-    gradient += currentGradient;
   }
 
   return performance;
@@ -366,9 +675,9 @@ EvaluateWithGradient(const arma::mat& /* parameters */,
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Gradient(
-    const arma::mat& parameters,
+    const MatType& parameters,
     const size_t begin,
-    arma::mat& gradient,
+    MatType& gradient,
     const size_t batchSize)
 {
   this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
@@ -378,7 +687,17 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Shuffle()
 {
-  arma::cube newPredictors, newResponses;
+  if (!sequenceLengths.is_empty())
+  {
+    // Keep the sequences packed: only the sequences of the same length are
+    // reordered.
+    PermuteSequences(arma::shuffle(arma::linspace<arma::uvec>(0,
+        predictors.n_cols - 1, predictors.n_cols)));
+    PackSequences();
+    return;
+  }
+
+  CubeType newPredictors, newResponses;
   math::ShuffleData(predictors, responses, newPredictors, newResponses);
 
   predictors = std::move(newPredictors);
@@ -424,31 +743,45 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::ResetGradients(
-    arma::mat& gradient)
+    MatType& gradient)
 {
   size_t offset = 0;
-  for (LayerTypes<CustomLayers...>& layer : network)
+  for (TypedLayerTypes<MatType, CustomLayers...>& layer : network)
   {
-    offset += boost::apply_visitor(GradientSetVisitor(std::move(gradient),
-        offset), layer);
+    offset += boost::apply_visitor(GradientSetVisitor<MatType>(std::move(
+        gradient), offset), layer);
   }
 }
 
 template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType,
-         CustomLayers...>::Forward(arma::mat&& input)
+         CustomLayers...>::Forward(MatType&& input)
 {
-  boost::apply_visitor(ForwardVisitor(std::move(input), std::move(
+  const bool profiling = profile.Enabled();
+  NetworkProfile::Clock::time_point begin;
+  if (profiling)
+    begin = NetworkProfile::Clock::now();
+
+  boost::apply_visitor(ForwardVisitor<MatType>(std::move(input), std::move(
       boost::apply_visitor(outputParameterVisitor, network.front()))),
       network.front());
 
+  if (profiling)
+    profile.Record<MatType>(0, NetworkProfile::FORWARD, begin, network.front());
+
   for (size_t i = 1; i < network.size(); ++i)
   {
-    boost::apply_visitor(ForwardVisitor(
+    if (profiling)
+      begin = NetworkProfile::Clock::now();
+
+    boost::apply_visitor(ForwardVisitor<MatType>(
         std::move(boost::apply_visitor(outputParameterVisitor, network[i - 1])),
         std::move(boost::apply_visitor(outputParameterVisitor, network[i]))),
         network[i]);
+
+    if (profiling)
+      profile.Record<MatType>(i, NetworkProfile::FORWARD, begin, network[i]);
   }
 }
 
@@ -456,19 +789,39 @@ template<typename OutputLayerType, typename InitializationRuleType,
          typename... CustomLayers>
 void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::Backward()
 {
-  boost::apply_visitor(BackwardVisitor(
+  const bool profiling = profile.Enabled();
+  NetworkProfile::Clock::time_point begin;
+  if (profiling)
+    begin = NetworkProfile::Clock::now();
+
+  boost::apply_visitor(BackwardVisitor<MatType>(
         std::move(boost::apply_visitor(outputParameterVisitor, network.back())),
         std::move(error), std::move(boost::apply_visitor(deltaVisitor,
         network.back()))), network.back());
 
+  if (profiling)
+  {
+    profile.Record<MatType>(network.size() - 1, NetworkProfile::BACKWARD,
+        begin, network.back());
+  }
+
   for (size_t i = 2; i < network.size(); ++i)
   {
-    boost::apply_visitor(BackwardVisitor(
+    if (profiling)
+      begin = NetworkProfile::Clock::now();
+
+    boost::apply_visitor(BackwardVisitor<MatType>(
         std::move(boost::apply_visitor(outputParameterVisitor,
         network[network.size() - i])), std::move(boost::apply_visitor(
         deltaVisitor, network[network.size() - i + 1])), std::move(
         boost::apply_visitor(deltaVisitor, network[network.size() - i]))),
         network[network.size() - i]);
+
+    if (profiling)
+    {
+      profile.Record<MatType>(network.size() - i, NetworkProfile::BACKWARD,
+          begin, network[network.size() - i]);
+    }
   }
 }
 
@@ -478,15 +831,32 @@ template<typename InputType>
 void RNN<OutputLayerType, InitializationRuleType,
          CustomLayers...>::Gradient(InputType&& input)
 {
-  boost::apply_visitor(GradientVisitor(std::move(input), std::move(
+  const bool profiling = profile.Enabled();
+  NetworkProfile::Clock::time_point begin;
+  if (profiling)
+    begin = NetworkProfile::Clock::now();
+
+  boost::apply_visitor(GradientVisitor<MatType>(std::move(input), std::move(
       boost::apply_visitor(deltaVisitor, network[1]))), network.front());
 
+  if (profiling)
+  {
+    profile.Record<MatType>(0, NetworkProfile::GRADIENT, begin,
+        network.front());
+  }
+
   for (size_t i = 1; i < network.size() - 1; ++i)
   {
-    boost::apply_visitor(GradientVisitor(
+    if (profiling)
+      begin = NetworkProfile::Clock::now();
+
+    boost::apply_visitor(GradientVisitor<MatType>(
         std::move(boost::apply_visitor(outputParameterVisitor, network[i - 1])),
         std::move(boost::apply_visitor(deltaVisitor, network[i + 1]))),
         network[i]);
+
+    if (profiling)
+      profile.Record<MatType>(i, NetworkProfile::GRADIENT, begin, network[i]);
   }
 }
 
@@ -509,6 +879,16 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
     ar & BOOST_SERIALIZATION_NVP(reset);
   }
 
+  // Earlier versions of the RNN code did not have truncated BPTT.
+  if (version > 1)
+  {
+    ar & BOOST_SERIALIZATION_NVP(stride);
+  }
+  else if (Archive::is_loading::value)
+  {
+    stride = 0;
+  }
+
   if (Archive::is_loading::value)
   {
     std::for_each(network.begin(), network.end(),
@@ -527,10 +907,10 @@ void RNN<OutputLayerType, InitializationRuleType, CustomLayers...>::serialize(
       reset = false;
 
     size_t offset = 0;
-    for (LayerTypes<CustomLayers...>& layer : network)
+    for (TypedLayerTypes<MatType, CustomLayers...>& layer : network)
     {
-      offset += boost::apply_visitor(WeightSetVisitor(std::move(parameter),
-          offset), layer);
+      offset += boost::apply_visitor(WeightSetVisitor<MatType>(std::move(
+          parameter), offset), layer);
 
       boost::apply_visitor(resetVisitor, layer);
     }
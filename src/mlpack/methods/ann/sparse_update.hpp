@@ -0,0 +1,199 @@
+/**
+ * @file sparse_update.hpp
+ *
+ * Definition of the SparseUpdate and SparseAdaGradUpdate classes, update
+ * policies for ens::SGD that only update the parameters whose gradient was
+ * written by FFN::EvaluateWithGradient() in sparse gradient mode.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_SPARSE_UPDATE_HPP
+#define MLPACK_METHODS_ANN_SPARSE_UPDATE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The SparseUpdate class is the vanilla SGD update policy restricted to the
+ * ranges of the gradient that the network wrote, as given by
+ * FFN::GradientRanges().  With large Lookup layers most of the gradient is
+ * zero, and the update of a batch then only touches the looked up entries.
+ *
+ * @code
+ * model.SparseGradient() = true;
+ * ens::SGD<SparseUpdate> optimizer(0.01, 32, 100000, 1e-5, true,
+ *     SparseUpdate(model.GradientRanges()));
+ * model.Train(predictors, responses, optimizer);
+ * @endcode
+ *
+ * Without ranges, or while they are empty, the whole iterate is updated.
+ */
+class SparseUpdate
+{
+ public:
+  /**
+   * Create the update policy.
+   *
+   * @param ranges The ranges to update, as one column per range with the index
+   *     of its first parameter and its length.  The matrix is not copied and
+   *     must outlive the optimization.
+   */
+  SparseUpdate(const arma::Mat<size_t>& ranges) : ranges(&ranges) { }
+
+  //! Create the update policy that updates all the parameters.
+  SparseUpdate() : ranges(NULL) { }
+
+  /**
+   * The Initialize method is called by SGD Optimizer method before the start
+   * of the iteration update process.
+   *
+   * @param rows Number of rows in the gradient matrix.
+   * @param cols Number of columns in the gradient matrix.
+   */
+  void Initialize(const size_t /* rows */, const size_t /* cols */)
+  { /* Nothing to do. */ }
+
+  /**
+   * Update step for SGD.  The iterate is updated in the given ranges only.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The gradient matrix.
+   */
+  template<typename MatType>
+  void Update(MatType& iterate,
+              const double stepSize,
+              const MatType& gradient)
+  {
+    if (ranges == NULL || ranges->n_cols == 0)
+    {
+      iterate -= stepSize * gradient;
+      return;
+    }
+
+    for (size_t i = 0; i < ranges->n_cols; ++i)
+    {
+      const size_t begin = (*ranges)(0, i);
+      const size_t end = begin + (*ranges)(1, i) - 1;
+      iterate.rows(begin, end) -= stepSize * gradient.rows(begin, end);
+    }
+  }
+
+ private:
+  //! The ranges to update.
+  const arma::Mat<size_t>* ranges;
+};
+
+/**
+ * The SparseAdaGradUpdate class is the AdaGrad update policy restricted to the
+ * ranges of the gradient that the network wrote, as given by
+ * FFN::GradientRanges().  The squared gradients are only accumulated in these
+ * ranges, which is the same as the dense AdaGrad update, since the gradient is
+ * zero elsewhere.
+ *
+ * @code
+ * model.SparseGradient() = true;
+ * ens::SGD<SparseAdaGradUpdate> optimizer(0.01, 32, 100000, 1e-5, true,
+ *     SparseAdaGradUpdate(model.GradientRanges()));
+ * model.Train(predictors, responses, optimizer);
+ * @endcode
+ */
+class SparseAdaGradUpdate
+{
+ public:
+  /**
+   * Create the update policy.
+   *
+   * @param ranges The ranges to update, as one column per range with the index
+   *     of its first parameter and its length.  The matrix is not copied and
+   *     must outlive the optimization.
+   * @param epsilon The epsilon value used to initialise the squared gradient
+   *     parameter.
+   */
+  SparseAdaGradUpdate(const arma::Mat<size_t>& ranges,
+                      const double epsilon = 1e-8) :
+      ranges(&ranges),
+      epsilon(epsilon)
+  { }
+
+  /**
+   * Create the update policy that updates all the parameters.
+   *
+   * @param epsilon The epsilon value used to initialise the squared gradient
+   *     parameter.
+   */
+  SparseAdaGradUpdate(const double epsilon = 1e-8) :
+      ranges(NULL),
+      epsilon(epsilon)
+  { }
+
+  /**
+   * The Initialize method is called by SGD Optimizer method before the start
+   * of the iteration update process.  The squared gradient matrix is
+   * initialized to zeros.
+   *
+   * @param rows Number of rows in the gradient matrix.
+   * @param cols Number of columns in the gradient matrix.
+   */
+  void Initialize(const size_t rows, const size_t cols)
+  {
+    squaredGradient.zeros(rows, cols);
+  }
+
+  /**
+   * Update step for SGD.  The squared gradient and the iterate are updated in
+   * the given ranges only.
+   *
+   * @param iterate Parameters that minimize the function.
+   * @param stepSize Step size to be used for the given iteration.
+   * @param gradient The gradient matrix.
+   */
+  template<typename MatType>
+  void Update(MatType& iterate,
+              const double stepSize,
+              const MatType& gradient)
+  {
+    if (ranges == NULL || ranges->n_cols == 0)
+    {
+      squaredGradient += gradient % gradient;
+      iterate -= (stepSize * gradient) / (arma::sqrt(squaredGradient) +
+          epsilon);
+      return;
+    }
+
+    for (size_t i = 0; i < ranges->n_cols; ++i)
+    {
+      const size_t begin = (*ranges)(0, i);
+      const size_t end = begin + (*ranges)(1, i) - 1;
+      squaredGradient.rows(begin, end) += gradient.rows(begin, end) %
+          gradient.rows(begin, end);
+      iterate.rows(begin, end) -= (stepSize * gradient.rows(begin, end)) /
+          (arma::sqrt(squaredGradient.rows(begin, end)) + epsilon);
+    }
+  }
+
+  //! Get the value used to initialise the squared gradient parameter.
+  double Epsilon() const { return epsilon; }
+  //! Modify the value used to initialise the squared gradient parameter.
+  double& Epsilon() { return epsilon; }
+
+ private:
+  //! The ranges to update.
+  const arma::Mat<size_t>* ranges;
+
+  //! The epsilon value used to initialise the squared gradient parameter.
+  double epsilon;
+
+  //! The squared gradient matrix.
+  arma::mat squaredGradient;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
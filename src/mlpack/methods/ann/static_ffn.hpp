@@ -0,0 +1,441 @@
+/**
+ * @file static_ffn.hpp
+ *
+ * Definition of the StaticFFN class, a feed forward neural network whose
+ * layers are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "visitor/loss_visitor.hpp"
+#include "visitor/output_height_visitor.hpp"
+#include "visitor/output_width_visitor.hpp"
+#include "visitor/reset_visitor.hpp"
+#include "visitor/weight_size_visitor.hpp"
+
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/init_rules/init_rules_traits.hpp>
+#include <mlpack/methods/ann/init_rules/random_init.hpp>
+#include <ensmallen.hpp>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * Implementation of a feed forward network whose layers are given as template
+ * parameters, for instance
+ *
+ * @code
+ * StaticFFN<NegativeLogLikelihood<>, RandomInitialization,
+ *     Linear<>, SigmoidLayer<>, Linear<>, LogSoftMax<> >
+ *     model(Linear<>(10, 8), SigmoidLayer<>(), Linear<>(8, 3), LogSoftMax<>());
+ * model.Train(trainData, trainLabels);
+ * @endcode
+ *
+ * The layers are held by value in a std::tuple, and the forward, backward and
+ * gradient passes are unrolled at compile time over the tuple.  The visitors
+ * are applied directly to each layer, so that unlike with the FFN class there
+ * is no boost::variant dispatch between the layers, and the calls to the
+ * layers can be inlined.  Otherwise the network behaves like an FFN with the
+ * same layers: the parameters, the gradients and the objective are the same.
+ *
+ * Since the layers are copied with the network, layers that hold other layers
+ * (i.e. that implement a Model() function, like Sequential or Concat) can't be
+ * used.
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ *         Its output parameter type is the matrix type of the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam Layers The types of the layers of the network, in order.
+ */
+template<
+  typename OutputLayerType,
+  typename InitializationRuleType,
+  typename... Layers
+>
+class StaticFFN
+{
+  static_assert(sizeof...(Layers) > 0,
+      "StaticFFN must have at least one layer.");
+
+ public:
+  //! The matrix type of the network, given by the output layer.
+  typedef typename std::remove_reference<decltype(
+      std::declval<OutputLayerType&>().OutputParameter())>::type MatType;
+
+  //! The number of layers of the network.
+  static const size_t NumLayers = sizeof...(Layers);
+
+  /**
+   * Create the StaticFFN object with the given layers, and default-constructed
+   * output layer and initialization rule.
+   *
+   * @param layers The layers of the network.
+   */
+  explicit StaticFFN(Layers... layers);
+
+  /**
+   * Create the StaticFFN object with the given output layer, initialization
+   * rule and layers.
+   *
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param initializeRule Instantiated InitializationRule object for
+   *        initializing the network parameter.
+   * @param layers The layers of the network.
+   */
+  StaticFFN(OutputLayerType outputLayer,
+            InitializationRuleType initializeRule,
+            Layers... layers);
+
+  //! Copy constructor.
+  StaticFFN(const StaticFFN& network);
+
+  //! Move constructor.
+  StaticFFN(StaticFFN&& network);
+
+  //! Copy/move assignment operator.
+  StaticFFN& operator=(StaticFFN network);
+
+  /**
+   * Train the network on the given input data using the given optimizer.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization. If this is not what you want, then you should access the
+   * parameters vector directly with Parameters() and modify it as desired.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType>
+  double Train(MatType predictors,
+               MatType responses,
+               OptimizerType& optimizer);
+
+  /**
+   * Train the network on the given input data. By default, the RMSProp
+   * optimization algorithm is used, but others can be specified (such as
+   * ens::SGD).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp>
+  double Train(MatType predictors, MatType responses);
+
+  /**
+   * Predict the responses to a given set of predictors.  As with FFN, the
+   * predictors are not copied and are passed through the network in batches
+   * of batchSize points.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Number of points passed through the network at once; 0
+   *      passes all of the points at once.
+   */
+  void Predict(const MatType& predictors,
+               MatType& results,
+               const size_t batchSize = 128);
+
+  /**
+   * Evaluate the network with the given predictors and responses.
+   *
+   * @param predictors Input variables.
+   * @param responses Target outputs for input variables.
+   */
+  double Evaluate(MatType predictors, MatType responses);
+
+  /**
+   * Evaluate the network on all the points of the training data, one at a
+   * time.
+   *
+   * @param parameters Matrix model parameters.
+   */
+  double Evaluate(const MatType& parameters);
+
+  /**
+   * Evaluate the network with the given parameters, but using only a number of
+   * data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   * @param deterministic Whether or not to train or test the model. Note some
+   *        layer act differently in training or testing mode.
+   */
+  double Evaluate(const MatType& parameters,
+                  const size_t begin,
+                  const size_t batchSize,
+                  const bool deterministic);
+
+  /**
+   * Evaluate the network with the given parameters, but using only a number of
+   * data points.  This just calls the overload of Evaluate() with
+   * deterministic = true.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  double Evaluate(const MatType& parameters,
+                  const size_t begin,
+                  const size_t batchSize);
+
+  /**
+   * Evaluate the network and its gradient on all the points of the training
+   * data, one at a time.
+   *
+   * @param parameters Matrix model parameters.
+   * @param gradient Matrix to output gradient into.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(const MatType& parameters, GradType& gradient);
+
+  /**
+   * Evaluate the network and its gradient with the given parameters, but using
+   * only a number of data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  template<typename GradType>
+  double EvaluateWithGradient(const MatType& parameters,
+                              const size_t begin,
+                              GradType& gradient,
+                              const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the network with the given parameters, and with
+   * respect to only a number of points in the dataset.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                MatType& gradient,
+                const size_t batchSize);
+
+  /**
+   * Shuffle the order of function visitation. This may be called by the
+   * optimizer.
+   */
+  void Shuffle();
+
+  //! Return the number of separable functions (the number of predictor points).
+  size_t NumFunctions() const { return numFunctions; }
+
+  //! Return the initial point for the optimization.
+  const MatType& Parameters() const { return parameter; }
+  //! Modify the initial point for the optimization.
+  MatType& Parameters() { return parameter; }
+
+  //! Get the matrix of responses to the input data points.
+  const MatType& Responses() const { return responses; }
+  //! Modify the matrix of responses to the input data points.
+  MatType& Responses() { return responses; }
+
+  //! Get the matrix of data points (predictors).
+  const MatType& Predictors() const { return predictors; }
+  //! Modify the matrix of data points (predictors).
+  MatType& Predictors() { return predictors; }
+
+  //! Get the layer with the given index.
+  template<size_t I>
+  const typename std::tuple_element<I, std::tuple<Layers...> >::type&
+  Layer() const { return std::get<I>(network); }
+  //! Modify the layer with the given index.
+  template<size_t I>
+  typename std::tuple_element<I, std::tuple<Layers...> >::type&
+  Layer() { return std::get<I>(network); }
+
+  /**
+   * Reset the module information (weights/parameters).
+   */
+  void ResetParameters();
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Prepare the network for the given data.
+   *
+   * @param predictors Input data variables.
+   * @param responses Outputs results from input data variables.
+   */
+  void ResetData(MatType predictors, MatType responses);
+
+  //! Evaluate the output layer and the layer losses after a forward pass.
+  double OutputLoss(MatType&& responses);
+
+  //! Make the layers use the weights stored in the parameter matrix.
+  void LinkParameters();
+
+  /**
+   * Reset the module status by setting the current deterministic parameter
+   * for all modules that implement the Deterministic function.
+   */
+  void ResetDeterministic();
+
+  //! The tag of the layer with index I, used to unroll the passes over the
+  //! layers at compile time.
+  template<size_t I>
+  using Index = std::integral_constant<size_t, I>;
+
+  /**
+   * Run the forward pass of the layer with index I and of the following
+   * layers, given the input of layer I.
+   */
+  template<size_t I>
+  void Forward(MatType&& input, Index<I> /* layer */);
+
+  //! End of the forward pass.
+  void Forward(MatType&& /* input */, Index<NumLayers> /* layer */) { }
+
+  /**
+   * Run the backward pass of the layer with index I and of the previous
+   * layers but the first, given the error of layer I.
+   */
+  template<size_t I>
+  void Backward(MatType&& gy, Index<I> /* layer */);
+
+  //! End of the backward pass; the first layer has no backward pass.
+  void Backward(MatType&& /* gy */, Index<0> /* layer */) { }
+
+  /**
+   * Compute the gradient of the layer with index I and of the following
+   * layers, given the input of layer I.
+   */
+  template<size_t I>
+  void Gradient(MatType&& input, Index<I> /* layer */);
+
+  //! Compute the gradient of the last layer, given its input.
+  void Gradient(MatType&& input, Index<NumLayers - 1> /* layer */);
+
+  //! Initialize the weights of the layer with index I and of the following
+  //! layers, one layer at a time.
+  template<size_t I>
+  void InitializeWeights(const size_t offset, Index<I> /* layer */);
+
+  //! End of the layer-wise initialization.
+  void InitializeWeights(const size_t /* offset */,
+                         Index<NumLayers> /* layer */) { }
+
+  //! Set the weights of the layer with index I and of the following layers.
+  template<size_t I>
+  void SetWeights(const size_t offset, Index<I> /* layer */);
+
+  //! End of the weight setting.
+  void SetWeights(const size_t /* offset */, Index<NumLayers> /* layer */) { }
+
+  //! Set the gradient of the layer with index I and of the following layers.
+  template<size_t I>
+  void SetGradients(MatType& gradient,
+                    const size_t offset,
+                    Index<I> /* layer */);
+
+  //! End of the gradient setting.
+  void SetGradients(MatType& /* gradient */,
+                    const size_t /* offset */,
+                    Index<NumLayers> /* layer */) { }
+
+  //! Apply the given visitor to the layer with index I and to the following
+  //! layers.
+  template<typename VisitorType, size_t I>
+  void ForEachLayer(const VisitorType& visitor, Index<I> /* layer */);
+
+  //! End of ForEachLayer().
+  template<typename VisitorType>
+  void ForEachLayer(const VisitorType& /* visitor */,
+                    Index<NumLayers> /* layer */) { }
+
+  //! Return the sum of the results of the given visitor over the layer with
+  //! index I and the following layers.
+  template<typename T, typename VisitorType, size_t I>
+  T SumLayers(const VisitorType& visitor, Index<I> /* layer */);
+
+  //! End of SumLayers().
+  template<typename T, typename VisitorType>
+  T SumLayers(const VisitorType& /* visitor */, Index<NumLayers> /* layer */)
+  {
+    return T(0);
+  }
+
+  //! Serialize the layer with index I and the following layers.
+  template<typename Archive, size_t I>
+  void SerializeLayers(Archive& ar, Index<I> /* layer */);
+
+  //! End of SerializeLayers().
+  template<typename Archive>
+  void SerializeLayers(Archive& /* ar */, Index<NumLayers> /* layer */) { }
+
+  //! Instantiated outputlayer used to evaluate the network.
+  OutputLayerType outputLayer;
+
+  //! Instantiated InitializationRule object for initializing the network
+  //! parameter.
+  InitializationRuleType initializeRule;
+
+  //! The input width.
+  size_t width;
+
+  //! The input height.
+  size_t height;
+
+  //! Indicator if we already passed data through the network.
+  bool reset;
+
+  //! Locally-stored model modules.
+  std::tuple<Layers...> network;
+
+  //! The matrix of data points (predictors).
+  MatType predictors;
+
+  //! The matrix of responses to the input data points.
+  MatType responses;
+
+  //! Matrix of (trained) parameters.
+  MatType parameter;
+
+  //! The number of separable functions (the number of predictor points).
+  size_t numFunctions;
+
+  //! The current error for the backward pass.
+  MatType error;
+
+  //! The current evaluation mode (training or testing).
+  bool deterministic;
+}; // class StaticFFN
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "static_ffn_impl.hpp"
+
+#endif
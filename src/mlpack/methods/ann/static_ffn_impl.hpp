@@ -0,0 +1,575 @@
+/**
+ * @file static_ffn_impl.hpp
+ *
+ * Implementation of the StaticFFN class, a feed forward neural network whose
+ * layers are fixed at compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+#define MLPACK_METHODS_ANN_STATIC_FFN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "static_ffn.hpp"
+
+#include <mlpack/core/math/make_alias.hpp>
+
+#include "visitor/forward_visitor.hpp"
+#include "visitor/backward_visitor.hpp"
+#include "visitor/deterministic_set_visitor.hpp"
+#include "visitor/gradient_set_visitor.hpp"
+#include "visitor/gradient_visitor.hpp"
+#include "visitor/set_input_height_visitor.hpp"
+#include "visitor/set_input_width_visitor.hpp"
+#include "visitor/weight_set_visitor.hpp"
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    Layers... layers) :
+    width(0),
+    height(0),
+    reset(false),
+    network(std::move(layers)...),
+    numFunctions(0),
+    deterministic(true)
+{
+  /* Nothing to do here */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    OutputLayerType outputLayer,
+    InitializationRuleType initializeRule,
+    Layers... layers) :
+    outputLayer(std::move(outputLayer)),
+    initializeRule(std::move(initializeRule)),
+    width(0),
+    height(0),
+    reset(false),
+    network(std::move(layers)...),
+    numFunctions(0),
+    deterministic(true)
+{
+  /* Nothing to do here */
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    const StaticFFN& network) :
+    outputLayer(network.outputLayer),
+    initializeRule(network.initializeRule),
+    width(network.width),
+    height(network.height),
+    reset(network.reset),
+    network(network.network),
+    predictors(network.predictors),
+    responses(network.responses),
+    parameter(network.parameter),
+    numFunctions(network.numFunctions),
+    error(network.error),
+    deterministic(network.deterministic)
+{
+  // The copied layers still use the weights of the other network.
+  LinkParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::StaticFFN(
+    StaticFFN&& network) :
+    outputLayer(std::move(network.outputLayer)),
+    initializeRule(std::move(network.initializeRule)),
+    width(network.width),
+    height(network.height),
+    reset(network.reset),
+    network(std::move(network.network)),
+    predictors(std::move(network.predictors)),
+    responses(std::move(network.responses)),
+    parameter(std::move(network.parameter)),
+    numFunctions(network.numFunctions),
+    error(std::move(network.error)),
+    deterministic(network.deterministic)
+{
+  // Small parameter matrices are copied instead of moved.
+  LinkParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>&
+StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::operator=(
+    StaticFFN network)
+{
+  outputLayer = std::move(network.outputLayer);
+  initializeRule = std::move(network.initializeRule);
+  width = network.width;
+  height = network.height;
+  reset = network.reset;
+  this->network = std::move(network.network);
+  predictors = std::move(network.predictors);
+  responses = std::move(network.responses);
+  parameter = std::move(network.parameter);
+  numFunctions = network.numFunctions;
+  error = std::move(network.error);
+  deterministic = network.deterministic;
+
+  LinkParameters();
+  return *this;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::ResetData(
+    MatType predictors, MatType responses)
+{
+  numFunctions = responses.n_cols;
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+  this->deterministic = true;
+  ResetDeterministic();
+
+  if (parameter.is_empty())
+    ResetParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Train(
+    MatType predictors,
+    MatType responses,
+    OptimizerType& optimizer)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const double out = optimizer.Optimize(*this, parameter);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "StaticFFN::Train(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename OptimizerType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Train(
+    MatType predictors, MatType responses)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses), optimizer);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Predict(
+    const MatType& predictors, MatType& results, const size_t batchSize)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  if (predictors.n_cols == 0)
+  {
+    results.reset();
+    return;
+  }
+
+  const size_t effectiveBatchSize = (batchSize == 0) ? predictors.n_cols :
+      std::min(batchSize, (size_t) predictors.n_cols);
+  for (size_t i = 0; i < predictors.n_cols; i += effectiveBatchSize)
+  {
+    const size_t end = std::min(i + effectiveBatchSize,
+        (size_t) predictors.n_cols) - 1;
+
+    // Use an alias of the predictors as the input of the first layer, so that
+    // they are not copied.
+    Forward(std::move(MatType(const_cast<typename MatType::elem_type*>(
+        predictors.colptr(i)), predictors.n_rows, end - i + 1, false, true)),
+        Index<0>());
+
+    const MatType& output = std::get<NumLayers - 1>(network).OutputParameter();
+    if (i == 0)
+      results.set_size(output.n_rows, predictors.n_cols);
+    results.cols(i, end) = output;
+  }
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    MatType predictors, MatType responses)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (!deterministic)
+  {
+    deterministic = true;
+    ResetDeterministic();
+  }
+
+  Forward(std::move(predictors), Index<0>());
+  return OutputLoss(std::move(responses));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const MatType& parameters)
+{
+  double res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += Evaluate(parameters, i, 1, true);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const MatType& /* parameters */,
+    const size_t begin,
+    const size_t batchSize,
+    const bool deterministic)
+{
+  if (parameter.is_empty())
+    ResetParameters();
+
+  if (deterministic != this->deterministic)
+  {
+    this->deterministic = deterministic;
+    ResetDeterministic();
+  }
+
+  // Aliases of the batch are passed to the network, so that it is not copied.
+  Forward(math::MakeColsAlias(predictors, begin, batchSize), Index<0>());
+  return OutputLoss(math::MakeColsAlias(responses, begin, batchSize));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Evaluate(
+    const MatType& parameters, const size_t begin, const size_t batchSize)
+{
+  return Evaluate(parameters, begin, batchSize, true);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename GradType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+EvaluateWithGradient(const MatType& parameters, GradType& gradient)
+{
+  double res = 0;
+  for (size_t i = 0; i < predictors.n_cols; ++i)
+    res += EvaluateWithGradient(parameters, i, gradient, 1);
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename GradType>
+double StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::
+EvaluateWithGradient(const MatType& /* parameters */,
+                     const size_t begin,
+                     GradType& gradient,
+                     const size_t batchSize)
+{
+  if (gradient.is_empty())
+  {
+    if (parameter.is_empty())
+      ResetParameters();
+
+    gradient = arma::zeros<MatType>(parameter.n_rows, parameter.n_cols);
+  }
+  else
+  {
+    gradient.zeros();
+  }
+
+  if (this->deterministic)
+  {
+    this->deterministic = false;
+    ResetDeterministic();
+  }
+
+  // Aliases of the batch are passed to the network, so that it is not copied.
+  Forward(math::MakeColsAlias(predictors, begin, batchSize), Index<0>());
+  const double res = OutputLoss(math::MakeColsAlias(responses, begin,
+      batchSize));
+
+  outputLayer.Backward(
+      std::move(std::get<NumLayers - 1>(network).OutputParameter()),
+      math::MakeColsAlias(responses, begin, batchSize), std::move(error));
+
+  Backward(std::move(error), Index<NumLayers - 1>());
+  SetGradients(gradient, 0, Index<0>());
+  Gradient(math::MakeColsAlias(predictors, begin, batchSize), Index<0>());
+
+  return res;
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Gradient(
+    const MatType& parameters,
+    const size_t begin,
+    MatType& gradient,
+    const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Shuffle()
+{
+  math::ShuffleDataInPlace(predictors, responses);
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetParameters()
+{
+  ResetDeterministic();
+
+  // Reset the network parameter with the given initialization rule, in the
+  // same way as NetworkInitialization does for the FFN class.
+  if (parameter.is_empty())
+    parameter.set_size(SumLayers<size_t>(WeightSizeVisitor(), Index<0>()), 1);
+
+  if (ann::InitTraits<InitializationRuleType>::UseLayer)
+    InitializeWeights(0, Index<0>());
+  else
+    initializeRule.Initialize(parameter, parameter.n_elem, 1);
+
+  LinkParameters();
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ResetDeterministic()
+{
+  ForEachLayer(DeterministicSetVisitor(deterministic), Index<0>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::LinkParameters()
+{
+  if (parameter.is_empty())
+    return;
+
+  SetWeights(0, Index<0>());
+  ForEachLayer(ResetVisitor(), Index<0>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+double StaticFFN<OutputLayerType, InitializationRuleType,
+                 Layers...>::OutputLoss(MatType&& responses)
+{
+  return outputLayer.Forward(
+      std::move(std::get<NumLayers - 1>(network).OutputParameter()),
+      std::move(responses)) + SumLayers<double>(LossVisitor(), Index<0>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Forward(
+    MatType&& input, Index<I> /* layer */)
+{
+  auto& layer = std::get<I>(network);
+
+  // The first layer gets its input dimensions from the data.
+  if (!reset && I > 0)
+  {
+    const SetInputWidthVisitor setInputWidthVisitor(width);
+    setInputWidthVisitor(&layer);
+
+    const SetInputHeightVisitor setInputHeightVisitor(height);
+    setInputHeightVisitor(&layer);
+  }
+
+  const ForwardVisitor<MatType> forwardVisitor(std::move(input),
+      std::move(layer.OutputParameter()));
+  forwardVisitor(&layer);
+
+  if (!reset)
+  {
+    const size_t outputWidth = OutputWidthVisitor()(&layer);
+    if (outputWidth != 0)
+      width = outputWidth;
+
+    const size_t outputHeight = OutputHeightVisitor()(&layer);
+    if (outputHeight != 0)
+      height = outputHeight;
+
+    // The dimensions are only needed the first time data is passed through
+    // the network.
+    if (I == NumLayers - 1)
+      reset = true;
+  }
+
+  Forward(std::move(layer.OutputParameter()), Index<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Backward(
+    MatType&& gy, Index<I> /* layer */)
+{
+  auto& layer = std::get<I>(network);
+  const BackwardVisitor<MatType> backwardVisitor(
+      std::move(layer.OutputParameter()), std::move(gy),
+      std::move(layer.Delta()));
+  backwardVisitor(&layer);
+
+  Backward(std::move(layer.Delta()), Index<I - 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Gradient(
+    MatType&& input, Index<I> /* layer */)
+{
+  auto& layer = std::get<I>(network);
+  const GradientVisitor<MatType> gradientVisitor(std::move(input),
+      std::move(std::get<I + 1>(network).Delta()));
+  gradientVisitor(&layer);
+
+  Gradient(std::move(layer.OutputParameter()), Index<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::Gradient(
+    MatType&& input, Index<NumLayers - 1> /* layer */)
+{
+  const GradientVisitor<MatType> gradientVisitor(std::move(input),
+      std::move(error));
+  gradientVisitor(&std::get<NumLayers - 1>(network));
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::InitializeWeights(const size_t offset,
+                                             Index<I> /* layer */)
+{
+  const size_t weight = WeightSizeVisitor()(&std::get<I>(network));
+  MatType tmp = MatType(parameter.memptr() + offset, weight, 1, false, false);
+  initializeRule.Initialize(tmp, tmp.n_elem, 1);
+
+  InitializeWeights(offset + weight, Index<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::SetWeights(
+    const size_t offset, Index<I> /* layer */)
+{
+  const size_t weight = WeightSetVisitor<MatType>(std::move(parameter),
+      offset)(&std::get<I>(network));
+
+  SetWeights(offset + weight, Index<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::SetGradients(MatType& gradient,
+                                        const size_t offset,
+                                        Index<I> /* layer */)
+{
+  const size_t weight = GradientSetVisitor<MatType>(std::move(gradient),
+      offset)(&std::get<I>(network));
+
+  SetGradients(gradient, offset + weight, Index<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename VisitorType, size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::ForEachLayer(const VisitorType& visitor,
+                                        Index<I> /* layer */)
+{
+  visitor(&std::get<I>(network));
+  ForEachLayer(visitor, Index<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename T, typename VisitorType, size_t I>
+T StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::SumLayers(
+    const VisitorType& visitor, Index<I> /* layer */)
+{
+  return T(visitor(&std::get<I>(network))) +
+      SumLayers<T>(visitor, Index<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename Archive, size_t I>
+void StaticFFN<OutputLayerType, InitializationRuleType,
+               Layers...>::SerializeLayers(Archive& ar, Index<I> /* layer */)
+{
+  ar & boost::serialization::make_nvp("layer", std::get<I>(network));
+  SerializeLayers(ar, Index<I + 1>());
+}
+
+template<typename OutputLayerType, typename InitializationRuleType,
+         typename... Layers>
+template<typename Archive>
+void StaticFFN<OutputLayerType, InitializationRuleType, Layers...>::serialize(
+    Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(parameter);
+  ar & BOOST_SERIALIZATION_NVP(width);
+  ar & BOOST_SERIALIZATION_NVP(height);
+  ar & BOOST_SERIALIZATION_NVP(reset);
+
+  SerializeLayers(ar, Index<0>());
+
+  // If we are loading, we need to initialize the weights.
+  if (Archive::is_loading::value)
+  {
+    LinkParameters();
+
+    deterministic = true;
+    ResetDeterministic();
+  }
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,169 @@
+/**
+ * @file training_checkpoint.cpp
+ *
+ * Implementation of the TrainingCheckpoint class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "training_checkpoint.hpp"
+
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <cstdio>
+#include <fstream>
+
+using namespace mlpack;
+using namespace mlpack::ann;
+
+TrainingCheckpoint::TrainingCheckpoint(const std::string& path,
+                                       const size_t interval) :
+    path(path),
+    interval(interval),
+    iterations(0),
+    pendingIterations(0),
+    hasPending(false)
+{
+  // Nothing to do here.
+}
+
+TrainingCheckpoint::TrainingCheckpoint(const TrainingCheckpoint& other) :
+    path(other.path),
+    interval(other.interval),
+    iterations(other.iterations),
+    pendingIterations(0),
+    hasPending(false)
+{
+  // Nothing to do here.
+}
+
+TrainingCheckpoint& TrainingCheckpoint::operator=(
+    const TrainingCheckpoint& other)
+{
+  if (this != &other)
+  {
+    Wait();
+    path = other.path;
+    interval = other.interval;
+    iterations = other.iterations;
+  }
+
+  return *this;
+}
+
+void TrainingCheckpoint::Update(const arma::mat& parameters)
+{
+  ++iterations;
+  if (!Enabled())
+    return;
+
+  if (iterations % interval == 0)
+  {
+    pending = parameters;
+    pendingIterations = iterations;
+    hasPending = true;
+  }
+
+  if (hasPending && (!writing.valid() || writing.wait_for(
+      std::chrono::seconds(0)) == std::future_status::ready))
+  {
+    Launch();
+  }
+}
+
+void TrainingCheckpoint::Finish(const arma::mat& parameters)
+{
+  if (!Enabled())
+    return;
+
+  pending = parameters;
+  pendingIterations = iterations;
+  hasPending = true;
+  Wait();
+}
+
+void TrainingCheckpoint::Wait()
+{
+  while (true)
+  {
+    // Rethrow the exception of the last write, if any.
+    if (writing.valid())
+      writing.get();
+
+    if (!hasPending)
+      return;
+
+    Launch();
+  }
+}
+
+bool TrainingCheckpoint::Restore(arma::mat& parameters)
+{
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs.is_open())
+    return false;
+
+  try
+  {
+    boost::archive::binary_iarchive ar(ifs);
+    size_t savedIterations;
+    ar >> savedIterations;
+    ar >> parameters;
+    iterations = savedIterations;
+  }
+  catch (boost::archive::archive_exception& e)
+  {
+    std::ostringstream oss;
+    oss << "TrainingCheckpoint::Restore(): can't load the checkpoint '" << path
+        << "': " << e.what();
+    throw std::runtime_error(oss.str());
+  }
+
+  return true;
+}
+
+void TrainingCheckpoint::Launch()
+{
+  // Rethrow the exception of the last write, if any.  The write is done, so
+  // its buffer can be reused.
+  if (writing.valid())
+    writing.get();
+
+  if (!written)
+    written = std::make_shared<arma::mat>();
+  written->swap(pending);
+  hasPending = false;
+
+  writing = std::async(std::launch::async, &TrainingCheckpoint::Save, path,
+      std::shared_ptr<const arma::mat>(written), pendingIterations);
+}
+
+void TrainingCheckpoint::Save(const std::string& file,
+                              std::shared_ptr<const arma::mat> parameters,
+                              const size_t iterations)
+{
+  const std::string temporary = file + ".tmp";
+  {
+    std::ofstream ofs(temporary, std::ios::binary);
+    if (!ofs.is_open())
+    {
+      std::ostringstream oss;
+      oss << "TrainingCheckpoint: can't open '" << temporary << "' for writing";
+      throw std::runtime_error(oss.str());
+    }
+
+    boost::archive::binary_oarchive ar(ofs);
+    ar << iterations;
+    ar << *parameters;
+  }
+
+  if (std::rename(temporary.c_str(), file.c_str()) != 0)
+  {
+    std::ostringstream oss;
+    oss << "TrainingCheckpoint: can't replace '" << file << "' with the new "
+        << "checkpoint";
+    throw std::runtime_error(oss.str());
+  }
+}
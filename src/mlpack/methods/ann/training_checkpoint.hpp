@@ -0,0 +1,165 @@
+/**
+ * @file training_checkpoint.hpp
+ *
+ * Definition of the TrainingCheckpoint class, which periodically writes the
+ * parameters of a network to disk while it is trained.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_TRAINING_CHECKPOINT_HPP
+#define MLPACK_METHODS_ANN_TRAINING_CHECKPOINT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <future>
+#include <memory>
+
+namespace mlpack {
+namespace ann /** Artificial Neural Network. */ {
+
+/**
+ * The TrainingCheckpoint class snapshots the parameters of a network every
+ * Interval() iterations (batches evaluated by EvaluateWithGradient()), and
+ * writes the snapshot to Path() in a background thread, so that a long
+ * training can be resumed after a failure.  FFN and RNN hold a
+ * TrainingCheckpoint, which writes nothing until it is given a path and an
+ * interval:
+ *
+ * @code
+ * model.Checkpoint().Path() = "model.ckpt";
+ * model.Checkpoint().Interval() = 1000;
+ * model.Train(trainData, trainLabels, optimizer);
+ * @endcode
+ *
+ * and training is resumed from the last checkpoint with
+ *
+ * @code
+ * model.ResetParameters();
+ * model.Checkpoint().Restore(model.Parameters());
+ * model.Train(trainData, trainLabels, optimizer);
+ * @endcode
+ *
+ * The training loop only copies the parameters into a buffer; the buffer is
+ * swapped with the one of the last write when that write is done, so a slow
+ * disk delays the checkpoints but never the training.  When a new snapshot is
+ * taken before the last one could be written, the older one is dropped.  Each
+ * checkpoint is written to a temporary file which then replaces Path(), so
+ * Path() always holds a complete checkpoint.  Train() writes a last checkpoint
+ * and waits for it before returning.
+ *
+ * Only the parameters and the number of iterations are saved: the optimizers
+ * don't expose their state, so stateful optimizers (like Adam) start again
+ * from their initial state when training is resumed.
+ */
+class TrainingCheckpoint
+{
+ public:
+  /**
+   * Create the checkpoint.  Nothing is written unless both the path and the
+   * interval are set.
+   *
+   * @param path The file to write the checkpoints to.
+   * @param interval The number of iterations between two checkpoints.
+   */
+  TrainingCheckpoint(const std::string& path = "", const size_t interval = 0);
+
+  //! Copy the settings and the iterations (but not the pending writes).
+  TrainingCheckpoint(const TrainingCheckpoint& other);
+  //! Take ownership of the checkpoint and of its pending writes.
+  TrainingCheckpoint(TrainingCheckpoint&& other) = default;
+  //! Copy the settings and the iterations (but not the pending writes).
+  TrainingCheckpoint& operator=(const TrainingCheckpoint& other);
+  //! Take ownership of the checkpoint and of its pending writes.
+  TrainingCheckpoint& operator=(TrainingCheckpoint&& other) = default;
+
+  //! Get the file the checkpoints are written to.
+  const std::string& Path() const { return path; }
+  //! Modify the file the checkpoints are written to.
+  std::string& Path() { return path; }
+
+  //! Get the number of iterations between two checkpoints (0 disables them).
+  size_t Interval() const { return interval; }
+  //! Modify the number of iterations between two checkpoints.
+  size_t& Interval() { return interval; }
+
+  //! Get the number of iterations seen so far.
+  size_t Iterations() const { return iterations; }
+  //! Modify the number of iterations seen so far.
+  size_t& Iterations() { return iterations; }
+
+  //! Get whether checkpoints are written.
+  bool Enabled() const { return !path.empty() && interval > 0; }
+
+  /**
+   * Count an iteration of the optimizer, and take a snapshot of the parameters
+   * if it is due.  The pending snapshot is written if the last write is done.
+   *
+   * @param parameters The current parameters of the network.
+   */
+  void Update(const arma::mat& parameters);
+
+  /**
+   * Take a snapshot of the parameters and wait until it is written, if the
+   * checkpoints are enabled.
+   *
+   * @param parameters The current parameters of the network.
+   */
+  void Finish(const arma::mat& parameters);
+
+  /**
+   * Wait until the pending snapshots are written.  A std::runtime_error is
+   * thrown if a write failed.
+   */
+  void Wait();
+
+  /**
+   * Load the parameters and the number of iterations of the checkpoint at
+   * Path().
+   *
+   * @param parameters Matrix to load the parameters into.
+   * @return Whether a checkpoint was found.
+   */
+  bool Restore(arma::mat& parameters);
+
+ private:
+  //! Start writing the pending snapshot.
+  void Launch();
+
+  /**
+   * Write a snapshot to the given file, through a temporary file.
+   *
+   * @param file The file to write to.
+   * @param parameters The parameters to write.
+   * @param iterations The number of iterations of the snapshot.
+   */
+  static void Save(const std::string& file,
+                   std::shared_ptr<const arma::mat> parameters,
+                   const size_t iterations);
+
+  //! The file the checkpoints are written to.
+  std::string path;
+  //! The number of iterations between two checkpoints.
+  size_t interval;
+  //! The number of iterations seen so far.
+  size_t iterations;
+
+  //! The snapshot that waits to be written.
+  arma::mat pending;
+  //! The number of iterations of the pending snapshot.
+  size_t pendingIterations;
+  //! Whether there is a pending snapshot.
+  bool hasPending;
+
+  //! The buffer of the snapshot that is (or was last) written.
+  std::shared_ptr<arma::mat> written;
+  //! The write in progress, if any.
+  std::future<void> writing;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
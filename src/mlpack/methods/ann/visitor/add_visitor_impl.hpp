@@ -19,35 +19,38 @@ namespace mlpack {
 namespace ann {
 
 //! AddVisitor visitor class.
-template<typename... CustomLayers>
+template<typename MatType, typename... CustomLayers>
 template<typename T>
-inline AddVisitor<CustomLayers...>::AddVisitor(T newLayer) :
+inline AddVisitor<MatType, CustomLayers...>::AddVisitor(T newLayer) :
     newLayer(std::move(newLayer))
 {
   /* Nothing to do here. */
 }
 
-template<typename... CustomLayers>
+template<typename MatType, typename... CustomLayers>
 template<typename LayerType>
-inline void AddVisitor<CustomLayers...>::operator()(LayerType* layer) const
+inline void AddVisitor<MatType, CustomLayers...>::operator()(
+    LayerType* layer) const
 {
   LayerAdd<LayerType>(layer);
 }
 
-template<typename... CustomLayers>
+template<typename MatType, typename... CustomLayers>
 template<typename T>
-inline typename std::enable_if<
-    HasAddCheck<T, void(T::*)(LayerTypes<CustomLayers...>)>::value, void>::type
-AddVisitor<CustomLayers...>::LayerAdd(T* layer) const
+inline typename std::enable_if<HasAddCheck<T,
+    void(T::*)(TypedLayerTypes<MatType, CustomLayers...>)>::value,
+    void>::type
+AddVisitor<MatType, CustomLayers...>::LayerAdd(T* layer) const
 {
   layer->Add(newLayer);
 }
 
-template<typename... CustomLayers>
+template<typename MatType, typename... CustomLayers>
 template<typename T>
-inline typename std::enable_if<
-    !HasAddCheck<T, void(T::*)(LayerTypes<CustomLayers...>)>::value, void>::type
-AddVisitor<CustomLayers...>::LayerAdd(T* /* layer */) const
+inline typename std::enable_if<!HasAddCheck<T,
+    void(T::*)(TypedLayerTypes<MatType, CustomLayers...>)>::value,
+    void>::type
+AddVisitor<MatType, CustomLayers...>::LayerAdd(T* /* layer */) const
 {
   /* Nothing to do here. */
 }
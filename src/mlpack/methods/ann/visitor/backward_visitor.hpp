@@ -25,15 +25,16 @@ namespace ann {
  * BackwardVisitor executes the Backward() function given the input, error and
  * delta parameter.
  */
+template<typename MatType = arma::mat>
 class BackwardVisitor : public boost::static_visitor<void>
 {
  public:
   //! Execute the Backward() function given the input, error and delta
   //! parameter.
-  BackwardVisitor(arma::mat&& input, arma::mat&& error, arma::mat&& delta);
+  BackwardVisitor(MatType&& input, MatType&& error, MatType&& delta);
 
   //! Execute the Backward() function for the layer with the specified index.
-  BackwardVisitor(arma::mat&& input, arma::mat&& error, arma::mat&& delta,
+  BackwardVisitor(MatType&& input, MatType&& error, MatType&& delta,
       const size_t index);
 
   //! Execute the Backward() function.
@@ -42,13 +43,13 @@ class BackwardVisitor : public boost::static_visitor<void>
 
  private:
   //! The input parameter set.
-  arma::mat&& input;
+  MatType&& input;
 
   //! The error parameter.
-  arma::mat&& error;
+  MatType&& error;
 
   //! The delta parameter.
-  arma::mat&& delta;
+  MatType&& delta;
 
   //! The index of the layer to run.
   size_t index;
@@ -61,13 +62,13 @@ class BackwardVisitor : public boost::static_visitor<void>
   template<typename T>
   typename std::enable_if<
       !HasRunCheck<T, bool&(T::*)(void)>::value, void>::type
-  LayerBackward(T* layer, arma::mat& input) const;
+  LayerBackward(T* layer, MatType& input) const;
 
   //! Execute the Backward() function if the module is has Run() function.
   template<typename T>
   typename std::enable_if<
       HasRunCheck<T, bool&(T::*)(void)>::value, void>::type
-  LayerBackward(T* layer, arma::mat& input) const;
+  LayerBackward(T* layer, MatType& input) const;
 };
 
 } // namespace ann
@@ -19,9 +19,10 @@ namespace mlpack {
 namespace ann {
 
 //! BackwardVisitor visitor class.
-inline BackwardVisitor::BackwardVisitor(arma::mat&& input,
-                                        arma::mat&& error,
-                                        arma::mat&& delta) :
+template<typename MatType>
+inline BackwardVisitor<MatType>::BackwardVisitor(MatType&& input,
+                                                 MatType&& error,
+                                                 MatType&& delta) :
   input(std::move(input)),
   error(std::move(error)),
   delta(std::move(delta)),
@@ -31,10 +32,11 @@ inline BackwardVisitor::BackwardVisitor(arma::mat&& input,
   /* Nothing to do here. */
 }
 
-inline BackwardVisitor::BackwardVisitor(arma::mat&& input,
-                                        arma::mat&& error,
-                                        arma::mat&& delta,
-                                        const size_t index) :
+template<typename MatType>
+inline BackwardVisitor<MatType>::BackwardVisitor(MatType&& input,
+                                                 MatType&& error,
+                                                 MatType&& delta,
+                                                 const size_t index) :
   input(std::move(input)),
   error(std::move(error)),
   delta(std::move(delta)),
@@ -44,24 +46,27 @@ inline BackwardVisitor::BackwardVisitor(arma::mat&& input,
   /* Nothing to do here. */
 }
 
+template<typename MatType>
 template<typename LayerType>
-inline void BackwardVisitor::operator()(LayerType* layer) const
+inline void BackwardVisitor<MatType>::operator()(LayerType* layer) const
 {
   LayerBackward(layer, layer->OutputParameter());
 }
 
+template<typename MatType>
 template<typename T>
 inline typename std::enable_if<
     !HasRunCheck<T, bool&(T::*)(void)>::value, void>::type
-BackwardVisitor::LayerBackward(T* layer, arma::mat& /* input */) const
+BackwardVisitor<MatType>::LayerBackward(T* layer, MatType& /* input */) const
 {
   layer->Backward(std::move(input), std::move(error), std::move(delta));
 }
 
+template<typename MatType>
 template<typename T>
 inline typename std::enable_if<
     HasRunCheck<T, bool&(T::*)(void)>::value, void>::type
-BackwardVisitor::LayerBackward(T* layer, arma::mat& /* input */) const
+BackwardVisitor<MatType>::LayerBackward(T* layer, MatType& /* input */) const
 {
   if (!hasIndex)
   {
@@ -0,0 +1,80 @@
+/**
+ * @file carry_state_visitor.hpp
+ *
+ * Boost static visitor abstraction for carrying the state of RNN cells over to
+ * the next window of truncated backpropagation through time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_CARRY_STATE_VISITOR_HPP
+#define MLPACK_METHODS_ANN_VISITOR_CARRY_STATE_VISITOR_HPP
+
+#include <mlpack/methods/ann/layer/layer_traits.hpp>
+#include <mlpack/methods/ann/layer/layer_types.hpp>
+
+#include <boost/variant.hpp>
+
+namespace mlpack {
+namespace ann {
+
+/**
+ * CarryStateVisitor executes the CarryState() function, so that the next
+ * window starts from the state after the given step of the current window.
+ * The cells that don't implement CarryState() are reset with ResetCell()
+ * instead, so they start the next window from their initial state.
+ */
+class CarryStateVisitor : public boost::static_visitor<void>
+{
+ public:
+  /**
+   * Carry the state after the given step over to the next window.
+   *
+   * @param step Number of steps of the current window before the next one.
+   * @param size The size used to reset the cells that can't carry their state.
+   */
+  CarryStateVisitor(const size_t step, const size_t size);
+
+  //! Execute the CarryState() function.
+  template<typename LayerType>
+  void operator()(LayerType* layer) const;
+
+ private:
+  //! Number of steps of the current window before the next one.
+  size_t step;
+
+  //! The size used to reset the cells that can't carry their state.
+  size_t size;
+
+  //! Execute the CarryState() function for a module which implements the
+  //! CarryState() function.
+  template<typename T>
+  typename std::enable_if<
+      HasCarryStateCheck<T, void(T::*)(const size_t)>::value, void>::type
+  CarryState(T* layer) const;
+
+  //! Execute the ResetCell() function for a module which only implements the
+  //! ResetCell() function.
+  template<typename T>
+  typename std::enable_if<
+      !HasCarryStateCheck<T, void(T::*)(const size_t)>::value &&
+      HasResetCellCheck<T, void(T::*)(const size_t)>::value, void>::type
+  CarryState(T* layer) const;
+
+  //! Do nothing for a module which has no state.
+  template<typename T>
+  typename std::enable_if<
+      !HasCarryStateCheck<T, void(T::*)(const size_t)>::value &&
+      !HasResetCellCheck<T, void(T::*)(const size_t)>::value, void>::type
+  CarryState(T* layer) const;
+};
+
+} // namespace ann
+} // namespace mlpack
+
+// Include implementation.
+#include "carry_state_visitor_impl.hpp"
+
+#endif
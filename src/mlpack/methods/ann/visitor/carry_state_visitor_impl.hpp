@@ -0,0 +1,65 @@
+/**
+ * @file carry_state_visitor_impl.hpp
+ *
+ * Implementation of the CarryState() function layer abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_CARRY_STATE_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_CARRY_STATE_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "carry_state_visitor.hpp"
+
+namespace mlpack {
+namespace ann {
+
+//! CarryStateVisitor visitor class.
+inline CarryStateVisitor::CarryStateVisitor(const size_t step,
+                                            const size_t size) :
+    step(step),
+    size(size)
+{
+  /* Nothing to do here. */
+}
+
+//! CarryStateVisitor visitor class.
+template<typename LayerType>
+inline void CarryStateVisitor::operator()(LayerType* layer) const
+{
+  CarryState(layer);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    HasCarryStateCheck<T, void(T::*)(const size_t)>::value, void>::type
+CarryStateVisitor::CarryState(T* layer) const
+{
+  layer->CarryState(step);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasCarryStateCheck<T, void(T::*)(const size_t)>::value &&
+    HasResetCellCheck<T, void(T::*)(const size_t)>::value, void>::type
+CarryStateVisitor::CarryState(T* layer) const
+{
+  layer->ResetCell(size);
+}
+
+template<typename T>
+inline typename std::enable_if<
+    !HasCarryStateCheck<T, void(T::*)(const size_t)>::value &&
+    !HasResetCellCheck<T, void(T::*)(const size_t)>::value, void>::type
+CarryStateVisitor::CarryState(T* /* layer */) const
+{
+  /* Nothing to do here. */
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -22,12 +22,13 @@ namespace ann {
  * This visitor is to support copy constructor for neural network module.
  * We want a layer-wise copy rather than simple duplicate the pointer.
  */
-template <typename... CustomLayers>
-class CopyVisitor : public boost::static_visitor<LayerTypes<CustomLayers...> >
+template <typename MatType, typename... CustomLayers>
+class CopyVisitor :
+    public boost::static_visitor<TypedLayerTypes<MatType, CustomLayers...> >
 {
  public:
   template <typename LayerType>
-  LayerTypes<CustomLayers...> operator()(LayerType*) const;
+  TypedLayerTypes<MatType, CustomLayers...> operator()(LayerType*) const;
 };
 
 } // namespace ann
@@ -18,10 +18,10 @@
 namespace mlpack {
 namespace ann {
 
-template <typename... CustomLayers>
+template <typename MatType, typename... CustomLayers>
 template <typename LayerType>
-inline LayerTypes<CustomLayers...>
-CopyVisitor<CustomLayers...>::operator()(LayerType* layer) const
+inline TypedLayerTypes<MatType, CustomLayers...>
+CopyVisitor<MatType, CustomLayers...>::operator()(LayerType* layer) const
 {
   return new LayerType(*layer);
 }
@@ -25,11 +25,12 @@ namespace ann {
  * ForwardVisitor executes the Forward() function given the input and output
  * parameter.
  */
+template<typename MatType = arma::mat>
 class ForwardVisitor : public boost::static_visitor<void>
 {
  public:
   //! Execute the Foward() function given the input and output parameter.
-  ForwardVisitor(arma::mat&& input, arma::mat&& output);
+  ForwardVisitor(MatType&& input, MatType&& output);
 
   //! Execute the Foward() function.
   template<typename LayerType>
@@ -37,10 +38,10 @@ class ForwardVisitor : public boost::static_visitor<void>
 
  private:
   //! The input parameter set.
-  arma::mat&& input;
+  MatType&& input;
 
   //! The output parameter set.
-  arma::mat&& output;
+  MatType&& output;
 };
 
 } // namespace ann
@@ -19,25 +19,29 @@ namespace mlpack {
 namespace ann {
 
 //! GradientUpdateVisitor visitor class.
-inline GradientUpdateVisitor::GradientUpdateVisitor(arma::mat&& gradient,
-                                                    size_t offset) :
+template<typename MatType>
+inline GradientUpdateVisitor<MatType>::GradientUpdateVisitor(MatType&& gradient,
+                                                             size_t offset) :
     gradient(std::move(gradient)),
     offset(offset)
 {
   /* Nothing to do here. */
 }
 
+template<typename MatType>
 template<typename LayerType>
-inline size_t GradientUpdateVisitor::operator()(LayerType* layer) const
+inline size_t GradientUpdateVisitor<MatType>::operator()(LayerType* layer) const
 {
   return LayerGradients(layer, layer->OutputParameter());
 }
 
+template<typename MatType>
 template<typename T>
 inline typename std::enable_if<
-    HasGradientCheck<T, arma::mat&(T::*)()>::value &&
+    HasGradientCheck<T, MatType&(T::*)()>::value &&
     !HasModelCheck<T>::value, size_t>::type
-GradientUpdateVisitor::LayerGradients(T* layer, arma::mat& /* input */) const
+GradientUpdateVisitor<MatType>::LayerGradients(T* layer,
+                                               MatType& /* input */) const
 {
   if (layer->Parameters().n_elem != 0)
   {
@@ -48,11 +52,13 @@ GradientUpdateVisitor::LayerGradients(T* layer, arma::mat& /* input */) const
   return layer->Parameters().n_elem;
 }
 
+template<typename MatType>
 template<typename T>
 inline typename std::enable_if<
-    !HasGradientCheck<T, arma::mat&(T::*)()>::value &&
+    !HasGradientCheck<T, MatType&(T::*)()>::value &&
     HasModelCheck<T>::value, size_t>::type
-GradientUpdateVisitor::LayerGradients(T* layer, arma::mat& /* input */) const
+GradientUpdateVisitor<MatType>::LayerGradients(T* layer,
+                                               MatType& /* input */) const
 {
   size_t modelOffset = 0;
   for (size_t i = 0; i < layer->Model().size(); ++i)
@@ -64,11 +70,13 @@ GradientUpdateVisitor::LayerGradients(T* layer, arma::mat& /* input */) const
   return modelOffset;
 }
 
+template<typename MatType>
 template<typename T>
 inline typename std::enable_if<
-    HasGradientCheck<T, arma::mat&(T::*)()>::value &&
+    HasGradientCheck<T, MatType&(T::*)()>::value &&
     HasModelCheck<T>::value, size_t>::type
-GradientUpdateVisitor::LayerGradients(T* layer, arma::mat& /* input */) const
+GradientUpdateVisitor<MatType>::LayerGradients(T* layer,
+                                               MatType& /* input */) const
 {
   if (layer->Parameters().n_elem != 0)
   {
@@ -86,11 +94,13 @@ GradientUpdateVisitor::LayerGradients(T* layer, arma::mat& /* input */) const
   return modelOffset;
 }
 
+template<typename MatType>
 template<typename T, typename P>
 inline typename std::enable_if<
     !HasGradientCheck<T, P&(T::*)()>::value &&
     !HasModelCheck<T>::value, size_t>::type
-GradientUpdateVisitor::LayerGradients(T* /* layer */, P& /* input */) const
+GradientUpdateVisitor<MatType>::LayerGradients(T* /* layer */,
+                                               P& /* input */) const
 {
   return 0;
 }
@@ -25,15 +25,16 @@ namespace ann {
  * SearchModeVisitor executes the Gradient() method of the given module using
  * the input and delta parameter.
  */
+template<typename MatType = arma::mat>
 class GradientVisitor : public boost::static_visitor<void>
 {
  public:
   //! Executes the Gradient() method of the given module using the input and
   //! delta parameter.
-  GradientVisitor(arma::mat&& input, arma::mat&& delta);
+  GradientVisitor(MatType&& input, MatType&& delta);
 
   //! Executes the Gradient() method for the layer with the specified index.
-  GradientVisitor(arma::mat&& input, arma::mat&& delta, const size_t index);
+  GradientVisitor(MatType&& input, MatType&& delta, const size_t index);
 
   //! Executes the Gradient() method.
   template<typename LayerType>
@@ -41,10 +42,10 @@ class GradientVisitor : public boost::static_visitor<void>
 
  private:
   //! The input set.
-  arma::mat&& input;
+  MatType&& input;
 
   //! The delta parameter.
-  arma::mat&& delta;
+  MatType&& delta;
 
   //! Index of the layer to run.
   size_t index;
@@ -56,17 +57,17 @@ class GradientVisitor : public boost::static_visitor<void>
   //! function.
   template<typename T>
   typename std::enable_if<
-      HasGradientCheck<T, arma::mat&(T::*)()>::value &&
+      HasGradientCheck<T, MatType&(T::*)()>::value &&
       !HasRunCheck<T, bool&(T::*)(void)>::value, void>::type
-  LayerGradients(T* layer, arma::mat& input) const;
+  LayerGradients(T* layer, MatType& input) const;
 
   //! Execute the Gradient() function if the module implements the Gradient()
   //! and has a Run() function.
   template<typename T>
   typename std::enable_if<
-      HasGradientCheck<T, arma::mat&(T::*)()>::value &&
+      HasGradientCheck<T, MatType&(T::*)()>::value &&
       HasRunCheck<T, bool&(T::*)(void)>::value, void>::type
-  LayerGradients(T* layer, arma::mat& input) const;
+  LayerGradients(T* layer, MatType& input) const;
 
   //! Do not execute the Gradient() function if the module doesn't implement
   //! the Gradient() function.
@@ -19,7 +19,9 @@ namespace mlpack {
 namespace ann {
 
 //! GradientVisitor visitor class.
-inline GradientVisitor::GradientVisitor(arma::mat&& input, arma::mat&& delta) :
+template<typename MatType>
+inline GradientVisitor<MatType>::GradientVisitor(MatType&& input,
+                                                 MatType&& delta) :
     input(std::move(input)),
     delta(std::move(delta)),
     index(0),
@@ -28,8 +30,10 @@ inline GradientVisitor::GradientVisitor(arma::mat&& input, arma::mat&& delta) :
   /* Nothing to do here. */
 }
 
-inline GradientVisitor::GradientVisitor(arma::mat&& input, arma::mat&& delta,
-                                        const size_t index) :
+template<typename MatType>
+inline GradientVisitor<MatType>::GradientVisitor(MatType&& input,
+                                                 MatType&& delta,
+                                                 const size_t index) :
     input(std::move(input)),
     delta(std::move(delta)),
     index(index),
@@ -38,27 +42,30 @@ inline GradientVisitor::GradientVisitor(arma::mat&& input, arma::mat&& delta,
   /* Nothing to do here. */
 }
 
+template<typename MatType>
 template<typename LayerType>
-inline void GradientVisitor::operator()(LayerType* layer) const
+inline void GradientVisitor<MatType>::operator()(LayerType* layer) const
 {
   LayerGradients(layer, layer->OutputParameter());
 }
 
+template<typename MatType>
 template<typename T>
 inline typename std::enable_if<
-    HasGradientCheck<T, arma::mat&(T::*)()>::value &&
+    HasGradientCheck<T, MatType&(T::*)()>::value &&
     !HasRunCheck<T, bool&(T::*)(void)>::value, void>::type
-GradientVisitor::LayerGradients(T* layer, arma::mat& /* input */) const
+GradientVisitor<MatType>::LayerGradients(T* layer, MatType& /* input */) const
 {
   layer->Gradient(std::move(input), std::move(delta),
       std::move(layer->Gradient()));
 }
 
+template<typename MatType>
 template<typename T>
 inline typename std::enable_if<
-    HasGradientCheck<T, arma::mat&(T::*)()>::value &&
+    HasGradientCheck<T, MatType&(T::*)()>::value &&
     HasRunCheck<T, bool&(T::*)(void)>::value, void>::type
-GradientVisitor::LayerGradients(T* layer, arma::mat& /* input */) const
+GradientVisitor<MatType>::LayerGradients(T* layer, MatType& /* input */) const
 {
   if (!hasIndex)
   {
@@ -72,10 +79,11 @@ GradientVisitor::LayerGradients(T* layer, arma::mat& /* input */) const
   }
 }
 
+template<typename MatType>
 template<typename T, typename P>
 inline typename std::enable_if<
     !HasGradientCheck<T, P&(T::*)()>::value, void>::type
-GradientVisitor::LayerGradients(T* /* layer */, P& /* input */) const
+GradientVisitor<MatType>::LayerGradients(T* /* layer */, P& /* input */) const
 {
   /* Nothing to do here. */
 }
@@ -0,0 +1,41 @@
+/**
+ * @file layer_name_visitor_impl.hpp
+ *
+ * Implementation of the layer name abstraction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_VISITOR_LAYER_NAME_VISITOR_IMPL_HPP
+#define MLPACK_METHODS_ANN_VISITOR_LAYER_NAME_VISITOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "layer_name_visitor.hpp"
+
+#include <boost/core/demangle.hpp>
+#include <typeinfo>
+
+namespace mlpack {
+namespace ann {
+
+//! LayerNameVisitor visitor class.
+template<typename LayerType>
+inline std::string LayerNameVisitor::operator()(LayerType* /* layer */) const
+{
+  std::string name = boost::core::demangle(typeid(LayerType).name());
+
+  // Strip the template parameters, and then the namespaces.
+  name = name.substr(0, name.find('<'));
+  const size_t separator = name.rfind(':');
+  if (separator != std::string::npos)
+    name = name.substr(separator + 1);
+
+  return name;
+}
+
+} // namespace ann
+} // namespace mlpack
+
+#endif
@@ -25,11 +25,12 @@ namespace ann {
  * LoadOutputParameterVisitor restores the output parameter using the given
  * parameter set.
  */
+template<typename MatType = arma::mat>
 class LoadOutputParameterVisitor : public boost::static_visitor<void>
 {
  public:
   //! Restore the output parameter given a parameter set.
-  LoadOutputParameterVisitor(std::vector<arma::mat>&& parameter);
+  LoadOutputParameterVisitor(std::vector<MatType>&& parameter);
 
   //! Restore the output parameter.
   template<typename LayerType>
@@ -37,7 +38,7 @@ class LoadOutputParameterVisitor : public boost::static_visitor<void>
 
  private:
   //! The parameter set.
-  std::vector<arma::mat>&& parameter;
+  std::vector<MatType>&& parameter;
 
   //! Restore the output parameter for a module which doesn't implement the
   //! Model() function.
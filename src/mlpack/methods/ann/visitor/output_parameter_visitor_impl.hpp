@@ -19,8 +19,10 @@ namespace mlpack {
 namespace ann {
 
 //! OutputParameterVisitor visitor class.
+template<typename MatType>
 template<typename LayerType>
-inline arma::mat& OutputParameterVisitor::operator()(LayerType *layer) const
+inline MatType& OutputParameterVisitor<MatType>::operator()(
+    LayerType *layer) const
 {
   return layer->OutputParameter();
 }
@@ -23,11 +23,12 @@ namespace ann {
 /**
  * WeightSetVisitor update the module parameters given the parameters set.
  */
+template<typename MatType = arma::mat>
 class WeightSetVisitor : public boost::static_visitor<size_t>
 {
  public:
   //! Update the parameters given the parameters set and offset.
-  WeightSetVisitor(arma::mat&& weight, const size_t offset = 0);
+  WeightSetVisitor(MatType&& weight, const size_t offset = 0);
 
   //! Update the parameters set.
   template<typename LayerType>
@@ -35,7 +36,7 @@ class WeightSetVisitor : public boost::static_visitor<size_t>
 
  private:
   //! The parameters set.
-  arma::mat&& weight;
+  MatType&& weight;
 
   //! The parameters offset.
   const size_t offset;
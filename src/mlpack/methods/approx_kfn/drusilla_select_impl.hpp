@@ -83,15 +83,19 @@ void DrusillaSelect<MatType>::Train(
 
   arma::vec dataMean(arma::mean(referenceSet, 1));
   arma::vec norms(referenceSet.n_cols);
+  arma::vec sqNorms(referenceSet.n_cols);
 
   MatType refCopy(referenceSet.n_rows, referenceSet.n_cols);
   for (size_t i = 0; i < refCopy.n_cols; ++i)
   {
     refCopy.col(i) = referenceSet.col(i) - dataMean;
-    norms[i] = arma::norm(refCopy.col(i));
+    sqNorms[i] = arma::dot(refCopy.col(i), refCopy.col(i));
+    norms[i] = std::sqrt(sqNorms[i]);
   }
 
-  // Find the top m points for each of the l projections...
+  // Find the top m points for each of the l projections...  Each table depends
+  // on the points chosen by the previous ones, so only the work inside a table
+  // can be done in parallel.
   for (size_t i = 0; i < l; ++i)
   {
     // Pick best index.
@@ -100,15 +104,21 @@ void DrusillaSelect<MatType>::Train(
 
     arma::vec line(refCopy.col(maxIndex) / arma::norm(refCopy.col(maxIndex)));
 
+    // Project every point onto the line at once.  The distortion of a point
+    // (its distance to the line) then follows from its norm and its offset.
+    const arma::vec offsets = refCopy.t() * line;
+
     // Calculate distortion and offset and make scores.
-    std::vector<bool> closeAngle(referenceSet.n_cols, false);
+    std::vector<char> closeAngle(referenceSet.n_cols, false);
     arma::vec sums(referenceSet.n_cols);
-    for (size_t j = 0; j < referenceSet.n_cols; ++j)
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) referenceSet.n_cols; ++j)
     {
       if (norms[j] > 0.0)
       {
-        const double offset = arma::dot(refCopy.col(j), line);
-        const double distortion = arma::norm(refCopy.col(j) - offset * line);
+        const double offset = offsets[j];
+        const double distortion = std::sqrt(std::max(sqNorms[j] -
+            offset * offset, 0.0));
         sums[j] = std::abs(offset) - std::abs(distortion);
         closeAngle[j] =
             (std::atan(distortion / std::abs(offset)) < (M_PI / 8.0));
@@ -180,18 +190,36 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
         "greater than number of points in candidate set!  Increase l or m.");
 
   // We'll use the NeighborSearchRules class to perform our brute-force search.
-  // Note that we aren't using trees for our search, so we can use 'int' as a
-  // TreeType.
-  metric::EuclideanDistance metric;
-  NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
+  // Note that we aren't using trees for our search, so the TreeType is only
+  // used for its typedefs.  The query points are split into blocks, each with
+  // its own rules, and the base cases of a block against the whole candidate
+  // set are computed at once (with a matrix multiplication for dense data).
+  typedef NeighborSearchRules<FurthestNeighborSort, metric::EuclideanDistance,
       tree::KDTree<metric::EuclideanDistance, tree::EmptyStatistic, MatType>>
-      rules(candidateSet, querySet, k, metric, 0, false);
+      RuleType;
+
+  const size_t blockSize = 256;
+  const size_t numBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t count = std::min(blockSize, querySet.n_cols - begin);
+
+    metric::EuclideanDistance metric;
+    RuleType rules(candidateSet, querySet, begin, count, k, metric, 0, false);
 
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
+    std::vector<size_t> queryIndices(count);
+    for (size_t q = 0; q < count; ++q)
+      queryIndices[q] = begin + q;
+    rules.BatchBaseCases(queryIndices, 0, candidateSet.n_cols);
 
-  rules.GetResults(neighbors, distances);
+    // Each set of rules only fills the columns of its own query points.
+    rules.GetResults(neighbors, distances);
+  }
 
   // Map the neighbors back to their original indices in the reference set.
   for (size_t i = 0; i < neighbors.n_elem; ++i)
@@ -30,7 +30,23 @@
 namespace mlpack {
 namespace neighbor {
 
-template<typename MatType = arma::mat>
+/**
+ * The QDAFN class performs query-dependent approximate furthest neighbor
+ * search.  Training projects the reference set onto l random lines and keeps
+ * the m points with the largest projection on each line; these are the
+ * candidate sets that are searched.  The candidate sets of the tables are built
+ * in parallel, and a search projects all of the query points onto the lines
+ * with a single matrix multiplication, then handles the query points in
+ * parallel.
+ *
+ * @tparam MatType Type of the reference and query sets.
+ * @tparam CandidateMatType Type used to store the candidate sets.  This may
+ *     hold a smaller element type than MatType (for instance arma::fmat), which
+ *     halves the memory taken by the candidate sets; distances are then
+ *     computed in that element type.
+ */
+template<typename MatType = arma::mat,
+         typename CandidateMatType = MatType>
 class QDAFN
 {
  public:
@@ -87,11 +103,32 @@ class QDAFN
   size_t NumProjections() const { return candidateSet.size(); }
 
   //! Get the candidate set for the given projection table.
-  const MatType& CandidateSet(const size_t t) const { return candidateSet[t]; }
+  const CandidateMatType& CandidateSet(const size_t t) const
+  {
+    return candidateSet[t];
+  }
   //! Modify the candidate set for the given projection table.  Careful!
-  MatType& CandidateSet(const size_t t) { return candidateSet[t]; }
+  CandidateMatType& CandidateSet(const size_t t) { return candidateSet[t]; }
 
  private:
+  /**
+   * Store the columns of the given matrix with the given indices in the given
+   * candidate matrix, converting the elements to the candidate element type.
+   */
+  template<typename InMatType, typename OutMatType>
+  static void CopyColumns(const InMatType& in,
+                          const arma::uvec& indices,
+                          OutMatType& out);
+
+  /**
+   * Store the columns of the given matrix with the given indices in the given
+   * matrix of the same type.  This also works for sparse matrices.
+   */
+  template<typename SameMatType>
+  static void CopyColumns(const SameMatType& in,
+                          const arma::uvec& indices,
+                          SameMatType& out);
+
   //! The number of projections.
   size_t l;
   //! The number of elements to store for each projection.
@@ -107,7 +144,7 @@ class QDAFN
   arma::mat sValues;
 
   // Candidate sets; one element in the vector for each table.
-  std::vector<MatType> candidateSet;
+  std::vector<CandidateMatType> candidateSet;
 };
 
 } // namespace neighbor
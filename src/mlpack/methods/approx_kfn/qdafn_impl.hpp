@@ -22,8 +22,10 @@ namespace mlpack {
 namespace neighbor {
 
 // Non-training constructor.
-template<typename MatType>
-QDAFN<MatType>::QDAFN(const size_t l, const size_t m) : l(l), m(m)
+template<typename MatType, typename CandidateMatType>
+QDAFN<MatType, CandidateMatType>::QDAFN(const size_t l, const size_t m) :
+    l(l),
+    m(m)
 {
   if (l == 0)
     throw std::invalid_argument("QDAFN::QDAFN(): l must be greater than 0!");
@@ -32,10 +34,10 @@ QDAFN<MatType>::QDAFN(const size_t l, const size_t m) : l(l), m(m)
 }
 
 // Constructor.
-template<typename MatType>
-QDAFN<MatType>::QDAFN(const MatType& referenceSet,
-                      const size_t l,
-                      const size_t m) :
+template<typename MatType, typename CandidateMatType>
+QDAFN<MatType, CandidateMatType>::QDAFN(const MatType& referenceSet,
+                                        const size_t l,
+                                        const size_t m) :
     l(l),
     m(m)
 {
@@ -48,16 +50,24 @@ QDAFN<MatType>::QDAFN(const MatType& referenceSet,
 }
 
 // Train the object.
-template<typename MatType>
-void QDAFN<MatType>::Train(const MatType& referenceSet,
-                           const size_t lIn,
-                           const size_t mIn)
+template<typename MatType, typename CandidateMatType>
+void QDAFN<MatType, CandidateMatType>::Train(const MatType& referenceSet,
+                                             const size_t lIn,
+                                             const size_t mIn)
 {
   if (lIn != 0)
     l = lIn;
   if (mIn != 0)
     m = mIn;
 
+  if (m > referenceSet.n_cols)
+  {
+    std::stringstream ss;
+    ss << "QDAFN::Train(): m (" << m << ") must not be greater than the "
+        << "number of reference points (" << referenceSet.n_cols << ")!";
+    throw std::invalid_argument(ss.str());
+  }
+
   // Build tables.  This is done by drawing random points from a Gaussian
   // distribution as the vectors we project onto.  The Gaussian should have zero
   // mean and unit variance.
@@ -70,31 +80,48 @@ void QDAFN<MatType>::Train(const MatType& referenceSet,
   // top m elements.
   projections = referenceSet.t() * lines;
 
-  // Loop over each projection and find the top m elements.
+  // Loop over each projection and find the top m elements.  Only those need to
+  // be sorted, so a partial selection is done first.  Each table is
+  // independent.
   sIndices.set_size(m, l);
   sValues.set_size(m, l);
   candidateSet.resize(l);
-  for (size_t i = 0; i < l; ++i)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) l; ++i)
   {
-    candidateSet[i].set_size(referenceSet.n_rows, m);
-    arma::uvec sortedIndices = arma::sort_index(projections.col(i), "descend");
+    const arma::vec projection(projections.col(i));
+    auto greater = [&projection](const size_t a, const size_t b)
+    {
+      return (projection[a] > projection[b]) ||
+          (projection[a] == projection[b] && a < b);
+    };
+
+    std::vector<size_t> order(projection.n_elem);
+    for (size_t j = 0; j < order.size(); ++j)
+      order[j] = j;
+    std::nth_element(order.begin(), order.begin() + (m - 1), order.end(),
+        greater);
+    std::sort(order.begin(), order.begin() + m, greater);
 
     // Grab the top m elements.
+    arma::uvec topIndices(m);
     for (size_t j = 0; j < m; ++j)
     {
-      sIndices(j, i) = sortedIndices[j];
-      sValues(j, i) = projections(sortedIndices[j], i);
-      candidateSet[i].col(j) = referenceSet.col(sortedIndices[j]);
+      topIndices[j] = order[j];
+      sIndices(j, i) = order[j];
+      sValues(j, i) = projection[order[j]];
     }
+
+    CopyColumns(referenceSet, topIndices, candidateSet[i]);
   }
 }
 
 // Search.
-template<typename MatType>
-void QDAFN<MatType>::Search(const MatType& querySet,
-                            const size_t k,
-                            arma::Mat<size_t>& neighbors,
-                            arma::mat& distances)
+template<typename MatType, typename CandidateMatType>
+void QDAFN<MatType, CandidateMatType>::Search(const MatType& querySet,
+                                              const size_t k,
+                                              arma::Mat<size_t>& neighbors,
+                                              arma::mat& distances)
 {
   if (k > m)
     throw std::invalid_argument("QDAFN::Search(): requested k is greater than "
@@ -104,17 +131,25 @@ void QDAFN<MatType>::Search(const MatType& querySet,
   neighbors.fill(size_t() - 1);
   distances.zeros(k, querySet.n_cols);
 
+  // Project all of the query points onto all of the lines at once.
+  const arma::mat queryProjections = lines.t() * querySet;
+
   // Search for each point.
-  for (size_t q = 0; q < querySet.n_cols; ++q)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
   {
+    // The query point, stored like the candidates for the distance
+    // computations.
+    CandidateMatType query;
+    CopyColumns(querySet, arma::uvec({ (arma::uword) q }), query);
+
     // Initialize a priority queue.
     // The size_t represents the index of the table, and the double represents
     // the value of l_i * S_i - l_i * query (see line 6 of Algorithm 1).
     std::priority_queue<std::pair<double, size_t>> queue;
     for (size_t i = 0; i < l; ++i)
     {
-      const double val = sValues(0, i) - arma::dot(querySet.col(q),
-          lines.col(i));
+      const double val = sValues(0, i) - queryProjections(i, q);
       queue.push(std::make_pair(val, i));
     }
 
@@ -129,7 +164,7 @@ void QDAFN<MatType>::Search(const MatType& querySet,
         resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
     for (size_t i = 0; i < m; ++i)
     {
-      std::pair<size_t, double> p = queue.top();
+      std::pair<double, size_t> p = queue.top();
       queue.pop();
 
       // Get index of reference point to look at.
@@ -137,7 +172,7 @@ void QDAFN<MatType>::Search(const MatType& querySet,
 
       // Calculate distance from query point.
       const double dist = mlpack::metric::EuclideanDistance::Evaluate(
-          querySet.col(q), candidateSet[p.second].col(tableIndex));
+          query.col(0), candidateSet[p.second].col(tableIndex));
 
       // Is this neighbor good enough to insert into the results?
       if (dist > resultsQueue.top().first)
@@ -169,9 +204,11 @@ void QDAFN<MatType>::Search(const MatType& querySet,
   }
 }
 
-template<typename MatType>
+template<typename MatType, typename CandidateMatType>
 template<typename Archive>
-void QDAFN<MatType>::serialize(Archive& ar, const unsigned int /* version */)
+void QDAFN<MatType, CandidateMatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
 {
   ar & BOOST_SERIALIZATION_NVP(l);
   ar & BOOST_SERIALIZATION_NVP(m);
@@ -184,6 +221,28 @@ void QDAFN<MatType>::serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(candidateSet);
 }
 
+template<typename MatType, typename CandidateMatType>
+template<typename InMatType, typename OutMatType>
+void QDAFN<MatType, CandidateMatType>::CopyColumns(
+    const InMatType& in,
+    const arma::uvec& indices,
+    OutMatType& out)
+{
+  out = arma::conv_to<OutMatType>::from(in.cols(indices));
+}
+
+template<typename MatType, typename CandidateMatType>
+template<typename SameMatType>
+void QDAFN<MatType, CandidateMatType>::CopyColumns(
+    const SameMatType& in,
+    const arma::uvec& indices,
+    SameMatType& out)
+{
+  out.set_size(in.n_rows, indices.n_elem);
+  for (size_t j = 0; j < indices.n_elem; ++j)
+    out.col(j) = in.col(indices[j]);
+}
+
 } // namespace neighbor
 } // namespace mlpack
 
@@ -15,6 +15,8 @@
 
 #include "bias_svd_function.hpp"
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/util/threads.hpp>
+#include <mlpack/methods/regularized_svd/rating_strata.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -278,6 +280,11 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
   // Rank of decomposition.
   const size_t rank = function.Rank();
 
+  // Split the ratings into one block of users and one block of items for each
+  // thread.
+  mlpack::svd::RatingStrata strata(data, numUsers, function.NumItems(),
+      mlpack::NumThreads());
+
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
   // till convergence.
@@ -319,55 +326,50 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
       std::shuffle(visitationOrder.begin(), visitationOrder.end(),
           mlpack::math::randGen);
 
-    #pragma omp parallel
+    // Each thread gets a share of threadShareSize ratings.
+    strata.Assign(visitationOrder, (threadShareSize >
+        visitationOrder.n_elem / strata.NumBlocks()) ? visitationOrder.n_elem :
+        threadShareSize * strata.NumBlocks());
+
+    // The strata processed by the threads in the same sub-epoch share no users
+    // and no items, so the updates need no synchronization.
+    for (size_t s = 0; s < strata.NumBlocks(); ++s)
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) strata.NumBlocks(); ++b)
       {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        double ratingError = rating - userBias - itemBias -
-            arma::dot(iterate.col(user).subvec(0, rank - 1),
-                      iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * iterate.col(user).subvec(0, rank - 1));
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < rank; ++i)
+        const size_t c = strata.ItemBlock(b, s);
+        for (size_t k = strata.Begin(b, c); k < strata.End(b, c); ++k)
         {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
+          const size_t j = strata.Ratings()[k];
+
+          // Indices for accessing the the correct parameter columns.
+          const size_t user = data(0, j);
+          const size_t item = data(1, j) + numUsers;
+
+          // Prediction error for the example.
+          const double rating = data(2, j);
+          const double userBias = iterate(rank, user);
+          const double itemBias = iterate(rank, item);
+          double ratingError = rating - userBias - itemBias -
+              arma::dot(iterate.col(user).subvec(0, rank - 1),
+                        iterate.col(item).subvec(0, rank - 1));
+
+          arma::vec userVecUpdate = stepSize * 2 * (
+              lambda * iterate.col(user).subvec(0, rank - 1) -
+              ratingError * iterate.col(item).subvec(0, rank - 1));
+
+          // Gradient is non-zero only for the parameter columns corresponding
+          // to the example.
+          iterate.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
+              lambda * iterate.col(item).subvec(0, rank - 1) -
+              ratingError * iterate.col(user).subvec(0, rank - 1));
+          iterate.col(user).subvec(0, rank - 1) -= userVecUpdate;
+          iterate(rank, user) -= stepSize * 2 * (lambda * userBias -
+              ratingError);
+          iterate(rank, item) -= stepSize * 2 * (lambda * itemBias -
+              ratingError);
         }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
       }
     }
   }
@@ -48,6 +48,25 @@ void RandomizedBlockKrylovSVD::Apply(const arma::mat& data,
                                      arma::vec& s,
                                      arma::mat& v,
                                      const size_t rank)
+{
+  ApplyImpl(data, u, s, v, rank);
+}
+
+void RandomizedBlockKrylovSVD::Apply(const arma::sp_mat& data,
+                                     arma::mat& u,
+                                     arma::vec& s,
+                                     arma::mat& v,
+                                     const size_t rank)
+{
+  ApplyImpl(data, u, s, v, rank);
+}
+
+template<typename MatType>
+void RandomizedBlockKrylovSVD::ApplyImpl(const MatType& data,
+                                         arma::mat& u,
+                                         arma::vec& s,
+                                         arma::mat& v,
+                                         const size_t rank)
 {
   arma::mat Q, R, block, blockIteration;
 
@@ -74,7 +93,9 @@ void RandomizedBlockKrylovSVD::Apply(const arma::mat& data,
     blockIteration = arma::mat(K.memptr() + blockOffset, block.n_rows,
         block.n_cols, false, false);
 
-    arma::qr_econ(blockIteration, R, data * (data.t() * block));
+    // The product with the transpose is formed as a dense times data product,
+    // so that a sparse data matrix is never transposed.
+    arma::qr_econ(blockIteration, R, data * (block.t() * data).t());
 
     // Update working matrix for the next iteration.
     block = arma::mat(K.memptr() + blockOffset, block.n_rows, block.n_cols,
@@ -104,6 +104,25 @@ class RandomizedBlockKrylovSVD
              arma::mat& v,
              const size_t rank);
 
+  /**
+   * Apply Principal Component Analysis to the provided sparse data set using
+   * the randomized block krylov SVD.  The data is only used in products with
+   * dense matrices of blockSize columns, so it is never densified, and each
+   * iteration takes O(nnz * blockSize) time.  Like the dense version, the data
+   * is not centered.
+   *
+   * @param data Sparse data matrix.
+   * @param u First unitary matrix.
+   * @param v Second unitary matrix.
+   * @param s Diagonal matrix of singular values.
+   * @param rank Rank of the approximation.
+   */
+  void Apply(const arma::sp_mat& data,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v,
+             const size_t rank);
+
   //! Get the number of iterations for the power method.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the number of iterations for the power method.
@@ -115,6 +134,22 @@ class RandomizedBlockKrylovSVD
   size_t& BlockSize() { return blockSize; }
 
  private:
+  /**
+   * Compute the randomized block krylov SVD of the given dense or sparse data.
+   *
+   * @param data Data matrix.
+   * @param u First unitary matrix.
+   * @param v Second unitary matrix.
+   * @param s Diagonal matrix of singular values.
+   * @param rank Rank of the approximation.
+   */
+  template<typename MatType>
+  void ApplyImpl(const MatType& data,
+                 arma::mat& u,
+                 arma::vec& s,
+                 arma::mat& v,
+                 const size_t rank);
+
   //! Locally stored number of iterations for the power method.
   size_t maxIterations;
 
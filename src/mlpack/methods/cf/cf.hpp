@@ -143,6 +143,31 @@ class CFType
              const double minResidue = 1e-5,
              const bool mit = false);
 
+  /**
+   * Fold new users into the trained model, without retraining it.  The new
+   * users are given the next user IDs, and their vectors are fitted to their
+   * ratings with the item vectors held fixed; the ratings are normalized like
+   * the training data.  The new users take part in the neighbor searches of
+   * later queries.  The DecompositionPolicy must provide FoldInUsers().
+   *
+   * @param ratings Ratings of the new users, with one row for each item and
+   *     one column for each new user.
+   * @param lambda Regularization parameter of the fit.
+   */
+  void FoldInUsers(const arma::sp_mat& ratings, const double lambda = 0.1);
+
+  /**
+   * Fold new items into the trained model, without retraining it.  The new
+   * items are given the next item IDs, and their vectors are fitted to their
+   * ratings with the user vectors held fixed; the ratings are normalized like
+   * the training data.  The DecompositionPolicy must provide FoldInItems().
+   *
+   * @param ratings Ratings of the new items, with one row for each new item and
+   *     one column for each user.
+   * @param lambda Regularization parameter of the fit.
+   */
+  void FoldInItems(const arma::sp_mat& ratings, const double lambda = 0.1);
+
   //! Sets number of users for calculating similarity.
   void NumUsersForSimilarity(const size_t num)
   {
@@ -201,6 +226,12 @@ class CFType
   /**
    * Generates the given number of recommendations for the specified users.
    *
+   * The ratings are computed for blocks of users at once with the
+   * GetRatingOfUsers() method of the decomposition policy, and the best unrated
+   * items of the users in each block are then selected in parallel with
+   * OpenMP.  If there are not enough unrated items for a user, the remaining
+   * recommendations are set to the number of items, which is not a valid item.
+   *
    * @tparam NeighborSearchPolicy The policy used to search neighbors of
    *     query set in referece set.
    * @tparam InterpolationPolicy The policy used to calculate interpolation
@@ -216,6 +247,36 @@ class CFType
                           arma::Mat<size_t>& recommendations,
                           const arma::Col<size_t>& users);
 
+  /**
+   * Generates the given number of recommendations for the specified users with
+   * an index over the item vectors, instead of the ratings of every item.  The
+   * index must be built on the item vectors given by the GetItemVectors()
+   * method of the decomposition policy, and it is queried with the
+   * interpolated user vectors given by GetUserVectors(); for example,
+   * MaxInnerProductSearch retrieves the items with the highest inner products
+   * in sublinear time.  The items are ranked by the ratings of the
+   * decomposition, so normalizations that add a value depending on the item
+   * (such as ItemMeanNormalization) are not taken into account.
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors of
+   *     query set in referece set.
+   * @tparam InterpolationPolicy The policy used to calculate interpolation
+   *     weights.
+   * @tparam ItemSearchPolicy The type of the index over the item vectors.
+   *
+   * @param numRecs Number of Recommendations.
+   * @param recommendations Matrix to save recommendations.
+   * @param users Users for which recommendations are to be generated.
+   * @param itemSearch Index over the item vectors.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch,
+           typename InterpolationPolicy = AverageInterpolation,
+           typename ItemSearchPolicy>
+  void GetRecommendations(const size_t numRecs,
+                          arma::Mat<size_t>& recommendations,
+                          const arma::Col<size_t>& users,
+                          ItemSearchPolicy& itemSearch);
+
   //! Converts the User, Item, Value Matrix to User-Item Table.
   static void CleanData(const arma::mat& data, arma::sp_mat& cleanedData);
 
@@ -274,6 +335,20 @@ class CFType
   //! Data normalization object.
   NormalizationType normalization;
 
+  /**
+   * Find the neighborhood of the given users, and calculate the interpolation
+   * weights of each neighbor.
+   *
+   * @param users Users whose neighborhood is to be computed.
+   * @param neighborhood Neighbors of each user.
+   * @param weights Interpolation weights of the neighbors of each user.
+   */
+  template<typename NeighborSearchPolicy,
+           typename InterpolationPolicy>
+  void GetNeighborWeights(const arma::Col<size_t>& users,
+                          arma::Mat<size_t>& neighborhood,
+                          arma::mat& weights) const;
+
   //! Candidate represents a possible recommendation (value, item).
   typedef std::pair<double, size_t> Candidate;
 
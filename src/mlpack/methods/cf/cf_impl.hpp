@@ -154,6 +154,66 @@ Train(const arma::sp_mat& data,
   Timer::Stop("cf_factorization");
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldInUsers(const arma::sp_mat& ratings, const double lambda)
+{
+  if (ratings.n_rows != cleanedData.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldInUsers(): ratings have " << ratings.n_rows
+        << " items, but the model has " << cleanedData.n_rows << " items!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (ratings.n_cols == 0)
+    return;
+
+  arma::sp_mat normalizedRatings(ratings);
+  normalization.NormalizeUsers(normalizedRatings);
+
+  Timer::Start("cf_fold_in");
+  decomposition.FoldInUsers(normalizedRatings, lambda);
+  Timer::Stop("cf_fold_in");
+
+  // Add the new users to the rating table.
+  const size_t numUsers = cleanedData.n_cols;
+  cleanedData.resize(cleanedData.n_rows, numUsers + ratings.n_cols);
+  cleanedData.cols(numUsers, cleanedData.n_cols - 1) = normalizedRatings;
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FoldInItems(const arma::sp_mat& ratings, const double lambda)
+{
+  if (ratings.n_cols != cleanedData.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "CFType::FoldInItems(): ratings have " << ratings.n_cols
+        << " users, but the model has " << cleanedData.n_cols << " users!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (ratings.n_rows == 0)
+    return;
+
+  arma::sp_mat normalizedRatings(ratings);
+  normalization.NormalizeItems(normalizedRatings);
+
+  Timer::Start("cf_fold_in");
+  decomposition.FoldInItems(normalizedRatings, lambda);
+  Timer::Stop("cf_fold_in");
+
+  // Add the new items to the rating table.
+  const size_t numItems = cleanedData.n_rows;
+  cleanedData.resize(numItems + ratings.n_rows, cleanedData.n_cols);
+  cleanedData.rows(numItems, cleanedData.n_rows - 1) = normalizedRatings;
+}
+
 template<typename DecompositionPolicy,
          typename NormalizationType>
 template<typename NeighborSearchPolicy,
@@ -185,88 +245,194 @@ GetRecommendations(const size_t numRecs,
                    arma::Mat<size_t>& recommendations,
                    const arma::Col<size_t>& users)
 {
-  // Temporary storage for neighborhood of the queried users.
+  // Calculate the neighborhood of the queried users and the interpolation
+  // weights of the neighbors.
   arma::Mat<size_t> neighborhood;
-  // Resulting similarities.
-  arma::mat similarities;
-
-  // Calculate the neighborhood of the queried users.  Note that the query user
-  // is part of the neighborhood---this is intentional.  We want to use the
-  // weighted sum of both the query user and the local neighborhood of the
-  // query user.
-  // Calculate the neighborhood of the queried users.
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
+  arma::mat weights;
+  GetNeighborWeights<NeighborSearchPolicy, InterpolationPolicy>(users,
+      neighborhood, weights);
 
   // Generate recommendations for each query user by finding the maximum numRecs
-  // elements in the ratings vector.
+  // elements in the ratings vector.  Items that can't be recommended are given
+  // the invalid item number.
+  const size_t numItems = cleanedData.n_rows;
   recommendations.set_size(numRecs, users.n_elem);
-  arma::mat values(numRecs, users.n_elem);
-  recommendations.fill(SIZE_MAX);
-  values.fill(DBL_MAX);
+  recommendations.fill(numItems);
+  std::vector<char> incomplete(users.n_elem, 0);
 
-  // Initialization of an InterpolationPolicy object should be put ahead of the
-  // following loop, because the initialization may takes a relatively long
-  // time and we don't want to repeat the initialization process in each loop.
-  InterpolationPolicy interpolation(cleanedData);
+  // The ratings are computed for blocks of users at once, so that they are
+  // obtained with matrix multiplications.  Each block of ratings takes about
+  // 32MB.
+  const size_t blockSize = std::max((size_t) 1, std::min((size_t) 1024,
+      (size_t) (1 << 22) / std::max(numItems, (size_t) 1)));
 
-  for (size_t i = 0; i < users.n_elem; i++)
+  arma::mat ratings, neighborRatings;
+  for (size_t begin = 0; begin < users.n_elem; begin += blockSize)
   {
-    // First, calculate the weighted sum of neighborhood values.
-    arma::vec ratings;
-    ratings.zeros(cleanedData.n_rows);
-
-    // Calculate interpolation weights.
-    arma::vec weights(numUsersForSimilarity);
-    interpolation.GetWeights(weights, decomposition, users(i),
-        neighborhood.col(i), similarities.col(i), cleanedData);
+    const size_t end = std::min(begin + blockSize, (size_t) users.n_elem);
 
+    // The ratings of each user are the weighted sum of the ratings of its
+    // neighbors, so they are accumulated one rank of neighbors at a time.
+    ratings.zeros(numItems, end - begin);
     for (size_t j = 0; j < neighborhood.n_rows; ++j)
     {
-      arma::vec neighborRatings;
-      decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
-      ratings += weights(j) * neighborRatings;
+      const arma::Col<size_t> neighbors = arma::trans(
+          neighborhood(arma::span(j), arma::span(begin, end - 1)));
+      const arma::rowvec neighborWeights =
+          weights(arma::span(j), arma::span(begin, end - 1));
+
+      decomposition.GetRatingOfUsers(neighbors, neighborRatings);
+      neighborRatings.each_row() %= neighborWeights;
+      ratings += neighborRatings;
     }
 
-    // Let's build the list of candidate recomendations for the given user.
-    // Default candidate: the smallest possible value and invalid item number.
-    const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
-    std::vector<Candidate> vect(numRecs, def);
-    typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-        CandidateList;
-    CandidateList pqueue(CandidateCmp(), std::move(vect));
-
-    // Look through the ratings column corresponding to the current user.
-    for (size_t j = 0; j < ratings.n_rows; ++j)
+    // Select the best candidates of each user in parallel.
+    #pragma omp parallel
     {
-      // Ensure that the user hasn't already rated the item.
-      // The algorithm omits rating of zero. Thus, when normalizing original
-      // ratings in Normalize(), if normalized rating equals zero, it is set
-      // to the smallest positive double value.
-      if (cleanedData(j, users(i)) != 0.0)
-        continue; // The user already rated the item.
-
-      // Is the estimated value better than the worst candidate?
-      // Denormalize rating before comparison.
-      double realRating = normalization.Denormalize(users(i), j, ratings[j]);
-      if (realRating > pqueue.top().first)
+      std::vector<Candidate> candidates;
+      candidates.reserve(numItems);
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
       {
-        Candidate c = std::make_pair(realRating, j);
-        pqueue.pop();
-        pqueue.push(c);
+        const size_t user = users(i);
+
+        // The items rated by the user are the nonzero elements of its column,
+        // in increasing order.  The algorithm omits rating of zero.  Thus, when
+        // normalizing original ratings in Normalize(), if normalized rating
+        // equals zero, it is set to the smallest positive double value.
+        arma::sp_mat::const_iterator it = cleanedData.begin_col(user);
+        const arma::sp_mat::const_iterator itEnd = cleanedData.end_col(user);
+
+        candidates.clear();
+        for (size_t item = 0; item < numItems; ++item)
+        {
+          if (it != itEnd && it.row() == item)
+          {
+            ++it;
+            continue; // The user already rated the item.
+          }
+
+          // Denormalize rating before comparison.
+          candidates.push_back(std::make_pair(normalization.Denormalize(user,
+              item, ratings(item, i - begin)), item));
+        }
+
+        // Only the best numRecs candidates need to be sorted.
+        const size_t found = std::min(numRecs, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + found,
+            candidates.end(), CandidateCmp());
+
+        for (size_t p = 0; p < found; ++p)
+          recommendations(p, i) = candidates[p].second;
+
+        if (found < numRecs)
+          incomplete[i] = 1;
       }
     }
+  }
+
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    if (incomplete[i])
+      Log::Warn << "Could not provide " << numRecs << " recommendations "
+          << "for user " << users(i) << " (not enough un-rated items)!"
+          << std::endl;
+  }
+}
 
-    for (size_t p = 1; p <= numRecs; p++)
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy,
+         typename ItemSearchPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetRecommendations(const size_t numRecs,
+                   arma::Mat<size_t>& recommendations,
+                   const arma::Col<size_t>& users,
+                   ItemSearchPolicy& itemSearch)
+{
+  // Calculate the neighborhood of the queried users and the interpolation
+  // weights of the neighbors.
+  arma::Mat<size_t> neighborhood;
+  arma::mat weights;
+  GetNeighborWeights<NeighborSearchPolicy, InterpolationPolicy>(users,
+      neighborhood, weights);
+
+  // Items that can't be recommended are given the invalid item number.
+  const size_t numItems = cleanedData.n_rows;
+  recommendations.set_size(numRecs, users.n_elem);
+  recommendations.fill(numItems);
+  std::vector<char> incomplete(users.n_elem, 0);
+
+  // The index is queried for blocks of users, to bound the memory used by the
+  // queries and the candidates.
+  const size_t blockSize = 16384;
+
+  arma::mat queries, neighborVectors, products;
+  arma::Mat<size_t> candidates;
+  for (size_t begin = 0; begin < users.n_elem; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) users.n_elem);
+
+    // The ratings are linear in the user vectors, so the query of each user is
+    // the weighted sum of the vectors of its neighbors.
+    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+    {
+      const arma::Col<size_t> neighbors = arma::trans(
+          neighborhood(arma::span(j), arma::span(begin, end - 1)));
+      const arma::rowvec neighborWeights =
+          weights(arma::span(j), arma::span(begin, end - 1));
+
+      decomposition.GetUserVectors(neighbors, neighborVectors);
+      neighborVectors.each_row() %= neighborWeights;
+      if (j == 0)
+        queries = std::move(neighborVectors);
+      else
+        queries += neighborVectors;
+    }
+
+    // Retrieve enough candidates to skip all the items rated by any user of
+    // the block.
+    size_t maxRated = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+      maxRated = std::max(maxRated,
+          (size_t) cleanedData.col(users(i)).n_nonzero);
+    }
+    const size_t k = std::min(numItems, numRecs + maxRated);
+    itemSearch.Search(queries, k, candidates, products);
+
+    // Filter the rated items out of the candidates of each user in parallel.
+    // The algorithm omits rating of zero.  Thus, when normalizing original
+    // ratings in Normalize(), if normalized rating equals zero, it is set to
+    // the smallest positive double value.
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = (omp_size_t) begin; i < (omp_size_t) end; ++i)
     {
-      recommendations(numRecs - p, i) = pqueue.top().second;
-      values(numRecs - p, i) = pqueue.top().first;
-      pqueue.pop();
+      size_t found = 0;
+      for (size_t c = 0; c < k && found < numRecs; ++c)
+      {
+        const size_t item = candidates(c, i - begin);
+        if (item >= numItems || cleanedData(item, users(i)) != 0.0)
+          continue;
+
+        recommendations(found++, i) = item;
+      }
+
+      if (found < numRecs)
+        incomplete[i] = 1;
     }
+  }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(numRecs - 1, i) == def.second)
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    if (incomplete[i])
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
           << std::endl;
@@ -353,9 +519,11 @@ Predict(const arma::Mat<size_t>& combinations,
 
   arma::mat weights(numUsersForSimilarity, users.n_elem);
 
-  // Calculate interpolation weights.
+  // Calculate interpolation weights.  The weights of each user are
+  // independent, so they can be computed in parallel.
   InterpolationPolicy interpolation(cleanedData);
-  for (size_t i = 0; i < users.n_elem; i++)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; i++)
   {
     interpolation.GetWeights(weights.col(i), decomposition, users[i],
         neighborhood.col(i), similarities.col(i), cleanedData);
@@ -388,6 +556,41 @@ Predict(const arma::Mat<size_t>& combinations,
   normalization.Denormalize(combinations, predictions);
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy,
+         typename InterpolationPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetNeighborWeights(const arma::Col<size_t>& users,
+                   arma::Mat<size_t>& neighborhood,
+                   arma::mat& weights) const
+{
+  // Resulting similarities.
+  arma::mat similarities;
+
+  // Calculate the neighborhood of the queried users.  Note that the query user
+  // is part of the neighborhood---this is intentional.  We want to use the
+  // weighted sum of both the query user and the local neighborhood of the
+  // query user.
+  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
+      users, numUsersForSimilarity, neighborhood, similarities);
+
+  // Calculate interpolation weights.  Initialization of an InterpolationPolicy
+  // object should be put ahead of the following loop, because the
+  // initialization may takes a relatively long time and we don't want to
+  // repeat the initialization process in each loop.  The weights of each user
+  // are independent, so they can be computed in parallel.
+  InterpolationPolicy interpolation(cleanedData);
+  weights.set_size(numUsersForSimilarity, users.n_elem);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) users.n_elem; i++)
+  {
+    interpolation.GetWeights(weights.col(i), decomposition, users(i),
+        neighborhood.col(i), similarities.col(i), cleanedData);
+  }
+}
+
 template<typename DecompositionPolicy,
          typename NormalizationType>
 void CFType<DecompositionPolicy,
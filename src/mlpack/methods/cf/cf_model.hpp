@@ -104,6 +104,35 @@ class RecommendationVisitor : public boost::static_visitor<void>
   void operator()(CFType<DecompositionPolicy>* c) const;
 };
 
+/**
+ * FoldInVisitor uses the CFType object to fold new users or new items into the
+ * model.
+ */
+class FoldInVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! Ratings of the new users or items.
+  const arma::sp_mat& ratings;
+  //! Regularization parameter.
+  const double lambda;
+  //! Whether the ratings are of new users, instead of new items.
+  const bool users;
+
+ public:
+  //! Visitor constructor.
+  FoldInVisitor(const arma::sp_mat& ratings,
+                const double lambda,
+                const bool users) :
+      ratings(ratings),
+      lambda(lambda),
+      users(users)
+  { }
+
+  //! Fold the new users or items into the model.
+  template<typename DecompositionPolicy>
+  void operator()(CFType<DecompositionPolicy>* c) const;
+};
+
 /**
  * The model to save to disk.
  */
@@ -164,6 +193,12 @@ class CFModel
   void GetRecommendations(const size_t numRecs,
                           arma::Mat<size_t>& recommendations);
 
+  //! Fold new users into the model.
+  void FoldInUsers(const arma::sp_mat& ratings, const double lambda);
+
+  //! Fold new items into the model.
+  void FoldInItems(const arma::sp_mat& ratings, const double lambda);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */);
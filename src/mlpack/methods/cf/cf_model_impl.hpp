@@ -93,6 +93,18 @@ void RecommendationVisitor<NeighborSearchPolicy, InterpolationPolicy>
         (numRecs, recommendations);
 }
 
+template<typename DecompositionPolicy>
+void FoldInVisitor::operator()(CFType<DecompositionPolicy>* c) const
+{
+  if (!c)
+    throw std::runtime_error("no cf model initialized");
+
+  if (users)
+    c->FoldInUsers(ratings, lambda);
+  else
+    c->FoldInItems(ratings, lambda);
+}
+
 CFModel::~CFModel()
 {
   boost::apply_visitor(DeleteVisitor(), cf);
@@ -151,6 +163,22 @@ void CFModel::GetRecommendations(const size_t numRecs,
   boost::apply_visitor(recommendation, cf);
 }
 
+//! Fold new users into the model.
+inline void CFModel::FoldInUsers(const arma::sp_mat& ratings,
+                                 const double lambda)
+{
+  FoldInVisitor foldIn(ratings, lambda, true);
+  boost::apply_visitor(foldIn, cf);
+}
+
+//! Fold new items into the model.
+inline void CFModel::FoldInItems(const arma::sp_mat& ratings,
+                                 const double lambda)
+{
+  FoldInVisitor foldIn(ratings, lambda, false);
+  boost::apply_visitor(foldIn, cf);
+}
+
 template<typename DecompositionPolicy>
 const CFType<DecompositionPolicy>* CFModel::CFPtr() const
 {
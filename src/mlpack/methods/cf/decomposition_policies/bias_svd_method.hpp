@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_BIAS_SVD_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/cf/decomposition_policies/fold_in.hpp>
 #include <mlpack/methods/bias_svd/bias_svd.hpp>
 
 namespace mlpack {
@@ -106,6 +107,99 @@ class BiasSVDPolicy
     rating = w * h.col(user) + p + q(user);
   }
 
+  /**
+   * Get predicted ratings for a set of users, with one column of ratings for
+   * each user.  The ratings of all the users are computed with a single
+   * matrix multiplication.
+   *
+   * @param users User IDs.
+   * @param ratings Resulting rating matrix.
+   */
+  void GetRatingOfUsers(const arma::Col<size_t>& users,
+                        arma::mat& ratings) const
+  {
+    arma::mat query(h.n_rows, users.n_elem);
+    arma::rowvec userBias(users.n_elem);
+    for (size_t i = 0; i < users.n_elem; i++)
+    {
+      query.col(i) = h.col(users(i));
+      userBias(i) = q(users(i));
+    }
+
+    ratings = w * query;
+    ratings.each_col() += p;
+    ratings.each_row() += userBias;
+  }
+
+  /**
+   * Get the item vectors, with one column for each item.  The predicted rating
+   * of an item for a user is the inner product of the item vector and the user
+   * vector given by GetUserVectors(), plus a term that only depends on the
+   * user.
+   *
+   * @param items Resulting item vectors.
+   */
+  void GetItemVectors(arma::mat& items) const
+  {
+    items = arma::join_cols(w.t(), p.t());
+  }
+
+  /**
+   * Get the user vectors for a set of users, with one column for each user.
+   *
+   * @param users User IDs.
+   * @param vectors Resulting user vectors.
+   */
+  void GetUserVectors(const arma::Col<size_t>& users,
+                      arma::mat& vectors) const
+  {
+    // The last element multiplies the item bias.
+    vectors.set_size(h.n_rows + 1, users.n_elem);
+    vectors.row(h.n_rows).ones();
+    for (size_t i = 0; i < users.n_elem; i++)
+      vectors.submat(0, i, h.n_rows - 1, i) = h.col(users(i));
+  }
+
+  /**
+   * Fold new users into the decomposition, which are given the next user IDs.
+   * The vector of each new user is the regularized least squares fit to its
+   * ratings, with the item vectors held fixed.  The bias of each new
+   * user is fitted and regularized along with its vector.
+   *
+   * @param ratings Normalized ratings of the new users, with one column for
+   *     each user.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& ratings, const double lambda)
+  {
+    // The last element of the fitted vectors is the user bias.
+    arma::mat vectors;
+    FoldIn(ratings, arma::join_cols(w.t(), arma::ones<arma::rowvec>(w.n_rows)),
+        p, lambda, vectors);
+    h = arma::join_rows(h, vectors.head_rows(h.n_rows));
+    q = arma::join_cols(q, vectors.row(h.n_rows).t());
+  }
+
+  /**
+   * Fold new items into the decomposition, which are given the next item IDs.
+   * The vector of each new item is the regularized least squares fit to its
+   * ratings, with the user vectors held fixed.  The bias of each new
+   * item is fitted and regularized along with its vector.
+   *
+   * @param ratings Normalized ratings of the new items, with one row for each
+   *     item.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& ratings, const double lambda)
+  {
+    // The last element of the fitted vectors is the item bias.
+    arma::mat vectors;
+    FoldIn(ratings.t(), arma::join_cols(h,
+        arma::ones<arma::rowvec>(h.n_cols)), q, lambda, vectors);
+    w = arma::join_cols(w, vectors.head_rows(w.n_cols).t());
+    p = arma::join_cols(p, vectors.row(w.n_cols).t());
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
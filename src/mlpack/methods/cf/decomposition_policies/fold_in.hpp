@@ -0,0 +1,87 @@
+/**
+ * @file fold_in.hpp
+ *
+ * Least squares fit of the vectors of new users or items, used to fold them
+ * into a trained decomposition.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_FOLD_IN_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_FOLD_IN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Fit the vector of each column of the given ratings, holding the other factor
+ * of the decomposition fixed.  The vector x of column j minimizes
+ *
+ * \f[
+ * \sum_{i : R_{ij} \neq 0} (R_{ij} - o_i - x^T F_i)^2 + \lambda \| x \|^2
+ * \f]
+ *
+ * where F_i is column i of the fixed factor and o_i is the offset of row i.
+ * Only the nonzero ratings are used, and the columns are solved in parallel
+ * with OpenMP.  Columns without ratings get a vector of zeros.
+ *
+ * @param ratings Ratings with one column for each vector to fit, and one row
+ *     for each column of the fixed factor.
+ * @param fixed Fixed factor.
+ * @param offsets Value subtracted from the ratings of each row; if empty,
+ *     nothing is subtracted.
+ * @param lambda Regularization parameter.
+ * @param vectors Resulting vectors, with one column for each column of the
+ *     ratings.
+ */
+inline void FoldIn(const arma::sp_mat& ratings,
+                   const arma::mat& fixed,
+                   const arma::vec& offsets,
+                   const double lambda,
+                   arma::mat& vectors)
+{
+  if (ratings.n_rows != fixed.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "FoldIn(): ratings have " << ratings.n_rows << " rows, but the "
+        << "fixed factor has " << fixed.n_cols << " columns!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  vectors.zeros(fixed.n_rows, ratings.n_cols);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t j = 0; j < (omp_size_t) ratings.n_cols; ++j)
+  {
+    std::vector<arma::uword> rows;
+    std::vector<double> values;
+    for (arma::sp_mat::const_iterator it = ratings.begin_col(j);
+         it != ratings.end_col(j); ++it)
+    {
+      rows.push_back(it.row());
+      values.push_back(*it);
+    }
+
+    if (rows.empty())
+      continue;
+
+    const arma::uvec indices(rows.data(), rows.size(), false, true);
+    arma::vec targets(values.data(), values.size());
+    if (!offsets.is_empty())
+      targets -= offsets.elem(indices);
+
+    const arma::mat local = fixed.cols(indices);
+    arma::mat gram = local * local.t();
+    gram.diag() += lambda;
+    vectors.col(j) = arma::solve(gram, local * targets);
+  }
+}
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_RANDOMIZED_SVD_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/cf/decomposition_policies/fold_in.hpp>
 #include <mlpack/methods/randomized_svd/randomized_svd.hpp>
 
 namespace mlpack {
@@ -113,6 +114,83 @@ class RandomizedSVDPolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get predicted ratings for a set of users, with one column of ratings for
+   * each user.  The ratings of all the users are computed with a single
+   * matrix multiplication.
+   *
+   * @param users User IDs.
+   * @param ratings Resulting rating matrix.
+   */
+  void GetRatingOfUsers(const arma::Col<size_t>& users,
+                        arma::mat& ratings) const
+  {
+    arma::mat query(h.n_rows, users.n_elem);
+    for (size_t i = 0; i < users.n_elem; i++)
+      query.col(i) = h.col(users(i));
+
+    ratings = w * query;
+  }
+
+  /**
+   * Get the item vectors, with one column for each item.  The predicted rating
+   * of an item for a user is the inner product of the item vector and the user
+   * vector given by GetUserVectors(), plus a term that only depends on the
+   * user.
+   *
+   * @param items Resulting item vectors.
+   */
+  void GetItemVectors(arma::mat& items) const
+  {
+    items = w.t();
+  }
+
+  /**
+   * Get the user vectors for a set of users, with one column for each user.
+   *
+   * @param users User IDs.
+   * @param vectors Resulting user vectors.
+   */
+  void GetUserVectors(const arma::Col<size_t>& users,
+                      arma::mat& vectors) const
+  {
+    vectors.set_size(h.n_rows, users.n_elem);
+    for (size_t i = 0; i < users.n_elem; i++)
+      vectors.col(i) = h.col(users(i));
+  }
+
+  /**
+   * Fold new users into the decomposition, which are given the next user IDs.
+   * The vector of each new user is the regularized least squares fit to its
+   * ratings, with the item vectors held fixed.
+   *
+   * @param ratings Normalized ratings of the new users, with one column for
+   *     each user.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& ratings, const double lambda)
+  {
+    arma::mat vectors;
+    FoldIn(ratings, w.t(), arma::vec(), lambda, vectors);
+    h = arma::join_rows(h, vectors);
+  }
+
+  /**
+   * Fold new items into the decomposition, which are given the next item IDs.
+   * The vector of each new item is the regularized least squares fit to its
+   * ratings, with the user vectors held fixed.
+   *
+   * @param ratings Normalized ratings of the new items, with one row for each
+   *     item.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& ratings, const double lambda)
+  {
+    arma::mat vectors;
+    FoldIn(ratings.t(), h, arma::vec(), lambda, vectors);
+    w = arma::join_cols(w, vectors.t());
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_SVD_INCOMPLETE_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/cf/decomposition_policies/fold_in.hpp>
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
@@ -44,6 +45,18 @@ namespace cf {
 class SVDIncompletePolicy
 {
  public:
+  /**
+   * Create the policy.  If parallel is true, the decomposition is computed on
+   * all threads with amf::SVDParallelIncrementalLearning, which runs the same
+   * updates in a different order.
+   *
+   * @param parallel Whether to compute the decomposition in parallel.
+   */
+  SVDIncompletePolicy(const bool parallel = false) : parallel(parallel)
+  {
+    /* Nothing to do here */
+  }
+
   /**
    * Apply Collaborative Filtering to the provided data set using the
    * SVD incomplete incremental method.
@@ -64,7 +77,33 @@ class SVDIncompletePolicy
              const double minResidue,
              const bool mit)
   {
-    if (mit)
+    if (parallel)
+    {
+      // Each iteration of the parallel update rule is a pass over the data
+      // instead of the update of a single column, so convert the number of
+      // iterations.
+      const size_t size = std::max((size_t) cleanedData.n_cols, (size_t) 1);
+      const size_t passes = (maxIterations + size - 1) / size;
+      amf::SVDParallelIncrementalLearning update(0.001, 0, 0, false);
+      if (mit)
+      {
+        amf::MaxIterationTermination iter(passes);
+        amf::AMF<amf::MaxIterationTermination, amf::RandomInitialization,
+            amf::SVDParallelIncrementalLearning> svdpi(iter,
+            amf::RandomInitialization(), update);
+        svdpi.Apply(cleanedData, rank, w, h);
+      }
+      else
+      {
+        amf::SimpleResidueTermination srt(minResidue, passes);
+        amf::AMF<amf::SimpleResidueTermination,
+            amf::RandomAcolInitialization<>,
+            amf::SVDParallelIncrementalLearning> svdpi(srt,
+            amf::RandomAcolInitialization<>(), update);
+        svdpi.Apply(cleanedData, rank, w, h);
+      }
+    }
+    else if (mit)
     {
       amf::MaxIterationTermination iter(maxIterations);
 
@@ -109,6 +148,83 @@ class SVDIncompletePolicy
     rating = w * h.col(user);
   }
 
+  /**
+   * Get predicted ratings for a set of users, with one column of ratings for
+   * each user.  The ratings of all the users are computed with a single
+   * matrix multiplication.
+   *
+   * @param users User IDs.
+   * @param ratings Resulting rating matrix.
+   */
+  void GetRatingOfUsers(const arma::Col<size_t>& users,
+                        arma::mat& ratings) const
+  {
+    arma::mat query(h.n_rows, users.n_elem);
+    for (size_t i = 0; i < users.n_elem; i++)
+      query.col(i) = h.col(users(i));
+
+    ratings = w * query;
+  }
+
+  /**
+   * Get the item vectors, with one column for each item.  The predicted rating
+   * of an item for a user is the inner product of the item vector and the user
+   * vector given by GetUserVectors(), plus a term that only depends on the
+   * user.
+   *
+   * @param items Resulting item vectors.
+   */
+  void GetItemVectors(arma::mat& items) const
+  {
+    items = w.t();
+  }
+
+  /**
+   * Get the user vectors for a set of users, with one column for each user.
+   *
+   * @param users User IDs.
+   * @param vectors Resulting user vectors.
+   */
+  void GetUserVectors(const arma::Col<size_t>& users,
+                      arma::mat& vectors) const
+  {
+    vectors.set_size(h.n_rows, users.n_elem);
+    for (size_t i = 0; i < users.n_elem; i++)
+      vectors.col(i) = h.col(users(i));
+  }
+
+  /**
+   * Fold new users into the decomposition, which are given the next user IDs.
+   * The vector of each new user is the regularized least squares fit to its
+   * ratings, with the item vectors held fixed.
+   *
+   * @param ratings Normalized ratings of the new users, with one column for
+   *     each user.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& ratings, const double lambda)
+  {
+    arma::mat vectors;
+    FoldIn(ratings, w.t(), arma::vec(), lambda, vectors);
+    h = arma::join_rows(h, vectors);
+  }
+
+  /**
+   * Fold new items into the decomposition, which are given the next item IDs.
+   * The vector of each new item is the regularized least squares fit to its
+   * ratings, with the user vectors held fixed.
+   *
+   * @param ratings Normalized ratings of the new items, with one row for each
+   *     item.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& ratings, const double lambda)
+  {
+    arma::mat vectors;
+    FoldIn(ratings.t(), h, arma::vec(), lambda, vectors);
+    w = arma::join_cols(w, vectors.t());
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -153,6 +269,11 @@ class SVDIncompletePolicy
   //! Get the User Matrix.
   const arma::mat& H() const { return h; }
 
+  //! Get whether the decomposition is computed in parallel.
+  bool Parallel() const { return parallel; }
+  //! Modify whether the decomposition is computed in parallel.
+  bool& Parallel() { return parallel; }
+
   /**
    * Serialization.
    */
@@ -168,6 +289,8 @@ class SVDIncompletePolicy
   arma::mat w;
   //! User matrix.
   arma::mat h;
+  //! Whether to compute the decomposition in parallel.
+  bool parallel;
 };
 
 } // namespace cf
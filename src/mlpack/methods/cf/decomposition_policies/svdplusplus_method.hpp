@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_SVDPLUSPLUS_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/methods/cf/decomposition_policies/fold_in.hpp>
 #include <mlpack/methods/svdplusplus/svdplusplus.hpp>
 
 namespace mlpack {
@@ -141,6 +142,142 @@ class SVDPlusPlusPolicy
     rating = w * userVec + p + q(user);
   }
 
+  /**
+   * Get predicted ratings for a set of users, with one column of ratings for
+   * each user.  The ratings of all the users are computed with a single
+   * matrix multiplication.
+   *
+   * @param users User IDs.
+   * @param ratings Resulting rating matrix.
+   */
+  void GetRatingOfUsers(const arma::Col<size_t>& users,
+                        arma::mat& ratings) const
+  {
+    arma::mat vectors;
+    GetUserVectors(users, vectors);
+
+    ratings = arma::join_rows(w, p) * vectors;
+    for (size_t i = 0; i < users.n_elem; i++)
+      ratings.col(i) += q(users(i));
+  }
+
+  /**
+   * Get the item vectors, with one column for each item.  The predicted rating
+   * of an item for a user is the inner product of the item vector and the user
+   * vector given by GetUserVectors(), plus a term that only depends on the
+   * user.
+   *
+   * @param items Resulting item vectors.
+   */
+  void GetItemVectors(arma::mat& items) const
+  {
+    items = arma::join_cols(w.t(), p.t());
+  }
+
+  /**
+   * Get the user vectors for a set of users, with one column for each user.
+   *
+   * @param users User IDs.
+   * @param vectors Resulting user vectors.
+   */
+  void GetUserVectors(const arma::Col<size_t>& users,
+                      arma::mat& vectors) const
+  {
+    // The last element multiplies the item bias.
+    vectors.set_size(h.n_rows + 1, users.n_elem);
+    vectors.row(h.n_rows).ones();
+    for (size_t i = 0; i < users.n_elem; i++)
+    {
+      // The user vector also includes the implicit feedback of the user.
+      arma::vec userVec(h.n_rows, arma::fill::zeros);
+      size_t implicitCount = 0;
+      for (arma::sp_mat::const_iterator it = implicitData.begin_col(users(i));
+           it != implicitData.end_col(users(i)); ++it)
+      {
+        userVec += y.col(it.row());
+        implicitCount += 1;
+      }
+      if (implicitCount != 0)
+        userVec /= std::sqrt(implicitCount);
+
+      vectors.submat(0, i, h.n_rows - 1, i) = userVec + h.col(users(i));
+    }
+  }
+
+  /**
+   * Fold new users into the decomposition, which are given the next user IDs.
+   * The vector of each new user is the regularized least squares fit to its
+   * ratings, with the item vectors held fixed.  The bias of each new
+   * user is fitted along with its vector, the rated items are its implicit
+   * feedback, and the regularization applies to the user vector including
+   * the implicit feedback.
+   *
+   * @param ratings Normalized ratings of the new users, with one column for
+   *     each user.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInUsers(const arma::sp_mat& ratings, const double lambda)
+  {
+    // Fit the complete user vectors, whose last element is the user bias.
+    arma::mat vectors;
+    FoldIn(ratings, arma::join_cols(w.t(), arma::ones<arma::rowvec>(w.n_rows)),
+        p, lambda, vectors);
+
+    // Remove the implicit feedback from the user vectors.
+    const arma::sp_mat implicitRatings = arma::spones(ratings);
+    arma::mat userVectors = vectors.head_rows(h.n_rows);
+    for (size_t i = 0; i < ratings.n_cols; i++)
+    {
+      arma::vec userVec(h.n_rows, arma::fill::zeros);
+      size_t implicitCount = 0;
+      for (arma::sp_mat::const_iterator it = implicitRatings.begin_col(i);
+           it != implicitRatings.end_col(i); ++it)
+      {
+        userVec += y.col(it.row());
+        implicitCount += 1;
+      }
+      if (implicitCount != 0)
+        userVectors.col(i) -= userVec / std::sqrt(implicitCount);
+    }
+
+    h = arma::join_rows(h, userVectors);
+    q = arma::join_cols(q, vectors.row(h.n_rows).t());
+
+    const size_t numUsers = implicitData.n_cols;
+    implicitData.resize(implicitData.n_rows, numUsers + ratings.n_cols);
+    implicitData.cols(numUsers, implicitData.n_cols - 1) = implicitRatings;
+  }
+
+  /**
+   * Fold new items into the decomposition, which are given the next item IDs.
+   * The vector of each new item is the regularized least squares fit to its
+   * ratings, with the user vectors held fixed.  The bias of each new
+   * item is fitted along with its vector.  The implicit vectors of the new
+   * items are zero, and the new items are not part of the implicit feedback
+   * of the existing users, so that their predictions don't change.
+   *
+   * @param ratings Normalized ratings of the new items, with one row for each
+   *     item.
+   * @param lambda Regularization parameter.
+   */
+  void FoldInItems(const arma::sp_mat& ratings, const double lambda)
+  {
+    // The user vectors include the implicit feedback, and their last element
+    // multiplies the item bias.
+    const arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0,
+        h.n_cols - 1, h.n_cols);
+    arma::mat userVectors;
+    GetUserVectors(users, userVectors);
+
+    arma::mat vectors;
+    FoldIn(ratings.t(), userVectors, q, lambda, vectors);
+    w = arma::join_cols(w, vectors.head_rows(w.n_cols).t());
+    p = arma::join_cols(p, vectors.row(w.n_cols).t());
+    y = arma::join_rows(y, arma::zeros<arma::mat>(y.n_rows, ratings.n_rows));
+    implicitData.resize(implicitData.n_rows + ratings.n_rows,
+        implicitData.n_cols);
+  }
+
   /**
    * Get the neighborhood and corresponding similarities for a set of users.
    *
@@ -66,12 +66,7 @@ class RegressionInterpolation
    *
    * @param cleanedData Sparse rating matrix.
    */
-  RegressionInterpolation(const arma::sp_mat& cleanedData)
-  {
-    const size_t userNum = cleanedData.n_cols;
-    a.set_size(userNum, userNum);
-    b.set_size(userNum, userNum);
-  }
+  RegressionInterpolation(const arma::sp_mat& /* cleanedData */) { }
 
   /**
    * The regression-based interpolation problem can be solved by a linear
@@ -82,6 +77,12 @@ class RegressionInterpolation
    * multiplies each neighbor's rating by its corresponding weight and sums
    * them to get predicted rating.
    *
+   * The coefficients are the inner products of the predicted ratings of the
+   * neighbors, W h_i, which are computed from the Gram matrix W^T W without
+   * computing the predicted ratings.  The Gram matrix is computed by the first
+   * call and kept for later calls, so an object should only be used with one
+   * decomposition.  GetWeights() may be called from several threads at once.
+   *
    * @param weights Resulting interpolation weights. The size of weights should
    *     be set to the number of neighbors before calling GetWeights().
    * @param decomposition Decomposition object.
@@ -111,13 +112,12 @@ class RegressionInterpolation
     const size_t itemNum = cleanedData.n_rows;
     const size_t neighborNum = neighbors.size();
 
-    // Coeffcients of the linear equations used to compute weights.
-    arma::mat coeff(neighborNum, neighborNum);
-    // Constant terms of the linear equations used to compute weights.
-    arma::vec constant(neighborNum);
-
-    arma::vec userRating(cleanedData.col(queryUser));
-    const size_t support = arma::accu(userRating != 0);
+    // The ratings of the user, projected onto the item matrix.
+    arma::vec projectedRating(w.n_cols, arma::fill::zeros);
+    size_t support = 0;
+    for (arma::sp_mat::const_iterator it = cleanedData.begin_col(queryUser);
+         it != cleanedData.end_col(queryUser); ++it, ++support)
+      projectedRating += (*it) * w.row(it.row()).t();
 
     // If user has no rating at all, average interpolation is used.
     if (support == 0)
@@ -126,60 +126,29 @@ class RegressionInterpolation
       return;
     }
 
-    for (size_t i = 0; i < neighborNum; i++)
+    #pragma omp critical(RegressionInterpolationGram)
     {
-      // Calculate coefficient.
-      arma::vec iPrediction;
-      for (size_t j = i; j < neighborNum; j++)
-      {
-        if (a(neighbors(i), neighbors(j)) != 0)
-        {
-          // The coefficient has already been cached.
-          coeff(i, j) = a(neighbors(i), neighbors(j));
-          coeff(j, i) = coeff(i, j);
-        }
-        else
-        {
-          // Calculate the coefficient.
-          if (iPrediction.size() == 0)
-            // Avoid recalculation of iPrediction.
-            iPrediction = w * h.col(neighbors(i));
-          arma::vec jPrediction = w * h.col(neighbors(j));
-          coeff(i, j) = arma::dot(iPrediction, jPrediction) / itemNum;
-          if (coeff(i, j) == 0)
-            coeff(i, j) = std::numeric_limits<double>::min();
-          coeff(j, i) = coeff(i, j);
-          // Cache calcualted coefficient.
-          a(neighbors(i), neighbors(j)) = coeff(i, j);
-          a(neighbors(j), neighbors(i)) = coeff(i, j);
-        }
-      }
-
-      // Calculate constant terms.
-      if (b(neighbors(i), queryUser) != 0)
-        // The constant term has already been cached.
-        constant(i) = b(neighbors(i), queryUser);
-      else
-      {
-        // Calcuate the constant term.
-        if (iPrediction.size() == 0)
-            // Avoid recalculation of iPrediction.
-            iPrediction = w * h.col(neighbors(i));
-        constant(i) = arma::dot(iPrediction, userRating) / support;
-        if (constant(i) == 0)
-          constant(i) = std::numeric_limits<double>::min();
-        // Cache calculated constant term.
-        b(neighbors(i), queryUser) = constant(i);
-      }
+      if (gram.n_rows != w.n_cols)
+        gram = w.t() * w;
     }
+
+    arma::mat neighborVectors(h.n_rows, neighborNum);
+    for (size_t i = 0; i < neighborNum; i++)
+      neighborVectors.col(i) = h.col(neighbors(i));
+
+    // Coeffcients of the linear equations used to compute weights.
+    const arma::mat coeff = neighborVectors.t() * gram * neighborVectors /
+        itemNum;
+    // Constant terms of the linear equations used to compute weights.
+    const arma::vec constant = neighborVectors.t() * projectedRating /
+        support;
+
     weights = arma::solve(coeff, constant);
   }
 
  private:
-  //! Cached coefficients used in linear equations to compute weights.
-  arma::sp_mat a;
-  //! Cached constant terms used in linear equations to compute weights.
-  arma::sp_mat b;
+  //! Cached Gram matrix of the item matrix, W^T W.
+  arma::mat gram;
 };
 
 } // namespace cf
@@ -0,0 +1,117 @@
+/**
+ * @file max_inner_product_search.hpp
+ *
+ * Search for the points with the largest inner products.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_MAX_INNER_PRODUCT_SEARCH_HPP
+#define MLPACK_METHODS_CF_MAX_INNER_PRODUCT_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+namespace mlpack {
+namespace cf {
+
+/**
+ * Search for the reference points with the largest inner products with each
+ * query point.  Each reference point x is extended with one dimension holding
+ * sqrt(M^2 - ||x||^2), where M is the largest norm of the reference points,
+ * and each query point q is extended with a zero.  Then
+ * ||q - x||^2 = ||q||^2 + M^2 - 2 q^T x, so the nearest neighbors of a query
+ * point are the reference points with the largest inner products, and they are
+ * found with tree-based neighbor::KNN instead of a scan of the reference set.
+ * The epsilon parameter of the search trades recall for speed: with epsilon
+ * greater than zero, the search is approximate.
+ *
+ * In CF, this is used as an index over the item vectors, to retrieve the items
+ * with the highest predicted ratings for each user in sublinear time:
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * // Users for whom recommendations are generated.
+ * extern arma::Col<size_t> users;
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * CFType<> cf(data);
+ *
+ * // Build the index once.
+ * arma::mat items;
+ * cf.Decomposition().GetItemVectors(items);
+ * MaxInnerProductSearch itemSearch(items, 0.1);
+ *
+ * // Generate 10 recommendations for the given users.
+ * cf.GetRecommendations(10, recommendations, users, itemSearch);
+ * @endcode
+ */
+class MaxInnerProductSearch
+{
+ public:
+  /**
+   * Build the index on the given reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param epsilon Relative approximation error of the underlying nearest
+   *     neighbor search; 0 gives exact results.
+   */
+  MaxInnerProductSearch(const arma::mat& referenceSet,
+                        const double epsilon = 0.0) :
+      neighborSearch(neighbor::DUAL_TREE_MODE, epsilon)
+  {
+    const arma::rowvec norms = arma::sum(arma::square(referenceSet), 0);
+    maxSquaredNorm = (norms.n_elem == 0) ? 0.0 : norms.max();
+
+    // Extend the points so that they all have the same norm.
+    arma::mat extendedSet(referenceSet.n_rows + 1, referenceSet.n_cols);
+    extendedSet.head_rows(referenceSet.n_rows) = referenceSet;
+    extendedSet.row(referenceSet.n_rows) =
+        arma::sqrt(arma::clamp(maxSquaredNorm - norms, 0.0, DBL_MAX));
+
+    neighborSearch.Train(std::move(extendedSet));
+  }
+
+  /**
+   * Given a set of query points, find the k reference points with the largest
+   * inner products, and return the inner products as similarities.  The
+   * reference points are sorted by decreasing inner product.
+   *
+   * @param query A set of query points.
+   * @param k Number of reference points to search.
+   * @param neighbors Reference points with the largest inner products.
+   * @param similarities Inner products between each query point and its
+   *     neighbors.
+   */
+  void Search(const arma::mat& query, const size_t k,
+              arma::Mat<size_t>& neighbors, arma::mat& similarities)
+  {
+    arma::mat extendedQuery(query.n_rows + 1, query.n_cols);
+    extendedQuery.head_rows(query.n_rows) = query;
+    extendedQuery.row(query.n_rows).zeros();
+
+    neighborSearch.Search(extendedQuery, k, neighbors, similarities);
+
+    // Recover the inner products from the Euclidean distances.
+    const arma::rowvec queryNorms = arma::sum(arma::square(query), 0);
+    similarities = arma::square(similarities);
+    similarities.each_row() -= queryNorms;
+    similarities = 0.5 * (maxSquaredNorm - similarities);
+  }
+
+  //! Get the largest squared norm of the reference points.
+  double MaxSquaredNorm() const { return maxSquaredNorm; }
+
+ private:
+  //! Largest squared norm of the reference points.
+  double maxSquaredNorm;
+  //! NeighborSearch object on the extended reference set.
+  neighbor::KNN neighborSearch;
+};
+
+} // namespace cf
+} // namespace mlpack
+
+#endif
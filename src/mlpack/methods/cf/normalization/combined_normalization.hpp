@@ -60,6 +60,28 @@ class CombinedNormalization
     SequenceNormalize<0>(data);
   }
 
+  /**
+   * Normalize the ratings of new users by calling NormalizeUsers() in each
+   * normalization object.
+   *
+   * @param ratings Ratings of the new users, with one column for each user.
+   */
+  void NormalizeUsers(arma::sp_mat& ratings)
+  {
+    SequenceNormalizeUsers<0>(ratings);
+  }
+
+  /**
+   * Normalize the ratings of new items by calling NormalizeItems() in each
+   * normalization object.
+   *
+   * @param ratings Ratings of the new items, with one row for each item.
+   */
+  void NormalizeItems(arma::sp_mat& ratings)
+  {
+    SequenceNormalizeItems<0>(ratings);
+  }
+
   /**
    * Denormalize rating by calling Denormalize() in each normalization object.
    * Note that the order of objects calling Denormalize() should be the
@@ -130,6 +152,40 @@ class CombinedNormalization
       typename = void>
   void SequenceNormalize(MatType& /* data */) { }
 
+  //! Unpack normalizations tuple to normalize the ratings of new users.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I < std::tuple_size<TupleType>::value)>>
+  void SequenceNormalizeUsers(arma::sp_mat& ratings)
+  {
+    std::get<I>(normalizations).NormalizeUsers(ratings);
+    SequenceNormalizeUsers<I+1>(ratings);
+  }
+
+  //! End of tuple unpacking.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I >= std::tuple_size<TupleType>::value)>,
+      typename = void>
+  void SequenceNormalizeUsers(arma::sp_mat& /* ratings */) { }
+
+  //! Unpack normalizations tuple to normalize the ratings of new items.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I < std::tuple_size<TupleType>::value)>>
+  void SequenceNormalizeItems(arma::sp_mat& ratings)
+  {
+    std::get<I>(normalizations).NormalizeItems(ratings);
+    SequenceNormalizeItems<I+1>(ratings);
+  }
+
+  //! End of tuple unpacking.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename = std::enable_if_t<(I >= std::tuple_size<TupleType>::value)>,
+      typename = void>
+  void SequenceNormalizeItems(arma::sp_mat& /* ratings */) { }
+
   //! Unpack normalizations tuple to denormalize.
   template<
       int I, /* Which normalization in tuple to use */
@@ -117,6 +117,57 @@ class ItemMeanNormalization
     }
   }
 
+  /**
+   * Normalize the ratings of new users by subtracting the mean rating of each
+   * item.
+   *
+   * @param ratings Ratings of the new users, with one column for each user.
+   */
+  void NormalizeUsers(arma::sp_mat& ratings) const
+  {
+    for (arma::sp_mat::iterator it = ratings.begin(); it != ratings.end(); ++it)
+    {
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive double value.
+      const double rating = *it - itemMean(it.row());
+      *it = (rating == 0) ? std::numeric_limits<double>::min() : rating;
+    }
+  }
+
+  /**
+   * Normalize the ratings of new items, which are given the next item IDs, by
+   * subtracting the mean rating of each new item.
+   *
+   * @param ratings Ratings of the new items, with one row for each item.
+   */
+  void NormalizeItems(arma::sp_mat& ratings)
+  {
+    const size_t numItems = itemMean.n_elem;
+    arma::vec newMean(ratings.n_rows, arma::fill::zeros);
+    arma::Col<size_t> ratingNum(ratings.n_rows, arma::fill::zeros);
+    for (arma::sp_mat::iterator it = ratings.begin(); it != ratings.end(); ++it)
+    {
+      newMean(it.row()) += *it;
+      ratingNum(it.row()) += 1;
+    }
+    for (size_t i = 0; i < newMean.n_elem; i++)
+    {
+      if (ratingNum(i) != 0)
+        newMean(i) /= ratingNum(i);
+    }
+
+    itemMean.resize(numItems + ratings.n_rows);
+    itemMean.tail(ratings.n_rows) = newMean;
+
+    for (arma::sp_mat::iterator it = ratings.begin(); it != ratings.end(); ++it)
+    {
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive double value.
+      const double rating = *it - newMean(it.row());
+      *it = (rating == 0) ? std::numeric_limits<double>::min() : rating;
+    }
+  }
+
   /**
    * Denormalize computed rating by adding item mean.
    *
@@ -36,6 +36,20 @@ class NoNormalization
   template<typename MatType>
   inline void Normalize(const MatType& /* data */) const { }
 
+  /**
+   * Do nothing.
+   *
+   * @param ratings Ratings of new users.
+   */
+  inline void NormalizeUsers(const arma::sp_mat& /* ratings */) const { }
+
+  /**
+   * Do nothing.
+   *
+   * @param ratings Ratings of new items.
+   */
+  inline void NormalizeItems(const arma::sp_mat& /* ratings */) const { }
+
   /**
    * Do nothing.
    *
@@ -117,6 +117,56 @@ class UserMeanNormalization
     }
   }
 
+  /**
+   * Normalize the ratings of new users, which are given the next user IDs, by
+   * subtracting the mean rating of each new user.
+   *
+   * @param ratings Ratings of the new users, with one column for each user.
+   */
+  void NormalizeUsers(arma::sp_mat& ratings)
+  {
+    const size_t numUsers = userMean.n_elem;
+    userMean.resize(numUsers + ratings.n_cols);
+    for (size_t i = 0; i < ratings.n_cols; i++)
+    {
+      double sum = 0.0;
+      size_t ratingNum = 0;
+      for (arma::sp_mat::iterator it = ratings.begin_col(i);
+           it != ratings.end_col(i); ++it)
+      {
+        sum += *it;
+        ratingNum += 1;
+      }
+      userMean(numUsers + i) = (ratingNum != 0) ? sum / ratingNum : 0.0;
+
+      for (arma::sp_mat::iterator it = ratings.begin_col(i);
+           it != ratings.end_col(i); ++it)
+      {
+        // The algorithm omits rating of zero. If normalized rating equals
+        // zero, it is set to the smallest positive double value.
+        const double rating = *it - userMean(numUsers + i);
+        *it = (rating == 0) ? std::numeric_limits<double>::min() : rating;
+      }
+    }
+  }
+
+  /**
+   * Normalize the ratings of new items by subtracting the mean rating of each
+   * user.
+   *
+   * @param ratings Ratings of the new items, with one row for each item.
+   */
+  void NormalizeItems(arma::sp_mat& ratings) const
+  {
+    for (arma::sp_mat::iterator it = ratings.begin(); it != ratings.end(); ++it)
+    {
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive double value.
+      const double rating = *it - userMean(it.col());
+      *it = (rating == 0) ? std::numeric_limits<double>::min() : rating;
+    }
+  }
+
   /**
    * Denormalize computed rating by adding user mean.
    *
@@ -100,6 +100,31 @@ class ZScoreNormalization
     }
   }
 
+  /**
+   * Normalize the ratings of new users with the mean and the standard
+   * deviation of the existing ratings.
+   *
+   * @param ratings Ratings of the new users, with one column for each user.
+   */
+  void NormalizeUsers(arma::sp_mat& ratings) const
+  {
+    for (arma::sp_mat::iterator it = ratings.begin(); it != ratings.end(); ++it)
+    {
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive double value.
+      const double rating = (*it - mean) / stddev;
+      *it = (rating == 0) ? std::numeric_limits<double>::min() : rating;
+    }
+  }
+
+  /**
+   * Normalize the ratings of new items with the mean and the standard
+   * deviation of the existing ratings.
+   *
+   * @param ratings Ratings of the new items, with one row for each item.
+   */
+  void NormalizeItems(arma::sp_mat& ratings) const { NormalizeUsers(ratings); }
+
   /**
    * Denormalize computed rating by adding mean and multiplying stddev.
    *
@@ -15,7 +15,8 @@
 
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
-#include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/range_search/grid_range_search.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include "ordered_point_selection.hpp"
 #include <boost/dynamic_bitset.hpp>
@@ -44,6 +45,17 @@ namespace dbscan {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
+ * The points are joined with their neighbors in a ConcurrentUnionFind, in
+ * parallel when OpenMP is available; the clusters do not depend on the order in
+ * which the points are joined.  For low-dimensional data, a
+ * range::GridRangeSearch with the cell width set to epsilon can be used instead
+ * of a tree:
+ *
+ * @code
+ * DBSCAN<range::GridRangeSearch<>> d(epsilon, minPoints, true,
+ *     range::GridRangeSearch<>(epsilon));
+ * @endcode
+ *
  * @tparam RangeSearchType Class to use for range searching.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
  *      with.
@@ -57,8 +69,8 @@ class DBSCAN
    * Construct the DBSCAN object with the given parameters.  The batchMode
    * parameter should be set to false in the case where RAM issues will be
    * encountered (i.e. if the dataset is very large or if epsilon is large).
-   * When batchMode is false, each point will be searched iteratively, which
-   * could be slower but will use less memory.
+   * When batchMode is false, the points will be searched in small chunks,
+   * which could be slower but will use less memory.
    *
    * @param epsilon Size of range query.
    * @param minPoints Minimum number of points for each cluster.
@@ -129,11 +141,14 @@ class DBSCAN
   //! Instantiated point selection policy.
   PointSelectionPolicy pointSelector;
 
+  //! Number of points that are searched at once by PointwiseCluster().
+  static const size_t chunkSize = 10000;
+
   /**
    * Performs DBSCAN clustering on the data, returning the number of clusters and
-   * also the list of cluster assignments.  This searches each point iteratively,
-   * and can save on RAM usage.  It may be slower than the batch search with a
-   * dual-tree algorithm.
+   * also the list of cluster assignments.  This searches the points in chunks
+   * of chunkSize points, and can save on RAM usage.  It may be slower than the
+   * batch search with a dual-tree algorithm.
    *
    * @param data Dataset to cluster.
    * @param assignments Assignments for each point.
@@ -141,7 +156,7 @@ class DBSCAN
    */
   template<typename MatType>
   void PointwiseCluster(const MatType& data,
-                        emst::UnionFind& uf);
+                        emst::ConcurrentUnionFind& uf);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -154,7 +169,7 @@ class DBSCAN
    */
   template<typename MatType>
   void BatchCluster(const MatType& data,
-                    emst::UnionFind& uf);
+                    emst::ConcurrentUnionFind& uf);
 };
 
 } // namespace dbscan
@@ -101,7 +101,7 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     arma::Row<size_t>& assignments)
 {
   // Initialize the UnionFind object.
-  emst::UnionFind uf(data.n_cols);
+  emst::ConcurrentUnionFind uf(data.n_cols);
   rangeSearch.Train(data);
 
   if (batchMode)
@@ -109,9 +109,10 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
   else
     PointwiseCluster(data, uf);
 
-  // Now set assignments.
+  // Now set assignments.  Each component is labeled by its smallest point.
   assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
     assignments[i] = uf.Find(i);
 
   // Get a count of all clusters.
@@ -142,7 +143,7 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
 
 /**
  * Performs DBSCAN clustering on the data, returning the number of clusters and
- * also the list of cluster assignments.  This searches each point iteratively,
+ * also the list of cluster assignments.  This searches the points in chunks,
  * and can save on RAM usage.  It may be slower than the batch search with a
  * dual-tree algorithm.
  */
@@ -150,23 +151,28 @@ template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
+  arma::Col<size_t> offsets;
+  arma::Col<size_t> neighbors;
+  arma::vec distances;
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  for (size_t begin = 0; begin < data.n_cols; begin += chunkSize)
   {
-    if (i % 10000 == 0 && i > 0)
-      Log::Info << "DBSCAN clustering on point " << i << "..." << std::endl;
+    if (begin > 0)
+      Log::Info << "DBSCAN clustering on point " << begin << "..." << std::endl;
 
-    // Do the range search for only this point.
-    rangeSearch.Search(data.col(i), math::Range(0.0, epsilon), neighbors,
+    // Do the range search for only this chunk of points.
+    const size_t end = std::min((size_t) data.n_cols, begin + chunkSize);
+    const MatType chunk = data.cols(begin, end - 1);
+    rangeSearch.Search(chunk, math::Range(0.0, epsilon), offsets, neighbors,
         distances);
 
     // Union to all neighbors.
-    for (size_t j = 0; j < neighbors[0].size(); ++j)
-      uf.Union(i, neighbors[0][j]);
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) (end - begin); ++i)
+      for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+        uf.Union(begin + i, neighbors[j]);
   }
 }
 
@@ -179,23 +185,31 @@ template<typename RangeSearchType, typename PointSelectionPolicy>
 template<typename MatType>
 void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
     const MatType& data,
-    emst::UnionFind& uf)
+    emst::ConcurrentUnionFind& uf)
 {
   // For each point, find the points in epsilon-nighborhood and their distances.
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<double>> distances;
+  // The results are held in CSR form, so that no allocation is done per point.
+  arma::Col<size_t> offsets;
+  arma::Col<size_t> neighbors;
+  arma::vec distances;
   Log::Info << "Performing range search." << std::endl;
-  rangeSearch.Train(data);
-  rangeSearch.Search(data, math::Range(0.0, epsilon), neighbors, distances);
+  rangeSearch.Search(data, math::Range(0.0, epsilon), offsets, neighbors,
+      distances);
   Log::Info << "Range search complete." << std::endl;
 
-  // Now loop over all points.
+  // The point selection policy may not be thread-safe, so the order of the
+  // points is computed first.
+  std::vector<size_t> order(data.n_cols);
   for (size_t i = 0; i < data.n_cols; ++i)
+    order[i] = pointSelector.Select(i, data);
+
+  // Now loop over all points.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
   {
-    // Get the next index.
-    const size_t index = pointSelector.Select(i, data);
-    for (size_t j = 0; j < neighbors[index].size(); ++j)
-      uf.Union(index, neighbors[index][j]);
+    const size_t index = order[i];
+    for (size_t j = offsets[index]; j < offsets[index + 1]; ++j)
+      uf.Union(index, neighbors[j]);
   }
 }
 
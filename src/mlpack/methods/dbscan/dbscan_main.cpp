@@ -55,7 +55,9 @@ PROGRAM_INFO("DBSCAN clustering",
     PRINT_PARAM_STRING("naive") + " parameters.  " +
     PRINT_PARAM_STRING("tree_type") + " can control the type of tree used for "
     "range search; this can take a variety of values: 'kd', 'r', 'r-star', 'x',"
-    " 'hilbert-r', 'r-plus', 'r-plus-plus', 'cover', 'ball'. The " +
+    " 'hilbert-r', 'r-plus', 'r-plus-plus', 'cover', 'ball', or 'grid' for a "
+    "grid of cells of width epsilon, which is fastest for low-dimensional "
+    "data. The " +
     PRINT_PARAM_STRING("single_mode") + " parameter will force single-tree "
     "search (as opposed to the default dual-tree search), and '" +
     PRINT_PARAM_STRING("naive") + " will force brute-force range search."
@@ -82,7 +84,7 @@ PARAM_INT_IN("min_size", "Minimum number of points for a cluster.", "m", 5);
 
 PARAM_STRING_IN("tree_type", "If using single-tree or dual-tree search, the "
     "type of tree to use ('kd', 'r', 'r-star', 'x', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'cover', 'ball').", "t", "kd");
+    "'r-plus-plus', 'cover', 'ball', 'grid').", "t", "kd");
 PARAM_STRING_IN("selection_type", "If using point selection policy, the "
     "type of selection to use ('ordered', 'random').", "s", "ordered");
 PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
@@ -90,13 +92,23 @@ PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
 PARAM_FLAG("naive", "If set, brute-force range search (not tree-based) "
     "will be used.", "N");
 
+// Use single-tree search, if requested.
+template<typename RangeSearchType>
+void SetSingleMode(RangeSearchType& rs)
+{
+  if (CLI::HasParam("single_mode"))
+    rs.SingleMode() = true;
+}
+
+// The grid has no single-tree mode; the points are still searched in chunks.
+void SetSingleMode(GridRangeSearch<>& /* rs */) { }
+
 // Actually run the clustering, and process the output.
 template<typename RangeSearchType, typename PointSelectionPolicy>
 void RunDBSCAN(RangeSearchType rs,
                PointSelectionPolicy pointSelector = PointSelectionPolicy())
 {
-  if (CLI::HasParam("single_mode"))
-    rs.SingleMode() = true;
+  SetSingleMode(rs);
 
   // Load dataset.
   arma::mat dataset = std::move(CLI::GetParam<arma::mat>("input"));
@@ -145,7 +157,7 @@ static void mlpackMain()
   ReportIgnoredParam({{ "naive", true }}, "single_mode");
 
   RequireParamInSet<string>("tree_type", { "kd", "cover", "r", "r-star", "x",
-      "hilbert-r", "r-plus", "r-plus-plus", "ball" }, true,
+      "hilbert-r", "r-plus", "r-plus-plus", "ball", "grid" }, true,
       "unknown tree type");
 
   // Value of epsilon should be positive.
@@ -209,5 +221,10 @@ static void mlpackMain()
       ChoosePointSelectionPolicy<RangeSearch<EuclideanDistance, arma::mat,
           BallTree>>();
     }
+    else if (treeType == "grid")
+    {
+      GridRangeSearch<> rs(CLI::GetParam<double>("epsilon"));
+      ChoosePointSelectionPolicy(rs);
+    }
   }
 }
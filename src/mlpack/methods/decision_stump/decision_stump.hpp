@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_DECISION_STUMP_DECISION_STUMP_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <memory>
 
 namespace mlpack {
 namespace decision_stump {
@@ -53,6 +54,11 @@ class DecisionStump
    * from an already initiated decision stump, other. It appropriately sets the
    * weight vector.
    *
+   * If other was trained on the same data matrix, the sort order of each
+   * dimension that it computed is reused instead of sorting the data again.
+   * This is what happens between the rounds of boosting; the data must not be
+   * modified between the training of other and of this stump.
+   *
    * @param other The other initiated Decision Stump object from
    *      which we copy the values.
    * @param data The data on which to train this object on.
@@ -148,28 +154,50 @@ class DecisionStump
   //! Stores the labels for each splitting bin.
   arma::Col<size_t> binLabels;
 
+  //! The order of the points of the training data when sorted by each
+  //! dimension (one column per dimension).  This is shared between stumps
+  //! built on the same data, and is not serialized.
+  std::shared_ptr<const arma::umat> sortedIndices;
+  //! The data that sortedIndices was computed for.
+  const void* sortedData;
+
+  //! Allow stumps with other matrix types to share the sort order.
+  template<typename> friend class DecisionStump;
+
+  /**
+   * Compute the sort order of each dimension of the given data, unless the
+   * sort order for this data is already known.
+   *
+   * @param data Dataset to sort.
+   */
+  void Presort(const MatType& data);
+
   /**
    * Sets up dimension as if it were splitting on it and finds entropy when
    * splitting on dimension.
    *
-   * @param dimension A row from the training data, which might be a
-   *     candidate for the splitting dimension.
+   * @param sortedIndex The order of the points when sorted by this dimension.
+   * @param labels Labels of the training data.
+   * @param weights Weights of the training data.
    * @tparam UseWeights Whether we need to run a weighted Decision Stump.
    */
-  template<bool UseWeights, typename VecType>
-  double SetupSplitDimension(const VecType& dimension,
+  template<bool UseWeights>
+  double SetupSplitDimension(const arma::uvec& sortedIndex,
                              const arma::Row<size_t>& labels,
-                             const arma::rowvec& weightD);
+                             const arma::rowvec& weights);
 
   /**
    * After having decided the dimension on which to split, train on that
    * dimension.
    *
-   * @tparam dimension dimension is the dimension decided by the constructor
+   * @param dimension dimension is the dimension decided by the constructor
    *      on which we now train the decision stump.
+   * @param sortedIndex The order of the points when sorted by this dimension.
+   * @param labels Labels of the training data.
    */
   template<typename VecType>
   void TrainOnDim(const VecType& dimension,
+                  const arma::uvec& sortedIndex,
                   const arma::Row<size_t>& labels);
 
   /**
@@ -208,6 +236,16 @@ class DecisionStump
   double CalculateEntropy(const VecType& labels,
                           const WeightVecType& weights);
 
+  /**
+   * Calculate the entropy of a set of points from the (weighted) number of
+   * points in each class.
+   *
+   * @param classCounts Weighted number of points in each class.
+   * @param total Total weight of the points.
+   */
+  static double CountsEntropy(const arma::vec& classCounts,
+                              const double total);
+
   /**
    * Train the decision stump on the given data and labels.
    *
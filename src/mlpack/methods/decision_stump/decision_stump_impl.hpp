@@ -32,7 +32,8 @@ DecisionStump<MatType>::DecisionStump(const MatType& data,
                                       const size_t numClasses,
                                       const size_t bucketSize) :
     numClasses(numClasses),
-    bucketSize(bucketSize)
+    bucketSize(bucketSize),
+    sortedData(NULL)
 {
   arma::rowvec weights;
   Train<false>(data, labels, weights);
@@ -47,7 +48,8 @@ DecisionStump<MatType>::DecisionStump() :
     bucketSize(0),
     splitDimension(0),
     split(1),
-    binLabels(1)
+    binLabels(1),
+    sortedData(NULL)
 {
   split[0] = DBL_MAX;
   binLabels[0] = 0;
@@ -65,6 +67,10 @@ double DecisionStump<MatType>::Train(const MatType& data,
   this->numClasses = numClasses;
   this->bucketSize = bucketSize;
 
+  // The data may have changed since the last training, so sort it again.
+  sortedIndices.reset();
+  sortedData = NULL;
+
   // Pass to unweighted training function.
   arma::rowvec weights;
   return Train<false>(data, labels, weights);
@@ -85,6 +91,10 @@ double DecisionStump<MatType>::Train(const MatType& data,
   this->numClasses = numClasses;
   this->bucketSize = bucketSize;
 
+  // The data may have changed since the last training, so sort it again.
+  sortedIndices.reset();
+  sortedData = NULL;
+
   // Pass to weighted training function.
   return Train<true>(data, labels, weights);
 }
@@ -102,6 +112,9 @@ double DecisionStump<MatType>::Train(const MatType& data,
                                      const arma::Row<size_t>& labels,
                                      const arma::rowvec& weights)
 {
+  // Sort each dimension, if that has not been done for this data yet.
+  Presort(data);
+
   // If classLabels are not all identical, proceed with training.
   size_t bestDim = 0;
   double entropy;
@@ -110,12 +123,14 @@ double DecisionStump<MatType>::Train(const MatType& data,
   double gain, bestGain = 0.0;
   for (size_t i = 0; i < data.n_rows; i++)
   {
-    // Go through each dimension of the data.
-    if (IsDistinct(data.row(i)))
+    // Go through each dimension of the data.  The values of a dimension are
+    // all identical if its smallest and largest values are.
+    const arma::uvec sortedIndex = sortedIndices->unsafe_col(i);
+    if (data(i, sortedIndex[0]) != data(i, sortedIndex[data.n_cols - 1]))
     {
       // For each dimension with non-identical values, treat it as a potential
       // splitting dimension and calculate entropy if split on it.
-      entropy = SetupSplitDimension<UseWeights>(data.row(i), labels, weights);
+      entropy = SetupSplitDimension<UseWeights>(sortedIndex, labels, weights);
 
       gain = rootEntropy - entropy;
       // Find the dimension with the best entropy so that the gain is
@@ -133,10 +148,33 @@ double DecisionStump<MatType>::Train(const MatType& data,
   splitDimension = bestDim;
 
   // Once the splitting column/dimension has been decided, train on it.
-  TrainOnDim(data.row(splitDimension), labels);
+  TrainOnDim(data.row(splitDimension),
+      sortedIndices->unsafe_col(splitDimension), labels);
   return -bestGain;
 }
 
+/**
+ * Compute the sort order of each dimension of the data, if it is not already
+ * known.
+ */
+template<typename MatType>
+void DecisionStump<MatType>::Presort(const MatType& data)
+{
+  if (sortedIndices && sortedData == (const void*) &data &&
+      sortedIndices->n_rows == data.n_cols &&
+      sortedIndices->n_cols == data.n_rows)
+    return;
+
+  // This sort is stable.
+  arma::umat* indices = new arma::umat(data.n_cols, data.n_rows);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < data.n_rows; ++i)
+    indices->col(i) = arma::stable_sort_index(data.row(i).t());
+
+  sortedIndices.reset(indices);
+  sortedData = (const void*) &data;
+}
+
 /**
  * Classification function. After training, classify test, and put the predicted
  * classes in predictedLabels.
@@ -150,7 +188,9 @@ void DecisionStump<MatType>::Classify(const MatType& test,
                                       arma::Row<size_t>& predictedLabels)
 {
   predictedLabels.set_size(test.n_cols);
-  for (size_t i = 0; i < test.n_cols; i++)
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < test.n_cols; i++)
   {
     // Determine which bin the test point falls into.
     // Assume first that it falls into the first bin, then proceed through the
@@ -189,7 +229,9 @@ DecisionStump<MatType>::DecisionStump(const DecisionStump<>& other,
                                       const size_t numClasses,
                                       const arma::rowvec& weights) :
     numClasses(numClasses),
-    bucketSize(other.bucketSize)
+    bucketSize(other.bucketSize),
+    sortedIndices(other.sortedIndices),
+    sortedData(other.sortedData)
 {
   Train<true>(data, labels, weights);
 }
@@ -209,95 +251,87 @@ void DecisionStump<MatType>::serialize(Archive& ar,
   ar & BOOST_SERIALIZATION_NVP(splitDimension);
   ar & BOOST_SERIALIZATION_NVP(split);
   ar & BOOST_SERIALIZATION_NVP(binLabels);
+
+  // The sort order of the training data is not kept.
+  if (Archive::is_loading::value)
+  {
+    sortedIndices.reset();
+    sortedData = NULL;
+  }
 }
 
 /**
  * Sets up dimension as if it were splitting on it and finds entropy when
- * splitting on dimension.
+ * splitting on dimension.  The buckets are found in one sweep over the sorted
+ * points, keeping the running (weighted) count of each class in the current
+ * bucket.
  *
- * @param dimension A row from the training data, which might be a candidate for
- *      the splitting dimension.
+ * @param sortedIndex The order of the points when sorted by the candidate
+ *      splitting dimension.
  * @param UseWeights Whether we need to run a weighted Decision Stump.
  */
 template<typename MatType>
-template<bool UseWeights, typename VecType>
+template<bool UseWeights>
 double DecisionStump<MatType>::SetupSplitDimension(
-    const VecType& dimension,
+    const arma::uvec& sortedIndex,
     const arma::Row<size_t>& labels,
     const arma::rowvec& weights)
 {
+  const size_t n = sortedIndex.n_elem;
   size_t i, count, begin, end;
   double entropy = 0.0;
 
-  // Store the indices of the sorted dimension to build a vector of sorted
-  // labels.  This sort is stable.
-  arma::uvec sortedIndexDim = arma::stable_sort_index(dimension.t());
-
-  arma::Row<size_t> sortedLabels(dimension.n_elem);
-  arma::rowvec sortedWeights(dimension.n_elem);
-
-  for (i = 0; i < dimension.n_elem; i++)
-  {
-    sortedLabels(i) = labels(sortedIndexDim(i));
-
-    // Apply weights if necessary.
-    if (UseWeights)
-      sortedWeights(i) = weights(sortedIndexDim(i));
-  }
+  // The class counts of the points of the current bucket that have been seen;
+  // points [begin, next) are included.
+  arma::vec classCounts(numClasses, arma::fill::zeros);
+  double totalCount = 0.0;
+  size_t next = 0;
 
   i = 0;
   count = 0;
 
   // This splits the sorted data into buckets of size greater than or equal to
   // bucketSize.
-  while (i < sortedLabels.n_elem)
+  while (i < n)
   {
     count++;
-    if (i == sortedLabels.n_elem - 1)
+    begin = i - count + 1;
+    if (i == n - 1)
     {
       // If we're at the end, then don't worry about the bucket size; just take
       // this as the last bin.
-      begin = i - count + 1;
       end = i;
-
-      // Use ratioEl to calculate the ratio of elements in this split.
-      const double ratioEl = ((double) (end - begin + 1) / sortedLabels.n_elem);
-
-      entropy += ratioEl * CalculateEntropy<UseWeights>(
-          sortedLabels.subvec(begin, end), sortedWeights.subvec(begin, end));
-      i++;
     }
-    else if (sortedLabels(i) != sortedLabels(i + 1))
+    else if (labels(sortedIndex(i)) != labels(sortedIndex(i + 1)))
     {
       // If we're not at the last element of sortedLabels, then check whether
-      // count is less than the current bucket size.
-      if (count < bucketSize)
-      {
-        // If it is, then take the minimum bucket size anyways.
-        // This is where the inpBucketSize comes into use.
-        // This makes sure there isn't a bucket for every change in labels.
-        begin = i - count + 1;
-        end = begin + bucketSize - 1;
-
-        if (end > sortedLabels.n_elem - 1)
-          end = sortedLabels.n_elem - 1;
-      }
-      else
-      {
-        // If it is not, then take the bucket size as the value of count.
-        begin = i - count + 1;
-        end = i;
-      }
-      const double ratioEl = ((double) (end - begin + 1) / sortedLabels.n_elem);
-
-      entropy += ratioEl * CalculateEntropy<UseWeights>(
-          sortedLabels.subvec(begin, end), sortedWeights.subvec(begin, end));
-
-      i = end + 1;
-      count = 0;
+      // count is less than the current bucket size.  If it is, then take the
+      // minimum bucket size anyways.  This makes sure there isn't a bucket for
+      // every change in labels.
+      end = (count < bucketSize) ? std::min(begin + bucketSize - 1, n - 1) : i;
     }
     else
+    {
       i++;
+      continue;
+    }
+
+    // Add the rest of the points of this bucket to the running counts.
+    for (; next <= end; ++next)
+    {
+      const double weight = UseWeights ? weights(sortedIndex(next)) : 1.0;
+      classCounts(labels(sortedIndex(next))) += weight;
+      totalCount += weight;
+    }
+
+    // Use ratioEl to calculate the ratio of elements in this split.
+    const double ratioEl = ((double) (end - begin + 1) / n);
+    entropy += ratioEl * CountsEntropy(classCounts, totalCount);
+
+    classCounts.zeros();
+    totalCount = 0.0;
+    i = end + 1;
+    count = 0;
   }
   return entropy;
 }
@@ -312,17 +346,18 @@ double DecisionStump<MatType>::SetupSplitDimension(
 template<typename MatType>
 template<typename VecType>
 void DecisionStump<MatType>::TrainOnDim(const VecType& dimension,
+                                        const arma::uvec& sortedIndex,
                                         const arma::Row<size_t>& labels)
 {
   size_t i, count, begin, end;
 
-  typename MatType::row_type sortedSplitDim = arma::sort(dimension);
-  arma::uvec sortedSplitIndexDim = arma::stable_sort_index(dimension.t());
+  typename MatType::row_type sortedSplitDim(dimension.n_elem);
   arma::Row<size_t> sortedLabels(dimension.n_elem);
-  sortedLabels.fill(0);
-
   for (i = 0; i < dimension.n_elem; i++)
-    sortedLabels(i) = labels(sortedSplitIndexDim(i));
+  {
+    sortedSplitDim(i) = dimension(sortedIndex(i));
+    sortedLabels(i) = labels(sortedIndex(i));
+  }
 
   arma::rowvec subCols;
   double mostFreq;
@@ -512,6 +547,23 @@ double DecisionStump<MatType>::CalculateEntropy(
   return entropy / std::log(2.0);
 }
 
+/**
+ * Calculate the entropy of a set of points from the class counts.
+ */
+template<typename MatType>
+double DecisionStump<MatType>::CountsEntropy(const arma::vec& classCounts,
+                                             const double total)
+{
+  double entropy = 0.0;
+  for (size_t j = 0; j < classCounts.n_elem; j++)
+  {
+    const double p1 = classCounts(j) / total;
+    entropy += (p1 == 0) ? 0 : p1 * std::log(p1);
+  }
+
+  return entropy / std::log(2.0);
+}
+
 } // namespace decision_stump
 } // namespace mlpack
 
@@ -0,0 +1,116 @@
+/**
+ * @file binary_categorical_split.hpp
+ *
+ * A tree splitter that splits categorical features into two children by
+ * ordering the categories.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The BinaryCategoricalSplit is a splitting function that splits categorical
+ * features into two children, each of which holds a subset of the categories.
+ * Instead of trying all 2^(k - 1) - 1 partitions of the k categories, the
+ * categories are sorted by the proportion of the majority class of the node,
+ * and only the k - 1 partitions of a prefix of that order from the rest are
+ * evaluated, in one linear pass over the per-class counts of each category.
+ *
+ * For two classes, this finds the best partition for the Gini impurity and the
+ * entropy (Fisher 1958; Breiman et al. 1984).  For more classes the order is a
+ * heuristic, but unlike AllCategoricalSplit the number of children does not
+ * grow with the number of categories, so categorical features with many
+ * categories do not fragment the data.
+ *
+ * After a split, classProbabilities holds one element per category: the child
+ * (0 or 1) that points of that category go to.  Categories that were not seen
+ * in the node go to the left child.
+ *
+ * The FitnessFunction must provide an EvaluatePtr() function that evaluates the
+ * gain from per-class counts; GiniGain and InformationGain both do.
+ *
+ * @tparam FitnessFunction Fitness function to evaluate gain with.
+ */
+template<typename FitnessFunction>
+class BinaryCategoricalSplit
+{
+ public:
+  // No extra info needed for split.
+  template<typename ElemType>
+  class AuxiliarySplitInfo { };
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then classProbabilities
+   * and aux may be modified.  For this particular split type, aux will be empty
+   * and classProbabilities will hold the child of each category.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param numCategories Number of categories in the categorical data.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param classProbabilities Class probabilities vector, which may be filled
+   *      with split information a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const size_t numCategories,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::Col<typename VecType::elem_type>& classProbabilities,
+      AuxiliarySplitInfo<typename VecType::elem_type>& aux);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  template<typename ElemType>
+  static size_t NumChildren(const arma::Col<ElemType>& /* classProbabilities */,
+                            const AuxiliarySplitInfo<ElemType>& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param classProbabilities Auxiliary information for the split.
+   * @param aux (Unused) auxiliary information for the split.
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const arma::Col<ElemType>& classProbabilities,
+      const AuxiliarySplitInfo<ElemType>& /* aux */);
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "binary_categorical_split_impl.hpp"
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * @file binary_categorical_split_impl.hpp
+ *
+ * Implementation of the BinaryCategoricalSplit categorical split class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_BINARY_CATEGORICAL_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "binary_categorical_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double BinaryCategoricalSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const size_t numCategories,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2) || data.n_elem == 0)
+    return bestGain;
+
+  // Count the points in each category, and the count (or weight) of each class
+  // in each category.
+  arma::mat categoryCounts(numClasses, numCategories, arma::fill::zeros);
+  arma::Col<size_t> categoryPoints(numCategories, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t category = (size_t) data[i];
+    categoryCounts(labels[i], category) += UseWeights ?
+        (double) weights[i] : 1.0;
+    ++categoryPoints[category];
+  }
+
+  // Only the categories that have points can be split.
+  const arma::uvec present = arma::find(categoryPoints);
+  if (present.n_elem < 2)
+    return bestGain;
+
+  // Order the categories by the proportion of the majority class of the node.
+  const arma::vec totalCounts = arma::sum(categoryCounts, 1);
+  const double totalWeight = arma::accu(totalCounts);
+  arma::uword majorityClass;
+  totalCounts.max(majorityClass);
+  arma::vec proportions(present.n_elem);
+  for (size_t c = 0; c < present.n_elem; ++c)
+  {
+    const double categoryWeight = arma::accu(categoryCounts.col(present[c]));
+    proportions[c] = (categoryWeight > 0.0) ?
+        categoryCounts(majorityClass, present[c]) / categoryWeight : 0.0;
+  }
+  const arma::uvec order = present(arma::stable_sort_index(proportions));
+
+  // Loop through the boundaries between consecutive categories in that order,
+  // choosing the best one.  Also, force a minimum leaf size of 1 (empty
+  // children don't make sense).
+  arma::vec leftCounts(numClasses, arma::fill::zeros);
+  arma::vec rightCounts(numClasses);
+  double leftWeight = 0.0;
+  size_t leftPoints = 0;
+  double bestFoundGain = bestGain;
+  size_t bestBoundary = order.n_elem;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  for (size_t c = 0; c + 1 < order.n_elem; ++c)
+  {
+    leftCounts += categoryCounts.col(order[c]);
+    leftWeight += arma::accu(categoryCounts.col(order[c]));
+    leftPoints += categoryPoints[order[c]];
+
+    if (leftPoints < minimum)
+      continue;
+    if (data.n_elem - leftPoints < minimum)
+      break;
+
+    rightCounts = totalCounts - leftCounts;
+    const double rightWeight = totalWeight - leftWeight;
+
+    // Calculate the gain for the left and right child.
+    const double leftGain = FitnessFunction::template EvaluatePtr<UseWeights>(
+        leftCounts.memptr(), numClasses, leftWeight);
+    const double rightGain = FitnessFunction::template EvaluatePtr<UseWeights>(
+        rightCounts.memptr(), numClasses, rightWeight);
+
+    // Weight the gain of each child by its fraction of the points (or of the
+    // total weight).
+    double gain;
+    if (UseWeights)
+    {
+      gain = (leftWeight / totalWeight) * leftGain +
+          (rightWeight / totalWeight) * rightGain;
+    }
+    else
+    {
+      const double leftRatio = double(leftPoints) / double(data.n_elem);
+      const double rightRatio = 1.0 - leftRatio;
+
+      gain = leftRatio * leftGain + rightRatio * rightGain;
+    }
+
+    if (gain > bestFoundGain + minimumGainSplit)
+    {
+      bestFoundGain = gain;
+      bestBoundary = c;
+
+      // No split can be better than a perfect one.
+      if (gain >= 0.0)
+        break;
+    }
+  }
+
+  if (bestBoundary == order.n_elem)
+    return bestGain;
+
+  // Store the child of each category: the categories up to the boundary (and
+  // the categories that were not seen) go left.
+  classProbabilities.zeros(numCategories);
+  for (size_t c = bestBoundary + 1; c < order.n_elem; ++c)
+    classProbabilities[order[c]] = 1;
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t BinaryCategoricalSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  // Categories that are out of range (not seen in training) go left.
+  const size_t category = (size_t) point;
+  if (category >= classProbabilities.n_elem)
+    return 0;
+
+  return (size_t) classProbabilities[category];
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
@@ -16,19 +16,35 @@
 #include <mlpack/prereqs.hpp>
 #include "gini_gain.hpp"
 #include "best_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
 #include "all_categorical_split.hpp"
+#include "binary_categorical_split.hpp"
 #include "all_dimension_select.hpp"
 #include <type_traits>
 
 namespace mlpack {
 namespace tree {
 
+// Forward declaration of RandomForest, which is a friend of DecisionTree.
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+class RandomForest;
+
 /**
  * This class implements a generic decision tree learner.  Its behavior can be
  * controlled via its template arguments.
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * When OpenMP is enabled, nodes with many points are built in parallel: the
+ * candidate dimensions of the node are evaluated as separate tasks, and the
+ * children are then built as separate tasks.  When the tree is trained inside
+ * a parallel region (as in RandomForest), the tasks are shared with the other
+ * threads of that region.
  */
 template<typename FitnessFunction = GiniGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
@@ -56,7 +72,8 @@ class DecisionTree :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or labels are no longer needed to avoid copies.
+   * The data is not copied; use std::move if labels are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension of the dataset.
@@ -66,7 +83,7 @@ class DecisionTree :
    * @param minimumGainSplit Minimum gain for the node to split.
    */
   template<typename MatType, typename LabelsType>
-  DecisionTree(MatType data,
+  DecisionTree(const MatType& data,
                const data::DatasetInfo& datasetInfo,
                LabelsType labels,
                const size_t numClasses,
@@ -79,7 +96,8 @@ class DecisionTree :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or labels are no longer needed to avoid copies.
+   * The data is not copied; use std::move if labels are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param labels Labels for each training point.
@@ -88,7 +106,7 @@ class DecisionTree :
    * @param minimumGainSplit Minimum gain for the node to split.
    */
   template<typename MatType, typename LabelsType>
-  DecisionTree(MatType data,
+  DecisionTree(const MatType& data,
                LabelsType labels,
                const size_t numClasses,
                const size_t minimumLeafSize = 10,
@@ -100,8 +118,8 @@ class DecisionTree :
    * and minimumGainSplit too small may cause the tree to overfit, but setting
    * them too large may cause it to underfit.
    *
-   * Use std::move if data, labels or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied; use std::move if labels or weights are no longer
+   * needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension of the dataset.
@@ -112,7 +130,7 @@ class DecisionTree :
    * @param minimumGainSplit Minimum gain for the node to split.
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
-  DecisionTree(MatType data,
+  DecisionTree(const MatType& data,
                const data::DatasetInfo& datasetInfo,
                LabelsType labels,
                const size_t numClasses,
@@ -129,8 +147,8 @@ class DecisionTree :
    * and minimumGainSplit too small may cause the tree to overfit, but setting
    * them too large may cause it to underfit.
    *
-   * Use std::move if data, labels or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied; use std::move if labels or weights are no longer
+   * needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param labels Labels for each training point.
@@ -140,7 +158,7 @@ class DecisionTree :
    * @param minimumGainSplit Minimum gain for the node to split.
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
-  DecisionTree(MatType data,
+  DecisionTree(const MatType& data,
                LabelsType labels,
                const size_t numClasses,
                WeightsType weights,
@@ -201,7 +219,8 @@ class DecisionTree :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or labels are no longer needed to avoid copies.
+   * The data is not copied; use std::move if labels are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension.
@@ -213,7 +232,7 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                const data::DatasetInfo& datasetInfo,
                LabelsType labels,
                const size_t numClasses,
@@ -226,7 +245,8 @@ class DecisionTree :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or labels are no longer needed to avoid copies.
+   * The data is not copied; use std::move if labels are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param labels Labels for each training point.
@@ -237,7 +257,7 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                LabelsType labels,
                const size_t numClasses,
                const size_t minimumLeafSize = 10,
@@ -250,8 +270,8 @@ class DecisionTree :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data, labels or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied; use std::move if labels or weights are no longer
+   * needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension.
@@ -263,7 +283,7 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                const data::DatasetInfo& datasetInfo,
                LabelsType labels,
                const size_t numClasses,
@@ -279,8 +299,8 @@ class DecisionTree :
    * minimumLeafSize and minimumGainSplit too small may cause the tree to
    * overfit, but setting them too large may cause it to underfit.
    *
-   * Use std::move if data, labels or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied; use std::move if labels or weights are no longer
+   * needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param labels Labels for each training point.
@@ -291,7 +311,7 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                LabelsType labels,
                const size_t numClasses,
                WeightsType weights,
@@ -363,6 +383,19 @@ class DecisionTree :
   //! Modify the child of the given index (be careful!).
   DecisionTree& Child(const size_t i) { return *children[i]; }
 
+  //! Get the dimension this node splits on (only meaningful if the node is not
+  //! a leaf).
+  size_t SplitDimension() const { return splitDimension; }
+  //! Get the type of the dimension this node splits on (only meaningful if the
+  //! node is not a leaf).
+  data::Datatype SplitType() const
+  {
+    return (data::Datatype) dimensionTypeOrMajorityClass;
+  }
+  //! Get the class probabilities of a leaf, or the split information of a node
+  //! that is not a leaf.
+  const arma::vec& ClassProbabilities() const { return classProbabilities; }
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -379,6 +412,11 @@ class DecisionTree :
   size_t NumClasses() const;
 
  private:
+  //! RandomForest trains its trees directly on bootstrap indices.
+  template<typename, typename, template<typename> class,
+           template<typename> class, typename>
+  friend class RandomForest;
+
   //! The vector of children.
   std::vector<DecisionTree*> children;
   //! The dimension this node splits on.
@@ -414,21 +452,26 @@ class DecisionTree :
   /**
    * Corresponding to the public Train() method, this method is designed for
    * avoiding unnecessary copies during training.  This function is called to
-   * train children.
+   * train children.  The data is never modified; instead, the points of each
+   * node are the consecutive elements [begin, begin + count) of indices, and
+   * indices, labels and weights are reordered together as the tree is built.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param indices Indices of the points in the dataset; the same index may
+   *      appear more than once.
+   * @param begin Index of the starting point in indices that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param datasetInfo Type information for each dimension.
-   * @param labels Labels for each training point.
+   * @param labels Labels of the points in indices, in the same order.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::uvec& indices,
                const size_t begin,
                const size_t count,
                const data::DatasetInfo& datasetInfo,
@@ -441,20 +484,24 @@ class DecisionTree :
   /**
    * Corresponding to the public Train() method, this method is designed for
    * avoiding unnecessary copies during training.  This method is called for
-   * training children.
+   * training children.  As with the other overload, the data is never
+   * modified, and only indices, labels and weights are reordered.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param indices Indices of the points in the dataset; the same index may
+   *      appear more than once.
+   * @param begin Index of the starting point in indices that belongs to this
+   *      node.
    * @param count Number of points in this node.
-   * @param labels Labels for each training point.
+   * @param labels Labels of the points in indices, in the same order.
    * @param numClasses Number of classes in the dataset.
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::uvec& indices,
                const size_t begin,
                const size_t count,
                arma::Row<size_t>& labels,
@@ -462,6 +509,109 @@ class DecisionTree :
                arma::rowvec& weights,
                const size_t minimumLeafSize = 10,
                const double minimumGainSplit = 1e-7);
+
+  //! Nodes with at least this many points are built in parallel, if OpenMP is
+  //! enabled and more than one thread is available.
+  static const size_t parallelBuildThreshold = 10000;
+
+  /**
+   * Evaluate the given candidate dimensions of a node in parallel, and store
+   * the split information of the best one in this node.  The best dimension is
+   * chosen in the order of the candidates, with the same use of
+   * minimumGainSplit as the sequential search, so it only differs from the
+   * sequential result when two dimensions have gains within minimumGainSplit
+   * of each other.
+   *
+   * @param data Dataset to train on.
+   * @param indices Indices of the points in the dataset.
+   * @param begin Index of the starting point in indices that belongs to this
+   *      node.
+   * @param count Number of points in this node.
+   * @param datasetInfo Type information for each dimension, or NULL if all
+   *      dimensions are numeric.
+   * @param candidates Dimensions to evaluate.
+   * @param labels Labels of the points in indices, in the same order.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of the points in indices, in the same order.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param bestGain Gain of the node without a split; this is set to the gain
+   *      of the best split.
+   * @return Index of the best candidate, or candidates.size() if no split is
+   *      better than no split at all.
+   */
+  template<bool UseWeights, typename MatType>
+  size_t ParallelBestSplit(const MatType& data,
+                           const arma::uvec& indices,
+                           const size_t begin,
+                           const size_t count,
+                           const data::DatasetInfo* datasetInfo,
+                           const std::vector<size_t>& candidates,
+                           const arma::Row<size_t>& labels,
+                           const size_t numClasses,
+                           const arma::rowvec& weights,
+                           const size_t minimumLeafSize,
+                           const double minimumGainSplit,
+                           double& bestGain);
+
+  /**
+   * Compute the gain of the best split of each candidate dimension (relative
+   * to the given node gain) as a separate OpenMP task, storing the gains and
+   * the split information of each dimension.  If this is not called inside of
+   * a parallel region, a new one is created.
+   */
+  template<bool UseWeights, typename MatType>
+  void EvaluateDimensions(
+      const MatType& data,
+      const arma::uvec& indices,
+      const size_t begin,
+      const size_t count,
+      const data::DatasetInfo* datasetInfo,
+      const std::vector<size_t>& candidates,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const arma::rowvec& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      const double bestGain,
+      std::vector<double>& gains,
+      std::vector<arma::vec>& splitInfo,
+      std::vector<NumericAuxiliarySplitInfo>& numericAux,
+      std::vector<CategoricalAuxiliarySplitInfo>& categoricalAux);
+
+  /**
+   * Train the (already allocated) children of this node on their ranges of
+   * indices.  If parallel is true, each child is built as a separate OpenMP
+   * task; this is safe because the children reorder disjoint ranges of
+   * indices, labels and weights.
+   *
+   * @param data Dataset to train on.
+   * @param indices Indices of the points in the dataset.
+   * @param datasetInfo Type information for each dimension, or NULL if all
+   *      dimensions are numeric.
+   * @param labels Labels of the points in indices, in the same order.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of the points in indices, in the same order.
+   * @param childBegins Index of the first point of each child in indices.
+   * @param childCounts Number of points in each child.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param parallel Whether to build the children in parallel.
+   * @param childGains Vector to store the final gain of each child in.
+   */
+  template<bool UseWeights, typename MatType>
+  void TrainChildren(const MatType& data,
+                     arma::uvec& indices,
+                     const data::DatasetInfo* datasetInfo,
+                     arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     arma::rowvec& weights,
+                     const std::vector<size_t>& childBegins,
+                     const arma::Row<size_t>& childCounts,
+                     const size_t minimumLeafSize,
+                     const double minimumGainSplit,
+                     const bool parallel,
+                     std::vector<double>& childGains);
 };
 
 /**
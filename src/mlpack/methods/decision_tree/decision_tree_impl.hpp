@@ -28,24 +28,25 @@ DecisionTree<FitnessFunction,
              CategoricalSplitType,
              DimensionSelectionType,
              ElemType,
-             NoRecursion>::DecisionTree(MatType data,
+             NoRecursion>::DecisionTree(const MatType& data,
                                         const data::DatasetInfo& datasetInfo,
                                         LabelsType labels,
                                         const size_t numClasses,
                                         const size_t minimumLeafSize,
                                         const double minimumGainSplit)
 {
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels.  The data is not copied: the tree is built on a
+  // permutation of the point indices.
   TrueLabelsType tmpLabels(std::move(labels));
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      weights, minimumLeafSize, minimumGainSplit);
+  Train<false>(data, indices, 0, data.n_cols, datasetInfo, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit);
 }
 
 //! Construct and train.
@@ -61,22 +62,23 @@ DecisionTree<FitnessFunction,
              CategoricalSplitType,
              DimensionSelectionType,
              ElemType,
-             NoRecursion>::DecisionTree(MatType data,
+             NoRecursion>::DecisionTree(const MatType& data,
                                         LabelsType labels,
                                         const size_t numClasses,
                                         const size_t minimumLeafSize,
                                         const double minimumGainSplit)
 {
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels.  The data is not copied: the tree is built on a
+  // permutation of the point indices.
   TrueLabelsType tmpLabels(std::move(labels));
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, weights,
+  Train<false>(data, indices, 0, data.n_cols, tmpLabels, numClasses, weights,
       minimumLeafSize, minimumGainSplit);
 }
 
@@ -93,7 +95,7 @@ DecisionTree<FitnessFunction,
              CategoricalSplitType,
              DimensionSelectionType,
              ElemType,
-             NoRecursion>::DecisionTree(MatType data,
+             NoRecursion>::DecisionTree(const MatType& data,
                                         const data::DatasetInfo& datasetInfo,
                                         LabelsType labels,
                                         const size_t numClasses,
@@ -105,18 +107,19 @@ DecisionTree<FitnessFunction,
                                             typename std::remove_reference<
                                             WeightsType>::type>::value>*)
 {
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
   using TrueWeightsType = typename std::decay<WeightsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels and weights.  The data is not copied: the tree is
+  // built on a permutation of the point indices.
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      tmpWeights, minimumLeafSize, minimumGainSplit);
+  Train<true>(data, indices, 0, data.n_cols, datasetInfo, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
 //! Construct and train with weights.
@@ -132,7 +135,7 @@ DecisionTree<FitnessFunction,
              CategoricalSplitType,
              DimensionSelectionType,
              ElemType,
-             NoRecursion>::DecisionTree(MatType data,
+             NoRecursion>::DecisionTree(const MatType& data,
                                         LabelsType labels,
                                         const size_t numClasses,
                                         WeightsType weights,
@@ -143,18 +146,19 @@ DecisionTree<FitnessFunction,
                                             typename std::remove_reference<
                                             WeightsType>::type>::value>*)
 {
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
   using TrueWeightsType = typename std::decay<WeightsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels and weights.  The data is not copied: the tree is
+  // built on a permutation of the point indices.
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
-      minimumLeafSize, minimumGainSplit);
+  Train<true>(data, indices, 0, data.n_cols, tmpLabels, numClasses,
+      tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
 //! Construct, don't train.
@@ -345,7 +349,7 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     ElemType,
-                    NoRecursion>::Train(MatType data,
+                    NoRecursion>::Train(const MatType& data,
                                         const data::DatasetInfo& datasetInfo,
                                         LabelsType labels,
                                         const size_t numClasses,
@@ -362,16 +366,17 @@ double DecisionTree<FitnessFunction,
     throw std::invalid_argument(oss.str());
   }
 
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels.  The data is not copied: the tree is built on a
+  // permutation of the point indices.
   TrueLabelsType tmpLabels(std::move(labels));
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+  return Train<false>(data, indices, 0, data.n_cols, datasetInfo, tmpLabels,
       numClasses, weights, minimumLeafSize, minimumGainSplit);
 }
 
@@ -388,7 +393,7 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     ElemType,
-                    NoRecursion>::Train(MatType data,
+                    NoRecursion>::Train(const MatType& data,
                                         LabelsType labels,
                                         const size_t numClasses,
                                         const size_t minimumLeafSize,
@@ -404,16 +409,17 @@ double DecisionTree<FitnessFunction,
     throw std::invalid_argument(oss.str());
   }
 
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels.  The data is not copied: the tree is built on a
+  // permutation of the point indices.
   TrueLabelsType tmpLabels(std::move(labels));
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
+  return Train<false>(data, indices, 0, data.n_cols, tmpLabels, numClasses,
       weights, minimumLeafSize, minimumGainSplit);
 }
 
@@ -430,7 +436,7 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     ElemType,
-                    NoRecursion>::Train(MatType data,
+                    NoRecursion>::Train(const MatType& data,
                                         const data::DatasetInfo& datasetInfo,
                                         LabelsType labels,
                                         const size_t numClasses,
@@ -452,17 +458,18 @@ double DecisionTree<FitnessFunction,
     throw std::invalid_argument(oss.str());
   }
 
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
   using TrueWeightsType = typename std::decay<WeightsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels and weights.  The data is not copied: the tree is
+  // built on a permutation of the point indices.
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
 
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+  return Train<true>(data, indices, 0, data.n_cols, datasetInfo, tmpLabels,
       numClasses, tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
@@ -479,7 +486,7 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     ElemType,
-                    NoRecursion>::Train(MatType data,
+                    NoRecursion>::Train(const MatType& data,
                                         LabelsType labels,
                                         const size_t numClasses,
                                         WeightsType weights,
@@ -500,17 +507,18 @@ double DecisionTree<FitnessFunction,
     throw std::invalid_argument(oss.str());
   }
 
-  using TrueMatType = typename std::decay<MatType>::type;
   using TrueLabelsType = typename std::decay<LabelsType>::type;
   using TrueWeightsType = typename std::decay<WeightsType>::type;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels and weights.  The data is not copied: the tree is
+  // built on a permutation of the point indices.
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
+  arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols);
 
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
+  return Train<true>(data, indices, 0, data.n_cols, tmpLabels, numClasses,
       tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
@@ -527,7 +535,8 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     ElemType,
-                    NoRecursion>::Train(MatType& data,
+                    NoRecursion>::Train(const MatType& data,
+                                        arma::uvec& indices,
                                         const size_t begin,
                                         const size_t count,
                                         const data::DatasetInfo& datasetInfo,
@@ -553,46 +562,75 @@ double DecisionTree<FitnessFunction,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
   DimensionSelectionType dimensions(datasetInfo.Dimensionality());
-  for (size_t i = dimensions.Begin(); i != dimensions.End();
-       i = dimensions.Next())
+
+  // Large nodes evaluate their dimensions and build their children in
+  // parallel.
+  const bool parallel = (count >= parallelBuildThreshold) && (NumThreads() > 1);
+  if (parallel)
   {
-    double dimGain = -DBL_MAX;
-    if (datasetInfo.Type(i) == data::Datatype::categorical)
-    {
-      dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-          data.cols(begin, begin + count - 1).row(i),
-          datasetInfo.NumMappings(i),
-          labels.subvec(begin, begin + count - 1),
-          numClasses,
-          UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-          minimumLeafSize,
-          minimumGainSplit,
-          classProbabilities,
-          *this);
-    }
-    else if (datasetInfo.Type(i) == data::Datatype::numeric)
+    // The dimension selection may use the random number generator, so collect
+    // the candidate dimensions before evaluating them in parallel.
+    std::vector<size_t> candidates;
+    for (size_t i = dimensions.Begin(); i != dimensions.End();
+         i = dimensions.Next())
+      candidates.push_back(i);
+
+    const size_t bestIndex = ParallelBestSplit<UseWeights>(data, indices,
+        begin, count, &datasetInfo, candidates, labels, numClasses, weights,
+        minimumLeafSize, minimumGainSplit, bestGain);
+    if (bestIndex != candidates.size())
+      bestDim = candidates[bestIndex];
+  }
+  else
+  {
+    arma::Row<typename MatType::elem_type> dimValues(count);
+    for (size_t i = dimensions.Begin(); i != dimensions.End();
+         i = dimensions.Next())
     {
-      dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-          data.cols(begin, begin + count - 1).row(i),
-          labels.subvec(begin, begin + count - 1),
-          numClasses,
-          UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-          minimumLeafSize,
-          minimumGainSplit,
-          classProbabilities,
-          *this);
-    }
+      // Gather the values of the points in this node for this dimension.
+      for (size_t j = 0; j < count; ++j)
+        dimValues[j] = data(i, indices[begin + j]);
 
-    // Was there an improvement?  If so mark that it's the new best dimension.
-    if (dimGain > bestGain)
-    {
-      bestDim = i;
-      bestGain = dimGain;
-    }
+      double dimGain = -DBL_MAX;
+      if (datasetInfo.Type(i) == data::Datatype::categorical)
+      {
+        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(
+            bestGain,
+            dimValues,
+            datasetInfo.NumMappings(i),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            classProbabilities,
+            *this);
+      }
+      else if (datasetInfo.Type(i) == data::Datatype::numeric)
+      {
+        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
+            dimValues,
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            classProbabilities,
+            *this);
+      }
 
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain >= 0.0)
-      break;
+      // Was there an improvement?  If so mark that it's the new best
+      // dimension.
+      if (dimGain > bestGain)
+      {
+        bestDim = i;
+        bestGain = dimGain;
+      }
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -614,14 +652,14 @@ double DecisionTree<FitnessFunction,
     {
       for (size_t j = begin; j < begin + count; ++j)
         childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities, *this);
+            data(bestDim, indices[j]), classProbabilities, *this);
     }
     else
     {
       for (size_t j = begin; j < begin + count; ++j)
       {
         childAssignments[j - begin] = NumericSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities, *this);
+            data(bestDim, indices[j]), classProbabilities, *this);
       }
     }
 
@@ -630,47 +668,40 @@ double DecisionTree<FitnessFunction,
     for (size_t i = begin; i < begin + count; ++i)
       childCounts[childAssignments[i - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
-
-    // Split into children.
+    // Split the points into the children.
+    std::vector<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
+          indices.swap_rows(currentCol, j);
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
           ++currentCol;
         }
       }
+    }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit);
-      }
-      else
-      {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
-      }
-      children.push_back(child);
+    // Now build the children recursively.
+    for (size_t i = 0; i < numChildren; ++i)
+      children.push_back(new DecisionTree());
+    std::vector<double> childGains(numChildren);
+    TrainChildren<UseWeights>(data, indices, &datasetInfo, labels, numClasses,
+        weights, childBegins, childCounts, minimumLeafSize, minimumGainSplit,
+        parallel, childGains);
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      bestGain = 0.0;
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -701,7 +732,8 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     ElemType,
-                    NoRecursion>::Train(MatType& data,
+                    NoRecursion>::Train(const MatType& data,
+                                        arma::uvec& indices,
                                         const size_t begin,
                                         const size_t count,
                                         arma::Row<size_t>& labels,
@@ -728,30 +760,52 @@ double DecisionTree<FitnessFunction,
       numClasses,
       UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
   size_t bestDim = data.n_rows; // This means "no split".
-  for (size_t i = 0; i < data.n_rows; ++i)
+
+  // Large nodes evaluate their dimensions and build their children in
+  // parallel.
+  const bool parallel = (count >= parallelBuildThreshold) && (NumThreads() > 1);
+  if (parallel)
   {
-    const double dimGain = NumericSplitType<FitnessFunction>::template
-        SplitIfBetter<UseWeights>(bestGain,
-                                  data.cols(begin, begin + count - 1).row(i),
-                                  labels.cols(begin, begin + count - 1),
-                                  numClasses,
-                                  UseWeights ?
-                                      weights.cols(begin, begin + count - 1) :
-                                      weights,
-                                  minimumLeafSize,
-                                  minimumGainSplit,
-                                  classProbabilities,
-                                  *this);
-
-    if (dimGain > bestGain)
+    std::vector<size_t> candidates(data.n_rows);
+    for (size_t i = 0; i < data.n_rows; ++i)
+      candidates[i] = i;
+
+    bestDim = ParallelBestSplit<UseWeights>(data, indices, begin, count,
+        NULL, candidates, labels, numClasses, weights, minimumLeafSize,
+        minimumGainSplit, bestGain);
+  }
+  else
+  {
+    arma::Row<typename MatType::elem_type> dimValues(count);
+    for (size_t i = 0; i < data.n_rows; ++i)
     {
-      bestDim = i;
-      bestGain = dimGain;
-    }
+      // Gather the values of the points in this node for this dimension.
+      for (size_t j = 0; j < count; ++j)
+        dimValues[j] = data(i, indices[begin + j]);
+
+      const double dimGain = NumericSplitType<FitnessFunction>::template
+          SplitIfBetter<UseWeights>(bestGain,
+                                    dimValues,
+                                    labels.cols(begin, begin + count - 1),
+                                    numClasses,
+                                    UseWeights ?
+                                        weights.cols(begin, begin + count - 1) :
+                                        weights,
+                                    minimumLeafSize,
+                                    minimumGainSplit,
+                                    classProbabilities,
+                                    *this);
+
+      if (dimGain > bestGain)
+      {
+        bestDim = i;
+        bestGain = dimGain;
+      }
 
-    // If the gain is the best possible, no need to keep looking.
-    if (bestGain >= 0.0)
-      break;
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -768,7 +822,7 @@ double DecisionTree<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
     {
       childAssignments[j - begin] = NumericSplit::CalculateDirection(
-          data(bestDim, j), classProbabilities, *this);
+          data(bestDim, indices[j]), classProbabilities, *this);
     }
 
     // Calculate counts of children in each node.
@@ -777,46 +831,40 @@ double DecisionTree<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
       childCounts[childAssignments[j - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
-
+    // Split the points into the children.
+    std::vector<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
+          indices.swap_rows(currentCol, j);
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
           ++currentCol;
         }
       }
+    }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit);
-      }
-      else
-      {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
-      }
-      children.push_back(child);
+    // Now build the children recursively.
+    for (size_t i = 0; i < numChildren; ++i)
+      children.push_back(new DecisionTree());
+    std::vector<double> childGains(numChildren);
+    TrainChildren<UseWeights>(data, indices, NULL, labels, numClasses, weights,
+        childBegins, childCounts, minimumLeafSize, minimumGainSplit, parallel,
+        childGains);
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      bestGain = 0.0;
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -833,6 +881,247 @@ double DecisionTree<FitnessFunction,
   return -bestGain;
 }
 
+//! Evaluate the candidate dimensions in parallel.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+size_t DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    ElemType,
+                    NoRecursion>::ParallelBestSplit(
+    const MatType& data,
+    const arma::uvec& indices,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    const std::vector<size_t>& candidates,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    double& bestGain)
+{
+  // Each dimension gets its own split information, so that the dimensions can
+  // be evaluated independently.
+  std::vector<double> gains(candidates.size(), -DBL_MAX);
+  std::vector<arma::vec> splitInfo(candidates.size());
+  std::vector<NumericAuxiliarySplitInfo> numericAux(candidates.size());
+  std::vector<CategoricalAuxiliarySplitInfo> categoricalAux(
+      candidates.size());
+  EvaluateDimensions<UseWeights>(data, indices, begin, count, datasetInfo,
+      candidates, labels, numClasses, weights, minimumLeafSize,
+      minimumGainSplit, bestGain, gains, splitInfo, numericAux,
+      categoricalAux);
+
+  // Take the best dimension in the same order as the sequential search: a
+  // dimension has to improve on the best one before it by minimumGainSplit
+  // (unless it is a perfect split), and the search stops at the first perfect
+  // split.
+  size_t bestIndex = candidates.size();
+  for (size_t k = 0; k < candidates.size(); ++k)
+  {
+    const double minimumGain = (bestIndex == candidates.size() ||
+        gains[k] >= 0.0) ? bestGain : bestGain + minimumGainSplit;
+    if (gains[k] > minimumGain)
+    {
+      bestIndex = k;
+      bestGain = gains[k];
+    }
+
+    if (bestGain >= 0.0)
+      break;
+  }
+
+  if (bestIndex != candidates.size())
+  {
+    classProbabilities = std::move(splitInfo[bestIndex]);
+    if (datasetInfo != NULL && datasetInfo->Type(candidates[bestIndex]) ==
+        data::Datatype::categorical)
+    {
+      CategoricalAuxiliarySplitInfo::operator=(categoricalAux[bestIndex]);
+    }
+    else
+    {
+      NumericAuxiliarySplitInfo::operator=(numericAux[bestIndex]);
+    }
+  }
+
+  return bestIndex;
+}
+
+//! Evaluate each candidate dimension in its own task.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::EvaluateDimensions(
+    const MatType& data,
+    const arma::uvec& indices,
+    const size_t begin,
+    const size_t count,
+    const data::DatasetInfo* datasetInfo,
+    const std::vector<size_t>& candidates,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const arma::rowvec& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const double bestGain,
+    std::vector<double>& gains,
+    std::vector<arma::vec>& splitInfo,
+    std::vector<NumericAuxiliarySplitInfo>& numericAux,
+    std::vector<CategoricalAuxiliarySplitInfo>& categoricalAux)
+{
+#ifdef HAS_OPENMP
+  if (!InParallel())
+  {
+    // This is the first parallel node; create the threads that will work
+    // through the tasks of the rest of the tree.
+    #pragma omp parallel
+    {
+      #pragma omp single
+      EvaluateDimensions<UseWeights>(data, indices, begin, count, datasetInfo,
+          candidates, labels, numClasses, weights, minimumLeafSize,
+          minimumGainSplit, bestGain, gains, splitInfo, numericAux,
+          categoricalAux);
+    }
+    return;
+  }
+#endif
+
+  for (size_t k = 0; k < candidates.size(); ++k)
+  {
+    #pragma omp task default(shared) firstprivate(k)
+    {
+      const size_t dim = candidates[k];
+
+      // Gather the values of the points in this node for this dimension.
+      arma::Row<typename MatType::elem_type> dimValues(count);
+      for (size_t j = 0; j < count; ++j)
+        dimValues[j] = data(dim, indices[begin + j]);
+
+      if (datasetInfo != NULL &&
+          datasetInfo->Type(dim) == data::Datatype::categorical)
+      {
+        gains[k] = CategoricalSplit::template SplitIfBetter<UseWeights>(
+            bestGain,
+            dimValues,
+            datasetInfo->NumMappings(dim),
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            splitInfo[k],
+            categoricalAux[k]);
+      }
+      else if (datasetInfo == NULL ||
+          datasetInfo->Type(dim) == data::Datatype::numeric)
+      {
+        gains[k] = NumericSplit::template SplitIfBetter<UseWeights>(
+            bestGain,
+            dimValues,
+            labels.subvec(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            splitInfo[k],
+            numericAux[k]);
+      }
+    }
+  }
+
+  #pragma omp taskwait
+}
+
+//! Train the children of a node, possibly in parallel.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+template<bool UseWeights, typename MatType>
+void DecisionTree<FitnessFunction,
+                  NumericSplitType,
+                  CategoricalSplitType,
+                  DimensionSelectionType,
+                  ElemType,
+                  NoRecursion>::TrainChildren(
+    const MatType& data,
+    arma::uvec& indices,
+    const data::DatasetInfo* datasetInfo,
+    arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::rowvec& weights,
+    const std::vector<size_t>& childBegins,
+    const arma::Row<size_t>& childCounts,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const bool parallel,
+    std::vector<double>& childGains)
+{
+#ifdef HAS_OPENMP
+  if (parallel && !InParallel())
+  {
+    // This is the first parallel node; create the threads that will work
+    // through the tasks of the rest of the tree.
+    #pragma omp parallel
+    {
+      #pragma omp single
+      TrainChildren<UseWeights>(data, indices, datasetInfo, labels, numClasses,
+          weights, childBegins, childCounts, minimumLeafSize,
+          minimumGainSplit, parallel, childGains);
+    }
+    return;
+  }
+#endif
+
+  // The children hold disjoint ranges of indices, labels and weights, so they
+  // can be built at the same time.
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    // Without recursion, the children must be leaves.
+    const size_t childLeafSize = NoRecursion ? childCounts[i] :
+        minimumLeafSize;
+
+    #pragma omp task default(shared) firstprivate(i, childLeafSize) \
+        if(parallel)
+    {
+      if (datasetInfo != NULL)
+      {
+        childGains[i] = children[i]->template Train<UseWeights>(data, indices,
+            childBegins[i], childCounts[i], *datasetInfo, labels, numClasses,
+            weights, childLeafSize, minimumGainSplit);
+      }
+      else
+      {
+        childGains[i] = children[i]->template Train<UseWeights>(data, indices,
+            childBegins[i], childCounts[i], labels, numClasses, weights,
+            childLeafSize, minimumGainSplit);
+      }
+    }
+  }
+
+  #pragma omp taskwait
+}
+
 //! Return the class.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
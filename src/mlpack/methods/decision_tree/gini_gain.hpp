@@ -175,6 +175,35 @@ class GiniGain
     return -impurity;
   }
 
+  /**
+   * Evaluate the Gini impurity from the given per-class counts (or per-class
+   * sums of weights), instead of from a set of labels.  This is useful for
+   * splitters that accumulate class counts incrementally, such as
+   * HistogramNumericSplit.
+   *
+   * @param counts Pointer to the count (or weight) of each class.
+   * @param numClasses Number of classes in the dataset.
+   * @param totalCount Sum of all counts.
+   */
+  template<bool UseWeights, typename CountType>
+  static double EvaluatePtr(const CountType* counts,
+                            const size_t numClasses,
+                            const CountType totalCount)
+  {
+    // Corner case: if there are no elements, the impurity is zero.
+    if (totalCount == 0)
+      return 0.0;
+
+    double impurity = 0.0;
+    for (size_t i = 0; i < numClasses; ++i)
+    {
+      const double f = ((double) counts[i] / (double) totalCount);
+      impurity += f * (1.0 - f);
+    }
+
+    return -impurity;
+  }
+
   /**
    * Return the range of the Gini impurity for the given number of classes.
    * (That is, the difference between the maximum possible value and the minimum
@@ -0,0 +1,173 @@
+/**
+ * @file histogram_numeric_split_impl.hpp
+ *
+ * Implementation of strategy that finds the best binary numeric split on a
+ * histogram of the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "histogram_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::Col<typename VecType::elem_type>& classProbabilities,
+    AuxiliarySplitInfo<typename VecType::elem_type>& /* aux */)
+{
+  typedef typename VecType::elem_type ElemType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2) || data.n_elem == 0)
+    return bestGain;
+
+  // If every point has the same value, there is nothing to split.
+  const ElemType minValue = data.min();
+  const ElemType maxValue = data.max();
+  if (minValue == maxValue)
+    return bestGain;
+
+  // Count the points in each bin: the number of points, the count (or weight)
+  // of each class, and the smallest and largest value.
+  const size_t numBins = Bins;
+  const double scale = double(numBins) / (double(maxValue) - double(minValue));
+  arma::mat binCounts(numClasses, numBins, arma::fill::zeros);
+  arma::Col<size_t> binPoints(numBins, arma::fill::zeros);
+  arma::Col<ElemType> binMin(numBins);
+  arma::Col<ElemType> binMax(numBins);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const ElemType value = data[i];
+    const size_t bin = std::min((size_t) ((double(value) - double(minValue)) *
+        scale), numBins - 1);
+
+    binCounts(labels[i], bin) += UseWeights ? (double) weights[i] : 1.0;
+    if (binPoints[bin] == 0)
+    {
+      binMin[bin] = value;
+      binMax[bin] = value;
+    }
+    else
+    {
+      binMin[bin] = std::min(binMin[bin], value);
+      binMax[bin] = std::max(binMax[bin], value);
+    }
+    ++binPoints[bin];
+  }
+
+  // The counts of the whole node; the counts of the right child are the counts
+  // of the node minus the counts of the left child.
+  const arma::vec totalCounts = arma::sum(binCounts, 1);
+  const double totalWeight = arma::accu(totalCounts);
+  arma::vec leftCounts(numClasses, arma::fill::zeros);
+  arma::vec rightCounts(numClasses);
+  double leftWeight = 0.0;
+  size_t leftPoints = 0;
+
+  // Loop through the boundaries between non-empty bins, choosing the best one.
+  // Also, force a minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = bestGain;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  size_t bin = 0;
+  while (binPoints[bin] == 0)
+    ++bin;
+  while (bin < numBins)
+  {
+    // Find the next non-empty bin; the split point is between the two.
+    size_t next = bin + 1;
+    while (next < numBins && binPoints[next] == 0)
+      ++next;
+    if (next == numBins)
+      break;
+
+    leftCounts += binCounts.col(bin);
+    leftWeight += arma::accu(binCounts.col(bin));
+    leftPoints += binPoints[bin];
+
+    const size_t current = bin;
+    bin = next;
+    if (leftPoints < minimum)
+      continue;
+    if (data.n_elem - leftPoints < minimum)
+      break;
+
+    rightCounts = totalCounts - leftCounts;
+    const double rightWeight = totalWeight - leftWeight;
+
+    // Calculate the gain for the left and right child.
+    const double leftGain = FitnessFunction::template EvaluatePtr<UseWeights>(
+        leftCounts.memptr(), numClasses, leftWeight);
+    const double rightGain = FitnessFunction::template EvaluatePtr<UseWeights>(
+        rightCounts.memptr(), numClasses, rightWeight);
+
+    // Weight the gain of each child by its fraction of the points (or of the
+    // total weight).
+    double gain;
+    if (UseWeights)
+    {
+      gain = (leftWeight / totalWeight) * leftGain +
+          (rightWeight / totalWeight) * rightGain;
+    }
+    else
+    {
+      const double leftRatio = double(leftPoints) / double(data.n_elem);
+      const double rightRatio = 1.0 - leftRatio;
+
+      gain = leftRatio * leftGain + rightRatio * rightGain;
+    }
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just take
+      // this one.  The split value is halfway between the largest value of this
+      // bin and the smallest value of the next non-empty bin.
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[current] + binMin[next]) / 2.0;
+      return gain;
+    }
+    else if (gain > bestFoundGain + minimumGainSplit)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      classProbabilities.set_size(1);
+      classProbabilities[0] = (binMax[current] + binMin[next]) / 2.0;
+    }
+  }
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::Col<ElemType>& classProbabilities,
+    const AuxiliarySplitInfo<ElemType>& /* aux */)
+{
+  if (point <= classProbabilities[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
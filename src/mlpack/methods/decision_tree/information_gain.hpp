@@ -172,6 +172,36 @@ class InformationGain
     return gain;
   }
 
+  /**
+   * Calculate the information gain from the given per-class counts (or
+   * per-class sums of weights), instead of from a set of labels.  This is
+   * useful for splitters that accumulate class counts incrementally, such as
+   * HistogramNumericSplit.
+   *
+   * @param counts Pointer to the count (or weight) of each class.
+   * @param numClasses Number of classes in the dataset.
+   * @param totalCount Sum of all counts.
+   */
+  template<bool UseWeights, typename CountType>
+  static double EvaluatePtr(const CountType* counts,
+                            const size_t numClasses,
+                            const CountType totalCount)
+  {
+    // Edge case: if there are no elements, the gain is zero.
+    if (totalCount == 0)
+      return 0.0;
+
+    double gain = 0.0;
+    for (size_t i = 0; i < numClasses; ++i)
+    {
+      const double f = ((double) counts[i] / (double) totalCount);
+      if (f > 0.0)
+        gain += f * std::log2(f);
+    }
+
+    return gain;
+  }
+
   /**
    * Return the range of the information gain for the given number of classes.
    * (That is, the difference between the maximum possible value and the minimum
@@ -176,8 +176,10 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   const MatType cvData(dataset);
   const size_t testSize = dataset.n_cols / folds;
 
-  arma::vec regularizationConstants(prunedSequence.size());
-  regularizationConstants.fill(0.0);
+  // Each thread adds the regularization constants of its folds to its own
+  // column, so that no fold has to wait for another one to update the result.
+  arma::mat threadRegularizationConstants(prunedSequence.size(),
+      NumThreads(), arma::fill::zeros);
 
   Timer::Start("cross_validation");
   // Go through each fold.  On the Visual Studio compiler, we have to use
@@ -185,7 +187,7 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   // implementation. omp_size_t is the appropriate type according to the
   // platform.
   #pragma omp parallel for default(none) \
-      shared(prunedSequence, regularizationConstants)
+      shared(prunedSequence, threadRegularizationConstants)
   for (omp_size_t fold = 0; fold < (omp_size_t) folds; fold++)
   {
     // Break up data into train and test sets.
@@ -259,11 +261,14 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
       cvRegularizationConstants[prunedSequence.size() - 2] += 2.0 * cvVal
         / (double) cvData.n_cols;
 
-    #pragma omp critical(DTreeCVUpdate)
-    regularizationConstants += cvRegularizationConstants;
+    threadRegularizationConstants.col(ThreadNum()) +=
+        cvRegularizationConstants;
   }
   Timer::Stop("cross_validation");
 
+  const arma::vec regularizationConstants =
+      arma::sum(threadRegularizationConstants, 1);
+
   double optimalAlpha = -1.0;
   long double cvBestError = -std::numeric_limits<long double>::max();
 
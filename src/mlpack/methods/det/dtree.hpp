@@ -40,6 +40,12 @@ namespace det /** Density Estimation Trees */ {
  *   pages = {627--635}
  * }
  * @endcode
+ *
+ * When the tree is grown on a dense matrix, every dimension is sorted once at
+ * the root, and each split partitions the sorted dimensions stably, so that no
+ * node has to sort its points again; this takes O(d n) extra memory.  When
+ * OpenMP is enabled, nodes with many points search their dimensions and build
+ * their children as separate tasks.
  */
 template<typename MatType = arma::mat,
          typename TagType = int>
@@ -148,7 +154,9 @@ class DTree
 
   /**
    * Greedily expand the tree.  The points in the dataset will be reordered
-   * during tree growth.
+   * during tree growth.  If called inside of a parallel region (for instance,
+   * by the cross-validation of Trainer()), the tasks of large nodes are run by
+   * the threads of that region.
    *
    * @param data Dataset to build tree on.
    * @param oldFromNew Mappings from old points to new points.
@@ -332,17 +340,29 @@ class DTree
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  //! The values of each dimension of the points, in sorted order, with the
+  //! index of their column at the time they were sorted.
+  typedef std::vector<std::vector<std::pair<ElemType, size_t>>> SortedType;
+
+  //! Nodes with at least this many points are grown in parallel, if OpenMP is
+  //! enabled and more than one thread is available.
+  static const size_t parallelBuildThreshold = 10000;
+
   // Utility methods.
 
   /**
-   * Find the dimension to split on.
+   * Find the dimension to split on.  If sorted is given, the splits are taken
+   * from the presorted values of the points of this node instead of sorting
+   * them.  If parallel is true, the dimensions are searched as separate tasks.
    */
   bool FindSplit(const MatType& data,
                  size_t& splitDim,
                  ElemType& splitValue,
                  double& leftError,
                  double& rightError,
-                 const size_t minLeafSize = 5) const;
+                 const size_t minLeafSize = 5,
+                 const SortedType* sorted = NULL,
+                 const bool parallel = false) const;
 
   /**
    * Split the data, returning the number of points left of the split.
@@ -352,6 +372,36 @@ class DTree
                    const ElemType splitValue,
                    arma::Col<size_t>& oldFromNew) const;
 
+  /**
+   * Split the presorted values of the points of this node, so that the values
+   * of the points of each child are contiguous and still sorted.  The points
+   * that go left are the first splitIndex - start points of the split
+   * dimension.
+   *
+   * @param sorted Presorted values of the points.
+   * @param goesLeft Flag for each point, by its column when it was sorted.
+   * @param splitIndex Index of the first point of the right child.
+   * @param parallel If true, the dimensions are split as separate tasks.
+   */
+  void SplitSorted(SortedType& sorted,
+                   std::vector<char>& goesLeft,
+                   const size_t splitIndex,
+                   const bool parallel) const;
+
+  /**
+   * Greedily expand the tree, using the presorted values of the points if
+   * sorted is not NULL.  The children are built as separate tasks for large
+   * nodes; the caller must be inside of a parallel region for them to run in
+   * parallel.
+   */
+  double GrowNode(MatType& data,
+                  arma::Col<size_t>& oldFromNew,
+                  SortedType* sorted,
+                  std::vector<char>& goesLeft,
+                  const bool useVolReg,
+                  const size_t maxLeafSize,
+                  const size_t minLeafSize);
+
   void  FillMinMax(const StatType& mins,
                    const StatType& maxs);
 };
@@ -12,6 +12,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include "dtree.hpp"
+#include <algorithm>
 #include <stack>
 #include <vector>
 
@@ -147,6 +148,30 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
   }
 }
 
+// This one takes the splits from values that are already sorted, so it is the
+// same as the arma::Mat implementation without the copy and the sort.
+template<typename ElemType>
+void ExtractSortedSplits(
+    std::vector<std::pair<ElemType, size_t>>& splitVec,
+    const std::vector<std::pair<ElemType, size_t>>& sortedDim,
+    const size_t start,
+    const size_t end,
+    const size_t minLeafSize)
+{
+  typedef std::pair<ElemType, size_t> SplitItem;
+  const size_t points = end - start;
+
+  for (size_t i = minLeafSize - 1; i < points - minLeafSize; ++i)
+  {
+    const ElemType low = sortedDim[start + i].first;
+    const ElemType high = sortedDim[start + i + 1].first;
+    const ElemType split = (low + high) / 2.0;
+
+    if (split != low)
+      splitVec.push_back(SplitItem(split, i + 1));
+  }
+}
+
 } // namespace details
 
 template<typename MatType, typename TagType>
@@ -439,7 +464,9 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
                                         ElemType& splitValue,
                                         double& leftError,
                                         double& rightError,
-                                        const size_t minLeafSize) const
+                                        const size_t minLeafSize,
+                                        const SortedType* sorted,
+                                        const bool parallel) const
 {
   typedef std::pair<ElemType, size_t> SplitItem;
 
@@ -450,100 +477,131 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
 
   const size_t points = end - start;
 
-  double minError = logNegError;
-  bool splitFound = false;
+  // The best split of each dimension; because the dimensions may be searched
+  // in parallel, the best one is only picked once all of them are done.
+  arma::vec dimErrors(maxVals.n_elem);
+  dimErrors.fill(-std::numeric_limits<double>::infinity());
+  arma::vec dimLeftErrors(maxVals.n_elem);
+  arma::vec dimRightErrors(maxVals.n_elem);
+  arma::Col<ElemType> dimSplitValues(maxVals.n_elem);
 
   // Loop through each dimension.
-#ifdef _WIN32
-  #pragma omp parallel for default(shared)
-  for (intmax_t dim = 0; dim < (intmax_t) maxVals.n_elem; ++dim)
-#else
-  #pragma omp parallel for default(shared)
   for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
-#endif
   {
-    const ElemType min = minVals[dim];
-    const ElemType max = maxVals[dim];
-
-    // If there is nothing to split in this dimension, move on.
-    if (max - min == 0.0)
-      continue; // Skip to next dimension.
-
-    // Find the log volume of all the other dimensions.
-    const double volumeWithoutDim = logVolume - std::log(max - min);
-
-    // Initializing all other stuff for this dimension.
-    bool dimSplitFound = false;
-    // Take an error estimate for this dimension.
-    double minDimError = std::pow(points, 2.0) / (max - min);
-    double dimLeftError = 0.0; // For -Wuninitialized.  These variables will
-    double dimRightError = 0.0; // always be set to something else before use.
-    ElemType dimSplitValue = 0.0;
-
-    // Get the values for splitting. The old implementation:
-    //   dimVec = data.row(dim).subvec(start, end - 1);
-    //   dimVec = arma::sort(dimVec);
-    // could be quite inefficient for sparse matrices, due to
-    // copy operations (3). This one has custom implementation for dense and
-    // sparse matrices.
-
-    std::vector<SplitItem> splitVec;
-    details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
-        minLeafSize);
-
-    // Iterate on all the splits for this dimension
-    for (typename std::vector<SplitItem>::iterator i = splitVec.begin();
-         i != splitVec.end();
-         ++i)
+    #pragma omp task default(shared) firstprivate(dim) if(parallel)
     {
-      const ElemType split = i->first;
-      const size_t position = i->second;
+      const ElemType min = minVals[dim];
+      const ElemType max = maxVals[dim];
 
-      // Another way of picking split is using this:
-      //   split = leftsplit;
-      if ((split - min > 0.0) && (max - split > 0.0))
+      // If there is nothing to split in this dimension, there is nothing to
+      // search.
+      if (max - min > 0.0)
       {
-        // Ensure that the right node will have at least the minimum number of
-        // points.
-        Log::Assert((points - position) >= minLeafSize);
-
-        // Now we have to see if the error will be reduced.  Simple manipulation
-        // of the error function gives us the condition we must satisfy:
-        //   |t_l|^2 / V_l + |t_r|^2 / V_r  >= |t|^2 / (V_l + V_r)
-        // and because the volume is only dependent on the dimension we are
-        // splitting, we can assume V_l is just the range of the left and V_r is
-        // just the range of the right.
-        double negLeftError = std::pow(position, 2.0) / (split - min);
-        double negRightError = std::pow(points - position, 2.0) / (max - split);
-
-        // If this is better, take it.
-        if ((negLeftError + negRightError) >= minDimError)
+        // Find the log volume of all the other dimensions.
+        const double volumeWithoutDim = logVolume - std::log(max - min);
+
+        // Initializing all other stuff for this dimension.
+        bool dimSplitFound = false;
+        // Take an error estimate for this dimension.
+        double minDimError = std::pow(points, 2.0) / (max - min);
+        // For -Wuninitialized.  These variables will always be set to
+        // something else before use.
+        double dimLeftError = 0.0;
+        double dimRightError = 0.0;
+        ElemType dimSplitValue = 0.0;
+
+        // Get the values for splitting. The old implementation:
+        //   dimVec = data.row(dim).subvec(start, end - 1);
+        //   dimVec = arma::sort(dimVec);
+        // could be quite inefficient for sparse matrices, due to copy
+        // operations (3). This one has custom implementation for dense and
+        // sparse matrices.  With presorted values, the points of this node
+        // are already sorted.
+        std::vector<SplitItem> splitVec;
+        if (sorted)
+        {
+          details::ExtractSortedSplits<ElemType>(splitVec, (*sorted)[dim],
+              start, end, minLeafSize);
+        }
+        else
+        {
+          details::ExtractSplits<ElemType>(splitVec, data, dim, start, end,
+              minLeafSize);
+        }
+
+        // Iterate on all the splits for this dimension
+        for (typename std::vector<SplitItem>::iterator i = splitVec.begin();
+             i != splitVec.end();
+             ++i)
         {
-          minDimError = negLeftError + negRightError;
-          dimLeftError = negLeftError;
-          dimRightError = negRightError;
-          dimSplitValue = split;
-          dimSplitFound = true;
+          const ElemType split = i->first;
+          const size_t position = i->second;
+
+          // Another way of picking split is using this:
+          //   split = leftsplit;
+          if ((split - min > 0.0) && (max - split > 0.0))
+          {
+            // Ensure that the right node will have at least the minimum number
+            // of points.
+            Log::Assert((points - position) >= minLeafSize);
+
+            // Now we have to see if the error will be reduced.  Simple
+            // manipulation of the error function gives us the condition we
+            // must satisfy:
+            //   |t_l|^2 / V_l + |t_r|^2 / V_r  >= |t|^2 / (V_l + V_r)
+            // and because the volume is only dependent on the dimension we
+            // are splitting, we can assume V_l is just the range of the left
+            // and V_r is just the range of the right.
+            double negLeftError = std::pow(position, 2.0) / (split - min);
+            double negRightError = std::pow(points - position, 2.0) /
+                (max - split);
+
+            // If this is better, take it.
+            if ((negLeftError + negRightError) >= minDimError)
+            {
+              minDimError = negLeftError + negRightError;
+              dimLeftError = negLeftError;
+              dimRightError = negRightError;
+              dimSplitValue = split;
+              dimSplitFound = true;
+            }
+          }
+        }
+
+        if (dimSplitFound)
+        {
+          // Calculate actual error (in logspace) by adding terms back to our
+          // estimate.
+          dimErrors[dim] = std::log(minDimError)
+            - 2 * std::log((double) data.n_cols)
+            - volumeWithoutDim;
+          dimSplitValues[dim] = dimSplitValue;
+          dimLeftErrors[dim] = std::log(dimLeftError)
+            - 2 * std::log((double) data.n_cols)
+            - volumeWithoutDim;
+          dimRightErrors[dim] = std::log(dimRightError)
+            - 2 * std::log((double) data.n_cols)
+            - volumeWithoutDim;
         }
       }
     }
+  }
 
-    const double actualMinDimError = std::log(minDimError)
-      - 2 * std::log((double) data.n_cols)
-      - volumeWithoutDim;
+  #pragma omp taskwait
 
-#pragma omp critical(DTreeFindUpdate)
-    if ((actualMinDimError > minError) && dimSplitFound)
+  // Take the best dimension, in order, so that the split does not depend on
+  // the number of threads.
+  double minError = logNegError;
+  bool splitFound = false;
+  for (size_t dim = 0; dim < maxVals.n_elem; ++dim)
+  {
+    if (dimErrors[dim] > minError)
     {
-      // Calculate actual error (in logspace) by adding terms back to our
-      // estimate.
-      minError = actualMinDimError;
+      minError = dimErrors[dim];
       splitDim = dim;
-      splitValue = dimSplitValue;
-      leftError = std::log(dimLeftError) - 2 * std::log((double) data.n_cols)
-        - volumeWithoutDim;
-      rightError = std::log(dimRightError) - 2 * std::log((double) data.n_cols)
-        - volumeWithoutDim;
+      splitValue = dimSplitValues[dim];
+      leftError = dimLeftErrors[dim];
+      rightError = dimRightErrors[dim];
       splitFound = true;
     } // end if better split found in this dimension.
   }
@@ -585,6 +643,40 @@ size_t DTree<MatType, TagType>::SplitData(MatType& data,
   return left;
 }
 
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::SplitSorted(SortedType& sorted,
+                                          std::vector<char>& goesLeft,
+                                          const size_t splitIndex,
+                                          const bool parallel) const
+{
+  typedef std::pair<ElemType, size_t> SortedItem;
+
+  // The points of the split dimension are already in the order of the
+  // children, so they tell which points go left.
+  const std::vector<SortedItem>& splitSorted = sorted[splitDim];
+  Log::Assert(splitSorted[splitIndex - 1].first <= splitValue);
+  Log::Assert(splitSorted[splitIndex].first > splitValue);
+  for (size_t i = start; i < end; ++i)
+    goesLeft[splitSorted[i].second] = (i < splitIndex);
+
+  // A stable partition of the other dimensions keeps the values of each child
+  // sorted.
+  for (size_t dim = 0; dim < sorted.size(); ++dim)
+  {
+    if (dim == splitDim)
+      continue;
+
+    #pragma omp task default(shared) firstprivate(dim) if(parallel)
+    std::stable_partition(sorted[dim].begin() + start,
+        sorted[dim].begin() + end, [&goesLeft](const SortedItem& item)
+        {
+          return goesLeft[item.second] != 0;
+        });
+  }
+
+  #pragma omp taskwait
+}
+
 // Greedily expand the tree.
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::Grow(MatType& data,
@@ -596,8 +688,71 @@ double DTree<MatType, TagType>::Grow(MatType& data,
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
 
+  // Sort each dimension of the points once; every split then keeps the values
+  // of each child sorted.  Sparse matrices only need to sort their nonzero
+  // values, so they are not presorted.
+  SortedType sorted;
+  std::vector<char> goesLeft;
+  if (!arma::is_SpMat<MatType>::value)
+  {
+    sorted.resize(data.n_rows);
+    goesLeft.resize(data.n_cols);
+
+    #pragma omp parallel for
+    for (omp_size_t dim = 0; dim < (omp_size_t) data.n_rows; ++dim)
+    {
+      sorted[dim].resize(data.n_cols);
+      for (size_t i = start; i < end; ++i)
+      {
+        sorted[dim][i] = std::pair<ElemType, size_t>((ElemType) data(dim, i),
+            i);
+      }
+
+      std::sort(sorted[dim].begin() + start, sorted[dim].begin() + end);
+    }
+  }
+
+  SortedType* sortedPtr = sorted.empty() ? NULL : &sorted;
+
+#ifdef HAS_OPENMP
+  if (!InParallel() && (end - start >= parallelBuildThreshold) &&
+      (NumThreads() > 1))
+  {
+    // This is the first parallel node; create the threads that will work
+    // through the tasks of the rest of the tree.
+    double g = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      g = GrowNode(data, oldFromNew, sortedPtr, goesLeft, useVolReg,
+          maxLeafSize, minLeafSize);
+    }
+    return g;
+  }
+#endif
+
+  return GrowNode(data, oldFromNew, sortedPtr, goesLeft, useVolReg,
+      maxLeafSize, minLeafSize);
+}
+
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::GrowNode(MatType& data,
+                                         arma::Col<size_t>& oldFromNew,
+                                         SortedType* sorted,
+                                         std::vector<char>& goesLeft,
+                                         const bool useVolReg,
+                                         const size_t maxLeafSize,
+                                         const size_t minLeafSize)
+{
   double leftG, rightG;
 
+  // Large nodes search their dimensions and grow their children in parallel.
+  // The columns of a sparse matrix cannot be swapped concurrently, so its
+  // children are always grown one after the other.
+  const bool parallel = (end - start >= parallelBuildThreshold) &&
+      (NumThreads() > 1);
+  const bool parallelChildren = parallel && !arma::is_SpMat<MatType>::value;
+
   // Compute points ratio.
   ratio = (double) (end - start) / (double) oldFromNew.n_elem;
 
@@ -614,7 +769,8 @@ double DTree<MatType, TagType>::Grow(MatType& data,
     size_t dim;
     double splitValueTmp;
     double leftError, rightError;
-    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize))
+    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize,
+        sorted, parallel))
     {
       // Move the data around for the children to have points in a node lie
       // contiguously (to increase efficiency during the training).
@@ -633,14 +789,22 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       splitValue = splitValueTmp;
       splitDim = dim;
 
-      // Recursively grow the children.
+      if (sorted)
+        SplitSorted(*sorted, goesLeft, splitIndex, parallel);
+
+      // Recursively grow the children.  They hold disjoint ranges of the
+      // points, so they can be grown at the same time.
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
-      leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                         minLeafSize);
-      rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                           minLeafSize);
+      #pragma omp task default(shared) if(parallelChildren)
+      leftG = left->GrowNode(data, oldFromNew, sorted, goesLeft, useVolReg,
+          maxLeafSize, minLeafSize);
+      #pragma omp task default(shared) if(parallelChildren)
+      rightG = right->GrowNode(data, oldFromNew, sorted, goesLeft, useVolReg,
+          maxLeafSize, minLeafSize);
+
+      #pragma omp taskwait
 
       // Store values of R(T~) and |T~|.
       subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
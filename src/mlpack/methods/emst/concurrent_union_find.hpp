@@ -0,0 +1,99 @@
+/**
+ * @file concurrent_union_find.hpp
+ *
+ * Implements a union-find data structure that can be used by multiple threads
+ * at once.  Each point in the graph is initially in its own component.
+ * Calling unionfind.Union(x, y) unites the components indexed by x and y.
+ * unionfind.Find(x) returns the index of the component containing point x.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace emst {
+
+/**
+ * A lock-free Union-Find data structure, whose Find() and Union() can be called
+ * concurrently from multiple threads.  The parent of each element is updated
+ * with compare-and-swap: Find() uses path halving, and Union() links the root
+ * with the larger index below the root with the smaller index.  The index of
+ * each component is therefore the smallest element in it, no matter in which
+ * order the unions are done.
+ */
+class ConcurrentUnionFind
+{
+ private:
+  std::vector<std::atomic<size_t>> parent;
+
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the component containing an element.  If no Union() happens
+   * concurrently, this is the smallest element of the component.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t p = parent[x].load();
+      if (p == x)
+        return x;
+
+      // Make x point to its grandparent.  If this fails, another thread has
+      // changed the parent of x; the grandparent is still an ancestor of x.
+      const size_t grandparent = parent[p].load();
+      if (grandparent != p)
+        parent[x].compare_exchange_weak(p, grandparent);
+
+      x = grandparent;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.
+   *
+   * @param x one component
+   * @param y the other component
+   * @return true if the components were different (and have been united).
+   */
+  bool Union(size_t x, size_t y)
+  {
+    while (true)
+    {
+      x = Find(x);
+      y = Find(y);
+      if (x == y)
+        return false;
+
+      if (x < y)
+        std::swap(x, y);
+
+      // The link only succeeds if x is still a root; otherwise, try again.
+      size_t expected = x;
+      if (parent[x].compare_exchange_strong(expected, y))
+        return true;
+    }
+  }
+}; // class ConcurrentUnionFind
+
+} // namespace emst
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
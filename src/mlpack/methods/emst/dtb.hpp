@@ -27,11 +27,13 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <atomic>
 
 namespace mlpack {
 namespace emst /** Euclidean Minimum Spanning Trees. */ {
@@ -68,6 +70,13 @@ namespace emst /** Euclidean Minimum Spanning Trees. */ {
  * More advanced usage of the class can use different types of trees, pass in an
  * already-built tree, or compute the MST using the O(n^2) naive algorithm.
  *
+ * When OpenMP is available, the search for the shortest edge out of each
+ * component in each round is split over the threads: binary trees are split
+ * into disjoint query subtrees that are traversed concurrently, and the naive
+ * computation is split into blocks of query points.  The edges are then joined
+ * serially between rounds, so the results do not depend on the number of
+ * threads.
+ *
  * @tparam MetricType The metric to use.
  * @tparam MatType The type of data matrix to use.
  * @tparam TreeType Type of tree to use.  This should follow the TreeType policy
@@ -103,14 +112,17 @@ class DualTreeBoruvka
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
   //! Connections.
-  UnionFind connections;
-
-  //! List of edge nodes.
-  arma::Col<size_t> neighborsInComponent;
-  //! List of edge nodes.
-  arma::Col<size_t> neighborsOutComponent;
-  //! List of edge distances.
-  arma::vec neighborsDistances;
+  ConcurrentUnionFind connections;
+
+  //! Distance of the candidate edge of each point.
+  arma::vec pointDistances;
+  //! The other endpoint of the candidate edge of each point.
+  arma::Col<size_t> pointNeighbors;
+  //! Distance of the candidate edge of each component.
+  std::vector<std::atomic<double>> componentDistances;
+  //! The point of each component whose candidate edge is the candidate edge of
+  //! the component.
+  std::vector<std::atomic<size_t>> componentPoints;
 
   //! Total distance of the tree.
   double totalDist;
@@ -202,6 +214,11 @@ class DualTreeBoruvka
    * The values stored in the tree must be reset on each iteration.
    */
   void Cleanup();
+
+  /**
+   * Reset the candidate edges of the points and components.
+   */
+  void ResetCandidates();
 }; // class DualTreeBoruvka
 
 } // namespace emst
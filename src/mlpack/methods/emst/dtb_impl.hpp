@@ -14,6 +14,9 @@
 
 #include "dtb_rules.hpp"
 
+#include <mlpack/core/tree/query_subtrees.hpp>
+#include <mlpack/core/tree/tree_cache.hpp>
+
 namespace mlpack {
 namespace emst {
 
@@ -25,7 +28,8 @@ TreeType* BuildTree(
     const typename std::enable_if<
         tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
 {
-  return new TreeType(std::forward<MatType>(dataset), oldFromNew);
+  return tree::TreeCache::BuildTree<TreeType>(std::forward<MatType>(dataset),
+      oldFromNew);
 }
 
 //! Call the tree constructor that does not do mapping.
@@ -58,15 +62,16 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(!naive),
     naive(naive),
     connections(dataset.n_cols),
+    pointDistances(dataset.n_cols),
+    pointNeighbors(dataset.n_cols),
+    componentDistances(dataset.n_cols),
+    componentPoints(dataset.n_cols),
     totalDist(0.0),
     metric(metric)
 {
   edges.reserve(data.n_cols - 1); // Set size.
 
-  neighborsInComponent.set_size(data.n_cols);
-  neighborsOutComponent.set_size(data.n_cols);
-  neighborsDistances.set_size(data.n_cols);
-  neighborsDistances.fill(DBL_MAX);
+  ResetCandidates();
 }
 
 template<
@@ -83,15 +88,16 @@ DualTreeBoruvka<MetricType, MatType, TreeType>::DualTreeBoruvka(
     ownTree(false),
     naive(false),
     connections(data.n_cols),
+    pointDistances(data.n_cols),
+    pointNeighbors(data.n_cols),
+    componentDistances(data.n_cols),
+    componentPoints(data.n_cols),
     totalDist(0.0),
     metric(metric)
 {
   edges.reserve(data.n_cols - 1); // Fill with EdgePairs.
 
-  neighborsInComponent.set_size(data.n_cols);
-  neighborsOutComponent.set_size(data.n_cols);
-  neighborsDistances.set_size(data.n_cols);
-  neighborsDistances.fill(DBL_MAX);
+  ResetCandidates();
 }
 
 template<
@@ -124,23 +130,66 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
   totalDist = 0; // Reset distance.
 
   typedef DTBRules<MetricType, Tree> RuleType;
-  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
-                 neighborsOutComponent, metric);
-  while (edges.size() < (data.n_cols - 1))
+
+  // Each round, the query points are split over the threads.  Each set of
+  // rules only writes the candidate edges of its own query points, and the
+  // candidate edge distances of the components, which are used for pruning,
+  // are only ever lowered atomically.  No components are joined during the
+  // search, so finding the component of a point is safe from any thread.
+  const size_t numThreads = NumThreads();
+  std::vector<Tree*> subtrees;
+  std::vector<std::pair<size_t, size_t>> ranges;
+  if (naive)
   {
-    if (naive)
+    const size_t numBlocks = std::min((size_t) data.n_cols,
+        (numThreads > 1) ? 4 * numThreads : 1);
+    for (size_t b = 0; b < numBlocks; ++b)
     {
-      // Full O(N^2) traversal.
-      for (size_t i = 0; i < data.n_cols; ++i)
-        for (size_t j = 0; j < data.n_cols; ++j)
-          rules.BaseCase(i, j);
+      const size_t begin = b * data.n_cols / numBlocks;
+      const size_t end = (b + 1) * data.n_cols / numBlocks;
+      ranges.push_back(std::make_pair(begin, end - begin));
     }
-    else
+  }
+  else
+  {
+    tree::GetQuerySubtrees(*tree, (numThreads > 1) ? 4 * numThreads : 1,
+        subtrees, ranges);
+  }
+
+  size_t totalBaseCases = 0;
+  size_t totalScores = 0;
+  while (edges.size() < (data.n_cols - 1))
+  {
+    size_t baseCases = 0;
+    size_t scores = 0;
+
+    #pragma omp parallel for schedule(dynamic) reduction(+:baseCases, scores)
+    for (omp_size_t i = 0; i < (omp_size_t) ranges.size(); ++i)
     {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      RuleType rules(data, connections, pointDistances, pointNeighbors,
+          componentDistances, metric);
+      if (naive)
+      {
+        // Full O(N^2) traversal for this block of query points.
+        const size_t begin = ranges[i].first;
+        const size_t end = begin + ranges[i].second;
+        for (size_t q = begin; q < end; ++q)
+          for (size_t r = 0; r < data.n_cols; ++r)
+            rules.BaseCase(q, r);
+      }
+      else
+      {
+        typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+        traverser.Traverse(*subtrees[i], *tree);
+      }
+
+      baseCases += rules.BaseCases();
+      scores += rules.Scores();
     }
 
+    totalBaseCases += baseCases;
+    totalScores += scores;
+
     AddAllEdges();
 
     Cleanup();
@@ -148,8 +197,8 @@ void DualTreeBoruvka<MetricType, MatType, TreeType>::ComputeMST(
     Log::Info << edges.size() << " edges found so far." << std::endl;
     if (!naive)
     {
-      Log::Info << rules.BaseCases() << " cumulative base cases." << std::endl;
-      Log::Info << rules.Scores() << " cumulative node combinations scored."
+      Log::Info << totalBaseCases << " cumulative base cases." << std::endl;
+      Log::Info << totalScores << " cumulative node combinations scored."
           << std::endl;
     }
   }
@@ -195,18 +244,45 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::AddAllEdges()
 {
-  for (size_t i = 0; i < data.n_cols; i++)
+  const size_t n = data.n_cols;
+
+  // Find the point of each component whose candidate edge is the candidate
+  // edge of the component.  If several points have it, the one with the
+  // smallest index is taken, so that the edges do not depend on the number of
+  // threads.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    const size_t component = connections.Find(i);
+    if (pointDistances[i] == DBL_MAX || pointDistances[i] !=
+        componentDistances[component].load(std::memory_order_relaxed))
+      continue;
+
+    std::atomic<size_t>& componentPoint = componentPoints[component];
+    size_t current = componentPoint.load(std::memory_order_relaxed);
+    while ((size_t) i < current &&
+        !componentPoint.compare_exchange_weak(current, (size_t) i))
+    {
+      // current now holds the value set by another thread; try again.
+    }
+  }
+
+  // Join the components.  Two components may have found the same edge, which
+  // is then only added once.
+  for (size_t component = 0; component < n; ++component)
   {
-    size_t component = connections.Find(i);
-    size_t inEdge = neighborsInComponent[component];
-    size_t outEdge = neighborsOutComponent[component];
-    if (connections.Find(inEdge) != connections.Find(outEdge))
+    const size_t inEdge =
+        componentPoints[component].load(std::memory_order_relaxed);
+    if (inEdge == n)
+      continue;
+
+    const size_t outEdge = pointNeighbors[inEdge];
+    if (connections.Union(inEdge, outEdge))
     {
       // totalDist = totalDist + dist;
       // changed to make this agree with the cover tree code
-      totalDist += neighborsDistances[component];
-      AddEdge(inEdge, outEdge, neighborsDistances[component]);
-      connections.Union(inEdge, outEdge);
+      totalDist += pointDistances[inEdge];
+      AddEdge(inEdge, outEdge, pointDistances[inEdge]);
     }
   }
 }
@@ -318,13 +394,35 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<MetricType, MatType, TreeType>::Cleanup()
 {
-  for (size_t i = 0; i < data.n_cols; i++)
-    neighborsDistances[i] = DBL_MAX;
+  ResetCandidates();
 
   if (!naive)
     CleanupHelper(tree);
 }
 
+/**
+ * Reset the candidate edges of the points and components.
+ */
+template<
+    typename MetricType,
+    typename MatType,
+    template<typename TreeMetricType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<MetricType, MatType, TreeType>::ResetCandidates()
+{
+  const size_t n = data.n_cols;
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    pointDistances[i] = DBL_MAX;
+    pointNeighbors[i] = n;
+    componentDistances[i].store(DBL_MAX, std::memory_order_relaxed);
+    componentPoints[i].store(n, std::memory_order_relaxed);
+  }
+}
+
 } // namespace emst
 } // namespace mlpack
 
@@ -15,19 +15,44 @@
 #include <mlpack/prereqs.hpp>
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <atomic>
+
+#include "concurrent_union_find.hpp"
 
 namespace mlpack {
 namespace emst {
 
+/**
+ * The rules of one round of the dual-tree Boruvka algorithm, which finds the
+ * shortest edge from each component to another component.
+ *
+ * Several sets of rules can be used at once from different threads, as long as
+ * each query point is only handled by one of them.  The candidate edge of each
+ * query point is only written by the rules that handle it, and the candidate
+ * edge distance of each component, which is used for pruning, is shared and
+ * lowered with compare-and-swap.
+ */
 template<typename MetricType, typename TreeType>
 class DTBRules
 {
  public:
+  /**
+   * Construct the rules.
+   *
+   * @param dataSet The data points.
+   * @param connections The components found so far.
+   * @param pointDistances Distance of the candidate edge of each point.
+   * @param pointNeighbors Point of another component at the other end of the
+   *     candidate edge of each point.
+   * @param componentDistances Distance of the candidate edge of each
+   *     component, indexed by the component index.
+   * @param metric The instantiated metric.
+   */
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
-           arma::vec& neighborsDistances,
-           arma::Col<size_t>& neighborsInComponent,
-           arma::Col<size_t>& neighborsOutComponent,
+           ConcurrentUnionFind& connections,
+           arma::vec& pointDistances,
+           arma::Col<size_t>& pointNeighbors,
+           std::vector<std::atomic<double>>& componentDistances,
            MetricType& metric);
 
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
@@ -102,18 +127,17 @@ class DTBRules
   const arma::mat& dataSet;
 
   //! Stores the tree structure so far
-  UnionFind& connections;
+  ConcurrentUnionFind& connections;
 
-  //! The distance to the candidate nearest neighbor for each component.
-  arma::vec& neighborsDistances;
+  //! The distance to the candidate nearest neighbor in another component for
+  //! each point.
+  arma::vec& pointDistances;
 
-  //! The index of the point in the component that is an endpoint of the
-  //! candidate edge.
-  arma::Col<size_t>& neighborsInComponent;
+  //! The candidate nearest neighbor in another component for each point.
+  arma::Col<size_t>& pointNeighbors;
 
-  //! The index of the point outside of the component that is an endpoint
-  //! of the candidate edge.
-  arma::Col<size_t>& neighborsOutComponent;
+  //! The distance to the candidate nearest neighbor for each component.
+  std::vector<std::atomic<double>>& componentDistances;
 
   //! The instantiated metric.
   MetricType& metric;
@@ -123,6 +147,16 @@ class DTBRules
    */
   inline double CalculateBound(TreeType& queryNode) const;
 
+  //! Get the candidate edge distance of the given component.
+  double ComponentDistance(const size_t component) const
+  {
+    return componentDistances[component].load(std::memory_order_relaxed);
+  }
+
+  //! Lower the candidate edge distance of the given component to the given
+  //! distance, if it is smaller.
+  void UpdateComponentDistance(const size_t component, const double distance);
+
   TraversalInfoType traversalInfo;
 
   //! The number of base cases calculated.
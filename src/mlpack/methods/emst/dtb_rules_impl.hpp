@@ -18,17 +18,17 @@ namespace emst {
 template<typename MetricType, typename TreeType>
 DTBRules<MetricType, TreeType>::
 DTBRules(const arma::mat& dataSet,
-         UnionFind& connections,
-         arma::vec& neighborsDistances,
-         arma::Col<size_t>& neighborsInComponent,
-         arma::Col<size_t>& neighborsOutComponent,
+         ConcurrentUnionFind& connections,
+         arma::vec& pointDistances,
+         arma::Col<size_t>& pointNeighbors,
+         std::vector<std::atomic<double>>& componentDistances,
          MetricType& metric)
 :
   dataSet(dataSet),
   connections(connections),
-  neighborsDistances(neighborsDistances),
-  neighborsInComponent(neighborsInComponent),
-  neighborsOutComponent(neighborsOutComponent),
+  pointDistances(pointDistances),
+  pointNeighbors(pointNeighbors),
+  componentDistances(componentDistances),
   metric(metric),
   baseCases(0),
   scores(0)
@@ -44,7 +44,6 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
   // Check if the points are in the same component at this iteration.
   // If not, return the distance between them.  Also, store a better result as
   // the current neighbor, if necessary.
-  double newUpperBound = -1.0;
 
   // Find the index of the component the query is in.
   size_t queryComponentIndex = connections.Find(queryIndex);
@@ -57,18 +56,21 @@ double DTBRules<MetricType, TreeType>::BaseCase(const size_t queryIndex,
     double distance = metric.Evaluate(dataSet.col(queryIndex),
                                       dataSet.col(referenceIndex));
 
-    if (distance < neighborsDistances[queryComponentIndex])
+    // Ties are broken by the smallest reference index, so that the candidate
+    // edge does not depend on the order of the base cases.
+    if (distance < pointDistances[queryIndex] ||
+        (distance == pointDistances[queryIndex] &&
+         referenceIndex < pointNeighbors[queryIndex]))
     {
       Log::Assert(queryIndex != referenceIndex);
 
-      neighborsDistances[queryComponentIndex] = distance;
-      neighborsInComponent[queryComponentIndex] = queryIndex;
-      neighborsOutComponent[queryComponentIndex] = referenceIndex;
+      pointDistances[queryIndex] = distance;
+      pointNeighbors[queryIndex] = referenceIndex;
+      UpdateComponentDistance(queryComponentIndex, distance);
     }
   }
 
-  if (newUpperBound < neighborsDistances[queryComponentIndex])
-    newUpperBound = neighborsDistances[queryComponentIndex];
+  const double newUpperBound = ComponentDistance(queryComponentIndex);
 
   Log::Assert(newUpperBound >= 0.0);
 
@@ -93,7 +95,7 @@ double DTBRules<MetricType, TreeType>::Score(const size_t queryIndex,
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for the query's component, we prune.
-  return neighborsDistances[queryComponentIndex] < distance
+  return ComponentDistance(queryComponentIndex) < distance
       ? DBL_MAX : distance;
 }
 
@@ -104,7 +106,7 @@ double DTBRules<MetricType, TreeType>::Rescore(const size_t queryIndex,
 {
   // We don't need to check component membership again, because it can't
   // change inside a single iteration.
-  return (oldScore > neighborsDistances[connections.Find(queryIndex)])
+  return (oldScore > ComponentDistance(connections.Find(queryIndex)))
       ? DBL_MAX : oldScore;
 }
 
@@ -153,7 +155,7 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
     const size_t pointComponent = connections.Find(queryNode.Point(i));
-    const double bound = neighborsDistances[pointComponent];
+    const double bound = ComponentDistance(pointComponent);
 
     if (bound > worstPointBound)
       worstPointBound = bound;
@@ -188,6 +190,20 @@ inline double DTBRules<MetricType, TreeType>::CalculateBound(
   return queryNode.Stat().Bound();
 }
 
+template<typename MetricType, typename TreeType>
+inline void DTBRules<MetricType, TreeType>::UpdateComponentDistance(
+    const size_t component,
+    const double distance)
+{
+  std::atomic<double>& componentDistance = componentDistances[component];
+  double current = componentDistance.load(std::memory_order_relaxed);
+  while (distance < current &&
+      !componentDistance.compare_exchange_weak(current, distance))
+  {
+    // current now holds the value set by another thread; try again.
+  }
+}
+
 } // namespace emst
 } // namespace mlpack
 
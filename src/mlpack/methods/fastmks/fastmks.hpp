@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/ip_metric.hpp>
+#include <mlpack/core/kernels/batch_kernels.hpp>
 #include "fastmks_stat.hpp"
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <queue>
@@ -285,6 +286,60 @@ class FastMKS
   //! Use a priority queue to represent the list of candidate points.
   typedef std::priority_queue<Candidate, std::vector<Candidate>,
       CandidateCmp> CandidateList;
+
+  /**
+   * Find the k points of the reference set with maximum kernel value to each
+   * query point by brute force, evaluating the kernel one pair of points at a
+   * time.  The query points are searched in parallel.
+   *
+   * @param querySet Set of query points.
+   * @param k The number of maximum kernels to find.
+   * @param sameSet If true, the query set is the reference set, and a point is
+   *     not returned as its own result.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   */
+  template<typename Kernel = KernelType>
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   const bool sameSet,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const typename std::enable_if_t<
+                       !kernel::SupportsBatchKernels<Kernel, MatType>::value>* =
+                       0);
+
+  /**
+   * Find the k points of the reference set with maximum kernel value to each
+   * query point by brute force, evaluating the kernel between a block of query
+   * points and a block of reference points with one matrix multiplication at a
+   * time.  The blocks of query points are searched in parallel.
+   */
+  template<typename Kernel = KernelType>
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   const bool sameSet,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const typename std::enable_if_t<
+                       kernel::SupportsBatchKernels<Kernel, MatType>::value>* =
+                       0);
+
+  /**
+   * Run single-tree search for each query point.  If the first point of each
+   * node of the tree is its centroid (as for cover trees), the traversal does
+   * not modify the reference tree, so ranges of query points are searched in
+   * parallel, each with its own rules.
+   *
+   * @param querySet Set of query points.
+   * @param k The number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   */
+  void SingleTreeSearch(const MatType& querySet,
+                        const size_t k,
+                        arma::Mat<size_t>& indices,
+                        arma::mat& kernels);
 };
 
 } // namespace fastmks
@@ -304,69 +304,84 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = metric.Kernel().Evaluate(querySet.col(q),
-                                                     referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; j++)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
+    NaiveSearch(querySet, k, false, indices, kernels);
 
     Timer::Stop("computing_products");
-
     return;
   }
 
   // Single-tree implementation.
   if (singleMode)
   {
-    // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
-    typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, querySet, k, metric.Kernel());
+    SingleTreeSearch(querySet, k, indices, kernels);
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
-
-    rules.GetResults(indices, kernels);
+    Timer::Stop("computing_products");
+    return;
+  }
 
+  // Dual-tree implementation.  With several threads, the query set is split
+  // into one block per thread (as long as the blocks are not too small), and a
+  // query tree is built on each block.  The blocks are then searched in
+  // parallel, each with its own rules; the reference tree is not modified by
+  // the dual-tree traversal.  We are assuming the trees don't map anything...
+  const size_t numBlocks = std::max((size_t) 1, std::min(NumThreads(),
+      (size_t) querySet.n_cols / 1000));
+  if (numBlocks == 1)
+  {
     Timer::Stop("computing_products");
+    Timer::Start("tree_building");
+    Tree queryTree(querySet);
+    Timer::Stop("tree_building");
+
+    Search(&queryTree, k, indices, kernels);
     return;
   }
 
-  // Dual-tree implementation.  First, we need to build the query tree.  We are
-  // assuming it doesn't map anything...
+  // The trees are built outside of the parallel region, since building a tree
+  // logs information.
   Timer::Stop("computing_products");
   Timer::Start("tree_building");
-  Tree queryTree(querySet);
+  std::vector<Tree*> queryTrees(numBlocks);
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = (size_t) b * querySet.n_cols / numBlocks;
+    const size_t end = ((size_t) b + 1) * querySet.n_cols / numBlocks;
+    queryTrees[b] = new Tree(MatType(querySet.cols(begin, end - 1)));
+  }
   Timer::Stop("tree_building");
+  Timer::Start("computing_products");
+
+  typedef FastMKSRules<KernelType, Tree> RuleType;
+  size_t baseCases = 0;
+  size_t scores = 0;
 
-  Search(&queryTree, k, indices, kernels);
+  #pragma omp parallel for schedule(dynamic) reduction(+:baseCases, scores)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = (size_t) b * querySet.n_cols / numBlocks;
+    const size_t end = ((size_t) b + 1) * querySet.n_cols / numBlocks;
+
+    RuleType rules(*referenceSet, queryTrees[b]->Dataset(), k,
+        metric.Kernel());
+    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+    traverser.Traverse(*queryTrees[b], *referenceTree);
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+
+    arma::Mat<size_t> blockIndices;
+    arma::mat blockKernels;
+    rules.GetResults(blockIndices, blockKernels);
+    indices.cols(begin, end - 1) = blockIndices;
+    kernels.cols(begin, end - 1) = blockKernels;
+
+    delete queryTrees[b];
+  }
+
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
+
+  Timer::Stop("computing_products");
 }
 
 template<typename KernelType,
@@ -433,73 +448,205 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
+    NaiveSearch(*referenceSet, k, true, indices, kernels);
+
+    Timer::Stop("computing_products");
+    return;
+  }
+
+  // Single-tree implementation.
+  if (singleMode)
+  {
+    SingleTreeSearch(*referenceSet, k, indices, kernels);
+
+    Timer::Stop("computing_products");
+    return;
+  }
+
+  // Dual-tree implementation.  The query tree is the reference tree here, so
+  // it can't be split into blocks with their own trees.
+  Timer::Stop("computing_products");
+
+  Search(referenceTree, k, indices, kernels);
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename Kernel>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    const bool sameSet,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const typename std::enable_if_t<
+        !kernel::SupportsBatchKernels<Kernel, MatType>::value>*)
+{
+  // Simple double loop.  Stupid, slow, but a good benchmark.  Each query point
+  // only writes its own results, so the query points are independent.
+  #pragma omp parallel for
+  for (omp_size_t q = 0; q < (omp_size_t) querySet.n_cols; ++q)
+  {
+    const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+    std::vector<Candidate> cList(k, def);
+    CandidateList pqueue(CandidateCmp(), std::move(cList));
+
+    for (size_t r = 0; r < referenceSet->n_cols; ++r)
     {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
+      if (sameSet && ((size_t) q == r))
+        continue; // Don't return the point as its own candidate.
 
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
+      const double eval = metric.Kernel().Evaluate(querySet.col(q),
+                                                   referenceSet->col(r));
+
+      if (eval > pqueue.top().first)
       {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
+        Candidate c = std::make_pair(eval, r);
+        pqueue.pop();
+        pqueue.push(c);
+      }
+    }
+
+    for (size_t j = 1; j <= k; j++)
+    {
+      indices(k - j, q) = pqueue.top().second;
+      kernels(k - j, q) = pqueue.top().first;
+      pqueue.pop();
+    }
+  }
+}
 
-        const double eval = metric.Kernel().Evaluate(referenceSet->col(q),
-                                                     referenceSet->col(r));
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename Kernel>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    const bool sameSet,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const typename std::enable_if_t<
+        kernel::SupportsBatchKernels<Kernel, MatType>::value>*)
+{
+  // The blocks are small enough that a block of kernel values stays in cache
+  // while the candidates are updated.
+  const size_t queryBlockSize = 256;
+  const size_t referenceBlockSize = 1024;
+  const size_t numBlocks = (querySet.n_cols + queryBlockSize - 1) /
+      queryBlockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t queryBegin = (size_t) b * queryBlockSize;
+    const size_t queryEnd = std::min(queryBegin + queryBlockSize,
+        (size_t) querySet.n_cols);
+
+    const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+    std::vector<CandidateList> pqueues(queryEnd - queryBegin,
+        CandidateList(CandidateCmp(), std::vector<Candidate>(k, def)));
+
+    // Column i of blockKernels holds the kernel values of query point
+    // queryBegin + i with each reference point of the block.
+    arma::mat blockKernels;
+    for (size_t refBegin = 0; refBegin < referenceSet->n_cols;
+         refBegin += referenceBlockSize)
+    {
+      const size_t refEnd = std::min(refBegin + referenceBlockSize,
+          (size_t) referenceSet->n_cols);
+      kernel::BatchKernels(metric.Kernel(),
+          referenceSet->cols(refBegin, refEnd - 1),
+          querySet.cols(queryBegin, queryEnd - 1), blockKernels);
 
-        if (eval > pqueue.top().first)
+      for (size_t i = 0; i < pqueues.size(); ++i)
+      {
+        CandidateList& pqueue = pqueues[i];
+        for (size_t j = 0; j < blockKernels.n_rows; ++j)
         {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
+          if (sameSet && (queryBegin + i == refBegin + j))
+            continue; // Don't return the point as its own candidate.
+
+          const double eval = blockKernels(j, i);
+          if (eval > pqueue.top().first)
+          {
+            Candidate c = std::make_pair(eval, refBegin + j);
+            pqueue.pop();
+            pqueue.push(c);
+          }
         }
       }
+    }
 
+    for (size_t i = 0; i < pqueues.size(); ++i)
+    {
       for (size_t j = 1; j <= k; j++)
       {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
+        indices(k - j, queryBegin + i) = pqueues[i].top().second;
+        kernels(k - j, queryBegin + i) = pqueues[i].top().first;
+        pqueues[i].pop();
       }
     }
+  }
+}
 
-    Timer::Stop("computing_products");
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::SingleTreeSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels)
+{
+  typedef FastMKSRules<KernelType, Tree> RuleType;
 
-    return;
-  }
+  // Other trees store the kernel values of the single-tree traversal in the
+  // statistics of the reference tree, so they are searched on one thread.
+  const size_t numThreads = NumThreads();
+  const size_t numRanges = std::min((size_t) querySet.n_cols,
+      (tree::TreeTraits<Tree>::FirstPointIsCentroid && numThreads > 1) ?
+      4 * numThreads : 1);
 
-  // Single-tree implementation.
-  if (singleMode)
+  size_t baseCases = 0;
+  size_t scores = 0;
+  size_t numPrunes = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:baseCases, scores, numPrunes)
+  for (omp_size_t i = 0; i < (omp_size_t) numRanges; ++i)
   {
+    const size_t begin = (size_t) i * querySet.n_cols / numRanges;
+    const size_t end = ((size_t) i + 1) * querySet.n_cols / numRanges;
+
     // Create rules object (this will store the results).  This constructor
     // precalculates each self-kernel value.
-    typedef FastMKSRules<KernelType, Tree> RuleType;
-    RuleType rules(*referenceSet, *referenceSet, k, metric.Kernel());
+    RuleType rules(*referenceSet, querySet, begin, end - begin, k,
+        metric.Kernel());
 
     typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    // Save the number of pruned nodes.
-    const size_t numPrunes = traverser.NumPrunes();
+    for (size_t q = begin; q < end; ++q)
+      traverser.Traverse(q, *referenceTree);
 
-    Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
-
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+    numPrunes += traverser.NumPrunes();
 
+    // Each set of rules only fills the columns of its own query points.
     rules.GetResults(indices, kernels);
-
-    Timer::Stop("computing_products");
-    return;
   }
 
-  // Dual-tree implementation.
-  Timer::Stop("computing_products");
-
-  Search(referenceTree, k, indices, kernels);
+  Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
+  Log::Info << baseCases << " base cases." << std::endl;
+  Log::Info << scores << " scores." << std::endl;
 }
 
 //! Serialize the model.
@@ -48,8 +48,31 @@ class FastMKSRules
                const size_t k,
                KernelType& kernel);
 
+  /**
+   * Construct the FastMKSRules object, only holding candidate lists for the
+   * contiguous range of query points [queryBegin, queryBegin + queryCount).
+   * Only those query points may be passed to BaseCase(), Score() and Rescore().
+   * This is used by the parallel single-tree search, where each thread searches
+   * a range of query points with its own rules.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param queryBegin Index of the first query point handled by these rules.
+   * @param queryCount Number of query points handled by these rules.
+   * @param k Number of candidates to search for.
+   * @param kernel Kernel to run FastMKS with.
+   */
+  FastMKSRules(const typename TreeType::Mat& referenceSet,
+               const typename TreeType::Mat& querySet,
+               const size_t queryBegin,
+               const size_t queryCount,
+               const size_t k,
+               KernelType& kernel);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
+   * If these rules only handle a range of query points, only the columns of
+   * that range are filled.
    *
    * @param indices Matrix storing lists of candidate for each query point.
    * @param products Matrix storing kernel value for each candidate.
@@ -148,13 +171,17 @@ class FastMKSRules
   typedef boost::heap::priority_queue<Candidate,
       boost::heap::compare<CandidateCmp>> CandidateList;
 
-  //! Set of candidates for each point.
+  //! The index of the first query point handled by these rules.
+  size_t queryBegin;
+
+  //! Set of candidates for each query point handled by these rules.
   std::vector<CandidateList> candidates;
 
   //! Number of points to search for.
   const size_t k;
 
-  //! Cached query set self-kernels (|| q || for each q).
+  //! Cached query set self-kernels (|| q || for each q handled by these
+  //! rules).
   arma::vec queryKernels;
   //! Cached reference set self-kernels (|| r || for each r).
   arma::vec referenceKernels;
@@ -169,6 +196,13 @@ class FastMKSRules
   //! The last kernel evaluation resulting from BaseCase().
   double lastKernel;
 
+  //! For trees whose first point is the centroid, the last kernel evaluation
+  //! between a query point and each reference point.  During a single-tree
+  //! traversal this holds the kernel value of each scored reference node for
+  //! the current query point, so that the traversal does not write to the
+  //! statistics of the reference tree.
+  arma::vec lastPointKernels;
+
   //! Calculate the bound for a given query node.
   double CalculateBound(TreeType& queryNode) const;
 
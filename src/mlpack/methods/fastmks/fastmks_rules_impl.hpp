@@ -24,8 +24,20 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     const typename TreeType::Mat& querySet,
     const size_t k,
     KernelType& kernel) :
+    FastMKSRules(referenceSet, querySet, 0, querySet.n_cols, k, kernel)
+{ /* Nothing left to do. */ }
+
+template<typename KernelType, typename TreeType>
+FastMKSRules<KernelType, TreeType>::FastMKSRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    const size_t queryBegin,
+    const size_t queryCount,
+    const size_t k,
+    KernelType& kernel) :
     referenceSet(referenceSet),
     querySet(querySet),
+    queryBegin(queryBegin),
     k(k),
     kernel(kernel),
     lastQueryIndex(-1),
@@ -35,16 +47,19 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     scores(0)
 {
   // Precompute each self-kernel.
-  queryKernels.set_size(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; ++i)
-    queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(i),
-                                           querySet.col(i)));
+  queryKernels.set_size(queryCount);
+  for (size_t i = 0; i < queryCount; ++i)
+    queryKernels[i] = sqrt(kernel.Evaluate(querySet.col(queryBegin + i),
+                                           querySet.col(queryBegin + i)));
 
   referenceKernels.set_size(referenceSet.n_cols);
   for (size_t i = 0; i < referenceSet.n_cols; ++i)
     referenceKernels[i] = sqrt(kernel.Evaluate(referenceSet.col(i),
                                                referenceSet.col(i)));
 
+  if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+    lastPointKernels.zeros(referenceSet.n_cols);
+
   // Set to invalid memory, so that the first node combination does not try to
   // dereference null pointers.
   traversalInfo.LastQueryNode() = (TreeType*) this;
@@ -60,7 +75,7 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
   pqueue.reserve(k);
   for (size_t i = 0; i < k; i++)
     pqueue.push(def);
-  std::vector<CandidateList> tmp(querySet.n_cols, pqueue);
+  std::vector<CandidateList> tmp(queryCount, pqueue);
   candidates.swap(tmp);
 }
 
@@ -72,13 +87,13 @@ void FastMKSRules<KernelType, TreeType>::GetResults(
   indices.set_size(k, querySet.n_cols);
   products.set_size(k, querySet.n_cols);
 
-  for (size_t i = 0; i < querySet.n_cols; i++)
+  for (size_t i = 0; i < candidates.size(); i++)
   {
     CandidateList& pqueue = candidates[i];
     for (size_t j = 1; j <= k; j++)
     {
-      indices(k - j, i) = pqueue.top().second;
-      products(k - j, i) = pqueue.top().first;
+      indices(k - j, queryBegin + i) = pqueue.top().second;
+      products(k - j, queryBegin + i) = pqueue.top().first;
       pqueue.pop();
     }
   }
@@ -111,7 +126,10 @@ double FastMKSRules<KernelType, TreeType>::BaseCase(
 
   // Update the last kernel value, if we need to.
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
+  {
     lastKernel = kernelEval;
+    lastPointKernels[referenceIndex] = kernelEval;
+  }
 
   // If the reference and query sets are identical, we still need to compute the
   // base case (so that things can be bounded properly), but we won't add it to
@@ -129,7 +147,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
                                                  TreeType& referenceNode)
 {
   // Compare with the current best.
-  const double bestKernel = candidates[queryIndex].top().first;
+  const double bestKernel = candidates[queryIndex - queryBegin].top().first;
 
   // See if we can perform a parent-child prune.
   const double furthestDist = referenceNode.FurthestDescendantDistance();
@@ -138,7 +156,10 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     double maxKernelBound;
     const double parentDist = referenceNode.ParentDistance();
     const double combinedDistBound = parentDist + furthestDist;
-    const double lastKernel = referenceNode.Parent()->Stat().LastKernel();
+    // The parent has already been scored for this query point.
+    const double lastKernel = tree::TreeTraits<TreeType>::FirstPointIsCentroid
+        ? lastPointKernels[referenceNode.Parent()->Point(0)]
+        : referenceNode.Parent()->Stat().LastKernel();
     if (kernel::KernelTraits<KernelType>::IsNormalized)
     {
       const double squaredDist = std::pow(combinedDistBound, 2.0);
@@ -157,7 +178,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     else
     {
       maxKernelBound = lastKernel +
-          combinedDistBound * queryKernels[queryIndex];
+          combinedDistBound * queryKernels[queryIndex - queryBegin];
     }
 
     if (maxKernelBound < bestKernel)
@@ -175,7 +196,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
         referenceNode.Parent() != NULL &&
         referenceNode.Point(0) == referenceNode.Parent()->Point(0))
     {
-      kernelEval = referenceNode.Parent()->Stat().LastKernel();
+      kernelEval = lastPointKernels[referenceNode.Point(0)];
     }
     else
     {
@@ -188,9 +209,9 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     referenceNode.Center(refCenter);
 
     kernelEval = kernel.Evaluate(querySet.col(queryIndex), refCenter);
-  }
 
-  referenceNode.Stat().LastKernel() = kernelEval;
+    referenceNode.Stat().LastKernel() = kernelEval;
+  }
 
   double maxKernel;
   if (kernel::KernelTraits<KernelType>::IsNormalized)
@@ -210,7 +231,8 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
   }
   else
   {
-    maxKernel = kernelEval + furthestDist * queryKernels[queryIndex];
+    maxKernel = kernelEval +
+        furthestDist * queryKernels[queryIndex - queryBegin];
   }
 
   // We return the inverse of the maximum kernel so that larger kernels are
@@ -412,7 +434,7 @@ double FastMKSRules<KernelType, TreeType>::Rescore(const size_t queryIndex,
                                                    TreeType& /*referenceNode*/,
                                                    const double oldScore) const
 {
-  const double bestKernel = candidates[queryIndex].top().first;
+  const double bestKernel = candidates[queryIndex - queryBegin].top().first;
 
   return ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
 }
@@ -459,7 +481,7 @@ double FastMKSRules<KernelType, TreeType>::CalculateBound(TreeType& queryNode)
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
     const size_t point = queryNode.Point(i);
-    const CandidateList& candidatesPoints = candidates[point];
+    const CandidateList& candidatesPoints = candidates[point - queryBegin];
     if (candidatesPoints.top().first < worstPointKernel)
       worstPointKernel = candidatesPoints.top().first;
 
@@ -529,7 +551,7 @@ inline void FastMKSRules<KernelType, TreeType>::InsertNeighbor(
     const size_t index,
     const double product)
 {
-  CandidateList& pqueue = candidates[queryIndex];
+  CandidateList& pqueue = candidates[queryIndex - queryBegin];
   if (product > pqueue.top().first)
   {
     Candidate c = std::make_pair(product, index);
@@ -30,6 +30,12 @@ class DiagonalConstraint
     covariance = arma::diagmat(arma::clamp(covariance.diag(), 1e-10, DBL_MAX));
   }
 
+  //! Apply the same minimum value to the diagonal of a covariance matrix.
+  static void ApplyConstraint(arma::vec& diagCovariance)
+  {
+    diagCovariance = arma::clamp(diagCovariance, 1e-10, DBL_MAX);
+  }
+
   //! Serialize the constraint (which holds nothing, so, nothing to do).
   template<typename Archive>
   static void serialize(Archive& /* ar */, const unsigned int /* version */) { }
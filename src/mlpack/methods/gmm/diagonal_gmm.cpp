@@ -0,0 +1,171 @@
+/**
+ * @file diagonal_gmm.cpp
+ *
+ * Implementation of the non-template DiagonalGMM methods.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "diagonal_gmm.hpp"
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * Create a GMM with the given number of Gaussians, each of which have the
+ * specified dimensionality.
+ */
+DiagonalGMM::DiagonalGMM(const size_t gaussians, const size_t dimensionality) :
+    gaussians(gaussians),
+    dimensionality(dimensionality),
+    dists(gaussians,
+        distribution::DiagonalGaussianDistribution(dimensionality)),
+    weights(gaussians)
+{
+  // Set equal weights.  Technically this model is still valid, but only barely.
+  weights.fill(1.0 / gaussians);
+}
+
+/**
+ * Return the log probability of the given observation being from this GMM.
+ */
+double DiagonalGMM::LogProbability(const arma::vec& observation) const
+{
+  // Sum the probability for each Gaussian in our mixture (and we have to
+  // multiply by the prior for each Gaussian too).
+  double sum = -std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < gaussians; i++)
+    sum = math::LogAdd(sum, log(weights[i]) +
+        dists[i].LogProbability(observation));
+
+  return sum;
+}
+
+/**
+ * Return the probability of the given observation being from this GMM.
+ */
+double DiagonalGMM::Probability(const arma::vec& observation) const
+{
+  return exp(LogProbability(observation));
+}
+
+/**
+ * Return the log probability of the given observation being from the given
+ * component in the mixture.
+ */
+double DiagonalGMM::LogProbability(const arma::vec& observation,
+                                   const size_t component) const
+{
+  // We are only considering one Gaussian component -- so we only need to call
+  // Probability() once.  We do consider the prior probability!
+  return log(weights[component]) + dists[component].LogProbability(observation);
+}
+
+/**
+ * Return the probability of the given observation being from the given
+ * component in the mixture.
+ */
+double DiagonalGMM::Probability(const arma::vec& observation,
+                                const size_t component) const
+{
+  return exp(LogProbability(observation, component));
+}
+
+/**
+ * Return the log probability of each of the given observations.
+ */
+void DiagonalGMM::LogProbability(const arma::mat& observations,
+                                 arma::vec& logProbabilities) const
+{
+  // Compute the weighted log probability of all points under each component,
+  // then combine them with the log-sum-exp trick, one component at a time.
+  logProbabilities.set_size(observations.n_cols);
+  logProbabilities.fill(-std::numeric_limits<double>::infinity());
+  arma::vec componentLogProbs;
+  for (size_t i = 0; i < gaussians; i++)
+  {
+    dists[i].LogProbability(observations, componentLogProbs);
+    componentLogProbs += log(weights[i]);
+    for (size_t j = 0; j < observations.n_cols; ++j)
+      logProbabilities[j] = math::LogAdd(logProbabilities[j],
+          componentLogProbs[j]);
+  }
+}
+
+/**
+ * Return a randomly generated observation according to the probability
+ * distribution defined by this object.
+ */
+arma::vec DiagonalGMM::Random() const
+{
+  // Determine which Gaussian it will be coming from.
+  double gaussRand = math::Random();
+  size_t gaussian = 0;
+
+  double sumProb = 0;
+  for (size_t g = 0; g < gaussians; g++)
+  {
+    sumProb += weights(g);
+    if (gaussRand <= sumProb)
+    {
+      gaussian = g;
+      break;
+    }
+  }
+
+  return dists[gaussian].Random();
+}
+
+/**
+ * Classify the given observations as being from an individual component in this
+ * GMM.
+ */
+void DiagonalGMM::Classify(const arma::mat& observations,
+                           arma::Row<size_t>& labels) const
+{
+  // Evaluate all points under each component at once, and keep the most
+  // likely component of each point.
+  labels.zeros(observations.n_cols);
+  arma::vec bestLogProbs(observations.n_cols);
+  bestLogProbs.fill(-std::numeric_limits<double>::infinity());
+  arma::vec logProbs;
+  for (size_t i = 0; i < gaussians; ++i)
+  {
+    dists[i].LogProbability(observations, logProbs);
+    logProbs += log(weights[i]);
+    for (size_t j = 0; j < observations.n_cols; ++j)
+    {
+      if (logProbs[j] >= bestLogProbs[j])
+      {
+        bestLogProbs[j] = logProbs[j];
+        labels[j] = i;
+      }
+    }
+  }
+}
+
+/**
+ * Get the log-likelihood of this data's fit to the model.
+ */
+double DiagonalGMM::LogLikelihood(
+    const arma::mat& data,
+    const std::vector<distribution::DiagonalGaussianDistribution>& distsL,
+    const arma::vec& weightsL) const
+{
+  arma::vec phis;
+  arma::vec likelihoods(data.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < gaussians; i++)
+  {
+    distsL[i].Probability(data, phis);
+    likelihoods += weightsL(i) * phis;
+  }
+
+  // Now sum over every point.
+  return arma::accu(arma::log(likelihoods));
+}
+
+} // namespace gmm
+} // namespace mlpack
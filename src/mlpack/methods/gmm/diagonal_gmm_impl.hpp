@@ -0,0 +1,211 @@
+/**
+ * @file diagonal_gmm_impl.hpp
+ *
+ * Implementation of template-based DiagonalGMM methods.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_DIAGONAL_GMM_IMPL_HPP
+#define MLPACK_METHODS_GMM_DIAGONAL_GMM_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "diagonal_gmm.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * Fit the GMM to the given observations.
+ */
+template<typename FittingType>
+double DiagonalGMM::Train(const arma::mat& observations,
+                  const size_t trials,
+                  const bool useExistingModel,
+                  FittingType fitter)
+{
+  double bestLikelihood; // This will be reported later.
+
+  // We don't need to store temporary models if we are only doing one trial.
+  if (trials == 1)
+  {
+    // Train the model.  The user will have been warned earlier if the GMM was
+    // initialized with no parameters (0 gaussians, dimensionality of 0).
+    fitter.Estimate(observations, dists, weights, useExistingModel);
+    bestLikelihood = LogLikelihood(observations, dists, weights);
+  }
+  else
+  {
+    if (trials == 0)
+      return -DBL_MAX; // It's what they asked for...
+
+    // If each trial must start from the same initial location, we must save it.
+    std::vector<distribution::DiagonalGaussianDistribution> distsOrig;
+    arma::vec weightsOrig;
+    if (useExistingModel)
+    {
+      distsOrig = dists;
+      weightsOrig = weights;
+    }
+
+    // We need to keep temporary copies.  We'll do the first training into the
+    // actual model position, so that if it's the best we don't need to copy it.
+    fitter.Estimate(observations, dists, weights, useExistingModel);
+
+    bestLikelihood = LogLikelihood(observations, dists, weights);
+
+    Log::Info << "DiagonalGMM::Train(): Log-likelihood of trial 0 is "
+        << bestLikelihood << "." << std::endl;
+
+    // Now the temporary model.
+    std::vector<distribution::DiagonalGaussianDistribution> distsTrial(
+        gaussians, distribution::DiagonalGaussianDistribution(dimensionality));
+    arma::vec weightsTrial(gaussians);
+
+    for (size_t trial = 1; trial < trials; ++trial)
+    {
+      if (useExistingModel)
+      {
+        distsTrial = distsOrig;
+        weightsTrial = weightsOrig;
+      }
+
+      fitter.Estimate(observations, distsTrial, weightsTrial, useExistingModel);
+
+      // Check to see if the log-likelihood of this one is better.
+      double newLikelihood = LogLikelihood(observations, distsTrial,
+          weightsTrial);
+
+      Log::Info << "DiagonalGMM::Train(): Log-likelihood of trial " << trial
+          << " is " << newLikelihood << "." << std::endl;
+
+      if (newLikelihood > bestLikelihood)
+      {
+        // Save new likelihood and copy new model.
+        bestLikelihood = newLikelihood;
+
+        dists = distsTrial;
+        weights = weightsTrial;
+      }
+    }
+  }
+
+  // Report final log-likelihood and return it.
+  Log::Info << "DiagonalGMM::Train(): log-likelihood of trained GMM is "
+      << bestLikelihood << "." << std::endl;
+  return bestLikelihood;
+}
+
+/**
+ * Fit the GMM to the given observations, each of which has a certain
+ * probability of being from this distribution.
+ */
+template<typename FittingType>
+double DiagonalGMM::Train(const arma::mat& observations,
+                  const arma::vec& probabilities,
+                  const size_t trials,
+                  const bool useExistingModel,
+                  FittingType fitter)
+{
+  double bestLikelihood; // This will be reported later.
+
+  // We don't need to store temporary models if we are only doing one trial.
+  if (trials == 1)
+  {
+    // Train the model.  The user will have been warned earlier if the GMM was
+    // initialized with no parameters (0 gaussians, dimensionality of 0).
+    fitter.Estimate(observations, probabilities, dists, weights,
+        useExistingModel);
+    bestLikelihood = LogLikelihood(observations, dists, weights);
+  }
+  else
+  {
+    if (trials == 0)
+      return -DBL_MAX; // It's what they asked for...
+
+    // If each trial must start from the same initial location, we must save it.
+    std::vector<distribution::DiagonalGaussianDistribution> distsOrig;
+    arma::vec weightsOrig;
+    if (useExistingModel)
+    {
+      distsOrig = dists;
+      weightsOrig = weights;
+    }
+
+    // We need to keep temporary copies.  We'll do the first training into the
+    // actual model position, so that if it's the best we don't need to copy it.
+    fitter.Estimate(observations, probabilities, dists, weights,
+        useExistingModel);
+
+    bestLikelihood = LogLikelihood(observations, dists, weights);
+
+    Log::Debug << "DiagonalGMM::Train(): Log-likelihood of trial 0 is "
+        << bestLikelihood << "." << std::endl;
+
+    // Now the temporary model.
+    std::vector<distribution::DiagonalGaussianDistribution> distsTrial(
+        gaussians, distribution::DiagonalGaussianDistribution(dimensionality));
+    arma::vec weightsTrial(gaussians);
+
+    for (size_t trial = 1; trial < trials; ++trial)
+    {
+      if (useExistingModel)
+      {
+        distsTrial = distsOrig;
+        weightsTrial = weightsOrig;
+      }
+
+      fitter.Estimate(observations, probabilities, distsTrial, weightsTrial,
+          useExistingModel);
+
+      // Check to see if the log-likelihood of this one is better.
+      double newLikelihood = LogLikelihood(observations, distsTrial,
+          weightsTrial);
+
+      Log::Debug << "DiagonalGMM::Train(): Log-likelihood of trial " << trial
+          << " is " << newLikelihood << "." << std::endl;
+
+      if (newLikelihood > bestLikelihood)
+      {
+        // Save new likelihood and copy new model.
+        bestLikelihood = newLikelihood;
+
+        dists = distsTrial;
+        weights = weightsTrial;
+      }
+    }
+  }
+
+  // Report final log-likelihood and return it.
+  Log::Info << "DiagonalGMM::Train(): log-likelihood of trained GMM is "
+      << bestLikelihood << "." << std::endl;
+  return bestLikelihood;
+}
+
+/**
+ * Serialize the object.
+ */
+template<typename Archive>
+void DiagonalGMM::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(gaussians);
+  ar & BOOST_SERIALIZATION_NVP(dimensionality);
+
+  // Load (or save) the gaussians.  Not going to use the default std::vector
+  // serialize here because it won't call out correctly to serialize() for each
+  // Gaussian distribution.
+  if (Archive::is_loading::value)
+    dists.resize(gaussians);
+
+  ar & BOOST_SERIALIZATION_NVP(dists);
+
+  ar & BOOST_SERIALIZATION_NVP(weights);
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
+
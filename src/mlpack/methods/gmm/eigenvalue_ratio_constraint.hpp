@@ -76,6 +76,20 @@ class EigenvalueRatioConstraint
     covariance = eigenvectors * arma::diagmat(eigenvalues) * eigenvectors.t();
   }
 
+  /**
+   * Apply the eigenvalue ratio constraint to the given diagonal of a covariance
+   * matrix, whose elements are its eigenvalues.
+   */
+  void ApplyConstraint(arma::vec& diagCovariance) const
+  {
+    // The eigenvalues of the diagonal matrix, in the same order as armadillo's
+    // eig_sym() would return them.
+    const arma::uvec order = arma::sort_index(diagCovariance);
+    const double first = diagCovariance[order[0]];
+    for (size_t i = 0; i < order.n_elem; ++i)
+      diagCovariance[order[i]] = first * ratios[i];
+  }
+
   //! Serialize the constraint.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */)
@@ -16,6 +16,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/dists/gaussian_distribution.hpp>
+#include <mlpack/core/dists/diagonal_gaussian_distribution.hpp>
 
 // Default clustering mechanism.
 #include <mlpack/methods/kmeans/kmeans.hpp>
@@ -37,9 +38,16 @@ namespace gmm {
  *
  * This method should create 'clusters' clusters, and return the assignment of
  * each point to a cluster.
+ *
+ * The components of the mixture are either distribution::GaussianDistribution
+ * objects, or distribution::DiagonalGaussianDistribution objects, whose
+ * covariances are only a vector holding the diagonal.  With the latter, the
+ * covariance constraint policy must also be able to constrain the diagonal of a
+ * covariance matrix (all of mlpack's constraints can).
  */
 template<typename InitialClusteringType = kmeans::KMeans<>,
-         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint>
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
 class EMFit
 {
  public:
@@ -80,7 +88,7 @@ class EMFit
    *      clustering.
    */
   void Estimate(const arma::mat& observations,
-                std::vector<distribution::GaussianDistribution>& dists,
+                std::vector<Distribution>& dists,
                 arma::vec& weights,
                 const bool useInitialModel = false);
 
@@ -103,7 +111,7 @@ class EMFit
    */
   void Estimate(const arma::mat& observations,
                 const arma::vec& probabilities,
-                std::vector<distribution::GaussianDistribution>& dists,
+                std::vector<Distribution>& dists,
                 arma::vec& weights,
                 const bool useInitialModel = false);
 
@@ -132,6 +140,60 @@ class EMFit
   void serialize(Archive& ar, const unsigned int version);
 
  private:
+  //! The type of the covariance of each component (a matrix, or a vector for
+  //! diagonal Gaussians).
+  typedef typename std::decay<decltype(
+      std::declval<const Distribution&>().Covariance())>::type CovarianceType;
+
+  /**
+   * Compute the weighted scatter matrix of the given centered observations:
+   * sum_i w_i x_i x_i^T.
+   */
+  static arma::mat Scatter(const arma::mat& centered,
+                           const arma::rowvec& weights,
+                           const distribution::GaussianDistribution& /* d */)
+  {
+    return centered * (centered.each_row() % weights).t();
+  }
+
+  /**
+   * Compute the diagonal of the weighted scatter matrix of the given centered
+   * observations: sum_i w_i (x_i % x_i).
+   */
+  static arma::vec Scatter(
+      const arma::mat& centered,
+      const arma::rowvec& weights,
+      const distribution::DiagonalGaussianDistribution& /* d */)
+  {
+    return arma::square(centered) * weights.t();
+  }
+
+  //! Get the diagonal of the covariance of a Gaussian.
+  static arma::vec Diagonal(const distribution::GaussianDistribution& d)
+  {
+    return d.Covariance().diag();
+  }
+
+  //! Get the diagonal of the covariance of a diagonal Gaussian.
+  static arma::vec Diagonal(const distribution::DiagonalGaussianDistribution& d)
+  {
+    return d.Covariance();
+  }
+
+  //! Set the covariance of a Gaussian to the given diagonal matrix.
+  static void SetDiagonal(distribution::GaussianDistribution& d,
+                          const arma::vec& diagonal)
+  {
+    d.Covariance(arma::diagmat(diagonal));
+  }
+
+  //! Set the covariance of a diagonal Gaussian.
+  static void SetDiagonal(distribution::DiagonalGaussianDistribution& d,
+                          const arma::vec& diagonal)
+  {
+    d.Covariance(diagonal);
+  }
+
   /**
    * Run the clusterer, and then turn the cluster assignments into Gaussians.
    * This is a helper function for both overloads of Estimate().  The vectors
@@ -143,9 +205,47 @@ class EMFit
    * @param weights Vector to store a priori weights in.
    */
   void InitialClustering(const arma::mat& observations,
-                         std::vector<distribution::GaussianDistribution>& dists,
+                         std::vector<Distribution>& dists,
                          arma::vec& weights);
 
+  /**
+   * Compute the conditional probability of each Gaussian of the model given
+   * each observation (the E step).  Column i of condProb holds the
+   * probabilities for Gaussian i, and each row is normalized to sum to 1 (or is
+   * all zeros if the observation has zero probability under every Gaussian).
+   * The observations are handled in parallel, in blocks.
+   *
+   * @param observations List of observations.
+   * @param dists Current distributions of the model.
+   * @param weights Current a priori weights of the model.
+   * @param condProb Matrix to store the conditional probabilities in.
+   */
+  void ConditionalProbabilities(
+      const arma::mat& observations,
+      const std::vector<Distribution>& dists,
+      const arma::vec& weights,
+      arma::mat& condProb) const;
+
+  /**
+   * Update the mean and covariance of each Gaussian from the given weights of
+   * each observation for each Gaussian (the M step).  The means are computed
+   * with one matrix multiplication; the weighted covariances are accumulated
+   * from blocks of observations with matrix multiplications, in parallel over
+   * (Gaussian, range of observations) pairs, each with its own accumulator.
+   * Gaussians with zero total weight are left unchanged.
+   *
+   * @param observations List of observations.
+   * @param observationWeights Weight of each observation (row) for each
+   *     Gaussian (column).
+   * @param weightSums Sum of each column of observationWeights.
+   * @param dists Distributions to update.
+   */
+  void UpdateDistributions(
+      const arma::mat& observations,
+      const arma::mat& observationWeights,
+      const arma::vec& weightSums,
+      std::vector<Distribution>& dists);
+
   /**
    * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
    * GMM code.  Intuition suggests that the log-likelihood is not the best way
@@ -157,8 +257,7 @@ class EMFit
    * @param weights Vector of a priori weights.
    */
   double LogLikelihood(const arma::mat& data,
-                       const std::vector<distribution::GaussianDistribution>&
-                           dists,
+                       const std::vector<Distribution>& dists,
                        const arma::vec& weights) const;
 
   // Armadillo uses uword internally as an OpenMP index type, which crashes
@@ -166,8 +265,9 @@ class EMFit
   #ifndef _WIN32
   /**
    * Use the Armadillo gmm_diag clusterer to train a GMM with diagonal
-   * covariance.  If InitialClusteringType == kmeans::KMeans<>, this will use
-   * Armadillo's initialization also.
+   * covariance (held either in GaussianDistribution or in
+   * DiagonalGaussianDistribution objects).  If InitialClusteringType ==
+   * kmeans::KMeans<>, this will use Armadillo's initialization also.
    *
    * @param observations Data to train on.
    * @param dists Distributions to store model in.
@@ -176,7 +276,7 @@ class EMFit
    */
   void ArmadilloGMMWrapper(
       const arma::mat& observations,
-      std::vector<distribution::GaussianDistribution>& dists,
+      std::vector<Distribution>& dists,
       arma::vec& weights,
       const bool useInitialModel);
   #endif
@@ -21,8 +21,10 @@ namespace mlpack {
 namespace gmm {
 
 //! Constructor.
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-EMFit<InitialClusteringType, CovarianceConstraintPolicy>::EMFit(
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::EMFit(
     const size_t maxIterations,
     const double tolerance,
     InitialClusteringType clusterer,
@@ -33,10 +35,13 @@ EMFit<InitialClusteringType, CovarianceConstraintPolicy>::EMFit(
     constraint(constraint)
 { /* Nothing to do. */ }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+Estimate(
     const arma::mat& observations,
-    std::vector<distribution::GaussianDistribution>& dists,
+    std::vector<Distribution>& dists,
     arma::vec& weights,
     const bool useInitialModel)
 {
@@ -72,52 +77,14 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
 
     // Calculate the conditional probabilities of choosing a particular
     // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
+    ConditionalProbabilities(observations, dists, weights, condProb);
 
     // Store the sum of the probability of each state over all the observations.
     arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
 
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0)
-        dists[i].Mean() = (observations * condProb.col(i)) / probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i)));
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != 0.0)
-      {
-        arma::mat covariance = (tmp * trans(tmpB)) / probRowSums[i];
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
+    // Calculate the new values of the means and covariances using the updated
+    // conditional probabilities.
+    UpdateDistributions(observations, condProb, probRowSums, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -131,11 +98,14 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   }
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+Estimate(
     const arma::mat& observations,
     const arma::vec& probabilities,
-    std::vector<distribution::GaussianDistribution>& dists,
+    std::vector<Distribution>& dists,
     arma::vec& weights,
     const bool useInitialModel)
 {
@@ -156,56 +126,17 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   {
     // Calculate the conditional probabilities of choosing a particular
     // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Store conditional probabilities into condProb vector for each
-      // Gaussian.  First we make an alias of the condProb vector.
-      arma::vec condProbAlias = condProb.unsafe_col(i);
-      dists[i].Probability(observations, condProbAlias);
-      condProbAlias *= weights[i];
-    }
+    ConditionalProbabilities(observations, dists, weights, condProb);
 
-    // Normalize row-wise.
-    for (size_t i = 0; i < condProb.n_rows; i++)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = accu(condProb.row(i));
-      if (probSum != 0.0)
-        condProb.row(i) /= probSum;
-    }
-
-    // This will store the sum of probabilities of each state over all the
-    // observations.
-    arma::vec probRowSums(dists.size());
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); i++)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      probRowSums[i] = accu(condProb.col(i) % probabilities);
-
-      dists[i].Mean() = (observations * (condProb.col(i) % probabilities)) /
-        probRowSums[i];
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations - (dists[i].Mean() *
-          arma::ones<arma::rowvec>(observations.n_cols));
-      arma::mat tmpB = tmp % (arma::ones<arma::vec>(observations.n_rows) *
-          trans(condProb.col(i) % probabilities));
-
-      arma::mat cov = (tmp * trans(tmpB)) / probRowSums[i];
+    // Weight the conditional probabilities of each point by the probability of
+    // the point being from this mixture model, and store the sum of the
+    // weighted probabilities of each state over all the observations.
+    condProb.each_col() %= probabilities;
+    arma::vec probRowSums = trans(arma::sum(condProb, 0 /* columnwise */));
 
-      // Apply covariance constraint.
-      constraint.ApplyConstraint(cov);
-
-      dists[i].Covariance(std::move(cov));
-    }
+    // Calculate the new values of the means and covariances using the updated
+    // conditional probabilities.
+    UpdateDistributions(observations, condProb, probRowSums, dists);
 
     // Calculate the new values for omega using the updated conditional
     // probabilities.
@@ -219,10 +150,12 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::Estimate(
   }
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
 InitialClustering(const arma::mat& observations,
-                  std::vector<distribution::GaussianDistribution>& dists,
+                  std::vector<Distribution>& dists,
                   arma::vec& weights)
 {
   // Assignments from clustering.
@@ -232,18 +165,17 @@ InitialClustering(const arma::mat& observations,
   clusterer.Cluster(observations, dists.size(), assignments);
 
   std::vector<arma::vec> means(dists.size());
-  std::vector<arma::mat> covs(dists.size());
+  std::vector<CovarianceType> covs(dists.size());
 
   // Now calculate the means, covariances, and weights.
   weights.zeros();
   for (size_t i = 0; i < dists.size(); ++i)
   {
     means[i].zeros(dists[i].Mean().n_elem);
-    covs[i].zeros(dists[i].Covariance().n_rows,
-                  dists[i].Covariance().n_cols);
+    covs[i].zeros(arma::size(dists[i].Covariance()));
   }
 
-  // From the assignments, generate our means, covariances, and weights.
+  // From the assignments, generate our means and weights.
   for (size_t i = 0; i < observations.n_cols; ++i)
   {
     const size_t cluster = assignments[i];
@@ -251,9 +183,6 @@ InitialClustering(const arma::mat& observations,
     // Add this to the relevant mean.
     means[cluster] += observations.col(i);
 
-    // Add this to the relevant covariance.
-    covs[cluster] += observations.col(i) * trans(observations.col(i));
-
     // Now add one to the weights (we will normalize).
     weights[cluster]++;
   }
@@ -267,8 +196,9 @@ InitialClustering(const arma::mat& observations,
   for (size_t i = 0; i < observations.n_cols; ++i)
   {
     const size_t cluster = assignments[i];
-    const arma::vec normObs = observations.col(i) - means[cluster];
-    covs[cluster] += normObs * normObs.t();
+    const arma::mat normObs = observations.col(i) - means[cluster];
+    covs[cluster] += Scatter(normObs, arma::ones<arma::rowvec>(1),
+        dists[cluster]);
   }
 
   for (size_t i = 0; i < dists.size(); ++i)
@@ -286,37 +216,172 @@ InitialClustering(const arma::mat& observations,
   weights /= accu(weights);
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-double EMFit<InitialClusteringType, CovarianceConstraintPolicy>::LogLikelihood(
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+ConditionalProbabilities(
     const arma::mat& observations,
-    const std::vector<distribution::GaussianDistribution>& dists,
-    const arma::vec& weights) const
+    const std::vector<Distribution>& dists,
+    const arma::vec& weights,
+    arma::mat& condProb) const
 {
-  double logLikelihood = 0;
+  condProb.set_size(observations.n_cols, dists.size());
+
+  // Each block of observations is evaluated under every Gaussian at once, and
+  // then the rows of the block are normalized while they are still in cache.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min((size_t) observations.n_cols,
+        begin + blockSize);
+    const arma::mat block = observations.cols(begin, end - 1);
 
-  arma::vec phis;
-  arma::mat likelihoods(dists.size(), observations.n_cols);
+    arma::vec logProbs;
+    for (size_t i = 0; i < dists.size(); i++)
+    {
+      dists[i].LogProbability(block, logProbs);
+      condProb.submat(begin, i, end - 1, i) = weights[i] * arma::exp(logProbs);
+    }
 
-  for (size_t i = 0; i < dists.size(); ++i)
+    // Normalize row-wise.
+    for (size_t j = begin; j < end; j++)
+    {
+      // Avoid dividing by zero; if the probability for everything is 0, we
+      // don't want to make it NaN.
+      const double probSum = accu(condProb.row(j));
+      if (probSum != 0.0)
+        condProb.row(j) /= probSum;
+    }
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+UpdateDistributions(
+    const arma::mat& observations,
+    const arma::mat& observationWeights,
+    const arma::vec& weightSums,
+    std::vector<Distribution>& dists)
+{
+  const size_t numDists = dists.size();
+  const size_t n = observations.n_cols;
+
+  // All of the means are one matrix multiplication.  Don't update if there's
+  // no probability of the Gaussian having points.
+  const arma::mat means = observations * observationWeights;
+  for (size_t i = 0; i < numDists; i++)
+    if (weightSums[i] != 0.0)
+      dists[i].Mean() = means.col(i) / weightSums[i];
+
+  // Split the observations into enough ranges that there are at least as many
+  // (Gaussian, range) tasks as threads.  Each task accumulates the weighted
+  // scatter matrix of its range around the new mean, one block at a time.
+  const size_t numThreads = NumThreads();
+  const size_t numRanges = std::max((size_t) 1, std::min(n,
+      (numThreads + numDists - 1) / std::max(numDists, (size_t) 1)));
+  const size_t blockSize = 1024;
+  std::vector<CovarianceType> partials(numDists * numRanges);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) partials.size(); ++t)
+  {
+    const size_t i = t / numRanges;
+    const size_t r = t % numRanges;
+    CovarianceType& partial = partials[t];
+    partial.zeros(arma::size(dists[i].Covariance()));
+    if (weightSums[i] == 0.0)
+      continue;
+
+    const size_t rangeBegin = r * n / numRanges;
+    const size_t rangeEnd = (r + 1) * n / numRanges;
+    for (size_t begin = rangeBegin; begin < rangeEnd; begin += blockSize)
+    {
+      const size_t end = std::min(rangeEnd, begin + blockSize);
+      arma::mat centered = observations.cols(begin, end - 1);
+      centered.each_col() -= dists[i].Mean();
+      partial += Scatter(centered,
+          observationWeights.submat(begin, i, end - 1, i).t(), dists[i]);
+    }
+  }
+
+  // Merge the accumulators of each Gaussian, and factor the new covariances.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numDists; ++i)
   {
-    dists[i].Probability(observations, phis);
-    likelihoods.row(i) = weights(i) * trans(phis);
+    // Don't update if there's no probability of the Gaussian having points.
+    if (weightSums[i] == 0.0)
+      continue;
+
+    CovarianceType covariance = std::move(partials[i * numRanges]);
+    for (size_t r = 1; r < numRanges; ++r)
+      covariance += partials[i * numRanges + r];
+    covariance /= weightSums[i];
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+LogLikelihood(
+    const arma::mat& observations,
+    const std::vector<Distribution>& dists,
+    const arma::vec& weights) const
+{
+  double logLikelihood = 0;
+  size_t zeroLikelihoods = 0;
+
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (observations.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:logLikelihood, zeroLikelihoods)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    if (accu(likelihoods.col(j)) == 0)
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
-    logLikelihood += log(accu(likelihoods.col(j)));
+    const size_t begin = b * blockSize;
+    const size_t end = std::min((size_t) observations.n_cols,
+        begin + blockSize);
+    const arma::mat block = observations.cols(begin, end - 1);
+
+    arma::vec logProbs;
+    arma::vec likelihoods(block.n_cols, arma::fill::zeros);
+    for (size_t i = 0; i < dists.size(); ++i)
+    {
+      dists[i].LogProbability(block, logProbs);
+      likelihoods += weights(i) * arma::exp(logProbs);
+    }
+
+    // Now sum over every point.
+    for (size_t j = 0; j < likelihoods.n_elem; ++j)
+    {
+      if (likelihoods[j] == 0)
+        ++zeroLikelihoods;
+      logLikelihood += log(likelihoods[j]);
+    }
   }
 
+  if (zeroLikelihoods > 0)
+    Log::Info << "Likelihood of " << zeroLikelihoods << " points is 0!  They "
+        << "are probably outliers." << std::endl;
+
   return logLikelihood;
 }
 
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
 template<typename Archive>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::serialize(
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+serialize(
     Archive& ar,
     const unsigned int /* version */)
 {
@@ -329,10 +394,12 @@ void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::serialize(
 // Armadillo uses uword internally as an OpenMP index type, which crashes Visual
 // Studio.
 #ifndef _WIN32
-template<typename InitialClusteringType, typename CovarianceConstraintPolicy>
-void EMFit<InitialClusteringType, CovarianceConstraintPolicy>::
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
 ArmadilloGMMWrapper(const arma::mat& observations,
-                    std::vector<distribution::GaussianDistribution>& dists,
+                    std::vector<Distribution>& dists,
                     arma::vec& weights,
                     const bool useInitialModel)
 {
@@ -361,7 +428,7 @@ ArmadilloGMMWrapper(const arma::mat& observations,
     for (size_t i = 0; i < dists.size(); ++i)
     {
       means.col(i) = dists[i].Mean();
-      covs.col(i) = dists[i].Covariance().diag();
+      covs.col(i) = Diagonal(dists[i]);
     }
 
     g.reset(observations.n_rows, dists.size());
@@ -383,7 +450,7 @@ ArmadilloGMMWrapper(const arma::mat& observations,
   for (size_t i = 0; i < dists.size(); ++i)
   {
     dists[i].Mean() = g.means.col(i);
-    dists[i].Covariance(arma::diagmat(g.dcovs.col(i)));
+    SetDiagonal(dists[i], g.dcovs.col(i));
   }
 }
 #endif
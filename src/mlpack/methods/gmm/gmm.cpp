@@ -96,6 +96,27 @@ double GMM::Probability(const arma::vec& observation,
   return exp(LogProbability(observation, component));
 }
 
+/**
+ * Return the log probability of each of the given observations.
+ */
+void GMM::LogProbability(const arma::mat& observations,
+                         arma::vec& logProbabilities) const
+{
+  // Compute the weighted log probability of all points under each component,
+  // then combine them with the log-sum-exp trick, one component at a time.
+  logProbabilities.set_size(observations.n_cols);
+  logProbabilities.fill(-std::numeric_limits<double>::infinity());
+  arma::vec componentLogProbs;
+  for (size_t i = 0; i < gaussians; i++)
+  {
+    dists[i].LogProbability(observations, componentLogProbs);
+    componentLogProbs += log(weights[i]);
+    for (size_t j = 0; j < observations.n_cols; ++j)
+      logProbabilities[j] = math::LogAdd(logProbabilities[j],
+          componentLogProbs[j]);
+  }
+}
+
 /**
  * Return a randomly generated observation according to the probability
  * distribution defined by this object.
@@ -128,22 +149,22 @@ arma::vec GMM::Random() const
 void GMM::Classify(const arma::mat& observations,
                    arma::Row<size_t>& labels) const
 {
-  // This is not the best way to do this!
-
-  // We should not have to fill this with values, because each one should be
-  // overwritten.
-  labels.set_size(observations.n_cols);
-  for (size_t i = 0; i < observations.n_cols; ++i)
+  // Evaluate all points under each component at once, and keep the most
+  // likely component of each point.
+  labels.zeros(observations.n_cols);
+  arma::vec bestLogProbs(observations.n_cols);
+  bestLogProbs.fill(-std::numeric_limits<double>::infinity());
+  arma::vec logProbs;
+  for (size_t i = 0; i < gaussians; ++i)
   {
-    // Find maximum probability component.
-    double probability = 0;
-    for (size_t j = 0; j < gaussians; ++j)
+    dists[i].LogProbability(observations, logProbs);
+    logProbs += log(weights[i]);
+    for (size_t j = 0; j < observations.n_cols; ++j)
     {
-      double newProb = Probability(observations.unsafe_col(i), j);
-      if (newProb >= probability)
+      if (logProbs[j] >= bestLogProbs[j])
       {
-        probability = newProb;
-        labels[i] = j;
+        bestLogProbs[j] = logProbs[j];
+        labels[j] = i;
       }
     }
   }
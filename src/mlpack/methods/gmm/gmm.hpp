@@ -191,6 +191,18 @@ class GMM
    */
   double LogProbability(const arma::vec& observation,
                         const size_t component) const;
+
+  /**
+   * Compute the log probability of each of the given observations (columns)
+   * under this distribution.  The components are evaluated on all of the
+   * observations at once.
+   *
+   * @param observations Observations to evaluate the probability of.
+   * @param logProbabilities Output log probabilities of each observation.
+   */
+  void LogProbability(const arma::mat& observations,
+                      arma::vec& logProbabilities) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
@@ -212,6 +224,11 @@ class GMM
    * is deterministic after the initial position is given, then 'trials' should
    * be set to 1.
    *
+   * When there are several trials, they are fit in parallel, each with a copy
+   * of the fitter and its own random stream seeded from math::randGen, so the
+   * model doesn't depend on the number of threads.  The number of trials fit
+   * at once can be limited with 'maxMemory'.
+   *
    * @tparam FittingType The type of fitting method which should be used
    *     (EMFit<> is suggested).
    * @param observations Observations of the model.
@@ -219,13 +236,17 @@ class GMM
    *      the greatest log-likelihood will be selected.
    * @param useExistingModel If true, the existing model is used as an initial
    *      model for the estimation.
+   * @param fitter The fitter to use; each trial uses a copy of it.
+   * @param maxMemory Approximate memory (in bytes) that the trials fit at once
+   *      may use; 0 means no limit, and at least one trial is always fit.
    * @return The log-likelihood of the best fit.
    */
   template<typename FittingType = EMFit<>>
   double Train(const arma::mat& observations,
                const size_t trials = 1,
                const bool useExistingModel = false,
-               FittingType fitter = FittingType());
+               FittingType fitter = FittingType(),
+               const size_t maxMemory = 0);
 
   /**
    * Estimate the probability distribution directly from the given observations,
@@ -249,6 +270,10 @@ class GMM
    *     the greatest log-likelihood will be selected.
    * @param useExistingModel If true, the existing model is used as an initial
    *     model for the estimation.
+   * @param fitter The fitter to use; each trial uses a copy of it.
+   * @param maxMemory Approximate memory (in bytes) that the trials fit at once
+   *     may use; 0 means no limit.  The trials are fit in parallel as with the
+   *     other overload of Train().
    * @return The log-likelihood of the best fit.
    */
   template<typename FittingType = EMFit<>>
@@ -256,7 +281,8 @@ class GMM
                const arma::vec& probabilities,
                const size_t trials = 1,
                const bool useExistingModel = false,
-               FittingType fitter = FittingType());
+               FittingType fitter = FittingType(),
+               const size_t maxMemory = 0);
 
   /**
    * Classify the given observations as being from an individual component in
@@ -284,6 +310,28 @@ class GMM
   void serialize(Archive& ar, const unsigned int /* version */);
 
  private:
+  /**
+   * Fit the given number of trials in parallel, and keep the model with the
+   * greatest log-likelihood.  This is used by GMM::Train().
+   *
+   * @param observations Observations of the model.
+   * @param trials Number of trials to perform (more than one).
+   * @param useExistingModel If true, each trial starts from the existing model.
+   * @param fitter The fitter; each trial uses a copy of it.
+   * @param maxMemory Approximate memory that the trials fit at once may use (0
+   *     for no limit).
+   * @param estimate Function fitting a trial, called with the copy of the
+   *     fitter, the distributions and the weights.
+   * @return The log-likelihood of the best fit.
+   */
+  template<typename FittingType, typename EstimateType>
+  double TrainTrials(const arma::mat& observations,
+                     const size_t trials,
+                     const bool useExistingModel,
+                     const FittingType& fitter,
+                     const size_t maxMemory,
+                     const EstimateType& estimate);
+
   /**
    * This function computes the loglikelihood of the given model.  This function
    * is used by GMM::Train().
@@ -27,7 +27,8 @@ template<typename FittingType>
 double GMM::Train(const arma::mat& observations,
                   const size_t trials,
                   const bool useExistingModel,
-                  FittingType fitter)
+                  FittingType fitter,
+                  const size_t maxMemory)
 {
   double bestLikelihood; // This will be reported later.
 
@@ -44,55 +45,14 @@ double GMM::Train(const arma::mat& observations,
     if (trials == 0)
       return -DBL_MAX; // It's what they asked for...
 
-    // If each trial must start from the same initial location, we must save it.
-    std::vector<distribution::GaussianDistribution> distsOrig;
-    arma::vec weightsOrig;
-    if (useExistingModel)
-    {
-      distsOrig = dists;
-      weightsOrig = weights;
-    }
-
-    // We need to keep temporary copies.  We'll do the first training into the
-    // actual model position, so that if it's the best we don't need to copy it.
-    fitter.Estimate(observations, dists, weights, useExistingModel);
-
-    bestLikelihood = LogLikelihood(observations, dists, weights);
-
-    Log::Info << "GMM::Train(): Log-likelihood of trial 0 is "
-        << bestLikelihood << "." << std::endl;
-
-    // Now the temporary model.
-    std::vector<distribution::GaussianDistribution> distsTrial(gaussians,
-        distribution::GaussianDistribution(dimensionality));
-    arma::vec weightsTrial(gaussians);
-
-    for (size_t trial = 1; trial < trials; ++trial)
-    {
-      if (useExistingModel)
-      {
-        distsTrial = distsOrig;
-        weightsTrial = weightsOrig;
-      }
-
-      fitter.Estimate(observations, distsTrial, weightsTrial, useExistingModel);
-
-      // Check to see if the log-likelihood of this one is better.
-      double newLikelihood = LogLikelihood(observations, distsTrial,
-          weightsTrial);
-
-      Log::Info << "GMM::Train(): Log-likelihood of trial " << trial << " is "
-          << newLikelihood << "." << std::endl;
-
-      if (newLikelihood > bestLikelihood)
-      {
-        // Save new likelihood and copy new model.
-        bestLikelihood = newLikelihood;
-
-        dists = distsTrial;
-        weights = weightsTrial;
-      }
-    }
+    bestLikelihood = TrainTrials(observations, trials, useExistingModel,
+        fitter, maxMemory, [&](FittingType& trialFitter,
+            std::vector<distribution::GaussianDistribution>& trialDists,
+            arma::vec& trialWeights)
+        {
+          trialFitter.Estimate(observations, trialDists, trialWeights,
+              useExistingModel);
+        });
   }
 
   // Report final log-likelihood and return it.
@@ -110,7 +70,8 @@ double GMM::Train(const arma::mat& observations,
                   const arma::vec& probabilities,
                   const size_t trials,
                   const bool useExistingModel,
-                  FittingType fitter)
+                  FittingType fitter,
+                  const size_t maxMemory)
 {
   double bestLikelihood; // This will be reported later.
 
@@ -128,62 +89,100 @@ double GMM::Train(const arma::mat& observations,
     if (trials == 0)
       return -DBL_MAX; // It's what they asked for...
 
-    // If each trial must start from the same initial location, we must save it.
-    std::vector<distribution::GaussianDistribution> distsOrig;
-    arma::vec weightsOrig;
-    if (useExistingModel)
-    {
-      distsOrig = dists;
-      weightsOrig = weights;
-    }
+    bestLikelihood = TrainTrials(observations, trials, useExistingModel,
+        fitter, maxMemory, [&](FittingType& trialFitter,
+            std::vector<distribution::GaussianDistribution>& trialDists,
+            arma::vec& trialWeights)
+        {
+          trialFitter.Estimate(observations, probabilities, trialDists,
+              trialWeights, useExistingModel);
+        });
+  }
 
-    // We need to keep temporary copies.  We'll do the first training into the
-    // actual model position, so that if it's the best we don't need to copy it.
-    fitter.Estimate(observations, probabilities, dists, weights,
-        useExistingModel);
+  // Report final log-likelihood and return it.
+  Log::Info << "GMM::Train(): log-likelihood of trained GMM is "
+      << bestLikelihood << "." << std::endl;
+  return bestLikelihood;
+}
 
-    bestLikelihood = LogLikelihood(observations, dists, weights);
+/**
+ * Run the trials of Train() in parallel, and keep the best model.
+ */
+template<typename FittingType, typename EstimateType>
+double GMM::TrainTrials(const arma::mat& observations,
+                        const size_t trials,
+                        const bool useExistingModel,
+                        const FittingType& fitter,
+                        const size_t maxMemory,
+                        const EstimateType& estimate)
+{
+  // If each trial must start from the same initial location, we must save it.
+  typedef std::vector<distribution::GaussianDistribution> DistributionVector;
+  const DistributionVector distsOrig = useExistingModel ? dists :
+      DistributionVector(gaussians,
+      distribution::GaussianDistribution(dimensionality));
+  const arma::vec weightsOrig = useExistingModel ? weights :
+      arma::vec(gaussians, arma::fill::zeros);
+
+  // Each trial gets its own random stream, so that its model doesn't depend on
+  // the thread that fits it, or on the number of threads.
+  std::vector<size_t> seeds(trials);
+  for (size_t trial = 0; trial < trials; ++trial)
+    seeds[trial] = math::randGen();
+
+  // Fit as many trials at once as the memory allows.  EMFit holds the
+  // conditional probabilities of all the points for each Gaussian, and k-means
+  // the assignments of all the points.
+  const size_t trialMemory = sizeof(double) * (observations.n_cols *
+      (2 * gaussians + 1) + 4 * gaussians * dimensionality * dimensionality);
+  size_t threads = std::min(NumThreads(), trials);
+  if (maxMemory != 0)
+    threads = std::max((size_t) 1, std::min(threads, maxMemory / trialMemory));
+
+  // A fitter given by reference (e.g. an OnlineEMFit that keeps its
+  // statistics) is shared by the trials, so they must be fit one at a time.
+  if (std::is_reference<FittingType>::value)
+    threads = 1;
+
+  std::vector<double> likelihoods(trials);
+  double bestLikelihood = -DBL_MAX;
+  size_t bestTrial = trials;
+
+  #pragma omp parallel for schedule(dynamic) num_threads(threads)
+  for (omp_size_t trial = 0; trial < (omp_size_t) trials; ++trial)
+  {
+    math::RandomStream stream(seeds[trial]);
 
-    Log::Debug << "GMM::Train(): Log-likelihood of trial 0 is "
-        << bestLikelihood << "." << std::endl;
+    FittingType trialFitter(fitter);
+    std::vector<distribution::GaussianDistribution> trialDists(distsOrig);
+    arma::vec trialWeights(weightsOrig);
+    estimate(trialFitter, trialDists, trialWeights);
 
-    // Now the temporary model.
-    std::vector<distribution::GaussianDistribution> distsTrial(gaussians,
-        distribution::GaussianDistribution(dimensionality));
-    arma::vec weightsTrial(gaussians);
+    const double likelihood = LogLikelihood(observations, trialDists,
+        trialWeights);
+    likelihoods[trial] = likelihood;
 
-    for (size_t trial = 1; trial < trials; ++trial)
+    // Keep the best model; between models with the same likelihood, keep the
+    // first trial, like a sequential fit.
+    #pragma omp critical
     {
-      if (useExistingModel)
-      {
-        distsTrial = distsOrig;
-        weightsTrial = weightsOrig;
-      }
-
-      fitter.Estimate(observations, probabilities, distsTrial, weightsTrial,
-          useExistingModel);
-
-      // Check to see if the log-likelihood of this one is better.
-      double newLikelihood = LogLikelihood(observations, distsTrial,
-          weightsTrial);
-
-      Log::Debug << "GMM::Train(): Log-likelihood of trial " << trial << " is "
-          << newLikelihood << "." << std::endl;
-
-      if (newLikelihood > bestLikelihood)
+      if (likelihood > bestLikelihood || (likelihood == bestLikelihood &&
+          (size_t) trial < bestTrial) || bestTrial == trials)
       {
-        // Save new likelihood and copy new model.
-        bestLikelihood = newLikelihood;
-
-        dists = distsTrial;
-        weights = weightsTrial;
+        bestLikelihood = likelihood;
+        bestTrial = trial;
+        dists = std::move(trialDists);
+        weights = std::move(trialWeights);
       }
     }
   }
 
-  // Report final log-likelihood and return it.
-  Log::Info << "GMM::Train(): log-likelihood of trained GMM is "
-      << bestLikelihood << "." << std::endl;
+  for (size_t trial = 0; trial < trials; ++trial)
+  {
+    Log::Info << "GMM::Train(): Log-likelihood of trial " << trial << " is "
+        << likelihoods[trial] << "." << std::endl;
+  }
+
   return bestLikelihood;
 }
 
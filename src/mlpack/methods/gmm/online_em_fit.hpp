@@ -0,0 +1,235 @@
+/**
+ * @file online_em_fit.hpp
+ *
+ * Utility class to fit a GMM with the online (stochastic) EM algorithm, one
+ * mini-batch of observations at a time.  Used by GMM::Train<>().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+/**
+ * This class fits a GMM to observations with the online EM algorithm of Cappé
+ * and Moulines.  Instead of running the E-step and M-step on the whole dataset,
+ * the observations are visited in mini-batches; the expected sufficient
+ * statistics (the weight, first moment and second moment of each component)
+ * are computed on each mini-batch and blended into running statistics with a
+ * decreasing step size
+ *
+ *   gamma_t = (t + stepOffset)^(-stepDecay),
+ *
+ * and the model is recomputed from the running statistics after each
+ * mini-batch.  The running statistics are exactly those of the current model,
+ * so only the number of updates t has to be kept between calls to Estimate().
+ * This makes it possible to train a GMM on data that arrives in chunks, or that
+ * does not fit in memory, by calling GMM::Train() on each chunk with
+ * useExistingModel set to true.
+ *
+ * Because GMM::Train() takes its fitter by value, the fitter must be passed by
+ * reference for the step-size schedule to carry over from one chunk to the
+ * next:
+ *
+ * @code
+ * GMM gmm(gaussians, dimensionality);
+ * OnlineEMFit<> fitter(1000);
+ * gmm.Train<OnlineEMFit<>&>(firstChunk, 1, false, fitter);
+ * while (...)
+ *   gmm.Train<OnlineEMFit<>&>(nextChunk, 1, true, fitter);
+ * @endcode
+ *
+ * If no initial model is given, EMFit (with the given clusterer and constraint)
+ * is run on the first mini-batch to obtain one.  As with EMFit, the components
+ * may be distribution::GaussianDistribution or
+ * distribution::DiagonalGaussianDistribution objects.
+ */
+template<typename InitialClusteringType = kmeans::KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = distribution::GaussianDistribution>
+class OnlineEMFit
+{
+ public:
+  /**
+   * Construct the OnlineEMFit object.  The step decay should be in (0.5, 1]
+   * for the running statistics to converge.
+   *
+   * @param batchSize Number of observations in each mini-batch.
+   * @param passes Number of passes over the observations in each call to
+   *     Estimate().
+   * @param stepDecay Exponent of the step-size schedule.
+   * @param stepOffset Offset of the step-size schedule; larger values give
+   *     smaller and more stable early steps.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  OnlineEMFit(const size_t batchSize = 1000,
+              const size_t passes = 1,
+              const double stepDecay = 0.6,
+              const double stepOffset = 1.0,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) using online EM.
+   * The size of the vectors (indicating the number of components) must already
+   * be set.  If useInitialModel is true, the given model is updated with the
+   * statistics of the observations; otherwise, an initial model is first fit
+   * to the first mini-batch.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Vector of distributions to store the trained model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used as the starting
+   *      point.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) using online EM,
+   * taking into account the probabilities of each point being from this
+   * mixture.  The size of the vectors (indicating the number of components)
+   * must already be set.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Vector of distributions to store the trained model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used as the starting
+   *      point.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the number of observations in each mini-batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of observations in each mini-batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of passes over the observations.
+  size_t Passes() const { return passes; }
+  //! Modify the number of passes over the observations.
+  size_t& Passes() { return passes; }
+
+  //! Get the exponent of the step-size schedule.
+  double StepDecay() const { return stepDecay; }
+  //! Modify the exponent of the step-size schedule.
+  double& StepDecay() { return stepDecay; }
+
+  //! Get the offset of the step-size schedule.
+  double StepOffset() const { return stepOffset; }
+  //! Modify the offset of the step-size schedule.
+  double& StepOffset() { return stepOffset; }
+
+  //! Get the number of mini-batch updates done so far.
+  size_t Updates() const { return updates; }
+  //! Modify the number of mini-batch updates done so far (set it to 0 to
+  //! restart the step-size schedule).
+  size_t& Updates() { return updates; }
+
+  //! Serialize the fitter.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  //! The type of the covariance of each component (a matrix, or a vector for
+  //! diagonal Gaussians).
+  typedef typename std::decay<decltype(
+      std::declval<const Distribution&>().Covariance())>::type CovarianceType;
+
+  //! Compute the weighted (uncentered) second moment sum_i w_i x_i x_i^T.
+  static arma::mat SecondMoment(
+      const arma::mat& observations,
+      const arma::rowvec& weights,
+      const distribution::GaussianDistribution& /* d */)
+  {
+    return (observations.each_row() % weights) * observations.t();
+  }
+
+  //! Compute the diagonal of the weighted second moment sum_i w_i (x_i % x_i).
+  static arma::vec SecondMoment(
+      const arma::mat& observations,
+      const arma::rowvec& weights,
+      const distribution::DiagonalGaussianDistribution& /* d */)
+  {
+    return arma::square(observations) * weights.t();
+  }
+
+  //! Compute the outer product of a mean with itself.
+  static arma::mat Outer(const arma::vec& mean,
+                         const distribution::GaussianDistribution& /* d */)
+  {
+    return mean * mean.t();
+  }
+
+  //! Compute the diagonal of the outer product of a mean with itself.
+  static arma::vec Outer(
+      const arma::vec& mean,
+      const distribution::DiagonalGaussianDistribution& /* d */)
+  {
+    return arma::square(mean);
+  }
+
+  /**
+   * Run online EM over the observations, starting from the given model.  Each
+   * observation is weighted by the corresponding element of probabilities, if
+   * it is not empty.
+   *
+   * @param observations List of observations.
+   * @param probabilities Probability of each observation, or an empty vector.
+   * @param dists Distributions of the model to update.
+   * @param weights A priori weights of the model to update.
+   */
+  void Update(const arma::mat& observations,
+              const arma::vec& probabilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights);
+
+  //! Number of observations in each mini-batch.
+  size_t batchSize;
+  //! Number of passes over the observations.
+  size_t passes;
+  //! Exponent of the step-size schedule.
+  double stepDecay;
+  //! Offset of the step-size schedule.
+  double stepOffset;
+  //! Number of mini-batch updates done so far.
+  size_t updates;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+};
+
+} // namespace gmm
+} // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,215 @@
+/**
+ * @file online_em_fit_impl.hpp
+ *
+ * Implementation of the online EM algorithm for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+
+namespace mlpack {
+namespace gmm {
+
+//! Constructor.
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+OnlineEMFit(const size_t batchSize,
+            const size_t passes,
+            const double stepDecay,
+            const double stepOffset,
+            InitialClusteringType clusterer,
+            CovarianceConstraintPolicy constraint) :
+    batchSize(batchSize),
+    passes(passes),
+    stepDecay(stepDecay),
+    stepOffset(stepOffset),
+    updates(0),
+    clusterer(clusterer),
+    constraint(constraint)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("OnlineEMFit::OnlineEMFit(): batchSize must "
+        "be positive!");
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  if (observations.n_cols == 0)
+    return;
+
+  // Fit an initial model to the first mini-batch, if we need one.
+  if (!useInitialModel)
+  {
+    const size_t initSize = std::min(batchSize, (size_t) observations.n_cols);
+    EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>
+        em(300, 1e-10, clusterer, constraint);
+    em.Estimate(arma::mat(observations.cols(0, initSize - 1)), dists, weights,
+        false);
+  }
+
+  Update(observations, arma::vec(), dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            const arma::vec& probabilities,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  if (observations.n_cols == 0)
+    return;
+
+  // Fit an initial model to the first mini-batch, if we need one.
+  if (!useInitialModel)
+  {
+    const size_t initSize = std::min(batchSize, (size_t) observations.n_cols);
+    EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>
+        em(300, 1e-10, clusterer, constraint);
+    em.Estimate(arma::mat(observations.cols(0, initSize - 1)),
+        arma::vec(probabilities.subvec(0, initSize - 1)), dists, weights,
+        false);
+  }
+
+  Update(observations, probabilities, dists, weights);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Update(const arma::mat& observations,
+                          const arma::vec& probabilities,
+                          std::vector<Distribution>& dists,
+                          arma::vec& weights)
+{
+  const size_t k = dists.size();
+
+  // Build the running sufficient statistics from the current model: the
+  // weight, the weighted mean, and the weighted second moment of each
+  // component.
+  arma::vec s0 = weights;
+  arma::mat s1(observations.n_rows, k);
+  std::vector<CovarianceType> s2(k);
+  for (size_t i = 0; i < k; ++i)
+  {
+    s1.col(i) = weights[i] * dists[i].Mean();
+    s2[i] = weights[i] * (dists[i].Covariance() +
+        Outer(dists[i].Mean(), dists[i]));
+  }
+
+  arma::vec logProbs;
+  for (size_t pass = 0; pass < passes; ++pass)
+  {
+    for (size_t begin = 0; begin < observations.n_cols; begin += batchSize)
+    {
+      const size_t end = std::min(begin + batchSize,
+          (size_t) observations.n_cols);
+      const arma::mat batch = observations.cols(begin, end - 1);
+
+      // E-step: compute the responsibility of each component (row) for each
+      // point (column) of the mini-batch.
+      arma::mat resp(k, batch.n_cols);
+      for (size_t i = 0; i < k; ++i)
+      {
+        dists[i].LogProbability(batch, logProbs);
+        resp.row(i) = arma::trans(logProbs) + std::log(weights[i]);
+      }
+
+      for (size_t j = 0; j < batch.n_cols; ++j)
+      {
+        const double maxLog = resp.col(j).max();
+        if (std::isfinite(maxLog))
+        {
+          resp.col(j) = arma::exp(resp.col(j) - maxLog);
+          resp.col(j) /= arma::accu(resp.col(j));
+        }
+        else
+        {
+          // This point has zero probability under every component.
+          resp.col(j).zeros();
+        }
+      }
+
+      double total = batch.n_cols;
+      if (probabilities.n_elem > 0)
+      {
+        resp.each_row() %= arma::trans(probabilities.subvec(begin, end - 1));
+        total = arma::accu(probabilities.subvec(begin, end - 1));
+      }
+
+      if (total <= 0.0)
+        continue;
+
+      // Blend the statistics of this mini-batch into the running statistics.
+      const double step = std::pow((double) updates + stepOffset, -stepDecay);
+      ++updates;
+
+      s0 = (1.0 - step) * s0 + (step / total) * arma::sum(resp, 1);
+      s1 = (1.0 - step) * s1 + (step / total) * (batch * resp.t());
+      for (size_t i = 0; i < k; ++i)
+      {
+        s2[i] = (1.0 - step) * s2[i] +
+            (step / total) * SecondMoment(batch, resp.row(i), dists[i]);
+      }
+
+      // M-step: recompute the model from the running statistics.  Components
+      // that have lost all of their weight are left unchanged.
+      weights = s0 / arma::accu(s0);
+      for (size_t i = 0; i < k; ++i)
+      {
+        if (s0[i] <= 0.0)
+          continue;
+
+        arma::vec mean = s1.col(i) / s0[i];
+        CovarianceType covariance = s2[i] / s0[i] - Outer(mean, dists[i]);
+        constraint.ApplyConstraint(covariance);
+
+        dists[i].Mean() = std::move(mean);
+        dists[i].Covariance(std::move(covariance));
+      }
+    }
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(batchSize);
+  ar & BOOST_SERIALIZATION_NVP(passes);
+  ar & BOOST_SERIALIZATION_NVP(stepDecay);
+  ar & BOOST_SERIALIZATION_NVP(stepOffset);
+  ar & BOOST_SERIALIZATION_NVP(updates);
+  ar & BOOST_SERIALIZATION_NVP(clusterer);
+  ar & BOOST_SERIALIZATION_NVP(constraint);
+}
+
+} // namespace gmm
+} // namespace mlpack
+
+#endif
@@ -62,6 +62,19 @@ class PositiveDefiniteConstraint
     }
   }
 
+  /**
+   * Apply the positive definiteness constraint to the given diagonal of a
+   * covariance matrix: each element is made at least 1e-50, and large enough
+   * that the condition number is at most 1e5.
+   *
+   * @param diagCovariance Diagonal of a covariance matrix.
+   */
+  static void ApplyConstraint(arma::vec& diagCovariance)
+  {
+    const double minVariance = std::max(diagCovariance.max() / 1e5, 1e-50);
+    diagCovariance = arma::clamp(diagCovariance, minVariance, DBL_MAX);
+  }
+
   //! Serialize the constraint (which stores nothing, so, nothing to do).
   template<typename Archive>
   static void serialize(Archive& /* ar */, const unsigned int /* version */) { }
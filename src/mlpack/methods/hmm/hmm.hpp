@@ -284,6 +284,29 @@ class HMM
   double Predict(const arma::mat& dataSeq,
                  arma::Row<size_t>& stateSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence for the given data
+   * sequence with a checkpointed Viterbi algorithm, returning the
+   * log-likelihood of the most likely state sequence.  The result is the same
+   * as Predict(), but instead of keeping the Viterbi scores and backpointers
+   * of every time step, only the scores of every checkpointInterval-th step are
+   * kept; the backpointers of each interval are recomputed from its checkpoint
+   * during the backtracking.  This takes O(checkpointInterval * states +
+   * (length / checkpointInterval) * states) memory, which is
+   * O(sqrt(length) * states) for the default interval, at the cost of
+   * evaluating the forward recursion and the emission probabilities twice.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateSeq Vector in which the most probable state sequence will be
+   *    stored.
+   * @param checkpointInterval Number of time steps between checkpoints; if 0,
+   *    ceil(sqrt(length)) is used.
+   * @return Log-likelihood of most probable state sequence.
+   */
+  double PredictCheckpointed(const arma::mat& dataSeq,
+                             arma::Row<size_t>& stateSeq,
+                             const size_t checkpointInterval = 0) const;
+
   /**
    * Compute the log-likelihood of the given data sequence.
    *
@@ -384,6 +407,71 @@ class HMM
                 const arma::vec& logScales,
                 arma::mat& backwardLogProb) const;
 
+  /**
+   * Compute the log probability of every observation in the given data
+   * sequence under every emission distribution.  The returned matrix has rows
+   * equal to the number of hidden states and columns equal to the number of
+   * observations.  If the Distribution type provides a batch
+   * LogProbability(const arma::mat&, arma::vec&) method, each row is computed
+   * with a single call to it.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logProbs Matrix in which the emission log probabilities will be
+   *     saved.
+   */
+  void EmissionLogProbability(const arma::mat& dataSeq,
+                              arma::mat& logProbs) const;
+
+  /**
+   * The Forward algorithm, using emission log probabilities that have already
+   * been computed with EmissionLogProbability().
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logScales Vector in which scaling factors will be saved.
+   * @param forwardLogProb Matrix in which forward probabilities will be saved.
+   * @param logProbs Emission log probabilities of the data sequence.
+   */
+  void Forward(const arma::mat& dataSeq,
+               arma::vec& logScales,
+               arma::mat& forwardLogProb,
+               const arma::mat& logProbs) const;
+
+  /**
+   * The Backward algorithm, using emission log probabilities that have already
+   * been computed with EmissionLogProbability().
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logScales Vector of scaling factors.
+   * @param backwardLogProb Matrix in which backward probabilities will be
+   *     saved.
+   * @param logProbs Emission log probabilities of the data sequence.
+   */
+  void Backward(const arma::mat& dataSeq,
+                const arma::vec& logScales,
+                arma::mat& backwardLogProb,
+                const arma::mat& logProbs) const;
+
+  /**
+   * Run the Viterbi recursion over the time steps [begin, end) of the given
+   * data sequence.  On input, score holds the Viterbi scores of each state at
+   * time begin - 1 (it is ignored if begin is 0); on output, it holds the
+   * scores at time end - 1.  If backpointers is not NULL, the best previous
+   * state of state j at time t is stored in (*backpointers)(j, t - begin).
+   *
+   * @param dataSeq Data sequence.
+   * @param logTrans Transposed log transition matrix.
+   * @param begin First time step to compute.
+   * @param end One past the last time step to compute.
+   * @param score Viterbi scores of each state.
+   * @param backpointers Matrix to store backpointers in, or NULL.
+   */
+  void ViterbiSteps(const arma::mat& dataSeq,
+                    const arma::mat& logTrans,
+                    const size_t begin,
+                    const size_t end,
+                    arma::vec& score,
+                    arma::Mat<size_t>* backpointers) const;
+
   //! Set of emission probability distributions; one for each state.
   std::vector<Distribution> emission;
 
@@ -17,10 +17,64 @@
 // Just in case...
 #include "hmm.hpp"
 #include <mlpack/core/math/log_add.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 
 namespace mlpack {
 namespace hmm {
 
+/**
+ * This gives us a HasBatchLogProbability object that we can use to tell whether
+ * or not an emission distribution can evaluate many observations at once.
+ */
+HAS_MEM_FUNC(LogProbability, HasBatchLogProbabilityCheck);
+
+/**
+ * 'value' is true if the Distribution class has a member
+ * LogProbability(const arma::mat& x, arma::vec& logProbabilities) const.
+ */
+template<typename Distribution>
+struct HasBatchLogProbability
+{
+  static const bool value = HasBatchLogProbabilityCheck<Distribution,
+      void(Distribution::*)(const arma::mat&, arma::vec&) const>::value;
+};
+
+//! Compute the emission log probabilities with the batch LogProbability() of
+//! each distribution, if it has one.
+template<typename Distribution>
+void EmissionLogProbabilities(
+    const std::vector<Distribution>& emission,
+    const arma::mat& dataSeq,
+    arma::mat& logProbs,
+    const typename std::enable_if_t<
+        HasBatchLogProbability<Distribution>::value>* = 0)
+{
+  logProbs.set_size(emission.size(), dataSeq.n_cols);
+  arma::vec stateLogProbs;
+  for (size_t state = 0; state < emission.size(); state++)
+  {
+    emission[state].LogProbability(dataSeq, stateLogProbs);
+    logProbs.row(state) = trans(stateLogProbs);
+  }
+}
+
+//! Compute the emission log probabilities one observation at a time, if the
+//! distribution has no batch LogProbability().
+template<typename Distribution>
+void EmissionLogProbabilities(
+    const std::vector<Distribution>& emission,
+    const arma::mat& dataSeq,
+    arma::mat& logProbs,
+    const typename std::enable_if_t<
+        !HasBatchLogProbability<Distribution>::value>* = 0)
+{
+  logProbs.set_size(emission.size(), dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; t++)
+    for (size_t state = 0; state < emission.size(); state++)
+      logProbs(state, t) =
+          emission[state].LogProbability(dataSeq.unsafe_col(t));
+}
+
 /**
  * Create the Hidden Markov Model with the given number of hidden states and the
  * given number of emission states.
@@ -105,10 +159,28 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   }
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The observations
+  // of each sequence are stored at a fixed offset in the emission list, so the
+  // list only has to be filled once.
   std::vector<arma::vec> emissionProb(transition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> offsets(dataSeq.size());
+  arma::uvec lengths(dataSeq.size());
+  size_t offset = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = offset;
+    lengths[seq] = dataSeq[seq].n_cols;
+    if (dataSeq[seq].n_cols > 0)
+      emissionList.cols(offset, offset + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    offset += dataSeq[seq].n_cols;
+  }
+
+  // The sequences are handed out to threads longest first, so that the short
+  // sequences at the end balance the load.
+  const arma::uvec order = arma::sort_index(lengths, "descend");
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -124,53 +196,87 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
-
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // Loop over each sequence in parallel.  Each thread accumulates its own
+    // expected initial and transition counts, which are combined at the end;
+    // the emission weights of each sequence go to a disjoint range of
+    // emissionProb.
+    #pragma omp parallel reduction(+:loglik)
     {
-      arma::mat stateLogProb;
-      arma::mat forwardLog;
-      arma::mat backwardLog;
-      arma::vec logScales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      for (size_t j = 0; j < transition.n_cols; ++j)
-        newLogInitial[j] = math::LogAdd(newLogInitial[j], stateLogProb(j, 0));
-
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      arma::vec localLogInitial(transition.n_rows);
+      localLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::mat localLogTransition(transition.n_rows, transition.n_cols);
+      localLogTransition.fill(-std::numeric_limits<double>::infinity());
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t s = 0; s < (omp_size_t) dataSeq.size(); ++s)
       {
+        const size_t seq = order[s];
+        arma::mat stateLogProb;
+        arma::mat forwardLog;
+        arma::mat backwardLog;
+        arma::vec logScales;
+        arma::mat logProbs;
+
+        // Add the log-likelihood of this sequence.  This is the E-step.  The
+        // emission log probabilities are computed once and shared by the
+        // forward and backward passes and the transition estimate.
+        EmissionLogProbability(dataSeq[seq], logProbs);
+        Forward(dataSeq[seq], logScales, forwardLog, logProbs);
+        Backward(dataSeq[seq], logScales, backwardLog, logProbs);
+        stateLogProb = forwardLog + backwardLog;
+        loglik += accu(logScales);
+
+        // Add to estimate of initial probability for state j.
         for (size_t j = 0; j < transition.n_cols; ++j)
         {
-          if (t < dataSeq[seq].n_cols - 1)
+          localLogInitial[j] = math::LogAdd(localLogInitial[j],
+              stateLogProb(j, 0));
+        }
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.
+        for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+        {
+          for (size_t j = 0; j < transition.n_cols; ++j)
           {
-            // Estimate of T_ij (probability of transition from state j to state
-            // i).  We postpone multiplication of the old T_ij until later.
-            for (size_t i = 0; i < transition.n_rows; i++)
+            if (t < dataSeq[seq].n_cols - 1)
             {
-              newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
-                  forwardLog(j, t) + backwardLog(i, t + 1) +
-                  emission[i].LogProbability(dataSeq[seq].unsafe_col(t + 1)) -
-                  logScales[t + 1]);
+              // Estimate of T_ij (probability of transition from state j to
+              // state i).  We postpone multiplication of the old T_ij until
+              // later.
+              for (size_t i = 0; i < transition.n_rows; i++)
+              {
+                localLogTransition(i, j) = math::LogAdd(
+                    localLogTransition(i, j),
+                    forwardLog(j, t) + backwardLog(i, t + 1) +
+                    logProbs(i, t + 1) - logScales[t + 1]);
+              }
             }
+
+            // Add to the emission weights, for Distribution::Train().
+            emissionProb[j][offsets[seq] + t] = exp(stateLogProb(j, t));
           }
+        }
+      }
 
-          // Add to list of emission observations, for Distribution::Train().
-          emissionList.col(sumTime) = dataSeq[seq].col(t);
-          emissionProb[j][sumTime] = exp(stateLogProb(j, t));
+      // Combine the counts from each thread.
+      #pragma omp critical
+      {
+        for (size_t j = 0; j < transition.n_cols; ++j)
+        {
+          newLogInitial[j] = math::LogAdd(newLogInitial[j],
+              localLogInitial[j]);
+          for (size_t i = 0; i < transition.n_rows; ++i)
+          {
+            newLogTransition(i, j) = math::LogAdd(newLogTransition(i, j),
+                localLogTransition(i, j));
+          }
         }
-        sumTime++;
       }
     }
 
@@ -321,8 +427,10 @@ double HMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
                                       arma::vec& logScales) const
 {
   // First run the forward-backward algorithm.
-  Forward(dataSeq, logScales, forwardLogProb);
-  Backward(dataSeq, logScales, backwardLogProb);
+  arma::mat logProbs;
+  EmissionLogProbability(dataSeq, logProbs);
+  Forward(dataSeq, logScales, forwardLogProb, logProbs);
+  Backward(dataSeq, logScales, backwardLogProb, logProbs);
 
   // Now assemble the state probability matrix based on the forward and backward
   // probabilities.
@@ -440,54 +548,145 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Row<size_t>& stateSeq) const
 {
   // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
+  // probable sequence of states to produce the observed data sequence.  Only
+  // the scores of the current time step are kept, together with the best
+  // previous state of each state at each time step.
   stateSeq.set_size(dataSeq.n_cols);
-  arma::mat logStateProb(transition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(transition.n_rows, dataSeq.n_cols);
 
   // Store the logs of the transposed transition matrix.  This is because we
   // will be using the rows of the transition matrix.
-  arma::mat logTrans(log(trans(transition)));
+  const arma::mat logTrans(log(trans(transition)));
 
   // The calculation of the first state is slightly different; the probability
   // of the first state being state j is the maximum probability that the state
   // came to be j from another state.
-  logStateProb.col(0).zeros();
-  for (size_t state = 0; state < transition.n_rows; state++)
+  arma::vec score;
+  ViterbiSteps(dataSeq, logTrans, 0, 1, score, NULL);
+
+  // Given that we are in state j at time t, stateSeqBack(j, t - 1) is the state
+  // with the highest probability of being the previous state.
+  arma::Mat<size_t> stateSeqBack(transition.n_rows, dataSeq.n_cols - 1);
+  ViterbiSteps(dataSeq, logTrans, 1, dataSeq.n_cols, score, &stateSeqBack);
+
+  // Backtrack to find the most probable state sequence.
+  arma::uword index;
+  const double logLikelihood = score.max(index);
+  stateSeq[dataSeq.n_cols - 1] = index;
+  for (size_t t = dataSeq.n_cols - 1; t > 0; --t)
+    stateSeq[t - 1] = stateSeqBack(stateSeq[t], t - 1);
+
+  return logLikelihood;
+}
+
+/**
+ * Compute the most probable hidden state sequence for the given observation
+ * using the Viterbi algorithm, keeping only checkpoints of the Viterbi scores.
+ */
+template<typename Distribution>
+double HMM<Distribution>::PredictCheckpointed(
+    const arma::mat& dataSeq,
+    arma::Row<size_t>& stateSeq,
+    const size_t checkpointInterval) const
+{
+  const size_t length = dataSeq.n_cols;
+  const size_t states = transition.n_rows;
+  stateSeq.set_size(length);
+  if (length == 0)
+    return 0.0;
+
+  const size_t interval = (checkpointInterval > 0) ? checkpointInterval :
+      (size_t) std::ceil(std::sqrt((double) length));
+  const size_t numSegments = (length + interval - 1) / interval;
+
+  // logTrans(i, j) is the log probability of a transition from state i to
+  // state j.
+  const arma::mat logTrans(log(trans(transition)));
+
+  // The Viterbi scores at the first time step of each segment.
+  arma::mat checkpoints(states, numSegments);
+
+  // Forward pass: only keep the scores at the start of each segment.
+  arma::vec score;
+  for (size_t s = 0; s < numSegments; ++s)
   {
-    logStateProb(state, 0) = log(initial[state]) +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
-    stateSeqBack(state, 0) = state;
+    const size_t begin = s * interval;
+    const size_t end = std::min(length, begin + interval);
+    ViterbiSteps(dataSeq, logTrans, begin, begin + 1, score, NULL);
+    checkpoints.col(s) = score;
+    ViterbiSteps(dataSeq, logTrans, begin + 1, end, score, NULL);
   }
 
-  // Store the best first state.
+  // The best final state.
   arma::uword index;
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  const double logLikelihood = score.max(index);
+  stateSeq[length - 1] = index;
+
+  // Backtrack one segment at a time, recomputing the backpointers of each
+  // segment from its checkpoint.
+  arma::Mat<size_t> backpointers(states, interval - 1);
+  arma::vec prob(states);
+  for (size_t s = numSegments; s > 0; --s)
   {
-    // Assemble the state probability for this element.
-    // Given that we are in state j, we use state with the highest probability
-    // of being the previous state.
-    for (size_t j = 0; j < transition.n_rows; j++)
+    const size_t begin = (s - 1) * interval;
+    const size_t end = std::min(length, begin + interval);
+
+    score = checkpoints.col(s - 1);
+    ViterbiSteps(dataSeq, logTrans, begin + 1, end, score, &backpointers);
+
+    // Find the state at the last time step of this segment from the state at
+    // the first time step of the next segment.
+    if (end < length)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTrans.col(j);
-      logStateProb(j, t) = prob.max(index) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
-      stateSeqBack(j, t) = index;
+      prob = score + logTrans.col(stateSeq[end]);
+      prob.max(index);
+      stateSeq[end - 1] = index;
     }
+
+    for (size_t t = end - 1; t > begin; --t)
+      stateSeq[t - 1] = backpointers(stateSeq[t], t - begin - 1);
   }
 
-  // Backtrack to find the most probable state sequence.
-  logStateProb.unsafe_col(dataSeq.n_cols - 1).max(index);
-  stateSeq[dataSeq.n_cols - 1] = index;
-  for (size_t t = 2; t <= dataSeq.n_cols; t++)
+  return logLikelihood;
+}
+
+/**
+ * Run the Viterbi recursion over the time steps [begin, end).
+ */
+template<typename Distribution>
+void HMM<Distribution>::ViterbiSteps(const arma::mat& dataSeq,
+                                     const arma::mat& logTrans,
+                                     const size_t begin,
+                                     const size_t end,
+                                     arma::vec& score,
+                                     arma::Mat<size_t>* backpointers) const
+{
+  if (end <= begin)
+    return;
+
+  arma::mat logProbs;
+  EmissionLogProbability(dataSeq.cols(begin, end - 1), logProbs);
+
+  arma::vec prob(transition.n_rows);
+  arma::vec newScore(transition.n_rows);
+  arma::uword index;
+  for (size_t t = begin; t < end; ++t)
   {
-    stateSeq[dataSeq.n_cols - t] =
-        stateSeqBack(stateSeq[dataSeq.n_cols - t + 1], dataSeq.n_cols - t + 1);
-  }
+    // The score of the first state only depends on the initial probabilities.
+    if (t == 0)
+    {
+      score = log(initial) + logProbs.col(0);
+      continue;
+    }
 
-  return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
+    for (size_t j = 0; j < transition.n_rows; ++j)
+    {
+      prob = score + logTrans.col(j);
+      newScore[j] = prob.max(index) + logProbs(j, t - begin);
+      if (backpointers)
+        (*backpointers)(j, t - begin) = index;
+    }
+    score = newScore;
+  }
 }
 
 /**
@@ -560,6 +759,17 @@ template<typename Distribution>
 void HMM<Distribution>::Forward(const arma::mat& dataSeq,
                                 arma::vec& logScales,
                                 arma::mat& forwardLogProb) const
+{
+  arma::mat logProbs;
+  EmissionLogProbability(dataSeq, logProbs);
+  Forward(dataSeq, logScales, forwardLogProb, logProbs);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Forward(const arma::mat& dataSeq,
+                                arma::vec& logScales,
+                                arma::mat& forwardLogProb,
+                                const arma::mat& logProbs) const
 {
   // Our goal is to calculate the forward probabilities:
   //  P(X_k | o_{1:k}) for all possible states X_k, for each time point k.
@@ -577,8 +787,7 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
   // sequence and that should produce results in line with MATLAB.
   for (size_t state = 0; state < transition.n_rows; state++)
   {
-    forwardLogProb(state, 0) = log(initial(state)) +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
+    forwardLogProb(state, 0) = log(initial(state)) + logProbs(state, 0);
   }
 
   // Then normalize the column.
@@ -587,6 +796,7 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
     forwardLogProb.col(0) -= logScales[0];
 
   // Now compute the probabilities for each successive observation.
+  arma::vec tmp(transition.n_rows);
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
     for (size_t j = 0; j < transition.n_rows; j++)
@@ -594,9 +804,8 @@ void HMM<Distribution>::Forward(const arma::mat& dataSeq,
       // The forward probability of state j at time t is the sum over all states
       // of the probability of the previous state transitioning to the current
       // state and emitting the given observation.
-      arma::vec tmp = forwardLogProb.col(t - 1) + logTrans.col(j);
-      forwardLogProb(j, t) = math::AccuLog(tmp) +
-          emission[j].LogProbability(dataSeq.unsafe_col(t));
+      tmp = forwardLogProb.col(t - 1) + logTrans.col(j);
+      forwardLogProb(j, t) = math::AccuLog(tmp) + logProbs(j, t);
     }
 
     // Normalize probability.
@@ -610,6 +819,17 @@ template<typename Distribution>
 void HMM<Distribution>::Backward(const arma::mat& dataSeq,
                                  const arma::vec& logScales,
                                  arma::mat& backwardLogProb) const
+{
+  arma::mat logProbs;
+  EmissionLogProbability(dataSeq, logProbs);
+  Backward(dataSeq, logScales, backwardLogProb, logProbs);
+}
+
+template<typename Distribution>
+void HMM<Distribution>::Backward(const arma::mat& dataSeq,
+                                 const arma::vec& logScales,
+                                 arma::mat& backwardLogProb,
+                                 const arma::mat& logProbs) const
 {
   // Our goal is to calculate the backward probabilities:
   //  P(X_k | o_{k + 1:T}) for all possible states X_k, for each time point k.
@@ -621,20 +841,22 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
   backwardLogProb.col(dataSeq.n_cols - 1).fill(0);
 
   // Now step backwards through all other observations.
+  arma::vec next(transition.n_rows);
+  arma::vec tmp(transition.n_rows);
   for (size_t t = dataSeq.n_cols - 2; t + 1 > 0; t--)
   {
+    // The backward probability of each state at time t + 1, times the
+    // probability of that state emitting the observation at time t + 1.
+    next = backwardLogProb.col(t + 1) + logProbs.col(t + 1);
+
     for (size_t j = 0; j < transition.n_rows; j++)
     {
       // The backward probability of state j at time t is the sum over all state
       // of the probability of the next state having been a transition from the
       // current state multiplied by the probability of each of those states
       // emitting the given observation.
-      for (size_t state = 0; state < transition.n_rows; state++)
-      {
-        backwardLogProb(j, t) = math::LogAdd(backwardLogProb(j, t),
-            logTrans(state, j) + backwardLogProb(state, t + 1)
-            + emission[state].LogProbability(dataSeq.unsafe_col(t + 1)));
-      }
+      tmp = logTrans.col(j) + next;
+      backwardLogProb(j, t) = math::AccuLog(tmp);
 
       // Normalize by the weights from the forward algorithm.
       if (std::isfinite(logScales[t + 1]))
@@ -643,6 +865,16 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
   }
 }
 
+/**
+ * Compute the emission log probabilities of each observation under each state.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionLogProbability(const arma::mat& dataSeq,
+                                               arma::mat& logProbs) const
+{
+  EmissionLogProbabilities(emission, dataSeq, logProbs);
+}
+
 //! Serialize the HMM.
 template<typename Distribution>
 template<typename Archive>
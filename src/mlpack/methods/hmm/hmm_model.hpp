@@ -14,6 +14,7 @@
 
 #include "hmm.hpp"
 #include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/gmm/diagonal_gmm.hpp>
 
 namespace mlpack {
 namespace hmm {
@@ -22,7 +23,8 @@ enum HMMType : char
 {
   DiscreteHMM = 0,
   GaussianHMM,
-  GaussianMixtureModelHMM
+  GaussianMixtureModelHMM,
+  DiagonalGaussianMixtureModelHMM
 };
 
 /**
@@ -39,6 +41,8 @@ class HMMModel
   HMM<distribution::GaussianDistribution>* gaussianHMM;
   //! Not used if type is not GaussianMixtureModelHMM.
   HMM<gmm::GMM>* gmmHMM;
+  //! Not used if type is not DiagonalGaussianMixtureModelHMM.
+  HMM<gmm::DiagonalGMM>* diagGMMHMM;
 
  public:
   //! Construct an uninitialized model.
@@ -46,7 +50,8 @@ class HMMModel
       type(HMMType::DiscreteHMM),
       discreteHMM(new HMM<distribution::DiscreteDistribution>()),
       gaussianHMM(NULL),
-      gmmHMM(NULL)
+      gmmHMM(NULL),
+      diagGMMHMM(NULL)
   {
     // Nothing to do.
   }
@@ -56,7 +61,8 @@ class HMMModel
       type(type),
       discreteHMM(NULL),
       gaussianHMM(NULL),
-      gmmHMM(NULL)
+      gmmHMM(NULL),
+      diagGMMHMM(NULL)
   {
     if (type == HMMType::DiscreteHMM)
       discreteHMM = new HMM<distribution::DiscreteDistribution>();
@@ -64,6 +70,8 @@ class HMMModel
       gaussianHMM = new HMM<distribution::GaussianDistribution>();
     else if (type == HMMType::GaussianMixtureModelHMM)
       gmmHMM = new HMM<gmm::GMM>();
+    else if (type == HMMType::DiagonalGaussianMixtureModelHMM)
+      diagGMMHMM = new HMM<gmm::DiagonalGMM>();
   }
 
   //! Copy another model.
@@ -71,7 +79,8 @@ class HMMModel
       type(other.type),
       discreteHMM(NULL),
       gaussianHMM(NULL),
-      gmmHMM(NULL)
+      gmmHMM(NULL),
+      diagGMMHMM(NULL)
   {
     if (type == HMMType::DiscreteHMM)
       discreteHMM =
@@ -81,6 +90,8 @@ class HMMModel
           new HMM<distribution::GaussianDistribution>(*other.gaussianHMM);
     else if (type == HMMType::GaussianMixtureModelHMM)
       gmmHMM = new HMM<gmm::GMM>(*other.gmmHMM);
+    else if (type == HMMType::DiagonalGaussianMixtureModelHMM)
+      diagGMMHMM = new HMM<gmm::DiagonalGMM>(*other.diagGMMHMM);
   }
 
   //! Take ownership of another model.
@@ -88,12 +99,14 @@ class HMMModel
       type(other.type),
       discreteHMM(other.discreteHMM),
       gaussianHMM(other.gaussianHMM),
-      gmmHMM(other.gmmHMM)
+      gmmHMM(other.gmmHMM),
+      diagGMMHMM(other.diagGMMHMM)
   {
     other.type = HMMType::DiscreteHMM;
     other.discreteHMM = new HMM<distribution::DiscreteDistribution>();
     other.gaussianHMM = NULL;
     other.gmmHMM = NULL;
+    other.diagGMMHMM = NULL;
   }
 
   //! Copy assignment operator.
@@ -105,10 +118,12 @@ class HMMModel
     delete discreteHMM;
     delete gaussianHMM;
     delete gmmHMM;
+    delete diagGMMHMM;
 
     discreteHMM = NULL;
     gaussianHMM = NULL;
     gmmHMM = NULL;
+    diagGMMHMM = NULL;
 
     type = other.type;
     if (type == HMMType::DiscreteHMM)
@@ -119,6 +134,8 @@ class HMMModel
           new HMM<distribution::GaussianDistribution>(*other.gaussianHMM);
     else if (type == HMMType::GaussianMixtureModelHMM)
       gmmHMM = new HMM<gmm::GMM>(*other.gmmHMM);
+    else if (type == HMMType::DiagonalGaussianMixtureModelHMM)
+      diagGMMHMM = new HMM<gmm::DiagonalGMM>(*other.diagGMMHMM);
 
     return *this;
   }
@@ -129,6 +146,7 @@ class HMMModel
     delete discreteHMM;
     delete gaussianHMM;
     delete gmmHMM;
+    delete diagGMMHMM;
   }
 
   /**
@@ -145,6 +163,8 @@ class HMMModel
       ActionType::Apply(*gaussianHMM, x);
     else if (type == HMMType::GaussianMixtureModelHMM)
       ActionType::Apply(*gmmHMM, x);
+    else if (type == HMMType::DiagonalGaussianMixtureModelHMM)
+      ActionType::Apply(*diagGMMHMM, x);
   }
 
   //! Serialize the model.
@@ -159,10 +179,13 @@ class HMMModel
       delete discreteHMM;
       delete gaussianHMM;
       delete gmmHMM;
+      delete diagGMMHMM;
+    delete diagGMMHMM;
 
       discreteHMM = NULL;
       gaussianHMM = NULL;
       gmmHMM = NULL;
+      diagGMMHMM = NULL;
     }
 
     if (type == HMMType::DiscreteHMM)
@@ -171,21 +194,24 @@ class HMMModel
       ar & BOOST_SERIALIZATION_NVP(gaussianHMM);
     else if (type == HMMType::GaussianMixtureModelHMM)
       ar & BOOST_SERIALIZATION_NVP(gmmHMM);
+    else if (type == HMMType::DiagonalGaussianMixtureModelHMM)
+      ar & BOOST_SERIALIZATION_NVP(diagGMMHMM);
   }
 
   // Accessor method for type of HMM
   HMMType Type() { return type; }
 
   /**
-   * Accessor methods for discreteHMM, gaussianHMM and gmmHMM.
+   * Accessor methods for discreteHMM, gaussianHMM, gmmHMM and diagGMMHMM.
    * Note that an instatiation of this class will only contain one type of HMM
-   * (as indicated by the "type" instance variable) - the other two pointers
-   * will be NULL.
+   * (as indicated by the "type" instance variable) - the other pointers will
+   * be NULL.
    *
    * For instance, if the HMMModel object holds a discrete HMM, then:
    * type         --> DiscreteHMM
    * gaussianHMM  --> NULL
    * gmmHMM       --> NULL
+   * diagGMMHMM   --> NULL
    * discreteHMM  --> HMM<DiscreteDistribution> object
    * and hence, calls to GMMHMM() and GaussianHMM() will return NULL. Only the
    * call to DiscreteHMM() will return a non NULL pointer.
@@ -197,6 +223,7 @@ class HMMModel
   HMM<distribution::DiscreteDistribution>* DiscreteHMM() { return discreteHMM; }
   HMM<distribution::GaussianDistribution>* GaussianHMM() { return gaussianHMM; }
   HMM<gmm::GMM>* GMMHMM() { return gmmHMM; }
+  HMM<gmm::DiagonalGMM>* DiagGMMHMM() { return diagGMMHMM; }
 };
 
 } // namespace hmm
@@ -17,6 +17,7 @@
 #include "hmm_model.hpp"
 
 #include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/gmm/diagonal_gmm.hpp>
 
 using namespace mlpack;
 using namespace mlpack::hmm;
@@ -34,8 +35,10 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Training",
     "with other mlpack HMM tools.",
     // Long description.
     "This program allows a Hidden Markov Model to be trained on labeled or "
-    "unlabeled data.  It supports three types of HMMs: discrete HMMs, "
-    "Gaussian HMMs, or GMM HMMs."
+    "unlabeled data.  It supports four types of HMMs: discrete HMMs, "
+    "Gaussian HMMs, GMM HMMs, or GMM HMMs whose Gaussians have diagonal "
+    "covariance ('diag_gmm'), which are much faster to train in high "
+    "dimensions."
     "\n\n"
     "Either one input sequence can be specified (with --input_file), or, a "
     "file containing files in which input sequences can be found (when "
@@ -62,8 +65,8 @@ PROGRAM_INFO("Hidden Markov Model (HMM) Training",
         "@doxygen/classmlpack_1_1hmm_1_1HMM.html"));
 
 PARAM_STRING_IN_REQ("input_file", "File containing input observations.", "i");
-PARAM_STRING_IN("type", "Type of HMM: discrete | gaussian | gmm.", "t",
-    "gaussian");
+PARAM_STRING_IN("type", "Type of HMM: discrete | gaussian | gmm | diag_gmm.",
+    "t", "gaussian");
 
 PARAM_FLAG("batch", "If true, input_file (and if passed, labels_file) are "
     "expected to contain a list of files to use as input observation sequences "
@@ -71,7 +74,7 @@ PARAM_FLAG("batch", "If true, input_file (and if passed, labels_file) are "
 PARAM_INT_IN("states", "Number of hidden states in HMM (necessary, unless "
     "model_file is specified).", "n", 0);
 PARAM_INT_IN("gaussians", "Number of gaussians in each GMM (necessary when type"
-    " is 'gmm').", "g", 0);
+    " is 'gmm' or 'diag_gmm').", "g", 0);
 PARAM_MODEL_IN(HMMModel, "input_model", "Pre-existing HMM model to initialize "
     "training with.", "m");
 PARAM_STRING_IN("labels_file", "Optional file of hidden states, used for "
@@ -151,6 +154,25 @@ struct Init
                      vector<mat>& trainSeq,
                      size_t states,
                      double tolerance)
+  {
+    CreateGMM(hmm, trainSeq, states, tolerance);
+  }
+
+  //! Helper function to create diagonal GMM HMM.
+  static void Create(HMM<DiagonalGMM>& hmm,
+                     vector<mat>& trainSeq,
+                     size_t states,
+                     double tolerance)
+  {
+    CreateGMM(hmm, trainSeq, states, tolerance);
+  }
+
+  //! Helper function to create an HMM with either type of GMM.
+  template<typename GMMType>
+  static void CreateGMM(HMM<GMMType>& hmm,
+                        vector<mat>& trainSeq,
+                        size_t states,
+                        double tolerance)
   {
     // Find dimension of the data.
     const size_t dimensionality = trainSeq[0].n_rows;
@@ -159,7 +181,7 @@ struct Init
     if (gaussians == 0)
     {
       Log::Fatal << "Number of gaussians for each GMM must be specified "
-          << "when type = 'gmm'!" << endl;
+          << "when type = 'gmm' or type = 'diag_gmm'!" << endl;
     }
 
     if (gaussians < 0)
@@ -169,8 +191,8 @@ struct Init
     }
 
     // Create HMM object.
-    hmm = HMM<GMM>(size_t(states), GMM(size_t(gaussians), dimensionality),
-        tolerance);
+    hmm = HMM<GMMType>(size_t(states),
+        GMMType(size_t(gaussians), dimensionality), tolerance);
 
     // Issue a warning if the user didn't give labels.
     if (!CLI::HasParam("labels_file"))
@@ -225,6 +247,30 @@ struct Init
       }
     }
   }
+
+  //! Helper function for diagonal GMM emission distributions.
+  static void RandomInitialize(vector<DiagonalGMM>& e)
+  {
+    for (size_t i = 0; i < e.size(); ++i)
+    {
+      // Random weights.
+      e[i].Weights().randu();
+      e[i].Weights() /= arma::accu(e[i].Weights());
+
+      // Random means and covariances.
+      for (int g = 0; g < CLI::GetParam<int>("gaussians"); ++g)
+      {
+        const size_t dimensionality = e[i].Component(g).Mean().n_rows;
+        e[i].Component(g).Mean().randu();
+
+        // Generate a random covariance, with the same diagonal as the random
+        // full covariances above.
+        arma::mat r = arma::randu<arma::mat>(dimensionality,
+            dimensionality);
+        e[i].Component(g).Covariance(arma::vec(arma::sum(arma::square(r), 1)));
+      }
+    }
+  }
 };
 
 // Because we don't know what the type of our HMM is, we need to write a
@@ -388,7 +434,8 @@ static void mlpackMain()
 
   if (!CLI::HasParam("input_model"))
   {
-    RequireParamInSet<string>("type", { "discrete", "gaussian", "gmm" }, true,
+    RequireParamInSet<string>("type",
+        { "discrete", "gaussian", "gmm", "diag_gmm" }, true,
         "unknown HMM type");
   }
 
@@ -448,8 +495,10 @@ static void mlpackMain()
     typeId = HMMType::DiscreteHMM;
   else if (type == "gaussian")
     typeId = HMMType::GaussianHMM;
-  else
+  else if (type == "gmm")
     typeId = HMMType::GaussianMixtureModelHMM;
+  else
+    typeId = HMMType::DiagonalGaussianMixtureModelHMM;
 
   // If we have a model file, we can autodetect the type.
   HMMModel* hmm;
@@ -16,6 +16,7 @@
 
 #include <mlpack/methods/hmm/hmm.hpp>
 #include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/gmm/diagonal_gmm.hpp>
 
 namespace mlpack {
 namespace hmm {
@@ -87,6 +88,11 @@ void LoadHMMAndPerformActionHelper(const std::string& modelFile,
           HMM<gmm::GMM>>(ar, x);
       break;
 
+    case HMMType::DiagonalGaussianMixtureModelHMM:
+      DeserializeHMMAndPerformAction<ActionType, ArchiveType,
+          HMM<gmm::DiagonalGMM>>(ar, x);
+      break;
+
     default:
       Log::Fatal << "Unknown HMM type '" << (unsigned int) type << "'!"
           << std::endl;
@@ -169,6 +175,12 @@ char GetHMMType<HMM<gmm::GMM>>()
   return HMMType::GaussianMixtureModelHMM;
 }
 
+template<>
+char GetHMMType<HMM<gmm::DiagonalGMM>>()
+{
+  return HMMType::DiagonalGaussianMixtureModelHMM;
+}
+
 } // namespace hmm
 } // namespace mlpack
 
@@ -0,0 +1,252 @@
+/**
+ * @file sparse_hmm.hpp
+ *
+ * Definition of the SparseHMM class, a Hidden Markov Model with a sparse
+ * transition matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_SPARSE_HMM_HPP
+#define MLPACK_METHODS_HMM_SPARSE_HMM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "hmm.hpp"
+
+namespace mlpack {
+namespace hmm {
+
+/**
+ * A Hidden Markov Model whose transition matrix is stored as an arma::sp_mat.
+ * This is useful for models with many hidden states but few allowed
+ * transitions out of each state, such as left-to-right models.  Every step of
+ * the Forward, Backward and Viterbi algorithms, and of the transition update of
+ * the Baum-Welch algorithm, only visits the nonzero transitions, so it takes
+ * O(nnz) time instead of the O(states^2) time of the HMM class.
+ *
+ * Transitions that are zero in the given transition matrix stay zero during
+ * Baum-Welch training, so the sparsity structure is given by the initial
+ * model.  Labeled training estimates the structure from the observed
+ * transitions.
+ *
+ * The Distribution template parameter has the same requirements as for the HMM
+ * class; emission distributions with a batch
+ * LogProbability(const arma::mat&, arma::vec&) function are evaluated on a
+ * whole sequence at once.
+ *
+ * @code
+ * // A left-to-right model: each state either stays or moves to the next one.
+ * arma::sp_mat transition(states, states);
+ * for (size_t i = 0; i < states; ++i)
+ * {
+ *   transition(i, i) = 0.5;
+ *   transition((i + 1) % states, i) = 0.5;
+ * }
+ * SparseHMM<GaussianDistribution> hmm(initial, transition, emissions);
+ * hmm.Train(sequences);
+ * @endcode
+ *
+ * @tparam Distribution Type of emission distribution for this HMM.
+ */
+template<typename Distribution = distribution::DiscreteDistribution>
+class SparseHMM
+{
+ public:
+  /**
+   * Create an empty SparseHMM with no states.
+   */
+  SparseHMM() : dimensionality(0), tolerance(1e-5) { /* Nothing to do. */ }
+
+  /**
+   * Create the Hidden Markov Model with the given initial probability vector,
+   * the given sparse transition matrix, and the given emission distributions.
+   * The transition matrix should be such that T(i, j) is the probability of
+   * transition to state i from state j; its columns should sum to 1.
+   *
+   * @param initial Initial state probabilities.
+   * @param transition Sparse transition matrix.
+   * @param emission Emission distributions.
+   * @param tolerance Tolerance for convergence of training algorithm
+   *      (Baum-Welch).
+   */
+  SparseHMM(const arma::vec& initial,
+            const arma::sp_mat& transition,
+            const std::vector<Distribution>& emission,
+            const double tolerance = 1e-5);
+
+  /**
+   * Train the model using the Baum-Welch algorithm, with only the given
+   * unlabeled observations.  The current parameters of the model are used as
+   * the starting point, and transitions that are zero stay zero.  The
+   * sequences are processed in parallel with OpenMP.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @return Log-likelihood of state sequence.
+   */
+  double Train(const std::vector<arma::mat>& dataSeq);
+
+  /**
+   * Train the model using the given labeled observations; the transition and
+   * emission distributions are directly estimated, and the sparsity structure
+   * of the transition matrix is the set of observed transitions.
+   *
+   * @param dataSeq Vector of observation sequences.
+   * @param stateSeq Vector of state sequences, corresponding to each
+   *     observation.
+   */
+  void Train(const std::vector<arma::mat>& dataSeq,
+             const std::vector<arma::Row<size_t> >& stateSeq);
+
+  /**
+   * Estimate the probabilities of each hidden state at each time step for each
+   * given data observation, using the Forward-Backward algorithm.  The
+   * returned matrices hold log probabilities, as with HMM::LogEstimate().
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateLogProb Matrix in which the log probabilities of each state at
+   *     each time interval will be stored.
+   * @param forwardLogProb Matrix in which the forward log probabilities of each
+   *     state at each time interval will be stored.
+   * @param backwardLogProb Matrix in which the backward log probabilities of
+   *     each state at each time interval will be stored.
+   * @param logScales Vector in which the log of scaling factors at each time
+   *     interval will be stored.
+   * @return Log-likelihood of most likely state sequence.
+   */
+  double LogEstimate(const arma::mat& dataSeq,
+                     arma::mat& stateLogProb,
+                     arma::mat& forwardLogProb,
+                     arma::mat& backwardLogProb,
+                     arma::vec& logScales) const;
+
+  /**
+   * Generate a random data sequence of the given length.
+   *
+   * @param length Length of random sequence to generate.
+   * @param dataSequence Vector to store data in.
+   * @param stateSequence Vector to store states in.
+   * @param startState Hidden state to start sequence in (default 0).
+   */
+  void Generate(const size_t length,
+                arma::mat& dataSequence,
+                arma::Row<size_t>& stateSequence,
+                const size_t startState = 0) const;
+
+  /**
+   * Compute the most probable hidden state sequence for the given data
+   * sequence, using the Viterbi algorithm, returning the log-likelihood of the
+   * most likely state sequence.
+   *
+   * @param dataSeq Sequence of observations.
+   * @param stateSeq Vector in which the most probable state sequence will be
+   *    stored.
+   * @return Log-likelihood of most probable state sequence.
+   */
+  double Predict(const arma::mat& dataSeq,
+                 arma::Row<size_t>& stateSeq) const;
+
+  /**
+   * Compute the log-likelihood of the given data sequence.
+   *
+   * @param dataSeq Data sequence to evaluate the likelihood of.
+   * @return Log-likelihood of the given sequence.
+   */
+  double LogLikelihood(const arma::mat& dataSeq) const;
+
+  //! Return the vector of initial state probabilities.
+  const arma::vec& Initial() const { return initial; }
+  //! Modify the vector of initial state probabilities.
+  arma::vec& Initial() { return initial; }
+
+  //! Return the sparse transition matrix.
+  const arma::sp_mat& Transition() const { return transition; }
+  //! Return a modifiable sparse transition matrix reference.
+  arma::sp_mat& Transition() { return transition; }
+
+  //! Return the emission distributions.
+  const std::vector<Distribution>& Emission() const { return emission; }
+  //! Return a modifiable emission distributions reference.
+  std::vector<Distribution>& Emission() { return emission; }
+
+  //! Get the dimensionality of observations.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Set the dimensionality of observations.
+  size_t& Dimensionality() { return dimensionality; }
+
+  //! Get the tolerance of the Baum-Welch algorithm.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance of the Baum-Welch algorithm.
+  double& Tolerance() { return tolerance; }
+
+  /**
+   * Serialize the object.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+ private:
+  /**
+   * Extract the nonzero transitions of the transition matrix, in column order.
+   * Nonzero transition k goes from state from[k] to state to[k] with log
+   * probability logProbs[k].
+   */
+  void LogTransitions(arma::uvec& from,
+                      arma::uvec& to,
+                      arma::vec& logProbs) const;
+
+  /**
+   * Build a transition matrix from the given (to, from) locations and
+   * (unnormalized) values, normalizing each column to sum to 1.  Repeated
+   * locations are added together.
+   */
+  static arma::sp_mat NormalizedTransition(const arma::umat& locations,
+                                           const arma::vec& values,
+                                           const size_t states);
+
+  /**
+   * The Forward algorithm, using the given emission log probabilities and
+   * nonzero transitions.
+   */
+  void Forward(const arma::mat& logEmission,
+               const arma::uvec& from,
+               const arma::uvec& to,
+               const arma::vec& logTrans,
+               arma::vec& logScales,
+               arma::mat& forwardLogProb) const;
+
+  /**
+   * The Backward algorithm, using the given emission log probabilities and
+   * nonzero transitions, and the scaling factors found by Forward().
+   */
+  void Backward(const arma::mat& logEmission,
+                const arma::uvec& from,
+                const arma::uvec& to,
+                const arma::vec& logTrans,
+                const arma::vec& logScales,
+                arma::mat& backwardLogProb) const;
+
+  //! Set of emission probability distributions; one for each state.
+  std::vector<Distribution> emission;
+
+  //! Sparse transition probability matrix.
+  arma::sp_mat transition;
+
+  //! Initial state probability vector.
+  arma::vec initial;
+
+  //! Dimensionality of observations.
+  size_t dimensionality;
+
+  //! Tolerance of Baum-Welch algorithm.
+  double tolerance;
+};
+
+} // namespace hmm
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_hmm_impl.hpp"
+
+#endif
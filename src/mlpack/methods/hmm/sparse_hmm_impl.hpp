@@ -0,0 +1,575 @@
+/**
+ * @file sparse_hmm_impl.hpp
+ *
+ * Implementation of the SparseHMM class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_SPARSE_HMM_IMPL_HPP
+#define MLPACK_METHODS_HMM_SPARSE_HMM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_hmm.hpp"
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+namespace hmm {
+
+template<typename Distribution>
+SparseHMM<Distribution>::SparseHMM(const arma::vec& initial,
+                                   const arma::sp_mat& transition,
+                                   const std::vector<Distribution>& emission,
+                                   const double tolerance) :
+    emission(emission),
+    transition(transition),
+    initial(initial),
+    tolerance(tolerance)
+{
+  if (transition.n_rows != transition.n_cols ||
+      transition.n_rows != initial.n_elem ||
+      transition.n_rows != emission.size())
+  {
+    std::ostringstream oss;
+    oss << "SparseHMM::SparseHMM(): transition matrix is " << transition.n_rows
+        << "x" << transition.n_cols << ", but there are " << initial.n_elem
+        << " initial probabilities and " << emission.size()
+        << " emission distributions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Set the dimensionality, if we can.
+  dimensionality = (emission.size() > 0) ? emission[0].Dimensionality() : 0;
+}
+
+/**
+ * Train the model using the Baum-Welch algorithm, with only the given unlabeled
+ * observations.  Only the nonzero transitions are updated.
+ */
+template<typename Distribution>
+double SparseHMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
+{
+  double loglik = 0;
+  double oldLoglik = 0;
+
+  // Maximum iterations?
+  size_t iterations = 1000;
+
+  // Find length of all sequences and ensure they are the correct size.
+  size_t totalLength = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    totalLength += dataSeq[seq].n_cols;
+
+    if (dataSeq[seq].n_rows != dimensionality)
+      Log::Fatal << "SparseHMM::Train(): data sequence " << seq << " has "
+          << "dimensionality " << dataSeq[seq].n_rows << " (expected "
+          << dimensionality << " dimensions)." << std::endl;
+  }
+
+  // The observations of each sequence are stored at a fixed offset in the
+  // emission list.
+  const size_t states = transition.n_rows;
+  std::vector<arma::vec> emissionProb(states, arma::vec(totalLength));
+  arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> offsets(dataSeq.size());
+  arma::uvec lengths(dataSeq.size());
+  size_t offset = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    offsets[seq] = offset;
+    lengths[seq] = dataSeq[seq].n_cols;
+    if (dataSeq[seq].n_cols > 0)
+      emissionList.cols(offset, offset + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    offset += dataSeq[seq].n_cols;
+  }
+
+  // The sequences are handed out to threads longest first.
+  const arma::uvec order = arma::sort_index(lengths, "descend");
+
+  for (size_t iter = 0; iter < iterations; iter++)
+  {
+    // The nonzero transitions of the current model.
+    arma::uvec from, to;
+    arma::vec logTrans;
+    LogTransitions(from, to, logTrans);
+
+    arma::vec newLogInitial(states);
+    newLogInitial.fill(-std::numeric_limits<double>::infinity());
+    arma::vec newLogCounts(logTrans.n_elem);
+    newLogCounts.fill(-std::numeric_limits<double>::infinity());
+
+    loglik = 0;
+
+    #pragma omp parallel reduction(+:loglik)
+    {
+      arma::vec localLogInitial(states);
+      localLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::vec localLogCounts(logTrans.n_elem);
+      localLogCounts.fill(-std::numeric_limits<double>::infinity());
+
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t s = 0; s < (omp_size_t) dataSeq.size(); ++s)
+      {
+        const size_t seq = order[s];
+        arma::mat logEmission, forwardLog, backwardLog;
+        arma::vec logScales;
+
+        // The E-step.
+        EmissionLogProbabilities(emission, dataSeq[seq], logEmission);
+        Forward(logEmission, from, to, logTrans, logScales, forwardLog);
+        Backward(logEmission, from, to, logTrans, logScales, backwardLog);
+        const arma::mat stateLogProb = forwardLog + backwardLog;
+        loglik += accu(logScales);
+
+        for (size_t j = 0; j < states; ++j)
+        {
+          localLogInitial[j] = math::LogAdd(localLogInitial[j],
+              stateLogProb(j, 0));
+        }
+
+        // Expected number of each nonzero transition; the multiplication by
+        // the old transition probability is postponed until later.
+        for (size_t t = 0; t + 1 < dataSeq[seq].n_cols; ++t)
+        {
+          for (size_t k = 0; k < logTrans.n_elem; ++k)
+          {
+            localLogCounts[k] = math::LogAdd(localLogCounts[k],
+                forwardLog(from[k], t) + backwardLog(to[k], t + 1) +
+                logEmission(to[k], t + 1) - logScales[t + 1]);
+          }
+        }
+
+        for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+          for (size_t j = 0; j < states; ++j)
+            emissionProb[j][offsets[seq] + t] = exp(stateLogProb(j, t));
+      }
+
+      // Combine the counts from each thread.
+      #pragma omp critical
+      {
+        for (size_t j = 0; j < states; ++j)
+        {
+          newLogInitial[j] = math::LogAdd(newLogInitial[j],
+              localLogInitial[j]);
+        }
+        for (size_t k = 0; k < logTrans.n_elem; ++k)
+        {
+          newLogCounts[k] = math::LogAdd(newLogCounts[k],
+              localLogCounts[k]);
+        }
+      }
+    }
+
+    if (std::abs(oldLoglik - loglik) < tolerance)
+    {
+      Log::Debug << "Converged after " << iter << " iterations." << std::endl;
+      break;
+    }
+
+    oldLoglik = loglik;
+
+    // Normalize the new initial probabilities.
+    if (dataSeq.size() > 1)
+      initial = exp(newLogInitial) / dataSeq.size();
+    else
+      initial = exp(newLogInitial);
+
+    // Multiply the expected counts by the old transition probabilities, and
+    // renormalize each column.  A column that has no expected transitions at
+    // all keeps its old probabilities.
+    arma::vec values = exp(logTrans + newLogCounts);
+    arma::vec columnSums(states, arma::fill::zeros);
+    for (size_t k = 0; k < values.n_elem; ++k)
+      columnSums[from[k]] += values[k];
+    for (size_t k = 0; k < values.n_elem; ++k)
+      if (columnSums[from[k]] == 0.0)
+        values[k] = exp(logTrans[k]);
+
+    arma::umat locations(2, values.n_elem);
+    locations.row(0) = to.t();
+    locations.row(1) = from.t();
+    transition = NormalizedTransition(locations, values, states);
+
+    // Now estimate emission probabilities.
+    for (size_t state = 0; state < states; state++)
+      emission[state].Train(emissionList, emissionProb[state]);
+
+    Log::Debug << "Iteration " << iter << ": log-likelihood " << loglik
+        << "." << std::endl;
+  }
+
+  return loglik;
+}
+
+/**
+ * Train the model using the given labeled observations.
+ */
+template<typename Distribution>
+void SparseHMM<Distribution>::Train(
+    const std::vector<arma::mat>& dataSeq,
+    const std::vector<arma::Row<size_t> >& stateSeq)
+{
+  // Simple error checking.
+  if (dataSeq.size() != stateSeq.size())
+  {
+    Log::Fatal << "SparseHMM::Train(): number of data sequences ("
+        << dataSeq.size() << ") not equal to number of state sequences ("
+        << stateSeq.size() << ")." << std::endl;
+  }
+
+  const size_t states = transition.n_rows;
+  initial.zeros(states);
+
+  // Count the observed transitions, and collect the time indices of the
+  // observations from each state.
+  size_t numTransitions = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    if (dataSeq[seq].n_cols != stateSeq[seq].n_elem)
+    {
+      Log::Fatal << "SparseHMM::Train(): number of observations ("
+          << dataSeq[seq].n_cols << ") in sequence " << seq
+          << " not equal to number of states (" << stateSeq[seq].n_cols
+          << ") in sequence " << seq << "." << std::endl;
+    }
+
+    if (dataSeq[seq].n_rows != dimensionality)
+    {
+      Log::Fatal << "SparseHMM::Train(): data sequence " << seq << " has "
+          << "dimensionality " << dataSeq[seq].n_rows << " (expected "
+          << dimensionality << " dimensions)." << std::endl;
+    }
+
+    if (stateSeq[seq].n_elem > 0)
+      numTransitions += stateSeq[seq].n_elem - 1;
+  }
+
+  arma::umat locations(2, numTransitions);
+  std::vector<std::vector<std::pair<size_t, size_t> > > emissionList(states);
+  size_t k = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    if (stateSeq[seq].n_elem == 0)
+      continue;
+
+    initial[stateSeq[seq][0]]++;
+    for (size_t t = 0; t < stateSeq[seq].n_elem; t++)
+    {
+      if (t + 1 < stateSeq[seq].n_elem)
+      {
+        locations(0, k) = stateSeq[seq][t + 1];
+        locations(1, k) = stateSeq[seq][t];
+        ++k;
+      }
+      emissionList[stateSeq[seq][t]].push_back(std::make_pair(seq, t));
+    }
+  }
+
+  // Normalize initial weights and the transition counts.
+  initial /= accu(initial);
+  transition = NormalizedTransition(locations,
+      arma::ones<arma::vec>(numTransitions), states);
+
+  // Estimate emission distributions.
+  for (size_t state = 0; state < states; state++)
+  {
+    if (emissionList[state].size() > 0)
+    {
+      arma::mat emissions(dimensionality, emissionList[state].size());
+      for (size_t i = 0; i < emissions.n_cols; i++)
+      {
+        emissions.col(i) = dataSeq[emissionList[state][i].first].col(
+            emissionList[state][i].second);
+      }
+
+      emission[state].Train(emissions);
+    }
+    else
+    {
+      Log::Warn << "There are no observations in training data with hidden "
+          << "state " << state << "!  The corresponding emission distribution "
+          << "is likely to be meaningless." << std::endl;
+    }
+  }
+}
+
+/**
+ * Estimate the probabilities of each hidden state at each time step for each
+ * given data observation.
+ */
+template<typename Distribution>
+double SparseHMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
+                                            arma::mat& stateLogProb,
+                                            arma::mat& forwardLogProb,
+                                            arma::mat& backwardLogProb,
+                                            arma::vec& logScales) const
+{
+  arma::uvec from, to;
+  arma::vec logTrans;
+  LogTransitions(from, to, logTrans);
+
+  arma::mat logEmission;
+  EmissionLogProbabilities(emission, dataSeq, logEmission);
+  Forward(logEmission, from, to, logTrans, logScales, forwardLogProb);
+  Backward(logEmission, from, to, logTrans, logScales, backwardLogProb);
+
+  stateLogProb = forwardLogProb + backwardLogProb;
+  return accu(logScales);
+}
+
+/**
+ * Generate a random data sequence of a given length.
+ */
+template<typename Distribution>
+void SparseHMM<Distribution>::Generate(const size_t length,
+                                       arma::mat& dataSequence,
+                                       arma::Row<size_t>& stateSequence,
+                                       const size_t startState) const
+{
+  stateSequence.set_size(length);
+  dataSequence.set_size(dimensionality, length);
+  if (length == 0)
+    return;
+
+  stateSequence[0] = startState;
+  dataSequence.col(0) = emission[startState].Random();
+
+  for (size_t t = 1; t < length; t++)
+  {
+    // Find where a random value sits in the distribution of transitions out of
+    // the previous state; only its nonzero transitions need to be visited.
+    const double randValue = math::Random();
+    double probSum = 0;
+    const size_t prev = stateSequence[t - 1];
+    stateSequence[t] = prev;
+    for (arma::sp_mat::const_iterator it = transition.begin_col(prev);
+         it != transition.end_col(prev); ++it)
+    {
+      probSum += *it;
+      stateSequence[t] = it.row();
+      if (randValue <= probSum)
+        break;
+    }
+
+    dataSequence.col(t) = emission[stateSequence[t]].Random();
+  }
+}
+
+/**
+ * Compute the most probable hidden state sequence with the Viterbi algorithm.
+ */
+template<typename Distribution>
+double SparseHMM<Distribution>::Predict(const arma::mat& dataSeq,
+                                        arma::Row<size_t>& stateSeq) const
+{
+  const size_t states = transition.n_rows;
+  stateSeq.set_size(dataSeq.n_cols);
+
+  arma::uvec from, to;
+  arma::vec logTrans;
+  LogTransitions(from, to, logTrans);
+
+  arma::mat logEmission;
+  EmissionLogProbabilities(emission, dataSeq, logEmission);
+
+  // stateSeqBack(j, t) is the most probable previous state of state j at
+  // time t.
+  arma::Mat<size_t> stateSeqBack(states, dataSeq.n_cols);
+  arma::vec score = log(initial) + logEmission.col(0);
+  arma::vec newScore(states);
+  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  {
+    newScore.fill(-std::numeric_limits<double>::infinity());
+    stateSeqBack.col(t).zeros();
+    for (size_t k = 0; k < logTrans.n_elem; ++k)
+    {
+      const double candidate = score[from[k]] + logTrans[k];
+      if (candidate > newScore[to[k]])
+      {
+        newScore[to[k]] = candidate;
+        stateSeqBack(to[k], t) = from[k];
+      }
+    }
+
+    score = newScore + logEmission.col(t);
+  }
+
+  // Backtrack to find the most probable state sequence.
+  arma::uword index;
+  const double logLikelihood = score.max(index);
+  stateSeq[dataSeq.n_cols - 1] = index;
+  for (size_t t = dataSeq.n_cols - 1; t > 0; --t)
+    stateSeq[t - 1] = stateSeqBack(stateSeq[t], t);
+
+  return logLikelihood;
+}
+
+/**
+ * Compute the log-likelihood of the given data sequence.
+ */
+template<typename Distribution>
+double SparseHMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
+{
+  arma::uvec from, to;
+  arma::vec logTrans;
+  LogTransitions(from, to, logTrans);
+
+  arma::mat logEmission;
+  EmissionLogProbabilities(emission, dataSeq, logEmission);
+
+  arma::mat forwardLog;
+  arma::vec logScales;
+  Forward(logEmission, from, to, logTrans, logScales, forwardLog);
+
+  // The log-likelihood is the log of the scales for each time step.
+  return accu(logScales);
+}
+
+template<typename Distribution>
+void SparseHMM<Distribution>::LogTransitions(arma::uvec& from,
+                                             arma::uvec& to,
+                                             arma::vec& logProbs) const
+{
+  from.set_size(transition.n_nonzero);
+  to.set_size(transition.n_nonzero);
+  logProbs.set_size(transition.n_nonzero);
+
+  size_t k = 0;
+  for (arma::sp_mat::const_iterator it = transition.begin();
+       it != transition.end(); ++it, ++k)
+  {
+    from[k] = it.col();
+    to[k] = it.row();
+    logProbs[k] = std::log(*it);
+  }
+}
+
+template<typename Distribution>
+arma::sp_mat SparseHMM<Distribution>::NormalizedTransition(
+    const arma::umat& locations,
+    const arma::vec& values,
+    const size_t states)
+{
+  // Add up repeated locations.
+  const arma::sp_mat counts(true, locations, values, states, states);
+
+  arma::vec columnSums(states, arma::fill::zeros);
+  for (arma::sp_mat::const_iterator it = counts.begin(); it != counts.end();
+       ++it)
+    columnSums[it.col()] += *it;
+
+  arma::umat newLocations(2, counts.n_nonzero);
+  arma::vec newValues(counts.n_nonzero);
+  size_t k = 0;
+  for (arma::sp_mat::const_iterator it = counts.begin(); it != counts.end();
+       ++it, ++k)
+  {
+    newLocations(0, k) = it.row();
+    newLocations(1, k) = it.col();
+    newValues[k] = *it / columnSums[it.col()];
+  }
+
+  return arma::sp_mat(newLocations, newValues, states, states);
+}
+
+/**
+ * The Forward procedure, visiting only the nonzero transitions.
+ */
+template<typename Distribution>
+void SparseHMM<Distribution>::Forward(const arma::mat& logEmission,
+                                      const arma::uvec& from,
+                                      const arma::uvec& to,
+                                      const arma::vec& logTrans,
+                                      arma::vec& logScales,
+                                      arma::mat& forwardLogProb) const
+{
+  const size_t length = logEmission.n_cols;
+  forwardLogProb.set_size(transition.n_rows, length);
+  logScales.set_size(length);
+
+  // The first entry in the forward algorithm uses the initial state
+  // probabilities.
+  forwardLogProb.col(0) = log(initial) + logEmission.col(0);
+  logScales[0] = math::AccuLog(forwardLogProb.col(0));
+  if (std::isfinite(logScales[0]))
+    forwardLogProb.col(0) -= logScales[0];
+
+  for (size_t t = 1; t < length; t++)
+  {
+    // Sum the probability of each previous state transitioning to each state.
+    forwardLogProb.col(t).fill(-std::numeric_limits<double>::infinity());
+    for (size_t k = 0; k < logTrans.n_elem; ++k)
+    {
+      forwardLogProb(to[k], t) = math::LogAdd(forwardLogProb(to[k], t),
+          forwardLogProb(from[k], t - 1) + logTrans[k]);
+    }
+    forwardLogProb.col(t) += logEmission.col(t);
+
+    // Normalize probability.
+    logScales[t] = math::AccuLog(forwardLogProb.col(t));
+    if (std::isfinite(logScales[t]))
+      forwardLogProb.col(t) -= logScales[t];
+  }
+}
+
+/**
+ * The Backward procedure, visiting only the nonzero transitions.
+ */
+template<typename Distribution>
+void SparseHMM<Distribution>::Backward(const arma::mat& logEmission,
+                                       const arma::uvec& from,
+                                       const arma::uvec& to,
+                                       const arma::vec& logTrans,
+                                       const arma::vec& logScales,
+                                       arma::mat& backwardLogProb) const
+{
+  const size_t length = logEmission.n_cols;
+  backwardLogProb.set_size(transition.n_rows, length);
+  backwardLogProb.fill(-std::numeric_limits<double>::infinity());
+
+  // The last element probability is 1.
+  backwardLogProb.col(length - 1).fill(0);
+
+  arma::vec next(transition.n_rows);
+  for (size_t t = length - 2; t + 1 > 0; t--)
+  {
+    // The backward probability of each state at time t + 1, times the
+    // probability of that state emitting the observation at time t + 1.
+    next = backwardLogProb.col(t + 1) + logEmission.col(t + 1);
+
+    for (size_t k = 0; k < logTrans.n_elem; ++k)
+    {
+      backwardLogProb(from[k], t) = math::LogAdd(backwardLogProb(from[k], t),
+          logTrans[k] + next[to[k]]);
+    }
+
+    // Normalize by the weights from the forward algorithm.
+    if (std::isfinite(logScales[t + 1]))
+      backwardLogProb.col(t) -= logScales[t + 1];
+  }
+}
+
+//! Serialize the SparseHMM.
+template<typename Distribution>
+template<typename Archive>
+void SparseHMM<Distribution>::serialize(Archive& ar,
+                                        const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(dimensionality);
+  ar & BOOST_SERIALIZATION_NVP(tolerance);
+  ar & BOOST_SERIALIZATION_NVP(transition);
+  ar & BOOST_SERIALIZATION_NVP(initial);
+
+  if (Archive::is_loading::value)
+    emission.resize(transition.n_rows);
+  ar & BOOST_SERIALIZATION_NVP(emission);
+}
+
+} // namespace hmm
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,242 @@
+/**
+ * @file hnsw_main.cpp
+ *
+ * This file computes the approximate nearest-neighbors using a hierarchical
+ * navigable small world graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include "hnsw_search.hpp"
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+using namespace mlpack::util;
+
+// Information about the program itself.
+PROGRAM_INFO("K-Approximate-Nearest-Neighbor Search with HNSW",
+    // Short description.
+    "An implementation of approximate k-nearest-neighbor search with a "
+    "hierarchical navigable small world (HNSW) graph.  Given a set of reference"
+    " points and a set of query points, this will compute the k approximate "
+    "nearest neighbors of each query point in the reference set; models can be "
+    "saved for future use, and more points can be inserted into them.",
+    // Long description.
+    "This program will calculate the k approximate-nearest-neighbors of a set "
+    "of points using a hierarchical navigable small world graph built on the "
+    "reference points.  You may specify a separate set of reference points and "
+    "query points, or just a reference set which will be used as both the "
+    "reference and query set."
+    "\n\n"
+    "For example, the following will return 5 neighbors from the data for each "
+    "point in " + PRINT_DATASET("input") + " and store the distances in " +
+    PRINT_DATASET("distances") + " and the neighbors in " +
+    PRINT_DATASET("neighbors") + ":"
+    "\n\n" +
+    PRINT_CALL("hnsw", "k", 5, "reference", "input", "distances", "distances",
+        "neighbors", "neighbors") +
+    "\n\n"
+    "The output is organized such that row i and column j in the neighbors "
+    "output corresponds to the index of the point in the reference set which "
+    "is the j'th nearest neighbor from the point in the query set with index "
+    "i.  Row j and column i in the distances output file corresponds to the "
+    "distance between those two points."
+    "\n\n"
+    "The " + PRINT_PARAM_STRING("connections") + " and " +
+    PRINT_PARAM_STRING("ef_construction") + " parameters control the quality "
+    "of the graph (and the time it takes to build), and the " +
+    PRINT_PARAM_STRING("ef_search") + " parameter controls the recall of the "
+    "search (and the time it takes).  Points given with " +
+    PRINT_PARAM_STRING("insert") + " are inserted into the graph of the input "
+    "model (or of the reference set) before the search, without rebuilding it."
+    "\n\n"
+    "For example, the following will insert the points of " +
+    PRINT_DATASET("new_points") + " into the model " + PRINT_MODEL("model") +
+    " and save the resulting model to " + PRINT_MODEL("new_model") + ":"
+    "\n\n" +
+    PRINT_CALL("hnsw", "input_model", "model", "insert", "new_points",
+        "output_model", "new_model") +
+    "\n\n"
+    "Because this is approximate-nearest-neighbors search, results may be "
+    "different from run to run.  Thus, the " + PRINT_PARAM_STRING("seed") +
+    " parameter can be specified to set the random seed.",
+    SEE_ALSO("@knn", "#knn"),
+    SEE_ALSO("@lsh", "#lsh"),
+    SEE_ALSO("Efficient and robust approximate nearest neighbor search using "
+        "hierarchical navigable small world graphs (pdf)",
+        "https://arxiv.org/pdf/1603.09320.pdf"),
+    SEE_ALSO("mlpack::neighbor::HNSWSearch C++ class documentation",
+        "@doxygen/classmlpack_1_1neighbor_1_1HNSWSearch.html"));
+
+// Define our input parameters that this program will take.
+PARAM_MATRIX_IN("reference", "Matrix containing the reference dataset.", "r");
+PARAM_MATRIX_OUT("distances", "Matrix to output distances into.", "d");
+PARAM_UMATRIX_OUT("neighbors", "Matrix to output neighbors into.", "n");
+
+// We can load or save models.
+PARAM_MODEL_IN(HNSWSearch<>, "input_model", "Input HNSW model.", "m");
+PARAM_MODEL_OUT(HNSWSearch<>, "output_model", "Output for trained HNSW model.",
+    "M");
+
+// For testing recall.
+PARAM_UMATRIX_IN("true_neighbors", "Matrix of true neighbors to compute "
+    "recall with (the recall is printed when -v is specified).", "t");
+
+PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
+PARAM_MATRIX_IN("query", "Matrix containing query points (optional).", "q");
+PARAM_MATRIX_IN("insert", "Matrix containing points to insert into the graph "
+    "before searching (optional).", "i");
+
+PARAM_INT_IN("connections", "The number of links of each point in each level "
+    "of the graph above the first (there are twice as many in the first).",
+    "c", 16);
+PARAM_INT_IN("ef_construction", "The number of candidates the links of each "
+    "inserted point are selected from.", "e", 200);
+PARAM_INT_IN("ef_search", "The number of candidates kept while searching.",
+    "E", 50);
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+static void mlpackMain()
+{
+  if (CLI::GetParam<int>("seed") != 0)
+    math::RandomSeed((size_t) CLI::GetParam<int>("seed"));
+  else
+    math::RandomSeed((size_t) time(NULL));
+
+  // Get all the parameters after checking them.
+  if (CLI::HasParam("k"))
+  {
+    RequireParamValue<int>("k", [](int x) { return x > 0; }, true,
+        "k must be greater than 0");
+  }
+  RequireParamValue<int>("connections", [](int x) { return x >= 2; }, true,
+      "the number of connections must be at least 2");
+  RequireParamValue<int>("ef_construction", [](int x) { return x > 0; }, true,
+      "ef_construction must be greater than 0");
+  RequireParamValue<int>("ef_search", [](int x) { return x > 0; }, true,
+      "ef_search must be greater than 0");
+
+  const size_t k = CLI::GetParam<int>("k");
+  const size_t connections = CLI::GetParam<int>("connections");
+  const size_t efConstruction = CLI::GetParam<int>("ef_construction");
+  const size_t efSearch = CLI::GetParam<int>("ef_search");
+
+  RequireOnlyOnePassed({ "input_model", "reference" }, true);
+  RequireAtLeastOnePassed({ "neighbors", "distances", "output_model" }, false,
+      "no results will be saved");
+
+  ReportIgnoredParam({{ "k", false }}, "neighbors");
+  ReportIgnoredParam({{ "k", false }}, "distances");
+  ReportIgnoredParam({{ "k", false }}, "query");
+
+  ReportIgnoredParam({{ "reference", false }}, "connections");
+  ReportIgnoredParam({{ "reference", false }}, "ef_construction");
+
+  if (CLI::HasParam("input_model") && !CLI::HasParam("k") &&
+      !CLI::HasParam("insert"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("k") << " not passed; no search will be "
+        << "performed!" << std::endl;
+  }
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  HNSWSearch<>* hnsw;
+  if (CLI::HasParam("reference"))
+  {
+    arma::mat referenceData = std::move(CLI::GetParam<arma::mat>("reference"));
+    Log::Info << "Using reference data from '"
+        << CLI::GetPrintableParam<arma::mat>("reference") << "' ("
+        << referenceData.n_rows << " x " << referenceData.n_cols << ")."
+        << endl;
+    Log::Info << "Using HNSW with " << connections << " connections and "
+        << "ef_construction " << efConstruction << "." << endl;
+
+    hnsw = new HNSWSearch<>(connections, efConstruction, efSearch);
+
+    Timer::Start("graph_building");
+    hnsw->Train(std::move(referenceData));
+    Timer::Stop("graph_building");
+  }
+  else // We must have an input model.
+  {
+    hnsw = CLI::GetParam<HNSWSearch<>*>("input_model");
+    if (CLI::HasParam("ef_search"))
+      hnsw->EfSearch() = efSearch;
+  }
+
+  if (CLI::HasParam("insert"))
+  {
+    const arma::mat& newPoints = CLI::GetParam<arma::mat>("insert");
+    Log::Info << "Inserting " << newPoints.n_cols << " points from '"
+        << CLI::GetPrintableParam<arma::mat>("insert") << "'." << endl;
+
+    Timer::Start("graph_insertion");
+    hnsw->Insert(newPoints);
+    Timer::Stop("graph_insertion");
+  }
+
+  if (CLI::HasParam("k"))
+  {
+    Log::Info << "Computing " << k << " distance approximate nearest neighbors "
+        << "with ef_search " << hnsw->EfSearch() << "." << endl;
+    if (CLI::HasParam("query"))
+    {
+      const arma::mat& queryData = CLI::GetParam<arma::mat>("query");
+      Log::Info << "Loaded query data from '"
+          << CLI::GetPrintableParam<arma::mat>("query") << "' ("
+          << queryData.n_rows << " x " << queryData.n_cols << ")." << endl;
+
+      hnsw->Search(queryData, k, neighbors, distances);
+    }
+    else
+    {
+      hnsw->Search(k, neighbors, distances);
+    }
+
+    Log::Info << "Neighbors computed." << endl;
+  }
+
+  // Compute recall, if desired.
+  if (CLI::HasParam("true_neighbors"))
+  {
+    // Load the true neighbors.
+    arma::Mat<size_t> trueNeighbors =
+        std::move(CLI::GetParam<arma::Mat<size_t>>("true_neighbors"));
+
+    if (trueNeighbors.n_rows != neighbors.n_rows ||
+        trueNeighbors.n_cols != neighbors.n_cols)
+    {
+        Log::Fatal << "The true neighbors file must have the same number of "
+            << "values as the set of neighbors being queried!" << endl;
+    }
+
+    Log::Info << "Using true neighbor indices from '"
+        << CLI::GetPrintableParam<arma::Mat<size_t>>("true_neighbors") << "'."
+        << endl;
+
+    // Compute recall and print it.
+    double recallPercentage = 100 * hnsw->ComputeRecall(neighbors,
+        trueNeighbors);
+
+    Log::Info << "Recall: " << recallPercentage << endl;
+  }
+
+  // Save output, if we did a search.
+  if (CLI::HasParam("k"))
+  {
+    CLI::GetParam<arma::mat>("distances") = std::move(distances);
+    CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  }
+  CLI::GetParam<HNSWSearch<>*>("output_model") = hnsw;
+}
@@ -0,0 +1,407 @@
+/**
+ * @file hnsw_search.hpp
+ *
+ * Defines the HNSWSearch class, which performs approximate nearest neighbor
+ * search with a hierarchical navigable small world graph built on the
+ * reference set.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @article{malkov2018efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       hierarchical navigable small world graphs},
+ *   author={Malkov, Yu A. and Yashunin, Dmitry A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   year={2018},
+ *   publisher={IEEE}
+ * }
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+#include <mutex>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The HNSWSearch class builds a hierarchical navigable small world (HNSW)
+ * graph on the reference set and uses it to compute the approximate nearest
+ * neighbors of the given queries.  Each point is inserted in the levels of the
+ * graph from 0 up to a random level, which is drawn from an exponentially
+ * decaying distribution, so each level holds a small fraction of the points of
+ * the level below it.  In each level, every point is linked to up to M of its
+ * nearest neighbors (2M in level 0).  A query greedily walks down from the
+ * single point of the top level, and then does a best-first search with a
+ * list of efSearch candidates in level 0.
+ *
+ * Unlike LSHSearch, the graph adapts to the intrinsic dimensionality of the
+ * data, so it gives a much better recall for the same number of distance
+ * evaluations on high-dimensional data, such as embeddings.  The recall is
+ * controlled at search time by efSearch, and the quality of the graph by M
+ * and efConstruction.
+ *
+ * The graph is built in parallel: the points are inserted concurrently, and
+ * each point's links are protected by their own lock.  The points are
+ * inserted in a different order from run to run, so the graph (and the
+ * results) may vary slightly between runs with several threads.  More points
+ * can be inserted into a built graph with Insert().
+ *
+ * @code
+ * HNSWSearch<> hnsw(referenceSet, 16, 200, 50);
+ * hnsw.Search(querySet, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MetricType The metric to use; this can be any metric (for instance
+ *     an LMetric, or an IPMetric for kernel-induced distances).
+ * @tparam MatType The type of the data.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class HNSWSearch
+{
+ public:
+  /**
+   * Create an untrained HNSW model with the given parameters.  Be sure to call
+   * Train() before calling Search(); otherwise, an exception will be thrown
+   * when Search() is called.
+   *
+   * @param m Number of links of each point in each level above 0 (there are
+   *     2m in level 0); this must be at least 2.
+   * @param efConstruction Number of candidates to select the links of an
+   *     inserted point from.
+   * @param efSearch Number of candidates to keep while searching.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(const size_t m = 16,
+             const size_t efConstruction = 200,
+             const size_t efSearch = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Build the HNSW graph on the given reference set.  In order to avoid
+   * copying the reference set, consider passing it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param m Number of links of each point in each level above 0 (there are
+   *     2m in level 0); this must be at least 2.
+   * @param efConstruction Number of candidates to select the links of an
+   *     inserted point from.
+   * @param efSearch Number of candidates to keep while searching.
+   * @param metric Instantiated metric.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t m = 16,
+             const size_t efConstruction = 200,
+             const size_t efSearch = 50,
+             const MetricType metric = MetricType());
+
+  /**
+   * Build the HNSW graph on the given reference set, replacing the current
+   * graph (the parameters are kept).  In order to avoid copying the reference
+   * set, consider passing it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Insert new points into the graph, without rebuilding it.  The new points
+   * get the indices after those of the current reference set, and are
+   * inserted in parallel.
+   *
+   * @param newPoints Points to insert.
+   */
+  void Insert(const MatType& newPoints);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the given query
+   * set and store the output in the given matrices.  The matrices will be set
+   * to the size of n columns by k rows, where n is the number of points in the
+   * query set and k is the number of neighbors being searched for.  If fewer
+   * than k neighbors are found for a query, the remaining neighbors are set to
+   * the number of reference points and their distances to DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Compute the approximate nearest neighbors of each point of the reference
+   * set (excluding the point itself) and store the output in the given
+   * matrices.
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each point.
+   * @param distances Matrix storing distances of neighbors for each point.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Compute the recall (% of neighbors found) given the neighbors returned by
+   * Search() and a "ground truth" set of neighbors.  The recall returned will
+   * be in the range [0, 1].
+   *
+   * @param foundNeighbors Set of neighbors to compute recall of.
+   * @param realNeighbors Set of "ground truth" neighbors to compute recall
+   *     against.
+   */
+  static double ComputeRecall(const arma::Mat<size_t>& foundNeighbors,
+                              const arma::Mat<size_t>& realNeighbors);
+
+  /**
+   * Serialize the HNSW model.
+   *
+   * @param ar Archive to serialize to.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int version);
+
+  //! Return the reference dataset.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of links of each point in the levels above 0.
+  size_t M() const { return m; }
+
+  //! Get the number of candidates the links of inserted points are selected
+  //! from.
+  size_t EfConstruction() const { return efConstruction; }
+  //! Modify the number of candidates the links of inserted points are
+  //! selected from (this only affects points inserted later).
+  size_t& EfConstruction() { return efConstruction; }
+
+  //! Get the number of candidates kept while searching.
+  size_t EfSearch() const { return efSearch; }
+  //! Modify the number of candidates kept while searching.
+  size_t& EfSearch() { return efSearch; }
+
+  //! Get the top level of the graph.
+  size_t MaxLevel() const { return maxLevel; }
+  //! Get the point the searches start from (the point of the top level).
+  size_t EntryPoint() const { return entryPoint; }
+  //! Get the top level of each point.
+  const std::vector<size_t>& Levels() const { return levels; }
+
+  //! Get the points the given point is linked to in the given level.
+  arma::Col<size_t> Neighbors(const size_t point, const size_t level) const
+  {
+    const size_t* links = Links(point, level);
+    return arma::Col<size_t>(links + 1, links[0]);
+  }
+
+  //! Return the number of distance evaluations performed.
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+  //! Modify the number of distance evaluations performed.
+  size_t& DistanceEvaluations() { return distanceEvaluations; }
+
+  //! Get the instantiated metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the instantiated metric.
+  MetricType& Metric() { return metric; }
+
+ private:
+  //! A candidate neighbor: its distance and its index.
+  typedef std::pair<double, size_t> Candidate;
+
+  /**
+   * A set of visited points, which is cleared in constant time by changing
+   * the tag that marks visited points.
+   */
+  class VisitedList
+  {
+   public:
+    //! Create a set for the given number of points.
+    VisitedList(const size_t n) : marks(n, 0), tag(0) { }
+
+    //! Clear the set.
+    void Reset()
+    {
+      if (++tag == 0)
+      {
+        std::fill(marks.begin(), marks.end(), 0);
+        tag = 1;
+      }
+    }
+
+    //! Mark the given point as visited, and return whether it already was.
+    bool Visit(const size_t point)
+    {
+      if (marks[point] == tag)
+        return true;
+      marks[point] = tag;
+      return false;
+    }
+
+   private:
+    //! The tag of each point.
+    std::vector<unsigned int> marks;
+    //! The tag of the visited points.
+    unsigned int tag;
+  };
+
+  //! Get the links of the given point in the given level; the first element
+  //! is the number of links.
+  const size_t* Links(const size_t point, const size_t level) const
+  {
+    return (level == 0) ? &baseLinks[point * (2 * m + 1)] :
+        &upperLinks[point][(level - 1) * (m + 1)];
+  }
+
+  //! Modify the links of the given point in the given level.
+  size_t* Links(const size_t point, const size_t level)
+  {
+    return (level == 0) ? &baseLinks[point * (2 * m + 1)] :
+        &upperLinks[point][(level - 1) * (m + 1)];
+  }
+
+  //! Compute the distance between the given point and a reference point.
+  template<typename VecType>
+  double Distance(const VecType& point,
+                  const size_t reference,
+                  size_t& evaluations)
+  {
+    ++evaluations;
+    return metric.Evaluate(point, referenceSet.unsafe_col(reference));
+  }
+
+  /**
+   * Copy the links of the given point in the given level.  If locks is not
+   * NULL, the lock of the point is held while copying.
+   */
+  void CopyLinks(const size_t point,
+                 const size_t level,
+                 std::mutex* locks,
+                 std::vector<size_t>& links) const;
+
+  /**
+   * Insert the points from the given index up to the end of the reference set
+   * into the graph, in parallel.
+   *
+   * @param begin Index of the first point to insert.
+   */
+  void Build(const size_t begin);
+
+  /**
+   * Insert the given point into the graph, once its level is set and the
+   * storage of its links is allocated.
+   *
+   * @param point Index of the point to insert.
+   * @param locks Lock of each point, which protects its links.
+   * @param entryLock Lock protecting the entry point and the top level.
+   * @param visited Visited set of the calling thread.
+   * @param evaluations Incremented with the number of distance evaluations.
+   */
+  void InsertPoint(const size_t point,
+                   std::mutex* locks,
+                   std::mutex& entryLock,
+                   VisitedList& visited,
+                   size_t& evaluations);
+
+  /**
+   * Link the given reference point to newPoint in the given level.  If the
+   * reference point already has the maximum number of links, its links are
+   * selected again among its links and newPoint.
+   */
+  void Connect(const size_t reference,
+               const size_t newPoint,
+               const double distance,
+               const size_t level,
+               std::mutex* locks,
+               size_t& evaluations);
+
+  /**
+   * Select up to maxLinks links among the candidates (sorted by increasing
+   * distance from a point): a candidate is skipped if it is closer to an
+   * already selected candidate than to the point, so that the links point in
+   * diverse directions.
+   */
+  void SelectNeighbors(const std::vector<Candidate>& candidates,
+                       const size_t maxLinks,
+                       std::vector<Candidate>& selected,
+                       size_t& evaluations);
+
+  /**
+   * Walk greedily in the given level from the given entry to the point
+   * nearest to the query, and return it.
+   */
+  template<typename VecType>
+  Candidate GreedySearch(const VecType& query,
+                         Candidate entry,
+                         const size_t level,
+                         std::mutex* locks,
+                         size_t& evaluations);
+
+  /**
+   * Search the given level for the ef points nearest to the query, starting
+   * from the given entries, and return them sorted by increasing distance.
+   */
+  template<typename VecType>
+  std::vector<Candidate> SearchLevel(const VecType& query,
+                                     const std::vector<Candidate>& entries,
+                                     const size_t ef,
+                                     const size_t level,
+                                     VisitedList& visited,
+                                     std::mutex* locks,
+                                     size_t& evaluations);
+
+  /**
+   * Search the points of the given query set in parallel.  If sameSet is
+   * true, the query set is the reference set, and each point is excluded from
+   * its own results.
+   */
+  void SearchQueries(const MatType& querySet,
+                     const size_t k,
+                     const bool sameSet,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances);
+
+  //! Reference dataset.
+  MatType referenceSet;
+  //! Instantiated metric.
+  MetricType metric;
+  //! Number of links of each point in the levels above 0.
+  size_t m;
+  //! Number of candidates the links of inserted points are selected from.
+  size_t efConstruction;
+  //! Number of candidates kept while searching.
+  size_t efSearch;
+  //! The top level of each point.
+  std::vector<size_t> levels;
+  //! The links of each point in level 0: 2m + 1 elements per point, the first
+  //! one holding the number of links.
+  std::vector<size_t> baseLinks;
+  //! The links of each point in the levels above 0: m + 1 elements per level
+  //! of the point, the first one holding the number of links.
+  std::vector<std::vector<size_t>> upperLinks;
+  //! The point the searches start from.
+  size_t entryPoint;
+  //! The top level of the graph.
+  size_t maxLevel;
+  //! The number of distance evaluations performed.
+  size_t distanceEvaluations;
+}; // class HNSWSearch
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
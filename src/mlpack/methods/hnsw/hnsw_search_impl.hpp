@@ -0,0 +1,520 @@
+/**
+ * @file hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+#include <mlpack/core/math/random.hpp>
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(const size_t m,
+                                            const size_t efConstruction,
+                                            const size_t efSearch,
+                                            const MetricType metric) :
+    metric(metric),
+    m(m),
+    efConstruction(efConstruction),
+    efSearch(efSearch),
+    entryPoint(0),
+    maxLevel(0),
+    distanceEvaluations(0)
+{
+  if (m < 2)
+    throw std::invalid_argument("HNSWSearch::HNSWSearch(): the number of links"
+        " per point (m) must be at least 2");
+}
+
+template<typename MetricType, typename MatType>
+HNSWSearch<MetricType, MatType>::HNSWSearch(MatType referenceSet,
+                                            const size_t m,
+                                            const size_t efConstruction,
+                                            const size_t efSearch,
+                                            const MetricType metric) :
+    HNSWSearch(m, efConstruction, efSearch, metric)
+{
+  Train(std::move(referenceSet));
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Train(MatType referenceSetIn)
+{
+  referenceSet = std::move(referenceSetIn);
+  levels.clear();
+  baseLinks.clear();
+  upperLinks.clear();
+  entryPoint = 0;
+  maxLevel = 0;
+
+  Build(0);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Insert(const MatType& newPoints)
+{
+  if (referenceSet.n_cols > 0 && newPoints.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Insert(): dimensionality of new points ("
+        << newPoints.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  const size_t begin = referenceSet.n_cols;
+  if (begin == 0)
+    referenceSet = newPoints;
+  else
+    referenceSet.insert_cols(begin, newPoints);
+
+  Build(begin);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Build(const size_t begin)
+{
+  const size_t n = referenceSet.n_cols;
+
+  // Draw the level of each new point, and allocate the storage of its links.
+  // The levels are drawn serially, so that they only depend on the random
+  // seed.
+  const double levelMultiplier = 1.0 / std::log((double) m);
+  levels.resize(n);
+  baseLinks.resize(n * (2 * m + 1), 0);
+  upperLinks.resize(n);
+  for (size_t i = begin; i < n; ++i)
+  {
+    levels[i] = (size_t) std::floor(-std::log(1.0 - math::Random()) *
+        levelMultiplier);
+    upperLinks[i].assign(levels[i] * (m + 1), 0);
+  }
+
+  if (begin == n)
+    return;
+
+  // The first point of an empty graph is the entry point.
+  size_t first = begin;
+  if (begin == 0)
+  {
+    entryPoint = 0;
+    maxLevel = levels[0];
+    first = 1;
+  }
+
+  Timer::Start("hnsw_construction");
+
+  std::vector<std::mutex> locks(n);
+  std::mutex entryLock;
+  size_t evaluations = 0;
+
+  #pragma omp parallel reduction(+:evaluations)
+  {
+    VisitedList visited(n);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = (omp_size_t) first; i < (omp_size_t) n; ++i)
+      InsertPoint(i, locks.data(), entryLock, visited, evaluations);
+  }
+
+  Timer::Stop("hnsw_construction");
+
+  distanceEvaluations += evaluations;
+  Log::Info << "HNSW graph built on " << n << " points with " << maxLevel + 1
+      << " levels." << std::endl;
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::InsertPoint(const size_t point,
+                                                  std::mutex* locks,
+                                                  std::mutex& entryLock,
+                                                  VisitedList& visited,
+                                                  size_t& evaluations)
+{
+  const size_t level = levels[point];
+
+  // A point that becomes the new top of the graph holds the entry lock until
+  // it is inserted, so that the entry point is never a point without links.
+  std::unique_lock<std::mutex> entryGuard(entryLock);
+  const size_t currentEntry = entryPoint;
+  const size_t currentMaxLevel = maxLevel;
+  if (level <= currentMaxLevel)
+    entryGuard.unlock();
+
+  const arma::Col<typename MatType::elem_type> query =
+      referenceSet.unsafe_col(point);
+  Candidate entry(Distance(query, currentEntry, evaluations), currentEntry);
+  for (size_t l = currentMaxLevel; l > level; --l)
+    entry = GreedySearch(query, entry, l, locks, evaluations);
+
+  const size_t ef = std::max(efConstruction, m);
+  std::vector<Candidate> entries(1, entry);
+  std::vector<Candidate> selected;
+  for (size_t l = std::min(level, currentMaxLevel) + 1; l-- > 0; )
+  {
+    std::vector<Candidate> candidates = SearchLevel(query, entries, ef, l,
+        visited, locks, evaluations);
+    SelectNeighbors(candidates, m, selected, evaluations);
+
+    {
+      std::lock_guard<std::mutex> guard(locks[point]);
+      size_t* links = Links(point, l);
+      links[0] = selected.size();
+      for (size_t i = 0; i < selected.size(); ++i)
+        links[i + 1] = selected[i].second;
+    }
+
+    for (size_t i = 0; i < selected.size(); ++i)
+    {
+      Connect(selected[i].second, point, selected[i].first, l, locks,
+          evaluations);
+    }
+
+    entries = std::move(candidates);
+  }
+
+  if (level > currentMaxLevel)
+  {
+    entryPoint = point;
+    maxLevel = level;
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Connect(const size_t reference,
+                                              const size_t newPoint,
+                                              const double distance,
+                                              const size_t level,
+                                              std::mutex* locks,
+                                              size_t& evaluations)
+{
+  const size_t maxLinks = (level == 0) ? 2 * m : m;
+
+  std::lock_guard<std::mutex> guard(locks[reference]);
+  size_t* links = Links(reference, level);
+  if (links[0] < maxLinks)
+  {
+    links[++links[0]] = newPoint;
+    return;
+  }
+
+  // The point is full, so its links are selected again.
+  const arma::Col<typename MatType::elem_type> point =
+      referenceSet.unsafe_col(reference);
+  std::vector<Candidate> candidates;
+  candidates.reserve(maxLinks + 1);
+  candidates.push_back(Candidate(distance, newPoint));
+  for (size_t i = 1; i <= links[0]; ++i)
+  {
+    candidates.push_back(Candidate(Distance(point, links[i], evaluations),
+        links[i]));
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  std::vector<Candidate> selected;
+  SelectNeighbors(candidates, maxLinks, selected, evaluations);
+  links[0] = selected.size();
+  for (size_t i = 0; i < selected.size(); ++i)
+    links[i + 1] = selected[i].second;
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    const size_t maxLinks,
+    std::vector<Candidate>& selected,
+    size_t& evaluations)
+{
+  selected.clear();
+  for (size_t i = 0; i < candidates.size() && selected.size() < maxLinks; ++i)
+  {
+    const arma::Col<typename MatType::elem_type> candidate =
+        referenceSet.unsafe_col(candidates[i].second);
+
+    bool diverse = true;
+    for (size_t j = 0; j < selected.size() && diverse; ++j)
+    {
+      diverse = (Distance(candidate, selected[j].second, evaluations) >=
+          candidates[i].first);
+    }
+
+    if (diverse)
+      selected.push_back(candidates[i]);
+  }
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::CopyLinks(
+    const size_t point,
+    const size_t level,
+    std::mutex* locks,
+    std::vector<size_t>& links) const
+{
+  std::unique_lock<std::mutex> guard;
+  if (locks)
+    guard = std::unique_lock<std::mutex>(locks[point]);
+
+  const size_t* pointLinks = Links(point, level);
+  links.assign(pointLinks + 1, pointLinks + 1 + pointLinks[0]);
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+typename HNSWSearch<MetricType, MatType>::Candidate
+HNSWSearch<MetricType, MatType>::GreedySearch(const VecType& query,
+                                              Candidate entry,
+                                              const size_t level,
+                                              std::mutex* locks,
+                                              size_t& evaluations)
+{
+  std::vector<size_t> links;
+  bool moved = true;
+  while (moved)
+  {
+    moved = false;
+    CopyLinks(entry.second, level, locks, links);
+    for (size_t i = 0; i < links.size(); ++i)
+    {
+      const double distance = Distance(query, links[i], evaluations);
+      if (distance < entry.first)
+      {
+        entry = Candidate(distance, links[i]);
+        moved = true;
+      }
+    }
+  }
+
+  return entry;
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType>
+std::vector<typename HNSWSearch<MetricType, MatType>::Candidate>
+HNSWSearch<MetricType, MatType>::SearchLevel(
+    const VecType& query,
+    const std::vector<Candidate>& entries,
+    const size_t ef,
+    const size_t level,
+    VisitedList& visited,
+    std::mutex* locks,
+    size_t& evaluations)
+{
+  // The candidates to expand, nearest first, and the ef nearest points found,
+  // farthest first.
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> candidates;
+  std::priority_queue<Candidate> results;
+
+  visited.Reset();
+  for (size_t i = 0; i < entries.size(); ++i)
+  {
+    visited.Visit(entries[i].second);
+    candidates.push(entries[i]);
+    results.push(entries[i]);
+    if (results.size() > ef)
+      results.pop();
+  }
+
+  std::vector<size_t> links;
+  while (!candidates.empty())
+  {
+    const Candidate nearest = candidates.top();
+    if (nearest.first > results.top().first && results.size() >= ef)
+      break;
+    candidates.pop();
+
+    CopyLinks(nearest.second, level, locks, links);
+    for (size_t i = 0; i < links.size(); ++i)
+    {
+      if (visited.Visit(links[i]))
+        continue;
+
+      const double distance = Distance(query, links[i], evaluations);
+      if (results.size() < ef || distance < results.top().first)
+      {
+        candidates.push(Candidate(distance, links[i]));
+        results.push(Candidate(distance, links[i]));
+        if (results.size() > ef)
+          results.pop();
+      }
+    }
+  }
+
+  std::vector<Candidate> nearestPoints(results.size());
+  for (size_t i = nearestPoints.size(); i > 0; --i)
+  {
+    nearestPoints[i - 1] = results.top();
+    results.pop();
+  }
+
+  return nearestPoints;
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const MatType& querySet,
+                                             const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  // Ensure the dimensionality of the query set is correct.
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << referenceSet.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  SearchQueries(querySet, k, false, neighbors, distances);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::Search(const size_t k,
+                                             arma::Mat<size_t>& neighbors,
+                                             arma::mat& distances)
+{
+  if (k >= referenceSet.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HNSWSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << referenceSet.n_cols
+        << " points, including the query points themselves!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  SearchQueries(referenceSet, k, true, neighbors, distances);
+}
+
+template<typename MetricType, typename MatType>
+void HNSWSearch<MetricType, MatType>::SearchQueries(
+    const MatType& querySet,
+    const size_t k,
+    const bool sameSet,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // If the user asked for 0 nearest neighbors... uh... we're done.
+  if (k == 0)
+    return;
+
+  // A monochromatic search finds the query point itself too.
+  const size_t ef = std::max(efSearch, sameSet ? k + 1 : k);
+  size_t evaluations = 0;
+
+  Timer::Start("computing_neighbors");
+
+  // Each query writes only its own results, and the number of distance
+  // evaluations is summed with a reduction.
+  #pragma omp parallel reduction(+:evaluations)
+  {
+    VisitedList visited(referenceSet.n_cols);
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+    {
+      const arma::Col<typename MatType::elem_type> query =
+          querySet.unsafe_col(i);
+      Candidate entry(Distance(query, entryPoint, evaluations), entryPoint);
+      for (size_t l = maxLevel; l > 0; --l)
+        entry = GreedySearch(query, entry, l, NULL, evaluations);
+
+      const std::vector<Candidate> results = SearchLevel(query,
+          std::vector<Candidate>(1, entry), ef, 0, visited, NULL,
+          evaluations);
+
+      size_t found = 0;
+      for (size_t j = 0; j < results.size() && found < k; ++j)
+      {
+        if (sameSet && results[j].second == (size_t) i)
+          continue;
+
+        neighbors(found, i) = results[j].second;
+        distances(found, i) = results[j].first;
+        ++found;
+      }
+
+      for (; found < k; ++found)
+      {
+        neighbors(found, i) = referenceSet.n_cols;
+        distances(found, i) = DBL_MAX;
+      }
+    }
+  }
+
+  Timer::Stop("computing_neighbors");
+
+  distanceEvaluations += evaluations;
+}
+
+template<typename MetricType, typename MatType>
+double HNSWSearch<MetricType, MatType>::ComputeRecall(
+    const arma::Mat<size_t>& foundNeighbors,
+    const arma::Mat<size_t>& realNeighbors)
+{
+  if (foundNeighbors.n_rows != realNeighbors.n_rows ||
+      foundNeighbors.n_cols != realNeighbors.n_cols)
+    throw std::invalid_argument("HNSWSearch::ComputeRecall(): matrices "
+        "provided must have equal size");
+
+  // The recall is the set intersection of found and real neighbors.
+  size_t found = 0;
+  for (size_t col = 0; col < foundNeighbors.n_cols; ++col)
+    for (size_t row = 0; row < realNeighbors.n_rows; ++row)
+      for (size_t nei = 0; nei < foundNeighbors.n_rows; ++nei)
+        if (realNeighbors(row, col) == foundNeighbors(nei, col))
+        {
+          found++;
+          break;
+        }
+
+  return ((double) found) / realNeighbors.n_elem;
+}
+
+template<typename MetricType, typename MatType>
+template<typename Archive>
+void HNSWSearch<MetricType, MatType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(referenceSet);
+  ar & BOOST_SERIALIZATION_NVP(metric);
+  ar & BOOST_SERIALIZATION_NVP(m);
+  ar & BOOST_SERIALIZATION_NVP(efConstruction);
+  ar & BOOST_SERIALIZATION_NVP(efSearch);
+  ar & BOOST_SERIALIZATION_NVP(levels);
+  ar & BOOST_SERIALIZATION_NVP(baseLinks);
+  ar & BOOST_SERIALIZATION_NVP(upperLinks);
+  ar & BOOST_SERIALIZATION_NVP(entryPoint);
+  ar & BOOST_SERIALIZATION_NVP(maxLevel);
+  ar & BOOST_SERIALIZATION_NVP(distanceEvaluations);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
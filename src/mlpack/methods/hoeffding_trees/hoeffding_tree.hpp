@@ -15,9 +15,11 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/data/dataset_mapper.hpp>
+#include <mlpack/core/data/matrix_reader.hpp>
 #include "gini_impurity.hpp"
 #include "hoeffding_numeric_split.hpp"
 #include "hoeffding_categorical_split.hpp"
+#include "quantile_numeric_split.hpp"
 
 namespace mlpack {
 namespace tree {
@@ -48,6 +50,14 @@ namespace tree {
  * are handled.  As far as the actual splitting goes, the meat of the splitting
  * procedure will be contained in those two classes.
  *
+ * Every leaf keeps split statistics for every dimension, so on wide data the
+ * memory used by the tree grows quickly with the number of leaves.  As in the
+ * VFDT paper, the number of leaves that collect statistics can be bounded with
+ * MaxActiveLeaves(): the least promising leaves (those whose probability of
+ * seeing a point times their error rate is smallest) are then deactivated and
+ * free their statistics, and they can later be reactivated if they become
+ * more promising than an active leaf.
+ *
  * @tparam FitnessFunction Fitness function to use.
  * @tparam NumericSplitType Technique for splitting numeric features.
  * @tparam CategoricalSplitType Technique for splitting categorical features.
@@ -186,6 +196,50 @@ class HoeffdingTree
   template<typename VecType>
   void Train(const VecType& point, const size_t label);
 
+  /**
+   * Train on a mini-batch of points in streaming mode, with the given labels.
+   * The points are first routed to the leaves they fall into, and then the
+   * statistics of every dimension of every leaf are updated with all of their
+   * points at once, in parallel if OpenMP is enabled.  Each leaf checks for a
+   * split once, at the end of the batch, if the batch brought its number of
+   * samples past a multiple of CheckInterval().  This gives the same tree as
+   * passing each point to Train(), except that a leaf that splits during the
+   * batch does not pass the rest of the points of the batch to its children.
+   *
+   * @param data Mini-batch of points to train on.
+   * @param labels Labels of the points.
+   */
+  template<typename MatType>
+  void TrainMiniBatch(const MatType& data, const arma::Row<size_t>& labels);
+
+  /**
+   * Train in streaming mode on the points of the given readers, one
+   * mini-batch at a time with TrainMiniBatch(), so that the training data
+   * never has to be in memory at once.  The next batch is read while the
+   * current one is trained on.  The types of the dimensions of the tree must
+   * match those of the data reader.  A std::runtime_error is thrown if the
+   * readers don't have the same number of points.
+   *
+   * @param data Reader of the points to train on.
+   * @param labels Reader of the labels of the points, with one dimension.
+   * @param batchSize Number of points read at a time.
+   */
+  void Train(data::MatrixReader& data,
+             data::MatrixReader& labels,
+             const size_t batchSize = 10000);
+
+  /**
+   * Make sure that at most MaxActiveLeaves() leaves below this node collect
+   * statistics.  All the leaves are ranked by their promise, that is, the
+   * number of points they have seen times their error rate; the most promising
+   * leaves are (re)activated and the others are deactivated.  A deactivated
+   * leaf frees its statistics and keeps predicting its majority class; a
+   * reactivated leaf starts new statistics.  If MaxActiveLeaves() is 0,
+   * every leaf is activated.  It is called automatically every CheckInterval()
+   * points given to this node.
+   */
+  void EnforceLeafBudget();
+
   /**
    * Check if a split would satisfy the conditions of the Hoeffding bound with
    * the node's specified success probability.  If so, the number of children
@@ -234,6 +288,21 @@ class HoeffdingTree
   //! Modify the number of samples before a split check is performed.
   void CheckInterval(const size_t checkInterval);
 
+  //! Get the maximum number of active leaves below this node (0 if there is
+  //! no limit).
+  size_t MaxActiveLeaves() const { return maxActiveLeaves; }
+  //! Modify the maximum number of active leaves below this node (0 for no
+  //! limit).  This is only enforced by the node it is set on, which should be
+  //! the node that training points are given to (usually the root).
+  void MaxActiveLeaves(const size_t maxActiveLeaves);
+
+  //! Get whether this node is an active leaf, or an internal node.  Inactive
+  //! leaves do not collect statistics.
+  bool Active() const { return active; }
+
+  //! Get the number of active leaves in this (sub)tree.
+  size_t NumActiveLeaves() const;
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -303,9 +372,20 @@ class HoeffdingTree
    */
   void CreateChildren();
 
+  /**
+   * Stop collecting statistics in this leaf, and free them; the leaf keeps
+   * predicting its majority class.
+   */
+  void Deactivate();
+
+  /**
+   * Start collecting new statistics in this leaf.
+   */
+  void Activate();
+
   //! Serialize the split.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
   // We need to keep some information for before we have split.
@@ -336,6 +416,16 @@ class HoeffdingTree
   bool ownsInfo;
   //! The required probability of success for a split to be performed.
   double successProbability;
+  //! Whether or not this leaf collects statistics.
+  bool active;
+  //! The number of samples seen by this node as a leaf, whether it was active
+  //! or not.
+  size_t leafSamples;
+  //! The maximum number of active leaves below this node (0 for no limit).
+  size_t maxActiveLeaves;
+  //! The number of samples given to this node since the leaf budget was last
+  //! enforced.
+  size_t budgetSamples;
 
   // And we need to keep some information for after we have split.
 
@@ -357,6 +447,27 @@ class HoeffdingTree
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the HoeffdingTree class.  Version 1 stores
+//! the leaf budget and whether each leaf is active.
+//! BOOST_TEMPLATE_CLASS_VERSION() cannot be used here, because the template
+//! signature contains commas.
+namespace boost {
+namespace serialization {
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+struct version<mlpack::tree::HoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 #include "hoeffding_tree_impl.hpp"
 
 #endif
@@ -50,6 +50,10 @@ HoeffdingTree<
     datasetInfo(new data::DatasetInfo(datasetInfo)),
     ownsInfo(true),
     successProbability(successProbability),
+    active(true),
+    leafSamples(0),
+    maxActiveLeaves(0),
+    budgetSamples(0),
     splitDimension(size_t(-1)),
     majorityClass(0),
     majorityProbability(0.0),
@@ -108,6 +112,10 @@ HoeffdingTree<
     datasetInfo(new data::DatasetInfo(datasetInfo)),
     ownsInfo(true),
     successProbability(successProbability),
+    active(true),
+    leafSamples(0),
+    maxActiveLeaves(0),
+    budgetSamples(0),
     splitDimension(size_t(-1)),
     majorityClass(0),
     majorityProbability(0.0),
@@ -172,6 +180,10 @@ HoeffdingTree<
     datasetInfo(new data::DatasetInfo()),
     ownsInfo(true),
     successProbability(0.95),
+    active(true),
+    leafSamples(0),
+    maxActiveLeaves(0),
+    budgetSamples(0),
     splitDimension(size_t(-1)),
     majorityClass(0),
     majorityProbability(0.0),
@@ -200,6 +212,10 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     datasetInfo(new data::DatasetInfo(*other.datasetInfo)),
     ownsInfo(true),
     successProbability(other.successProbability),
+    active(other.active),
+    leafSamples(other.leafSamples),
+    maxActiveLeaves(other.maxActiveLeaves),
+    budgetSamples(other.budgetSamples),
     splitDimension(other.splitDimension),
     majorityClass(other.majorityClass),
     majorityProbability(other.majorityProbability),
@@ -245,8 +261,7 @@ void HoeffdingTree<
     // Don't split if there are fewer than five points.
     size_t oldMaxSamples = maxSamples;
     maxSamples = std::max(size_t(data.n_cols - 1), size_t(5));
-    for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+    TrainMiniBatch(data, labels);
     maxSamples = oldMaxSamples;
 
     // Now, if we did split, find out which points go to which child, and
@@ -301,6 +316,8 @@ void HoeffdingTree<
     for (size_t i = 0; i < data.n_cols; ++i)
       Train(data.col(i), labels[i]);
   }
+
+  EnforceLeafBudget();
 }
 
 //! Train on a set of points.
@@ -370,8 +387,14 @@ void HoeffdingTree<
     CategoricalSplitType
 >::Train(const VecType& point, const size_t label)
 {
-  if (splitDimension == size_t(-1))
+  if (splitDimension == size_t(-1) && !active)
+  {
+    // An inactive leaf only counts the points it sees, for its promise.
+    ++leafSamples;
+  }
+  else if (splitDimension == size_t(-1))
   {
+    ++leafSamples;
     ++numSamples;
     size_t numericIndex = 0;
     size_t categoricalIndex = 0;
@@ -414,6 +437,164 @@ void HoeffdingTree<
     size_t direction = CalculateDirection(point);
     children[direction]->Train(point, label);
   }
+
+  // Check the leaf budget, if this node has one.
+  if (maxActiveLeaves > 0 && ++budgetSamples >= checkInterval)
+    EnforceLeafBudget();
+}
+
+//! Train on a mini-batch of points.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainMiniBatch(const MatType& data, const arma::Row<size_t>& labels)
+{
+  // Find the leaf that each point falls into.  The tree is not modified until
+  // all the points have been routed.
+  std::vector<HoeffdingTree*> pointLeaves(data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    HoeffdingTree* node = this;
+    while (node->splitDimension != size_t(-1))
+      node = node->children[node->CalculateDirection(data.col(i))];
+    pointLeaves[i] = node;
+  }
+
+  // Group the points by leaf, in the order they were given.
+  std::vector<HoeffdingTree*> leaves;
+  std::vector<std::vector<size_t>> leafPoints;
+  std::unordered_map<HoeffdingTree*, size_t> leafIndices;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    const std::pair<typename std::unordered_map<HoeffdingTree*,
+        size_t>::iterator, bool> result = leafIndices.insert(
+        std::make_pair(pointLeaves[i], leaves.size()));
+    if (result.second)
+    {
+      leaves.push_back(pointLeaves[i]);
+      leafPoints.push_back(std::vector<size_t>());
+    }
+
+    leafPoints[result.first->second].push_back(i);
+  }
+
+  // Each dimension of each leaf has its own statistics, so they can all be
+  // updated at the same time.
+  const size_t dims = data.n_rows;
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t k = 0; k < (omp_size_t) (leaves.size() * dims); ++k)
+  {
+    HoeffdingTree& leaf = *leaves[k / dims];
+    const std::vector<size_t>& points = leafPoints[k / dims];
+    const size_t dim = k % dims;
+    if (!leaf.active)
+      continue;
+
+    const size_t type = dimensionMappings->at(dim).first;
+    const size_t index = dimensionMappings->at(dim).second;
+    if (type == data::Datatype::categorical)
+    {
+      for (size_t j = 0; j < points.size(); ++j)
+        leaf.categoricalSplits[index].Train(data(dim, points[j]),
+            labels[points[j]]);
+    }
+    else if (type == data::Datatype::numeric)
+    {
+      for (size_t j = 0; j < points.size(); ++j)
+        leaf.numericSplits[index].Train(data(dim, points[j]),
+            labels[points[j]]);
+    }
+  }
+
+  // Now check each leaf for a split, once.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t l = 0; l < (omp_size_t) leaves.size(); ++l)
+  {
+    HoeffdingTree& leaf = *leaves[l];
+    leaf.leafSamples += leafPoints[l].size();
+    if (!leaf.active)
+      continue;
+
+    const size_t oldNumSamples = leaf.numSamples;
+    leaf.numSamples += leafPoints[l].size();
+
+    // Grab majority class from splits.
+    if (leaf.categoricalSplits.size() > 0)
+    {
+      leaf.majorityClass = leaf.categoricalSplits[0].MajorityClass();
+      leaf.majorityProbability =
+          leaf.categoricalSplits[0].MajorityProbability();
+    }
+    else
+    {
+      leaf.majorityClass = leaf.numericSplits[0].MajorityClass();
+      leaf.majorityProbability = leaf.numericSplits[0].MajorityProbability();
+    }
+
+    // Check for a split, if the batch took us past a check.
+    if (leaf.numSamples / leaf.checkInterval >
+        oldNumSamples / leaf.checkInterval)
+    {
+      const size_t numChildren = leaf.SplitCheck();
+      if (numChildren > 0)
+      {
+        // We need to add a bunch of children.
+        // Delete children, if we have them.
+        leaf.children.clear();
+        leaf.CreateChildren();
+      }
+    }
+  }
+
+  // Check the leaf budget, if this node has one.
+  budgetSamples += data.n_cols;
+  if (maxActiveLeaves > 0 && budgetSamples >= checkInterval)
+    EnforceLeafBudget();
+}
+
+//! Train on the points of the given readers.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Train(data::MatrixReader& data,
+         data::MatrixReader& labels,
+         const size_t batchSize)
+{
+  if (labels.Dimensionality() != 1)
+  {
+    std::ostringstream oss;
+    oss << "HoeffdingTree::Train(): the labels have "
+        << labels.Dimensionality() << " dimensions, but should have 1";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat dataBatch, labelBatch;
+  bool moreData = data.NextBatch(dataBatch, batchSize);
+  bool moreLabels = labels.NextBatch(labelBatch, batchSize);
+  while (moreData && moreLabels && dataBatch.n_cols == labelBatch.n_cols)
+  {
+    TrainMiniBatch(dataBatch,
+        arma::conv_to<arma::Row<size_t>>::from(labelBatch));
+
+    moreData = data.NextBatch(dataBatch, batchSize);
+    moreLabels = labels.NextBatch(labelBatch, batchSize);
+  }
+
+  if (moreData || moreLabels)
+  {
+    throw std::runtime_error("HoeffdingTree::Train(): the data and the labels "
+        "don't have the same number of points");
+  }
 }
 
 template<typename FitnessFunction,
@@ -569,6 +750,42 @@ void HoeffdingTree<
     children[i]->CheckInterval(checkInterval);
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::MaxActiveLeaves(const size_t maxActiveLeaves)
+{
+  this->maxActiveLeaves = maxActiveLeaves;
+  EnforceLeafBudget();
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+size_t HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::NumActiveLeaves() const
+{
+  if (splitDimension == size_t(-1))
+    return active ? 1 : 0;
+
+  size_t numActiveLeaves = 0;
+  for (size_t i = 0; i < children.size(); ++i)
+    numActiveLeaves += children[i]->NumActiveLeaves();
+
+  return numActiveLeaves;
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -762,6 +979,17 @@ void HoeffdingTree<
           categoricalSplits[0], numericSplits[0], dimensionMappings));
     }
 
+    // The children share our dataset information, like the dimension
+    // mappings, instead of each holding a copy of it.
+    delete children[i]->datasetInfo;
+    children[i]->datasetInfo = datasetInfo;
+    children[i]->ownsInfo = false;
+
+    // Until it has seen points of its own, each child is taken to see an equal
+    // share of our points, so that the leaf budget does not deactivate it
+    // right away.
+    children[i]->leafSamples = leafSamples / childMajorities.n_elem;
+
     children[i]->MajorityClass() = childMajorities[i];
   }
 
@@ -770,6 +998,138 @@ void HoeffdingTree<
   categoricalSplits.clear();
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Deactivate()
+{
+  active = false;
+  numSamples = 0;
+
+  // Only keep one new split of each type, so that Activate() can create the
+  // statistics again with the same parameters.
+  if (numericSplits.size() > 0)
+  {
+    const NumericSplitType<FitnessFunction> numericSplitIn(numClasses,
+        numericSplits[0]);
+    numericSplits.clear();
+    numericSplits.push_back(numericSplitIn);
+  }
+
+  if (categoricalSplits.size() > 0)
+  {
+    const CategoricalSplitType<FitnessFunction> categoricalSplitIn(0,
+        numClasses, categoricalSplits[0]);
+    categoricalSplits.clear();
+    categoricalSplits.push_back(categoricalSplitIn);
+  }
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::Activate()
+{
+  active = true;
+  numSamples = 0;
+
+  const CategoricalSplitType<FitnessFunction> categoricalSplitIn =
+      (categoricalSplits.size() > 0) ? categoricalSplits[0] :
+      CategoricalSplitType<FitnessFunction>(0, numClasses);
+  const NumericSplitType<FitnessFunction> numericSplitIn =
+      (numericSplits.size() > 0) ? numericSplits[0] :
+      NumericSplitType<FitnessFunction>(numClasses);
+
+  numericSplits.clear();
+  categoricalSplits.clear();
+  for (size_t i = 0; i < datasetInfo->Dimensionality(); ++i)
+  {
+    if (datasetInfo->Type(i) == data::Datatype::categorical)
+    {
+      categoricalSplits.push_back(CategoricalSplitType<FitnessFunction>(
+          datasetInfo->NumMappings(i), numClasses, categoricalSplitIn));
+    }
+    else
+    {
+      numericSplits.push_back(NumericSplitType<FitnessFunction>(numClasses,
+          numericSplitIn));
+    }
+  }
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::EnforceLeafBudget()
+{
+  budgetSamples = 0;
+
+  // Collect all of the leaves below this node.
+  std::vector<HoeffdingTree*> leaves;
+  std::stack<HoeffdingTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    HoeffdingTree* node = stack.top();
+    stack.pop();
+
+    if (node->splitDimension == size_t(-1))
+      leaves.push_back(node);
+    else
+      for (size_t i = 0; i < node->children.size(); ++i)
+        stack.push(node->children[i]);
+  }
+
+  if (maxActiveLeaves == 0 || leaves.size() <= maxActiveLeaves)
+  {
+    // There is no budget, or every leaf fits in it.
+    for (size_t i = 0; i < leaves.size(); ++i)
+      if (!leaves[i]->active)
+        leaves[i]->Activate();
+    return;
+  }
+
+  // The promise of a leaf is the probability that a point reaches it times its
+  // error rate; the total number of points is the same for every leaf, so it
+  // is left out.
+  arma::vec promises(leaves.size());
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    promises[i] = leaves[i]->leafSamples *
+        (1.0 - leaves[i]->majorityProbability);
+  }
+
+  // Keep the most promising leaves active.  Ties keep the order of the
+  // traversal, so that the result is deterministic.
+  const arma::uvec order = arma::stable_sort_index(promises, "descend");
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    HoeffdingTree* leaf = leaves[order[i]];
+    if (i < maxActiveLeaves && !leaf->active)
+      leaf->Activate();
+    else if (i >= maxActiveLeaves && leaf->active)
+      leaf->Deactivate();
+  }
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -780,10 +1140,27 @@ void HoeffdingTree<
     FitnessFunction,
     NumericSplitType,
     CategoricalSplitType
->::serialize(Archive& ar, const unsigned int /* version */)
+>::serialize(Archive& ar, const unsigned int version)
 {
   ar & BOOST_SERIALIZATION_NVP(splitDimension);
 
+  // Older versions did not have a leaf budget, so every leaf was active.
+  if (version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(active);
+    ar & BOOST_SERIALIZATION_NVP(leafSamples);
+    ar & BOOST_SERIALIZATION_NVP(maxActiveLeaves);
+  }
+  else if (Archive::is_loading::value)
+  {
+    active = true;
+    leafSamples = 0;
+    maxActiveLeaves = 0;
+  }
+
+  if (Archive::is_loading::value)
+    budgetSamples = 0;
+
   // Clear memory for the mappings if necessary.
   if (Archive::is_loading::value && ownsMappings && dimensionMappings)
     delete dimensionMappings;
@@ -840,6 +1217,10 @@ void HoeffdingTree<
               NumericSplitType<FitnessFunction>(numClasses));
       }
 
+      // An inactive leaf does not hold statistics.
+      if (!active)
+        Deactivate();
+
       // Clear things we don't need.
       categoricalSplit = typename CategoricalSplitType<FitnessFunction>::
           SplitInfo(numClasses);
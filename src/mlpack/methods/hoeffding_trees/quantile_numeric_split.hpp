@@ -0,0 +1,155 @@
+/**
+ * @file quantile_numeric_split.hpp
+ *
+ * A numeric feature split for Hoeffding trees that summarizes the values it
+ * has seen with a fixed-size streaming histogram, so that its memory does not
+ * depend on the number of points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "binary_numeric_split_info.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The QuantileNumericSplit class summarizes the values of a numeric feature
+ * with the streaming histogram of Ben-Haim and Tom-Tov, a compact quantile
+ * sketch:
+ *
+ * @code
+ * @article{ben2010streaming,
+ *   title={A Streaming Parallel Decision Tree Algorithm},
+ *   author={Ben-Haim, Y. and Tom-Tov, E.},
+ *   journal={Journal of Machine Learning Research},
+ *   volume={11},
+ *   pages={849--872},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * The sketch holds at most MaxBins() bins, each with a centroid and the number
+ * of points of each class that it holds.  Each new value is added as its own
+ * bin, and if there are then too many bins, the two bins with the closest
+ * centroids are merged.  Unlike HoeffdingNumericSplit, no values are buffered
+ * before the bins are known, and unlike BinaryNumericSplit, the memory used
+ * does not grow with the number of points: it is O(MaxBins() * numClasses).
+ *
+ * Candidate binary splits lie halfway between the centroids of neighboring
+ * bins, so EvaluateFitnessFunction() takes O(MaxBins() * numClasses) time.
+ * Like HoeffdingNumericSplit, only the fitness of the best of these splits is
+ * returned, since neighboring candidates of one dimension are not meant to be
+ * compared with each other by the Hoeffding bound.
+ *
+ * @tparam FitnessFunction Fitness function to use for calculating gain.
+ * @tparam ObservationType Type of observation used by this dimension.
+ */
+template<typename FitnessFunction,
+         typename ObservationType = double>
+class QuantileNumericSplit
+{
+ public:
+  //! The splitting information required by the QuantileNumericSplit.
+  typedef BinaryNumericSplitInfo<ObservationType> SplitInfo;
+
+  /**
+   * Create the QuantileNumericSplit object with the given number of classes
+   * and the given maximum number of bins.
+   *
+   * @param numClasses Number of classes in dataset.
+   * @param maxBins Maximum number of bins of the sketch.
+   */
+  QuantileNumericSplit(const size_t numClasses = 0,
+                       const size_t maxBins = 32);
+
+  /**
+   * Create the QuantileNumericSplit object with the given number of classes,
+   * using the maximum number of bins of the given other split.
+   */
+  QuantileNumericSplit(const size_t numClasses,
+                       const QuantileNumericSplit& other);
+
+  /**
+   * Train on the given value with the given label.
+   *
+   * @param value The value to train on.
+   * @param label The label to train on.
+   */
+  void Train(ObservationType value, const size_t label);
+
+  /**
+   * Evaluate the fitness function of every candidate split, and return the
+   * best value.  The second best value is always 0.
+   *
+   * @param bestFitness Fitness function value for best possible split.
+   * @param secondBestFitness Fitness function value for second best possible
+   *      split (always 0).
+   */
+  void EvaluateFitnessFunction(double& bestFitness,
+                               double& secondBestFitness) const;
+
+  //! Return the number of children if this node were to split on this feature.
+  size_t NumChildren() const { return 2; }
+
+  /**
+   * Given that a split should happen, return the majority classes of the (two)
+   * children and an initialized SplitInfo object.
+   *
+   * @param childMajorities Majority classes of the children after the split.
+   * @param splitInfo Split information.
+   */
+  void Split(arma::Col<size_t>& childMajorities, SplitInfo& splitInfo) const;
+
+  //! The majority class of the points seen so far.
+  size_t MajorityClass() const;
+  //! The probability of the majority class given the points seen so far.
+  double MajorityProbability() const;
+
+  //! Get the maximum number of bins.
+  size_t MaxBins() const { return maxBins; }
+  //! Get the number of bins in use.
+  size_t NumBins() const { return numBins; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Find the best split, and return the index of the last bin on its left
+   * side, or NumBins() if there is no possible split.  The fitness of the best
+   * and second best splits are also returned.
+   */
+  size_t BestSplit(double& bestFitness, double& secondBestFitness) const;
+
+  //! The maximum number of bins.
+  size_t maxBins;
+  //! The number of bins in use.
+  size_t numBins;
+  //! The centroids of the bins, in increasing order (length maxBins + 1).
+  arma::Col<ObservationType> centroids;
+  //! The number of points of each class in each bin (maxBins + 1 columns).
+  arma::Mat<size_t> sufficientStatistics;
+  //! The number of points of each class.
+  arma::Col<size_t> classCounts;
+};
+
+// Convenience typedef.
+template<typename FitnessFunction>
+using QuantileDoubleNumericSplit = QuantileNumericSplit<FitnessFunction,
+    double>;
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "quantile_numeric_split_impl.hpp"
+
+#endif
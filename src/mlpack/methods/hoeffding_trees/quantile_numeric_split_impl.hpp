@@ -0,0 +1,223 @@
+/**
+ * @file quantile_numeric_split_impl.hpp
+ *
+ * Implementation of the QuantileNumericSplit class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_QUANTILE_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "quantile_numeric_split.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction, typename ObservationType>
+QuantileNumericSplit<FitnessFunction, ObservationType>::QuantileNumericSplit(
+    const size_t numClasses,
+    const size_t maxBins) :
+    maxBins(maxBins),
+    numBins(0),
+    centroids(maxBins + 1),
+    sufficientStatistics(numClasses, maxBins + 1),
+    classCounts(numClasses)
+{
+  if (maxBins < 2)
+  {
+    std::ostringstream oss;
+    oss << "QuantileNumericSplit::QuantileNumericSplit(): maxBins must be at "
+        << "least 2 (given " << maxBins << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  sufficientStatistics.zeros();
+  classCounts.zeros();
+}
+
+template<typename FitnessFunction, typename ObservationType>
+QuantileNumericSplit<FitnessFunction, ObservationType>::QuantileNumericSplit(
+    const size_t numClasses,
+    const QuantileNumericSplit& other) :
+    QuantileNumericSplit(numClasses, other.maxBins)
+{
+  // Nothing to do.
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::Train(
+    ObservationType value,
+    const size_t label)
+{
+  ++classCounts[label];
+
+  // Find the first bin whose centroid is not less than the value.
+  const ObservationType* begin = centroids.memptr();
+  const size_t position = std::lower_bound(begin, begin + numBins, value) -
+      begin;
+  if (position < numBins && centroids[position] == value)
+  {
+    ++sufficientStatistics(label, position);
+    return;
+  }
+
+  // Add a bin for the value.  There is always room for one more bin than the
+  // maximum.
+  for (size_t i = numBins; i > position; --i)
+  {
+    centroids[i] = centroids[i - 1];
+    sufficientStatistics.col(i) = sufficientStatistics.col(i - 1);
+  }
+  centroids[position] = value;
+  sufficientStatistics.col(position).zeros();
+  sufficientStatistics(label, position) = 1;
+  ++numBins;
+
+  if (numBins <= maxBins)
+    return;
+
+  // There are too many bins, so merge the two with the closest centroids.
+  size_t closest = 0;
+  for (size_t i = 1; i < numBins - 1; ++i)
+  {
+    if (centroids[i + 1] - centroids[i] <
+        centroids[closest + 1] - centroids[closest])
+      closest = i;
+  }
+
+  const double leftCount = arma::accu(sufficientStatistics.col(closest));
+  const double rightCount = arma::accu(sufficientStatistics.col(closest + 1));
+  centroids[closest] = ObservationType((leftCount * centroids[closest] +
+      rightCount * centroids[closest + 1]) / (leftCount + rightCount));
+  sufficientStatistics.col(closest) += sufficientStatistics.col(closest + 1);
+
+  for (size_t i = closest + 1; i < numBins - 1; ++i)
+  {
+    centroids[i] = centroids[i + 1];
+    sufficientStatistics.col(i) = sufficientStatistics.col(i + 1);
+  }
+  --numBins;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+size_t QuantileNumericSplit<FitnessFunction, ObservationType>::BestSplit(
+    double& bestFitness,
+    double& secondBestFitness) const
+{
+  // Start with all the points on the right side, and move one bin at a time
+  // to the left side.
+  arma::Mat<size_t> counts(classCounts.n_elem, 2);
+  counts.col(0).zeros();
+  counts.col(1) = classCounts;
+
+  bestFitness = 0.0;
+  secondBestFitness = 0.0;
+  size_t bestBin = numBins;
+  for (size_t i = 0; i + 1 < numBins; ++i)
+  {
+    counts.col(0) += sufficientStatistics.col(i);
+    counts.col(1) -= sufficientStatistics.col(i);
+
+    const double value = FitnessFunction::Evaluate(counts);
+    if (value > bestFitness)
+    {
+      secondBestFitness = bestFitness;
+      bestFitness = value;
+      bestBin = i;
+    }
+    else if (value > secondBestFitness)
+    {
+      secondBestFitness = value;
+    }
+  }
+
+  return bestBin;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::
+    EvaluateFitnessFunction(double& bestFitness,
+                            double& secondBestFitness) const
+{
+  BestSplit(bestFitness, secondBestFitness);
+
+  // Neighboring candidate splits of the same dimension have almost the same
+  // fitness, so comparing them with the Hoeffding bound would hardly ever
+  // allow a split; like HoeffdingNumericSplit, only the best split is given.
+  secondBestFitness = 0.0;
+}
+
+template<typename FitnessFunction, typename ObservationType>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::Split(
+    arma::Col<size_t>& childMajorities,
+    SplitInfo& splitInfo) const
+{
+  double bestFitness, secondBestFitness;
+  const size_t bestBin = BestSplit(bestFitness, secondBestFitness);
+
+  // Split halfway between the centroids on each side.  If there is no
+  // possible split, everything goes to the right child.
+  arma::Mat<size_t> counts(classCounts.n_elem, 2);
+  counts.col(0).zeros();
+  counts.col(1) = classCounts;
+  ObservationType splitPoint = (numBins > 0) ? centroids[0] :
+      ObservationType(0);
+  if (bestBin < numBins)
+  {
+    splitPoint = (centroids[bestBin] + centroids[bestBin + 1]) / 2;
+    for (size_t i = 0; i <= bestBin; ++i)
+    {
+      counts.col(0) += sufficientStatistics.col(i);
+      counts.col(1) -= sufficientStatistics.col(i);
+    }
+  }
+
+  // Calculate the majority classes of the children.
+  childMajorities.set_size(2);
+  arma::uword maxIndex;
+  counts.unsafe_col(0).max(maxIndex);
+  childMajorities[0] = size_t(maxIndex);
+  counts.unsafe_col(1).max(maxIndex);
+  childMajorities[1] = size_t(maxIndex);
+
+  // Create the according SplitInfo object.
+  splitInfo = SplitInfo(splitPoint);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+size_t QuantileNumericSplit<FitnessFunction, ObservationType>::MajorityClass()
+    const
+{
+  arma::uword maxIndex;
+  classCounts.max(maxIndex);
+  return size_t(maxIndex);
+}
+
+template<typename FitnessFunction, typename ObservationType>
+double QuantileNumericSplit<FitnessFunction, ObservationType>::
+    MajorityProbability() const
+{
+  return double(arma::max(classCounts)) / double(arma::accu(classCounts));
+}
+
+template<typename FitnessFunction, typename ObservationType>
+template<typename Archive>
+void QuantileNumericSplit<FitnessFunction, ObservationType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(maxBins);
+  ar & BOOST_SERIALIZATION_NVP(numBins);
+  ar & BOOST_SERIALIZATION_NVP(centroids);
+  ar & BOOST_SERIALIZATION_NVP(sufficientStatistics);
+  ar & BOOST_SERIALIZATION_NVP(classCounts);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
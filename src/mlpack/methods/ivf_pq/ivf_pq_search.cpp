@@ -0,0 +1,31 @@
+/**
+ * @file ivf_pq_search.cpp
+ *
+ * Implementation of the non-templated methods of the IVFPQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "ivf_pq_search.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+IVFPQSearch::IVFPQSearch(const size_t numLists,
+                         const size_t numSubspaces,
+                         const size_t numCentroids,
+                         const size_t maxIterations) :
+    numLists(numLists),
+    maxIterations(maxIterations),
+    quantizer(numSubspaces, numCentroids, maxIterations)
+{
+  if (numLists == 0)
+  {
+    throw std::invalid_argument("IVFPQSearch::IVFPQSearch(): the number of "
+        "lists must be positive");
+  }
+
+  listOffsets.zeros(numLists + 1);
+}
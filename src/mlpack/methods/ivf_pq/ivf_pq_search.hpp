@@ -0,0 +1,177 @@
+/**
+ * @file ivf_pq_search.hpp
+ *
+ * Defines the IVFPQSearch class, an approximate nearest neighbor index that
+ * stores the reference points compressed with a product quantizer, in
+ * inverted lists of a coarse k-means quantizer.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, H. and Douze, M. and Schmid, C.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011}
+ * }
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_HPP
+#define MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "product_quantizer.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * An inverted file index with product quantization (IVF-PQ).  The reference
+ * points are clustered with KMeans into numLists lists (the coarse
+ * quantizer), and the residual of each point (its difference with the
+ * centroid of its list) is encoded with a ProductQuantizer.  Only the codes
+ * and the indices of the points are kept, so each point takes numSubspaces
+ * bytes plus its index instead of its full vector: with 16 subspaces,
+ * 128-dimensional points of floats take 24 bytes instead of 512.
+ *
+ * A query is compared with the coarse centroids, and only the numProbes
+ * nearest lists are scanned.  For each scanned list, the table of the
+ * distances between the residual of the query and the centroids of the
+ * product quantizer is computed once, so the distance to each point of the
+ * list only takes numSubspaces table lookups.  The distances returned are the
+ * (approximate) Euclidean distances given by these lookups.
+ *
+ * The queries are searched in parallel, and the points are assigned to their
+ * list and encoded in parallel.  To train the quantizers on large reference
+ * sets, train them on a random sample of the points with the trainingPoints
+ * parameter of Train(); all the points are still encoded.  Points of type
+ * float (arma::fmat) can be indexed without converting the whole set.
+ *
+ * @code
+ * IVFPQSearch ivfpq(1024, 16);
+ * ivfpq.Train(referenceSet, 100000);
+ * ivfpq.Search(querySet, 10, neighbors, distances, 16);
+ * @endcode
+ */
+class IVFPQSearch
+{
+ public:
+  /**
+   * Create an untrained index with the given parameters.  Be sure to call
+   * Train() before calling Search(); otherwise, an exception will be thrown
+   * when Search() is called.
+   *
+   * @param numLists Number of inverted lists (centroids of the coarse
+   *     quantizer).
+   * @param numSubspaces Number of subspaces of the product quantizer, that is
+   *     number of bytes of each code.
+   * @param numCentroids Number of centroids in each subspace of the product
+   *     quantizer; this must be between 1 and 256.
+   * @param maxIterations Maximum number of iterations of k-means when training
+   *     the quantizers.
+   */
+  IVFPQSearch(const size_t numLists = 256,
+              const size_t numSubspaces = 8,
+              const size_t numCentroids = 256,
+              const size_t maxIterations = 25);
+
+  /**
+   * Train the coarse quantizer and the product quantizer, and encode the
+   * given reference points.  The reference set itself is not kept.
+   *
+   * @param referenceSet Set of reference points.
+   * @param trainingPoints If positive and less than the number of reference
+   *     points, the quantizers are trained on a random sample of that many
+   *     points.
+   */
+  template<typename MatType>
+  void Train(const MatType& referenceSet, const size_t trainingPoints = 0);
+
+  /**
+   * Compute the approximate nearest neighbors of the points in the given query
+   * set and store the output in the given matrices.  The matrices will be set
+   * to the size of n columns by k rows, where n is the number of points in the
+   * query set and k is the number of neighbors being searched for.  If fewer
+   * than k points are in the scanned lists, the remaining neighbors are set to
+   * the number of reference points and their distances to DBL_MAX.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing the approximate distances of the
+   *     neighbors of each query point.
+   * @param numProbes Number of lists to scan for each query.
+   */
+  template<typename MatType>
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances,
+              const size_t numProbes = 8) const;
+
+  /**
+   * Serialize the index.
+   *
+   * @param ar Archive to serialize to.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+  //! Get the number of inverted lists.
+  size_t NumLists() const { return numLists; }
+  //! Get the number of reference points.
+  size_t NumPoints() const { return indices.n_elem; }
+
+  //! Get the centroids of the coarse quantizer (one per column).
+  const arma::mat& Centroids() const { return centroids; }
+  //! Get the product quantizer the residuals are encoded with.
+  const ProductQuantizer& Quantizer() const { return quantizer; }
+
+  //! Get the codes of the points of all the lists, one after the other (one
+  //! code per column).
+  const arma::Mat<unsigned char>& Codes() const { return codes; }
+  //! Get the index of the point of each code.
+  const arma::Col<size_t>& Indices() const { return indices; }
+  //! Get the offsets of the lists; the points of list i are in
+  //! [ListOffsets()[i], ListOffsets()[i + 1]).
+  const arma::Col<size_t>& ListOffsets() const { return listOffsets; }
+
+ private:
+  //! Return the index of the nearest coarse centroid of the given point.
+  size_t NearestList(const arma::vec& point) const
+  {
+    arma::uword nearest;
+    arma::sum(arma::square(centroids.each_col() - point), 0).eval().min(
+        nearest);
+    return nearest;
+  }
+
+  //! Number of inverted lists.
+  size_t numLists;
+  //! Maximum number of iterations of k-means.
+  size_t maxIterations;
+  //! Centroids of the coarse quantizer.
+  arma::mat centroids;
+  //! Quantizer of the residuals.
+  ProductQuantizer quantizer;
+  //! Codes of the points of all the lists.
+  arma::Mat<unsigned char> codes;
+  //! Index of the point of each code.
+  arma::Col<size_t> indices;
+  //! Offsets of the lists in codes and indices.
+  arma::Col<size_t> listOffsets;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ivf_pq_search_impl.hpp"
+
+#endif
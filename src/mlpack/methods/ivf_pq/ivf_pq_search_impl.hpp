@@ -0,0 +1,217 @@
+/**
+ * @file ivf_pq_search_impl.hpp
+ *
+ * Implementation of the templated methods of the IVFPQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_IVF_PQ_IVF_PQ_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ivf_pq_search.hpp"
+
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <queue>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType>
+void IVFPQSearch::Train(const MatType& referenceSet,
+                        const size_t trainingPoints)
+{
+  if (referenceSet.n_cols < numLists)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Train(): the reference set has "
+        << referenceSet.n_cols << " points, but " << numLists << " lists are "
+        << "needed!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Timer::Start("ivf_pq_training");
+
+  // Train the quantizers on a sample of the points, if requested.
+  arma::mat trainingSet;
+  if (trainingPoints > 0 && trainingPoints < referenceSet.n_cols)
+  {
+    const arma::uvec sample = arma::shuffle(arma::linspace<arma::uvec>(0,
+        referenceSet.n_cols - 1, referenceSet.n_cols));
+    trainingSet = arma::conv_to<arma::mat>::from(referenceSet.cols(
+        sample.head(trainingPoints)));
+  }
+  else
+  {
+    trainingSet = arma::conv_to<arma::mat>::from(referenceSet);
+  }
+
+  // Train the coarse quantizer, and then the product quantizer on the
+  // residuals of the training points.
+  arma::Row<size_t> assignments;
+  kmeans::KMeans<> kmeans(maxIterations);
+  kmeans.Cluster(trainingSet, numLists, assignments, centroids);
+  trainingSet -= centroids.cols(arma::conv_to<arma::uvec>::from(assignments));
+  quantizer.Train(trainingSet);
+  trainingSet.reset();
+
+  Timer::Stop("ivf_pq_training");
+  Timer::Start("ivf_pq_encoding");
+
+  // Assign all the points to their list and encode their residuals, in
+  // parallel.  The residuals are computed in blocks, so that the points are
+  // only converted to double precision one block at a time.
+  const size_t n = referenceSet.n_cols;
+  const size_t blockSize = 65536;
+  arma::Col<size_t> lists(n);
+  arma::Mat<unsigned char> pointCodes(quantizer.NumSubspaces(), n);
+  arma::Mat<unsigned char> blockCodes;
+  for (size_t begin = 0; begin < n; begin += blockSize)
+  {
+    const size_t end = std::min(n, begin + blockSize);
+    arma::mat residuals = arma::conv_to<arma::mat>::from(
+        referenceSet.cols(begin, end - 1));
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) residuals.n_cols; ++i)
+    {
+      lists[begin + i] = NearestList(residuals.unsafe_col(i));
+      residuals.col(i) -= centroids.col(lists[begin + i]);
+    }
+
+    quantizer.Encode(residuals, blockCodes);
+    pointCodes.cols(begin, end - 1) = blockCodes;
+  }
+
+  // Store the points of each list together, in the order of the lists.
+  listOffsets.zeros(numLists + 1);
+  for (size_t i = 0; i < n; ++i)
+    ++listOffsets[lists[i] + 1];
+  for (size_t l = 0; l < numLists; ++l)
+    listOffsets[l + 1] += listOffsets[l];
+
+  arma::Col<size_t> positions = listOffsets.head(numLists);
+  codes.set_size(quantizer.NumSubspaces(), n);
+  indices.set_size(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t position = positions[lists[i]]++;
+    codes.col(position) = pointCodes.col(i);
+    indices[position] = i;
+  }
+
+  Timer::Stop("ivf_pq_encoding");
+
+  Log::Info << "Encoded " << n << " points in " << numLists << " lists with "
+      << quantizer.NumSubspaces() << " bytes per point." << std::endl;
+}
+
+template<typename MatType>
+void IVFPQSearch::Search(const MatType& querySet,
+                         const size_t k,
+                         arma::Mat<size_t>& neighbors,
+                         arma::mat& distances,
+                         const size_t numProbes) const
+{
+  // Ensure the dimensionality of the query set is correct.
+  if (querySet.n_rows != centroids.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Search(): dimensionality of query set ("
+        << querySet.n_rows << ") is not equal to the dimensionality the model "
+        << "was trained on (" << centroids.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (k > NumPoints())
+  {
+    std::ostringstream oss;
+    oss << "IVFPQSearch::Search(): requested " << k << " approximate nearest "
+        << "neighbors, but reference set has " << NumPoints() << " points!"
+        << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // If the user asked for 0 nearest neighbors... uh... we're done.
+  if (k == 0)
+    return;
+
+  const size_t probes = std::max((size_t) 1, std::min(numProbes, numLists));
+
+  Timer::Start("computing_neighbors");
+
+  // Each query writes only its own results.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    const arma::vec query = arma::conv_to<arma::vec>::from(querySet.col(i));
+
+    // Find the lists to scan.
+    const arma::uvec order = arma::sort_index(arma::sum(arma::square(
+        centroids.each_col() - query), 0));
+
+    // The k best candidates, worst first.
+    typedef std::pair<double, size_t> Candidate;
+    std::priority_queue<Candidate> results;
+    arma::mat table;
+    for (size_t p = 0; p < probes; ++p)
+    {
+      const size_t list = order[p];
+      const arma::vec residual = query - centroids.col(list);
+      quantizer.DistanceTable(residual, table);
+
+      for (size_t j = listOffsets[list]; j < listOffsets[list + 1]; ++j)
+      {
+        const double distance = quantizer.AsymmetricDistance(table,
+            codes.colptr(j));
+        if (results.size() < k)
+        {
+          results.push(Candidate(distance, indices[j]));
+        }
+        else if (distance < results.top().first)
+        {
+          results.pop();
+          results.push(Candidate(distance, indices[j]));
+        }
+      }
+    }
+
+    for (size_t j = k; j > results.size(); --j)
+    {
+      neighbors(j - 1, i) = NumPoints();
+      distances(j - 1, i) = DBL_MAX;
+    }
+
+    for (size_t j = results.size(); j > 0; --j)
+    {
+      neighbors(j - 1, i) = results.top().second;
+      distances(j - 1, i) = std::sqrt(std::max(results.top().first, 0.0));
+      results.pop();
+    }
+  }
+
+  Timer::Stop("computing_neighbors");
+}
+
+template<typename Archive>
+void IVFPQSearch::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(numLists);
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(centroids);
+  ar & BOOST_SERIALIZATION_NVP(quantizer);
+  ar & BOOST_SERIALIZATION_NVP(codes);
+  ar & BOOST_SERIALIZATION_NVP(indices);
+  ar & BOOST_SERIALIZATION_NVP(listOffsets);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
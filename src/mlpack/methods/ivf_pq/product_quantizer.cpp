@@ -0,0 +1,59 @@
+/**
+ * @file product_quantizer.cpp
+ *
+ * Implementation of the non-templated methods of the ProductQuantizer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "product_quantizer.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+ProductQuantizer::ProductQuantizer(const size_t numSubspaces,
+                                   const size_t numCentroids,
+                                   const size_t maxIterations) :
+    numSubspaces(numSubspaces),
+    numCentroids(numCentroids),
+    maxIterations(maxIterations),
+    dimensionality(0)
+{
+  if (numSubspaces == 0)
+  {
+    throw std::invalid_argument("ProductQuantizer::ProductQuantizer(): the "
+        "number of subspaces must be positive");
+  }
+
+  if (numCentroids == 0 || numCentroids > 256)
+  {
+    throw std::invalid_argument("ProductQuantizer::ProductQuantizer(): the "
+        "number of centroids must be between 1 and 256");
+  }
+}
+
+void ProductQuantizer::Decode(const arma::Mat<unsigned char>& codes,
+                              arma::mat& data) const
+{
+  if (codes.n_rows != numSubspaces)
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Decode(): the codes have " << codes.n_rows
+        << " subspaces, but the quantizer has " << numSubspaces << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  data.set_size(dimensionality, codes.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) codes.n_cols; ++i)
+  {
+    for (size_t s = 0; s < numSubspaces; ++s)
+    {
+      data.submat(SubspaceBegin(s), i, SubspaceBegin(s + 1) - 1, i) =
+          codebooks[s].col(codes(s, i));
+    }
+  }
+}
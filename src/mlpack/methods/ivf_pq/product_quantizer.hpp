@@ -0,0 +1,191 @@
+/**
+ * @file product_quantizer.hpp
+ *
+ * Defines the ProductQuantizer class, which compresses vectors into short
+ * codes by quantizing subvectors with separate k-means codebooks, and computes
+ * approximate distances to the compressed vectors with table lookups.
+ *
+ * The details of this method can be found in the following paper:
+ *
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, H. and Douze, M. and Schmid, C.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011}
+ * }
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_PRODUCT_QUANTIZER_HPP
+#define MLPACK_METHODS_IVF_PQ_PRODUCT_QUANTIZER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * A product quantizer.  The dimensions are split into numSubspaces contiguous
+ * subspaces, and the subvectors of the training points in each subspace are
+ * clustered with KMeans into numCentroids centroids (the codebook of the
+ * subspace).  A vector is then encoded as the index of the nearest centroid
+ * of each of its subvectors, so with the default 256 centroids each subspace
+ * takes one byte: 128-dimensional vectors of doubles encoded with 16
+ * subspaces take 16 bytes instead of 1024.
+ *
+ * The squared Euclidean distance between a query and an encoded vector is
+ * approximated by the asymmetric distance: the sum over the subspaces of the
+ * squared distance between the subvector of the query and the centroid the
+ * vector was encoded with.  Once the table of the squared distances between
+ * the subvectors of the query and all the centroids is computed with
+ * DistanceTable(), the distance to each encoded vector only takes
+ * numSubspaces table lookups.
+ *
+ * @code
+ * ProductQuantizer pq(16);
+ * pq.Train(dataset);
+ * arma::Mat<unsigned char> codes;
+ * pq.Encode(dataset, codes);
+ *
+ * arma::mat table;
+ * pq.DistanceTable(query, table);
+ * const double d = pq.AsymmetricDistance(table, codes.colptr(i));
+ * @endcode
+ */
+class ProductQuantizer
+{
+ public:
+  /**
+   * Create an untrained product quantizer with the given parameters.
+   *
+   * @param numSubspaces Number of subspaces, that is number of bytes of each
+   *     code.
+   * @param numCentroids Number of centroids in the codebook of each subspace;
+   *     this must be between 1 and 256.
+   * @param maxIterations Maximum number of iterations of k-means when training
+   *     the codebooks.
+   */
+  ProductQuantizer(const size_t numSubspaces = 8,
+                   const size_t numCentroids = 256,
+                   const size_t maxIterations = 25);
+
+  /**
+   * Train the codebooks on the given points.  The dimensionality must be at
+   * least the number of subspaces, and there must be at least numCentroids
+   * points.  Training on a random sample of the points to encode is usually
+   * enough.
+   *
+   * @param data Points to train the codebooks on.
+   */
+  template<typename MatType>
+  void Train(const MatType& data);
+
+  /**
+   * Encode the given points, in parallel.  Column i of codes holds the code of
+   * point i, one byte per subspace.
+   *
+   * @param data Points to encode.
+   * @param codes Filled with the code of each point.
+   */
+  template<typename MatType>
+  void Encode(const MatType& data, arma::Mat<unsigned char>& codes) const;
+
+  /**
+   * Decode the given codes: each point is the concatenation of the centroids
+   * it was encoded with.
+   *
+   * @param codes Codes to decode.
+   * @param data Filled with the decoded points.
+   */
+  void Decode(const arma::Mat<unsigned char>& codes, arma::mat& data) const;
+
+  /**
+   * Compute the table of the squared distances between the subvectors of the
+   * given query and the centroids: table(c, s) holds the squared distance
+   * between the subvector of the query in subspace s and centroid c of that
+   * subspace.
+   *
+   * @param query Query point.
+   * @param table Filled with the distance table.
+   */
+  template<typename VecType>
+  void DistanceTable(const VecType& query, arma::mat& table) const;
+
+  /**
+   * Return the asymmetric distance (an approximation of the squared Euclidean
+   * distance) between the query a distance table was computed for and the
+   * point with the given code.
+   *
+   * @param table Distance table of the query (see DistanceTable()).
+   * @param code Code of the point (numSubspaces bytes).
+   */
+  double AsymmetricDistance(const arma::mat& table,
+                            const unsigned char* code) const
+  {
+    const double* column = table.memptr();
+    double distance = 0.0;
+    for (size_t s = 0; s < numSubspaces; ++s, column += numCentroids)
+      distance += column[code[s]];
+
+    return distance;
+  }
+
+  //! Get the number of subspaces (the number of bytes of each code).
+  size_t NumSubspaces() const { return numSubspaces; }
+  //! Get the number of centroids in the codebook of each subspace.
+  size_t NumCentroids() const { return numCentroids; }
+  //! Get the maximum number of iterations of k-means.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations of k-means.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the dimensionality of the points the quantizer was trained on.
+  size_t Dimensionality() const { return dimensionality; }
+
+  //! Get the first dimension of the given subspace; subspace s holds the
+  //! dimensions [SubspaceBegin(s), SubspaceBegin(s + 1)).
+  size_t SubspaceBegin(const size_t subspace) const
+  {
+    return subspace * dimensionality / numSubspaces;
+  }
+
+  //! Get the codebook of the given subspace (one centroid per column).
+  const arma::mat& Codebook(const size_t subspace) const
+  {
+    return codebooks[subspace];
+  }
+
+  /**
+   * Serialize the product quantizer.
+   *
+   * @param ar Archive to serialize to.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Number of subspaces.
+  size_t numSubspaces;
+  //! Number of centroids in the codebook of each subspace.
+  size_t numCentroids;
+  //! Maximum number of iterations of k-means.
+  size_t maxIterations;
+  //! Dimensionality of the points the quantizer was trained on.
+  size_t dimensionality;
+  //! The codebook of each subspace.
+  std::vector<arma::mat> codebooks;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "product_quantizer_impl.hpp"
+
+#endif
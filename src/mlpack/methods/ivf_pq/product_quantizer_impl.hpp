@@ -0,0 +1,117 @@
+/**
+ * @file product_quantizer_impl.hpp
+ *
+ * Implementation of the templated methods of the ProductQuantizer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_IVF_PQ_PRODUCT_QUANTIZER_IMPL_HPP
+#define MLPACK_METHODS_IVF_PQ_PRODUCT_QUANTIZER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "product_quantizer.hpp"
+
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename MatType>
+void ProductQuantizer::Train(const MatType& data)
+{
+  if (data.n_rows < numSubspaces)
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Train(): dimensionality of the data ("
+        << data.n_rows << ") is less than the number of subspaces ("
+        << numSubspaces << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (data.n_cols < numCentroids)
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Train(): the data has " << data.n_cols
+        << " points, but " << numCentroids << " centroids are needed in each "
+        << "subspace!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  dimensionality = data.n_rows;
+  codebooks.resize(numSubspaces);
+
+  kmeans::KMeans<> kmeans(maxIterations);
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    const arma::mat subvectors = arma::conv_to<arma::mat>::from(
+        data.rows(SubspaceBegin(s), SubspaceBegin(s + 1) - 1));
+    kmeans.Cluster(subvectors, numCentroids, codebooks[s]);
+  }
+}
+
+template<typename MatType>
+void ProductQuantizer::Encode(const MatType& data,
+                              arma::Mat<unsigned char>& codes) const
+{
+  if (data.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "ProductQuantizer::Encode(): dimensionality of the data ("
+        << data.n_rows << ") is not equal to the dimensionality the quantizer "
+        << "was trained on (" << dimensionality << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  codes.set_size(numSubspaces, data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    const arma::vec point = arma::conv_to<arma::vec>::from(data.col(i));
+    for (size_t s = 0; s < numSubspaces; ++s)
+    {
+      // Find the nearest centroid of the subvector.
+      const arma::vec subvector = point.subvec(SubspaceBegin(s),
+          SubspaceBegin(s + 1) - 1);
+      const arma::rowvec distances = arma::sum(arma::square(
+          codebooks[s].each_col() - subvector), 0);
+      arma::uword nearest;
+      distances.min(nearest);
+      codes(s, i) = (unsigned char) nearest;
+    }
+  }
+}
+
+template<typename VecType>
+void ProductQuantizer::DistanceTable(const VecType& query,
+                                     arma::mat& table) const
+{
+  const arma::vec point = arma::conv_to<arma::vec>::from(query);
+
+  table.set_size(numCentroids, numSubspaces);
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    const arma::vec subvector = point.subvec(SubspaceBegin(s),
+        SubspaceBegin(s + 1) - 1);
+    table.col(s) = arma::sum(arma::square(codebooks[s].each_col() - subvector),
+        0).t();
+  }
+}
+
+template<typename Archive>
+void ProductQuantizer::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(numSubspaces);
+  ar & BOOST_SERIALIZATION_NVP(numCentroids);
+  ar & BOOST_SERIALIZATION_NVP(maxIterations);
+  ar & BOOST_SERIALIZATION_NVP(dimensionality);
+  ar & BOOST_SERIALIZATION_NVP(codebooks);
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,128 @@
+/**
+ * @file gaussian_series_expansion.cpp
+ *
+ * Implementation of the series expansion of sums of Gaussian kernels.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "gaussian_series_expansion.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kde;
+
+GaussianSeriesExpansion::GaussianSeriesExpansion(const size_t dimensionality,
+                                                 const size_t maxOrder,
+                                                 const double bandwidth) :
+    dimensionality(dimensionality),
+    maxOrder(maxOrder),
+    bandwidth(bandwidth),
+    scale(std::sqrt(2.0) * bandwidth)
+{
+  const size_t numTerms = NumTerms(dimensionality, maxOrder);
+  parent.resize(numTerms, 0);
+  dimension.resize(numTerms, 0);
+  constants.set_size(numTerms);
+  if (numTerms == 0)
+    return;
+
+  // The monomials of each degree are the products of the monomials of the
+  // previous degree with each coordinate; starting the products with
+  // coordinate i at the first monomial that was made with coordinate i avoids
+  // duplicates.
+  arma::Mat<size_t> exponents(dimensionality, numTerms, arma::fill::zeros);
+  std::vector<size_t> heads(dimensionality, 0);
+  constants[0] = 1.0;
+  size_t t = 1;
+  for (size_t k = 1; k < maxOrder; ++k)
+  {
+    const size_t tail = t;
+    for (size_t i = 0; i < dimensionality; ++i)
+    {
+      const size_t head = heads[i];
+      heads[i] = t;
+      for (size_t j = head; j < tail; ++j, ++t)
+      {
+        parent[t] = j;
+        dimension[t] = i;
+        exponents.col(t) = exponents.col(j);
+        exponents(i, t)++;
+        constants[t] = constants[j] * 2.0 / exponents(i, t);
+      }
+    }
+  }
+}
+
+size_t GaussianSeriesExpansion::NumTerms(const size_t dimensionality,
+                                         const size_t order)
+{
+  if (order == 0)
+    return 0;
+
+  // The binomial coefficient (order - 1 + dimensionality, dimensionality).
+  size_t numTerms = 1;
+  for (size_t i = 1; i <= dimensionality; ++i)
+    numTerms = numTerms * (order - 1 + i) / i;
+
+  return numTerms;
+}
+
+void GaussianSeriesExpansion::Accumulate(const arma::vec& point,
+                                         const arma::vec& center,
+                                         const size_t order,
+                                         arma::vec& coefficients) const
+{
+  scaled = (point - center) / scale;
+  const double weight = std::exp(-arma::dot(scaled, scaled));
+  Monomials(scaled, order);
+
+  for (size_t t = 0; t < monomials.n_elem; ++t)
+    coefficients[t] += weight * constants[t] * monomials[t];
+}
+
+double GaussianSeriesExpansion::Evaluate(const arma::vec& query,
+                                         const arma::vec& center,
+                                         const arma::vec& coefficients,
+                                         const size_t order) const
+{
+  scaled = (query - center) / scale;
+  Monomials(scaled, order);
+
+  double sum = 0.0;
+  for (size_t t = 0; t < monomials.n_elem; ++t)
+    sum += coefficients[t] * monomials[t];
+
+  return std::exp(-arma::dot(scaled, scaled)) * sum;
+}
+
+double GaussianSeriesExpansion::ErrorBound(const size_t numPoints,
+                                           const double referenceRadius,
+                                           const double minQueryDistance,
+                                           const double maxQueryDistance,
+                                           const size_t order) const
+{
+  const double a = referenceRadius / scale;
+  const double b = maxQueryDistance / scale;
+  if (a * b == 0.0)
+    return (order == 0) ? (double) numPoints : 0.0;
+
+  // (2 ||u|| ||v||)^p / p! is largest for the largest norms, and
+  // exp(-(||u|| - ||v||)^2) for the closest norms.
+  const double gap = std::max(0.0, minQueryDistance / scale - a);
+  return numPoints * std::exp(order * std::log(2.0 * a * b) -
+      std::lgamma(order + 1.0) - gap * gap);
+}
+
+void GaussianSeriesExpansion::Monomials(const arma::vec& x,
+                                        const size_t order) const
+{
+  monomials.set_size(NumTerms(dimensionality, order));
+  if (monomials.n_elem == 0)
+    return;
+
+  monomials[0] = 1.0;
+  for (size_t t = 1; t < monomials.n_elem; ++t)
+    monomials[t] = monomials[parent[t]] * x[dimension[t]];
+}
@@ -0,0 +1,174 @@
+/**
+ * @file gaussian_series_expansion.hpp
+ *
+ * Series expansion of sums of Gaussian kernels, as used by the improved fast
+ * Gauss transform.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_GAUSSIAN_SERIES_EXPANSION_HPP
+#define MLPACK_METHODS_KDE_GAUSSIAN_SERIES_EXPANSION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kde {
+
+/**
+ * The GaussianSeriesExpansion holds the constants of the multivariate Taylor
+ * expansion of the sum of Gaussian kernels exp(-||q - r||^2 / (2 sigma^2))
+ * over a set of reference points r, about a center c, that is used by the
+ * improved fast Gauss transform:
+ *
+ * @code
+ * @inproceedings{yang2003improved,
+ *   title={Improved fast Gauss transform and efficient kernel density
+ *       estimation},
+ *   author={Yang, C. and Duraiswami, R. and Gumerov, N.A. and Davis, L.},
+ *   booktitle={Proceedings of the Ninth IEEE International Conference on
+ *       Computer Vision (ICCV 2003)},
+ *   pages={664--671},
+ *   year={2003}
+ * }
+ * @endcode
+ *
+ * With h = sqrt(2) sigma, u = (r - c) / h and v = (q - c) / h, each kernel is
+ * exp(-||u||^2) exp(-||v||^2) exp(2 u^T v), and the last factor is expanded in
+ * the monomials of total degree less than the order p of the expansion:
+ *
+ *   sum_r K(q, r) ~= exp(-||v||^2) sum_{|a| < p} C_a v^a,
+ *   C_a = 2^|a| / a! sum_r exp(-||u||^2) u^a.
+ *
+ * The coefficients C_a only depend on the reference points, so they are
+ * computed once per reference node, and the expansion is then evaluated at
+ * each query point with NumTerms(p) operations instead of one kernel
+ * evaluation per reference point.  That pays off in low dimension, where the
+ * number of terms is small.
+ *
+ * The monomials are in graded order, so that the first NumTerms(p)
+ * coefficients of an expansion of order P > p are the coefficients of the
+ * expansion of order p.
+ *
+ * Accumulate() and Evaluate() use working storage of the object, so each
+ * thread must use its own copy.
+ */
+class GaussianSeriesExpansion
+{
+ public:
+  /**
+   * Create the expansion constants for points of the given dimensionality, up
+   * to the given order.
+   *
+   * @param dimensionality Dimensionality of the points.
+   * @param maxOrder Maximum order of the expansions.
+   * @param bandwidth Bandwidth sigma of the Gaussian kernel.
+   */
+  GaussianSeriesExpansion(const size_t dimensionality = 0,
+                          const size_t maxOrder = 0,
+                          const double bandwidth = 1.0);
+
+  /**
+   * Get the number of terms of an expansion of the given order, which is the
+   * number of monomials of total degree less than the order in the given
+   * dimensionality.
+   */
+  static size_t NumTerms(const size_t dimensionality, const size_t order);
+
+  /**
+   * Add the contribution of the given reference point to the coefficients of
+   * an expansion of the given order about the given center.  The coefficients
+   * must have NumTerms(order) elements.
+   *
+   * @param point Reference point to add.
+   * @param center Center of the expansion.
+   * @param order Order of the expansion (at most MaxOrder()).
+   * @param coefficients Coefficients to add to.
+   */
+  void Accumulate(const arma::vec& point,
+                  const arma::vec& center,
+                  const size_t order,
+                  arma::vec& coefficients) const;
+
+  /**
+   * Evaluate the expansion of the given order with the given coefficients at
+   * the given query point.  The coefficients may be those of an expansion of
+   * a higher order.
+   *
+   * @param query Query point.
+   * @param center Center of the expansion.
+   * @param coefficients Coefficients of the expansion.
+   * @param order Order of the expansion to evaluate.
+   */
+  double Evaluate(const arma::vec& query,
+                  const arma::vec& center,
+                  const arma::vec& coefficients,
+                  const size_t order) const;
+
+  /**
+   * Get an upper bound of the error of the expansion of the given order, when
+   * it is evaluated at a query point at between minQueryDistance and
+   * maxQueryDistance from the center, for numPoints reference points within
+   * referenceRadius of the center.  The Taylor remainder of exp(2 u^T v) after
+   * the terms of degree less than p is at most (2 ||u|| ||v||)^p / p! exp(2
+   * ||u|| ||v||), so the error of each kernel is at most (2 ||u|| ||v||)^p /
+   * p! exp(-(||u|| - ||v||)^2).
+   *
+   * @param numPoints Number of reference points.
+   * @param referenceRadius Maximum distance of the reference points to the
+   *     center.
+   * @param minQueryDistance Minimum distance of the query points to the
+   *     center.
+   * @param maxQueryDistance Maximum distance of the query points to the
+   *     center.
+   * @param order Order of the expansion.
+   */
+  double ErrorBound(const size_t numPoints,
+                    const double referenceRadius,
+                    const double minQueryDistance,
+                    const double maxQueryDistance,
+                    const size_t order) const;
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get the maximum order of the expansions.
+  size_t MaxOrder() const { return maxOrder; }
+  //! Get the bandwidth of the Gaussian kernel.
+  double Bandwidth() const { return bandwidth; }
+
+ private:
+  /**
+   * Compute the monomials of the given scaled point, in graded order, up to
+   * the given order.
+   */
+  void Monomials(const arma::vec& x, const size_t order) const;
+
+  //! Dimensionality of the points.
+  size_t dimensionality;
+  //! Maximum order of the expansions.
+  size_t maxOrder;
+  //! Bandwidth of the Gaussian kernel.
+  double bandwidth;
+  //! Scale h = sqrt(2) * bandwidth of the expansion.
+  double scale;
+
+  //! Each monomial but the first is the product of the monomial parent[i] and
+  //! the coordinate dimension[i].
+  std::vector<size_t> parent;
+  //! The coordinate of each monomial; see parent.
+  std::vector<size_t> dimension;
+  //! The constant 2^|a| / a! of each monomial.
+  arma::vec constants;
+
+  //! Storage for the monomials of a point.
+  mutable arma::vec monomials;
+  //! Storage for a scaled point.
+  mutable arma::vec scaled;
+};
+
+} // namespace kde
+} // namespace mlpack
+
+#endif
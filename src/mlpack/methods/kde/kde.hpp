@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 
 #include "kde_stat.hpp"
+#include "gaussian_series_expansion.hpp"
 
 namespace mlpack {
 namespace kde /** Kernel Density Estimation. */ {
@@ -35,6 +36,35 @@ enum KDEMode
  * This implementation performs this estimation using a tree-independent
  * dual-tree algorithm. Details about this algorithm are available in KDERules.
  *
+ * When multiple threads are available, the query points are split among them:
+ * single-tree evaluation splits the query set into blocks of points, and
+ * dual-tree evaluation splits binary query trees that rearrange the dataset
+ * into disjoint subtrees.  Each block or subtree is evaluated with its own
+ * KDERules, and since the error tolerance is split evenly among the reference
+ * points, the error guarantees are the same as in a serial evaluation.
+ *
+ * In Monte Carlo mode, node combinations that can't be pruned within the error
+ * tolerance are estimated by sampling points of the reference node instead,
+ * which is much faster in high dimension, where deterministic pruning rarely
+ * happens.  The estimation of each query point is then within the relative
+ * error tolerance with probability (at least) MCProb(); see KDERules.
+ *
+ * In series expansion mode, which needs the Gaussian kernel and the Euclidean
+ * distance, each reference node with enough points holds the coefficients of
+ * a Taylor expansion of the sum of the kernels of its points (the improved
+ * fast Gauss transform; see GaussianSeriesExpansion), of order at most
+ * MaxSeriesOrder().  Node combinations that can't be pruned are estimated by
+ * evaluating the expansion at the query points when its error bound is within
+ * the error tolerance given by RelativeError() and AbsoluteError(), so the
+ * error guarantees are unchanged.  This pays off in low dimension (d <= 5 or
+ * so), where the expansions have few terms; the coefficients are computed
+ * before the first evaluation with a given bandwidth and order.
+ *
+ * Reference points can be added to a trained model with AddReferencePoints().
+ * The added points are held in additional reference trees, which are merged
+ * and rebuilt with the logarithmic method, so that each point is part of
+ * O(log n) tree builds and there are O(log n) reference trees to evaluate.
+ *
  * @tparam KernelType Kernel function to use for KDE calculations.
  * @tparam MetricType Metric to use for KDE calculations.
  * @tparam MatType Type of data to use.
@@ -70,12 +100,34 @@ class KDE
    * @param kernel Instantiated kernel object.
    * @param mode Mode for the algorithm.
    * @param metric Instantiated metric object.
+   * @param monteCarlo Whether to estimate node combinations that can't be
+   *                   pruned by sampling.
+   * @param mcProb Probability that the Monte Carlo estimation of each query
+   *               point is within the relative error tolerance (in [0, 1)).
+   * @param initialSampleSize Number of points first sampled from a reference
+   *                          node in Monte Carlo mode.
+   * @param mcEntryCoef Only reference nodes with at least mcEntryCoef *
+   *                    initialSampleSize points are sampled (at least 1).
+   * @param mcBreakCoef Sampling of a reference node is given up once more
+   *                    than mcBreakCoef times its number of points would be
+   *                    needed (in (0, 1]).
+   * @param seriesExpansion Whether to estimate node combinations that can't
+   *                        be pruned by series expansion (Gaussian kernel
+   *                        only).
+   * @param maxSeriesOrder Maximum order of the series expansions.
    */
   KDE(const double relError = 0.05,
       const double absError = 0,
       KernelType kernel = KernelType(),
       const KDEMode mode = DUAL_TREE_MODE,
-      MetricType metric = MetricType());
+      MetricType metric = MetricType(),
+      const bool monteCarlo = false,
+      const double mcProb = 0.95,
+      const size_t initialSampleSize = 100,
+      const double mcEntryCoef = 3,
+      const double mcBreakCoef = 0.4,
+      const bool seriesExpansion = false,
+      const size_t maxSeriesOrder = 8);
 
   /**
    * Construct KDE object as a copy of the given model. This may be
@@ -175,6 +227,30 @@ class KDE
    */
   void Evaluate(arma::vec& estimations);
 
+  /**
+   * Add the given points to the reference set of a trained model, without
+   * building a tree on the whole reference set again.  The new points are
+   * given the reference indices following the current ones, so that the
+   * estimations of the monochromatic Evaluate() are in the order of the
+   * original reference set followed by the added points.
+   *
+   * - The tree returned by ReferenceTree() only holds the added points once
+   *   it has been rebuilt, which happens when it is outgrown by the added
+   *   points or when the model is saved.
+   *
+   * - Use std::move if the new points are no longer needed.
+   *
+   * @pre The model has to be previously trained.
+   * @param newPoints Set of reference points to add.
+   */
+  void AddReferencePoints(MatType newPoints);
+
+  //! Get the number of reference points, including the added ones.
+  size_t NumReferencePoints() const;
+
+  //! Get the number of reference trees, including the trees of added points.
+  size_t NumReferenceTrees() const { return 1 + addedTrees.size(); }
+
   //! Get the kernel.
   const KernelType& Kernel() const { return kernel; }
 
@@ -214,9 +290,60 @@ class KDE
   //! Modify the mode of KDE.
   KDEMode& Mode() { return mode; }
 
+  //! Get whether Monte Carlo estimation is used.
+  bool MonteCarlo() const { return monteCarlo; }
+
+  //! Modify whether Monte Carlo estimation is used.
+  bool& MonteCarlo() { return monteCarlo; }
+
+  //! Get the probability of the Monte Carlo estimations.
+  double MCProb() const { return mcProb; }
+
+  //! Modify the probability of the Monte Carlo estimations (0 <= newProb < 1).
+  void MCProb(const double newProb);
+
+  //! Get the initial number of samples of Monte Carlo estimations.
+  size_t MCInitialSampleSize() const { return initialSampleSize; }
+
+  //! Modify the initial number of samples of Monte Carlo estimations.
+  size_t& MCInitialSampleSize() { return initialSampleSize; }
+
+  //! Get the Monte Carlo entry coefficient.
+  double MCEntryCoefficient() const { return mcEntryCoef; }
+
+  //! Modify the Monte Carlo entry coefficient (1 <= newCoef).
+  void MCEntryCoefficient(const double newCoef);
+
+  //! Get the Monte Carlo break coefficient.
+  double MCBreakCoefficient() const { return mcBreakCoef; }
+
+  //! Modify the Monte Carlo break coefficient (0 < newCoef <= 1).
+  void MCBreakCoefficient(const double newCoef);
+
+  //! Get whether series expansion is used.
+  bool SeriesExpansion() const { return seriesExpansion; }
+
+  //! Modify whether series expansion is used.
+  bool& SeriesExpansion() { return seriesExpansion; }
+
+  //! Get the maximum order of the series expansions.
+  size_t MaxSeriesOrder() const { return maxSeriesOrder; }
+
+  //! Modify the maximum order of the series expansions.
+  size_t& MaxSeriesOrder() { return maxSeriesOrder; }
+
+  //! Get the number of query points that traverse the reference tree together
+  //! in single-tree mode (0 or 1 means one at a time).
+  size_t QueryBlockSize() const { return queryBlockSize; }
+
+  //! Modify the number of query points that traverse the reference tree
+  //! together in single-tree mode (0 or 1 means one at a time).  Blocks are
+  //! only used with binary space trees; see tree::BlockSingleTreeTraversal().
+  size_t& QueryBlockSize() { return queryBlockSize; }
+
   //! Serialize the model.
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
   //! Kernel.
@@ -246,9 +373,114 @@ class KDE
   //! Mode of the KDE algorithm.
   KDEMode mode;
 
+  //! If true, node combinations that can't be pruned are estimated by
+  //! sampling.
+  bool monteCarlo;
+
+  //! Probability of the Monte Carlo estimations.
+  double mcProb;
+
+  //! Initial number of samples of Monte Carlo estimations.
+  size_t initialSampleSize;
+
+  //! Monte Carlo entry coefficient.
+  double mcEntryCoef;
+
+  //! Monte Carlo break coefficient.
+  double mcBreakCoef;
+
+  //! If true, node combinations that can't be pruned are estimated by series
+  //! expansion.
+  bool seriesExpansion;
+
+  //! Maximum order of the series expansions.
+  size_t maxSeriesOrder;
+
+  //! Number of query points that traverse the reference tree together in
+  //! single-tree mode.
+  size_t queryBlockSize;
+
+  //! Constants of the series expansions of the current evaluation.
+  GaussianSeriesExpansion expansion;
+
+  //! A tree on reference points that were added after training.
+  struct AddedTree
+  {
+    //! The tree, owned by the KDE object.
+    Tree* tree;
+    //! The reference index of each point of the tree's dataset.
+    std::vector<size_t> indices;
+  };
+
+  //! Trees on the added reference points, from the largest to the smallest.
+  std::vector<AddedTree> addedTrees;
+
+  /**
+   * Add the unnormalized estimations of the query points of the given query
+   * tree, taken over the points of the given reference tree, to the given
+   * densities (indexed like the query tree's dataset).
+   */
+  void DualTreeEvaluate(Tree& queryTree,
+                        Tree& refTree,
+                        const bool sameSet,
+                        arma::vec& densities,
+                        size_t& scores,
+                        size_t& baseCases,
+                        size_t& monteCarloPrunes,
+                        size_t& seriesExpansionPrunes);
+
+  /**
+   * Add the unnormalized estimations of the given query points, taken over the
+   * points of the given reference tree, to the given densities.
+   */
+  void SingleTreeEvaluate(const MatType& querySet,
+                          Tree& refTree,
+                          const bool sameSet,
+                          arma::vec& densities,
+                          size_t& scores,
+                          size_t& baseCases,
+                          size_t& monteCarloPrunes,
+                          size_t& seriesExpansionPrunes);
+
+  /**
+   * If series expansion is enabled, set the expansion constants for the
+   * current kernel and compute the series expansions of the nodes of all the
+   * reference trees that don't have an up to date one.
+   */
+  void PrepareSeriesExpansions();
+
+  //! Compute the series expansions of the nodes of the given reference tree
+  //! that don't have an up to date one.
+  void ComputeSeriesExpansions(Tree& refTree);
+
+  //! Get the reference tree with the given index (0 is the main tree).
+  Tree& GetReferenceTree(const size_t t);
+
+  //! Get the reference index of the given point of the given reference tree.
+  size_t ReferenceIndex(const size_t t, const size_t point) const;
+
+  /**
+   * Rebuild the main reference tree on all the reference points and the given
+   * extra points, in the order of their reference indices, and delete the
+   * trees of added points.
+   *
+   * @param extraPoints Points that are not held by any reference tree yet.
+   * @param extraIndices Reference index of each of the extra points.
+   */
+  void MergeReferenceTrees(const MatType& extraPoints,
+                           const std::vector<size_t>& extraIndices);
+
+  //! Delete the trees of added points.
+  void ClearAddedTrees();
+
   //! Check whether absolute and relative error values are compatible.
   static void CheckErrorValues(const double relError, const double absError);
 
+  //! Check whether the Monte Carlo parameters are valid.
+  static void CheckMonteCarloValues(const double mcProb,
+                                    const double mcEntryCoef,
+                                    const double mcBreakCoef);
+
   //! Rearrange estimations vector if required.
   static void RearrangeEstimations(const std::vector<size_t>& oldFromNew,
                                    arma::vec& estimations);
@@ -257,6 +489,32 @@ class KDE
 } // namespace kde
 } // namespace mlpack
 
+//! Set the serialization version of the KDE class.  Version 1 stores the Monte
+//! Carlo parameters, and version 2 the series expansion parameters.
+//! BOOST_TEMPLATE_CLASS_VERSION() cannot be used here, because the template
+//! signature contains commas.
+namespace boost {
+namespace serialization {
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+struct version<mlpack::kde::KDE<KernelType, MetricType, MatType, TreeType,
+    DualTreeTraversalType, SingleTreeTraversalType>>
+{
+  typedef mpl::int_<2> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "kde_impl.hpp"
 
@@ -13,6 +13,11 @@
 #include "kde.hpp"
 #include "kde_rules.hpp"
 
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/tree/block_single_tree_traversal.hpp>
+#include <mlpack/core/tree/query_subtrees.hpp>
+#include <mlpack/core/tree/tree_cache.hpp>
+
 namespace mlpack {
 namespace kde {
 
@@ -24,7 +29,8 @@ TreeType* BuildTree(
     const typename std::enable_if<
         tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
 {
-  return new TreeType(std::forward<MatType>(dataset), oldFromNew);
+  return tree::TreeCache::BuildTree<TreeType>(std::forward<MatType>(dataset),
+      oldFromNew);
 }
 
 //! Construct tree that doesn't rearrange the dataset.
@@ -38,6 +44,30 @@ TreeType* BuildTree(
   return new TreeType(std::forward<MatType>(dataset));
 }
 
+//! Get the bandwidth of the Gaussian kernel for the series expansions.
+template<typename KernelType, typename MetricType>
+double SeriesExpansionBandwidth(
+    const KernelType& kernel,
+    const typename std::enable_if<
+        std::is_same<KernelType, kernel::GaussianKernel>::value &&
+        std::is_same<MetricType, metric::EuclideanDistance>::value>::type* = 0)
+{
+  return kernel.Bandwidth();
+}
+
+//! Series expansions are only available for the Gaussian kernel and the
+//! Euclidean distance.
+template<typename KernelType, typename MetricType>
+double SeriesExpansionBandwidth(
+    const KernelType& /* kernel */,
+    const typename std::enable_if<
+        !std::is_same<KernelType, kernel::GaussianKernel>::value ||
+        !std::is_same<MetricType, metric::EuclideanDistance>::value>::type* = 0)
+{
+  throw std::invalid_argument("cannot evaluate KDE model: series expansion "
+      "is only available with the Gaussian kernel and the Euclidean distance");
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -56,7 +86,14 @@ KDE(const double relError,
     const double absError,
     KernelType kernel,
     const KDEMode mode,
-    MetricType metric) :
+    MetricType metric,
+    const bool monteCarlo,
+    const double mcProb,
+    const size_t initialSampleSize,
+    const double mcEntryCoef,
+    const double mcBreakCoef,
+    const bool seriesExpansion,
+    const size_t maxSeriesOrder) :
     kernel(kernel),
     metric(metric),
     referenceTree(nullptr),
@@ -65,9 +102,18 @@ KDE(const double relError,
     absError(absError),
     ownsReferenceTree(false),
     trained(false),
-    mode(mode)
+    mode(mode),
+    monteCarlo(monteCarlo),
+    mcProb(mcProb),
+    initialSampleSize(initialSampleSize),
+    mcEntryCoef(mcEntryCoef),
+    mcBreakCoef(mcBreakCoef),
+    seriesExpansion(seriesExpansion),
+    maxSeriesOrder(maxSeriesOrder),
+    queryBlockSize(0)
 {
   CheckErrorValues(relError, absError);
+  CheckMonteCarloValues(mcProb, mcEntryCoef, mcBreakCoef);
 }
 
 template<typename KernelType,
@@ -91,7 +137,15 @@ KDE(const KDE& other) :
     absError(other.absError),
     ownsReferenceTree(other.ownsReferenceTree),
     trained(other.trained),
-    mode(other.mode)
+    mode(other.mode),
+    monteCarlo(other.monteCarlo),
+    mcProb(other.mcProb),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    seriesExpansion(other.seriesExpansion),
+    maxSeriesOrder(other.maxSeriesOrder),
+    queryBlockSize(other.queryBlockSize)
 {
   if (trained)
   {
@@ -106,6 +160,15 @@ KDE(const KDE& other) :
       oldFromNewReferences = other.oldFromNewReferences;
       referenceTree = other.referenceTree;
     }
+
+    // The trees of added points are always owned.
+    for (size_t i = 0; i < other.addedTrees.size(); ++i)
+    {
+      AddedTree added;
+      added.tree = new Tree(*other.addedTrees[i].tree);
+      added.indices = other.addedTrees[i].indices;
+      addedTrees.push_back(std::move(added));
+    }
   }
 }
 
@@ -132,7 +195,16 @@ KDE(KDE&& other) :
     absError(other.absError),
     ownsReferenceTree(other.ownsReferenceTree),
     trained(other.trained),
-    mode(other.mode)
+    mode(other.mode),
+    monteCarlo(other.monteCarlo),
+    mcProb(other.mcProb),
+    initialSampleSize(other.initialSampleSize),
+    mcEntryCoef(other.mcEntryCoef),
+    mcBreakCoef(other.mcBreakCoef),
+    seriesExpansion(other.seriesExpansion),
+    maxSeriesOrder(other.maxSeriesOrder),
+    queryBlockSize(other.queryBlockSize),
+    addedTrees(std::move(other.addedTrees))
 {
   other.kernel = std::move(KernelType());
   other.metric = std::move(MetricType());
@@ -140,6 +212,7 @@ KDE(KDE&& other) :
   other.oldFromNewReferences = nullptr;
   other.ownsReferenceTree = false;
   other.trained = false;
+  other.addedTrees.clear();
 }
 
 template<typename KernelType,
@@ -170,6 +243,7 @@ operator=(KDE other)
     delete referenceTree;
     delete oldFromNewReferences;
   }
+  ClearAddedTrees();
 
   // Move the other object.
   this->kernel = std::move(other.kernel);
@@ -181,6 +255,16 @@ operator=(KDE other)
   this->ownsReferenceTree = other.ownsReferenceTree;
   this->trained = other.trained;
   this->mode = other.mode;
+  this->monteCarlo = other.monteCarlo;
+  this->mcProb = other.mcProb;
+  this->initialSampleSize = other.initialSampleSize;
+  this->mcEntryCoef = other.mcEntryCoef;
+  this->mcBreakCoef = other.mcBreakCoef;
+  this->seriesExpansion = other.seriesExpansion;
+  this->maxSeriesOrder = other.maxSeriesOrder;
+  this->queryBlockSize = other.queryBlockSize;
+  this->addedTrees = std::move(other.addedTrees);
+  other.addedTrees.clear();
 
   return *this;
 }
@@ -206,6 +290,7 @@ KDE<KernelType,
     delete referenceTree;
     delete oldFromNewReferences;
   }
+  ClearAddedTrees();
 }
 
 template<typename KernelType,
@@ -236,6 +321,7 @@ Train(MatType referenceSet)
     delete referenceTree;
     delete oldFromNewReferences;
   }
+  ClearAddedTrees();
 
   this->ownsReferenceTree = true;
   Timer::Start("building_reference_tree");
@@ -274,6 +360,7 @@ Train(Tree* referenceTree, std::vector<size_t>* oldFromNewReferences)
     delete this->referenceTree;
     delete this->oldFromNewReferences;
   }
+  ClearAddedTrees();
 
   this->ownsReferenceTree = false;
   this->referenceTree = referenceTree;
@@ -335,33 +422,36 @@ Evaluate(MatType querySet, arma::vec& estimations)
                                   "referenceSet dimensions don't match");
     }
 
+    PrepareSeriesExpansions();
+
     Timer::Start("computing_kde");
 
     // Evaluate.
-    typedef KDERules<MetricType, KernelType, Tree> RuleType;
-    RuleType rules = RuleType(referenceTree->Dataset(),
-                              querySet,
-                              estimations,
-                              relError,
-                              absError,
-                              metric,
-                              kernel,
-                              false);
-
-    // Create traverser.
-    SingleTreeTraversalType<RuleType> traverser(rules);
-
-    // Traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    estimations /= referenceTree->Dataset().n_cols;
+    size_t scores = 0;
+    size_t baseCases = 0;
+    size_t monteCarloPrunes = 0;
+    size_t seriesExpansionPrunes = 0;
+    for (size_t t = 0; t < NumReferenceTrees(); ++t)
+    {
+      SingleTreeEvaluate(querySet, GetReferenceTree(t), false, estimations,
+          scores, baseCases, monteCarloPrunes, seriesExpansionPrunes);
+    }
+
+    estimations /= NumReferencePoints();
     Timer::Stop("computing_kde");
 
-    Log::Info << rules.Scores() << " node combinations were scored."
-              << std::endl;
-    Log::Info << rules.BaseCases() << " base cases were calculated."
-              << std::endl;
+    Log::Info << scores << " node combinations were scored." << std::endl;
+    Log::Info << baseCases << " base cases were calculated." << std::endl;
+    if (monteCarlo)
+    {
+      Log::Info << monteCarloPrunes << " node combinations were estimated by "
+          << "sampling." << std::endl;
+    }
+    if (seriesExpansion)
+    {
+      Log::Info << seriesExpansionPrunes << " node combinations were "
+          << "estimated by series expansion." << std::endl;
+    }
   }
 }
 
@@ -418,30 +508,39 @@ Evaluate(Tree* queryTree,
                                 "dual-tree");
   }
 
+  PrepareSeriesExpansions();
+
   Timer::Start("computing_kde");
 
   // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            queryTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            metric,
-                            kernel,
-                            false);
-
-  // Create traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
-  estimations /= referenceTree->Dataset().n_cols;
+  size_t scores = 0;
+  size_t baseCases = 0;
+  size_t monteCarloPrunes = 0;
+  size_t seriesExpansionPrunes = 0;
+  for (size_t t = 0; t < NumReferenceTrees(); ++t)
+  {
+    DualTreeEvaluate(*queryTree, GetReferenceTree(t), false, estimations,
+        scores, baseCases, monteCarloPrunes, seriesExpansionPrunes);
+  }
+
+  estimations /= NumReferencePoints();
   Timer::Stop("computing_kde");
 
   // Rearrange if necessary.
   RearrangeEstimations(oldFromNewQueries, estimations);
 
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+  if (monteCarlo)
+  {
+    Log::Info << monteCarloPrunes << " node combinations were estimated by "
+        << "sampling." << std::endl;
+  }
+  if (seriesExpansion)
+  {
+    Log::Info << seriesExpansionPrunes << " node combinations were estimated "
+        << "by series expansion." << std::endl;
+  }
 }
 
 template<typename KernelType,
@@ -468,43 +567,167 @@ Evaluate(arma::vec& estimations)
   }
 
   // Get estimations vector ready.
+  const size_t numReferences = NumReferencePoints();
   estimations.clear();
-  estimations.set_size(referenceTree->Dataset().n_cols);
+  estimations.set_size(numReferences);
   estimations.fill(arma::fill::zeros);
 
+  PrepareSeriesExpansions();
+
   Timer::Start("computing_kde");
 
-  // Evaluate.
-  typedef KDERules<MetricType, KernelType, Tree> RuleType;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            referenceTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            metric,
-                            kernel,
-                            true);
+  // Evaluate the points of each reference tree against every reference tree;
+  // a point is only skipped in the estimation of itself when the two trees are
+  // the same.
+  size_t scores = 0;
+  size_t baseCases = 0;
+  size_t monteCarloPrunes = 0;
+  size_t seriesExpansionPrunes = 0;
+  arma::vec densities;
+  for (size_t q = 0; q < NumReferenceTrees(); ++q)
+  {
+    Tree& queryTree = GetReferenceTree(q);
+    densities.zeros(queryTree.Dataset().n_cols);
+    for (size_t r = 0; r < NumReferenceTrees(); ++r)
+    {
+      if (mode == DUAL_TREE_MODE)
+      {
+        DualTreeEvaluate(queryTree, GetReferenceTree(r), q == r, densities,
+            scores, baseCases, monteCarloPrunes, seriesExpansionPrunes);
+      }
+      else if (mode == SINGLE_TREE_MODE)
+      {
+        SingleTreeEvaluate(queryTree.Dataset(), GetReferenceTree(r), q == r,
+            densities, scores, baseCases, monteCarloPrunes,
+            seriesExpansionPrunes);
+      }
+    }
 
-  if (mode == DUAL_TREE_MODE)
+    // Store the estimations in the order of the reference indices.
+    for (size_t i = 0; i < densities.n_elem; ++i)
+      estimations(ReferenceIndex(q, i)) = densities(i);
+  }
+
+  estimations /= numReferences;
+  Timer::Stop("computing_kde");
+
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+  if (monteCarlo)
   {
-    // Create traverser.
-    DualTreeTraversalType<RuleType> traverser(rules);
-    traverser.Traverse(*referenceTree, *referenceTree);
+    Log::Info << monteCarloPrunes << " node combinations were estimated by "
+        << "sampling." << std::endl;
   }
-  else if (mode == SINGLE_TREE_MODE)
+  if (seriesExpansion)
   {
-    SingleTreeTraversalType<RuleType> traverser(rules);
-    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    Log::Info << seriesExpansionPrunes << " node combinations were estimated "
+        << "by series expansion." << std::endl;
   }
+}
 
-  estimations /= referenceTree->Dataset().n_cols;
-  // Rearrange if necessary.
-  RearrangeEstimations(*oldFromNewReferences, estimations);
-  Timer::Stop("computing_kde");
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+AddReferencePoints(MatType newPoints)
+{
+  // Check whether has already been trained.
+  if (!trained)
+  {
+    throw std::runtime_error("cannot add reference points to KDE model: model "
+                             "needs to be trained before adding points");
+  }
+
+  if (newPoints.n_cols == 0)
+    return;
 
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  // Check whether dimensions match.
+  if (newPoints.n_rows != referenceTree->Dataset().n_rows)
+  {
+    std::stringstream ss;
+    ss << "cannot add reference points to KDE model: points have "
+        << "dimensionality " << newPoints.n_rows << ", but the reference set "
+        << "has dimensionality " << referenceTree->Dataset().n_rows;
+    throw std::invalid_argument(ss.str());
+  }
+
+  const size_t firstIndex = NumReferencePoints();
+  std::vector<size_t> indices(newPoints.n_cols);
+  for (size_t i = 0; i < indices.size(); ++i)
+    indices[i] = firstIndex + i;
+
+  // Merge the new points with the smallest trees until the tree before holds
+  // more than twice as many points, so that there are O(log n) trees.
+  while (!addedTrees.empty() &&
+      addedTrees.back().indices.size() <= 2 * indices.size())
+  {
+    AddedTree& last = addedTrees.back();
+    newPoints = arma::join_rows(newPoints, last.tree->Dataset());
+    indices.insert(indices.end(), last.indices.begin(), last.indices.end());
+    delete last.tree;
+    addedTrees.pop_back();
+  }
+
+  // If the main reference tree is outgrown too, rebuild it on all the points.
+  if (addedTrees.empty() &&
+      referenceTree->Dataset().n_cols <= 2 * indices.size())
+  {
+    MergeReferenceTrees(newPoints, indices);
+    return;
+  }
+
+  Timer::Start("building_reference_tree");
+  AddedTree added;
+  std::vector<size_t> oldFromNew;
+  added.tree = BuildTree<Tree>(std::move(newPoints), oldFromNew);
+  if (tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    added.indices.resize(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+      added.indices[i] = indices[oldFromNew[i]];
+  }
+  else
+  {
+    added.indices = std::move(indices);
+  }
+  addedTrees.push_back(std::move(added));
+  Timer::Stop("building_reference_tree");
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+NumReferencePoints() const
+{
+  if (!trained)
+    return 0;
+
+  size_t numReferences = referenceTree->Dataset().n_cols;
+  for (size_t i = 0; i < addedTrees.size(); ++i)
+    numReferences += addedTrees[i].indices.size();
+
+  return numReferences;
 }
 
 template<typename KernelType,
@@ -547,6 +770,66 @@ AbsoluteError(const double newError)
   absError = newError;
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+MCProb(const double newProb)
+{
+  CheckMonteCarloValues(newProb, mcEntryCoef, mcBreakCoef);
+  mcProb = newProb;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+MCEntryCoefficient(const double newCoef)
+{
+  CheckMonteCarloValues(mcProb, newCoef, mcBreakCoef);
+  mcEntryCoef = newCoef;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+MCBreakCoefficient(const double newCoef)
+{
+  CheckMonteCarloValues(mcProb, mcEntryCoef, newCoef);
+  mcBreakCoef = newCoef;
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -562,7 +845,7 @@ void KDE<KernelType,
          TreeType,
          DualTreeTraversalType,
          SingleTreeTraversalType>::
-serialize(Archive& ar, const unsigned int /* version */)
+serialize(Archive& ar, const unsigned int version)
 {
   // Serialize preferences.
   ar & BOOST_SERIALIZATION_NVP(relError);
@@ -570,9 +853,41 @@ serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(trained);
   ar & BOOST_SERIALIZATION_NVP(mode);
 
+  // Backward compatibility: older versions of KDE had no Monte Carlo mode.
+  if (version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(monteCarlo);
+    ar & BOOST_SERIALIZATION_NVP(mcProb);
+    ar & BOOST_SERIALIZATION_NVP(initialSampleSize);
+    ar & BOOST_SERIALIZATION_NVP(mcEntryCoef);
+    ar & BOOST_SERIALIZATION_NVP(mcBreakCoef);
+  }
+  else if (Archive::is_loading::value)
+  {
+    monteCarlo = false;
+  }
+
+  // Backward compatibility: older versions of KDE had no series expansion.
+  if (version > 1)
+  {
+    ar & BOOST_SERIALIZATION_NVP(seriesExpansion);
+    ar & BOOST_SERIALIZATION_NVP(maxSeriesOrder);
+  }
+  else if (Archive::is_loading::value)
+  {
+    seriesExpansion = false;
+    maxSeriesOrder = 8;
+  }
+
+  // The trees of added points are not serialized, so they are merged into the
+  // main reference tree before saving.
+  if (Archive::is_saving::value && !addedTrees.empty())
+    MergeReferenceTrees(MatType(), std::vector<size_t>());
+
   // If we are loading, clean up memory if necessary.
   if (Archive::is_loading::value)
   {
+    ClearAddedTrees();
     if (ownsReferenceTree && referenceTree)
     {
       delete referenceTree;
@@ -589,6 +904,375 @@ serialize(Archive& ar, const unsigned int /* version */)
   ar & BOOST_SERIALIZATION_NVP(oldFromNewReferences);
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+DualTreeEvaluate(Tree& queryTree,
+                 Tree& refTree,
+                 const bool sameSet,
+                 arma::vec& densities,
+                 size_t& scores,
+                 size_t& baseCases,
+                 size_t& monteCarloPrunes,
+                 size_t& seriesExpansionPrunes)
+{
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+  const size_t numReferences = NumReferencePoints();
+
+  // When multiple threads are available, split the query tree into disjoint
+  // subtrees.  Each subtree is traversed against the reference tree with its
+  // own rules, which only add to the densities of the points of the subtree.
+  // Whether a node combination can be pruned does not depend on the other
+  // query points, so the error guarantees are the same as for a serial
+  // traversal.
+  const size_t numThreads = NumThreads();
+
+  std::vector<Tree*> subtrees;
+  std::vector<std::pair<size_t, size_t>> ranges;
+  tree::GetQuerySubtrees(queryTree, (numThreads > 1) ? 4 * numThreads : 1,
+      subtrees, ranges);
+
+  // Each set of rules samples with its own random number generator.
+  std::vector<uint32_t> seeds(subtrees.size());
+  if (monteCarlo)
+  {
+    for (size_t i = 0; i < seeds.size(); ++i)
+      seeds[i] = (uint32_t) math::randGen();
+  }
+
+  size_t totalScores = 0;
+  size_t totalBaseCases = 0;
+  size_t totalMonteCarloPrunes = 0;
+  size_t totalSeriesExpansionPrunes = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:totalScores, totalBaseCases, totalMonteCarloPrunes, \
+      totalSeriesExpansionPrunes)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    RuleType rules(refTree.Dataset(), queryTree.Dataset(), densities, relError,
+        absError, metric, kernel, sameSet, numReferences);
+    if (monteCarlo)
+    {
+      rules.SetMonteCarlo(mcProb, initialSampleSize, mcEntryCoef, mcBreakCoef,
+          seeds[i]);
+    }
+    if (seriesExpansion)
+      rules.SetSeriesExpansion(expansion);
+
+    DualTreeTraversalType<RuleType> traverser(rules);
+    traverser.Traverse(*subtrees[i], refTree);
+
+    totalScores += rules.Scores();
+    totalBaseCases += rules.BaseCases();
+    totalMonteCarloPrunes += rules.MonteCarloPrunes();
+    totalSeriesExpansionPrunes += rules.SeriesExpansionPrunes();
+  }
+
+  scores += totalScores;
+  baseCases += totalBaseCases;
+  monteCarloPrunes += totalMonteCarloPrunes;
+  seriesExpansionPrunes += totalSeriesExpansionPrunes;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+SingleTreeEvaluate(const MatType& querySet,
+                   Tree& refTree,
+                   const bool sameSet,
+                   arma::vec& densities,
+                   size_t& scores,
+                   size_t& baseCases,
+                   size_t& monteCarloPrunes,
+                   size_t& seriesExpansionPrunes)
+{
+  typedef KDERules<MetricType, KernelType, Tree> RuleType;
+  const size_t numReferences = NumReferencePoints();
+
+  // When multiple threads are available, split the query points into blocks
+  // that are each traversed with their own rules.
+  const size_t numThreads = NumThreads();
+  const size_t numBlocks = (numThreads > 1) ?
+      std::min((size_t) querySet.n_cols, 4 * numThreads) : 1;
+
+  // Each set of rules samples with its own random number generator.
+  std::vector<uint32_t> seeds(numBlocks);
+  if (monteCarlo)
+  {
+    for (size_t i = 0; i < seeds.size(); ++i)
+      seeds[i] = (uint32_t) math::randGen();
+  }
+
+  size_t totalScores = 0;
+  size_t totalBaseCases = 0;
+  size_t totalMonteCarloPrunes = 0;
+  size_t totalSeriesExpansionPrunes = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:totalScores, totalBaseCases, totalMonteCarloPrunes, \
+      totalSeriesExpansionPrunes)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = (size_t) b * querySet.n_cols / numBlocks;
+    const size_t end = ((size_t) b + 1) * querySet.n_cols / numBlocks;
+
+    RuleType rules(refTree.Dataset(), querySet, densities, relError, absError,
+        metric, kernel, sameSet, numReferences);
+    if (monteCarlo)
+    {
+      rules.SetMonteCarlo(mcProb, initialSampleSize, mcEntryCoef, mcBreakCoef,
+          seeds[b]);
+    }
+    if (seriesExpansion)
+      rules.SetSeriesExpansion(expansion);
+
+    tree::BlockSingleTreeTraversal<SingleTreeTraversalType>(rules, querySet,
+        begin, end - begin, refTree, queryBlockSize);
+
+    totalScores += rules.Scores();
+    totalBaseCases += rules.BaseCases();
+    totalMonteCarloPrunes += rules.MonteCarloPrunes();
+    totalSeriesExpansionPrunes += rules.SeriesExpansionPrunes();
+  }
+
+  scores += totalScores;
+  baseCases += totalBaseCases;
+  monteCarloPrunes += totalMonteCarloPrunes;
+  seriesExpansionPrunes += totalSeriesExpansionPrunes;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+PrepareSeriesExpansions()
+{
+  if (!seriesExpansion)
+    return;
+
+  const double bandwidth =
+      SeriesExpansionBandwidth<KernelType, MetricType>(kernel);
+  expansion = GaussianSeriesExpansion(referenceTree->Dataset().n_rows,
+      maxSeriesOrder, bandwidth);
+
+  Timer::Start("computing_series_expansions");
+  for (size_t t = 0; t < NumReferenceTrees(); ++t)
+    ComputeSeriesExpansions(GetReferenceTree(t));
+  Timer::Stop("computing_series_expansions");
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+ComputeSeriesExpansions(Tree& refTree)
+{
+  // Collect the nodes, so that their expansions are computed in parallel.
+  std::vector<Tree*> nodes;
+  std::vector<Tree*> stack(1, &refTree);
+  while (!stack.empty())
+  {
+    Tree* node = stack.back();
+    stack.pop_back();
+    nodes.push_back(node);
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push_back(&node->Child(i));
+  }
+
+  const size_t dimensionality = refTree.Dataset().n_rows;
+  const double bandwidth = expansion.Bandwidth();
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) nodes.size(); ++i)
+  {
+    Tree& node = *nodes[i];
+    KDEStat& stat = node.Stat();
+    const size_t numDescendants = node.NumDescendants();
+
+    // The highest order whose expansion has fewer terms than the node has
+    // points; an expansion with more terms is never used.
+    size_t order = 0;
+    while (order < maxSeriesOrder && GaussianSeriesExpansion::NumTerms(
+        dimensionality, order + 1) < numDescendants)
+      ++order;
+
+    if (stat.SeriesOrder() == order &&
+        (order == 0 || stat.SeriesBandwidth() == bandwidth))
+      continue;
+
+    stat.SeriesOrder() = order;
+    stat.SeriesBandwidth() = bandwidth;
+    if (order == 0)
+    {
+      stat.SeriesCoefficients().reset();
+      continue;
+    }
+
+    stat.SeriesCenter() = stat.ValidCentroid() ? stat.Centroid() :
+        arma::vec(node.Dataset().col(node.Point(0)));
+
+    // The expansion constants have working storage, so each node uses its own
+    // copy.
+    const GaussianSeriesExpansion nodeExpansion(expansion);
+    arma::vec& coefficients = stat.SeriesCoefficients();
+    coefficients.zeros(GaussianSeriesExpansion::NumTerms(dimensionality,
+        order));
+    double radius = 0.0;
+    for (size_t j = 0; j < numDescendants; ++j)
+    {
+      const arma::vec point(node.Dataset().col(node.Descendant(j)));
+      radius = std::max(radius, metric.Evaluate(point, stat.SeriesCenter()));
+      nodeExpansion.Accumulate(point, stat.SeriesCenter(), order,
+          coefficients);
+    }
+    stat.SeriesRadius() = radius;
+  }
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+typename KDE<KernelType,
+             MetricType,
+             MatType,
+             TreeType,
+             DualTreeTraversalType,
+             SingleTreeTraversalType>::Tree&
+KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+GetReferenceTree(const size_t t)
+{
+  return (t == 0) ? *referenceTree : *addedTrees[t - 1].tree;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+size_t KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+ReferenceIndex(const size_t t, const size_t point) const
+{
+  if (t > 0)
+    return addedTrees[t - 1].indices[point];
+
+  return tree::TreeTraits<Tree>::RearrangesDataset ?
+      (*oldFromNewReferences)[point] : point;
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+MergeReferenceTrees(const MatType& extraPoints,
+                    const std::vector<size_t>& extraIndices)
+{
+  MatType points(referenceTree->Dataset().n_rows,
+      NumReferencePoints() + extraIndices.size());
+  for (size_t t = 0; t < NumReferenceTrees(); ++t)
+  {
+    const MatType& dataset = GetReferenceTree(t).Dataset();
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      points.col(ReferenceIndex(t, i)) = dataset.col(i);
+  }
+  for (size_t i = 0; i < extraIndices.size(); ++i)
+    points.col(extraIndices[i]) = extraPoints.col(i);
+
+  // This deletes the trees of added points.
+  Train(std::move(points));
+}
+
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+ClearAddedTrees()
+{
+  for (size_t i = 0; i < addedTrees.size(); ++i)
+    delete addedTrees[i].tree;
+  addedTrees.clear();
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -617,6 +1301,41 @@ CheckErrorValues(const double relError, const double absError)
   }
 }
 
+template<typename KernelType,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         MetricType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+CheckMonteCarloValues(const double mcProb,
+                      const double mcEntryCoef,
+                      const double mcBreakCoef)
+{
+  if (mcProb < 0 || mcProb >= 1)
+  {
+    throw std::invalid_argument("Monte Carlo probability must be a value "
+                                "greater or equal to 0 and less than 1");
+  }
+  if (mcEntryCoef < 1)
+  {
+    throw std::invalid_argument("Monte Carlo entry coefficient must be a "
+                                "value greater or equal to 1");
+  }
+  if (mcBreakCoef <= 0 || mcBreakCoef > 1)
+  {
+    throw std::invalid_argument("Monte Carlo break coefficient must be a "
+                                "value greater than 0 and less or equal to 1");
+  }
+}
+
 template<typename KernelType,
          typename MetricType,
          typename MatType,
@@ -171,6 +171,28 @@ class TrainVisitor : public boost::static_visitor<void>
   TrainVisitor(arma::mat&& referenceSet);
 };
 
+/**
+ * AddReferencePointsVisitor adds reference points to a trained KDEType.
+ */
+class AddReferencePointsVisitor : public boost::static_visitor<void>
+{
+ private:
+  //! The reference points to add.
+  arma::mat&& newPoints;
+
+ public:
+  //! Add the reference points to some KDEType.
+  template<typename KernelType,
+           template<typename TreeMetricType,
+                    typename TreeStatType,
+                    typename TreeMatType> class TreeType>
+  void operator()(KDEType<KernelType, TreeType>* kde) const;
+
+  //! AddReferencePointsVisitor constructor. Takes ownership of the given
+  //! points.
+  AddReferencePointsVisitor(arma::mat&& newPoints);
+};
+
 /**
  * ModeVisitor exposes the Mode() method of the KDEType.
  */
@@ -345,6 +367,17 @@ class KDEModel
    */
   void BuildModel(arma::mat&& referenceSet);
 
+  /**
+   * Add the given points to the reference set of the model, without building
+   * the model again on the whole reference set.  This is useful when the
+   * reference set grows over time.  Takes possession of the points to avoid a
+   * copy, so they will not be usable after this.
+   *
+   * @pre The model has to be previously created with BuildModel.
+   * @param newPoints Set of reference points to add.
+   */
+  void AddReferencePoints(arma::mat&& newPoints);
+
   /**
    * Perform kernel density estimation on the given query set.
    * Takes possession of the query set to avoid a copy, so the query set
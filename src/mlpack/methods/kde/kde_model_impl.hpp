@@ -219,6 +219,13 @@ inline void KDEModel::BuildModel(arma::mat&& referenceSet)
   boost::apply_visitor(train, kdeModel);
 }
 
+// Add reference points to the model.
+inline void KDEModel::AddReferencePoints(arma::mat&& newPoints)
+{
+  AddReferencePointsVisitor add(std::move(newPoints));
+  boost::apply_visitor(add, kdeModel);
+}
+
 // Perform bichromatic evaluation.
 inline void KDEModel::Evaluate(arma::mat&& querySet, arma::vec& estimations)
 {
@@ -313,6 +320,27 @@ void TrainVisitor::operator()(KDEType<KernelType, TreeType>* kde) const
     throw std::runtime_error("no KDE model initialized");
 }
 
+// Parameters for AddReferencePoints.
+inline AddReferencePointsVisitor::AddReferencePointsVisitor(
+    arma::mat&& newPoints) :
+    newPoints(std::move(newPoints))
+{}
+
+// Default AddReferencePoints.
+template<typename KernelType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void AddReferencePointsVisitor::operator()(
+    KDEType<KernelType, TreeType>* kde) const
+{
+  Log::Info << "Adding reference points to KDE model..." << std::endl;
+  if (kde)
+    kde->AddReferencePoints(std::move(newPoints));
+  else
+    throw std::runtime_error("no KDE model initialized");
+}
+
 // Delete model.
 template<typename KDEType>
 void DeleteVisitor::operator()(KDEType* kde) const
@@ -14,6 +14,10 @@
 #define MLPACK_METHODS_KDE_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+#include <random>
+
+#include "gaussian_series_expansion.hpp"
 
 namespace mlpack {
 namespace kde {
@@ -21,6 +25,36 @@ namespace kde {
 /**
  * A dual-tree traversal Rules class for kernel density estimation.  This
  * contains the Score() and BaseCase() implementations.
+ *
+ * If Monte Carlo estimation is enabled with SetMonteCarlo(), node combinations
+ * that can't be pruned deterministically are estimated by sampling points of
+ * the reference node, when it has enough points.  Samples are drawn until,
+ * by the normal approximation of the mean of the samples, the estimated
+ * contribution of the reference node to each query point is within the
+ * relative error tolerance with the required probability; sampling is given
+ * up (and the traversal recurses) once more than a fraction of the points of
+ * the reference node would be needed.  The failure probability of each query
+ * point is split among the reference nodes it is estimated with, in
+ * proportion to their number of points, so that each query point's
+ * estimation is within the relative error tolerance with at least the
+ * requested probability.
+ *
+ * If series expansion is enabled with SetSeriesExpansion() (for the Gaussian
+ * kernel and the Euclidean distance), node combinations that can't be pruned
+ * are first estimated by evaluating the series expansion of the reference
+ * node at each query point, when the reference node has one (see
+ * GaussianSeriesExpansion and KDEStat), when the error bound of an expansion
+ * of some order is within the error tolerance of the reference node, and when
+ * that expansion has fewer terms than the reference node has points.  In
+ * monochromatic evaluation, query points that may be in the reference node are
+ * never estimated by series expansion, because the expansion counts the
+ * kernel of a point with itself.
+ *
+ * Kernels with finite support (see KernelTraits::HasFiniteSupport) are zero
+ * beyond their bandwidth, so node combinations whose minimum distance is
+ * greater than the bandwidth are pruned right away, and the kernel is only
+ * evaluated in base cases within the bandwidth; the evaluation then visits
+ * the same node combinations as a range search with the bandwidth as radius.
  */
 template<typename MetricType, typename KernelType, typename TreeType>
 class KDERules
@@ -38,6 +72,11 @@ class KDERules
    * @param kernel Instantiated kernel.
    * @param sameSet True if query and reference sets are the same
    *                (monochromatic evaluation).
+   * @param numReferences Total number of reference points the estimations
+   *                      are taken over, which is more than the size of
+   *                      referenceSet when the reference points are split
+   *                      among several trees.  If 0, the size of referenceSet
+   *                      is used.
    */
   KDERules(const arma::mat& referenceSet,
            const arma::mat& querySet,
@@ -46,7 +85,8 @@ class KDERules
            const double absError,
            MetricType& metric,
            KernelType& kernel,
-           const bool sameSet);
+           const bool sameSet,
+           const size_t numReferences = 0);
 
   //! Base Case.
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
@@ -81,6 +121,44 @@ class KDERules
   //! Get the number of scores.
   size_t Scores() const { return scores; }
 
+  //! Get the number of node combinations that were estimated by sampling.
+  size_t MonteCarloPrunes() const { return monteCarloPrunes; }
+
+  //! Get the number of node combinations that were estimated by series
+  //! expansion.
+  size_t SeriesExpansionPrunes() const { return seriesExpansionPrunes; }
+
+  /**
+   * Enable Monte Carlo estimation of node combinations that can't be pruned
+   * deterministically.
+   *
+   * @param mcProb Probability that the estimation of each query point is
+   *               within the relative error tolerance (in [0, 1)).
+   * @param initialSampleSize Number of samples drawn from a reference node
+   *                          before the first check of the estimations.
+   * @param mcEntryCoef Only reference nodes with at least mcEntryCoef *
+   *                    initialSampleSize points are sampled (at least 1).
+   * @param mcBreakCoef Sampling of a reference node is given up once more
+   *                    than mcBreakCoef times its number of points would be
+   *                    needed (in (0, 1]).
+   * @param seed Seed of the random number generator used for the samples.
+   */
+  void SetMonteCarlo(const double mcProb,
+                     const size_t initialSampleSize,
+                     const double mcEntryCoef,
+                     const double mcBreakCoef,
+                     const uint32_t seed);
+
+  /**
+   * Enable the estimation of node combinations that can't be pruned by the
+   * series expansions of the reference nodes.  The expansions must have been
+   * computed for the bandwidth of the given expansion constants, whose
+   * maximum order must be at least the order of each expansion.
+   *
+   * @param expansion Constants of the series expansions.
+   */
+  void SetSeriesExpansion(const GaussianSeriesExpansion& expansion);
+
  private:
   //! Evaluate kernel value of 2 points given their indexes.
   double EvaluateKernel(const size_t queryIndex,
@@ -90,6 +168,29 @@ class KDERules
   double EvaluateKernel(const arma::vec& query,
                         const arma::vec& reference) const;
 
+  /**
+   * Try to estimate the contribution of the reference node to each of the
+   * query points in estimateQueries by sampling.  If the estimations are
+   * accurate enough, they are added to the densities and true is returned.
+   */
+  bool MonteCarloEstimate(TreeType& referenceNode);
+
+  //! Get whether the reference node has a series expansion that can be used.
+  bool HasSeriesExpansion(const TreeType& referenceNode) const;
+
+  /**
+   * Try to estimate the contribution of the reference node to each of the
+   * query points in estimateQueries, which are between minQueryDistance and
+   * maxQueryDistance of the center of the expansion of the reference node,
+   * with the series expansion of the reference node.  If an expansion of some
+   * order is accurate enough and cheaper than the base cases, the estimations
+   * are added to the densities and true is returned.
+   */
+  bool SeriesEstimate(TreeType& referenceNode,
+                      const double minKernel,
+                      const double minQueryDistance,
+                      const double maxQueryDistance);
+
   //! The reference set.
   const arma::mat& referenceSet;
 
@@ -111,9 +212,16 @@ class KDERules
   //! Instantiated kernel.
   KernelType& kernel;
 
+  //! Distance beyond which the kernel is zero (DBL_MAX if there is none).
+  const double support;
+
   //! Whether reference and query sets are the same.
   const bool sameSet;
 
+  //! Total number of reference points; the error tolerance of each reference
+  //! point is a 1 / numReferences share of the tolerance.
+  const size_t numReferences;
+
   //! The last query index.
   size_t lastQueryIndex;
 
@@ -128,6 +236,47 @@ class KDERules
 
   //! The number of scores.
   size_t scores;
+
+  //! Whether Monte Carlo estimation is enabled.
+  bool monteCarlo;
+
+  //! Failure probability of the estimation of each query point.
+  double mcAlpha;
+
+  //! Number of samples drawn before the estimations are first checked.
+  size_t initialSampleSize;
+
+  //! Minimum reference node size to sample from, relative to
+  //! initialSampleSize.
+  double mcEntryCoef;
+
+  //! Maximum number of samples, relative to the reference node size.
+  double mcBreakCoef;
+
+  //! Random number generator for the samples.
+  std::mt19937 generator;
+
+  //! The query points of the node combination being estimated by sampling or
+  //! series expansion.
+  std::vector<size_t> estimateQueries;
+
+  //! The sum of the sampled kernel values of each query point.
+  arma::vec mcSums;
+
+  //! The sum of the squared sampled kernel values of each query point.
+  arma::vec mcSquaredSums;
+
+  //! The number of node combinations estimated by sampling.
+  size_t monteCarloPrunes;
+
+  //! Whether series expansion is enabled.
+  bool seriesExpansion;
+
+  //! Constants of the series expansions.
+  GaussianSeriesExpansion expansion;
+
+  //! The number of node combinations estimated by series expansion.
+  size_t seriesExpansionPrunes;
 };
 
 } // namespace kde
@@ -16,9 +16,31 @@
 // In case it hasn't been included yet.
 #include "kde_rules.hpp"
 
+#include <boost/math/distributions/normal.hpp>
+
 namespace mlpack {
 namespace kde {
 
+//! Get the distance beyond which a kernel with finite support is zero.
+template<typename KernelType>
+double KernelSupport(
+    const KernelType& kernel,
+    const typename std::enable_if<
+        kernel::KernelTraits<KernelType>::HasFiniteSupport>::type* = 0)
+{
+  return kernel.Bandwidth();
+}
+
+//! Kernels without finite support are never zero.
+template<typename KernelType>
+double KernelSupport(
+    const KernelType& /* kernel */,
+    const typename std::enable_if<
+        !kernel::KernelTraits<KernelType>::HasFiniteSupport>::type* = 0)
+{
+  return DBL_MAX;
+}
+
 template<typename MetricType, typename KernelType, typename TreeType>
 KDERules<MetricType, KernelType, TreeType>::KDERules(
     const arma::mat& referenceSet,
@@ -28,7 +50,8 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     const double absError,
     MetricType& metric,
     KernelType& kernel,
-    const bool sameSet) :
+    const bool sameSet,
+    const size_t numReferences) :
     referenceSet(referenceSet),
     querySet(querySet),
     densities(densities),
@@ -36,15 +59,49 @@ KDERules<MetricType, KernelType, TreeType>::KDERules(
     relError(relError),
     metric(metric),
     kernel(kernel),
+    support(KernelSupport(kernel)),
     sameSet(sameSet),
+    numReferences(numReferences == 0 ? referenceSet.n_cols : numReferences),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    monteCarlo(false),
+    mcAlpha(0.0),
+    initialSampleSize(0),
+    mcEntryCoef(0.0),
+    mcBreakCoef(0.0),
+    monteCarloPrunes(0),
+    seriesExpansion(false),
+    seriesExpansionPrunes(0)
 {
   // Nothing to do.
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::SetMonteCarlo(
+    const double mcProb,
+    const size_t initialSampleSize,
+    const double mcEntryCoef,
+    const double mcBreakCoef,
+    const uint32_t seed)
+{
+  this->monteCarlo = true;
+  this->mcAlpha = 1.0 - mcProb;
+  this->initialSampleSize = std::max(initialSampleSize, (size_t) 2);
+  this->mcEntryCoef = mcEntryCoef;
+  this->mcBreakCoef = mcBreakCoef;
+  generator.seed(seed);
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+void KDERules<MetricType, KernelType, TreeType>::SetSeriesExpansion(
+    const GaussianSeriesExpansion& expansion)
+{
+  this->seriesExpansion = true;
+  this->expansion = expansion;
+}
+
 //! The base case.
 template<typename MetricType, typename KernelType, typename TreeType>
 inline force_inline
@@ -64,7 +121,8 @@ double KDERules<MetricType, KernelType, TreeType>::BaseCase(
   // Calculations.
   const double distance = metric.Evaluate(querySet.col(queryIndex),
                                           referenceSet.col(referenceIndex));
-  densities(queryIndex) += kernel.Evaluate(distance);
+  if (distance <= support)
+    densities(queryIndex) += kernel.Evaluate(distance);
 
   ++baseCases;
   lastQueryIndex = queryIndex;
@@ -82,6 +140,15 @@ Score(const size_t queryIndex, TreeType& referenceNode)
   const double minDistance = referenceNode.MinDistance(queryPoint);
   bool newCalculations = true;
 
+  // The kernel is zero for all the points of the reference node.
+  if (minDistance > support)
+  {
+    ++scores;
+    traversalInfo.LastReferenceNode() = &referenceNode;
+    traversalInfo.LastScore() = DBL_MAX;
+    return DBL_MAX;
+  }
+
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid &&
       lastQueryIndex == queryIndex &&
       traversalInfo.LastReferenceNode() != NULL &&
@@ -101,7 +168,7 @@ Score(const size_t queryIndex, TreeType& referenceNode)
   }
 
   if (newCalculations &&
-      bound <= (absError + relError * minKernel) / referenceSet.n_cols)
+      bound <= (absError + relError * minKernel) / numReferences)
   {
     // Estimate values.
     double kernelValue;
@@ -122,6 +189,24 @@ Score(const size_t queryIndex, TreeType& referenceNode)
     // Don't explore this tree branch.
     score = DBL_MAX;
   }
+  else if (newCalculations && (seriesExpansion || monteCarlo))
+  {
+    estimateQueries.assign(1, queryIndex);
+    score = minDistance;
+
+    // A query point in the reference node has a minimum distance of 0.
+    if (HasSeriesExpansion(referenceNode) && !(sameSet && minDistance == 0.0))
+    {
+      const double centerDistance = metric.Evaluate(queryPoint,
+          referenceNode.Stat().SeriesCenter());
+      if (SeriesEstimate(referenceNode, minKernel, centerDistance,
+          centerDistance))
+        score = DBL_MAX;
+    }
+
+    if (score != DBL_MAX && monteCarlo && MonteCarloEstimate(referenceNode))
+      score = DBL_MAX;
+  }
   else
   {
     score = minDistance;
@@ -153,6 +238,16 @@ Score(TreeType& queryNode, TreeType& referenceNode)
   // Calculations are not duplicated.
   bool newCalculations = true;
 
+  // The kernel is zero for all the pairs of points of the nodes.
+  if (minDistance > support)
+  {
+    ++scores;
+    traversalInfo.LastQueryNode() = &queryNode;
+    traversalInfo.LastReferenceNode() = &referenceNode;
+    traversalInfo.LastScore() = DBL_MAX;
+    return DBL_MAX;
+  }
+
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid &&
       (traversalInfo.LastQueryNode() != NULL) &&
       (traversalInfo.LastReferenceNode() != NULL) &&
@@ -174,7 +269,7 @@ Score(TreeType& queryNode, TreeType& referenceNode)
 
   // If possible, avoid some calculations because of the error tolerance.
   if (newCalculations &&
-      bound <= (absError + relError * minKernel) / referenceSet.n_cols)
+      bound <= (absError + relError * minKernel) / numReferences)
   {
     // Auxiliary variables.
     double kernelValue;
@@ -201,6 +296,25 @@ Score(TreeType& queryNode, TreeType& referenceNode)
     }
     score = DBL_MAX;
   }
+  else if (newCalculations && (seriesExpansion || monteCarlo))
+  {
+    estimateQueries.resize(queryNode.NumDescendants());
+    for (size_t i = 0; i < estimateQueries.size(); ++i)
+      estimateQueries[i] = queryNode.Descendant(i);
+    score = minDistance;
+
+    // Overlapping nodes have a minimum distance of 0.
+    if (HasSeriesExpansion(referenceNode) && !(sameSet && minDistance == 0.0))
+    {
+      const arma::vec& center = referenceNode.Stat().SeriesCenter();
+      if (SeriesEstimate(referenceNode, minKernel,
+          queryNode.MinDistance(center), queryNode.MaxDistance(center)))
+        score = DBL_MAX;
+    }
+
+    if (score != DBL_MAX && monteCarlo && MonteCarloEstimate(referenceNode))
+      score = DBL_MAX;
+  }
   else
   {
     score = minDistance;
@@ -240,6 +354,128 @@ EvaluateKernel(const arma::vec& query, const arma::vec& reference) const
   return kernel.Evaluate(metric.Evaluate(query, reference));
 }
 
+template<typename MetricType, typename KernelType, typename TreeType>
+bool KDERules<MetricType, KernelType, TreeType>::MonteCarloEstimate(
+    TreeType& referenceNode)
+{
+  const size_t numDescendants = referenceNode.NumDescendants();
+  if (numDescendants < mcEntryCoef * initialSampleSize)
+    return false;
+
+  // The reference nodes a query point is estimated with are disjoint, so
+  // splitting the failure probability in proportion to their size keeps the
+  // total failure probability of the query point below mcAlpha.
+  const double alpha = mcAlpha * numDescendants / numReferences;
+  const double z = boost::math::quantile(boost::math::normal(),
+      1.0 - alpha / 2.0);
+  const double maxSamples = mcBreakCoef * numDescendants;
+
+  const size_t numQueries = estimateQueries.size();
+  mcSums.zeros(numQueries);
+  mcSquaredSums.zeros(numQueries);
+  std::uniform_int_distribution<size_t> distribution(0, numDescendants - 1);
+
+  size_t numSamples = 0;
+  size_t targetSamples = initialSampleSize;
+  while (numSamples < targetSamples)
+  {
+    for (; numSamples < targetSamples; ++numSamples)
+    {
+      const size_t referenceIndex =
+          referenceNode.Descendant(distribution(generator));
+      for (size_t i = 0; i < numQueries; ++i)
+      {
+        // A point does not contribute to its own estimation.
+        if (sameSet && estimateQueries[i] == referenceIndex)
+          continue;
+
+        const double kernelValue = EvaluateKernel(estimateQueries[i],
+            referenceIndex);
+        mcSums[i] += kernelValue;
+        mcSquaredSums[i] += kernelValue * kernelValue;
+      }
+    }
+
+    // The mean of m samples is within the relative error tolerance with
+    // probability 1 - alpha when z * stddev / sqrt(m) <= relError * mean.
+    for (size_t i = 0; i < numQueries; ++i)
+    {
+      const double mean = mcSums[i] / numSamples;
+      const double variance = std::max(0.0, (mcSquaredSums[i] -
+          numSamples * mean * mean) / (numSamples - 1));
+      if (variance == 0.0)
+        continue;
+
+      const double tolerance = relError * mean;
+      if (tolerance == 0.0)
+        return false;
+
+      const double requiredSamples = std::ceil(z * z * variance /
+          (tolerance * tolerance));
+      if (requiredSamples > maxSamples)
+        return false;
+
+      targetSamples = std::max(targetSamples, (size_t) requiredSamples);
+    }
+  }
+
+  for (size_t i = 0; i < numQueries; ++i)
+    densities(estimateQueries[i]) += numDescendants * mcSums[i] / numSamples;
+
+  ++monteCarloPrunes;
+  return true;
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+inline bool KDERules<MetricType, KernelType, TreeType>::HasSeriesExpansion(
+    const TreeType& referenceNode) const
+{
+  const KDEStat& referenceStat = referenceNode.Stat();
+  return seriesExpansion && referenceStat.SeriesOrder() > 0 &&
+      referenceStat.SeriesBandwidth() == expansion.Bandwidth();
+}
+
+template<typename MetricType, typename KernelType, typename TreeType>
+bool KDERules<MetricType, KernelType, TreeType>::SeriesEstimate(
+    TreeType& referenceNode,
+    const double minKernel,
+    const double minQueryDistance,
+    const double maxQueryDistance)
+{
+  const KDEStat& referenceStat = referenceNode.Stat();
+  const size_t numDescendants = referenceNode.NumDescendants();
+
+  // The error tolerance of the reference node, as for deterministic pruning.
+  const double tolerance = numDescendants * (absError + relError * minKernel) /
+      numReferences;
+
+  // Use the lowest order that is accurate enough, as long as it is cheaper
+  // than the base cases.
+  for (size_t order = 1; order <= referenceStat.SeriesOrder(); ++order)
+  {
+    if (GaussianSeriesExpansion::NumTerms(expansion.Dimensionality(), order) >=
+        numDescendants)
+      return false;
+
+    if (expansion.ErrorBound(numDescendants, referenceStat.SeriesRadius(),
+        minQueryDistance, maxQueryDistance, order) > tolerance)
+      continue;
+
+    for (size_t i = 0; i < estimateQueries.size(); ++i)
+    {
+      densities(estimateQueries[i]) += expansion.Evaluate(
+          querySet.unsafe_col(estimateQueries[i]),
+          referenceStat.SeriesCenter(), referenceStat.SeriesCoefficients(),
+          order);
+    }
+
+    ++seriesExpansionPrunes;
+    return true;
+  }
+
+  return false;
+}
+
 } // namespace kde
 } // namespace mlpack
 
@@ -25,11 +25,19 @@ class KDEStat
 {
  public:
   //! Initialize the statistic.
-  KDEStat() : validCentroid(false) { }
+  KDEStat() :
+      validCentroid(false),
+      seriesRadius(0.0),
+      seriesOrder(0),
+      seriesBandwidth(0.0)
+  { }
 
   //! Initialization for a fully initialized node.
   template<typename TreeType>
-  KDEStat(TreeType& node)
+  KDEStat(TreeType& node) :
+      seriesRadius(0.0),
+      seriesOrder(0),
+      seriesBandwidth(0.0)
   {
     // Calculate centroid if necessary.
     if (!tree::TreeTraits<TreeType>::FirstPointIsCentroid)
@@ -62,12 +70,41 @@ class KDEStat
   //! Get whether the centroid is valid.
   inline bool ValidCentroid() const { return validCentroid; }
 
-  //! Serialize the statistic to/from an archive.
+  //! Get the coefficients of the series expansion of the node's points.
+  const arma::vec& SeriesCoefficients() const { return seriesCoefficients; }
+  //! Modify the coefficients of the series expansion of the node's points.
+  arma::vec& SeriesCoefficients() { return seriesCoefficients; }
+
+  //! Get the center of the series expansion.
+  const arma::vec& SeriesCenter() const { return seriesCenter; }
+  //! Modify the center of the series expansion.
+  arma::vec& SeriesCenter() { return seriesCenter; }
+
+  //! Get the maximum distance of the node's points to the series center.
+  double SeriesRadius() const { return seriesRadius; }
+  //! Modify the maximum distance of the node's points to the series center.
+  double& SeriesRadius() { return seriesRadius; }
+
+  //! Get the order of the series expansion (0 if there is none).
+  size_t SeriesOrder() const { return seriesOrder; }
+  //! Modify the order of the series expansion (0 if there is none).
+  size_t& SeriesOrder() { return seriesOrder; }
+
+  //! Get the kernel bandwidth the series expansion was computed for.
+  double SeriesBandwidth() const { return seriesBandwidth; }
+  //! Modify the kernel bandwidth the series expansion was computed for.
+  double& SeriesBandwidth() { return seriesBandwidth; }
+
+  //! Serialize the statistic to/from an archive.  The series expansion is not
+  //! serialized; it is computed again when it is needed.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int /* version */)
   {
     ar & BOOST_SERIALIZATION_NVP(centroid);
     ar & BOOST_SERIALIZATION_NVP(validCentroid);
+
+    if (Archive::is_loading::value)
+      seriesOrder = 0;
   }
 
  private:
@@ -76,6 +113,21 @@ class KDEStat
 
   //! Whether the centroid is updated or is junk.
   bool validCentroid;
+
+  //! Coefficients of the series expansion of the node's points.
+  arma::vec seriesCoefficients;
+
+  //! Center of the series expansion.
+  arma::vec seriesCenter;
+
+  //! Maximum distance of the node's points to the series center.
+  double seriesRadius;
+
+  //! Order of the series expansion (0 if there is none).
+  size_t seriesOrder;
+
+  //! Kernel bandwidth the series expansion was computed for.
+  double seriesBandwidth;
 };
 
 } // namespace kde
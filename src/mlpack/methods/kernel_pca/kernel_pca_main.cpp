@@ -30,6 +30,7 @@
 #include <mlpack/methods/nystroem_method/kmeans_selection.hpp>
 #include <mlpack/methods/nystroem_method/nystroem_method.hpp>
 #include <mlpack/methods/kernel_pca/kernel_rules/nystroem_method.hpp>
+#include <mlpack/methods/kernel_pca/kernel_rules/random_fourier_method.hpp>
 
 #include "kernel_pca.hpp"
 
@@ -98,7 +99,15 @@ PROGRAM_INFO("Kernel Principal Components Analysis",
     "the kernel matrix; to specify the sampling scheme, the " +
     PRINT_PARAM_STRING("sampling") + " parameter is used.  The "
     "sampling scheme for the Nystr\u00F6m method can be chosen from the "
-    "following list: 'kmeans', 'random', 'ordered'.",
+    "following list: 'kmeans', 'random', 'ordered'."
+    "\n\n"
+    "For the 'gaussian' and 'laplacian' kernels, random Fourier features "
+    "(\"Random features for large-scale kernel machines\", 2008) can be used "
+    "instead by specifying the " + PRINT_PARAM_STRING("random_features") +
+    " parameter.  The data is mapped to " +
+    PRINT_PARAM_STRING("num_features") + " random features, so that no kernel "
+    "matrix is computed and the running time is linear in the number of "
+    "points.",
     SEE_ALSO("Kernel principal component analysis on Wikipedia",
         "https://en.wikipedia.org/wiki/Kernel_principal_component_analysis"),
     SEE_ALSO("Kernel Principal Component Analysis (pdf)",
@@ -123,6 +132,11 @@ PARAM_FLAG("nystroem_method", "If set, the Nystroem method will be used.", "n");
 PARAM_STRING_IN("sampling", "Sampling scheme to use for the Nystroem method: "
     "'kmeans', 'random', 'ordered'", "s", "kmeans");
 
+PARAM_FLAG("random_features", "If set, random Fourier features will be used "
+    "(only for the 'gaussian' and 'laplacian' kernels).", "R");
+PARAM_INT_IN("num_features", "Number of random Fourier features to use.", "F",
+    500);
+
 PARAM_DOUBLE_IN("kernel_scale", "Scale, for 'hyptan' kernel.", "S", 1.0);
 PARAM_DOUBLE_IN("offset", "Offset, for 'hyptan' and 'polynomial' kernels.", "O",
     0.0);
@@ -175,6 +189,28 @@ void RunKPCA(arma::mat& dataset,
   }
 }
 
+//! Run KPCA with random Fourier features for the given kernel type.
+template<typename KernelType>
+void RunRandomFourierKPCA(arma::mat& dataset,
+                          const bool centerTransformedData,
+                          const size_t newDim,
+                          const size_t numFeatures,
+                          KernelType& kernel)
+{
+  KernelPCA<KernelType, RandomFourierKernelRule<KernelType> > kpca(kernel,
+      centerTransformedData);
+
+  // Use at least as many features as output dimensions.
+  arma::mat transformedData, eigvec;
+  arma::vec eigval;
+  kpca.Apply(dataset, transformedData, eigval, eigvec,
+      std::max(numFeatures, newDim));
+
+  if (newDim < transformedData.n_rows)
+    transformedData.shed_rows(newDim, transformedData.n_rows - 1);
+  dataset = std::move(transformedData);
+}
+
 static void mlpackMain()
 {
   RequireAtLeastOnePassed({ "output" }, false, "no output will be saved");
@@ -205,6 +241,22 @@ static void mlpackMain()
   const bool centerTransformedData = CLI::HasParam("center");
   const bool nystroem = CLI::HasParam("nystroem_method");
   const string sampling = CLI::GetParam<string>("sampling");
+  const bool randomFeatures = CLI::HasParam("random_features");
+
+  ReportIgnoredParam({{ "random_features", false }}, "num_features");
+  RequireParamValue<int>("num_features", [](int x) { return x > 0; }, true,
+      "number of random features must be positive");
+  if (randomFeatures && nystroem)
+  {
+    Log::Fatal << "Cannot use both " << PRINT_PARAM_STRING("nystroem_method")
+        << " and " << PRINT_PARAM_STRING("random_features") << "!" << endl;
+  }
+  if (randomFeatures && kernelType != "gaussian" && kernelType != "laplacian")
+  {
+    Log::Fatal << PRINT_PARAM_STRING("random_features") << " can only be used "
+        << "with the 'gaussian' and 'laplacian' kernels!" << endl;
+  }
+  const size_t numFeatures = (size_t) CLI::GetParam<int>("num_features");
 
   if (kernelType == "linear")
   {
@@ -217,8 +269,16 @@ static void mlpackMain()
     const double bandwidth = CLI::GetParam<double>("bandwidth");
 
     GaussianKernel kernel(bandwidth);
-    RunKPCA<GaussianKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    if (randomFeatures)
+    {
+      RunRandomFourierKPCA<GaussianKernel>(dataset, centerTransformedData,
+          newDim, numFeatures, kernel);
+    }
+    else
+    {
+      RunKPCA<GaussianKernel>(dataset, centerTransformedData, nystroem, newDim,
+          sampling, kernel);
+    }
   }
   else if (kernelType == "polynomial")
   {
@@ -243,8 +303,16 @@ static void mlpackMain()
     const double bandwidth = CLI::GetParam<double>("bandwidth");
 
     LaplacianKernel kernel(bandwidth);
-    RunKPCA<LaplacianKernel>(dataset, centerTransformedData, nystroem, newDim,
-        sampling, kernel);
+    if (randomFeatures)
+    {
+      RunRandomFourierKPCA<LaplacianKernel>(dataset, centerTransformedData,
+          newDim, numFeatures, kernel);
+    }
+    else
+    {
+      RunKPCA<LaplacianKernel>(dataset, centerTransformedData, nystroem, newDim,
+          sampling, kernel);
+    }
   }
   else if (kernelType == "epanechnikov")
   {
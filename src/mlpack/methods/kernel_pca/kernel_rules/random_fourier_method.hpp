@@ -0,0 +1,78 @@
+/**
+ * @file random_fourier_method.hpp
+ *
+ * Use random Fourier features for approximating a kernel matrix.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_METHOD_HPP
+#define MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/random_fourier_features/random_fourier_features.hpp>
+
+namespace mlpack {
+namespace kpca {
+
+/**
+ * Kernel rule that maps the data to random Fourier features (see
+ * kernel::RandomFourierFeatures) and performs PCA on the features.  The kernel
+ * matrix is approximated by Z^T Z for the D x n feature matrix Z, so only the
+ * D x D covariance of the features is decomposed, and the cost is linear in
+ * the number of points.  Since the features are explicit, they are centered
+ * exactly, instead of centering the kernel matrix.
+ *
+ * Only shift-invariant kernels (GaussianKernel, LaplacianKernel,
+ * CauchyKernel) are supported.
+ */
+template<typename KernelType>
+class RandomFourierKernelRule
+{
+ public:
+  /**
+   * Approximate the kernel matrix with random Fourier features.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors will be written to this matrix.
+   * @param rank Number of random features to use.
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t rank,
+                                KernelType kernel = KernelType())
+  {
+    kernel::RandomFourierFeatures<KernelType> rff(data.n_rows, rank, kernel);
+    arma::mat features;
+    rff.Transform(data, features);
+
+    // Center the features.
+    features.each_col() -= arma::mean(features, 1);
+
+    // The nonzero eigenvalues of the centered kernel matrix Z^T Z are those of
+    // Z Z^T.
+    arma::eig_sym(eigval, eigvec, features * features.t());
+
+    // Swap the eigenvalues since they are ordered backwards (we need largest
+    // to smallest).
+    for (size_t i = 0; i < floor(eigval.n_elem / 2.0); ++i)
+      eigval.swap_rows(i, (eigval.n_elem - 1) - i);
+
+    // Flip the coefficients to produce the same effect.
+    eigvec = arma::fliplr(eigvec);
+
+    transformedData = eigvec.t() * features;
+  }
+};
+
+} // namespace kpca
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,202 @@
+/**
+ * @file distributed_kmeans.hpp
+ *
+ * A data-parallel k-means clustering over a dataset split between several
+ * ranks (e.g. MPI processes), each of which holds one shard of the points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "kmeans.hpp"
+#include "local_communicator.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This class runs Lloyd's algorithm on a dataset that is split in shards
+ * between the ranks of a communicator.  All the ranks construct the object and
+ * call Cluster() with their own shard; they all end up with the same
+ * centroids.
+ *
+ * Each iteration runs one step of the given LloydStepType on the local shard,
+ * which gives the local centroids and counts of the points in each cluster.
+ * Those are combined into the global centroids with a single sum over the
+ * ranks, so the clustering is the same as the one KMeans computes on the whole
+ * dataset (up to the rounding of the sums), with the same convergence test and
+ * maximum number of iterations.
+ *
+ * The bounds kept by the pruning step types (e.g. HamerlyKMeans or
+ * ElkanKMeans) are only valid for the centroids they compute themselves, which
+ * are not the global centroids.  So a new step is constructed at each
+ * iteration; it is exact, but those step types then prune less than with
+ * KMeans, and the ones that build a tree (DualTreeKMeans, PellegMooreKMeans)
+ * rebuild it at each iteration.  Step types that keep state between iterations
+ * (like MiniBatchKMeans) can't be used.
+ *
+ * The initial partition policy runs on each shard if it gives assignments, and
+ * only on the shard of rank 0 if it gives centroids, which are then sent to the
+ * other ranks.  The empty cluster policy also runs on rank 0 only, with the
+ * global centroids and counts but the local shard, and its result is sent to
+ * the other ranks.
+ *
+ * @code
+ * extern arma::mat shard; // The points held by this rank.
+ * arma::mat centroids;
+ *
+ * // With MPI (mlpack configured with -DUSE_MPI=ON).
+ * DistributedKMeans<MPICommunicator, EuclideanDistance, SampleInitialization,
+ *     MaxVarianceNewCluster, HamerlyKMeans> k;
+ * k.Cluster(shard, 10, centroids);
+ * @endcode
+ *
+ * @tparam CommunicatorType The communicator between the ranks; it must
+ *     implement 'size_t Rank() const', 'size_t Size() const', 'void
+ *     AllReduceSum(arma::mat&) const' and 'void Broadcast(arma::mat&) const'
+ *     (from rank 0); see LocalCommunicator and MPICommunicator.
+ * @tparam MetricType The distance metric to use.
+ * @tparam InitialPartitionPolicy Initial partitioning policy; see KMeans.
+ * @tparam EmptyClusterPolicy Policy for what to do on an empty cluster; see
+ *     KMeans.
+ * @tparam LloydStepType Implementation of single Lloyd step to run on each
+ *     shard.
+ * @tparam MatType Type of the shards.
+ */
+template<typename CommunicatorType = LocalCommunicator,
+         typename MetricType = metric::EuclideanDistance,
+         typename InitialPartitionPolicy = SampleInitialization,
+         typename EmptyClusterPolicy = MaxVarianceNewCluster,
+         template<class, class> class LloydStepType = NaiveKMeans,
+         typename MatType = arma::mat>
+class DistributedKMeans
+{
+ public:
+  /**
+   * Create a distributed K-Means object.
+   *
+   * @param maxIterations Maximum number of iterations allowed before giving up
+   *     (0 is valid, but the algorithm may never terminate).
+   * @param metric Optional MetricType object; for when the metric has state
+   *     it needs to store.
+   * @param partitioner Optional InitialPartitionPolicy object; for when a
+   *     specially initialized partitioning policy is required.
+   * @param emptyClusterAction Optional EmptyClusterPolicy object; for when a
+   *     specially initialized empty cluster policy is required.
+   * @param communicator Optional CommunicatorType object; for when the
+   *     communicator isn't the default one.
+   */
+  DistributedKMeans(
+      const size_t maxIterations = 1000,
+      const MetricType metric = MetricType(),
+      const InitialPartitionPolicy partitioner = InitialPartitionPolicy(),
+      const EmptyClusterPolicy emptyClusterAction = EmptyClusterPolicy(),
+      const CommunicatorType communicator = CommunicatorType());
+
+  /**
+   * Perform k-means clustering on the shards, returning the centroids of each
+   * cluster in the centroids matrix.  All the ranks must call this together.
+   * Optionally, the initial centroids can be specified by filling the centroids
+   * matrix of rank 0 with the initial centroids and specifying initialGuess =
+   * true.
+   *
+   * @param data Shard of the dataset held by this rank.
+   * @param clusters Number of clusters to compute.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that the centroids of rank
+   *      0 contain the initial cluster centroids.
+   */
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  /**
+   * Perform k-means clustering on the shards, returning the centroids of each
+   * cluster and the cluster assignments of the points of the local shard.
+   *
+   * @param data Shard of the dataset held by this rank.
+   * @param clusters Number of clusters to compute.
+   * @param assignments Vector to store the assignments of the shard in.
+   * @param centroids Matrix in which centroids are stored.
+   * @param initialGuess If true, then it is assumed that the centroids of rank
+   *      0 contain the initial cluster centroids.
+   */
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::Row<size_t>& assignments,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Set the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the distance metric.
+  const MetricType& Metric() const { return metric; }
+  //! Modify the distance metric.
+  MetricType& Metric() { return metric; }
+
+  //! Get the initial partitioning policy.
+  const InitialPartitionPolicy& Partitioner() const { return partitioner; }
+  //! Modify the initial partitioning policy.
+  InitialPartitionPolicy& Partitioner() { return partitioner; }
+
+  //! Get the empty cluster policy.
+  const EmptyClusterPolicy& EmptyClusterAction() const
+  { return emptyClusterAction; }
+  //! Modify the empty cluster policy.
+  EmptyClusterPolicy& EmptyClusterAction() { return emptyClusterAction; }
+
+  //! Get the communicator.
+  const CommunicatorType& Communicator() const { return communicator; }
+  //! Modify the communicator.
+  CommunicatorType& Communicator() { return communicator; }
+
+ private:
+  /**
+   * Sum the given per-cluster sums of points and counts over all the ranks,
+   * and compute the centroids from them, in place.  The clusters without points
+   * get a zero centroid, like with the Lloyd step types.
+   *
+   * @param centroids Sums of the points of each cluster on this rank; they are
+   *     overwritten with the global centroids.
+   * @param counts Number of points in each cluster on this rank; they are
+   *     overwritten with the global counts.
+   */
+  void Reduce(arma::mat& centroids, arma::Col<size_t>& counts) const;
+
+  /**
+   * Copy the centroids and counts of rank 0 to all the other ranks.
+   *
+   * @param centroids Centroids to broadcast.
+   * @param counts Counts to broadcast.
+   */
+  void Broadcast(arma::mat& centroids, arma::Col<size_t>& counts) const;
+
+  //! Maximum number of iterations before giving up.
+  size_t maxIterations;
+  //! Instantiated distance metric.
+  MetricType metric;
+  //! Instantiated initial partitioning policy.
+  InitialPartitionPolicy partitioner;
+  //! Instantiated empty cluster policy.
+  EmptyClusterPolicy emptyClusterAction;
+  //! Instantiated communicator.
+  CommunicatorType communicator;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_kmeans_impl.hpp"
+
+#endif
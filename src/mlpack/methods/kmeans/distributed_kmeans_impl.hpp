@@ -0,0 +1,313 @@
+/**
+ * @file distributed_kmeans_impl.hpp
+ *
+ * Implementation of the DistributedKMeans class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_kmeans.hpp"
+
+#include <mlpack/core/util/rate_limiter.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename CommunicatorType,
+         typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+DistributedKMeans<
+    CommunicatorType,
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+DistributedKMeans(const size_t maxIterations,
+                  const MetricType metric,
+                  const InitialPartitionPolicy partitioner,
+                  const EmptyClusterPolicy emptyClusterAction,
+                  const CommunicatorType communicator) :
+    maxIterations(maxIterations),
+    metric(metric),
+    partitioner(partitioner),
+    emptyClusterAction(emptyClusterAction),
+    communicator(communicator)
+{
+  // Nothing to do.
+}
+
+template<typename CommunicatorType,
+         typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<
+    CommunicatorType,
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+Cluster(const MatType& data,
+        const size_t clusters,
+        arma::mat& centroids,
+        const bool initialGuess)
+{
+  // Make sure we have more points than clusters, over all the shards.
+  arma::mat points(1, 1);
+  points[0] = data.n_cols;
+  communicator.AllReduceSum(points);
+  if (clusters > points[0])
+    Log::Warn << "DistributedKMeans::Cluster(): more clusters requested than "
+        << "points given." << std::endl;
+  else if (clusters == 0)
+    Log::Warn << "DistributedKMeans::Cluster(): zero clusters requested.  This "
+        << "probably isn't going to work.  Brace for crash." << std::endl;
+
+  if (initialGuess)
+  {
+    // All the ranks use the initial centroids of rank 0.
+    communicator.Broadcast(centroids);
+
+    if (centroids.n_cols != clusters)
+      Log::Fatal << "DistributedKMeans::Cluster(): wrong number of initial "
+          << "cluster centroids (" << centroids.n_cols << ", should be "
+          << clusters << ")!" << std::endl;
+
+    if (centroids.n_rows != data.n_rows)
+      Log::Fatal << "DistributedKMeans::Cluster(): initial cluster centroids "
+          << "have wrong dimensionality (" << centroids.n_rows << ", should be "
+          << data.n_rows << ")!" << std::endl;
+  }
+  else if (GivesCentroids<InitialPartitionPolicy>::value)
+  {
+    // Only rank 0 computes the initial centroids, from its own shard.
+    arma::Row<size_t> assignments;
+    if (communicator.Rank() == 0)
+    {
+      GetInitialAssignmentsOrCentroids(partitioner, data, clusters,
+          assignments, centroids);
+    }
+    communicator.Broadcast(centroids);
+  }
+  else
+  {
+    // Each rank assigns its own points, and the centroids are computed from
+    // the assignments of all the shards.
+    arma::Row<size_t> assignments;
+    GetInitialAssignmentsOrCentroids(partitioner, data, clusters, assignments,
+        centroids);
+
+    arma::Col<size_t> counts(clusters, arma::fill::zeros);
+    centroids.zeros(data.n_rows, clusters);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      centroids.col(assignments[i]) += arma::vec(data.col(i));
+      counts[assignments[i]]++;
+    }
+
+    Reduce(centroids, counts);
+  }
+
+  // Counts of points in each cluster.
+  arma::Col<size_t> counts(clusters);
+
+  size_t iteration = 0;
+  size_t distanceCalculations = 0;
+
+  arma::mat newCentroids;
+  double cNorm;
+
+  // Print the progress at most once per second.
+  util::RateLimiter progress;
+
+  do
+  {
+    // The bounds of a step are only valid for the centroids it computes, so a
+    // new step is used for each iteration.
+    LloydStepType<MetricType, MatType> lloydStep(data, metric);
+    lloydStep.Iterate(centroids, newCentroids, counts);
+    distanceCalculations += lloydStep.DistanceCalculations();
+
+    // Turn the local centroids back into sums, and combine the shards.
+    for (size_t i = 0; i < counts.n_elem; ++i)
+      newCentroids.col(i) *= counts[i];
+    Reduce(newCentroids, counts);
+
+    // The same residual as the Lloyd step types, but with the global
+    // centroids.
+    cNorm = 0.0;
+    for (size_t i = 0; i < centroids.n_cols; ++i)
+    {
+      cNorm += std::pow(metric.Evaluate(centroids.col(i),
+          newCentroids.col(i)), 2.0);
+    }
+    cNorm = std::sqrt(cNorm);
+
+    // The empty clusters are handled by rank 0, and the result is sent to all
+    // the other ranks.
+    if (arma::any(counts == 0))
+    {
+      if (communicator.Rank() == 0)
+      {
+        for (size_t i = 0; i < counts.n_elem; i++)
+        {
+          if (counts[i] == 0)
+          {
+            Log::Info << "Cluster " << i << " is empty.\n";
+            emptyClusterAction.EmptyCluster(data, i, centroids, newCentroids,
+                counts, metric, iteration);
+          }
+        }
+      }
+
+      Broadcast(newCentroids, counts);
+    }
+
+    centroids.swap(newCentroids);
+
+    iteration++;
+    if (progress.Ready())
+    {
+      Log::Info << "DistributedKMeans::Cluster(): iteration " << iteration
+          << ", residual " << cNorm << ".\n";
+    }
+    if (std::isnan(cNorm) || std::isinf(cNorm))
+      cNorm = 1e-4; // Keep iterating.
+  } while (cNorm > 1e-5 && iteration != maxIterations);
+
+  if (iteration != maxIterations)
+  {
+    Log::Info << "DistributedKMeans::Cluster(): converged after " << iteration
+        << " iterations." << std::endl;
+  }
+  else
+  {
+    Log::Info << "DistributedKMeans::Cluster(): terminated after limit of "
+        << iteration << " iterations." << std::endl;
+  }
+  Log::Info << distanceCalculations << " distance calculations on rank "
+      << communicator.Rank() << "." << std::endl;
+}
+
+template<typename CommunicatorType,
+         typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<
+    CommunicatorType,
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+Cluster(const MatType& data,
+        const size_t clusters,
+        arma::Row<size_t>& assignments,
+        arma::mat& centroids,
+        const bool initialGuess)
+{
+  Cluster(data, clusters, centroids, initialGuess);
+
+  // Calculate the final assignments of the local shard in parallel.
+  assignments.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    // Find the closest centroid to this point.
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; j++)
+    {
+      const double distance = metric.Evaluate(data.col(i), centroids.col(j));
+
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+
+    assignments[i] = closestCluster;
+  }
+}
+
+template<typename CommunicatorType,
+         typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<
+    CommunicatorType,
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+Reduce(arma::mat& centroids, arma::Col<size_t>& counts) const
+{
+  // The sums and the counts are summed together, with the counts in the last
+  // row.
+  arma::mat sums = arma::join_cols(centroids,
+      arma::conv_to<arma::rowvec>::from(counts));
+  communicator.AllReduceSum(sums);
+
+  for (size_t i = 0; i < counts.n_elem; ++i)
+  {
+    counts[i] = (size_t) sums(centroids.n_rows, i);
+    if (counts[i] != 0)
+      centroids.col(i) = sums.submat(0, i, centroids.n_rows - 1, i) /
+          counts[i];
+    else
+      centroids.col(i).zeros();
+  }
+}
+
+template<typename CommunicatorType,
+         typename MetricType,
+         typename InitialPartitionPolicy,
+         typename EmptyClusterPolicy,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<
+    CommunicatorType,
+    MetricType,
+    InitialPartitionPolicy,
+    EmptyClusterPolicy,
+    LloydStepType,
+    MatType>::
+Broadcast(arma::mat& centroids, arma::Col<size_t>& counts) const
+{
+  // The empty cluster policy may remove clusters, so the size of the matrix is
+  // sent too.
+  arma::mat packed = arma::join_cols(centroids,
+      arma::conv_to<arma::rowvec>::from(counts));
+  communicator.Broadcast(packed);
+
+  centroids = packed.rows(0, packed.n_rows - 2);
+  counts = arma::conv_to<arma::Col<size_t>>::from(
+      packed.row(packed.n_rows - 1).t());
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -30,6 +30,13 @@ namespace kmeans {
  * dataset.  The conditions under which this will perform best are probably
  * limited to the case where k is close to the number of points in the dataset,
  * and the number of iterations of the k-means algorithm will be few.
+ *
+ * If OpenMP is available, the dual-tree traversal is split over subtrees of the
+ * tree built on the points, which are traversed in parallel, and the updates of
+ * the statistics of the tree are done with OpenMP tasks.  The tree built on the
+ * centroids is kept between iterations: if the tree type supports it (like
+ * BinarySpaceTree) and few centroids moved, only the nodes holding the
+ * centroids that moved are refit, instead of building a new tree.
  */
 template<
     typename MetricType,
@@ -50,6 +57,10 @@ class DualTreeKMeans
   using NNSTreeType =
       TreeType<TreeMetricType, DualTreeKMeansStatistic, TreeMatType>;
 
+  //! The nearest neighbor search on the centroids.
+  typedef neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType,
+      MatType, NNSTreeType> CentroidSearch;
+
   /**
    * Construct the DualTreeKMeans object, which will construct a tree on the
    * points.
@@ -97,12 +108,13 @@ class DualTreeKMeans
   arma::vec upperBounds;
   //! Lower bounds on second closest cluster distance for each point.
   arma::vec lowerBounds;
-  //! Indicator of whether or not the point is pruned.
-  std::vector<bool> prunedPoints;
+  //! Indicator of whether or not the point is pruned.  (This is not a
+  //! std::vector<bool>, so that threads may set different points at once.)
+  std::vector<char> prunedPoints;
 
   arma::Row<size_t> assignments;
 
-  std::vector<bool> visited; // Was the point visited this iteration?
+  std::vector<char> visited; // Was the point visited this iteration?
 
   arma::mat lastIterationCentroids; // For sanity checks.
 
@@ -110,6 +122,21 @@ class DualTreeKMeans
 
   arma::mat interclusterDistances; // Static storage for intercluster distances.
 
+  //! The search on the tree built on the centroids, kept between iterations.
+  CentroidSearch* centroidSearch;
+  //! Mappings from indices in the centroid tree to indices of centroids.
+  std::vector<size_t> oldFromNewCentroids;
+
+  //! Build or update the tree on the centroids for the given centroids.
+  void UpdateCentroidTree(const arma::mat& centroids);
+
+  //! Collect the subtrees of the given node that will be traversed in
+  //! parallel, which hold at most the given number of descendants, if they can
+  //! be split that far.  Statically pruned subtrees are skipped.
+  void CollectSubtrees(Tree& node,
+                       const size_t maxDescendants,
+                       std::vector<Tree*>& subtrees);
+
   //! Update the bounds in the tree before the next iteration.
   //! centroids is the current (not yet searched) centroids.
   void UpdateTree(Tree& node,
@@ -119,10 +146,11 @@ class DualTreeKMeans
                   const double parentLowerBound = DBL_MAX,
                   const double adjustedParentLowerBound = 0.0);
 
-  //! Extract the centroids of the clusters.
+  //! Extract the centroids of the clusters.  Each thread sums into the
+  //! elements of newCentroids and newCounts with its own index, ThreadNum().
   void ExtractCentroids(Tree& node,
-                        arma::mat& newCentroids,
-                        arma::Col<size_t>& newCounts,
+                        std::vector<arma::mat>& newCentroids,
+                        std::vector<arma::Col<size_t>>& newCounts,
                         const arma::mat& centroids);
 
   void CoalesceTree(Tree& node, const size_t child = 0);
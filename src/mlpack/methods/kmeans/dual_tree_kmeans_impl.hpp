@@ -20,9 +20,14 @@
 
 #include "dual_tree_kmeans_rules.hpp"
 
+#include <mlpack/core/util/sfinae_utility.hpp>
+
 namespace mlpack {
 namespace kmeans {
 
+//! This is used to tell whether a tree can refit the bounds of its nodes.
+HAS_MEM_FUNC(RefitBound, HasRefitBoundCheck);
+
 //! Call the tree constructor that does mapping.
 template<typename TreeType, typename MatType>
 TreeType* BuildTree(
@@ -47,6 +52,60 @@ TreeType* BuildTree(
   return new TreeType(std::forward<MatType>(dataset));
 }
 
+//! Refit the nodes holding any of the moved points, children first.
+//! movedBefore[i] is the number of moved points before index i of the dataset
+//! of the tree.
+template<typename TreeType>
+void RefitMovedNodes(TreeType& node, const std::vector<size_t>& movedBefore)
+{
+  if (movedBefore[node.Begin() + node.Count()] == movedBefore[node.Begin()])
+    return; // None of the points of this node moved.
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    RefitMovedNodes(node.Child(i), movedBefore);
+
+  node.RefitBound();
+}
+
+//! Copy the centroids that moved into the dataset of a tree that can be refit,
+//! and refit the nodes holding them.  movedBefore[i] is the number of moved
+//! centroids before index i of the dataset of the tree.
+template<typename TreeType>
+bool RefitCentroidTree(
+    TreeType& centroidTree,
+    const arma::mat& centroids,
+    const std::vector<size_t>& oldFromNewCentroids,
+    const std::vector<size_t>& movedBefore,
+    const typename std::enable_if<HasRefitBoundCheck<TreeType,
+        void(TreeType::*)()>::value>::type* = 0)
+{
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    if (movedBefore[i + 1] > movedBefore[i])
+    {
+      centroidTree.Dataset().col(i) = centroids.col(
+          (tree::TreeTraits<TreeType>::RearrangesDataset) ?
+          oldFromNewCentroids[i] : i);
+    }
+  }
+
+  RefitMovedNodes(centroidTree, movedBefore);
+  return true;
+}
+
+//! Trees that can't be refit are built again; this does nothing.
+template<typename TreeType>
+bool RefitCentroidTree(
+    TreeType& /* centroidTree */,
+    const arma::mat& /* centroids */,
+    const std::vector<size_t>& /* oldFromNewCentroids */,
+    const std::vector<size_t>& /* movedBefore */,
+    const typename std::enable_if<!HasRefitBoundCheck<TreeType,
+        void(TreeType::*)()>::value>::type* = 0)
+{
+  return false;
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -65,7 +124,8 @@ DualTreeKMeans<MetricType, MatType, TreeType>::DualTreeKMeans(
     lowerBounds(dataset.n_cols),
     prunedPoints(dataset.n_cols, false), // Fill with false.
     assignments(dataset.n_cols),
-    visited(dataset.n_cols, false) // Fill with false.
+    visited(dataset.n_cols, false), // Fill with false.
+    centroidSearch(NULL)
 {
   for (size_t i = 0; i < dataset.n_cols; ++i)
   {
@@ -86,6 +146,8 @@ DualTreeKMeans<MetricType, MatType, TreeType>::~DualTreeKMeans()
 {
   if (tree)
     delete tree;
+  if (centroidSearch)
+    delete centroidSearch;
 }
 
 // Run a single iteration.
@@ -99,16 +161,14 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
     arma::mat& newCentroids,
     arma::Col<size_t>& counts)
 {
-  // Build a tree on the centroids.  This will make a copy if necessary, which
-  // is unfortunate, but I don't see a reasonable way around it.
-  std::vector<size_t> oldFromNewCentroids;
-  Tree* centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
+  // Build a tree on the centroids, or update the one of the last iteration.
+  UpdateCentroidTree(centroids);
+  CentroidSearch& nns = *centroidSearch;
 
-  // Find the nearest neighbors of each of the clusters.  We have to make our
-  // own TreeType, which is a little bit abuse, but we know for sure the
-  // TreeStatType we have will work.
-  neighbor::NeighborSearch<neighbor::NearestNeighborSort, MetricType, MatType,
-      NNSTreeType> nns(std::move(*centroidTree));
+  // Below this number of points, the overhead of parallelism is not worth it.
+  const size_t parallelThreshold = 10000;
+  const bool parallel = (NumThreads() > 1) &&
+      (dataset.n_cols >= parallelThreshold);
 
   // Reset information in the tree, if we need to.
   if (iteration > 0)
@@ -136,10 +196,13 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
 
     Timer::Stop("knn");
 
-    UpdateTree(*tree, centroids);
+    #pragma omp parallel if(parallel)
+    {
+      #pragma omp single
+      UpdateTree(*tree, centroids);
+    }
 
-    for (size_t i = 0; i < dataset.n_cols; ++i)
-      visited[i] = false;
+    std::fill(visited.begin(), visited.end(), false);
   }
   else
   {
@@ -151,30 +214,72 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   // We won't use the KNN class here because we have our own set of rules.
   lastIterationCentroids = centroids;
   typedef DualTreeKMeansRules<MetricType, Tree> RuleType;
-  RuleType rules(nns.ReferenceTree().Dataset(), dataset, assignments,
-      upperBounds, lowerBounds, metric, prunedPoints, oldFromNewCentroids,
-      visited);
-
-  typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
-      traverser(rules);
 
   Timer::Start("tree_mod");
-  CoalesceTree(*tree);
+  #pragma omp parallel if(parallel)
+  {
+    #pragma omp single
+    CoalesceTree(*tree);
+  }
   Timer::Stop("tree_mod");
 
-  // Set the number of pruned centroids in the root to 0.
-  tree->Stat().Pruned() = 0;
-  traverser.Traverse(*tree, nns.ReferenceTree());
-  distanceCalculations += rules.BaseCases() + rules.Scores();
+  // The subtrees of the points hold disjoint sets of points, so they can be
+  // traversed at the same time, each with its own rules.  There are several
+  // subtrees per thread so that they can be balanced between the threads.
+  // Each subtree is traversed like the root: the number of pruned centroids
+  // starts at 0.
+  std::vector<Tree*> subtrees;
+  const size_t subtreeSize = parallel ? std::max((size_t) dataset.n_cols /
+      (16 * NumThreads()), parallelThreshold / 10) : (size_t) dataset.n_cols;
+  CollectSubtrees(*tree, subtreeSize, subtrees);
+  for (size_t i = 0; i < subtrees.size(); ++i)
+    subtrees[i]->Stat().Pruned() = 0;
+
+  size_t traversalDistances = 0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:traversalDistances) \
+      if(parallel)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    RuleType rules(nns.ReferenceTree().Dataset(), dataset, assignments,
+        upperBounds, lowerBounds, metric, prunedPoints, oldFromNewCentroids,
+        visited);
+
+    typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
+        traverser(rules);
+
+    traverser.Traverse(*subtrees[i], nns.ReferenceTree());
+    traversalDistances += rules.BaseCases() + rules.Scores();
+  }
+  distanceCalculations += traversalDistances;
 
   Timer::Start("tree_mod");
-  DecoalesceTree(*tree);
+  #pragma omp parallel if(parallel)
+  {
+    #pragma omp single
+    DecoalesceTree(*tree);
+  }
   Timer::Stop("tree_mod");
 
-  // Now we need to extract the clusters.
-  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
-  counts.zeros(centroids.n_cols);
-  ExtractCentroids(*tree, newCentroids, counts, centroids);
+  // Now we need to extract the clusters.  Each thread sums into its own
+  // matrices, which are added up afterwards.
+  const size_t numSums = parallel ? NumThreads() : 1;
+  std::vector<arma::mat> threadCentroids(numSums,
+      arma::mat(centroids.n_rows, centroids.n_cols, arma::fill::zeros));
+  std::vector<arma::Col<size_t>> threadCounts(numSums,
+      arma::Col<size_t>(centroids.n_cols, arma::fill::zeros));
+  #pragma omp parallel if(parallel)
+  {
+    #pragma omp single
+    ExtractCentroids(*tree, threadCentroids, threadCounts, centroids);
+  }
+
+  newCentroids = std::move(threadCentroids[0]);
+  counts = std::move(threadCounts[0]);
+  for (size_t t = 1; t < numSums; ++t)
+  {
+    newCentroids += threadCentroids[t];
+    counts += threadCounts[t];
+  }
 
   // Now, calculate how far the clusters moved, after normalizing them.
   double residual = 0.0;
@@ -199,13 +304,83 @@ double DualTreeKMeans<MetricType, MatType, TreeType>::Iterate(
   }
   distanceCalculations += centroids.n_cols;
 
-  delete centroidTree;
-
   ++iteration;
 
   return std::sqrt(residual);
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DualTreeKMeans<MetricType, MatType, TreeType>::UpdateCentroidTree(
+    const arma::mat& centroids)
+{
+  if (centroidSearch != NULL &&
+      centroidSearch->ReferenceSet().n_cols == centroids.n_cols)
+  {
+    // Find the centroids that moved (most of them do not, near convergence).
+    const MatType& treeCentroids = centroidSearch->ReferenceSet();
+    std::vector<size_t> movedBefore(centroids.n_cols + 1, 0);
+    for (size_t i = 0; i < centroids.n_cols; ++i)
+    {
+      const size_t c = (tree::TreeTraits<Tree>::RearrangesDataset) ?
+          oldFromNewCentroids[i] : i;
+      const bool moved = arma::any(treeCentroids.col(i) != centroids.col(c));
+      movedBefore[i + 1] = movedBefore[i] + (moved ? 1 : 0);
+    }
+
+    // If few centroids moved, refit the nodes that hold them, if the tree
+    // allows it.  Otherwise, a new tree will be tighter than a refit one.
+    const size_t numMoved = movedBefore[centroids.n_cols];
+    if (numMoved == 0)
+      return;
+    if (4 * numMoved <= centroids.n_cols &&
+        RefitCentroidTree(centroidSearch->ReferenceTree(), centroids,
+            oldFromNewCentroids, movedBefore))
+      return;
+  }
+
+  // Build a tree on the centroids.  This will make a copy if necessary, which
+  // is unfortunate, but I don't see a reasonable way around it.
+  oldFromNewCentroids.clear();
+  Tree* centroidTree = BuildTree<Tree>(centroids, oldFromNewCentroids);
+
+  // Find the nearest neighbors of each of the clusters.  We have to make our
+  // own TreeType, which is a little bit abuse, but we know for sure the
+  // TreeStatType we have will work.
+  delete centroidSearch;
+  centroidSearch = new CentroidSearch(std::move(*centroidTree));
+  delete centroidTree;
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DualTreeKMeans<MetricType, MatType, TreeType>::CollectSubtrees(
+    Tree& node,
+    const size_t maxDescendants,
+    std::vector<Tree*>& subtrees)
+{
+  // No points of a statically pruned node will be visited.
+  if (node.Stat().StaticPruned())
+    return;
+
+  // A node can only be left out if its children hold all of its points.
+  if (node.NumDescendants() <= maxDescendants || node.NumChildren() == 0 ||
+      (node.NumPoints() > 0 && !tree::TreeTraits<Tree>::HasSelfChildren))
+  {
+    subtrees.push_back(&node);
+    return;
+  }
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    CollectSubtrees(node.Child(i), maxDescendants, subtrees);
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -328,6 +503,7 @@ visited[node.Descendant(i)] << ".\n";
                    node.MaxDistance(centroids.col(node.Stat().Owner())));
       adjustedUpperBound = node.Stat().UpperBound();
 
+      #pragma omp atomic
       ++distanceCalculations;
       if (node.Stat().UpperBound() < node.Stat().LowerBound())
         node.Stat().StaticPruned() = true;
@@ -339,12 +515,21 @@ visited[node.Descendant(i)] << ".\n";
   }
 
   // Recurse into children, and if all the children (and all the points) are
-  // pruned, then we can mark this as statically pruned.
-  bool allChildrenPruned = true;
+  // pruned, then we can mark this as statically pruned.  The children hold
+  // disjoint sets of points, so large ones are updated in parallel.
+  const size_t parallelThreshold = 10000;
   for (size_t i = 0; i < node.NumChildren(); ++i)
   {
+    #pragma omp task default(shared) firstprivate(i) \
+        if(node.Child(i).NumDescendants() >= parallelThreshold)
     UpdateTree(node.Child(i), centroids, unadjustedUpperBound,
         adjustedUpperBound, unadjustedLowerBound, adjustedLowerBound);
+  }
+  #pragma omp taskwait
+
+  bool allChildrenPruned = true;
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
     if (!node.Child(i).Stat().StaticPruned())
       allChildrenPruned = false;
   }
@@ -363,6 +548,7 @@ visited[node.Descendant(i)] << ".\n";
   else if (!node.Stat().StaticPruned())
   {
     // Try to prune individual points.
+    size_t pointDistances = 0;
     for (size_t i = 0; i < node.NumPoints(); ++i)
     {
       const size_t index = node.Point(i);
@@ -400,7 +586,7 @@ visited[node.Descendant(i)] << ".\n";
         // Attempt to tighten the bound.
         upperBounds[index] = metric.Evaluate(dataset.col(index),
                                              centroids.col(owner));
-        ++distanceCalculations;
+        ++pointDistances;
         if (upperBounds[index] < pruningLowerBound)
         {
           prunedPoints[index] = true;
@@ -422,6 +608,9 @@ visited[node.Descendant(i)] << ".\n";
         }
       }
     }
+
+    #pragma omp atomic
+    distanceCalculations += pointDistances;
   }
 
 /*
@@ -478,17 +667,22 @@ template<typename MetricType,
                   typename TreeMatType> class TreeType>
 void DualTreeKMeans<MetricType, MatType, TreeType>::ExtractCentroids(
     Tree& node,
-    arma::mat& newCentroids,
-    arma::Col<size_t>& newCounts,
+    std::vector<arma::mat>& newCentroids,
+    std::vector<arma::Col<size_t>>& newCounts,
     const arma::mat& centroids)
 {
+  // This is the thread running the task, so no other thread uses these sums.
+  arma::mat& threadCentroids = newCentroids[ThreadNum()];
+  arma::Col<size_t>& threadCounts = newCounts[ThreadNum()];
+
   // Does this node own points?
-  if ((node.Stat().Pruned() == newCentroids.n_cols) ||
-      (node.Stat().StaticPruned() && node.Stat().Owner() < newCentroids.n_cols))
+  if ((node.Stat().Pruned() == centroids.n_cols) ||
+      (node.Stat().StaticPruned() && node.Stat().Owner() < centroids.n_cols))
   {
     const size_t owner = node.Stat().Owner();
-    newCentroids.col(owner) += node.Stat().Centroid() * node.NumDescendants();
-    newCounts[owner] += node.NumDescendants();
+    threadCentroids.col(owner) += node.Stat().Centroid() *
+        node.NumDescendants();
+    threadCounts[owner] += node.NumDescendants();
 
     // Perform the sanity check here.
 /*
@@ -526,8 +720,8 @@ node.Stat().UpperBound() << " and owner " << node.Stat().Owner() << ".\n";
       for (size_t i = 0; i < node.NumPoints(); ++i)
       {
         const size_t owner = assignments[node.Point(i)];
-        newCentroids.col(owner) += dataset.col(node.Point(i));
-        ++newCounts[owner];
+        threadCentroids.col(owner) += dataset.col(node.Point(i));
+        ++threadCounts[owner];
 
 /*
         const size_t index = node.Point(i);
@@ -558,9 +752,16 @@ assignments[node.Point(i)] << " with ub " << upperBounds[node.Point(i)] <<
       }
     }
 
-    // The node is not entirely owned by a cluster.  Recurse.
+    // The node is not entirely owned by a cluster.  Recurse, in parallel for
+    // large children.
+    const size_t parallelThreshold = 10000;
     for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      #pragma omp task default(shared) firstprivate(i) \
+          if(node.Child(i).NumDescendants() >= parallelThreshold)
       ExtractCentroids(node.Child(i), newCentroids, newCounts, centroids);
+    }
+    #pragma omp taskwait
   }
 }
 
@@ -577,22 +778,37 @@ void DualTreeKMeans<MetricType, MatType, TreeType>::CoalesceTree(
   if (node.NumChildren() == 0)
     return; // We can't do anything.
 
+  // Large children are coalesced in parallel.  Each child only changes its
+  // own slot in our list of children.
+  const size_t parallelThreshold = 10000;
+
   // If this is the root node, we can't coalesce.
   if (node.Parent() != NULL)
   {
     // First, we should coalesce those nodes that aren't statically pruned.
+    // This has to happen before any children are hidden, because hiding a
+    // child moves the children after it.
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      if (!node.Child(i).Stat().StaticPruned())
+      {
+        #pragma omp task default(shared) firstprivate(i) \
+            if(node.Child(i).NumDescendants() >= parallelThreshold)
+        CoalesceTree(node.Child(i), i);
+      }
+    }
+    #pragma omp taskwait
+
+    // Now hide the statically pruned children, from the last one, so that the
+    // indices of the ones we have not looked at yet don't change.
     for (size_t i = node.NumChildren() - 1; i > 0; --i)
     {
       if (node.Child(i).Stat().StaticPruned())
         HideChild(node, i);
-      else
-        CoalesceTree(node.Child(i), i);
     }
 
     if (node.Child(0).Stat().StaticPruned())
       HideChild(node, 0);
-    else
-      CoalesceTree(node.Child(0), 0);
 
     // If we've pruned all but one child, then notPrunedIndex will contain the
     // index of that child, and we can coalesce this node entirely.  Note that
@@ -609,7 +825,12 @@ void DualTreeKMeans<MetricType, MatType, TreeType>::CoalesceTree(
     // We can't coalesce the root, so call the children individually and
     // coalesce them.
     for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      #pragma omp task default(shared) firstprivate(i) \
+          if(node.Child(i).NumDescendants() >= parallelThreshold)
       CoalesceTree(node.Child(i), i);
+    }
+    #pragma omp taskwait
   }
 }
 
@@ -623,8 +844,16 @@ void DualTreeKMeans<MetricType, MatType, TreeType>::DecoalesceTree(Tree& node)
   node.Parent() = (Tree*) node.Stat().TrueParent();
   RestoreChildren(node);
 
+  // Each node only restores its own pointers, so large subtrees are restored
+  // in parallel.
+  const size_t parallelThreshold = 10000;
   for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    #pragma omp task default(shared) firstprivate(i) \
+        if(node.Child(i).NumDescendants() >= parallelThreshold)
     DecoalesceTree(node.Child(i));
+  }
+  #pragma omp taskwait
 }
 
 //! Utility function for hiding children in a non-binary tree.
@@ -12,6 +12,8 @@
 #ifndef MLPACK_METHODS_KMEANS_ELKAN_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_ELKAN_KMEANS_HPP
 
+#include <mlpack/prereqs.hpp>
+
 namespace mlpack {
 namespace kmeans {
 
@@ -34,10 +34,6 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
                                                  arma::mat& newCentroids,
                                                  arma::Col<size_t>& counts)
 {
-  // Clear new centroids.
-  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
-  counts.zeros(centroids.n_cols);
-
   // At the beginning of the iteration, we must compute the distances between
   // all centers.  This is O(k^2).
   clusterDistances.set_size(centroids.n_cols, centroids.n_cols);
@@ -46,10 +42,9 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // being the closest cluster centroid.
   clusterDistances.diag().fill(DBL_MAX);
 
-  // Initially set r(x) to true.
-  std::vector<bool> mustRecalculate(dataset.n_cols, true);
-
-  // If this is the first iteration, we must reset all the bounds.
+  // If this is the first iteration, we must reset all the bounds.  The lower
+  // bounds of each point are stored in one column, so that each point only
+  // touches its own contiguous memory.
   if (lowerBounds.n_rows != centroids.n_cols)
   {
     lowerBounds.set_size(centroids.n_cols, dataset.n_cols);
@@ -63,13 +58,15 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
 
   // Step 1: for all centers, compute between-cluster distances.  For all
   // centers, compute s(c) = 1/2 min d(c, c').
-  for (size_t i = 0; i < centroids.n_cols; ++i)
+  size_t iterationDistances = 0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:iterationDistances)
+  for (omp_size_t i = 0; i < (omp_size_t) centroids.n_cols; ++i)
   {
     for (size_t j = i + 1; j < centroids.n_cols; ++j)
     {
       const double distance = metric.Evaluate(centroids.col(i),
                                               centroids.col(j));
-      distanceCalculations++;
+      iterationDistances++;
       clusterDistances(i, j) = distance;
       clusterDistances(j, i) = distance;
     }
@@ -79,19 +76,37 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   // that this is equivalent to s(c) for each cluster c.
   minClusterDistances = 0.5 * arma::min(clusterDistances).t();
 
-  // Now loop over all points, and see which ones need to be updated.
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  // Now loop over all points, and see which ones need to be updated.  The
+  // points are split into one contiguous block per thread, and each block sums
+  // the points of each cluster separately; the sums are merged afterwards.
+  const size_t numBlocks = std::max((size_t) 1,
+      std::min(NumThreads(), (size_t) dataset.n_cols));
+  std::vector<arma::mat> blockCentroids(numBlocks);
+  std::vector<arma::Col<size_t>> blockCounts(numBlocks);
+
+  #pragma omp parallel for reduction(+:iterationDistances)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    // Step 2: identify all points such that u(x) <= s(c(x)).
-    if (upperBounds(i) <= minClusterDistances(assignments[i]))
-    {
-      // No change needed.  This point must still belong to that cluster.
-      counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-      continue;
-    }
-    else
+    arma::mat& localCentroids = blockCentroids[b];
+    arma::Col<size_t>& localCounts = blockCounts[b];
+    localCentroids.zeros(centroids.n_rows, centroids.n_cols);
+    localCounts.zeros(centroids.n_cols);
+
+    const size_t begin = b * dataset.n_cols / numBlocks;
+    const size_t end = (b + 1) * dataset.n_cols / numBlocks;
+    for (size_t i = begin; i < end; ++i)
     {
+      // Step 2: identify all points such that u(x) <= s(c(x)).
+      if (upperBounds(i) <= minClusterDistances(assignments[i]))
+      {
+        // No change needed.  This point must still belong to that cluster.
+        localCounts(assignments[i])++;
+        localCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+        continue;
+      }
+
+      // Initially set r(x) to true.
+      bool mustRecalculate = true;
       for (size_t c = 0; c < centroids.n_cols; ++c)
       {
         // Step 3: for all remaining points x and centers c such that c != c(x),
@@ -108,13 +123,13 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
         // Step 3a: if r(x) then compute d(x, c(x)) and assign r(x) = false.
         // Otherwise, d(x, c(x)) = u(x).
         double dist;
-        if (mustRecalculate[i])
+        if (mustRecalculate)
         {
-          mustRecalculate[i] = false;
+          mustRecalculate = false;
           dist = metric.Evaluate(dataset.col(i), centroids.col(assignments[i]));
           lowerBounds(assignments[i], i) = dist;
           upperBounds(i) = dist;
-          distanceCalculations++;
+          iterationDistances++;
 
           // Check if we can prune again.
           if (upperBounds(i) <= lowerBounds(c, i))
@@ -136,7 +151,7 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
           const double pointDist = metric.Evaluate(dataset.col(i),
                                                    centroids.col(c));
           lowerBounds(c, i) = pointDist;
-          distanceCalculations++;
+          iterationDistances++;
           if (pointDist < dist)
           {
             upperBounds(i) = pointDist;
@@ -144,13 +159,28 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
           }
         }
       }
+
+      // At this point, we know the new cluster assignment.
+      // Step 4: for each center c, let m(c) be the mean of the points assigned
+      // to c.
+      localCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+      localCounts[assignments[i]]++;
     }
+  }
 
-    // At this point, we know the new cluster assignment.
-    // Step 4: for each center c, let m(c) be the mean of the points assigned to
-    // c.
-    newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
-    counts[assignments[i]]++;
+  // Merge the sums of the blocks, one cluster at a time.
+  newCentroids.set_size(centroids.n_rows, centroids.n_cols);
+  counts.set_size(centroids.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) centroids.n_cols; ++c)
+  {
+    newCentroids.col(c) = blockCentroids[0].col(c);
+    counts[c] = blockCounts[0][c];
+    for (size_t b = 1; b < numBlocks; ++b)
+    {
+      newCentroids.col(c) += blockCentroids[b].col(c);
+      counts[c] += blockCounts[b][c];
+    }
   }
 
   // Now, normalize and calculate the distance each cluster has moved.
@@ -163,16 +193,16 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
 
     moveDistances(c) = metric.Evaluate(newCentroids.col(c), centroids.col(c));
     cNorm += std::pow(moveDistances(c), 2.0);
-    distanceCalculations++;
+    iterationDistances++;
   }
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
     // Step 5: for each point x and center c, assign
     //   l(x, c) = max { l(x, c) - d(c, m(c)), 0 }.
     // But it doesn't actually matter if l(x, c) is positive.
-    for (size_t c = 0; c < centroids.n_cols; ++c)
-      lowerBounds(c, i) -= moveDistances(c);
+    lowerBounds.unsafe_col(i) -= moveDistances;
 
     // Step 6: for each point x, assign
     //   u(x) = u(x) + d(m(c(x)), c(x))
@@ -180,6 +210,8 @@ double ElkanKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
     upperBounds(i) += moveDistances(assignments[i]);
   }
 
+  distanceCalculations += iterationDistances;
+
   return std::sqrt(cNorm);
 }
 
@@ -12,6 +12,8 @@
 #ifndef MLPACK_METHODS_KMEANS_HAMERLY_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_HAMERLY_KMEANS_HPP
 
+#include <mlpack/prereqs.hpp>
+
 namespace mlpack {
 namespace kmeans {
 
@@ -48,10 +50,9 @@ class HamerlyKMeans
   //! Minimum cluster distances from each cluster.
   arma::vec minClusterDistances;
 
-  //! Upper bounds for each point.
-  arma::vec upperBounds;
-  //! Lower bounds for each point.
-  arma::vec lowerBounds;
+  //! Upper (row 0) and lower (row 1) bounds for each point, stored next to
+  //! each other because they are always used together.
+  arma::mat bounds;
   //! Assignments for each point.
   arma::Col<size_t> assignments;
 
@@ -34,96 +34,128 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
                                                    arma::Col<size_t>& counts)
 {
   size_t hamerlyPruned = 0;
+  size_t iterationDistances = 0;
 
   // If this is the first iteration, we need to set all the bounds.
   if (minClusterDistances.n_elem != centroids.n_cols)
   {
-    upperBounds.set_size(dataset.n_cols);
-    upperBounds.fill(DBL_MAX);
-    lowerBounds.zeros(dataset.n_cols);
+    bounds.set_size(2, dataset.n_cols);
+    bounds.row(0).fill(DBL_MAX);
+    bounds.row(1).zeros();
     assignments.zeros(dataset.n_cols);
     minClusterDistances.set_size(centroids.n_cols);
   }
 
-  // Reset new centroids.
-  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
-  counts.zeros(centroids.n_cols);
-
   // Calculate minimum intra-cluster distance for each cluster.
-  minClusterDistances.fill(DBL_MAX);
-  for (size_t i = 0; i < centroids.n_cols; ++i)
+  arma::mat clusterDistances(centroids.n_cols, centroids.n_cols);
+  clusterDistances.diag().fill(DBL_MAX);
+  #pragma omp parallel for schedule(dynamic) reduction(+:iterationDistances)
+  for (omp_size_t i = 0; i < (omp_size_t) centroids.n_cols; ++i)
   {
     for (size_t j = i + 1; j < centroids.n_cols; ++j)
     {
       const double dist = metric.Evaluate(centroids.col(i), centroids.col(j)) /
           2.0;
-      ++distanceCalculations;
-
-      // Update bounds, if this intra-cluster distance is smaller.
-      if (dist < minClusterDistances(i))
-        minClusterDistances(i) = dist;
-      if (dist < minClusterDistances(j))
-        minClusterDistances(j) = dist;
+      ++iterationDistances;
+      clusterDistances(i, j) = dist;
+      clusterDistances(j, i) = dist;
     }
   }
-
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  minClusterDistances = arma::min(clusterDistances).t();
+
+  // The points are split into one contiguous block per thread, and each block
+  // sums the points of each cluster separately; the sums are merged
+  // afterwards.
+  const size_t numBlocks = std::max((size_t) 1,
+      std::min(NumThreads(), (size_t) dataset.n_cols));
+  std::vector<arma::mat> blockCentroids(numBlocks);
+  std::vector<arma::Col<size_t>> blockCounts(numBlocks);
+
+  #pragma omp parallel for reduction(+:iterationDistances, hamerlyPruned)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    const double m = std::max(minClusterDistances(assignments[i]),
-                              lowerBounds(i));
-
-    // First bound test.
-    if (upperBounds(i) <= m)
-    {
-      ++hamerlyPruned;
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
-      continue;
-    }
-
-    // Tighten upper bound.
-    upperBounds(i) = metric.Evaluate(dataset.col(i),
-                                     centroids.col(assignments[i]));
-    ++distanceCalculations;
-
-    // Second bound test.
-    if (upperBounds(i) <= m)
+    arma::mat& localCentroids = blockCentroids[b];
+    arma::Col<size_t>& localCounts = blockCounts[b];
+    localCentroids.zeros(centroids.n_rows, centroids.n_cols);
+    localCounts.zeros(centroids.n_cols);
+
+    const size_t begin = b * dataset.n_cols / numBlocks;
+    const size_t end = (b + 1) * dataset.n_cols / numBlocks;
+    for (size_t i = begin; i < end; ++i)
     {
-      newCentroids.col(assignments[i]) += dataset.col(i);
-      ++counts(assignments[i]);
-      continue;
-    }
+      double& upperBound = bounds(0, i);
+      double& lowerBound = bounds(1, i);
+      const double m = std::max(minClusterDistances(assignments[i]),
+                                lowerBound);
 
-    // The bounds failed.  So test against all other clusters.
-    // This is Hamerly's Point-All-Ctrs() function from the paper.
-    // We have to reset the lower bound first.
-    lowerBounds(i) = DBL_MAX;
-    for (size_t c = 0; c < centroids.n_cols; ++c)
-    {
-      if (c == assignments[i])
+      // First bound test.
+      if (upperBound <= m)
+      {
+        ++hamerlyPruned;
+        localCentroids.col(assignments[i]) += dataset.col(i);
+        ++localCounts(assignments[i]);
         continue;
+      }
 
-      const double dist = metric.Evaluate(dataset.col(i), centroids.col(c));
+      // Tighten upper bound.
+      upperBound = metric.Evaluate(dataset.col(i),
+                                   centroids.col(assignments[i]));
+      ++iterationDistances;
 
-      // Is this a better cluster?  At this point, upperBounds[i] = d(i, c(i)).
-      if (dist < upperBounds(i))
+      // Second bound test.
+      if (upperBound <= m)
       {
-        // lowerBounds holds the second closest cluster.
-        lowerBounds(i) = upperBounds(i);
-        upperBounds(i) = dist;
-        assignments[i] = c;
+        localCentroids.col(assignments[i]) += dataset.col(i);
+        ++localCounts(assignments[i]);
+        continue;
       }
-      else if (dist < lowerBounds(i))
+
+      // The bounds failed.  So test against all other clusters.
+      // This is Hamerly's Point-All-Ctrs() function from the paper.
+      // We have to reset the lower bound first.
+      lowerBound = DBL_MAX;
+      for (size_t c = 0; c < centroids.n_cols; ++c)
       {
-        // This is a closer second-closest cluster.
-        lowerBounds(i) = dist;
+        if (c == assignments[i])
+          continue;
+
+        const double dist = metric.Evaluate(dataset.col(i), centroids.col(c));
+
+        // Is this a better cluster?  At this point, upperBound = d(i, c(i)).
+        if (dist < upperBound)
+        {
+          // lowerBound holds the second closest cluster.
+          lowerBound = upperBound;
+          upperBound = dist;
+          assignments[i] = c;
+        }
+        else if (dist < lowerBound)
+        {
+          // This is a closer second-closest cluster.
+          lowerBound = dist;
+        }
       }
+      iterationDistances += centroids.n_cols - 1;
+
+      // Update new centroids.
+      localCentroids.col(assignments[i]) += dataset.col(i);
+      ++localCounts(assignments[i]);
     }
-    distanceCalculations += centroids.n_cols - 1;
+  }
 
-    // Update new centroids.
-    newCentroids.col(assignments[i]) += dataset.col(i);
-    ++counts(assignments[i]);
+  // Merge the sums of the blocks, one cluster at a time.
+  newCentroids.set_size(centroids.n_rows, centroids.n_cols);
+  counts.set_size(centroids.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) centroids.n_cols; ++c)
+  {
+    newCentroids.col(c) = blockCentroids[0].col(c);
+    counts[c] = blockCounts[0][c];
+    for (size_t b = 1; b < numBlocks; ++b)
+    {
+      newCentroids.col(c) += blockCentroids[b].col(c);
+      counts[c] += blockCounts[b][c];
+    }
   }
 
   // Normalize centroids and calculate cluster movement (contains parts of
@@ -143,7 +175,7 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
                                             newCentroids.col(c));
     centroidMovements(c) = movement;
     centroidMovement += std::pow(movement, 2.0);
-    ++distanceCalculations;
+    ++iterationDistances;
 
     if (movement > furthestMovement)
     {
@@ -158,15 +190,17 @@ double HamerlyKMeans<MetricType, MatType>::Iterate(const arma::mat& centroids,
   }
 
   // Now update bounds (lines 3-8 of Update-Bounds()).
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
   {
-    upperBounds(i) += centroidMovements(assignments[i]);
+    bounds(0, i) += centroidMovements(assignments[i]);
     if (assignments[i] == furthestMovingCluster)
-      lowerBounds(i) -= secondFurthestMovement;
+      bounds(1, i) -= secondFurthestMovement;
     else
-      lowerBounds(i) -= furthestMovement;
+      bounds(1, i) -= furthestMovement;
   }
 
+  distanceCalculations += iterationDistances;
   Log::Info << "Hamerly prunes: " << hamerlyPruned << ".\n";
 
   return std::sqrt(centroidMovement);
@@ -211,6 +211,9 @@ Cluster(const MatType& data,
   arma::mat centroidsOther;
   double cNorm;
 
+  // Print the progress at most once per second.
+  util::RateLimiter progress;
+
   do
   {
     // We have two centroid matrices.  We don't want to copy anything, so,
@@ -237,8 +240,11 @@ Cluster(const MatType& data,
     }
 
     iteration++;
-    Log::Info << "KMeans::Cluster(): iteration " << iteration << ", residual "
-        << cNorm << ".\n";
+    if (progress.Ready())
+    {
+      Log::Info << "KMeans::Cluster(): iteration " << iteration << ", residual "
+          << cNorm << ".\n";
+    }
     if (std::isnan(cNorm) || std::isinf(cNorm))
       cNorm = 1e-4; // Keep iterating.
   } while (cNorm > 1e-5 && iteration != maxIterations);
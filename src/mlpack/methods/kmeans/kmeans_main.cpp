@@ -17,10 +17,12 @@
 #include "allow_empty_clusters.hpp"
 #include "kill_empty_clusters.hpp"
 #include "refined_start.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
 
 using namespace mlpack;
 using namespace mlpack::kmeans;
@@ -49,6 +51,15 @@ PROGRAM_INFO("K-Means Clustering",
     "used in each sample, the " + PRINT_PARAM_STRING("percentage") +
     " parameter is used (it should be a value between 0.0 and 1.0)."
     "\n\n"
+    "Alternately, the k-means|| approach (\"Scalable k-means++\", 2012) can be "
+    "used to select initial points by specifying the " +
+    PRINT_PARAM_STRING("kmeans_parallel") + " parameter.  This picks initial "
+    "points spread out like those of k-means++ in a few passes over the "
+    "dataset; the number of passes is given by the " +
+    PRINT_PARAM_STRING("rounds") + " parameter, and the number of candidate "
+    "points picked in each pass, as a multiple of the number of clusters, is "
+    "given by the " + PRINT_PARAM_STRING("oversampling") + " parameter."
+    "\n\n"
     "There are several options available for the algorithm used for each Lloyd "
     "iteration, specified with the " + PRINT_PARAM_STRING("algorithm") + " "
     " option.  The standard O(kN) approach can be used ('naive').  Other "
@@ -56,7 +67,11 @@ PROGRAM_INFO("K-Means Clustering",
     "Elkan's triangle-inequality based algorithm ('elkan'), Hamerly's "
     "modification to Elkan's algorithm ('hamerly'), the dual-tree k-means "
     "algorithm ('dualtree'), and the dual-tree k-means algorithm using the "
-    "cover tree ('dualtree-covertree')."
+    "cover tree ('dualtree-covertree').  For very large datasets, the "
+    "mini-batch algorithm ('minibatch') only uses a random sample of the "
+    "points in each iteration, whose size is given by the " +
+    PRINT_PARAM_STRING("batch_size") + " parameter; this gives an approximate "
+    "clustering much faster."
     "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the " + PRINT_PARAM_STRING("allow_empty_clusters") + " option.  When "
@@ -140,9 +155,20 @@ PARAM_INT_IN("samplings", "Number of samplings to perform for refined start "
 PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
     "start sampling (use when --refined_start is specified).", "p", 0.02);
 
+// Parameters for k-means|| initialization.
+PARAM_FLAG("kmeans_parallel", "Use the k-means|| initial point strategy to "
+    "choose initial points.", "K");
+PARAM_INT_IN("rounds", "Number of sampling passes over the dataset for "
+    "k-means|| (use when --kmeans_parallel is specified).", "R", 5);
+PARAM_DOUBLE_IN("oversampling", "Number of candidate points picked in each "
+    "k-means|| pass, as a multiple of the number of clusters (use when "
+    "--kmeans_parallel is specified).", "O", 2.0);
+
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
-    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
-    "'dualtree-covertree').", "a", "naive");
+    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', "
+    "'dualtree-covertree', or 'minibatch').", "a", "naive");
+PARAM_INT_IN("batch_size", "Number of points sampled in each iteration of the "
+    "'minibatch' algorithm.", "b", 1000);
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -171,6 +197,9 @@ static void mlpackMain()
   // Now, start building the KMeans type that we'll be using.  Start with the
   // initial partition policy.  The call to FindEmptyClusterPolicy<> results in
   // a call to RunKMeans<> and the algorithm is completed.
+  if (CLI::HasParam("refined_start") || CLI::HasParam("kmeans_parallel"))
+    RequireOnlyOnePassed({ "refined_start", "kmeans_parallel" }, true);
+
   if (CLI::HasParam("refined_start"))
   {
     RequireParamValue<int>("samplings", [](int x) { return x > 0; }, true,
@@ -183,6 +212,17 @@ static void mlpackMain()
 
     FindEmptyClusterPolicy<RefinedStart>(RefinedStart(samplings, percentage));
   }
+  else if (CLI::HasParam("kmeans_parallel"))
+  {
+    RequireParamValue<int>("rounds", [](int x) { return x >= 0; }, true,
+        "number of rounds must be non-negative");
+    RequireParamValue<double>("oversampling", [](double x) { return x > 0.0; },
+        true, "oversampling factor must be positive");
+
+    FindEmptyClusterPolicy<KMeansParallelInitialization>(
+        KMeansParallelInitialization(CLI::GetParam<double>("oversampling"),
+        (size_t) CLI::GetParam<int>("rounds")));
+  }
   else
   {
     FindEmptyClusterPolicy<SampleInitialization>(SampleInitialization());
@@ -213,8 +253,8 @@ template<typename InitialPartitionPolicy, typename EmptyClusterPolicy>
 void FindLloydStepType(const InitialPartitionPolicy& ipp)
 {
   RequireParamInSet<string>("algorithm", { "elkan", "hamerly", "pelleg-moore",
-      "dualtree", "dualtree-covertree", "naive" }, true, "unknown k-means "
-      "algorithm");
+      "dualtree", "dualtree-covertree", "naive", "minibatch" }, true,
+      "unknown k-means algorithm");
 
   const string algorithm = CLI::GetParam<string>("algorithm");
   if (algorithm == "elkan")
@@ -232,6 +272,15 @@ void FindLloydStepType(const InitialPartitionPolicy& ipp)
         CoverTreeDualTreeKMeans>(ipp);
   else if (algorithm == "naive")
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, NaiveKMeans>(ipp);
+  else if (algorithm == "minibatch")
+  {
+    RequireParamValue<int>("batch_size", [](int x) { return x > 0; }, true,
+        "batch size must be positive");
+    typedef MiniBatchKMeans<metric::EuclideanDistance, arma::mat> StepType;
+    StepType::DefaultBatchSize() = (size_t) CLI::GetParam<int>("batch_size");
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
+        MiniBatchKMeans>(ipp);
+  }
 }
 
 // Given the template parameters, sanitize/load input and run k-means.
@@ -278,8 +327,9 @@ void RunKMeans(const InitialPartitionPolicy& ipp)
       clusters = centroids.n_cols;
 
     ReportIgnoredParam({{ "refined_start", true }}, "initial_centroids");
+    ReportIgnoredParam({{ "kmeans_parallel", true }}, "initial_centroids");
 
-    if (!CLI::HasParam("refined_start"))
+    if (!CLI::HasParam("refined_start") && !CLI::HasParam("kmeans_parallel"))
       Log::Info << "Using initial centroid guesses." << endl;
   }
 
@@ -0,0 +1,125 @@
+/**
+ * @file kmeans_parallel_initialization.hpp
+ *
+ * The k-means|| ("scalable k-means++") initialization strategy for k-means,
+ * which chooses initial centroids spread out like those of k-means++, but with
+ * a few passes over the data instead of k.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * An InitialPartitionPolicy for KMeans that implements the k-means||
+ * initialization of Bahmani et al.:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, B. and Moseley, B. and Vattani, A. and Kumar, R. and
+ *       Vassilvitskii, S.},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ *
+ * k-means++ picks the k initial centroids one at a time, which takes k passes
+ * over the data.  k-means|| instead starts from one random point and then, in
+ * each of a few rounds, samples every point independently with probability
+ * proportional to its squared distance to the closest candidate picked so far,
+ * so that about l = oversampling * k new candidates are picked per round.  Each
+ * round is one parallel pass over the data.  The candidates are then weighted
+ * by the number of points closest to them, and k-means++ on the weighted
+ * candidates picks the k initial centroids.
+ *
+ * Like RefinedStart, this uses the Euclidean distance, whatever the metric of
+ * KMeans is.
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the KMeansParallelInitialization object, optionally specifying the
+   * oversampling factor and the number of rounds.
+   *
+   * @param oversampling Expected number of candidates picked in each round,
+   *     as a multiple of the number of clusters.
+   * @param rounds Number of sampling rounds.
+   */
+  KMeansParallelInitialization(const double oversampling = 2.0,
+                               const size_t rounds = 5);
+
+  /**
+   * Pick the given number of initial centroids for the given dataset with the
+   * k-means|| algorithm.
+   *
+   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @param data Dataset to partition.
+   * @param clusters Number of clusters to split dataset into.
+   * @param centroids Matrix to store centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids) const;
+
+  /**
+   * Pick the given number of initial centroids for the given dataset with the
+   * k-means|| algorithm, and assign each point to the closest one.
+   *
+   * @tparam MatType Type of data (arma::mat or arma::sp_mat).
+   * @param data Dataset to partition.
+   * @param clusters Number of clusters to split dataset into.
+   * @param assignments Vector to store cluster assignments into.  Values will
+   *     be between 0 and (clusters - 1).
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::Row<size_t>& assignments) const;
+
+  //! Get the oversampling factor.
+  double Oversampling() const { return oversampling; }
+  //! Modify the oversampling factor.
+  double& Oversampling() { return oversampling; }
+
+  //! Get the number of sampling rounds.
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds.
+  size_t& Rounds() { return rounds; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(oversampling);
+    ar & BOOST_SERIALIZATION_NVP(rounds);
+  }
+
+ private:
+  //! The expected number of candidates of each round, divided by k.
+  double oversampling;
+  //! The number of sampling rounds.
+  size_t rounds;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "kmeans_parallel_initialization_impl.hpp"
+
+#endif
@@ -0,0 +1,198 @@
+/**
+ * @file kmeans_parallel_initialization_impl.hpp
+ *
+ * Implementation of the k-means|| initialization strategy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kmeans_parallel_initialization.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+inline KMeansParallelInitialization::KMeansParallelInitialization(
+    const double oversampling,
+    const size_t rounds) :
+    oversampling(oversampling),
+    rounds(rounds)
+{
+  if (oversampling <= 0.0)
+  {
+    std::stringstream ss;
+    ss << "KMeansParallelInitialization: oversampling factor must be positive "
+        << "(given " << oversampling << ")";
+    throw std::invalid_argument(ss.str());
+  }
+}
+
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(const MatType& data,
+                                           const size_t clusters,
+                                           arma::mat& centroids) const
+{
+  typedef metric::SquaredEuclideanDistance Distance;
+
+  centroids.set_size(data.n_rows, clusters);
+  const size_t n = data.n_cols;
+  if (n == 0 || clusters == 0)
+    return;
+
+  // Start with one point chosen uniformly at random.  For each point, track the
+  // squared distance to its closest candidate, and which candidate that is.
+  std::vector<size_t> candidates(1, (size_t) math::RandInt(n));
+  arma::vec distances(n);
+  arma::Col<size_t> closest(n, arma::fill::zeros);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    distances[i] = Distance::Evaluate(data.col(i), data.col(candidates[0]));
+
+  // Each round samples each point with probability l * d(x)^2 / phi, where phi
+  // is the current cost; points that are already candidates have distance 0.
+  const double l = oversampling * clusters;
+  for (size_t r = 0; r < rounds; ++r)
+  {
+    const double cost = arma::accu(distances);
+    if (cost == 0.0)
+      break;
+
+    // The random numbers are drawn before the parallel pass, so the candidates
+    // only depend on the random seed.
+    const arma::vec u = arma::randu<arma::vec>(n);
+    const size_t first = candidates.size();
+    for (size_t i = 0; i < n; ++i)
+      if (u[i] * cost < l * distances[i])
+        candidates.push_back(i);
+
+    if (candidates.size() == first)
+      continue;
+
+    #pragma omp parallel for
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    {
+      for (size_t j = first; j < candidates.size(); ++j)
+      {
+        const double distance = Distance::Evaluate(data.col(i),
+            data.col(candidates[j]));
+        if (distance < distances[i])
+        {
+          distances[i] = distance;
+          closest[i] = j;
+        }
+      }
+    }
+  }
+
+  // If there are not more candidates than clusters, use all of them, and fill
+  // the other centroids with random points.
+  const size_t numCandidates = candidates.size();
+  if (numCandidates <= clusters)
+  {
+    for (size_t c = 0; c < clusters; ++c)
+    {
+      const size_t index = (c < numCandidates) ? candidates[c] :
+          (size_t) math::RandInt(n);
+      centroids.col(c) = data.col(index);
+    }
+
+    return;
+  }
+
+  // Weight each candidate by the number of points closest to it.
+  arma::vec weights(numCandidates, arma::fill::zeros);
+  for (size_t i = 0; i < n; ++i)
+    weights[closest[i]] += 1.0;
+
+  arma::mat candidatePoints(data.n_rows, numCandidates);
+  for (size_t j = 0; j < numCandidates; ++j)
+    candidatePoints.col(j) = data.col(candidates[j]);
+
+  // Now run k-means++ on the weighted candidates: each centroid is a candidate
+  // picked with probability proportional to its weight times its squared
+  // distance to the closest centroid picked so far.
+  arma::vec candidateDistances(numCandidates);
+  candidateDistances.fill(1.0);
+  for (size_t c = 0; c < clusters; ++c)
+  {
+    const arma::vec scores = weights % candidateDistances;
+    const double total = arma::accu(scores);
+
+    size_t chosen = numCandidates - 1;
+    if (total > 0.0)
+    {
+      const double threshold = math::Random() * total;
+      double sum = 0.0;
+      for (size_t j = 0; j < numCandidates; ++j)
+      {
+        sum += scores[j];
+        if (sum > threshold)
+        {
+          chosen = j;
+          break;
+        }
+      }
+    }
+    else
+    {
+      // All of the candidates are on the centroids already.
+      chosen = (size_t) math::RandInt(numCandidates);
+    }
+
+    centroids.col(c) = candidatePoints.col(chosen);
+
+    #pragma omp parallel for
+    for (omp_size_t j = 0; j < (omp_size_t) numCandidates; ++j)
+    {
+      const double distance = Distance::Evaluate(candidatePoints.col(j),
+          centroids.col(c));
+      if (c == 0 || distance < candidateDistances[j])
+        candidateDistances[j] = distance;
+    }
+  }
+}
+
+template<typename MatType>
+void KMeansParallelInitialization::Cluster(
+    const MatType& data,
+    const size_t clusters,
+    arma::Row<size_t>& assignments) const
+{
+  arma::mat centroids;
+  Cluster(data, clusters, centroids);
+
+  // Turn the centroids into assignments.
+  assignments.set_size(data.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
+  {
+    // Find the closest centroid to this point.
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = clusters;
+
+    for (size_t j = 0; j < clusters; ++j)
+    {
+      const double distance = metric::EuclideanDistance::Evaluate(data.col(i),
+          centroids.col(j));
+
+      if (distance < minDistance)
+      {
+        minDistance = distance;
+        closestCluster = j;
+      }
+    }
+
+    // Assign the point to its closest cluster.
+    assignments[i] = closestCluster;
+  }
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
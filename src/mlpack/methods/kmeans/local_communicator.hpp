@@ -0,0 +1,50 @@
+/**
+ * @file local_communicator.hpp
+ *
+ * The communicator of a DistributedKMeans run by a single process.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_LOCAL_COMMUNICATOR_HPP
+#define MLPACK_METHODS_KMEANS_LOCAL_COMMUNICATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * A communicator with a single rank, which holds the whole dataset.  The
+ * collective operations have nothing to do, so DistributedKMeans with this
+ * communicator is the same as KMeans.
+ */
+class LocalCommunicator
+{
+ public:
+  //! Get the rank of this process (always 0).
+  size_t Rank() const { return 0; }
+  //! Get the number of ranks (always 1).
+  size_t Size() const { return 1; }
+
+  /**
+   * Sum the given matrix over all the ranks, in place.
+   *
+   * @param m Matrix to sum; it must have the same size on all the ranks.
+   */
+  void AllReduceSum(arma::mat& /* m */) const { }
+
+  /**
+   * Copy the given matrix of rank 0 to all the other ranks.
+   *
+   * @param m Matrix to broadcast; it is resized on the other ranks.
+   */
+  void Broadcast(arma::mat& /* m */) const { }
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * @file mini_batch_kmeans.hpp
+ *
+ * An implementation of a mini-batch step for k-means clustering: instead of a
+ * full pass over the dataset, each iteration only moves the centroids towards
+ * a small random sample of the points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * This is an implementation of the mini-batch k-means step of Sculley:
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * Each call to Iterate() draws a batch of points uniformly at random (with
+ * replacement) from the dataset, assigns each of them to its closest centroid,
+ * and moves each centroid towards the points assigned to it.  Each centroid has
+ * its own learning rate, which is one over the number of points that were ever
+ * assigned to it, so a centroid is always the mean of all the points it was
+ * assigned so far.  An iteration costs O(bk) for a batch of b points instead of
+ * O(nk), at the price of an approximate clustering; the maximum number of
+ * iterations of KMeans should be chosen accordingly.
+ *
+ * The counts returned by Iterate() are the total number of points assigned to
+ * each centroid over all iterations, so a cluster is only empty if it was
+ * never assigned a point.
+ *
+ * Because KMeans constructs the step itself, the batch size is set for all
+ * subsequently constructed objects of a given MiniBatchKMeans type with
+ * DefaultBatchSize().
+ *
+ * @tparam MetricType Type of metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename MetricType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and metric.
+   * The batch size is DefaultBatchSize().
+   *
+   * @param dataset Dataset.
+   * @param metric Instantiated metric.
+   */
+  MiniBatchKMeans(const MatType& dataset, MetricType& metric);
+
+  /**
+   * Run a single mini-batch iteration, updating the given centroids into the
+   * newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Total number of points assigned to each cluster so far.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the number of points in each batch.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each batch.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get or modify the batch size of MiniBatchKMeans objects constructed
+  //! afterwards (1000 unless changed).
+  static size_t& DefaultBatchSize()
+  {
+    static size_t defaultBatchSize = 1000;
+    return defaultBatchSize;
+  }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The number of points in each batch.
+  size_t batchSize;
+  //! The number of points assigned to each centroid so far.
+  arma::Col<size_t> clusterCounts;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
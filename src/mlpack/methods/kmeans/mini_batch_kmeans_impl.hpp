@@ -0,0 +1,123 @@
+/**
+ * @file mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of the mini-batch step for k-means clustering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+MiniBatchKMeans<MetricType, MatType>::MiniBatchKMeans(const MatType& dataset,
+                                                      MetricType& metric) :
+    dataset(dataset),
+    metric(metric),
+    batchSize(DefaultBatchSize()),
+    distanceCalculations(0)
+{
+  if (batchSize == 0)
+    throw std::invalid_argument("MiniBatchKMeans::MiniBatchKMeans(): batch "
+        "size must be greater than 0!");
+}
+
+// Run a single iteration.
+template<typename MetricType, typename MatType>
+double MiniBatchKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  if (clusterCounts.n_elem != centroids.n_cols)
+    clusterCounts.zeros(centroids.n_cols);
+
+  // Draw the batch before anything is done in parallel, so that the results
+  // only depend on the random seed.
+  const size_t n = batchSize;
+  arma::Col<size_t> batch(n);
+  for (size_t i = 0; i < n; ++i)
+    batch[i] = (size_t) math::RandInt(dataset.n_cols);
+
+  arma::mat sums(centroids.n_rows, centroids.n_cols, arma::fill::zeros);
+  arma::Col<size_t> batchCounts(centroids.n_cols, arma::fill::zeros);
+
+  // Find the closest centroid to each point of the batch, and sum the points
+  // assigned to each centroid.
+  #pragma omp parallel
+  {
+    arma::mat localSums(centroids.n_rows, centroids.n_cols, arma::fill::zeros);
+    arma::Col<size_t> localCounts(centroids.n_cols, arma::fill::zeros);
+
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    {
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
+
+      for (size_t j = 0; j < centroids.n_cols; ++j)
+      {
+        const double distance = metric.Evaluate(dataset.col(batch[i]),
+            centroids.unsafe_col(j));
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          closestCluster = j;
+        }
+      }
+
+      Log::Assert(closestCluster != centroids.n_cols);
+
+      localSums.unsafe_col(closestCluster) += dataset.col(batch[i]);
+      localCounts(closestCluster)++;
+    }
+
+    #pragma omp critical
+    {
+      sums += localSums;
+      batchCounts += localCounts;
+    }
+  }
+
+  // Moving a centroid towards each of its points in turn with a learning rate
+  // of one over its count is the same as taking the weighted mean of the old
+  // centroid and the new points.
+  newCentroids = centroids;
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    if (batchCounts[j] == 0)
+      continue;
+
+    const double oldCount = (double) clusterCounts[j];
+    clusterCounts[j] += batchCounts[j];
+    newCentroids.col(j) = (oldCount * centroids.col(j) + sums.col(j)) /
+        (double) clusterCounts[j];
+  }
+
+  counts = clusterCounts;
+  distanceCalculations += centroids.n_cols * n;
+
+  // Calculate the movement of the centroids for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(metric.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file mpi_communicator.hpp
+ *
+ * The communicator of a DistributedKMeans run over MPI.  It is only available
+ * when mlpack is configured with -DUSE_MPI=ON and MPI is found.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MPI_COMMUNICATOR_HPP
+#define MLPACK_METHODS_KMEANS_MPI_COMMUNICATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef HAS_MPI
+
+#include <mpi.h>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * A communicator whose ranks are the processes of an MPI communicator.  MPI
+ * must be initialized (with MPI_Init()) before the communicator is used, and
+ * all the ranks must call DistributedKMeans::Cluster() together.
+ *
+ * @code
+ * MPI_Init(&argc, &argv);
+ * {
+ *   extern arma::mat shard; // The points held by this rank.
+ *   arma::mat centroids;
+ *
+ *   DistributedKMeans<MPICommunicator> k;
+ *   k.Cluster(shard, 10, centroids);
+ * }
+ * MPI_Finalize();
+ * @endcode
+ */
+class MPICommunicator
+{
+ public:
+  /**
+   * Create the communicator over the given MPI communicator.
+   *
+   * @param comm MPI communicator to use.
+   */
+  MPICommunicator(MPI_Comm comm = MPI_COMM_WORLD) : comm(comm) { }
+
+  //! Get the rank of this process.
+  size_t Rank() const
+  {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    return (size_t) rank;
+  }
+
+  //! Get the number of ranks.
+  size_t Size() const
+  {
+    int size;
+    MPI_Comm_size(comm, &size);
+    return (size_t) size;
+  }
+
+  /**
+   * Sum the given matrix over all the ranks, in place.
+   *
+   * @param m Matrix to sum; it must have the same size on all the ranks.
+   */
+  void AllReduceSum(arma::mat& m) const
+  {
+    MPI_Allreduce(MPI_IN_PLACE, m.memptr(), (int) m.n_elem, MPI_DOUBLE,
+        MPI_SUM, comm);
+  }
+
+  /**
+   * Copy the given matrix of rank 0 to all the other ranks.
+   *
+   * @param m Matrix to broadcast; it is resized on the other ranks.
+   */
+  void Broadcast(arma::mat& m) const
+  {
+    unsigned long long size[2] = { m.n_rows, m.n_cols };
+    MPI_Bcast(size, 2, MPI_UNSIGNED_LONG_LONG, 0, comm);
+    if (Rank() != 0)
+      m.set_size(size[0], size[1]);
+
+    MPI_Bcast(m.memptr(), (int) m.n_elem, MPI_DOUBLE, 0, comm);
+  }
+
+  //! Get the MPI communicator.
+  MPI_Comm Comm() const { return comm; }
+
+ private:
+  //! The MPI communicator.
+  MPI_Comm comm;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif // HAS_MPI
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ * @file sparse_hamerly_kmeans.hpp
+ *
+ * A version of Hamerly's k-means step for sparse data, which computes the
+ * Euclidean distances from the dot products of the points and the centroids.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_SPARSE_HAMERLY_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_SPARSE_HAMERLY_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace kmeans {
+
+/**
+ * The SparseHamerlyKMeans step type keeps the same bounds as HamerlyKMeans,
+ * but each distance between a point x and a centroid c is computed as
+ *
+ *   ||x - c|| = sqrt(||x||^2 + ||c||^2 - 2 x^T c),
+ *
+ * with the squared norms of the points computed once, and those of the
+ * centroids once per iteration.  The dot products then only touch the nonzero
+ * elements of the point, instead of all the dimensions of the dense centroid
+ * that metric.Evaluate() goes through.  When the bounds fail for a point, the
+ * dot products with all the centroids are computed at once from the
+ * transposed centroids, so that each nonzero element of the point adds a
+ * contiguous row of k centroid coordinates (one column of the sparse-dense
+ * product of the centroids and the dataset).  The sums of the new centroids
+ * only add the nonzero elements too.
+ *
+ * This is meant for high-dimensional sparse data such as TF-IDF vectors; it
+ * also works with dense matrices, but HamerlyKMeans is then as fast.  The
+ * distances are only exact up to the cancellation of the subtraction, so
+ * points that are at nearly the same distance of two centroids may be assigned
+ * differently than with the other step types.
+ *
+ * @tparam MetricType Type of metric; this must be the Euclidean distance.
+ * @tparam MatType Matrix type (arma::sp_mat or arma::mat).
+ */
+template<typename MetricType, typename MatType>
+class SparseHamerlyKMeans
+{
+  static_assert(std::is_same<MetricType, metric::EuclideanDistance>::value,
+      "SparseHamerlyKMeans can only be used with the Euclidean distance.");
+
+ public:
+  /**
+   * Construct the SparseHamerlyKMeans object, which must store several sets
+   * of bounds, and compute the squared norms of the points.
+   */
+  SparseHamerlyKMeans(const MatType& dataset, MetricType& metric);
+
+  /**
+   * Run a single iteration of Hamerly's algorithm, updating the given centroids
+   * into the newCentroids matrix.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Current counts, to be overwritten with new counts.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  //! Get the squared norm of the given point of a dense dataset.
+  template<typename eT>
+  static double SquaredNorm(const arma::Mat<eT>& data, const size_t point);
+  //! Get the squared norm of the given point of a sparse dataset.
+  template<typename eT>
+  static double SquaredNorm(const arma::SpMat<eT>& data, const size_t point);
+
+  //! Get the dot product of the given point of a dense dataset with the given
+  //! centroid.
+  template<typename eT>
+  static double Dot(const arma::Mat<eT>& data,
+                    const size_t point,
+                    const arma::mat& centroids,
+                    const size_t centroid);
+  //! Get the dot product of the given point of a sparse dataset with the
+  //! given centroid.
+  template<typename eT>
+  static double Dot(const arma::SpMat<eT>& data,
+                    const size_t point,
+                    const arma::mat& centroids,
+                    const size_t centroid);
+
+  //! Compute the dot products of the given point of a dense dataset with all
+  //! the centroids, given transposed (one row per centroid).
+  template<typename eT>
+  static void Dots(const arma::Mat<eT>& data,
+                   const size_t point,
+                   const arma::mat& centroidsT,
+                   arma::vec& dots);
+  //! Compute the dot products of the given point of a sparse dataset with all
+  //! the centroids, given transposed (one row per centroid).
+  template<typename eT>
+  static void Dots(const arma::SpMat<eT>& data,
+                   const size_t point,
+                   const arma::mat& centroidsT,
+                   arma::vec& dots);
+
+  //! Add the given point of a dense dataset to the given column of sums.
+  template<typename eT>
+  static void AddPoint(const arma::Mat<eT>& data,
+                       const size_t point,
+                       arma::mat& sums,
+                       const size_t column);
+  //! Add the given point of a sparse dataset to the given column of sums.
+  template<typename eT>
+  static void AddPoint(const arma::SpMat<eT>& data,
+                       const size_t point,
+                       arma::mat& sums,
+                       const size_t column);
+
+  //! Get the distance between a point and a centroid with the given squared
+  //! norms and dot product.
+  static double Distance(const double pointNorm,
+                         const double centroidNorm,
+                         const double dot)
+  {
+    return std::sqrt(std::max(0.0, pointNorm + centroidNorm - 2.0 * dot));
+  }
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated metric.
+  MetricType& metric;
+
+  //! The squared norm of each point.
+  arma::vec pointNorms;
+
+  //! Minimum cluster distances from each cluster.
+  arma::vec minClusterDistances;
+
+  //! Upper (row 0) and lower (row 1) bounds for each point, stored next to
+  //! each other because they are always used together.
+  arma::mat bounds;
+  //! Assignments for each point.
+  arma::Col<size_t> assignments;
+
+  //! Track distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace kmeans
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_hamerly_kmeans_impl.hpp"
+
+#endif
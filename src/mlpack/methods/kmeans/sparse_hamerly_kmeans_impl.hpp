@@ -0,0 +1,333 @@
+/**
+ * @file sparse_hamerly_kmeans_impl.hpp
+ *
+ * Implementation of Hamerly's k-means step for sparse data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_SPARSE_HAMERLY_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_SPARSE_HAMERLY_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_hamerly_kmeans.hpp"
+
+namespace mlpack {
+namespace kmeans {
+
+template<typename MetricType, typename MatType>
+SparseHamerlyKMeans<MetricType, MatType>::SparseHamerlyKMeans(
+    const MatType& dataset,
+    MetricType& metric) :
+    dataset(dataset),
+    metric(metric),
+    pointNorms(dataset.n_cols),
+    distanceCalculations(0)
+{
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+    pointNorms[i] = SquaredNorm(dataset, i);
+}
+
+template<typename MetricType, typename MatType>
+double SparseHamerlyKMeans<MetricType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  size_t hamerlyPruned = 0;
+  size_t iterationDistances = 0;
+
+  // If this is the first iteration, we need to set all the bounds.
+  if (minClusterDistances.n_elem != centroids.n_cols)
+  {
+    bounds.set_size(2, dataset.n_cols);
+    bounds.row(0).fill(DBL_MAX);
+    bounds.row(1).zeros();
+    assignments.zeros(dataset.n_cols);
+    minClusterDistances.set_size(centroids.n_cols);
+  }
+
+  // The squared norms of the centroids, and the centroids transposed so that
+  // the coordinates of all the centroids in one dimension are contiguous.
+  const arma::rowvec centroidNorms = arma::sum(arma::square(centroids), 0);
+  const arma::mat centroidsT = centroids.t();
+
+  // Calculate minimum intra-cluster distance for each cluster.
+  arma::mat clusterDistances(centroids.n_cols, centroids.n_cols);
+  clusterDistances.diag().fill(DBL_MAX);
+  #pragma omp parallel for schedule(dynamic) reduction(+:iterationDistances)
+  for (omp_size_t i = 0; i < (omp_size_t) centroids.n_cols; ++i)
+  {
+    for (size_t j = i + 1; j < centroids.n_cols; ++j)
+    {
+      const double dist = metric.Evaluate(centroids.col(i), centroids.col(j)) /
+          2.0;
+      ++iterationDistances;
+      clusterDistances(i, j) = dist;
+      clusterDistances(j, i) = dist;
+    }
+  }
+  minClusterDistances = arma::min(clusterDistances).t();
+
+  // The points are split into one contiguous block per thread, and each block
+  // sums the points of each cluster separately; the sums are merged
+  // afterwards.
+  const size_t numBlocks = std::max((size_t) 1,
+      std::min(NumThreads(), (size_t) dataset.n_cols));
+  std::vector<arma::mat> blockCentroids(numBlocks);
+  std::vector<arma::Col<size_t>> blockCounts(numBlocks);
+
+  #pragma omp parallel for reduction(+:iterationDistances, hamerlyPruned)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    arma::mat& localCentroids = blockCentroids[b];
+    arma::Col<size_t>& localCounts = blockCounts[b];
+    localCentroids.zeros(centroids.n_rows, centroids.n_cols);
+    localCounts.zeros(centroids.n_cols);
+    arma::vec dots(centroids.n_cols);
+
+    const size_t begin = b * dataset.n_cols / numBlocks;
+    const size_t end = (b + 1) * dataset.n_cols / numBlocks;
+    for (size_t i = begin; i < end; ++i)
+    {
+      double& upperBound = bounds(0, i);
+      double& lowerBound = bounds(1, i);
+      const double m = std::max(minClusterDistances(assignments[i]),
+                                lowerBound);
+
+      // First bound test.
+      if (upperBound <= m)
+      {
+        ++hamerlyPruned;
+        AddPoint(dataset, i, localCentroids, assignments[i]);
+        ++localCounts(assignments[i]);
+        continue;
+      }
+
+      // Tighten upper bound.
+      upperBound = Distance(pointNorms[i], centroidNorms[assignments[i]],
+          Dot(dataset, i, centroids, assignments[i]));
+      ++iterationDistances;
+
+      // Second bound test.
+      if (upperBound <= m)
+      {
+        AddPoint(dataset, i, localCentroids, assignments[i]);
+        ++localCounts(assignments[i]);
+        continue;
+      }
+
+      // The bounds failed.  So test against all other clusters, with the dot
+      // products to all the centroids at once.
+      Dots(dataset, i, centroidsT, dots);
+      lowerBound = DBL_MAX;
+      const size_t assignment = assignments[i];
+      for (size_t c = 0; c < centroids.n_cols; ++c)
+      {
+        if (c == assignment)
+          continue;
+
+        const double dist = Distance(pointNorms[i], centroidNorms[c], dots[c]);
+
+        // Is this a better cluster?  At this point, upperBound = d(i, c(i)).
+        if (dist < upperBound)
+        {
+          // lowerBound holds the second closest cluster.
+          lowerBound = upperBound;
+          upperBound = dist;
+          assignments[i] = c;
+        }
+        else if (dist < lowerBound)
+        {
+          // This is a closer second-closest cluster.
+          lowerBound = dist;
+        }
+      }
+      iterationDistances += centroids.n_cols - 1;
+
+      // Update new centroids.
+      AddPoint(dataset, i, localCentroids, assignments[i]);
+      ++localCounts(assignments[i]);
+    }
+  }
+
+  // Merge the sums of the blocks, one cluster at a time.
+  newCentroids.set_size(centroids.n_rows, centroids.n_cols);
+  counts.set_size(centroids.n_cols);
+  #pragma omp parallel for
+  for (omp_size_t c = 0; c < (omp_size_t) centroids.n_cols; ++c)
+  {
+    newCentroids.col(c) = blockCentroids[0].col(c);
+    counts[c] = blockCounts[0][c];
+    for (size_t b = 1; b < numBlocks; ++b)
+    {
+      newCentroids.col(c) += blockCentroids[b].col(c);
+      counts[c] += blockCounts[b][c];
+    }
+  }
+
+  // Normalize centroids and calculate cluster movement (contains parts of
+  // Move-Centers() and Update-Bounds()).
+  double furthestMovement = 0.0;
+  double secondFurthestMovement = 0.0;
+  size_t furthestMovingCluster = 0;
+  arma::vec centroidMovements(centroids.n_cols);
+  double centroidMovement = 0.0;
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    if (counts(c) > 0)
+      newCentroids.col(c) /= counts(c);
+
+    // Calculate movement.
+    const double movement = metric.Evaluate(centroids.col(c),
+                                            newCentroids.col(c));
+    centroidMovements(c) = movement;
+    centroidMovement += std::pow(movement, 2.0);
+    ++iterationDistances;
+
+    if (movement > furthestMovement)
+    {
+      secondFurthestMovement = furthestMovement;
+      furthestMovement = movement;
+      furthestMovingCluster = c;
+    }
+    else if (movement > secondFurthestMovement)
+    {
+      secondFurthestMovement = movement;
+    }
+  }
+
+  // Now update bounds (lines 3-8 of Update-Bounds()).
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) dataset.n_cols; ++i)
+  {
+    bounds(0, i) += centroidMovements(assignments[i]);
+    if (assignments[i] == furthestMovingCluster)
+      bounds(1, i) -= secondFurthestMovement;
+    else
+      bounds(1, i) -= furthestMovement;
+  }
+
+  distanceCalculations += iterationDistances;
+  Log::Info << "Hamerly prunes: " << hamerlyPruned << ".\n";
+
+  return std::sqrt(centroidMovement);
+}
+
+template<typename MetricType, typename MatType>
+template<typename eT>
+double SparseHamerlyKMeans<MetricType, MatType>::SquaredNorm(
+    const arma::Mat<eT>& data,
+    const size_t point)
+{
+  double norm = 0.0;
+  for (size_t r = 0; r < data.n_rows; ++r)
+    norm += (double) data(r, point) * data(r, point);
+
+  return norm;
+}
+
+template<typename MetricType, typename MatType>
+template<typename eT>
+double SparseHamerlyKMeans<MetricType, MatType>::SquaredNorm(
+    const arma::SpMat<eT>& data,
+    const size_t point)
+{
+  double norm = 0.0;
+  for (typename arma::SpMat<eT>::const_iterator it = data.begin_col(point);
+       it != data.end_col(point); ++it)
+    norm += (double) (*it) * (*it);
+
+  return norm;
+}
+
+template<typename MetricType, typename MatType>
+template<typename eT>
+double SparseHamerlyKMeans<MetricType, MatType>::Dot(
+    const arma::Mat<eT>& data,
+    const size_t point,
+    const arma::mat& centroids,
+    const size_t centroid)
+{
+  double dot = 0.0;
+  for (size_t r = 0; r < data.n_rows; ++r)
+    dot += data(r, point) * centroids(r, centroid);
+
+  return dot;
+}
+
+template<typename MetricType, typename MatType>
+template<typename eT>
+double SparseHamerlyKMeans<MetricType, MatType>::Dot(
+    const arma::SpMat<eT>& data,
+    const size_t point,
+    const arma::mat& centroids,
+    const size_t centroid)
+{
+  double dot = 0.0;
+  for (typename arma::SpMat<eT>::const_iterator it = data.begin_col(point);
+       it != data.end_col(point); ++it)
+    dot += (*it) * centroids(it.row(), centroid);
+
+  return dot;
+}
+
+template<typename MetricType, typename MatType>
+template<typename eT>
+void SparseHamerlyKMeans<MetricType, MatType>::Dots(
+    const arma::Mat<eT>& data,
+    const size_t point,
+    const arma::mat& centroidsT,
+    arma::vec& dots)
+{
+  dots.zeros();
+  for (size_t r = 0; r < data.n_rows; ++r)
+    dots += data(r, point) * centroidsT.col(r);
+}
+
+template<typename MetricType, typename MatType>
+template<typename eT>
+void SparseHamerlyKMeans<MetricType, MatType>::Dots(
+    const arma::SpMat<eT>& data,
+    const size_t point,
+    const arma::mat& centroidsT,
+    arma::vec& dots)
+{
+  dots.zeros();
+  for (typename arma::SpMat<eT>::const_iterator it = data.begin_col(point);
+       it != data.end_col(point); ++it)
+    dots += (*it) * centroidsT.col(it.row());
+}
+
+template<typename MetricType, typename MatType>
+template<typename eT>
+void SparseHamerlyKMeans<MetricType, MatType>::AddPoint(
+    const arma::Mat<eT>& data,
+    const size_t point,
+    arma::mat& sums,
+    const size_t column)
+{
+  for (size_t r = 0; r < data.n_rows; ++r)
+    sums(r, column) += data(r, point);
+}
+
+template<typename MetricType, typename MatType>
+template<typename eT>
+void SparseHamerlyKMeans<MetricType, MatType>::AddPoint(
+    const arma::SpMat<eT>& data,
+    const size_t point,
+    arma::mat& sums,
+    const size_t column)
+{
+  for (typename arma::SpMat<eT>::const_iterator it = data.begin_col(point);
+       it != data.end_col(point); ++it)
+    sums(it.row(), column) += (*it);
+}
+
+} // namespace kmeans
+} // namespace mlpack
+
+#endif
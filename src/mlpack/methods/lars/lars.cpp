@@ -68,6 +68,18 @@ LARS::LARS(const arma::mat& data,
   Train(data, responses, transposeData);
 }
 
+LARS::LARS(const arma::sp_mat& data,
+           const arma::rowvec& responses,
+           const bool transposeData,
+           const bool useCholesky,
+           const double lambda1,
+           const double lambda2,
+           const double tolerance) :
+    LARS(useCholesky, lambda1, lambda2, tolerance)
+{
+  Train(data, responses, transposeData);
+}
+
 double LARS::Train(const arma::mat& matX,
                    const arma::rowvec& y,
                    arma::vec& beta,
@@ -75,15 +87,6 @@ double LARS::Train(const arma::mat& matX,
 {
   Timer::Start("lars_regression");
 
-  // Clear any previous solution information.
-  betaPath.clear();
-  lambdaPath.clear();
-  activeSet.clear();
-  isActive.clear();
-  ignoreSet.clear();
-  isIgnored.clear();
-  matUtriCholFactor.reset();
-
   // This matrix may end up holding the transpose -- if necessary.
   arma::mat dataTrans;
   // dataRef is row-major.
@@ -92,7 +95,181 @@ double LARS::Train(const arma::mat& matX,
     dataTrans = trans(matX);
 
   // Compute X' * y.
-  arma::vec vecXTy = trans(y * dataRef);
+  const arma::vec vecXTy = trans(y * dataRef);
+
+  const double maxCorr = TrainPath(dataRef, vecXTy, beta);
+
+  Timer::Stop("lars_regression");
+  return maxCorr;
+}
+
+double LARS::Train(const arma::sp_mat& matX,
+                   const arma::rowvec& y,
+                   arma::vec& beta,
+                   const bool transposeData)
+{
+  Timer::Start("lars_regression");
+
+  // This matrix may end up holding the transpose -- if necessary.
+  arma::sp_mat dataTrans;
+  // dataRef is row-major, so that each dimension is a sparse column.
+  const arma::sp_mat& dataRef = (transposeData ? dataTrans : matX);
+  if (transposeData)
+    dataTrans = trans(matX);
+
+  // Compute X' * y.
+  const arma::vec vecXTy = trans(y * dataRef);
+
+  const double maxCorr = TrainPath(dataRef, vecXTy, beta);
+
+  Timer::Stop("lars_regression");
+  return maxCorr;
+}
+
+double LARS::Train(const arma::mat& matX,
+                   const arma::mat& y,
+                   arma::mat& betas,
+                   const bool transposeData)
+{
+  Timer::Start("lars_regression");
+
+  // This matrix may end up holding the transpose -- if necessary.
+  arma::mat dataTrans;
+  // dataRef is row-major.
+  const arma::mat& dataRef = (transposeData ? dataTrans : matX);
+  if (transposeData)
+    dataTrans = trans(matX);
+
+  if (y.n_cols != dataRef.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "LARS::Train(): responses have " << y.n_cols << " columns, but "
+        << "data has " << dataRef.n_rows << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Compute X' * y for every target at once.
+  const arma::mat matXTy = trans(y * dataRef);
+
+  // Compute the Gram matrix once; every target shares it.
+  ComputeGram(dataRef);
+
+  betas.set_size(dataRef.n_cols, y.n_rows);
+  arma::vec maxCorrs(y.n_rows, arma::fill::zeros);
+  std::vector<LARS> models(y.n_rows, LARS(useCholesky, *matGram, lambda1,
+      lambda2, tolerance));
+
+  // Targets have solution paths of different lengths, so schedule them
+  // dynamically.  Each model has its own active set and Cholesky factor.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t t = 0; t < (omp_size_t) y.n_rows; ++t)
+  {
+    // LARS places the result directly into this alias of the column.
+    arma::vec beta = betas.unsafe_col(t);
+    maxCorrs[t] = models[t].TrainPath(dataRef, matXTy.col(t), beta);
+  }
+  const double maxCorr = (y.n_rows > 0) ? maxCorrs.max() : 0.0;
+
+  // Keep the solution path of the last target.
+  if (models.size() > 0)
+  {
+    LARS& last = models.back();
+    matUtriCholFactor = std::move(last.matUtriCholFactor);
+    betaPath = std::move(last.betaPath);
+    lambdaPath = std::move(last.lambdaPath);
+    activeSet = std::move(last.activeSet);
+    isActive = std::move(last.isActive);
+    ignoreSet = std::move(last.ignoreSet);
+    isIgnored = std::move(last.isIgnored);
+  }
+
+  Timer::Stop("lars_regression");
+  return maxCorr;
+}
+
+void LARS::ComputeGram(const arma::mat& dataRef)
+{
+  // Compute the Gram matrix.  If this is the elastic net problem, we will add
+  // lambda2 * I_n to the matrix.
+  if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
+  {
+    // In this case, matGram should reference matGramInternal.
+    matGramInternal = trans(dataRef) * dataRef;
+
+    if (elasticNet && !useCholesky)
+      matGramInternal += lambda2 * arma::eye(dataRef.n_cols, dataRef.n_cols);
+  }
+}
+
+void LARS::ActiveGramColumn(const arma::mat& dataRef,
+                            const size_t varInd,
+                            double& sqNorm,
+                            arma::vec& gramCol) const
+{
+  sqNorm = (*matGram)(varInd, varInd);
+  gramCol = matGram->elem(varInd * dataRef.n_cols +
+      arma::conv_to<arma::uvec>::from(activeSet));
+}
+
+void LARS::ActiveGramColumn(const arma::sp_mat& dataRef,
+                            const size_t varInd,
+                            double& sqNorm,
+                            arma::vec& gramCol) const
+{
+  sqNorm = 0.0;
+  arma::sp_mat::const_iterator it = dataRef.begin_col(varInd);
+  const arma::sp_mat::const_iterator end = dataRef.end_col(varInd);
+  for (; it != end; ++it)
+    sqNorm += (*it) * (*it);
+
+  // The nonzero elements of each column are sorted by row, so each inner
+  // product is a merge of two columns.
+  gramCol.set_size(activeSet.size());
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (omp_size_t i = 0; i < (omp_size_t) activeSet.size(); ++i)
+  {
+    arma::sp_mat::const_iterator a = dataRef.begin_col(activeSet[i]);
+    const arma::sp_mat::const_iterator aEnd = dataRef.end_col(activeSet[i]);
+    arma::sp_mat::const_iterator b = dataRef.begin_col(varInd);
+    double product = 0.0;
+    while (a != aEnd && b != end)
+    {
+      if (a.row() < b.row())
+      {
+        ++a;
+      }
+      else if (b.row() < a.row())
+      {
+        ++b;
+      }
+      else
+      {
+        product += (*a) * (*b);
+        ++a;
+        ++b;
+      }
+    }
+    gramCol[i] = product;
+  }
+}
+
+template<typename MatType>
+double LARS::TrainPath(const MatType& dataRef,
+                       const arma::vec& vecXTy,
+                       arma::vec& beta)
+{
+  // The Gram matrix of sparse data is never formed, so its active set is
+  // always handled with the Cholesky factorization.
+  const bool cholesky = useCholesky || arma::is_SpMat<MatType>::value;
+
+  // Clear any previous solution information.
+  betaPath.clear();
+  lambdaPath.clear();
+  activeSet.clear();
+  isActive.clear();
+  ignoreSet.clear();
+  isIgnored.clear();
+  matUtriCholFactor.reset();
 
   // Set up active set variables.  In the beginning, the active set has size 0
   // (all dimensions are inactive).
@@ -128,20 +305,10 @@ double LARS::Train(const arma::mat& matX,
   if (maxCorr < lambda1)
   {
     lambdaPath[0] = lambda1;
-    Timer::Stop("lars_regression");
     return maxCorr;
   }
 
-  // Compute the Gram matrix.  If this is the elastic net problem, we will add
-  // lambda2 * I_n to the matrix.
-  if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
-  {
-    // In this case, matGram should reference matGramInternal.
-    matGramInternal = trans(dataRef) * dataRef;
-
-    if (elasticNet && !useCholesky)
-      matGramInternal += lambda2 * arma::eye(dataRef.n_cols, dataRef.n_cols);
-  }
+  ComputeGram(dataRef);
 
   // Main loop.
   while (((activeSet.size() + ignoreSet.size()) < dataRef.n_cols) &&
@@ -160,18 +327,13 @@ double LARS::Train(const arma::mat& matX,
 
     if (!lassocond)
     {
-      if (useCholesky)
+      if (cholesky)
       {
-        // vec newGramCol = vec(activeSet.size());
-        // for (size_t i = 0; i < activeSet.size(); i++)
-        // {
-        //   newGramCol[i] = dot(matX.col(activeSet[i]), matX.col(changeInd));
-        // }
-        // This is equivalent to the above 5 lines.
-        arma::vec newGramCol = matGram->elem(changeInd * dataRef.n_cols +
-            arma::conv_to<arma::uvec>::from(activeSet));
-
-        CholeskyInsert((*matGram)(changeInd, changeInd), newGramCol);
+        double sqNorm;
+        arma::vec newGramCol;
+        ActiveGramColumn(dataRef, changeInd, sqNorm, newGramCol);
+
+        CholeskyInsert(sqNorm, newGramCol);
       }
 
       // Add variable to active set.
@@ -189,7 +351,7 @@ double LARS::Train(const arma::mat& matX,
     arma::vec unnormalizedBetaDirection;
     double normalization;
     arma::vec betaDirection;
-    if (useCholesky)
+    if (cholesky)
     {
       // Check for singularity.
       const double lastUtriElement = matUtriCholFactor(
@@ -267,12 +429,13 @@ double LARS::Train(const arma::mat& matX,
     if ((activeSet.size() + ignoreSet.size()) < dataRef.n_cols)
     {
       // Compute correlations with direction.
+      const arma::vec dirCorrs = trans(yHatDirection.t() * dataRef);
       for (size_t ind = 0; ind < dataRef.n_cols; ind++)
       {
         if (isActive[ind] || isIgnored[ind])
           continue;
 
-        double dirCorr = dot(dataRef.col(ind), yHatDirection);
+        double dirCorr = dirCorrs[ind];
         double val1 = (maxCorr - corr(ind)) / (normalization - dirCorr);
         double val2 = (maxCorr + corr(ind)) / (normalization + dirCorr);
         if ((val1 > 0) && (val1 < gamma))
@@ -328,13 +491,13 @@ double LARS::Train(const arma::mat& matX,
     if (lassocond)
     {
       // Index is in position changeInd in activeSet.
-      if (useCholesky)
+      if (cholesky)
         CholeskyDelete(changeInd);
 
       Deactivate(changeInd);
     }
 
-    corr = vecXTy - trans(dataRef) * yHat;
+    corr = vecXTy - trans(yHat.t() * dataRef);
     if (elasticNet)
       corr -= lambda2 * beta;
 
@@ -360,7 +523,6 @@ double LARS::Train(const arma::mat& matX,
   // Unfortunate copy...
   beta = betaPath.back();
 
-  Timer::Stop("lars_regression");
   return maxCorr;
 }
 
@@ -372,6 +534,14 @@ double LARS::Train(const arma::mat& data,
   return Train(data, responses, beta, transposeData);
 }
 
+double LARS::Train(const arma::sp_mat& data,
+                   const arma::rowvec& responses,
+                   const bool transposeData)
+{
+  arma::vec beta;
+  return Train(data, responses, beta, transposeData);
+}
+
 void LARS::Predict(const arma::mat& points,
                    arma::rowvec& predictions,
                    const bool rowMajor) const
@@ -383,6 +553,16 @@ void LARS::Predict(const arma::mat& points,
     predictions = betaPath.back().t() * points;
 }
 
+void LARS::Predict(const arma::sp_mat& points,
+                   arma::rowvec& predictions,
+                   const bool rowMajor) const
+{
+  if (rowMajor)
+    predictions = trans(points * betaPath.back());
+  else
+    predictions = betaPath.back().t() * points;
+}
+
 // Private functions.
 void LARS::Deactivate(const size_t activeVarInd)
 {
@@ -402,7 +582,8 @@ void LARS::Ignore(const size_t varInd)
   ignoreSet.push_back(varInd);
 }
 
-void LARS::ComputeYHatDirection(const arma::mat& matX,
+template<typename MatType>
+void LARS::ComputeYHatDirection(const MatType& matX,
                                 const arma::vec& betaDirection,
                                 arma::vec& yHatDirection)
 {
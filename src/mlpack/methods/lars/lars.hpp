@@ -170,6 +170,29 @@ class LARS
        const double lambda2 = 0.0,
        const double tolerance = 1e-16);
 
+  /**
+   * Set the parameters to LARS and run training on sparse data.  See the
+   * sparse overload of Train() for details.
+   *
+   * @param data Sparse input data.
+   * @param responses A vector of targets.
+   * @param transposeData Should be true if the input data is column-major and
+   *     false otherwise.
+   * @param useCholesky Ignored for sparse data; the Cholesky decomposition is
+   *     always used.
+   * @param lambda1 Regularization parameter for l1-norm penalty.
+   * @param lambda2 Regularization parameter for l2-norm penalty.
+   * @param tolerance Run until the maximum correlation of elements in (X^T y)
+   *     is less than this.
+   */
+  LARS(const arma::sp_mat& data,
+       const arma::rowvec& responses,
+       const bool transposeData = true,
+       const bool useCholesky = false,
+       const double lambda1 = 0.0,
+       const double lambda2 = 0.0,
+       const double tolerance = 1e-16);
+
   /**
    * Run LARS.  The input matrix (like all mlpack matrices) should be
    * column-major -- each column is an observation and each row is a dimension.
@@ -208,6 +231,62 @@ class LARS
                const arma::rowvec& responses,
                const bool transposeData = true);
 
+  /**
+   * Run LARS on sparse data.  The full Gram matrix X^T X is never formed:
+   * whenever a dimension enters the active set, its inner products with the
+   * dimensions already in the active set are computed from the sparse columns
+   * (in parallel) and added to the Cholesky factorization of the Gram matrix
+   * of the active set, so the Cholesky decomposition is always used for sparse
+   * data, and the memory needed beyond the data is quadratic only in the size
+   * of the active set.  As for dense data, the matrix is transposed internally
+   * unless transposeData is false.
+   *
+   * @param data Column-major sparse input data (or row-major sparse input data
+   *     if transposeData = false).
+   * @param responses A vector of targets.
+   * @param beta Vector to store the solution (the coefficients) in.
+   * @param transposeData Set to false if the data is row-major.
+   * @return The final absolute maximum correlation.
+   */
+  double Train(const arma::sp_mat& data,
+               const arma::rowvec& responses,
+               arma::vec& beta,
+               const bool transposeData = true);
+
+  /**
+   * Run LARS on sparse data; see the overload above.
+   *
+   * @param data Sparse input data.
+   * @param responses A vector of targets.
+   * @param transposeData Should be true if the input data is column-major and
+   *     false otherwise.
+   * @return The final absolute maximum correlation.
+   */
+  double Train(const arma::sp_mat& data,
+               const arma::rowvec& responses,
+               const bool transposeData = true);
+
+  /**
+   * Run LARS for several targets (responses) on the same data.  The Gram matrix
+   * X^T X (or the precalculated Gram matrix passed to the constructor) and the
+   * transposed data are computed once and shared by all targets, and the
+   * targets are solved in parallel with OpenMP.  Each row of responses is one
+   * target, and the solution for target i is stored in column i of betas.
+   * Afterwards, BetaPath(), LambdaPath(), ActiveSet() and MatUtriCholFactor()
+   * hold the solution path of the last target.
+   *
+   * @param data Column-major input data (or row-major input data if
+   *     transposeData = false).
+   * @param responses A matrix of targets; each row holds one target.
+   * @param betas Matrix to store the solutions (the coefficients) in.
+   * @param transposeData Set to false if the data is row-major.
+   * @return The largest final absolute maximum correlation of all targets.
+   */
+  double Train(const arma::mat& data,
+               const arma::mat& responses,
+               arma::mat& betas,
+               const bool transposeData = true);
+
   /**
    * Predict y_i for each data point in the given data matrix using the
    * currently-trained LARS model.
@@ -221,6 +300,19 @@ class LARS
                arma::rowvec& predictions,
                const bool rowMajor = false) const;
 
+  /**
+   * Predict y_i for each sparse data point in the given data matrix using the
+   * currently-trained LARS model.
+   *
+   * @param points The sparse data points to regress on.
+   * @param predictions y, which will contained calculated values on completion.
+   * @param rowMajor Should be true if the data points matrix is row-major and
+   *     false otherwise.
+   */
+  void Predict(const arma::sp_mat& points,
+               arma::rowvec& predictions,
+               const bool rowMajor = false) const;
+
   //! Access the set of active dimensions.
   const std::vector<size_t>& ActiveSet() const { return activeSet; }
 
@@ -290,6 +382,60 @@ class LARS
   //! Membership indicator for set of ignored variables.
   std::vector<bool> isIgnored;
 
+  /**
+   * Compute the Gram matrix of the given row-major data into matGramInternal,
+   * unless a Gram matrix of the right size is already available.
+   *
+   * @param dataRef Row-major input data.
+   */
+  void ComputeGram(const arma::mat& dataRef);
+
+  //! The Gram matrix of sparse data is never formed; see ActiveGramColumn().
+  void ComputeGram(const arma::sp_mat& /* dataRef */) { }
+
+  /**
+   * Compute the squared norm of dimension varInd, and its inner products with
+   * the dimensions of the active set, from the Gram matrix.
+   *
+   * @param dataRef Row-major input data.
+   * @param varInd Dimension to compute the inner products of.
+   * @param sqNorm Squared norm of the dimension.
+   * @param gramCol Vector to store the inner products into.
+   */
+  void ActiveGramColumn(const arma::mat& dataRef,
+                        const size_t varInd,
+                        double& sqNorm,
+                        arma::vec& gramCol) const;
+
+  /**
+   * Compute the squared norm of dimension varInd, and its inner products with
+   * the dimensions of the active set, from the sparse columns of the data.
+   *
+   * @param dataRef Row-major sparse input data.
+   * @param varInd Dimension to compute the inner products of.
+   * @param sqNorm Squared norm of the dimension.
+   * @param gramCol Vector to store the inner products into.
+   */
+  void ActiveGramColumn(const arma::sp_mat& dataRef,
+                        const size_t varInd,
+                        double& sqNorm,
+                        arma::vec& gramCol) const;
+
+  /**
+   * Run LARS on row-major data for one target, given X^T y.  For dense data,
+   * the Gram matrix is computed if it is not already available; for sparse
+   * data, it is never formed, and the Cholesky decomposition is always used.
+   *
+   * @param dataRef Row-major input data.
+   * @param vecXTy X^T y for the target.
+   * @param beta Vector to store the solution in.
+   * @return The final absolute maximum correlation.
+   */
+  template<typename MatType>
+  double TrainPath(const MatType& dataRef,
+                   const arma::vec& vecXTy,
+                   arma::vec& beta);
+
   /**
    * Remove activeVarInd'th element from active set.
    *
@@ -312,7 +458,8 @@ class LARS
   void Ignore(const size_t varInd);
 
   // compute "equiangular" direction in output space
-  void ComputeYHatDirection(const arma::mat& matX,
+  template<typename MatType>
+  void ComputeYHatDirection(const MatType& matX,
                             const arma::vec& betaDirection,
                             arma::vec& yHatDirection);
 
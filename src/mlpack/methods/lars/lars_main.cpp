@@ -12,6 +12,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/load.hpp>
 
 #include "lars.hpp"
 
@@ -66,6 +67,16 @@ PROGRAM_INFO("LARS",
     " a model can be passed via the " + PRINT_PARAM_STRING("input_model") +
     " parameter."
     "\n\n"
+    "Sparse data that is too large to hold as a dense matrix can be given "
+    "instead as a filename with the " + PRINT_PARAM_STRING("sparse_input") +
+    " and " + PRINT_PARAM_STRING("sparse_test") + " parameters, either as a "
+    "LibSVM file (whose labels are the responses, unless " +
+    PRINT_PARAM_STRING("responses") + " is given) or as a coordinate list with "
+    "one 'row column value' triple per line, where each column is a point.  "
+    "The Gram matrix is then never formed; the inner products of the "
+    "dimensions in the active set are computed from the sparse data, and the "
+    "Cholesky decomposition is always used."
+    "\n\n"
     "The program can also provide predictions for test data using either the "
     "trained model or the given input model.  Test points can be specified with"
     " the " + PRINT_PARAM_STRING("test") + " parameter.  Predicted responses "
@@ -112,6 +123,11 @@ PARAM_DOUBLE_IN("lambda2", "Regularization parameter for l2-norm penalty.", "L",
 PARAM_FLAG("use_cholesky", "Use Cholesky decomposition during computation "
     "rather than explicitly computing the full Gram matrix.", "c");
 
+PARAM_STRING_IN("sparse_input", "File containing sparse covariates (X), in "
+    "LibSVM format or as a coordinate list.", "s", "");
+PARAM_STRING_IN("sparse_test", "File containing sparse points to regress on, "
+    "in LibSVM format or as a coordinate list.", "S", "");
+
 static void mlpackMain()
 {
   double lambda1 = CLI::GetParam<double>("lambda1");
@@ -119,20 +135,58 @@ static void mlpackMain()
   bool useCholesky = CLI::HasParam("use_cholesky");
 
   // Check parameters -- make sure everything given makes sense.
-  RequireOnlyOnePassed({ "input", "input_model" }, true);
+  RequireOnlyOnePassed({ "input", "sparse_input", "input_model" }, true);
   if (CLI::HasParam("input"))
   {
     RequireOnlyOnePassed({ "responses" }, true, "if input data is specified, "
         "responses must also be specified");
   }
-  ReportIgnoredParam({{ "input", false }}, "responses");
+  ReportIgnoredParam({{ "input", false }, { "sparse_input", false }},
+      "responses");
+  RequireOnlyOnePassed({ "test", "sparse_test" }, false);
 
   RequireAtLeastOnePassed({ "output_predictions", "output_model" }, false,
       "no results will be saved");
-  ReportIgnoredParam({{ "test", true }}, "output_predictions");
+  if (!CLI::HasParam("test") && !CLI::HasParam("sparse_test"))
+    ReportIgnoredParam("output_predictions", "no test points are given");
 
   LARS* lars;
-  if (CLI::HasParam("input"))
+  if (CLI::HasParam("sparse_input"))
+  {
+    lars = new LARS(useCholesky, lambda1, lambda2);
+
+    // The sparse data is loaded with one point per column, so LARS transposes
+    // it.
+    const string filename = CLI::GetParam<string>("sparse_input");
+    sp_mat matX;
+    arma::rowvec y;
+    if (CLI::HasParam("responses"))
+    {
+      data::Load(filename, matX, true);
+      mat matY = std::move(CLI::GetParam<arma::mat>("responses"));
+      if (matY.n_cols == 1)
+        matY = trans(matY);
+      if (matY.n_rows > 1)
+      {
+        Log::Fatal << "Only one column or row allowed in responses file!"
+            << endl;
+      }
+      y = std::move(matY);
+    }
+    else
+    {
+      // The labels of a LibSVM file are the responses.
+      data::Load(filename, matX, y, true);
+    }
+
+    if (y.n_elem != matX.n_cols)
+      Log::Fatal << "Number of responses must be equal to number of points!"
+          << endl;
+
+    vec beta;
+    lars->Train(matX, y, beta, true /* transpose */);
+  }
+  else if (CLI::HasParam("input"))
   {
     // Initialize the object.
     lars = new LARS(useCholesky, lambda1, lambda2);
@@ -165,7 +219,29 @@ static void mlpackMain()
     lars = CLI::GetParam<LARS*>("input_model");
   }
 
-  if (CLI::HasParam("test"))
+  if (CLI::HasParam("sparse_test"))
+  {
+    Log::Info << "Regressing on sparse test points." << endl;
+
+    sp_mat testPoints;
+    data::Load(CLI::GetParam<string>("sparse_test"), testPoints, true);
+
+    // The file only has as many rows as its largest index, so it may have
+    // fewer dimensions than the model.
+    const size_t dimensions = lars->BetaPath().back().n_elem;
+    if (testPoints.n_rows > dimensions)
+      Log::Fatal << "Dimensionality of test set (" << testPoints.n_rows << ") "
+          << "is not equal to the dimensionality of the model ("
+          << dimensions << ")!" << endl;
+    testPoints.resize(dimensions, testPoints.n_cols);
+
+    arma::rowvec predictions;
+    lars->Predict(testPoints, predictions, false);
+
+    // Save test predictions (one per line).
+    CLI::GetParam<arma::mat>("output_predictions") = predictions.t();
+  }
+  else if (CLI::HasParam("test"))
   {
     Log::Info << "Regressing on test points." << endl;
 
@@ -34,6 +34,25 @@ LinearRegression::LinearRegression(const arma::mat& predictors,
   Train(predictors, responses, weights, intercept);
 }
 
+LinearRegression::LinearRegression(const arma::sp_mat& predictors,
+                                   const arma::rowvec& responses,
+                                   const double lambda,
+                                   const bool intercept) :
+    lambda(lambda),
+    intercept(intercept)
+{
+  Train(predictors, responses, intercept);
+}
+
+LinearRegression::LinearRegression(
+    const LinearRegressionAccumulator& accumulator,
+    const double lambda) :
+    lambda(lambda),
+    intercept(accumulator.Intercept())
+{
+  Train(accumulator);
+}
+
 double LinearRegression::Train(const arma::mat& predictors,
                                const arma::rowvec& responses,
                                const bool intercept)
@@ -88,6 +107,183 @@ double LinearRegression::Train(const arma::mat& predictors,
   return ComputeError(predictors, responses);
 }
 
+double LinearRegression::Train(const arma::sp_mat& predictors,
+                               const arma::rowvec& responses,
+                               const bool intercept,
+                               const size_t maxIterations,
+                               const double tolerance)
+{
+  return Train(predictors, responses, arma::rowvec(), intercept, maxIterations,
+      tolerance);
+}
+
+double LinearRegression::Train(const arma::sp_mat& predictors,
+                               const arma::rowvec& responses,
+                               const arma::rowvec& weights,
+                               const bool intercept,
+                               const size_t maxIterations,
+                               const double tolerance)
+{
+  this->intercept = intercept;
+
+  if (responses.n_elem != predictors.n_cols ||
+      (weights.n_elem > 0 && weights.n_elem != predictors.n_cols))
+  {
+    std::ostringstream oss;
+    oss << "LinearRegression::Train(): the data has " << predictors.n_cols
+        << " points, but " << responses.n_elem << " responses and "
+        << weights.n_elem << " weights were given!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The design matrix is A = [1; X] W^(1/2) (or X W^(1/2) without intercept),
+  // but it is only ever used through the products A^T b and A r.
+  const size_t offset = intercept ? 1 : 0;
+  const size_t dims = predictors.n_rows + offset;
+  const bool weighted = (weights.n_elem > 0);
+  const arma::rowvec sqrtWeights = weighted ? arma::rowvec(arma::sqrt(weights))
+      : arma::rowvec();
+
+  // A^T b: the (weighted) predictions of the parameters b.
+  auto predict = [&](const arma::vec& b, arma::rowvec& out)
+  {
+    if (predictors.n_rows > 0)
+      out = b.subvec(offset, dims - 1).t() * predictors;
+    else
+      out.zeros(predictors.n_cols);
+    if (intercept)
+      out += b[0];
+    if (weighted)
+      out %= sqrtWeights;
+  };
+
+  // A r: the correlation of the (weighted) residuals r with each dimension.
+  auto correlate = [&](const arma::rowvec& r, arma::vec& out)
+  {
+    out.set_size(dims);
+    const arma::rowvec weightedR = weighted ? arma::rowvec(r % sqrtWeights)
+        : r;
+    if (intercept)
+      out[0] = arma::accu(weightedR);
+    if (predictors.n_rows > 0)
+      out.subvec(offset, dims - 1) = predictors * weightedR.t();
+  };
+
+  // CGLS: conjugate gradients on (A A^T + lambda I) B = A y^T, keeping the
+  // residual r = y - A^T B instead of forming A A^T.
+  arma::rowvec r = weighted ? arma::rowvec(responses % sqrtWeights) :
+      responses;
+  parameters.zeros(dims);
+  arma::vec s;
+  correlate(r, s);
+  const double correlationNorm = arma::norm(s, 2);
+  arma::vec p = s;
+  arma::rowvec q;
+  double gamma = arma::dot(s, s);
+  const size_t iterations = (maxIterations == 0) ? dims : maxIterations;
+  size_t i = 0;
+  for (; i < iterations && std::sqrt(gamma) > tolerance * correlationNorm;
+      ++i)
+  {
+    predict(p, q);
+    const double delta = arma::dot(q, q) + lambda * arma::dot(p, p);
+    if (delta <= 0.0)
+      break;
+
+    const double alpha = gamma / delta;
+    parameters += alpha * p;
+    r -= alpha * q;
+
+    correlate(r, s);
+    s -= lambda * parameters;
+    const double newGamma = arma::dot(s, s);
+    p = s + (newGamma / gamma) * p;
+    gamma = newGamma;
+  }
+
+  Log::Info << "LinearRegression::Train(): " << i << " conjugate gradient "
+      << "iterations; relative residual " << ((correlationNorm > 0.0) ?
+      std::sqrt(gamma) / correlationNorm : 0.0) << "." << std::endl;
+
+  return ComputeError(predictors, responses);
+}
+
+double LinearRegression::Train(const LinearRegressionAccumulator& accumulator)
+{
+  intercept = accumulator.Intercept();
+
+  if (accumulator.TotalWeight() <= 0.0)
+  {
+    throw std::invalid_argument("LinearRegression::Train(): accumulator has "
+        "no training points!");
+  }
+
+  // As with the in-memory Train(), the regularization is applied to every
+  // parameter, including the intercept.
+  const arma::mat& gram = accumulator.Gram();
+  const arma::vec& moment = accumulator.Moment();
+  const arma::mat cov = gram +
+      lambda * arma::eye<arma::mat>(gram.n_rows, gram.n_rows);
+
+  // The regularized Gram matrix is symmetric positive definite unless the data
+  // is degenerate, so it can be solved with one Cholesky decomposition.
+  arma::mat upper;
+  if (arma::chol(upper, cov))
+  {
+    const arma::vec lower = arma::solve(arma::trimatl(upper.t()), moment);
+    parameters = arma::solve(arma::trimatu(upper), lower);
+  }
+  else
+  {
+    Log::Warn << "LinearRegression::Train(): Gram matrix is singular; "
+        << "consider setting lambda > 0." << std::endl;
+    parameters = arma::solve(cov, moment);
+  }
+
+  // The training error follows from the accumulated statistics:
+  //   || y - B^T X ||^2 = y y^T - 2 B^T X y^T + B^T X X^T B.
+  const double error = accumulator.SquaredResponses() -
+      2.0 * arma::dot(parameters, moment) +
+      arma::as_scalar(parameters.t() * gram * parameters);
+  return std::max(error, 0.0) / accumulator.TotalWeight();
+}
+
+double LinearRegression::Train(data::MatrixReader& predictors,
+                               data::MatrixReader& responses,
+                               const bool intercept,
+                               const size_t batchSize)
+{
+  if (responses.Dimensionality() != 1)
+  {
+    std::ostringstream oss;
+    oss << "LinearRegression::Train(): the responses have "
+        << responses.Dimensionality() << " dimensions, but should have 1";
+    throw std::invalid_argument(oss.str());
+  }
+
+  LinearRegressionAccumulator accumulator(predictors.Dimensionality(),
+      intercept);
+  arma::mat predictorBatch, responseBatch;
+  bool morePredictors = predictors.NextBatch(predictorBatch, batchSize);
+  bool moreResponses = responses.NextBatch(responseBatch, batchSize);
+  while (morePredictors && moreResponses &&
+      predictorBatch.n_cols == responseBatch.n_cols)
+  {
+    accumulator.Add(predictorBatch, responseBatch.row(0));
+
+    morePredictors = predictors.NextBatch(predictorBatch, batchSize);
+    moreResponses = responses.NextBatch(responseBatch, batchSize);
+  }
+
+  if (morePredictors || moreResponses)
+  {
+    throw std::runtime_error("LinearRegression::Train(): the predictors and "
+        "the responses don't have the same number of points");
+  }
+
+  return Train(accumulator);
+}
+
 void LinearRegression::Predict(const arma::mat& points,
     arma::rowvec& predictions) const
 {
@@ -112,6 +308,23 @@ void LinearRegression::Predict(const arma::mat& points,
   }
 }
 
+void LinearRegression::Predict(const arma::sp_mat& points,
+    arma::rowvec& predictions) const
+{
+  if (intercept)
+  {
+    Log::Assert(points.n_rows == parameters.n_rows - 1);
+    predictions = arma::trans(parameters.subvec(1, parameters.n_elem - 1))
+        * points;
+    predictions += parameters(0);
+  }
+  else
+  {
+    Log::Assert(points.n_rows == parameters.n_rows);
+    predictions = arma::trans(parameters) * points;
+  }
+}
+
 double LinearRegression::ComputeError(const arma::mat& predictors,
                                       const arma::rowvec& responses) const
 {
@@ -147,3 +360,19 @@ double LinearRegression::ComputeError(const arma::mat& predictors,
 
   return cost;
 }
+
+double LinearRegression::ComputeError(const arma::sp_mat& predictors,
+                                      const arma::rowvec& responses) const
+{
+  if (predictors.n_rows + (intercept ? 1 : 0) != parameters.n_rows)
+  {
+    Log::Fatal << "The test data must have the same number of columns as the "
+        "training file." << std::endl;
+  }
+
+  arma::rowvec temp;
+  Predict(predictors, temp);
+  temp = responses - temp;
+
+  return arma::dot(temp, temp) / predictors.n_cols;
+}
@@ -14,6 +14,9 @@
 #define MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/matrix_reader.hpp>
+
+#include "linear_regression_accumulator.hpp"
 
 namespace mlpack {
 namespace regression /** Regression methods. */ {
@@ -54,6 +57,30 @@ class LinearRegression
                    const double lambda = 0,
                    const bool intercept = true);
 
+  /**
+   * Creates the model from sparse data, solving the normal equations with
+   * conjugate gradients; see the sparse overload of Train().
+   *
+   * @param predictors X, sparse matrix of data points.
+   * @param responses y, the measured data for each point in X.
+   * @param lambda Regularization constant for ridge regression.
+   * @param intercept Whether or not to include an intercept term.
+   */
+  LinearRegression(const arma::sp_mat& predictors,
+                   const arma::rowvec& responses,
+                   const double lambda = 0,
+                   const bool intercept = true);
+
+  /**
+   * Creates the model from the normal equations accumulated over a stream of
+   * data.  Whether an intercept is fitted is given by the accumulator.
+   *
+   * @param accumulator Statistics of the training data.
+   * @param lambda Regularization constant for ridge regression.
+   */
+  LinearRegression(const LinearRegressionAccumulator& accumulator,
+                   const double lambda = 0);
+
   /**
    * Empty constructor.  This gives a non-working model, so make sure Train() is
    * called (or make sure the model parameters are set) before calling
@@ -95,6 +122,93 @@ class LinearRegression
                const arma::rowvec& weights,
                const bool intercept = true);
 
+  /**
+   * Train the LinearRegression model on sparse data.  The normal equations
+   * (X W X^T + lambda I) B = X W y^T are solved with conjugate gradients on the
+   * least squares problem (CGLS), which only needs the products of X and X^T
+   * with vectors, so neither X X^T nor a dense copy of X is ever formed and the
+   * memory used is linear in the number of nonzero elements.  The intercept is
+   * handled implicitly as an extra row of ones.  Careful! This will completely
+   * ignore and overwrite the existing model.  A std::invalid_argument is thrown
+   * if the number of responses (or weights) doesn't match the number of
+   * points.
+   *
+   * The iteration stops when the norm of the residual of the normal equations
+   * falls below tolerance times the norm of X W y^T, or after maxIterations
+   * iterations; if maxIterations is 0, it is the number of parameters, after
+   * which conjugate gradients would converge in exact arithmetic.  If lambda is
+   * 0 and the problem is underdetermined, the minimum-norm solution is found.
+   *
+   * @param predictors X, the sparse matrix of data points to train the model
+   *     on.
+   * @param responses y, the responses to the data points.
+   * @param weights Observation weights (for boosting); may be empty.
+   * @param intercept Whether or not to fit an intercept term.
+   * @param maxIterations Maximum number of conjugate gradient iterations (0
+   *     means the number of parameters).
+   * @param tolerance Relative tolerance for the conjugate gradient iterations.
+   * @return The least squares error after training.
+   */
+  double Train(const arma::sp_mat& predictors,
+               const arma::rowvec& responses,
+               const arma::rowvec& weights,
+               const bool intercept = true,
+               const size_t maxIterations = 0,
+               const double tolerance = 1e-10);
+
+  /**
+   * Train the LinearRegression model on sparse data, without weights.  See the
+   * weighted overload for details.
+   *
+   * @param predictors X, the sparse matrix of data points to train the model
+   *     on.
+   * @param responses y, the responses to the data points.
+   * @param intercept Whether or not to fit an intercept term.
+   * @param maxIterations Maximum number of conjugate gradient iterations (0
+   *     means the number of parameters).
+   * @param tolerance Relative tolerance for the conjugate gradient iterations.
+   * @return The least squares error after training.
+   */
+  double Train(const arma::sp_mat& predictors,
+               const arma::rowvec& responses,
+               const bool intercept = true,
+               const size_t maxIterations = 0,
+               const double tolerance = 1e-10);
+
+  /**
+   * Train the LinearRegression model on the normal equations accumulated by a
+   * LinearRegressionAccumulator, so that the training data never has to be in
+   * memory at once.  The system (X W X^T + lambda I) B = X W y^T is solved
+   * with a single Cholesky decomposition.  Careful! This will completely
+   * ignore and overwrite the existing model.  Whether an intercept is fitted
+   * is given by the accumulator.
+   *
+   * @param accumulator Statistics of the training data.
+   * @return The (weighted) least squares error on the training data.
+   */
+  double Train(const LinearRegressionAccumulator& accumulator);
+
+  /**
+   * Train the LinearRegression model on the points of the given readers, one
+   * batch at a time, so that the training data never has to be in memory at
+   * once.  The batches are added to a LinearRegressionAccumulator, and the
+   * next batch is read while the current one is accumulated.  Careful! This
+   * will completely ignore and overwrite the existing model.  A
+   * std::runtime_error is thrown if the readers don't have the same number of
+   * points.
+   *
+   * @param predictors Reader of X, the data points to train the model on.
+   * @param responses Reader of y, the responses to the data points, with one
+   *     dimension.
+   * @param intercept Whether or not to fit an intercept term.
+   * @param batchSize Number of points read at a time.
+   * @return The least squares error after training.
+   */
+  double Train(data::MatrixReader& predictors,
+               data::MatrixReader& responses,
+               const bool intercept = true,
+               const size_t batchSize = 10000);
+
   /**
    * Calculate y_i for each data point in points.
    *
@@ -103,6 +217,14 @@ class LinearRegression
    */
   void Predict(const arma::mat& points, arma::rowvec& predictions) const;
 
+  /**
+   * Calculate y_i for each sparse data point in points.
+   *
+   * @param points the sparse data points to calculate with.
+   * @param predictions y, will contain calculated values on completion.
+   */
+  void Predict(const arma::sp_mat& points, arma::rowvec& predictions) const;
+
   /**
    * Calculate the L2 squared error on the given predictors and responses using
    * this linear regression model. This calculation returns
@@ -123,6 +245,16 @@ class LinearRegression
   double ComputeError(const arma::mat& points,
                       const arma::rowvec& responses) const;
 
+  /**
+   * Calculate the L2 squared error on the given sparse predictors and
+   * responses, as the dense overload does.
+   *
+   * @param points Sparse matrix of predictors (X).
+   * @param responses Transposed vector of responses (y^T).
+   */
+  double ComputeError(const arma::sp_mat& points,
+                      const arma::rowvec& responses) const;
+
   //! Return the parameters (the b vector).
   const arma::vec& Parameters() const { return parameters; }
   //! Modify the parameters (the b vector).
@@ -0,0 +1,133 @@
+/**
+ * @file linear_regression_accumulator.cpp
+ *
+ * Implementation of the LinearRegressionAccumulator class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "linear_regression_accumulator.hpp"
+
+using namespace mlpack;
+using namespace mlpack::regression;
+
+LinearRegressionAccumulator::LinearRegressionAccumulator(
+    const size_t dimensionality,
+    const bool intercept) :
+    dimensionality(dimensionality),
+    intercept(intercept)
+{
+  Reset();
+}
+
+void LinearRegressionAccumulator::Reset()
+{
+  const size_t dim = intercept ? dimensionality + 1 : dimensionality;
+  gram.zeros(dim, dim);
+  moment.zeros(dim);
+  squaredResponses = 0.0;
+  totalWeight = 0.0;
+}
+
+void LinearRegressionAccumulator::Add(const arma::mat& predictors,
+                                      const arma::rowvec& responses)
+{
+  Add(predictors, responses, arma::rowvec());
+}
+
+void LinearRegressionAccumulator::Add(const arma::mat& predictors,
+                                      const arma::rowvec& responses,
+                                      const arma::rowvec& weights)
+{
+  if (predictors.n_rows != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "LinearRegressionAccumulator::Add(): predictors have "
+        << predictors.n_rows << " dimensions, but accumulator has "
+        << dimensionality << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (responses.n_elem != predictors.n_cols ||
+      (weights.n_elem > 0 && weights.n_elem != predictors.n_cols))
+  {
+    throw std::invalid_argument("LinearRegressionAccumulator::Add(): number "
+        "of responses and weights must match the number of points!");
+  }
+
+  const size_t points = predictors.n_cols;
+  const size_t block = blockSize;
+  const size_t numBlocks = (points + block - 1) / block;
+
+  // Each thread accumulates the statistics of its blocks of points, and the
+  // results are summed at the end.
+  #pragma omp parallel if (numBlocks > 1)
+  {
+    arma::mat localGram(arma::size(gram), arma::fill::zeros);
+    arma::vec localMoment(moment.n_elem, arma::fill::zeros);
+    double localSquaredResponses = 0.0;
+    double localTotalWeight = 0.0;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * block;
+      const size_t end = std::min(begin + block, points) - 1;
+
+      // Add the row of ones for the intercept, if needed.
+      arma::mat x;
+      if (intercept)
+      {
+        x = arma::join_cols(arma::ones<arma::rowvec>(end - begin + 1),
+            predictors.cols(begin, end));
+      }
+      else
+      {
+        x = predictors.cols(begin, end);
+      }
+      const arma::rowvec y = responses.subvec(begin, end);
+
+      if (weights.n_elem > 0)
+      {
+        const arma::rowvec w = weights.subvec(begin, end);
+        const arma::mat wx = x.each_row() % w;
+        localGram += wx * x.t();
+        localMoment += wx * y.t();
+        localSquaredResponses += arma::dot(w % y, y);
+        localTotalWeight += arma::accu(w);
+      }
+      else
+      {
+        localGram += x * x.t();
+        localMoment += x * y.t();
+        localSquaredResponses += arma::dot(y, y);
+        localTotalWeight += x.n_cols;
+      }
+    }
+
+    #pragma omp critical
+    {
+      gram += localGram;
+      moment += localMoment;
+      squaredResponses += localSquaredResponses;
+      totalWeight += localTotalWeight;
+    }
+  }
+}
+
+void LinearRegressionAccumulator::Add(const LinearRegressionAccumulator& other)
+{
+  if (other.dimensionality != dimensionality || other.intercept != intercept)
+  {
+    throw std::invalid_argument("LinearRegressionAccumulator::Add(): cannot "
+        "merge accumulators with different dimensionality or intercept "
+        "settings!");
+  }
+
+  gram += other.gram;
+  moment += other.moment;
+  squaredResponses += other.squaredResponses;
+  totalWeight += other.totalWeight;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file linear_regression_accumulator.hpp
+ *
+ * Definition of the LinearRegressionAccumulator class, which accumulates the
+ * normal equations of a linear regression problem over chunks of data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_ACCUMULATOR_HPP
+#define MLPACK_METHODS_LINEAR_REGRESSION_LINEAR_REGRESSION_ACCUMULATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace regression {
+
+/**
+ * Accumulate the sufficient statistics of a (possibly weighted) least squares
+ * problem: the Gram matrix X W X^T, the vector X W y^T, the weighted sum of
+ * squared responses y W y^T and the total weight, where X holds one point per
+ * column (with a leading row of ones if an intercept is fitted).  These take
+ * O(d^2) memory no matter how many points are added, so a LinearRegression
+ * model can be trained in one pass over data that does not fit in memory:
+ *
+ * @code
+ * LinearRegressionAccumulator accumulator(dimensionality);
+ * while (...)
+ * {
+ *   arma::mat chunk; // Load the next chunk of predictors...
+ *   arma::rowvec chunkResponses; // ...and its responses.
+ *   accumulator.Add(chunk, chunkResponses);
+ * }
+ *
+ * LinearRegression lr(accumulator, lambda);
+ * @endcode
+ *
+ * Each chunk passed to Add() is split into blocks of points which are
+ * accumulated in parallel with OpenMP; each thread keeps its own copy of the
+ * statistics, so this takes O(t d^2) memory for t threads.  Accumulators built
+ * on different parts of the data (for instance in different processes) can be
+ * merged with Add().
+ */
+class LinearRegressionAccumulator
+{
+ public:
+  /**
+   * Create an empty accumulator for points of the given dimensionality.
+   *
+   * @param dimensionality Number of dimensions of each point.
+   * @param intercept Whether or not an intercept term will be fitted.
+   */
+  LinearRegressionAccumulator(const size_t dimensionality = 0,
+                              const bool intercept = true);
+
+  /**
+   * Add the given points and responses to the statistics.
+   *
+   * @param predictors X, matrix of data points.
+   * @param responses y, the measured data for each point in X.
+   */
+  void Add(const arma::mat& predictors, const arma::rowvec& responses);
+
+  /**
+   * Add the given points, responses and observation weights to the
+   * statistics.
+   *
+   * @param predictors X, matrix of data points.
+   * @param responses y, the measured data for each point in X.
+   * @param weights Observation weights.
+   */
+  void Add(const arma::mat& predictors,
+           const arma::rowvec& responses,
+           const arma::rowvec& weights);
+
+  /**
+   * Merge the statistics of another accumulator into this one.  The other
+   * accumulator must have the same dimensionality and intercept setting.
+   *
+   * @param other Accumulator to merge.
+   */
+  void Add(const LinearRegressionAccumulator& other);
+
+  //! Reset the statistics, keeping the dimensionality and intercept setting.
+  void Reset();
+
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get whether an intercept term will be fitted.
+  bool Intercept() const { return intercept; }
+
+  //! Get the Gram matrix X W X^T.
+  const arma::mat& Gram() const { return gram; }
+  //! Get the vector X W y^T.
+  const arma::vec& Moment() const { return moment; }
+  //! Get the weighted sum of squared responses y W y^T.
+  double SquaredResponses() const { return squaredResponses; }
+  //! Get the total weight of the points (the number of points if unweighted).
+  double TotalWeight() const { return totalWeight; }
+
+  /**
+   * Serialize the accumulator, so that a pass over the data can be resumed.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(dimensionality);
+    ar & BOOST_SERIALIZATION_NVP(intercept);
+    ar & BOOST_SERIALIZATION_NVP(gram);
+    ar & BOOST_SERIALIZATION_NVP(moment);
+    ar & BOOST_SERIALIZATION_NVP(squaredResponses);
+    ar & BOOST_SERIALIZATION_NVP(totalWeight);
+  }
+
+ private:
+  //! Number of points in each block accumulated by one thread at a time.
+  static const size_t blockSize = 1024;
+
+  //! Dimensionality of the points.
+  size_t dimensionality;
+  //! Whether an intercept term will be fitted.
+  bool intercept;
+  //! The Gram matrix X W X^T.
+  arma::mat gram;
+  //! The vector X W y^T.
+  arma::vec moment;
+  //! The weighted sum of squared responses.
+  double squaredResponses;
+  //! The total weight of the points.
+  double totalWeight;
+};
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
@@ -12,6 +12,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/load.hpp>
 
 #include "linear_regression.hpp"
 
@@ -55,6 +56,16 @@ PROGRAM_INFO("Simple Linear Regression and Prediction",
     "of regression is related to least-angle regression, which mlpack "
     "implements as the 'lars' program."
     "\n\n"
+    "Sparse data that is too large to hold as a dense matrix can be given "
+    "instead as a filename with the " + PRINT_PARAM_STRING("sparse_training") +
+    " and " + PRINT_PARAM_STRING("sparse_test") + " parameters, either as a "
+    "LibSVM file (whose labels are the responses, unless " +
+    PRINT_PARAM_STRING("training_responses") + " is given) or as a coordinate "
+    "list with one 'row column value' triple per line.  The model is then "
+    "trained with conjugate gradients, which never form a dense copy of the "
+    "data or of the covariance matrix; " +
+    PRINT_PARAM_STRING("max_iterations") + " limits the number of iterations."
+    "\n\n"
     "For example, to run a linear regression on the dataset " +
     PRINT_DATASET("X") + " with responses " + PRINT_DATASET("y") + ", saving "
     "the trained model to " + PRINT_MODEL("lr_model") + ", the following "
@@ -97,13 +108,27 @@ PARAM_ROW_OUT("output_predictions", "If --test_file is specified, this "
 PARAM_DOUBLE_IN("lambda", "Tikhonov regularization for ridge regression.  If 0,"
     " the method reduces to linear regression.", "l", 0.0);
 
+PARAM_STRING_IN("sparse_training", "File containing a sparse training set X, "
+    "in LibSVM format or as a coordinate list.", "s", "");
+PARAM_STRING_IN("sparse_test", "File containing sparse test points X', in "
+    "LibSVM format or as a coordinate list.", "S", "");
+PARAM_INT_IN("max_iterations", "Maximum number of conjugate gradient "
+    "iterations for sparse training data (0 means the number of dimensions "
+    "plus one).", "n", 0);
+
 static void mlpackMain()
 {
   const double lambda = CLI::GetParam<double>("lambda");
 
-  RequireOnlyOnePassed({ "training", "input_model" }, true);
+  RequireOnlyOnePassed({ "training", "sparse_training", "input_model" }, true);
+  RequireOnlyOnePassed({ "test", "sparse_test" }, false);
+
+  if (!CLI::HasParam("test") && !CLI::HasParam("sparse_test"))
+    ReportIgnoredParam("output_predictions", "no test points are given");
+  ReportIgnoredParam({{ "sparse_training", false }}, "max_iterations");
 
-  ReportIgnoredParam({{ "test", true }}, "output_predictions");
+  RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; }, true,
+      "maximum number of iterations must not be negative");
 
   mat regressors;
   rowvec responses;
@@ -111,14 +136,15 @@ static void mlpackMain()
   LinearRegression* lr;
 
   const bool computeModel = !CLI::HasParam("input_model");
-  const bool computePrediction = CLI::HasParam("test");
+  const bool computePrediction = CLI::HasParam("test") ||
+      CLI::HasParam("sparse_test");
 
   // If they specified a model file, we also need a test file or we
   // have nothing to do.
   if (!computeModel)
   {
-    RequireAtLeastOnePassed({ "test" }, true, "test points must be specified "
-        "when an input model is given");
+    RequireAtLeastOnePassed({ "test", "sparse_test" }, true, "test points must "
+        "be specified when an input model is given");
   }
 
   ReportIgnoredParam({{ "input_model", true }}, "lambda");
@@ -126,8 +152,40 @@ static void mlpackMain()
   RequireAtLeastOnePassed({ "output_model", "output_predictions" }, false,
       "no output will be saved");
 
+  // A sparse input file was given, so we train on the sparse data.
+  if (CLI::HasParam("sparse_training"))
+  {
+    const string filename = CLI::GetParam<string>("sparse_training");
+    sp_mat sparseRegressors;
+
+    Timer::Start("load_regressors");
+    if (CLI::HasParam("training_responses"))
+    {
+      data::Load(filename, sparseRegressors, true);
+      responses = CLI::GetParam<rowvec>("training_responses");
+    }
+    else
+    {
+      // The labels of a LibSVM file are the responses.
+      data::Load(filename, sparseRegressors, responses, true);
+    }
+    Timer::Stop("load_regressors");
+
+    if (responses.n_cols != sparseRegressors.n_cols)
+    {
+      Log::Fatal << "The responses must have the same number of columns "
+          "as the training set." << endl;
+    }
+
+    Timer::Start("regression");
+    lr = new LinearRegression();
+    lr->Lambda() = lambda;
+    lr->Train(sparseRegressors, responses, true,
+        (size_t) CLI::GetParam<int>("max_iterations"));
+    Timer::Stop("regression");
+  }
   // An input file was given and we need to generate the model.
-  if (computeModel)
+  else if (computeModel)
   {
     Timer::Start("load_regressors");
     regressors = std::move(CLI::GetParam<mat>("training"));
@@ -172,7 +230,37 @@ static void mlpackMain()
   }
 
   // Did we want to predict, too?
-  if (computePrediction)
+  if (CLI::HasParam("sparse_test"))
+  {
+    // Load the sparse test points; any labels of a LibSVM file are ignored.
+    Timer::Start("load_test_points");
+    sp_mat points;
+    data::Load(CLI::GetParam<string>("sparse_test"), points, true);
+    Timer::Stop("load_test_points");
+
+    // The file only has as many rows as its largest index, so it may have
+    // fewer dimensions than the model.
+    const size_t dimensions = lr->Parameters().n_elem - 1;
+    if (points.n_rows > dimensions)
+    {
+      if (computeModel)
+        delete lr;
+
+      Log::Fatal << "The model was trained on " << dimensions << "-dimensional "
+          << "data, but the test points in '"
+          << CLI::GetParam<string>("sparse_test") << "' are " << points.n_rows
+          << "-dimensional!" << endl;
+    }
+    points.resize(dimensions, points.n_cols);
+
+    rowvec predictions;
+    Timer::Start("prediction");
+    lr->Predict(points, predictions);
+    Timer::Stop("prediction");
+
+    CLI::GetParam<rowvec>("output_predictions") = std::move(predictions);
+  }
+  else if (computePrediction)
   {
     // Load the test file data.
     Timer::Start("load_test_points");
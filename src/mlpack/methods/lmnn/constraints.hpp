@@ -26,6 +26,11 @@ namespace lmnn {
  * of each data point), Impostors() (used for calculating impostors of each
  * data point) and Triplets() (Generates sets of {dataset, target neighbors,
  * impostors} tripltets.)
+ *
+ * Every search skips the classes that have no query points, so recalculating
+ * the impostors of a few points only builds the trees of their classes.  The
+ * reference trees of several classes are built in parallel, and each search
+ * is parallelized over the query tree by NeighborSearch.
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class Constraints
@@ -205,6 +210,42 @@ class Constraints
   */
   inline void Precalculate(const arma::Row<size_t>& labels);
 
+  /**
+  * Split the points of the given batch by class.
+  *
+  * @param queries Indices of the batch points of each class.
+  * @param labels Input dataset labels.
+  * @param begin Index of the initial point of dataset.
+  * @param batchSize Number of data points to use.
+  */
+  inline void BatchQueries(std::vector<arma::uvec>& queries,
+                           const arma::Row<size_t>& labels,
+                           const size_t begin,
+                           const size_t batchSize);
+
+  /**
+  * For each class, search the k nearest neighbors of the query points of that
+  * class among the reference points of that class, and store them (and
+  * optionally their distances) in the columns of the query points.  Classes
+  * without query points are skipped.
+  *
+  * @param outputNeighbors Coordinates matrix to store neighbors.
+  * @param outputDistance Matrix to store distances; ignored if NULL.
+  * @param dataset Input dataset.
+  * @param norms Norms of the input dataset points.
+  * @param references Indices of the reference points of each class.
+  * @param queries Indices of the query points of each class.
+  * @param sameSet If true, the query points of each class are its reference
+  *     points, and a point is not returned as its own neighbor.
+  */
+  inline void Search(arma::Mat<size_t>& outputNeighbors,
+                     arma::mat* outputDistance,
+                     const arma::mat& dataset,
+                     const arma::vec& norms,
+                     const std::vector<arma::uvec>& references,
+                     const std::vector<arma::uvec>& queries,
+                     const bool sameSet);
+
   /**
   * Re-order neighbors on the basis of increasing norm in case
   * of ties among distances.
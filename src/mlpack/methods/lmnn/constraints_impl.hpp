@@ -87,30 +87,9 @@ void Constraints<MetricType>::TargetNeighbors(arma::Mat<size_t>& outputMatrix,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Perform KNN search with same class points as both reference
-    // set and query set.
-    knn.Train(dataset.cols(indexSame[i]));
-    knn.Search(k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexSame[i].at(neighbors(j));
-
-    // Store target neihbors.
-    outputMatrix.cols(indexSame[i]) = neighbors;
-  }
+  // Perform KNN search with same class points as both reference set and
+  // query set.
+  Search(outputMatrix, NULL, dataset, norms, indexSame, indexSame, true);
 }
 
 // Calculates k similar labeled nearest neighbors  on a
@@ -126,39 +105,12 @@ void Constraints<MetricType>::TargetNeighbors(arma::Mat<size_t>& outputMatrix,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
-  arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
+  std::vector<arma::uvec> queries;
+  BatchQueries(queries, labels, begin, batchSize);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Calculate Target Neighbors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
-
-    // Perform KNN search with same class points as both reference
-    // set and query set.
-    knn.Train(dataset.cols(indexSame[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexSame[i].at(neighbors(j));
-
-    // Store target neighbors.
-    outputMatrix.cols(begin + subIndexSame) = neighbors;
-  }
+  // Perform KNN search with same class points as reference set and the
+  // batch points of that class as query set.
+  Search(outputMatrix, NULL, dataset, norms, indexSame, queries, false);
 }
 
 // Calculates k differently labeled nearest neighbors.
@@ -171,30 +123,9 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Perform KNN search with differently labeled points as reference
-    // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputMatrix.cols(indexSame[i]) = neighbors;
-  }
+  // Perform KNN search with differently labeled points as reference
+  // set and same class points as query set.
+  Search(outputMatrix, NULL, dataset, norms, indexDiff, indexSame, false);
 }
 
 // Calculates k differently labeled nearest neighbors. The function
@@ -209,31 +140,10 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Perform KNN search with differently labeled points as reference
-    // set and  same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(indexSame[i]), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputNeighbors.cols(indexSame[i]) = neighbors;
-    outputDistance.cols(indexSame[i]) = distances;
-  }
+  // Perform KNN search with differently labeled points as reference
+  // set and same class points as query set.
+  Search(outputNeighbors, &outputDistance, dataset, norms, indexDiff,
+      indexSame, false);
 }
 
 // Calculates k differently labeled nearest neighbors on a
@@ -249,39 +159,12 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputMatrix,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
-  arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
+  std::vector<arma::uvec> queries;
+  BatchQueries(queries, labels, begin, batchSize);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
-
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputMatrix.cols(begin + subIndexSame) = neighbors;
-  }
+  // Perform KNN search with differently labeled points as reference
+  // set and same class points as query set.
+  Search(outputMatrix, NULL, dataset, norms, indexDiff, queries, false);
 }
 
 // Calculates k differently labeled nearest neighbors & distances on a
@@ -298,40 +181,13 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  arma::mat subDataset = dataset.cols(begin, begin + batchSize - 1);
-  arma::Row<size_t> sublabels = labels.cols(begin, begin + batchSize - 1);
+  std::vector<arma::uvec> queries;
+  BatchQueries(queries, labels, begin, batchSize);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
-
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Calculate impostors.
-    subIndexSame = arma::find(sublabels == uniqueLabels[i]);
-
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(subDataset.cols(subIndexSame), k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputNeighbors.cols(begin + subIndexSame) = neighbors;
-    outputDistance.cols(begin + subIndexSame) = distances;
-  }
+  // Perform KNN search with differently labeled points as reference
+  // set and same class points as query set.
+  Search(outputNeighbors, &outputDistance, dataset, norms, indexDiff, queries,
+      false);
 }
 
 // Calculates k differently labeled nearest neighbors & distances over some
@@ -345,42 +201,25 @@ void Constraints<MetricType>::Impostors(arma::Mat<size_t>& outputNeighbors,
                                         const arma::uvec& points,
                                         const size_t numPoints)
 {
+  // Nothing to do if the bounds of every point still hold.
+  if (numPoints == 0)
+    return;
+
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
-
-  arma::Mat<size_t> neighbors;
-  arma::mat distances;
-
-  // Vectors to store indices.
-  arma::uvec subIndexSame;
+  // Split the points by class.
+  const arma::uvec subPoints = points.head(numPoints);
+  const arma::Row<size_t> subLabels = labels.cols(subPoints);
+  std::vector<arma::uvec> queries(uniqueLabels.n_elem);
+  for (size_t i = 0; i < uniqueLabels.n_elem; i++)
+    queries[i] = subPoints.elem(arma::find(subLabels == uniqueLabels[i]));
 
-  for (size_t i = 0; i < uniqueLabels.n_cols; i++)
-  {
-    // Calculate impostors.
-    subIndexSame = arma::find(labels.cols(points.head(numPoints)) ==
-        uniqueLabels[i]);
-
-    // Perform KNN search with differently labeled points as reference
-    // set and same class points as query set.
-    knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(points.elem(subIndexSame)),
-        k, neighbors, distances);
-
-    // Re-order neighbors on the basis of increasing norm in case
-    // of ties among distances.
-    ReorderResults(distances, neighbors, norms);
-
-    // Re-map neighbors to their index.
-    for (size_t j = 0; j < neighbors.n_elem; j++)
-      neighbors(j) = indexDiff[i].at(neighbors(j));
-
-    // Store impostors.
-    outputNeighbors.cols(points.elem(subIndexSame)) = neighbors;
-    outputDistance.cols(points.elem(subIndexSame)) = distances;
-  }
+  // Perform KNN search with differently labeled points as reference
+  // set and same class points as query set.  Classes without any point to
+  // recalculate are skipped, so no tree is built for them.
+  Search(outputNeighbors, &outputDistance, dataset, norms, indexDiff, queries,
+      false);
 }
 
 // Generates {data point, target neighbors, impostors} triplets using
@@ -419,6 +258,85 @@ void Constraints<MetricType>::Triplets(arma::Mat<size_t>& outputMatrix,
   }
 }
 
+template<typename MetricType>
+inline void Constraints<MetricType>::BatchQueries(
+                                         std::vector<arma::uvec>& queries,
+                                         const arma::Row<size_t>& labels,
+                                         const size_t begin,
+                                         const size_t batchSize)
+{
+  const arma::Row<size_t> sublabels = labels.cols(begin,
+      begin + batchSize - 1);
+
+  queries.resize(uniqueLabels.n_elem);
+  for (size_t i = 0; i < uniqueLabels.n_elem; i++)
+    queries[i] = begin + arma::find(sublabels == uniqueLabels[i]);
+}
+
+template<typename MetricType>
+inline void Constraints<MetricType>::Search(
+    arma::Mat<size_t>& outputNeighbors,
+    arma::mat* outputDistance,
+    const arma::mat& dataset,
+    const arma::vec& norms,
+    const std::vector<arma::uvec>& references,
+    const std::vector<arma::uvec>& queries,
+    const bool sameSet)
+{
+  // Only the classes with query points need a search.
+  std::vector<size_t> classes;
+  for (size_t i = 0; i < queries.size(); i++)
+  {
+    if (queries[i].n_elem > 0)
+      classes.push_back(i);
+  }
+
+  if (classes.empty())
+    return;
+
+  // Building the reference tree of a class is serial, but the dual-tree search
+  // on it is already parallel.  So the trees of up to NumThreads() classes are
+  // built in parallel, and are then searched one after the other.  This also
+  // bounds the number of trees held in memory at once.
+  const size_t blockSize = std::min(NumThreads(), classes.size());
+  std::vector<KNN> knns(blockSize);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  for (size_t block = 0; block < classes.size(); block += blockSize)
+  {
+    const size_t blockEnd = std::min(block + blockSize, classes.size());
+
+    #pragma omp parallel for schedule(dynamic)
+    for (omp_size_t b = block; b < (omp_size_t) blockEnd; ++b)
+      knns[b - block].Train(dataset.cols(references[classes[b]]));
+
+    for (size_t b = block; b < blockEnd; b++)
+    {
+      const size_t c = classes[b];
+      if (sameSet)
+        knns[b - block].Search(k, neighbors, distances);
+      else
+        knns[b - block].Search(dataset.cols(queries[c]), k, neighbors,
+            distances);
+
+      // Re-map neighbors to their index.
+      for (size_t j = 0; j < neighbors.n_elem; j++)
+        neighbors(j) = references[c].at(neighbors(j));
+
+      // Re-order neighbors on the basis of increasing norm in case
+      // of ties among distances.
+      ReorderResults(distances, neighbors, norms);
+
+      // Store the results.
+      outputNeighbors.cols(queries[c]) = neighbors;
+      if (outputDistance)
+        outputDistance->cols(queries[c]) = distances;
+    }
+  }
+}
+
 template<typename MetricType>
 inline void Constraints<MetricType>::Precalculate(
                                          const arma::Row<size_t>& labels)
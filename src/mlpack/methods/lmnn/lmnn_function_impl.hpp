@@ -85,7 +85,7 @@ LMNNFunction<MetricType>::LMNNFunction(const arma::mat& dataset,
   }
 
   constraint.TargetNeighbors(targetNeighbors, dataset, labels, norm);
-  constraint.Impostors(impostors, dataset, labels, norm);
+  constraint.Impostors(impostors, distance, dataset, labels, norm);
 
   // Precalculate and save the gradient due to target neighbors.
   Precalculate();
@@ -120,9 +120,27 @@ void LMNNFunction<MetricType>::Shuffle()
     evalOld.slice(i) = newEvalOld.slice(ordering(i));
   }
 
-  // Re-calculate target neighbors as indices changed.
+  // The target neighbors and impostors of each point are unchanged by the
+  // shuffle, so the cached sets are permuted and re-indexed instead of being
+  // searched again.
+  arma::uvec newIndices(ordering.n_elem);
+  newIndices.elem(ordering) = arma::linspace<arma::uvec>(0,
+      ordering.n_elem - 1, ordering.n_elem);
+
+  arma::Mat<size_t> newTargetNeighbors = targetNeighbors.cols(ordering);
+  arma::Mat<size_t> newImpostors = impostors.cols(ordering);
+  for (size_t i = 0; i < newTargetNeighbors.n_elem; i++)
+  {
+    newTargetNeighbors[i] = newIndices[newTargetNeighbors[i]];
+    newImpostors[i] = newIndices[newImpostors[i]];
+  }
+
+  targetNeighbors = std::move(newTargetNeighbors);
+  impostors = std::move(newImpostors);
+  distance = arma::mat(distance.cols(ordering));
+
+  // The indices of each class changed.
   constraint.PreCalulated() = false;
-  constraint.TargetNeighbors(targetNeighbors, dataset, labels, norm);
 }
 
 // Update cache transformation matrices.
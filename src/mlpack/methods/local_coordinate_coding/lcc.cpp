@@ -34,32 +34,37 @@ void LocalCoordinateCoding::Encode(const arma::mat& data, arma::mat& codes)
       data.n_cols) + repmat(sum(square(data)), atoms, 1) - 2 * trans(dictionary)
       * data);
 
-  arma::mat dictGram = trans(dictionary) * dictionary;
-  arma::mat dictGramTD(dictGram.n_rows, dictGram.n_cols);
+  const arma::mat dictGram = trans(dictionary) * dictionary;
 
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; i++)
+
+  // Each point is an independent LARS problem, so the points are encoded in
+  // parallel.  Each thread keeps its own workspace for the weighted dictionary
+  // and its Gram matrix.
+  #pragma omp parallel
   {
-    // Report progress.
-    if ((i % 100) == 0)
+    arma::mat dictPrime(arma::size(dictionary));
+    arma::mat dictGramTD(arma::size(dictGram));
+
+    #pragma omp for schedule(dynamic)
+    for (omp_size_t i = 0; i < (omp_size_t) data.n_cols; ++i)
     {
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
+      // dictPrime = dictionary * diagmat(invW), and
+      // dictGramTD = diagmat(invW) * dictGram * diagmat(invW).
+      const arma::vec invW = invSqDists.unsafe_col(i);
+      dictPrime = dictionary.each_row() % trans(invW);
+      dictGramTD = (invW * trans(invW)) % dictGram;
+
+      bool useCholesky = false;
+      regression::LARS lars(useCholesky, dictGramTD, 0.5 * lambda);
+
+      // Run LARS for this point, by making an alias of the point and passing
+      // that.
+      arma::vec beta = codes.unsafe_col(i);
+      arma::rowvec responses = data.unsafe_col(i).t();
+      lars.Train(dictPrime, responses, beta, false);
+      beta %= invW; // Remember, beta is an alias of codes.col(i).
     }
-
-    arma::vec invW = invSqDists.unsafe_col(i);
-    arma::mat dictPrime = dictionary * diagmat(invW);
-
-    arma::mat dictGramTD = diagmat(invW) * dictGram * diagmat(invW);
-
-    bool useCholesky = false;
-    regression::LARS lars(useCholesky, dictGramTD, 0.5 * lambda);
-
-    // Run LARS for this point, by making an alias of the point and passing
-    // that.
-    arma::vec beta = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictPrime, responses, beta, false);
-    beta %= invW; // Remember, beta is an alias of codes.col(i).
   }
 }
 
@@ -67,141 +72,82 @@ void LocalCoordinateCoding::OptimizeDictionary(const arma::mat& data,
                                                const arma::mat& codes,
                                                const arma::uvec& adjacencies)
 {
-  // Count number of atomic neighbors for each point x^i.
-  arma::uvec neighborCounts = arma::zeros<arma::uvec>(data.n_cols, 1);
-  if (adjacencies.n_elem > 0)
-  {
-    // This gets the column index.  Intentional integer division.
-    size_t curPointInd = (size_t) (adjacencies(0) / atoms);
-    ++neighborCounts(curPointInd);
-
-    size_t nextColIndex = (curPointInd + 1) * atoms;
-    for (size_t l = 1; l < adjacencies.n_elem; l++)
-    {
-      // If l no longer refers to an element in this column, advance the column
-      // number accordingly.
-      if (adjacencies(l) >= nextColIndex)
-      {
-        curPointInd = (size_t) (adjacencies(l) / atoms);
-        nextColIndex = (curPointInd + 1) * atoms;
-      }
-
-      ++neighborCounts(curPointInd);
-    }
-  }
-
-  // Build dataPrime := [X x^1 ... x^1 ... x^n ... x^n]
-  // where each x^i is repeated for the number of neighbors x^i has.
-  arma::mat dataPrime = arma::zeros(data.n_rows,
-      data.n_cols + adjacencies.n_elem);
-
-  dataPrime(arma::span::all, arma::span(0, data.n_cols - 1)) = data;
-
-  size_t curCol = data.n_cols;
-  for (size_t i = 0; i < data.n_cols; i++)
-  {
-    if (neighborCounts(i) > 0)
-    {
-      dataPrime(arma::span::all, arma::span(curCol, curCol + neighborCounts(i)
-          - 1)) = repmat(data.col(i), 1, neighborCounts(i));
-    }
-    curCol += neighborCounts(i);
-  }
-
   // Handle the case of inactive atoms (atoms not used in the given coding).
+  const arma::uvec nonzeros = arma::sum(codes != 0, 1);
   std::vector<size_t> inactiveAtoms;
   for (size_t j = 0; j < atoms; ++j)
-    if (accu(codes.row(j) != 0) == 0)
+    if (nonzeros[j] == 0)
       inactiveAtoms.push_back(j);
 
   const size_t nInactiveAtoms = inactiveAtoms.size();
   const size_t nActiveAtoms = atoms - nInactiveAtoms;
 
-  // Efficient construction of codes restricted to active atoms.
-  arma::mat codesPrime = arma::zeros(nActiveAtoms, data.n_cols +
-      adjacencies.n_elem);
-  arma::vec wSquared = arma::ones(data.n_cols + adjacencies.n_elem, 1);
+  // Map each active atom to its index among the active atoms.
+  arma::uvec activeIndex(atoms);
+  size_t inactiveOffset = 0;
+  for (size_t i = 0; i < atoms; ++i)
+  {
+    if (inactiveOffset < nInactiveAtoms && inactiveAtoms[inactiveOffset] == i)
+      ++inactiveOffset;
+    else
+      activeIndex(i) = i - inactiveOffset;
+  }
 
+  // Codes restricted to active atoms.
+  arma::mat activeCodes;
   if (nInactiveAtoms > 0)
   {
     Log::Warn << "There are " << nInactiveAtoms
         << " inactive atoms.  They will be re-initialized randomly.\n";
 
-    // Create matrix holding only active codes.
-    arma::mat activeCodes;
     math::RemoveRows(codes, inactiveAtoms, activeCodes);
-
-    // Create reverse atom lookup for active atoms.
-    arma::uvec atomReverseLookup(atoms);
-    size_t inactiveOffset = 0;
-    for (size_t i = 0; i < atoms; ++i)
-    {
-      if (inactiveAtoms[inactiveOffset] == i)
-        ++inactiveOffset;
-      else
-        atomReverseLookup(i - inactiveOffset) = i;
-    }
-
-    codesPrime(arma::span::all, arma::span(0, data.n_cols - 1)) = activeCodes;
-
-    // Fill the rest of codesPrime.
-    for (size_t l = 0; l < adjacencies.n_elem; ++l)
-    {
-      // Recover the location in the codes matrix that this adjacency refers to.
-      size_t atomInd = adjacencies(l) % atoms;
-      size_t pointInd = (size_t) (adjacencies(l) / atoms);
-
-      // Fill matrix.
-      codesPrime(atomReverseLookup(atomInd), data.n_cols + l) = 1.0;
-      wSquared(data.n_cols + l) = codes(atomInd, pointInd);
-    }
   }
-  else
+  const arma::mat& codesRef = (nInactiveAtoms > 0) ? activeCodes : codes;
+
+  // The dictionary step is a weighted least squares problem over the data and,
+  // for each adjacency l between atom j and point i, one more copy of x^i
+  // whose code is e_j with weight w_l = lambda * |codes(j, i)|.  Instead of
+  // building those copies, collect the weights into a sparse matrix S with
+  // S(j, i) = w_l; then the normal equations are
+  //   A = codes codes^T + diagmat(S 1),  B = (codes + S) X^T,
+  // which are computed with a few large matrix products.
+  arma::umat locations(2, adjacencies.n_elem);
+  arma::vec values(adjacencies.n_elem);
+  for (size_t l = 0; l < adjacencies.n_elem; ++l)
   {
-    // All atoms are active.
-    codesPrime(arma::span::all, arma::span(0, data.n_cols - 1)) = codes;
-
-    for (size_t l = 0; l < adjacencies.n_elem; ++l)
-    {
-      // Recover the location in the codes matrix that this adjacency refers to.
-      size_t atomInd = adjacencies(l) % atoms;
-      size_t pointInd = (size_t) (adjacencies(l) / atoms);
+    // Recover the location in the codes matrix that this adjacency refers to.
+    const size_t atomInd = adjacencies(l) % atoms;
+    const size_t pointInd = (size_t) (adjacencies(l) / atoms);
 
-      // Fill matrix.
-      codesPrime(atomInd, data.n_cols + l) = 1.0;
-      wSquared(data.n_cols + l) = codes(atomInd, pointInd);
-    }
+    locations(0, l) = activeIndex(atomInd);
+    locations(1, l) = pointInd;
+    values(l) = lambda * std::abs(codes(atomInd, pointInd));
   }
+  const arma::sp_mat adjacencyWeights(true, locations, values, nActiveAtoms,
+      data.n_cols);
 
-  wSquared.subvec(data.n_cols, wSquared.n_elem - 1) = lambda *
-      abs(wSquared.subvec(data.n_cols, wSquared.n_elem - 1));
+  arma::mat A = codesRef * trans(codesRef);
+  A.diag() += arma::mat(arma::sum(adjacencyWeights, 1));
+  const arma::mat B = (codesRef + adjacencyWeights) * trans(data);
 
   // Solve system.
   if (nInactiveAtoms == 0)
   {
     // No inactive atoms.  We can solve directly.
-    arma::mat A = codesPrime * diagmat(wSquared) * trans(codesPrime);
-    arma::mat B = codesPrime * diagmat(wSquared) * trans(dataPrime);
-
     dictionary = trans(solve(A, B));
-    /*
-    dictionary = trans(solve(codesPrime * diagmat(wSquared) * trans(codesPrime),
-        codesPrime * diagmat(wSquared) * trans(dataPrime)));
-    */
   }
   else
   {
     // Inactive atoms must be reinitialized randomly, so we cannot solve
     // directly for the entire dictionary estimate.
-    arma::mat dictionaryActive =
-      trans(solve(codesPrime * diagmat(wSquared) * trans(codesPrime),
-                  codesPrime * diagmat(wSquared) * trans(dataPrime)));
+    arma::mat dictionaryActive = trans(solve(A, B));
 
     // Update all atoms.
     size_t currentInactiveIndex = 0;
     for (size_t i = 0; i < atoms; ++i)
     {
-      if (inactiveAtoms[currentInactiveIndex] == i)
+      if (currentInactiveIndex < nInactiveAtoms &&
+          inactiveAtoms[currentInactiveIndex] == i)
       {
         // This atom is inactive.  Reinitialize it randomly.
         dictionary.col(i) = (data.col(math::RandInt(data.n_cols)) +
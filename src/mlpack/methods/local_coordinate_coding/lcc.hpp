@@ -146,7 +146,8 @@ class LocalCoordinateCoding
                    DictionaryInitializer());
 
   /**
-   * Code each point via distance-weighted LARS.
+   * Code each point via distance-weighted LARS.  Each point is an independent
+   * LARS problem, so the points are coded in parallel with OpenMP.
    *
    * @param data Matrix containing points to encode.
    * @param codes Output matrix to store codes in.
@@ -15,6 +15,7 @@
 #define MLPACK_METHODS_LOGISTIC_REGRESSION_LOGISTIC_REGRESSION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/cv/warm_start_traits.hpp>
 #include <ensmallen.hpp>
 
 #include "logistic_regression_function.hpp"
@@ -33,6 +34,19 @@ namespace regression {
  * class is restricted to support only two classes.  For multiclass logistic
  * regression, see mlpack::regression::SoftmaxRegression.
  *
+ * For very sparse, high-dimensional data, the model can be trained with the
+ * lock-free parallel SGD optimizer ens::ParallelSGD (Hogwild!), which uses the
+ * sparse gradients of LogisticRegressionFunction and only updates the
+ * parameters of the features that are nonzero in each point:
+ *
+ * @code
+ * LogisticRegression<arma::sp_mat> lr(dataset.n_rows, lambda);
+ * ens::ParallelSGD<ens::ConstantStep> optimizer(maxIterations,
+ *     std::ceil((double) dataset.n_cols / omp_get_max_threads()), tolerance,
+ *     true, ens::ConstantStep(stepSize));
+ * lr.Train(dataset, responses, optimizer);
+ * @endcode
+ *
  * @tparam MatType Type of data matrix.
  */
 template<typename MatType = arma::mat>
@@ -243,6 +257,40 @@ class LogisticRegression
 };
 
 } // namespace regression
+
+namespace cv {
+
+/**
+ * LogisticRegression models are warm-started in cross-validation by training
+ * them from their current parameters with the new lambda.
+ */
+template<typename MatType>
+struct WarmStartTraits<regression::LogisticRegression<MatType>>
+{
+  static const bool IsSupported = true;
+
+  static void Train(regression::LogisticRegression<MatType>& model,
+                    const MatType& predictors,
+                    const arma::Row<size_t>& responses,
+                    const double lambda = 0)
+  {
+    model.Lambda() = lambda;
+    model.Train(predictors, responses);
+  }
+
+  //! Train from scratch with other arguments (like an optimizer).
+  template<typename... Args>
+  static void Train(regression::LogisticRegression<MatType>& model,
+                    const MatType& predictors,
+                    const arma::Row<size_t>& responses,
+                    const Args&... args)
+  {
+    model = regression::LogisticRegression<MatType>(predictors, responses,
+        args...);
+  }
+};
+
+} // namespace cv
 } // namespace mlpack
 
 // Include implementation.
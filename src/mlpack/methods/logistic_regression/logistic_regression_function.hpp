@@ -54,6 +54,8 @@ class LogisticRegressionFunction
 
   /**
   * Shuffle the order of function visitation.  This may be called by the optimizer.
+  * The data is not copied: only the order in which the separable functions
+  * visit the points is shuffled, and each batch is gathered through it.
   */
   void Shuffle();
 
@@ -119,6 +121,31 @@ class LogisticRegressionFunction
                 GradType& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the gradient of the logistic regression log-likelihood function
+   * with the given parameters, for the given batch size from a given point in
+   * the dataset, as a sparse matrix.  Only the intercept and the features that
+   * are nonzero in at least one point of the batch have a gradient, so the
+   * cost depends on the number of nonzero elements of the batch, not the
+   * dimensionality of the data.  This is used by optimizers that apply sparse
+   * updates, such as ens::ParallelSGD (Hogwild!).
+   *
+   * The L2-regularization term is only applied to the features that are
+   * nonzero in the batch, so that features that do not appear in a point are
+   * not updated by it.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the starting point to use for objective function
+   *     gradient evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *     function gradient evaluation.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
   /**
    * Evaluate the gradient of the logistic regression log-likelihood function
    * with the given parameters, and with respect to only one feature in the
@@ -160,12 +187,21 @@ class LogisticRegressionFunction
  private:
   //! The initial point, from which to start the optimization.
   arma::mat initialPoint;
-  //! The matrix of data points (predictors).  This is an alias until shuffling
-  //! is done.
+  //! Gather the points of the given batch, in the shuffled order.
+  MatType BatchPredictors(const size_t begin, const size_t batchSize) const;
+  //! Gather the responses of the given batch, in the shuffled order.
+  arma::Row<size_t> BatchResponses(const size_t begin,
+                                   const size_t batchSize) const;
+
+  //! The matrix of data points (predictors).  This is an alias of the input
+  //! data if possible.
   MatType predictors;
-  //! The vector of responses to the input data points.  This is an alias until
-  //! shuffling is done.
+  //! The vector of responses to the input data points.  This is an alias of
+  //! the input data if possible.
   arma::Row<size_t> responses;
+  //! The order in which the separable functions visit the points (empty until
+  //! Shuffle() is called).
+  arma::uvec ordering;
   //! The regularization parameter for L2-regularization.
   double lambda;
 };
@@ -66,18 +66,33 @@ LogisticRegressionFunction<MatType>::LogisticRegressionFunction(
 template<typename MatType>
 void LogisticRegressionFunction<MatType>::Shuffle()
 {
-  MatType newPredictors;
-  arma::Row<size_t> newResponses;
+  // Only the order of the points is shuffled; the batches are gathered
+  // through it.
+  ordering = arma::shuffle(arma::linspace<arma::uvec>(0,
+      predictors.n_cols - 1, predictors.n_cols));
+}
+
+template<typename MatType>
+MatType LogisticRegressionFunction<MatType>::BatchPredictors(
+    const size_t begin,
+    const size_t batchSize) const
+{
+  if (ordering.is_empty())
+    return MatType(predictors.cols(begin, begin + batchSize - 1));
 
-  math::ShuffleData(predictors, responses, newPredictors, newResponses);
+  return math::GatherColumns(predictors,
+      ordering.subvec(begin, begin + batchSize - 1));
+}
 
-  // If we are an alias, make sure we don't write to the original data.
-  math::ClearAlias(predictors);
-  math::ClearAlias(responses);
+template<typename MatType>
+arma::Row<size_t> LogisticRegressionFunction<MatType>::BatchResponses(
+    const size_t begin,
+    const size_t batchSize) const
+{
+  if (ordering.is_empty())
+    return responses.subvec(begin, begin + batchSize - 1);
 
-  // Take ownership of the new data.
-  predictors = std::move(newPredictors);
-  responses = std::move(newResponses);
+  return responses.cols(ordering.subvec(begin, begin + batchSize - 1));
 }
 
 /**
@@ -130,6 +145,10 @@ double LogisticRegressionFunction<MatType>::Evaluate(
                   const size_t begin,
                   const size_t batchSize) const
 {
+  // Gather the points of the batch, in the shuffled order.
+  const MatType batch = BatchPredictors(begin, batchSize);
+  const arma::Row<size_t> batchResponses = BatchResponses(begin, batchSize);
+
   // Calculate the regularization term.
   const double regularization = lambda *
       (batchSize / (2.0 * predictors.n_cols)) *
@@ -138,12 +157,10 @@ double LogisticRegressionFunction<MatType>::Evaluate(
 
   // Calculate the sigmoid function values.
   const arma::rowvec sigmoid = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
+      parameters.tail_cols(parameters.n_elem - 1) * batch)));
 
   // Compute the objective for the given batch size from a given point.
-  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
-      begin + batchSize - 1));
+  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(batchResponses);
   const double result = arma::accu(arma::log(1.0 - respD + sigmoid %
       (2 * respD - 1.0)));
 
@@ -180,23 +197,72 @@ void LogisticRegressionFunction<MatType>::Gradient(
                 GradType& gradient,
                 const size_t batchSize) const
 {
+  // Gather the points of the batch, in the shuffled order.
+  const MatType batch = BatchPredictors(begin, batchSize);
+  const arma::Row<size_t> batchResponses = BatchResponses(begin, batchSize);
+
   // Regularization term.
   arma::mat regularization;
   regularization = lambda * parameters.tail_cols(parameters.n_elem - 1)
       / predictors.n_cols * batchSize;
 
   const arma::rowvec exponents = parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1);
+      parameters.tail_cols(parameters.n_elem - 1) * batch;
   // Calculating the sigmoid function values.
   const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-exponents));
 
   gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+  gradient[0] = -arma::accu(batchResponses - sigmoids);
+  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - batchResponses) *
+      batch.t() + regularization;
+}
+
+//! Evaluate the sparse gradient of the logistic regression objective function
+//! for a given batch size.
+template<typename MatType>
+void LogisticRegressionFunction<MatType>::Gradient(
+                const arma::mat& parameters,
+                const size_t begin,
+                arma::sp_mat& gradient,
+                const size_t batchSize) const
+{
+  const arma::sp_mat batch(BatchPredictors(begin, batchSize));
+  const arma::Row<size_t> batchResponses = BatchResponses(begin, batchSize);
+
+  // Calculating the sigmoid function values.
+  const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
+      parameters.tail_cols(parameters.n_elem - 1) * batch)));
+  const arma::rowvec diffs = sigmoids -
+      arma::conv_to<arma::rowvec>::from(batchResponses);
+
+  // Each nonzero element of the batch contributes to the gradient of its
+  // feature; the contributions to the same feature are added together when the
+  // sparse matrix is built.
+  arma::umat locations(2, batch.n_nonzero + 1, arma::fill::zeros);
+  arma::vec values(batch.n_nonzero + 1);
+  values[0] = arma::accu(diffs);
+  size_t k = 1;
+  for (arma::sp_mat::const_iterator it = batch.begin(); it != batch.end();
+       ++it, ++k)
+  {
+    locations(1, k) = it.row() + 1;
+    values[k] = diffs[it.col()] * (*it);
+  }
+
+  gradient = arma::sp_mat(true, locations, values, parameters.n_rows,
+      parameters.n_cols, true, false);
+
+  // Regularization term, for the features in the batch only.
+  if (lambda != 0.0)
+  {
+    const double scale = lambda / predictors.n_cols * batchSize;
+    for (arma::sp_mat::iterator it = gradient.begin(); it != gradient.end();
+         ++it)
+    {
+      if (it.col() > 0)
+        *it += scale * parameters(0, it.col());
+    }
+  }
 }
 
 /**
@@ -265,6 +331,10 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
     GradType& gradient,
     const size_t batchSize) const
 {
+  // Gather the points of the batch, in the shuffled order.
+  const MatType batch = BatchPredictors(begin, batchSize);
+  const arma::Row<size_t> batchResponses = BatchResponses(begin, batchSize);
+
   // Regularization term.
   arma::mat regularization =
       lambda * parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
@@ -277,19 +347,15 @@ double LogisticRegressionFunction<MatType>::EvaluateWithGradient(
 
   // Calculate the sigmoid function values.
   const arma::rowvec sigmoids = 1.0 / (1.0 + arma::exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
+      parameters.tail_cols(parameters.n_elem - 1) * batch)));
 
   gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -arma::accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+  gradient[0] = -arma::accu(batchResponses - sigmoids);
+  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - batchResponses) *
+      batch.t() + regularization;
 
   // Now compute the objective function using the sigmoids.
-  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(responses.subvec(begin,
-      begin + batchSize - 1));
+  arma::rowvec respD = arma::conv_to<arma::rowvec>::from(batchResponses);
   const double result = arma::accu(arma::log(1.0 - respD + sigmoids %
       (2 * respD - 1.0)));
 
@@ -48,7 +48,10 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/methods/neighbor_search/sort_policies/nearest_neighbor_sort.hpp>
 
+#include <algorithm>
 #include <queue>
+#include <unordered_map>
+#include <boost/dynamic_bitset.hpp>
 
 namespace mlpack {
 namespace neighbor {
@@ -188,6 +191,21 @@ class LSHSearch
              const size_t bucketSize = 500,
              const arma::cube& projection = arma::cube());
 
+  /**
+   * Insert new points into the reference set, hashing them into the existing
+   * tables with the existing projections and offsets, so that the model is not
+   * retrained.  The new points get the indices after those of the current
+   * reference set.  As in Train(), points that fall into a full bucket are not
+   * stored in that bucket.
+   *
+   * Room is left at the end of each bucket that grows, so that the buckets are
+   * only moved when one of them runs out of room, and the cost of the moves is
+   * amortized over the insertions.
+   *
+   * @param newPoints Points to insert.
+   */
+  void Insert(const arma::mat& newPoints);
+
   /**
    * Compute the nearest neighbors of the points in the given query set and
    * store the output in the given matrices.  The matrices will be set to the
@@ -280,9 +298,15 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  //! Get the second hash table, which holds the points of all of the buckets
+  //! one after the other.  After Insert(), buckets may have unused slots at
+  //! their end, and the table may have unused slots after the last bucket;
+  //! unused slots hold SIZE_MAX.
+  const arma::Col<size_t>& SecondHashTable() const { return secondHashTable; }
+
+  //! Get the offsets of the buckets in the second hash table; the points of
+  //! the bucket in row i are in [BucketOffsets()[i], BucketOffsets()[i + 1]).
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -297,24 +321,56 @@ class LSHSearch
 
  private:
   /**
-   * This function takes a query and hashes it into each of the hash tables to
-   * get keys for the query and then the key is hashed to a bucket of the second
-   * hash table and all the points (if any) in those buckets are collected as
-   * the potential neighbor candidates.
+   * Compute the index of the bucket of the second hash table that each of the
+   * given points is hashed to in each table.  Row i of secondHashVectors holds
+   * the buckets for table i.
+   *
+   * @param points Points to hash.
+   * @param secondHashVectors Matrix storing the bucket of each point in each
+   *     table.
+   */
+  void HashPoints(const arma::mat& points,
+                  arma::Mat<size_t>& secondHashVectors) const;
+
+  //! Get the number of points stored in the bucket held in the given row.
+  size_t BucketFill(const size_t row) const;
+
+  /**
+   * Project a block of consecutive points with the projections of each of the
+   * first numTablesToSearch tables (and add the offsets), using one matrix
+   * multiplication per table.  Slice i of queryCodes holds the projections of
+   * point (begin + i), with one column per table.
+   *
+   * @param points Set of points to project.
+   * @param begin Index of the first point of the block.
+   * @param count Number of points in the block.
+   * @param numTablesToSearch The number of tables to project the points for.
+   * @param queryCodes Cube storing the projections of each point of the block.
+   */
+  void ProjectPoints(const arma::mat& points,
+                     const size_t begin,
+                     const size_t count,
+                     const size_t numTablesToSearch,
+                     arma::cube& queryCodes) const;
+
+  /**
+   * This function takes the projections of a query in each of the hash tables
+   * (as computed by ProjectPoints()) to get keys for the query and then the
+   * key is hashed to a bucket of the second hash table and all the points (if
+   * any) in those buckets are collected as the potential neighbor candidates.
    *
-   * @param queryPoint The query point currently being processed.
+   * @param queryCodesNotFloored The projections of the query currently being
+   *    processed, with one column per table to search.
    * @param referenceIndices The list of neighbor candidates obtained from
    *    hashing the query into all the hash tables and eventually into
    *    multiple buckets of the second hash table.
-   * @param numTablesToSearch The number of tables to perform the search in. If
-   *    0, all tables are searched.
+   * @param numTablesToSearch The number of tables to perform the search in.
    * @param T The number of additional probing bins for multiprobe LSH. If 0,
    *    single-probe is used.
    */
-  template<typename VecType>
-  void ReturnIndicesFromTable(const VecType& queryPoint,
+  void ReturnIndicesFromTable(const arma::mat& queryCodesNotFloored,
                               arma::uvec& referenceIndices,
-                              size_t numTablesToSearch,
+                              const size_t numTablesToSearch,
                               const size_t T) const;
 
   /**
@@ -383,7 +439,7 @@ class LSHSearch
    * @param A perturbation set to compute the score of.
    * @param scores vector containing score of each perturbation.
   */
-  double PerturbationScore(const std::vector<bool>& A,
+  double PerturbationScore(const boost::dynamic_bitset<>& A,
                            const arma::vec& scores) const;
 
   /**
@@ -393,7 +449,7 @@ class LSHSearch
    *
    * @param A perturbation set to shift.
    */
-  bool PerturbationShift(std::vector<bool>& A) const;
+  bool PerturbationShift(boost::dynamic_bitset<>& A) const;
 
   /**
    * Inline function used by GetAdditionalProbingBins. The vector expansion
@@ -403,7 +459,7 @@ class LSHSearch
    *
    * @param A perturbation set to expand.
    */
-  bool PerturbationExpand(std::vector<bool>& A) const;
+  bool PerturbationExpand(boost::dynamic_bitset<>& A) const;
 
   /**
    * Return true if perturbation set A is valid. A perturbation set is invalid
@@ -411,8 +467,10 @@ class LSHSearch
    * that are larger than the queryCode's dimensions.
    *
    * @param A perturbation set to validate.
+   * @param positions vector containing the dimension of each perturbation.
    */
-  bool PerturbationValid(const std::vector<bool>& A) const;
+  bool PerturbationValid(const boost::dynamic_bitset<>& A,
+                         const arma::Col<size_t>& positions) const;
 
   //! Reference dataset.
   arma::mat referenceSet;
@@ -440,13 +498,14 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The final hash table: the (<= bucketSize) points of each of the
+  //! (< secondHashSize) non-empty buckets, stored one bucket after the other.
+  //! Unused slots (left for points inserted later) hold SIZE_MAX.
+  arma::Col<size_t> secondHashTable;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The offset of each bucket in secondHashTable, with one extra element at
+  //! the end holding the end of the last bucket.
+  arma::Col<size_t> bucketOffsets;
 
   //! For a particular hash value, points to the row in secondHashTable
   //! corresponding to this value. Length secondHashSize.
@@ -476,7 +535,7 @@ class LSHSearch
 
 //! Set the serialization version of the LSHSearch class.
 BOOST_TEMPLATE_CLASS_VERSION(template<typename SortPolicy>,
-    mlpack::neighbor::LSHSearch<SortPolicy>, 1);
+    mlpack::neighbor::LSHSearch<SortPolicy>, 2);
 
 // Include implementation.
 #include "lsh_search_impl.hpp"
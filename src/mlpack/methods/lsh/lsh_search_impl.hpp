@@ -84,7 +84,7 @@ LSHSearch<SortPolicy>::LSHSearch(const LSHSearch& other) :
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
     secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
+    bucketOffsets(other.bucketOffsets),
     bucketRowInHashTable(other.bucketRowInHashTable),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -104,7 +104,7 @@ LSHSearch<SortPolicy>::LSHSearch(LSHSearch&& other) :
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
     secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
+    bucketOffsets(std::move(other.bucketOffsets)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -131,7 +131,7 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(const LSHSearch& other)
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
   secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
+  bucketOffsets = other.bucketOffsets;
   bucketRowInHashTable = other.bucketRowInHashTable;
   distanceEvaluations = other.distanceEvaluations;
 
@@ -152,7 +152,7 @@ LSHSearch<SortPolicy>& LSHSearch<SortPolicy>::operator=(LSHSearch&& other)
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
   secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
+  bucketOffsets = std::move(other.bucketOffsets);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
   distanceEvaluations = other.distanceEvaluations;
 
@@ -251,27 +251,239 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
         "tables provided must be equal to numProj");
   }
 
+  // Step IV and V: hash each point of the reference set in each table.
+  arma::Mat<size_t> secondHashVectors;
+  HashPoints(this->referenceSet, secondHashVectors);
+
+  // Now, using the hash vectors for each table, count the number of rows we
+  // have in the second hash table.
+  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
+  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
+    secondHashBinCounts[secondHashVectors[i]]++;
+
+  // Enforce the maximum bucket size.
+  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
+      { return std::min(val, effectiveBucketSize); });
+
+  // The buckets are stored one after the other in 'secondHashTable' (in the
+  // order in which they are first seen), and the points of the bucket in row r
+  // are held in [bucketOffsets[r], bucketOffsets[r + 1]).  So first we find the
+  // row of each bucket and the offsets of the rows.
+  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
+  bucketOffsets.set_size(numRowsInTable + 1);
+  bucketOffsets[0] = 0;
+  size_t currentRow = 0;
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      const size_t hashInd = secondHashVectors(i, j);
+      if (bucketRowInHashTable[hashInd] == secondHashSize)
+      {
+        bucketRowInHashTable[hashInd] = currentRow;
+        bucketOffsets[currentRow + 1] = bucketOffsets[currentRow] +
+            secondHashBinCounts[hashInd];
+        currentRow++;
+      }
+    }
+  }
+
+  // Next we must assign each point in each table to the right bucket, until
+  // the bucket is full.
+  secondHashTable.set_size(bucketOffsets[numRowsInTable]);
+  arma::Col<size_t> rowEnds = bucketOffsets.head(numRowsInTable);
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; j++)
+    {
+      // The point ID is 'j'.
+      const size_t row = bucketRowInHashTable[secondHashVectors(i, j)];
+      if (rowEnds[row] < bucketOffsets[row + 1])
+        secondHashTable[rowEnds[row]++] = j;
+    } // Loop over all points in the reference set.
+  } // Loop over tables.
+
+  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
+            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
+            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
+            << std::endl;
+}
+
+// Insert new points into the hash tables.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::Insert(const arma::mat& newPoints)
+{
+  if (numTables == 0)
+  {
+    throw std::invalid_argument("LSHSearch::Insert(): the model must be "
+        "trained before points can be inserted");
+  }
+
+  if (newPoints.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "LSHSearch::Insert(): dimensionality of new points ("
+        << newPoints.n_rows << ") is not equal to the dimensionality the "
+        << "model was trained on (" << referenceSet.n_rows << ")!" << std::endl;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (newPoints.n_cols == 0)
+    return;
+
+  const size_t firstId = referenceSet.n_cols;
+  referenceSet.insert_cols(firstId, newPoints);
+
+  // The new points are hashed with the existing projections and offsets.
+  arma::Mat<size_t> secondHashVectors;
+  HashPoints(newPoints, secondHashVectors);
+
+  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
+  const size_t numRows = bucketOffsets.n_elem - 1;
+
+  // Find the buckets that the new points fall into, giving a new row to each
+  // bucket that did not exist yet, and count the points for each bucket.  Only
+  // the rows that are touched are looked at, so that inserting a few points
+  // does not cost as much as rehashing the reference set.
+  std::unordered_map<size_t, size_t> rowIndex;
+  std::vector<size_t> touchedRows, rowFill, rowAdded;
+  size_t newRows = 0;
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      const size_t hashInd = secondHashVectors(i, j);
+      if (bucketRowInHashTable[hashInd] == secondHashSize)
+        bucketRowInHashTable[hashInd] = numRows + newRows++;
+
+      const size_t row = bucketRowInHashTable[hashInd];
+      std::unordered_map<size_t, size_t>::const_iterator it =
+          rowIndex.find(row);
+      if (it == rowIndex.end())
+      {
+        rowIndex[row] = touchedRows.size();
+        touchedRows.push_back(row);
+        rowFill.push_back((row < numRows) ? BucketFill(row) : 0);
+        rowAdded.push_back(1);
+      }
+      else
+      {
+        ++rowAdded[it->second];
+      }
+    }
+  }
+
+  // Compute the capacity that each row needs.  A bucket that overflows gets
+  // twice the space it needs, so that the storage of each bucket grows
+  // geometrically and the cost of moving the buckets is amortized.
+  arma::Col<size_t> capacities(numRows + newRows);
+  for (size_t r = 0; r < numRows; ++r)
+    capacities[r] = bucketOffsets[r + 1] - bucketOffsets[r];
+  for (size_t r = numRows; r < numRows + newRows; ++r)
+    capacities[r] = 0;
+
+  bool overflow = false;
+  for (size_t t = 0; t < touchedRows.size(); ++t)
+  {
+    const size_t row = touchedRows[t];
+    const size_t needed = std::min(rowFill[t] + rowAdded[t],
+        effectiveBucketSize);
+    if (needed > capacities[row])
+    {
+      capacities[row] = std::min(2 * needed, effectiveBucketSize);
+      if (row < numRows)
+        overflow = true;
+    }
+  }
+
+  arma::Col<size_t> newOffsets(numRows + newRows + 1);
+  newOffsets[0] = 0;
+  for (size_t r = 0; r < numRows + newRows; ++r)
+    newOffsets[r + 1] = newOffsets[r] + capacities[r];
+
+  if (overflow)
+  {
+    // Some existing buckets have to grow, so move all of the buckets to a new
+    // array.  The unused slots are copied along with the points.
+    arma::Col<size_t> newTable(newOffsets[numRows + newRows]);
+    newTable.fill(SIZE_MAX);
+    for (size_t r = 0; r < numRows; ++r)
+    {
+      const size_t oldCapacity = bucketOffsets[r + 1] - bucketOffsets[r];
+      if (oldCapacity > 0)
+        newTable.subvec(newOffsets[r], newOffsets[r] + oldCapacity - 1) =
+            secondHashTable.subvec(bucketOffsets[r], bucketOffsets[r + 1] - 1);
+    }
+
+    secondHashTable = std::move(newTable);
+  }
+  else if (newOffsets[numRows + newRows] > secondHashTable.n_elem)
+  {
+    // Only new buckets are added, after the existing ones; the space at the
+    // end of the array grows geometrically.
+    const size_t oldSize = secondHashTable.n_elem;
+    secondHashTable.resize(std::max(newOffsets[numRows + newRows],
+        2 * oldSize));
+    secondHashTable.tail(secondHashTable.n_elem - oldSize).fill(SIZE_MAX);
+  }
+
+  bucketOffsets = std::move(newOffsets);
+
+  // Finally, put the new points in the buckets, until the buckets are full.
+  for (size_t i = 0; i < numTables; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      const size_t row = bucketRowInHashTable[secondHashVectors(i, j)];
+      const size_t t = rowIndex[row];
+      if (rowFill[t] < bucketOffsets[row + 1] - bucketOffsets[row])
+        secondHashTable[bucketOffsets[row] + rowFill[t]++] = firstId + j;
+    }
+  }
+}
+
+// Get the number of points in the bucket held in the given row.
+template<typename SortPolicy>
+size_t LSHSearch<SortPolicy>::BucketFill(const size_t row) const
+{
+  // The points of a bucket are at the start of its storage, and the unused
+  // slots after them hold SIZE_MAX.
+  const size_t* begin = secondHashTable.memptr() + bucketOffsets[row];
+  const size_t* end = secondHashTable.memptr() + bucketOffsets[row + 1];
+  return std::partition_point(begin, end,
+      [](const size_t index) { return index != SIZE_MAX; }) - begin;
+}
+
+// Hash the given points in each table.
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::HashPoints(
+    const arma::mat& points,
+    arma::Mat<size_t>& secondHashVectors) const
+{
   // We will store the second hash vectors in this matrix; the second hash
   // vector for table i will be held in row i.  We have to use int and not
   // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
+  secondHashVectors.set_size(numTables, points.n_cols);
 
-  for (size_t i = 0; i < numTables; i++)
+  // The tables are independent, so they are hashed in parallel.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) numTables; i++)
   {
     // Step IV: create the 'numProj'-dimensional key for each point in each
     // table.
 
     // The following code performs the task of hashing each point to a
     // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
+    // 'points.n_cols') key matrix.
     //
     // For a single table, let the 'numProj' projections be denoted by 'proj_i'
     // and the corresponding offset be 'offset_i'.  Then the key of a single
     // point is obtained as:
     // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
     arma::mat offsetMat = arma::repmat(offsets.unsafe_col(i), 1,
-                                       this->referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (this->referenceSet);
+                                       points.n_cols);
+    arma::mat hashMat = projections.slice(i).t() * points;
     hashMat += offsetMat;
     hashMat /= hashWidth;
 
@@ -295,56 +507,6 @@ void LSHSearch<SortPolicy>::Train(arma::mat referenceSet,
       }
     }
   }
-
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize, arma::fill::zeros);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
-
-  // Enforce the maximum bucket size.
-  const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
-  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
-      { return std::min(val, effectiveBucketSize); });
-
-  const size_t numRowsInTable = arma::accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
-
-  // Next we must assign each point in each table to the right second hash
-  // table.
-  size_t currentRow = 0;
-  for (size_t i = 0; i < numTables; ++i)
-  {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
-    for (size_t j = 0; j < secondHashVectors.n_cols; j++)
-    {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
-      if (bucketRowInHashTable[hashInd] == secondHashSize)
-      {
-        bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
-      }
-
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
-
-  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
-            << "maximum length of " << arma::max(secondHashBinCounts) << ", "
-            << "totaling " << arma::accu(secondHashBinCounts) << " elements."
-            << std::endl;
 }
 
 // Base case where the query set is the reference set.  (So, we can't return
@@ -438,29 +600,29 @@ void LSHSearch<SortPolicy>::BaseCase(const size_t queryIndex,
 template<typename SortPolicy>
 inline force_inline
 double LSHSearch<SortPolicy>::PerturbationScore(
-    const std::vector<bool>& A,
+    const boost::dynamic_bitset<>& A,
     const arma::vec& scores) const
 {
   double score = 0.0;
-  for (size_t i = 0; i < A.size(); ++i)
-    if (A[i])
-      score += scores(i); // add scores of non-zero indices
+  for (size_t i = A.find_first(); i != A.npos; i = A.find_next(i))
+    score += scores(i); // add scores of non-zero indices
   return score;
 }
 
 template<typename SortPolicy>
 inline force_inline
-bool LSHSearch<SortPolicy>::PerturbationShift(std::vector<bool>& A) const
+bool LSHSearch<SortPolicy>::PerturbationShift(boost::dynamic_bitset<>& A) const
 {
+  // Find the last '1' in A.  Sets only hold a few elements, so visiting the set
+  // elements is cheaper than visiting every position.
   size_t maxPos = 0;
-  for (size_t i = 0; i < A.size(); ++i)
-    if (A[i] == 1) // Marked true.
-      maxPos = i;
+  for (size_t i = A.find_first(); i != A.npos; i = A.find_next(i))
+    maxPos = i;
 
   if (maxPos + 1 < A.size()) // Otherwise, this is an invalid vector.
   {
-    A[maxPos] = 0;
-    A[maxPos + 1] = 1;
+    A.reset(maxPos);
+    A.set(maxPos + 1);
     return true; // valid
   }
   return false; // invalid
@@ -468,17 +630,17 @@ bool LSHSearch<SortPolicy>::PerturbationShift(std::vector<bool>& A) const
 
 template<typename SortPolicy>
 inline force_inline
-bool LSHSearch<SortPolicy>::PerturbationExpand(std::vector<bool>& A) const
+bool LSHSearch<SortPolicy>::PerturbationExpand(boost::dynamic_bitset<>& A)
+    const
 {
   // Find the last '1' in A.
   size_t maxPos = 0;
-  for (size_t i = 0; i < A.size(); ++i)
-    if (A[i]) // Marked true.
-      maxPos = i;
+  for (size_t i = A.find_first(); i != A.npos; i = A.find_next(i))
+    maxPos = i;
 
   if (maxPos + 1 < A.size()) // Otherwise, this is an invalid vector.
   {
-    A[maxPos + 1] = 1;
+    A.set(maxPos + 1);
     return true;
   }
   return false;
@@ -487,25 +649,24 @@ bool LSHSearch<SortPolicy>::PerturbationExpand(std::vector<bool>& A) const
 template<typename SortPolicy>
 inline force_inline
 bool LSHSearch<SortPolicy>::PerturbationValid(
-    const std::vector<bool>& A) const
+    const boost::dynamic_bitset<>& A,
+    const arma::Col<size_t>& positions) const
 {
   // Use check to mark dimensions we have seen before in A. If a dimension is
   // seen twice (or more), A is not a valid perturbation.
-  std::vector<bool> check(numProj);
+  boost::dynamic_bitset<> check(numProj);
 
   if (A.size() > 2 * numProj)
     return false; // This should never happen.
 
   // Check that we only see each dimension once. If not, vector is not valid.
-  for (size_t i = 0; i < A.size(); ++i)
+  // The elements of A are indices into the sorted actions, so positions gives
+  // the dimension of each of them.
+  for (size_t i = A.find_first(); i != A.npos; i = A.find_next(i))
   {
-    // Only check dimensions that were included.
-    if (!A[i])
-      continue;
-
-    // If dimesnion is unseen thus far, mark it as seen.
-    if (check[i % numProj] == false)
-      check[i % numProj] = true;
+    // If dimension is unseen thus far, mark it as seen.
+    if (!check.test(positions(i)))
+      check.set(positions(i));
     else
       return false; // If dimension was seen before, set is not valid.
   }
@@ -625,18 +786,19 @@ void LSHSearch<SortPolicy>::GetAdditionalProbingBins(
   //
   // Method:
   // Store each perturbation set (pair of (dimension, action)) in a
-  // std::vector. Create a minheap of scores, with each node pointing to its
-  // relevant perturbation set. Each perturbation set popped from the minheap
-  // is the next most likely perturbation set.
+  // boost::dynamic_bitset. Create a minheap of scores, with each node pointing
+  // to its relevant perturbation set. Each perturbation set popped from the
+  // minheap is the next most likely perturbation set.
   // Transform perturbation set to perturbation vector by setting the
   // dimensions specified by the set to queryCode+action (action is {-1, 1}).
 
   // Perturbation sets (A) mark with 1 the (score, action, dimension) positions
   // included in a given perturbation vector. Other spaces are 0.
-  std::vector<bool> Ao(2 * numProj);
-  Ao[0] = 1; // Smallest vector includes only smallest score.
+  boost::dynamic_bitset<> Ao(2 * numProj);
+  Ao.set(0); // Smallest vector includes only smallest score.
 
-  std::vector< std::vector<bool> > perturbationSets;
+  std::vector<boost::dynamic_bitset<>> perturbationSets;
+  perturbationSets.reserve(2 * T + 1);
   perturbationSets.push_back(Ao); // Storage of perturbation sets.
 
   std::priority_queue<
@@ -655,77 +817,84 @@ void LSHSearch<SortPolicy>::GetAdditionalProbingBins(
   // neighbors of the query).
   for (size_t pvec = 0; pvec < T; ++pvec)
   {
-    std::vector<bool> Ai;
+    size_t ai;
     do
     {
+      // The heap only runs out if there are fewer than T other bins; the
+      // remaining columns then hold the query's own code.
+      if (minHeap.empty())
+        return;
+
       // Get the perturbation set corresponding to the minimum score.
-      Ai = perturbationSets[ minHeap.top().second ];
+      ai = minHeap.top().second;
       minHeap.pop(); // .top() returns, .pop() removes
 
-      // Shift operation on Ai (replace max with max+1).
-      std::vector<bool> As = Ai;
+      // Invalid sets are kept in the heap, because the sets generated from
+      // them may be valid; they are only skipped when they are popped.
 
-      // Don't add invalid sets.
-      if (PerturbationShift(As) && PerturbationValid(As))
+      // Shift operation on Ai (replace max with max+1).
+      boost::dynamic_bitset<> As = perturbationSets[ai];
+      if (PerturbationShift(As))
       {
-        perturbationSets.push_back(As); // add shifted set to sets
-        minHeap.push(
-            std::make_pair(PerturbationScore(As, scores),
-            perturbationSets.size() - 1));
+        minHeap.push(std::make_pair(PerturbationScore(As, scores),
+            perturbationSets.size()));
+        perturbationSets.push_back(std::move(As)); // add shifted set to sets
       }
 
       // Expand operation on Ai (add max+1 to set).
-      std::vector<bool> Ae = Ai;
-
-      // Don't add invalid sets.
-      if (PerturbationExpand(Ae) && PerturbationValid(Ae))
+      boost::dynamic_bitset<> Ae = perturbationSets[ai];
+      if (PerturbationExpand(Ae))
       {
-        perturbationSets.push_back(Ae); // add expanded set to sets
-        minHeap.push(
-            std::make_pair(PerturbationScore(Ae, scores),
-            perturbationSets.size() - 1));
+        minHeap.push(std::make_pair(PerturbationScore(Ae, scores),
+            perturbationSets.size()));
+        perturbationSets.push_back(std::move(Ae)); // add expanded set to sets
       }
-    } while (!PerturbationValid(Ai)); // Discard invalid perturbations
+    } while (!PerturbationValid(perturbationSets[ai], positions));
 
     // Found valid perturbation set Ai. Construct perturbation vector from set.
-    for (size_t pos = 0; pos < Ai.size(); ++pos)
-    {
-      // If Ai[pos] is marked, add action to probing vector.
-      additionalProbingBins(positions(pos), pvec) += Ai[pos] ? actions(pos) : 0;
-    }
+    const boost::dynamic_bitset<>& Ai = perturbationSets[ai];
+    for (size_t pos = Ai.find_first(); pos != Ai.npos; pos = Ai.find_next(pos))
+      additionalProbingBins(positions(pos), pvec) += actions(pos);
+  }
+}
+
+template<typename SortPolicy>
+void LSHSearch<SortPolicy>::ProjectPoints(
+    const arma::mat& points,
+    const size_t begin,
+    const size_t count,
+    const size_t numTablesToSearch,
+    arma::cube& queryCodes) const
+{
+  queryCodes.set_size(numProj, numTablesToSearch, count);
+
+  // One matrix multiplication per table projects the whole block of points at
+  // once, which is much faster than one matrix-vector product per point.
+  arma::mat tableProjections;
+  for (size_t t = 0; t < numTablesToSearch; ++t)
+  {
+    tableProjections = projections.slice(t).t() *
+        points.cols(begin, begin + count - 1);
+    tableProjections.each_col() += offsets.col(t);
+
+    for (size_t i = 0; i < count; ++i)
+      queryCodes.slice(i).col(t) = tableProjections.col(i);
   }
 }
 
 template<typename SortPolicy>
-template<typename VecType>
 void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
-    const VecType& queryPoint,
+    const arma::mat& queryCodesNotFloored,
     arma::uvec& referenceIndices,
-    size_t numTablesToSearch,
+    const size_t numTablesToSearch,
     const size_t T) const
 {
-  // Decide on the number of tables to look into.
-  if (numTablesToSearch == 0) // If no user input is given, search all.
-    numTablesToSearch = numTables;
-
-  // Sanity check to make sure that the existing number of tables is not
-  // exceeded.
-  if (numTablesToSearch > numTables)
-    numTablesToSearch = numTables;
-
-  // Hash the query in each of the 'numTablesToSearch' hash tables using the
-  // 'numProj' projections for each table. This gives us 'numTablesToSearch'
-  // keys for the query where each key is a 'numProj' dimensional integer
-  // vector.
-
-  // Compute the projection of the query in each table.
-  arma::mat allProjInTables(numProj, numTablesToSearch);
-  arma::mat queryCodesNotFloored(numProj, numTablesToSearch);
-  for (size_t i = 0; i < numTablesToSearch; i++)
-    queryCodesNotFloored.unsafe_col(i) = projections.slice(i).t() * queryPoint;
-
-  queryCodesNotFloored += offsets.cols(0, numTablesToSearch - 1);
-  allProjInTables = arma::floor(queryCodesNotFloored / hashWidth);
+  // The query has been hashed in each of the 'numTablesToSearch' hash tables
+  // using the 'numProj' projections for each table. Flooring gives us
+  // 'numTablesToSearch' keys for the query where each key is a 'numProj'
+  // dimensional integer vector.
+  const arma::mat allProjInTables = arma::floor(queryCodesNotFloored /
+      hashWidth);
 
   // Use hashMat to store the primary probing codes and any additional codes
   // from multiprobe LSH.
@@ -762,7 +931,8 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
     }
   }
 
-  // Count number of points hashed in the same bucket as the query.
+  // Count number of points hashed in the same bucket as the query.  Buckets
+  // may have unused slots after insertions, so this is an upper bound.
   size_t maxNumPoints = 0;
   for (size_t i = 0; i < numTablesToSearch; ++i)
   {
@@ -770,8 +940,8 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
     {
       const size_t hashInd = hashMat(p, i); // find query's bucket
       const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
+      if (tableRow < secondHashSize) // Count bucket contents.
+        maxNumPoints += bucketOffsets[tableRow + 1] - bucketOffsets[tableRow];
     }
   }
 
@@ -802,11 +972,13 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
         size_t hashInd = hashMat(p, i);
         size_t tableRow = bucketRowInHashTable[hashInd];
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
+        if (tableRow < secondHashSize)
         {
           // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
+          for (size_t j = bucketOffsets[tableRow];
+               j < bucketOffsets[tableRow + 1] &&
+               secondHashTable[j] != SIZE_MAX; ++j)
+            refPointsConsidered[secondHashTable[j]]++;
         }
       }
     }
@@ -836,13 +1008,17 @@ void LSHSearch<SortPolicy>::ReturnIndicesFromTable(
         if (tableRow < secondHashSize)
         {
           // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
+          for (size_t j = bucketOffsets[tableRow];
+               j < bucketOffsets[tableRow + 1] &&
+               secondHashTable[j] != SIZE_MAX; ++j)
+            refPointsConsideredSmall(start++) = secondHashTable[j];
        }
       }
     }
 
-    // Keep only one copy of each candidate.
+    // Keep only one copy of each candidate.  Buckets with unused slots make
+    // maxNumPoints an overestimate, so the unfilled end is dropped first.
+    refPointsConsideredSmall.resize(start);
     referenceIndices = arma::unique(refPointsConsideredSmall);
     return;
   }
@@ -900,33 +1076,49 @@ void LSHSearch<SortPolicy>::Search(const arma::mat& querySet,
     Log::Info << "Running multiprobe LSH with " << Teffective
         <<" additional probing bins per table per query." << std::endl;
 
+  // Decide on the number of tables to look into.  If no user input is given,
+  // or too many tables are requested, search all of them.
+  const size_t tablesToSearch = (numTablesToSearch == 0 ||
+      numTablesToSearch > numTables) ? numTables : numTablesToSearch;
+
   size_t avgIndicesReturned = 0;
 
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  // The queries are projected in blocks, so that the projections of a block
+  // are computed with one matrix multiplication per table.
+  const size_t blockSize = 1024;
+  arma::cube queryCodes;
+  for (size_t begin = 0; begin < querySet.n_cols; begin += blockSize)
   {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(querySet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running
-    // #pragma omp atomic
-    avgIndicesReturned = avgIndicesReturned + refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
+    const size_t count = std::min(blockSize, querySet.n_cols - begin);
+    ProjectPoints(querySet, begin, count, tablesToSearch, queryCodes);
+
+    // Parallelization to process more than one query at a time.  Each query
+    // writes only its own results, and the number of candidates is summed with
+    // a reduction.
+    #pragma omp parallel for \
+        shared(resultingNeighbors, distances, queryCodes) \
+        schedule(dynamic)\
+        reduction(+:avgIndicesReturned)
+    for (omp_size_t j = 0; j < (omp_size_t) count; ++j)
+    {
+      const size_t i = begin + j;
+
+      // Hash every query into every hash table and eventually into the
+      // 'secondHashTable' to obtain the neighbor candidates.
+      arma::uvec refIndices;
+      ReturnIndicesFromTable(queryCodes.slice(j), refIndices, tablesToSearch,
+          Teffective);
+
+      // An informative book-keeping for the number of neighbor candidates
+      // returned on average.
+      avgIndicesReturned += refIndices.n_elem;
+
+      // Sequentially go through all the candidates and save the best 'k'
+      // candidates.
+      BaseCase(i, refIndices, k, querySet, resultingNeighbors, distances);
+    }
   }
 
   Timer::Stop("computing_neighbors");
@@ -966,33 +1158,49 @@ Search(const size_t k,
     Log::Info << "Running multiprobe LSH with " << Teffective <<
       " additional probing bins per table per query."<< std::endl;
 
+  // Decide on the number of tables to look into.  If no user input is given,
+  // or too many tables are requested, search all of them.
+  const size_t tablesToSearch = (numTablesToSearch == 0 ||
+      numTablesToSearch > numTables) ? numTables : numTablesToSearch;
+
   size_t avgIndicesReturned = 0;
 
   Timer::Start("computing_neighbors");
 
-  // Parallelization to process more than one query at a time.
-  #pragma omp parallel for \
-      shared(resultingNeighbors, distances) \
-      schedule(dynamic)\
-      reduction(+:avgIndicesReturned)
-  for (omp_size_t i = 0; i < (omp_size_t) referenceSet.n_cols; ++i)
+  // The queries are projected in blocks, so that the projections of a block
+  // are computed with one matrix multiplication per table.
+  const size_t blockSize = 1024;
+  arma::cube queryCodes;
+  for (size_t begin = 0; begin < referenceSet.n_cols; begin += blockSize)
   {
-    // Go through every query point.
-    // Hash every query into every hash table and eventually into the
-    // 'secondHashTable' to obtain the neighbor candidates.
-    arma::uvec refIndices;
-    ReturnIndicesFromTable(referenceSet.col(i), refIndices, numTablesToSearch,
-        Teffective);
-
-    // An informative book-keeping for the number of neighbor candidates
-    // returned on average.
-    // Make atomic to avoid race conditions when multiple threads are running.
-    // #pragma omp atomic
-    avgIndicesReturned += refIndices.n_elem;
-
-    // Sequentially go through all the candidates and save the best 'k'
-    // candidates.
-    BaseCase(i, refIndices, k, resultingNeighbors, distances);
+    const size_t count = std::min(blockSize, referenceSet.n_cols - begin);
+    ProjectPoints(referenceSet, begin, count, tablesToSearch, queryCodes);
+
+    // Parallelization to process more than one query at a time.  Each query
+    // writes only its own results, and the number of candidates is summed with
+    // a reduction.
+    #pragma omp parallel for \
+        shared(resultingNeighbors, distances, queryCodes) \
+        schedule(dynamic)\
+        reduction(+:avgIndicesReturned)
+    for (omp_size_t j = 0; j < (omp_size_t) count; ++j)
+    {
+      const size_t i = begin + j;
+
+      // Hash every query into every hash table and eventually into the
+      // 'secondHashTable' to obtain the neighbor candidates.
+      arma::uvec refIndices;
+      ReturnIndicesFromTable(queryCodes.slice(j), refIndices, tablesToSearch,
+          Teffective);
+
+      // An informative book-keeping for the number of neighbor candidates
+      // returned on average.
+      avgIndicesReturned += refIndices.n_elem;
+
+      // Sequentially go through all the candidates and save the best 'k'
+      // candidates.
+      BaseCase(i, refIndices, k, resultingNeighbors, distances);
+    }
   }
 
   Timer::Stop("computing_neighbors");
@@ -1066,73 +1274,75 @@ void LSHSearch<SortPolicy>::serialize(Archive& ar,
   ar & BOOST_SERIALIZATION_NVP(bucketSize);
   // needs specific handling for new version
 
-  // Backward compatibility: in older versions of LSHSearch, the secondHashTable
-  // was stored as an arma::Mat<size_t>.  So we need to properly load that, then
-  // prune it down to size.
-  if (version == 0)
+  // Backward compatibility: older versions of LSHSearch stored each bucket in
+  // its own vector, so those are loaded and then packed together.
+  if (version < 2)
   {
-    arma::Mat<size_t> tmpSecondHashTable;
-    ar & BOOST_SERIALIZATION_NVP(tmpSecondHashTable);
-
-    // The old secondHashTable was stored in row-major format, so we transpose
-    // it.
-    tmpSecondHashTable = tmpSecondHashTable.t();
+    std::vector<arma::Col<size_t>> oldSecondHashTable;
+    arma::Col<size_t> bucketContentSize;
 
-    secondHashTable.resize(tmpSecondHashTable.n_cols);
-    for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+    // In the oldest versions, the secondHashTable was stored as an
+    // arma::Mat<size_t>, and bucketContentSize held the size of all possible
+    // buckets (secondHashSize of them).
+    if (version == 0)
     {
-      // Find length of each column.  We know we are at the end of the list when
-      // the value referenceSet.n_cols is seen.
+      arma::Mat<size_t> tmpSecondHashTable;
+      ar & BOOST_SERIALIZATION_NVP(tmpSecondHashTable);
 
-      size_t len = 0;
-      for (; len < tmpSecondHashTable.n_rows; ++len)
-        if (tmpSecondHashTable(len, i) == referenceSet.n_cols)
-          break;
+      // The old secondHashTable was stored in row-major format, so we
+      // transpose it.
+      tmpSecondHashTable = tmpSecondHashTable.t();
 
-      // Set the size of the new column correctly.
-      secondHashTable[i].set_size(len);
-      for (size_t j = 0; j < len; ++j)
-        secondHashTable[i](j) = tmpSecondHashTable(j, i);
-    }
-  }
-  else
-  {
-    size_t tables;
-    if (Archive::is_saving::value)
-      tables = secondHashTable.size();
-    ar & BOOST_SERIALIZATION_NVP(tables);
+      oldSecondHashTable.resize(tmpSecondHashTable.n_cols);
+      for (size_t i = 0; i < tmpSecondHashTable.n_cols; ++i)
+      {
+        // Find length of each column.  We know we are at the end of the list
+        // when the value referenceSet.n_cols is seen.
+        size_t len = 0;
+        for (; len < tmpSecondHashTable.n_rows; ++len)
+          if (tmpSecondHashTable(len, i) == referenceSet.n_cols)
+            break;
+
+        oldSecondHashTable[i] = tmpSecondHashTable.col(i).head(len);
+      }
+
+      arma::Col<size_t> tmpBucketContentSize;
+      ar & BOOST_SERIALIZATION_NVP(tmpBucketContentSize);
+      ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
 
-    // Set size of second hash table if needed.
-    if (Archive::is_loading::value)
+      // Compress into a smaller vector by just dropping all of the zeros.
+      bucketContentSize.zeros(oldSecondHashTable.size());
+      for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
+        if (tmpBucketContentSize[i] > 0)
+          bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
+    }
+    else
     {
-      secondHashTable.clear();
-      secondHashTable.resize(tables);
+      size_t tables;
+      ar & BOOST_SERIALIZATION_NVP(tables);
+      oldSecondHashTable.resize(tables);
+      ar & boost::serialization::make_nvp("secondHashTable",
+          oldSecondHashTable);
+      ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
+      ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
     }
 
-    ar & BOOST_SERIALIZATION_NVP(secondHashTable);
-  }
+    bucketOffsets.set_size(oldSecondHashTable.size() + 1);
+    bucketOffsets[0] = 0;
+    for (size_t i = 0; i < oldSecondHashTable.size(); ++i)
+      bucketOffsets[i + 1] = bucketOffsets[i] + bucketContentSize[i];
 
-  // Backward compatibility: old versions of LSHSearch held bucketContentSize
-  // for all possible buckets (of size secondHashSize), but now we hold a
-  // compressed representation.
-  if (version == 0)
-  {
-    // The vector was stored in the old uncompressed form.  So we need to shrink
-    // it.  But we can't do that until we have bucketRowInHashTable, so we also
-    // have to load that.
-    arma::Col<size_t> tmpBucketContentSize;
-    ar & BOOST_SERIALIZATION_NVP(tmpBucketContentSize);
-    ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
-
-    // Compress into a smaller vector by just dropping all of the zeros.
-    bucketContentSize.set_size(secondHashTable.size());
-    for (size_t i = 0; i < tmpBucketContentSize.n_elem; ++i)
-      if (tmpBucketContentSize[i] > 0)
-        bucketContentSize[bucketRowInHashTable[i]] = tmpBucketContentSize[i];
+    secondHashTable.set_size(bucketOffsets[oldSecondHashTable.size()]);
+    for (size_t i = 0; i < oldSecondHashTable.size(); ++i)
+    {
+      for (size_t j = 0; j < bucketContentSize[i]; ++j)
+        secondHashTable[bucketOffsets[i] + j] = oldSecondHashTable[i][j];
+    }
   }
   else
   {
-    ar & BOOST_SERIALIZATION_NVP(bucketContentSize);
+    ar & BOOST_SERIALIZATION_NVP(secondHashTable);
+    ar & BOOST_SERIALIZATION_NVP(bucketOffsets);
     ar & BOOST_SERIALIZATION_NVP(bucketRowInHashTable);
   }
 
@@ -19,31 +19,35 @@ MatrixCompletion::MatrixCompletion(const size_t m,
                                    const size_t n,
                                    const arma::umat& indices,
                                    const arma::vec& values,
-                                   const size_t r) :
-    m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0, arma::randu<arma::mat>(m + n, r))
+                                   const size_t r,
+                                   const bool factorized) :
+    m(m), n(n), indices(indices), values(values), factorized(factorized),
+    sdp(factorized ? 0 : indices.n_cols, 0, arma::randu<arma::mat>(m + n, r))
 {
   CheckValues();
-  InitSDP();
+  if (!factorized)
+    InitSDP();
 }
 
 MatrixCompletion::MatrixCompletion(const size_t m,
                                    const size_t n,
                                    const arma::umat& indices,
                                    const arma::vec& values,
-                                   const arma::mat& initialPoint) :
-    m(m), n(n), indices(indices), values(values),
-    sdp(indices.n_cols, 0, initialPoint)
+                                   const arma::mat& initialPoint,
+                                   const bool factorized) :
+    m(m), n(n), indices(indices), values(values), factorized(factorized),
+    sdp(factorized ? 0 : indices.n_cols, 0, initialPoint)
 {
   CheckValues();
-  InitSDP();
+  if (!factorized)
+    InitSDP();
 }
 
 MatrixCompletion::MatrixCompletion(const size_t m,
                                    const size_t n,
                                    const arma::umat& indices,
                                    const arma::vec& values) :
-    m(m), n(n), indices(indices), values(values),
+    m(m), n(n), indices(indices), values(values), factorized(false),
     sdp(indices.n_cols, 0,
         arma::randu<arma::mat>(m + n, DefaultRank(m, n, indices.n_cols)))
 {
@@ -92,12 +96,81 @@ void MatrixCompletion::InitSDP()
 
 void MatrixCompletion::Recover(arma::mat& recovered)
 {
+  if (factorized)
+  {
+    arma::mat u, v;
+    Recover(u, v);
+    recovered = u * trans(v);
+    return;
+  }
+
   recovered = sdp.Function().GetInitialPoint();
   sdp.Optimize(recovered);
   recovered = recovered * trans(recovered);
   recovered = recovered(arma::span(0, m - 1), arma::span(m, m + n - 1));
 }
 
+void MatrixCompletion::Recover(arma::mat& u, arma::mat& v)
+{
+  arma::mat coordinates = sdp.Function().GetInitialPoint();
+  if (factorized)
+  {
+    // The columns of the coordinates are the rows of U and V.
+    coordinates = trans(coordinates);
+    OptimizeFactors(coordinates);
+    coordinates = trans(coordinates);
+  }
+  else
+  {
+    sdp.Optimize(coordinates);
+  }
+
+  // X is the upper right block of R R^T, where R = [U; V].
+  u = coordinates.rows(0, m - 1);
+  v = coordinates.rows(m, m + n - 1);
+}
+
+void MatrixCompletion::OptimizeFactors(arma::mat& coordinates)
+{
+  MatrixCompletionFunction function(m, n, indices, values);
+  ens::L_BFGS lbfgs;
+
+  // Use the same augmented Lagrangian method as the LRSDP solver: after each
+  // minimization of the augmented Lagrangian, either update the Lagrange
+  // multipliers, if the constraints improved enough, or increase the penalty.
+  const double tolerance = 1e-14 * std::max(arma::dot(values, values), 1.0);
+  double lastPenalty = DBL_MAX;
+  arma::vec constraints;
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    lbfgs.Optimize(function, coordinates);
+
+    const double penalty = function.EvaluateConstraints(coordinates,
+        constraints);
+    Log::Info << "MatrixCompletion::Recover(): iteration " << i << ", "
+        << "penalty " << penalty << ", sigma " << function.Sigma() << "."
+        << std::endl;
+    if (penalty <= tolerance)
+      break;
+
+    if (penalty < 0.25 * lastPenalty)
+    {
+      function.Lambda() -= function.Sigma() * constraints;
+      lastPenalty = penalty;
+    }
+    else if (function.Sigma() < 1e15)
+    {
+      function.Sigma() *= 10;
+    }
+    else
+    {
+      Log::Warning << "MatrixCompletion::Recover(): constraints could not be "
+          << "satisfied; the penalty is " << penalty << "." << std::endl;
+      break;
+    }
+  }
+}
+
 size_t MatrixCompletion::DefaultRank(const size_t m,
                                      const size_t n,
                                      const size_t p)
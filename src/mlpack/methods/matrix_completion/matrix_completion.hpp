@@ -15,6 +15,8 @@
 
 #include <ensmallen.hpp>
 
+#include "matrix_completion_function.hpp"
+
 namespace mlpack {
 namespace matrix_completion {
 
@@ -47,6 +49,21 @@ namespace matrix_completion {
  * mc.Recover(recovered);
  * @endcode
  *
+ * The SDP has one constraint matrix for each known entry, so for problems
+ * with millions of known entries, pass factorized = true to the constructor.
+ * Then, the SDP is not built; instead, the augmented Lagrangian of the same
+ * problem is minimized over the factors U and V of X = U V^T with L-BFGS,
+ * evaluating the constraints directly from the list of known entries (see
+ * MatrixCompletionFunction).  The memory used is then linear in the number of
+ * known entries plus (m + n) r, and the factors can be recovered without
+ * forming X:
+ *
+ * @code
+ * MatrixCompletion mc(m, n, indices, values, r, true);
+ * arma::mat u, v;
+ * mc.Recover(u, v); // The completed matrix is u * v.t().
+ * @endcode
+ *
  * @see LRSDP
  */
 class MatrixCompletion
@@ -63,12 +80,15 @@ class MatrixCompletion
    * @param values Vector containing the values of the known entries (must be
    *    length p).
    * @param r Maximum rank of solution.
+   * @param factorized If true, optimize the factors of the solution directly
+   *    instead of building the SDP.
    */
   MatrixCompletion(const size_t m,
                    const size_t n,
                    const arma::umat& indices,
                    const arma::vec& values,
-                   const size_t r);
+                   const size_t r,
+                   const bool factorized = false);
 
   /**
    * Construct a matrix completion problem, specifying the initial point of the
@@ -81,12 +101,15 @@ class MatrixCompletion
    * @param values Vector containing the values of the known entries (must be
    *    length p).
    * @param initialPoint Starting point for the SDP optimization.
+   * @param factorized If true, optimize the factors of the solution directly
+   *    instead of building the SDP.
    */
   MatrixCompletion(const size_t m,
                    const size_t n,
                    const arma::umat& indices,
                    const arma::vec& values,
-                   const arma::mat& initialPoint);
+                   const arma::mat& initialPoint,
+                   const bool factorized = false);
 
   /**
    * Construct a matrix completion problem.
@@ -110,7 +133,19 @@ class MatrixCompletion
    */
   void Recover(arma::mat& recovered);
 
-  //! Return the underlying SDP.
+  /**
+   * Solve the underlying problem, and return the factors of the completed
+   * matrix, which is u * v.t().
+   *
+   * @param u Will contain the m x r left factor.
+   * @param v Will contain the n x r right factor.
+   */
+  void Recover(arma::mat& u, arma::mat& v);
+
+  //! Return whether the factors are optimized directly instead of the SDP.
+  bool Factorized() const { return factorized; }
+
+  //! Return the underlying SDP.  It has no constraints if Factorized() is true.
   const ens::LRSDP<ens::SDP<arma::sp_mat>>& Sdp() const
   {
     return sdp;
@@ -126,7 +161,10 @@ class MatrixCompletion
   //! Matrix containing the indices of the known entries (has two rows).
   arma::umat indices;
   //! Vector containing the values of the known entries.
-  arma::mat values;
+  arma::vec values;
+
+  //! Whether the factors are optimized directly instead of the SDP.
+  bool factorized;
 
   //! The underlying SDP to be solved.
   ens::LRSDP<ens::SDP<arma::sp_mat>> sdp;
@@ -135,6 +173,9 @@ class MatrixCompletion
   void CheckValues();
   //! Initialize the SDP.
   void InitSDP();
+  //! Minimize the augmented Lagrangian over the factors, starting from (and
+  //! overwriting) the given r x (m + n) coordinates.
+  void OptimizeFactors(arma::mat& coordinates);
 
   //! Select a rank of the matrix given that is of size m x n and has p known
   //! elements.
@@ -0,0 +1,137 @@
+/**
+ * @file matrix_completion_function.cpp
+ *
+ * Implementation of MatrixCompletionFunction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "matrix_completion_function.hpp"
+
+namespace mlpack {
+namespace matrix_completion {
+
+/**
+ * Order the entries by the given indices with a counting sort, storing the
+ * offset of the entries of each index (there are n indices).
+ */
+static void OrderEntries(const arma::urowvec& entryIndices,
+                         const size_t n,
+                         arma::uvec& order,
+                         arma::uvec& offsets)
+{
+  offsets.zeros(n + 1);
+  for (size_t k = 0; k < entryIndices.n_elem; ++k)
+    ++offsets[entryIndices[k] + 1];
+  for (size_t i = 0; i < n; ++i)
+    offsets[i + 1] += offsets[i];
+
+  arma::uvec next = offsets.subvec(0, n - 1);
+  order.set_size(entryIndices.n_elem);
+  for (size_t k = 0; k < entryIndices.n_elem; ++k)
+    order[next[entryIndices[k]]++] = k;
+}
+
+MatrixCompletionFunction::MatrixCompletionFunction(const size_t m,
+                                                   const size_t n,
+                                                   const arma::umat& indices,
+                                                   const arma::vec& values,
+                                                   const double sigma) :
+    m(m),
+    n(n),
+    indices(indices),
+    values(values),
+    lambda(arma::zeros<arma::vec>(values.n_elem)),
+    sigma(sigma)
+{
+  OrderEntries(indices.row(0), m, rowOrder, rowOffsets);
+  OrderEntries(indices.row(1), n, colOrder, colOffsets);
+}
+
+double MatrixCompletionFunction::Evaluate(const arma::mat& coordinates) const
+{
+  arma::vec constraints;
+  EvaluateConstraints(coordinates, constraints);
+
+  return arma::accu(arma::square(coordinates)) +
+      arma::dot(0.5 * sigma * constraints - lambda, constraints);
+}
+
+void MatrixCompletionFunction::Gradient(const arma::mat& coordinates,
+                                        arma::mat& gradient) const
+{
+  arma::vec constraints;
+  EvaluateConstraints(coordinates, constraints);
+  ComputeGradient(coordinates, constraints, gradient);
+}
+
+double MatrixCompletionFunction::EvaluateWithGradient(
+    const arma::mat& coordinates,
+    arma::mat& gradient) const
+{
+  arma::vec constraints;
+  EvaluateConstraints(coordinates, constraints);
+  ComputeGradient(coordinates, constraints, gradient);
+
+  return arma::accu(arma::square(coordinates)) +
+      arma::dot(0.5 * sigma * constraints - lambda, constraints);
+}
+
+double MatrixCompletionFunction::EvaluateConstraints(
+    const arma::mat& coordinates,
+    arma::vec& constraints) const
+{
+  constraints.set_size(values.n_elem);
+
+  double penalty = 0.0;
+  #pragma omp parallel for reduction(+:penalty)
+  for (omp_size_t k = 0; k < (omp_size_t) values.n_elem; ++k)
+  {
+    const double c = arma::dot(coordinates.col(indices(0, k)),
+        coordinates.col(m + indices(1, k))) - values[k];
+    constraints[k] = c;
+    penalty += c * c;
+  }
+
+  return penalty;
+}
+
+void MatrixCompletionFunction::ComputeGradient(
+    const arma::mat& coordinates,
+    const arma::vec& constraints,
+    arma::mat& gradient) const
+{
+  // The gradient of u_i^T v_j with respect to u_i is v_j, and vice versa, and
+  // each constraint is weighted by sigma c_k - lambda_k.
+  const arma::vec weights = sigma * constraints - lambda;
+
+  gradient = 2 * coordinates;
+
+  // Each row of U only receives the contributions of the entries in its row
+  // of X, so the rows can be handled in parallel without conflicts.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t i = 0; i < (omp_size_t) m; ++i)
+  {
+    for (size_t o = rowOffsets[i]; o < rowOffsets[i + 1]; ++o)
+    {
+      const size_t k = rowOrder[o];
+      gradient.col(i) += weights[k] * coordinates.col(m + indices(1, k));
+    }
+  }
+
+  // Likewise for the rows of V and the columns of X.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (omp_size_t j = 0; j < (omp_size_t) n; ++j)
+  {
+    for (size_t o = colOffsets[j]; o < colOffsets[j + 1]; ++o)
+    {
+      const size_t k = colOrder[o];
+      gradient.col(m + j) += weights[k] * coordinates.col(indices(0, k));
+    }
+  }
+}
+
+} // namespace matrix_completion
+} // namespace mlpack
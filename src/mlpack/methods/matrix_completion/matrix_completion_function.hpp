@@ -0,0 +1,147 @@
+/**
+ * @file matrix_completion_function.hpp
+ *
+ * The augmented Lagrangian of the low-rank (Burer-Monteiro) formulation of
+ * nuclear norm minimization, evaluated directly on the list of known entries.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_MATRIX_COMPLETION_MATRIX_COMPLETION_FUNCTION_HPP
+#define MLPACK_METHODS_MATRIX_COMPLETION_MATRIX_COMPLETION_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace matrix_completion {
+
+/**
+ * With the factorization X = U V^T of the m x n matrix X, where U is m x r and
+ * V is n x r, nuclear norm minimization becomes
+ *
+ *   min ||U||_F^2 + ||V||_F^2 subj to u_i^T v_j = M_ij,
+ *
+ * which is the low-rank SDP solved by MatrixCompletion, with R = [U; V].  This
+ * class evaluates the augmented Lagrangian of that problem,
+ *
+ *   L(U, V) = ||U||_F^2 + ||V||_F^2 + sum_k (-lambda_k c_k + sigma / 2 c_k^2),
+ *
+ * where c_k = u_i^T v_j - M_ij is the violation of the constraint of the k'th
+ * known entry (i, j).  The constraints are never stored as matrices: they are
+ * evaluated from the list of known entries, so that the memory used is linear
+ * in the number of known entries plus the size of U and V.
+ *
+ * The coordinates are stored as an r x (m + n) matrix whose first m columns
+ * are the rows of U and whose last n columns are the rows of V.  The
+ * constraints are evaluated in parallel over the known entries, and the
+ * gradient in parallel over the rows and the columns of X, so that no two
+ * threads write the same column of the gradient.
+ *
+ * The Lagrange multipliers (Lambda()) and the penalty parameter (Sigma()) are
+ * updated by the caller between the optimizations of L; see
+ * MatrixCompletion::Recover().
+ */
+class MatrixCompletionFunction
+{
+ public:
+  /**
+   * Create the function for the given known entries.  The indices and the
+   * values are not copied, so they must outlive the function.
+   *
+   * @param m Number of rows of the matrix.
+   * @param n Number of columns of the matrix.
+   * @param indices Indices of the known entries (must be [2 x p]).
+   * @param values Values of the known entries (must be length p).
+   * @param sigma Initial penalty parameter.
+   */
+  MatrixCompletionFunction(const size_t m,
+                           const size_t n,
+                           const arma::umat& indices,
+                           const arma::vec& values,
+                           const double sigma = 10.0);
+
+  /**
+   * Evaluate the augmented Lagrangian at the given coordinates.
+   *
+   * @param coordinates Coordinates ([U^T V^T]) to evaluate at.
+   */
+  double Evaluate(const arma::mat& coordinates) const;
+
+  /**
+   * Evaluate the gradient of the augmented Lagrangian at the given
+   * coordinates.
+   *
+   * @param coordinates Coordinates ([U^T V^T]) to evaluate at.
+   * @param gradient Matrix to store the gradient into.
+   */
+  void Gradient(const arma::mat& coordinates, arma::mat& gradient) const;
+
+  /**
+   * Evaluate the augmented Lagrangian and its gradient at the given
+   * coordinates, computing the constraints only once.
+   *
+   * @param coordinates Coordinates ([U^T V^T]) to evaluate at.
+   * @param gradient Matrix to store the gradient into.
+   */
+  double EvaluateWithGradient(const arma::mat& coordinates,
+                              arma::mat& gradient) const;
+
+  /**
+   * Compute the violation of the constraint of each known entry, and return
+   * the sum of their squares.
+   *
+   * @param coordinates Coordinates ([U^T V^T]) to evaluate at.
+   * @param constraints Vector to store the violations into.
+   */
+  double EvaluateConstraints(const arma::mat& coordinates,
+                             arma::vec& constraints) const;
+
+  //! Get the number of known entries.
+  size_t NumConstraints() const { return values.n_elem; }
+
+  //! Get the Lagrange multipliers.
+  const arma::vec& Lambda() const { return lambda; }
+  //! Modify the Lagrange multipliers.
+  arma::vec& Lambda() { return lambda; }
+
+  //! Get the penalty parameter.
+  double Sigma() const { return sigma; }
+  //! Modify the penalty parameter.
+  double& Sigma() { return sigma; }
+
+ private:
+  //! Compute the gradient, given the violations of the constraints.
+  void ComputeGradient(const arma::mat& coordinates,
+                       const arma::vec& constraints,
+                       arma::mat& gradient) const;
+
+  //! Number of rows of the matrix.
+  size_t m;
+  //! Number of columns of the matrix.
+  size_t n;
+  //! Indices of the known entries.
+  const arma::umat& indices;
+  //! Values of the known entries.
+  const arma::vec& values;
+
+  //! The known entries, ordered by row.
+  arma::uvec rowOrder;
+  //! The offset of the entries of each row in rowOrder (length m + 1).
+  arma::uvec rowOffsets;
+  //! The known entries, ordered by column.
+  arma::uvec colOrder;
+  //! The offset of the entries of each column in colOrder (length n + 1).
+  arma::uvec colOffsets;
+
+  //! The Lagrange multipliers.
+  arma::vec lambda;
+  //! The penalty parameter.
+  double sigma;
+};
+
+} // namespace matrix_completion
+} // namespace mlpack
+
+#endif
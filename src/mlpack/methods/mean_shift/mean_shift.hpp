@@ -17,6 +17,7 @@
 #include <mlpack/core/kernels/gaussian_kernel.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <boost/utility.hpp>
 
 namespace mlpack {
@@ -27,6 +28,24 @@ namespace meanshift /** Mean shift clustering. */ {
  * apply mean shift algorithm until maximum iterations or convergence.  Then
  * remove duplicate centroids.
  *
+ * The seeds are shifted in parallel with OpenMP, over one kd-tree built on the
+ * dataset that all threads share.  The duplicate centroids are found with one
+ * range search on the converged centroids.
+ *
+ * For large datasets, the points can be replaced by bins with UseBins(): the
+ * points are placed into hypercube bins of side length equal to the radius,
+ * and the seeds are shifted over the mean of the points of each occupied bin,
+ * weighted by the number of points in the bin.  The cost of each shift then
+ * depends on the number of occupied bins instead of the number of points.
+ *
+ * If no radius is given, it is estimated from the nearest neighbors of the
+ * points (see EstimateRadius()).  For large datasets, the estimate can be
+ * computed from a random sample of query points with RadiusSampleSize(),
+ * which is enlarged until the estimate is within RadiusTolerance() of the
+ * mean over all points with probability RadiusConfidence().  The kd-tree
+ * built on the dataset for the estimate is then reused as the query tree
+ * when the points are assigned to the centroids.
+ *
  * A simple example of how to run mean shift clustering is shown below.
  *
  * @code
@@ -67,7 +86,15 @@ class MeanShift
             const KernelType kernel = KernelType());
 
   /**
-   * Give an estimation of radius based on given dataset.
+   * Give an estimation of radius based on given dataset: the mean, over the
+   * points, of the distance to their k-th nearest neighbor, with k the given
+   * ratio of the number of points.  If RadiusSampleSize() is 0 (the default)
+   * or at least the number of points, the mean is taken over all the points
+   * with one all-k-nearest-neighbor search.  Otherwise it is taken over
+   * random query points searched in parallel in the tree of the dataset:
+   * RadiusSampleSize() points first, and twice as many each time the normal
+   * confidence interval of the mean at level RadiusConfidence() is wider than
+   * RadiusTolerance() times the mean, until all points are used.
    *
    * @param data Dataset for estimation.
    * @param ratio Percentage of dataset to use for nearest neighbor search.
@@ -101,12 +128,47 @@ class MeanShift
   //! Set the radius.
   void Radius(double radius);
 
+  //! Get whether the seeds are shifted over the bins instead of the points.
+  bool UseBins() const { return useBins; }
+  //! Modify whether the seeds are shifted over the bins instead of the points.
+  bool& UseBins() { return useBins; }
+
+  //! Get the initial number of query points of the estimation of the radius
+  //! (0 uses all points).
+  size_t RadiusSampleSize() const { return radiusSampleSize; }
+  //! Modify the initial number of query points of the estimation of the
+  //! radius (0 uses all points).
+  size_t& RadiusSampleSize() { return radiusSampleSize; }
+
+  //! Get the confidence level of the sampled estimation of the radius.
+  double RadiusConfidence() const { return radiusConfidence; }
+  //! Modify the confidence level of the sampled estimation of the radius.
+  double& RadiusConfidence() { return radiusConfidence; }
+
+  //! Get the relative tolerance of the sampled estimation of the radius.
+  double RadiusTolerance() const { return radiusTolerance; }
+  //! Modify the relative tolerance of the sampled estimation of the radius.
+  double& RadiusTolerance() { return radiusTolerance; }
+
   //! Get the kernel.
   const KernelType& Kernel() const { return kernel; }
   //! Modify the kernel.
   KernelType& Kernel() { return kernel; }
 
  private:
+  /**
+   * Estimate the radius (see EstimateRadius()) from the points of the
+   * reference tree of the given searcher.
+   *
+   * @param searcher Nearest neighbor searcher on the dataset.
+   * @param ratio Percentage of dataset to use for nearest neighbor search.
+   */
+  double EstimateRadius(neighbor::KNN& searcher, const double ratio);
+
+  //! Reset the statistics of all the nodes of the given tree, so that it can
+  //! be used as a query tree again.
+  static void ResetStatistics(neighbor::KNN::Tree& node);
+
   /**
    * To speed up, we can generate some seeds from data set and use
    * them as initial centroids rather than all the points in the data set.  The
@@ -125,19 +187,39 @@ class MeanShift
                 const int minFreq,
                 MatType& seeds);
 
+  /**
+   * Place the points into hypercube bins of side length binSize, and get the
+   * occupied bins in lexicographic order of their coordinates.
+   *
+   * @param data The reference data set.
+   * @param binSize Width of hypercube bins.
+   * @param corners Matrix to store the lower corner of each bin in, in units
+   *     of binSize.
+   * @param means Matrix to store the mean of the points of each bin in.
+   * @param counts Vector to store the number of points of each bin in.
+   */
+  void BinPoints(const MatType& data,
+                 const double binSize,
+                 arma::mat& corners,
+                 MatType& means,
+                 arma::vec& counts);
+
   /**
    * Use kernel to calculate new centroid given dataset and valid neighbors.
    *
    * @param data The whole dataset
    * @param neighbors Valid neighbors
    * @param distances Distances to neighbors
-   # @param centroid Store calculated centroid
+   * @param weights Weight of each point of the dataset, or an empty vector if
+   *     all points have weight 1
+   * @param centroid Store calculated centroid
    */
   template<bool ApplyKernel = UseKernel>
   typename std::enable_if<ApplyKernel, bool>::type
   CalculateCentroid(const MatType& data,
                     const std::vector<size_t>& neighbors,
                     const std::vector<double>& distances,
+                    const arma::vec& weights,
                     arma::colvec& centroid);
 
   /**
@@ -146,13 +228,16 @@ class MeanShift
    * @param data The whole dataset
    * @param neighbors Valid neighbors
    * @param distances Distances to neighbors
-   # @param centroid Store calculated centroid
+   * @param weights Weight of each point of the dataset, or an empty vector if
+   *     all points have weight 1
+   * @param centroid Store calculated centroid
    */
   template<bool ApplyKernel = UseKernel>
   typename std::enable_if<!ApplyKernel, bool>::type
   CalculateCentroid(const MatType& data,
                     const std::vector<size_t>& neighbors,
                     const std::vector<double>&, /*unused*/
+                    const arma::vec& weights,
                     arma::colvec& centroid);
 
   /**
@@ -165,6 +250,18 @@ class MeanShift
   //! Maximum number of iterations before giving up.
   size_t maxIterations;
 
+  //! Whether the seeds are shifted over the bins instead of the points.
+  bool useBins;
+
+  //! The initial number of query points of the estimation of the radius.
+  size_t radiusSampleSize;
+
+  //! The confidence level of the sampled estimation of the radius.
+  double radiusConfidence;
+
+  //! The relative tolerance of the sampled estimation of the radius.
+  double radiusTolerance;
+
   //! Instantiated kernel.
   KernelType kernel;
 };
@@ -17,8 +17,7 @@
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
-
-#include "map"
+#include <boost/math/distributions/normal.hpp>
 
 // In case it hasn't been included yet.
 #include "mean_shift.hpp"
@@ -36,6 +35,10 @@ MeanShift(const double radius,
           const KernelType kernel) :
     radius(radius),
     maxIterations(maxIterations),
+    useBins(false),
+    radiusSampleSize(0),
+    radiusConfidence(0.95),
+    radiusTolerance(0.05),
     kernel(kernel)
 {
   // Nothing to do.
@@ -53,6 +56,15 @@ double MeanShift<UseKernel, KernelType, MatType>::
 EstimateRadius(const MatType& data, double ratio)
 {
   neighbor::KNN neighborSearch(data);
+  return EstimateRadius(neighborSearch, ratio);
+}
+
+// Estimate radius from the reference tree of the given searcher.
+template<bool UseKernel, typename KernelType, typename MatType>
+double MeanShift<UseKernel, KernelType, MatType>::
+EstimateRadius(neighbor::KNN& neighborSearch, const double ratio)
+{
+  const arma::mat& data = neighborSearch.ReferenceSet();
 
   /**
    * For each point in dataset, select nNeighbors nearest points and get
@@ -62,31 +74,72 @@ EstimateRadius(const MatType& data, double ratio)
   const size_t nNeighbors = size_t(data.n_cols * ratio);
   arma::Mat<size_t> neighbors;
   arma::mat distances;
-  neighborSearch.Search(nNeighbors, neighbors, distances);
+  if (radiusSampleSize == 0 || radiusSampleSize >= data.n_cols)
+  {
+    neighborSearch.Search(nNeighbors, neighbors, distances);
 
-  // Get max distance for each point.
-  arma::rowvec maxDistances = max(distances);
+    // Get max distance for each point.
+    arma::rowvec maxDistances = max(distances);
 
-  // Calculate and return the radius.
-  return arma::sum(maxDistances) / (double) data.n_cols;
-}
+    // Calculate and return the radius.
+    return arma::sum(maxDistances) / (double) data.n_cols;
+  }
 
-// Class to compare two vectors.
-template <typename VecType>
-class less
-{
- public:
-  bool operator()(const VecType& first, const VecType& second) const
+  // The sampled query points are points of the dataset, so they are their own
+  // first neighbor.
+  const size_t k = std::min(nNeighbors + 1, (size_t) data.n_cols);
+  const double z = boost::math::quantile(boost::math::normal(),
+      1.0 - (1.0 - radiusConfidence) / 2.0);
+
+  // The query points are searched in parallel with single-tree search, in
+  // batches of at most about 2^24 neighbors.
+  const neighbor::NeighborSearchMode mode = neighborSearch.SearchMode();
+  neighborSearch.SearchMode() = neighbor::SINGLE_TREE_MODE;
+  const size_t maxBatchSize = std::max((size_t) 1, ((size_t) 1 << 24) / k);
+  std::uniform_int_distribution<size_t> distribution(0, data.n_cols - 1);
+
+  double sum = 0.0, squaredSum = 0.0;
+  size_t numSamples = 0;
+  size_t targetSamples = radiusSampleSize;
+  while (numSamples < targetSamples)
   {
-    for (size_t i = 0; i < first.n_rows; ++i)
+    const size_t batchSize = std::min(targetSamples - numSamples,
+        maxBatchSize);
+    arma::uvec queries(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+      queries[i] = distribution(math::randGen);
+
+    neighborSearch.Search(data.cols(queries), k, neighbors, distances);
+    const arma::rowvec maxDistances = max(distances);
+    sum += arma::accu(maxDistances);
+    squaredSum += arma::accu(arma::square(maxDistances));
+    numSamples += batchSize;
+
+    // Take more samples if the confidence interval of the mean is too wide.
+    if (numSamples == targetSamples && targetSamples < data.n_cols)
     {
-      if (first[i] == second[i])
-        continue;
-      return first(i) < second(i);
+      const double mean = sum / numSamples;
+      const double variance = std::max(0.0, squaredSum / numSamples -
+          mean * mean);
+      if (z * std::sqrt(variance / numSamples) > radiusTolerance * mean)
+        targetSamples = std::min(2 * targetSamples, (size_t) data.n_cols);
     }
-    return false;
   }
-};
+
+  neighborSearch.SearchMode() = mode;
+  Log::Info << "Estimated the radius from " << numSamples << " query points."
+      << std::endl;
+  return sum / numSamples;
+}
+
+template<bool UseKernel, typename KernelType, typename MatType>
+void MeanShift<UseKernel, KernelType, MatType>::ResetStatistics(
+    neighbor::KNN::Tree& node)
+{
+  node.Stat().Reset();
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    ResetStatistics(node.Child(i));
+}
 
 // Generate seeds from given data set.
 template<bool UseKernel, typename KernelType, typename MatType>
@@ -96,37 +149,65 @@ void MeanShift<UseKernel, KernelType, MatType>::GenSeeds(
     const int minFreq,
     MatType& seeds)
 {
-  typedef arma::colvec VecType;
-  std::map<VecType, int, less<VecType> > allSeeds;
-  for (size_t i = 0; i < data.n_cols; ++i)
+  arma::mat corners;
+  MatType means;
+  arma::vec counts;
+  BinPoints(data, binSize, corners, means, counts);
+
+  // Remove seeds with too few points.
+  const arma::uvec kept = arma::find(counts >= minFreq);
+  seeds = corners.cols(kept) * binSize;
+}
+
+// Place the points into bins.
+template<bool UseKernel, typename KernelType, typename MatType>
+void MeanShift<UseKernel, KernelType, MatType>::BinPoints(
+    const MatType& data,
+    const double binSize,
+    arma::mat& corners,
+    MatType& means,
+    arma::vec& counts)
+{
+  const arma::mat binned = arma::floor(data / binSize);
+
+  // Sort the points by bin, so that the points of each bin are consecutive.
+  std::vector<size_t> order(data.n_cols);
+  for (size_t i = 0; i < order.size(); ++i)
+    order[i] = i;
+
+  std::sort(order.begin(), order.end(), [&binned](const size_t a,
+                                                  const size_t b)
+      {
+        for (size_t k = 0; k < binned.n_rows; ++k)
+        {
+          if (binned(k, a) != binned(k, b))
+            return binned(k, a) < binned(k, b);
+        }
+        return a < b;
+      });
+
+  // The first point of each bin.
+  std::vector<size_t> binStarts;
+  for (size_t i = 0; i < order.size(); ++i)
   {
-    VecType binnedPoint = arma::floor(data.unsafe_col(i) / binSize);
-    if (allSeeds.find(binnedPoint) == allSeeds.end())
-      allSeeds[binnedPoint] = 1;
-    else
-      allSeeds[binnedPoint]++;
+    if (i == 0 || arma::any(binned.col(order[i]) != binned.col(order[i - 1])))
+      binStarts.push_back(i);
   }
+  binStarts.push_back(order.size());
 
-  // Remove seeds with too few points.  First we count the number of seeds we
-  // end up with, then we add them.
-  std::map<VecType, int, less<VecType> >::iterator it;
-  size_t count = 0;
-  for (it = allSeeds.begin(); it != allSeeds.end(); ++it)
-    if (it->second >= minFreq)
-      ++count;
-
-  seeds.set_size(data.n_rows, count);
-  count = 0;
-  for (it = allSeeds.begin(); it != allSeeds.end(); ++it)
+  const size_t numBins = binStarts.size() - 1;
+  corners.set_size(data.n_rows, numBins);
+  means.zeros(data.n_rows, numBins);
+  counts.set_size(numBins);
+  for (size_t b = 0; b < numBins; ++b)
   {
-    if (it->second >= minFreq)
-    {
-      seeds.col(count) = it->first;
-      ++count;
-    }
-  }
+    corners.col(b) = binned.col(order[binStarts[b]]);
+    for (size_t i = binStarts[b]; i < binStarts[b + 1]; ++i)
+      means.col(b) += data.col(order[i]);
 
-  seeds *= binSize;
+    counts[b] = binStarts[b + 1] - binStarts[b];
+    means.col(b) /= counts[b];
+  }
 }
 
 // Calculate new centroid with given kernel.
@@ -137,6 +218,7 @@ MeanShift<UseKernel, KernelType, MatType>::
 CalculateCentroid(const MatType& data,
                   const std::vector<size_t>& neighbors,
                   const std::vector<double>& distances,
+                  const arma::vec& weights,
                   arma::colvec& centroid)
 {
   double sumWeight = 0;
@@ -146,6 +228,8 @@ CalculateCentroid(const MatType& data,
     {
       double dist = distances[i] / radius;
       double weight = kernel.Gradient(dist) / dist;
+      if (!weights.empty())
+        weight *= weights[neighbors[i]];
       sumWeight += weight;
       centroid += weight * data.unsafe_col(neighbors[i]);
     }
@@ -167,12 +251,26 @@ MeanShift<UseKernel, KernelType, MatType>::
 CalculateCentroid(const MatType& data,
                   const std::vector<size_t>& neighbors,
                   const std::vector<double>&, /*unused*/
+                  const arma::vec& weights,
                   arma::colvec& centroid)
 {
+  if (weights.empty())
+  {
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      centroid += data.unsafe_col(neighbors[i]);
+
+    centroid /= neighbors.size();
+    return true;
+  }
+
+  double sumWeight = 0;
   for (size_t i = 0; i < neighbors.size(); ++i)
-    centroid += data.unsafe_col(neighbors[i]);
+  {
+    sumWeight += weights[neighbors[i]];
+    centroid += weights[neighbors[i]] * data.unsafe_col(neighbors[i]);
+  }
 
-  centroid /= neighbors.size();
+  centroid /= sumWeight;
   return true;
 }
 
@@ -188,17 +286,41 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
     bool forceConvergence,
     bool useSeeds)
 {
+  // The tree built on the data for the estimation of the radius is reused as
+  // the query tree of the assignments.
+  std::vector<size_t> oldFromNewData;
+  neighbor::KNN dataSearch;
+  bool dataTreeBuilt = false;
   if (radius <= 0)
   {
     // An invalid radius is given; an estimation is needed.
-    Radius(EstimateRadius(data));
+    dataSearch.Train(neighbor::KNN::Tree(data, oldFromNewData));
+    dataTreeBuilt = true;
+    Radius(EstimateRadius(dataSearch, 0.2));
+  }
+
+  // In binned mode, the seeds are shifted over the mean of the points of each
+  // occupied bin, weighted by the number of points in the bin.
+  arma::mat binCorners;
+  MatType binMeans;
+  arma::vec binCounts;
+  const MatType* pReference = &data;
+  if (useBins)
+  {
+    BinPoints(data, radius, binCorners, binMeans, binCounts);
+    pReference = &binMeans;
+    Log::Info << "Shifting seeds over " << binMeans.n_cols << " bins."
+        << std::endl;
   }
 
   MatType seeds;
-  const MatType* pSeeds = &data;
+  const MatType* pSeeds = pReference;
   if (useSeeds)
   {
-    GenSeeds(data, radius, 1, seeds);
+    if (useBins)
+      seeds = binCorners * radius;
+    else
+      GenSeeds(data, radius, 1, seeds);
     pSeeds = &seeds;
   }
 
@@ -207,58 +329,107 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
 
   assignments.set_size(data.n_cols);
 
-  range::RangeSearch<> rangeSearcher(data);
-  math::Range validRadius(0, radius);
-  std::vector<std::vector<size_t> > neighbors;
-  std::vector<std::vector<double> > distances;
+  // All seeds are shifted over the same tree.  Each seed is searched with its
+  // own rules, and the tree is only read, so the seeds are shifted in
+  // parallel.
+  typedef range::RangeSearch<metric::EuclideanDistance, MatType>
+      RangeSearchType;
+  typedef typename RangeSearchType::Tree Tree;
+  typedef range::RangeSearchRules<metric::EuclideanDistance, Tree> RuleType;
+
+  std::vector<size_t> oldFromNew;
+  Tree tree(*pReference, oldFromNew);
+  const MatType& referenceSet = tree.Dataset();
+  arma::vec weights;
+  if (useBins)
+  {
+    weights.set_size(binCounts.n_elem);
+    for (size_t i = 0; i < weights.n_elem; ++i)
+      weights[i] = binCounts[oldFromNew[i]];
+  }
+
+  const math::Range validRadius(0, radius);
+  std::vector<char> converged(pSeeds->n_cols, 0);
 
   // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) pSeeds->n_cols; ++i)
   {
+    metric::EuclideanDistance metric;
+    std::vector<std::vector<size_t> > neighbors(1);
+    std::vector<std::vector<double> > distances(1);
+
     // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
+    MatType centroid = pSeeds->col(i);
     for (size_t completedIterations = 0; completedIterations < maxIterations
         || forceConvergence; completedIterations++)
     {
       // Store new centroid in this.
       arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
 
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
+      neighbors[0].clear();
+      distances[0].clear();
+      range::RangeSearchVectorResults results(neighbors, distances);
+      RuleType rules(referenceSet, centroid, validRadius, results, metric);
+      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+      traverser.Traverse(0, tree);
       if (neighbors[0].size() == 0) // There are no points in the cluster.
         break;
 
       // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
-        newCentroid = allCentroids.unsafe_col(i);
+      if (!CalculateCentroid(referenceSet, neighbors[0], distances[0],
+          weights, newCentroid))
+        newCentroid = centroid.unsafe_col(0);
 
       // If the mean shift vector is small enough, it has converged.
       if (metric::EuclideanDistance::Evaluate(newCentroid,
-          allCentroids.unsafe_col(i)) < 1e-3 * radius)
+          centroid.unsafe_col(0)) < 1e-3 * radius)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
-        {
-          const double distance = metric::EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
-        }
-
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
-
-        // Get out of the loop.
+        converged[i] = 1;
         break;
       }
 
       // Update the centroid.
-      allCentroids.col(i) = newCentroid;
+      centroid = newCentroid;
     }
+
+    allCentroids.col(i) = centroid;
+  }
+
+  // Remove duplicate centroids: a converged centroid is kept unless it is
+  // within the radius of a centroid that was kept before it.  The pairs of
+  // converged centroids that are within the radius are found with one range
+  // search.
+  std::vector<size_t> convergedSeeds;
+  for (size_t i = 0; i < converged.size(); ++i)
+    if (converged[i])
+      convergedSeeds.push_back(i);
+
+  centroids.set_size(data.n_rows, 0);
+  if (!convergedSeeds.empty())
+  {
+    const arma::mat convergedCentroids = allCentroids.cols(
+        arma::conv_to<arma::uvec>::from(convergedSeeds));
+    RangeSearchType duplicateSearcher(convergedCentroids);
+    arma::Col<size_t> offsets, duplicates;
+    arma::vec duplicateDistances;
+    duplicateSearcher.Search(validRadius, offsets, duplicates,
+        duplicateDistances);
+
+    std::vector<bool> isDuplicated(convergedSeeds.size(), false);
+    std::vector<size_t> kept;
+    for (size_t i = 0; i < convergedSeeds.size(); ++i)
+    {
+      if (isDuplicated[i])
+        continue;
+
+      kept.push_back(i);
+      for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+        if (duplicateDistances[j] < radius)
+          isDuplicated[duplicates[j]] = true;
+    }
+
+    centroids = convergedCentroids.cols(arma::conv_to<arma::uvec>::from(kept));
   }
 
   // If no centroid has converged due to too little iterations and without
@@ -285,12 +456,23 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
   }
   else
   {
-    // Assign centroids to each point.
+    // Assign centroids to each point, with a query tree on the data.
+    if (dataTreeBuilt)
+    {
+      ResetStatistics(dataSearch.ReferenceTree());
+    }
+    else
+    {
+      dataSearch.Train(neighbor::KNN::Tree(data, oldFromNewData));
+    }
+
     neighbor::KNN neighborSearcher(centroids);
     arma::mat neighborDistances;
     arma::Mat<size_t> resultingNeighbors;
-    neighborSearcher.Search(data, 1, resultingNeighbors, neighborDistances);
-    assignments = resultingNeighbors;
+    neighborSearcher.Search(dataSearch.ReferenceTree(), 1, resultingNeighbors,
+        neighborDistances);
+    for (size_t i = 0; i < oldFromNewData.size(); ++i)
+      assignments[oldFromNewData[i]] = resultingNeighbors[i];
   }
 }
 
@@ -71,6 +71,11 @@ PARAM_FLAG("labels_only", "If specified, only the output labels will be "
 PARAM_FLAG("force_convergence", "If specified, the mean shift algorithm will "
   "continue running regardless of max_iterations until the clusters converge."
   , "f");
+PARAM_FLAG("use_bins", "If specified, the seeds are shifted over the mean of "
+    "the points of each occupied bin of side length equal to the radius, "
+    "weighted by the number of points in the bin, instead of over all points.  "
+    "This is much faster for large datasets.", "b");
+
 PARAM_MATRIX_OUT("output", "Matrix to write output labels or labeled data to.",
     "o");
 PARAM_MATRIX_OUT("centroid", "If specified, the centroids of each cluster will "
@@ -104,6 +109,7 @@ static void mlpackMain()
   arma::Row<size_t> assignments;
 
   MeanShift<> meanShift(radius, maxIterations);
+  meanShift.UseBins() = CLI::HasParam("use_bins");
 
   Timer::Start("clustering");
   Log::Info << "Performing mean shift clustering..." << endl;
@@ -16,6 +16,7 @@
 #define MLPACK_METHODS_NAIVE_BAYES_NAIVE_BAYES_CLASSIFIER_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/matrix_reader.hpp>
 
 namespace mlpack {
 namespace naive_bayes /** The Naive Bayes Classifier. */ {
@@ -97,7 +98,10 @@ class NaiveBayesClassifier
   /**
    * Train the Naive Bayes classifier on the given dataset.  If the incremental
    * algorithm is used, the current model is used as a starting point (this is
-   * the default).  If the incremental algorithm is not used, then the current
+   * the default): the class counts, means, and variances of the given data are
+   * computed and then merged with those of the model, so the data can be given
+   * in mini-batches, and the result is the same as training on all of the data
+   * at once.  If the incremental algorithm is not used, then the current
    * model is ignored and the new model will be trained only on the given data.
    * Note that even if the incremental algorithm is not used, the data must have
    * the same dimensionality and number of classes that the model was
@@ -128,6 +132,23 @@ class NaiveBayesClassifier
   template<typename VecType>
   void Train(const VecType& point, const size_t label);
 
+  /**
+   * Train the Naive Bayes classifier on the points of the given readers, one
+   * batch at a time, with the incremental algorithm, so that the training data
+   * never has to be in memory at once.  The next batch is read while the
+   * current one is trained on.  A std::runtime_error is thrown if the readers
+   * don't have the same number of points.
+   *
+   * @param data Reader of the dataset to train on.
+   * @param labels Reader of the labels for the dataset, with one dimension.
+   * @param numClasses The number of classes in the dataset.
+   * @param batchSize Number of points read at a time.
+   */
+  void Train(data::MatrixReader& data,
+             data::MatrixReader& labels,
+             const size_t numClasses,
+             const size_t batchSize = 10000);
+
   /**
    * Classify the given point, using the trained NaiveBayesClassifier model. The
    * predicted label is returned.
@@ -225,10 +246,14 @@ class NaiveBayesClassifier
   //! Number of training points seen so far.
   size_t trainingPoints;
 
+  //! Number of points whose log likelihoods are computed at once.
+  static const size_t logLikelihoodBlockSize = 256;
+
   /**
    * Compute the unnormalized posterior log probability of given points (log
    * likelihood). Results are returned as arma::mat, and each column represents
-   * a point, each row represents log likelihood of a class.
+   * a point, each row represents log likelihood of a class.  Blocks of points
+   * are handled in parallel if OpenMP is enabled.
    *
    * @param data Set of points to compute posterior log probability for.
    * @param logLikelihoods Matrix to store log likelihoods in.
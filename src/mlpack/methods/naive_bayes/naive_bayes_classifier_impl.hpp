@@ -101,67 +101,74 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     }
   }
 
-  // Calculate the class probabilities as well as the sample mean and variance
-  // for each of the features with respect to each of the labels.
-  if (incremental)
+  // Calculate the number of points, the sample mean, and the sum of squared
+  // deviations from the mean of each class in the given data.  This is a
+  // two-pass algorithm; a one-pass algorithm would be faster, but it has some
+  // precision and stability issues.
+  arma::vec batchCounts(numClasses, arma::fill::zeros);
+  ModelMatType batchMeans(data.n_rows, numClasses, arma::fill::zeros);
+  ModelMatType batchScatter(data.n_rows, numClasses, arma::fill::zeros);
+  for (size_t j = 0; j < data.n_cols; ++j)
   {
-    // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
-    probabilities *= trainingPoints;
+    const size_t label = labels[j];
+    ++batchCounts[label];
+    batchMeans.col(label) += data.col(j);
+  }
 
-    for (size_t j = 0; j < data.n_cols; ++j)
-    {
-      const size_t label = labels[j];
-      ++probabilities[label];
+  for (size_t i = 0; i < numClasses; ++i)
+    if (batchCounts[i] != 0.0)
+      batchMeans.col(i) /= batchCounts[i];
 
-      arma::vec delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
-    }
+  for (size_t j = 0; j < data.n_cols; ++j)
+  {
+    const size_t label = labels[j];
+    batchScatter.col(label) += square(data.col(j) - batchMeans.col(label));
+  }
 
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-    {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
-    }
+  // If the incremental algorithm is used, the statistics of the data are
+  // merged with those of the current model, following Chan, Golub, and
+  // LeVeque; otherwise the model is trained from scratch.
+  arma::vec counts(numClasses, arma::fill::zeros);
+  if (incremental)
+  {
+    // De-normalize probabilities.
+    for (size_t i = 0; i < numClasses; ++i)
+      counts[i] = probabilities[i] * trainingPoints;
   }
   else
   {
-    // Set all parameters to zero.
-    probabilities.zeros();
     means.zeros();
     variances.zeros();
+    trainingPoints = 0;
+  }
 
-    // Don't use incremental algorithm.  This is a two-pass algorithm.  It is
-    // possible to calculate the means and variances using a faster one-pass
-    // algorithm but there are some precision and stability issues.  If this is
-    // too slow, it's an option to use the faster algorithm by default and then
-    // have this (and the incremental algorithm) be other options.
+  for (size_t i = 0; i < numClasses; ++i)
+  {
+    if (batchCounts[i] == 0.0)
+      continue;
 
-    // Calculate the means.
-    for (size_t j = 0; j < data.n_cols; ++j)
+    const double n = counts[i] + batchCounts[i];
+    if (counts[i] == 0.0)
     {
-      const size_t label = labels[j];
-      ++probabilities[label];
-      means.col(label) += data.col(j);
+      means.col(i) = batchMeans.col(i);
+      variances.col(i) = batchScatter.col(i);
     }
-
-    // Normalize means.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] != 0.0)
-        means.col(i) /= probabilities[i];
-
-    // Calculate variances.
-    for (size_t j = 0; j < data.n_cols; ++j)
+    else
     {
-      const size_t label = labels[j];
-      variances.col(label) += square(data.col(j) - means.col(label));
+      const ModelMatType delta = batchMeans.col(i) - means.col(i);
+      if (counts[i] > 1)
+        variances.col(i) *= (counts[i] - 1);
+      else
+        variances.col(i).zeros();
+
+      variances.col(i) += batchScatter.col(i) +
+          (counts[i] * batchCounts[i] / n) * square(delta);
+      means.col(i) += (batchCounts[i] / n) * delta;
     }
 
-    // Normalize variances.
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
-      if (probabilities[i] > 1)
-        variances.col(i) /= (probabilities[i] - 1);
+    if (n > 1)
+      variances.col(i) /= (n - 1);
+    counts[i] = n;
   }
 
   // Ensure that the variances are invertible.
@@ -169,8 +176,9 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     if (variances[i] == 0.0)
       variances[i] = 1e-50;
 
-  probabilities /= data.n_cols;
   trainingPoints += data.n_cols;
+  for (size_t i = 0; i < numClasses; ++i)
+    probabilities[i] = counts[i] / trainingPoints;
 }
 
 template<typename ModelMatType>
@@ -198,6 +206,39 @@ void NaiveBayesClassifier<ModelMatType>::Train(const VecType& point,
   probabilities /= trainingPoints;
 }
 
+template<typename ModelMatType>
+void NaiveBayesClassifier<ModelMatType>::Train(data::MatrixReader& data,
+                                               data::MatrixReader& labels,
+                                               const size_t numClasses,
+                                               const size_t batchSize)
+{
+  if (labels.Dimensionality() != 1)
+  {
+    std::ostringstream oss;
+    oss << "NaiveBayesClassifier::Train(): the labels have "
+        << labels.Dimensionality() << " dimensions, but should have 1";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat dataBatch, labelBatch;
+  bool moreData = data.NextBatch(dataBatch, batchSize);
+  bool moreLabels = labels.NextBatch(labelBatch, batchSize);
+  while (moreData && moreLabels && dataBatch.n_cols == labelBatch.n_cols)
+  {
+    Train(arma::conv_to<ModelMatType>::from(dataBatch),
+        arma::conv_to<arma::Row<size_t>>::from(labelBatch), numClasses, true);
+
+    moreData = data.NextBatch(dataBatch, batchSize);
+    moreLabels = labels.NextBatch(labelBatch, batchSize);
+  }
+
+  if (moreData || moreLabels)
+  {
+    throw std::runtime_error("NaiveBayesClassifier::Train(): the data and the "
+        "labels don't have the same number of points");
+  }
+}
+
 template<typename ModelMatType>
 template<typename MatType>
 void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
@@ -208,23 +249,38 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  logLikelihoods = arma::log(arma::repmat(probabilities, 1, data.n_cols));
-  ModelMatType invVar = 1.0 / variances;
-
-  // Calculate the joint log likelihood of point for each of the
-  // means.n_cols.
-
-  // Loop over every class.
-  for (size_t i = 0; i < means.n_cols; i++)
+  // The log likelihood of a point for class i is the log prior probability of
+  // the class, plus the log density of a Gaussian with diagonal covariance.
+  // The terms that do not depend on the point are computed once.
+  const ModelMatType invVar = 1.0 / variances;
+  const ModelMatType logConstants = arma::log(probabilities) -
+      data.n_rows / 2.0 * std::log(2 * M_PI) -
+      0.5 * arma::trans(arma::sum(arma::log(variances), 0));
+
+  // Each block of points is handled at once, so that the Mahalanobis distances
+  // to the means of all the classes are computed with matrix-vector products
+  // on a block that stays in cache.  The blocks are independent.
+  logLikelihoods.set_size(means.n_cols, data.n_cols);
+  const size_t numBlocks = (data.n_cols + logLikelihoodBlockSize - 1) /
+      logLikelihoodBlockSize;
+
+  #pragma omp parallel for schedule(static) if (numBlocks > 1)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
   {
-    // This is an adaptation of gmm::phi() for the case where the covariance is
-    // a diagonal matrix.
-    ModelMatType diffs = data - arma::repmat(means.col(i), 1, data.n_cols);
-    ModelMatType rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::Mat<ElemType> exponents = arma::sum(diffs % rhs, 0);
-
-    logLikelihoods.row(i) += (data.n_rows / -2.0 * log(2 * M_PI) - 0.5 *
-        std::log(arma::det(arma::diagmat(variances.col(i)))) + exponents);
+    const size_t begin = b * logLikelihoodBlockSize;
+    const size_t end = std::min(begin + logLikelihoodBlockSize,
+        (size_t) data.n_cols) - 1;
+    const ModelMatType block(data.cols(begin, end));
+
+    for (size_t i = 0; i < means.n_cols; ++i)
+    {
+      // Subtracting the mean first (instead of expanding the square into
+      // products with precision-weighted means) keeps the result accurate for
+      // features with tiny variances.
+      const ModelMatType diffs = block.each_col() - means.col(i);
+      logLikelihoods.submat(i, begin, i, end) = logConstants[i] -
+          0.5 * (arma::trans(invVar.col(i)) * arma::square(diffs));
+    }
   }
 }
 
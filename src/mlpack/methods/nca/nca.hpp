@@ -61,10 +61,13 @@ class NCA
    * @param tolerance Tolerance for termination of stochastic gradient descent.
    * @param shuffle Whether or not to shuffle the dataset during SGD.
    * @param metric Instantiated metric to use.
+   * @param numNeighbors If nonzero, truncate the neighborhood of each point to
+   *     its numNeighbors nearest neighbors in the transformed space.
    */
   NCA(const arma::mat& dataset,
       const arma::Row<size_t>& labels,
-      MetricType metric = MetricType());
+      MetricType metric = MetricType(),
+      const size_t numNeighbors = 0);
 
   /**
    * Perform Neighborhood Components Analysis.  The output distance learning
@@ -82,6 +85,10 @@ class NCA
   //! Get the labels reference.
   const arma::Row<size_t>& Labels() const { return labels; }
 
+  //! Get the number of neighbors in the neighborhood of each point (0 means
+  //! all points).
+  size_t NumNeighbors() const { return errorFunction.NumNeighbors(); }
+
   //! Get the optimizer.
   const OptimizerType& Optimizer() const { return optimizer; }
   OptimizerType& Optimizer() { return optimizer; }
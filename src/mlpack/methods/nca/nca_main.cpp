@@ -88,7 +88,14 @@ PROGRAM_INFO("Neighborhood Components Analysis (NCA)",
     "mlpack L-BFGS documentation (in lbfgs.hpp) or the vast set of published "
     "literature on L-BFGS."
     "\n\n"
-    "By default, the SGD optimizer is used.",
+    "By default, the SGD optimizer is used."
+    "\n\n"
+    "Each evaluation of the objective takes time quadratic in the number of "
+    "points.  For large datasets, the " + PRINT_PARAM_STRING("num_neighbors") +
+    " parameter can be used to only consider the given number of nearest "
+    "neighbors of each point in the transformed space; the neighbors are "
+    "searched again for each new L-BFGS iterate, or at the start of each pass "
+    "of SGD over the data.",
     SEE_ALSO("@lmnn", "#lmnn"),
     SEE_ALSO("Neighbourhood components analysis on Wikipedia",
         "https://en.wikipedia.org/wiki/Neighbourhood_components_analysis"),
@@ -129,6 +136,9 @@ PARAM_DOUBLE_IN("min_step", "Minimum step of line search for L-BFGS.", "m",
 PARAM_DOUBLE_IN("max_step", "Maximum step of line search for L-BFGS.", "M",
     1e20);
 
+PARAM_INT_IN("num_neighbors", "If nonzero, only this many nearest neighbors "
+    "of each point are used in the softmax.", "k", 0);
+
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -149,6 +159,8 @@ static void mlpackMain()
   const string optimizerType = CLI::GetParam<string>("optimizer");
   RequireParamInSet<string>("optimizer", { "sgd", "lbfgs" },
       true, "unknown optimizer type");
+  RequireParamValue<int>("num_neighbors", [](int x) { return x >= 0; }, true,
+      "number of neighbors must be positive or zero");
 
   // Warn on unused parameters.
   if (optimizerType == "sgd")
@@ -181,6 +193,7 @@ static void mlpackMain()
   const double minStep = CLI::GetParam<double>("min_step");
   const double maxStep = CLI::GetParam<double>("max_step");
   const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
+  const size_t numNeighbors = (size_t) CLI::GetParam<int>("num_neighbors");
 
   // Load data.
   arma::mat data = std::move(CLI::GetParam<arma::mat>("input"));
@@ -206,6 +219,12 @@ static void mlpackMain()
     data.shed_row(data.n_rows - 1);
   }
 
+  if (numNeighbors >= data.n_cols)
+  {
+    Log::Fatal << "The number of neighbors (" << numNeighbors << ") must be "
+        << "less than the number of points (" << data.n_cols << ")!" << endl;
+  }
+
   // Now, normalize the labels.
   arma::Col<size_t> mappings;
   arma::Row<size_t> labels;
@@ -234,7 +253,7 @@ static void mlpackMain()
   // Now create the NCA object and run the optimization.
   if (optimizerType == "sgd")
   {
-    NCA<LMetric<2> > nca(data, labels);
+    NCA<LMetric<2> > nca(data, labels, LMetric<2>(), numNeighbors);
     nca.Optimizer().StepSize() = stepSize;
     nca.Optimizer().MaxIterations() = maxIterations;
     nca.Optimizer().Tolerance() = tolerance;
@@ -245,7 +264,8 @@ static void mlpackMain()
   }
   else if (optimizerType == "lbfgs")
   {
-    NCA<LMetric<2>, ens::L_BFGS> nca(data, labels);
+    NCA<LMetric<2>, ens::L_BFGS> nca(data, labels, LMetric<2>(),
+        numNeighbors);
     nca.Optimizer().NumBasis() = numBasis;
     nca.Optimizer().MaxIterations() = maxIterations;
     nca.Optimizer().ArmijoConstant() = armijoConstant;
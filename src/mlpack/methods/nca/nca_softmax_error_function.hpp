@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 namespace mlpack {
 namespace nca {
@@ -38,6 +39,21 @@ namespace nca {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * The softmax terms are computed for blocks of points at once, in parallel
+ * with OpenMP.  For the Euclidean and squared Euclidean distances, the
+ * distances of a block of points to all points are computed with one matrix
+ * product, and the gradient is assembled from matrix products as well, so no
+ * temporaries are created for each pair of points.
+ *
+ * The cost of evaluating the objective is O(n^2 d), because the denominator
+ * of each p_ij is a sum over all points.  For large datasets, the neighborhood
+ * of each point can be truncated to its k nearest neighbors in the transformed
+ * space (see the numNeighbors parameter of the constructor); the neighbors are
+ * found with a tree-based NeighborSearch, and the cost drops to O(n k d).  The
+ * non-separable Evaluate() and Gradient() search the neighbors again for each
+ * new transformation, and the separable overloads search them again at the
+ * start of each pass over the data (that is, when begin is 0).
  */
 template<typename MetricType = metric::SquaredEuclideanDistance>
 class SoftmaxErrorFunction
@@ -52,10 +68,13 @@ class SoftmaxErrorFunction
    * @param dataset Matrix containing the dataset.
    * @param labels Vector of class labels for each point in the dataset.
    * @param kernel Instantiated kernel (optional).
+   * @param numNeighbors If nonzero, only the numNeighbors nearest neighbors of
+   *     each point in the transformed space are used in its softmax.
    */
   SoftmaxErrorFunction(const arma::mat& dataset,
                        const arma::Row<size_t>& labels,
-                       MetricType metric = MetricType());
+                       MetricType metric = MetricType(),
+                       const size_t numNeighbors = 0);
 
   /**
    * Shuffle the dataset.
@@ -118,6 +137,35 @@ class SoftmaxErrorFunction
                 GradType& gradient,
                 const size_t batchSize = 1);
 
+  /**
+   * Evaluate the softmax function and its gradient for the given covariance
+   * matrix, in one pass over the data.  This is the non-separable
+   * implementation.
+   *
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   * @param gradient Matrix to store the calculated gradient in.
+   */
+  double EvaluateWithGradient(const arma::mat& covariance,
+                              arma::mat& gradient);
+
+  /**
+   * Evaluate the softmax objective function and its gradient for the given
+   * covariance matrix on the given batch size, from a given initial point of
+   * the dataset, in one pass over the data.  This is the separable
+   * implementation.
+   *
+   * @tparam GradType The type of the gradient out-param.
+   * @param covariance Covariance matrix of Mahalanobis distance.
+   * @param begin Index of the initial point to use for objective function.
+   * @param gradient Matrix to store the calculated gradient in.
+   * @param batchSize Number of points to use for objective function.
+   */
+  template <typename GradType>
+  double EvaluateWithGradient(const arma::mat& covariance,
+                              const size_t begin,
+                              GradType& gradient,
+                              const size_t batchSize = 1);
+
   /**
    * Get the initial point.
    */
@@ -129,6 +177,10 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the number of neighbors in the neighborhood of each point (0 means
+  //! all points).
+  size_t NumNeighbors() const { return numNeighbors; }
+
  private:
   //! The dataset.  This is an alias until Shuffle() is called.
   arma::mat dataset;
@@ -139,33 +191,92 @@ class SoftmaxErrorFunction
   //! The instantiated metric.
   MetricType metric;
 
+  //! Number of neighbors of each point, or 0 to use all points.
+  size_t numNeighbors;
+
   //! Last coordinates.  Used for the non-separable Evaluate() and Gradient().
   arma::mat lastCoordinates;
   //! Stretched dataset.  Kept internal to avoid memory reallocations.
   arma::mat stretchedDataset;
-  //! Holds calculated p_i, for the non-separable Evaluate() and Gradient().
-  arma::vec p;
-  //! Holds denominators for calculation of p_ij, for the non-separable
-  //! Evaluate() and Gradient().
-  arma::vec denominators;
+  //! Squared norms of the points of the stretched dataset.
+  arma::rowvec stretchedNorms;
+  //! The nearest neighbors of each point, if the neighborhoods are truncated.
+  arma::Mat<size_t> neighborhoods;
+  //! Holds the objective for the last coordinates, for the non-separable
+  //! Evaluate().
+  double objective;
+  //! Whether the objective has been computed for the last coordinates.
+  bool objectiveValid;
 
   //! False if nothing has ever been precalculated (only at construction time).
   bool precalculated;
 
   /**
-   * Precalculate the denominators and numerators that will make up the p_ij,
-   * but only if the coordinates matrix is different than the last coordinates
-   * the Precalculate() method was run with.  This method is only called by the
+   * Stretch the dataset with the given coordinates and, if the neighborhoods
+   * are truncated, search the neighbors of each point again (the objective is
+   * then computed by Evaluate() or EvaluateWithGradient()), but only if the
+   * coordinates matrix is different than the last coordinates the
+   * Precalculate() method was run with.  This method is only called by the
    * non-separable Evaluate() and Gradient().
    *
-   * This will update last_coordinates_ and stretched_dataset_, and also
-   * calculate the p_i and denominators_ which are used in the calculation of
-   * p_i or p_ij.  The calculation will be O((n * (n + 1)) / 2), which is not
-   * great.
-   *
    * @param coordinates Coordinates matrix to use for precalculation.
    */
   void Precalculate(const arma::mat& coordinates);
+
+  /**
+   * Stretch the whole dataset with the given coordinates, and compute the
+   * squared norms of the stretched points.
+   *
+   * @param coordinates Coordinates matrix to stretch the dataset with.
+   */
+  void Stretch(const arma::mat& coordinates);
+
+  /**
+   * Compute the sum of p_i for the points in [begin, end), and optionally the
+   * matrix
+   *
+   *   sum_i sum_k p_ik (p_i - [y_i == y_k]) x_ik x_ik^T
+   *
+   * over those points, from which the gradient is obtained as -2 A times that
+   * matrix.  If the neighborhoods are not truncated, the stretched dataset must
+   * correspond to the given coordinates.
+   *
+   * @param coordinates Coordinates matrix.
+   * @param begin Index of the first point.
+   * @param end One past the index of the last point.
+   * @param useStretched Whether the stretched dataset corresponds to the given
+   *     coordinates (if it does not, only the needed points are stretched).
+   * @param gradientSum If not NULL, the matrix to store the gradient sum in.
+   */
+  double SoftmaxSum(const arma::mat& coordinates,
+                    const size_t begin,
+                    const size_t end,
+                    const bool useStretched,
+                    arma::mat* gradientSum);
+
+  /**
+   * Compute the distances between the stretched points in [begin, end) and
+   * all stretched points, with the metric.
+   */
+  template<typename OtherMetricType>
+  void BlockDistances(const OtherMetricType& /* metric */,
+                      const size_t begin,
+                      const size_t end,
+                      arma::mat& distances);
+
+  /**
+   * Compute the distances between the stretched points in [begin, end) and
+   * all stretched points with one matrix product, for the Euclidean and
+   * squared Euclidean distances.
+   */
+  template<bool TakeRoot>
+  void BlockDistances(const metric::LMetric<2, TakeRoot>& /* metric */,
+                      const size_t begin,
+                      const size_t end,
+                      arma::mat& distances);
+
+  //! Search the nearest neighbors of each point in the stretched dataset.
+  void UpdateNeighborhoods();
 };
 
 } // namespace nca
@@ -23,12 +23,25 @@ template<typename MetricType>
 SoftmaxErrorFunction<MetricType>::SoftmaxErrorFunction(
     const arma::mat& dataset,
     const arma::Row<size_t>& labels,
-    MetricType metric) :
+    MetricType metric,
+    const size_t numNeighbors) :
     dataset(math::MakeAlias(const_cast<arma::mat&>(dataset), false)),
     labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
     metric(metric),
+    numNeighbors(numNeighbors),
+    objective(0.0),
+    objectiveValid(false),
     precalculated(false)
-{ /* nothing to do */ }
+{
+  if (numNeighbors >= dataset.n_cols && numNeighbors > 0)
+  {
+    std::ostringstream oss;
+    oss << "SoftmaxErrorFunction::SoftmaxErrorFunction(): number of neighbors ("
+        << numNeighbors << ") must be less than the number of points ("
+        << dataset.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+}
 
 //! Shuffle the dataset.
 template<typename MetricType>
@@ -44,17 +57,28 @@ void SoftmaxErrorFunction<MetricType>::Shuffle()
 
   dataset = std::move(newDataset);
   labels = std::move(newLabels);
+
+  // The cached values refer to the old order of the points.
+  neighborhoods.reset();
+  precalculated = false;
 }
 
 //! The non-separable implementation, which uses Precalculate() to save time.
 template<typename MetricType>
 double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates)
 {
-  // Calculate the denominators and numerators, if necessary.
+  // Calculate the stretched dataset and the objective, if necessary.
   Precalculate(coordinates);
 
-  return -accu(p); // Sum of p_i for all i.  We negate because our solver
-                   // minimizes, not maximizes.
+  if (!objectiveValid)
+  {
+    // Sum of p_i for all i.  We negate because our solver minimizes, not
+    // maximizes.
+    objective = -SoftmaxSum(coordinates, 0, dataset.n_cols, true, NULL);
+    objectiveValid = true;
+  }
+
+  return objective;
 };
 
 //! The separated objective function, which does not use Precalculate(),
@@ -64,45 +88,19 @@ double SoftmaxErrorFunction<MetricType>::Evaluate(const arma::mat& coordinates,
                                                   const size_t begin,
                                                   const size_t batchSize)
 {
-  // Unfortunately each evaluation will take O(N) time because it requires a
-  // scan over all points in the dataset.  Our objective is to compute p_i.
-  double denominator = 0;
-  double numerator = 0;
-  double result = 0;
-
-  // It's quicker to do this now than one point at a time later.
-  stretchedDataset = coordinates * dataset;
-  for (size_t i = begin; i < begin + batchSize; i++)
+  // Without truncated neighborhoods each evaluation takes O(N) time per point,
+  // because every point is in the denominator of p_i.
+  const bool stretched = (numNeighbors == 0 || begin == 0 ||
+      neighborhoods.n_cols != dataset.n_cols);
+  if (stretched)
   {
-    for (size_t k = 0; k < dataset.n_cols; ++k)
-    {
-      // Don't consider the case where the points are the same.
-      if (k == i)
-        continue;
-
-      // We want to evaluate exp(-D(A x_i, A x_k)).
-      double eval = std::exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                              stretchedDataset.unsafe_col(k)));
-
-      // If they are in the same class, update the numerator.
-      if (labels[i] == labels[k])
-        numerator += eval;
-
-      denominator += eval;
-    }
-
-    // Now the result is just a simple division, but we have to be sure that the
-    // denominator is not 0.
-    if (denominator == 0.0)
-    {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
-      continue;
-    }
-
-    result += -(numerator / denominator); // Negate because the optimizer is a
-                                          // minimizer.
+    Stretch(coordinates);
+    if (numNeighbors > 0)
+      UpdateNeighborhoods();
   }
-  return result;
+
+  // Negate because the optimizer is a minimizer.
+  return -SoftmaxSum(coordinates, begin, begin + batchSize, stretched, NULL);
 }
 
 //! The non-separable implementation, where Precalculate() is used.
@@ -110,47 +108,7 @@ template<typename MetricType>
 void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 arma::mat& gradient)
 {
-  // Calculate the denominators and numerators, if necessary.
-  Precalculate(coordinates);
-
-  // Now, we handle the summation over i:
-  //   sum_i (p_i sum_k (p_ik x_ik x_ik^T) -
-  //       sum_{j in class of i} (p_ij x_ij x_ij^T)
-  // We can algebraically manipulate the whole thing to produce a more
-  // memory-friendly way to calculate this.  Looping over each i and k (again
-  // O((n * (n + 1)) / 2) as with the last step, we can add the following to the
-  // sum:
-  //
-  //   if class of i is the same as the class of k, add
-  //     (((p_i - (1 / p_i)) p_ik) + ((p_k - (1 / p_k)) p_ki)) x_ik x_ik^T
-  //   otherwise, add
-  //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
-  arma::mat sum;
-  sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
-  {
-    for (size_t k = (i + 1); k < stretchedDataset.n_cols; k++)
-    {
-      // Calculate p_ik and p_ki first.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-      double p_ik = 0, p_ki = 0;
-      p_ik = eval / denominators(i);
-      p_ki = eval / denominators(k);
-
-      // Subtract x_i from x_k.  We are not using stretched points here.
-      arma::vec x_ik = dataset.col(i) - dataset.col(k);
-      arma::mat secondTerm = (x_ik * trans(x_ik));
-
-      if (labels[i] == labels[k])
-        sum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) * secondTerm;
-      else
-        sum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
-    }
-  }
-
-  // Assemble the final gradient.
-  gradient = -2 * coordinates * sum;
+  EvaluateWithGradient(coordinates, gradient);
 }
 
 //! The separable implementation for a given batch size and an initial index.
@@ -161,72 +119,59 @@ void SoftmaxErrorFunction<MetricType>::Gradient(const arma::mat& coordinates,
                                                 GradType& gradient,
                                                 const size_t batchSize)
 {
-  // The gradient involves two matrix terms which are eventually combined into
-  // one.
-  GradType firstTerm, secondTerm;
-  // We will need to calculate p_i before this evaluation is done, so
-  // these two variables will hold the information necessary for that.
-  double numerator, denominator;
+  EvaluateWithGradient(coordinates, begin, gradient, batchSize);
+}
 
-  gradient.zeros(coordinates.n_rows, coordinates.n_rows);
+//! The non-separable implementation, where Precalculate() is used.
+template<typename MetricType>
+double SoftmaxErrorFunction<MetricType>::EvaluateWithGradient(
+    const arma::mat& coordinates,
+    arma::mat& gradient)
+{
+  // Stretch the dataset and search the neighborhoods, if necessary.
+  Precalculate(coordinates);
 
-  // Compute the stretched dataset.
-  stretchedDataset = coordinates * dataset;
-  for (size_t i = begin; i < begin + batchSize; i++)
-  {
-    numerator = 0;
-    denominator = 0;
+  // The gradient is
+  //   -2 A sum_i (p_i sum_k (p_ik x_ik x_ik^T) -
+  //       sum_{j in class of i} (p_ij x_ij x_ij^T)),
+  // which SoftmaxSum() assembles with matrix products.
+  arma::mat sum;
+  objective = -SoftmaxSum(coordinates, 0, dataset.n_cols, true, &sum);
+  objectiveValid = true;
 
-    firstTerm.zeros(coordinates.n_rows, coordinates.n_cols);
-    secondTerm.zeros(coordinates.n_rows, coordinates.n_cols);
+  // Assemble the final gradient.
+  gradient = -2 * coordinates * sum;
 
-    for (size_t k = 0; k < dataset.n_cols; ++k)
-    {
-      // Don't consider the case where the points are the same.
-      if (i == k)
-        continue;
-
-      // Calculate the numerator of p_ik.
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(k)));
-
-      // If the points are in the same class, we must add to the second term of
-      // the gradient as well as the numerator of p_i.  We will divide by the
-      // denominator of p_ik later.  For x_ik we are not using stretched points.
-      GradType x_ik = dataset.col(i) - dataset.col(k);
-      if (labels[i] == labels[k])
-      {
-        numerator += eval;
-        secondTerm += eval * x_ik * trans(x_ik);
-      }
+  return objective;
+}
 
-      // We always have to add to the denominator of p_i
-      // and the first term of the gradient computation.
-      // We will divide by the denominator of p_ik later.
-      denominator += eval;
-      firstTerm += eval * x_ik * trans(x_ik);
-    }
+//! The separable implementation for a given batch size and an initial index.
+template <typename MetricType>
+template <typename GradType>
+double SoftmaxErrorFunction<MetricType>::EvaluateWithGradient(
+    const arma::mat& coordinates,
+    const size_t begin,
+    GradType& gradient,
+    const size_t batchSize)
+{
+  const bool stretched = (numNeighbors == 0 || begin == 0 ||
+      neighborhoods.n_cols != dataset.n_cols);
+  if (stretched)
+  {
+    Stretch(coordinates);
+    if (numNeighbors > 0)
+      UpdateNeighborhoods();
+  }
 
-    // Calculate p_i.
-    double p = 0;
-    if (denominator == 0)
-    {
-      Log::Warn << "Denominator of p_" << i << " is 0!" << std::endl;
-      // If the denominator is zero, then all p_ik should be zero and there is
-      // no gradient contribution from this point.
-      continue;
-    }
-    else
-    {
-      p = numerator / denominator;
-      firstTerm /= denominator;
-      secondTerm /= denominator;
-    }
+  arma::mat sum;
+  const double result = SoftmaxSum(coordinates, begin, begin + batchSize,
+      stretched, &sum);
 
-    // Now multiply the first term by p_i, and add the two together and multiply
-    // all by 2 * A.  We negate it though, because our optimizer is a minimizer.
-    gradient += -2 * coordinates * (p * firstTerm - secondTerm);
-  }
+  // Multiply by 2 * A.  We negate it though, because our optimizer is a
+  // minimizer.
+  gradient = -2 * coordinates * sum;
+
+  return -result;
 }
 
 template<typename MetricType>
@@ -253,55 +198,278 @@ void SoftmaxErrorFunction<MetricType>::Precalculate(
 
   // Coordinates are different; save the new ones, and stretch the dataset.
   lastCoordinates = coordinates;
+  Stretch(coordinates);
+
+  if (numNeighbors > 0)
+    UpdateNeighborhoods();
+  objectiveValid = false;
+
+  // We've done a precalculation.  Mark it as done.
+  precalculated = true;
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::Stretch(const arma::mat& coordinates)
+{
   stretchedDataset = coordinates * dataset;
+  stretchedNorms = arma::sum(arma::square(stretchedDataset), 0);
 
-  // For each point i, we must evaluate the softmax function:
-  //   p_ij = exp( -K(x_i, x_j) ) / ( sum_{k != i} ( exp( -K(x_i, x_k) )))
-  //   p_i = sum_{j in class of i} p_ij
-  // We will do this by keeping track of the denominators for each i as well as
-  // the numerators (the sum for all j in class of i).  This will be on the
-  // order of O((n * (n + 1)) / 2), which really isn't all that great.
-  p.zeros(stretchedDataset.n_cols);
-  denominators.zeros(stretchedDataset.n_cols);
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+  // The stretched dataset may not correspond to lastCoordinates anymore.
+  precalculated = false;
+}
+
+template<typename MetricType>
+double SoftmaxErrorFunction<MetricType>::SoftmaxSum(
+    const arma::mat& coordinates,
+    const size_t begin,
+    const size_t end,
+    const bool useStretched,
+    arma::mat* gradientSum)
+{
+  const size_t n = dataset.n_cols;
+  const size_t d = dataset.n_rows;
+
+  double result = 0.0;
+  size_t zeroDenominators = 0;
+
+  // Without truncated neighborhoods, the sum over all k of
+  // w_ik x_ik x_ik^T, with w_ik = p_ik (p_i - [y_i == y_k]), is
+  //   X_B diag(W 1) X_B^T + X diag(W^T 1) X^T - X_B W X^T - (X_B W X^T)^T
+  // for a block B of points, so only the column sums of W are kept across
+  // blocks.
+  arma::rowvec columnWeights;
+  if (gradientSum)
+  {
+    gradientSum->zeros(d, d);
+    if (numNeighbors == 0)
+      columnWeights.zeros(n);
+  }
+
+  if (numNeighbors == 0)
   {
-    for (size_t j = (i + 1); j < stretchedDataset.n_cols; j++)
+    // Each block holds a few distance matrices of blockSize x n elements.
+    const size_t blockSize = std::max((size_t) 1,
+        std::min((size_t) 64, ((size_t) 1 << 18) / n));
+    const size_t numBlocks = (end - begin + blockSize - 1) / blockSize;
+
+    #pragma omp parallel
     {
-      // Evaluate exp(-d(x_i, x_j)).
-      double eval = exp(-metric.Evaluate(stretchedDataset.unsafe_col(i),
-                                         stretchedDataset.unsafe_col(j)));
+      arma::mat kernel, weights, localSum;
+      arma::rowvec localColumnWeights;
+      if (gradientSum)
+      {
+        localSum.zeros(d, d);
+        localColumnWeights.zeros(n);
+      }
+      double localResult = 0.0;
+      size_t localZeroDenominators = 0;
 
-      // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
-      denominators[i] += eval;
-      denominators[j] += eval;
+      #pragma omp for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+      {
+        const size_t blockBegin = begin + b * blockSize;
+        const size_t blockEnd = std::min(blockBegin + blockSize, end);
+        const size_t rows = blockEnd - blockBegin;
+
+        // Evaluate exp(-d(A x_i, A x_k)), and don't consider the case where
+        // the points are the same.
+        BlockDistances(metric, blockBegin, blockEnd, kernel);
+        kernel = arma::exp(-kernel);
+        for (size_t i = blockBegin; i < blockEnd; ++i)
+          kernel(i - blockBegin, i) = 0.0;
+
+        // The denominators sum over all points, and the numerators over the
+        // points in the same class.
+        const arma::vec denominators = arma::sum(kernel, 1);
+        arma::vec numerators(rows, arma::fill::zeros);
+        for (size_t k = 0; k < n; ++k)
+          for (size_t r = 0; r < rows; ++r)
+            if (labels[k] == labels[blockBegin + r])
+              numerators[r] += kernel(r, k);
+
+        arma::vec p(rows), scales(rows);
+        for (size_t r = 0; r < rows; ++r)
+        {
+          // If the denominator is zero, then all p_ik should be zero and
+          // there is no contribution from this point.
+          if (denominators[r] == 0.0)
+          {
+            ++localZeroDenominators;
+            p[r] = 0.0;
+            scales[r] = 0.0;
+          }
+          else
+          {
+            p[r] = numerators[r] / denominators[r];
+            scales[r] = 1.0 / denominators[r];
+          }
+        }
+
+        localResult += arma::accu(p);
+
+        if (!gradientSum)
+          continue;
+
+        weights.set_size(rows, n);
+        for (size_t k = 0; k < n; ++k)
+        {
+          for (size_t r = 0; r < rows; ++r)
+          {
+            const double same = (labels[k] == labels[blockBegin + r]) ? 1.0 :
+                0.0;
+            weights(r, k) = kernel(r, k) * scales[r] * (p[r] - same);
+          }
+        }
+
+        const arma::mat blockPoints = dataset.cols(blockBegin, blockEnd - 1);
+        const arma::vec rowWeights = arma::sum(weights, 1);
+        localColumnWeights += arma::sum(weights, 0);
+
+        const arma::mat cross = blockPoints * (weights * dataset.t());
+        localSum += (blockPoints.each_row() % rowWeights.t()) *
+            blockPoints.t() - cross - cross.t();
+      }
 
-      // If i and j are the same class, add to numerator of both.
-      if (labels[i] == labels[j])
+      #pragma omp critical
       {
-        p[i] += eval;
-        p[j] += eval;
+        result += localResult;
+        zeroDenominators += localZeroDenominators;
+        if (gradientSum)
+        {
+          *gradientSum += localSum;
+          columnWeights += localColumnWeights;
+        }
       }
     }
+
+    if (gradientSum)
+      *gradientSum += (dataset.each_row() % columnWeights) * dataset.t();
   }
+  else
+  {
+    #pragma omp parallel
+    {
+      arma::mat localSum, projected, differences;
+      if (gradientSum)
+        localSum.zeros(d, d);
+      arma::uvec indices(numNeighbors + 1);
+      arma::vec kernel(numNeighbors), weights(numNeighbors);
+      double localResult = 0.0;
+      size_t localZeroDenominators = 0;
+
+      #pragma omp for schedule(static)
+      for (omp_size_t i = begin; i < (omp_size_t) end; ++i)
+      {
+        indices[0] = i;
+        for (size_t j = 0; j < numNeighbors; ++j)
+          indices[j + 1] = neighborhoods(j, i);
+
+        // Only the point and its neighbors need to be stretched.
+        if (useStretched)
+          projected = stretchedDataset.cols(indices);
+        else
+          projected = coordinates * dataset.cols(indices);
+
+        double numerator = 0.0, denominator = 0.0;
+        for (size_t j = 0; j < numNeighbors; ++j)
+        {
+          kernel[j] = std::exp(-metric.Evaluate(projected.unsafe_col(0),
+              projected.unsafe_col(j + 1)));
+          denominator += kernel[j];
+          if (labels[indices[j + 1]] == labels[i])
+            numerator += kernel[j];
+        }
+
+        if (denominator == 0.0)
+        {
+          ++localZeroDenominators;
+          continue;
+        }
+
+        const double p = numerator / denominator;
+        localResult += p;
+
+        if (!gradientSum)
+          continue;
+
+        for (size_t j = 0; j < numNeighbors; ++j)
+        {
+          const double same = (labels[indices[j + 1]] == labels[i]) ? 1.0 :
+              0.0;
+          weights[j] = kernel[j] / denominator * (p - same);
+        }
+
+        differences = dataset.cols(indices.tail(numNeighbors));
+        differences.each_col() -= dataset.col(i);
+        localSum += (differences.each_row() % weights.t()) * differences.t();
+      }
 
-  // Divide p_i by their denominators.
-  p /= denominators;
+      #pragma omp critical
+      {
+        result += localResult;
+        zeroDenominators += localZeroDenominators;
+        if (gradientSum)
+          *gradientSum += localSum;
+      }
+    }
+  }
 
-  // Clean up any bad values.
-  for (size_t i = 0; i < stretchedDataset.n_cols; i++)
+  if (zeroDenominators > 0)
   {
-    if (denominators[i] == 0.0)
-    {
-      Log::Debug << "Denominator of p_{" << i << ", j} is 0." << std::endl;
+    Log::Warn << "Denominator of p_i is 0 for " << zeroDenominators
+        << " points!" << std::endl;
+  }
+
+  return result;
+}
 
-      // Set to usable values.
-      denominators[i] = std::numeric_limits<double>::infinity();
-      p[i] = 0;
+template<typename MetricType>
+template<typename OtherMetricType>
+void SoftmaxErrorFunction<MetricType>::BlockDistances(
+    const OtherMetricType& /* metric */,
+    const size_t begin,
+    const size_t end,
+    arma::mat& distances)
+{
+  distances.set_size(end - begin, stretchedDataset.n_cols);
+  for (size_t k = 0; k < stretchedDataset.n_cols; ++k)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      distances(i - begin, k) = metric.Evaluate(stretchedDataset.unsafe_col(i),
+          stretchedDataset.unsafe_col(k));
     }
   }
+}
 
-  // We've done a precalculation.  Mark it as done.
-  precalculated = true;
+template<typename MetricType>
+template<bool TakeRoot>
+void SoftmaxErrorFunction<MetricType>::BlockDistances(
+    const metric::LMetric<2, TakeRoot>& /* metric */,
+    const size_t begin,
+    const size_t end,
+    arma::mat& distances)
+{
+  // || a - b ||^2 = || a ||^2 + || b ||^2 - 2 a^T b.
+  distances = -2 * stretchedDataset.cols(begin, end - 1).t() *
+      stretchedDataset;
+  distances.each_col() += stretchedNorms.subvec(begin, end - 1).t();
+  distances.each_row() += stretchedNorms;
+
+  // The cancellation can leave small negative values.
+  distances = arma::clamp(distances, 0.0, std::numeric_limits<double>::max());
+  if (TakeRoot)
+    distances = arma::sqrt(distances);
+}
+
+template<typename MetricType>
+void SoftmaxErrorFunction<MetricType>::UpdateNeighborhoods()
+{
+  // The neighbors are searched with the Euclidean distance in the transformed
+  // space; self-matches are excluded by the monochromatic search.
+  neighbor::KNN knn(stretchedDataset);
+  arma::mat distances;
+  knn.Search(numNeighbors, neighborhoods, distances);
 }
 
 } // namespace nca
@@ -0,0 +1,171 @@
+/**
+ * @file dynamic_neighbor_search.hpp
+ *
+ * Defines the DynamicNeighborSearch class, which performs neighbor search on a
+ * reference set that points can be inserted into and removed from, without
+ * rebuilding a tree on the whole reference set each time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_DYNAMIC_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_DYNAMIC_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <vector>
+#include "neighbor_search.hpp"
+#include "sharded_neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The DynamicNeighborSearch class performs neighbor search on a reference set
+ * that changes over time.  It uses the logarithmic method: the points are held
+ * in a few buckets, each with its own static NeighborSearch object and tree.
+ * Inserted points form a new bucket, which is merged with and rebuilt together
+ * with the smallest buckets until the bucket before it is more than twice as
+ * large.  Each point is thus part of O(log n) rebuilds in total, and a search
+ * visits O(log n) buckets.
+ *
+ * Removed points are only marked as removed; they are skipped in the results
+ * of the search.  A bucket is rebuilt without its removed points once the
+ * fraction of its points that are removed reaches the rebuild threshold.
+ *
+ * Each inserted point gets an identifier, which is the number of points that
+ * were inserted before it; identifiers are never reused.  Searches return the
+ * identifiers of the neighbors.
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The tree type to use for each bucket.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename MetricType = mlpack::metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class DynamicNeighborSearch
+{
+ public:
+  //! The type of the search object for each bucket.
+  typedef NeighborSearch<SortPolicy, MetricType, MatType, TreeType>
+      BucketSearchType;
+
+  /**
+   * Create an empty DynamicNeighborSearch object.
+   *
+   * @param mode Neighbor search mode to use for each bucket.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param rebuildThreshold Fraction of removed points of a bucket at which
+   *     the bucket is rebuilt (in (0, 1]).
+   * @param metric An optional instance of the MetricType class.
+   */
+  DynamicNeighborSearch(const NeighborSearchMode mode = DUAL_TREE_MODE,
+                        const double epsilon = 0,
+                        const double rebuildThreshold = 0.25,
+                        const MetricType metric = MetricType());
+
+  /**
+   * Insert the given points into the reference set.  The points get the
+   * consecutive identifiers starting at the returned value.
+   *
+   * @param points Points to insert.
+   * @return Identifier of the first inserted point.
+   */
+  size_t Insert(const MatType& points);
+
+  /**
+   * Remove the points with the given identifiers from the reference set.
+   * Identifiers of points that were already removed are ignored.
+   *
+   * @param ids Identifiers of the points to remove.
+   */
+  void Remove(const std::vector<size_t>& ids);
+
+  /**
+   * For each point in the query set, compute the k best neighbors among the
+   * points of the reference set that have not been removed, and store their
+   * identifiers and distances in the given matrices.  The matrices will be set
+   * to k rows by n columns, where n is the number of query points.  If fewer
+   * than k points remain, the missing neighbors are given as SIZE_MAX with
+   * distance SortPolicy::WorstDistance().
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  //! Get the number of points in the reference set (not counting the removed
+  //! points).
+  size_t NumPoints() const;
+  //! Get the number of buckets.
+  size_t NumBuckets() const { return buckets.size(); }
+
+  //! Get the rebuild threshold.
+  double RebuildThreshold() const { return rebuildThreshold; }
+  //! Modify the rebuild threshold.
+  double& RebuildThreshold() { return rebuildThreshold; }
+
+ private:
+  //! A bucket of points with its own search object.
+  struct Bucket
+  {
+    //! The search object, built on the points of the bucket.
+    BucketSearchType search;
+    //! The identifier of each point of the search object's reference set.
+    std::vector<size_t> ids;
+    //! The number of points of the bucket that have been removed.
+    size_t numRemoved;
+  };
+
+  /**
+   * Append the points of the given bucket that have not been removed, and
+   * their identifiers, to the given matrix and vector.
+   */
+  void GetPoints(const Bucket& bucket,
+                 MatType& points,
+                 std::vector<size_t>& ids) const;
+
+  /**
+   * Build the given bucket on the given points, which have the given
+   * identifiers, and record the location of the points.
+   */
+  void BuildBucket(MatType&& points,
+                   std::vector<size_t>&& ids,
+                   const size_t index);
+
+  //! The buckets, from the largest to the smallest.
+  std::vector<Bucket> buckets;
+  //! Whether the point with each identifier has been removed.
+  std::vector<bool> removed;
+  //! The index of the bucket that holds the point with each identifier.
+  std::vector<size_t> location;
+
+  //! The search mode.
+  NeighborSearchMode searchMode;
+  //! The relative approximate error.
+  double epsilon;
+  //! The fraction of removed points at which a bucket is rebuilt.
+  double rebuildThreshold;
+  //! The instantiated metric.
+  MetricType metric;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "dynamic_neighbor_search_impl.hpp"
+
+#endif
@@ -0,0 +1,330 @@
+/**
+ * @file dynamic_neighbor_search_impl.hpp
+ *
+ * Implementation of the DynamicNeighborSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_DYNAMIC_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_DYNAMIC_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "dynamic_neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+DynamicNeighborSearch(const NeighborSearchMode mode,
+                      const double epsilon,
+                      const double rebuildThreshold,
+                      const MetricType metric) :
+    searchMode(mode),
+    epsilon(epsilon),
+    rebuildThreshold(rebuildThreshold),
+    metric(metric)
+{
+  if (epsilon < 0)
+    throw std::invalid_argument("epsilon must be non-negative");
+  if (rebuildThreshold <= 0 || rebuildThreshold > 1)
+    throw std::invalid_argument("rebuildThreshold must be in (0, 1]");
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Insert(const MatType& points)
+{
+  const size_t firstId = removed.size();
+  if (points.n_cols == 0)
+    return firstId;
+
+  if (!buckets.empty() &&
+      points.n_rows != buckets[0].search.ReferenceSet().n_rows)
+  {
+    std::stringstream ss;
+    ss << "DynamicNeighborSearch::Insert(): points have dimensionality "
+        << points.n_rows << ", but the reference set has dimensionality "
+        << buckets[0].search.ReferenceSet().n_rows;
+    throw std::invalid_argument(ss.str());
+  }
+
+  removed.resize(firstId + points.n_cols, false);
+  location.resize(firstId + points.n_cols);
+
+  MatType newPoints(points);
+  std::vector<size_t> ids(points.n_cols);
+  for (size_t i = 0; i < ids.size(); ++i)
+    ids[i] = firstId + i;
+
+  // Merge the new points with the smallest buckets until the bucket before
+  // holds more than twice as many points, so that there are O(log n) buckets.
+  while (!buckets.empty() &&
+      buckets.back().ids.size() - buckets.back().numRemoved <= 2 * ids.size())
+  {
+    GetPoints(buckets.back(), newPoints, ids);
+    buckets.pop_back();
+  }
+
+  buckets.emplace_back();
+  BuildBucket(std::move(newPoints), std::move(ids), buckets.size() - 1);
+
+  return firstId;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+Remove(const std::vector<size_t>& ids)
+{
+  for (size_t i = 0; i < ids.size(); ++i)
+  {
+    if (ids[i] >= removed.size())
+    {
+      std::stringstream ss;
+      ss << "DynamicNeighborSearch::Remove(): no point has identifier "
+          << ids[i];
+      throw std::invalid_argument(ss.str());
+    }
+
+    if (!removed[ids[i]])
+    {
+      removed[ids[i]] = true;
+      ++buckets[location[ids[i]]].numRemoved;
+    }
+  }
+
+  // Rebuild the buckets with too many removed points, and drop the empty ones.
+  size_t b = 0;
+  while (b < buckets.size())
+  {
+    Bucket& bucket = buckets[b];
+    if (bucket.numRemoved == 0 ||
+        bucket.numRemoved < rebuildThreshold * bucket.ids.size())
+    {
+      ++b;
+    }
+    else if (bucket.numRemoved == bucket.ids.size())
+    {
+      buckets.erase(buckets.begin() + b);
+      for (size_t i = b; i < buckets.size(); ++i)
+        for (size_t j = 0; j < buckets[i].ids.size(); ++j)
+          location[buckets[i].ids[j]] = i;
+    }
+    else
+    {
+      MatType points;
+      std::vector<size_t> bucketIds;
+      GetPoints(bucket, points, bucketIds);
+      BuildBucket(std::move(points), std::move(bucketIds), b);
+      ++b;
+    }
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  neighbors.set_size(k, querySet.n_cols);
+  neighbors.fill(size_t() - 1);
+  distances.set_size(k, querySet.n_cols);
+  distances.fill(SortPolicy::WorstDistance());
+
+  if (k == 0 || querySet.n_cols == 0)
+    return;
+
+  arma::Mat<size_t> bucketNeighbors(k, querySet.n_cols);
+  arma::mat bucketDistances(k, querySet.n_cols);
+  arma::Mat<size_t> foundNeighbors;
+  arma::mat foundDistances;
+  std::vector<size_t> pending, nextPending;
+  for (size_t b = 0; b < buckets.size(); ++b)
+  {
+    const Bucket& bucket = buckets[b];
+    const size_t numPoints = bucket.ids.size();
+    const size_t numLive = numPoints - bucket.numRemoved;
+
+    // Removed points may be among the neighbors that are found, so search for
+    // enough neighbors that k are left in most cases.  The query points that
+    // are left with fewer are searched again for twice as many neighbors.
+    size_t bucketK = std::min(numPoints, k + (size_t) std::ceil(
+        double(k) * bucket.numRemoved / numLive));
+    pending.resize(querySet.n_cols);
+    for (size_t q = 0; q < querySet.n_cols; ++q)
+      pending[q] = q;
+
+    while (!pending.empty())
+    {
+      if (pending.size() == querySet.n_cols)
+      {
+        buckets[b].search.Search(querySet, bucketK, foundNeighbors,
+            foundDistances);
+      }
+      else
+      {
+        const MatType subset = querySet.cols(
+            arma::conv_to<arma::uvec>::from(pending));
+        buckets[b].search.Search(subset, bucketK, foundNeighbors,
+            foundDistances);
+      }
+
+      nextPending.clear();
+      for (size_t i = 0; i < pending.size(); ++i)
+      {
+        const size_t q = pending[i];
+        size_t count = 0;
+        for (size_t j = 0; j < bucketK && count < k; ++j)
+        {
+          // Approximate searches may not find bucketK neighbors.
+          if (foundNeighbors(j, i) >= numPoints)
+            break;
+
+          const size_t id = bucket.ids[foundNeighbors(j, i)];
+          if (!removed[id])
+          {
+            bucketNeighbors(count, q) = id;
+            bucketDistances(count, q) = foundDistances(j, i);
+            ++count;
+          }
+        }
+
+        for (size_t j = count; j < k; ++j)
+        {
+          bucketNeighbors(j, q) = size_t() - 1;
+          bucketDistances(j, q) = SortPolicy::WorstDistance();
+        }
+
+        if (count < k && count < numLive && bucketK < numPoints)
+          nextPending.push_back(q);
+      }
+
+      pending.swap(nextPending);
+      bucketK = std::min(numPoints, 2 * bucketK);
+    }
+
+    ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+        MergeResults(bucketNeighbors, bucketDistances, 0, neighbors,
+        distances);
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+size_t DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+NumPoints() const
+{
+  size_t numPoints = 0;
+  for (size_t b = 0; b < buckets.size(); ++b)
+    numPoints += buckets[b].ids.size() - buckets[b].numRemoved;
+
+  return numPoints;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+GetPoints(const Bucket& bucket,
+          MatType& points,
+          std::vector<size_t>& ids) const
+{
+  std::vector<size_t> live;
+  for (size_t i = 0; i < bucket.ids.size(); ++i)
+  {
+    if (!removed[bucket.ids[i]])
+    {
+      live.push_back(i);
+      ids.push_back(bucket.ids[i]);
+    }
+  }
+
+  points = arma::join_rows(points, bucket.search.ReferenceSet().cols(
+      arma::conv_to<arma::uvec>::from(live)));
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DynamicNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+BuildBucket(MatType&& points,
+            std::vector<size_t>&& ids,
+            const size_t index)
+{
+  Bucket& bucket = buckets[index];
+  bucket.numRemoved = 0;
+
+  if (searchMode == NAIVE_MODE)
+  {
+    bucket.ids = std::move(ids);
+    bucket.search = BucketSearchType(std::move(points), searchMode, epsilon,
+        metric);
+  }
+  else
+  {
+    // The tree is built here so that the identifiers can follow the points if
+    // the tree rearranges them; the results of the search are then indices
+    // into the rearranged reference set.
+    typedef typename BucketSearchType::Tree Tree;
+    std::vector<size_t> oldFromNew;
+    Tree* tree = BuildTree<Tree>(std::move(points), oldFromNew);
+
+    if (oldFromNew.empty())
+    {
+      bucket.ids = std::move(ids);
+    }
+    else
+    {
+      bucket.ids.resize(ids.size());
+      for (size_t i = 0; i < ids.size(); ++i)
+        bucket.ids[i] = ids[oldFromNew[i]];
+    }
+
+    bucket.search = BucketSearchType(std::move(*tree), searchMode, epsilon,
+        metric);
+    delete tree;
+  }
+
+  for (size_t i = 0; i < bucket.ids.size(); ++i)
+    location[bucket.ids[i]] = index;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -21,6 +21,7 @@
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
 #include "ns_model.hpp"
+#include "ns_query_server.hpp"
 
 using namespace std;
 using namespace mlpack;
@@ -107,6 +108,20 @@ PARAM_DOUBLE_IN("percentage", "If specified, will do approximate furthest "
     "neighbors will be at least (p*100) % of the distance as the true furthest "
     "neighbor.", "p", 1);
 
+PARAM_FLAG("traversal_statistics", "If set, print the number of base cases, "
+    "and the number of nodes of the reference tree visited and pruned at each "
+    "depth, for tuning the tree type and leaf size (with --verbose).", "");
+
+// Answering queries from standard input is only possible from the command line.
+#if (BINDING_TYPE == BINDING_TYPE_CLI)
+PARAM_FLAG("serve", "If set, keep the model in memory and answer batches of "
+    "query points read from standard input until it is closed.  Each batch has "
+    "one point per line (with comma or whitespace separated coordinates) and "
+    "is ended by an empty line; for each point, a line with the indices of its "
+    "k neighbors followed by their distances is written to standard output, "
+    "and each batch of results is ended by an empty line.", "");
+#endif
+
 static void mlpackMain()
 {
   if (CLI::GetParam<int>("seed") != 0)
@@ -133,8 +148,32 @@ static void mlpackMain()
   RequireAtLeastOnePassed({ "k", "output_model" }, false,
       "no results will be saved");
 
+#if (BINDING_TYPE == BINDING_TYPE_CLI)
+  const bool serve = CLI::HasParam("serve");
+#else
+  const bool serve = false;
+#endif
+
+  // When serving, the queries and results go through standard input and
+  // output.
+  if (serve)
+  {
+    if (!CLI::HasParam("k"))
+    {
+      Log::Fatal << PRINT_PARAM_STRING("serve") << " requires "
+          << PRINT_PARAM_STRING("k") << " to be specified." << endl;
+    }
+
+    const string reason = "queries are read from standard input";
+    ReportIgnoredParam("query", reason);
+    ReportIgnoredParam("neighbors", reason);
+    ReportIgnoredParam("distances", reason);
+    ReportIgnoredParam("true_neighbors", reason);
+    ReportIgnoredParam("true_distances", reason);
+  }
+
   // If the user specifies k but no output files, they should be warned.
-  if (CLI::HasParam("k"))
+  if (CLI::HasParam("k") && !serve)
   {
     RequireAtLeastOnePassed({ "neighbors", "distances" }, false,
         "furthest neighbor search results will not be saved");
@@ -259,8 +298,28 @@ static void mlpackMain()
         << " dataset)." << endl;
   }
 
+  // Answer queries from standard input, if desired.
+  if (serve)
+  {
+    const size_t k = (size_t) CLI::GetParam<int>("k");
+    if (k > kfn->Dataset().n_cols)
+    {
+      Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
+          << "than or equal to the number of reference points ("
+          << kfn->Dataset().n_cols << ")." << endl;
+    }
+
+    // Informational output would be mixed with the results on stdout.
+    Log::Info << "Serving queries from standard input." << endl;
+    const bool ignoreInfo = Log::Info.ignoreInput;
+    Log::Info.ignoreInput = true;
+    const size_t batches = ServeQueries(*kfn, k, std::cin, std::cout);
+    Log::Info.ignoreInput = ignoreInfo;
+    Log::Info << "Answered " << batches << " batches of queries." << endl;
+  }
+
   // Perform search, if desired.
-  if (CLI::HasParam("k"))
+  if (CLI::HasParam("k") && !serve)
   {
     const size_t k = (size_t) CLI::GetParam<int>("k");
 
@@ -296,11 +355,14 @@ static void mlpackMain()
     arma::Mat<size_t> neighbors;
     arma::mat distances;
 
+    kfn->CollectStatistics() = CLI::HasParam("traversal_statistics");
     if (CLI::HasParam("query"))
       kfn->Search(std::move(queryData), k, neighbors, distances);
     else
       kfn->Search(k, neighbors, distances);
     Log::Info << "Search complete." << endl;
+    if (CLI::HasParam("traversal_statistics"))
+      kfn->Statistics().Print(Log::Info);
 
     // Save output.
     CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
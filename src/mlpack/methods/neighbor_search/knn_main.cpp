@@ -23,6 +23,7 @@
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
 #include "ns_model.hpp"
+#include "ns_query_server.hpp"
 
 using namespace std;
 using namespace mlpack;
@@ -110,9 +111,27 @@ PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
 PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
-    "'dual_tree', 'greedy'.", "a", "dual_tree");
+    "'dual_tree', 'greedy', 'best_first'.", "a", "dual_tree");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
+PARAM_INT_IN("max_leaves", "Maximum number of leaves visited for each query "
+    "point by best-first search (0 means no limit).", "", 0);
+PARAM_INT_IN("max_base_cases", "Maximum number of distance computations for "
+    "each query point in best-first search (0 means no limit).", "", 0);
+
+PARAM_FLAG("traversal_statistics", "If set, print the number of base cases, "
+    "and the number of nodes of the reference tree visited and pruned at each "
+    "depth, for tuning the tree type and leaf size (with --verbose).", "");
+
+// Answering queries from standard input is only possible from the command line.
+#if (BINDING_TYPE == BINDING_TYPE_CLI)
+PARAM_FLAG("serve", "If set, keep the model in memory and answer batches of "
+    "query points read from standard input until it is closed.  Each batch has "
+    "one point per line (with comma or whitespace separated coordinates) and "
+    "is ended by an empty line; for each point, a line with the indices of its "
+    "k neighbors followed by their distances is written to standard output, "
+    "and each batch of results is ended by an empty line.", "");
+#endif
 
 static void mlpackMain()
 {
@@ -139,8 +158,32 @@ static void mlpackMain()
   RequireAtLeastOnePassed({ "k", "output_model" }, false,
       "no results will be saved");
 
+#if (BINDING_TYPE == BINDING_TYPE_CLI)
+  const bool serve = CLI::HasParam("serve");
+#else
+  const bool serve = false;
+#endif
+
+  // When serving, the queries and results go through standard input and
+  // output.
+  if (serve)
+  {
+    if (!CLI::HasParam("k"))
+    {
+      Log::Fatal << PRINT_PARAM_STRING("serve") << " requires "
+          << PRINT_PARAM_STRING("k") << " to be specified." << endl;
+    }
+
+    const string reason = "queries are read from standard input";
+    ReportIgnoredParam("query", reason);
+    ReportIgnoredParam("neighbors", reason);
+    ReportIgnoredParam("distances", reason);
+    ReportIgnoredParam("true_neighbors", reason);
+    ReportIgnoredParam("true_distances", reason);
+  }
+
   // If the user specifies k but no output files, they should be warned.
-  if (CLI::HasParam("k"))
+  if (CLI::HasParam("k") && !serve)
   {
     RequireAtLeastOnePassed({ "neighbors", "distances" }, false,
         "nearest neighbor search results will not be saved");
@@ -185,7 +228,7 @@ static void mlpackMain()
 
   const string algorithm = CLI::GetParam<string>("algorithm");
   RequireParamInSet<string>("algorithm", { "naive", "single_tree", "dual_tree",
-      "greedy" }, true, "unknown neighbor search algorithm");
+      "greedy", "best_first" }, true, "unknown neighbor search algorithm");
   NeighborSearchMode searchMode = DUAL_TREE_MODE;
 
   if (algorithm == "naive")
@@ -196,6 +239,22 @@ static void mlpackMain()
     searchMode = DUAL_TREE_MODE;
   else if (algorithm == "greedy")
     searchMode = GREEDY_SINGLE_TREE_MODE;
+  else if (algorithm == "best_first")
+    searchMode = BEST_FIRST_SINGLE_TREE_MODE;
+
+  // Sanity checks on the budget of best-first search.
+  RequireParamValue<int>("max_leaves", [](int x) { return x >= 0; }, true,
+      "maximum number of leaves must be non-negative");
+  RequireParamValue<int>("max_base_cases", [](int x) { return x >= 0; }, true,
+      "maximum number of base cases must be non-negative");
+  if (searchMode != BEST_FIRST_SINGLE_TREE_MODE)
+  {
+    ReportIgnoredParam("max_leaves", "best-first search is not being used");
+    ReportIgnoredParam("max_base_cases", "best-first search is not being used");
+  }
+  const bool budgeted = (searchMode == BEST_FIRST_SINGLE_TREE_MODE) &&
+      (CLI::GetParam<int>("max_leaves") > 0 ||
+       CLI::GetParam<int>("max_base_cases") > 0);
 
   if (CLI::HasParam("reference"))
   {
@@ -277,8 +336,31 @@ static void mlpackMain()
         << " dataset)." << endl;
   }
 
+  knn->MaxLeaves() = (size_t) CLI::GetParam<int>("max_leaves");
+  knn->MaxBaseCases() = (size_t) CLI::GetParam<int>("max_base_cases");
+
+  // Answer queries from standard input, if desired.
+  if (serve)
+  {
+    const size_t k = (size_t) CLI::GetParam<int>("k");
+    if (k > knn->Dataset().n_cols)
+    {
+      Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
+          << "than or equal to the number of reference points ("
+          << knn->Dataset().n_cols << ")." << endl;
+    }
+
+    // Informational output would be mixed with the results on stdout.
+    Log::Info << "Serving queries from standard input." << endl;
+    const bool ignoreInfo = Log::Info.ignoreInput;
+    Log::Info.ignoreInput = true;
+    const size_t batches = ServeQueries(*knn, k, std::cin, std::cout);
+    Log::Info.ignoreInput = ignoreInfo;
+    Log::Info << "Answered " << batches << " batches of queries." << endl;
+  }
+
   // Perform search, if desired.
-  if (CLI::HasParam("k"))
+  if (CLI::HasParam("k") && !serve)
   {
     const size_t k = (size_t) CLI::GetParam<int>("k");
 
@@ -314,11 +396,14 @@ static void mlpackMain()
     arma::Mat<size_t> neighbors;
     arma::mat distances;
 
+    knn->CollectStatistics() = CLI::HasParam("traversal_statistics");
     if (CLI::HasParam("query"))
       knn->Search(std::move(queryData), k, neighbors, distances);
     else
       knn->Search(k, neighbors, distances);
     Log::Info << "Search complete." << endl;
+    if (CLI::HasParam("traversal_statistics"))
+      knn->Statistics().Print(Log::Info);
 
     // Save output.
     CLI::GetParam<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
@@ -327,7 +412,8 @@ static void mlpackMain()
     // Calculate the effective error, if desired.
     if (CLI::HasParam("true_distances"))
     {
-      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0)
+      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0 &&
+          !budgeted)
         Log::Warn << PRINT_PARAM_STRING("true_distances") << "specified, but "
             << "the search is exact, so there is no need to calculate the "
             << "error!" << endl;
@@ -347,7 +433,8 @@ static void mlpackMain()
     // Calculate the recall, if desired.
     if (CLI::HasParam("true_neighbors"))
     {
-      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0)
+      if (knn->TreeType() != KNNModel::SPILL_TREE && knn->Epsilon() == 0 &&
+          !budgeted)
         Log::Warn << PRINT_PARAM_STRING("true_neighbors") << " specified, but "
             << " the search is exact, so there is no need to calculate the "
             << "recall!" << endl;
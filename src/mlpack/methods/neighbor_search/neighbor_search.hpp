@@ -16,10 +16,12 @@
 #include <mlpack/prereqs.hpp>
 #include <vector>
 #include <string>
+#include <functional>
 
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/binary_space_tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/instrumented_rules.hpp>
 
 #include "neighbor_search_stat.hpp"
 #include "sort_policies/nearest_neighbor_sort.hpp"
@@ -40,7 +42,8 @@ enum NeighborSearchMode
   NAIVE_MODE,
   SINGLE_TREE_MODE,
   DUAL_TREE_MODE,
-  GREEDY_SINGLE_TREE_MODE
+  GREEDY_SINGLE_TREE_MODE,
+  BEST_FIRST_SINGLE_TREE_MODE
 };
 
 /**
@@ -273,6 +276,28 @@ class NeighborSearch
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Search for the nearest neighbors of a stream of query points, which may be
+   * too large to hold in memory at once.  Chunks of query points are obtained
+   * by calling nextQueryChunk() until it returns false.  Each chunk is searched
+   * just like with Search(querySet, k, neighbors, distances) (so, in dual-tree
+   * mode, a query tree is built on each chunk), and the results are passed to
+   * handleResults() together with the index of the first point of the chunk in
+   * the stream.  Only one chunk and its results are held at any time, so the
+   * memory used does not depend on the total number of query points.
+   *
+   * @param nextQueryChunk Function that fills the given matrix with the next
+   *     chunk of query points, and returns false when there are no more.
+   * @param k Number of neighbors to search for.
+   * @param handleResults Function called with the index of the first query
+   *     point of a chunk, and the neighbors and distances for that chunk.
+   */
+  void Search(const std::function<bool(MatType&)>& nextQueryChunk,
+              const size_t k,
+              const std::function<void(const size_t,
+                                       const arma::Mat<size_t>&,
+                                       const arma::mat&)>& handleResults);
+
   /**
    * Calculate the average relative error (effective error) between the
    * distances calculated and the true distances provided.  The input matrices
@@ -312,6 +337,15 @@ class NeighborSearch
   //! Return the number of node combination scores during the last search.
   size_t Scores() const { return scores; }
 
+  //! Get whether traversal statistics are collected during searches.
+  bool CollectStatistics() const { return collectStatistics; }
+  //! Modify whether traversal statistics are collected during searches.
+  bool& CollectStatistics() { return collectStatistics; }
+
+  //! Get the traversal statistics of the last search.  These are only
+  //! collected by tree searches when CollectStatistics() is set.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
   //! Access the search mode.
   NeighborSearchMode SearchMode() const { return searchMode; }
   //! Modify the search mode.
@@ -322,6 +356,29 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
+  //! Get the maximum number of leaves visited for each query point by
+  //! best-first search (0 means no limit).
+  size_t MaxLeaves() const { return maxLeaves; }
+  //! Modify the maximum number of leaves visited for each query point by
+  //! best-first search (0 means no limit).
+  size_t& MaxLeaves() { return maxLeaves; }
+
+  //! Get the maximum number of base cases for each query point in best-first
+  //! search (0 means no limit).
+  size_t MaxBaseCases() const { return maxBaseCases; }
+  //! Modify the maximum number of base cases for each query point in
+  //! best-first search (0 means no limit).
+  size_t& MaxBaseCases() { return maxBaseCases; }
+
+  //! Get the number of query points that traverse the reference tree together
+  //! in single-tree search (0 or 1 means one at a time).
+  size_t QueryBlockSize() const { return queryBlockSize; }
+  //! Modify the number of query points that traverse the reference tree
+  //! together in single-tree search (0 or 1 means one at a time).  Blocks are
+  //! only used with binary space trees and their default single-tree
+  //! traverser; see tree::BlockSingleTreeTraversal().
+  size_t& QueryBlockSize() { return queryBlockSize; }
+
   //! Access the reference dataset.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
@@ -354,11 +411,113 @@ class NeighborSearch
   size_t baseCases;
   //! The total number of scores (applicable for non-naive search).
   size_t scores;
+  //! If true, traversal statistics are collected during searches.
+  bool collectStatistics;
+  //! The traversal statistics of the last search.
+  tree::TraversalStatistics statistics;
+  //! The maximum number of leaves visited for each query point by best-first
+  //! search.
+  size_t maxLeaves;
+  //! The maximum number of base cases for each query point in best-first
+  //! search.
+  size_t maxBaseCases;
+  //! The number of query points that traverse the reference tree together in
+  //! single-tree search.
+  size_t queryBlockSize;
 
   //! If this is true, the reference tree bounds need to be reset on a call to
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  /**
+   * Perform a dual-tree traversal of the given query tree against the
+   * reference tree, and store the results in the given matrices, which must
+   * already have the right size.  If OpenMP is available and the tree type
+   * holds contiguous ranges of points in each node, disjoint query subtrees
+   * are traversed in parallel.
+   *
+   * @param queryTree Tree built on query points.
+   * @param k Number of neighbors to search for.
+   * @param sameSet Denotes whether or not the reference and query sets are the
+   *      same.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *      point.
+   */
+  void DualTreeSearch(Tree& queryTree,
+                      const size_t k,
+                      const bool sameSet,
+                      arma::Mat<size_t>& neighbors,
+                      arma::mat& distances);
+
+  /**
+   * Perform a dual-tree search of the given query points with spill trees, and
+   * store the results in the given matrices, which must already have the right
+   * size.  Spill trees hold lists of point indexes instead of ranges of points,
+   * so a query tree can't be split into subtrees that each have their own
+   * rules; instead, the query points are split into contiguous ranges, and a
+   * (non-overlapping) query tree is built on each range and traversed against
+   * the reference tree.  If OpenMP is available, the ranges are searched in
+   * parallel; otherwise there is one range, holding all the query points.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param sameSet Denotes whether or not the reference and query sets are the
+   *      same.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *      point.
+   */
+  void SpillDualTreeSearch(const MatType& querySet,
+                           const size_t k,
+                           const bool sameSet,
+                           arma::Mat<size_t>& neighbors,
+                           arma::mat& distances);
+
+  /**
+   * Perform a single-tree search of the reference tree with the given query
+   * points, and store the results in the given matrices, which must already
+   * have the right size.  If OpenMP is available, contiguous ranges of query
+   * points are searched in parallel, each with its own rules.  Trees whose
+   * first point is the centroid are searched on one thread, because their
+   * scores cache distances in the statistics of the reference nodes.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param sameSet Denotes whether or not the reference and query sets are the
+   *      same.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *      point.
+   */
+  void SingleTreeSearch(const MatType& querySet,
+                        const size_t k,
+                        const bool sameSet,
+                        arma::Mat<size_t>& neighbors,
+                        arma::mat& distances);
+
+  /**
+   * Perform best-first single-tree search with the given rules for the first
+   * numQueries query points, within the budget given by MaxLeaves() and
+   * MaxBaseCases().
+   *
+   * @param rules Rules of the search.
+   * @param numQueries Number of query points.
+   * @param minBaseCases Number of base cases computed before the budget
+   *     applies.
+   */
+  template<typename RuleType>
+  void BestFirstSearch(RuleType& rules,
+                       const size_t numQueries,
+                       const size_t minBaseCases);
+
+  //! Traverse the reference tree best-first with the given rules for the
+  //! first numQueries query points; this is used by BestFirstSearch().
+  template<typename RuleType>
+  void BestFirstTraversal(RuleType& rules,
+                          const size_t numQueries,
+                          const size_t minBaseCases);
+
   //! The NSModel class should have access to internal members.
   template<typename SortPol>
   friend class TrainVisitor;
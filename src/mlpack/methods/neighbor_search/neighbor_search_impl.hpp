@@ -15,6 +15,10 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
+#include <mlpack/core/tree/best_first_single_tree_traverser.hpp>
+#include <mlpack/core/tree/block_single_tree_traversal.hpp>
+#include <mlpack/core/tree/query_subtrees.hpp>
+#include <mlpack/core/tree/tree_cache.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
 
@@ -30,7 +34,8 @@ TreeType* BuildTree(
         tree::TreeTraits<TreeType>::RearrangesDataset, TreeType
     >* = 0)
 {
-  return new TreeType(std::forward<MatType>(dataset), oldFromNew);
+  return tree::TreeCache::BuildTree<TreeType>(std::forward<MatType>(dataset),
+      oldFromNew);
 }
 
 //! Call the tree constructor that does not do mapping.
@@ -45,6 +50,31 @@ TreeType* BuildTree(
   return new TreeType(std::forward<MatType>(dataset));
 }
 
+//! Build a spill tree on the given points of the dataset.
+template<typename TreeType, typename MatType>
+TreeType* BuildTree(
+    const MatType& dataset,
+    const arma::Col<size_t>& points,
+    typename std::enable_if_t<
+        tree::IsSpillTree<TreeType>::value, TreeType
+    >* = 0)
+{
+  return new TreeType(dataset, points);
+}
+
+//! Only spill trees are built on some of the points of a dataset (see
+//! SpillDualTreeSearch()); this is never called for the other trees.
+template<typename TreeType, typename MatType>
+TreeType* BuildTree(
+    const MatType& /* dataset */,
+    const arma::Col<size_t>& /* points */,
+    const typename std::enable_if_t<
+        !tree::IsSpillTree<TreeType>::value, TreeType
+    >* = 0)
+{
+  return NULL;
+}
+
 // Construct the object.
 template<typename SortPolicy,
          typename MetricType,
@@ -68,6 +98,10 @@ SingleTreeTraversalType>::NeighborSearch(MatType referenceSetIn,
     metric(metric),
     baseCases(0),
     scores(0),
+    collectStatistics(false),
+    maxLeaves(0),
+    maxBaseCases(0),
+    queryBlockSize(0),
     treeNeedsReset(false)
 {
   if (epsilon < 0)
@@ -95,6 +129,10 @@ SingleTreeTraversalType>::NeighborSearch(Tree referenceTree,
     metric(metric),
     baseCases(0),
     scores(0),
+    collectStatistics(false),
+    maxLeaves(0),
+    maxBaseCases(0),
+    queryBlockSize(0),
     treeNeedsReset(false)
 {
   if (epsilon < 0)
@@ -121,6 +159,10 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearchMode mode,
     metric(metric),
     baseCases(0),
     scores(0),
+    collectStatistics(false),
+    maxLeaves(0),
+    maxBaseCases(0),
+    queryBlockSize(0),
     treeNeedsReset(false)
 {
   if (epsilon < 0)
@@ -154,6 +196,11 @@ SingleTreeTraversalType>::NeighborSearch(const NeighborSearch& other) :
     metric(other.metric),
     baseCases(other.baseCases),
     scores(other.scores),
+    collectStatistics(other.collectStatistics),
+    statistics(other.statistics),
+    maxLeaves(other.maxLeaves),
+    maxBaseCases(other.maxBaseCases),
+    queryBlockSize(other.queryBlockSize),
     treeNeedsReset(false)
 {
   // Nothing else to do.
@@ -178,6 +225,11 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
     scores(other.scores),
+    collectStatistics(other.collectStatistics),
+    statistics(other.statistics),
+    maxLeaves(other.maxLeaves),
+    maxBaseCases(other.maxBaseCases),
+    queryBlockSize(other.queryBlockSize),
     treeNeedsReset(other.treeNeedsReset)
 {
   // Clear the other model.
@@ -189,6 +241,7 @@ SingleTreeTraversalType>::NeighborSearch(NeighborSearch&& other) :
   other.epsilon = 0.0;
   other.baseCases = 0;
   other.scores = 0;
+  other.statistics.Reset();
   other.treeNeedsReset = false;
 }
 
@@ -232,6 +285,11 @@ NeighborSearch<SortPolicy,
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
+  collectStatistics = other.collectStatistics;
+  statistics = other.statistics;
+  maxLeaves = other.maxLeaves;
+  maxBaseCases = other.maxBaseCases;
+  queryBlockSize = other.queryBlockSize;
   treeNeedsReset = false;
 }
 
@@ -274,6 +332,11 @@ NeighborSearch<SortPolicy,
   metric = other.metric;
   baseCases = other.baseCases;
   scores = other.scores;
+  collectStatistics = other.collectStatistics;
+  statistics = other.statistics;
+  maxLeaves = other.maxLeaves;
+  maxBaseCases = other.maxBaseCases;
+  queryBlockSize = other.queryBlockSize;
   treeNeedsReset = other.treeNeedsReset;
 
   // Reset the other object.
@@ -284,6 +347,7 @@ NeighborSearch<SortPolicy,
   other.epsilon = 0.0;
   other.baseCases = 0;
   other.scores = 0;
+  other.statistics.Reset();
   other.treeNeedsReset = false;
 }
 
@@ -401,6 +465,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   baseCases = 0;
   scores = 0;
+  statistics.Reset();
 
   // This will hold mappings for query points, if necessary.
   std::vector<size_t> oldFromNewQueries;
@@ -449,29 +514,18 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     }
     case SINGLE_TREE_MODE:
     {
-      // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, querySet, k, metric, epsilon);
-
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
-      rules.GetResults(*neighborPtr, *distancePtr);
+      SingleTreeSearch(querySet, k, false, *neighborPtr, *distancePtr);
       break;
     }
     case DUAL_TREE_MODE:
     {
+      if (tree::IsSpillTree<Tree>::value)
+      {
+        // The query trees are built on ranges of the query points.
+        SpillDualTreeSearch(querySet, k, false, *neighborPtr, *distancePtr);
+        break;
+      }
+
       // Build the query tree.
       Timer::Stop("computing_neighbors");
       Timer::Start("tree_building");
@@ -479,13 +533,25 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       Timer::Stop("tree_building");
       Timer::Start("computing_neighbors");
 
+      DualTreeSearch(*queryTree, k, false, *neighborPtr, *distancePtr);
+
+      delete queryTree;
+      break;
+    }
+    case GREEDY_SINGLE_TREE_MODE:
+    {
       // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, queryTree->Dataset(), k, metric, epsilon);
+      RuleType rules(*referenceSet, querySet, k, metric);
 
       // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
+      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
+
+      // Set the value of minBaseCases.
+      traverser.MinBaseCases() = k;
 
-      traverser.Traverse(*queryTree, *referenceTree);
+      // Now have it traverse for each point.
+      for (size_t i = 0; i < querySet.n_cols; ++i)
+        traverser.Traverse(i, *referenceTree);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -496,24 +562,14 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
 
       rules.GetResults(*neighborPtr, *distancePtr);
-
-      delete queryTree;
       break;
     }
-    case GREEDY_SINGLE_TREE_MODE:
+    case BEST_FIRST_SINGLE_TREE_MODE:
     {
       // Create the helper object for the tree traversal.
-      RuleType rules(*referenceSet, querySet, k, metric);
-
-      // Create the traverser.
-      tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
-
-      // Set the value of minBaseCases.
-      traverser.MinBaseCases() = k;
+      RuleType rules(*referenceSet, querySet, k, metric, epsilon);
 
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      BestFirstSearch(rules, querySet.n_cols, k);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -623,6 +679,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   baseCases = 0;
   scores = 0;
+  statistics.Reset();
 
   // Get a reference to the query set.
   const MatType& querySet = queryTree.Dataset();
@@ -637,24 +694,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   neighborPtr->set_size(k, querySet.n_cols);
   distances.set_size(k, querySet.n_cols);
 
-  // Create the helper object for the traversal.
-  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, querySet, k, metric, epsilon, sameSet);
-
-  // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(queryTree, *referenceTree);
-
-  scores += rules.Scores();
-  baseCases += rules.BaseCases();
-
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
-
-  rules.GetResults(*neighborPtr, distances);
-
-  Log::Info << rules.Scores() << " node combinations were scored.\n";
-  Log::Info << rules.BaseCases() << " base cases were calculated.\n";
+  DualTreeSearch(queryTree, k, sameSet, *neighborPtr, distances);
 
   Timer::Stop("computing_neighbors");
 
@@ -675,6 +715,39 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Search(
+    const std::function<bool(MatType&)>& nextQueryChunk,
+    const size_t k,
+    const std::function<void(const size_t,
+                             const arma::Mat<size_t>&,
+                             const arma::mat&)>& handleResults)
+{
+  MatType queryChunk;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  size_t firstQuery = 0;
+
+  while (nextQueryChunk(queryChunk))
+  {
+    // An empty chunk has no results, but the stream may not be finished.
+    if (queryChunk.n_cols == 0)
+      continue;
+
+    Search(queryChunk, k, neighbors, distances);
+    handleResults(firstQuery, neighbors, distances);
+    firstQuery += queryChunk.n_cols;
+  }
+}
+
 template<typename SortPolicy,
          typename MetricType,
          typename MatType,
@@ -709,6 +782,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
   baseCases = 0;
   scores = 0;
+  statistics.Reset();
 
   arma::Mat<size_t>* neighborPtr = &neighbors;
   arma::mat* distancePtr = &distances;
@@ -725,39 +799,30 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   neighborPtr->set_size(k, referenceSet->n_cols);
   distancePtr->set_size(k, referenceSet->n_cols);
 
-  // Create the helper object for the traversal.
   typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
-      true /* don't return the same point as nearest neighbor */);
 
   switch (searchMode)
   {
     case NAIVE_MODE:
     {
+      // Create the helper object for the traversal.
+      RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+
       // The naive brute-force solution.
       for (size_t i = 0; i < referenceSet->n_cols; ++i)
         for (size_t j = 0; j < referenceSet->n_cols; ++j)
           rules.BaseCase(i, j);
 
       baseCases += referenceSet->n_cols * referenceSet->n_cols;
+
+      rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
     case SINGLE_TREE_MODE:
     {
-      // Create the traverser.
-      SingleTreeTraversalType<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < referenceSet->n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
-
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
+      // Don't return the same point as nearest neighbor.
+      SingleTreeSearch(*referenceSet, k, true, *neighborPtr, *distancePtr);
       break;
     }
     case DUAL_TREE_MODE:
@@ -782,37 +847,28 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         }
       }
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
       if (tree::IsSpillTree<Tree>::value)
       {
-        // For Dual Tree Search on SpillTree, the queryTree must be built with
-        // non overlapping (tau = 0).
-        Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        // For Dual Tree Search on SpillTree, the query trees must be built
+        // with non overlapping (tau = 0).
+        SpillDualTreeSearch(*referenceSet, k, true, *neighborPtr,
+            *distancePtr);
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
-        // Next time we perform this search, we'll need to reset the tree.
-        treeNeedsReset = true;
+        DualTreeSearch(*referenceTree, k, true, *neighborPtr, *distancePtr);
       }
 
-      scores += rules.Scores();
-      baseCases += rules.BaseCases();
-
-      Log::Info << rules.Scores() << " node combinations were scored."
-          << std::endl;
-      Log::Info << rules.BaseCases() << " base cases were calculated."
-          << std::endl;
-
       // Next time we perform this search, we'll need to reset the tree.
       treeNeedsReset = true;
       break;
     }
     case GREEDY_SINGLE_TREE_MODE:
     {
+      // Create the helper object for the traversal.
+      RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+
       // Create the traverser.
       tree::GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
 
@@ -830,11 +886,31 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
           << std::endl;
       Log::Info << rules.BaseCases() << " base cases were calculated."
           << std::endl;
+
+      rules.GetResults(*neighborPtr, *distancePtr);
       break;
     }
-  }
+    case BEST_FIRST_SINGLE_TREE_MODE:
+    {
+      // Create the helper object for the traversal.
+      RuleType rules(*referenceSet, *referenceSet, k, metric, epsilon,
+          true /* don't return the same point as nearest neighbor */);
+
+      // The base case of each point with itself doesn't give a neighbor.
+      BestFirstSearch(rules, referenceSet->n_cols, k + 1);
+
+      scores += rules.Scores();
+      baseCases += rules.BaseCases();
 
-  rules.GetResults(*neighborPtr, *distancePtr);
+      Log::Info << rules.Scores() << " node combinations were scored."
+          << std::endl;
+      Log::Info << rules.BaseCases() << " base cases were calculated."
+          << std::endl;
+
+      rules.GetResults(*neighborPtr, *distancePtr);
+      break;
+    }
+  }
 
   Timer::Stop("computing_neighbors");
 
@@ -862,6 +938,281 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DualTreeSearch(
+    Tree& queryTree,
+    const size_t k,
+    const bool sameSet,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+  const MatType& querySet = queryTree.Dataset();
+
+  // When multiple threads are available, split the query tree into disjoint
+  // subtrees.  Each subtree is traversed against the reference tree with its
+  // own rules (so the traversal info, base case cache and candidate lists are
+  // thread-local), and the bounds cached in the statistics of each query
+  // subtree are only touched by one thread.  The results are exact, because
+  // traversing a query subtree on its own only loosens the bounds inherited
+  // from its (untouched) ancestors.
+  const size_t numThreads = NumThreads();
+
+  std::vector<Tree*> subtrees;
+  std::vector<std::pair<size_t, size_t>> ranges;
+  tree::GetQuerySubtrees(queryTree, (numThreads > 1) ? 4 * numThreads : 1,
+      subtrees, ranges);
+
+  size_t totalScores = 0;
+  size_t totalBaseCases = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:totalScores, totalBaseCases)
+  for (omp_size_t i = 0; i < (omp_size_t) subtrees.size(); ++i)
+  {
+    RuleType rules(*referenceSet, querySet, ranges[i].first, ranges[i].second,
+        k, metric, epsilon, sameSet);
+
+    if (collectStatistics)
+    {
+      tree::TraversalStatistics subtreeStatistics;
+      tree::DualTreeTraversal<DualTreeTraversalType>(rules, *subtrees[i],
+          *referenceTree, &subtreeStatistics);
+
+      #pragma omp critical
+      statistics.Merge(subtreeStatistics);
+    }
+    else
+    {
+      tree::DualTreeTraversal<DualTreeTraversalType>(rules, *subtrees[i],
+          *referenceTree);
+    }
+
+    totalScores += rules.Scores();
+    totalBaseCases += rules.BaseCases();
+
+    // Each set of rules only fills the columns of its own query points.
+    rules.GetResults(neighbors, distances);
+  }
+
+  scores += totalScores;
+  baseCases += totalBaseCases;
+
+  Log::Info << totalScores << " node combinations were scored." << std::endl;
+  Log::Info << totalBaseCases << " base cases were calculated." << std::endl;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SpillDualTreeSearch(
+    const MatType& querySet,
+    const size_t k,
+    const bool sameSet,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  // Each range of query points gets its own query tree and its own rules, so
+  // the threads share nothing but the reference tree, whose statistics aren't
+  // touched when the query tree is a different tree.  With one thread, the
+  // only query tree is the same as one built on the whole query set.
+  const size_t numThreads = NumThreads();
+  const size_t numRanges = std::max((size_t) 1, std::min(
+      (size_t) querySet.n_cols, (numThreads > 1) ? 4 * numThreads : 1));
+
+  size_t totalScores = 0;
+  size_t totalBaseCases = 0;
+
+  #pragma omp parallel for schedule(dynamic) \
+      reduction(+:totalScores, totalBaseCases)
+  for (omp_size_t i = 0; i < (omp_size_t) numRanges; ++i)
+  {
+    const size_t begin = i * querySet.n_cols / numRanges;
+    const size_t end = (i + 1) * querySet.n_cols / numRanges;
+
+    arma::Col<size_t> points(end - begin);
+    for (size_t j = 0; j < points.n_elem; ++j)
+      points[j] = begin + j;
+
+    Tree* queryTree = BuildTree<Tree>(querySet, points);
+    RuleType rules(*referenceSet, querySet, begin, end - begin, k, metric,
+        epsilon, sameSet);
+
+    if (collectStatistics)
+    {
+      tree::TraversalStatistics rangeStatistics;
+      tree::DualTreeTraversal<DualTreeTraversalType>(rules, *queryTree,
+          *referenceTree, &rangeStatistics);
+
+      #pragma omp critical
+      statistics.Merge(rangeStatistics);
+    }
+    else
+    {
+      tree::DualTreeTraversal<DualTreeTraversalType>(rules, *queryTree,
+          *referenceTree);
+    }
+
+    totalScores += rules.Scores();
+    totalBaseCases += rules.BaseCases();
+
+    // Each set of rules only fills the columns of its own query points.
+    rules.GetResults(neighbors, distances);
+    delete queryTree;
+  }
+
+  scores += totalScores;
+  baseCases += totalBaseCases;
+
+  Log::Info << totalScores << " node combinations were scored." << std::endl;
+  Log::Info << totalBaseCases << " base cases were calculated." << std::endl;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SingleTreeSearch(
+    const MatType& querySet,
+    const size_t k,
+    const bool sameSet,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  typedef NeighborSearchRules<SortPolicy, MetricType, Tree> RuleType;
+
+  // Each range of query points is traversed with its own rules (so the base
+  // case cache and candidate lists are thread-local).  The traversals only
+  // read the reference tree, except when the first point of each node is the
+  // centroid: then scores save the last base case in the reference nodes.
+  const size_t numThreads = tree::TreeTraits<Tree>::FirstPointIsCentroid ? 1 :
+      NumThreads();
+  const size_t numRanges = std::max((size_t) 1, std::min(
+      (size_t) querySet.n_cols, (numThreads > 1) ? 4 * numThreads : 1));
+
+  size_t totalScores = 0;
+  size_t totalBaseCases = 0;
+
+  #pragma omp parallel for schedule(dynamic) if (numRanges > 1) \
+      reduction(+:totalScores, totalBaseCases)
+  for (omp_size_t i = 0; i < (omp_size_t) numRanges; ++i)
+  {
+    const size_t begin = i * querySet.n_cols / numRanges;
+    const size_t end = (i + 1) * querySet.n_cols / numRanges;
+
+    RuleType rules(*referenceSet, querySet, begin, end - begin, k, metric,
+        epsilon, sameSet);
+
+    // The blocks of query points are taken within the range, since the rules
+    // only hold the candidates of the query points of the range.
+    if (collectStatistics)
+    {
+      tree::TraversalStatistics rangeStatistics;
+      tree::BlockSingleTreeTraversal<SingleTreeTraversalType>(rules, querySet,
+          begin, end - begin, *referenceTree, queryBlockSize,
+          &rangeStatistics);
+
+      #pragma omp critical
+      statistics.Merge(rangeStatistics);
+    }
+    else
+    {
+      tree::BlockSingleTreeTraversal<SingleTreeTraversalType>(rules, querySet,
+          begin, end - begin, *referenceTree, queryBlockSize);
+    }
+
+    totalScores += rules.Scores();
+    totalBaseCases += rules.BaseCases();
+
+    // Each set of rules only fills the columns of its own query points.
+    rules.GetResults(neighbors, distances);
+  }
+
+  scores += totalScores;
+  baseCases += totalBaseCases;
+
+  Log::Info << totalScores << " node combinations were scored." << std::endl;
+  Log::Info << totalBaseCases << " base cases were calculated." << std::endl;
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::BestFirstSearch(
+    RuleType& rules,
+    const size_t numQueries,
+    const size_t minBaseCases)
+{
+  if (collectStatistics)
+  {
+    tree::InstrumentedRules<RuleType> instrumentedRules(rules);
+    BestFirstTraversal(instrumentedRules, numQueries, minBaseCases);
+    statistics.Merge(instrumentedRules.Statistics());
+  }
+  else
+  {
+    BestFirstTraversal(rules, numQueries, minBaseCases);
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, MetricType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::BestFirstTraversal(
+    RuleType& rules,
+    const size_t numQueries,
+    const size_t minBaseCases)
+{
+  tree::BestFirstSingleTreeTraverser<Tree, RuleType> traverser(rules);
+  traverser.MaxLeaves() = maxLeaves;
+  traverser.MaxBaseCases() = maxBaseCases;
+  traverser.MinBaseCases() = minBaseCases;
+
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Traverse(i, *referenceTree);
+
+  if (maxLeaves > 0 || maxBaseCases > 0)
+  {
+    Log::Info << traverser.NumStopped() << " of " << numQueries << " queries "
+        << "stopped at the search budget." << std::endl;
+  }
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename MetricType,
@@ -998,6 +1349,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
   {
     baseCases = 0;
     scores = 0;
+    statistics.Reset();
   }
 }
 
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/batch_base_cases.hpp>
 
 #include <queue>
 
@@ -54,8 +55,36 @@ class NeighborSearchRules
                       const double epsilon = 0,
                       const bool sameSet = false);
 
+  /**
+   * Construct the NeighborSearchRules object, only holding candidate lists for
+   * the contiguous range of query points [queryBegin, queryBegin + queryCount).
+   * Only those query points may be passed to BaseCase(), Score() and Rescore().
+   * This is used by the parallel dual-tree search, where each thread traverses
+   * a disjoint query subtree with its own rules.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param queryBegin Index of the first query point handled by these rules.
+   * @param queryCount Number of query points handled by these rules.
+   * @param k Number of neighbors to search for.
+   * @param metric Instantiated metric.
+   * @param epsilon Relative approximate error.
+   * @param sameSet If true, the query and reference set are taken to be the
+   *      same, and a query point will not return itself in the results.
+   */
+  NeighborSearchRules(const typename TreeType::Mat& referenceSet,
+                      const typename TreeType::Mat& querySet,
+                      const size_t queryBegin,
+                      const size_t queryCount,
+                      const size_t k,
+                      MetricType& metric,
+                      const double epsilon = 0,
+                      const bool sameSet = false);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
+   * If these rules only handle a range of query points, only the columns of
+   * that range are filled.
    *
    * @param neighbors Matrix storing lists of neighbors for each query point.
    * @param distances Matrix storing distances of neighbors for each query
@@ -73,6 +102,21 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Perform the base cases between each of the given query points and each
+   * reference point in [referenceBegin, referenceBegin + referenceCount).  For
+   * the Euclidean distance in more than a few dimensions, the whole block of
+   * distances is computed with one matrix multiplication; otherwise, this is
+   * the same as calling BaseCase() for each pair.
+   *
+   * @param queryIndices Indices of query points.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BatchBaseCases(const std::vector<size_t>& queryIndices,
+                      const size_t referenceBegin,
+                      const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -175,12 +219,18 @@ class NeighborSearchRules
     };
   };
 
-  //! Use a priority queue to represent the list of candidate neighbors.
-  typedef std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>
-      CandidateList;
+  /**
+   * The candidate neighbors of all query points, stored in one flat array: the
+   * k candidates of the i'th query point held by these rules are
+   * candidates[i * k] to candidates[i * k + k - 1], sorted from best to worst.
+   * Since k is small, keeping each list sorted by insertion is cheaper than a
+   * heap, the k'th best distance (used for pruning) is always the last element
+   * of the list, and all of the lists take only a single allocation.
+   */
+  std::vector<Candidate> candidates;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Index of the first query point whose candidates are held in candidates.
+  size_t queryBegin;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -206,6 +256,18 @@ class NeighborSearchRules
   //! The number of scores that have been performed.
   size_t scores;
 
+  //! The element type of the datasets.
+  typedef typename TreeType::Mat::elem_type ElemType;
+
+  //! Squared norms of the query points held in candidates, used by
+  //! BatchBaseCases().  This is empty if base cases are not batched.
+  arma::Col<ElemType> queryNorms;
+  //! Squared norms of the reference points, used by BatchBaseCases().
+  arma::Col<ElemType> referenceNorms;
+  //! Distances computed by BatchBaseCases(), held in the class so that it
+  //! isn't continually being reallocated.
+  arma::Mat<ElemType> batchDistances;
+
   //! Traversal info for the parent combination; this is updated by the
   //! traversal before each call to Score().
   TraversalInfoType traversalInfo;
@@ -225,6 +287,16 @@ class NeighborSearchRules
   void InsertNeighbor(const size_t queryIndex,
                       const size_t neighbor,
                       const double distance);
+
+  /**
+   * Return the distance to the k'th best candidate of the given query point.
+   *
+   * @param queryIndex Index of the query point.
+   */
+  double WorstCandidateDistance(const size_t queryIndex) const
+  {
+    return candidates[(queryIndex - queryBegin) * k + k - 1].first;
+  }
 };
 
 } // namespace neighbor
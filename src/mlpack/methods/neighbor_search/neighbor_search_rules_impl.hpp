@@ -27,8 +27,23 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
     MetricType& metric,
     const double epsilon,
     const bool sameSet) :
+    NeighborSearchRules(referenceSet, querySet, 0, querySet.n_cols, k, metric,
+        epsilon, sameSet)
+{ /* Nothing left to do. */ }
+
+template<typename SortPolicy, typename MetricType, typename TreeType>
+NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
+    const size_t queryBegin,
+    const size_t queryCount,
+    const size_t k,
+    MetricType& metric,
+    const double epsilon,
+    const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    queryBegin(queryBegin),
     k(k),
     metric(metric),
     sameSet(sameSet),
@@ -51,12 +66,13 @@ NeighborSearchRules<SortPolicy, MetricType, TreeType>::NeighborSearchRules(
   const Candidate def = std::make_pair(SortPolicy::WorstDistance(),
       size_t() - 1);
 
-  std::vector<Candidate> vect(k, def);
-  CandidateList pqueue(CandidateCmp(), std::move(vect));
+  candidates.assign(queryCount * k, def);
 
-  candidates.reserve(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; i++)
-    candidates.push_back(pqueue);
+  // If base cases can be computed in blocks, cache the squared norms of the
+  // points.
+  tree::BatchNorms<MetricType>(querySet, queryBegin, queryCount, queryNorms);
+  tree::BatchNorms<MetricType>(referenceSet, 0, referenceSet.n_cols,
+      referenceNorms);
 }
 
 template<typename SortPolicy, typename MetricType, typename TreeType>
@@ -67,14 +83,13 @@ void NeighborSearchRules<SortPolicy, MetricType, TreeType>::GetResults(
   neighbors.set_size(k, querySet.n_cols);
   distances.set_size(k, querySet.n_cols);
 
-  for (size_t i = 0; i < querySet.n_cols; i++)
+  const size_t queryCount = candidates.size() / k;
+  for (size_t i = 0; i < queryCount; i++)
   {
-    CandidateList& pqueue = candidates[i];
-    for (size_t j = 1; j <= k; j++)
+    for (size_t j = 0; j < k; j++)
     {
-      neighbors(k - j, i) = pqueue.top().second;
-      distances(k - j, i) = pqueue.top().first;
-      pqueue.pop();
+      neighbors(j, queryBegin + i) = candidates[i * k + j].second;
+      distances(j, queryBegin + i) = candidates[i * k + j].first;
     }
   }
 };
@@ -107,6 +122,46 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return distance;
 }
 
+template<typename SortPolicy, typename MetricType, typename TreeType>
+void NeighborSearchRules<SortPolicy, MetricType, TreeType>::BatchBaseCases(
+    const std::vector<size_t>& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  const size_t referenceEnd = referenceBegin + referenceCount;
+  if (queryNorms.is_empty() || referenceNorms.is_empty())
+  {
+    for (size_t i = 0; i < queryIndices.size(); ++i)
+      for (size_t ref = referenceBegin; ref < referenceEnd; ++ref)
+        BaseCase(queryIndices[i], ref);
+
+    return;
+  }
+
+  arma::uvec queries(queryIndices.size());
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+    queries[i] = queryIndices[i];
+
+  const arma::Col<ElemType> norms = queryNorms.elem(queries - queryBegin);
+  tree::BatchDistances<MetricType>(querySet, queries, norms, referenceSet,
+      referenceBegin, referenceCount,
+      referenceNorms.subvec(referenceBegin, referenceEnd - 1), batchDistances);
+
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+  {
+    for (size_t j = 0; j < referenceCount; ++j)
+    {
+      // As in BaseCase(), a point is not its own neighbor.
+      if (sameSet && (queryIndices[i] == referenceBegin + j))
+        continue;
+
+      InsertNeighbor(queryIndices[i], referenceBegin + j,
+          (double) batchDistances(i, j));
+      ++baseCases;
+    }
+  }
+}
+
 template<typename SortPolicy, typename MetricType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
     const size_t queryIndex,
@@ -143,7 +198,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Score(
   }
 
   // Compare against the best k'th distance for this query point so far.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = WorstCandidateDistance(queryIndex);
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ?
@@ -179,7 +234,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::Rescore(
   const double distance = SortPolicy::ConvertToDistance(oldScore);
 
   // Just check the score again against the distances.
-  double bestDistance = candidates[queryIndex].top().first;
+  double bestDistance = WorstCandidateDistance(queryIndex);
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
   return (SortPolicy::IsBetter(distance, bestDistance)) ? oldScore : DBL_MAX;
@@ -404,7 +459,7 @@ inline double NeighborSearchRules<SortPolicy, MetricType, TreeType>::
   // Loop over points held in the node.
   for (size_t i = 0; i < queryNode.NumPoints(); ++i)
   {
-    const double distance = candidates[queryNode.Point(i)].top().first;
+    const double distance = WorstCandidateDistance(queryNode.Point(i));
     if (SortPolicy::IsBetter(worstDistance, distance))
       worstDistance = distance;
     if (SortPolicy::IsBetter(distance, bestPointDistance))
@@ -499,14 +554,21 @@ InsertNeighbor(
     const size_t neighbor,
     const double distance)
 {
-  CandidateList& pqueue = candidates[queryIndex];
-  Candidate c = std::make_pair(distance, neighbor);
+  Candidate* list = candidates.data() + (queryIndex - queryBegin) * k;
+  const Candidate c = std::make_pair(distance, neighbor);
+
+  if (!CandidateCmp()(c, list[k - 1]))
+    return;
 
-  if (CandidateCmp()(c, pqueue.top()))
+  // Shift the worse candidates down to make room for the new one, keeping the
+  // list sorted.
+  size_t pos = k - 1;
+  while (pos > 0 && CandidateCmp()(c, list[pos - 1]))
   {
-    pqueue.pop();
-    pqueue.push(c);
+    list[pos] = list[pos - 1];
+    --pos;
   }
+  list[pos] = c;
 }
 
 } // namespace neighbor
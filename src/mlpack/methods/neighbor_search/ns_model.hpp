@@ -212,6 +212,52 @@ class EpsilonVisitor : public boost::static_visitor<double&>
   double& operator()(NSType *ns) const;
 };
 
+/**
+ * MaxLeavesVisitor exposes the MaxLeaves() method of the given NSType.
+ */
+class MaxLeavesVisitor : public boost::static_visitor<size_t&>
+{
+ public:
+  //! Return the maximum number of leaves visited by best-first search.
+  template<typename NSType>
+  size_t& operator()(NSType* ns) const;
+};
+
+/**
+ * MaxBaseCasesVisitor exposes the MaxBaseCases() method of the given NSType.
+ */
+class MaxBaseCasesVisitor : public boost::static_visitor<size_t&>
+{
+ public:
+  //! Return the maximum number of base cases of best-first search.
+  template<typename NSType>
+  size_t& operator()(NSType* ns) const;
+};
+
+/**
+ * CollectStatisticsVisitor exposes the CollectStatistics() method of the given
+ * NSType.
+ */
+class CollectStatisticsVisitor : public boost::static_visitor<bool&>
+{
+ public:
+  //! Return whether traversal statistics are collected.
+  template<typename NSType>
+  bool& operator()(NSType* ns) const;
+};
+
+/**
+ * StatisticsVisitor exposes the traversal statistics of the given NSType.
+ */
+class StatisticsVisitor :
+    public boost::static_visitor<const tree::TraversalStatistics&>
+{
+ public:
+  //! Return the traversal statistics of the last search.
+  template<typename NSType>
+  const tree::TraversalStatistics& operator()(NSType* ns) const;
+};
+
 /**
  * ReferenceSetVisitor exposes the referenceSet of the given NSType.
  */
@@ -363,6 +409,21 @@ class NSModel
   double Epsilon() const;
   double& Epsilon();
 
+  //! Expose the maximum number of leaves visited by best-first search.
+  size_t MaxLeaves() const;
+  size_t& MaxLeaves();
+
+  //! Expose the maximum number of base cases of best-first search.
+  size_t MaxBaseCases() const;
+  size_t& MaxBaseCases();
+
+  //! Expose whether traversal statistics are collected.
+  bool CollectStatistics() const;
+  bool& CollectStatistics();
+
+  //! Expose the traversal statistics of the last search.
+  const tree::TraversalStatistics& Statistics() const;
+
   //! Expose leafSize.
   size_t LeafSize() const { return leafSize; }
   size_t& LeafSize() { return leafSize; }
@@ -400,6 +461,19 @@ class NSModel
               arma::Mat<size_t>& neighbors,
               arma::mat& distances);
 
+  /**
+   * Perform neighbor search on a stream of query points, one chunk at a time.
+   * nextQueryChunk() is called to get each chunk until it returns false, and
+   * the results for each chunk are passed to handleResults() along with the
+   * index of the first point of the chunk in the stream.  See
+   * NeighborSearch::Search() for details.
+   */
+  void Search(const std::function<bool(arma::mat&)>& nextQueryChunk,
+              const size_t k,
+              const std::function<void(const size_t,
+                                       const arma::Mat<size_t>&,
+                                       const arma::mat&)>& handleResults);
+
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
 };
@@ -243,6 +243,43 @@ double& EpsilonVisitor::operator()(NSType* ns) const
   throw std::runtime_error("no neighbor search model initialized");
 }
 
+//! Expose the MaxLeaves method of the given NSType.
+template<typename NSType>
+size_t& MaxLeavesVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->MaxLeaves();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Expose the MaxBaseCases method of the given NSType.
+template<typename NSType>
+size_t& MaxBaseCasesVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->MaxBaseCases();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Expose the CollectStatistics method of the given NSType.
+template<typename NSType>
+bool& CollectStatisticsVisitor::operator()(NSType* ns) const
+{
+  if (ns)
+    return ns->CollectStatistics();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
+//! Expose the traversal statistics of the given NSType.
+template<typename NSType>
+const tree::TraversalStatistics& StatisticsVisitor::operator()(NSType* ns)
+    const
+{
+  if (ns)
+    return ns->Statistics();
+  throw std::runtime_error("no neighbor search model initialized");
+}
+
 //! Expose the referenceSet of the given NSType.
 template<typename NSType>
 const arma::mat& ReferenceSetVisitor::operator()(NSType* ns) const
@@ -412,6 +449,48 @@ double& NSModel<SortPolicy>::Epsilon()
   return boost::apply_visitor(EpsilonVisitor(), nSearch);
 }
 
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::MaxLeaves() const
+{
+  return boost::apply_visitor(MaxLeavesVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+size_t& NSModel<SortPolicy>::MaxLeaves()
+{
+  return boost::apply_visitor(MaxLeavesVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::MaxBaseCases() const
+{
+  return boost::apply_visitor(MaxBaseCasesVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+size_t& NSModel<SortPolicy>::MaxBaseCases()
+{
+  return boost::apply_visitor(MaxBaseCasesVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+bool NSModel<SortPolicy>::CollectStatistics() const
+{
+  return boost::apply_visitor(CollectStatisticsVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+bool& NSModel<SortPolicy>::CollectStatistics()
+{
+  return boost::apply_visitor(CollectStatisticsVisitor(), nSearch);
+}
+
+template<typename SortPolicy>
+const tree::TraversalStatistics& NSModel<SortPolicy>::Statistics() const
+{
+  return boost::apply_visitor(StatisticsVisitor(), nSearch);
+}
+
 //! Build the reference tree.
 template<typename SortPolicy>
 void NSModel<SortPolicy>::BuildModel(arma::mat&& referenceSet,
@@ -554,6 +633,10 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
       Log::Info << "greedy single-tree " << TreeName() << " search..."
           << std::endl;
       break;
+    case BEST_FIRST_SINGLE_TREE_MODE:
+      Log::Info << "best-first single-tree " << TreeName() << " search..."
+          << std::endl;
+      break;
   }
 
   BiSearchVisitor<SortPolicy> search(querySet, k, neighbors, distances,
@@ -561,6 +644,33 @@ void NSModel<SortPolicy>::Search(arma::mat&& querySet,
   boost::apply_visitor(search, nSearch);
 }
 
+//! Perform neighbor search on a stream of query chunks.
+template<typename SortPolicy>
+void NSModel<SortPolicy>::Search(
+    const std::function<bool(arma::mat&)>& nextQueryChunk,
+    const size_t k,
+    const std::function<void(const size_t,
+                             const arma::Mat<size_t>&,
+                             const arma::mat&)>& handleResults)
+{
+  arma::mat queryChunk;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  size_t firstQuery = 0;
+
+  while (nextQueryChunk(queryChunk))
+  {
+    if (queryChunk.n_cols == 0)
+      continue;
+
+    // The chunk may be modified by the search, so it is not used afterwards.
+    const size_t chunkSize = queryChunk.n_cols;
+    Search(std::move(queryChunk), k, neighbors, distances);
+    handleResults(firstQuery, neighbors, distances);
+    firstQuery += chunkSize;
+  }
+}
+
 //! Perform neighbor search.
 template<typename SortPolicy>
 void NSModel<SortPolicy>::Search(const size_t k,
@@ -584,6 +694,10 @@ void NSModel<SortPolicy>::Search(const size_t k,
       Log::Info << "greedy single-tree " << TreeName() << " search..."
           << std::endl;
       break;
+    case BEST_FIRST_SINGLE_TREE_MODE:
+      Log::Info << "best-first single-tree " << TreeName() << " search..."
+          << std::endl;
+      break;
   }
 
   if (Epsilon() != 0 && SearchMode() != NAIVE_MODE)
@@ -0,0 +1,111 @@
+/**
+ * @file ns_query_server.cpp
+ *
+ * Reading of query batches and writing of results for ServeQueries().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "ns_query_server.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+namespace mlpack {
+namespace neighbor {
+
+bool ReadQueryBatch(std::istream& input,
+                    const size_t dimensionality,
+                    arma::mat& batch,
+                    std::string& error)
+{
+  std::vector<double> values;
+  size_t numPoints = 0;
+  std::string line;
+  error.clear();
+
+  while (std::getline(input, line))
+  {
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream lineStream(line);
+
+    size_t count = 0;
+    double value;
+    while (lineStream >> value)
+    {
+      values.push_back(value);
+      ++count;
+    }
+
+    // Reading only stops before the end of the line at a bad value.
+    const bool parsed = lineStream.eof();
+    if (parsed && count == 0)
+    {
+      // An empty line ends the batch, unless the batch has not started yet.
+      if (numPoints > 0 || !error.empty())
+        break;
+      continue;
+    }
+
+    // Once the batch has been rejected, skip the rest of it.
+    if (!error.empty())
+      continue;
+
+    std::ostringstream oss;
+    if (!parsed)
+    {
+      oss << "could not parse query point " << numPoints << ".";
+      error = oss.str();
+    }
+    else if (count != dimensionality)
+    {
+      oss << "query point " << numPoints << " has " << count << " dimensions, "
+          << "but the reference set has " << dimensionality << ".";
+      error = oss.str();
+    }
+
+    ++numPoints;
+  }
+
+  if (numPoints == 0 && error.empty())
+  {
+    batch.reset();
+    return false;
+  }
+
+  if (error.empty())
+    batch = arma::mat(values.data(), dimensionality, numPoints);
+  else
+    batch.reset();
+
+  return true;
+}
+
+void WriteQueryResults(const arma::Mat<size_t>& neighbors,
+                       const arma::mat& distances,
+                       std::ostream& output)
+{
+  // Print enough digits that the distances can be read back exactly.
+  const std::streamsize precision =
+      output.precision(std::numeric_limits<double>::max_digits10);
+
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+      output << neighbors(j, i) << ",";
+
+    for (size_t j = 0; j < distances.n_rows; ++j)
+      output << distances(j, i) << ((j + 1 < distances.n_rows) ? "," : "");
+
+    output << std::endl;
+  }
+
+  output << std::endl;
+  output.precision(precision);
+}
+
+} // namespace neighbor
+} // namespace mlpack
@@ -0,0 +1,87 @@
+/**
+ * @file ns_query_server.hpp
+ *
+ * A simple query server for NSModel.  Batches of query points are read from an
+ * input stream and their neighbors are written to an output stream, so that a
+ * model can be loaded once and then answer many requests from another program
+ * (for instance, one connected to the standard input and output of mlpack_knn
+ * --serve).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NS_QUERY_SERVER_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NS_QUERY_SERVER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <iostream>
+#include <string>
+#include "ns_model.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * Read one batch of query points from the given stream.  A batch holds one
+ * point per line, with the coordinates separated by commas or whitespace, and
+ * is ended by an empty line or by the end of the stream.  Empty lines before a
+ * batch are skipped.  If the batch is malformed, the rest of it is skipped,
+ * the batch is left empty and the reason is given in error.
+ *
+ * @param input Stream to read from.
+ * @param dimensionality Number of coordinates each query point must have.
+ * @param batch Matrix to store the query points in, one per column.
+ * @param error Set to the reason the batch was rejected, or cleared.
+ * @return false if the stream ended before any point of another batch.
+ */
+bool ReadQueryBatch(std::istream& input,
+                    const size_t dimensionality,
+                    arma::mat& batch,
+                    std::string& error);
+
+/**
+ * Write the results for one batch of query points to the given stream: one
+ * line per query point holding the indices of its neighbors followed by the
+ * distances to them, separated by commas, then an empty line.  The stream is
+ * flushed afterwards.
+ *
+ * @param neighbors Neighbors of each query point, one column per point.
+ * @param distances Distances to those neighbors.
+ * @param output Stream to write to.
+ */
+void WriteQueryResults(const arma::Mat<size_t>& neighbors,
+                       const arma::mat& distances,
+                       std::ostream& output);
+
+/**
+ * Answer batches of query points read from the given input stream with the
+ * given model, until the input ends.  The format of the batches is described
+ * in ReadQueryBatch(), and the format of the results in WriteQueryResults().
+ * All the points of a batch are searched together (with a single dual-tree
+ * traversal in dual-tree mode), so clients should group their queries into
+ * batches where they can.
+ *
+ * A malformed batch is answered with a single line starting with "error: ",
+ * followed by an empty line, and the following batches are still answered.
+ *
+ * @param model Model to search with.
+ * @param k Number of neighbors to search for.
+ * @param input Stream to read batches of query points from.
+ * @param output Stream to write the results to.
+ * @return Number of batches that were answered with results.
+ */
+template<typename SortPolicy>
+size_t ServeQueries(NSModel<SortPolicy>& model,
+                    const size_t k,
+                    std::istream& input,
+                    std::ostream& output);
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "ns_query_server_impl.hpp"
+
+#endif
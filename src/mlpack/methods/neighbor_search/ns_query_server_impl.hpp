@@ -0,0 +1,58 @@
+/**
+ * @file ns_query_server_impl.hpp
+ *
+ * Implementation of ServeQueries().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_NS_QUERY_SERVER_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_NS_QUERY_SERVER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ns_query_server.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy>
+size_t ServeQueries(NSModel<SortPolicy>& model,
+                    const size_t k,
+                    std::istream& input,
+                    std::ostream& output)
+{
+  const size_t dimensionality = model.Dataset().n_rows;
+  size_t batches = 0;
+  std::string error;
+
+  // Each batch is one chunk of the query stream.
+  model.Search([&](arma::mat& batch)
+      {
+        while (ReadQueryBatch(input, dimensionality, batch, error))
+        {
+          if (error.empty())
+            return true;
+
+          output << "error: " << error << std::endl << std::endl;
+        }
+
+        return false;
+      },
+      k,
+      [&](const size_t /* firstQuery */,
+          const arma::Mat<size_t>& neighbors,
+          const arma::mat& distances)
+      {
+        WriteQueryResults(neighbors, distances, output);
+        ++batches;
+      });
+
+  return batches;
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file sharded_neighbor_search.hpp
+ *
+ * Defines the ShardedNeighborSearch class, which performs neighbor search on a
+ * reference set that is split into several shards, each with its own
+ * NeighborSearch object and tree, and merges the results of the shards.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <algorithm>
+#include <vector>
+#include "neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+/**
+ * The ShardedNeighborSearch class searches a reference set that is given as a
+ * list of shards.  A NeighborSearch object (with its own reference tree) is
+ * built on each shard; to search, each shard is searched in turn with the
+ * existing Search() of NeighborSearch, and the k best results of each shard
+ * are merged into the k best results overall.  The points of the reference set
+ * are numbered shard by shard: the points of shard i come after all the points
+ * of shards 0 through i - 1.
+ *
+ * Shards are searched in order of their distance to the query points.  Before
+ * a shard is searched, its root node is compared with the current k'th best
+ * distance of each query point, and the shard is only searched for the query
+ * points that could have a better neighbor in it.  When the shards cover
+ * separate regions of space, most shards are then skipped for most queries.
+ *
+ * Each shard can also be searched elsewhere (for instance, on another machine
+ * holding only that shard) and the results combined with MergeResults().
+ *
+ * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
+ * @tparam MetricType The metric to use for computation.
+ * @tparam MatType The type of data matrix.
+ * @tparam TreeType The tree type to use for each shard.
+ */
+template<typename SortPolicy = NearestNeighborSort,
+         typename MetricType = mlpack::metric::EuclideanDistance,
+         typename MatType = arma::mat,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = tree::KDTree>
+class ShardedNeighborSearch
+{
+ public:
+  //! The type of the search object for each shard.
+  typedef NeighborSearch<SortPolicy, MetricType, MatType, TreeType> ShardType;
+
+  /**
+   * Build a search object (and, unless naive search is used, a tree) on each
+   * of the given shards.  The shards are taken with std::move() to avoid
+   * copies.  All shards must have the same dimensionality and at least one
+   * point.
+   *
+   * @param shards Shards of the reference set.
+   * @param mode Neighbor search mode to use for each shard.
+   * @param epsilon Relative approximate error (non-negative).
+   * @param metric An optional instance of the MetricType class.
+   */
+  ShardedNeighborSearch(std::vector<MatType> shards,
+                        const NeighborSearchMode mode = DUAL_TREE_MODE,
+                        const double epsilon = 0,
+                        const MetricType metric = MetricType());
+
+  /**
+   * For each point in the query set, compute the k best neighbors over all of
+   * the shards and store them in the given matrices, which are set to k rows by
+   * n columns, where n is the number of query points.  If the reference set has
+   * fewer than k points, the missing neighbors are given as SIZE_MAX with
+   * distance SortPolicy::WorstDistance().
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::mat& distances);
+
+  /**
+   * Merge the results of searching one shard into the current results.  Each
+   * column of the current results holds k neighbors sorted from best to worst;
+   * each column of the shard results holds at most k neighbors, also sorted.
+   * The best k of the two lists are kept, in order.
+   *
+   * @param shardNeighbors Neighbors found in the shard, with indices local to
+   *     the shard.
+   * @param shardDistances Distances to the neighbors found in the shard.
+   * @param shardOffset Index of the first point of the shard in the whole
+   *     reference set; this is added to the indices of the shard results.
+   * @param neighbors Current neighbors, which are updated.
+   * @param distances Current distances, which are updated.
+   */
+  static void MergeResults(const arma::Mat<size_t>& shardNeighbors,
+                           const arma::mat& shardDistances,
+                           const size_t shardOffset,
+                           arma::Mat<size_t>& neighbors,
+                           arma::mat& distances);
+
+  //! Get the number of shards.
+  size_t NumShards() const { return shards.size(); }
+  //! Get the search object of the given shard.
+  const ShardType& Shard(const size_t i) const { return shards[i]; }
+  //! Get the index of the first point of the given shard.
+  size_t ShardOffset(const size_t i) const { return offsets[i]; }
+
+  //! Get the number of times a shard was searched during the last search (at
+  //! most once per shard).
+  size_t ShardSearches() const { return shardSearches; }
+
+ private:
+  //! The search objects of each shard.
+  std::vector<ShardType> shards;
+  //! The index of the first point of each shard in the whole reference set.
+  std::vector<size_t> offsets;
+  //! The search mode.
+  NeighborSearchMode searchMode;
+  //! The number of shards searched during the last search.
+  size_t shardSearches;
+};
+
+} // namespace neighbor
+} // namespace mlpack
+
+// Include implementation.
+#include "sharded_neighbor_search_impl.hpp"
+
+#endif
@@ -0,0 +1,208 @@
+/**
+ * @file sharded_neighbor_search_impl.hpp
+ *
+ * Implementation of the ShardedNeighborSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SHARDED_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sharded_neighbor_search.hpp"
+
+namespace mlpack {
+namespace neighbor {
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+ShardedNeighborSearch(std::vector<MatType> shardsIn,
+                      const NeighborSearchMode mode,
+                      const double epsilon,
+                      const MetricType metric) :
+    searchMode(mode),
+    shardSearches(0)
+{
+  shards.reserve(shardsIn.size());
+  offsets.reserve(shardsIn.size());
+
+  size_t offset = 0;
+  for (size_t i = 0; i < shardsIn.size(); ++i)
+  {
+    if (shardsIn[i].n_cols == 0)
+    {
+      std::stringstream ss;
+      ss << "ShardedNeighborSearch: shard " << i << " has no points";
+      throw std::invalid_argument(ss.str());
+    }
+
+    if (shardsIn[i].n_rows != shardsIn[0].n_rows)
+    {
+      std::stringstream ss;
+      ss << "ShardedNeighborSearch: shard " << i << " has dimensionality "
+          << shardsIn[i].n_rows << ", but shard 0 has dimensionality "
+          << shardsIn[0].n_rows;
+      throw std::invalid_argument(ss.str());
+    }
+
+    offsets.push_back(offset);
+    offset += shardsIn[i].n_cols;
+    shards.emplace_back(std::move(shardsIn[i]), mode, epsilon, metric);
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::mat& distances)
+{
+  neighbors.set_size(k, querySet.n_cols);
+  neighbors.fill(size_t() - 1);
+  distances.set_size(k, querySet.n_cols);
+  distances.fill(SortPolicy::WorstDistance());
+  shardSearches = 0;
+
+  if (k == 0)
+    return;
+
+  // Without trees there are no bounds to prune shards with.
+  const bool prune = (searchMode != NAIVE_MODE);
+
+  // Compute the best distance from each query point to the root of each shard,
+  // and search the shards that are closest to the query set first, so that the
+  // other shards can be pruned for as many query points as possible.
+  std::vector<size_t> order(shards.size());
+  for (size_t s = 0; s < shards.size(); ++s)
+    order[s] = s;
+
+  arma::mat bestDistances;
+  if (prune)
+  {
+    bestDistances.set_size(shards.size(), querySet.n_cols);
+    std::vector<double> shardBest(shards.size(), SortPolicy::WorstDistance());
+    for (size_t s = 0; s < shards.size(); ++s)
+    {
+      for (size_t q = 0; q < querySet.n_cols; ++q)
+      {
+        bestDistances(s, q) = SortPolicy::BestPointToNodeDistance(
+            querySet.col(q), &shards[s].ReferenceTree());
+        if (SortPolicy::IsBetter(bestDistances(s, q), shardBest[s]))
+          shardBest[s] = bestDistances(s, q);
+      }
+    }
+
+    // IsBetter() is not strict, so it is reversed to get a strict ordering.
+    std::stable_sort(order.begin(), order.end(),
+        [&shardBest](const size_t a, const size_t b)
+        {
+          return !SortPolicy::IsBetter(shardBest[b], shardBest[a]);
+        });
+  }
+
+  std::vector<size_t> queryIndices;
+  arma::Mat<size_t> shardNeighbors;
+  arma::mat shardDistances;
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    const size_t s = order[i];
+    const size_t shardK = std::min(k, (size_t) shards[s].ReferenceSet().n_cols);
+
+    // Only search for the query points that may have a better neighbor in this
+    // shard than their current k'th neighbor.
+    queryIndices.clear();
+    for (size_t q = 0; q < querySet.n_cols; ++q)
+    {
+      if (!prune || SortPolicy::IsBetter(bestDistances(s, q),
+          distances(k - 1, q)))
+        queryIndices.push_back(q);
+    }
+
+    if (queryIndices.empty())
+      continue;
+
+    ++shardSearches;
+    if (queryIndices.size() == querySet.n_cols)
+    {
+      shards[s].Search(querySet, shardK, shardNeighbors, shardDistances);
+      MergeResults(shardNeighbors, shardDistances, offsets[s], neighbors,
+          distances);
+    }
+    else
+    {
+      const arma::uvec indices = arma::conv_to<arma::uvec>::from(queryIndices);
+      const MatType subset = querySet.cols(indices);
+      shards[s].Search(subset, shardK, shardNeighbors, shardDistances);
+
+      arma::Mat<size_t> subsetNeighbors = neighbors.cols(indices);
+      arma::mat subsetDistances = distances.cols(indices);
+      MergeResults(shardNeighbors, shardDistances, offsets[s],
+          subsetNeighbors, subsetDistances);
+      neighbors.cols(indices) = subsetNeighbors;
+      distances.cols(indices) = subsetDistances;
+    }
+  }
+}
+
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void ShardedNeighborSearch<SortPolicy, MetricType, MatType, TreeType>::
+MergeResults(const arma::Mat<size_t>& shardNeighbors,
+             const arma::mat& shardDistances,
+             const size_t shardOffset,
+             arma::Mat<size_t>& neighbors,
+             arma::mat& distances)
+{
+  const size_t k = neighbors.n_rows;
+  arma::Col<size_t> oldNeighbors;
+  arma::vec oldDistances;
+
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    oldNeighbors = neighbors.col(i);
+    oldDistances = distances.col(i);
+
+    // Merge the two sorted lists; on ties, the current neighbor is kept.
+    size_t a = 0;
+    size_t b = 0;
+    for (size_t j = 0; j < k; ++j)
+    {
+      if (b < shardDistances.n_rows &&
+          !SortPolicy::IsBetter(oldDistances[a], shardDistances(b, i)))
+      {
+        neighbors(j, i) = shardOffset + shardNeighbors(b, i);
+        distances(j, i) = shardDistances(b, i);
+        ++b;
+      }
+      else
+      {
+        neighbors(j, i) = oldNeighbors[a];
+        distances(j, i) = oldDistances[a];
+        ++a;
+      }
+    }
+  }
+}
+
+} // namespace neighbor
+} // namespace mlpack
+
+#endif
@@ -57,7 +57,10 @@ PROGRAM_INFO("Non-negative Matrix Factorization",
     "The maximum number of iterations is specified with " +
     PRINT_PARAM_STRING("max_iterations") + ", and the minimum residue "
     "required for algorithm termination is specified with the " +
-    PRINT_PARAM_STRING("min_residue") + " parameter."
+    PRINT_PARAM_STRING("min_residue") + " parameter.  Checking the residue "
+    "costs about as much as an iteration with a small rank; to check it only "
+    "every few iterations, use the " + PRINT_PARAM_STRING("check_interval") +
+    " parameter."
     "\n\n"
     "For example, to run NMF on the input matrix " + PRINT_DATASET("V") + " "
     "using the 'multdist' update rules with a rank-10 decomposition and "
@@ -88,6 +91,8 @@ PARAM_INT_IN("max_iterations", "Number of iterations before NMF terminates (0 "
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 PARAM_DOUBLE_IN("min_residue", "The minimum root mean square residue allowed "
     "for each iteration, below which the program terminates.", "e", 1e-5);
+PARAM_INT_IN("check_interval", "Number of iterations between computations of "
+    "the residue.", "c", 1);
 
 PARAM_STRING_IN("update_rules", "Update rules for each iteration; ( multdist | "
     "multdiv | als ).", "u", "multdist");
@@ -142,6 +147,7 @@ static void mlpackMain()
   const size_t r = CLI::GetParam<int>("rank");
   const size_t maxIterations = CLI::GetParam<int>("max_iterations");
   const double minResidue = CLI::GetParam<double>("min_residue");
+  const size_t checkInterval = CLI::GetParam<int>("check_interval");
   const string updateRules = CLI::GetParam<string>("update_rules");
 
   // Validate parameters.
@@ -151,6 +157,8 @@ static void mlpackMain()
       true, "unknown update rules");
   RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; },
       true, "max_iterations must be non-negative");
+  RequireParamValue<int>("check_interval", [](int x) { return x > 0; },
+      true, "check_interval must be positive");
 
   RequireAtLeastOnePassed({ "h", "w" }, false, "no output will be saved");
   RequireNoneOrAllPassed({"initial_w", "initial_h"}, true);
@@ -168,7 +176,7 @@ static void mlpackMain()
     Log::Info << "Performing NMF with multiplicative distance-based update "
         << "rules." << std::endl;
 
-    SimpleResidueTermination srt(minResidue, maxIterations);
+    SimpleResidueTermination srt(minResidue, maxIterations, checkInterval);
     if (CLI::HasParam("initial_w"))
     {
       // Initialization with given W, H matrices.
@@ -191,7 +199,7 @@ static void mlpackMain()
     Log::Info << "Performing NMF with multiplicative divergence-based update "
         << "rules." << std::endl;
 
-    SimpleResidueTermination srt(minResidue, maxIterations);
+    SimpleResidueTermination srt(minResidue, maxIterations, checkInterval);
     if (CLI::HasParam("initial_w"))
     {
       // Initialization with given W, H matrices.
@@ -217,7 +225,7 @@ static void mlpackMain()
     Log::Info << "Performing NMF with alternating least squared update rules."
         << std::endl;
 
-    SimpleResidueTermination srt(minResidue, maxIterations);
+    SimpleResidueTermination srt(minResidue, maxIterations, checkInterval);
     if (CLI::HasParam("initial_w"))
     {
       // Initialization with given W, H matrices.
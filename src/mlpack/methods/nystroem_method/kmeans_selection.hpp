@@ -39,12 +39,12 @@ class KMeansSelection
    */
   const static arma::mat* Select(const arma::mat& data, const size_t m)
   {
-    arma::Row<size_t> assignments;
     arma::mat* centroids = new arma::mat;
 
-    // Perform the K-Means clustering method.
+    // Perform the K-Means clustering method.  Only the centroids are needed, so
+    // the points are not assigned to them after the last iteration.
     ClusteringType kmeans(maxIterations);
-    kmeans.Cluster(data, m, assignments, *centroids);
+    kmeans.Cluster(data, m, *centroids);
 
     return centroids;
   }
@@ -0,0 +1,132 @@
+/**
+ * @file leverage_score_selection.hpp
+ *
+ * Select the points for use in the Nystroem method by sampling them according
+ * to their ridge leverage scores.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NYSTROEM_METHOD_LEVERAGE_SCORE_SELECTION_HPP
+#define MLPACK_METHODS_NYSTROEM_METHOD_LEVERAGE_SCORE_SELECTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Select points without replacement, with probabilities proportional to their
+ * ridge leverage scores, which measure how much each point contributes to the
+ * span of the dataset:
+ *
+ * @code
+ * @inproceedings{alaoui2015fast,
+ *   title={Fast randomized kernel ridge regression with statistical
+ *       guarantees},
+ *   author={Alaoui, A. and Mahoney, M.W.},
+ *   booktitle={Advances in Neural Information Processing Systems},
+ *   pages={775--783},
+ *   year={2015}
+ * }
+ * @endcode
+ *
+ * The selection policy doesn't get the kernel, so the scores are those of the
+ * points themselves (the linear kernel): l_i = x_i^T (X X^T + lambda I)^-1 x_i,
+ * with lambda = trace(X X^T) / m for m points to select.  That takes one d x d
+ * matrix and one parallel pass over the dataset, in O(n d^2).  For other
+ * kernels, the scores are a cheap proxy that favors the points far from the
+ * bulk of the data, which random selection tends to miss.
+ *
+ * The points are drawn with the keys log(u_i) / l_i of Efraimidis and
+ * Spirakis, with u_i uniform in [0, 1): the m points with the largest keys are
+ * a weighted sample without replacement.
+ */
+class LeverageScoreSelection
+{
+ public:
+  /**
+   * Select the specified number of points in the dataset, according to their
+   * ridge leverage scores.
+   *
+   * @param data Dataset to sample from.
+   * @param m Number of points to select.
+   * @return Indices of selected points from the dataset.
+   */
+  const static arma::Col<size_t> Select(const arma::mat& data, const size_t m)
+  {
+    if (m > data.n_cols)
+    {
+      std::ostringstream oss;
+      oss << "LeverageScoreSelection::Select(): cannot select " << m
+          << " points from a dataset of " << data.n_cols << " points";
+      throw std::invalid_argument(oss.str());
+    }
+
+    arma::vec scores;
+    LeverageScores(data, m, scores);
+
+    std::vector<std::pair<double, size_t>> keys(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      keys[i].first = (scores[i] > 0.0) ? std::log(math::Random()) /
+          scores[i] : -std::numeric_limits<double>::infinity();
+      keys[i].second = i;
+    }
+
+    std::nth_element(keys.begin(), keys.begin() + m, keys.end(),
+        std::greater<std::pair<double, size_t>>());
+
+    arma::Col<size_t> selectedPoints(m);
+    for (size_t i = 0; i < m; ++i)
+      selectedPoints(i) = keys[i].second;
+
+    return selectedPoints;
+  }
+
+  /**
+   * Compute the ridge leverage scores of the points of the dataset, for the
+   * selection of m points.
+   *
+   * @param data Dataset.
+   * @param m Number of points to select.
+   * @param scores Vector to store the score of each point in.
+   */
+  static void LeverageScores(const arma::mat& data,
+                             const size_t m,
+                             arma::vec& scores)
+  {
+    arma::mat gram = data * data.t();
+    const double lambda = arma::trace(gram) / std::max(m, (size_t) 1);
+    if (lambda <= 0.0)
+    {
+      // All the points are zero; they are equally (un)important.
+      scores.ones(data.n_cols);
+      return;
+    }
+
+    gram.diag() += lambda;
+    const arma::mat inverse = arma::inv_sympd(gram);
+
+    // Each block of points is scored at once by one thread.
+    const size_t blockSize = 1024;
+    const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+    scores.set_size(data.n_cols);
+
+    #pragma omp parallel for
+    for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) data.n_cols) - 1;
+      scores.subvec(begin, end) = arma::sum((inverse * data.cols(begin, end)) %
+          data.cols(begin, end), 0).t();
+    }
+  }
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
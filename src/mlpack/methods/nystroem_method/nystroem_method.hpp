@@ -16,6 +16,7 @@
 #define MLPACK_METHODS_NYSTROEM_METHOD_NYSTROEM_METHOD_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/batch_kernels.hpp>
 #include "kmeans_selection.hpp"
 
 namespace mlpack {
@@ -36,17 +36,12 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
     arma::mat& semiKernel)
 {
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      miniKernel(i, j) = kernel.Evaluate(selectedData->col(i),
-                                         selectedData->col(j));
+  kernel::KernelMatrix(kernel, *selectedData, *selectedData, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected data and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         selectedData->col(j));
+  kernel::KernelMatrix(kernel, data, *selectedData, semiKernel);
+
   // Clean the memory.
   delete selectedData;
 }
@@ -57,22 +52,16 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::GetKernelMatrix(
     arma::mat& miniKernel,
     arma::mat& semiKernel)
 {
+  // Gather the selected points, so that the kernel matrices can be assembled
+  // as blocks.
+  const arma::mat selectedData = data.cols(selectedPoints);
+
   // Assemble mini-kernel matrix.
-  for (size_t i = 0; i < rank; ++i)
-  {
-    for (size_t j = 0; j < rank; ++j)
-    {
-      miniKernel(i, j) = kernel.Evaluate(data.col(selectedPoints(i)),
-                                         data.col(selectedPoints(j)));
-    }
-  }
+  kernel::KernelMatrix(kernel, selectedData, selectedData, miniKernel);
 
   // Construct semi-kernel matrix with interactions between selected points and
   // all points.
-  for (size_t i = 0; i < data.n_cols; ++i)
-    for (size_t j = 0; j < rank; ++j)
-      semiKernel(i, j) = kernel.Evaluate(data.col(i),
-                                         data.col(selectedPoints(j)));
+  kernel::KernelMatrix(kernel, data, selectedData, semiKernel);
 }
 
 template<typename KernelType, typename PointSelectionPolicy>
@@ -96,7 +85,9 @@ void NystroemMethod<KernelType, PointSelectionPolicy>::Apply(arma::mat& output)
     if (std::abs(s[i]) <= 1e-20)
       normalization(i, i) = 0.0;
 
-  output = semiKernel * U * normalization * V;
+  // Multiply the small matrices first, so that the semi-kernel matrix is only
+  // used in one matrix multiplication.
+  output = semiKernel * (U * normalization * V);
 }
 
 } // namespace kernel
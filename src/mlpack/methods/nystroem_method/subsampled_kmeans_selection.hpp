@@ -0,0 +1,94 @@
+/**
+ * @file subsampled_kmeans_selection.hpp
+ *
+ * Use the centroids of a mini-batch K-Means clustering of a random subsample
+ * of the dataset for use in the Nystroem method of kernel matrix
+ * approximation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NYSTROEM_METHOD_SUBSAMPLED_KMEANS_SELECTION_HPP
+#define MLPACK_METHODS_NYSTROEM_METHOD_SUBSAMPLED_KMEANS_SELECTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <unordered_set>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+#include <mlpack/methods/kmeans/allow_empty_clusters.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Implementation of the kmeans sampling scheme for large datasets.
+ * KMeansSelection clusters the whole dataset with Lloyd iterations, which
+ * costs O(nm) per iteration for m points to select.  This policy instead
+ * clusters a random subsample (without replacement) of sampleFactor * m points
+ * of the dataset.  By default, the centroids are initialized with k-means||
+ * (kmeans::KMeansParallelInitialization), and refined with mini-batch k-means
+ * iterations, which only touch the points of each batch (see
+ * kmeans::MiniBatchKMeans::DefaultBatchSize()); both run in parallel.  Empty
+ * clusters are allowed, so the points aren't searched for new centroids, and
+ * a centroid that was never assigned a point stays at its initial point,
+ * which k-means|| picks away from the other ones.
+ *
+ * @tparam ClusteringType Type of clustering.
+ * @tparam maxIterations Maximum number of iterations allowed before giving up.
+ * @tparam sampleFactor Size of the subsample, in multiples of the number of
+ *     points to select.
+ */
+template<typename ClusteringType = kmeans::KMeans<metric::EuclideanDistance,
+             kmeans::KMeansParallelInitialization, kmeans::AllowEmptyClusters,
+             kmeans::MiniBatchKMeans>,
+         size_t maxIterations = 100,
+         size_t sampleFactor = 20>
+class SubsampledKMeansSelection
+{
+ public:
+  /**
+   * Use the K-Means clustering method on a subsample of the dataset to select
+   * the specified number of points.  You are responsible for deleting the
+   * returned matrix!
+   *
+   * @param data Dataset to sample from.
+   * @param m Number of points to select.
+   * @return Matrix pointer in which centroids are stored.
+   */
+  const static arma::mat* Select(const arma::mat& data, const size_t m)
+  {
+    arma::mat* centroids = new arma::mat;
+    ClusteringType kmeans(maxIterations);
+
+    const size_t sampleSize = sampleFactor * m;
+    if (sampleSize >= data.n_cols)
+    {
+      kmeans.Cluster(data, m, *centroids);
+      return centroids;
+    }
+
+    // Floyd's algorithm draws the subsample without replacement in
+    // O(sampleSize) time.
+    std::unordered_set<size_t> sampled;
+    arma::Col<size_t> sample(sampleSize);
+    for (size_t i = 0, j = data.n_cols - sampleSize; i < sampleSize; ++i, ++j)
+    {
+      const size_t index = math::RandInt(0, j + 1);
+      sample(i) = sampled.count(index) ? j : index;
+      sampled.insert(sample(i));
+    }
+
+    const arma::mat subsample = data.cols(sample);
+    kmeans.Cluster(subsample, m, *centroids);
+
+    return centroids;
+  }
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,237 @@
+/**
+ * @file incremental_pca_method.hpp
+ *
+ * Implementation of the incremental PCA method, which updates the mean and a
+ * low-rank basis of the data one mini-batch at a time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_PCA_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_PCA_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * Implementation of the incremental PCA policy, as described in the following
+ * paper:
+ *
+ * @code
+ * @article{Ross2008,
+ *   author  = {Ross, D. A. and Lim, J. and Lin, R.-S. and Yang, M.-H.},
+ *   title   = {Incremental Learning for Robust Visual Tracking},
+ *   journal = {International Journal of Computer Vision},
+ *   volume  = {77},
+ *   number  = {1},
+ *   pages   = {125--141},
+ *   year    = {2008},
+ * }
+ * @endcode
+ *
+ * The policy keeps the number of points seen, their mean, and a rank-k basis
+ * of the centered points with its singular values.  Each mini-batch is merged
+ * with a thin SVD of
+ *
+ * [ U * diag(s), B - mean(B), sqrt(n * b / (n + b)) * (mean(B) - mean) ]
+ *
+ * where B is the mini-batch of b points and n is the number of points seen so
+ * far, so memory is bounded by O(d * (k + b)) whatever the number of points.
+ * When used by the PCA class, the centered data is processed in mini-batches;
+ * to compute PCA of data that doesn't fit in memory, call Reset() and then
+ * Update() with each mini-batch as it is read.
+ *
+ * @code
+ * IncrementalPCAPolicy ipca;
+ * ipca.Reset(dimensionality, rank);
+ *
+ * arma::mat batch;
+ * while (ReadNextBatch(batch))
+ *   ipca.Update(batch);
+ *
+ * // The principal components and their eigenvalues.
+ * const arma::mat& eigvec = ipca.Basis();
+ * arma::vec eigVal = arma::square(ipca.SingularValues()) /
+ *     (ipca.NumPoints() - 1);
+ * @endcode
+ */
+class IncrementalPCAPolicy
+{
+ public:
+  /**
+   * Use incremental PCA to perform the principal components analysis (PCA).
+   *
+   * @param batchSize Number of points in each mini-batch used by Apply()
+   *        (Default: 1024).
+   * @param oversampling Number of components kept in addition to the rank;
+   *        they make the truncation of each update more accurate
+   *        (Default: 10).
+   */
+  IncrementalPCAPolicy(const size_t batchSize = 1024,
+                       const size_t oversampling = 10) :
+      batchSize(batchSize),
+      oversampling(oversampling),
+      numComponents(0),
+      numPoints(0)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set using
+   * incremental PCA.
+   *
+   * @param data Data matrix.
+   * @param centeredData Centered data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const arma::mat& data,
+             const arma::mat& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    Reset(centeredData.n_rows, rank);
+
+    const size_t step = std::max(batchSize, (size_t) 1);
+    for (size_t i = 0; i < centeredData.n_cols; i += step)
+    {
+      Update(centeredData.cols(i, std::min(i + step,
+          (size_t) centeredData.n_cols) - 1));
+    }
+
+    eigvec = basis;
+
+    // Now we must square the singular values to get the eigenvalues.
+    // In addition we must divide by the number of points, because the
+    // covariance matrix is X * X' / (N - 1).
+    eigVal = arma::square(singularValues) / (data.n_cols - 1);
+
+    // Project the samples to the principals.
+    transformedData = arma::trans(eigvec) * centeredData;
+  }
+
+  /**
+   * Start a new decomposition of points with the given dimensionality.  The
+   * basis will have rank + Oversampling() components, or dimensionality
+   * components if that is smaller.
+   *
+   * @param dimensionality Dimensionality of the points.
+   * @param rank Rank of the decomposition.
+   */
+  void Reset(const size_t dimensionality, const size_t rank)
+  {
+    numComponents = std::min(rank + oversampling, dimensionality);
+    numPoints = 0;
+    mean.zeros(dimensionality);
+    basis.set_size(dimensionality, 0);
+    singularValues.set_size(0);
+  }
+
+  /**
+   * Update the mean and the basis with the given mini-batch of points.
+   *
+   * @param batch Mini-batch of points, one point per column.
+   */
+  void Update(const arma::mat& batch)
+  {
+    if (batch.n_rows != mean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "IncrementalPCAPolicy::Update(): batch has dimensionality "
+          << batch.n_rows << ", but the decomposition was reset with "
+          << "dimensionality " << mean.n_elem << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    if (batch.n_cols == 0)
+      return;
+
+    const double n = numPoints;
+    const double b = batch.n_cols;
+    const arma::vec batchMean = arma::mean(batch, 1);
+
+    // The current basis scaled by its singular values, the centered batch,
+    // and a column that accounts for the shift of the mean.
+    const size_t k = basis.n_cols;
+    arma::mat m(mean.n_elem, k + batch.n_cols + ((numPoints > 0) ? 1 : 0));
+    if (k > 0)
+    {
+      m.head_cols(k) = basis;
+      m.head_cols(k).each_row() %= singularValues.t();
+    }
+    m.cols(k, k + batch.n_cols - 1) = batch;
+    m.cols(k, k + batch.n_cols - 1).each_col() -= batchMean;
+    if (numPoints > 0)
+      m.col(m.n_cols - 1) = std::sqrt(n * b / (n + b)) * (batchMean - mean);
+
+    arma::mat u, v;
+    arma::vec s;
+    arma::svd_econ(u, s, v, m, 'l');
+
+    const size_t keep = std::min(numComponents, (size_t) s.n_elem);
+    basis = u.head_cols(keep);
+    singularValues = s.head(keep);
+
+    mean = (n * mean + b * batchMean) / (n + b);
+    numPoints += batch.n_cols;
+  }
+
+  //! Get the number of points in each mini-batch used by Apply().
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each mini-batch used by Apply().
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the number of components kept in addition to the rank.
+  size_t Oversampling() const { return oversampling; }
+  //! Modify the number of components kept in addition to the rank.  This takes
+  //! effect on the next call to Reset().
+  size_t& Oversampling() { return oversampling; }
+
+  //! Get the number of points seen since the last call to Reset().
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the mean of the points seen.
+  const arma::vec& Mean() const { return mean; }
+
+  //! Get the basis of the centered points seen.
+  const arma::mat& Basis() const { return basis; }
+
+  //! Get the singular values of the centered points seen.
+  const arma::vec& SingularValues() const { return singularValues; }
+
+ private:
+  //! Locally stored number of points in each mini-batch.
+  size_t batchSize;
+
+  //! Locally stored number of components kept in addition to the rank.
+  size_t oversampling;
+
+  //! Number of components of the basis.
+  size_t numComponents;
+
+  //! Number of points seen since the last call to Reset().
+  size_t numPoints;
+
+  //! Mean of the points seen.
+  arma::vec mean;
+
+  //! Basis of the centered points seen.
+  arma::mat basis;
+
+  //! Singular values of the centered points seen.
+  arma::vec singularValues;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
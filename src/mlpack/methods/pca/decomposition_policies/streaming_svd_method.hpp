@@ -0,0 +1,102 @@
+/**
+ * @file streaming_svd_method.hpp
+ *
+ * Implementation of the streaming SVD method for use in the Principal
+ * Components Analysis method.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_STREAMING_SVD_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_STREAMING_SVD_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/streaming_svd/streaming_svd.hpp>
+
+namespace mlpack {
+namespace pca {
+
+/**
+ * Implementation of the streaming SVD policy, which reads the data in a single
+ * pass over blocks of columns.  To run PCA on data that doesn't fit in memory,
+ * use svd::StreamingSVD directly and call Factorize() with centering.
+ */
+class StreamingSVDPolicy
+{
+ public:
+  /**
+   * Use streaming SVD method to perform the principal components analysis
+   * (PCA).
+   *
+   * @param oversampling Number of columns of the range sketch in addition to
+   *     the rank (Default: 10).
+   * @param blockSize Number of columns processed at once (Default: 1024).
+   */
+  StreamingSVDPolicy(const size_t oversampling = 10,
+                     const size_t blockSize = 1024) :
+      oversampling(oversampling),
+      blockSize(blockSize)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set using the
+   * streaming SVD.
+   *
+   * @param data Data matrix.
+   * @param centeredData Centered data matrix.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param rank Rank of the decomposition.
+   */
+  void Apply(const arma::mat& data,
+             const arma::mat& centeredData,
+             arma::mat& transformedData,
+             arma::vec& eigVal,
+             arma::mat& eigvec,
+             const size_t rank)
+  {
+    // This matrix will store the right singular values; we do not need them.
+    arma::mat v;
+
+    // Do singular value decomposition using the streaming SVD algorithm.  Like
+    // the other randomized policies, keep all the components of the sketch,
+    // so that the eigenvalues also estimate the variance that isn't retained.
+    svd::StreamingSVD ssvd(0, blockSize);
+    ssvd.Apply(centeredData, eigvec, eigVal, v, rank + oversampling);
+
+    // Now we must square the singular values to get the eigenvalues.
+    // In addition we must divide by the number of points, because the
+    // covariance matrix is X * X' / (N - 1).
+    eigVal %= eigVal / (data.n_cols - 1);
+
+    // Project the samples to the principals.
+    transformedData = arma::trans(eigvec) * centeredData;
+  }
+
+  //! Get the oversampling of the range sketch.
+  size_t Oversampling() const { return oversampling; }
+  //! Modify the oversampling of the range sketch.
+  size_t& Oversampling() { return oversampling; }
+
+  //! Get the number of columns processed at once.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of columns processed at once.
+  size_t& BlockSize() { return blockSize; }
+
+ private:
+  //! Locally stored oversampling of the range sketch.
+  size_t oversampling;
+
+  //! Locally stored number of columns processed at once.
+  size_t blockSize;
+};
+
+} // namespace pca
+} // namespace mlpack
+
+#endif
@@ -74,6 +74,7 @@ class PCA
    * rest. The parameter returned is the amount of variance of the data that
    * is retained; this is a value between 0 and 1.  For instance, a value of
    * 0.9 indicates that 90% of the variance present in the data was retained.
+   * The data is centered in place, so no copy of it is made.
    *
    * @param data Data matrix.
    * @param newDimension New dimension of the data.
@@ -95,7 +96,8 @@ class PCA
    * retained.  If the amount is 1, then all dimensions will be retained.
    *
    * The method returns the actual amount of variance retained, which will
-   * always be greater than or equal to the varRetained parameter.
+   * always be greater than or equal to the varRetained parameter.  The data is
+   * centered in place, so no copy of it is made.
    *
    * @param data Data matrix.
    * @param varRetained Lower bound on amount of variance to retain; should be
@@ -128,7 +130,7 @@ class PCA
         if (stdDev[i] == 0)
           stdDev[i] = 1e-50;
 
-      centeredData /= arma::repmat(stdDev, 1, centeredData.n_cols);
+      centeredData.each_col() /= stdDev;
     }
   }
 
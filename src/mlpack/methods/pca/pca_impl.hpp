@@ -106,14 +106,14 @@ double PCA<DecompositionPolicy>::Apply(arma::mat& data,
 
   Timer::Start("pca");
 
-  // Center the data into a temporary matrix.
-  arma::mat centeredData;
-  math::Center(data, centeredData);
+  // The data will be overwritten with the result, so center it in place
+  // instead of into a temporary matrix.
+  math::CenterInPlace(data);
 
   // Scale the data if the user ask for.
-  ScaleData(centeredData);
+  ScaleData(data);
 
-  decomposition.Apply(data, centeredData, data, eigVal, eigvec, newDimension);
+  decomposition.Apply(data, data, data, eigVal, eigvec, newDimension);
 
   if (newDimension < eigvec.n_rows)
     // Drop unnecessary rows.
@@ -154,7 +154,18 @@ double PCA<DecompositionPolicy>::Apply(arma::mat& data,
   arma::mat eigvec;
   arma::vec eigVal;
 
-  Apply(data, data, eigVal, eigvec);
+  Timer::Start("pca");
+
+  // The data will be overwritten with the result, so center it in place
+  // instead of into a temporary matrix.
+  math::CenterInPlace(data);
+
+  // Scale the data if the user ask for.
+  ScaleData(data);
+
+  decomposition.Apply(data, data, data, eigVal, eigvec, data.n_rows);
+
+  Timer::Stop("pca");
 
   // Calculate the dimension we should keep.
   size_t newDimension = 0;
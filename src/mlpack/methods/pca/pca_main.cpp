@@ -16,9 +16,11 @@
 
 #include "pca.hpp"
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_pca_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_block_krylov_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/streaming_svd_method.hpp>
 
 using namespace mlpack;
 using namespace mlpack::pca;
@@ -34,7 +36,8 @@ PROGRAM_INFO("Principal Components Analysis",
     "linear transformation determined by PCA.",
     // Long description.
     "This program performs principal components analysis on the given dataset "
-    "using the exact, randomized, randomized block Krylov, or QUIC SVD method. "
+    "using the exact, randomized, randomized block Krylov, QUIC, or streaming "
+    "SVD method, or with incremental PCA. "
     "It will transform the data onto its principal components, optionally "
     "performing dimensionality reduction by ignoring the principal components "
     "with the smallest eigenvalues."
@@ -50,7 +53,10 @@ PROGRAM_INFO("Principal Components Analysis",
     "Multiple different decomposition techniques can be used.  The method to "
     "use can be specified with the " +
     PRINT_PARAM_STRING("decomposition_method") + " parameter, and it may take "
-    "the values 'exact', 'randomized', or 'quic'."
+    "the values 'exact', 'randomized', 'randomized-block-krylov', 'quic', "
+    "'streaming', or 'incremental'.  The 'streaming' method reads the data in "
+    "a single pass over blocks of points, and the 'incremental' method updates "
+    "the principal components one mini-batch of points at a time."
     "\n\n"
     "For example, to reduce the dimensionality of the matrix " +
     PRINT_DATASET("data") + " to 5 dimensions using randomized SVD for the "
@@ -77,7 +83,7 @@ PARAM_FLAG("scale", "If set, the data will be scaled before running PCA, such "
 
 PARAM_STRING_IN("decomposition_method", "Method used for the principal "
     "components analysis: 'exact', 'randomized', 'randomized-block-krylov', "
-    "'quic'.", "c", "exact");
+    "'quic', 'streaming', 'incremental'.", "c", "exact");
 
 
 //! Run RunPCA on the specified dataset with the given decomposition method.
@@ -119,7 +125,7 @@ static void mlpackMain()
 
   // Check decomposition method validity.
   RequireParamInSet<string>("decomposition_method", { "exact", "randomized",
-      "randomized-block-krylov", "quic" }, true,
+      "randomized-block-krylov", "quic", "streaming", "incremental" }, true,
       "unknown decomposition method");
 
   // Find out what dimension we want.
@@ -162,6 +168,14 @@ static void mlpackMain()
   {
     RunPCA<QUICSVDPolicy>(dataset, newDimension, scale, varToRetain);
   }
+  else if (decompositionMethod == "streaming")
+  {
+    RunPCA<StreamingSVDPolicy>(dataset, newDimension, scale, varToRetain);
+  }
+  else if (decompositionMethod == "incremental")
+  {
+    RunPCA<IncrementalPCAPolicy>(dataset, newDimension, scale, varToRetain);
+  }
 
   // Now save the results.
   if (CLI::HasParam("output"))
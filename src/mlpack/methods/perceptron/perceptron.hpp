@@ -26,9 +26,30 @@ namespace perceptron {
  * network).  It converges if the supplied training dataset is linearly
  * separable.
  *
+ * By default the perceptron is trained online: the weights are updated after
+ * each misclassified point.  If BatchSize() is set to more than one point, the
+ * points of each mini-batch are classified with the same weights and the
+ * updates of all the misclassified points are summed before they are applied;
+ * the points of a batch are processed in parallel with OpenMP.  If Average()
+ * is set, the final model holds the average of the weights after every update
+ * step (the averaged perceptron), which generalizes better on data that is not
+ * linearly separable.  Averaging costs O(d k) time per step for k classes, so
+ * it is cheapest in mini-batch mode.
+ *
+ * @code
+ * Perceptron<> p(numClasses, data.n_rows);
+ * p.BatchSize() = 256;
+ * p.Average() = true;
+ * p.Train(data, labels, numClasses);
+ * @endcode
+ *
+ * Sparse data (arma::sp_mat) is supported; the SimpleWeightUpdate policy then
+ * only updates the weights of the nonzero dimensions of each point.
+ *
  * @tparam LearnPolicy Options of SimpleWeightUpdate and GradientDescent.
  * @tparam WeightInitializationPolicy Option of ZeroInitialization and
  *      RandomInitialization.
+ * @tparam MatType Type of data matrix (arma::mat or arma::sp_mat).
  */
 template<typename LearnPolicy = SimpleWeightUpdate,
          typename WeightInitializationPolicy = ZeroInitialization,
@@ -69,8 +90,9 @@ class Perceptron
              const size_t maxIterations = 1000);
 
   /**
-   * Alternate constructor which copies parameters from an already initiated
-   * perceptron.
+   * Alternate constructor which copies parameters (the maximum number of
+   * iterations, the batch size and the averaging setting) from an already
+   * initiated perceptron.
    *
    * @param other The other initiated Perceptron object from which we copy the
    *       values from.
@@ -91,6 +113,7 @@ class Perceptron
    * iterations (specified in the constructor or through MaxIterations()).  A
    * single iteration corresponds to a single pass through the data, so if you
    * want to pass through the dataset only once, set MaxIterations() to 1.
+   * Training stops early when no point is misclassified during an iteration.
    *
    * This training does not reset the model weights, so you can call Train() on
    * multiple datasets sequentially.
@@ -120,13 +143,23 @@ class Perceptron
    * Serialize the perceptron.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
   //! Get the maximum number of iterations.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of points in each mini-batch (1 for online training).
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each mini-batch (1 for online training).
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get whether the weights are averaged over all the update steps.
+  bool Average() const { return average; }
+  //! Modify whether the weights are averaged over all the update steps.
+  bool& Average() { return average; }
+
   //! Get the number of classes this perceptron has been trained for.
   size_t NumClasses() const { return weights.n_cols; }
 
@@ -144,6 +177,12 @@ class Perceptron
   //! The maximum number of iterations during training.
   size_t maxIterations;
 
+  //! The number of points in each mini-batch.
+  size_t batchSize;
+
+  //! Whether the weights are averaged over all the update steps.
+  bool average;
+
   /**
    * Stores the weights for each of the input class labels.  Each column
    * corresponds to the weights for one class label, and each row corresponds to
@@ -159,6 +198,26 @@ class Perceptron
 } // namespace perceptron
 } // namespace mlpack
 
+//! Set the serialization version of the Perceptron class.  Version 1 stores the
+//! batch size and the averaging setting.  BOOST_TEMPLATE_CLASS_VERSION() cannot
+//! be used here, because the template signature contains commas.
+namespace boost {
+namespace serialization {
+
+template<typename LearnPolicy,
+         typename WeightInitializationPolicy,
+         typename MatType>
+struct version<mlpack::perceptron::Perceptron<LearnPolicy,
+    WeightInitializationPolicy, MatType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 #include "perceptron_impl.hpp"
 
 #endif
@@ -30,7 +30,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const size_t numClasses,
     const size_t dimensionality,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(1),
+    average(false)
 {
   WeightInitializationPolicy wip;
   wip.Initialize(weights, biases, dimensionality, numClasses);
@@ -56,7 +58,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(1),
+    average(false)
 {
   // Start training.
   Train(data, labels, numClasses);
@@ -84,7 +88,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const arma::rowvec& instanceWeights) :
-    maxIterations(other.maxIterations)
+    maxIterations(other.maxIterations),
+    batchSize(other.batchSize),
+    average(other.average)
 {
   Train(data, labels, numClasses, instanceWeights);
 }
@@ -106,14 +112,15 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
     const MatType& test,
     arma::Row<size_t>& predictedLabels)
 {
-  arma::vec tempLabelMat;
-  arma::uword maxIndex = 0;
+  // Compute the scores of all points at once.
+  arma::mat tempLabelMat = weights.t() * test;
+  tempLabelMat.each_col() += biases;
 
-  // Could probably be faster if done in batch.
+  predictedLabels.set_size(test.n_cols);
   for (size_t i = 0; i < test.n_cols; i++)
   {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    tempLabelMat.max(maxIndex);
+    arma::uword maxIndex = 0;
+    tempLabelMat.unsafe_col(i).max(maxIndex);
     predictedLabels(0, i) = maxIndex;
   }
 }
@@ -138,23 +145,38 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
     const size_t numClasses,
     const arma::rowvec& instanceWeights)
 {
-  // Do we need to resize the weights?
-  if (weights.n_elem != numClasses)
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("Perceptron::Train(): the batch size must be "
+        "positive!");
+  }
+
+  // Do we need to resize the weights?  Otherwise we continue training from the
+  // current weights.
+  if (weights.n_rows != data.n_rows || weights.n_cols < numClasses)
   {
     WeightInitializationPolicy wip;
     wip.Initialize(weights, biases, data.n_rows, numClasses);
   }
 
-  size_t j, i = 0;
-  bool converged = false;
-  size_t tempLabel;
-  arma::uword maxIndexRow = 0, maxIndexCol = 0;
-  arma::mat tempLabelMat;
-
   LearnPolicy LP;
 
   const bool hasWeights = (instanceWeights.n_elem > 0);
 
+  // The sums of the weights after each update step, if we are averaging.
+  arma::mat weightSum;
+  arma::vec biasSum;
+  size_t steps = 0;
+  if (average)
+  {
+    weightSum.zeros(arma::size(weights));
+    biasSum.zeros(biases.n_elem);
+  }
+
+  size_t i = 0;
+  bool converged = false;
+  arma::mat scores;
+
   while ((i < maxIterations) && (!converged))
   {
     // This outer loop is for each iteration, and we use the 'converged'
@@ -162,34 +184,90 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Train(
     i++;
     converged = true;
 
-    // Now this inner loop is for going through the dataset in each iteration.
-    for (j = 0; j < data.n_cols; j++)
+    // Now this inner loop is for going through the dataset in each iteration,
+    // one batch at a time.
+    for (size_t begin = 0; begin < data.n_cols; begin += batchSize)
     {
-      // Multiply for each variable and check whether the current weight vector
-      // correctly classifies this.
-      tempLabelMat = weights.t() * data.col(j) + biases;
+      const size_t end = std::min(begin + batchSize, (size_t) data.n_cols) - 1;
+
+      // Classify all the points of the batch with the current weights.
+      scores = weights.t() * data.cols(begin, end);
+      scores.each_col() += biases;
+
+      if (begin == end)
+      {
+        arma::uword maxIndex = 0;
+        scores.unsafe_col(0).max(maxIndex);
+
+        // Check whether prediction is correct.
+        if (maxIndex != labels(0, begin))
+        {
+          // Due to incorrect prediction, convergence set to false.
+          converged = false;
+
+          // Send maxIndex for knowing which weight to update, send the point
+          // to know the value of the vector to update it with.  Send the label
+          // to know the correct class.
+          LP.UpdateWeights(data.col(begin), weights, biases, maxIndex,
+              labels(0, begin), hasWeights ? instanceWeights(begin) : 1.0);
+        }
+      }
+      else
+      {
+        // Each thread sums the updates of its misclassified points, and the
+        // sums are applied together at the end of the batch.
+        const size_t batchPoints = end - begin + 1;
+        size_t mistakes = 0;
+
+        #pragma omp parallel
+        {
+          LearnPolicy localLP(LP);
+          arma::mat localWeights(arma::size(weights), arma::fill::zeros);
+          arma::vec localBiases(biases.n_elem, arma::fill::zeros);
+          size_t localMistakes = 0;
+
+          #pragma omp for schedule(static)
+          for (omp_size_t k = 0; k < (omp_size_t) batchPoints; ++k)
+          {
+            const size_t j = begin + k;
+            arma::uword maxIndex = 0;
+            scores.unsafe_col(k).max(maxIndex);
 
-      tempLabelMat.max(maxIndexRow, maxIndexCol);
+            if (maxIndex != labels(0, j))
+            {
+              ++localMistakes;
+              localLP.UpdateWeights(data.col(j), localWeights, localBiases,
+                  maxIndex, labels(0, j),
+                  hasWeights ? instanceWeights(j) : 1.0);
+            }
+          }
 
-      // Check whether prediction is correct.
-      if (maxIndexRow != labels(0, j))
+          #pragma omp critical
+          {
+            weights += localWeights;
+            biases += localBiases;
+            mistakes += localMistakes;
+          }
+        }
+
+        if (mistakes > 0)
+          converged = false;
+      }
+
+      if (average)
       {
-        // Due to incorrect prediction, convergence set to false.
-        converged = false;
-        tempLabel = labels(0, j);
-
-        // Send maxIndexRow for knowing which weight to update, send j to know
-        // the value of the vector to update it with.  Send tempLabel to know
-        // the correct class.
-        if (hasWeights)
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow, tempLabel,
-              instanceWeights(j));
-        else
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow,
-              tempLabel);
+        weightSum += weights;
+        biasSum += biases;
+        ++steps;
       }
     }
   }
+
+  if (average && steps > 0)
+  {
+    weights = weightSum / steps;
+    biases = biasSum / steps;
+  }
 }
 
 //! Serialize the perceptron.
@@ -199,13 +277,26 @@ template<typename LearnPolicy,
 template<typename Archive>
 void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::serialize(
     Archive& ar,
-    const unsigned int /* version */)
+    const unsigned int version)
 {
-  // We just need to serialize the maximum number of iterations, the weights,
-  // and the biases.
+  // We just need to serialize the training settings, the weights, and the
+  // biases.
   ar & BOOST_SERIALIZATION_NVP(maxIterations);
   ar & BOOST_SERIALIZATION_NVP(weights);
   ar & BOOST_SERIALIZATION_NVP(biases);
+
+  // Backward compatibility: older versions of Perceptron were always trained
+  // online without averaging.
+  if (version > 0)
+  {
+    ar & BOOST_SERIALIZATION_NVP(batchSize);
+    ar & BOOST_SERIALIZATION_NVP(average);
+  }
+  else if (Archive::is_loading::value)
+  {
+    batchSize = 1;
+    average = false;
+  }
 }
 
 } // namespace perceptron
@@ -86,7 +86,6 @@ static void mlpackMain()
 
   // Load the data.
   arma::mat input = std::move(CLI::GetParam<arma::mat>("input"));
-  arma::mat output;
 
   RequireParamValue<int>("dimension", [](int x) { return x >= 0; }, true,
       "dimension to binarize must be nonnegative");
@@ -99,15 +98,15 @@ static void mlpackMain()
   Timer::Start("binarize");
   if (CLI::HasParam("dimension"))
   {
-    data::Binarize<double>(input, output, threshold, dimension);
+    data::Binarize<double>(input, threshold, dimension);
   }
   else
   {
     // Binarize the whole dataset.
-    data::Binarize<double>(input, output, threshold);
+    data::Binarize<double>(input, threshold);
   }
   Timer::Stop("binarize");
 
   if (CLI::HasParam("output"))
-    CLI::GetParam<arma::mat>("output") = std::move(output);
+    CLI::GetParam<arma::mat>("output") = std::move(input);
 }
@@ -12,6 +12,8 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/util/cli.hpp>
 #include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/core/data/dataset_statistics.hpp>
+#include <mlpack/core/data/matrix_reader.hpp>
 
 #include <boost/format.hpp>
 #include <boost/lexical_cast.hpp>
@@ -52,13 +54,28 @@ PROGRAM_INFO("Descriptive Statistics",
     "the dataset as a population, we could run"
     "\n\n" +
     PRINT_CALL("preprocess_describe", "input", "X", "width", 10, "precision", 5,
-        "verbose", true),
+        "verbose", true) +
+    "\n\n"
+    "A dataset that doesn't fit in memory can be described in one pass over "
+    "the file given with the " + PRINT_PARAM_STRING("stream_file") + " "
+    "parameter, instead of " + PRINT_PARAM_STRING("input") + "; the file is "
+    "read in batches of " + PRINT_PARAM_STRING("batch_size") + " points.  The "
+    "moments are then merged from the statistics of each batch, and the "
+    "median is estimated with a quantile sketch whose accuracy is set by the " +
+    PRINT_PARAM_STRING("sketch_size") + " parameter; its rank is off by "
+    "about 1.5% of the number of points for the default size.",
     SEE_ALSO("@preprocess_binarize", "#preprocess_binarize"),
     SEE_ALSO("@preprocess_imputer", "#preprocess_imputer"),
     SEE_ALSO("@preprocess_split", "#preprocess_split"));
 
 // Define parameters for data.
-PARAM_MATRIX_IN_REQ("input", "Matrix containing data,", "i");
+PARAM_MATRIX_IN("input", "Matrix containing data,", "i");
+PARAM_STRING_IN("stream_file", "File containing data to describe in one "
+    "streaming pass, instead of loading it.", "s", "");
+PARAM_INT_IN("batch_size", "Number of points read at a time from the "
+    "streamed file.", "b", 100000);
+PARAM_INT_IN("sketch_size", "Size of the quantile sketch used to estimate the "
+    "median of the streamed file.", "k", 200);
 PARAM_INT_IN("dimension", "Dimension of the data. Use this to specify a "
     "dimension", "d", 0);
 PARAM_INT_IN("precision", "Precision of the output statistics.", "p", 4);
@@ -70,107 +87,27 @@ PARAM_FLAG("row_major", "If specified, the program will calculate statistics "
     "across rows, not across columns.  (Remember that in mlpack, a column "
     "represents a point, so this option is generally not necessary.)", "r");
 
-/**
- * Calculates the sum of deviations to the Nth Power.
- *
- * @param input Vector that captures a dimension of a dataset.
- * @param rowMean Mean of the given vector.
- * @param n Degree of power.
- * @return sum of nth power deviations.
- */
-double SumNthPowerDeviations(const arma::rowvec& input,
-                             const double& fMean,
-                             size_t n)
-{
-  return arma::sum(arma::pow(input - fMean, static_cast<double>(n)));
-}
-
-/**
- * Calculates Skewness of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Skewness of the given vector.
- */
-double Skewness(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double skewness = 0;
-  const double S3 = pow(fStd, 3);
-  const double M3 = SumNthPowerDeviations(input, fMean, 3);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population skewness
-    skewness = M3 / (n * S3);
-  }
-  else
-  {
-    // Calculate sample skewness.
-    skewness = n * M3 / ((n - 1) * (n - 2) * S3);
-  }
-  return skewness;
-}
-
-/**
- * Calculates excess kurtosis of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Kurtosis of the given vector.
- */
-double Kurtosis(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double kurtosis = 0;
-  const double M4 = SumNthPowerDeviations(input, fMean, 4);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population excess kurtosis.
-    const double M2 = SumNthPowerDeviations(input, fMean, 2);
-    kurtosis = n * (M4 / pow(M2, 2)) - 3;
-  }
-  else
-  {
-    // Calculate sample excess kurtosis.
-    const double S4 = pow(fStd, 4);
-    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
-    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
-    const double normM = M4 / S4;
-    kurtosis = normC * normM - norm3;
-  }
-  return kurtosis;
-}
-
-/**
- * Calculates standard error of standard deviation.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @return Standard error of the stanrdard devation of the given vector.
- */
-double StandardError(const size_t size, const double& fStd)
-{
-  return fStd / sqrt(size);
-}
-
 static void mlpackMain()
 {
+  RequireOnlyOnePassed({ "input", "stream_file" }, true);
+
   const size_t dimension = static_cast<size_t>(CLI::GetParam<int>("dimension"));
   const size_t precision = static_cast<size_t>(CLI::GetParam<int>("precision"));
   const size_t width = static_cast<size_t>(CLI::GetParam<int>("width"));
   const bool population = CLI::HasParam("population");
   const bool rowMajor = CLI::HasParam("row_major");
+  const bool streaming = CLI::HasParam("stream_file");
 
-  // Load the data.
-  arma::mat& data = CLI::GetParam<arma::mat>("input");
+  if (streaming && rowMajor)
+  {
+    Log::Fatal << "Cannot specify " << PRINT_PARAM_STRING("row_major")
+        << " with " << PRINT_PARAM_STRING("stream_file") << "!" << endl;
+  }
+
+  RequireParamValue<int>("batch_size", [](int x) { return x > 0; }, true,
+      "batch size must be positive");
+  RequireParamValue<int>("sketch_size", [](int x) { return x > 1; }, true,
+      "sketch size must be at least 2");
 
   // Generate boost format recipe.
   const string widthPrecision("%-" + to_string(width) + "." +
@@ -193,50 +130,94 @@ static void mlpackMain()
       % "range" % "skew" % "kurt" % "SE" << endl;
 
   // Lambda function to print out the results.
-  auto PrintStatResults = [&](size_t dim, bool rowMajor)
+  auto PrintStatResults = [&](size_t dim,
+                              const RunningMoments& moments,
+                              const double median)
   {
-    arma::rowvec feature;
-    if (rowMajor)
-      feature = arma::conv_to<arma::rowvec>::from(data.col(dim));
-    else
-      feature = data.row(dim);
-
     // f at the front of the variable names means "feature".
-    const double fMax = arma::max(feature);
-    const double fMin = arma::min(feature);
-    const double fMean = arma::mean(feature);
-    const double fStd = arma::stddev(feature, population);
+    const double fMax = moments.Max();
+    const double fMin = moments.Min();
+    const double fStd = moments.Stddev(population);
 
     // Print statistics of the given dimension.
     Log::Info << boost::format(numberFormat)
         % dim
-        % arma::var(feature, population)
-        % fMean
+        % moments.Variance(population)
+        % moments.Mean()
         % fStd
-        % arma::median(feature)
+        % median
         % fMin
         % fMax
         % (fMax - fMin) // range
-        % Skewness(feature, fStd, fMean, population)
-        % Kurtosis(feature, fStd, fMean, population)
-        % StandardError(feature.n_elem, fStd)
+        % moments.Skewness(population)
+        % moments.Kurtosis(population)
+        % (fStd / sqrt(moments.Count())) // standard error
         << endl;
   };
 
-  // If the user specified dimension, describe statistics of the given
-  // dimension. If a dimension is not specified, describe all dimensions.
-  if (CLI::HasParam("dimension"))
+  if (streaming)
   {
-    PrintStatResults(dimension, rowMajor);
+    // Compute the statistics of all dimensions in one pass over the file.
+    const size_t batchSize = (size_t) CLI::GetParam<int>("batch_size");
+    MatrixReader reader(CLI::GetParam<string>("stream_file"));
+    DatasetStatistics statistics(reader.Dimensionality(),
+        (size_t) CLI::GetParam<int>("sketch_size"));
+
+    arma::mat batch;
+    while (reader.NextBatch(batch, batchSize))
+      statistics.Add(batch);
+
+    if (CLI::HasParam("dimension") && dimension >= statistics.Dimensionality())
+    {
+      Log::Fatal << "Dimension " << dimension << " is out of range; the data "
+          << "has " << statistics.Dimensionality() << " dimensions!" << endl;
+    }
+
+    // If the user specified dimension, describe statistics of the given
+    // dimension. If a dimension is not specified, describe all dimensions.
+    const size_t first = CLI::HasParam("dimension") ? dimension : 0;
+    const size_t last = CLI::HasParam("dimension") ? dimension + 1 :
+        statistics.Dimensionality();
+    for (size_t i = first; i < last; ++i)
+    {
+      PrintStatResults(i, statistics.Moments(i),
+          statistics.Quantiles(i).Quantile(0.5));
+    }
   }
   else
   {
-    const size_t dimensions = rowMajor ? data.n_cols : data.n_rows;
-    for (size_t i = 0; i < dimensions; ++i)
+    // Load the data.
+    arma::mat& data = CLI::GetParam<arma::mat>("input");
+
+    auto DescribeDimension = [&](size_t dim)
+    {
+      arma::rowvec feature;
+      if (rowMajor)
+        feature = arma::conv_to<arma::rowvec>::from(data.col(dim));
+      else
+        feature = data.row(dim);
+
+      RunningMoments moments;
+      for (size_t i = 0; i < feature.n_elem; ++i)
+        moments.Add(feature[i]);
+
+      PrintStatResults(dim, moments, arma::median(feature));
+    };
+
+    // If the user specified dimension, describe statistics of the given
+    // dimension. If a dimension is not specified, describe all dimensions.
+    if (CLI::HasParam("dimension"))
+    {
+      DescribeDimension(dimension);
+    }
+    else
     {
-      PrintStatResults(i, rowMajor);
+      const size_t dimensions = rowMajor ? data.n_cols : data.n_rows;
+      for (size_t i = 0; i < dimensions; ++i)
+      {
+        DescribeDimension(i);
+      }
     }
   }
   Timer::Stop("statistics");
 }
-
@@ -13,6 +13,7 @@
 #include "radical.hpp"
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
+#include <mlpack/core/math/random.hpp>
 
 using namespace std;
 using namespace arma;
@@ -45,7 +46,8 @@ void Radical::CopyAndPerturb(mat& xNew, const mat& x) const
 
 double Radical::Vasicek(vec& z) const
 {
-  z = sort(z);
+  // Sort in place, so that the caller's buffer is reused instead of copied.
+  std::sort(z.begin(), z.end());
 
   // Apparently slower.
   /*
@@ -70,26 +72,34 @@ double Radical::DoRadical2D(const mat& matX)
 {
   CopyAndPerturb(perturbed, matX);
 
-  mat::fixed<2, 2> matJacobi;
+  return OptimalAngle(perturbed);
+}
 
+double Radical::OptimalAngle(const mat& perturbedX) const
+{
   vec values(angles);
 
-  for (size_t i = 0; i < angles; i++)
+  // Each angle is independent, so the angles are swept in parallel.  Each
+  // thread rotates the points into its own buffers, which are then sorted in
+  // place by Vasicek().
+  #pragma omp parallel
   {
-    const double theta = (i / (double) angles) * M_PI / 2.0;
-    const double cosTheta = cos(theta);
-    const double sinTheta = sin(theta);
+    vec candidateY1(perturbedX.n_rows);
+    vec candidateY2(perturbedX.n_rows);
 
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
+    #pragma omp for
+    for (omp_size_t i = 0; i < (omp_size_t) angles; i++)
+    {
+      const double theta = (i / (double) angles) * M_PI / 2.0;
+      const double cosTheta = cos(theta);
+      const double sinTheta = sin(theta);
 
-    candidate = perturbed * matJacobi;
-    vec candidateY1 = candidate.unsafe_col(0);
-    vec candidateY2 = candidate.unsafe_col(1);
+      // This is perturbed * [cos(theta) sin(theta); -sin(theta) cos(theta)].
+      candidateY1 = cosTheta * perturbedX.col(0) - sinTheta * perturbedX.col(1);
+      candidateY2 = sinTheta * perturbedX.col(0) + cosTheta * perturbedX.col(1);
 
-    values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+      values(i) = Vasicek(candidateY1) + Vasicek(candidateY2);
+    }
   }
 
   uword indOpt = 0;
@@ -97,6 +107,20 @@ double Radical::DoRadical2D(const mat& matX)
   return (indOpt / (double) angles) * M_PI / 2.0;
 }
 
+/**
+ * Apply the Jacobi rotation by the given angle to columns i and j of the given
+ * matrix; this is x * J, where J is the identity except for the 2x2 rotation
+ * in rows and columns i and j.
+ */
+static void Rotate(mat& x, const size_t i, const size_t j, const double theta)
+{
+  const double cosTheta = cos(theta);
+  const double sinTheta = sin(theta);
+
+  const vec colI = x.col(i);
+  x.col(i) = cosTheta * colI - sinTheta * x.col(j);
+  x.col(j) = sinTheta * colI + cosTheta * x.col(j);
+}
 
 void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
 {
@@ -132,42 +156,70 @@ void Radical::DoRadical(const mat& matXT, mat& matY, mat& matW)
   Timer::Start("radical_do_radical");
   matW = matWhitening;
 
-  mat matYSubspace(nPoints, 2);
-
-  mat matJ = eye(nDims, nDims);
+  // Each sweep visits every pair of dimensions once, in the rounds of a
+  // round-robin schedule; the pairs of a round are disjoint, so their
+  // rotations touch different columns and the pairs are processed in
+  // parallel.  With an odd number of dimensions, a dummy dimension is added to
+  // the schedule, and pairs with it are skipped.
+  const size_t nPlayers = nDims + (nDims % 2);
+  std::vector<std::pair<size_t, size_t>> pairs;
+  std::vector<int> seeds;
 
   for (size_t sweepNum = 0; sweepNum < sweeps; sweepNum++)
   {
     Log::Info << "RADICAL: sweep " << sweepNum << "." << std::endl;
 
-    for (size_t i = 0; i < nDims - 1; i++)
+    for (size_t round = 0; round + 1 < nPlayers; round++)
     {
-      for (size_t j = i + 1; j < nDims; j++)
+      pairs.clear();
+      for (size_t k = 0; k < nPlayers / 2; k++)
       {
-        Log::Debug << "RADICAL 2D on dimensions " << i << " and " << j << "."
-            << std::endl;
-
-        matYSubspace.col(0) = matY.col(i);
-        matYSubspace.col(1) = matY.col(j);
-
-        const double thetaOpt = DoRadical2D(matYSubspace);
-
-        const double cosThetaOpt = cos(thetaOpt);
-        const double sinThetaOpt = sin(thetaOpt);
+        const size_t a = (k == 0) ? nPlayers - 1 :
+            (round + k) % (nPlayers - 1);
+        const size_t b = (round + nPlayers - 1 - k) % (nPlayers - 1);
+        if (a < nDims && b < nDims)
+          pairs.push_back(std::make_pair(std::min(a, b), std::max(a, b)));
+      }
 
-        // Set elements of transformation matrix.
-        matJ(i, i) = cosThetaOpt;
-        matJ(j, i) = -sinThetaOpt;
-        matJ(i, j) = sinThetaOpt;
-        matJ(j, j) = cosThetaOpt;
+      Log::Debug << "RADICAL 2D on " << pairs.size() << " pairs of dimensions "
+          << "in round " << round << "." << std::endl;
 
-        matY *= matJ;
+      // The perturbations of each pair are generated with their own random
+      // number generator, seeded here so that the results do not depend on
+      // the number of threads.
+      seeds.resize(pairs.size());
+      for (size_t p = 0; p < pairs.size(); p++)
+        seeds[p] = math::RandInt(std::numeric_limits<int>::max());
 
-        // Unset elements of transformation matrix, so matJ = eye() again.
-        matJ(i, i) = 1;
-        matJ(j, i) = 0;
-        matJ(i, j) = 0;
-        matJ(j, j) = 1;
+      #pragma omp parallel for schedule(dynamic) if (pairs.size() > 1)
+      for (omp_size_t p = 0; p < (omp_size_t) pairs.size(); p++)
+      {
+        const size_t i = pairs[p].first;
+        const size_t j = pairs[p].second;
+
+        // This is CopyAndPerturb() on columns i and j of matY.
+        std::mt19937 generator(seeds[p]);
+        std::normal_distribution<double> noise;
+        mat pairPerturbed(replicates * nPoints, 2);
+        for (size_t c = 0; c < 2; c++)
+        {
+          const vec column = matY.col((c == 0) ? i : j);
+          for (size_t r = 0; r < replicates; r++)
+          {
+            for (size_t q = 0; q < nPoints; q++)
+            {
+              pairPerturbed(r * nPoints + q, c) = column(q) + noiseStdDev *
+                  noise(generator);
+            }
+          }
+        }
+
+        const double thetaOpt = OptimalAngle(pairPerturbed);
+
+        // Rotate the components, and accumulate the rotation in the unmixing
+        // matrix.
+        Rotate(matY, i, j, thetaOpt);
+        Rotate(matW, i, j, thetaOpt);
       }
     }
   }
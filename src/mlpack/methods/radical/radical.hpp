@@ -131,8 +131,15 @@ class Radical
 
   //! Internal matrix, held as member variable to prevent memory reallocations.
   arma::mat perturbed;
-  //! Internal matrix, held as member variable to prevent memory reallocations.
-  arma::mat candidate;
+
+  /**
+   * Find the rotation angle of the given two-dimensional perturbed data that
+   * minimizes the sum of the entropy estimates of the two rotated dimensions.
+   * The angles are swept in parallel.
+   *
+   * @param perturbedX Perturbed replicates of the two-dimensional data.
+   */
+  double OptimalAngle(const arma::mat& perturbedX) const;
 };
 
 void WhitenFeatureMajorMatrix(const arma::mat& matX,
@@ -35,18 +35,66 @@ void Bootstrap(const MatType& dataset,
   if (UseWeights)
     bootstrapWeights.set_size(weights.n_elem);
 
-  // Random sampling with replacement.
-  arma::uvec indices = arma::randi<arma::uvec>(dataset.n_cols,
-      arma::distr_param(0, dataset.n_cols - 1));
+  // Random sampling with replacement.  math::RandInt() is used instead of
+  // arma::randi() so that a RandomStream or the thread's generator is used
+  // when trees are built in parallel.
   for (size_t i = 0; i < dataset.n_cols; ++i)
   {
-    bootstrapDataset.col(i) = dataset.col(indices[i]);
-    bootstrapLabels[i] = labels[indices[i]];
+    const size_t index = math::RandInt(dataset.n_cols);
+    bootstrapDataset.col(i) = dataset.col(index);
+    bootstrapLabels[i] = labels[index];
     if (UseWeights)
-      bootstrapWeights[i] = weights[indices[i]];
+      bootstrapWeights[i] = weights[index];
   }
 }
 
+/**
+ * Create a bootstrap sample of the points of a dataset with the given number of
+ * points, without copying the dataset: only the indices of the sampled points
+ * (which may repeat), and their labels and weights, are returned.
+ */
+template<bool UseWeights,
+         typename LabelsType,
+         typename WeightsType>
+void BootstrapIndices(const size_t numPoints,
+                      const LabelsType& labels,
+                      const WeightsType& weights,
+                      arma::uvec& bootstrapIndices,
+                      LabelsType& bootstrapLabels,
+                      WeightsType& bootstrapWeights)
+{
+  bootstrapLabels.set_size(numPoints);
+  if (UseWeights)
+    bootstrapWeights.set_size(numPoints);
+
+  // Random sampling with replacement.
+  bootstrapIndices.set_size(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    bootstrapIndices[i] = math::RandInt(numPoints);
+    bootstrapLabels[i] = labels[bootstrapIndices[i]];
+    if (UseWeights)
+      bootstrapWeights[i] = weights[bootstrapIndices[i]];
+  }
+}
+
+/**
+ * Find the points of a dataset with the given number of points that are not in
+ * the given bootstrap sample (the out-of-bag points).  The indices of these
+ * points are stored in increasing order in oobIndices.
+ */
+inline void OutOfBagIndices(const size_t numPoints,
+                            const arma::uvec& bootstrapIndices,
+                            arma::uvec& oobIndices)
+{
+  // Count how many times each point was sampled.
+  arma::Col<size_t> multiplicities(numPoints, arma::fill::zeros);
+  for (size_t i = 0; i < bootstrapIndices.n_elem; ++i)
+    ++multiplicities[bootstrapIndices[i]];
+
+  oobIndices = arma::find(multiplicities == 0);
+}
+
 } // namespace tree
 } // namespace mlpack
 
@@ -0,0 +1,88 @@
+/**
+ * @file flat_forest.cpp
+ *
+ * Implementation of classification with the FlatForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "flat_forest.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+
+size_t FlatForest::Classify(const arma::vec& point) const
+{
+  if (roots.n_elem == 0)
+  {
+    throw std::invalid_argument("FlatForest::Classify(): no trees in the "
+        "model!");
+  }
+
+  arma::vec probabilities(numClasses, arma::fill::zeros);
+  for (size_t t = 0; t < roots.n_elem; ++t)
+    probabilities += leafProbabilities.col(Leaf(point.memptr(), roots[t]));
+
+  // The tree probabilities don't need to be averaged to find the maximum.
+  arma::uword maxIndex = 0;
+  probabilities.max(maxIndex);
+  return (size_t) maxIndex;
+}
+
+void FlatForest::Classify(const arma::mat& data,
+                          arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+void FlatForest::Classify(const arma::mat& data,
+                          arma::Row<size_t>& predictions,
+                          arma::mat& probabilities) const
+{
+  if (roots.n_elem == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("FlatForest::Classify(): no trees in the "
+        "model!");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.zeros(numClasses, data.n_cols);
+
+  // Evaluate every tree on a whole block of points before moving on to the
+  // next tree, so that the nodes near the root stay in cache.
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for
+  for (omp_size_t block = 0; block < (omp_size_t) numBlocks; ++block)
+  {
+    const size_t begin = block * BlockSize;
+    const size_t end = (begin + BlockSize < data.n_cols) ?
+        begin + BlockSize : data.n_cols;
+
+    for (size_t t = 0; t < roots.n_elem; ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        const size_t leaf = Leaf(data.colptr(i), roots[t]);
+        const double* leafProbs = leafProbabilities.colptr(leaf);
+        double* probs = probabilities.colptr(i);
+        for (size_t c = 0; c < numClasses; ++c)
+          probs[c] += leafProbs[c];
+      }
+    }
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      probabilities.col(i) /= roots.n_elem;
+
+      arma::uword maxIndex = 0;
+      probabilities.col(i).max(maxIndex);
+      predictions[i] = (size_t) maxIndex;
+    }
+  }
+}
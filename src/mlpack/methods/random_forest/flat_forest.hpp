@@ -0,0 +1,183 @@
+/**
+ * @file flat_forest.hpp
+ *
+ * Definition of the FlatForest class, a compact representation of a trained
+ * DecisionTree or RandomForest that is only used for classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/decision_tree.hpp>
+#include "random_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+/**
+ * The FlatForest class holds the nodes of one or more trained decision trees in
+ * flat arrays, for fast classification.  Each node is described by its split
+ * dimension, split type, threshold and the index of its first child; the
+ * children of a node are stored consecutively, so no pointers have to be
+ * followed.  The class probabilities of all leaves are stored in the columns of
+ * a single matrix.
+ *
+ * When a set of points is classified, the points are processed in blocks, and
+ * each tree is evaluated on all of the points of a block before moving to the
+ * next tree, so the top levels of each tree stay in cache.  Blocks are
+ * classified in parallel with OpenMP.
+ *
+ * A FlatForest gives the same predictions as the DecisionTree or RandomForest
+ * it was built from.  Only trees using BestBinaryNumericSplit or
+ * HistogramNumericSplit for numeric dimensions and AllCategoricalSplit for
+ * categorical dimensions are supported, and the model can not be trained
+ * further.
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses, 50);
+ * FlatForest flat(rf);
+ * flat.Classify(testData, predictions);
+ * @endcode
+ */
+class FlatForest
+{
+ public:
+  //! The number of points classified together in a block.
+  static const size_t BlockSize = 64;
+
+  /**
+   * Create an empty FlatForest.  Classify() will throw an exception until a
+   * model is loaded.
+   */
+  FlatForest() : numClasses(0) { }
+
+  /**
+   * Flatten the given decision tree.
+   *
+   * @param tree Trained decision tree.
+   */
+  template<typename FitnessFunction,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename DimensionSelectionType,
+           typename ElemType,
+           bool NoRecursion>
+  FlatForest(const DecisionTree<FitnessFunction, NumericSplitType,
+      CategoricalSplitType, DimensionSelectionType, ElemType, NoRecursion>&
+      tree);
+
+  /**
+   * Flatten all of the trees of the given random forest.
+   *
+   * @param forest Trained random forest.
+   */
+  template<typename FitnessFunction,
+           typename DimensionSelectionType,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename ElemType>
+  FlatForest(const RandomForest<FitnessFunction, DimensionSelectionType,
+      NumericSplitType, CategoricalSplitType, ElemType>& forest);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to be classified.
+   */
+  size_t Classify(const arma::vec& point) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  void Classify(const arma::mat& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * predicted class probabilities (averaged over all trees) for each point.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  void Classify(const arma::mat& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.n_elem; }
+  //! Get the total number of nodes in all trees.
+  size_t NumNodes() const { return children.n_elem; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  /**
+   * Serialize the model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  /**
+   * Append the nodes of the given tree to the arrays, in breadth-first order.
+   */
+  template<typename FitnessFunction,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename DimensionSelectionType,
+           typename ElemType,
+           bool NoRecursion>
+  void AddTree(const DecisionTree<FitnessFunction, NumericSplitType,
+      CategoricalSplitType, DimensionSelectionType, ElemType, NoRecursion>&
+      tree);
+
+  /**
+   * Return the index of the leaf of the tree with the given root that the
+   * given point falls into.
+   */
+  size_t Leaf(const double* point, const size_t root) const
+  {
+    size_t node = root;
+    while (children[node] != 0)
+    {
+      const double value = point[dimensions[node]];
+      if (dimensionTypes[node] == (size_t) data::Datatype::categorical)
+        node = children[node] + (size_t) value;
+      else
+        node = children[node] + ((value <= thresholds[node]) ? 0 : 1);
+    }
+
+    return dimensions[node];
+  }
+
+  //! The index of the root node of each tree.
+  arma::Col<size_t> roots;
+  //! The split dimension of each node, or the index of the leaf column in
+  //! leafProbabilities for leaves.
+  arma::Col<size_t> dimensions;
+  //! The type of the split dimension of each node.
+  arma::Col<size_t> dimensionTypes;
+  //! The split threshold of each numeric node.
+  arma::vec thresholds;
+  //! The index of the first child of each node, or 0 for leaves.
+  arma::Col<size_t> children;
+  //! The class probabilities of each leaf.
+  arma::mat leafProbabilities;
+  //! The number of classes.
+  size_t numClasses;
+};
+
+} // namespace tree
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file flat_forest_impl.hpp
+ *
+ * Implementation of the templated functions of the FlatForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_forest.hpp"
+
+namespace mlpack {
+namespace tree {
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+FlatForest::FlatForest(const DecisionTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DimensionSelectionType, ElemType, NoRecursion>&
+    tree) :
+    numClasses(tree.NumClasses())
+{
+  AddTree(tree);
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+FlatForest::FlatForest(const RandomForest<FitnessFunction,
+    DimensionSelectionType, NumericSplitType, CategoricalSplitType, ElemType>&
+    forest) :
+    numClasses(forest.NumTrees() > 0 ? forest.Tree(0).NumClasses() : 0)
+{
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    AddTree(forest.Tree(i));
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         typename ElemType,
+         bool NoRecursion>
+void FlatForest::AddTree(const DecisionTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType, DimensionSelectionType, ElemType, NoRecursion>&
+    tree)
+{
+  static_assert(std::is_same<NumericSplitType<FitnessFunction>,
+      BestBinaryNumericSplit<FitnessFunction>>::value ||
+      std::is_same<NumericSplitType<FitnessFunction>,
+      HistogramNumericSplit<FitnessFunction>>::value,
+      "FlatForest only supports BestBinaryNumericSplit and "
+      "HistogramNumericSplit numeric splits.");
+  static_assert(std::is_same<CategoricalSplitType<FitnessFunction>,
+      AllCategoricalSplit<FitnessFunction>>::value,
+      "FlatForest only supports AllCategoricalSplit categorical splits.");
+
+  typedef DecisionTree<FitnessFunction, NumericSplitType, CategoricalSplitType,
+      DimensionSelectionType, ElemType, NoRecursion> TreeType;
+
+  // Collect the nodes in breadth-first order, so that the children of each
+  // node are consecutive, and find the position of the first child of each
+  // node (0 for leaves, since the root is never a child).
+  std::vector<const TreeType*> nodes(1, &tree);
+  std::vector<size_t> firstChildren;
+  size_t numLeaves = 0;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    const TreeType* node = nodes[i];
+    if (node->NumChildren() == 0)
+    {
+      firstChildren.push_back(0);
+      ++numLeaves;
+    }
+    else
+    {
+      firstChildren.push_back(nodes.size());
+    }
+
+    for (size_t c = 0; c < node->NumChildren(); ++c)
+      nodes.push_back(&node->Child(c));
+  }
+
+  // Append the nodes to the arrays.
+  const size_t offset = children.n_elem;
+  const size_t leafOffset = leafProbabilities.n_cols;
+  roots.resize(roots.n_elem + 1);
+  roots[roots.n_elem - 1] = offset;
+  dimensions.resize(offset + nodes.size());
+  dimensionTypes.resize(offset + nodes.size());
+  thresholds.resize(offset + nodes.size());
+  children.resize(offset + nodes.size());
+  leafProbabilities.resize(numClasses, leafOffset + numLeaves);
+
+  size_t leaf = leafOffset;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    const TreeType* node = nodes[i];
+    if (node->NumChildren() == 0)
+    {
+      dimensions[offset + i] = leaf;
+      dimensionTypes[offset + i] = (size_t) data::Datatype::numeric;
+      thresholds[offset + i] = 0.0;
+      children[offset + i] = 0;
+      leafProbabilities.col(leaf) = node->ClassProbabilities();
+      ++leaf;
+    }
+    else
+    {
+      dimensions[offset + i] = node->SplitDimension();
+      dimensionTypes[offset + i] = (size_t) node->SplitType();
+      thresholds[offset + i] =
+          (node->SplitType() == data::Datatype::numeric) ?
+          node->ClassProbabilities()[0] : 0.0;
+      children[offset + i] = offset + firstChildren[i];
+    }
+  }
+}
+
+template<typename Archive>
+void FlatForest::serialize(Archive& ar, const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(roots);
+  ar & BOOST_SERIALIZATION_NVP(dimensions);
+  ar & BOOST_SERIALIZATION_NVP(dimensionTypes);
+  ar & BOOST_SERIALIZATION_NVP(thresholds);
+  ar & BOOST_SERIALIZATION_NVP(children);
+  ar & BOOST_SERIALIZATION_NVP(leafProbabilities);
+  ar & BOOST_SERIALIZATION_NVP(numClasses);
+}
+
+} // namespace tree
+} // namespace mlpack
+
+#endif
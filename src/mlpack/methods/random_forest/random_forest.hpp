@@ -35,7 +35,7 @@ class RandomForest
    * Construct the random forest without any training or specifying the number
    * of trees.  Predict() will throw an exception until Train() is called.
    */
-  RandomForest() { }
+  RandomForest() : oobError(0.0) { }
 
   /**
    * Create a random forest, training on the given labeled training data with
@@ -261,11 +261,21 @@ class RandomForest
   //! Get the number of trees in the forest.
   size_t NumTrees() const { return trees.size(); }
 
+  /**
+   * Get the out-of-bag error estimate of the last call to Train(): the
+   * (weighted) fraction of training points that are misclassified by the trees
+   * whose bootstrap samples do not contain them.  Points that are in the
+   * bootstrap sample of every tree are ignored.  The estimate is computed
+   * during training, so neither the bootstrap samples nor the training data
+   * have to be kept.
+   */
+  double OOBError() const { return oobError; }
+
   /**
    * Serialize the random forest.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const unsigned int /* version */);
+  void serialize(Archive& ar, const unsigned int version);
 
  private:
   /**
@@ -296,11 +306,35 @@ class RandomForest
 
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
+  //! The out-of-bag error estimate of the last training.
+  double oobError;
 };
 
 } // namespace tree
 } // namespace mlpack
 
+//! Set the serialization version of the RandomForest class.  Version 1 stores
+//! the out-of-bag error.  BOOST_TEMPLATE_CLASS_VERSION() cannot be used here,
+//! because the template signature contains commas.
+namespace boost {
+namespace serialization {
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename ElemType>
+struct version<mlpack::tree::RandomForest<FitnessFunction,
+    DimensionSelectionType, NumericSplitType, CategoricalSplitType, ElemType>>
+{
+  typedef mpl::int_<1> type;
+  typedef mpl::integral_c_tag tag;
+  BOOST_STATIC_CONSTANT(int, value = version::type::value);
+};
+
+} // namespace serialization
+} // namespace boost
+
 // Include implementation.
 #include "random_forest_impl.hpp"
 
@@ -390,7 +390,7 @@ void RandomForest<
     NumericSplitType,
     CategoricalSplitType,
     ElemType
->::serialize(Archive& ar, const unsigned int /* version */)
+>::serialize(Archive& ar, const unsigned int version)
 {
   size_t numTrees;
   if (Archive::is_loading::value)
@@ -405,6 +405,12 @@ void RandomForest<
     trees.resize(numTrees);
 
   ar & BOOST_SERIALIZATION_NVP(trees);
+
+  // Older versions did not store the out-of-bag error.
+  if (version > 0)
+    ar & BOOST_SERIALIZATION_NVP(oobError);
+  else if (Archive::is_loading::value)
+    oobError = 0.0;
 }
 
 template<
@@ -433,42 +439,80 @@ double RandomForest<
   trees.resize(numTrees); // This will fill the vector with untrained trees.
   double avgGain = 0.0;
 
-  #pragma omp parallel for reduction( + : avgGain)
+  // The summed out-of-bag class probabilities of each point.
+  arma::mat oobProbabilities(numClasses, dataset.n_cols, arma::fill::zeros);
+
+  // Each tree has its own random stream, so the bootstrap sample of each tree
+  // only depends on the random seed, not on which thread builds the tree.
+  std::vector<std::mt19937::result_type> seeds(numTrees);
+  for (size_t i = 0; i < numTrees; ++i)
+    seeds[i] = math::randGen();
+
+  // Large nodes of each tree are built with OpenMP tasks, so threads that have
+  // no tree left to build help with the trees that are still in progress.
+  #pragma omp parallel for schedule(dynamic) reduction( + : avgGain)
   for (omp_size_t i = 0; i < numTrees; ++i)
   {
-    MatType bootstrapDataset;
+    math::RandomStream stream(seeds[i]);
+
+    // Only the indices, labels and weights of the bootstrap sample are stored;
+    // the trees are built directly on the shared dataset.
+    arma::uvec bootstrapIndices;
     arma::Row<size_t> bootstrapLabels;
     arma::rowvec bootstrapWeights;
-    Bootstrap<UseWeights>(dataset, labels, weights, bootstrapDataset,
-        bootstrapLabels, bootstrapWeights);
+    BootstrapIndices<UseWeights>(dataset.n_cols, labels, weights,
+        bootstrapIndices, bootstrapLabels, bootstrapWeights);
 
     // Now build the decision tree.
-    if (UseWeights)
+    if (UseDatasetInfo)
     {
-      if (UseDatasetInfo)
-      {
-        avgGain += trees[i].Train(dataset, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize);
-      }
-      else
-      {
-        avgGain += trees[i].Train(dataset, labels, numClasses, weights,
-            minimumLeafSize);
-      }
+      avgGain += trees[i].template Train<UseWeights>(dataset, bootstrapIndices,
+          0, dataset.n_cols, datasetInfo, bootstrapLabels, numClasses,
+          bootstrapWeights, minimumLeafSize);
     }
     else
     {
-      if (UseDatasetInfo)
-      {
-        avgGain += trees[i].Train(dataset, datasetInfo, labels, numClasses,
-            minimumLeafSize);
-      }
-      else
-      {
-        avgGain += trees[i].Train(dataset, labels, numClasses, minimumLeafSize);
-      }
+      avgGain += trees[i].template Train<UseWeights>(dataset, bootstrapIndices,
+          0, dataset.n_cols, bootstrapLabels, numClasses, bootstrapWeights,
+          minimumLeafSize);
+    }
+
+    // Classify the points that are not in the bootstrap sample, for the
+    // out-of-bag error estimate.
+    arma::uvec oobIndices;
+    OutOfBagIndices(dataset.n_cols, bootstrapIndices, oobIndices);
+    arma::mat treeProbabilities(numClasses, oobIndices.n_elem);
+    for (size_t j = 0; j < oobIndices.n_elem; ++j)
+    {
+      size_t prediction;
+      arma::vec probabilities = treeProbabilities.unsafe_col(j);
+      trees[i].Classify(dataset.col(oobIndices[j]), prediction, probabilities);
+    }
+
+    #pragma omp critical
+    {
+      for (size_t j = 0; j < oobIndices.n_elem; ++j)
+        oobProbabilities.col(oobIndices[j]) += treeProbabilities.col(j);
     }
   }
+
+  // Compute the out-of-bag error from the summed probabilities of each point.
+  double oobWrong = 0.0, oobTotal = 0.0;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    // Skip points that were in the bootstrap sample of every tree.
+    if (arma::accu(oobProbabilities.col(i)) == 0.0)
+      continue;
+
+    const double weight = UseWeights ? weights[i] : 1.0;
+    oobTotal += weight;
+    arma::uword maxIndex = 0;
+    oobProbabilities.col(i).max(maxIndex);
+    if (maxIndex != labels[i])
+      oobWrong += weight;
+  }
+  oobError = (oobTotal > 0.0) ? oobWrong / oobTotal : 0.0;
+
   return avgGain / numTrees;
 }
 
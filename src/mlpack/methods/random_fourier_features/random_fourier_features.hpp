@@ -0,0 +1,126 @@
+/**
+ * @file random_fourier_features.hpp
+ *
+ * Random Fourier features, an explicit feature map whose inner products
+ * approximate a shift-invariant kernel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_HPP
+#define MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+#include <mlpack/core/kernels/cauchy_kernel.hpp>
+
+namespace mlpack {
+namespace kernel {
+
+/**
+ * Random Fourier features map points into a D-dimensional feature space, such
+ * that the inner product of the features of two points approximates the value
+ * of a shift-invariant kernel between them:
+ *
+ * @f[
+ * z(x) = \sqrt{2 / D} \cos(\Omega x + b), \qquad z(x)^T z(y) \approx K(x, y),
+ * @f]
+ *
+ * where the rows of @f$ \Omega @f$ are drawn from the Fourier transform of the
+ * kernel and the elements of b are drawn uniformly from @f$ [0, 2\pi) @f$.
+ * The error of the approximation decreases as @f$ O(1 / \sqrt{D}) @f$.  For
+ * more details, see the following paper:
+ *
+ * @code
+ * @inproceedings{rahimi2008random,
+ *   title={Random features for large-scale kernel machines},
+ *   author={Rahimi, Ali and Recht, Benjamin},
+ *   booktitle={Advances in Neural Information Processing Systems},
+ *   pages={1177--1184},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Mapping n points costs one matrix multiplication and nD cosines, so no
+ * kernel matrix is ever formed.  Because the map is explicit, the features can
+ * be used as the input of any linear method (for instance, linear regression
+ * or logistic regression) to approximate its kernelized version, and the same
+ * map can be applied to new points later.
+ *
+ * The supported kernels are GaussianKernel, LaplacianKernel and CauchyKernel.
+ *
+ * @tparam KernelType Shift-invariant kernel to approximate.
+ */
+template<typename KernelType>
+class RandomFourierFeatures
+{
+ public:
+  /**
+   * Create the feature map for points of the given dimensionality, drawing
+   * the random frequencies and offsets.  Use math::RandomSeed() to get the
+   * same map again.
+   *
+   * @param dimensionality Dimensionality of the points.
+   * @param numFeatures Number of features (D).
+   * @param kernel Kernel to approximate.
+   */
+  RandomFourierFeatures(const size_t dimensionality,
+                        const size_t numFeatures,
+                        const KernelType& kernel = KernelType());
+
+  /**
+   * Create an empty feature map, which can be loaded with serialize().
+   */
+  RandomFourierFeatures() { }
+
+  /**
+   * Compute the features of the given points, with one column of features for
+   * each point.  The columns are computed in parallel.
+   *
+   * @param data Points to map, with one column for each point.
+   * @param features Matrix to store the features into.
+   */
+  void Transform(const arma::mat& data, arma::mat& features) const;
+
+  //! Get the random frequencies, with one row for each feature.
+  const arma::mat& Frequencies() const { return frequencies; }
+  //! Get the random offsets, with one element for each feature.
+  const arma::vec& Offsets() const { return offsets; }
+  //! Get the number of features.
+  size_t NumFeatures() const { return frequencies.n_rows; }
+  //! Get the dimensionality of the points.
+  size_t Dimensionality() const { return frequencies.n_cols; }
+
+  /**
+   * Serialize the feature map.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */);
+
+ private:
+  //! Draw frequencies from the Fourier transform of the Gaussian kernel.
+  static void SampleFrequencies(const GaussianKernel& kernel,
+                                arma::mat& frequencies);
+  //! Draw frequencies from the Fourier transform of the Laplacian kernel.
+  static void SampleFrequencies(const LaplacianKernel& kernel,
+                                arma::mat& frequencies);
+  //! Draw frequencies from the Fourier transform of the Cauchy kernel.
+  static void SampleFrequencies(const CauchyKernel& kernel,
+                                arma::mat& frequencies);
+
+  //! The random frequencies, with one row for each feature.
+  arma::mat frequencies;
+  //! The random offsets.
+  arma::vec offsets;
+};
+
+} // namespace kernel
+} // namespace mlpack
+
+// Include implementation.
+#include "random_fourier_features_impl.hpp"
+
+#endif
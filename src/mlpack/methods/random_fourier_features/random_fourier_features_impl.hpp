@@ -0,0 +1,108 @@
+/**
+ * @file random_fourier_features_impl.hpp
+ *
+ * Implementation of random Fourier features.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOURIER_FEATURES_RANDOM_FOURIER_FEATURES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "random_fourier_features.hpp"
+
+namespace mlpack {
+namespace kernel {
+
+template<typename KernelType>
+RandomFourierFeatures<KernelType>::RandomFourierFeatures(
+    const size_t dimensionality,
+    const size_t numFeatures,
+    const KernelType& kernel) :
+    frequencies(numFeatures, dimensionality)
+{
+  SampleFrequencies(kernel, frequencies);
+  offsets = 2 * M_PI * arma::randu<arma::vec>(numFeatures);
+}
+
+template<typename KernelType>
+void RandomFourierFeatures<KernelType>::Transform(const arma::mat& data,
+                                                  arma::mat& features) const
+{
+  if (data.n_rows != frequencies.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "RandomFourierFeatures::Transform(): dimensionality of points ("
+        << data.n_rows << ") does not match dimensionality of feature map ("
+        << frequencies.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  features = frequencies * data;
+
+  const double scale = std::sqrt(2.0 / frequencies.n_rows);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) features.n_cols; ++i)
+  {
+    double* column = features.colptr(i);
+    for (size_t j = 0; j < features.n_rows; ++j)
+      column[j] = scale * std::cos(column[j] + offsets[j]);
+  }
+}
+
+template<typename KernelType>
+template<typename Archive>
+void RandomFourierFeatures<KernelType>::serialize(
+    Archive& ar,
+    const unsigned int /* version */)
+{
+  ar & BOOST_SERIALIZATION_NVP(frequencies);
+  ar & BOOST_SERIALIZATION_NVP(offsets);
+}
+
+template<typename KernelType>
+void RandomFourierFeatures<KernelType>::SampleFrequencies(
+    const GaussianKernel& kernel,
+    arma::mat& frequencies)
+{
+  // The Fourier transform of exp(-|| x ||^2 / (2 sigma^2)) is a Gaussian with
+  // variance 1 / sigma^2.
+  frequencies.randn();
+  frequencies /= kernel.Bandwidth();
+}
+
+template<typename KernelType>
+void RandomFourierFeatures<KernelType>::SampleFrequencies(
+    const LaplacianKernel& kernel,
+    arma::mat& frequencies)
+{
+  // The Fourier transform of exp(-|| x || / sigma) is a multivariate Cauchy
+  // distribution with scale 1 / sigma, which is a Gaussian divided by the
+  // absolute value of an independent standard normal variable.
+  frequencies.randn();
+  const arma::vec scales = arma::abs(arma::randn<arma::vec>(frequencies.n_rows))
+      * kernel.Bandwidth();
+  frequencies.each_col() /= scales;
+}
+
+template<typename KernelType>
+void RandomFourierFeatures<KernelType>::SampleFrequencies(
+    const CauchyKernel& kernel,
+    arma::mat& frequencies)
+{
+  // 1 / (1 + || x ||^2 / sigma^2) is the integral over t of
+  // exp(-t) exp(-t || x ||^2 / sigma^2), so its Fourier transform is a mixture
+  // of Gaussians with variance 2 t / sigma^2, where t is exponential.
+  frequencies.randn();
+  const arma::vec t = -arma::log(1 -
+      arma::randu<arma::vec>(frequencies.n_rows));
+  frequencies.each_col() %= arma::sqrt(2 * t) / kernel.Bandwidth();
+}
+
+} // namespace kernel
+} // namespace mlpack
+
+#endif
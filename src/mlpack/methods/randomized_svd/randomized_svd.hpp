@@ -106,7 +106,12 @@ class RandomizedSVD
 
 /**
    * Center the data to apply Principal Component Analysis on given sparse
-   * matrix dataset using randomized SVD.
+   * matrix dataset using randomized SVD.  The centering is implicit: the data
+   * is only used in products with dense matrices of iteratedPower columns, and
+   * the mean is subtracted from the results, so the data is never densified
+   * and each product takes O(nnz * iteratedPower) time.  To compute the SVD
+   * without centering (e.g. for latent semantic analysis), call the Apply()
+   * overload that takes the row mean with arma::sp_mat(data.n_rows, 1).
    *
    * @param data Sparse data matrix.
    * @param u First unitary matrix.
@@ -0,0 +1,173 @@
+/**
+ * @file grid_range_search.hpp
+ *
+ * Defines the GridRangeSearch class, which performs range search with a
+ * uniform grid of cells instead of a tree.  For low-dimensional data and a
+ * radius close to the cell width, a search only visits a few cells next to the
+ * cell of the query point.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_GRID_RANGE_SEARCH_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_GRID_RANGE_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * The GridRangeSearch class finds, for each query point, the reference points
+ * whose distance to it is in a given range, using a uniform grid: the
+ * reference points are sorted by the cell of the grid that holds them, and a
+ * search with radius r only visits the cells within ceil(r / w) cells of the
+ * query point in each dimension, where w is the width of the cells.  This is
+ * exact for any radius, but it is only fast for low-dimensional data and a
+ * radius that is not much larger than the cell width, since (2 ceil(r / w) +
+ * 1)^d cells are visited.  When the radius is known in advance (for instance
+ * the epsilon of DBSCAN), it is the best cell width.
+ *
+ * Searches do not modify the object, so they may be run from several threads
+ * at once; the batch searches are themselves parallelized with OpenMP.
+ *
+ * GridRangeSearch provides the same Train() and Search() signatures as
+ * RangeSearch for a query set, so it can be used in place of RangeSearch in
+ * DBSCAN.
+ *
+ * @tparam MetricType Metric to use for the search.  The distance between two
+ *     points must be at least the absolute difference of any of their
+ *     coordinates, as is the case for all LMetric types.
+ * @tparam MatType Type of (dense) data matrix.
+ */
+template<typename MetricType = metric::EuclideanDistance,
+         typename MatType = arma::mat>
+class GridRangeSearch
+{
+ public:
+  /**
+   * Create the GridRangeSearch object without a reference set.  Train() must
+   * be called before searching.
+   *
+   * @param cellWidth Width of each cell of the grid; if 0, it is chosen so that
+   *     the cells hold a few points on average.
+   * @param metric Instantiated metric.
+   */
+  GridRangeSearch(const double cellWidth = 0.0,
+                  const MetricType metric = MetricType());
+
+  /**
+   * Create the GridRangeSearch object and build the grid on the given
+   * reference set.
+   *
+   * @param referenceSet Set of reference points.
+   * @param cellWidth Width of each cell of the grid; if 0, it is chosen so that
+   *     the cells hold a few points on average.
+   * @param metric Instantiated metric.
+   */
+  GridRangeSearch(MatType referenceSet,
+                  const double cellWidth = 0.0,
+                  const MetricType metric = MetricType());
+
+  /**
+   * Build the grid on the given reference set.  The points are copied (or
+   * moved) and sorted by cell.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Search for all reference points in the given range of each point of the
+   * query set, and store them and their distances in the given vectors.  The
+   * neighbors of each query point are not sorted in any particular order.
+   *
+   * @param querySet Set of query points.
+   * @param range The range of distances in which to search.
+   * @param neighbors Object which will hold the list of neighbors for each
+   *     point which fell into the given range, for each query point.
+   * @param distances Object which will hold the list of distances for each
+   *     point which fell into the given range, for each query point.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              std::vector<std::vector<size_t>>& neighbors,
+              std::vector<std::vector<double>>& distances) const;
+
+  /**
+   * Search for all reference points in the given range of each point of the
+   * query set, and store the results in compressed sparse row (CSR) form: the
+   * neighbors of query point i are neighbors[offsets[i]] through
+   * neighbors[offsets[i + 1] - 1], with the corresponding distances.
+   *
+   * @param querySet Set of query points.
+   * @param range The range of distances in which to search.
+   * @param offsets Offset of the neighbors of each query point (the number of
+   *     query points plus one elements).
+   * @param neighbors Neighbors of all query points.
+   * @param distances Distances of the neighbors of all query points.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances) const;
+
+  /**
+   * Call f(referenceIndex, distance) for each reference point in the given
+   * range of the given point.
+   *
+   * @param point Query point.
+   * @param range The range of distances in which to search.
+   * @param f Function to call for each reference point in the range.
+   */
+  template<typename VecType, typename FunctionType>
+  void ForEachNeighbor(const VecType& point,
+                       const math::Range& range,
+                       FunctionType&& f) const;
+
+  //! Get the width of the cells.
+  double CellWidth() const { return cellWidth; }
+  //! Get the number of cells that hold points.
+  size_t NumCells() const { return cellKeys.size(); }
+  //! Get the number of reference points.
+  size_t NumPoints() const { return referenceSet.n_cols; }
+
+ private:
+  //! Check that the query set has the dimensionality of the reference set.
+  void CheckDimensionality(const MatType& querySet) const;
+
+  //! The reference points, sorted by cell.
+  MatType referenceSet;
+  //! The original index of each sorted reference point.
+  std::vector<size_t> oldFromNew;
+
+  //! The smallest coordinate of the reference points in each dimension.
+  arma::vec minima;
+  //! The number of cells in each dimension.
+  std::vector<size_t> extents;
+  //! The key of each cell is the sum of its cell coordinates times these.
+  std::vector<size_t> strides;
+  //! The sorted keys of the cells that hold points.
+  std::vector<size_t> cellKeys;
+  //! Offset of the first point of each cell (one more element than cellKeys).
+  std::vector<size_t> cellOffsets;
+
+  //! The requested width of the cells (0 to choose it automatically).
+  double requestedWidth;
+  //! The width of the cells.
+  double cellWidth;
+  //! The instantiated metric.
+  MetricType metric;
+};
+
+} // namespace range
+} // namespace mlpack
+
+// Include implementation.
+#include "grid_range_search_impl.hpp"
+
+#endif
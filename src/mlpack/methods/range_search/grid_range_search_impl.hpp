@@ -0,0 +1,317 @@
+/**
+ * @file grid_range_search_impl.hpp
+ *
+ * Implementation of the GridRangeSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_GRID_RANGE_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_GRID_RANGE_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "grid_range_search.hpp"
+
+namespace mlpack {
+namespace range {
+
+template<typename MetricType, typename MatType>
+GridRangeSearch<MetricType, MatType>::GridRangeSearch(
+    const double cellWidth,
+    const MetricType metric) :
+    requestedWidth(cellWidth),
+    cellWidth(cellWidth),
+    metric(metric)
+{
+  if (cellWidth < 0.0)
+  {
+    std::stringstream ss;
+    ss << "GridRangeSearch: cell width must be non-negative (given "
+        << cellWidth << ")";
+    throw std::invalid_argument(ss.str());
+  }
+}
+
+template<typename MetricType, typename MatType>
+GridRangeSearch<MetricType, MatType>::GridRangeSearch(
+    MatType referenceSet,
+    const double cellWidth,
+    const MetricType metric) :
+    GridRangeSearch(cellWidth, metric)
+{
+  Train(std::move(referenceSet));
+}
+
+template<typename MetricType, typename MatType>
+void GridRangeSearch<MetricType, MatType>::Train(MatType points)
+{
+  const size_t n = points.n_cols;
+  const size_t d = points.n_rows;
+
+  cellKeys.clear();
+  cellOffsets.assign(1, 0);
+  oldFromNew.resize(n);
+  extents.assign(d, 1);
+  strides.assign(d, 1);
+  cellWidth = (requestedWidth > 0.0) ? requestedWidth : 1.0;
+  if (n == 0)
+  {
+    minima.zeros(d);
+    referenceSet = std::move(points);
+    return;
+  }
+
+  minima = arma::min(points, 1);
+  const arma::vec maxima = arma::max(points, 1);
+
+  if (requestedWidth == 0.0)
+  {
+    // Choose the width so that the cells of the bounding box hold about eight
+    // points on average.
+    double volume = 1.0;
+    size_t dims = 0;
+    for (size_t k = 0; k < d; ++k)
+    {
+      if (maxima[k] > minima[k])
+      {
+        volume *= (maxima[k] - minima[k]);
+        ++dims;
+      }
+    }
+
+    const double width = std::pow(volume * 8.0 / n, 1.0 / dims);
+    if (dims > 0 && width > 0.0 && std::isfinite(width))
+      cellWidth = width;
+  }
+
+  // Widen the cells until the keys of all cells fit in a size_t.
+  while (true)
+  {
+    double numCells = 1.0;
+    for (size_t k = 0; k < d; ++k)
+      numCells *= std::floor((maxima[k] - minima[k]) / cellWidth) + 1.0;
+
+    if (numCells < 1e18)
+      break;
+
+    cellWidth *= 2.0;
+  }
+
+  for (size_t k = 0; k < d; ++k)
+  {
+    extents[k] = (size_t) std::floor((maxima[k] - minima[k]) / cellWidth) + 1;
+    if (k > 0)
+      strides[k] = strides[k - 1] * extents[k - 1];
+  }
+
+  // Compute the key of the cell of each point, and sort the points by key.
+  std::vector<size_t> keys(n);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+  {
+    size_t key = 0;
+    for (size_t k = 0; k < d; ++k)
+    {
+      const size_t c = std::min(extents[k] - 1,
+          (size_t) ((points(k, i) - minima[k]) / cellWidth));
+      key += c * strides[k];
+    }
+    keys[i] = key;
+  }
+
+  for (size_t i = 0; i < n; ++i)
+    oldFromNew[i] = i;
+  std::sort(oldFromNew.begin(), oldFromNew.end(),
+      [&keys](const size_t a, const size_t b)
+      {
+        return (keys[a] < keys[b]) || (keys[a] == keys[b] && a < b);
+      });
+
+  referenceSet.set_size(d, n);
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) n; ++i)
+    referenceSet.col(i) = points.col(oldFromNew[i]);
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    const size_t key = keys[oldFromNew[i]];
+    if (cellKeys.empty() || cellKeys.back() != key)
+    {
+      if (!cellKeys.empty())
+        cellOffsets.push_back(i);
+      cellKeys.push_back(key);
+    }
+  }
+  cellOffsets.push_back(n);
+}
+
+template<typename MetricType, typename MatType>
+void GridRangeSearch<MetricType, MatType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances) const
+{
+  CheckDimensionality(querySet);
+
+  neighbors.clear();
+  neighbors.resize(querySet.n_cols);
+  distances.clear();
+  distances.resize(querySet.n_cols);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) querySet.n_cols; ++i)
+  {
+    std::vector<size_t>& pointNeighbors = neighbors[i];
+    std::vector<double>& pointDistances = distances[i];
+    ForEachNeighbor(querySet.col(i), range,
+        [&pointNeighbors, &pointDistances](const size_t index,
+                                           const double distance)
+        {
+          pointNeighbors.push_back(index);
+          pointDistances.push_back(distance);
+        });
+  }
+}
+
+template<typename MetricType, typename MatType>
+void GridRangeSearch<MetricType, MatType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances) const
+{
+  CheckDimensionality(querySet);
+
+  // Each block of query points collects its results separately; they are then
+  // copied to their place once the number of results of each point is known.
+  const size_t numQueries = querySet.n_cols;
+  const size_t numThreads = NumThreads();
+  const size_t numBlocks = std::min(numQueries,
+      (numThreads > 1) ? 4 * numThreads : (size_t) 1);
+  std::vector<std::vector<size_t>> blockNeighbors(numBlocks);
+  std::vector<std::vector<double>> blockDistances(numBlocks);
+
+  offsets.zeros(numQueries + 1);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    std::vector<size_t>& bNeighbors = blockNeighbors[b];
+    std::vector<double>& bDistances = blockDistances[b];
+    const size_t begin = b * numQueries / numBlocks;
+    const size_t end = (b + 1) * numQueries / numBlocks;
+    for (size_t i = begin; i < end; ++i)
+    {
+      const size_t before = bNeighbors.size();
+      ForEachNeighbor(querySet.col(i), range,
+          [&bNeighbors, &bDistances](const size_t index, const double distance)
+          {
+            bNeighbors.push_back(index);
+            bDistances.push_back(distance);
+          });
+      offsets[i + 1] = bNeighbors.size() - before;
+    }
+  }
+
+  for (size_t i = 0; i < numQueries; ++i)
+    offsets[i + 1] += offsets[i];
+
+  neighbors.set_size(offsets[numQueries]);
+  distances.set_size(offsets[numQueries]);
+  #pragma omp parallel for
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t begin = offsets[b * numQueries / numBlocks];
+    std::copy(blockNeighbors[b].begin(), blockNeighbors[b].end(),
+        neighbors.memptr() + begin);
+    std::copy(blockDistances[b].begin(), blockDistances[b].end(),
+        distances.memptr() + begin);
+    std::vector<size_t>().swap(blockNeighbors[b]);
+    std::vector<double>().swap(blockDistances[b]);
+  }
+}
+
+template<typename MetricType, typename MatType>
+template<typename VecType, typename FunctionType>
+void GridRangeSearch<MetricType, MatType>::ForEachNeighbor(
+    const VecType& point,
+    const math::Range& range,
+    FunctionType&& f) const
+{
+  const size_t d = referenceSet.n_rows;
+  if (referenceSet.n_cols == 0 || d == 0)
+    return;
+
+  // Points of cells that are farther than this many cells away in any
+  // dimension are farther than range.Hi() from the point.
+  const double reach = std::ceil(range.Hi() / cellWidth);
+  std::vector<size_t> low(d), high(d);
+  for (size_t k = 0; k < d; ++k)
+  {
+    const double c = std::floor((point[k] - minima[k]) / cellWidth);
+    const double lo = std::max(0.0, c - reach);
+    const double hi = std::min(double(extents[k] - 1), c + reach);
+    if (!(lo <= hi))
+      return;
+
+    low[k] = (size_t) lo;
+    high[k] = (size_t) hi;
+  }
+
+  // The keys of a row of cells along the first dimension are consecutive, so
+  // the points of the row are contiguous.
+  std::vector<size_t> cell(low);
+  while (true)
+  {
+    size_t rowKey = 0;
+    for (size_t k = 1; k < d; ++k)
+      rowKey += cell[k] * strides[k];
+
+    const std::vector<size_t>::const_iterator first = std::lower_bound(
+        cellKeys.begin(), cellKeys.end(), rowKey + low[0]);
+    const std::vector<size_t>::const_iterator last = std::upper_bound(
+        first, cellKeys.end(), rowKey + high[0]);
+    const size_t pointsEnd = cellOffsets[last - cellKeys.begin()];
+    for (size_t j = cellOffsets[first - cellKeys.begin()]; j < pointsEnd; ++j)
+    {
+      const double distance = metric.Evaluate(point, referenceSet.col(j));
+      if (range.Contains(distance))
+        f(oldFromNew[j], distance);
+    }
+
+    // Move to the next row.
+    size_t k = 1;
+    while (k < d && cell[k] == high[k])
+    {
+      cell[k] = low[k];
+      ++k;
+    }
+
+    if (k == d)
+      break;
+
+    ++cell[k];
+  }
+}
+
+template<typename MetricType, typename MatType>
+void GridRangeSearch<MetricType, MatType>::CheckDimensionality(
+    const MatType& querySet) const
+{
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "GridRangeSearch::Search(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet.n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+} // namespace range
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/instrumented_rules.hpp>
 #include "range_search_stat.hpp"
 
 namespace mlpack {
@@ -262,6 +263,67 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<double>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, and store the results in compressed sparse row (CSR) form: the
+   * neighbors of query point i are neighbors[offsets[i]] through
+   * neighbors[offsets[i + 1] - 1], and their distances are held at the same
+   * positions of distances.  The results are gathered in flat arrays, so no
+   * allocation is done per query point.  The neighbors of each query point are
+   * not sorted in any particular order.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param offsets Offset of the neighbors of each query point (one more
+   *     element than the number of query points).
+   * @param neighbors Neighbors of all of the query points.
+   * @param distances Distances of all of the neighbors.
+   */
+  void Search(const MatType& querySet,
+              const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Search for all the points in the given range for each point in the
+   * reference set (which was passed to the constructor), and store the results
+   * in compressed sparse row (CSR) form, as with the other CSR overload of
+   * Search().  A point is not returned in its own range.
+   *
+   * @param range Range of distances in which to search.
+   * @param offsets Offset of the neighbors of each point (one more element
+   *     than the number of points).
+   * @param neighbors Neighbors of all of the points.
+   * @param distances Distances of all of the neighbors.
+   */
+  void Search(const math::Range& range,
+              arma::Col<size_t>& offsets,
+              arma::Col<size_t>& neighbors,
+              arma::vec& distances);
+
+  /**
+   * Count the reference points in the given range of each point in the query
+   * set, without storing the neighbors.  The points of reference nodes that
+   * are entirely in the range are counted without computing their distances.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param counts Number of reference points in the range of each query point.
+   */
+  void Count(const MatType& querySet,
+             const math::Range& range,
+             arma::Col<size_t>& counts);
+
+  /**
+   * Count the points in the given range of each point in the reference set,
+   * without storing the neighbors.  A point is not counted in its own range.
+   *
+   * @param range Range of distances in which to search.
+   * @param counts Number of points in the range of each point.
+   */
+  void Count(const math::Range& range, arma::Col<size_t>& counts);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -277,6 +339,23 @@ class RangeSearch
   //! Get the number of scores during the last search.
   size_t Scores() const { return scores; }
 
+  //! Get whether traversal statistics are collected during searches.
+  bool CollectStatistics() const { return collectStatistics; }
+  //! Modify whether traversal statistics are collected during searches.
+  bool& CollectStatistics() { return collectStatistics; }
+
+  //! Get the traversal statistics of the last search.  These are only
+  //! collected by tree searches when CollectStatistics() is set.
+  const tree::TraversalStatistics& Statistics() const { return statistics; }
+
+  //! Get the number of query points that traverse the reference tree together
+  //! in single-tree search (0 or 1 means one at a time).
+  size_t QueryBlockSize() const { return queryBlockSize; }
+  //! Modify the number of query points that traverse the reference tree
+  //! together in single-tree search (0 or 1 means one at a time).  Blocks are
+  //! only used with binary space trees; see tree::BlockSingleTreeTraversal().
+  size_t& QueryBlockSize() { return queryBlockSize; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const unsigned int version);
@@ -288,6 +367,28 @@ class RangeSearch
   Tree* ReferenceTree() { return referenceTree; }
 
  private:
+  /**
+   * Search the reference set for each point of the query set, storing the
+   * results in the given object.  If a query tree is built, the query indices
+   * of the results are indices into the query tree's dataset, and
+   * oldFromNewQueries is filled with the mapping back to the query set;
+   * otherwise it is left empty.  The reference indices of the results are
+   * those of the reference tree's dataset.
+   */
+  template<typename ResultsType>
+  void Traverse(const MatType& querySet,
+                const math::Range& range,
+                ResultsType& results,
+                std::vector<size_t>& oldFromNewQueries);
+
+  /**
+   * Search the reference set for each of its own points, storing the results
+   * in the given object.  The indices of the results are those of the
+   * reference tree's dataset.
+   */
+  template<typename ResultsType>
+  void Traverse(const math::Range& range, ResultsType& results);
+
   //! Mappings to old reference indices (used when this object builds trees).
   std::vector<size_t> oldFromNewReferences;
   //! Reference tree.
@@ -311,6 +412,13 @@ class RangeSearch
   size_t baseCases;
   //! The total number of scores during the last search.
   size_t scores;
+  //! If true, traversal statistics are collected during searches.
+  bool collectStatistics;
+  //! The traversal statistics of the last search.
+  tree::TraversalStatistics statistics;
+  //! The number of query points that traverse the reference tree together in
+  //! single-tree search.
+  size_t queryBlockSize;
 
   //! For access to mappings when building models.
   friend class TrainVisitor;
@@ -18,6 +18,9 @@
 // The rules for traversal.
 #include "range_search_rules.hpp"
 
+#include <mlpack/core/tree/block_single_tree_traversal.hpp>
+#include <mlpack/core/tree/tree_cache.hpp>
+
 namespace mlpack {
 namespace range {
 
@@ -28,7 +31,8 @@ TreeType* BuildTree(
     const typename std::enable_if<
         tree::TreeTraits<TreeType>::RearrangesDataset>::type* = 0)
 {
-  return new TreeType(std::forward<MatType>(dataset), oldFromNew);
+  return tree::TreeCache::BuildTree<TreeType>(std::forward<MatType>(dataset),
+      oldFromNew);
 }
 
 //! Call the tree constructor that does not do mapping.
@@ -61,7 +65,9 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(!naive && singleMode),
     metric(metric),
     baseCases(0),
-    scores(0)
+    scores(0),
+    collectStatistics(false),
+    queryBlockSize(0)
 {
   // Nothing to do.
 }
@@ -82,7 +88,9 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(singleMode),
     metric(metric),
     baseCases(0),
-    scores(0)
+    scores(0),
+    collectStatistics(false),
+    queryBlockSize(0)
 {
   // Nothing else to initialize.
 }
@@ -103,7 +111,9 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(singleMode),
     metric(metric),
     baseCases(0),
-    scores(0)
+    scores(0),
+    collectStatistics(false),
+    queryBlockSize(0)
 {
   // Build the tree on the empty dataset, if necessary.
   if (!naive)
@@ -130,7 +140,10 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(
     singleMode(other.singleMode),
     metric(other.metric),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    collectStatistics(other.collectStatistics),
+    statistics(other.statistics),
+    queryBlockSize(other.queryBlockSize)
 {
   // Nothing to do.
 }
@@ -149,7 +162,10 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
     singleMode(other.singleMode),
     metric(std::move(other.metric)),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    collectStatistics(other.collectStatistics),
+    statistics(other.statistics),
+    queryBlockSize(other.queryBlockSize)
 {
   // Clear other object.
   other.referenceSet = new MatType();
@@ -161,6 +177,7 @@ RangeSearch<MetricType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
   other.singleMode = false;
   other.baseCases = 0;
   other.scores = 0;
+  other.statistics.Reset();
 }
 
 template<typename MetricType,
@@ -187,6 +204,9 @@ RangeSearch<MetricType, MatType, TreeType>::operator=(RangeSearch other)
   metric = std::move(other.metric);
   baseCases = other.baseCases;
   scores = other.scores;
+  collectStatistics = other.collectStatistics;
+  statistics = other.statistics;
+  queryBlockSize = other.queryBlockSize;
 
   return *this;
 }
@@ -327,11 +347,12 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   // Reset counts.
   baseCases = 0;
   scores = 0;
+  statistics.Reset();
 
+  RangeSearchVectorResults results(*neighborPtr, *distancePtr);
   if (naive)
   {
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
+    RuleType rules(*referenceSet, querySet, range, results, metric);
 
     // The naive brute-force solution.
     for (size_t i = 0; i < querySet.n_cols; ++i)
@@ -342,14 +363,11 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
-        metric);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // Create the rules and traverse the trees.
+    RuleType rules(*referenceSet, querySet, range, results, metric);
+    tree::BlockSingleTreeTraversal<Tree::template SingleTreeTraverser>(rules,
+        querySet, 0, querySet.n_cols, *referenceTree, queryBlockSize,
+        collectStatistics ? &statistics : NULL);
 
     baseCases += rules.BaseCases();
     scores += rules.Scores();
@@ -363,12 +381,12 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
     Timer::Stop("range_search/tree_building");
     Timer::Start("range_search/computing_neighbors");
 
-    // Create the traverser.
-    RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-        *distancePtr, metric);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*queryTree, *referenceTree);
+    // Create the rules and traverse the trees.
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, results,
+        metric);
+    tree::DualTreeTraversal<Tree::template DualTreeTraverser>(rules,
+        *queryTree, *referenceTree,
+        collectStatistics ? &statistics : NULL);
 
     baseCases += rules.BaseCases();
     scores += rules.Scores();
@@ -461,6 +479,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   if (referenceSet->n_cols == 0)
     return;
 
+  statistics.Reset();
   Timer::Start("range_search/computing_neighbors");
 
   // Get a reference to the query set.
@@ -485,13 +504,13 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   // Create the helper object for the traversal.
   typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
-      distances, metric);
-
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  RangeSearchVectorResults results(*neighborPtr, distances);
+  RuleType rules(*referenceSet, queryTree->Dataset(), range, results, metric);
 
-  traverser.Traverse(*queryTree, *referenceTree);
+  // Traverse the trees.
+  tree::DualTreeTraversal<Tree::template DualTreeTraverser>(rules,
+      *queryTree, *referenceTree,
+      collectStatistics ? &statistics : NULL);
 
   Timer::Stop("range_search/computing_neighbors");
 
@@ -531,6 +550,7 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   if (referenceSet->n_cols == 0)
     return;
 
+  statistics.Reset();
   Timer::Start("range_search/computing_neighbors");
 
   // Here, we will use the query set as the reference set.
@@ -552,8 +572,9 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
 
   // Create the helper object for the traversal.
   typedef RangeSearchRules<MetricType, Tree> RuleType;
-  RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
-      *distancePtr, metric, true /* don't return the query in the results */);
+  RangeSearchVectorResults results(*neighborPtr, *distancePtr);
+  RuleType rules(*referenceSet, *referenceSet, range, results, metric,
+      true /* don't return the query in the results */);
 
   if (naive)
   {
@@ -567,22 +588,20 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // Traverse the trees.
+    tree::BlockSingleTreeTraversal<Tree::template SingleTreeTraverser>(rules,
+        *referenceSet, 0, referenceSet->n_cols, *referenceTree,
+        queryBlockSize, collectStatistics ? &statistics : NULL);
 
     baseCases = rules.BaseCases();
     scores = rules.Scores();
   }
   else // Dual-tree recursion.
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
+    // Traverse the trees.
+    tree::DualTreeTraversal<Tree::template DualTreeTraverser>(rules,
+        *referenceTree, *referenceTree,
+        collectStatistics ? &statistics : NULL);
 
     baseCases = rules.BaseCases();
     scores = rules.Scores();
@@ -618,6 +637,245 @@ void RangeSearch<MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  RangeSearchCSRResults results;
+  std::vector<size_t> oldFromNewQueries;
+  Traverse(querySet, range, results, oldFromNewQueries);
+
+  // Map the indices back to the original indices while converting to CSR.
+  const bool mapReferences = (treeOwner &&
+      tree::TreeTraits<Tree>::RearrangesDataset);
+  results.Finalize(querySet.n_cols,
+      oldFromNewQueries.empty() ? NULL : &oldFromNewQueries,
+      mapReferences ? &oldFromNewReferences : NULL, offsets, neighbors,
+      distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Search(
+    const math::Range& range,
+    arma::Col<size_t>& offsets,
+    arma::Col<size_t>& neighbors,
+    arma::vec& distances)
+{
+  RangeSearchCSRResults results;
+  Traverse(range, results);
+
+  // The query set is the reference set, so both indices may need mapping.
+  const std::vector<size_t>* oldFromNew = (treeOwner &&
+      tree::TreeTraits<Tree>::RearrangesDataset) ? &oldFromNewReferences :
+      NULL;
+  results.Finalize(referenceSet->n_cols, oldFromNew, oldFromNew, offsets,
+      neighbors, distances);
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const MatType& querySet,
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  arma::Col<size_t> treeCounts(querySet.n_cols, arma::fill::zeros);
+  RangeSearchCountResults results(treeCounts);
+  std::vector<size_t> oldFromNewQueries;
+  Traverse(querySet, range, results, oldFromNewQueries);
+
+  // Map the query indices back to the original indices, if necessary.
+  if (oldFromNewQueries.empty())
+  {
+    counts = std::move(treeCounts);
+  }
+  else
+  {
+    counts.set_size(querySet.n_cols);
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      counts[oldFromNewQueries[i]] = treeCounts[i];
+  }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<MetricType, MatType, TreeType>::Count(
+    const math::Range& range,
+    arma::Col<size_t>& counts)
+{
+  arma::Col<size_t> treeCounts(referenceSet->n_cols, arma::fill::zeros);
+  RangeSearchCountResults results(treeCounts);
+  Traverse(range, results);
+
+  // Map the indices back to the original indices, if necessary.
+  if (treeOwner && tree::TreeTraits<Tree>::RearrangesDataset)
+  {
+    counts.set_size(referenceSet->n_cols);
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+      counts[oldFromNewReferences[i]] = treeCounts[i];
+  }
+  else
+  {
+    counts = std::move(treeCounts);
+  }
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename ResultsType>
+void RangeSearch<MetricType, MatType, TreeType>::Traverse(
+    const MatType& querySet,
+    const math::Range& range,
+    ResultsType& results,
+    std::vector<size_t>& oldFromNewQueries)
+{
+  if (querySet.n_rows != referenceSet->n_rows)
+  {
+    std::ostringstream oss;
+    oss << "RangeSearch::Search(): dimensionalities of query set ("
+        << querySet.n_rows << ") and reference set (" << referenceSet->n_rows
+        << ") do not match!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Reset counts.
+  baseCases = 0;
+  scores = 0;
+  statistics.Reset();
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  Timer::Start("range_search/computing_neighbors");
+
+  typedef RangeSearchRules<MetricType, Tree, ResultsType> RuleType;
+  if (naive)
+  {
+    RuleType rules(*referenceSet, querySet, range, results, metric);
+
+    // The naive brute-force solution.
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
+
+    baseCases = (querySet.n_cols * referenceSet->n_cols);
+  }
+  else if (singleMode)
+  {
+    // Create the rules and traverse the trees.
+    RuleType rules(*referenceSet, querySet, range, results, metric);
+    tree::BlockSingleTreeTraversal<Tree::template SingleTreeTraverser>(rules,
+        querySet, 0, querySet.n_cols, *referenceTree, queryBlockSize,
+        collectStatistics ? &statistics : NULL);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+  }
+  else // Dual-tree recursion.
+  {
+    // Build the query tree.  The results then hold indices into the query
+    // tree's dataset, which oldFromNewQueries maps back.
+    Timer::Stop("range_search/computing_neighbors");
+    Timer::Start("range_search/tree_building");
+    Tree* queryTree = BuildTree<Tree>(querySet, oldFromNewQueries);
+    Timer::Stop("range_search/tree_building");
+    Timer::Start("range_search/computing_neighbors");
+
+    RuleType rules(*referenceSet, queryTree->Dataset(), range, results,
+        metric);
+    tree::DualTreeTraversal<Tree::template DualTreeTraverser>(rules,
+        *queryTree, *referenceTree,
+        collectStatistics ? &statistics : NULL);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+
+    delete queryTree;
+  }
+
+  Timer::Stop("range_search/computing_neighbors");
+}
+
+template<typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename ResultsType>
+void RangeSearch<MetricType, MatType, TreeType>::Traverse(
+    const math::Range& range,
+    ResultsType& results)
+{
+  // Reset counts.
+  baseCases = 0;
+  scores = 0;
+  statistics.Reset();
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  Timer::Start("range_search/computing_neighbors");
+
+  typedef RangeSearchRules<MetricType, Tree, ResultsType> RuleType;
+  RuleType rules(*referenceSet, *referenceSet, range, results, metric,
+      true /* don't return the query in the results */);
+
+  if (naive)
+  {
+    // The naive brute-force solution.
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+      for (size_t j = 0; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
+
+    baseCases = (referenceSet->n_cols * referenceSet->n_cols);
+  }
+  else if (singleMode)
+  {
+    // Traverse the trees.
+    tree::BlockSingleTreeTraversal<Tree::template SingleTreeTraverser>(rules,
+        *referenceSet, 0, referenceSet->n_cols, *referenceTree,
+        queryBlockSize, collectStatistics ? &statistics : NULL);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+  }
+  else // Dual-tree recursion.
+  {
+    // Traverse the trees.
+    tree::DualTreeTraversal<Tree::template DualTreeTraverser>(rules,
+        *referenceTree, *referenceTree,
+        collectStatistics ? &statistics : NULL);
+
+    baseCases = rules.BaseCases();
+    scores = rules.Scores();
+  }
+
+  Timer::Stop("range_search/computing_neighbors");
+}
+
 template<typename MetricType,
          typename MatType,
          template<typename TreeMetricType,
@@ -637,6 +895,7 @@ void RangeSearch<MetricType, MatType, TreeType>::serialize(
   {
     baseCases = 0;
     scores = 0;
+    statistics.Reset();
   }
 
   // If we are doing naive search, we serialize the dataset.  Otherwise we
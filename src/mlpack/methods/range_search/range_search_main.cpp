@@ -104,6 +104,9 @@ PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 PARAM_FLAG("naive", "If true, O(n^2) naive mode is used for computation.", "N");
 PARAM_FLAG("single_mode", "If true, single-tree search is used (as opposed to "
     "dual-tree search).", "S");
+PARAM_FLAG("traversal_statistics", "If set, print the number of base cases, "
+    "and the number of nodes of the reference tree visited and pruned at each "
+    "depth, for tuning the tree type and leaf size (with --verbose).", "");
 
 static void mlpackMain()
 {
@@ -250,12 +253,15 @@ static void mlpackMain()
     vector<vector<size_t>> neighbors;
     vector<vector<double>> distances;
 
+    rs->CollectStatistics() = CLI::HasParam("traversal_statistics");
     if (CLI::HasParam("query"))
       rs->Search(std::move(queryData), r, neighbors, distances);
     else
       rs->Search(r, neighbors, distances);
 
     Log::Info << "Search complete." << endl;
+    if (CLI::HasParam("traversal_statistics"))
+      rs->Statistics().Print(Log::Info);
 
     // Save output, if desired.  We have to do this by hand.
     if (CLI::HasParam("distances_file"))
@@ -0,0 +1,199 @@
+/**
+ * @file range_search_results.hpp
+ *
+ * Result types for RangeSearchRules: the results of a range search can be
+ * stored in a vector of vectors per query point, in compressed sparse row
+ * (CSR) form, or only counted.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RESULTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace range {
+
+/**
+ * Store the results of a range search in one vector of neighbors and one
+ * vector of distances for each query point.  This is what the
+ * std::vector<std::vector<size_t>> overloads of RangeSearch::Search() use.
+ */
+class RangeSearchVectorResults
+{
+ public:
+  //! The distances of the results are stored.
+  static const bool StoresDistances = true;
+
+  /**
+   * Store the results in the given vectors, which must already have one
+   * element for each query point.
+   */
+  RangeSearchVectorResults(std::vector<std::vector<size_t>>& neighbors,
+                           std::vector<std::vector<double>>& distances) :
+      neighbors(neighbors),
+      distances(distances)
+  { }
+
+  //! Make room for the given number of additional results for a query point.
+  void Reserve(const size_t queryIndex, const size_t count)
+  {
+    neighbors[queryIndex].reserve(neighbors[queryIndex].size() + count);
+    distances[queryIndex].reserve(distances[queryIndex].size() + count);
+  }
+
+  //! Add a result for a query point.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    neighbors[queryIndex].push_back(referenceIndex);
+    distances[queryIndex].push_back(distance);
+  }
+
+ private:
+  //! The neighbors of each query point.
+  std::vector<std::vector<size_t>>& neighbors;
+  //! The distances of each query point.
+  std::vector<std::vector<double>>& distances;
+};
+
+/**
+ * Store the results of a range search as a list of (query, reference,
+ * distance) triples in three flat arrays, in the order in which they are found,
+ * and then convert them to compressed sparse row form with Finalize().  No
+ * allocation is done per query point, and the arrays grow geometrically, so
+ * query points with huge neighborhoods do not fragment memory.
+ */
+class RangeSearchCSRResults
+{
+ public:
+  //! The distances of the results are stored.
+  static const bool StoresDistances = true;
+
+  //! Make room for the given number of additional results for a query point.
+  void Reserve(const size_t /* queryIndex */, const size_t count)
+  {
+    if (queries.size() + count > queries.capacity())
+    {
+      const size_t capacity = std::max(queries.size() + count,
+          2 * queries.capacity());
+      queries.reserve(capacity);
+      references.reserve(capacity);
+      distances.reserve(capacity);
+    }
+  }
+
+  //! Add a result for a query point.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const double distance)
+  {
+    queries.push_back(queryIndex);
+    references.push_back(referenceIndex);
+    distances.push_back(distance);
+  }
+
+  /**
+   * Convert the results to CSR form: the neighbors of query point i are
+   * neighbors[offsets[i]] through neighbors[offsets[i + 1] - 1], with the
+   * corresponding distances.  The neighbors of each query point are not sorted
+   * in any particular order.  The stored results are released.
+   *
+   * @param numQueries Number of query points.
+   * @param oldFromNewQueries Mapping from the query indices in the results to
+   *     the original query indices, or NULL if they are the same.
+   * @param oldFromNewReferences Mapping from the reference indices in the
+   *     results to the original reference indices, or NULL if they are the
+   *     same.
+   * @param offsets Offset of the neighbors of each query point (numQueries + 1
+   *     elements).
+   * @param neighbors Neighbors of all query points.
+   * @param neighborDistances Distances of the neighbors of all query points.
+   */
+  void Finalize(const size_t numQueries,
+                const std::vector<size_t>* oldFromNewQueries,
+                const std::vector<size_t>* oldFromNewReferences,
+                arma::Col<size_t>& offsets,
+                arma::Col<size_t>& neighbors,
+                arma::vec& neighborDistances)
+  {
+    // Count the results of each query point, then compute the offsets.
+    offsets.zeros(numQueries + 1);
+    for (size_t i = 0; i < queries.size(); ++i)
+      ++offsets[MapIndex(oldFromNewQueries, queries[i]) + 1];
+    for (size_t i = 0; i < numQueries; ++i)
+      offsets[i + 1] += offsets[i];
+
+    neighbors.set_size(queries.size());
+    neighborDistances.set_size(queries.size());
+    arma::Col<size_t> next = offsets.head(numQueries);
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+      const size_t position = next[MapIndex(oldFromNewQueries, queries[i])]++;
+      neighbors[position] = MapIndex(oldFromNewReferences, references[i]);
+      neighborDistances[position] = distances[i];
+    }
+
+    std::vector<size_t>().swap(queries);
+    std::vector<size_t>().swap(references);
+    std::vector<double>().swap(distances);
+  }
+
+ private:
+  //! Map the given index, if there is a mapping.
+  static size_t MapIndex(const std::vector<size_t>* oldFromNew,
+                         const size_t index)
+  {
+    return (oldFromNew == NULL) ? index : (*oldFromNew)[index];
+  }
+
+  //! The query index of each result.
+  std::vector<size_t> queries;
+  //! The reference index of each result.
+  std::vector<size_t> references;
+  //! The distance of each result.
+  std::vector<double> distances;
+};
+
+/**
+ * Only count the results of a range search for each query point.  The points
+ * of reference nodes that are entirely in the range are counted without
+ * computing their distances.
+ */
+class RangeSearchCountResults
+{
+ public:
+  //! The distances of the results are not needed.
+  static const bool StoresDistances = false;
+
+  /**
+   * Count the results in the given vector, which must already have one
+   * element for each query point.
+   */
+  RangeSearchCountResults(arma::Col<size_t>& counts) : counts(counts) { }
+
+  //! Nothing needs to be reserved to count results.
+  void Reserve(const size_t /* queryIndex */, const size_t /* count */) { }
+
+  //! Count a result for a query point.
+  void Add(const size_t queryIndex,
+           const size_t /* referenceIndex */,
+           const double /* distance */)
+  {
+    ++counts[queryIndex];
+  }
+
+ private:
+  //! The number of results of each query point.
+  arma::Col<size_t>& counts;
+};
+
+} // namespace range
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,8 @@
 #define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/batch_base_cases.hpp>
+#include "range_search_results.hpp"
 
 namespace mlpack {
 namespace range {
@@ -23,8 +25,13 @@ namespace range {
  *
  * @tparam MetricType The metric to use for computation.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ * @tparam ResultsType The type that the results are stored in; see
+ *     RangeSearchVectorResults, RangeSearchCSRResults and
+ *     RangeSearchCountResults.
  */
-template<typename MetricType, typename TreeType>
+template<typename MetricType,
+         typename TreeType,
+         typename ResultsType = RangeSearchVectorResults>
 class RangeSearchRules
 {
  public:
@@ -35,17 +42,15 @@ class RangeSearchRules
    * @param referenceSet Set of reference data.
    * @param querySet Set of query data.
    * @param range Range to search for.
-   * @param neighbors Vector to store resulting neighbors in.
-   * @param distances Vector to store resulting distances in.
+   * @param results Object to store the results in.
    * @param metric Instantiated metric.
    * @param sameSet If true, the query and reference set are taken to be the
    *      same, and a query point will not return itself in the results.
    */
-  RangeSearchRules(const arma::mat& referenceSet,
-                   const arma::mat& querySet,
+  RangeSearchRules(const typename TreeType::Mat& referenceSet,
+                   const typename TreeType::Mat& querySet,
                    const math::Range& range,
-                   std::vector<std::vector<size_t> >& neighbors,
-                   std::vector<std::vector<double> >& distances,
+                   ResultsType& results,
                    MetricType& metric,
                    const bool sameSet = false);
 
@@ -57,6 +62,21 @@ class RangeSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between each of the given query points and each
+   * reference point in [referenceBegin, referenceBegin + referenceCount).  For
+   * the Euclidean distance in more than a few dimensions, the whole block of
+   * distances is computed with one matrix multiplication; otherwise, this is
+   * the same as calling BaseCase() for each pair.
+   *
+   * @param queryIndices Indices of query points.
+   * @param referenceBegin Index of the first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BatchBaseCases(const std::vector<size_t>& queryIndices,
+                      const size_t referenceBegin,
+                      const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -119,19 +139,16 @@ class RangeSearchRules
 
  private:
   //! The reference set.
-  const arma::mat& referenceSet;
+  const typename TreeType::Mat& referenceSet;
 
   //! The query set.
-  const arma::mat& querySet;
+  const typename TreeType::Mat& querySet;
 
   //! The range of distances for which we are searching.
   const math::Range& range;
 
-  //! The vector the resultant neighbor indices should be stored in.
-  std::vector<std::vector<size_t> >& neighbors;
-
-  //! The vector the resultant neighbor distances should be stored in.
-  std::vector<std::vector<double> >& distances;
+  //! The object the results should be stored in.
+  ResultsType& results;
 
   //! The instantiated metric.
   MetricType& metric;
@@ -152,6 +169,18 @@ class RangeSearchRules
 
   TraversalInfoType traversalInfo;
 
+  //! The element type of the datasets.
+  typedef typename TreeType::Mat::elem_type ElemType;
+
+  //! Squared norms of the query points, used by BatchBaseCases().  This is
+  //! empty if base cases are not batched.
+  arma::Col<ElemType> queryNorms;
+  //! Squared norms of the reference points, used by BatchBaseCases().
+  arma::Col<ElemType> referenceNorms;
+  //! Distances computed by BatchBaseCases(), held in the class so that it
+  //! isn't continually being reallocated.
+  arma::Mat<ElemType> batchDistances;
+
   //! The number of base cases.
   size_t baseCases;
   //! THe number of scores.
@@ -18,20 +18,18 @@
 namespace mlpack {
 namespace range {
 
-template<typename MetricType, typename TreeType>
-RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
-    const arma::mat& referenceSet,
-    const arma::mat& querySet,
+template<typename MetricType, typename TreeType, typename ResultsType>
+RangeSearchRules<MetricType, TreeType, ResultsType>::RangeSearchRules(
+    const typename TreeType::Mat& referenceSet,
+    const typename TreeType::Mat& querySet,
     const math::Range& range,
-    std::vector<std::vector<size_t> >& neighbors,
-    std::vector<std::vector<double> >& distances,
+    ResultsType& results,
     MetricType& metric,
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
     range(range),
-    neighbors(neighbors),
-    distances(distances),
+    results(results),
     metric(metric),
     sameSet(sameSet),
     lastQueryIndex(querySet.n_cols),
@@ -39,14 +37,18 @@ RangeSearchRules<MetricType, TreeType>::RangeSearchRules(
     baseCases(0),
     scores(0)
 {
-  // Nothing to do.
+  // If base cases can be computed in blocks, cache the squared norms of the
+  // points.
+  tree::BatchNorms<MetricType>(querySet, 0, querySet.n_cols, queryNorms);
+  tree::BatchNorms<MetricType>(referenceSet, 0, referenceSet.n_cols,
+      referenceNorms);
 }
 
 //! The base case.  Evaluate the distance between the two points and add to the
 //! results if necessary.
-template<typename MetricType, typename TreeType>
+template<typename MetricType, typename TreeType, typename ResultsType>
 inline force_inline
-double RangeSearchRules<MetricType, TreeType>::BaseCase(
+double RangeSearchRules<MetricType, TreeType, ResultsType>::BaseCase(
     const size_t queryIndex,
     const size_t referenceIndex)
 {
@@ -67,18 +69,57 @@ double RangeSearchRules<MetricType, TreeType>::BaseCase(
   lastReferenceIndex = referenceIndex;
 
   if (range.Contains(distance))
+    results.Add(queryIndex, referenceIndex, distance);
+
+  return distance;
+}
+
+template<typename MetricType, typename TreeType, typename ResultsType>
+void RangeSearchRules<MetricType, TreeType, ResultsType>::BatchBaseCases(
+    const std::vector<size_t>& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  const size_t referenceEnd = referenceBegin + referenceCount;
+  if (queryNorms.is_empty() || referenceNorms.is_empty())
   {
-    neighbors[queryIndex].push_back(referenceIndex);
-    distances[queryIndex].push_back(distance);
+    for (size_t i = 0; i < queryIndices.size(); ++i)
+      for (size_t ref = referenceBegin; ref < referenceEnd; ++ref)
+        BaseCase(queryIndices[i], ref);
+
+    return;
   }
 
-  return distance;
+  arma::uvec queries(queryIndices.size());
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+    queries[i] = queryIndices[i];
+
+  const arma::Col<ElemType> norms = queryNorms.elem(queries);
+  tree::BatchDistances<MetricType>(querySet, queries, norms, referenceSet,
+      referenceBegin, referenceCount,
+      referenceNorms.subvec(referenceBegin, referenceEnd - 1), batchDistances);
+
+  for (size_t i = 0; i < queryIndices.size(); ++i)
+  {
+    const size_t queryIndex = queryIndices[i];
+    for (size_t j = 0; j < referenceCount; ++j)
+    {
+      // As in BaseCase(), a point is not in its own range.
+      if (sameSet && (queryIndex == referenceBegin + j))
+        continue;
+
+      ++baseCases;
+      if (range.Contains(batchDistances(i, j)))
+        results.Add(queryIndex, referenceBegin + j, batchDistances(i, j));
+    }
+  }
 }
 
 //! Single-tree scoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
-                                                     TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename ResultsType>
+double RangeSearchRules<MetricType, TreeType, ResultsType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
 {
   // We must get the minimum and maximum distances and store them in this
   // object.
@@ -136,8 +177,8 @@ double RangeSearchRules<MetricType, TreeType>::Score(const size_t queryIndex,
 }
 
 //! Single-tree rescoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Rescore(
+template<typename MetricType, typename TreeType, typename ResultsType>
+double RangeSearchRules<MetricType, TreeType, ResultsType>::Rescore(
     const size_t /* queryIndex */,
     TreeType& /* referenceNode */,
     const double oldScore) const
@@ -147,9 +188,10 @@ double RangeSearchRules<MetricType, TreeType>::Rescore(
 }
 
 //! Dual-tree scoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
-                                                     TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename ResultsType>
+double RangeSearchRules<MetricType, TreeType, ResultsType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
 {
   math::Range distances;
   if (tree::TreeTraits<TreeType>::FirstPointIsCentroid)
@@ -209,8 +251,8 @@ double RangeSearchRules<MetricType, TreeType>::Score(TreeType& queryNode,
 }
 
 //! Dual-tree rescoring function.
-template<typename MetricType, typename TreeType>
-double RangeSearchRules<MetricType, TreeType>::Rescore(
+template<typename MetricType, typename TreeType, typename ResultsType>
+double RangeSearchRules<MetricType, TreeType, ResultsType>::Rescore(
     TreeType& /* queryNode */,
     TreeType& /* referenceNode */,
     const double oldScore) const
@@ -221,9 +263,10 @@ double RangeSearchRules<MetricType, TreeType>::Rescore(
 
 //! Add all the points in the given node to the results for the given query
 //! point.
-template<typename MetricType, typename TreeType>
-void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
-                                                       TreeType& referenceNode)
+template<typename MetricType, typename TreeType, typename ResultsType>
+void RangeSearchRules<MetricType, TreeType, ResultsType>::AddResult(
+    const size_t queryIndex,
+    TreeType& referenceNode)
 {
   // Some types of trees calculate the base case evaluation before Score() is
   // called, so if the base case has already been calculated, then we must avoid
@@ -236,14 +279,9 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
     baseCaseMod = 1;
   }
 
-  // Resize distances and neighbors vectors appropriately.  We have to use
-  // reserve() and not resize(), because we don't know if we will encounter the
-  // case where the datasets and points are the same (and we skip in that case).
-  const size_t oldSize = neighbors[queryIndex].size();
-  neighbors[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
-  distances[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
+  // Make room for the results.  This may be more than needed, if the datasets
+  // and points are the same (and we skip in that case).
+  results.Reserve(queryIndex, referenceNode.NumDescendants() - baseCaseMod);
 
   for (size_t i = baseCaseMod; i < referenceNode.NumDescendants(); ++i)
   {
@@ -251,11 +289,13 @@ void RangeSearchRules<MetricType, TreeType>::AddResult(const size_t queryIndex,
         (queryIndex == referenceNode.Descendant(i)))
       continue;
 
-    const double distance = metric.Evaluate(querySet.unsafe_col(queryIndex),
-        referenceNode.Dataset().unsafe_col(referenceNode.Descendant(i)));
+    // The points are known to be in the range, so the distance is only
+    // computed if it is stored.
+    const double distance = ResultsType::StoresDistances ?
+        metric.Evaluate(querySet.unsafe_col(queryIndex),
+        referenceNode.Dataset().unsafe_col(referenceNode.Descendant(i))) : 0.0;
 
-    neighbors[queryIndex].push_back(referenceNode.Descendant(i));
-    distances[queryIndex].push_back(distance);
+    results.Add(queryIndex, referenceNode.Descendant(i), distance);
   }
 }
 
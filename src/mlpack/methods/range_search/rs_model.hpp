@@ -209,6 +209,30 @@ class NaiveVisitor : public boost::static_visitor<bool&>
   bool& operator()(RSType* rs) const;
 };
 
+/**
+ * CollectStatisticsVisitor exposes the CollectStatistics() method of the given
+ * RSType.
+ */
+class CollectStatisticsVisitor : public boost::static_visitor<bool&>
+{
+ public:
+  //! Return whether traversal statistics are collected.
+  template<typename RSType>
+  bool& operator()(RSType* rs) const;
+};
+
+/**
+ * StatisticsVisitor exposes the traversal statistics of the given RSType.
+ */
+class StatisticsVisitor :
+    public boost::static_visitor<const tree::TraversalStatistics&>
+{
+ public:
+  //! Return the traversal statistics of the last search.
+  template<typename RSType>
+  const tree::TraversalStatistics& operator()(RSType* rs) const;
+};
+
 class RSModel
 {
  public:
@@ -315,6 +339,14 @@ class RSModel
   //! Modify whether the model is in naive search mode.
   bool& Naive();
 
+  //! Get whether traversal statistics are collected.
+  bool CollectStatistics() const;
+  //! Modify whether traversal statistics are collected.
+  bool& CollectStatistics();
+
+  //! Get the traversal statistics of the last search.
+  const tree::TraversalStatistics& Statistics() const;
+
   //! Get the leaf size (applicable to everything but the cover tree).
   size_t LeafSize() const { return leafSize; }
   //! Modify the leaf size (applicable to everything but the cover tree).
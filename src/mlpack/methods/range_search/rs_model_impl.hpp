@@ -448,6 +448,25 @@ bool& NaiveVisitor::operator()(RSType* rs) const
   throw std::runtime_error("no range search model initialized");
 }
 
+//! Exposes CollectStatistics() function of given RSType
+template<typename RSType>
+bool& CollectStatisticsVisitor::operator()(RSType* rs) const
+{
+  if (rs)
+    return rs->CollectStatistics();
+  throw std::runtime_error("no range search model initialized");
+}
+
+//! Exposes the traversal statistics of given RSType
+template<typename RSType>
+const tree::TraversalStatistics& StatisticsVisitor::operator()(RSType* rs)
+    const
+{
+  if (rs)
+    return rs->Statistics();
+  throw std::runtime_error("no range search model initialized");
+}
+
 // Serialize the model.
 template<typename Archive>
 void RSModel::serialize(Archive& ar, const unsigned int /* version */)
@@ -489,6 +508,21 @@ inline bool& RSModel::Naive()
   return boost::apply_visitor(NaiveVisitor(), rSearch);
 }
 
+inline bool RSModel::CollectStatistics() const
+{
+  return boost::apply_visitor(CollectStatisticsVisitor(), rSearch);
+}
+
+inline bool& RSModel::CollectStatistics()
+{
+  return boost::apply_visitor(CollectStatisticsVisitor(), rSearch);
+}
+
+inline const tree::TraversalStatistics& RSModel::Statistics() const
+{
+  return boost::apply_visitor(StatisticsVisitor(), rSearch);
+}
+
 } // namespace range
 } // namespace mlpack
 
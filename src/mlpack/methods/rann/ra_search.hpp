@@ -391,6 +391,19 @@ class RASearch
   //! Instantiation of kernel.
   MetricType metric;
 
+  /**
+   * Traverse the reference tree for each of the given number of query points
+   * with the given rules.  The query points are split into blocks of fixed
+   * size, each with its own random number generator seeded in order from
+   * math::randGen, and the blocks are traversed in parallel when OpenMP is
+   * available.  The sampling is thus the same for any number of threads.
+   *
+   * @param rules The rules to traverse with.
+   * @param numQueries Number of query points.
+   */
+  template<typename RuleType>
+  void SingleTreeTraversal(RuleType& rules, const size_t numQueries);
+
   //! For access to mappings when building models.
   template<typename SortPol>
   friend class TrainVisitor;
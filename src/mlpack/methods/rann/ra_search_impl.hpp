@@ -323,12 +323,7 @@ Search(const MatType& querySet,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      SingleTreeTraversal(rules, querySet.n_cols);
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
@@ -539,12 +534,7 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeTraversal(rules, referenceSet->n_cols);
   }
   else
   {
@@ -581,6 +571,44 @@ void RASearch<SortPolicy, MetricType, MatType, TreeType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename MetricType,
+         typename MatType,
+         template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RASearch<SortPolicy, MetricType, MatType, TreeType>::SingleTreeTraversal(
+    RuleType& rules,
+    const size_t numQueries)
+{
+  // The blocks do not depend on the number of threads, and their seeds are
+  // drawn before the traversal, so the results only depend on the random seed.
+  const size_t blockSize = 64;
+  const size_t numBlocks = (numQueries + blockSize - 1) / blockSize;
+  std::vector<std::mt19937::result_type> seeds(numBlocks);
+  for (size_t b = 0; b < numBlocks; ++b)
+    seeds[b] = math::randGen();
+
+  rules.SetQueryBlockSize(blockSize);
+
+  // Each query point only changes its own candidates and statistics, so the
+  // blocks can be traversed independently.
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    std::mt19937 generator(seeds[b]);
+    rules.BlockGenerator(b) = &generator;
+
+    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    const size_t end = std::min(((size_t) b + 1) * blockSize, numQueries);
+    for (size_t i = (size_t) b * blockSize; i < end; ++i)
+      traverser.Traverse(i, *referenceTree);
+
+    rules.BlockGenerator(b) = NULL;
+  }
+}
+
 template<typename SortPolicy,
          typename MetricType,
          typename MatType,
@@ -227,7 +227,28 @@ class RASearchRules
                  const double oldScore);
 
 
-  size_t NumDistComputations() { return numDistComputations; }
+  /**
+   * Give the query points their own random number generators for the sampling
+   * done during single-tree search: the query points are split into
+   * consecutive blocks of the given size, and the sampling for a query point
+   * uses the generator of its block, set with BlockGenerator(), instead of
+   * math::randGen.  Different blocks can then be traversed in parallel.
+   *
+   * @param blockSize Number of query points in each block.
+   */
+  void SetQueryBlockSize(const size_t blockSize)
+  {
+    queryBlockSize = blockSize;
+    blockGenerators.assign((querySet.n_cols + blockSize - 1) / blockSize, NULL);
+  }
+
+  //! Modify the random number generator of the given block of query points.
+  std::mt19937*& BlockGenerator(const size_t block)
+  {
+    return blockGenerators[block];
+  }
+
+  size_t NumDistComputations() { return arma::accu(numDistComputations); }
   size_t NumEffectiveSamples()
   {
     if (numSamplesMade.n_elem == 0)
@@ -290,8 +311,16 @@ class RASearchRules
   //! The sampling ratio.
   double samplingRatio;
 
-  //! The number of distance calculations performed during search.
-  size_t numDistComputations;
+  //! The number of distance calculations performed during search for every
+  //! query.
+  arma::Col<size_t> numDistComputations;
+
+  //! The number of query points in each block, if the blocks have their own
+  //! random number generators.
+  size_t queryBlockSize;
+
+  //! The random number generator of each block of query points.
+  std::vector<std::mt19937*> blockGenerators;
 
   //! If the query and reference set are identical, this is true.
   bool sameSet;
@@ -309,6 +338,16 @@ class RASearchRules
                       const size_t neighbor,
                       const double distance);
 
+  /**
+   * Obtain no more than numSamples distinct samples in [0, hiExclusive) for
+   * the given query point, with the random number generator of its block if
+   * there is one.
+   */
+  void ObtainDistinctSamples(const size_t queryIndex,
+                             const size_t hiExclusive,
+                             const size_t numSamples,
+                             arma::uvec& distinctSamples);
+
   /**
    * Perform actual scoring for single-tree case.
    */
@@ -0,0 +1,156 @@
+/**
+ * @file rating_strata.hpp
+ *
+ * Partition of a rating dataset into strata of user blocks and item blocks,
+ * used by the parallel SGD optimizers of the SVD-based factorizations.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_REGULARIZED_SVD_RATING_STRATA_HPP
+#define MLPACK_METHODS_REGULARIZED_SVD_RATING_STRATA_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * The users and the items of a rating dataset (with users in the first row and
+ * items in the second row) are each split into numBlocks blocks, so that the
+ * ratings are split into numBlocks x numBlocks strata.  This is the
+ * stratification of distributed stochastic gradient descent (DSGD), described
+ * in the following paper:
+ *
+ * @code
+ * @inproceedings{gemulla2011large,
+ *   title={Large-scale matrix factorization with distributed stochastic
+ *       gradient descent},
+ *   author={Gemulla, R. and Nijkamp, E. and Haas, P.J. and Sismanis, Y.},
+ *   booktitle={Proceedings of the 17th ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={69--77},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * In sub-epoch s, the thread of user block b processes the stratum of item
+ * block (b + s) % numBlocks.  The strata of one sub-epoch share no users and no
+ * items, so the threads never update the same parameters and need no
+ * synchronization, and after numBlocks sub-epochs every stratum has been
+ * processed.  Users and items are assigned to contiguous blocks with about the
+ * same number of ratings, so that the strata of a sub-epoch are balanced.
+ */
+class RatingStrata
+{
+ public:
+  /**
+   * Assign the users and items of the given dataset to blocks.
+   *
+   * @param data Rating dataset, with users in the first row and items in the
+   *     second row.
+   * @param numUsers Number of users.
+   * @param numItems Number of items.
+   * @param numBlocks Number of user blocks and of item blocks.
+   */
+  RatingStrata(const arma::mat& data,
+               const size_t numUsers,
+               const size_t numItems,
+               const size_t numBlocks) :
+      numBlocks(std::max(numBlocks, (size_t) 1))
+  {
+    arma::Col<size_t> userBlocks, itemBlocks;
+    Partition(data.row(0), numUsers, userBlocks);
+    Partition(data.row(1), numItems, itemBlocks);
+
+    strata.set_size(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      strata[i] = userBlocks[(size_t) data(0, i)] * this->numBlocks +
+          itemBlocks[(size_t) data(1, i)];
+    }
+  }
+
+  /**
+   * Sort the first count ratings of the given visitation order into their
+   * strata.  The ratings of each stratum keep their order of visitation.
+   *
+   * @param order Order in which the ratings are visited.
+   * @param count Number of ratings to visit.
+   */
+  void Assign(const arma::Col<size_t>& order, const size_t count)
+  {
+    offsets.zeros(numBlocks * numBlocks + 1);
+    for (size_t j = 0; j < count; ++j)
+      ++offsets[strata[order[j]] + 1];
+    for (size_t k = 1; k < offsets.n_elem; ++k)
+      offsets[k] += offsets[k - 1];
+
+    arma::Col<size_t> positions = offsets;
+    ratings.set_size(count);
+    for (size_t j = 0; j < count; ++j)
+      ratings[positions[strata[order[j]]]++] = order[j];
+  }
+
+  //! Get the number of user blocks and item blocks.
+  size_t NumBlocks() const { return numBlocks; }
+
+  //! Get the item block processed by the given user block in the given
+  //! sub-epoch.
+  size_t ItemBlock(const size_t userBlock, const size_t subEpoch) const
+  { return (userBlock + subEpoch) % numBlocks; }
+
+  //! Get the position in Ratings() of the first rating of the given stratum.
+  size_t Begin(const size_t userBlock, const size_t itemBlock) const
+  { return offsets[userBlock * numBlocks + itemBlock]; }
+
+  //! Get the position in Ratings() after the last rating of the given stratum.
+  size_t End(const size_t userBlock, const size_t itemBlock) const
+  { return offsets[userBlock * numBlocks + itemBlock + 1]; }
+
+  //! Get the assigned ratings, sorted by stratum.
+  const arma::Col<size_t>& Ratings() const { return ratings; }
+
+ private:
+  /**
+   * Split the given IDs into contiguous blocks with about the same number of
+   * ratings.
+   *
+   * @param ids ID of each rating.
+   * @param numIds Number of different IDs.
+   * @param blocks Resulting block of each ID.
+   */
+  void Partition(const arma::rowvec& ids,
+                 const size_t numIds,
+                 arma::Col<size_t>& blocks) const
+  {
+    arma::Col<size_t> counts(numIds, arma::fill::zeros);
+    for (size_t i = 0; i < ids.n_elem; ++i)
+      ++counts[(size_t) ids[i]];
+
+    blocks.set_size(numIds);
+    size_t seen = 0;
+    for (size_t i = 0; i < numIds; ++i)
+    {
+      blocks[i] = std::min(numBlocks - 1,
+          (seen * numBlocks) / std::max(ids.n_elem, (arma::uword) 1));
+      seen += counts[i];
+    }
+  }
+
+  //! Number of user blocks and item blocks.
+  size_t numBlocks;
+  //! Stratum of each rating.
+  arma::Col<size_t> strata;
+  //! Position in ratings of the first rating of each stratum.
+  arma::Col<size_t> offsets;
+  //! Assigned ratings, sorted by stratum.
+  arma::Col<size_t> ratings;
+};
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
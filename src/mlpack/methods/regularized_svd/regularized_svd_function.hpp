@@ -140,6 +140,10 @@ namespace ens {
    * because the gradient affects only a small number of parameters per example,
    * and thus the normal abstraction does not work as fast as we might like it
    * to.
+   *
+   * The parallel SGD optimizer splits the ratings into strata of user blocks
+   * and item blocks (see RatingStrata), and the threads process strata that
+   * share no users and no items, so that they never update the same parameters.
    */
   template <>
   template <>
@@ -14,6 +14,8 @@
 
 #include "regularized_svd_function.hpp"
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/util/threads.hpp>
+#include "rating_strata.hpp"
 
 namespace mlpack {
 namespace svd {
@@ -232,6 +234,13 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
       (function.NumFunctions() - 1), function.NumFunctions());
 
   const arma::mat data = function.Dataset();
+  const size_t numUsers = function.NumUsers();
+  const double lambda = function.Lambda();
+
+  // Split the ratings into one block of users and one block of items for each
+  // thread.
+  mlpack::svd::RatingStrata strata(data, numUsers, function.NumItems(),
+      mlpack::NumThreads());
 
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
@@ -274,45 +283,40 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
       std::shuffle(visitationOrder.begin(), visitationOrder.end(),
           mlpack::math::randGen);
 
-    #pragma omp parallel
+    // Each thread gets a share of threadShareSize ratings.
+    strata.Assign(visitationOrder, (threadShareSize >
+        visitationOrder.n_elem / strata.NumBlocks()) ? visitationOrder.n_elem :
+        threadShareSize * strata.NumBlocks());
+
+    // The strata processed by the threads in the same sub-epoch share no users
+    // and no items, so the updates need no synchronization.
+    for (size_t s = 0; s < strata.NumBlocks(); ++s)
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) strata.NumBlocks(); ++b)
       {
-        const size_t numUsers = function.NumUsers();
-
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
+        const size_t c = strata.ItemBlock(b, s);
+        for (size_t k = strata.Begin(b, c); k < strata.End(b, c); ++k)
+        {
+          const size_t j = strata.Ratings()[k];
 
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        double ratingError = rating - arma::dot(iterate.col(user),
-            iterate.col(item));
+          // Indices for accessing the the correct parameter columns.
+          const size_t user = data(0, j);
+          const size_t item = data(1, j) + numUsers;
 
-        double lambda = function.Lambda();
+          // Prediction error for the example.
+          const double rating = data(2, j);
+          double ratingError = rating - arma::dot(iterate.col(user),
+              iterate.col(item));
 
-        arma::mat userUpdate = stepSize * (lambda * iterate.col(user) -
-            ratingError * iterate.col(item));
-        arma::mat itemUpdate = stepSize * (lambda * iterate.col(item) -
-            ratingError * iterate.col(user));
+          arma::vec userUpdate = stepSize * (lambda * iterate.col(user) -
+              ratingError * iterate.col(item));
 
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < iterate.n_rows; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemUpdate(i);
+          // Gradient is non-zero only for the parameter columns corresponding
+          // to the example.
+          iterate.col(item) -= stepSize * (lambda * iterate.col(item) -
+              ratingError * iterate.col(user));
+          iterate.col(user) -= userUpdate;
         }
       }
     }
@@ -14,7 +14,7 @@
 #define MLPACK_METHODS_RL_ASYNC_LEARNING_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
-#include "queue"
+#include <atomic>
 
 namespace mlpack {
 namespace rl {
@@ -68,22 +68,21 @@ void AsyncLearning<
   NetworkType learningNetwork = std::move(this->learningNetwork);
   if (learningNetwork.Parameters().is_empty())
     learningNetwork.ResetParameters();
-  NetworkType targetNetwork = learningNetwork;
-  size_t totalSteps = 0;
+  TargetParameters targetParameters(learningNetwork.Parameters());
+  std::atomic<size_t> totalSteps(0);
   PolicyType policy = this->policy;
-  bool stop = false;
+  std::atomic<bool> stop(false);
 
-  // Set up worker pool, worker 0 will be deterministic for evaluation.
+  // Set up worker pool, worker 0 will be deterministic for evaluation.  The
+  // pool is reserved, so that the local networks of the workers are never
+  // copied once they are initialized.
   std::vector<WorkerType> workers;
+  workers.reserve(config.NumWorkers() + 1);
   for (size_t i = 0; i <= config.NumWorkers(); ++i)
   {
     workers.push_back(WorkerType(updater, environment, config, !i));
     workers.back().Initialize(learningNetwork);
   }
-  // Set up task queue corresponding to worker pool.
-  std::queue<size_t> tasks;
-  for (size_t i = 0; i <= config.NumWorkers(); ++i)
-    tasks.push(i);
 
   /**
    * Compute the number of threads for the for-loop. In general, we should use
@@ -95,9 +94,15 @@ void AsyncLearning<
   numThreads++;
   Log::Debug << numThreads << " threads will be used in total." << std::endl;
 
-  #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
-      targetNetwork, totalSteps, policy)
-  for (omp_size_t i = 0; i < numThreads; ++i)
+  /**
+   * The workers are assigned to the threads statically: thread i steps the
+   * workers i, i + numThreads, ... in turn.  So the threads never wait for
+   * each other: the shared network is updated without locking, the target
+   * network is double buffered, and the step counter is atomic.
+   */
+  #pragma omp parallel for shared(stop, workers, learningNetwork, \
+      targetParameters, totalSteps, policy)
+  for (omp_size_t i = 0; i < (omp_size_t) numThreads; ++i)
   {
     #pragma omp critical
     {
@@ -106,34 +111,26 @@ void AsyncLearning<
             " started." << std::endl;
       #endif
     }
-    size_t task = std::numeric_limits<size_t>::max();
-    while (!stop)
-    {
-      // Assign task to current thread from queue.
-      #pragma omp critical
-      {
-        if (task != std::numeric_limits<size_t>::max())
-          tasks.push(task);
-
-        if (!tasks.empty())
-        {
-          task = tasks.front();
-          tasks.pop();
-        }
-      };
 
-      // This may happen when threads are more than workers.
-      if (task == std::numeric_limits<size_t>::max())
-        continue;
+    // This may happen when threads are more than workers.
+    if ((size_t) i >= workers.size())
+      continue;
 
+    size_t task = i;
+    while (!stop)
+    {
       // Get corresponding worker.
       WorkerType& worker = workers[task];
       double episodeReturn;
-      if (worker.Step(learningNetwork, targetNetwork, totalSteps,
+      if (worker.Step(learningNetwork, targetParameters, totalSteps,
           policy, episodeReturn) && !task)
       {
         stop = measure(episodeReturn);
       }
+
+      task += numThreads;
+      if (task >= workers.size())
+        task = i;
     }
   }
 
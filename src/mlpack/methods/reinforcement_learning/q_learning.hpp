@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include "replay/random_replay.hpp"
+#include "replay/prioritized_replay.hpp"
 #include "training_config.hpp"
 
 namespace mlpack {
@@ -45,7 +46,8 @@ namespace rl {
  * @tparam NetworkType The network to compute action value.
  * @tparam UpdaterType How to apply gradients when training.
  * @tparam PolicyType Behavior policy of the agent.
- * @tparam ReplayType Experience replay method.
+ * @tparam ReplayType Experience replay method, such as RandomReplay or
+ *         PrioritizedReplay.
  */
 template <
   typename EnvironmentType,
@@ -95,6 +97,18 @@ class QLearning
    */
   double Episode();
 
+  /**
+   * Execute an episode in each of the given number of copies of the
+   * environment, stepped in lockstep.  The actions of all the copies that are
+   * still running are selected with a single batched forward pass of the
+   * learning network, and the learning network is trained once per lockstep
+   * on a sample of the replay memory, instead of once per transition.
+   *
+   * @param numEnvironments Number of copies of the environment.
+   * @return Return of the episode of each copy.
+   */
+  arma::colvec Episodes(const size_t numEnvironments);
+
   /**
    * @return Total steps from beginning.
    */
@@ -113,6 +127,17 @@ class QLearning
    */
   arma::Col<size_t> BestAction(const arma::mat& actionValues);
 
+  /**
+   * Train the learning network on a sample of the replay memory.
+   */
+  void TrainAgent();
+
+  /**
+   * Count a step of training: sync the target network and anneal the policy
+   * when needed.
+   */
+  void CountStep();
+
   //! Locally-stored hyper-parameters.
   TrainingConfig config;
 
@@ -113,6 +113,26 @@ double QLearning<
   if (deterministic || totalSteps < config.ExplorationSteps())
     return reward;
 
+  TrainAgent();
+
+  return reward;
+}
+
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::TrainAgent()
+{
   // Start experience replay.
 
   // Sample from previous experience.
@@ -142,8 +162,9 @@ double QLearning<
   }
 
   // Compute the update target.
-  arma::mat target;
-  learningNetwork.Forward(sampledStates, target);
+  arma::mat actionValues;
+  learningNetwork.Forward(sampledStates, actionValues);
+  arma::mat target = actionValues;
   /**
    * If the agent is at a terminal state, then we don't need to add the
    * discounted reward. At terminal state, the agent wont perform any
@@ -158,12 +179,39 @@ double QLearning<
           nextActionValues(bestActions[i], i);
   }
 
+  // Let the replay method update its memory, e.g. the priorities of the
+  // sampled transitions, from the temporal difference errors.
+  replayMethod.Update(sampledActions, actionValues, target);
+
   // Learn form experience.
   arma::mat gradients;
   learningNetwork.Backward(target, gradients);
   updater.Update(learningNetwork.Parameters(), config.StepSize(), gradients);
+}
 
-  return reward;
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+void QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::CountStep()
+{
+  totalSteps++;
+
+  // Update target network
+  if (totalSteps % config.TargetNetworkSyncInterval() == 0)
+    targetNetwork = learningNetwork;
+
+  if (totalSteps > config.ExplorationSteps())
+    policy.Anneal();
 }
 
 template <
@@ -202,17 +250,85 @@ double QLearning<
     if (deterministic)
       continue;
 
-    totalSteps++;
+    CountStep();
+  }
 
-    // Update target network
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-      targetNetwork = learningNetwork;
+  return totalReturn;
+}
 
-    if (totalSteps > config.ExplorationSteps())
-      policy.Anneal();
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+arma::colvec QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Episodes(const size_t numEnvironments)
+{
+  // The environments don't hold the state of an episode, so the copies of the
+  // environment only need their own state.
+  std::vector<StateType> states(numEnvironments);
+  std::vector<size_t> running;
+  for (size_t k = 0; k < numEnvironments; ++k)
+  {
+    states[k] = environment.InitialSample();
+    if (!environment.IsTerminal(states[k]))
+      running.push_back(k);
   }
 
-  return totalReturn;
+  // Track the return of each episode.
+  arma::colvec totalReturns(numEnvironments, arma::fill::zeros);
+
+  // Running until all copies get to a terminal state.
+  arma::mat encodedStates, actionValues;
+  for (size_t steps = 0; !running.empty(); ++steps)
+  {
+    if (config.StepLimit() && steps >= config.StepLimit())
+      break;
+
+    // Get the action values of all running copies at once.
+    encodedStates.set_size(StateType::dimension, running.size());
+    for (size_t j = 0; j < running.size(); ++j)
+      encodedStates.col(j) = states[running[j]].Encode();
+    learningNetwork.Predict(encodedStates, actionValues);
+
+    std::vector<size_t> stillRunning;
+    for (size_t j = 0; j < running.size(); ++j)
+    {
+      const size_t k = running[j];
+
+      // Select an action according to the behavior policy, and interact with
+      // the environment to advance to next state.
+      const ActionType action = policy.Sample(actionValues.col(j),
+          deterministic);
+      StateType nextState;
+      const double reward = environment.Sample(states[k], action, nextState);
+      const bool isEnd = environment.IsTerminal(nextState);
+
+      // Store the transition for replay.
+      replayMethod.Store(states[k], action, reward, nextState, isEnd);
+
+      states[k] = nextState;
+      totalReturns[k] += reward;
+      if (!isEnd)
+        stillRunning.push_back(k);
+
+      if (!deterministic)
+        CountStep();
+    }
+    running.swap(stillRunning);
+
+    if (!deterministic && totalSteps >= config.ExplorationSteps())
+      TrainAgent();
+  }
+
+  return totalReturns;
 }
 
 } // namespace rl
@@ -0,0 +1,317 @@
+/**
+ * @file compact_replay.hpp
+ *
+ * This file is an implementation of experience replay with a circular buffer
+ * of frames, where each state is stored once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_COMPACT_REPLAY_HPP
+#define MLPACK_METHODS_RL_REPLAY_COMPACT_REPLAY_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of random experience replay with compact storage.
+ *
+ * RandomReplay stores the state and the next state of each transition as two
+ * columns of doubles, so in a trajectory every state is stored twice.  The
+ * compact replay instead keeps the encoded states in a circular buffer of
+ * frames, of the given observation type (for instance float, or unsigned char
+ * for images), and each transition only holds the indices of the frames of
+ * its state and next state.  When a stored state equals the next state of the
+ * transition stored just before it, which is the case along a trajectory, the
+ * frame is shared, so a trajectory of n transitions takes n + 1 frames.  The
+ * buffer has capacity + 1 frames; when a frame is overwritten, the oldest
+ * transitions that use it are dropped.  So if the stored transitions are not
+ * consecutive (for instance when several environments are stepped in
+ * lockstep), each of them takes two frames and the memory holds about half of
+ * the capacity.
+ *
+ * The sampled states and next states are gathered with one conversion of the
+ * selected frames to the output matrices.
+ *
+ * With steps > 1, each sampled transition is extended in place with up to
+ * steps - 1 of the transitions that follow it in its trajectory, as the
+ * NStepQLearningWorker does: the sampled reward is the discounted return of
+ * these m transitions, and the sampled next state is the next state of the
+ * last one, which is terminal if one of them is.  The trajectory continues
+ * while the state of a transition is the frame of the next state of the
+ * previous one.  Since QLearning discounts the value of the sampled next
+ * state once, Update() rescales it by discount^(m - 1), so the discount must
+ * be the discount of the training configuration.
+ *
+ * @tparam EnvironmentType Desired task.
+ * @tparam ObservationType Type of the stored encoded states.
+ */
+template <typename EnvironmentType, typename ObservationType = float>
+class CompactReplay
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  /**
+   * Construct an instance of compact experience replay class.
+   *
+   * @param batchSize Number of examples returned at each sample.
+   * @param capacity Total memory size in terms of number of examples.
+   * @param steps Maximum number of transitions of each sampled return.
+   * @param discount Discount rate of the sampled returns.
+   * @param dimension The dimension of an encoded state.
+   */
+  CompactReplay(const size_t batchSize,
+                const size_t capacity,
+                const size_t steps = 1,
+                const double discount = 0.99,
+                const size_t dimension = StateType::dimension) :
+      batchSize(batchSize),
+      capacity(capacity),
+      steps(std::max(steps, (size_t) 1)),
+      discount(discount),
+      frames(dimension, capacity + 1),
+      nextFrame(0),
+      lastFrame(capacity + 1),
+      start(0),
+      size(0),
+      stateFrames(capacity),
+      nextStateFrames(capacity),
+      actions(capacity),
+      rewards(capacity),
+      isTerminal(capacity)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Store the given experience.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   */
+  void Store(const StateType& state,
+             ActionType action,
+             double reward,
+             const StateType& nextState,
+             bool isEnd)
+  {
+    const arma::Col<ObservationType> encoded =
+        arma::conv_to<arma::Col<ObservationType>>::from(state.Encode());
+
+    size_t stateFrame;
+    if (lastFrame <= capacity && arma::all(frames.col(lastFrame) == encoded))
+      stateFrame = lastFrame;
+    else
+      stateFrame = WriteFrame(encoded);
+
+    const size_t nextStateFrame = WriteFrame(
+        arma::conv_to<arma::Col<ObservationType>>::from(nextState.Encode()));
+    lastFrame = nextStateFrame;
+
+    if (size == capacity)
+      Pop();
+
+    const size_t position = (start + size) % capacity;
+    stateFrames[position] = stateFrame;
+    nextStateFrames[position] = nextStateFrame;
+    actions(position) = action;
+    rewards(position) = reward;
+    isTerminal(position) = isEnd;
+    ++size;
+  }
+
+  /**
+   * Sample some experiences.
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards, or returns if steps > 1.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   */
+  void Sample(arma::mat& sampledStates,
+              arma::icolvec& sampledActions,
+              arma::colvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::icolvec& isTerminal)
+  {
+    sampledIndices = arma::randi<arma::uvec>(batchSize,
+        arma::distr_param(0, size - 1));
+
+    arma::uvec sampledStateFrames(batchSize);
+    arma::uvec sampledNextStateFrames(batchSize);
+    sampledActions.set_size(batchSize);
+    sampledRewards.set_size(batchSize);
+    isTerminal.set_size(batchSize);
+    bootstrapScales.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      // Walk along the trajectory of the sampled transition.
+      size_t t = (start + sampledIndices[i]) % capacity;
+      sampledStateFrames[i] = stateFrames[t];
+      sampledActions[i] = actions(t);
+
+      double sampledReturn = rewards(t);
+      double scale = 1.0;
+      for (size_t k = sampledIndices[i] + 1; k < std::min(size,
+          sampledIndices[i] + steps); ++k)
+      {
+        const size_t next = (start + k) % capacity;
+        if (this->isTerminal(t) || stateFrames[next] != nextStateFrames[t])
+          break;
+
+        scale *= discount;
+        sampledReturn += scale * rewards(next);
+        t = next;
+      }
+
+      sampledNextStateFrames[i] = nextStateFrames[t];
+      sampledRewards[i] = sampledReturn;
+      isTerminal[i] = this->isTerminal(t);
+      bootstrapScales[i] = scale;
+    }
+
+    sampledStates = arma::conv_to<arma::mat>::from(
+        frames.cols(sampledStateFrames));
+    sampledNextStates = arma::conv_to<arma::mat>::from(
+        frames.cols(sampledNextStateFrames));
+    this->sampledRewards = sampledRewards;
+  }
+
+  /**
+   * Update the targets of the last sampled experiences.  QLearning computes
+   * each target as the sampled return plus the discounted value of the sampled
+   * next state, so for the returns of m > 1 transitions the value is rescaled
+   * by discount^(m - 1).  The memory is not changed.
+   *
+   * @param sampledActions The actions of the last sampled experiences.
+   * @param actionValues The action values predicted for the sampled states.
+   * @param target The targets of the sampled experiences.
+   */
+  void Update(const arma::icolvec& sampledActions,
+              const arma::mat& /* actionValues */,
+              arma::mat& target)
+  {
+    for (size_t i = 0; i < sampledIndices.n_elem; ++i)
+    {
+      double& value = target(sampledActions[i], i);
+      value = sampledRewards[i] + bootstrapScales[i] *
+          (value - sampledRewards[i]);
+    }
+  }
+
+  /**
+   * Get the number of transitions in the memory.
+   *
+   * @return Actual used memory size
+   */
+  const size_t& Size()
+  {
+    return size;
+  }
+
+  //! Get the indices of the last sampled experiences, from the oldest stored
+  //! experience.
+  const arma::uvec& SampledIndices() const { return sampledIndices; }
+
+  //! Get the maximum number of transitions of each sampled return.
+  size_t Steps() const { return steps; }
+
+  //! Get the discount rate of the sampled returns.
+  double Discount() const { return discount; }
+
+  //! Get the stored frames.
+  const arma::Mat<ObservationType>& Frames() const { return frames; }
+
+ private:
+  //! Write the given encoded state in the next frame, and drop the
+  //! transitions that used it; return the index of the frame.
+  size_t WriteFrame(const arma::Col<ObservationType>& encoded)
+  {
+    // The frames of the stored transitions are in the order they were
+    // written, so only the oldest transitions can use the oldest frame.
+    while (size > 0 && (stateFrames[start] == nextFrame ||
+        nextStateFrames[start] == nextFrame))
+      Pop();
+
+    const size_t frame = nextFrame;
+    frames.col(frame) = encoded;
+    nextFrame = (nextFrame + 1) % frames.n_cols;
+    return frame;
+  }
+
+  //! Drop the oldest transition.
+  void Pop()
+  {
+    start = (start + 1) % capacity;
+    --size;
+  }
+
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
+
+  //! Locally-stored total memory limit.
+  size_t capacity;
+
+  //! Locally-stored maximum number of transitions of each sampled return.
+  size_t steps;
+
+  //! Locally-stored discount rate of the sampled returns.
+  double discount;
+
+  //! Locally-stored circular buffer of encoded states.
+  arma::Mat<ObservationType> frames;
+
+  //! The index of the next frame to write.
+  size_t nextFrame;
+
+  //! The frame of the last stored next state, or capacity + 1 if none.
+  size_t lastFrame;
+
+  //! The position of the oldest transition.
+  size_t start;
+
+  //! The number of stored transitions.
+  size_t size;
+
+  //! Locally-stored frames of the previous states.
+  arma::uvec stateFrames;
+
+  //! Locally-stored frames of the previous next states.
+  arma::uvec nextStateFrames;
+
+  //! Locally-stored previous actions.
+  arma::icolvec actions;
+
+  //! Locally-stored previous rewards.
+  arma::colvec rewards;
+
+  //! Locally-stored termination information of previous experience.
+  arma::icolvec isTerminal;
+
+  //! The indices of the last sampled experiences.
+  arma::uvec sampledIndices;
+
+  //! The returns of the last sampled experiences.
+  arma::colvec sampledRewards;
+
+  //! The rescaling of the value of the next state of the last sampled
+  //! experiences.
+  arma::colvec bootstrapScales;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
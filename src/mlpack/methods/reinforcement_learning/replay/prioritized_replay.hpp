@@ -0,0 +1,269 @@
+/**
+ * @file prioritized_replay.hpp
+ *
+ * This file is an implementation of prioritized experience replay.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_PRIORITIZED_REPLAY_HPP
+#define MLPACK_METHODS_RL_REPLAY_PRIORITIZED_REPLAY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "sum_tree.hpp"
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * Implementation of prioritized experience replay.
+ *
+ * Like random experience replay, the interactions between the agent and the
+ * environment are saved to a First-In-First-Out buffer.  However, each
+ * transition is sampled with a probability proportional to its priority
+ * p_i^alpha, where the priority is the absolute temporal difference error of
+ * the transition the last time it was replayed, so that the agent replays more
+ * often the transitions it has the most to learn from.  New transitions get
+ * the largest priority seen so far, so that they are replayed at least once.
+ * The priorities are stored in a sum tree, so that storing, sampling and
+ * updating a transition take O(log n) time.
+ *
+ * Since the sampling is not uniform anymore, the update of each sampled
+ * transition is weighted by the importance-sampling weight
+ * (N * P(i))^-beta, normalized by the largest weight of the batch.  The
+ * weights are applied by QLearning through Update(), which moves the target
+ * of each transition towards the current action value; for the mean squared
+ * error loss this scales the gradient of the transition by its weight.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{schaul2015prioritized,
+ *  title   = {Prioritized Experience Replay},
+ *  author  = {Schaul, Tom and Quan, John and Antonoglou, Ioannis and
+ *             Silver, David},
+ *  journal = {arXiv preprint arXiv:1511.05952},
+ *  year    = {2015}
+ * }
+ * @endcode
+ *
+ * @tparam EnvironmentType Desired task.
+ */
+template <typename EnvironmentType>
+class PrioritizedReplay
+{
+ public:
+  //! Convenient typedef for action.
+  using ActionType = typename EnvironmentType::Action;
+
+  //! Convenient typedef for state.
+  using StateType = typename EnvironmentType::State;
+
+  /**
+   * Construct an instance of prioritized experience replay class.
+   *
+   * @param batchSize Number of examples returned at each sample.
+   * @param capacity Total memory size in terms of number of examples.
+   * @param alpha How much prioritization is used; 0 is uniform sampling.
+   * @param beta Exponent of the importance-sampling weights; 1 fully
+   *        compensates the non-uniform sampling.
+   * @param dimension The dimension of an encoded state.
+   */
+  PrioritizedReplay(const size_t batchSize,
+                    const size_t capacity,
+                    const double alpha = 0.6,
+                    const double beta = 0.4,
+                    const size_t dimension = StateType::dimension) :
+      batchSize(batchSize),
+      capacity(capacity),
+      position(0),
+      states(dimension, capacity),
+      actions(capacity),
+      rewards(capacity),
+      nextStates(dimension, capacity),
+      isTerminal(capacity),
+      full(false),
+      alpha(alpha),
+      beta(beta),
+      maxPriority(1.0),
+      priorities(capacity)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Store the given experience, with the largest priority seen so far.
+   *
+   * @param state Given state.
+   * @param action Given action.
+   * @param reward Given reward.
+   * @param nextState Given next state.
+   * @param isEnd Whether next state is terminal state.
+   */
+  void Store(const StateType& state,
+             ActionType action,
+             double reward,
+             const StateType& nextState,
+             bool isEnd)
+  {
+    states.col(position) = state.Encode();
+    actions(position) = action;
+    rewards(position) = reward;
+    nextStates.col(position) = nextState.Encode();
+    isTerminal(position) = isEnd;
+    priorities.Set(position, maxPriority);
+    position++;
+    if (position == capacity)
+    {
+      full = true;
+      position = 0;
+    }
+  }
+
+  /**
+   * Sample some experiences proportionally to their priority.  The range of
+   * the priorities is split in batchSize segments of equal mass, and one
+   * experience is drawn from each.  The indices and the importance-sampling
+   * weights of the sampled experiences are kept for Update().
+   *
+   * @param sampledStates Sampled encoded states.
+   * @param sampledActions Sampled actions.
+   * @param sampledRewards Sampled rewards.
+   * @param sampledNextStates Sampled encoded next states.
+   * @param isTerminal Indicate whether corresponding next state is terminal
+   *        state.
+   */
+  void Sample(arma::mat& sampledStates,
+              arma::icolvec& sampledActions,
+              arma::colvec& sampledRewards,
+              arma::mat& sampledNextStates,
+              arma::icolvec& isTerminal)
+  {
+    const double total = priorities.Sum();
+    const double segment = total / batchSize;
+
+    sampledIndices.set_size(batchSize);
+    weights.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+    {
+      sampledIndices[i] = priorities.FindPrefixSum(
+          math::Random(i * segment, (i + 1) * segment));
+
+      const double probability = priorities.Get(sampledIndices[i]) / total;
+      weights[i] = std::pow(Size() * probability, -beta);
+    }
+    weights /= weights.max();
+
+    sampledStates = states.cols(sampledIndices);
+    sampledActions = actions.elem(sampledIndices);
+    sampledRewards = rewards.elem(sampledIndices);
+    sampledNextStates = nextStates.cols(sampledIndices);
+    isTerminal = this->isTerminal.elem(sampledIndices);
+  }
+
+  /**
+   * Update the priorities of the last sampled experiences with their temporal
+   * difference errors, and weight their targets by the importance-sampling
+   * weights.  The priorities of the whole batch are set at once.
+   *
+   * @param sampledActions The actions of the last sampled experiences.
+   * @param actionValues The action values predicted for the sampled states.
+   * @param target The targets of the sampled experiences, which are moved
+   *        towards the predicted action values by their weights.
+   */
+  void Update(const arma::icolvec& sampledActions,
+              const arma::mat& actionValues,
+              arma::mat& target)
+  {
+    arma::colvec newPriorities(sampledIndices.n_elem);
+    for (size_t i = 0; i < sampledIndices.n_elem; ++i)
+    {
+      const double value = actionValues(sampledActions[i], i);
+      const double tdError = target(sampledActions[i], i) - value;
+      target(sampledActions[i], i) = value + weights[i] * tdError;
+
+      newPriorities[i] = std::pow(std::abs(tdError) + 1e-6, alpha);
+    }
+
+    maxPriority = std::max(maxPriority, newPriorities.max());
+    priorities.Set(sampledIndices, newPriorities);
+  }
+
+  /**
+   * Get the number of transitions in the memory.
+   *
+   * @return Actual used memory size
+   */
+  const size_t& Size()
+  {
+    return full ? capacity : position;
+  }
+
+  //! Get the importance-sampling weights of the last sampled experiences.
+  const arma::colvec& Weights() const { return weights; }
+
+  //! Get the indices of the last sampled experiences.
+  const arma::uvec& SampledIndices() const { return sampledIndices; }
+
+  //! Get the prioritization exponent.
+  double Alpha() const { return alpha; }
+  //! Modify the prioritization exponent.
+  double& Alpha() { return alpha; }
+
+  //! Get the importance-sampling exponent.
+  double Beta() const { return beta; }
+  //! Modify the importance-sampling exponent; it is typically annealed to 1
+  //! over the training.
+  double& Beta() { return beta; }
+
+ private:
+  //! Locally-stored number of examples of each sample.
+  size_t batchSize;
+
+  //! Locally-stored total memory limit.
+  size_t capacity;
+
+  //! Indicate the position to store new transition.
+  size_t position;
+
+  //! Locally-stored encoded previous states.
+  arma::mat states;
+
+  //! Locally-stored previous actions.
+  arma::icolvec actions;
+
+  //! Locally-stored previous rewards.
+  arma::colvec rewards;
+
+  //! Locally-stored encoded previous next states.
+  arma::mat nextStates;
+
+  //! Locally-stored termination information of previous experience.
+  arma::icolvec isTerminal;
+
+  //! Locally-stored indicator that whether the memory is full or not
+  bool full;
+
+  //! Locally-stored prioritization exponent.
+  double alpha;
+
+  //! Locally-stored importance-sampling exponent.
+  double beta;
+
+  //! The largest priority so far, given to new experiences.
+  double maxPriority;
+
+  //! The priorities of the stored experiences.
+  SumTree<double> priorities;
+
+  //! The indices of the last sampled experiences.
+  arma::uvec sampledIndices;
+
+  //! The importance-sampling weights of the last sampled experiences.
+  arma::colvec weights;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -125,6 +125,19 @@ class RandomReplay
     isTerminal = this->isTerminal.elem(sampledIndices);
   }
 
+  /**
+   * Update the memory after the targets of the last sampled experiences have
+   * been computed.  Random replay samples uniformly, so this does nothing.
+   *
+   * @param sampledActions The actions of the last sampled experiences.
+   * @param actionValues The action values predicted for the sampled states.
+   * @param target The targets of the sampled experiences.
+   */
+  void Update(const arma::icolvec& /* sampledActions */,
+              const arma::mat& /* actionValues */,
+              arma::mat& /* target */)
+  { /* Nothing to do here. */ }
+
   /**
    * Get the number of transitions in the memory.
    *
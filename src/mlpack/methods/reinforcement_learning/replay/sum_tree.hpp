@@ -0,0 +1,142 @@
+/**
+ * @file sum_tree.hpp
+ *
+ * Definition of the SumTree class, which stores nonnegative values so that
+ * they can be sampled proportionally to their value in logarithmic time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_REPLAY_SUM_TREE_HPP
+#define MLPACK_METHODS_RL_REPLAY_SUM_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * A sum tree is a complete binary tree whose leaves hold the stored values and
+ * whose internal nodes hold the sum of their children.  Setting a value and
+ * finding the value where a given prefix sum is reached both take O(log n)
+ * time, so that values can be sampled proportionally by drawing a uniform
+ * number in [0, Sum()) and calling FindPrefixSum().
+ *
+ * The nodes are stored in an array: the root is node 1, the children of node i
+ * are the nodes 2i and 2i + 1, and the leaves are the last nodes.
+ *
+ * @tparam ElemType Type of the stored values.
+ */
+template<typename ElemType = double>
+class SumTree
+{
+ public:
+  /**
+   * Create a sum tree of the given capacity, with all values set to zero.
+   *
+   * @param capacity Number of values the tree holds.
+   */
+  SumTree(const size_t capacity = 0) : capacity(capacity), leaves(1)
+  {
+    while (leaves < capacity)
+      leaves *= 2;
+
+    nodes.zeros(2 * leaves);
+  }
+
+  /**
+   * Set the value at the given index.
+   *
+   * @param index Index of the value, smaller than Capacity().
+   * @param value The new value, nonnegative.
+   */
+  void Set(const size_t index, const ElemType value)
+  {
+    size_t node = leaves + index;
+    nodes[node] = value;
+    for (node /= 2; node > 0; node /= 2)
+      nodes[node] = nodes[2 * node] + nodes[2 * node + 1];
+  }
+
+  /**
+   * Set the values at the given indices.  The ancestors of the changed leaves
+   * are recomputed level by level, so that a node that is shared by several of
+   * them is only recomputed once.  If an index is given several times, its
+   * last value is kept.
+   *
+   * @param indices Indices of the values, smaller than Capacity().
+   * @param values The new values, nonnegative.
+   */
+  void Set(const arma::uvec& indices, const arma::Col<ElemType>& values)
+  {
+    if (indices.is_empty())
+      return;
+
+    for (size_t i = 0; i < indices.n_elem; ++i)
+      nodes[leaves + indices[i]] = values[i];
+
+    arma::uvec parents = arma::unique((indices + leaves) / 2);
+    while (parents[0] > 0)
+    {
+      for (size_t i = 0; i < parents.n_elem; ++i)
+        nodes[parents[i]] = nodes[2 * parents[i]] + nodes[2 * parents[i] + 1];
+
+      parents = arma::unique(parents / 2);
+    }
+  }
+
+  //! Get the value at the given index.
+  ElemType Get(const size_t index) const { return nodes[leaves + index]; }
+
+  //! Get the sum of all values.
+  ElemType Sum() const { return nodes[1]; }
+
+  //! Get the number of values the tree holds.
+  size_t Capacity() const { return capacity; }
+
+  /**
+   * Find the index of the value where the running sum of the values exceeds
+   * the given mass, that is the smallest index i such that the sum of the
+   * values 0 to i is larger than mass.  Only indices of nonzero values are
+   * returned, even if mass is at least Sum() because of rounding.
+   *
+   * @param mass The prefix sum to find, in [0, Sum()).
+   */
+  size_t FindPrefixSum(ElemType mass) const
+  {
+    size_t node = 1;
+    while (node < leaves)
+    {
+      const size_t left = 2 * node;
+      if (mass < nodes[left] || nodes[left + 1] == 0)
+      {
+        node = left;
+      }
+      else
+      {
+        mass -= nodes[left];
+        node = left + 1;
+      }
+    }
+
+    return node - leaves;
+  }
+
+ private:
+  //! The number of values the tree holds.
+  size_t capacity;
+
+  //! The number of leaves, the smallest power of two that is at least the
+  //! capacity.
+  size_t leaves;
+
+  //! The values of the nodes; node 0 is unused.
+  arma::Col<ElemType> nodes;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
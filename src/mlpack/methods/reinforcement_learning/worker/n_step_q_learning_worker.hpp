@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_RL_WORKER_N_STEP_Q_LEARNING_WORKER_HPP
 
 #include <mlpack/methods/reinforcement_learning/training_config.hpp>
+#include "target_parameters.hpp"
 
 namespace mlpack {
 namespace rl {
@@ -68,15 +69,22 @@ class NStepQLearningWorker
   {
     updater.Initialize(learningNetwork.Parameters().n_rows,
         learningNetwork.Parameters().n_cols);
-    // Build local network.
+    // Build the local networks.  Their layers are reset so that they use the
+    // parameters of the network, which are then the only thing to sync.
     network = learningNetwork;
+    network.ResetParameters();
+    network.Parameters() = learningNetwork.Parameters();
+    targetNetwork = network;
+    targetNetwork.ResetParameters();
+    targetNetwork.Parameters() = learningNetwork.Parameters();
+    targetVersion = 0;
   }
 
   /**
    * The agent will execute one step.
    *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
+   * @param targetParameters The shared parameters of the target network.
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -84,8 +92,8 @@ class NStepQLearningWorker
    * @return Indicate whether current episode ends after this step.
    */
   bool Step(NetworkType& learningNetwork,
-            NetworkType& targetNetwork,
-            size_t& totalSteps,
+            TargetParameters& targetParameters,
+            std::atomic<size_t>& totalSteps,
             PolicyType& policy,
             double& totalReward)
   {
@@ -108,15 +116,14 @@ class NStepQLearningWorker
         totalReward = episodeReturn;
         Reset();
         // Sync with latest learning network.
-        network = learningNetwork;
+        network.Parameters() = learningNetwork.Parameters();
         return true;
       }
       state = nextState;
       return false;
     }
 
-    #pragma omp atomic
-    totalSteps++;
+    const size_t step = ++totalSteps;
 
     pending[pendingIndex] = std::make_tuple(state, action, reward, nextState);
     pendingIndex++;
@@ -132,8 +139,8 @@ class NStepQLearningWorker
       double target = 0;
       if (!terminal)
       {
-        #pragma omp critical
-        { targetNetwork.Predict(nextState.Encode(), actionValue); };
+        targetParameters.Fetch(targetNetwork.Parameters(), targetVersion);
+        targetNetwork.Predict(nextState.Encode(), actionValue);
         target = actionValue.max();
       }
 
@@ -166,17 +173,15 @@ class NStepQLearningWorker
           config.StepSize(), totalGradients);
 
       // Sync the local network with the global network.
-      network = learningNetwork;
+      network.Parameters() = learningNetwork.Parameters();
 
       pendingIndex = 0;
     }
 
-    // Update global target network.
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
-    {
-      #pragma omp critical
-      { targetNetwork = learningNetwork; }
-    }
+    // Update global target network; only the worker that made the step
+    // publishes it.
+    if (step % config.TargetNetworkSyncInterval() == 0)
+      targetParameters.Publish(learningNetwork.Parameters());
 
     policy.Anneal();
 
@@ -229,6 +234,12 @@ class NStepQLearningWorker
   //! Local network of the worker.
   NetworkType network;
 
+  //! Local copy of the target network.
+  NetworkType targetNetwork;
+
+  //! The version of the parameters of the local target network.
+  size_t targetVersion;
+
   //! Current state of the agent.
   StateType state;
 };
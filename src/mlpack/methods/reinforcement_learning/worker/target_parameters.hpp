@@ -0,0 +1,91 @@
+/**
+ * @file target_parameters.hpp
+ *
+ * Definition of the TargetParameters class, which shares the parameters of the
+ * target network between the asynchronous workers without locking.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_WORKER_TARGET_PARAMETERS_HPP
+#define MLPACK_METHODS_RL_WORKER_TARGET_PARAMETERS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <atomic>
+
+namespace mlpack {
+namespace rl {
+
+/**
+ * The target parameters are double buffered: Publish() writes the new
+ * parameters into the inactive buffer and then makes it the active one by
+ * increasing the version, and each worker keeps a local target network that
+ * Fetch() only copies the active buffer into when the version changed.  So
+ * the workers predict with their own copy, and never wait for each other.
+ *
+ * Publish() is called by a single worker every TargetNetworkSyncInterval()
+ * steps; a fetch that overlaps a publish reads the previous buffer, which is
+ * only rewritten by the next publish.
+ */
+class TargetParameters
+{
+ public:
+  /**
+   * Create the shared target parameters.
+   *
+   * @param parameters The initial parameters of the target network.
+   */
+  TargetParameters(const arma::mat& parameters) : version(0)
+  {
+    buffers[0] = parameters;
+    buffers[1] = parameters;
+  }
+
+  /**
+   * Make the given parameters the parameters of the target network.
+   *
+   * @param parameters The new parameters of the target network.
+   */
+  void Publish(const arma::mat& parameters)
+  {
+    const size_t next = version.load() + 1;
+    buffers[next % 2] = parameters;
+    version.store(next);
+  }
+
+  /**
+   * Copy the parameters of the target network into the given matrix, if they
+   * changed since the given version.
+   *
+   * @param parameters The local parameters of the target network.
+   * @param localVersion The version of the local parameters; it is updated.
+   * @return Whether the parameters were copied.
+   */
+  bool Fetch(arma::mat& parameters, size_t& localVersion) const
+  {
+    const size_t latest = version.load();
+    if (latest == localVersion)
+      return false;
+
+    parameters = buffers[latest % 2];
+    localVersion = latest;
+    return true;
+  }
+
+  //! Get the number of times the parameters were published.
+  size_t Version() const { return version.load(); }
+
+ private:
+  //! The two buffers of the parameters.
+  arma::mat buffers[2];
+
+  //! The number of publishes; the active buffer is version % 2.
+  std::atomic<size_t> version;
+};
+
+} // namespace rl
+} // namespace mlpack
+
+#endif
@@ -55,6 +55,18 @@ namespace regression {
  * // Obtain predictions from both the learned models.
  * regressor.Classify(testData, predictions);
  * @endcode
+ *
+ * The training and test data may be given as any dense or sparse Armadillo
+ * matrix type, such as arma::sp_mat for high-dimensional sparse data (e.g.
+ * bag-of-words features) or arma::fmat for single-precision data; the data is
+ * never converted to a dense arma::mat.  The model parameters are always an
+ * arma::mat, so a model trained on one matrix type can classify points of
+ * another.
+ *
+ * @code
+ * arma::sp_mat sparseData; // Sparse training data matrix.
+ * SoftmaxRegression sparseRegressor(sparseData, labels, numClasses);
+ * @endcode
  */
 class SoftmaxRegression
 {
@@ -79,6 +91,7 @@ class SoftmaxRegression
    * function. By default, the model takes a small value.
    *
    * @tparam OptimizerType Desired optimizer type.
+   * @tparam MatType Type of the training data (dense or sparse).
    * @param data Input training features. Each column associate with one sample
    * @param labels Labels associated with the feature data.
    * @param inputSize Size of the input feature vector.
@@ -87,8 +100,8 @@ class SoftmaxRegression
    * @param lambda L2-regularization constant.
    * @param fitIntercept add intercept term or not.
    */
-  template<typename OptimizerType = ens::L_BFGS>
-  SoftmaxRegression(const arma::mat& data,
+  template<typename OptimizerType = ens::L_BFGS, typename MatType = arma::mat>
+  SoftmaxRegression(const MatType& data,
                     const arma::Row<size_t>& labels,
                     const size_t numClasses,
                     const double lambda = 0.0001,
@@ -104,7 +117,8 @@ class SoftmaxRegression
    * @param dataset Set of points to classify.
    * @param labels Predicted labels for each point.
    */
-  void Classify(const arma::mat& dataset, arma::Row<size_t>& labels) const;
+  template<typename MatType>
+  void Classify(const MatType& dataset, arma::Row<size_t>& labels) const;
 
   /**
    * Classify the given point. The predicted class label is returned.
@@ -128,7 +142,8 @@ class SoftmaxRegression
    * @param labels Predicted labels for each point.
    * @param probabilities Class probabilities for each point.
    */
-  void Classify(const arma::mat& dataset,
+  template<typename MatType>
+  void Classify(const MatType& dataset,
                 arma::Row<size_t>& labels,
                 arma::mat& probabilites) const;
 
@@ -138,7 +153,8 @@ class SoftmaxRegression
    * @param dataset Matrix of data points to be classified.
    * @param probabilities Class probabilities for each point.
    */
-  void Classify(const arma::mat& dataset,
+  template<typename MatType>
+  void Classify(const MatType& dataset,
                 arma::mat& probabilities) const;
 
   /**
@@ -149,21 +165,23 @@ class SoftmaxRegression
    * @param testData Matrix of data points using which predictions are made.
    * @param labels Vector of labels associated with the data.
    */
-  double ComputeAccuracy(const arma::mat& testData,
+  template<typename MatType>
+  double ComputeAccuracy(const MatType& testData,
                          const arma::Row<size_t>& labels) const;
 
   /**
    * Train the softmax regression with the given training data.
    *
    * @tparam OptimizerType Desired optimizer type.
+   * @tparam MatType Type of the training data (dense or sparse).
    * @param data Input data with each column as one example.
    * @param labels Labels associated with the feature data.
    * @param numClasses Number of classes for classification.
    * @param optimizer Desired optimizer.
    * @return Objective value of the final point.
    */
-  template<typename OptimizerType = ens::L_BFGS>
-  double Train(const arma::mat& data,
+  template<typename OptimizerType = ens::L_BFGS, typename MatType = arma::mat>
+  double Train(const MatType& data,
                const arma::Row<size_t>& labels,
                const size_t numClasses,
                OptimizerType optimizer = OptimizerType());
@@ -215,6 +233,53 @@ class SoftmaxRegression
 };
 
 } // namespace regression
+
+namespace cv {
+
+/**
+ * SoftmaxRegression models are warm-started in cross-validation by training
+ * them from their current parameters with the new lambda.  The parameters
+ * have another shape if the intercept flag changes, so the model is then
+ * trained from scratch.
+ */
+template<>
+struct WarmStartTraits<regression::SoftmaxRegression>
+{
+  static const bool IsSupported = true;
+
+  template<typename MatType>
+  static void Train(regression::SoftmaxRegression& model,
+                    const MatType& data,
+                    const arma::Row<size_t>& labels,
+                    const size_t numClasses,
+                    const double lambda = 0.0001,
+                    const bool fitIntercept = false)
+  {
+    if (model.FitIntercept() != fitIntercept ||
+        model.NumClasses() != numClasses)
+    {
+      model = regression::SoftmaxRegression(data, labels, numClasses, lambda,
+          fitIntercept);
+      return;
+    }
+
+    model.Lambda() = lambda;
+    model.Train(data, labels, numClasses);
+  }
+
+  //! Train from scratch with other arguments (like an optimizer).
+  template<typename MatType, typename... Args>
+  static void Train(regression::SoftmaxRegression& model,
+                    const MatType& data,
+                    const arma::Row<size_t>& labels,
+                    const size_t numClasses,
+                    const Args&... args)
+  {
+    model = regression::SoftmaxRegression(data, labels, numClasses, args...);
+  }
+};
+
+} // namespace cv
 } // namespace mlpack
 
 // Include implementation.
@@ -18,6 +18,23 @@
 namespace mlpack {
 namespace regression {
 
+/**
+ * The objective function of softmax regression, to be optimized with any
+ * ensmallen optimizer.  The training data may be dense or sparse, and may hold
+ * any element type (for instance, arma::fmat or arma::sp_fmat); the parameters
+ * are always an arma::mat.  Products between the parameters and the data are
+ * carried out in the element type of the data, so neither a sparse dataset nor
+ * a single-precision dataset is ever converted to a dense arma::mat.
+ *
+ * The objective and the gradient are computed in parallel over blocks of
+ * points, and each thread keeps the probabilities of its blocks in a workspace
+ * that is reused by the next calls, so the memory used doesn't grow with the
+ * size of the batch.  Because of these workspaces, the same function must not
+ * be evaluated by several threads at once.
+ *
+ * @tparam MatType Type of the training data matrix.
+ */
+template<typename MatType = arma::mat>
 class SoftmaxRegressionFunction
 {
  public:
@@ -32,7 +49,7 @@ class SoftmaxRegressionFunction
    * @param lambda L2-regularization constant.
    * @param fitIntercept Intercept term flag.
    */
-  SoftmaxRegressionFunction(const arma::mat& data,
+  SoftmaxRegressionFunction(const MatType& data,
                             const arma::Row<size_t>& labels,
                             const size_t numClasses,
                             const double lambda = 0.0001,
@@ -42,7 +59,9 @@ class SoftmaxRegressionFunction
   const arma::mat InitializeWeights();
 
   /**
-   * Shuffle the dataset.
+   * Shuffle the dataset.  The data is not copied: only the order in which the
+   * batches visit the points is shuffled, and each batch is gathered through
+   * it.
    */
   void Shuffle();
 
@@ -98,6 +117,23 @@ class SoftmaxRegressionFunction
                               const size_t start,
                               const size_t batchSize) const;
 
+  /**
+   * Compute the class probabilities of the given points with the given
+   * parameters.  This is what GetProbabilitiesMatrix() computes on the training
+   * data, and what SoftmaxRegression::Classify() computes on test points.
+   *
+   * @tparam InputType Type of the points (a dense or sparse matrix or view).
+   * @param parameters Model parameters.
+   * @param points Points to compute the class probabilities of.
+   * @param fitIntercept Whether parameters.col(0) is the intercept term.
+   * @param probabilities Matrix to store the class probabilities in.
+   */
+  template<typename InputType>
+  static void ComputeProbabilities(const arma::mat& parameters,
+                                   const InputType& points,
+                                   const bool fitIntercept,
+                                   arma::mat& probabilities);
+
   /**
    * Evaluates the objective function of the softmax regression model using the
    * given parameters. The cost function has terms for the log likelihood error
@@ -151,6 +187,30 @@ class SoftmaxRegressionFunction
                 arma::mat& gradient,
                 const size_t batchSize = 1) const;
 
+  /**
+   * Evaluate the objective function and its gradient given the current set of
+   * parameters, computing the class probabilities only once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the objective function and its gradient on a subset of the data,
+   * computing the class probabilities only once.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param gradient Matrix to store gradient into.
+   * @param batchSize Number of data points to use.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t start,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters for a single feature indexed by j.
@@ -185,10 +245,79 @@ class SoftmaxRegressionFunction
   bool FitIntercept() const { return fitIntercept; }
 
  private:
-  //! Training data matrix.  This is an alias until the data is shuffled.
-  arma::mat data;
+  /**
+   * Compute lhs * rhs, where lhs is a dense expression and rhs may be a dense
+   * or sparse expression.  If the element type of rhs is not double, lhs is
+   * converted to that element type instead of rhs being converted to double.
+   */
+  template<typename LhsType, typename InputType>
+  static arma::mat Product(const LhsType& lhs,
+                           const InputType& rhs,
+                           const typename std::enable_if<std::is_same<
+                               typename InputType::elem_type,
+                               double>::value>::type* = 0)
+  {
+    return lhs * rhs;
+  }
+
+  //! Compute lhs * rhs in the (non-double) element type of rhs.
+  template<typename LhsType, typename InputType>
+  static arma::mat Product(const LhsType& lhs,
+                           const InputType& rhs,
+                           const typename std::enable_if<!std::is_same<
+                               typename InputType::elem_type,
+                               double>::value>::type* = 0)
+  {
+    typedef typename InputType::elem_type ElemType;
+    const arma::Mat<ElemType> result =
+        arma::conv_to<arma::Mat<ElemType>>::from(lhs) * rhs;
+    return arma::conv_to<arma::mat>::from(result);
+  }
+
+  /**
+   * Evaluate the objective function, and optionally its gradient, on the given
+   * points, in parallel over blocks of points.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param start First index of the data points to use.
+   * @param batchSize Number of data points to use.
+   * @param order The order in which to visit the points (the identity if it is
+   *     empty).
+   * @param gradient Matrix to store the gradient in, or NULL.
+   */
+  double BatchObjective(const arma::mat& parameters,
+                        const size_t start,
+                        const size_t batchSize,
+                        const arma::uvec& order,
+                        arma::mat* gradient) const;
+
+  /**
+   * Compute the log likelihood of a block of points, and add the unscaled
+   * gradient of the block to the given gradient if it is not NULL.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param points Points of the block.
+   * @param first Index of the first point of the block in the order.
+   * @param order The order in which to visit the points (the identity if it is
+   *     empty).
+   * @param probabilities Workspace for the probabilities of the block.
+   * @param gradient Gradient to add the gradient of the block to, or NULL.
+   */
+  template<typename InputType>
+  double BlockObjective(const arma::mat& parameters,
+                        const InputType& points,
+                        const size_t first,
+                        const arma::uvec& order,
+                        arma::mat& probabilities,
+                        arma::mat* gradient) const;
+
+  //! Training data matrix.  This is an alias of the input data.
+  MatType data;
   //! Label matrix for the provided data.
   arma::sp_mat groundTruth;
+  //! The order in which the batches visit the points (empty until Shuffle() is
+  //! called).
+  arma::uvec ordering;
   //! Initial parameter point.
   arma::mat initialPoint;
   //! Number of classes.
@@ -197,9 +326,16 @@ class SoftmaxRegressionFunction
   double lambda;
   //! Intercept term flag.
   bool fitIntercept;
+  //! The probabilities workspace of each thread.
+  mutable std::vector<arma::mat> workspaces;
+  //! The gradient accumulated by each thread.
+  mutable std::vector<arma::mat> localGradients;
 };
 
 } // namespace regression
 } // namespace mlpack
 
+// Include implementation.
+#include "softmax_regression_function_impl.hpp"
+
 #endif
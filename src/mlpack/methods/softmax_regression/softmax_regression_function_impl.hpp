@@ -0,0 +1,404 @@
+/**
+ * @file softmax_regression_function_impl.hpp
+ * @author Siddharth Agrawal
+ *
+ * Implementation of function to be optimized for softmax regression.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+#define MLPACK_METHODS_SOFTMAX_REGRESSION_SOFTMAX_REGRESSION_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "softmax_regression_function.hpp"
+#include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/shuffle_data.hpp>
+
+namespace mlpack {
+namespace regression {
+
+template<typename MatType>
+SoftmaxRegressionFunction<MatType>::SoftmaxRegressionFunction(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const double lambda,
+    const bool fitIntercept) :
+    data(math::MakeAlias(const_cast<MatType&>(data), false)),
+    numClasses(numClasses),
+    lambda(lambda),
+    fitIntercept(fitIntercept)
+{
+  // Initialize the parameters to suitable values.
+  initialPoint = InitializeWeights();
+
+  // Calculate the label matrix.
+  GetGroundTruthMatrix(labels, groundTruth);
+}
+
+/**
+ * Shuffle the order in which the batches visit the data.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Shuffle()
+{
+  // The data is not copied: each batch is gathered through the ordering.
+  ordering = arma::shuffle(arma::linspace<arma::uvec>(0, data.n_cols - 1,
+      data.n_cols));
+}
+
+/**
+ * Initializes parameter weights to random values taken from a scaled standard
+ * normal distribution. The weights cannot be initialized to zero, as that will
+ * lead to each class output being the same.
+ */
+template<typename MatType>
+const arma::mat SoftmaxRegressionFunction<MatType>::InitializeWeights()
+{
+  return InitializeWeights(data.n_rows, numClasses, fitIntercept);
+}
+
+template<typename MatType>
+const arma::mat SoftmaxRegressionFunction<MatType>::InitializeWeights(
+    const size_t featureSize,
+    const size_t numClasses,
+    const bool fitIntercept)
+{
+    arma::mat parameters;
+    InitializeWeights(parameters, featureSize, numClasses, fitIntercept);
+    return parameters;
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::InitializeWeights(
+    arma::mat &weights,
+    const size_t featureSize,
+    const size_t numClasses,
+    const bool fitIntercept)
+{
+  // Initialize values to 0.005 * r. 'r' is a matrix of random values taken from
+  // a Gaussian distribution with mean zero and variance one.
+  // If the fitIntercept flag is true, parameters.col(0) is the intercept.
+  if (fitIntercept)
+    weights.randn(numClasses, featureSize + 1);
+  else
+    weights.randn(numClasses, featureSize);
+  weights *= 0.005;
+}
+
+/**
+ * This is equivalent to applying the indicator function to the training
+ * labels. The output is in the form of a matrix, which leads to simpler
+ * calculations in the Evaluate() and Gradient() methods.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::GetGroundTruthMatrix(
+    const arma::Row<size_t>& labels, arma::sp_mat& groundTruth)
+{
+  // Calculate the ground truth matrix according to the labels passed. The
+  // ground truth matrix is a matrix of dimensions 'numClasses * numExamples',
+  // where each column contains a single entry of '1', marking the label
+  // corresponding to that example.
+
+  // Row pointers and column pointers corresponding to the entries.
+  arma::uvec rowPointers(labels.n_elem);
+  arma::uvec colPointers(labels.n_elem + 1);
+
+  // Row pointers are the labels of the examples, and column pointers are the
+  // number of cumulative entries made uptil that column.
+  colPointers(0) = 0;
+  for (size_t i = 0; i < labels.n_elem; i++)
+  {
+    rowPointers(i) = labels(i);
+    colPointers(i + 1) = i + 1;
+  }
+
+  // All entries are '1'.
+  arma::vec values;
+  values.ones(labels.n_elem);
+
+  // Calculate the matrix.
+  groundTruth = arma::sp_mat(rowPointers, colPointers, values, numClasses,
+                             labels.n_elem);
+}
+
+/**
+ * Compute the class probabilities of the given points.  If fitIntercept is
+ * true, parameters.col(0) is the intercept term.
+ */
+template<typename MatType>
+template<typename InputType>
+void SoftmaxRegressionFunction<MatType>::ComputeProbabilities(
+    const arma::mat& parameters,
+    const InputType& points,
+    const bool fitIntercept,
+    arma::mat& probabilities)
+{
+  // The probabilities are computed in place, so that probabilities may be a
+  // preallocated workspace (or an alias of one).
+  if (fitIntercept)
+  {
+    // In order to add the intercept term, we should compute following matrix:
+    //     [1; data] = arma::join_cols(ones(1, data.n_cols), data)
+    //     hypothesis = arma::exp(parameters * [1; data]).
+    //
+    // Since the cost of join may be high due to the copy of original data (and
+    // would destroy the sparsity of sparse data), split the hypothesis
+    // computation to two components.
+    probabilities = Product(parameters.cols(1, parameters.n_cols - 1), points);
+    probabilities.each_col() += parameters.col(0);
+  }
+  else
+  {
+    probabilities = Product(parameters, points);
+  }
+
+  probabilities = arma::exp(probabilities);
+  probabilities.each_row() /= arma::sum(probabilities, 0);
+}
+
+/**
+ * Evaluate the probabilities matrix. If fitIntercept flag is true,
+ * it should consider the parameters.cols(0) intercept term.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::GetProbabilitiesMatrix(
+    const arma::mat& parameters,
+    arma::mat& probabilities,
+    const size_t start,
+    const size_t batchSize) const
+{
+  ComputeProbabilities(parameters, data.cols(start, start + batchSize - 1),
+      fitIntercept, probabilities);
+}
+
+/**
+ * Evaluates the objective function given the parameters.
+ */
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters) const
+{
+  // The objective function is the negative log likelihood of the model
+  // calculated over all the training examples. Mathematically it is as follows:
+  // log likelihood = sum(1{y_i = j} * log(probability(j))) / m
+  // The sum is over all 'i's and 'j's, where 'i' points to a training example
+  // and 'j' points to a particular class. 1{x} is an indicator function whose
+  // value is 1 only when 'x' is satisfied, otherwise it is 0.
+  // 'm' is the number of training examples.
+  // The cost also takes into account the regularization to control the
+  // parameter weights.
+  //
+  // The class probabilities for each training example are given by:
+  // p_j = exp(theta_j' * x_i) / sum(exp(theta_k' * x_i))
+  // The sum is calculated over all the classes.
+  // x_i is the input vector for a particular training example.
+  // theta_j is the parameter vector associated with a particular class.
+  //
+  // The whole dataset is visited in its original order.
+  return BatchObjective(parameters, 0, data.n_cols, arma::uvec(), NULL);
+}
+
+/**
+ * Evaluate the objective function for the given points given the parameters.
+ */
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::Evaluate(
+    const arma::mat& parameters,
+    const size_t start,
+    const size_t batchSize) const
+{
+  return BatchObjective(parameters, start, batchSize, ordering, NULL);
+}
+
+/**
+ * Calculates and stores the gradient values given a set of parameters.
+ */
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(const arma::mat& parameters,
+                                                  arma::mat& gradient) const
+{
+  BatchObjective(parameters, 0, data.n_cols, arma::uvec(), &gradient);
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::Gradient(const arma::mat& parameters,
+                                                  const size_t start,
+                                                  arma::mat& gradient,
+                                                  const size_t batchSize) const
+{
+  BatchObjective(parameters, start, batchSize, ordering, &gradient);
+}
+
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  return BatchObjective(parameters, 0, data.n_cols, arma::uvec(), &gradient);
+}
+
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t start,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  return BatchObjective(parameters, start, batchSize, ordering, &gradient);
+}
+
+template<typename MatType>
+double SoftmaxRegressionFunction<MatType>::BatchObjective(
+    const arma::mat& parameters,
+    const size_t start,
+    const size_t batchSize,
+    const arma::uvec& order,
+    arma::mat* gradient) const
+{
+  // Each block holds the probabilities of a few points, in a workspace of
+  // about 2MB that each thread keeps between the calls.
+  const size_t blockSize = std::max((size_t) 1,
+      std::min((size_t) 1024, ((size_t) 1 << 18) / parameters.n_rows));
+  const size_t numBlocks = (batchSize + blockSize - 1) / blockSize;
+
+  const size_t numThreads = NumThreads();
+  if (workspaces.size() < numThreads)
+    workspaces.resize(numThreads);
+  if (gradient && localGradients.size() < numThreads)
+    localGradients.resize(numThreads);
+  for (size_t t = 0; t < numThreads; ++t)
+  {
+    workspaces[t].set_size(parameters.n_rows, blockSize);
+    if (gradient)
+      localGradients[t].zeros(parameters.n_rows, parameters.n_cols);
+  }
+
+  double logLikelihood = 0.0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:logLikelihood)
+  for (omp_size_t b = 0; b < (omp_size_t) numBlocks; ++b)
+  {
+    const size_t first = start + b * blockSize;
+    const size_t last = std::min(first + blockSize, start + batchSize) - 1;
+    const size_t thread = ThreadNum();
+
+    // The probabilities of the block are computed in the workspace.
+    arma::mat probabilities(workspaces[thread].memptr(), parameters.n_rows,
+        last - first + 1, false, true);
+    arma::mat* blockGradient = gradient ? &localGradients[thread] : NULL;
+    if (order.is_empty())
+    {
+      logLikelihood += BlockObjective(parameters, data.cols(first, last), first,
+          order, probabilities, blockGradient);
+    }
+    else
+    {
+      // Gather the points of the block, in the shuffled order.
+      logLikelihood += BlockObjective(parameters, math::GatherColumns(data,
+          order.subvec(first, last)), first, order, probabilities,
+          blockGradient);
+    }
+  }
+
+  if (gradient)
+  {
+    *gradient = localGradients[0];
+    for (size_t t = 1; t < numThreads; ++t)
+      *gradient += localGradients[t];
+    *gradient = *gradient / batchSize + lambda * parameters;
+  }
+
+  const double weightDecay = 0.5 * lambda * arma::accu(parameters % parameters);
+  return -logLikelihood / batchSize + weightDecay;
+}
+
+template<typename MatType>
+template<typename InputType>
+double SoftmaxRegressionFunction<MatType>::BlockObjective(
+    const arma::mat& parameters,
+    const InputType& points,
+    const size_t first,
+    const arma::uvec& order,
+    arma::mat& probabilities,
+    arma::mat* gradient) const
+{
+  ComputeProbabilities(parameters, points, fitIntercept, probabilities);
+
+  // The ground truth has a single entry in each column, so the log likelihood
+  // only needs the probability of the label of each point.  The difference
+  // between the predicted probabilities and the ground truth is computed in
+  // place for the gradient.
+  double logLikelihood = 0.0;
+  for (size_t j = 0; j < probabilities.n_cols; ++j)
+  {
+    const size_t point = order.is_empty() ? first + j : order[first + j];
+    for (arma::sp_mat::const_iterator it = groundTruth.begin_col(point);
+         it != groundTruth.end_col(point); ++it)
+    {
+      logLikelihood += (*it) * std::log(probabilities(it.row(), j));
+      probabilities(it.row(), j) -= (*it);
+    }
+  }
+
+  if (!gradient)
+    return logLikelihood;
+
+  // Accumulate the parameter gradients.  The product with the transposed data
+  // only touches the nonzero elements of sparse data.
+  if (fitIntercept)
+  {
+    // Treating the intercept term parameters.col(0) seperately to avoid
+    // the cost of building matrix [1; data].
+    gradient->col(0) += arma::sum(probabilities, 1);
+    gradient->cols(1, parameters.n_cols - 1) += Product(probabilities,
+        points.t());
+  }
+  else
+  {
+    *gradient += Product(probabilities, points.t());
+  }
+
+  return logLikelihood;
+}
+
+template<typename MatType>
+void SoftmaxRegressionFunction<MatType>::PartialGradient(
+    const arma::mat& parameters,
+    const size_t j,
+    arma::sp_mat& gradient) const
+{
+  gradient.zeros(arma::size(parameters));
+
+  arma::mat probabilities;
+  GetProbabilitiesMatrix(parameters, probabilities, 0, data.n_cols);
+
+  // Calculate the required part of the gradient.
+  arma::mat inner = probabilities - groundTruth;
+  if (fitIntercept)
+  {
+    if (j == 0)
+    {
+      gradient.col(j) =
+          inner * arma::ones<arma::mat>(data.n_cols, 1) / data.n_cols +
+          lambda * parameters.col(0);
+    }
+    else
+    {
+      gradient.col(j) = Product(inner, data.row(j - 1).t()) / data.n_cols +
+          lambda * parameters.col(j);
+    }
+  }
+  else
+  {
+    gradient.col(j) = Product(inner, data.row(j).t()) / data.n_cols +
+        lambda * parameters.col(j);
+  }
+}
+
+} // namespace regression
+} // namespace mlpack
+
+#endif
@@ -45,8 +45,8 @@ namespace nn {
  * const size_t numIterations = 100; // Maximum number of iterations.
  *
  * // Use an instantiated optimizer for the training.
- * SparseAutoencoderFunction saf(data, vSize, hSize);
- * L_BFGS<SparseAutoencoderFunction> optimizer(saf, numBasis, numIterations);
+ * SparseAutoencoderFunction<> saf(data, vSize, hSize);
+ * L_BFGS<SparseAutoencoderFunction<>> optimizer(saf, numBasis, numIterations);
  * SparseAutoencoder<L_BFGS> encoder2(optimizer);
  *
  * arma::mat features1, features2; // Matrices for storing new representations.
@@ -70,6 +70,7 @@ class SparseAutoencoder
    * and sparsity of the model.
    *
    * @tparam OptimizerType The optimizer to use.
+   * @tparam MatType Type of the data (arma::mat or arma::sp_mat).
    * @param data Input data with each column as one example.
    * @param visibleSize Size of input vector expected at the visible layer.
    * @param hiddenSize Size of input vector expected at the hidden layer.
@@ -77,8 +78,8 @@ class SparseAutoencoder
    * @param beta KL divergence parameter.
    * @param rho Sparsity parameter.
    */
-  template<typename OptimizerType = ens::L_BFGS>
-  SparseAutoencoder(const arma::mat& data,
+  template<typename OptimizerType = ens::L_BFGS, typename MatType = arma::mat>
+  SparseAutoencoder(const MatType& data,
                     const size_t visibleSize,
                     const size_t hiddenSize,
                     const double lambda = 0.0001,
@@ -91,10 +92,12 @@ class SparseAutoencoder
    * autoencoder. The function basically performs a feedforward computation
    * using the learned weights, and returns the hidden layer activations.
    *
+   * @tparam MatType Type of the data (arma::mat or arma::sp_mat).
    * @param data Matrix of the provided data.
    * @param features The hidden layer representation of the provided data.
    */
-  void GetNewFeatures(arma::mat& data, arma::mat& features);
+  template<typename MatType>
+  void GetNewFeatures(const MatType& data, arma::mat& features);
 
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
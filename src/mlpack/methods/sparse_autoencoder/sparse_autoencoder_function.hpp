@@ -22,7 +22,16 @@ namespace nn {
  * This is a class for the sparse autoencoder objective function. It can be used
  * to create learning models like self-taught learning, stacked autoencoders,
  * conditional random fields (CRFs), and so forth.
+ *
+ * The data can be sparse; then the hidden layer activations, the
+ * reconstruction error and the gradient of the encoding weights only visit
+ * the nonzero elements of the data, so that very high dimensional sparse data
+ * never has to be densified.  The reconstruction and the gradient are computed
+ * in parallel over blocks of visible units.
+ *
+ * @tparam MatType Type of the data matrix (arma::mat or arma::sp_mat).
  */
+template<typename MatType = arma::mat>
 class SparseAutoencoderFunction
 {
  public:
@@ -37,7 +46,7 @@ class SparseAutoencoderFunction
    * @param beta KL divergence parameter.
    * @param rho Sparsity parameter.
    */
-  SparseAutoencoderFunction(const arma::mat& data,
+  SparseAutoencoderFunction(const MatType& data,
                             const size_t visibleSize,
                             const size_t hiddenSize,
                             const double lambda = 0.0001,
@@ -70,6 +79,16 @@ class SparseAutoencoderFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluates the objective function and its gradient given the current set of
+   * parameters, with a single feedforward pass.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
    * function of a real number 'x' is [1 / (1 + exp(-x))].
@@ -145,8 +164,60 @@ class SparseAutoencoderFunction
   }
 
  private:
+  /**
+   * Compute the objective function, and its gradient if gradient is not NULL.
+   * The visible units are split evenly across the threads; each thread
+   * reconstructs its units for all points, in blocks small enough that the
+   * dense reconstruction of a block stays small, and writes their columns of
+   * the gradient.
+   */
+  double Objective(const arma::mat& parameters, arma::mat* gradient) const;
+
+  //! Compute the hidden layer activations of all points, for dense data.
+  void HiddenLayer(const arma::mat& parameters,
+                   const arma::mat& points,
+                   arma::mat& hiddenLayer) const;
+
+  //! Compute the hidden layer activations of all points, for sparse data.
+  void HiddenLayer(const arma::mat& parameters,
+                   const arma::sp_mat& points,
+                   arma::mat& hiddenLayer) const;
+
+  //! Compute the difference between the reconstruction of the visible units
+  //! starting at the given one and the data, for dense data.
+  void Difference(const arma::mat& outputLayer,
+                  const arma::mat& points,
+                  const size_t begin,
+                  arma::mat& diff) const;
+
+  //! Compute the difference between the reconstruction of the visible units
+  //! starting at the given one and the data, for sparse data.
+  void Difference(const arma::mat& outputLayer,
+                  const arma::sp_mat& points,
+                  const size_t begin,
+                  arma::mat& diff) const;
+
+  //! Compute the data term of the gradient of w1, for dense data.
+  void EncoderGradient(const arma::mat& delHid,
+                       const arma::mat& points,
+                       arma::mat& gradient) const;
+
+  //! Compute the data term of the gradient of w1, for sparse data.
+  void EncoderGradient(const arma::mat& delHid,
+                       const arma::sp_mat& points,
+                       arma::mat& gradient) const;
+
+  //! Dense data is accessed through submatrix views; nothing to prepare.
+  void PrepareData(const arma::mat& /* points */) { }
+
+  //! Store the transpose of sparse data, so that it can be accessed one
+  //! visible unit at a time.
+  void PrepareData(const arma::sp_mat& points) { transposedData = points.t(); }
+
   //! The matrix of data points.
-  const arma::mat& data;
+  const MatType& data;
+  //! The transpose of the data, if it is sparse.
+  arma::sp_mat transposedData;
   //! Initial parameter vector.
   arma::mat initialPoint;
   //! Size of the visible layer.
@@ -164,4 +235,7 @@ class SparseAutoencoderFunction
 } // namespace nn
 } // namespace mlpack
 
+// Include implementation.
+#include "sparse_autoencoder_function_impl.hpp"
+
 #endif
@@ -0,0 +1,359 @@
+/**
+ * @file sparse_autoencoder_function_impl.hpp
+ * @author Siddharth Agrawal
+ *
+ * Implementation of function to be optimized for sparse autoencoders.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SPARSE_AUTOENCODER_SPARSE_AUTOENCODER_FUNCTION_IMPL_HPP
+#define MLPACK_METHODS_SPARSE_AUTOENCODER_SPARSE_AUTOENCODER_FUNCTION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_autoencoder_function.hpp"
+
+namespace mlpack {
+namespace nn {
+
+template<typename MatType>
+SparseAutoencoderFunction<MatType>::SparseAutoencoderFunction(
+    const MatType& data,
+    const size_t visibleSize,
+    const size_t hiddenSize,
+    const double lambda,
+    const double beta,
+    const double rho) :
+    data(data),
+    visibleSize(visibleSize),
+    hiddenSize(hiddenSize),
+    lambda(lambda),
+    beta(beta),
+    rho(rho)
+{
+  PrepareData(data);
+
+  // Initialize the parameters to suitable values.
+  initialPoint = InitializeWeights();
+}
+
+/** Initializes the parameter weights if the initial point is not passed to the
+  * constructor. The weights w1, w2 are initialized to randomly in the range
+  * [-r, r] where 'r' is decided using the sizes of the visible and hidden
+  * layers. The biases b1, b2 are initialized to 0.
+  */
+template<typename MatType>
+const arma::mat SparseAutoencoderFunction<MatType>::InitializeWeights()
+{
+  // The module uses a matrix to store the parameters, its structure looks like:
+  //          vSize   1
+  //       |        |  |
+  //  hSize|   w1   |b1|
+  //       |________|__|
+  //       |        |  |
+  //  hSize|   w2'  |  |
+  //       |________|__|
+  //      1|   b2'  |  |
+  //
+  // There are (hiddenSize + 1) empty cells in the matrix, but it is small
+  // compared to the matrix size. The above structure allows for smooth matrix
+  // operations without making the code too ugly.
+
+  // Initialize w1 and w2 to random values in the range [0, 1], then set b1 and
+  // b2 to 0.
+  arma::mat parameters;
+  parameters.randu(2 * hiddenSize + 1, visibleSize + 1);
+  parameters.row(2 * hiddenSize).zeros();
+  parameters.col(visibleSize).zeros();
+
+  // Decide the parameter 'r' depending on the size of the visible and hidden
+  // layers. The formula used is r = sqrt(6) / sqrt(vSize + hSize + 1).
+  const double range = sqrt(6) / sqrt(visibleSize + hiddenSize + 1);
+
+  // Shift range of w1 and w2 values from [0, 1] to [-r, r].
+  parameters.submat(0, 0, 2 * hiddenSize - 1, visibleSize - 1) = 2 * range *
+      (parameters.submat(0, 0, 2 * hiddenSize - 1, visibleSize - 1) - 0.5);
+
+  return parameters;
+}
+
+/** Evaluates the objective function given the parameters.
+  */
+template<typename MatType>
+double SparseAutoencoderFunction<MatType>::Evaluate(
+    const arma::mat& parameters) const
+{
+  return Objective(parameters, NULL);
+}
+
+/** Calculates and stores the gradient values given a set of parameters.
+  */
+template<typename MatType>
+void SparseAutoencoderFunction<MatType>::Gradient(const arma::mat& parameters,
+                                                  arma::mat& gradient) const
+{
+  Objective(parameters, &gradient);
+}
+
+/** Evaluates the objective function and calculates the gradient values given a
+  * set of parameters.
+  */
+template<typename MatType>
+double SparseAutoencoderFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  return Objective(parameters, &gradient);
+}
+
+template<typename MatType>
+double SparseAutoencoderFunction<MatType>::Objective(
+    const arma::mat& parameters,
+    arma::mat* gradient) const
+{
+  // The objective function is the average squared reconstruction error of the
+  // network. w1 and b1 are the weights and biases associated with the hidden
+  // layer, whereas w2 and b2 are associated with the output layer.
+  // f(w1,w2,b1,b2) = sum((data - sigmoid(w2*sigmoid(w1data + b1) + b2))^2) / 2m
+  // 'm' is the number of training examples.
+  // The cost also takes into account the regularization and KL divergence terms
+  // to control the parameter weights and sparsity of the model respectively.
+  //
+  // The gradient is computed with the backpropagation algorithm: the delta
+  // values at each layer, except for the input layer, are used with the input
+  // layer and hidden layer activations to get the parameter gradients.
+
+  // Compute the limits for the parameters w1, w2, b1 and b2.
+  const size_t l1 = hiddenSize;
+  const size_t l2 = visibleSize;
+  const size_t l3 = 2 * hiddenSize;
+  const size_t points = data.n_cols;
+
+  // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
+  // used in their place to avoid copying data. The following representations
+  // are used:
+  // w1 <- parameters.submat(0, 0, l1-1, l2-1)
+  // w2 <- parameters.submat(l1, 0, l3-1, l2-1).t()
+  // b1 <- parameters.submat(0, l2, l1-1, l2)
+  // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
+
+  // Compute activations of the hidden layer.
+  arma::mat hiddenLayer;
+  HiddenLayer(parameters, data, hiddenLayer);
+
+  // Average activations of the hidden layer.
+  const arma::mat rhoCap = arma::sum(hiddenLayer, 1) / points;
+
+  // The output layer is reconstructed in blocks of visible units of at most
+  // 2^22 elements, and each worker takes a contiguous range of the units.
+  const size_t numWorkers = std::max((size_t) 1, std::min(NumThreads(), l2));
+  const size_t blockSize = std::max((size_t) 1,
+      ((size_t) 1 << 22) / std::max(points, (size_t) 1));
+
+  // Each worker sums the squared reconstruction error of its units, and its
+  // part of w2 * delOut, which the delta of the hidden layer needs.
+  std::vector<double> errors(numWorkers, 0.0);
+  std::vector<arma::mat> hiddenErrors((gradient != NULL) ? numWorkers : 0);
+  if (gradient != NULL)
+    gradient->zeros(2 * hiddenSize + 1, visibleSize + 1);
+
+  #pragma omp parallel for schedule(static)
+  for (omp_size_t k = 0; k < (omp_size_t) numWorkers; ++k)
+  {
+    if (gradient != NULL)
+      hiddenErrors[k].zeros(l1, points);
+
+    const size_t end = (k + 1) * l2 / numWorkers;
+    for (size_t begin = k * l2 / numWorkers; begin < end; begin += blockSize)
+    {
+      const size_t last = std::min(begin + blockSize, end) - 1;
+
+      // Compute activations of the output layer for the units of the block,
+      // and the difference between the reconstructed data and the original
+      // data.
+      arma::mat outputLayer, diff;
+      Sigmoid(parameters.submat(l1, begin, l3 - 1, last).t() * hiddenLayer +
+          arma::repmat(parameters.submat(l3, begin, l3, last).t(), 1, points),
+          outputLayer);
+      Difference(outputLayer, data, begin, diff);
+
+      errors[k] += arma::accu(diff % diff);
+
+      if (gradient == NULL)
+        continue;
+
+      // The delta vector for the output layer is given by diff * f'(z), where
+      // z is the preactivation and f is the activation function. The
+      // derivative of the sigmoid function turns out to be f(z) * (1 - f(z)).
+      const arma::mat delOut = diff % outputLayer % (1 - outputLayer);
+      hiddenErrors[k] += parameters.submat(l1, begin, l3 - 1, last) * delOut;
+
+      // The units of the block only contribute to their own columns of the
+      // gradient of w2 and b2.
+      gradient->submat(l1, begin, l3 - 1, last) =
+          hiddenLayer * delOut.t() / points +
+          lambda * parameters.submat(l1, begin, l3 - 1, last);
+      gradient->submat(l3, begin, l3, last) =
+          (arma::sum(delOut, 1) / points).t();
+    }
+  }
+
+  double sumOfSquaresError = 0.0;
+  for (size_t k = 0; k < numWorkers; ++k)
+    sumOfSquaresError += errors[k];
+
+  if (gradient != NULL)
+  {
+    // For every other layer in the neural network which comes before the
+    // output layer, the delta values are given del_n = w_n' * del_(n+1) *
+    // f'(z_n). Since our cost function also includes the KL divergence term,
+    // we adjust for that in the formula below.
+    const arma::mat klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) /
+        (1 - rhoCap));
+    arma::mat delHid = arma::repmat(klDivGrad, 1, points);
+    for (size_t k = 0; k < numWorkers; ++k)
+      delHid += hiddenErrors[k];
+    delHid %= hiddenLayer % (1 - hiddenLayer);
+
+    // Compute the gradient values using the activations and the delta values.
+    // The formula also accounts for the regularization terms in the objective.
+    // function.
+    EncoderGradient(delHid, data, *gradient);
+    gradient->submat(0, 0, l1 - 1, l2 - 1) /= points;
+    gradient->submat(0, 0, l1 - 1, l2 - 1) +=
+        lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
+    gradient->submat(0, l2, l1 - 1, l2) = arma::sum(delHid, 1) / points;
+  }
+
+  // Calculate squared L2-norms of w1 and w2.
+  const double wL2SquaredNorm = arma::accu(parameters.submat(0, 0, l3 - 1,
+      l2 - 1) % parameters.submat(0, 0, l3 - 1, l2 - 1));
+
+  // Calculate the reconstruction error, the regularization cost and the KL
+  // divergence cost terms. 'sumOfSquaresError' is the average squared l2-norm
+  // of the reconstructed data difference. 'weightDecay' is the squared l2-norm
+  // of the weights w1 and w2. 'klDivergence' is the cost of the hidden layer
+  // activations not being low. It is given by the following formula:
+  // KL = sum_over_hSize(rho*log(rho/rhoCaq) + (1-rho)*log((1-rho)/(1-rhoCap)))
+  sumOfSquaresError = 0.5 * sumOfSquaresError / points;
+  const double weightDecay = 0.5 * lambda * wL2SquaredNorm;
+  const double klDivergence = beta * arma::accu(rho * arma::log(rho / rhoCap) +
+      (1 - rho) * arma::log((1 - rho) / (1 - rhoCap)));
+
+  // The cost is the sum of the terms calculated above.
+  return sumOfSquaresError + weightDecay + klDivergence;
+}
+
+template<typename MatType>
+void SparseAutoencoderFunction<MatType>::HiddenLayer(
+    const arma::mat& parameters,
+    const arma::mat& points,
+    arma::mat& hiddenLayer) const
+{
+  const size_t l1 = hiddenSize;
+  const size_t l2 = visibleSize;
+
+  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * points +
+      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, points.n_cols),
+      hiddenLayer);
+}
+
+template<typename MatType>
+void SparseAutoencoderFunction<MatType>::HiddenLayer(
+    const arma::mat& parameters,
+    const arma::sp_mat& points,
+    arma::mat& hiddenLayer) const
+{
+  const size_t l1 = hiddenSize;
+  const size_t l2 = visibleSize;
+
+  // Column i of w1 is contiguous in the parameters, so each nonzero element
+  // of a point adds one column of w1 to its preactivation.
+  hiddenLayer.set_size(l1, points.n_cols);
+
+  #pragma omp parallel for
+  for (omp_size_t j = 0; j < (omp_size_t) points.n_cols; ++j)
+  {
+    double* preactivation = hiddenLayer.colptr(j);
+    const double* b1 = parameters.colptr(l2);
+    for (size_t h = 0; h < l1; ++h)
+      preactivation[h] = b1[h];
+
+    for (arma::sp_mat::const_iterator it = points.begin_col(j);
+         it != points.end_col(j); ++it)
+    {
+      const double* w1 = parameters.colptr(it.row());
+      for (size_t h = 0; h < l1; ++h)
+        preactivation[h] += (*it) * w1[h];
+    }
+  }
+
+  Sigmoid(hiddenLayer, hiddenLayer);
+}
+
+template<typename MatType>
+void SparseAutoencoderFunction<MatType>::Difference(
+    const arma::mat& outputLayer,
+    const arma::mat& points,
+    const size_t begin,
+    arma::mat& diff) const
+{
+  diff = outputLayer - points.rows(begin, begin + outputLayer.n_rows - 1);
+}
+
+template<typename MatType>
+void SparseAutoencoderFunction<MatType>::Difference(
+    const arma::mat& outputLayer,
+    const arma::sp_mat& /* points */,
+    const size_t begin,
+    arma::mat& diff) const
+{
+  // Column i of the transposed data holds the values of visible unit i.
+  diff = outputLayer;
+  for (size_t i = 0; i < outputLayer.n_rows; ++i)
+  {
+    for (arma::sp_mat::const_iterator it = transposedData.begin_col(begin + i);
+         it != transposedData.end_col(begin + i); ++it)
+    {
+      diff(i, it.row()) -= (*it);
+    }
+  }
+}
+
+template<typename MatType>
+void SparseAutoencoderFunction<MatType>::EncoderGradient(
+    const arma::mat& delHid,
+    const arma::mat& points,
+    arma::mat& gradient) const
+{
+  gradient.submat(0, 0, hiddenSize - 1, visibleSize - 1) = delHid * points.t();
+}
+
+template<typename MatType>
+void SparseAutoencoderFunction<MatType>::EncoderGradient(
+    const arma::mat& delHid,
+    const arma::sp_mat& /* points */,
+    arma::mat& gradient) const
+{
+  // The gradient of column i of w1 only depends on the points where visible
+  // unit i is nonzero, so the columns are computed in parallel.
+  #pragma omp parallel for
+  for (omp_size_t i = 0; i < (omp_size_t) visibleSize; ++i)
+  {
+    double* g = gradient.colptr(i);
+    for (arma::sp_mat::const_iterator it = transposedData.begin_col(i);
+         it != transposedData.end_col(i); ++it)
+    {
+      const double* delta = delHid.colptr(it.row());
+      for (size_t h = 0; h < hiddenSize; ++h)
+        g[h] += (*it) * delta[h];
+    }
+  }
+}
+
+} // namespace nn
+} // namespace mlpack
+
+#endif
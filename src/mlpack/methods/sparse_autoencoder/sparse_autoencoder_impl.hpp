@@ -18,8 +18,8 @@
 namespace mlpack {
 namespace nn {
 
-template<typename OptimizerType>
-SparseAutoencoder::SparseAutoencoder(const arma::mat& data,
+template<typename OptimizerType, typename MatType>
+SparseAutoencoder::SparseAutoencoder(const MatType& data,
                                      const size_t visibleSize,
                                      const size_t hiddenSize,
                                      double lambda,
@@ -32,8 +32,8 @@ SparseAutoencoder::SparseAutoencoder(const arma::mat& data,
     beta(beta),
     rho(rho)
 {
-  SparseAutoencoderFunction encoderFunction(data, visibleSize, hiddenSize,
-                                            lambda, beta, rho);
+  SparseAutoencoderFunction<MatType> encoderFunction(data, visibleSize,
+      hiddenSize, lambda, beta, rho);
 
   parameters = encoderFunction.GetInitialPoint();
 
@@ -46,6 +46,18 @@ SparseAutoencoder::SparseAutoencoder(const arma::mat& data,
       << "trained model is " << out << "." << std::endl;
 }
 
+template<typename MatType>
+void SparseAutoencoder::GetNewFeatures(const MatType& data,
+                                       arma::mat& features)
+{
+  const size_t l1 = hiddenSize;
+  const size_t l2 = visibleSize;
+
+  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
+      arma::repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
+      features);
+}
+
 } // namespace nn
 } // namespace mlpack
 
@@ -39,59 +39,25 @@ void SparseCoding::Encode(const arma::mat& data, arma::mat& codes)
   // lambda2 > 0.
   arma::mat matGram = trans(dictionary) * dictionary;
 
-  codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-
-    bool useCholesky = true;
-    regression::LARS lars(useCholesky, matGram, lambda1, lambda2);
-
-    // Create an alias of the code (using the same memory), and then LARS will
-    // place the result directly into that; then we will not need to have an
-    // extra copy.
-    arma::vec code = codes.unsafe_col(i);
-    arma::rowvec responses = data.unsafe_col(i).t();
-    lars.Train(dictionary, responses, code, false);
-  }
+  // Every point is a separate LARS problem on the same dictionary, so solve
+  // them all with one multi-target LARS call, which shares the Gram matrix
+  // and solves the points in parallel.  Each row of the responses is a point.
+  const bool useCholesky = true;
+  regression::LARS lars(useCholesky, matGram, lambda1, lambda2);
+  lars.Train(dictionary, arma::mat(trans(data)), codes, false);
 }
 
 // Dictionary step for optimization.
 double SparseCoding::OptimizeDictionary(const arma::mat& data,
                                         const arma::mat& codes,
-                                        const arma::uvec& adjacencies)
+                                        const arma::uvec& /* adjacencies */)
 {
-  // Count the number of atomic neighbors for each point x^i.
-  arma::uvec neighborCounts = arma::zeros<arma::uvec>(data.n_cols, 1);
-
-  if (adjacencies.n_elem > 0)
-  {
-    // This gets the column index.  Intentional integer division.
-    size_t curPointInd = (size_t) (adjacencies(0) / atoms);
-
-    size_t nextColIndex = (curPointInd + 1) * atoms;
-    for (size_t l = 1; l < adjacencies.n_elem; ++l)
-    {
-      // If l no longer refers to an element in this column, advance the column
-      // number accordingly.
-      if (adjacencies(l) >= nextColIndex)
-      {
-        curPointInd = (size_t) (adjacencies(l) / atoms);
-        nextColIndex = (curPointInd + 1) * atoms;
-      }
-
-      ++neighborCounts(curPointInd);
-    }
-  }
-
   // Handle the case of inactive atoms (atoms not used in the given coding).
+  const arma::uvec nonzeros = arma::sum(codes != 0, 1);
   std::vector<size_t> inactiveAtoms;
-
   for (size_t j = 0; j < atoms; ++j)
   {
-    if (arma::accu(codes.row(j) != 0) == 0)
+    if (nonzeros[j] == 0)
       inactiveAtoms.push_back(j);
   }
 
@@ -216,7 +182,8 @@ double SparseCoding::OptimizeDictionary(const arma::mat& data,
     size_t currentInactiveIndex = 0;
     for (size_t i = 0; i < atoms; ++i)
     {
-      if (inactiveAtoms[currentInactiveIndex] == i)
+      if (currentInactiveIndex < nInactiveAtoms &&
+          inactiveAtoms[currentInactiveIndex] == i)
       {
         // This atom is inactive.  Reinitialize it randomly.
         dictionary.col(i) = (data.col(math::RandInt(data.n_cols)) +
@@ -186,7 +186,9 @@ class SparseCoding
 
   /**
    * Sparse code each point in the given dataset via LARS, using the current
-   * dictionary and store the encoded data in the codes matrix.
+   * dictionary and store the encoded data in the codes matrix.  The points
+   * share one Gram matrix of the dictionary and are coded in parallel with
+   * OpenMP.
    *
    * @param data Input data matrix to be encoded.
    * @param codes Output codes matrix.
@@ -0,0 +1,31 @@
+/**
+ * @file sparse_svm.cpp
+ *
+ * Implementation of the non-templated functions of the SparseSVM class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "sparse_svm.hpp"
+
+namespace mlpack {
+namespace svm {
+
+SparseSVM::SparseSVM(const size_t inputSize,
+                     const size_t numClasses,
+                     const double lambda,
+                     const double delta,
+                     const bool fitIntercept) :
+    numClasses(numClasses),
+    lambda(lambda),
+    delta(delta),
+    fitIntercept(fitIntercept)
+{
+  SparseSVMFunction::InitializeWeights(parameters, inputSize, numClasses,
+      fitIntercept);
+}
+
+} // namespace svm
+} // namespace mlpack
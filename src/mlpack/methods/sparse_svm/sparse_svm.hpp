@@ -0,0 +1,241 @@
+/**
+ * @file sparse_svm.hpp
+ *
+ * Definition of the SparseSVM class, a multiclass linear SVM for sparse data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_HPP
+#define MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <ensmallen.hpp>
+
+#include "sparse_svm_function.hpp"
+
+namespace mlpack {
+namespace svm {
+
+/**
+ * The SparseSVM class implements an L2-regularized multiclass linear SVM, which
+ * is trained by minimizing the multiclass hinge loss of SparseSVMFunction on
+ * sparse data.  The model has one vector of weights per class, and a point is
+ * classified as the class with the highest score.
+ *
+ * By default the model is trained with the L-BFGS optimizer, whose objective
+ * and gradient evaluations process the points in parallel with OpenMP.  For
+ * very large and very sparse datasets, the lock-free parallel SGD optimizer
+ * ens::ParallelSGD (Hogwild!) can be used instead; it uses the sparse gradients
+ * of SparseSVMFunction, which only touch the features of each point.
+ *
+ * @code
+ * arma::sp_mat data; // Sparse training data, one point per column.
+ * arma::Row<size_t> labels; // Labels in [0, numClasses).
+ *
+ * // Train with L-BFGS.
+ * SparseSVM svm(data, labels, numClasses, lambda);
+ *
+ * // Or train with Hogwild!.
+ * SparseSVM hogwild(data.n_rows, numClasses, lambda);
+ * ens::ParallelSGD<ens::ConstantStep> optimizer(maxIterations,
+ *     std::ceil((double) data.n_cols / NumThreads()), tolerance,
+ *     true, ens::ConstantStep(stepSize));
+ * hogwild.Train(data, labels, numClasses, optimizer);
+ *
+ * arma::Row<size_t> predictions;
+ * svm.Classify(testData, predictions);
+ * @endcode
+ *
+ * Classification works with any dense or sparse Armadillo matrix type.
+ */
+class SparseSVM
+{
+ public:
+  /**
+   * Initialize the SparseSVM without performing training.  Be sure to use
+   * Train() before calling Classify() or ComputeAccuracy(), otherwise the
+   * results may be meaningless.
+   *
+   * @param inputSize Size of the input feature vector.
+   * @param numClasses Number of classes for classification.
+   * @param lambda L2-regularization constant.
+   * @param delta Margin of difference between the score of the correct class
+   *      and the scores of the other classes.
+   * @param fitIntercept Whether to add an intercept term.
+   */
+  SparseSVM(const size_t inputSize = 0,
+            const size_t numClasses = 0,
+            const double lambda = 0.0001,
+            const double delta = 1.0,
+            const bool fitIntercept = false);
+
+  /**
+   * Construct the SparseSVM class with the provided data and labels.  This
+   * will train the model with the given optimizer.
+   *
+   * @tparam OptimizerType Desired optimizer type.
+   * @param data Input training features, one point per column.
+   * @param labels Labels associated with the feature data.
+   * @param numClasses Number of classes for classification.
+   * @param lambda L2-regularization constant.
+   * @param delta Margin of difference between the score of the correct class
+   *      and the scores of the other classes.
+   * @param fitIntercept Whether to add an intercept term.
+   * @param optimizer Desired optimizer.
+   */
+  template<typename OptimizerType = ens::L_BFGS>
+  SparseSVM(const arma::sp_mat& data,
+            const arma::Row<size_t>& labels,
+            const size_t numClasses = 2,
+            const double lambda = 0.0001,
+            const double delta = 1.0,
+            const bool fitIntercept = false,
+            OptimizerType optimizer = OptimizerType());
+
+  /**
+   * Train the SVM with the given training data.  The current parameters are
+   * used as the starting point; if there are none, or they do not match the
+   * data, they are initialized to small random values.
+   *
+   * @tparam OptimizerType Desired optimizer type.
+   * @param data Input training features, one point per column.
+   * @param labels Labels associated with the feature data.
+   * @param numClasses Number of classes for classification.
+   * @return Objective value of the final point.
+   */
+  template<typename OptimizerType = ens::L_BFGS>
+  double Train(const arma::sp_mat& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses);
+
+  /**
+   * Train the SVM with the given training data and instantiated optimizer.
+   *
+   * @tparam OptimizerType Desired optimizer type.
+   * @param data Input training features, one point per column.
+   * @param labels Labels associated with the feature data.
+   * @param numClasses Number of classes for classification.
+   * @param optimizer Instantiated optimizer.
+   * @return Objective value of the final point.
+   */
+  template<typename OptimizerType>
+  double Train(const arma::sp_mat& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               OptimizerType& optimizer);
+
+  /**
+   * Classify the given points, returning the predicted labels for each point.
+   *
+   * @param data Set of points to classify.
+   * @param labels Predicted labels for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::Row<size_t>& labels) const;
+
+  /**
+   * Classify the given points, returning the predicted labels and the scores
+   * of each class for each point.
+   *
+   * @param data Set of points to classify.
+   * @param labels Predicted labels for each point.
+   * @param scores Scores of each class for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& labels,
+                arma::mat& scores) const;
+
+  /**
+   * Compute the scores of each class for the given points.
+   *
+   * @param data Set of points to classify.
+   * @param scores Scores of each class for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data, arma::mat& scores) const;
+
+  /**
+   * Classify the given point.  The predicted class label is returned.
+   *
+   * @param point Point to be classified.
+   * @return Predicted class label of the point.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Compute the accuracy of the model on the given data and labels, as a
+   * percentage between 0 and 100.
+   *
+   * @param testData Matrix of data points using which predictions are made.
+   * @param labels Vector of labels associated with the data.
+   */
+  template<typename MatType>
+  double ComputeAccuracy(const MatType& testData,
+                         const arma::Row<size_t>& labels) const;
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+  //! Modify the number of classes.
+  size_t& NumClasses() { return numClasses; }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get the margin parameter.
+  double Delta() const { return delta; }
+  //! Modify the margin parameter.
+  double& Delta() { return delta; }
+
+  //! Get whether an intercept term is fitted.  This can't change after
+  //! training.
+  bool FitIntercept() const { return fitIntercept; }
+
+  //! Get the model parameters.
+  const arma::mat& Parameters() const { return parameters; }
+  //! Modify the model parameters.
+  arma::mat& Parameters() { return parameters; }
+
+  //! Get the feature size of the training data.
+  size_t FeatureSize() const
+  { return fitIntercept ? parameters.n_cols - 1 : parameters.n_cols; }
+
+  /**
+   * Serialize the SparseSVM model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(parameters);
+    ar & BOOST_SERIALIZATION_NVP(numClasses);
+    ar & BOOST_SERIALIZATION_NVP(lambda);
+    ar & BOOST_SERIALIZATION_NVP(delta);
+    ar & BOOST_SERIALIZATION_NVP(fitIntercept);
+  }
+
+ private:
+  //! Parameters after optimization, one row per class.
+  arma::mat parameters;
+  //! Number of classes.
+  size_t numClasses;
+  //! L2-regularization constant.
+  double lambda;
+  //! Margin between the correct class and the other classes.
+  double delta;
+  //! Intercept term flag.
+  bool fitIntercept;
+};
+
+} // namespace svm
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_svm_impl.hpp"
+
+#endif // MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_HPP
@@ -0,0 +1,339 @@
+/**
+ * @file sparse_svm_function.cpp
+ * @author Shikhar Bhardwaj
+ *
+ * Implementation of the hinge loss function for training a sparse SVM with the
+ * parallel SGD algorithm
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "sparse_svm_function.hpp"
+
+using namespace mlpack;
+using namespace mlpack::svm;
+
+SparseSVMFunction::SparseSVMFunction(
+    const arma::sp_mat& dataset,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const double lambda,
+    const double delta,
+    const bool fitIntercept) :
+    dataset(dataset),
+    labels(math::MakeAlias(const_cast<arma::Row<size_t>&>(labels), false)),
+    numClasses(numClasses),
+    lambda(lambda),
+    delta(delta),
+    fitIntercept(fitIntercept)
+{
+  if (labels.n_elem != dataset.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "SparseSVMFunction::SparseSVMFunction(): dataset has "
+        << dataset.n_cols << " points, but " << labels.n_elem << " labels "
+        << "were given!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (labels.n_elem > 0 && arma::max(labels) >= numClasses)
+  {
+    std::ostringstream oss;
+    oss << "SparseSVMFunction::SparseSVMFunction(): labels must be in the "
+        << "range [0, " << numClasses << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  InitializeWeights(initialPoint, dataset.n_rows, numClasses, fitIntercept);
+}
+
+void SparseSVMFunction::Shuffle()
+{
+  arma::sp_mat newDataset;
+  arma::Row<size_t> newLabels;
+
+  // Shuffle the data.
+  math::ShuffleData(dataset, labels, newDataset, newLabels);
+
+  // If we are an alias, make sure we don't write to the original labels.
+  math::ClearAlias(labels);
+
+  dataset = std::move(newDataset);
+  labels = std::move(newLabels);
+}
+
+void SparseSVMFunction::InitializeWeights(arma::mat& weights,
+                                          const size_t featureSize,
+                                          const size_t numClasses,
+                                          const bool fitIntercept)
+{
+  // Initialize values to 0.005 * r, where r is a matrix of random values taken
+  // from a Gaussian distribution with mean zero and variance one.
+  if (fitIntercept)
+    weights.randn(numClasses, featureSize + 1);
+  else
+    weights.randn(numClasses, featureSize);
+  weights *= 0.005;
+}
+
+double SparseSVMFunction::Evaluate(const arma::mat& parameters) const
+{
+  return ComputeLoss(parameters, 0, dataset.n_cols, NULL) +
+      Regularization(parameters);
+}
+
+double SparseSVMFunction::Evaluate(const arma::mat& parameters,
+                                   const size_t firstId,
+                                   const size_t batchSize) const
+{
+  return ComputeLoss(parameters, firstId, batchSize, NULL) +
+      Regularization(parameters) * batchSize / dataset.n_cols;
+}
+
+void SparseSVMFunction::Gradient(const arma::mat& parameters,
+                                 arma::mat& gradient) const
+{
+  EvaluateWithGradient(parameters, gradient);
+}
+
+void SparseSVMFunction::Gradient(const arma::mat& parameters,
+                                 const size_t firstId,
+                                 arma::mat& gradient,
+                                 const size_t batchSize) const
+{
+  EvaluateWithGradient(parameters, firstId, gradient, batchSize);
+}
+
+void SparseSVMFunction::Gradient(const arma::mat& parameters,
+                                 const size_t firstId,
+                                 arma::sp_mat& gradient,
+                                 const size_t batchSize) const
+{
+  const size_t offset = fitIntercept ? 1 : 0;
+  const size_t lastId = firstId + batchSize - 1;
+
+  // Each nonzero element of the batch contributes to the gradient of its
+  // feature for each class with a nonzero coefficient; the contributions to the
+  // same parameter are added together when the sparse matrix is built.
+  const size_t batchNonzeros = dataset.cols(firstId, lastId).n_nonzero;
+  const size_t maxEntries = numClasses * (batchNonzeros + offset * batchSize);
+  arma::umat locations(2, maxEntries);
+  arma::vec values(maxEntries);
+  size_t k = 0;
+
+  arma::vec scores, coefficients;
+  for (size_t i = firstId; i <= lastId; ++i)
+  {
+    PointLoss(parameters, i, scores, coefficients);
+
+    // There is no gradient if the point does not violate any margin.
+    if (coefficients[labels[i]] == 0.0)
+      continue;
+
+    for (size_t j = 0; j < numClasses; ++j)
+    {
+      if (coefficients[j] == 0.0)
+        continue;
+
+      if (fitIntercept)
+      {
+        locations(0, k) = j;
+        locations(1, k) = 0;
+        values[k++] = coefficients[j];
+      }
+
+      for (arma::sp_mat::const_iterator it = dataset.begin_col(i);
+           it != dataset.end_col(i); ++it)
+      {
+        locations(0, k) = j;
+        locations(1, k) = offset + it.row();
+        values[k++] = coefficients[j] * (*it);
+      }
+    }
+  }
+
+  if (k == 0)
+  {
+    gradient.zeros(parameters.n_rows, parameters.n_cols);
+    return;
+  }
+
+  locations.resize(2, k);
+  values.resize(k);
+  gradient = arma::sp_mat(true, locations, values, parameters.n_rows,
+      parameters.n_cols, true, false);
+
+  // Regularization term, for the parameters in the gradient only.
+  if (lambda != 0.0)
+  {
+    const double scale = lambda * batchSize / dataset.n_cols;
+    for (arma::sp_mat::iterator it = gradient.begin(); it != gradient.end();
+         ++it)
+    {
+      if (it.col() >= offset)
+        *it += scale * parameters(it.row(), it.col());
+    }
+  }
+}
+
+double SparseSVMFunction::EvaluateWithGradient(const arma::mat& parameters,
+                                               arma::mat& gradient) const
+{
+  return EvaluateWithGradient(parameters, 0, gradient, dataset.n_cols);
+}
+
+double SparseSVMFunction::EvaluateWithGradient(const arma::mat& parameters,
+                                               const size_t firstId,
+                                               arma::mat& gradient,
+                                               const size_t batchSize) const
+{
+  gradient.zeros(parameters.n_rows, parameters.n_cols);
+  const double loss = ComputeLoss(parameters, firstId, batchSize, &gradient);
+
+  // Add the share of the regularization term of this batch.
+  const double scale = (double) batchSize / dataset.n_cols;
+  if (lambda != 0.0)
+  {
+    if (fitIntercept)
+    {
+      gradient.cols(1, parameters.n_cols - 1) += scale * lambda *
+          parameters.cols(1, parameters.n_cols - 1);
+    }
+    else
+    {
+      gradient += scale * lambda * parameters;
+    }
+  }
+
+  return loss + scale * Regularization(parameters);
+}
+
+size_t SparseSVMFunction::NumFunctions() const
+{
+  // The number of points in the dataset is the number of functions, as this
+  // is a data dependent function.
+  return dataset.n_cols;
+}
+
+double SparseSVMFunction::ComputeLoss(const arma::mat& parameters,
+                                      const size_t firstId,
+                                      const size_t batchSize,
+                                      arma::mat* gradient) const
+{
+  const size_t lastId = firstId + batchSize - 1;
+  double loss = 0.0;
+
+  if (batchSize < parallelThreshold)
+  {
+    arma::vec scores, coefficients;
+    for (size_t i = firstId; i <= lastId; ++i)
+    {
+      loss += PointLoss(parameters, i, scores, coefficients);
+      if (gradient)
+        AddPointGradient(i, coefficients, *gradient);
+    }
+
+    return loss;
+  }
+
+  // Each thread handles a contiguous block of points, and so of the nonzero
+  // elements of the dataset, and accumulates their gradient in its own buffer.
+  #pragma omp parallel
+  {
+    arma::vec scores, coefficients;
+    arma::mat localGradient;
+    if (gradient)
+      localGradient.zeros(parameters.n_rows, parameters.n_cols);
+    double localLoss = 0.0;
+
+    #pragma omp for schedule(static)
+    for (omp_size_t i = (omp_size_t) firstId; i <= (omp_size_t) lastId; ++i)
+    {
+      localLoss += PointLoss(parameters, i, scores, coefficients);
+      if (gradient)
+        AddPointGradient(i, coefficients, localGradient);
+    }
+
+    #pragma omp critical
+    {
+      loss += localLoss;
+      if (gradient)
+        *gradient += localGradient;
+    }
+  }
+
+  return loss;
+}
+
+double SparseSVMFunction::PointLoss(const arma::mat& parameters,
+                                    const size_t i,
+                                    arma::vec& scores,
+                                    arma::vec& coefficients) const
+{
+  const size_t offset = fitIntercept ? 1 : 0;
+
+  // Compute the scores of each class, visiting only the nonzero elements of the
+  // point.
+  if (fitIntercept)
+    scores = parameters.col(0);
+  else
+    scores.zeros(numClasses);
+
+  for (arma::sp_mat::const_iterator it = dataset.begin_col(i);
+       it != dataset.end_col(i); ++it)
+    scores += (*it) * parameters.col(offset + it.row());
+
+  // Each class whose score is within delta of the score of the correct class
+  // adds to the loss.
+  const size_t label = labels[i];
+  double loss = 0.0;
+  coefficients.zeros(numClasses);
+  for (size_t j = 0; j < numClasses; ++j)
+  {
+    if (j == label)
+      continue;
+
+    const double margin = scores[j] - scores[label] + delta;
+    if (margin > 0.0)
+    {
+      loss += margin;
+      coefficients[j] = 1.0;
+      coefficients[label] -= 1.0;
+    }
+  }
+
+  return loss;
+}
+
+void SparseSVMFunction::AddPointGradient(const size_t i,
+                                         const arma::vec& coefficients,
+                                         arma::mat& gradient) const
+{
+  // There is no gradient if the point does not violate any margin.
+  if (coefficients[labels[i]] == 0.0)
+    return;
+
+  const size_t offset = fitIntercept ? 1 : 0;
+  if (fitIntercept)
+    gradient.col(0) += coefficients;
+
+  for (arma::sp_mat::const_iterator it = dataset.begin_col(i);
+       it != dataset.end_col(i); ++it)
+    gradient.col(offset + it.row()) += (*it) * coefficients;
+}
+
+double SparseSVMFunction::Regularization(const arma::mat& parameters) const
+{
+  if (lambda == 0.0)
+    return 0.0;
+
+  if (fitIntercept)
+  {
+    return 0.5 * lambda * arma::accu(arma::square(
+        parameters.cols(1, parameters.n_cols - 1)));
+  }
+
+  return 0.5 * lambda * arma::accu(arma::square(parameters));
+}
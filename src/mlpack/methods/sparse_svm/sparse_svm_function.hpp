@@ -15,14 +15,62 @@
 
 #include <mlpack/prereqs.hpp>
 
+namespace mlpack {
+namespace svm {
+
+/**
+ * The multiclass hinge loss function of a linear SVM on sparse data, as
+ * proposed by Weston and Watkins.  For parameters W (one row per class) and a
+ * point x_i with label y_i, the loss of the point is
+ *
+ *   L_i(W) = sum_{j != y_i} max(0, w_j^T x_i - w_{y_i}^T x_i + delta),
+ *
+ * and the objective function is the sum of the losses of all points plus the
+ * L2-regularization term 0.5 * lambda * ||W||^2 (the intercept, if any, is not
+ * regularized).  The separable objective of a batch of points is the sum of
+ * their losses plus a share of the regularization term proportional to the
+ * size of the batch, so the separable objectives of all points add up to the
+ * full objective.
+ *
+ * The parameters matrix has one row per class and one column per dimension;
+ * if fitIntercept is true, the first column holds the intercept of each class.
+ * With this layout the parameters of each feature are contiguous, so the
+ * scores of a point are computed by visiting only its nonzero elements.
+ *
+ * The full-batch Evaluate(), Gradient() and EvaluateWithGradient() functions,
+ * and the separable ones for large batches, partition the points among OpenMP
+ * threads; each thread accumulates the gradient of its points in its own
+ * buffer, and the buffers are summed at the end.  This takes O(t k d) memory
+ * for t threads, k classes and d dimensions.  The sparse separable Gradient()
+ * only stores the gradient of the features that appear in the batch, and is
+ * meant for optimizers that apply sparse updates, such as ens::ParallelSGD
+ * (Hogwild!).
+ */
 class SparseSVMFunction
 {
  public:
   //! Nothing to do for the default constructor.
-  SparseSVMFunction() {}
+  SparseSVMFunction() :
+      numClasses(0), lambda(0.0), delta(1.0), fitIntercept(false) { }
 
-  //! Member initialization constructor.
-  SparseSVMFunction(const arma::sp_mat& dataset, const arma::vec& labels);
+  /**
+   * Construct the function on the given dataset and labels.  The labels
+   * should be in the range [0, numClasses - 1].
+   *
+   * @param dataset Sparse matrix of training points, one per column.
+   * @param labels Labels of the training points.
+   * @param numClasses Number of classes.
+   * @param lambda L2-regularization constant.
+   * @param delta Margin of difference between the score of the correct class
+   *      and the scores of the other classes.
+   * @param fitIntercept Whether to fit an intercept term.
+   */
+  SparseSVMFunction(const arma::sp_mat& dataset,
+                    const arma::Row<size_t>& labels,
+                    const size_t numClasses,
+                    const double lambda = 0.0001,
+                    const double delta = 1.0,
+                    const bool fitIntercept = false);
 
   /**
    * Shuffle the dataset.
@@ -30,32 +78,107 @@ class SparseSVMFunction
   void Shuffle();
 
   /**
-   * Evaluate the hinge loss function on the specified datapoints.
+   * Initialize the weights to small random values, taken from a scaled
+   * standard normal distribution.
+   *
+   * @param weights Matrix to store the weights in.
+   * @param featureSize Dimensionality of the data.
+   * @param numClasses Number of classes.
+   * @param fitIntercept Whether to add a column for the intercept term.
+   */
+  static void InitializeWeights(arma::mat& weights,
+                                const size_t featureSize,
+                                const size_t numClasses,
+                                const bool fitIntercept = false);
+
+  /**
+   * Evaluate the objective function on the whole dataset.
    *
    * @param parameters The parameters of the SVM.
-   * @param startId First index of the datapoints to use for function
+   * @return The value of the objective function at the given parameters.
+   */
+  double Evaluate(const arma::mat& parameters) const;
+
+  /**
+   * Evaluate the separable objective function on the specified datapoints.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param firstId First index of the datapoints to use for function
    *      evaluation.
    * @param batchSize Size of batch to process.
    * @return The value of the loss function at the given parameters.
    */
   double Evaluate(const arma::mat& parameters,
-                  const size_t startId,
-                  const size_t batchSize = 1);
+                  const size_t firstId,
+                  const size_t batchSize = 1) const;
 
   /**
-   * Evaluate the gradient the gradient of the hinge loss function, following
-   * the SparseFunctionType requirements on the Gradient function.
+   * Evaluate the gradient of the objective function on the whole dataset.
    *
    * @param parameters The parameters of the SVM.
-   * @param firstId Index of the datapoint to use for the gradient evaluation.
+   * @param gradient Matrix to output the gradient into.
+   */
+  void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
+
+  /**
+   * Evaluate the gradient of the separable objective function on the
+   * specified datapoints.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param firstId Index of the first datapoint to use for the gradient
+   *      evaluation.
+   * @param gradient Matrix to output the gradient into.
+   * @param batchSize Size of the batch to process.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t firstId,
+                arma::mat& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the gradient of the separable objective function on the
+   * specified datapoints, as a sparse matrix.  Only the parameters of the
+   * intercept and of the features that are nonzero in at least one point of
+   * the batch have a gradient.  The L2-regularization term is only applied to
+   * those parameters, so that features that do not appear in a point are not
+   * updated by it.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param firstId Index of the first datapoint to use for the gradient
+   *      evaluation.
    * @param gradient Sparse matrix to output the gradient into.
    * @param batchSize Size of the batch to process.
    */
-  template <typename GradType>
   void Gradient(const arma::mat& parameters,
                 const size_t firstId,
-                GradType& gradient,
-                const size_t batchSize = 1);
+                arma::sp_mat& gradient,
+                const size_t batchSize = 1) const;
+
+  /**
+   * Evaluate the objective function and its gradient on the whole dataset in
+   * one pass over the data.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param gradient Matrix to output the gradient into.
+   * @return The value of the objective function at the given parameters.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluate the separable objective function and its gradient on the
+   * specified datapoints in one pass over them.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param firstId Index of the first datapoint to use.
+   * @param gradient Matrix to output the gradient into.
+   * @param batchSize Size of the batch to process.
+   * @return The value of the objective function at the given parameters.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t firstId,
+                              arma::mat& gradient,
+                              const size_t batchSize = 1) const;
 
   //! Return the initial point for the optimization.
   const arma::mat& InitialPoint() const { return initialPoint; }
@@ -68,14 +191,81 @@ class SparseSVMFunction
   arma::sp_mat& Dataset() { return dataset; }
 
   //! Get the labels.
-  const arma::vec& Labels() const { return labels; }
+  const arma::Row<size_t>& Labels() const { return labels; }
   //! Modify the labels.
-  arma::vec& Labels() { return labels; }
+  arma::Row<size_t>& Labels() { return labels; }
+
+  //! Get the number of classes.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get the margin parameter.
+  double Delta() const { return delta; }
+  //! Modify the margin parameter.
+  double& Delta() { return delta; }
+
+  //! Get whether an intercept term is fitted.
+  bool FitIntercept() const { return fitIntercept; }
 
   //! Return the number of functions.
-  size_t NumFunctions();
+  size_t NumFunctions() const;
+
+  /**
+   * Compute the scores of each class for the given points, as in the
+   * objective function: scores(j, i) = w_j^T x_i (plus the intercept of class
+   * j, if fitIntercept is true).
+   *
+   * @param parameters The parameters of the SVM.
+   * @param points Points to compute the scores of (dense or sparse).
+   * @param fitIntercept Whether the first column of the parameters is the
+   *      intercept.
+   * @param scores Matrix to store the scores in.
+   */
+  template<typename MatType>
+  static void ComputeScores(const arma::mat& parameters,
+                            const MatType& points,
+                            const bool fitIntercept,
+                            arma::mat& scores);
 
  private:
+  /**
+   * Compute the sum of the losses of the points [firstId, firstId + batchSize)
+   * and, if gradient is not NULL, add the gradient of the losses to it.  The
+   * points are processed in parallel if there are enough of them.
+   */
+  double ComputeLoss(const arma::mat& parameters,
+                     const size_t firstId,
+                     const size_t batchSize,
+                     arma::mat* gradient) const;
+
+  /**
+   * Compute the scores of one point and the coefficients of the point in the
+   * gradient of its loss: the gradient of the loss with respect to w_j is
+   * coefficients[j] * x_i.  Returns the loss of the point.
+   */
+  double PointLoss(const arma::mat& parameters,
+                   const size_t i,
+                   arma::vec& scores,
+                   arma::vec& coefficients) const;
+
+  /**
+   * Add the gradient of the loss of point i to the given gradient, using the
+   * coefficients computed by PointLoss().
+   */
+  void AddPointGradient(const size_t i,
+                        const arma::vec& coefficients,
+                        arma::mat& gradient) const;
+
+  //! Compute the L2-regularization term 0.5 * lambda * ||W||^2.
+  double Regularization(const arma::mat& parameters) const;
+
+  //! Minimum number of points to process in parallel.
+  static const size_t parallelThreshold = 256;
+
   //! The initial point, from which to start the optimization.
   arma::mat initialPoint;
 
@@ -83,10 +273,25 @@ class SparseSVMFunction
   arma::sp_mat dataset;
 
   //! The labels, y_i.
-  arma::vec labels;
+  arma::Row<size_t> labels;
+
+  //! The number of classes.
+  size_t numClasses;
+
+  //! The L2-regularization constant.
+  double lambda;
+
+  //! The margin between the correct class and the other classes.
+  double delta;
+
+  //! Whether an intercept term is fitted.
+  bool fitIntercept;
 };
 
-// Include implementation
+} // namespace svm
+} // namespace mlpack
+
+// Include implementation of templated functions.
 #include "sparse_svm_function_impl.hpp"
 
 #endif // MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_FUNCTION_HPP
@@ -1,9 +1,7 @@
 /**
  * @file sparse_svm_function_impl.hpp
- * @author Shikhar Bhardwaj
  *
- * Implementation of the hinge loss function for training a sparse SVM with the
- * parallel SGD algorithm
+ * Implementation of the templated functions of the SparseSVMFunction class.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -16,64 +14,29 @@
 // In case it hasn't been included yet.
 #include "sparse_svm_function.hpp"
 
-SparseSVMFunction::SparseSVMFunction(
-    const arma::sp_mat& dataset, const arma::vec& labels) :
-    dataset(dataset),
-    labels(math::MakeAlias(const_cast<arma::vec&>(labels), false))
-{ /* Nothing to do */ }
+namespace mlpack {
+namespace svm {
 
-void SparseSVMFunction::Shuffle()
+template<typename MatType>
+void SparseSVMFunction::ComputeScores(const arma::mat& parameters,
+                                      const MatType& points,
+                                      const bool fitIntercept,
+                                      arma::mat& scores)
 {
-  arma::sp_mat newDataset;
-  arma::vec newLabels;
-
-  // Shuffle the data.
-  math::ShuffleData(dataset, labels, newDataset, newLabels);
-
-  math::ClearAlias(newLabels);
-
-  dataset = std::move(newDataset);
-  labels = std::move(newLabels);
-}
-
-double SparseSVMFunction::Evaluate(const arma::mat& parameters,
-                                   const size_t firstId,
-                                   const size_t batchSize)
-{
-  // The hinge loss function.
-  const size_t lastId = firstId + batchSize - 1;
-  return arma::accu(arma::max(0.0, 1 - labels.subvec(firstId, lastId) %
-      dataset.cols(firstId, lastId) *
-      arma::repmat(parameters, 1, batchSize).t()));
-}
-
-template <typename GradType>
-void SparseSVMFunction::Gradient(const arma::mat& parameters,
-                                 const size_t firstId,
-                                 GradType& gradient,
-                                 const size_t batchSize)
-{
-  // Evaluate the gradient of the hinge loss function.
-  const size_t lastId = firstId + batchSize - 1;
-  arma::vec dots = 1 - labels.subvec(firstId, lastId) %
-      dataset.cols(firstId, lastId) *
-      arma::repmat(parameters, 1, batchSize).t();
-  gradient = GradType(parameters.n_rows, 1);
-  for (size_t i = 0; i < batchSize; ++i)
+  if (fitIntercept)
+  {
+    // Treat the intercept column separately, to avoid building [1; points]
+    // (which would destroy the sparsity of sparse points).
+    scores = parameters.cols(1, parameters.n_cols - 1) * points;
+    scores.each_col() += parameters.col(0);
+  }
+  else
   {
-    if (dots[i] >= 0)
-    {
-      // Is this correct?
-      gradient += -1 * GradType(dataset.col(id) * labels(id));
-    }
+    scores = parameters * points;
   }
 }
 
-size_t SparseSVMFunction::NumFunctions()
-{
-  // The number of points in the dataset is the number of functions, as this
-  // is a data dependent function.
-  return dataset.n_cols;
-}
+} // namespace svm
+} // namespace mlpack
 
 #endif // MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_FUNCTION_IMPL_HPP
@@ -0,0 +1,135 @@
+/**
+ * @file sparse_svm_impl.hpp
+ *
+ * Implementation of the templated functions of the SparseSVM class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_IMPL_HPP
+#define MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_svm.hpp"
+
+namespace mlpack {
+namespace svm {
+
+template<typename OptimizerType>
+SparseSVM::SparseSVM(const arma::sp_mat& data,
+                     const arma::Row<size_t>& labels,
+                     const size_t numClasses,
+                     const double lambda,
+                     const double delta,
+                     const bool fitIntercept,
+                     OptimizerType optimizer) :
+    numClasses(numClasses),
+    lambda(lambda),
+    delta(delta),
+    fitIntercept(fitIntercept)
+{
+  Train(data, labels, numClasses, optimizer);
+}
+
+template<typename OptimizerType>
+double SparseSVM::Train(const arma::sp_mat& data,
+                        const arma::Row<size_t>& labels,
+                        const size_t numClasses)
+{
+  OptimizerType optimizer;
+  return Train(data, labels, numClasses, optimizer);
+}
+
+template<typename OptimizerType>
+double SparseSVM::Train(const arma::sp_mat& data,
+                        const arma::Row<size_t>& labels,
+                        const size_t numClasses,
+                        OptimizerType& optimizer)
+{
+  this->numClasses = numClasses;
+
+  SparseSVMFunction svmFunction(data, labels, numClasses, lambda, delta,
+      fitIntercept);
+
+  // Start from the current parameters, if they fit the data.
+  if (parameters.n_rows != numClasses ||
+      parameters.n_cols != svmFunction.InitialPoint().n_cols)
+    parameters = svmFunction.InitialPoint();
+
+  // Train the model.
+  Timer::Start("sparse_svm_optimization");
+  const double out = optimizer.Optimize(svmFunction, parameters);
+  Timer::Stop("sparse_svm_optimization");
+
+  Log::Info << "SparseSVM::Train(): final objective of trained model is "
+      << out << "." << std::endl;
+
+  return out;
+}
+
+template<typename MatType>
+void SparseSVM::Classify(const MatType& data, arma::Row<size_t>& labels) const
+{
+  arma::mat scores;
+  Classify(data, labels, scores);
+}
+
+template<typename MatType>
+void SparseSVM::Classify(const MatType& data,
+                         arma::Row<size_t>& labels,
+                         arma::mat& scores) const
+{
+  Classify(data, scores);
+
+  // Each point is assigned to the class with the highest score.
+  labels.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    arma::uword maxIndex = 0;
+    scores.unsafe_col(i).max(maxIndex);
+    labels[i] = maxIndex;
+  }
+}
+
+template<typename MatType>
+void SparseSVM::Classify(const MatType& data, arma::mat& scores) const
+{
+  if (data.n_rows != FeatureSize())
+  {
+    std::ostringstream oss;
+    oss << "SparseSVM::Classify(): dataset has " << data.n_rows
+        << " dimensions, but model has " << FeatureSize() << " dimensions!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  SparseSVMFunction::ComputeScores(parameters, data, fitIntercept, scores);
+}
+
+template<typename VecType>
+size_t SparseSVM::Classify(const VecType& point) const
+{
+  arma::Row<size_t> label(1);
+  Classify(point, label);
+  return size_t(label(0));
+}
+
+template<typename MatType>
+double SparseSVM::ComputeAccuracy(const MatType& testData,
+                                  const arma::Row<size_t>& labels) const
+{
+  arma::Row<size_t> predictions;
+  Classify(testData, predictions);
+
+  // Count the number of correctly predicted labels.
+  const size_t count = arma::accu(predictions == labels);
+
+  // Return percentage accuracy.
+  return (count * 100.0) / predictions.n_elem;
+}
+
+} // namespace svm
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_SPARSE_SVM_SPARSE_SVM_IMPL_HPP
@@ -0,0 +1,300 @@
+/**
+ * @file sparse_svm_main.cpp
+ *
+ * Main program for the multiclass linear SVM on sparse data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/cli.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "sparse_svm.hpp"
+
+#include <ensmallen.hpp>
+
+#include <set>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::svm;
+using namespace mlpack::util;
+
+PROGRAM_INFO("Sparse Linear SVM",
+    // Short description.
+    "An implementation of a multiclass linear support vector machine, trained "
+    "with the L-BFGS optimizer or with lock-free parallel SGD (Hogwild!), that "
+    "is meant for high-dimensional sparse data.  Given labeled data, a model "
+    "can be trained and saved for future use; or, a pre-trained model can be "
+    "used to classify new points.",
+    // Long description.
+    "This program trains an L2-regularized multiclass linear SVM by minimizing "
+    "the multiclass hinge loss of Weston and Watkins, and can then use the "
+    "model to classify new points.  The data is stored as a sparse matrix "
+    "during training, and the objective function and its gradient are "
+    "computed in parallel."
+    "\n\n"
+    "Training is done by giving a matrix of training points with the " +
+    PRINT_PARAM_STRING("training") + " parameter and their labels with the " +
+    PRINT_PARAM_STRING("labels") + " parameter.  The number of classes can be "
+    "specified with the " + PRINT_PARAM_STRING("number_of_classes") + " "
+    "parameter; otherwise, it is the number of distinct labels.  The L2 "
+    "regularization constant is given with the " +
+    PRINT_PARAM_STRING("lambda") + " parameter and the margin with the " +
+    PRINT_PARAM_STRING("delta") + " parameter.  An intercept term is not "
+    "fitted unless the " + PRINT_PARAM_STRING("intercept") + " flag is "
+    "given."
+    "\n\n"
+    "The optimizer is chosen with the " + PRINT_PARAM_STRING("optimizer") +
+    " parameter: 'lbfgs' (the L-BFGS optimizer) or 'psgd' (parallel SGD, "
+    "where each thread updates only the parameters of the features of its "
+    "points).  The " + PRINT_PARAM_STRING("max_iterations") + " and " +
+    PRINT_PARAM_STRING("tolerance") + " parameters control the optimizer; for "
+    "parallel SGD an iteration refers to a single point, and the step size is "
+    "given by the " + PRINT_PARAM_STRING("step_size") + " parameter."
+    "\n\n"
+    "A model may be loaded with the " + PRINT_PARAM_STRING("input_model") +
+    " parameter, in which case training (if any) starts from that model, and "
+    "the trained model may be saved with the " +
+    PRINT_PARAM_STRING("output_model") + " output parameter.  A test dataset "
+    "can be given with the " + PRINT_PARAM_STRING("test") + " parameter; the "
+    "predicted classes and the scores of each class may be saved with the " +
+    PRINT_PARAM_STRING("predictions") + " and " +
+    PRINT_PARAM_STRING("scores") + " output parameters.  If labels for the "
+    "test set are given with " + PRINT_PARAM_STRING("test_labels") + ", the "
+    "accuracy of the predictions is printed."
+    "\n\n"
+    "For example, to train a model on the data " + PRINT_DATASET("data") +
+    " with labels " + PRINT_DATASET("labels") + " using parallel SGD, "
+    "saving the model to " + PRINT_MODEL("svm_model") + ", the following "
+    "command may be used:"
+    "\n\n" +
+    PRINT_CALL("sparse_svm", "training", "data", "labels", "labels",
+        "optimizer", "psgd", "output_model", "svm_model") +
+    "\n\n"
+    "Then, to use " + PRINT_MODEL("svm_model") + " to classify the points in "
+    + PRINT_DATASET("test") + ", saving the predictions to " +
+    PRINT_DATASET("predictions") + ", the following command may be used:"
+    "\n\n" +
+    PRINT_CALL("sparse_svm", "input_model", "svm_model", "test", "test",
+        "predictions", "predictions"),
+    SEE_ALSO("@softmax_regression", "#softmax_regression"),
+    SEE_ALSO("@logistic_regression", "#logistic_regression"),
+    SEE_ALSO("Support vector machine on Wikipedia",
+        "https://en.wikipedia.org/wiki/Support-vector_machine"),
+    SEE_ALSO("mlpack::svm::SparseSVM C++ class documentation",
+        "@doxygen/classmlpack_1_1svm_1_1SparseSVM.html"));
+
+// Training parameters.
+PARAM_MATRIX_IN("training", "A matrix containing the training set (the matrix "
+    "of predictors, X).", "t");
+PARAM_UROW_IN("labels", "A matrix containing labels for the points in the "
+    "training set (y).", "l");
+PARAM_INT_IN("number_of_classes", "Number of classes for classification; if "
+    "unspecified (or 0), the number of classes found in the labels will be "
+    "used.", "c", 0);
+PARAM_DOUBLE_IN("lambda", "L2-regularization constant.", "r", 0.0001);
+PARAM_DOUBLE_IN("delta", "Margin of difference between the score of the "
+    "correct class and the scores of the other classes.", "d", 1.0);
+PARAM_FLAG("intercept", "Fit an intercept term in the model.", "i");
+
+// Optimizer parameters.
+PARAM_STRING_IN("optimizer", "Optimizer to use for training ('lbfgs' or "
+    "'psgd').", "O", "lbfgs");
+PARAM_INT_IN("max_iterations", "Maximum iterations for optimizer (0 indicates "
+    "no limit).", "n", 10000);
+PARAM_DOUBLE_IN("tolerance", "Convergence tolerance for optimizer.", "e",
+    1e-10);
+PARAM_DOUBLE_IN("step_size", "Step size for parallel SGD optimizer.", "s",
+    0.01);
+
+// Model loading/saving.
+PARAM_MODEL_IN(SparseSVM, "input_model", "Existing model (parameters).", "m");
+PARAM_MODEL_OUT(SparseSVM, "output_model", "Output for trained linear SVM "
+    "model.", "M");
+
+// Testing.
+PARAM_MATRIX_IN("test", "Matrix containing test dataset.", "T");
+PARAM_UROW_IN("test_labels", "Matrix containing test labels.", "L");
+PARAM_UROW_OUT("predictions", "If test data is specified, this matrix is where "
+    "the predictions for the test set will be saved.", "P");
+PARAM_MATRIX_OUT("scores", "If test data is specified, this matrix is where "
+    "the class scores for the test set will be saved.", "x");
+
+static void mlpackMain()
+{
+  // One of training and input_model must be specified.
+  RequireAtLeastOnePassed({ "training", "input_model" }, true);
+  if (CLI::HasParam("training"))
+  {
+    RequireAtLeastOnePassed({ "labels" }, true, "if training data is specified,"
+        " labels must also be specified");
+    RequireAtLeastOnePassed({ "output_model" }, false, "trained model will not "
+        "be saved");
+  }
+
+  ReportIgnoredParam({{ "training", false }}, "labels");
+  ReportIgnoredParam({{ "training", false }}, "number_of_classes");
+  ReportIgnoredParam({{ "training", false }}, "optimizer");
+  ReportIgnoredParam({{ "training", false }}, "max_iterations");
+  ReportIgnoredParam({{ "training", false }}, "tolerance");
+  ReportIgnoredParam({{ "training", false }}, "step_size");
+  ReportIgnoredParam({{ "test", false }}, "test_labels");
+  ReportIgnoredParam({{ "test", false }}, "predictions");
+  ReportIgnoredParam({{ "test", false }}, "scores");
+
+  RequireAtLeastOnePassed({ "output_model", "predictions", "scores" }, false,
+      "no output will be saved");
+
+  RequireParamInSet<string>("optimizer", { "lbfgs", "psgd" }, true,
+      "unknown optimizer");
+  RequireParamValue<int>("max_iterations", [](int x) { return x >= 0; }, true,
+      "max_iterations must be positive or zero");
+  RequireParamValue<int>("number_of_classes", [](int x) { return x >= 0; },
+      true, "number of classes must be positive or zero");
+  RequireParamValue<double>("tolerance", [](double x) { return x >= 0.0; },
+      true, "tolerance must be positive or zero");
+  RequireParamValue<double>("lambda", [](double x) { return x >= 0.0; }, true,
+      "lambda must be positive or zero");
+  RequireParamValue<double>("delta", [](double x) { return x > 0.0; }, true,
+      "delta must be positive");
+  RequireParamValue<double>("step_size", [](double x) { return x > 0.0; },
+      true, "step size must be positive");
+
+  const string optimizerType = CLI::GetParam<string>("optimizer");
+  if (optimizerType != "psgd" && CLI::HasParam("step_size"))
+  {
+    Log::Warn << PRINT_PARAM_STRING("step_size") << " ignored because "
+        << "optimizer type is not 'psgd'." << std::endl;
+  }
+
+  SparseSVM* model;
+  if (CLI::HasParam("input_model"))
+  {
+    model = CLI::GetParam<SparseSVM*>("input_model");
+    if (CLI::HasParam("intercept"))
+    {
+      Log::Warn << PRINT_PARAM_STRING("intercept") << " ignored because a "
+          << "model is given with " << PRINT_PARAM_STRING("input_model") << "."
+          << std::endl;
+    }
+  }
+  else
+  {
+    model = new SparseSVM(0, 0, CLI::GetParam<double>("lambda"),
+        CLI::GetParam<double>("delta"), CLI::HasParam("intercept"));
+  }
+
+  if (CLI::HasParam("training"))
+  {
+    // The training data is stored as a sparse matrix.
+    const arma::sp_mat trainData(CLI::GetParam<arma::mat>("training"));
+    const arma::Row<size_t> labels =
+        std::move(CLI::GetParam<arma::Row<size_t>>("labels"));
+
+    if (trainData.n_cols != labels.n_elem)
+    {
+      if (!CLI::HasParam("input_model"))
+        delete model;
+
+      Log::Fatal << "The labels must have the same number of points as the "
+          << "training dataset." << endl;
+    }
+
+    size_t numClasses = (size_t) CLI::GetParam<int>("number_of_classes");
+    if (numClasses == 0)
+    {
+      const set<size_t> uniqueLabels(labels.begin(), labels.end());
+      numClasses = uniqueLabels.size();
+    }
+
+    if (labels.n_elem > 0 && arma::max(labels) >= numClasses)
+    {
+      if (!CLI::HasParam("input_model"))
+        delete model;
+
+      Log::Fatal << "The labels must be in the range [0, " << numClasses
+          << "), but the largest label is " << arma::max(labels) << "!"
+          << endl;
+    }
+
+    model->Lambda() = CLI::GetParam<double>("lambda");
+    model->Delta() = CLI::GetParam<double>("delta");
+
+    const size_t maxIterations =
+        (size_t) CLI::GetParam<int>("max_iterations");
+    const double tolerance = CLI::GetParam<double>("tolerance");
+    if (optimizerType == "psgd")
+    {
+      // Each thread visits an equal share of the points.
+      const size_t threadShareSize = (size_t) std::ceil(
+          (double) trainData.n_cols / NumThreads());
+      ens::ParallelSGD<ens::ConstantStep> optimizer(maxIterations,
+          threadShareSize, tolerance, true,
+          ens::ConstantStep(CLI::GetParam<double>("step_size")));
+      Log::Info << "Training model with parallel SGD optimizer." << endl;
+
+      model->Train(trainData, labels, numClasses, optimizer);
+    }
+    else
+    {
+      ens::L_BFGS optimizer;
+      optimizer.MaxIterations() = maxIterations;
+      optimizer.MinGradientNorm() = tolerance;
+      Log::Info << "Training model with L-BFGS optimizer." << endl;
+
+      model->Train(trainData, labels, numClasses, optimizer);
+    }
+  }
+
+  if (CLI::HasParam("test"))
+  {
+    const arma::sp_mat testData(CLI::GetParam<arma::mat>("test"));
+
+    if (testData.n_rows != model->FeatureSize())
+    {
+      const size_t trainingDimensionality = model->FeatureSize();
+      if (!CLI::HasParam("input_model"))
+        delete model;
+
+      Log::Fatal << "Test data dimensionality (" << testData.n_rows << ") must "
+          << "be the same as the dimensionality of the training data ("
+          << trainingDimensionality << ")!" << endl;
+    }
+
+    arma::Row<size_t> predictions;
+    arma::mat scores;
+    model->Classify(testData, predictions, scores);
+
+    if (CLI::HasParam("test_labels"))
+    {
+      const arma::Row<size_t>& testLabels =
+          CLI::GetParam<arma::Row<size_t>>("test_labels");
+      if (testLabels.n_elem != testData.n_cols)
+      {
+        if (!CLI::HasParam("input_model"))
+          delete model;
+
+        Log::Fatal << "Test data given with " << PRINT_PARAM_STRING("test")
+            << " has " << testData.n_cols << " points, but labels in "
+            << PRINT_PARAM_STRING("test_labels") << " have "
+            << testLabels.n_elem << " labels!" << endl;
+      }
+
+      const size_t correct = arma::accu(predictions == testLabels);
+      Log::Info << "Accuracy on test set is "
+          << (double) correct / testLabels.n_elem << " (" << correct << " of "
+          << testLabels.n_elem << ")." << endl;
+    }
+
+    if (CLI::HasParam("predictions"))
+      CLI::GetParam<arma::Row<size_t>>("predictions") = std::move(predictions);
+    if (CLI::HasParam("scores"))
+      CLI::GetParam<arma::mat>("scores") = std::move(scores);
+  }
+
+  CLI::GetParam<SparseSVM*>("output_model") = model;
+}
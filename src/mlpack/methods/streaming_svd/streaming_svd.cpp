@@ -0,0 +1,136 @@
+/**
+ * @file streaming_svd.cpp
+ *
+ * Implementation of the single-pass streaming randomized SVD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "streaming_svd.hpp"
+
+namespace mlpack {
+namespace svd {
+
+StreamingSVD::StreamingSVD(const size_t oversampling,
+                           const size_t blockSize) :
+    oversampling(oversampling),
+    blockSize(blockSize),
+    rank(0),
+    numColumns(0)
+{
+  /* Nothing to do here */
+}
+
+void StreamingSVD::Reset(const size_t dimensionality, const size_t rank)
+{
+  if (rank == 0)
+    throw std::invalid_argument("StreamingSVD::Reset(): rank must be nonzero!");
+
+  this->rank = rank;
+  numColumns = 0;
+
+  // A sketch larger than the number of rows doesn't capture anything more.
+  const size_t k = std::min(rank + oversampling, dimensionality);
+  const size_t l = std::min(2 * k + 1, dimensionality);
+
+  psi = arma::randn<arma::mat>(l, dimensionality);
+  rangeSketch.zeros(dimensionality, k);
+  coRangeSketch.set_size(l, 0);
+  testSum.zeros(k);
+  columnSum.zeros(dimensionality);
+}
+
+void StreamingSVD::Update(const arma::mat& block)
+{
+  if (block.n_rows != psi.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "StreamingSVD::Update(): block has " << block.n_rows << " rows, but "
+        << "the sketch was reset with " << psi.n_cols << " rows!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The rows of Omega for these columns are only needed once, so they are
+  // drawn here instead of being stored.
+  const arma::mat omega = arma::randn<arma::mat>(block.n_cols,
+      rangeSketch.n_cols);
+  rangeSketch += block * omega;
+  testSum += arma::sum(omega, 0);
+  columnSum += arma::sum(block, 1);
+
+  // Grow the co-range sketch geometrically, so that appending blocks takes
+  // amortized linear time.
+  if (numColumns + block.n_cols > coRangeSketch.n_cols)
+  {
+    coRangeSketch.resize(psi.n_rows, std::max(2 * coRangeSketch.n_cols,
+        numColumns + block.n_cols));
+  }
+
+  if (block.n_cols > 0)
+  {
+    coRangeSketch.cols(numColumns, numColumns + block.n_cols - 1) =
+        psi * block;
+  }
+  numColumns += block.n_cols;
+}
+
+void StreamingSVD::Factorize(arma::mat& u,
+                             arma::vec& s,
+                             arma::mat& v,
+                             const bool center) const
+{
+  if (numColumns == 0)
+  {
+    throw std::invalid_argument("StreamingSVD::Factorize(): no columns have "
+        "been given to Update()!");
+  }
+
+  arma::mat y = rangeSketch;
+  arma::mat w = coRangeSketch.head_cols(numColumns);
+  if (center)
+  {
+    // The sketches of the centered matrix follow from the sketches of the
+    // matrix and the mean of its columns.
+    const arma::vec mean = columnSum / numColumns;
+    y -= mean * testSum;
+    w.each_col() -= psi * mean;
+  }
+
+  // Form an orthonormal basis of the range, and find the matrix X such that
+  // the matrix is approximately Q * X.
+  arma::mat q, r;
+  arma::qr_econ(q, r, y);
+  const arma::mat x = arma::solve(psi * q, w);
+
+  arma::mat ux;
+  arma::svd_econ(ux, s, v, x);
+  u = q * ux;
+
+  // Only keep the requested rank.
+  if (s.n_elem > rank)
+  {
+    u = u.head_cols(rank);
+    s = s.head(rank);
+    v = v.head_cols(rank);
+  }
+}
+
+void StreamingSVD::Apply(const arma::mat& data,
+                         arma::mat& u,
+                         arma::vec& s,
+                         arma::mat& v,
+                         const size_t rank)
+{
+  Reset(data.n_rows, rank);
+
+  const size_t step = std::max(blockSize, (size_t) 1);
+  for (size_t i = 0; i < data.n_cols; i += step)
+    Update(data.cols(i, std::min(i + step, (size_t) data.n_cols) - 1));
+
+  Factorize(u, s, v);
+}
+
+} // namespace svd
+} // namespace mlpack
@@ -0,0 +1,175 @@
+/**
+ * @file streaming_svd.hpp
+ *
+ * An implementation of the single-pass streaming randomized SVD.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_STREAMING_SVD_STREAMING_SVD_HPP
+#define MLPACK_METHODS_STREAMING_SVD_STREAMING_SVD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace svd {
+
+/**
+ * Streaming SVD computes a low-rank SVD of a matrix from a single pass over its
+ * columns, as described in "Practical sketching algorithms for low-rank matrix
+ * approximation".  Unlike RandomizedSVD and RandomizedBlockKrylovSVD, which
+ * need the whole matrix in memory and multiply by it several times, each block
+ * of columns is only seen once, by Update(), and only two sketches are kept:
+ * the range sketch Y = A * Omega, of size m x k, and the co-range sketch
+ * W = Psi * A, of size l x n, where k = rank + oversampling and l = 2k + 1.
+ * The columns of A can therefore be read from disk one block at a time, with
+ * O(k (m + n)) memory.  Factorize() then recovers A ~= Q * X with
+ * Q = orth(Y) and X = (Psi * Q)^+ * W, and computes the SVD of X.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{Tropp2017,
+ *   author  = {Tropp, J. A. and Yurtsever, A. and Udell, M. and Cevher, V.},
+ *   title   = {Practical Sketching Algorithms for Low-Rank Matrix
+ *              Approximation},
+ *   journal = {SIAM J. Matrix Anal. Appl.},
+ *   volume  = {38},
+ *   number  = {4},
+ *   pages   = {1454--1485},
+ *   year    = {2017},
+ * }
+ * @endcode
+ *
+ * Because the mean of the columns is also accumulated, Factorize() can return
+ * the SVD of the centered matrix, which is what principal components analysis
+ * needs, without a second pass.
+ *
+ * An example of how to use the interface is shown below:
+ *
+ * @code
+ * const size_t rank = 20; // Rank used for the decomposition.
+ *
+ * StreamingSVD sSVD;
+ * sSVD.Reset(dimensionality, rank);
+ *
+ * // Add each block of columns as it is read.
+ * arma::mat block;
+ * while (ReadNextBlock(block))
+ *   sSVD.Update(block);
+ *
+ * arma::mat u, v;
+ * arma::vec s;
+ * sSVD.Factorize(u, s, v);
+ * @endcode
+ */
+class StreamingSVD
+{
+ public:
+  /**
+   * Create object for the streaming SVD method.
+   *
+   * @param oversampling Number of columns of the range sketch in addition to
+   *     the rank.
+   * @param blockSize Number of columns processed at once by Apply().
+   */
+  StreamingSVD(const size_t oversampling = 10,
+               const size_t blockSize = 1024);
+
+  /**
+   * Start a new sketch of a matrix with the given number of rows.  This draws
+   * the random test matrix of the co-range sketch.
+   *
+   * @param dimensionality Number of rows of the matrix.
+   * @param rank Rank of the approximation.
+   */
+  void Reset(const size_t dimensionality, const size_t rank);
+
+  /**
+   * Add the given block of columns to the sketches.  The block must have as
+   * many rows as given to Reset().
+   *
+   * @param block Block of columns of the matrix.
+   */
+  void Update(const arma::mat& block);
+
+  /**
+   * Compute the SVD of the matrix formed by all the columns seen by Update()
+   * since the last call to Reset().
+   *
+   * @param u First unitary matrix.
+   * @param s Vector of singular values.
+   * @param v Second unitary matrix.
+   * @param center If true, the SVD of the matrix with the mean of its columns
+   *     subtracted is computed instead.
+   */
+  void Factorize(arma::mat& u,
+                 arma::vec& s,
+                 arma::mat& v,
+                 const bool center = false) const;
+
+  /**
+   * Compute the SVD of the given matrix in a single pass over its columns,
+   * which are processed in blocks of BlockSize() columns.
+   *
+   * @param data Data matrix.
+   * @param u First unitary matrix.
+   * @param s Vector of singular values.
+   * @param v Second unitary matrix.
+   * @param rank Rank of the approximation.
+   */
+  void Apply(const arma::mat& data,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v,
+             const size_t rank);
+
+  //! Get the number of columns seen since the last call to Reset().
+  size_t NumColumns() const { return numColumns; }
+
+  //! Get the oversampling of the range sketch.
+  size_t Oversampling() const { return oversampling; }
+  //! Modify the oversampling of the range sketch.  This takes effect on the
+  //! next call to Reset().
+  size_t& Oversampling() { return oversampling; }
+
+  //! Get the block size used by Apply().
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the block size used by Apply().
+  size_t& BlockSize() { return blockSize; }
+
+ private:
+  //! Locally stored oversampling of the range sketch.
+  size_t oversampling;
+
+  //! Locally stored block size used by Apply().
+  size_t blockSize;
+
+  //! Rank of the approximation.
+  size_t rank;
+
+  //! Number of columns seen since the last call to Reset().
+  size_t numColumns;
+
+  //! Random test matrix of the co-range sketch.
+  arma::mat psi;
+
+  //! Range sketch, Y = A * Omega.
+  arma::mat rangeSketch;
+
+  //! Co-range sketch, W = Psi * A; only the first numColumns columns are used.
+  arma::mat coRangeSketch;
+
+  //! Sum of the rows of the random test matrix Omega of the range sketch.
+  arma::rowvec testSum;
+
+  //! Sum of the columns seen.
+  arma::vec columnSum;
+};
+
+} // namespace svd
+} // namespace mlpack
+
+#endif
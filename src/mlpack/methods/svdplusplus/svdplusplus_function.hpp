@@ -154,6 +154,12 @@ namespace ens {
    * because the gradient affects only a small number of parameters per example,
    * and thus the normal abstraction does not work as fast as we might like it
    * to.
+   *
+   * The parallel SGD optimizer splits the ratings into strata of user blocks
+   * and item blocks (see RatingStrata), and the threads process strata that
+   * share no users and no items, so that they never update the same parameters.
+   * The implicit item vectors are shared by all users, so their updates are
+   * still atomic, but they are applied once for each user in each stratum.
    */
   template <>
   template <>
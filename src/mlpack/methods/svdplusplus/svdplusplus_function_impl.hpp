@@ -15,6 +15,8 @@
 
 #include "svdplusplus_function.hpp"
 #include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/util/threads.hpp>
+#include <mlpack/methods/regularized_svd/rating_strata.hpp>
 
 namespace mlpack {
 namespace svd {
@@ -414,6 +416,12 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
 
   // Rank of decomposition.
   const size_t rank = function.Rank();
+  const size_t implicitStart = numUsers + numItems;
+
+  // Split the ratings into one block of users and one block of items for each
+  // thread.
+  mlpack::svd::RatingStrata strata(data, numUsers, numItems,
+      mlpack::NumThreads());
 
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
@@ -456,94 +464,111 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
       std::shuffle(visitationOrder.begin(), visitationOrder.end(),
           mlpack::math::randGen);
 
-    #pragma omp parallel
+    // Each thread gets a share of threadShareSize ratings.
+    strata.Assign(visitationOrder, (threadShareSize >
+        visitationOrder.n_elem / strata.NumBlocks()) ? visitationOrder.n_elem :
+        threadShareSize * strata.NumBlocks());
+
+    // The strata processed by the threads in the same sub-epoch share no users
+    // and no items, so the updates of the user and item parameters need no
+    // synchronization.
+    for (size_t s = 0; s < strata.NumBlocks(); ++s)
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
-      size_t threadId = 0;
-      #ifdef HAS_OPENMP
-        threadId = omp_get_thread_num();
-      #endif
-
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+      #pragma omp parallel for schedule(dynamic)
+      for (omp_size_t b = 0; b < (omp_size_t) strata.NumBlocks(); ++b)
       {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-        const size_t implicitStart = numUsers + numItems;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        // Iterate through each item which the user interacted with to calculate
-        // user vector.
-        arma::vec userVec(rank, arma::fill::zeros);
-        arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-        arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-        size_t implicitCount = 0;
-        for (; it != it_end; ++it)
-        {
-          userVec += iterate.col(implicitStart + it.row()).subvec(0, rank - 1);
-          implicitCount += 1;
-        }
-        if (implicitCount != 0)
-          userVec /= std::sqrt(implicitCount);
-        userVec += iterate.col(user).subvec(0, rank - 1);
-
-        double ratingError = rating - userBias - itemBias -
-        arma::dot(userVec, iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * userVec);
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Update of item implicit vectors.
-        arma::mat itemImplicitUpdate(rank, implicitCount);
-        arma::Col<size_t> implicitItems(implicitCount);
-        it = implicitData.begin_col(user);
-        it_end = implicitData.end_col(user);
-        size_t implicitIndex = 0;
-        for (; it != it_end; ++it, ++implicitIndex)
+        const size_t c = strata.ItemBlock(b, s);
+
+        // Group the ratings of the stratum by user, keeping their order of
+        // visitation, so that the implicit term of each user is only computed
+        // once.
+        std::vector<size_t> stratum(
+            strata.Ratings().begin() + strata.Begin(b, c),
+            strata.Ratings().begin() + strata.End(b, c));
+        std::stable_sort(stratum.begin(), stratum.end(),
+            [&data](const size_t x, const size_t y)
+            { return data(0, x) < data(0, y); });
+
+        arma::vec implicitSum(rank), implicitGradient(rank);
+        size_t first = 0;
+        while (first < stratum.size())
         {
-          itemImplicitUpdate.col(implicitIndex) =
-              stepSize * 2.0 * (lambda / implicitCount *
-              iterate.col(implicitStart + it.row()).subvec(0, rank - 1) -
-              ratingError / std::sqrt(implicitCount) *
-              iterate.col(item).subvec(0, rank - 1));
-          implicitItems(implicitIndex) = it.row();
-        }
+          const size_t user = data(0, stratum[first]);
+          size_t last = first + 1;
+          while (last < stratum.size() && data(0, stratum[last]) == user)
+            ++last;
+
+          // Iterate through each item which the user interacted with to
+          // calculate the implicit term of the user vector.  The implicit item
+          // vectors are held fixed during the ratings of the user.
+          implicitSum.zeros();
+          size_t implicitCount = 0;
+          arma::sp_mat::const_iterator it = implicitData.begin_col(user);
+          arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
+          for (; it != it_end; ++it)
+          {
+            implicitSum += iterate.col(implicitStart + it.row()).subvec(0,
+                rank - 1);
+            implicitCount += 1;
+          }
+          if (implicitCount != 0)
+            implicitSum /= std::sqrt(implicitCount);
 
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < rank; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
-        }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
-        for (size_t k = 0; k < implicitCount; ++k)
-        {
-          for (size_t i = 0; i < rank; ++i)
+          implicitGradient.zeros();
+          for (size_t k = first; k < last; ++k)
           {
-            #pragma omp atomic
-            iterate(i, implicitStart + implicitItems(k)) -=
-                itemImplicitUpdate(i, k);
+            const size_t j = stratum[k];
+
+            // Indices for accessing the the correct parameter columns.
+            const size_t item = data(1, j) + numUsers;
+
+            // Prediction error for the example.
+            const double rating = data(2, j);
+            const double userBias = iterate(rank, user);
+            const double itemBias = iterate(rank, item);
+            const arma::vec userVec = implicitSum +
+                iterate.col(user).subvec(0, rank - 1);
+
+            double ratingError = rating - userBias - itemBias -
+                arma::dot(userVec, iterate.col(item).subvec(0, rank - 1));
+            implicitGradient += ratingError *
+                iterate.col(item).subvec(0, rank - 1);
+
+            arma::vec userVecUpdate = stepSize * 2 * (
+                lambda * iterate.col(user).subvec(0, rank - 1) -
+                ratingError * iterate.col(item).subvec(0, rank - 1));
+
+            // Gradient is non-zero only for the parameter columns
+            // corresponding to the example.
+            iterate.col(item).subvec(0, rank - 1) -= stepSize * 2 * (
+                lambda * iterate.col(item).subvec(0, rank - 1) -
+                ratingError * userVec);
+            iterate.col(user).subvec(0, rank - 1) -= userVecUpdate;
+            iterate(rank, user) -= stepSize * 2 * (lambda * userBias -
+                ratingError);
+            iterate(rank, item) -= stepSize * 2 * (lambda * itemBias -
+                ratingError);
           }
+
+          // Apply the updates of the implicit item vectors for all the ratings
+          // of the user at once.  These vectors are shared by all the users,
+          // so other threads may update them at the same time.
+          const double numRatings = last - first;
+          it = implicitData.begin_col(user);
+          for (; it != it_end; ++it)
+          {
+            const arma::vec itemImplicitUpdate = stepSize * 2.0 * (
+                numRatings * lambda / implicitCount *
+                iterate.col(implicitStart + it.row()).subvec(0, rank - 1) -
+                implicitGradient / std::sqrt(implicitCount));
+            for (size_t i = 0; i < rank; ++i)
+            {
+              #pragma omp atomic
+              iterate(i, implicitStart + it.row()) -= itemImplicitUpdate(i);
+            }
+          }
+
+          first = last;
         }
       }
     }
@@ -116,6 +116,14 @@ or upgrade Boost to 1.59 or newer.
 #include <mlpack/core/util/log.hpp>
 #include <mlpack/core/util/timers.hpp>
 
+// Use OpenMP if compiled with -DHAS_OPENMP.
+#ifdef HAS_OPENMP
+  #include <omp.h>
+#endif
+
+// Control over the number of threads that mlpack uses.
+#include <mlpack/core/util/threads.hpp>
+
 // This can be removed with Visual Studio supports an OpenMP version with
 // unsigned loop variables.
 #ifdef _WIN32
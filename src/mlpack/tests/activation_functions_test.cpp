@@ -21,6 +21,7 @@
 #include <mlpack/methods/ann/activation_functions/softplus_function.hpp>
 #include <mlpack/methods/ann/activation_functions/swish_function.hpp>
 #include <mlpack/methods/ann/activation_functions/hard_sigmoid_function.hpp>
+#include <mlpack/methods/ann/activation_functions/fast_math.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -604,4 +605,127 @@ BOOST_AUTO_TEST_CASE(HardSigmoidFunctionTest)
       desiredDerivatives);
 }
 
+/**
+ * Compute the largest relative error of the FastMath approximations over the
+ * given points, with respect to the standard library.
+ */
+template<bool Accurate, typename eT>
+double FastMathError(const arma::vec& points)
+{
+  const arma::Col<eT> x = arma::conv_to<arma::Col<eT>>::from(points);
+  arma::Col<eT> y(x.n_elem);
+
+  double error = 0.0;
+  FastMath::Exp<Accurate>(x.memptr(), y.memptr(), x.n_elem);
+  for (size_t i = 0; i < x.n_elem; ++i)
+  {
+    const double target = std::exp((double) x[i]);
+    error = std::max(error, std::abs(y[i] - target) / target);
+  }
+
+  FastMath::Logistic<Accurate>(x.memptr(), y.memptr(), x.n_elem);
+  for (size_t i = 0; i < x.n_elem; ++i)
+  {
+    const double target = 1.0 / (1.0 + std::exp(-(double) x[i]));
+    error = std::max(error, std::abs(y[i] - target) / target);
+  }
+
+  FastMath::Tanh<Accurate>(x.memptr(), y.memptr(), x.n_elem);
+  for (size_t i = 0; i < x.n_elem; ++i)
+  {
+    const double target = std::tanh((double) x[i]);
+    if (target != 0.0)
+      error = std::max(error, std::abs(y[i] - target) / std::abs(target));
+    else
+      error = std::max(error, (double) std::abs(y[i]));
+  }
+
+  FastMath::Softplus<Accurate>(x.memptr(), y.memptr(), x.n_elem);
+  for (size_t i = 0; i < x.n_elem; ++i)
+  {
+    const double target = std::log1p(std::exp((double) x[i]));
+    error = std::max(error, std::abs(y[i] - target) / target);
+  }
+
+  return error;
+}
+
+/**
+ * Make sure that the accurate and the fast approximations of FastMath are as
+ * precise as documented, both near zero and in the saturated regions.
+ */
+BOOST_AUTO_TEST_CASE(FastMathAccuracyTest)
+{
+  const arma::vec points = arma::join_cols(arma::linspace(-80, 80, 16001),
+      arma::linspace(-0.25, 0.25, 5001));
+
+  BOOST_REQUIRE_LT((FastMathError<true, double>(points)), 1e-14);
+  BOOST_REQUIRE_LT((FastMathError<false, double>(points)), 1e-6);
+  BOOST_REQUIRE_LT((FastMathError<true, float>(points)), 1e-6);
+  BOOST_REQUIRE_LT((FastMathError<false, float>(points)), 2e-6);
+}
+
+/**
+ * Make sure that the FastMath approximations saturate instead of overflowing
+ * for large inputs.
+ */
+BOOST_AUTO_TEST_CASE(FastMathLimitsTest)
+{
+  const arma::vec x("-1000 -710 710 1000");
+  arma::vec y(x.n_elem);
+
+  FastMath::Logistic<false>(x.memptr(), y.memptr(), x.n_elem);
+  BOOST_REQUIRE_SMALL(y[0], 1e-300);
+  BOOST_REQUIRE_SMALL(y[1], 1e-300);
+  BOOST_REQUIRE_CLOSE(y[2], 1.0, 1e-10);
+  BOOST_REQUIRE_CLOSE(y[3], 1.0, 1e-10);
+
+  FastMath::Tanh<false>(x.memptr(), y.memptr(), x.n_elem);
+  BOOST_REQUIRE_CLOSE(y[0], -1.0, 1e-10);
+  BOOST_REQUIRE_CLOSE(y[1], -1.0, 1e-10);
+  BOOST_REQUIRE_CLOSE(y[2], 1.0, 1e-10);
+  BOOST_REQUIRE_CLOSE(y[3], 1.0, 1e-10);
+
+  FastMath::Softplus<false>(x.memptr(), y.memptr(), x.n_elem);
+  BOOST_REQUIRE_SMALL(y[0], 1e-300);
+  BOOST_REQUIRE_SMALL(y[1], 1e-300);
+  BOOST_REQUIRE_CLOSE(y[2], 710.0, 1e-10);
+  BOOST_REQUIRE_CLOSE(y[3], 1000.0, 1e-10);
+}
+
+/**
+ * Make sure that the vectorized matrix overloads of the activation functions
+ * agree with the scalar ones.
+ */
+template<class ActivationFunction>
+void CheckMatrixActivationCorrect()
+{
+  const arma::mat input = 10 * arma::randn<arma::mat>(10, 100);
+
+  arma::mat activations, derivatives;
+  ActivationFunction::Fn(input, activations);
+  ActivationFunction::Deriv(input, derivatives);
+  BOOST_REQUIRE_EQUAL(activations.n_rows, input.n_rows);
+  BOOST_REQUIRE_EQUAL(activations.n_cols, input.n_cols);
+
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(activations[i], ActivationFunction::Fn(input[i]),
+        1e-4);
+    BOOST_REQUIRE_SMALL(derivatives[i] - ActivationFunction::Deriv(input[i]),
+        1e-6);
+  }
+}
+
+/**
+ * Test the vectorized matrix overloads of the activation functions.
+ */
+BOOST_AUTO_TEST_CASE(MatrixActivationFunctionsTest)
+{
+  CheckMatrixActivationCorrect<LogisticFunction>();
+  CheckMatrixActivationCorrect<TanhFunction>();
+  CheckMatrixActivationCorrect<SoftplusFunction>();
+  CheckMatrixActivationCorrect<SwishFunction>();
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -891,4 +891,80 @@ BOOST_AUTO_TEST_CASE(DecisionStumpSerializationTest)
   }
 }
 
+/**
+ * Make sure that the blocked Classify() gives the same predictions as the
+ * weighted vote of the weak learners, on more points than fit in one block.
+ */
+BOOST_AUTO_TEST_CASE(BlockedClassifyTest)
+{
+  mat data = randu<mat>(4, 1000);
+  Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    labels[i] = (data(0, i) + data(2, i) > 1.0) ? 1 : ((i % 7 == 0) ? 2 : 0);
+
+  DecisionStump<> ds(data, labels, 3, 20);
+  AdaBoost<DecisionStump<>> ab(data, labels, 3, ds, 20, 1e-10);
+
+  mat testData = randu<mat>(4, 777);
+  Row<size_t> predictions;
+  ab.Classify(testData, predictions);
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+
+  // Compute the votes learner by learner.
+  mat votes(3, testData.n_cols, fill::zeros);
+  for (size_t i = 0; i < ab.WeakLearners(); ++i)
+  {
+    Row<size_t> weakPredictions;
+    ab.WeakLearner(i).Classify(testData, weakPredictions);
+    for (size_t j = 0; j < testData.n_cols; ++j)
+      votes(weakPredictions[j], j) += ab.Alpha(i);
+  }
+
+  for (size_t j = 0; j < testData.n_cols; ++j)
+  {
+    uword maxIndex = 0;
+    votes.unsafe_col(j).max(maxIndex);
+    BOOST_REQUIRE_EQUAL(predictions[j], (size_t) maxIndex);
+  }
+}
+
+/**
+ * Run AdaBoost with sparse perceptrons as the weak learner on the UCI Iris
+ * dataset, and make sure the Hamming loss bound holds as in the dense case.
+ */
+BOOST_AUTO_TEST_CASE(SparsePerceptronHammingLossBoundIris)
+{
+  arma::mat inputData;
+
+  if (!data::Load("iris.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset iris.csv!");
+
+  arma::Mat<size_t> labels;
+  if (!data::Load("iris_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for iris iris_labels.txt");
+
+  const size_t numClasses = max(labels.row(0)) + 1;
+  const arma::sp_mat sparseData(inputData);
+
+  typedef Perceptron<SimpleWeightUpdate, ZeroInitialization, arma::sp_mat>
+      SparsePerceptron;
+  SparsePerceptron p(sparseData, labels.row(0), numClasses, 400);
+
+  size_t iterations = 50;
+  double tolerance = 1e-10;
+  AdaBoost<SparsePerceptron, arma::sp_mat> a(sparseData, labels.row(0),
+      numClasses, p, iterations, tolerance);
+
+  arma::Row<size_t> predictedLabels;
+  a.Classify(sparseData, predictedLabels);
+
+  size_t countError = 0;
+  for (size_t i = 0; i < labels.n_cols; i++)
+    if (labels(i) != predictedLabels(i))
+      countError++;
+  double hammingLoss = (double) countError / labels.n_cols;
+
+  BOOST_REQUIRE_LE(hammingLoss, a.ZtProduct());
+}
+
 BOOST_AUTO_TEST_SUITE_END();
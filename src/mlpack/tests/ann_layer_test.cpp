@@ -233,6 +233,58 @@ BOOST_AUTO_TEST_CASE(DropoutProbabilityTest)
   }
 }
 
+/**
+ * Make sure that the dropout mask keeps the right fraction of the elements,
+ * that Apply() and Mask() agree with Kept(), that the mask only depends on the
+ * random seed, and that the backward pass of Dropout uses the mask of the
+ * forward pass.
+ */
+BOOST_AUTO_TEST_CASE(DropoutMaskTest)
+{
+  const double ratio = 0.3;
+  math::RandomSeed(42);
+  DropoutMask mask;
+  mask.Generate(513, 40, ratio);
+
+  arma::mat input = arma::randu<arma::mat>(513, 40) + 1.0;
+  arma::mat output, denseMask;
+  mask.Apply(input, output, 2.0, 0.5, -1.0);
+  mask.Mask(denseMask);
+
+  size_t kept = 0;
+  for (size_t i = 0; i < input.n_elem; ++i)
+  {
+    if (mask.Kept(i))
+    {
+      ++kept;
+      BOOST_REQUIRE_CLOSE(output[i], input[i] * 2.0 + 0.5, 1e-10);
+      BOOST_REQUIRE_EQUAL(denseMask[i], 1.0);
+    }
+    else
+    {
+      BOOST_REQUIRE_EQUAL(output[i], -1.0);
+      BOOST_REQUIRE_EQUAL(denseMask[i], 0.0);
+    }
+  }
+  BOOST_REQUIRE_CLOSE((double) kept / input.n_elem, 1.0 - ratio, 3.0);
+
+  // The same seed gives the same mask.
+  math::RandomSeed(42);
+  DropoutMask otherMask;
+  otherMask.Generate(513, 40, ratio);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(otherMask.Kept(i), mask.Kept(i));
+
+  // The backward pass drops the same units as the forward pass.
+  Dropout<> module(ratio);
+  module.Deterministic() = false;
+  arma::mat ones = arma::ones(200, 10);
+  arma::mat delta;
+  module.Forward(std::move(ones), std::move(output));
+  module.Backward(std::move(ones), std::move(ones), std::move(delta));
+  CheckMatrices(output, delta);
+}
+
 /*
  * Perform dropout with probability 1 - p where p = 0, means no dropout.
  */
@@ -445,6 +497,48 @@ BOOST_AUTO_TEST_CASE(SimpleLinearNoBiasLayerTest)
   BOOST_REQUIRE_EQUAL(arma::accu(delta), 0);
 }
 
+/**
+ * Make sure that the quantized linear module is close to the linear module it
+ * was created from.
+ */
+BOOST_AUTO_TEST_CASE(SimpleQuantizedLinearLayerTest)
+{
+  arma::mat input = arma::randu(10, 5) - 0.5;
+  Linear<> linear(10, 4);
+  linear.Parameters().randu();
+  linear.Reset();
+
+  arma::mat output;
+  linear.Forward(std::move(input), std::move(output));
+
+  const arma::mat weight(linear.Parameters().memptr(), 4, 10);
+  const arma::mat bias(linear.Parameters().memptr() + weight.n_elem, 4, 1);
+  QuantizedLinear<> module(weight, bias, arma::abs(input).max());
+  BOOST_REQUIRE_EQUAL(module.Weights().size(), 40);
+
+  // Each weight and each input is off by at most half of its scale.
+  arma::mat quantizedOutput;
+  module.Forward(std::move(input), std::move(quantizedOutput));
+  BOOST_REQUIRE_EQUAL(quantizedOutput.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(quantizedOutput.n_cols, 5);
+  BOOST_REQUIRE_LE(arma::abs(quantizedOutput - output).max(), 0.05);
+
+  BOOST_REQUIRE_LE(arma::abs(module.DequantizedWeight() - weight).max(),
+      module.WeightScales().max() / 2 + 1e-10);
+
+  // Inputs outside of the calibrated range are clamped.
+  arma::mat largeInput = 10 * arma::ones(10, 1);
+  module.Forward(std::move(largeInput), std::move(quantizedOutput));
+  arma::mat clampedOutput = weight * arma::ones(10, 1) *
+      arma::abs(input).max() + bias;
+  BOOST_REQUIRE_LE(arma::abs(quantizedOutput - clampedOutput).max(), 0.05);
+
+  // The backward pass uses the dequantized weights.
+  arma::mat error = arma::ones(4, 5), delta;
+  module.Backward(std::move(input), std::move(error), std::move(delta));
+  CheckMatrices(delta, module.DequantizedWeight().t() * error);
+}
+
 /**
  * Jacobian linear no bias module test.
  */
@@ -817,6 +911,51 @@ BOOST_AUTO_TEST_CASE(GradientLSTMLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
 }
 
+/**
+ * LSTM layer numerical gradient test with a batch of sequences, which checks
+ * the fused computation of the gates over several columns.
+ */
+BOOST_AUTO_TEST_CASE(GradientLSTMLayerBatchTest)
+{
+  // LSTM function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(2, 4, 5);
+      target.ones(1, 4, 5);
+      const size_t rho = 5;
+
+      model = new RNN<NegativeLogLikelihood<> >(rho);
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(2, 6);
+      model->Add<LSTM<> >(6, 3, rho);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 4);
+      model->Gradient(model->Parameters(), 0, gradient, 4);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    RNN<NegativeLogLikelihood<> >* model;
+    arma::cube input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
+}
+
 /**
  * Test the FastLSTM layer with a user defined rho parameter and without.
  */
@@ -1193,6 +1332,111 @@ BOOST_AUTO_TEST_CASE(SimpleLookupLayerTest)
   BOOST_REQUIRE_CLOSE(arma::accu(gradient), arma::accu(error), 1e-3);
 }
 
+/**
+ * Test that the Lookup gradient sums the errors of repeated entries, and that
+ * reusing the gradient only keeps the entries of the last call.
+ */
+BOOST_AUTO_TEST_CASE(LookupLayerRepeatedGradientTest)
+{
+  arma::mat gradient;
+  Lookup<> module(10, 3);
+  module.Parameters().randu();
+
+  arma::mat input("2 5 2");
+  arma::mat error = arma::randu(3, 3);
+  module.Gradient(std::move(input), std::move(error), std::move(gradient));
+
+  arma::mat expected = arma::zeros(3, 10);
+  expected.col(1) = error.col(0) + error.col(2);
+  expected.col(4) = error.col(1);
+  CheckMatrices(gradient, expected);
+  BOOST_REQUIRE_EQUAL(module.Indices().n_elem, 2);
+  BOOST_REQUIRE_EQUAL(module.Indices()[0], 1);
+  BOOST_REQUIRE_EQUAL(module.Indices()[1], 4);
+
+  // The same gradient again, with other entries.
+  input = arma::mat("7 1");
+  error = arma::randu(3, 2);
+  module.Gradient(std::move(input), std::move(error), std::move(gradient));
+
+  expected.zeros();
+  expected.col(6) = error.col(0);
+  expected.col(0) = error.col(1);
+  CheckMatrices(gradient, expected);
+}
+
+/**
+ * Test the MaxPooling layer with overlapping windows on a batch of points with
+ * several channels against a direct computation.
+ */
+BOOST_AUTO_TEST_CASE(MaxPoolingLayerTest)
+{
+  arma::mat input = arma::randu(5 * 4 * 2, 3), output, delta;
+  MaxPooling<> module(2, 2, 1, 1);
+  module.InputWidth() = 5;
+  module.InputHeight() = 4;
+
+  module.Forward(std::move(input), std::move(output));
+  BOOST_REQUIRE_EQUAL(module.OutputWidth(), 4);
+  BOOST_REQUIRE_EQUAL(module.OutputHeight(), 3);
+  BOOST_REQUIRE_EQUAL(output.n_rows, 4 * 3 * 2);
+  BOOST_REQUIRE_EQUAL(output.n_cols, 3);
+
+  arma::cube inputCube(input.memptr(), 5, 4, 6, false, true);
+  arma::cube outputCube(output.memptr(), 4, 3, 6, false, true);
+  for (size_t s = 0; s < 6; ++s)
+    for (size_t j = 0; j < 3; ++j)
+      for (size_t i = 0; i < 4; ++i)
+      {
+        BOOST_REQUIRE_CLOSE(outputCube(i, j, s), inputCube.slice(s).submat(
+            i, j, i + 1, j + 1).max(), 1e-5);
+      }
+
+  // The error goes to the maxima, summed where windows overlap.
+  arma::mat error = arma::randu(output.n_rows, output.n_cols);
+  module.Backward(std::move(input), std::move(error), std::move(delta));
+  BOOST_REQUIRE_EQUAL(delta.n_rows, input.n_rows);
+  BOOST_REQUIRE_EQUAL(delta.n_cols, input.n_cols);
+  BOOST_REQUIRE_CLOSE(arma::accu(delta), arma::accu(error), 1e-5);
+  for (size_t i = 0; i < delta.n_elem; ++i)
+  {
+    if (delta[i] != 0)
+      BOOST_REQUIRE_GT(arma::accu(output == input[i]), 0);
+  }
+}
+
+/**
+ * Test the MeanPooling layer with overlapping windows on a batch of points with
+ * several channels against a direct computation.
+ */
+BOOST_AUTO_TEST_CASE(MeanPoolingLayerTest)
+{
+  arma::mat input = arma::randu(5 * 4 * 2, 3), output, delta;
+  MeanPooling<> module(3, 2, 2, 1);
+  module.InputWidth() = 5;
+  module.InputHeight() = 4;
+
+  module.Forward(std::move(input), std::move(output));
+  BOOST_REQUIRE_EQUAL(module.OutputWidth(), 2);
+  BOOST_REQUIRE_EQUAL(module.OutputHeight(), 3);
+
+  arma::cube inputCube(input.memptr(), 5, 4, 6, false, true);
+  arma::cube outputCube(output.memptr(), 2, 3, 6, false, true);
+  for (size_t s = 0; s < 6; ++s)
+    for (size_t j = 0; j < 3; ++j)
+      for (size_t i = 0; i < 2; ++i)
+      {
+        BOOST_REQUIRE_CLOSE(outputCube(i, j, s), arma::mean(arma::vectorise(
+            inputCube.slice(s).submat(2 * i, j, 2 * i + 2, j + 1))), 1e-5);
+      }
+
+  // The layer is linear, so the backward pass is its transpose.
+  arma::mat error = arma::randu(output.n_rows, output.n_cols);
+  module.Backward(std::move(input), std::move(error), std::move(delta));
+  BOOST_REQUIRE_CLOSE(arma::accu(delta % input), arma::accu(error % output),
+      1e-5);
+}
+
 /**
  * Simple LogSoftMax module test.
  */
@@ -1639,6 +1883,125 @@ BOOST_AUTO_TEST_CASE(GradientAtrousConvolutionLayerTest)
   BOOST_REQUIRE_LE(CheckGradient(function), 0.2);
 }
 
+/**
+ * Make sure that a Convolution layer that uses the im2col rules gives the same
+ * results as a Convolution layer that uses the naive rules.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColConvolutionLayerTest)
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution>> Im2ColConvolutionLayer;
+
+  // Use padding, and a batch of three 7x6 images with two channels.
+  Convolution<> naive(2, 3, 3, 2, 1, 1, 1, 1, 7, 6);
+  Im2ColConvolutionLayer im2col(2, 3, 3, 2, 1, 1, 1, 1, 7, 6);
+
+  naive.Parameters().randu(3 * 2 * 2 * 3 + 3, 1);
+  naive.Reset();
+  im2col.Parameters() = naive.Parameters();
+  im2col.Reset();
+
+  arma::mat input = arma::randu<arma::mat>(7 * 6 * 2, 3);
+  arma::mat naiveOutput, im2colOutput;
+  naive.Forward(std::move(input), std::move(naiveOutput));
+  im2col.Forward(std::move(input), std::move(im2colOutput));
+  CheckMatrices(naiveOutput, im2colOutput, 1e-5);
+
+  arma::mat error = arma::randu<arma::mat>(naiveOutput.n_rows,
+      naiveOutput.n_cols);
+  arma::mat naiveDelta, im2colDelta;
+  naive.Backward(std::move(input), std::move(error),
+      std::move(naiveDelta));
+  im2col.Backward(std::move(input), std::move(error),
+      std::move(im2colDelta));
+  CheckMatrices(naiveDelta, im2colDelta, 1e-5);
+
+  // The naive rules only keep the bias gradient of the last image, so compare
+  // the gradients on a single image.
+  arma::mat single = input.col(0);
+  naive.Forward(std::move(single), std::move(naiveOutput));
+  im2col.Forward(std::move(single), std::move(im2colOutput));
+  error = error.col(0);
+  arma::mat naiveGradient, im2colGradient;
+  naive.Gradient(std::move(single), std::move(error),
+      std::move(naiveGradient));
+  im2col.Gradient(std::move(single), std::move(error),
+      std::move(im2colGradient));
+  CheckMatrices(naiveGradient, im2colGradient, 1e-5);
+}
+
+/**
+ * Im2col Convolution layer numerical gradient test, with padding and strides.
+ */
+BOOST_AUTO_TEST_CASE(GradientIm2ColConvolutionLayerTest)
+{
+  typedef Convolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution>> Im2ColConvolutionLayer;
+  typedef FFN<NegativeLogLikelihood<>, RandomInitialization,
+      Im2ColConvolutionLayer> NetworkType;
+
+  // Add function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu<arma::mat>(6 * 6 * 2, 1);
+      target = arma::mat("1");
+
+      model = new NetworkType();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<Im2ColConvolutionLayer>(2, 2, 3, 3, 2, 2, 1, 1, 6, 6);
+      model->Add<LogSoftMax<> >();
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    NetworkType* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
+}
+
+/**
+ * Make sure that an AtrousConvolution layer that uses the im2col rules gives
+ * the same output as one that uses the naive rules.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColAtrousConvolutionLayerTest)
+{
+  AtrousConvolution<> naive(2, 2, 3, 3, 1, 1, 0, 0, 9, 8, 2, 2);
+  AtrousConvolution<Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution>> im2col(2, 2, 3, 3, 1, 1, 0, 0, 9,
+      8, 2, 2);
+
+  naive.Parameters().randu(3 * 3 * 2 * 2 + 2, 1);
+  naive.Reset();
+  im2col.Parameters() = naive.Parameters();
+  im2col.Reset();
+
+  arma::mat input = arma::randu<arma::mat>(9 * 8 * 2, 2);
+  arma::mat naiveOutput, im2colOutput;
+  naive.Forward(std::move(input), std::move(naiveOutput));
+  im2col.Forward(std::move(input), std::move(im2colOutput));
+  CheckMatrices(naiveOutput, im2colOutput, 1e-5);
+}
+
 /**
  * Tests the LayerNorm layer.
  */
@@ -2082,6 +2445,46 @@ BOOST_AUTO_TEST_CASE(SimpleResidualLayerTest)
   delete linearB;
 }
 
+/**
+ * Check that the output and the delta of a sequential module are aliases of
+ * the output of its last layer and of the delta of its first layer.
+ */
+BOOST_AUTO_TEST_CASE(SequentialAliasTest)
+{
+  arma::mat output, delta;
+  Sequential<> sequential;
+
+  Linear<>* linearA = new Linear<>(10, 8);
+  linearA->Parameters().randu();
+  linearA->Reset();
+  Linear<>* linearB = new Linear<>(8, 5);
+  linearB->Parameters().randu();
+  linearB->Reset();
+  sequential.Add(linearA);
+  sequential.Add(linearB);
+
+  arma::mat input = arma::randu(10, 4);
+  arma::mat error = arma::randu(5, 4);
+  sequential.Forward(std::move(input), std::move(output));
+  BOOST_REQUIRE_EQUAL(output.memptr(), linearB->OutputParameter().memptr());
+
+  CheckMatrices(output, arma::reshape(linearB->Parameters().rows(0, 39), 5, 8)
+      * (arma::reshape(linearA->Parameters().rows(0, 79), 8, 10) * input +
+      arma::repmat(linearA->Parameters().rows(80, 87), 1, 4)) +
+      arma::repmat(linearB->Parameters().rows(40, 44), 1, 4));
+
+  sequential.Backward(std::move(input), std::move(error), std::move(delta));
+  BOOST_REQUIRE_EQUAL(delta.memptr(), linearA->Delta().memptr());
+  CheckMatrices(delta, arma::reshape(linearA->Parameters().rows(0, 79), 8,
+      10).t() * arma::reshape(linearB->Parameters().rows(0, 39), 5, 8).t() *
+      error);
+
+  // An alias of columns of a matrix reads them in place.
+  const arma::mat alias = math::MakeColsAlias(input, 1, 2);
+  BOOST_REQUIRE_EQUAL(alias.memptr(), input.colptr(1));
+  CheckMatrices(alias, input.cols(1, 2));
+}
+
 /**
  * Sequential layer numerical gradient test.
  */
@@ -68,4 +68,19 @@ BOOST_AUTO_TEST_CASE(BinerizeAll)
   BOOST_REQUIRE_CLOSE(output(2, 2), 1.0, 1e-5); // 9
 }
 
+BOOST_AUTO_TEST_CASE(BinarizeInPlace)
+{
+  mat input = randu<mat>(5, 100);
+  mat expected, expectedDimension;
+  Binarize<double>(input, expected, 0.5);
+  Binarize<double>(input, expectedDimension, 0.5, 3);
+
+  mat inputDimension(input);
+  Binarize<double>(input, 0.5);
+  Binarize<double>(inputDimension, 0.5, 3);
+
+  CheckMatrices(input, expected);
+  CheckMatrices(inputDimension, expectedDimension);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
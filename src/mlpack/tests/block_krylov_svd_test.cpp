@@ -109,4 +109,39 @@ BOOST_AUTO_TEST_CASE(RandomizedBlockKrylovSVDNoisyLowRankTest)
   BOOST_REQUIRE_SMALL(error, 1e-2);
 }
 
+/**
+ * The SVD of a sparse matrix should be the same as the SVD of the same matrix
+ * in dense form.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedBlockKrylovSVDSparseTest)
+{
+  arma::sp_mat data = arma::sprandu<arma::sp_mat>(50, 400, 0.05);
+  arma::mat denseData(data);
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  svd::RandomizedBlockKrylovSVD rSVD(5, 10);
+
+  // Use the same random block for both decompositions.
+  math::RandomSeed(42);
+  rSVD.Apply(denseData, U1, s1, V1, 5);
+  math::RandomSeed(42);
+  rSVD.Apply(data, U2, s2, V2, 5);
+
+  CheckMatrices(s1, s2, 1e-3);
+
+  const arma::mat reconstruct = U1 * arma::diagmat(s1) * V1.t();
+  const double error = arma::norm(reconstruct - U2 * arma::diagmat(s2) *
+      V2.t(), "frob") / arma::norm(reconstruct, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+
+  // The leading singular values should also be close to the exact ones.
+  arma::mat U3, V3;
+  arma::vec s3;
+  arma::svd_econ(U3, s3, V3, denseData);
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(s2[i], s3[i], 1.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -29,6 +29,7 @@
 #include <mlpack/methods/cf/neighbor_search_policies/lmetric_search.hpp>
 #include <mlpack/methods/cf/neighbor_search_policies/cosine_search.hpp>
 #include <mlpack/methods/cf/neighbor_search_policies/pearson_search.hpp>
+#include <mlpack/methods/cf/neighbor_search_policies/max_inner_product_search.hpp>
 #include <mlpack/methods/cf/interpolation_policies/average_interpolation.hpp>
 #include <mlpack/methods/cf/interpolation_policies/similarity_interpolation.hpp>
 #include <mlpack/methods/cf/interpolation_policies/regression_interpolation.hpp>
@@ -291,6 +292,188 @@ void BatchPredict()
   }
 }
 
+/**
+ * Make sure that the recommendations of each user are the unrated items with
+ * the highest predicted ratings, in decreasing order of rating.
+ */
+template<typename DecompositionPolicy,
+         typename NormalizationType = NoNormalization>
+void RecommendationsMatchPredictions()
+{
+  DecompositionPolicy decomposition;
+
+  // Load GroupLens data.
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy,
+      NormalizationType> c(dataset, decomposition, 5, 5, 30);
+
+  arma::Col<size_t> users(10);
+  for (size_t i = 0; i < users.n_elem; ++i)
+    users(i) = 3 * i;
+
+  const size_t numRecs = 10;
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(numRecs, recommendations, users);
+
+  const arma::sp_mat& cleanedData = c.CleanedData();
+  const size_t numItems = cleanedData.n_rows;
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    // Predict the rating of every item for the user.
+    arma::Mat<size_t> combinations(2, numItems);
+    combinations.row(0).fill(users(i));
+    combinations.row(1) = arma::linspace<arma::Row<size_t>>(0, numItems - 1,
+        numItems);
+
+    arma::vec predictions;
+    c.Predict(combinations, predictions);
+
+    // The items that the user rated can't be recommended.
+    for (size_t item = 0; item < numItems; ++item)
+    {
+      if (cleanedData(item, users(i)) != 0.0)
+        predictions(item) = -DBL_MAX;
+    }
+
+    double lowest = DBL_MAX;
+    for (size_t j = 0; j < numRecs; ++j)
+    {
+      const size_t item = recommendations(j, i);
+      BOOST_REQUIRE_LT(item, numItems);
+      BOOST_REQUIRE_EQUAL(cleanedData(item, users(i)), 0.0);
+      BOOST_REQUIRE_LE(predictions(item), lowest + 1e-6);
+
+      lowest = predictions(item);
+      predictions(item) = -DBL_MAX;
+    }
+
+    // No other item has a higher predicted rating.
+    BOOST_REQUIRE_LE(predictions.max(), lowest + 1e-6);
+  }
+}
+
+/**
+ * Make sure that the recommendations obtained with an exact index over the
+ * item vectors are the same as the recommendations obtained from the ratings
+ * of every item.
+ */
+template<typename DecompositionPolicy>
+void IndexedRecommendations()
+{
+  DecompositionPolicy decomposition;
+
+  // Load GroupLens data.
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  arma::Col<size_t> users(20);
+  for (size_t i = 0; i < users.n_elem; ++i)
+    users(i) = 7 * i;
+
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(10, recommendations, users);
+
+  arma::mat items;
+  c.Decomposition().GetItemVectors(items);
+  BOOST_REQUIRE_EQUAL(items.n_cols, c.CleanedData().n_rows);
+
+  MaxInnerProductSearch itemSearch(items);
+  arma::Mat<size_t> indexedRecommendations;
+  c.GetRecommendations(10, indexedRecommendations, users, itemSearch);
+
+  CheckMatrices(indexedRecommendations, recommendations);
+}
+
+/**
+ * Compute the root mean squared error of the decomposition on the given raw
+ * ratings of the given users, whose IDs start at firstUser; and the same for
+ * items if the ratings are of items.
+ */
+template<typename CFModelType>
+double FoldInRMSE(const CFModelType& c,
+                  const arma::sp_mat& ratings,
+                  const size_t firstUser,
+                  const size_t firstItem)
+{
+  double error = 0.0;
+  for (arma::sp_mat::const_iterator it = ratings.begin(); it != ratings.end();
+       ++it)
+  {
+    const size_t user = firstUser + it.col();
+    const size_t item = firstItem + it.row();
+    const double rating = c.Normalization().Denormalize(user, item,
+        c.Decomposition().GetRating(user, item));
+    error += std::pow(rating - *it, 2.0);
+  }
+
+  return std::sqrt(error / ratings.n_nonzero);
+}
+
+/**
+ * Make sure that new users and items can be folded into a trained model, and
+ * that their fitted vectors describe their ratings about as well as the
+ * trained vectors of the users and items they copy.
+ */
+template<typename DecompositionPolicy,
+         typename NormalizationType = NoNormalization>
+void FoldIn()
+{
+  DecompositionPolicy decomposition;
+
+  // Load GroupLens data.
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  CFType<DecompositionPolicy,
+      NormalizationType> c(dataset, decomposition, 5, 5, 30);
+  const size_t numUsers = c.CleanedData().n_cols;
+  const size_t numItems = c.CleanedData().n_rows;
+
+  arma::sp_mat rawData;
+  CFType<DecompositionPolicy, NormalizationType>::CleanData(dataset, rawData);
+
+  // Fold in copies of the first users.
+  const arma::sp_mat userRatings = rawData.cols(0, 4);
+  const double trainedUserRMSE = FoldInRMSE(c, userRatings, 0, 0);
+  c.FoldInUsers(userRatings);
+
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_cols, numUsers + 5);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().H().n_cols, numUsers + 5);
+  BOOST_REQUIRE_LE(FoldInRMSE(c, userRatings, numUsers, 0),
+      trainedUserRMSE + 0.1);
+
+  // Fold in copies of the first items.
+  const arma::sp_mat itemRatings = rawData.rows(0, 4);
+  const double trainedItemRMSE = FoldInRMSE(c, itemRatings, 0, 0);
+
+  // The ratings of the new items include the new users.
+  arma::sp_mat newItemRatings(5, numUsers + 5);
+  newItemRatings.cols(0, numUsers - 1) = itemRatings;
+  c.FoldInItems(newItemRatings);
+
+  BOOST_REQUIRE_EQUAL(c.CleanedData().n_rows, numItems + 5);
+  BOOST_REQUIRE_EQUAL(c.Decomposition().W().n_rows, numItems + 5);
+  BOOST_REQUIRE_LE(FoldInRMSE(c, itemRatings, 0, numItems),
+      trainedItemRMSE + 0.1);
+
+  // The new users can get recommendations, which don't include the items they
+  // rated.
+  arma::Col<size_t> users(1);
+  users(0) = numUsers;
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(10, recommendations, users);
+  for (size_t i = 0; i < recommendations.n_elem; ++i)
+  {
+    BOOST_REQUIRE_LT(recommendations[i], numItems + 5);
+    if (recommendations[i] < numItems)
+      BOOST_REQUIRE_EQUAL(userRatings(recommendations[i], 0), 0.0);
+  }
+}
+
 /**
  * Make sure we can train an already-trained model and it works okay.
  */
@@ -900,6 +1083,26 @@ BOOST_AUTO_TEST_CASE(TrainSVDIncompleteTest)
   Train(decomposition);
 }
 
+/**
+ * Make sure we can train an already-trained model and it works okay for the
+ * parallel SVD Complete and Incomplete Incremental methods.
+ */
+BOOST_AUTO_TEST_CASE(TrainParallelSVDIncrementalTest)
+{
+  const size_t numThreads = NumThreads();
+  SetNumThreads(4);
+
+  SVDCompletePolicy complete(true);
+  BOOST_REQUIRE_EQUAL(complete.Parallel(), true);
+  Train(complete);
+
+  SVDIncompletePolicy incomplete(true);
+  BOOST_REQUIRE_EQUAL(incomplete.Parallel(), true);
+  Train(incomplete);
+
+  SetNumThreads(numThreads);
+}
+
 /**
  * Make sure we can train an already-trained model and it works okay for
  * BiasSVD method.
@@ -1228,4 +1431,337 @@ BOOST_AUTO_TEST_CASE(CFPredictRegressionInterpolation)
             RegressionInterpolation>(2.0);
 }
 
+/**
+ * Make sure that the weights of RegressionInterpolation solve the linear
+ * system built from the predicted ratings of the neighbors.
+ */
+BOOST_AUTO_TEST_CASE(RegressionInterpolationWeightsTest)
+{
+  arma::mat dataset;
+  arma::mat savedCols;
+  GetDatasets(dataset, savedCols);
+
+  CFType<RegSVDPolicy> c(dataset, RegSVDPolicy(), 5, 5, 30);
+  const arma::mat& w = c.Decomposition().W();
+  const arma::mat& h = c.Decomposition().H();
+  const arma::sp_mat& cleanedData = c.CleanedData();
+
+  // Find a user with ratings.
+  size_t user = 0;
+  while (cleanedData.col(user).n_nonzero == 0)
+    ++user;
+
+  arma::Col<size_t> neighbors(3);
+  neighbors[0] = user;
+  neighbors[1] = (user + 1) % cleanedData.n_cols;
+  neighbors[2] = (user + 2) % cleanedData.n_cols;
+
+  RegressionInterpolation interpolation(cleanedData);
+  arma::vec weights(3);
+  interpolation.GetWeights(weights, c.Decomposition(), user, neighbors,
+      arma::vec(3), cleanedData);
+
+  // Build the linear system from the predicted ratings.
+  arma::mat predictions(cleanedData.n_rows, 3);
+  for (size_t i = 0; i < 3; ++i)
+    predictions.col(i) = w * h.col(neighbors[i]);
+  const arma::vec rating(cleanedData.col(user));
+  const arma::mat coeff = predictions.t() * predictions / cleanedData.n_rows;
+  const arma::vec constant = predictions.t() * rating /
+      cleanedData.col(user).n_nonzero;
+
+  const arma::vec expected = arma::solve(coeff, constant);
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(weights[i], expected[i], 1e-4);
+}
+
+/**
+ * Make sure that the interpolation weights don't depend on the number of
+ * threads they are computed with.
+ */
+BOOST_AUTO_TEST_CASE(ParallelInterpolationTest)
+{
+  arma::mat dataset;
+  arma::mat savedCols;
+  GetDatasets(dataset, savedCols);
+
+  CFType<RegSVDPolicy> c(dataset, RegSVDPolicy(), 5, 5, 30);
+
+  arma::Mat<size_t> combinations(2, savedCols.n_cols);
+  for (size_t i = 0; i < savedCols.n_cols; ++i)
+  {
+    combinations(0, i) = size_t(savedCols(0, i));
+    combinations(1, i) = size_t(savedCols(1, i));
+  }
+
+  const size_t numThreads = NumThreads();
+  SetNumThreads(1);
+  arma::vec predictions1, predictions2;
+  c.Predict<EuclideanSearch, RegressionInterpolation>(combinations,
+      predictions1);
+  arma::Mat<size_t> recommendations1, recommendations2;
+  c.GetRecommendations<EuclideanSearch, SimilarityInterpolation>(10,
+      recommendations1);
+
+  SetNumThreads(4);
+  c.Predict<EuclideanSearch, RegressionInterpolation>(combinations,
+      predictions2);
+  c.GetRecommendations<EuclideanSearch, SimilarityInterpolation>(10,
+      recommendations2);
+  SetNumThreads(numThreads);
+
+  for (size_t i = 0; i < predictions1.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(predictions1[i], predictions2[i], 1e-8);
+  CheckMatrices(recommendations1, recommendations2);
+}
+
+
+/**
+ * Make sure that the recommendations match the predicted ratings, for policies
+ * with and without biases.
+ */
+BOOST_AUTO_TEST_CASE(RecommendationsMatchPredictionsNMFTest)
+{
+  RecommendationsMatchPredictions<NMFPolicy, OverallMeanNormalization>();
+}
+
+BOOST_AUTO_TEST_CASE(RecommendationsMatchPredictionsBiasSVDTest)
+{
+  RecommendationsMatchPredictions<BiasSVDPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(RecommendationsMatchPredictionsSVDPPTest)
+{
+  RecommendationsMatchPredictions<SVDPlusPlusPolicy>();
+}
+
+/**
+ * Make sure that the batched ratings of a set of users are the same as the
+ * ratings of each user.
+ */
+BOOST_AUTO_TEST_CASE(GetRatingOfUsersTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  SVDPlusPlusPolicy decomposition;
+  CFType<SVDPlusPlusPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  arma::Col<size_t> users("4 0 17 4 101");
+  arma::mat ratings;
+  c.Decomposition().GetRatingOfUsers(users, ratings);
+
+  BOOST_REQUIRE_EQUAL(ratings.n_cols, users.n_elem);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    arma::vec rating;
+    c.Decomposition().GetRatingOfUser(users(i), rating);
+    CheckMatrices(ratings.col(i), rating);
+  }
+}
+
+
+/**
+ * Make sure that MaxInnerProductSearch finds the points with the largest inner
+ * products.
+ */
+BOOST_AUTO_TEST_CASE(MaxInnerProductSearchTest)
+{
+  const arma::mat referenceSet = arma::randn<arma::mat>(5, 200);
+  const arma::mat querySet = arma::randn<arma::mat>(5, 20);
+
+  MaxInnerProductSearch search(referenceSet);
+  arma::Mat<size_t> neighbors;
+  arma::mat products;
+  search.Search(querySet, 10, neighbors, products);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 20);
+
+  const arma::mat naiveProducts = referenceSet.t() * querySet;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    const arma::uvec ordering = arma::sort_index(naiveProducts.col(i),
+        "descend");
+    for (size_t j = 0; j < 10; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors(j, i), ordering(j));
+      BOOST_REQUIRE_CLOSE(products(j, i), naiveProducts(ordering(j), i),
+          1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that the recommendations obtained with an index over the item
+ * vectors are correct, for policies with and without biases.
+ */
+BOOST_AUTO_TEST_CASE(IndexedRecommendationsNMFTest)
+{
+  IndexedRecommendations<NMFPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(IndexedRecommendationsBiasSVDTest)
+{
+  IndexedRecommendations<BiasSVDPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(IndexedRecommendationsSVDPPTest)
+{
+  IndexedRecommendations<SVDPlusPlusPolicy>();
+}
+
+/**
+ * Make sure that an approximate index still gives valid recommendations.
+ */
+BOOST_AUTO_TEST_CASE(ApproximateIndexedRecommendationsTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  NMFPolicy decomposition;
+  CFType<NMFPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  arma::mat items;
+  c.Decomposition().GetItemVectors(items);
+  MaxInnerProductSearch itemSearch(items, 0.5);
+
+  const arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0, 49,
+      50);
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(10, recommendations, users, itemSearch);
+
+  BOOST_REQUIRE_EQUAL(recommendations.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(recommendations.n_cols, 50);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    for (size_t j = 0; j < recommendations.n_rows; ++j)
+    {
+      const size_t item = recommendations(j, i);
+      BOOST_REQUIRE_LT(item, c.CleanedData().n_rows);
+      BOOST_REQUIRE_EQUAL(c.CleanedData()(item, users(i)), 0.0);
+    }
+  }
+}
+
+
+/**
+ * Make sure that FoldIn() matches a naive least squares fit.
+ */
+BOOST_AUTO_TEST_CASE(FoldInNaiveTest)
+{
+  arma::sp_mat ratings;
+  ratings.sprandu(40, 10, 0.3);
+  ratings.col(2).zeros();
+  const arma::mat fixed = arma::randn<arma::mat>(4, 40);
+  const arma::vec offsets = arma::randu<arma::vec>(40);
+
+  arma::mat vectors;
+  FoldIn(ratings, fixed, offsets, 0.1, vectors);
+
+  BOOST_REQUIRE_EQUAL(vectors.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(vectors.n_cols, 10);
+
+  const arma::mat denseRatings(ratings);
+  for (size_t j = 0; j < ratings.n_cols; ++j)
+  {
+    const arma::vec column = denseRatings.col(j);
+    const arma::uvec rows = arma::find(column != 0);
+    if (rows.n_elem == 0)
+    {
+      for (size_t i = 0; i < vectors.n_rows; ++i)
+        BOOST_REQUIRE_SMALL(vectors(i, j), 1e-10);
+      continue;
+    }
+
+    const arma::mat local = fixed.cols(rows);
+    const arma::vec expected = arma::solve(local * local.t() +
+        0.1 * arma::eye<arma::mat>(4, 4),
+        local * (column.elem(rows) - offsets.elem(rows)));
+    CheckMatrices(vectors.col(j), expected, 1e-5);
+  }
+}
+
+/**
+ * Make sure that new users and items can be folded into the model.
+ */
+BOOST_AUTO_TEST_CASE(FoldInNMFTest)
+{
+  FoldIn<NMFPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(FoldInRegSVDTest)
+{
+  FoldIn<RegSVDPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(FoldInBiasSVDTest)
+{
+  FoldIn<BiasSVDPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(FoldInSVDPPTest)
+{
+  FoldIn<SVDPlusPlusPolicy>();
+}
+
+BOOST_AUTO_TEST_CASE(FoldInUserMeanNormalizationTest)
+{
+  FoldIn<RegSVDPolicy, UserMeanNormalization>();
+}
+
+BOOST_AUTO_TEST_CASE(FoldInItemMeanNormalizationTest)
+{
+  FoldIn<RegSVDPolicy, ItemMeanNormalization>();
+}
+
+/**
+ * Make sure that ratings of the wrong size can't be folded in.
+ */
+BOOST_AUTO_TEST_CASE(FoldInInvalidRatingsTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  RegSVDPolicy decomposition;
+  CFType<RegSVDPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  arma::sp_mat users(c.CleanedData().n_rows + 1, 2);
+  arma::sp_mat items(2, c.CleanedData().n_cols + 1);
+  BOOST_REQUIRE_THROW(c.FoldInUsers(users), std::invalid_argument);
+  BOOST_REQUIRE_THROW(c.FoldInItems(items), std::invalid_argument);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that the recommendations are the same with one thread and with
+ * many threads.
+ */
+BOOST_AUTO_TEST_CASE(CFParallelRecommendationsTest)
+{
+  arma::mat dataset;
+  data::Load("GroupLensSmall.csv", dataset);
+
+  NMFPolicy decomposition;
+  CFType<NMFPolicy> c(dataset, decomposition, 5, 5, 30);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  arma::Mat<size_t> serialRecommendations;
+  c.GetRecommendations(10, serialRecommendations);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(10, recommendations);
+
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(recommendations, serialRecommendations);
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
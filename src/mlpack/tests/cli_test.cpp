@@ -611,6 +611,46 @@ BOOST_AUTO_TEST_CASE(InputMatrixParamTest)
     BOOST_REQUIRE_CLOSE(dataset[i], dataset2[i], 1e-10);
 }
 
+/**
+ * Make sure that several input matrices loaded in the background by
+ * ParseCommandLine() are loaded correctly and timed.
+ */
+BOOST_AUTO_TEST_CASE(BackgroundLoadParamTest)
+{
+  AddRequiredCLIOptions();
+
+  PARAM_MATRIX_IN("matrix", "Test matrix", "m");
+  PARAM_TMATRIX_IN("tmatrix", "Test non-transposed matrix", "n");
+
+  const char* argv[5];
+  argv[0] = "./test";
+  argv[1] = "-m";
+  argv[2] = "test_data_3_1000.csv";
+  argv[3] = "-n";
+  argv[4] = "test_data_3_1000.csv";
+
+  int argc = 5;
+
+  Timer::EnableTiming();
+  ParseCommandLine(argc, const_cast<char**>(argv));
+
+  arma::mat dataset = CLI::GetParam<arma::mat>("matrix");
+  arma::mat tdataset = CLI::GetParam<arma::mat>("tmatrix");
+  Timer::DisableTiming();
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, 1000);
+  BOOST_REQUIRE_EQUAL(tdataset.n_rows, 1000);
+  BOOST_REQUIRE_EQUAL(tdataset.n_cols, 3);
+
+  for (size_t i = 0; i < dataset.n_rows; ++i)
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+      BOOST_REQUIRE_CLOSE(dataset(i, j), tdataset(j, i), 1e-10);
+
+  BOOST_REQUIRE_GT(Timer::Get("loading_matrix").count(), 0);
+  BOOST_REQUIRE_GT(Timer::Get("loading_tmatrix").count(), 0);
+}
+
 BOOST_AUTO_TEST_CASE(InputMatrixNoTransposeParamTest)
 {
   AddRequiredCLIOptions();
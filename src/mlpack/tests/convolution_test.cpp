@@ -16,6 +16,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -149,6 +150,10 @@ BOOST_AUTO_TEST_CASE(ValidConvolution2DTest)
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<ValidConvolution> >(input, filter,
       output);
+
+  // Perform the convolution by lowering the input to a matrix.
+  Convolution2DMethodTest<Im2ColConvolution<ValidConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -186,6 +191,10 @@ BOOST_AUTO_TEST_CASE(FullConvolution2DTest)
   // speed up the computation.
   Convolution2DMethodTest<SVDConvolution<FullConvolution> >(input, filter,
       output);
+
+  // Perform the convolution by lowering the input to a matrix.
+  Convolution2DMethodTest<Im2ColConvolution<FullConvolution> >(input, filter,
+      output);
 }
 
 /**
@@ -370,4 +379,61 @@ BOOST_AUTO_TEST_CASE(FullConvolutionBatchTest)
       filterCube, outputCube);
 }
 
+/**
+ * Make sure that the im2col convolution gives the same results as the naive
+ * convolution on random data, with and without strides.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColNaiveConvolutionTest)
+{
+  arma::mat input = arma::randu<arma::mat>(11, 9);
+  arma::mat filter = arma::randu<arma::mat>(3, 4);
+
+  for (size_t stride = 1; stride <= 2; ++stride)
+  {
+    arma::mat naiveOutput, im2colOutput;
+    NaiveConvolution<ValidConvolution>::Convolution(input, filter,
+        naiveOutput, stride, stride);
+    Im2ColConvolution<ValidConvolution>::Convolution(input, filter,
+        im2colOutput, stride, stride);
+    CheckMatrices(naiveOutput, im2colOutput, 1e-5);
+
+    NaiveConvolution<FullConvolution>::Convolution(input, filter,
+        naiveOutput, stride, stride);
+    Im2ColConvolution<FullConvolution>::Convolution(input, filter,
+        im2colOutput, stride, stride);
+    CheckMatrices(naiveOutput, im2colOutput, 1e-5);
+  }
+}
+
+/**
+ * Make sure that Col2Im() is the adjoint of Im2Col(): for any input x and any
+ * matrix y, <Im2Col(x), y> = <x, Col2Im(y)>.
+ */
+BOOST_AUTO_TEST_CASE(Im2ColAdjointTest)
+{
+  arma::cube input = arma::randu<arma::cube>(7, 6, 3);
+
+  // Use a 3x2 kernel with stride 2x1, padding 1x2, and dilation 2x1 on the
+  // last two slices.
+  const size_t outputWidth = (7 + 2 * 1 - 2 * (3 - 1) - 1) / 2 + 1;
+  const size_t outputHeight = (6 + 2 * 2 - 1 * (2 - 1) - 1) / 1 + 1;
+
+  arma::mat columns;
+  Im2ColConvolution<ValidConvolution>::Im2Col(input, 1, 2, 3, 2, 2, 1, 1, 2,
+      2, 1, outputWidth, outputHeight, columns);
+  BOOST_REQUIRE_EQUAL(columns.n_rows, outputWidth * outputHeight);
+  BOOST_REQUIRE_EQUAL(columns.n_cols, 3 * 2 * 2);
+
+  arma::mat y = arma::randu<arma::mat>(columns.n_rows, columns.n_cols);
+  arma::cube result(input.n_rows, input.n_cols, input.n_slices,
+      arma::fill::zeros);
+  Im2ColConvolution<ValidConvolution>::Col2Im(y, 1, 2, 3, 2, 2, 1, 1, 2, 2,
+      1, outputWidth, outputHeight, result);
+
+  // The first slice is not used.
+  BOOST_REQUIRE_SMALL(arma::accu(arma::abs(result.slice(0))), 1e-10);
+  BOOST_REQUIRE_CLOSE(arma::accu(columns % y), arma::accu(input % result),
+      1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
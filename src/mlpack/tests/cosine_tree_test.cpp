@@ -222,4 +222,69 @@ BOOST_AUTO_TEST_CASE(CosineTreeModifiedGramSchmidt)
   }
 }
 
+/**
+ * Make sure that the orthonormalization and the Monte Carlo error estimate
+ * with the basis given as a matrix are the same as with the basis given as a
+ * priority queue.
+ */
+BOOST_AUTO_TEST_CASE(CosineTreeBasisMatrixTest)
+{
+  const size_t numRows = 30;
+  const size_t numCols = 40;
+  const size_t numBasis = 10;
+
+  arma::mat data = arma::randu(numRows, numCols);
+
+  CosineNodeQueue basisQueue;
+  CosineTree dummyTree(data, 1, 0.1);
+
+  // Build an orthonormal basis, stored both in a queue and in a matrix.
+  arma::mat q, r;
+  arma::qr_econ(q, r, arma::randu(numRows, numBasis));
+  for (size_t i = 0; i < numBasis; i++)
+  {
+    CosineTree* basisNode = new CosineTree(data);
+    arma::vec basisVector = q.col(i);
+    basisNode->BasisVector(basisVector);
+    basisNode->L2Error(arma::randu());
+    basisQueue.push(basisNode);
+  }
+
+  arma::mat basis(numRows, numBasis);
+  CosineNodeQueue::const_iterator j = basisQueue.begin();
+  for (size_t i = 0; j != basisQueue.end(); j++, i++)
+    basis.col(i) = (*j)->BasisVector();
+
+  arma::vec centroid1 = data.col(0);
+  arma::vec centroid2 = data.col(1);
+  arma::vec queueVector1, queueVector2, matrixVector1, matrixVector2;
+  dummyTree.ModifiedGramSchmidt(basisQueue, centroid1, queueVector1);
+  dummyTree.ModifiedGramSchmidt(basisQueue, centroid2, queueVector2,
+      &queueVector1);
+  dummyTree.ModifiedGramSchmidt(basis, centroid1, matrixVector1);
+  dummyTree.ModifiedGramSchmidt(basis, centroid2, matrixVector2,
+      &matrixVector1);
+
+  CheckMatrices(queueVector1, matrixVector1, 1e-5);
+  CheckMatrices(queueVector2, matrixVector2, 1e-5);
+
+  // The same columns are sampled when the random seed is the same.
+  CosineTree node(data);
+  math::RandomSeed(42);
+  const double queueError = dummyTree.MonteCarloError(&node, basisQueue,
+      &queueVector1, &queueVector2);
+  math::RandomSeed(42);
+  const double matrixError = dummyTree.MonteCarloError(&node, basis,
+      &matrixVector1, &matrixVector2);
+
+  BOOST_REQUIRE_CLOSE(queueError, matrixError, 1e-5);
+
+  while (!basisQueue.empty())
+  {
+    CosineTree* currentNode = basisQueue.top();
+    basisQueue.pop();
+    delete currentNode;
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
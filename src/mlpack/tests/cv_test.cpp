@@ -416,6 +416,30 @@ BOOST_AUTO_TEST_CASE(KFoldCVMSETest)
   cv.Model();
 }
 
+/**
+ * Test k-fold cross-validation stops after half of the folds when they are
+ * worse than the threshold.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVStopThresholdTest)
+{
+  arma::mat data("0 1  0 1");
+  arma::rowvec responses("0 1  1 3");
+
+  KFoldCV<LinearRegression, MSE> cv(2, data, responses, false);
+  cv.StopThreshold() = 0.0;
+
+  // Only the first fold is evaluated, so no model is kept.
+  double expectedMSE =
+      double((1 - 0) * (1 - 0) + (3 - 1) * (3 - 1)) / 2 * 2 / 2;
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), expectedMSE, 1e-5);
+  BOOST_REQUIRE_THROW(cv.Model(), std::logic_error);
+
+  // With a higher threshold every fold is evaluated.
+  cv.StopThreshold() = expectedMSE + 1.0;
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(), expectedMSE, 1e-5);
+  cv.Model();
+}
+
 /**
  * Test k-fold cross-validation with the Accuracy metric.
  */
@@ -676,4 +700,77 @@ BOOST_AUTO_TEST_CASE(KFoldCVWithDTTestUnevenBinsWeighted)
   BOOST_REQUIRE_GT(accuracy, 0.7);
 }
 
+/**
+ * Test that k-fold cross-validation gives the same results when the folds are
+ * run at the same time, with uneven bins and with weights.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVConcurrentFoldsTest)
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  data::DatasetInfo datasetInfo;
+  MockCategoricalData(data, labels, datasetInfo);
+  arma::rowvec weights(data.n_cols, arma::fill::randu);
+
+  size_t numClasses = 5;
+  size_t minimumLeafSize = 5;
+
+  KFoldCV<DecisionTree<InformationGain>, Accuracy> cv(7, data, datasetInfo,
+      labels, numClasses, weights, false);
+  const double serialAccuracy = cv.Evaluate(minimumLeafSize);
+  const size_t serialChildren = cv.Model().NumChildren();
+
+  // Decision trees are deterministic, so the folds give the same models
+  // whether they are run one after another or at the same time.
+  for (const size_t maxConcurrentFolds : { 0, 3 })
+  {
+    cv.MaxConcurrentFolds() = maxConcurrentFolds;
+    BOOST_REQUIRE_CLOSE(cv.Evaluate(minimumLeafSize), serialAccuracy, 1e-5);
+    BOOST_REQUIRE_EQUAL(cv.Model().NumChildren(), serialChildren);
+  }
+
+  // The data is left in its original order.
+  cv.MaxConcurrentFolds() = 1;
+  BOOST_REQUIRE_CLOSE(cv.Evaluate(minimumLeafSize), serialAccuracy, 1e-5);
+
+  // Unweighted learning, too.
+  KFoldCV<DecisionTree<InformationGain>, Accuracy> unweightedCV(7, data,
+      datasetInfo, labels, numClasses, false);
+  const double unweightedAccuracy = unweightedCV.Evaluate(minimumLeafSize);
+  unweightedCV.MaxConcurrentFolds() = 0;
+  BOOST_REQUIRE_CLOSE(unweightedCV.Evaluate(minimumLeafSize),
+      unweightedAccuracy, 1e-5);
+}
+
+/**
+ * Test that warm-started k-fold cross-validation along a regularization path
+ * gives the same models as training every fold from scratch.
+ */
+BOOST_AUTO_TEST_CASE(KFoldCVWarmStartTest)
+{
+  arma::mat data = arma::join_rows(arma::randn<arma::mat>(3, 100),
+      arma::randn<arma::mat>(3, 100) + 1.5);
+  arma::Row<size_t> labels = arma::join_rows(arma::zeros<arma::Row<size_t>>(
+      100), arma::ones<arma::Row<size_t>>(100));
+
+  // No shuffling, so that both objects see the same folds.
+  KFoldCV<LogisticRegression<>, Accuracy> coldCV(5, data, labels, false);
+  KFoldCV<LogisticRegression<>, Accuracy> warmCV(5, data, labels, false);
+  warmCV.WarmStart() = true;
+
+  for (const double lambda : { 1.0, 0.5, 0.2, 0.1 })
+  {
+    const double accuracy = coldCV.Evaluate(lambda);
+    BOOST_REQUIRE_CLOSE(warmCV.Evaluate(lambda), accuracy, 1e-5);
+
+    const arma::rowvec& coldParameters = coldCV.Model().Parameters();
+    const arma::rowvec& warmParameters = warmCV.Model().Parameters();
+    BOOST_REQUIRE_EQUAL(warmParameters.n_elem, coldParameters.n_elem);
+    for (size_t i = 0; i < coldParameters.n_elem; ++i)
+      BOOST_REQUIRE_SMALL(warmParameters[i] - coldParameters[i], 1e-3);
+
+    BOOST_REQUIRE_CLOSE(warmCV.Model().Lambda(), lambda, 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,169 @@
+/**
+ * @file dataset_statistics_test.cpp
+ *
+ * Tests for the one-pass descriptive statistics: RunningMoments,
+ * QuantileSketch and DatasetStatistics.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/data/dataset_statistics.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::data;
+
+BOOST_AUTO_TEST_SUITE(DatasetStatisticsTest);
+
+/**
+ * Make sure the moments of values added one at a time match the statistics
+ * computed from all the values at once, even with a large offset.
+ */
+BOOST_AUTO_TEST_CASE(RunningMomentsTest)
+{
+  arma::rowvec x = arma::square(arma::randn<arma::rowvec>(10000)) + 1e6;
+
+  RunningMoments moments;
+  for (size_t i = 0; i < x.n_elem; ++i)
+    moments.Add(x[i]);
+
+  const double n = x.n_elem;
+  const double mean = arma::mean(x);
+  const arma::rowvec deviations = x - mean;
+  const double m2 = arma::accu(arma::pow(deviations, 2));
+  const double m3 = arma::accu(arma::pow(deviations, 3));
+  const double m4 = arma::accu(arma::pow(deviations, 4));
+
+  BOOST_REQUIRE_EQUAL(moments.Count(), x.n_elem);
+  BOOST_REQUIRE_CLOSE(moments.Mean(), mean, 1e-8);
+  BOOST_REQUIRE_CLOSE(moments.Min(), x.min(), 1e-8);
+  BOOST_REQUIRE_CLOSE(moments.Max(), x.max(), 1e-8);
+  BOOST_REQUIRE_CLOSE(moments.Variance(), arma::var(x), 1e-6);
+  BOOST_REQUIRE_CLOSE(moments.Variance(true), arma::var(x, 1), 1e-6);
+  BOOST_REQUIRE_CLOSE(moments.Skewness(true),
+      m3 / (n * std::pow(m2 / n, 1.5)), 1e-5);
+  BOOST_REQUIRE_CLOSE(moments.Kurtosis(true), n * m4 / (m2 * m2) - 3, 1e-5);
+}
+
+/**
+ * Make sure merging the moments of two parts of the data gives the moments of
+ * the whole data.
+ */
+BOOST_AUTO_TEST_CASE(RunningMomentsMergeTest)
+{
+  arma::rowvec x = arma::randu<arma::rowvec>(5000);
+  x.subvec(0, 999) += 10.0;
+
+  RunningMoments all, first, second;
+  for (size_t i = 0; i < x.n_elem; ++i)
+  {
+    all.Add(x[i]);
+    if (i < 1000)
+      first.Add(x[i]);
+    else
+      second.Add(x[i]);
+  }
+  first.Merge(second);
+
+  BOOST_REQUIRE_EQUAL(first.Count(), all.Count());
+  BOOST_REQUIRE_CLOSE(first.Mean(), all.Mean(), 1e-8);
+  BOOST_REQUIRE_CLOSE(first.Variance(), all.Variance(), 1e-8);
+  BOOST_REQUIRE_CLOSE(first.Skewness(), all.Skewness(), 1e-6);
+  BOOST_REQUIRE_CLOSE(first.Kurtosis(), all.Kurtosis(), 1e-6);
+  BOOST_REQUIRE_EQUAL(first.Min(), all.Min());
+  BOOST_REQUIRE_EQUAL(first.Max(), all.Max());
+
+  // Merging empty moments changes nothing.
+  RunningMoments empty;
+  first.Merge(empty);
+  BOOST_REQUIRE_EQUAL(first.Count(), all.Count());
+  empty.Merge(first);
+  BOOST_REQUIRE_CLOSE(empty.Mean(), all.Mean(), 1e-8);
+}
+
+/**
+ * Make sure the quantiles estimated by a sketch, merged or not, have about the
+ * right rank, and that the sketch stays small.
+ */
+BOOST_AUTO_TEST_CASE(QuantileSketchTest)
+{
+  arma::vec x = arma::randn<arma::vec>(100000);
+  const arma::vec sorted = arma::sort(x);
+
+  QuantileSketch sketch, first, second;
+  for (size_t i = 0; i < x.n_elem; ++i)
+  {
+    sketch.Add(x[i]);
+    if (i % 3 == 0)
+      first.Add(x[i]);
+    else
+      second.Add(x[i]);
+  }
+  first.Merge(second);
+
+  BOOST_REQUIRE_EQUAL(sketch.Count(), x.n_elem);
+  BOOST_REQUIRE_EQUAL(first.Count(), x.n_elem);
+  BOOST_REQUIRE_LT(sketch.Size(), 1000);
+  BOOST_REQUIRE_LT(first.Size(), 1000);
+
+  const double quantiles[] = { 0.01, 0.25, 0.5, 0.75, 0.99 };
+  for (size_t i = 0; i < 5; ++i)
+  {
+    const double estimates[] = { sketch.Quantile(quantiles[i]),
+                                 first.Quantile(quantiles[i]) };
+    for (size_t j = 0; j < 2; ++j)
+    {
+      const double rank = (std::lower_bound(sorted.begin(), sorted.end(),
+          estimates[j]) - sorted.begin()) / (double) x.n_elem;
+      BOOST_REQUIRE_SMALL(rank - quantiles[i], 0.03);
+    }
+  }
+
+  BOOST_REQUIRE_THROW(sketch.Quantile(1.5), std::invalid_argument);
+  BOOST_REQUIRE(std::isnan(QuantileSketch().Quantile(0.5)));
+}
+
+/**
+ * Make sure the statistics of a dataset added in chunks match the statistics
+ * of each dimension.
+ */
+BOOST_AUTO_TEST_CASE(DatasetStatisticsChunksTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 20000);
+  data.row(1) *= 100.0;
+  data.row(2) = arma::square(data.row(2));
+
+  DatasetStatistics statistics(4);
+  for (size_t begin = 0; begin < data.n_cols; begin += 7000)
+  {
+    const size_t end = std::min(begin + 7000, (size_t) data.n_cols) - 1;
+    statistics.Add(data.cols(begin, end));
+  }
+
+  BOOST_REQUIRE_EQUAL(statistics.Count(), data.n_cols);
+  BOOST_REQUIRE_EQUAL(statistics.Dimensionality(), 4);
+  for (size_t d = 0; d < 4; ++d)
+  {
+    const arma::rowvec feature = data.row(d);
+    const RunningMoments& moments = statistics.Moments(d);
+    BOOST_REQUIRE_EQUAL(moments.Count(), data.n_cols);
+    BOOST_REQUIRE_CLOSE(moments.Mean(), arma::mean(feature), 1e-8);
+    BOOST_REQUIRE_CLOSE(moments.Variance(), arma::var(feature), 1e-6);
+    BOOST_REQUIRE_EQUAL(moments.Min(), feature.min());
+    BOOST_REQUIRE_EQUAL(moments.Max(), feature.max());
+
+    const double median = statistics.Quantiles(d).Quantile(0.5);
+    const double rank = arma::accu(feature < median) / (double) data.n_cols;
+    BOOST_REQUIRE_SMALL(rank - 0.5, 0.03);
+  }
+
+  arma::mat wrongDimensions(3, 10);
+  BOOST_REQUIRE_THROW(statistics.Add(wrongDimensions), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -309,4 +309,71 @@ BOOST_AUTO_TEST_CASE(RandomPointSelectionTest)
   BOOST_REQUIRE_EQUAL(assignments.n_elem, points.n_cols);
 }
 
+/**
+ * Make sure that DBSCAN with an epsilon-grid gives the same clusters as DBSCAN
+ * with a tree, in batch mode and in single mode.
+ */
+BOOST_AUTO_TEST_CASE(GridDBSCANTest)
+{
+  arma::mat points(2, 1000, arma::fill::randu);
+  const double epsilon = 0.03;
+
+  DBSCAN<> d(epsilon, 3);
+  arma::Row<size_t> assignments;
+  const size_t clusters = d.Cluster(points, assignments);
+
+  for (size_t batch = 0; batch < 2; ++batch)
+  {
+    DBSCAN<GridRangeSearch<>> gridD(epsilon, 3, batch == 1,
+        GridRangeSearch<>(epsilon));
+    arma::Row<size_t> gridAssignments;
+    const size_t gridClusters = gridD.Cluster(points, gridAssignments);
+
+    BOOST_REQUIRE_EQUAL(gridClusters, clusters);
+    BOOST_REQUIRE_EQUAL(gridAssignments.n_elem, assignments.n_elem);
+    for (size_t i = 0; i < assignments.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(gridAssignments[i], assignments[i]);
+  }
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that the clusters found with several threads are the same as with
+ * one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDBSCANTest)
+{
+  arma::mat points(3, 2000, arma::fill::randu);
+  const double epsilon = 0.08;
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  DBSCAN<> serialD(epsilon, 4);
+  arma::Row<size_t> serialAssignments;
+  const size_t serialClusters = serialD.Cluster(points, serialAssignments);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  DBSCAN<> d(epsilon, 4);
+  arma::Row<size_t> assignments;
+  const size_t clusters = d.Cluster(points, assignments);
+
+  DBSCAN<GridRangeSearch<>> gridD(epsilon, 4, true,
+      GridRangeSearch<>(epsilon));
+  arma::Row<size_t> gridAssignments;
+  const size_t gridClusters = gridD.Cluster(points, gridAssignments);
+
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_EQUAL(clusters, serialClusters);
+  BOOST_REQUIRE_EQUAL(gridClusters, serialClusters);
+  for (size_t i = 0; i < serialAssignments.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(assignments[i], serialAssignments[i]);
+    BOOST_REQUIRE_EQUAL(gridAssignments[i], serialAssignments[i]);
+  }
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
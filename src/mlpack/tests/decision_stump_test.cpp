@@ -391,4 +391,41 @@ BOOST_AUTO_TEST_CASE(IntTest)
   BOOST_CHECK_EQUAL(predictedLabels(0, 7), 2);
 }
 
+/**
+ * Make sure that a stump built from another stump that was trained on the same
+ * data (which reuses its sort order) is the same as a stump trained from
+ * scratch, and that the sort order is not reused for other data.
+ */
+BOOST_AUTO_TEST_CASE(ReuseSortOrderTest)
+{
+  mat data = randu<mat>(5, 300);
+  Row<size_t> labels(300);
+  for (size_t i = 0; i < 300; ++i)
+    labels[i] = (data(2, i) > 0.4) ? ((data(4, i) > 0.7) ? 2 : 1) : 0;
+  rowvec weights = randu<rowvec>(300);
+
+  DecisionStump<> ds(data, labels, 3, 5);
+
+  // Compare the stump built from ds with a stump trained from scratch, for
+  // the original data and for other data.
+  mat otherData = randu<mat>(5, 300);
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    const mat& trainData = (trial == 0) ? data : otherData;
+
+    DecisionStump<> reused(ds, trainData, labels, 3, weights);
+    DecisionStump<> scratch;
+    scratch.Train(trainData, labels, weights, 3, 5);
+
+    BOOST_REQUIRE_EQUAL(reused.SplitDimension(), scratch.SplitDimension());
+    BOOST_REQUIRE_EQUAL(reused.Split().n_elem, scratch.Split().n_elem);
+    BOOST_REQUIRE_EQUAL(reused.BinLabels().n_elem, scratch.BinLabels().n_elem);
+    for (size_t i = 0; i < scratch.Split().n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(reused.Split()[i], scratch.Split()[i]);
+      BOOST_REQUIRE_EQUAL(reused.BinLabels()[i], scratch.BinLabels()[i]);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -367,6 +367,163 @@ BOOST_AUTO_TEST_CASE(BestBinaryNumericSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * Make sure that EvaluatePtr() gives the same gain as Evaluate() for both
+ * fitness functions.
+ */
+BOOST_AUTO_TEST_CASE(EvaluatePtrTest)
+{
+  arma::Row<size_t> labels("0 1 1 2 2 2 0 1 2 2");
+  arma::rowvec weights("0.5 1.0 2.0 0.1 0.3 1.5 2.5 0.7 0.2 1.0");
+
+  arma::vec counts(3, arma::fill::zeros);
+  arma::vec weightCounts(3, arma::fill::zeros);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    counts[labels[i]] += 1.0;
+    weightCounts[labels[i]] += weights[i];
+  }
+
+  BOOST_REQUIRE_CLOSE(GiniGain::EvaluatePtr<false>(counts.memptr(), 3,
+      (double) labels.n_elem), GiniGain::Evaluate<false>(labels, 3, weights),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(GiniGain::EvaluatePtr<true>(weightCounts.memptr(), 3,
+      arma::accu(weights)), GiniGain::Evaluate<true>(labels, 3, weights),
+      1e-5);
+  BOOST_REQUIRE_CLOSE(InformationGain::EvaluatePtr<false>(counts.memptr(), 3,
+      (double) labels.n_elem), InformationGain::Evaluate<false>(labels, 3,
+      weights), 1e-5);
+  BOOST_REQUIRE_CLOSE(InformationGain::EvaluatePtr<true>(
+      weightCounts.memptr(), 3, arma::accu(weights)),
+      InformationGain::Evaluate<true>(labels, 3, weights), 1e-5);
+
+  // Empty sets have zero gain.
+  BOOST_REQUIRE_SMALL(GiniGain::EvaluatePtr<false>(counts.memptr(), 3, 0.0),
+      1e-10);
+  BOOST_REQUIRE_SMALL(InformationGain::EvaluatePtr<false>(counts.memptr(), 3,
+      0.0), 1e-10);
+}
+
+/**
+ * Check that the HistogramNumericSplit will split on an obviously splittable
+ * dimension.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitSimpleSplitTest)
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // Make sure that a split was made, and that the weighted split is the same.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_CLOSE(gain, weightedGain, 1e-5);
+
+  // The split is perfect, so we should be able to accomplish a gain of 0.
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+
+  // The splitting point should be between 4 and 5.
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 1);
+  BOOST_REQUIRE_GT(classProbabilities[0], 0.4);
+  BOOST_REQUIRE_LT(classProbabilities[0], 0.5);
+}
+
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when there are fewer distinct values than bins.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitMatchesBestTest)
+{
+  arma::vec values(1000);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    values[i] = math::RandInt(50);
+    // Noisy labels that mostly depend on the value.
+    labels[i] = (values[i] + math::RandInt(20) > 35) ? 1 : 0;
+  }
+  arma::rowvec weights;
+
+  arma::vec bestProbabilities, histogramProbabilities;
+  BestBinaryNumericSplit<InformationGain>::template
+      AuxiliarySplitInfo<double> bestAux;
+  HistogramNumericSplit<InformationGain>::template
+      AuxiliarySplitInfo<double> histogramAux;
+
+  const double bestGain = InformationGain::Evaluate<false>(labels, 2,
+      weights);
+  const double best =
+      BestBinaryNumericSplit<InformationGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 5, 1e-7, bestProbabilities, bestAux);
+  const double histogram =
+      HistogramNumericSplit<InformationGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 5, 1e-7, histogramProbabilities,
+      histogramAux);
+
+  BOOST_REQUIRE_GT(best, bestGain);
+  BOOST_REQUIRE_CLOSE(histogram, best, 1e-5);
+  BOOST_REQUIRE_EQUAL(histogramProbabilities.n_elem, 1);
+  BOOST_REQUIRE_CLOSE(histogramProbabilities[0], bestProbabilities[0], 1e-5);
+}
+
+/**
+ * Check that the HistogramNumericSplit won't split if not enough points are
+ * given, or if the dimension gives no gain.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitNoSplitTest)
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem, arma::fill::ones);
+
+  arma::vec classProbabilities;
+  HistogramNumericSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 8, 1e-7, classProbabilities, aux);
+
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+
+  // Now, a dimension where every value has both labels.
+  values.set_size(100);
+  labels.set_size(100);
+  for (size_t i = 0; i < 100; i += 2)
+  {
+    values[i] = i;
+    labels[i] = 0;
+    values[i + 1] = i;
+    labels[i + 1] = 1;
+  }
+
+  bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 10, 1e-7, classProbabilities, aux);
+
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+
+  // A constant dimension can't be split either.
+  values.fill(3.0);
+  gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 10, 1e-7, classProbabilities, aux);
+
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -465,6 +622,91 @@ BOOST_AUTO_TEST_CASE(AllCategoricalSplitNoGainTest)
   BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
 }
 
+/**
+ * Check that the BinaryCategoricalSplit finds the perfect binary partition of
+ * many categories, where the categories of each class are interleaved.
+ */
+BOOST_AUTO_TEST_CASE(BinaryCategoricalSplitSimpleSplitTest)
+{
+  arma::vec values(200);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+  {
+    values[i] = i % 20;
+    labels[i] = (i % 20) % 2;
+  }
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  BinaryCategoricalSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BinaryCategoricalSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, 20, labels, 2, weights, 3, 1e-7, classProbabilities,
+      aux);
+  const double weightedGain =
+      BinaryCategoricalSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      20, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // Make sure that a split was made, and that the weighted split is the same.
+  BOOST_REQUIRE_GT(gain, bestGain);
+  BOOST_REQUIRE_CLOSE(gain, weightedGain, 1e-5);
+
+  // The split is perfect, so we should be able to accomplish a gain of 0.
+  BOOST_REQUIRE_SMALL(gain, 1e-5);
+
+  // The split has two children, and the even and odd categories go to
+  // different children.
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 20);
+  BOOST_REQUIRE_EQUAL(BinaryCategoricalSplit<GiniGain>::NumChildren(
+      classProbabilities, aux), 2);
+  const size_t evenDirection = BinaryCategoricalSplit<GiniGain>::
+      CalculateDirection(0.0, classProbabilities, aux);
+  for (size_t c = 0; c < 20; ++c)
+  {
+    const size_t direction = BinaryCategoricalSplit<GiniGain>::
+        CalculateDirection(double(c), classProbabilities, aux);
+    if (c % 2 == 0)
+      BOOST_REQUIRE_EQUAL(direction, evenDirection);
+    else
+      BOOST_REQUIRE_NE(direction, evenDirection);
+  }
+}
+
+/**
+ * Make sure that BinaryCategoricalSplit respects the minimum number of samples
+ * required to split, and does not split a single category.
+ */
+BOOST_AUTO_TEST_CASE(BinaryCategoricalSplitMinSamplesTest)
+{
+  arma::vec values("0 0 0 1 1 1 2 2 2 2 2 2");
+  arma::Row<size_t> labels("0 0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  BinaryCategoricalSplit<GiniGain>::template AuxiliarySplitInfo<double> aux;
+
+  // The only good split puts 6 points in each child.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  double gain = BinaryCategoricalSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, 3, labels, 2, weights, 7, 1e-7, classProbabilities,
+      aux);
+
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+
+  // A dimension with only one category can't be split.
+  values.fill(1);
+  gain = BinaryCategoricalSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      values, 3, labels, 2, weights, 1, 1e-7, classProbabilities, aux);
+
+  BOOST_REQUIRE_EQUAL(gain, bestGain);
+  BOOST_REQUIRE_EQUAL(classProbabilities.n_elem, 0);
+}
+
 /**
  * A basic construction of the decision tree---ensure that we can create the
  * tree and that it split at least once.
@@ -664,6 +906,48 @@ BOOST_AUTO_TEST_CASE(SimpleGeneralizationTest)
   BOOST_REQUIRE_GT(wdcorrect, 0.75);
 }
 
+/**
+ * Test that a decision tree built with the HistogramNumericSplit generalizes
+ * reasonably.
+ */
+BOOST_AUTO_TEST_CASE(HistogramNumericSplitGeneralizationTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    BOOST_FAIL("Cannot load labels for vc2_labels.txt");
+
+  // Build decision tree.
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+
+  // Load testing data.
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    BOOST_FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    BOOST_FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  // Get the predicted test labels.
+  arma::Row<size_t> predictions;
+  d.Classify(testData, predictions);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+
+  // Figure out the accuracy.
+  double correct = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+  correct /= predictions.n_elem;
+
+  BOOST_REQUIRE_GT(correct, 0.75);
+}
+
 /**
  * Test that we can build a decision tree on a simple categorical dataset.
  */
@@ -736,6 +1020,56 @@ BOOST_AUTO_TEST_CASE(CategoricalBuildTestWithWeight)
   BOOST_REQUIRE_GT(correctPct, 0.70);
 }
 
+/**
+ * Test that we can build a decision tree with binary categorical splits on a
+ * simple categorical dataset.
+ */
+BOOST_AUTO_TEST_CASE(BinaryCategoricalBuildTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  // Split into a training set and a test set.
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+  arma::Row<size_t> testLabels = l.subvec(2000, 3999);
+
+  // Build the tree.
+  DecisionTree<GiniGain, BestBinaryNumericSplit, BinaryCategoricalSplit>
+      tree(trainingData, di, trainingLabels, 5, 10);
+
+  // Every split is binary.
+  typedef DecisionTree<GiniGain, BestBinaryNumericSplit,
+      BinaryCategoricalSplit> TreeType;
+  std::vector<const TreeType*> nodes(1, &tree);
+  while (!nodes.empty())
+  {
+    const TreeType* node = nodes.back();
+    nodes.pop_back();
+
+    BOOST_REQUIRE(node->NumChildren() == 0 || node->NumChildren() == 2);
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      nodes.push_back(&node->Child(i));
+  }
+
+  // Now evaluate the accuracy of the tree.
+  arma::Row<size_t> predictions;
+  tree.Classify(testData, predictions);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, testData.n_cols);
+  size_t correct = 0;
+  for (size_t i = 0; i < testData.n_cols; ++i)
+    if (testLabels[i] == predictions[i])
+      ++correct;
+
+  // Make sure we got at least 70% accuracy.
+  const double correctPct = double(correct) / double(testData.n_cols);
+  BOOST_REQUIRE_GT(correctPct, 0.70);
+}
+
 /**
  * Make sure that when we ask for a decision stump, we get one.
  */
@@ -1126,4 +1460,54 @@ BOOST_AUTO_TEST_CASE(RegularisedDecisionTree)
   BOOST_REQUIRE_GT(count, 0);
 }
 
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that a decision tree built in parallel, on a dataset large enough
+ * for the parallel build to be used, is the same as with one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDecisionTreeTest)
+{
+  arma::mat dataset(5, 25000, arma::fill::randu);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = (dataset(1, i) > 0.3 ? 1 : 0) + (dataset(3, i) > 0.6 ? 1 : 0);
+    // Add some noise so that the tree is not trivial.
+    if (math::RandInt(10) == 0)
+      labels[i] = math::RandInt(3);
+  }
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  DecisionTree<> serialTree(dataset, labels, 3, 5);
+  arma::Row<size_t> serialPredictions;
+  arma::mat serialProbabilities;
+  serialTree.Classify(dataset, serialPredictions, serialProbabilities);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  DecisionTree<> tree(dataset, labels, 3, 5);
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  tree.Classify(dataset, predictions, probabilities);
+
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_EQUAL(tree.NumChildren(), serialTree.NumChildren());
+  BOOST_REQUIRE_EQUAL(tree.SplitDimension(), serialTree.SplitDimension());
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(predictions[i], serialPredictions[i]);
+    for (size_t c = 0; c < 3; ++c)
+    {
+      BOOST_REQUIRE_SMALL(probabilities(c, i) - serialProbabilities(c, i),
+          1e-10);
+    }
+  }
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -778,4 +778,92 @@ BOOST_AUTO_TEST_CASE(MoveOperatorTest)
   BOOST_REQUIRE_CLOSE(testDTree2.Right()->SplitValue(), 0.5, 1e-5);
 }
 
+/**
+ * Make sure that two trees have the same structure and the same splits.
+ */
+template<typename TreeType1, typename TreeType2>
+void CheckSameTree(const TreeType1& tree1, const TreeType2& tree2)
+{
+  BOOST_REQUIRE_EQUAL(tree1.NumChildren(), tree2.NumChildren());
+  BOOST_REQUIRE_EQUAL(tree1.Start(), tree2.Start());
+  BOOST_REQUIRE_EQUAL(tree1.End(), tree2.End());
+  BOOST_REQUIRE_EQUAL(tree1.SubtreeLeaves(), tree2.SubtreeLeaves());
+  BOOST_REQUIRE_CLOSE(tree1.LogNegError(), tree2.LogNegError(), 1e-10);
+
+  if (tree1.NumChildren() == 0)
+    return;
+
+  BOOST_REQUIRE_EQUAL(tree1.SplitDim(), tree2.SplitDim());
+  BOOST_REQUIRE_CLOSE(tree1.SplitValue(), tree2.SplitValue(), 1e-10);
+
+  CheckSameTree(tree1.Child(0), tree2.Child(0));
+  CheckSameTree(tree1.Child(1), tree2.Child(1));
+}
+
+/**
+ * Growing a tree on a dense matrix, which uses the presorted values of the
+ * points, should give the same tree as growing it on the same sparse matrix,
+ * which sorts the values of each node.
+ */
+BOOST_AUTO_TEST_CASE(PresortedGrowTest)
+{
+  // Round the values, so that there are many ties.
+  arma::mat data = arma::round(5.0 * arma::randu<arma::mat>(4, 500)) + 1.0;
+  arma::sp_mat sparseData(data);
+
+  arma::Col<size_t> oldFromNew = arma::linspace<arma::Col<size_t>>(0, 499,
+      500);
+  arma::Col<size_t> sparseOldFromNew(oldFromNew);
+
+  DTree<arma::mat> tree(data);
+  const double alpha = tree.Grow(data, oldFromNew, false, 10, 3);
+
+  DTree<arma::sp_mat> sparseTree(sparseData);
+  const double sparseAlpha = sparseTree.Grow(sparseData, sparseOldFromNew,
+      false, 10, 3);
+
+  BOOST_REQUIRE_CLOSE(alpha, sparseAlpha, 1e-10);
+  CheckSameTree(tree, sparseTree);
+
+  for (size_t i = 0; i < oldFromNew.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(oldFromNew[i], sparseOldFromNew[i]);
+}
+
+#ifdef HAS_OPENMP
+/**
+ * A tree grown with several threads should be the same as a tree grown with
+ * one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelGrowTest)
+{
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  // Use enough points for the root to be grown in parallel.
+  const arma::mat data = arma::randn<arma::mat>(3, 30000);
+
+  arma::mat data1(data);
+  arma::Col<size_t> oldFromNew1 = arma::linspace<arma::Col<size_t>>(0,
+      data.n_cols - 1, data.n_cols);
+  omp_set_num_threads(1);
+  DTree<arma::mat> tree1(data1);
+  const double alpha1 = tree1.Grow(data1, oldFromNew1, false, 10, 5);
+
+  arma::mat data2(data);
+  arma::Col<size_t> oldFromNew2 = arma::linspace<arma::Col<size_t>>(0,
+      data.n_cols - 1, data.n_cols);
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  DTree<arma::mat> tree2(data2);
+  const double alpha2 = tree2.Grow(data2, oldFromNew2, false, 10, 5);
+
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_CLOSE(alpha1, alpha2, 1e-10);
+  CheckSameTree(tree1, tree2);
+
+  for (size_t i = 0; i < oldFromNew1.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(oldFromNew1[i], oldFromNew2[i]);
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -7,6 +7,7 @@
  * Tests for the classes:
  *  * mlpack::distribution::DiscreteDistribution
  *  * mlpack::distribution::GaussianDistribution
+ *  * mlpack::distribution::DiagonalGaussianDistribution
  *  * mlpack::distribution::GammaDistribution
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
@@ -151,7 +152,7 @@ BOOST_AUTO_TEST_CASE(MultiDiscreteDistributionConstructorTest)
   DiscreteDistribution d("4 4 4 4");
 
   BOOST_REQUIRE_EQUAL(d.Probabilities(0).size(), 4);
-  BOOST_REQUIRE_EQUAL(d.Dimensionality(), 4);
+  BOOST_REQUIRE_EQUAL(d.Dimensionality(), (size_t) 4);
   BOOST_REQUIRE_CLOSE(d.Probability("0 0 0 0"), 0.00390625, 1e-5);
   BOOST_REQUIRE_CLOSE(d.Probability("0 1 2 3"), 0.00390625, 1e-5);
 }
@@ -238,6 +239,45 @@ BOOST_AUTO_TEST_CASE(DiscreteProbabilityTest)
   BOOST_REQUIRE_CLOSE(prob(1), 0.0400000000000, 1e-3);
 }
 
+/**
+ * Make sure that the batch probabilities of a multidimensional discrete
+ * distribution match the probabilities of each observation.
+ */
+BOOST_AUTO_TEST_CASE(DiscreteBatchProbabilityTest)
+{
+  std::vector<arma::vec> probabilities;
+  probabilities.push_back(arma::vec("0.1 0.3 0.6"));
+  probabilities.push_back(arma::vec("0.5 0.5"));
+  probabilities.push_back(arma::vec("0.2 0.2 0.2 0.4"));
+  DiscreteDistribution d(probabilities);
+
+  arma::mat obs(3, 50);
+  for (size_t i = 0; i < obs.n_cols; ++i)
+  {
+    obs(0, i) = math::RandInt(3);
+    obs(1, i) = math::RandInt(2);
+    obs(2, i) = math::RandInt(4);
+  }
+
+  arma::vec probs, logProbs;
+  d.Probability(obs, probs);
+  d.LogProbability(obs, logProbs);
+  BOOST_REQUIRE_EQUAL(probs.n_elem, obs.n_cols);
+  BOOST_REQUIRE_EQUAL(logProbs.n_elem, obs.n_cols);
+
+  for (size_t i = 0; i < obs.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(probs(i), d.Probability(obs.col(i)), 1e-5);
+    BOOST_REQUIRE_CLOSE(logProbs(i), d.LogProbability(obs.col(i)), 1e-5);
+  }
+
+  // An observation out of bounds is an error.
+  obs(2, 10) = 4;
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(d.LogProbability(obs, logProbs), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 /*********************************/
 /** Gaussian Distribution Tests **/
 /*********************************/
@@ -443,6 +483,33 @@ BOOST_AUTO_TEST_CASE(GaussianMultipointMultivariateProbabilityTest)
   BOOST_REQUIRE_CLOSE(phis(5), -14.900192463287908, 1e-5);
 }
 
+/**
+ * Make sure the batch LogProbability() and Probability() functions give the
+ * same results as evaluating each point on its own, for a random covariance.
+ */
+BOOST_AUTO_TEST_CASE(GaussianBatchProbabilityTest)
+{
+  arma::mat a(8, 8, arma::fill::randu);
+  arma::mat cov = a * a.t() + arma::eye<arma::mat>(8, 8);
+  arma::vec mean(8, arma::fill::randu);
+  GaussianDistribution g(mean, cov);
+
+  arma::mat points(8, 500, arma::fill::randn);
+  points.each_col() += mean;
+
+  arma::vec logProbs, probs;
+  g.LogProbability(points, logProbs);
+  g.Probability(points, probs);
+
+  BOOST_REQUIRE_EQUAL(logProbs.n_elem, (size_t) 500);
+  BOOST_REQUIRE_EQUAL(probs.n_elem, (size_t) 500);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(logProbs[i], g.LogProbability(points.col(i)), 1e-5);
+    BOOST_REQUIRE_CLOSE(probs[i], g.Probability(points.col(i)), 1e-5);
+  }
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
@@ -630,6 +697,94 @@ BOOST_AUTO_TEST_CASE(GaussianDistributionTrainWithTwoDistProbabilitiesTest)
   BOOST_REQUIRE_CLOSE(guDist.Covariance()[0], cov1[0], 5);
 }
 
+/*******************************************/
+/** Diagonal Gaussian Distribution Tests **/
+/*******************************************/
+
+/**
+ * Make sure the probabilities of a diagonal Gaussian are the same as the
+ * probabilities of a Gaussian with the same (diagonal) covariance matrix, for
+ * single observations and for a batch.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGaussianDistributionProbabilityTest)
+{
+  const arma::vec mean("1.0 -2.0 0.5 3.0");
+  const arma::vec covariance("0.5 2.0 1.5 0.1");
+  DiagonalGaussianDistribution d(mean, covariance);
+  GaussianDistribution g(mean, arma::diagmat(covariance));
+
+  BOOST_REQUIRE_EQUAL(d.Dimensionality(), (size_t) 4);
+
+  arma::mat points(4, 100, arma::fill::randn);
+  points *= 2.0;
+  arma::vec logProbs, probs, gLogProbs;
+  d.LogProbability(points, logProbs);
+  d.Probability(points, probs);
+  g.LogProbability(points, gLogProbs);
+
+  BOOST_REQUIRE_EQUAL(logProbs.n_elem, (size_t) 100);
+  BOOST_REQUIRE_EQUAL(probs.n_elem, (size_t) 100);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(d.LogProbability(points.col(i)),
+        g.LogProbability(points.col(i)), 1e-5);
+    BOOST_REQUIRE_CLOSE(logProbs[i], gLogProbs[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(probs[i], g.Probability(points.col(i)), 1e-5);
+  }
+}
+
+/**
+ * Make sure that a diagonal Gaussian trained on some points has the mean and
+ * the (unbiased) variance of the points.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGaussianDistributionTrainTest)
+{
+  DiagonalGaussianDistribution original("1.0 3.0 0.0 2.5",
+      "3.0 0.5 1.0 2.0");
+  arma::mat observations(4, 10000);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    observations.col(i) = original.Random();
+
+  DiagonalGaussianDistribution d;
+  d.Train(observations);
+
+  const arma::vec mean = arma::mean(observations, 1);
+  const arma::vec variance = arma::var(observations, 0, 1);
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(d.Mean()[i], mean[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(d.Covariance()[i], variance[i], 1e-5);
+
+    // The estimate should also be near the original distribution.
+    BOOST_REQUIRE_SMALL(d.Mean()[i] - original.Mean()[i], 0.1);
+    BOOST_REQUIRE_CLOSE(d.Covariance()[i], original.Covariance()[i], 10);
+  }
+}
+
+/**
+ * Make sure that training a diagonal Gaussian with probabilities gives the
+ * diagonal of the covariance of a Gaussian trained with the same
+ * probabilities.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGaussianDistributionTrainWithProbabilitiesTest)
+{
+  arma::mat observations(3, 2000, arma::fill::randn);
+  observations.row(1) *= 2.0;
+  observations.row(2) += 5.0;
+  arma::vec probabilities(2000, arma::fill::randu);
+
+  DiagonalGaussianDistribution d;
+  d.Train(observations, probabilities);
+  GaussianDistribution g;
+  g.Train(observations, probabilities);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(d.Mean()[i], g.Mean()[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(d.Covariance()[i], g.Covariance()(i, i), 1e-5);
+  }
+}
+
 /******************************/
 /** Gamma Distribution Tests **/
 /******************************/
@@ -1012,6 +1167,56 @@ BOOST_AUTO_TEST_CASE(GammaDistributionLogProbabilityTest)
   BOOST_REQUIRE_CLOSE(logprob3(1), std::log(0.026165), 1e-3);
 }
 
+/**
+ * Make sure that the log probability is computed without overflow for large
+ * alpha, where the gamma function itself overflows.
+ */
+BOOST_AUTO_TEST_CASE(GammaDistributionLargeAlphaLogProbabilityTest)
+{
+  const arma::vec a("200.0"), b("0.75");
+  GammaDistribution d(a, b);
+
+  arma::mat x("150.0");
+  arma::vec logProbs, probs;
+  d.LogProbability(x, logProbs);
+  d.Probability(x, probs);
+
+  // Evaluated with lgamma().
+  BOOST_REQUIRE_CLOSE(logProbs(0), -3.280831810346484, 1e-5);
+  BOOST_REQUIRE_CLOSE(d.LogProbability(150.0, 0), -3.280831810346484, 1e-5);
+  BOOST_REQUIRE_CLOSE(probs(0), std::exp(-3.280831810346484), 1e-5);
+}
+
+/**
+ * Make sure that the dimensions fitted in parallel give the same result as
+ * one thread.
+ */
+BOOST_AUTO_TEST_CASE(GammaDistributionParallelTrainTest)
+{
+  const arma::mat data = arma::randu<arma::mat>(20, 300) + 0.1;
+  const arma::vec probabilities = arma::randu<arma::vec>(300);
+
+  const size_t numThreads = NumThreads();
+  SetNumThreads(1);
+  GammaDistribution d1, d2;
+  d1.Train(data);
+  d2.Train(data, probabilities);
+
+  SetNumThreads(4);
+  GammaDistribution d3, d4;
+  d3.Train(data);
+  d4.Train(data, probabilities);
+  SetNumThreads(numThreads);
+
+  for (size_t i = 0; i < 20; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(d1.Alpha(i), d3.Alpha(i), 1e-10);
+    BOOST_REQUIRE_CLOSE(d1.Beta(i), d3.Beta(i), 1e-10);
+    BOOST_REQUIRE_CLOSE(d2.Alpha(i), d4.Alpha(i), 1e-10);
+    BOOST_REQUIRE_CLOSE(d2.Beta(i), d4.Beta(i), 1e-10);
+  }
+}
+
 /**
  * Discrete Distribution serialization test.
  */
@@ -1176,6 +1381,36 @@ BOOST_AUTO_TEST_CASE(LaplaceDistributionLogProbabilityTest)
     1e-5);
 }
 
+/**
+ * Make sure that the batch log probabilities of a multivariate Laplace
+ * distribution match the log probabilities of each observation.
+ */
+BOOST_AUTO_TEST_CASE(LaplaceDistributionBatchLogProbabilityTest)
+{
+  LaplaceDistribution l(arma::vec("1.0 -2.0 0.5"), 1.5);
+  const arma::mat points = arma::randn<arma::mat>(3, 100);
+
+  arma::vec probabilities, logProbabilities;
+  l.Probability(points, probabilities);
+  l.LogProbability(points, logProbabilities);
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(logProbabilities(i),
+        l.LogProbability(points.col(i)), 1e-5);
+    BOOST_REQUIRE_CLOSE(probabilities(i), l.Probability(points.col(i)), 1e-5);
+  }
+
+  // The weighted estimate with equal weights is the unweighted estimate.
+  LaplaceDistribution l1, l2;
+  l1.Estimate(points);
+  l2.Estimate(points, arma::vec(points.n_cols, arma::fill::ones));
+  CheckMatrices(l1.Mean(), l2.Mean());
+  BOOST_REQUIRE_CLOSE(l1.Scale(), l2.Scale(), 1e-5);
+  BOOST_REQUIRE_CLOSE(l1.Scale(), arma::mean(arma::sqrt(arma::sum(
+      arma::square(points.each_col() - l1.Mean()), 0))), 1e-5);
+}
+
 /**
  * Mahalanobis Distance serialization test.
  */
@@ -1242,4 +1477,32 @@ BOOST_AUTO_TEST_CASE(RegressionDistributionTest)
                 binaryRd.Rf().Parameters());
 }
 
+/**
+ * Make sure that the batch probabilities of RegressionDistribution match the
+ * probabilities of each observation.
+ */
+BOOST_AUTO_TEST_CASE(RegressionDistributionBatchProbabilityTest)
+{
+  // The responses are in the first row.
+  arma::mat observations = arma::randn<arma::mat>(4, 200);
+  observations.row(0) = 2 * observations.row(1) - observations.row(3) +
+      0.1 * arma::randn<arma::rowvec>(200);
+
+  RegressionDistribution rd;
+  rd.Train(observations);
+
+  arma::vec probabilities, logProbabilities;
+  rd.Probability(observations, probabilities);
+  rd.LogProbability(observations, logProbabilities);
+  BOOST_REQUIRE_EQUAL(probabilities.n_elem, observations.n_cols);
+
+  for (size_t i = 0; i < observations.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(probabilities(i),
+        rd.Probability(observations.col(i)), 1e-5);
+    BOOST_REQUIRE_CLOSE(logProbabilities(i),
+        rd.LogProbability(observations.col(i)), 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -167,4 +167,48 @@ BOOST_AUTO_TEST_CASE(SparseTest)
   BOOST_REQUIRE_EQUAL(distances.n_rows, 3);
 }
 
+#ifdef HAS_OPENMP
+/**
+ * Make sure that training and searching with several threads gives the same
+ * results as with one thread, for more query points than fit in one block.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDrusillaSelectTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(5, 1000);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  DrusillaSelect<> serialDs(dataset, 10, 10);
+  arma::Mat<size_t> serialNeighbors;
+  arma::mat serialDistances;
+  serialDs.Search(querySet, 3, serialNeighbors, serialDistances);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  DrusillaSelect<> ds(dataset, 10, 10);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ds.Search(querySet, 3, neighbors, distances);
+
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_EQUAL(ds.CandidateIndices().n_elem, 100);
+  for (size_t i = 0; i < ds.CandidateIndices().n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(ds.CandidateIndices()[i],
+        serialDs.CandidateIndices()[i]);
+  }
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 1000);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], serialNeighbors[i]);
+    BOOST_REQUIRE_EQUAL(distances[i], serialDistances[i]);
+  }
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
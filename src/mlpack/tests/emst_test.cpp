@@ -278,4 +278,58 @@ BOOST_AUTO_TEST_CASE(BallTreeTest)
   }
 }
 
+#ifdef HAS_OPENMP
+/**
+ * Make sure that the MST found with several threads is the same as the MST
+ * found with one thread, both with trees and in naive mode.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeBoruvkaTest)
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    BOOST_FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  DualTreeBoruvka<> serialDtb(inputData);
+  arma::mat serialResults;
+  serialDtb.ComputeMST(serialResults);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  DualTreeBoruvka<> dtb(inputData);
+  arma::mat results;
+  dtb.ComputeMST(results);
+
+  DualTreeBoruvka<> dtbNaive(inputData, true);
+  arma::mat naiveResults;
+  dtbNaive.ComputeMST(naiveResults);
+
+  DualTreeBoruvka<EuclideanDistance, arma::mat, BallTree> ballt(inputData);
+  arma::mat ballResults;
+  ballt.ComputeMST(ballResults);
+
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_EQUAL(results.n_cols, serialResults.n_cols);
+  BOOST_REQUIRE_EQUAL(naiveResults.n_cols, serialResults.n_cols);
+  BOOST_REQUIRE_EQUAL(ballResults.n_cols, serialResults.n_cols);
+  for (size_t i = 0; i < serialResults.n_cols; i++)
+  {
+    BOOST_REQUIRE_EQUAL(results(0, i), serialResults(0, i));
+    BOOST_REQUIRE_EQUAL(results(1, i), serialResults(1, i));
+    BOOST_REQUIRE_CLOSE(results(2, i), serialResults(2, i), 1e-5);
+
+    BOOST_REQUIRE_EQUAL(naiveResults(0, i), serialResults(0, i));
+    BOOST_REQUIRE_EQUAL(naiveResults(1, i), serialResults(1, i));
+    BOOST_REQUIRE_CLOSE(naiveResults(2, i), serialResults(2, i), 1e-5);
+
+    BOOST_REQUIRE_EQUAL(ballResults(0, i), serialResults(0, i));
+    BOOST_REQUIRE_EQUAL(ballResults(1, i), serialResults(1, i));
+    BOOST_REQUIRE_CLOSE(ballResults(2, i), serialResults(2, i), 1e-5);
+  }
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -1082,4 +1082,94 @@ BOOST_AUTO_TEST_CASE(CopyAssignmentTest)
   }
 }
 
+/**
+ * Make sure that the batched kernel evaluations of naive search with the
+ * polynomial kernel give the same results as evaluating the kernel pair by
+ * pair, when the number of points is not a multiple of the block sizes.
+ */
+BOOST_AUTO_TEST_CASE(BatchedNaivePolynomialTest)
+{
+  arma::mat queryData = arma::randu<arma::mat>(5, 300);
+  arma::mat referenceData = arma::randu<arma::mat>(5, 2500);
+  PolynomialKernel pk(3.0, 0.5);
+
+  FastMKS<PolynomialKernel> naive(referenceData, pk, false, true);
+
+  arma::Mat<size_t> indices;
+  arma::mat kernels;
+  naive.Search(queryData, 5, indices, kernels);
+
+  BOOST_REQUIRE_EQUAL(indices.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(indices.n_cols, 300);
+
+  for (size_t q = 0; q < queryData.n_cols; ++q)
+  {
+    arma::vec pointKernels(referenceData.n_cols);
+    for (size_t r = 0; r < referenceData.n_cols; ++r)
+      pointKernels[r] = pk.Evaluate(queryData.col(q), referenceData.col(r));
+
+    const arma::uvec order = arma::sort_index(pointKernels, "descend");
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(indices(j, q), order[j]);
+      BOOST_REQUIRE_CLOSE(kernels(j, q), pointKernels[order[j]], 1e-5);
+    }
+  }
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Ensure that the parallel single-tree, dual-tree and naive searches give the
+ * same results as the searches with a single thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSearchTest)
+{
+  arma::mat referenceData = arma::randn<arma::mat>(5, 2000);
+  arma::mat queryData = arma::randn<arma::mat>(5, 4000);
+  LinearKernel lk;
+
+  FastMKS<LinearKernel> naive(referenceData, lk, false, true);
+  FastMKS<LinearKernel> single(referenceData, lk, true);
+  FastMKS<LinearKernel> dual(referenceData, lk);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+
+  arma::Mat<size_t> naiveIndices, singleIndices, singleMonoIndices,
+      dualIndices;
+  arma::mat naiveKernels, singleKernels, singleMonoKernels, dualKernels;
+  naive.Search(queryData, 5, naiveIndices, naiveKernels);
+  single.Search(queryData, 5, singleIndices, singleKernels);
+  single.Search(5, singleMonoIndices, singleMonoKernels);
+  dual.Search(queryData, 5, dualIndices, dualKernels);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+
+  arma::Mat<size_t> parallelNaiveIndices, parallelSingleIndices,
+      parallelSingleMonoIndices, parallelDualIndices;
+  arma::mat parallelNaiveKernels, parallelSingleKernels,
+      parallelSingleMonoKernels, parallelDualKernels;
+  naive.Search(queryData, 5, parallelNaiveIndices, parallelNaiveKernels);
+  single.Search(queryData, 5, parallelSingleIndices, parallelSingleKernels);
+  single.Search(5, parallelSingleMonoIndices, parallelSingleMonoKernels);
+  dual.Search(queryData, 5, parallelDualIndices, parallelDualKernels);
+
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(naiveIndices, parallelNaiveIndices);
+  CheckMatrices(naiveKernels, parallelNaiveKernels);
+  CheckMatrices(singleIndices, parallelSingleIndices);
+  CheckMatrices(singleKernels, parallelSingleKernels);
+  CheckMatrices(singleMonoIndices, parallelSingleMonoIndices);
+  CheckMatrices(singleMonoKernels, parallelSingleMonoKernels);
+
+  // The blocks of the parallel dual-tree search have their own query trees,
+  // but the results are still exact.
+  CheckMatrices(naiveIndices, parallelDualIndices);
+  CheckMatrices(dualKernels, parallelDualKernels);
+  CheckMatrices(naiveIndices, dualIndices);
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -15,6 +15,10 @@
 #include <mlpack/methods/ann/layer/layer.hpp>
 #include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/ffn_codegen.hpp>
+#include <mlpack/methods/ann/file_data_source.hpp>
+#include <mlpack/methods/ann/quantization_agreement.hpp>
+#include <mlpack/methods/ann/sparse_update.hpp>
 
 #include <ensmallen.hpp>
 
@@ -39,7 +43,8 @@ void BuildVanillaNetwork(MatType& trainData,
                          const size_t outputSize,
                          const size_t hiddenLayerSize,
                          const size_t maxEpochs,
-                         const double classificationErrorThreshold)
+                         const double classificationErrorThreshold,
+                         const size_t workers = 1)
 {
   /*
    * Construct a feed forward network with trainData.n_rows input nodes,
@@ -63,11 +68,12 @@ void BuildVanillaNetwork(MatType& trainData,
    * +-----+       +-----+
    */
 
-  FFN<NegativeLogLikelihood<> > model;
-  model.Add<Linear<> >(trainData.n_rows, hiddenLayerSize);
-  model.Add<SigmoidLayer<> >();
-  model.Add<Linear<> >(hiddenLayerSize, outputSize);
-  model.Add<LogSoftMax<> >();
+  FFN<NegativeLogLikelihood<MatType, MatType> > model;
+  model.Add<Linear<MatType, MatType> >(trainData.n_rows, hiddenLayerSize);
+  model.Add<SigmoidLayer<LogisticFunction, MatType, MatType> >();
+  model.Add<Linear<MatType, MatType> >(hiddenLayerSize, outputSize);
+  model.Add<LogSoftMax<MatType, MatType> >();
+  model.Workers() = workers;
 
   // RMSProp opt(0.01, 32, 0.88, 1e-8, maxEpochs * trainData.n_cols, -1);
   ens::RMSProp opt(0.01, 32, 0.88, 1e-8, maxEpochs * trainData.n_cols, -1);
@@ -137,6 +143,69 @@ BOOST_AUTO_TEST_CASE(VanillaNetworkTest)
       (dataset, labels, dataset, labels, 2, 10, 10, 0.2);
 }
 
+/**
+ * Train the vanilla network in single precision.
+ */
+BOOST_AUTO_TEST_CASE(FloatVanillaNetworkTest)
+{
+  arma::fmat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::fmat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::fmat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::fmat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  BuildVanillaNetwork<arma::fmat>
+      (trainData, trainLabels, testData, testLabels, 3, 8, 10, 0.1);
+}
+
+/**
+ * Make sure that a single-precision network has single-precision parameters
+ * and gives the same output as the double-precision network with the same
+ * parameters.
+ */
+BOOST_AUTO_TEST_CASE(FloatForwardTest)
+{
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Linear<> >(5, 4);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(4, 3);
+  model.Add<LogSoftMax<> >();
+
+  FFN<NegativeLogLikelihood<arma::fmat, arma::fmat> > floatModel;
+  floatModel.Add<Linear<arma::fmat, arma::fmat> >(5, 4);
+  floatModel.Add<SigmoidLayer<LogisticFunction, arma::fmat, arma::fmat> >();
+  floatModel.Add<Linear<arma::fmat, arma::fmat> >(4, 3);
+  floatModel.Add<LogSoftMax<arma::fmat, arma::fmat> >();
+
+  arma::mat input = arma::randu(5, 10);
+  arma::mat output;
+  model.Predict(input, output);
+
+  arma::fmat floatInput = arma::conv_to<arma::fmat>::from(input);
+  arma::fmat floatOutput;
+  floatModel.ResetParameters();
+  BOOST_REQUIRE_EQUAL(floatModel.Parameters().n_elem,
+      model.Parameters().n_elem);
+
+  // Copy the parameters element by element, since the layers use the memory
+  // of the parameter matrix.
+  arma::fmat& floatParameters = floatModel.Parameters();
+  for (size_t i = 0; i < floatParameters.n_elem; ++i)
+    floatParameters[i] = float(model.Parameters()[i]);
+  floatModel.Predict(floatInput, floatOutput);
+
+  BOOST_REQUIRE_EQUAL(floatOutput.n_rows, output.n_rows);
+  BOOST_REQUIRE_EQUAL(floatOutput.n_cols, output.n_cols);
+  for (size_t i = 0; i < output.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(floatOutput[i], output[i], 1e-3);
+}
+
 BOOST_AUTO_TEST_CASE(ForwardBackwardTest)
 {
   arma::mat dataset;
@@ -532,6 +601,432 @@ BOOST_AUTO_TEST_CASE(CustomLayerTest)
   arma::mat prediction = arma::zeros<arma::mat>(1, predictionTemp.n_cols);
 }
 
+/**
+ * Predictions should not depend on the number of points that are passed
+ * through the network at once, and repeated predictions should reuse the
+ * output matrix.
+ */
+BOOST_AUTO_TEST_CASE(PredictBatchSizeTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(6, 10);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >();
+  model.Add<Linear<> >(10, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  const arma::mat data(6, 100, arma::fill::randu);
+
+  arma::mat predictions;
+  model.Predict(data, predictions, 0);
+  BOOST_REQUIRE_EQUAL(predictions.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(predictions.n_cols, 100);
+
+  // The last batch of each of these is smaller than the others.
+  const size_t batchSizes[] = { 1, 7, 64, 1000 };
+  for (size_t b = 0; b < 4; ++b)
+  {
+    arma::mat batchPredictions;
+    model.Predict(data, batchPredictions, batchSizes[b]);
+
+    BOOST_REQUIRE_EQUAL(batchPredictions.n_rows, 3);
+    BOOST_REQUIRE_EQUAL(batchPredictions.n_cols, 100);
+    for (size_t i = 0; i < predictions.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(batchPredictions[i], predictions[i], 1e-8);
+  }
+
+  // Predicting again into the same matrix should not reallocate it.
+  const double* memory = predictions.memptr();
+  model.Predict(data, predictions, 0);
+  BOOST_REQUIRE_EQUAL(predictions.memptr(), memory);
+
+  // A single point should give the same result as in a batch.
+  arma::mat pointPrediction;
+  model.Predict(data.col(42), pointPrediction);
+  BOOST_REQUIRE_EQUAL(pointPrediction.n_cols, 1);
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(pointPrediction[i], predictions(i, 42), 1e-8);
+}
+
+/**
+ * The outputs of the layers share memory during Predict(); training afterwards
+ * should not be affected.
+ */
+BOOST_AUTO_TEST_CASE(PredictSharedBuffersTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 40);
+  arma::mat labels(1, 40);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = math::RandInt(1, 4);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(5, 7);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(7, 3);
+  model.Add<LogSoftMax<> >();
+
+  model.Predictors() = data;
+  model.Responses() = labels;
+  model.ResetParameters();
+
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 40);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  // Batches of 10 points share the buffers from the second batch on, and the
+  // next call with the same batch size from the first batch.
+  arma::mat batchPredictions;
+  for (size_t i = 0; i < 2; ++i)
+  {
+    model.Predict(data, batchPredictions, 10);
+    CheckMatrices(batchPredictions, predictions);
+  }
+
+  arma::mat newGradient;
+  const double newObjective = model.EvaluateWithGradient(model.Parameters(), 0,
+      newGradient, 40);
+  BOOST_REQUIRE_CLOSE(newObjective, objective, 1e-5);
+  CheckMatrices(newGradient, gradient);
+}
+
+/**
+ * Make sure that the profile records the passes of every layer, and nothing
+ * while it is disabled.
+ */
+BOOST_AUTO_TEST_CASE(NetworkProfileTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 12);
+  arma::mat labels(1, 12);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = math::RandInt(1, 4);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(5, 7);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(7, 3);
+  model.Add<LogSoftMax<> >();
+
+  model.Predictors() = data;
+  model.Responses() = labels;
+  model.ResetParameters();
+
+  arma::mat gradient;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 12);
+  BOOST_REQUIRE_EQUAL(model.Profile().NumLayers(), 0);
+  BOOST_REQUIRE_EQUAL(model.Profile().NumEvents(), 0);
+
+  model.Profile().Enabled() = true;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 12);
+
+  const NetworkProfile& profile = model.Profile();
+  BOOST_REQUIRE_EQUAL(profile.NumLayers(), 4);
+  BOOST_REQUIRE_EQUAL(profile.Name(0), "Linear");
+  BOOST_REQUIRE_EQUAL(profile.Name(2), "Linear");
+  BOOST_REQUIRE_EQUAL(profile.Name(3), "LogSoftMax");
+
+  // The first layer has no backward pass.
+  for (size_t i = 0; i < 4; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(profile.Calls(i, NetworkProfile::FORWARD), 1);
+    BOOST_REQUIRE_EQUAL(profile.Calls(i, NetworkProfile::BACKWARD),
+        (i == 0) ? 0 : 1);
+    BOOST_REQUIRE_EQUAL(profile.Calls(i, NetworkProfile::GRADIENT), 1);
+    BOOST_REQUIRE_GE(profile.Seconds(i, NetworkProfile::FORWARD), 0.0);
+    BOOST_REQUIRE_GT(profile.Bytes(i), 0);
+  }
+  BOOST_REQUIRE_EQUAL(profile.NumEvents(), 11);
+
+  // Two operations per weight and per point for the layers with weights.
+  BOOST_REQUIRE_CLOSE(profile.Flops(0, NetworkProfile::FORWARD),
+      2.0 * (5 * 7 + 7) * 12, 1e-5);
+  BOOST_REQUIRE_CLOSE(profile.Flops(1, NetworkProfile::FORWARD), 7.0 * 12,
+      1e-5);
+
+  std::ostringstream table, trace;
+  profile.PrintTable(table);
+  profile.PrintChromeTrace(trace);
+  BOOST_REQUIRE_NE(table.str().find("LogSoftMax"), std::string::npos);
+  BOOST_REQUIRE_NE(trace.str().find("\"traceEvents\""), std::string::npos);
+  BOOST_REQUIRE_NE(trace.str().find("\"cat\": \"gradient\""),
+      std::string::npos);
+
+  model.Profile().Clear();
+  BOOST_REQUIRE_EQUAL(model.Profile().NumLayers(), 0);
+  BOOST_REQUIRE_EQUAL(model.Profile().NumEvents(), 0);
+}
+
+/**
+ * Make sure that the training checkpoints are written in the background, and
+ * that the last one holds the trained parameters and the iterations.
+ */
+BOOST_AUTO_TEST_CASE(TrainingCheckpointTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 20);
+  arma::mat labels(1, 20);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = math::RandInt(1, 4);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(5, 7);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(7, 3);
+  model.Add<LogSoftMax<> >();
+
+  // Nothing is written without a path.
+  BOOST_REQUIRE(!model.Checkpoint().Enabled());
+  model.Checkpoint().Path() = "ffn_checkpoint_test.bin";
+  model.Checkpoint().Interval() = 7;
+  BOOST_REQUIRE(model.Checkpoint().Enabled());
+
+  // Ten epochs of two batches.
+  ens::StandardSGD opt(0.01, 10, 200, -1, true);
+  model.Train(data, labels, opt);
+  BOOST_REQUIRE_EQUAL(model.Checkpoint().Iterations(), 20);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> resumed;
+  resumed.Add<Linear<> >(5, 7);
+  resumed.Add<SigmoidLayer<> >();
+  resumed.Add<Linear<> >(7, 3);
+  resumed.Add<LogSoftMax<> >();
+  resumed.ResetParameters();
+  resumed.Checkpoint().Path() = "ffn_checkpoint_test.bin";
+  BOOST_REQUIRE(resumed.Checkpoint().Restore(resumed.Parameters()));
+
+  BOOST_REQUIRE_EQUAL(resumed.Checkpoint().Iterations(), 20);
+  CheckMatrices(resumed.Parameters(), model.Parameters());
+
+  remove("ffn_checkpoint_test.bin");
+  BOOST_REQUIRE(!resumed.Checkpoint().Restore(resumed.Parameters()));
+}
+
+/**
+ * Make sure that the generated inference code has the layers and the weights
+ * of the network, and that unsupported networks are rejected.
+ */
+BOOST_AUTO_TEST_CASE(FFNCodeGeneratorTest)
+{
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(4, 5);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Dropout<> >();
+  model.Add<Linear<> >(5, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  std::ostringstream header;
+  FFNCodeGenerator("model").Generate(model, header);
+  const std::string code = header.str();
+
+  BOOST_REQUIRE_NE(code.find("namespace model {"), std::string::npos);
+  BOOST_REQUIRE_NE(code.find("InputSize = 4;"), std::string::npos);
+  BOOST_REQUIRE_NE(code.find("OutputSize = 3;"), std::string::npos);
+  BOOST_REQUIRE_NE(code.find("detail::Linear<4, 5>(detail::layer0Weight, "
+      "detail::layer0Bias, input, a);"), std::string::npos);
+  BOOST_REQUIRE_NE(code.find("detail::Logistic<5>(a);"), std::string::npos);
+  BOOST_REQUIRE_NE(code.find("detail::Linear<5, 3>(detail::layer3Weight, "
+      "detail::layer3Bias, a, b);"), std::string::npos);
+  BOOST_REQUIRE_NE(code.find("detail::LogSoftMax<3>(b);"), std::string::npos);
+  BOOST_REQUIRE_NE(code.find("detail::Copy<OutputSize>(b, output);"),
+      std::string::npos);
+
+  // The weights of the first layer are written row-major, followed by the
+  // bias.
+  const std::string array = "layer0Weight[20] = {";
+  std::string values = code.substr(code.find(array) + array.size());
+  values = values.substr(0, values.find('}'));
+  std::replace(values.begin(), values.end(), ',', ' ');
+  std::istringstream stream(values);
+  const arma::mat weight(model.Parameters().memptr(), 5, 4);
+  for (size_t o = 0; o < 5; ++o)
+  {
+    for (size_t i = 0; i < 4; ++i)
+    {
+      double value;
+      BOOST_REQUIRE(stream >> value);
+      BOOST_REQUIRE_EQUAL(value, weight(o, i));
+    }
+  }
+
+  // Layers without a generated kernel are rejected.
+  model.Add<BatchNorm<> >(3);
+  model.ResetParameters();
+  std::ostringstream unsupported;
+  BOOST_REQUIRE_THROW(FFNCodeGenerator("model").Generate(model, unsupported),
+      std::invalid_argument);
+
+  BOOST_REQUIRE_THROW(FFNCodeGenerator("1model"), std::invalid_argument);
+}
+
+/**
+ * Folding the BatchNorm layers into the preceding Linear layers should remove
+ * them without changing the predictions.
+ */
+BOOST_AUTO_TEST_CASE(FoldBatchNormTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 30);
+  arma::mat labels(1, 30);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = math::RandInt(1, 4);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(5, 7);
+  model.Add<BatchNorm<> >(7);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(7, 3);
+  model.Add<BatchNorm<> >(3);
+  model.Add<LogSoftMax<> >();
+
+  model.Predictors() = data;
+  model.Responses() = labels;
+  model.ResetParameters();
+
+  // Use a scale and a shift different from the identity, and compute the
+  // statistics of the training data.
+  model.Parameters().randu();
+  model.Evaluate(model.Parameters(), 0, data.n_cols, false);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  const size_t parameters = model.Parameters().n_elem;
+  BOOST_REQUIRE_EQUAL(model.FoldBatchNorm(), 2);
+  BOOST_REQUIRE_EQUAL(model.Parameters().n_elem, parameters - 2 * (7 + 3));
+
+  arma::mat foldedPredictions;
+  model.Predict(data, foldedPredictions);
+  CheckMatrices(foldedPredictions, predictions, 1e-5);
+
+  // There is nothing left to fold.
+  BOOST_REQUIRE_EQUAL(model.FoldBatchNorm(), 0);
+}
+
+/**
+ * Quantize a network and make sure that its predictions stay close to those of
+ * the original network, also after serialization.
+ */
+BOOST_AUTO_TEST_CASE(QuantizeTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 100);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(5, 20);
+  model.Add<SigmoidLayer<> >();
+  model.Add<LinearNoBias<> >(20, 10);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(10, 3);
+  model.Add<LogSoftMax<> >();
+  model.ResetParameters();
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> quantized(model);
+  BOOST_REQUIRE_EQUAL(quantized.Quantize(data.cols(0, 49)), 3);
+  BOOST_REQUIRE_EQUAL(quantized.Parameters().n_elem, 0);
+
+  double maxError;
+  const double agreement = QuantizationAgreement(model, quantized, data,
+      maxError);
+  BOOST_REQUIRE_GE(agreement, 0.9);
+  BOOST_REQUIRE_LE(maxError, 0.1);
+
+  // There is nothing left to quantize.
+  BOOST_REQUIRE_EQUAL(quantized.Quantize(data), 0);
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> xmlModel, textModel,
+      binaryModel;
+  SerializeObjectAll(quantized, xmlModel, textModel, binaryModel);
+
+  arma::mat predictions, xmlPredictions, textPredictions, binaryPredictions;
+  quantized.Predict(data, predictions);
+  xmlModel.Predict(data, xmlPredictions);
+  textModel.Predict(data, textPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions);
+  CheckMatrices(predictions, textPredictions);
+  CheckMatrices(predictions, binaryPredictions);
+}
+
+/**
+ * Train the vanilla network on the thyroid dataset, split in chunks that are
+ * loaded from files while the network is trained.
+ */
+BOOST_AUTO_TEST_CASE(TrainFromSourceTest)
+{
+  arma::mat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::mat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::mat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::mat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  // Save the training set in three chunks.
+  const size_t numChunks = 3;
+  const size_t chunkSize = (trainData.n_cols + numChunks - 1) / numChunks;
+  std::vector<std::string> predictorFiles, responseFiles;
+  for (size_t i = 0; i < numChunks; ++i)
+  {
+    const size_t begin = i * chunkSize;
+    const size_t end = std::min(begin + chunkSize, (size_t) trainData.n_cols);
+    predictorFiles.push_back("ffn_chunk_x" + std::to_string(i) + ".csv");
+    responseFiles.push_back("ffn_chunk_y" + std::to_string(i) + ".csv");
+    data::Save(predictorFiles[i], arma::mat(trainData.cols(begin, end - 1)),
+        true);
+    data::Save(responseFiles[i], arma::mat(trainLabels.cols(begin, end - 1)),
+        true);
+  }
+
+  FFN<NegativeLogLikelihood<>, RandomInitialization> model;
+  model.Add<Linear<> >(trainData.n_rows, 8);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(8, 3);
+  model.Add<LogSoftMax<> >();
+
+  // One pass over a chunk per run of the optimizer, which keeps its state.
+  FileDataSource<> source(predictorFiles, responseFiles);
+  ens::RMSProp opt(0.01, 32, 0.88, 1e-8, chunkSize, -1, true, false);
+  model.TrainFromSource(source, opt, 10);
+
+  arma::mat predictionTemp;
+  model.Predict(testData, predictionTemp);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < predictionTemp.n_cols; ++i)
+  {
+    arma::uword prediction;
+    predictionTemp.col(i).max(prediction);
+    if (prediction + 1 == size_t(testLabels(i)))
+      ++correct;
+  }
+
+  const double classificationError = 1 - double(correct) / testData.n_cols;
+  BOOST_REQUIRE_LE(classificationError, 0.1);
+
+  for (size_t i = 0; i < numChunks; ++i)
+  {
+    remove(predictorFiles[i].c_str());
+    remove(responseFiles[i].c_str());
+  }
+
+  // The errors of the loader are passed on.
+  std::vector<std::string> missing(1, "ffn_missing_chunk.csv");
+  FileDataSource<> missingSource(missing, missing);
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(model.TrainFromSource(missingSource, opt, 1),
+      std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  BOOST_REQUIRE_THROW(FileDataSource<>(missing, predictorFiles),
+      std::invalid_argument);
+}
+
 /**
  * Test the overload of Forward function which allows partial forward pass.
  */
@@ -579,4 +1074,150 @@ BOOST_AUTO_TEST_CASE(PartialForwardTest)
   CheckMatrices(output, arma::ones(10, 1) * 20);
 }
 
+/**
+ * Splitting each batch across several workers should give the objective and
+ * the gradient of a single worker, whether the loss function sums or averages
+ * over the points.
+ */
+template<typename OutputLayerType>
+void CheckParallelGradient(const arma::mat& data, const arma::mat& responses)
+{
+  FFN<OutputLayerType> model;
+  model.Add<Linear<> >(data.n_rows, 7);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(7, 3);
+  model.Add<LogSoftMax<> >();
+
+  model.Predictors() = data;
+  model.Responses() = responses;
+  model.ResetParameters();
+
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, data.n_cols);
+
+  arma::mat batchGradient;
+  const double batchObjective = model.EvaluateWithGradient(model.Parameters(),
+      2, batchGradient, 5);
+
+  // More workers than threads, and more workers than points in the batch,
+  // should both work.
+  const size_t workers[] = { 2, 3, 8, 0 };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    model.Workers() = workers[i];
+
+    arma::mat parallelGradient;
+    const double parallelObjective = model.EvaluateWithGradient(
+        model.Parameters(), 0, parallelGradient, data.n_cols);
+    BOOST_REQUIRE_CLOSE(parallelObjective, objective, 1e-5);
+    CheckMatrices(parallelGradient, gradient, 1e-4);
+
+    // Now a batch that doesn't start at the first point.
+    const double parallelBatchObjective = model.EvaluateWithGradient(
+        model.Parameters(), 2, parallelGradient, 5);
+    BOOST_REQUIRE_CLOSE(parallelBatchObjective, batchObjective, 1e-5);
+    CheckMatrices(parallelGradient, batchGradient, 1e-4);
+  }
+}
+
+/**
+ * Check that the sparse gradient of a network with a Lookup layer is the same
+ * as the dense gradient, and that the gradient ranges cover the looked up
+ * entries and the dense layers only.
+ */
+BOOST_AUTO_TEST_CASE(SparseGradientTest)
+{
+  arma::mat data(1, 12);
+  arma::mat labels(1, 12);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    data[i] = math::RandInt(1, 21);
+    labels[i] = math::RandInt(1, 3);
+  }
+
+  FFN<NegativeLogLikelihood<> > model;
+  model.Add<Lookup<> >(20, 4);
+  model.Add<Linear<> >(4, 2);
+  model.Add<LogSoftMax<> >();
+
+  model.Predictors() = data;
+  model.Responses() = labels;
+  model.ResetParameters();
+
+  arma::mat sparseGradient;
+  for (size_t begin = 0; begin < 12; begin += 4)
+  {
+    model.SparseGradient() = false;
+    arma::mat gradient;
+    const double objective = model.EvaluateWithGradient(model.Parameters(),
+        begin, gradient, 4);
+
+    // The sparse gradient reuses the same matrix for all batches.
+    model.SparseGradient() = true;
+    const double sparseObjective = model.EvaluateWithGradient(
+        model.Parameters(), begin, sparseGradient, 4);
+    BOOST_REQUIRE_CLOSE(sparseObjective, objective, 1e-5);
+    CheckMatrices(sparseGradient, gradient, 1e-5);
+
+    // The ranges are the looked up columns of the Lookup layer, and the
+    // whole Linear layer.
+    arma::Col<size_t> covered(model.Parameters().n_elem, arma::fill::zeros);
+    const arma::Mat<size_t>& ranges = model.GradientRanges();
+    BOOST_REQUIRE_EQUAL(ranges.n_rows, 2);
+    for (size_t i = 0; i < ranges.n_cols; ++i)
+      covered.rows(ranges(0, i), ranges(0, i) + ranges(1, i) - 1).ones();
+
+    arma::Col<size_t> expected(model.Parameters().n_elem, arma::fill::zeros);
+    expected.tail_rows(4 * 2 + 2).ones();
+    for (size_t i = begin; i < begin + 4; ++i)
+    {
+      const size_t column = (size_t) data[i] - 1;
+      expected.rows(4 * column, 4 * column + 3).ones();
+    }
+    BOOST_REQUIRE_EQUAL(arma::accu(covered != expected), 0);
+  }
+
+  // A sparse update only changes the parameters in the ranges.
+  arma::mat parameters = model.Parameters();
+  SparseUpdate update(model.GradientRanges());
+  update.Initialize(parameters.n_rows, parameters.n_cols);
+  update.Update(parameters, 0.1, sparseGradient);
+  CheckMatrices(parameters, model.Parameters() - 0.1 * sparseGradient, 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelGradientTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 12);
+  arma::mat labels(1, 12);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = math::RandInt(1, 4);
+
+  CheckParallelGradient<NegativeLogLikelihood<> >(data, labels);
+
+  arma::mat responses = arma::randu<arma::mat>(3, 12);
+  CheckParallelGradient<MeanSquaredError<> >(data, responses);
+}
+
+/**
+ * Train the vanilla network with several workers.
+ */
+BOOST_AUTO_TEST_CASE(ParallelVanillaNetworkTest)
+{
+  arma::mat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::mat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::mat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::mat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  BuildVanillaNetwork<>
+      (trainData, trainLabels, testData, testLabels, 3, 8, 10, 0.1, 4);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
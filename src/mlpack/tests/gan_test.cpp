@@ -31,6 +31,76 @@ using namespace std::placeholders;
 
 BOOST_AUTO_TEST_SUITE(GANNetworkTest);
 
+/*
+ * Check that the gradient of the Generator, which reuses the forward passes of
+ * the generated batch, matches the numerical gradient of -log(D(G(noise))).
+ */
+BOOST_AUTO_TEST_CASE(GANGeneratorGradientTest)
+{
+  const size_t batchSize = 4;
+
+  arma::mat trainData(1, 16);
+  trainData.randn();
+
+  FFN<CrossEntropyError<> > discriminator;
+  discriminator.Add<Linear<> >(1, 4);
+  discriminator.Add<SigmoidLayer<> >();
+  discriminator.Add<Linear<> >(4, 1);
+  discriminator.Add<SigmoidLayer<> >();
+
+  FFN<CrossEntropyError<> > generator;
+  generator.Add<Linear<> >(1, 4);
+  generator.Add<SoftPlusLayer<> >();
+  generator.Add<Linear<> >(4, 1);
+
+  // Every batch gets the same noise, so that the objective of the Generator
+  // can be evaluated again.
+  const arma::mat noise("-1.0 -0.3 0.4 1.2");
+  size_t k = 0;
+  std::function<double()> noiseFunction = [&]()
+      { return noise[(k++) % noise.n_elem]; };
+
+  GaussianInitialization gaussian(0, 0.5);
+  GAN<FFN<CrossEntropyError<> >,
+      GaussianInitialization,
+      std::function<double()> >
+  gan(trainData, generator, discriminator, gaussian, noiseFunction, 1,
+      batchSize, 1, 0, 1);
+  gan.Reset();
+
+  arma::mat gradient;
+  gan.EvaluateWithGradient(gan.Parameters(), 0, gradient, batchSize);
+
+  const arma::mat ones(1, batchSize, arma::fill::ones);
+  auto generatorObjective = [&]()
+  {
+    arma::mat generated, output;
+    gan.Generator().Forward(noise, generated);
+    gan.Discriminator().Forward(generated, output);
+    CrossEntropyError<> loss;
+    return loss.Forward(std::move(output), std::move(ones));
+  };
+
+  const double eps = 1e-6;
+  const size_t generatorWeights = gan.Generator().Parameters().n_elem;
+  arma::vec numerical(generatorWeights);
+  for (size_t i = 0; i < generatorWeights; ++i)
+  {
+    const double weight = gan.Parameters()[i];
+    gan.Parameters()[i] = weight + eps;
+    const double objectivePlus = generatorObjective();
+    gan.Parameters()[i] = weight - eps;
+    const double objectiveMinus = generatorObjective();
+    gan.Parameters()[i] = weight;
+
+    numerical[i] = (objectivePlus - objectiveMinus) / (2 * eps);
+  }
+
+  const arma::vec analytic = gradient.rows(0, generatorWeights - 1);
+  BOOST_REQUIRE_LE(arma::norm(analytic - numerical) /
+      arma::norm(analytic + numerical), 1e-5);
+}
+
 /*
  * Load pre trained network values
  * for generating distribution that
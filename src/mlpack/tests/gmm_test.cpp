@@ -13,6 +13,8 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/gmm/diagonal_gmm.hpp>
+#include <mlpack/methods/gmm/online_em_fit.hpp>
 
 #include <mlpack/methods/gmm/no_constraint.hpp>
 #include <mlpack/methods/gmm/positive_definite_constraint.hpp>
@@ -794,6 +796,38 @@ BOOST_AUTO_TEST_CASE(UseExistingModelTest)
   }
 }
 
+/**
+ * Make sure that the trials of GMM::Train() give the same model when they are
+ * fit one at a time (with a small memory limit) as when they are fit in
+ * parallel.
+ */
+BOOST_AUTO_TEST_CASE(GMMParallelTrialsTest)
+{
+  arma::mat data(3, 600);
+  data.randn();
+  data.cols(200, 399) += 5.0;
+  data.cols(400, 599) -= 5.0;
+
+  math::RandomSeed(7);
+  GMM gmm(3, 3);
+  const double likelihood = gmm.Train(data, 6, false, EMFit<>(), 1);
+
+  math::RandomSeed(7);
+  GMM parallelGmm(3, 3);
+  const double parallelLikelihood = parallelGmm.Train(data, 6);
+
+  BOOST_REQUIRE_CLOSE(likelihood, parallelLikelihood, 1e-5);
+  for (size_t i = 0; i < gmm.Gaussians(); ++i)
+  {
+    BOOST_REQUIRE_CLOSE(gmm.Weights()[i], parallelGmm.Weights()[i], 1e-5);
+    for (size_t j = 0; j < gmm.Dimensionality(); ++j)
+    {
+      BOOST_REQUIRE_CLOSE(gmm.Component(i).Mean()[j],
+          parallelGmm.Component(i).Mean()[j], 1e-5);
+    }
+  }
+}
+
 /**
  * Make sure we can fit a diagonal GMM reasonably.
  */
@@ -894,4 +928,299 @@ BOOST_AUTO_TEST_CASE(DiagonalGMMTrainTest)
   }
 }
 
+/**
+ * Train a DiagonalGMM on points from a mixture of three diagonal Gaussians, and
+ * make sure the mixture is recovered, with both the parallel EM of EMFit and
+ * the default Armadillo-based fitting.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGMMClassTrainTest)
+{
+  distribution::DiagonalGaussianDistribution d1("0.0 1.0 0.0", "1.0 0.8 1.0");
+  distribution::DiagonalGaussianDistribution d2("2.0 -1.0 5.0", "3.0 1.2 1.3");
+  distribution::DiagonalGaussianDistribution d3("0.0 5.0 -3.0", "2.0 0.3 1.0");
+  std::vector<distribution::DiagonalGaussianDistribution> dists;
+  dists.push_back(d1);
+  dists.push_back(d2);
+  dists.push_back(d3);
+  const arma::vec weights("0.2 0.3 0.5");
+  DiagonalGMM original(dists, weights);
+
+  arma::mat points(3, 5000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    points.col(i) = original.Random();
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    DiagonalGMM g(3, 3);
+    if (trial == 0)
+    {
+      g.Train(points, 5);
+    }
+    else
+    {
+      g.Train<EMFit<kmeans::KMeans<>, PositiveDefiniteConstraint,
+          distribution::DiagonalGaussianDistribution>>(points, 5);
+    }
+
+    // Order by weights so that the components match.
+    arma::uvec sortedIndices = sort_index(g.Weights());
+    for (size_t c = 0; c < 3; ++c)
+    {
+      const distribution::DiagonalGaussianDistribution& component =
+          g.Component(sortedIndices[c]);
+      BOOST_REQUIRE_SMALL(g.Weights()[sortedIndices[c]] - weights[c], 0.1);
+      for (size_t i = 0; i < 3; ++i)
+      {
+        BOOST_REQUIRE_SMALL(component.Mean()[i] - dists[c].Mean()[i], 0.4);
+        BOOST_REQUIRE_SMALL(component.Covariance()[i] -
+            dists[c].Covariance()[i], 0.5);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that a DiagonalGMM gives the same probabilities and
+ * classifications as a GMM with the same diagonal covariances.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGMMProbabilityTest)
+{
+  DiagonalGMM d(4, 5);
+  GMM g(4, 5);
+  d.Weights() = arma::vec("0.1 0.2 0.3 0.4");
+  g.Weights() = d.Weights();
+  for (size_t i = 0; i < 4; ++i)
+  {
+    d.Component(i).Mean().randu();
+    d.Component(i).Mean() *= 4.0;
+    d.Component(i).Covariance(arma::vec(arma::randu<arma::vec>(5) + 0.5));
+    g.Component(i).Mean() = d.Component(i).Mean();
+    g.Component(i).Covariance(arma::diagmat(d.Component(i).Covariance()));
+  }
+
+  arma::mat points(5, 200, arma::fill::randu);
+  points *= 4.0;
+
+  arma::vec logProbs;
+  d.LogProbability(points, logProbs);
+  arma::Row<size_t> labels, gLabels;
+  d.Classify(points, labels);
+  g.Classify(points, gLabels);
+
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(d.LogProbability(points.col(i)),
+        g.LogProbability(points.col(i)), 1e-5);
+    BOOST_REQUIRE_CLOSE(logProbs[i], g.LogProbability(points.col(i)), 1e-5);
+    for (size_t j = 0; j < 4; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(d.Probability(points.col(i), j),
+          g.Probability(points.col(i), j), 1e-5);
+    }
+    BOOST_REQUIRE_EQUAL(labels[i], gLabels[i]);
+  }
+}
+
+/**
+ * Make sure that the batch LogProbability() and Classify() of a GMM agree with
+ * the single-observation functions.
+ */
+BOOST_AUTO_TEST_CASE(GMMBatchProbabilityTest)
+{
+  GMM g(3, 4);
+  g.Weights() = arma::vec("0.2 0.3 0.5");
+  for (size_t i = 0; i < 3; ++i)
+  {
+    g.Component(i).Mean().randu();
+    g.Component(i).Mean() *= 3.0;
+    arma::mat a(4, 4, arma::fill::randu);
+    g.Component(i).Covariance(arma::mat(a * a.t() +
+        arma::eye<arma::mat>(4, 4)));
+  }
+
+  arma::mat points(4, 300, arma::fill::randu);
+  points *= 3.0;
+
+  arma::vec logProbs;
+  g.LogProbability(points, logProbs);
+  arma::Row<size_t> labels;
+  g.Classify(points, labels);
+
+  BOOST_REQUIRE_EQUAL(logProbs.n_elem, (size_t) 300);
+  BOOST_REQUIRE_EQUAL(labels.n_elem, (size_t) 300);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(logProbs[i], g.LogProbability(points.col(i)), 1e-5);
+
+    // The label must be the most probable component.
+    double bestProb = 0.0;
+    size_t bestComponent = 0;
+    for (size_t j = 0; j < 3; ++j)
+    {
+      const double prob = g.Probability(points.col(i), j);
+      if (prob >= bestProb)
+      {
+        bestProb = prob;
+        bestComponent = j;
+      }
+    }
+    BOOST_REQUIRE_EQUAL((size_t) labels[i], bestComponent);
+  }
+}
+
+/**
+ * Train a GMM with OnlineEMFit on a stream of chunks of points from a mixture
+ * of three Gaussians, and make sure the mixture is recovered.
+ */
+BOOST_AUTO_TEST_CASE(OnlineEMFitStreamTest)
+{
+  distribution::GaussianDistribution d1("0.0 1.0 0.0", "1.0 0.1 0.0;"
+                                                       "0.1 0.8 0.0;"
+                                                       "0.0 0.0 1.0");
+  distribution::GaussianDistribution d2("6.0 -1.0 5.0", "3.0 0.0 0.5;"
+                                                        "0.0 1.2 0.0;"
+                                                        "0.5 0.0 1.3");
+  distribution::GaussianDistribution d3("0.0 8.0 -6.0", "2.0 0.0 0.0;"
+                                                        "0.0 0.3 0.0;"
+                                                        "0.0 0.0 1.0");
+
+  GMM g(3, 3);
+  OnlineEMFit<> fitter(500);
+  for (size_t chunk = 0; chunk < 10; ++chunk)
+  {
+    arma::mat points(3, 2000);
+    for (size_t i = 0; i < points.n_cols; ++i)
+    {
+      const double randValue = math::Random();
+      if (randValue <= 0.20) // p(d1) = 0.20
+        points.col(i) = d1.Random();
+      else if (randValue <= 0.50) // p(d2) = 0.30
+        points.col(i) = d2.Random();
+      else // p(d3) = 0.50
+        points.col(i) = d3.Random();
+    }
+
+    // Pass the fitter by reference so that its step-size schedule continues
+    // from one chunk to the next.
+    g.Train<OnlineEMFit<>&>(points, 1, (chunk > 0), fitter);
+  }
+
+  // Four mini-batches were processed for each of the ten chunks.
+  BOOST_REQUIRE_EQUAL((size_t) fitter.Updates(), 40);
+
+  // Order by weights so that the components can be compared.
+  arma::uvec sortedIndices = sort_index(g.Weights());
+  const distribution::GaussianDistribution* trueDists[3] = { &d1, &d2, &d3 };
+  const double trueWeights[3] = { 0.2, 0.3, 0.5 };
+  for (size_t c = 0; c < 3; ++c)
+  {
+    const distribution::GaussianDistribution& d =
+        g.Component(sortedIndices[c]);
+    BOOST_REQUIRE_SMALL(g.Weights()[sortedIndices[c]] - trueWeights[c], 0.1);
+    for (size_t i = 0; i < 3; ++i)
+      BOOST_REQUIRE_SMALL(d.Mean()[i] - trueDists[c]->Mean()[i], 0.4);
+    for (size_t i = 0; i < 9; ++i)
+      BOOST_REQUIRE_SMALL(d.Covariance()[i] - trueDists[c]->Covariance()[i],
+          0.5);
+  }
+
+  // With all probabilities equal to 1, the weighted overload must give the
+  // same update as the unweighted one.
+  arma::mat points(3, 1000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    points.col(i) = (i % 2 == 0) ? d1.Random() : d3.Random();
+  GMM g2(g);
+  OnlineEMFit<> fitter1(250), fitter2(250);
+  g.Train(points, 1, true, fitter1);
+  g2.Train(points, arma::ones<arma::vec>(points.n_cols), 1, true, fitter2);
+  for (size_t c = 0; c < 3; ++c)
+  {
+    BOOST_REQUIRE_CLOSE(g.Weights()[c], g2.Weights()[c], 1e-5);
+    for (size_t i = 0; i < 3; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(g.Component(c).Mean()[i],
+          g2.Component(c).Mean()[i], 1e-5);
+    }
+  }
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that EMFit gives the same model with one thread and with several
+ * threads, with and without observation probabilities.
+ */
+BOOST_AUTO_TEST_CASE(ParallelEMFitTest)
+{
+  // Enough points that the observations are split into several blocks.
+  distribution::GaussianDistribution d1("0 0 0", "1.0 0.2 0.0; 0.2 1.0 0.1;"
+      " 0.0 0.1 1.0");
+  distribution::GaussianDistribution d2("4 4 0", "2.0 0.0 0.3; 0.0 1.0 0.0;"
+      " 0.3 0.0 1.5");
+  distribution::GaussianDistribution d3("0 4 4", "1.0 0.0 0.0; 0.0 0.5 0.0;"
+      " 0.0 0.0 2.0");
+  arma::mat data(3, 5000);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (i % 3 == 0)
+      data.col(i) = d1.Random();
+    else if (i % 3 == 1)
+      data.col(i) = d2.Random();
+    else
+      data.col(i) = d3.Random();
+  }
+  arma::vec probabilities(data.n_cols, arma::fill::randu);
+
+  // Start all runs from the same model, so that they are deterministic.
+  std::vector<distribution::GaussianDistribution> initialDists;
+  initialDists.push_back(distribution::GaussianDistribution("1 1 1",
+      "1 0 0; 0 1 0; 0 0 1"));
+  initialDists.push_back(distribution::GaussianDistribution("3 3 1",
+      "1 0 0; 0 1 0; 0 0 1"));
+  initialDists.push_back(distribution::GaussianDistribution("1 3 3",
+      "1 0 0; 0 1 0; 0 0 1"));
+  const arma::vec initialWeights("0.3 0.3 0.4");
+
+  EMFit<> em(20, 1e-10);
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  std::vector<distribution::GaussianDistribution> dists(initialDists);
+  arma::vec weights(initialWeights);
+  em.Estimate(data, dists, weights, true);
+  std::vector<distribution::GaussianDistribution> probDists(initialDists);
+  arma::vec probWeights(initialWeights);
+  em.Estimate(data, probabilities, probDists, probWeights, true);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  std::vector<distribution::GaussianDistribution> parDists(initialDists);
+  arma::vec parWeights(initialWeights);
+  em.Estimate(data, parDists, parWeights, true);
+  std::vector<distribution::GaussianDistribution> parProbDists(initialDists);
+  arma::vec parProbWeights(initialWeights);
+  em.Estimate(data, probabilities, parProbDists, parProbWeights, true);
+
+  omp_set_num_threads(prevNumThreads);
+
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    BOOST_REQUIRE_CLOSE(weights[i], parWeights[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(probWeights[i], parProbWeights[i], 1e-5);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(dists[i].Mean()[j], parDists[i].Mean()[j], 1e-5);
+      BOOST_REQUIRE_CLOSE(probDists[i].Mean()[j], parProbDists[i].Mean()[j],
+          1e-5);
+    }
+    for (size_t j = 0; j < 9; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(dists[i].Covariance()[j],
+          parDists[i].Covariance()[j], 1e-5);
+      BOOST_REQUIRE_CLOSE(probDists[i].Covariance()[j],
+          parProbDists[i].Covariance()[j], 1e-5);
+    }
+  }
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -10,7 +10,9 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/hmm/hmm.hpp>
+#include <mlpack/methods/hmm/sparse_hmm.hpp>
 #include <mlpack/methods/gmm/gmm.hpp>
+#include <mlpack/methods/gmm/diagonal_gmm.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -1122,6 +1124,72 @@ BOOST_AUTO_TEST_CASE(GMMHMMLoadSaveTest)
   }
 }
 
+/**
+ * Make sure an HMM with diagonal GMM emissions gives the same log-likelihood
+ * and Viterbi path as an HMM with GMM emissions with the same diagonal
+ * covariances, and that it can be saved and loaded.
+ */
+BOOST_AUTO_TEST_CASE(DiagonalGMMHMMTest)
+{
+  HMM<DiagonalGMM> hmm(3, DiagonalGMM(2, 4));
+  HMM<GMM> fullHMM(3, GMM(2, 4));
+  hmm.Transition() = arma::mat("0.8 0.1 0.2; 0.1 0.7 0.1; 0.1 0.2 0.7");
+  fullHMM.Transition() = hmm.Transition();
+  for (size_t j = 0; j < hmm.Emission().size(); ++j)
+  {
+    hmm.Emission()[j].Weights() = arma::vec("0.4 0.6");
+    fullHMM.Emission()[j].Weights() = hmm.Emission()[j].Weights();
+    for (size_t i = 0; i < hmm.Emission()[j].Gaussians(); ++i)
+    {
+      DiagonalGaussianDistribution& d = hmm.Emission()[j].Component(i);
+      d.Mean() = 3.0 * j + arma::randu<arma::vec>(4);
+      d.Covariance(arma::vec(arma::randu<arma::vec>(4) + 0.5));
+      fullHMM.Emission()[j].Component(i).Mean() = d.Mean();
+      fullHMM.Emission()[j].Component(i).Covariance(
+          arma::diagmat(d.Covariance()));
+    }
+  }
+
+  arma::mat observations;
+  arma::Row<size_t> states;
+  hmm.Generate(200, observations, states);
+
+  arma::Row<size_t> path, fullPath;
+  const double logLikelihood = hmm.LogLikelihood(observations);
+  BOOST_REQUIRE_CLOSE(logLikelihood, fullHMM.LogLikelihood(observations),
+      1e-5);
+  hmm.Predict(observations, path);
+  fullHMM.Predict(observations, fullPath);
+  for (size_t t = 0; t < path.n_elem; ++t)
+    BOOST_REQUIRE_EQUAL(path[t], fullPath[t]);
+
+  // Save and load the HMM.
+  {
+    std::ofstream ofs("test-hmm-save.xml");
+    boost::archive::xml_oarchive ar(ofs);
+    ar << BOOST_SERIALIZATION_NVP(hmm);
+  }
+
+  HMM<DiagonalGMM> hmm2(3, DiagonalGMM(2, 4));
+  {
+    std::ifstream ifs("test-hmm-save.xml");
+    boost::archive::xml_iarchive ar(ifs);
+    ar >> BOOST_SERIALIZATION_NVP(hmm2);
+  }
+
+  // Remove clutter.
+  remove("test-hmm-save.xml");
+
+  BOOST_REQUIRE_CLOSE(hmm2.LogLikelihood(observations), logLikelihood, 1e-5);
+
+  // Training on labeled data should work too.
+  std::vector<arma::mat> observationSeqs(1, observations);
+  std::vector<arma::Row<size_t>> stateSeqs(1, states);
+  hmm2.Train(observationSeqs, stateSeqs);
+  BOOST_REQUIRE_EQUAL(hmm2.Emission()[0].Gaussians(), (size_t) 2);
+  BOOST_REQUIRE_EQUAL(hmm2.Emission()[0].Dimensionality(), (size_t) 4);
+}
+
 /**
  * Test saving and loading of Gaussian HMMs
  */
@@ -1228,5 +1296,193 @@ BOOST_AUTO_TEST_CASE(DiscreteHMMLoadSaveTest)
           hmm2.Emission()[j].Probabilities()[i], 1e-3);
 }
 
+/**
+ * Make sure that the checkpointed Viterbi algorithm gives the same state
+ * sequence and log-likelihood as Predict(), for several checkpoint intervals.
+ */
+BOOST_AUTO_TEST_CASE(CheckpointedViterbiTest)
+{
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(GaussianDistribution("0.0 0.0", "1.0 0.2; 0.2 1.5"));
+  emission.push_back(GaussianDistribution("1.5 1.0", "0.7 0.3; 0.3 2.6"));
+  emission.push_back(GaussianDistribution("1.0 2.0", "1.0 0.0; 0.0 1.0"));
+  arma::mat transition("0.5 0.3 0.2;"
+                       "0.3 0.6 0.1;"
+                       "0.2 0.1 0.7");
+  HMM<GaussianDistribution> hmm(arma::vec("0.4 0.3 0.3"), transition,
+      emission);
+
+  arma::mat observations;
+  arma::Row<size_t> states;
+  hmm.Generate(1003, observations, states);
+
+  arma::Row<size_t> predicted;
+  const double logLikelihood = hmm.Predict(observations, predicted);
+
+  const size_t intervals[] = { 0, 1, 2, 7, 32, 1003, 5000 };
+  for (size_t i = 0; i < 7; ++i)
+  {
+    arma::Row<size_t> checkpointed;
+    const double checkpointedLogLikelihood = hmm.PredictCheckpointed(
+        observations, checkpointed, intervals[i]);
+
+    BOOST_REQUIRE_CLOSE(checkpointedLogLikelihood, logLikelihood, 1e-10);
+    BOOST_REQUIRE_EQUAL(checkpointed.n_elem, predicted.n_elem);
+    for (size_t t = 0; t < predicted.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL((size_t) checkpointed[t], (size_t) predicted[t]);
+  }
+}
+
+/**
+ * Make sure that a SparseHMM gives the same results as an HMM with the same
+ * (dense) transition matrix, and that Baum-Welch training keeps the sparsity
+ * structure of the transition matrix.
+ */
+BOOST_AUTO_TEST_CASE(SparseHMMTest)
+{
+  // A left-to-right model with a loop back to the first state.
+  const size_t states = 6;
+  arma::sp_mat transition(states, states);
+  std::vector<GaussianDistribution> emission;
+  for (size_t i = 0; i < states; ++i)
+  {
+    transition(i, i) = 0.6;
+    transition((i + 1) % states, i) = 0.3;
+    transition((i + 2) % states, i) = 0.1;
+    emission.push_back(GaussianDistribution(
+        arma::vec(2, arma::fill::ones) * (double) i,
+        arma::eye<arma::mat>(2, 2)));
+  }
+  arma::vec initial(states, arma::fill::zeros);
+  initial[0] = 1.0;
+
+  SparseHMM<GaussianDistribution> sparseHmm(initial, transition, emission);
+  HMM<GaussianDistribution> hmm(initial, arma::mat(transition), emission);
+
+  std::vector<arma::mat> observations(20);
+  arma::Row<size_t> states1;
+  for (size_t i = 0; i < observations.size(); ++i)
+    sparseHmm.Generate(200, observations[i], states1);
+
+  // The generated state sequence must only use allowed transitions.
+  for (size_t t = 1; t < states1.n_elem; ++t)
+    BOOST_REQUIRE_GT((double) transition(states1[t], states1[t - 1]), 0.0);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(sparseHmm.LogLikelihood(observations[i]),
+        hmm.LogLikelihood(observations[i]), 1e-5);
+
+    arma::mat stateLogProb, forwardLogProb, backwardLogProb;
+    arma::mat denseStateLogProb, denseForwardLogProb, denseBackwardLogProb;
+    arma::vec logScales, denseLogScales;
+    sparseHmm.LogEstimate(observations[i], stateLogProb, forwardLogProb,
+        backwardLogProb, logScales);
+    hmm.LogEstimate(observations[i], denseStateLogProb, denseForwardLogProb,
+        denseBackwardLogProb, denseLogScales);
+    for (size_t j = 0; j < stateLogProb.n_elem; ++j)
+    {
+      if (std::isfinite(denseStateLogProb[j]))
+      {
+        BOOST_REQUIRE_SMALL(exp(stateLogProb[j]) - exp(denseStateLogProb[j]),
+            1e-8);
+      }
+      else
+      {
+        BOOST_REQUIRE(!std::isfinite(stateLogProb[j]));
+      }
+    }
+
+    arma::Row<size_t> predicted, densePredicted;
+    BOOST_REQUIRE_CLOSE(sparseHmm.Predict(observations[i], predicted),
+        hmm.Predict(observations[i], densePredicted), 1e-5);
+    for (size_t t = 0; t < predicted.n_elem; ++t)
+      BOOST_REQUIRE_EQUAL((size_t) predicted[t], (size_t) densePredicted[t]);
+  }
+
+  // Train both models from a perturbed start.
+  for (size_t i = 0; i < states; ++i)
+  {
+    sparseHmm.Emission()[i].Mean() += 0.2;
+    hmm.Emission()[i].Mean() += 0.2;
+  }
+  const double sparseLoglik = sparseHmm.Train(observations);
+  const double denseLoglik = hmm.Train(observations);
+
+  BOOST_REQUIRE_CLOSE(sparseLoglik, denseLoglik, 1e-3);
+  BOOST_REQUIRE_LE(sparseHmm.Transition().n_nonzero, transition.n_nonzero);
+  for (size_t i = 0; i < states; ++i)
+  {
+    for (size_t j = 0; j < states; ++j)
+    {
+      const double value = sparseHmm.Transition()(i, j);
+      if ((double) transition(i, j) == 0.0)
+        BOOST_REQUIRE_EQUAL(value, 0.0);
+      else
+        BOOST_REQUIRE_SMALL(value - hmm.Transition()(i, j), 1e-3);
+    }
+  }
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that Baum-Welch training on many sequences of different lengths
+ * gives the same model with one thread and with several threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelBaumWelchTest)
+{
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(GaussianDistribution("0.0 0.0", "1.0 0.2; 0.2 1.5"));
+  emission.push_back(GaussianDistribution("4.0 1.0", "0.7 0.3; 0.3 2.6"));
+  emission.push_back(GaussianDistribution("1.0 5.0", "1.0 0.0; 0.0 1.0"));
+  arma::mat transition("0.5 0.3 0.2;"
+                       "0.3 0.6 0.1;"
+                       "0.2 0.1 0.7");
+  HMM<GaussianDistribution> trueHmm(arma::vec("0.4 0.3 0.3"), transition,
+      emission);
+
+  std::vector<arma::mat> observations(300);
+  arma::Row<size_t> states;
+  for (size_t i = 0; i < observations.size(); ++i)
+    trueHmm.Generate(10 + math::RandInt(90), observations[i], states);
+
+  // Start both models from the same perturbed model.
+  HMM<GaussianDistribution> initialHmm(trueHmm);
+  initialHmm.Transition() = arma::mat("0.4 0.3 0.3;"
+                                      "0.3 0.4 0.3;"
+                                      "0.3 0.3 0.4");
+  for (size_t j = 0; j < 3; ++j)
+    initialHmm.Emission()[j].Mean() += 0.5;
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  HMM<GaussianDistribution> hmm1(initialHmm);
+  const double loglik1 = hmm1.Train(observations);
+
+  omp_set_num_threads(4);
+  HMM<GaussianDistribution> hmm4(initialHmm);
+  const double loglik4 = hmm4.Train(observations);
+
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_CLOSE(loglik1, loglik4, 1e-5);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE_SMALL(hmm1.Initial()[i] - hmm4.Initial()[i], 1e-4);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      BOOST_REQUIRE_SMALL(hmm1.Transition()(i, j) - hmm4.Transition()(i, j),
+          1e-4);
+    }
+    for (size_t d = 0; d < 2; ++d)
+    {
+      BOOST_REQUIRE_SMALL(hmm1.Emission()[i].Mean()[d] -
+          hmm4.Emission()[i].Mean()[d], 1e-4);
+    }
+  }
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
 
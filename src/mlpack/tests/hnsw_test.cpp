@@ -0,0 +1,308 @@
+/**
+ * @file hnsw_test.cpp
+ *
+ * Unit tests for the 'HNSWSearch' class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/metrics/lmetric.hpp>
+#include <mlpack/core/metrics/ip_metric.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+#include <mlpack/methods/hnsw/hnsw_search.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+using namespace std;
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(HNSWTest);
+
+/**
+ * Make sure that the recall against exact kNN is high on high-dimensional
+ * data, and that it increases with efSearch.
+ */
+BOOST_AUTO_TEST_CASE(HNSWRecallTest)
+{
+  arma::mat rdata = arma::randn<arma::mat>(50, 3000);
+  arma::mat qdata = arma::randn<arma::mat>(50, 200);
+
+  KNN knn(rdata);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(qdata, 10, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(rdata, 16, 200, 10);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(qdata, 10, neighbors, distances);
+  const double lowRecall = HNSWSearch<>::ComputeRecall(neighbors,
+      trueNeighbors);
+
+  hnsw.EfSearch() = 200;
+  hnsw.Search(qdata, 10, neighbors, distances);
+  const double highRecall = HNSWSearch<>::ComputeRecall(neighbors,
+      trueNeighbors);
+
+  BOOST_REQUIRE_GE(highRecall, lowRecall);
+  BOOST_REQUIRE_GT(highRecall, 0.95);
+
+  // The distances are sorted, and correct.
+  for (size_t i = 0; i < qdata.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 10; ++j)
+    {
+      if (j > 0)
+        BOOST_REQUIRE_LE(distances(j - 1, i), distances(j, i));
+      BOOST_REQUIRE_CLOSE(distances(j, i), metric::EuclideanDistance::Evaluate(
+          qdata.col(i), rdata.col(neighbors(j, i))), 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that the graph has the expected structure: no point has more
+ * links than allowed, links point to points of the same level, and the entry
+ * point is on the top level.
+ */
+BOOST_AUTO_TEST_CASE(HNSWGraphStructureTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(5, 2000);
+  HNSWSearch<> hnsw(rdata, 6, 50, 50);
+
+  BOOST_REQUIRE_EQUAL(hnsw.Levels().size(), rdata.n_cols);
+  BOOST_REQUIRE_EQUAL(hnsw.Levels()[hnsw.EntryPoint()], hnsw.MaxLevel());
+  BOOST_REQUIRE_GT(hnsw.MaxLevel(), 0);
+
+  for (size_t i = 0; i < rdata.n_cols; ++i)
+  {
+    BOOST_REQUIRE_LE(hnsw.Levels()[i], hnsw.MaxLevel());
+    for (size_t l = 0; l <= hnsw.Levels()[i]; ++l)
+    {
+      const arma::Col<size_t> links = hnsw.Neighbors(i, l);
+      BOOST_REQUIRE_LE(links.n_elem, (l == 0) ? 12 : 6);
+      if (l == 0)
+        BOOST_REQUIRE_GT(links.n_elem, 0);
+
+      for (size_t j = 0; j < links.n_elem; ++j)
+      {
+        BOOST_REQUIRE_NE(links[j], i);
+        BOOST_REQUIRE_GE(hnsw.Levels()[links[j]], l);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that the monochromatic search doesn't return the query points
+ * themselves, and that each point is found when it is searched for.
+ */
+BOOST_AUTO_TEST_CASE(HNSWMonochromaticTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(4, 1000);
+  HNSWSearch<> hnsw(rdata);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(5, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 1000);
+  for (size_t i = 0; i < rdata.n_cols; ++i)
+    for (size_t j = 0; j < 5; ++j)
+      BOOST_REQUIRE_NE(neighbors(j, i), i);
+
+  KNN knn(rdata);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(5, trueNeighbors, trueDistances);
+  BOOST_REQUIRE_GT(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors),
+      0.95);
+
+  hnsw.Search(rdata, 1, neighbors, distances);
+  for (size_t i = 0; i < rdata.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors(0, i), i);
+    BOOST_REQUIRE_SMALL(distances(0, i), 1e-5);
+  }
+}
+
+/**
+ * Make sure that points inserted into a built graph are found, and that the
+ * recall after the insertions is as good as with a graph built at once.
+ */
+BOOST_AUTO_TEST_CASE(HNSWInsertTest)
+{
+  arma::mat rdata = arma::randn<arma::mat>(20, 2000);
+  arma::mat qdata = arma::randn<arma::mat>(20, 100);
+
+  HNSWSearch<> hnsw(rdata.cols(0, 499));
+  for (size_t i = 500; i < rdata.n_cols; i += 500)
+    hnsw.Insert(rdata.cols(i, i + 499));
+
+  BOOST_REQUIRE_EQUAL(hnsw.ReferenceSet().n_cols, rdata.n_cols);
+  CheckMatrices(hnsw.ReferenceSet(), rdata);
+  BOOST_REQUIRE_EQUAL(hnsw.Levels().size(), rdata.n_cols);
+
+  // Each inserted point is its own nearest neighbor.
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  hnsw.Search(rdata.cols(1500, 1999), 1, neighbors, distances);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors(0, i), 1500 + i);
+    BOOST_REQUIRE_SMALL(distances(0, i), 1e-5);
+  }
+
+  KNN knn(rdata);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(qdata, 5, trueNeighbors, trueDistances);
+  hnsw.Search(qdata, 5, neighbors, distances);
+  BOOST_REQUIRE_GT(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors),
+      0.95);
+
+  // Inserting into an untrained model trains it.
+  HNSWSearch<> empty;
+  empty.Insert(rdata);
+  empty.Search(qdata, 5, neighbors, distances);
+  BOOST_REQUIRE_GT(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors),
+      0.95);
+
+  arma::mat wrongData = arma::randu<arma::mat>(3, 10);
+  BOOST_REQUIRE_THROW(hnsw.Insert(wrongData), std::invalid_argument);
+}
+
+/**
+ * Make sure that the graph can be built and searched with the metric induced
+ * by a kernel.  With the linear kernel, this is the Euclidean distance.
+ */
+BOOST_AUTO_TEST_CASE(HNSWIPMetricTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(10, 1000);
+  arma::mat qdata = arma::randu<arma::mat>(10, 100);
+
+  kernel::LinearKernel kernel;
+  metric::IPMetric<kernel::LinearKernel> metric(kernel);
+  HNSWSearch<metric::IPMetric<kernel::LinearKernel>> hnsw(rdata, 16, 200, 100,
+      metric);
+
+  KNN knn(rdata);
+  arma::Mat<size_t> trueNeighbors, neighbors;
+  arma::mat trueDistances, distances;
+  knn.Search(qdata, 5, trueNeighbors, trueDistances);
+  hnsw.Search(qdata, 5, neighbors, distances);
+
+  BOOST_REQUIRE_GT(HNSWSearch<>::ComputeRecall(neighbors, trueNeighbors),
+      0.95);
+}
+
+/**
+ * Make sure that the number of threads doesn't change the quality of the
+ * graph.
+ */
+BOOST_AUTO_TEST_CASE(HNSWThreadsTest)
+{
+  arma::mat rdata = arma::randn<arma::mat>(20, 2000);
+  arma::mat qdata = arma::randn<arma::mat>(20, 100);
+
+  KNN knn(rdata);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(qdata, 5, trueNeighbors, trueDistances);
+
+  const size_t numThreads = NumThreads();
+  SetNumThreads(1);
+  math::RandomSeed(12);
+  HNSWSearch<> serialHNSW(rdata);
+  SetNumThreads(numThreads);
+
+  math::RandomSeed(12);
+  HNSWSearch<> parallelHNSW(rdata);
+
+  // The levels only depend on the random seed.
+  BOOST_REQUIRE(serialHNSW.Levels() == parallelHNSW.Levels());
+  BOOST_REQUIRE_EQUAL(serialHNSW.MaxLevel(), parallelHNSW.MaxLevel());
+
+  arma::Mat<size_t> serialNeighbors, parallelNeighbors;
+  arma::mat serialDistances, parallelDistances;
+  serialHNSW.Search(qdata, 5, serialNeighbors, serialDistances);
+  parallelHNSW.Search(qdata, 5, parallelNeighbors, parallelDistances);
+
+  BOOST_REQUIRE_GT(HNSWSearch<>::ComputeRecall(serialNeighbors,
+      trueNeighbors), 0.95);
+  BOOST_REQUIRE_GT(HNSWSearch<>::ComputeRecall(parallelNeighbors,
+      trueNeighbors), 0.95);
+}
+
+/**
+ * Make sure invalid parameters and queries are rejected.
+ */
+BOOST_AUTO_TEST_CASE(HNSWExceptionTest)
+{
+  BOOST_REQUIRE_THROW(HNSWSearch<>(1), std::invalid_argument);
+
+  arma::mat rdata = arma::randu<arma::mat>(3, 10);
+  HNSWSearch<> hnsw(rdata);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  arma::mat qdata = arma::randu<arma::mat>(4, 10);
+  BOOST_REQUIRE_THROW(hnsw.Search(qdata, 2, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(hnsw.Search(rdata, 11, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(hnsw.Search(10, neighbors, distances),
+      std::invalid_argument);
+
+  // All the points are found in a small set.
+  hnsw.Search(rdata, 10, neighbors, distances);
+  for (size_t i = 0; i < rdata.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(arma::sort(neighbors.col(i)).eval()[9], 9);
+
+  HNSWSearch<> untrained;
+  BOOST_REQUIRE_THROW(untrained.Search(qdata, 2, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure a serialized model gives the same results.
+ */
+BOOST_AUTO_TEST_CASE(HNSWSerializationTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(5, 500);
+  arma::mat qdata = arma::randu<arma::mat>(5, 50);
+
+  HNSWSearch<> hnsw(rdata, 8, 100, 30);
+  HNSWSearch<> xmlHNSW;
+  HNSWSearch<> textHNSW(arma::randu<arma::mat>(5, 20));
+  HNSWSearch<> binaryHNSW(arma::randu<arma::mat>(3, 100), 4);
+
+  SerializeObjectAll(hnsw, xmlHNSW, textHNSW, binaryHNSW);
+
+  CheckMatrices(hnsw.ReferenceSet(), xmlHNSW.ReferenceSet(),
+      textHNSW.ReferenceSet(), binaryHNSW.ReferenceSet());
+  BOOST_REQUIRE_EQUAL(xmlHNSW.M(), 8);
+  BOOST_REQUIRE_EQUAL(textHNSW.EfConstruction(), 100);
+  BOOST_REQUIRE_EQUAL(binaryHNSW.EfSearch(), 30);
+  BOOST_REQUIRE(hnsw.Levels() == binaryHNSW.Levels());
+  BOOST_REQUIRE_EQUAL(hnsw.EntryPoint(), xmlHNSW.EntryPoint());
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  hnsw.Search(qdata, 3, neighbors, distances);
+  xmlHNSW.Search(qdata, 3, xmlNeighbors, xmlDistances);
+  textHNSW.Search(qdata, 3, textNeighbors, textDistances);
+  binaryHNSW.Search(qdata, 3, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
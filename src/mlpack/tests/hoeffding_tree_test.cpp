@@ -15,6 +15,7 @@
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_categorical_split.hpp>
 #include <mlpack/methods/hoeffding_trees/binary_numeric_split.hpp>
+#include <mlpack/methods/hoeffding_trees/quantile_numeric_split.hpp>
 #include <mlpack/methods/hoeffding_trees/hoeffding_tree_model.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -1462,4 +1463,262 @@ BOOST_AUTO_TEST_CASE(HoeffdingTreeModelSerializationTest)
   }
 }
 
+/**
+ * Training on mini-batches of one point should give the same tree as training
+ * on each point.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingTreeMiniBatchSinglePointTest)
+{
+  arma::mat dataset(3, 5000, arma::fill::randu);
+  arma::Row<size_t> labels(5000);
+  for (size_t i = 0; i < 5000; ++i)
+    labels[i] = (dataset(0, i) > 0.5) + 2 * (dataset(1, i) > 0.5);
+
+  typedef HoeffdingTree<GiniImpurity, HoeffdingDoubleNumericSplit> TreeType;
+  data::DatasetInfo info(3);
+  TreeType streamTree(info, 4);
+  TreeType miniBatchTree(info, 4);
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    streamTree.Train(dataset.col(i), labels[i]);
+
+    const arma::mat batch = dataset.cols(i, i);
+    const arma::Row<size_t> batchLabels = labels.cols(i, i);
+    miniBatchTree.TrainMiniBatch(batch, batchLabels);
+  }
+
+  BOOST_REQUIRE_EQUAL(streamTree.NumDescendants(),
+      miniBatchTree.NumDescendants());
+
+  arma::Row<size_t> streamPredictions, miniBatchPredictions;
+  arma::rowvec streamProbabilities, miniBatchProbabilities;
+  streamTree.Classify(dataset, streamPredictions, streamProbabilities);
+  miniBatchTree.Classify(dataset, miniBatchPredictions,
+      miniBatchProbabilities);
+
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(streamPredictions[i], miniBatchPredictions[i]);
+    BOOST_REQUIRE_CLOSE(streamProbabilities[i], miniBatchProbabilities[i],
+        1e-5);
+  }
+}
+
+/**
+ * Make sure that a tree trained on mini-batches learns an easy dataset.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingTreeMiniBatchTest)
+{
+  arma::mat dataset(3, 10000, arma::fill::randu);
+  arma::Row<size_t> labels(10000);
+  for (size_t i = 0; i < 10000; ++i)
+    labels[i] = (dataset(0, i) > 0.5) ? 1 : 0;
+
+  typedef HoeffdingTree<GiniImpurity, HoeffdingDoubleNumericSplit> TreeType;
+  data::DatasetInfo info(3);
+  TreeType tree(info, 2);
+  for (size_t i = 0; i < 10000; i += 1000)
+  {
+    const arma::mat batch = dataset.cols(i, i + 999);
+    const arma::Row<size_t> batchLabels = labels.cols(i, i + 999);
+    tree.TrainMiniBatch(batch, batchLabels);
+  }
+
+  BOOST_REQUIRE_GT(tree.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(tree.SplitDimension(), 0);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset, predictions);
+  const size_t correct = arma::accu(predictions == labels);
+  BOOST_REQUIRE_GT(correct, 9000);
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Training on mini-batches with several threads should give the same tree as
+ * with one thread.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingTreeParallelMiniBatchTest)
+{
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  arma::mat dataset(5, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < 20000; ++i)
+    labels[i] = (dataset(0, i) > 0.5) + 2 * (dataset(3, i) > 0.3);
+
+  typedef HoeffdingTree<GiniImpurity, HoeffdingDoubleNumericSplit> TreeType;
+  data::DatasetInfo info(5);
+  TreeType tree1(info, 4);
+  TreeType tree2(info, 4);
+  for (size_t i = 0; i < 20000; i += 500)
+  {
+    const arma::mat batch = dataset.cols(i, i + 499);
+    const arma::Row<size_t> batchLabels = labels.cols(i, i + 499);
+
+    omp_set_num_threads(1);
+    tree1.TrainMiniBatch(batch, batchLabels);
+
+    // Force multiple threads, even if only one core is available.
+    omp_set_num_threads(4);
+    tree2.TrainMiniBatch(batch, batchLabels);
+  }
+
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_EQUAL(tree1.NumDescendants(), tree2.NumDescendants());
+
+  arma::Row<size_t> predictions1, predictions2;
+  tree1.Classify(dataset, predictions1);
+  tree2.Classify(dataset, predictions2);
+  for (size_t i = 0; i < 20000; ++i)
+    BOOST_REQUIRE_EQUAL(predictions1[i], predictions2[i]);
+}
+#endif
+
+/**
+ * Make sure that the quantile numeric split never holds more bins than its
+ * maximum, and that it still finds the right split point.
+ */
+BOOST_AUTO_TEST_CASE(QuantileNumericSplitBoundedTest)
+{
+  QuantileNumericSplit<GiniImpurity> split(2, 16);
+
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    const double value = mlpack::math::Random();
+    split.Train(value, (value < 0.3) ? 0 : 1);
+    BOOST_REQUIRE_LE(split.NumBins(), 16);
+  }
+  BOOST_REQUIRE_EQUAL(split.NumBins(), 16);
+  BOOST_REQUIRE_EQUAL(split.MajorityClass(), 1);
+
+  double bestGain, secondBestGain;
+  split.EvaluateFitnessFunction(bestGain, secondBestGain);
+  BOOST_REQUIRE_GT(bestGain, 0.0);
+  BOOST_REQUIRE_EQUAL(secondBestGain, 0.0);
+
+  arma::Col<size_t> childMajorities;
+  QuantileNumericSplit<GiniImpurity>::SplitInfo splitInfo;
+  split.Split(childMajorities, splitInfo);
+
+  BOOST_REQUIRE_EQUAL(childMajorities.n_elem, 2);
+  BOOST_REQUIRE_EQUAL(childMajorities[0], 0);
+  BOOST_REQUIRE_EQUAL(childMajorities[1], 1);
+
+  // The split should be near 0.3, up to the resolution of the bins.
+  BOOST_REQUIRE_EQUAL(splitInfo.CalculateDirection(0.2), 0);
+  BOOST_REQUIRE_EQUAL(splitInfo.CalculateDirection(0.4), 1);
+}
+
+/**
+ * A tree with quantile numeric splits should learn a simple problem with a
+ * numeric and a categorical feature.
+ */
+BOOST_AUTO_TEST_CASE(QuantileNumericHoeffdingTreeTest)
+{
+  arma::mat dataset(2, 9000);
+  arma::Row<size_t> labels(9000);
+  data::DatasetInfo info(2); // The second feature is categorical.
+  info.MapString<double>("0", 1);
+  info.MapString<double>("1", 1);
+  for (size_t i = 0; i < 9000; ++i)
+  {
+    dataset(0, i) = mlpack::math::Random();
+    dataset(1, i) = mlpack::math::RandInt(2);
+    labels[i] = (dataset(0, i) < 0.6) ? 0 : 1;
+  }
+
+  typedef HoeffdingTree<GiniImpurity, QuantileDoubleNumericSplit> TreeType;
+  TreeType tree(info, 2);
+  for (size_t i = 0; i < 9000; ++i)
+    tree.Train(dataset.col(i), labels[i]);
+
+  BOOST_REQUIRE_GT(tree.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(tree.SplitDimension(), 0);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset, predictions);
+  BOOST_REQUIRE_GT(arma::accu(predictions == labels), 8550);
+}
+
+/**
+ * The leaf budget should hold in streaming and batch training, and the tree
+ * should still give good predictions.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingTreeLeafBudgetTest)
+{
+  arma::mat dataset(5, 30000, arma::fill::randu);
+  arma::Row<size_t> labels(30000);
+  for (size_t i = 0; i < 30000; ++i)
+    labels[i] = (dataset(0, i) > 0.5) + 2 * (dataset(3, i) > 0.3);
+
+  data::DatasetInfo info(5);
+  HoeffdingTree<> tree(info, 4, 0.95, 0, 100, 100);
+  tree.MaxActiveLeaves(2);
+  for (size_t i = 0; i < 30000; ++i)
+  {
+    tree.Train(dataset.col(i), labels[i]);
+
+    // The budget is enforced every CheckInterval() points.
+    if ((i + 1) % 100 == 0)
+      BOOST_REQUIRE_LE(tree.NumActiveLeaves(), 2);
+  }
+
+  BOOST_REQUIRE_GT(tree.NumDescendants(), 3);
+
+  // The tree should do better than the majority class (35%).
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset, predictions);
+  BOOST_REQUIRE_GT(arma::accu(predictions == labels), 13500);
+
+  // Removing the budget should reactivate every leaf.
+  tree.MaxActiveLeaves(0);
+  BOOST_REQUIRE_GT(tree.NumActiveLeaves(), 2);
+
+  // Mini-batch training should also respect the budget.
+  HoeffdingTree<> batchTree(info, 4);
+  batchTree.MaxActiveLeaves(3);
+  for (size_t i = 0; i < 30000; i += 1000)
+  {
+    batchTree.TrainMiniBatch(dataset.cols(i, i + 999),
+        labels.cols(i, i + 999));
+    BOOST_REQUIRE_LE(batchTree.NumActiveLeaves(), 3);
+  }
+}
+
+/**
+ * Make sure that the leaf budget survives serialization, and that inactive
+ * leaves are restored as inactive.
+ */
+BOOST_AUTO_TEST_CASE(HoeffdingTreeLeafBudgetSerializationTest)
+{
+  arma::mat dataset(5, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < 20000; ++i)
+    labels[i] = (dataset(0, i) > 0.5) + 2 * (dataset(3, i) > 0.3);
+
+  data::DatasetInfo info(5);
+  HoeffdingTree<> tree(info, 4);
+  tree.MaxActiveLeaves(2);
+  for (size_t i = 0; i < 20000; ++i)
+    tree.Train(dataset.col(i), labels[i]);
+
+  HoeffdingTree<> xmlTree, textTree, binaryTree;
+  SerializeObjectAll(tree, xmlTree, textTree, binaryTree);
+
+  BOOST_REQUIRE_EQUAL(xmlTree.MaxActiveLeaves(), 2);
+  BOOST_REQUIRE_EQUAL(textTree.MaxActiveLeaves(), 2);
+  BOOST_REQUIRE_EQUAL(binaryTree.MaxActiveLeaves(), 2);
+  BOOST_REQUIRE_EQUAL(xmlTree.NumActiveLeaves(), tree.NumActiveLeaves());
+  BOOST_REQUIRE_EQUAL(textTree.NumActiveLeaves(), tree.NumActiveLeaves());
+  BOOST_REQUIRE_EQUAL(binaryTree.NumActiveLeaves(), tree.NumActiveLeaves());
+
+  arma::Row<size_t> predictions, xmlPredictions;
+  tree.Classify(dataset, predictions);
+  xmlTree.Classify(dataset, xmlPredictions);
+  for (size_t i = 0; i < 20000; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], xmlPredictions[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,7 @@
 
 #include <mlpack/core/cv/metrics/mse.hpp>
 #include <mlpack/core/cv/metrics/accuracy.hpp>
+#include <mlpack/core/cv/k_fold_cv.hpp>
 #include <mlpack/core/cv/simple_cv.hpp>
 #include <mlpack/core/hpt/cv_function.hpp>
 #include <mlpack/core/hpt/fixed.hpp>
@@ -120,10 +121,12 @@ class QuadraticFunction
                     double xMin = 0.0,
                     double yMin = 0.0,
                     double zMin = 0.0) :
-      a(a), b(b), c(c), d(d), xMin(xMin), yMin(yMin), zMin(zMin) {}
+      a(a), b(b), c(c), d(d), xMin(xMin), yMin(yMin), zMin(zMin),
+      evaluations(0) {}
 
   double Evaluate(double x, double y, double z)
   {
+    ++evaluations;
     return a * pow(x - xMin, 2)  + b * pow(y - yMin, 2) + c * pow(z - zMin, 2)
         + d;
   }
@@ -135,8 +138,12 @@ class QuadraticFunction
     return MLAlgorithm();
   }
 
+  //! Get the number of times Evaluate() has been called.
+  size_t Evaluations() const { return evaluations; }
+
  private:
   double a, b, c, d, xMin, yMin, zMin;
+  size_t evaluations;
 };
 
 /**
@@ -179,6 +186,27 @@ BOOST_AUTO_TEST_CASE(CVFunctionGradientTest)
   BOOST_REQUIRE_CLOSE(gradient(2), aproximateZPartialDerivative, 1e-5);
 }
 
+/**
+ * Test CVFunction does not cross-validate the same parameters twice.
+ */
+BOOST_AUTO_TEST_CASE(CVFunctionCacheTest)
+{
+  QuadraticFunction<LARS> lf(1.0, -1.5, 2.5, 3.0);
+
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 3);
+  CVFunction<decltype(lf), LARS, 3> cvFun(lf, datasetInfo, 0.01, 0.001);
+
+  const double objective = cvFun.Evaluate(arma::vec("0.0 -1.0 2.0"));
+  BOOST_REQUIRE_EQUAL(lf.Evaluations(), 1);
+
+  BOOST_REQUIRE_EQUAL(cvFun.Evaluate(arma::vec("0.0 -1.0 2.0")), objective);
+  BOOST_REQUIRE_EQUAL(lf.Evaluations(), 1);
+
+  cvFun.Evaluate(arma::vec("0.0 -1.0 3.0"));
+  BOOST_REQUIRE_EQUAL(lf.Evaluations(), 2);
+}
+
 
 void InitProneToOverfittingData(arma::mat& xs,
                                 arma::rowvec& ys,
@@ -402,4 +430,34 @@ BOOST_AUTO_TEST_CASE(HPTGradientDescentTest)
   BOOST_REQUIRE_CLOSE(zOptimized, zMin, 1e-4);
 }
 
+/**
+ * Test HyperParameterTuner with early stopping still returns the objective of a
+ * complete k-fold cross-validation of the best hyper-parameters.
+ */
+BOOST_AUTO_TEST_CASE(HPTEarlyStoppingTest)
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  const size_t k = 5;
+  HyperParameterTuner<LARS, MSE, KFoldCV, GridSearch> hpt(k, xs, ys, false);
+  hpt.EarlyStopping() = true;
+
+  double lambda1, lambda2;
+  std::tie(lambda1, lambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  KFoldCV<LARS, MSE> cv(k, xs, ys, false);
+  const double objective = cv.Evaluate(transposeData, useCholesky, lambda1,
+      lambda2);
+  BOOST_REQUIRE_CLOSE(hpt.BestObjective(), objective, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -266,6 +266,44 @@ BOOST_AUTO_TEST_CASE(ListwiseDeletionTest)
   BOOST_REQUIRE_CLOSE(rowWiseInput(1, 3), 8.0, 1e-5);
 }
 
+/**
+ * Make sure that imputing several dimensions at once gives the same result as
+ * imputing them one by one, for each strategy and both orientations.
+ */
+template<typename StrategyType>
+void CheckMultipleDimensions(StrategyType strategy, const bool columnMajor)
+{
+  // Zeros are the missing values now.
+  arma::mat input = arma::floor(5 * arma::randu<arma::mat>(6, 500));
+  arma::mat expected(input);
+
+  std::vector<size_t> dimensions = { 4, 0, 2 };
+  for (size_t d : dimensions)
+    strategy.Impute(expected, 0.0, d, columnMajor);
+
+  strategy.Impute(input, std::vector<double>(dimensions.size(), 0.0),
+      dimensions, columnMajor);
+
+  BOOST_REQUIRE_EQUAL(input.n_rows, expected.n_rows);
+  BOOST_REQUIRE_EQUAL(input.n_cols, expected.n_cols);
+  for (size_t i = 0; i < input.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(input[i], expected[i], 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(MultipleDimensionImputationTest)
+{
+  for (const bool columnMajor : { true, false })
+  {
+    CheckMultipleDimensions(MeanImputation<double>(), columnMajor);
+    CheckMultipleDimensions(MedianImputation<double>(), columnMajor);
+    CheckMultipleDimensions(CustomImputation<double>(-1.0), columnMajor);
+
+    // Removing the points dimension by dimension gives the same result as
+    // removing them at once.
+    CheckMultipleDimensions(ListwiseDeletion<double>(), columnMajor);
+  }
+}
+
 /**
  * Make sure we can map non-strings.
  */
@@ -314,4 +352,55 @@ BOOST_AUTO_TEST_CASE(DatasetMapperPointerMapping)
   BOOST_REQUIRE_EQUAL(dm.UnmapString(2, 0), &c);
 }
 
+/**
+ * Make sure that mapping strings from ranges of characters gives the same
+ * mappings as mapping std::strings, with enough strings to grow the tables.
+ */
+BOOST_AUTO_TEST_CASE(DatasetMapperCharacterRangeMapping)
+{
+  DatasetInfo info(2);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    const std::string token = "token" + std::to_string((i * 7) % 1000);
+    const size_t dimension = i % 2;
+    const double value = (i % 3 == 0) ?
+        info.MapString<double>(token, dimension) :
+        info.MapString<double>(token.data(), token.data() + token.size(),
+            dimension);
+
+    BOOST_REQUIRE_EQUAL(info.UnmapValue(token, dimension), value);
+    BOOST_REQUIRE_EQUAL(info.UnmapString(value, dimension), token);
+  }
+
+  BOOST_REQUIRE_EQUAL(info.NumMappings(0), 500);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 500);
+  BOOST_REQUIRE_EQUAL(info.UnmapString(0, 0), "token0");
+  BOOST_REQUIRE_EQUAL(info.UnmapString(0, 1), "token7");
+
+  // A numeric dimension is still not mapped.
+  DatasetInfo numeric(1);
+  const std::string number = "2.5";
+  BOOST_REQUIRE_EQUAL(numeric.MapString<double>(number.data(),
+      number.data() + number.size(), 0), 2.5);
+  BOOST_REQUIRE_EQUAL(numeric.NumMappings(0), 0);
+
+  // The mappings of missing values can all be unmapped from NaN.
+  std::set<std::string> missingSet = { "?", "NA" };
+  MissingPolicy policy(missingSet);
+  DatasetMapper<MissingPolicy> missing(policy, 1);
+  const std::string tokens[] = { "?", "NA", "?", "1" };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    missing.MapString<double>(tokens[i].data(),
+        tokens[i].data() + tokens[i].size(), 0);
+  }
+
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  BOOST_REQUIRE_EQUAL(missing.NumMappings(0), 2);
+  BOOST_REQUIRE_EQUAL(missing.NumUnmappings(nan, 0), 2);
+  BOOST_REQUIRE_EQUAL(missing.UnmapString(nan, 0, 0), "?");
+  BOOST_REQUIRE_EQUAL(missing.UnmapString(nan, 0, 1), "NA");
+  BOOST_REQUIRE_THROW(missing.UnmapString(nan, 0, 2), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
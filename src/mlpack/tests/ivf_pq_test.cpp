@@ -0,0 +1,321 @@
+/**
+ * @file ivf_pq_test.cpp
+ *
+ * Tests for the ProductQuantizer and IVFPQSearch classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ivf_pq/ivf_pq_search.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::neighbor;
+
+BOOST_AUTO_TEST_SUITE(IVFPQTest);
+
+/**
+ * Make sure that the asymmetric distance is the squared distance between the
+ * query and the decoded point, and that decoding gives the centroids the
+ * points were encoded with.
+ */
+BOOST_AUTO_TEST_CASE(ProductQuantizerDistanceTest)
+{
+  arma::mat data = arma::randu<arma::mat>(10, 500);
+  arma::mat queries = arma::randu<arma::mat>(10, 20);
+
+  // 10 dimensions in 3 subspaces: the subspaces have 3, 3 and 4 dimensions.
+  ProductQuantizer pq(3, 16);
+  pq.Train(data);
+  BOOST_REQUIRE_EQUAL(pq.Dimensionality(), 10);
+  BOOST_REQUIRE_EQUAL(pq.SubspaceBegin(1), 3);
+  BOOST_REQUIRE_EQUAL(pq.SubspaceBegin(3), 10);
+  BOOST_REQUIRE_EQUAL(pq.Codebook(2).n_rows, 4);
+  BOOST_REQUIRE_EQUAL(pq.Codebook(2).n_cols, 16);
+
+  arma::Mat<unsigned char> codes;
+  pq.Encode(data, codes);
+  BOOST_REQUIRE_EQUAL(codes.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(codes.n_cols, 500);
+  BOOST_REQUIRE_LT(codes.max(), 16);
+
+  arma::mat decoded;
+  pq.Decode(codes, decoded);
+  BOOST_REQUIRE_EQUAL(decoded.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(decoded.n_cols, 500);
+
+  // Each subvector is encoded with its nearest centroid.
+  for (size_t i = 0; i < 500; i += 7)
+  {
+    for (size_t s = 0; s < 3; ++s)
+    {
+      const arma::vec subvector = data.submat(pq.SubspaceBegin(s), i,
+          pq.SubspaceBegin(s + 1) - 1, i);
+      const double encodedDistance = arma::accu(arma::square(subvector -
+          pq.Codebook(s).col(codes(s, i))));
+      for (size_t c = 0; c < 16; ++c)
+      {
+        BOOST_REQUIRE_LE(encodedDistance, arma::accu(arma::square(subvector -
+            pq.Codebook(s).col(c))) + 1e-10);
+      }
+    }
+  }
+
+  arma::mat table;
+  for (size_t q = 0; q < queries.n_cols; ++q)
+  {
+    pq.DistanceTable(queries.col(q), table);
+    BOOST_REQUIRE_EQUAL(table.n_rows, 16);
+    BOOST_REQUIRE_EQUAL(table.n_cols, 3);
+    for (size_t i = 0; i < 500; i += 13)
+    {
+      const double distance = arma::accu(arma::square(queries.col(q) -
+          decoded.col(i)));
+      BOOST_REQUIRE_CLOSE(pq.AsymmetricDistance(table, codes.colptr(i)),
+          distance, 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that more centroids give a smaller quantization error, and that
+ * the quantization error is much smaller than the variance of the data.
+ */
+BOOST_AUTO_TEST_CASE(ProductQuantizerErrorTest)
+{
+  arma::mat data = arma::randu<arma::mat>(8, 2000);
+  const double variance = arma::accu(arma::square(data.each_col() -
+      arma::mean(data, 1)));
+
+  double lastError = DBL_MAX;
+  for (size_t centroids = 4; centroids <= 256; centroids *= 4)
+  {
+    ProductQuantizer pq(4, centroids);
+    pq.Train(data);
+
+    arma::Mat<unsigned char> codes;
+    arma::mat decoded;
+    pq.Encode(data, codes);
+    pq.Decode(codes, decoded);
+
+    const double error = arma::accu(arma::square(data - decoded));
+    BOOST_REQUIRE_LT(error, lastError);
+    lastError = error;
+  }
+
+  BOOST_REQUIRE_LT(lastError, 0.05 * variance);
+}
+
+/**
+ * Make sure the product quantizer rejects invalid parameters and data.
+ */
+BOOST_AUTO_TEST_CASE(ProductQuantizerExceptionTest)
+{
+  BOOST_REQUIRE_THROW(ProductQuantizer(0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(ProductQuantizer(4, 257), std::invalid_argument);
+
+  arma::mat data = arma::randu<arma::mat>(3, 100);
+  ProductQuantizer pq(4, 16);
+  BOOST_REQUIRE_THROW(pq.Train(data), std::invalid_argument);
+
+  ProductQuantizer smallPQ(2, 200);
+  BOOST_REQUIRE_THROW(smallPQ.Train(data), std::invalid_argument);
+
+  ProductQuantizer validPQ(2, 16);
+  validPQ.Train(data);
+  arma::mat wrongData = arma::randu<arma::mat>(4, 10);
+  arma::Mat<unsigned char> codes;
+  BOOST_REQUIRE_THROW(validPQ.Encode(wrongData, codes), std::invalid_argument);
+}
+
+/**
+ * When all the lists are scanned, the neighbors are the points whose decoded
+ * vectors (coarse centroid plus decoded residual) are nearest to the query.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQExhaustiveSearchTest)
+{
+  arma::mat data = arma::randu<arma::mat>(6, 1000);
+  arma::mat queries = arma::randu<arma::mat>(6, 50);
+
+  IVFPQSearch ivfpq(8, 3, 32);
+  ivfpq.Train(data);
+  BOOST_REQUIRE_EQUAL(ivfpq.NumPoints(), 1000);
+  BOOST_REQUIRE_EQUAL(ivfpq.ListOffsets()[8], 1000);
+
+  // Reconstruct every point.
+  arma::mat reconstructed(6, 1000);
+  for (size_t l = 0; l < 8; ++l)
+  {
+    for (size_t j = ivfpq.ListOffsets()[l]; j < ivfpq.ListOffsets()[l + 1];
+        ++j)
+    {
+      arma::mat residual;
+      ivfpq.Quantizer().Decode(ivfpq.Codes().col(j), residual);
+      reconstructed.col(ivfpq.Indices()[j]) = ivfpq.Centroids().col(l) +
+          residual;
+    }
+  }
+
+  // Every point is in exactly one list.
+  arma::Col<size_t> sortedIndices = arma::sort(ivfpq.Indices());
+  for (size_t i = 0; i < 1000; ++i)
+    BOOST_REQUIRE_EQUAL(sortedIndices[i], i);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ivfpq.Search(queries, 5, neighbors, distances, 8);
+
+  for (size_t q = 0; q < queries.n_cols; ++q)
+  {
+    const arma::rowvec reconstructedDistances = arma::sqrt(arma::sum(
+        arma::square(reconstructed.each_col() - queries.col(q)), 0));
+    const arma::uvec order = arma::sort_index(reconstructedDistances);
+    for (size_t j = 0; j < 5; ++j)
+    {
+      BOOST_REQUIRE_CLOSE(distances(j, q), reconstructedDistances[order[j]],
+          1e-5);
+      BOOST_REQUIRE_CLOSE(distances(j, q),
+          reconstructedDistances[neighbors(j, q)], 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that slightly perturbed reference points find their original
+ * point, whatever the number of lists scanned.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQRecallTest)
+{
+  arma::mat data = arma::randn<arma::mat>(32, 5000);
+  arma::mat queries = data.cols(0, 199) + 0.01 * arma::randn<arma::mat>(32,
+      200);
+
+  IVFPQSearch ivfpq(64, 8, 256);
+  ivfpq.Train(data, 3000);
+
+  for (size_t probes = 1; probes <= 64; probes *= 8)
+  {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    ivfpq.Search(queries, 10, neighbors, distances, probes);
+
+    size_t found = 0;
+    for (size_t q = 0; q < queries.n_cols; ++q)
+    {
+      for (size_t j = 0; j < 10; ++j)
+      {
+        if (j > 0)
+          BOOST_REQUIRE_LE(distances(j - 1, q), distances(j, q));
+        if (neighbors(j, q) == q)
+          ++found;
+      }
+    }
+
+    BOOST_REQUIRE_GT(found, 180);
+  }
+}
+
+/**
+ * Make sure that points of type float can be indexed and searched.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQFloatTest)
+{
+  arma::fmat data = arma::randu<arma::fmat>(8, 1000);
+  arma::mat doubleData = arma::conv_to<arma::mat>::from(data);
+
+  math::RandomSeed(4);
+  IVFPQSearch floatIVFPQ(16, 4, 64);
+  floatIVFPQ.Train(data);
+
+  math::RandomSeed(4);
+  IVFPQSearch doubleIVFPQ(16, 4, 64);
+  doubleIVFPQ.Train(doubleData);
+
+  CheckMatrices(floatIVFPQ.Centroids(), doubleIVFPQ.Centroids());
+  // The centroids may differ in their last bits, so a few points may be
+  // encoded differently.
+  BOOST_REQUIRE_GT(arma::accu(floatIVFPQ.Codes() == doubleIVFPQ.Codes()),
+      0.99 * floatIVFPQ.Codes().n_elem);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  floatIVFPQ.Search(data.cols(0, 9), 3, neighbors, distances, 16);
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 10);
+}
+
+/**
+ * Make sure that invalid queries are rejected, and that lists with too few
+ * points give placeholder results.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQExceptionTest)
+{
+  BOOST_REQUIRE_THROW(IVFPQSearch(0), std::invalid_argument);
+
+  arma::mat data = arma::randu<arma::mat>(4, 100);
+  IVFPQSearch tooManyLists(200, 2, 16);
+  BOOST_REQUIRE_THROW(tooManyLists.Train(data), std::invalid_argument);
+
+  IVFPQSearch ivfpq(10, 2, 16);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  BOOST_REQUIRE_THROW(ivfpq.Search(data, 1, neighbors, distances),
+      std::invalid_argument);
+
+  ivfpq.Train(data);
+  arma::mat wrongQueries = arma::randu<arma::mat>(3, 10);
+  BOOST_REQUIRE_THROW(ivfpq.Search(wrongQueries, 1, neighbors, distances),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(ivfpq.Search(data, 101, neighbors, distances),
+      std::invalid_argument);
+
+  // Scanning only one list can't give 100 neighbors.
+  ivfpq.Search(data.cols(0, 4), 100, neighbors, distances, 1);
+  for (size_t q = 0; q < 5; ++q)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors(99, q), 100);
+    BOOST_REQUIRE_EQUAL(distances(99, q), DBL_MAX);
+  }
+}
+
+/**
+ * Make sure a serialized index gives the same results.
+ */
+BOOST_AUTO_TEST_CASE(IVFPQSerializationTest)
+{
+  arma::mat data = arma::randu<arma::mat>(6, 800);
+  arma::mat queries = arma::randu<arma::mat>(6, 30);
+
+  IVFPQSearch ivfpq(8, 3, 32);
+  ivfpq.Train(data);
+
+  IVFPQSearch xmlIVFPQ, textIVFPQ(4, 2, 8), binaryIVFPQ(16);
+  textIVFPQ.Train(arma::randu<arma::mat>(4, 100));
+
+  SerializeObjectAll(ivfpq, xmlIVFPQ, textIVFPQ, binaryIVFPQ);
+
+  BOOST_REQUIRE_EQUAL(xmlIVFPQ.NumLists(), 8);
+  BOOST_REQUIRE_EQUAL(textIVFPQ.Quantizer().NumSubspaces(), 3);
+  BOOST_REQUIRE_EQUAL(binaryIVFPQ.Quantizer().NumCentroids(), 32);
+  CheckMatrices(ivfpq.Centroids(), xmlIVFPQ.Centroids(),
+      textIVFPQ.Centroids(), binaryIVFPQ.Centroids());
+  CheckMatrices(ivfpq.Indices(), xmlIVFPQ.Indices(), textIVFPQ.Indices(),
+      binaryIVFPQ.Indices());
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  ivfpq.Search(queries, 4, neighbors, distances, 3);
+  xmlIVFPQ.Search(queries, 4, xmlNeighbors, xmlDistances, 3);
+  textIVFPQ.Search(queries, 4, textNeighbors, textDistances, 3);
+  binaryIVFPQ.Search(queries, 4, binaryNeighbors, binaryDistances, 3);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
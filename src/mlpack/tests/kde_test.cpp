@@ -10,6 +10,8 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/kde/kde.hpp>
+#include <mlpack/methods/kde/kde_rules.hpp>
+#include <mlpack/methods/kde/gaussian_series_expansion.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
@@ -818,4 +820,446 @@ BOOST_AUTO_TEST_CASE(NotTrained)
   BOOST_REQUIRE_THROW(kde.Evaluate(estimations), std::runtime_error);
 }
 
+#ifdef HAS_OPENMP
+/**
+ * Make sure that parallel single-tree and dual-tree evaluations respect the
+ * error tolerance, in both the bichromatic and the monochromatic case.
+ */
+BOOST_AUTO_TEST_CASE(ParallelEvaluationTest)
+{
+  arma::mat reference = arma::randu(2, 1000);
+  arma::mat query = arma::randu(2, 500);
+  const double relError = 0.01;
+  GaussianKernel kernel(0.3);
+
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  arma::vec bfMonoEstimations(reference.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+  BruteForceKDE<GaussianKernel>(reference, reference, bfMonoEstimations,
+      kernel);
+
+  // The monochromatic estimations leave out each point itself.
+  bfMonoEstimations -= kernel.Evaluate(0.0) / reference.n_cols;
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>
+      kde(relError, 0.0, kernel, KDEMode::DUAL_TREE_MODE);
+  kde.Train(reference);
+
+  arma::vec dualEstimations, dualMonoEstimations;
+  kde.Evaluate(query, dualEstimations);
+  kde.Evaluate(dualMonoEstimations);
+
+  kde.Mode() = KDEMode::SINGLE_TREE_MODE;
+  arma::vec singleEstimations, singleMonoEstimations;
+  kde.Evaluate(query, singleEstimations);
+  kde.Evaluate(singleMonoEstimations);
+
+  omp_set_num_threads(prevNumThreads);
+
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(bfEstimations[i], dualEstimations[i], relError * 100);
+    BOOST_REQUIRE_CLOSE(bfEstimations[i], singleEstimations[i],
+        relError * 100);
+  }
+
+  for (size_t i = 0; i < reference.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(bfMonoEstimations[i], dualMonoEstimations[i],
+        relError * 100);
+    BOOST_REQUIRE_CLOSE(bfMonoEstimations[i], singleMonoEstimations[i],
+        relError * 100);
+  }
+}
+#endif
+
+/**
+ * Make sure that estimations after adding reference points to a trained model
+ * match the estimations of a model trained on all the points.
+ */
+BOOST_AUTO_TEST_CASE(AddReferencePointsTest)
+{
+  arma::mat reference = arma::randu(2, 800);
+  arma::mat query = arma::randu(2, 200);
+  const double relError = 0.01;
+  GaussianKernel kernel(0.3);
+
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  arma::vec bfMonoEstimations(reference.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+  BruteForceKDE<GaussianKernel>(reference, reference, bfMonoEstimations,
+      kernel);
+  bfMonoEstimations -= kernel.Evaluate(0.0) / reference.n_cols;
+
+  for (size_t m = 0; m < 2; ++m)
+  {
+    const KDEMode mode = (m == 0) ? KDEMode::DUAL_TREE_MODE :
+        KDEMode::SINGLE_TREE_MODE;
+    KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>
+        kde(relError, 0.0, kernel, mode);
+
+    // Add the points in batches of different sizes, so that trees of added
+    // points are both created and merged.
+    kde.Train(reference.cols(0, 399));
+    size_t maxNumTrees = 1;
+    const size_t batchSizes[] = { 100, 20, 20, 60, 150, 50 };
+    size_t begin = 400;
+    for (size_t b = 0; b < 6; ++b)
+    {
+      kde.AddReferencePoints(reference.cols(begin, begin + batchSizes[b] - 1));
+      begin += batchSizes[b];
+      BOOST_REQUIRE_EQUAL(kde.NumReferencePoints(), begin);
+      maxNumTrees = std::max(maxNumTrees, kde.NumReferenceTrees());
+    }
+    BOOST_REQUIRE_EQUAL(begin, reference.n_cols);
+    BOOST_REQUIRE_GT(maxNumTrees, (size_t) 1);
+
+    arma::vec estimations, monoEstimations;
+    kde.Evaluate(query, estimations);
+    kde.Evaluate(monoEstimations);
+
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(bfEstimations[i], estimations[i], relError * 100);
+    for (size_t i = 0; i < reference.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(bfMonoEstimations[i], monoEstimations[i],
+          relError * 100);
+    }
+  }
+
+  // Points of the wrong dimensionality can't be added, and an untrained model
+  // can't take points at all.
+  KDE<> kde;
+  BOOST_REQUIRE_THROW(kde.AddReferencePoints(query), std::runtime_error);
+  kde.Train(reference);
+  BOOST_REQUIRE_THROW(kde.AddReferencePoints(arma::randu(3, 10)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that Monte Carlo estimations of a Gaussian KDE in high dimension
+ * are within the relative error tolerance for (almost) all query points, in
+ * both dual-tree and single-tree mode.
+ */
+BOOST_AUTO_TEST_CASE(MonteCarloGaussianKDETest)
+{
+  arma::mat reference = arma::randu(10, 3000);
+  arma::mat query = arma::randu(10, 200);
+  const double relError = 0.05;
+  GaussianKernel kernel(1.0);
+
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  for (size_t m = 0; m < 2; ++m)
+  {
+    const KDEMode mode = (m == 0) ? KDEMode::DUAL_TREE_MODE :
+        KDEMode::SINGLE_TREE_MODE;
+    KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>
+        kde(relError, 0.0, kernel, mode, EuclideanDistance(), true, 0.95, 50);
+    kde.Train(reference);
+
+    arma::vec estimations;
+    kde.Evaluate(query, estimations);
+
+    // Each query point may fail with probability 0.05.
+    size_t numFailures = 0;
+    for (size_t i = 0; i < query.n_cols; ++i)
+    {
+      if (std::abs(estimations[i] - bfEstimations[i]) >
+          relError * bfEstimations[i])
+        ++numFailures;
+    }
+    BOOST_REQUIRE_LE(numFailures, (size_t) 20);
+  }
+}
+
+/**
+ * Make sure that node combinations are actually estimated by sampling when
+ * Monte Carlo estimation is enabled, and only then.
+ */
+BOOST_AUTO_TEST_CASE(MonteCarloRulesSampleTest)
+{
+  arma::mat reference = arma::randu(10, 2000);
+  arma::mat query = arma::randu(10, 50);
+  GaussianKernel kernel(1.0);
+  EuclideanDistance metric;
+
+  typedef KDTree<EuclideanDistance, KDEStat, arma::mat> Tree;
+  typedef KDERules<EuclideanDistance, GaussianKernel, Tree> RuleType;
+  Tree referenceTree(reference);
+
+  for (size_t m = 0; m < 2; ++m)
+  {
+    arma::vec densities(query.n_cols, arma::fill::zeros);
+    RuleType rules(referenceTree.Dataset(), query, densities, 0.05, 0.0,
+        metric, kernel, false);
+    if (m == 1)
+      rules.SetMonteCarlo(0.95, 50, 3, 0.4, 42);
+
+    Tree::SingleTreeTraverser<RuleType> traverser(rules);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      traverser.Traverse(i, referenceTree);
+
+    if (m == 0)
+      BOOST_REQUIRE_EQUAL(rules.MonteCarloPrunes(), (size_t) 0);
+    else
+      BOOST_REQUIRE_GT(rules.MonteCarloPrunes(), (size_t) 0);
+  }
+}
+
+/**
+ * Make sure that invalid Monte Carlo parameters are rejected, and that the
+ * parameters are serialized.
+ */
+BOOST_AUTO_TEST_CASE(MonteCarloParametersTest)
+{
+  KDE<> kde;
+  BOOST_REQUIRE_THROW(kde.MCProb(1.0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(kde.MCProb(-0.1), std::invalid_argument);
+  BOOST_REQUIRE_THROW(kde.MCEntryCoefficient(0.5), std::invalid_argument);
+  BOOST_REQUIRE_THROW(kde.MCBreakCoefficient(0.0), std::invalid_argument);
+  BOOST_REQUIRE_THROW(kde.MCBreakCoefficient(1.5), std::invalid_argument);
+  BOOST_REQUIRE_THROW(KDE<>(0.05, 0.0, GaussianKernel(), DUAL_TREE_MODE,
+      EuclideanDistance(), true, 1.5), std::invalid_argument);
+
+  kde.MonteCarlo() = true;
+  kde.MCProb(0.8);
+  kde.MCInitialSampleSize() = 30;
+  kde.MCEntryCoefficient(2.0);
+  kde.MCBreakCoefficient(0.5);
+  kde.Train(arma::randu(3, 100));
+
+  KDE<> kdeXml, kdeText, kdeBinary;
+  SerializeObjectAll(kde, kdeXml, kdeText, kdeBinary);
+
+  BOOST_REQUIRE_EQUAL(kdeXml.MonteCarlo(), true);
+  BOOST_REQUIRE_EQUAL(kdeText.MonteCarlo(), true);
+  BOOST_REQUIRE_EQUAL(kdeBinary.MonteCarlo(), true);
+  BOOST_REQUIRE_CLOSE(kdeXml.MCProb(), 0.8, 1e-8);
+  BOOST_REQUIRE_CLOSE(kdeText.MCProb(), 0.8, 1e-8);
+  BOOST_REQUIRE_CLOSE(kdeBinary.MCProb(), 0.8, 1e-8);
+  BOOST_REQUIRE_EQUAL(kdeXml.MCInitialSampleSize(), (size_t) 30);
+  BOOST_REQUIRE_EQUAL(kdeText.MCInitialSampleSize(), (size_t) 30);
+  BOOST_REQUIRE_EQUAL(kdeBinary.MCInitialSampleSize(), (size_t) 30);
+  BOOST_REQUIRE_CLOSE(kdeXml.MCEntryCoefficient(), 2.0, 1e-8);
+  BOOST_REQUIRE_CLOSE(kdeText.MCEntryCoefficient(), 2.0, 1e-8);
+  BOOST_REQUIRE_CLOSE(kdeBinary.MCEntryCoefficient(), 2.0, 1e-8);
+  BOOST_REQUIRE_CLOSE(kdeXml.MCBreakCoefficient(), 0.5, 1e-8);
+  BOOST_REQUIRE_CLOSE(kdeText.MCBreakCoefficient(), 0.5, 1e-8);
+  BOOST_REQUIRE_CLOSE(kdeBinary.MCBreakCoefficient(), 0.5, 1e-8);
+}
+
+/**
+ * Make sure that the series expansion of a sum of Gaussian kernels is within
+ * its error bound of the exact sum, and that the error decreases with the
+ * order.
+ */
+BOOST_AUTO_TEST_CASE(GaussianSeriesExpansionTest)
+{
+  arma::mat reference = 0.3 * arma::randu(3, 200);
+  arma::mat query = 2.0 * arma::randu(3, 50) - 0.5;
+  const arma::vec center = arma::mean(reference, 1);
+  GaussianKernel kernel(0.5);
+  EuclideanDistance metric;
+  GaussianSeriesExpansion expansion(3, 8, 0.5);
+
+  double radius = 0.0;
+  for (size_t j = 0; j < reference.n_cols; ++j)
+    radius = std::max(radius, metric.Evaluate(reference.col(j), center));
+
+  double lastError = DBL_MAX;
+  for (size_t order = 1; order <= 8; order += 2)
+  {
+    arma::vec coefficients(GaussianSeriesExpansion::NumTerms(3, order),
+        arma::fill::zeros);
+    for (size_t j = 0; j < reference.n_cols; ++j)
+    {
+      expansion.Accumulate(arma::vec(reference.col(j)), center, order,
+          coefficients);
+    }
+
+    double maxError = 0.0;
+    for (size_t i = 0; i < query.n_cols; ++i)
+    {
+      const arma::vec q = query.col(i);
+      double sum = 0.0;
+      for (size_t j = 0; j < reference.n_cols; ++j)
+        sum += kernel.Evaluate(q, reference.col(j));
+
+      const double distance = metric.Evaluate(q, center);
+      const double error = std::abs(expansion.Evaluate(q, center,
+          coefficients, order) - sum);
+      BOOST_REQUIRE_LE(error, expansion.ErrorBound(reference.n_cols, radius,
+          distance, distance, order) + 1e-10);
+      maxError = std::max(maxError, error);
+    }
+
+    BOOST_REQUIRE_LT(maxError, lastError);
+    lastError = maxError;
+  }
+
+  BOOST_REQUIRE_EQUAL(GaussianSeriesExpansion::NumTerms(3, 0), (size_t) 0);
+  BOOST_REQUIRE_EQUAL(GaussianSeriesExpansion::NumTerms(3, 1), (size_t) 1);
+  BOOST_REQUIRE_EQUAL(GaussianSeriesExpansion::NumTerms(3, 3), (size_t) 10);
+  BOOST_REQUIRE_EQUAL(GaussianSeriesExpansion::NumTerms(2, 8), (size_t) 36);
+}
+
+/**
+ * Make sure that series expansion estimations of a Gaussian KDE in low
+ * dimension are within the relative error tolerance, with trees whose first
+ * point is the centroid and with trees whose centroid is computed.
+ */
+BOOST_AUTO_TEST_CASE(SeriesExpansionGaussianKDETest)
+{
+  arma::mat reference = arma::randu(2, 3000);
+  arma::mat query = arma::randu(2, 200);
+  const double relError = 0.01;
+  GaussianKernel kernel(0.5);
+
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  for (size_t m = 0; m < 2; ++m)
+  {
+    const KDEMode mode = (m == 0) ? KDEMode::DUAL_TREE_MODE :
+        KDEMode::SINGLE_TREE_MODE;
+    KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree>
+        kde(relError, 0.0, kernel, mode, EuclideanDistance(), false, 0.95,
+        100, 3, 0.4, true, 6);
+    kde.Train(reference);
+
+    arma::vec estimations;
+    kde.Evaluate(query, estimations);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(estimations[i], bfEstimations[i], relError * 100);
+
+    // Evaluating again uses the same expansions.
+    kde.Evaluate(query, estimations);
+    for (size_t i = 0; i < query.n_cols; ++i)
+      BOOST_REQUIRE_CLOSE(estimations[i], bfEstimations[i], relError * 100);
+  }
+
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, StandardCoverTree>
+      kde(relError, 0.0, kernel, KDEMode::SINGLE_TREE_MODE,
+      EuclideanDistance(), false, 0.95, 100, 3, 0.4, true, 6);
+  kde.Train(reference);
+
+  arma::vec estimations;
+  kde.Evaluate(query, estimations);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    BOOST_REQUIRE_CLOSE(estimations[i], bfEstimations[i], relError * 100);
+}
+
+/**
+ * Make sure that series expansion is rejected for other kernels, and that its
+ * parameters are serialized.
+ */
+BOOST_AUTO_TEST_CASE(SeriesExpansionParametersTest)
+{
+  KDE<EpanechnikovKernel> epanechnikovKDE;
+  epanechnikovKDE.SeriesExpansion() = true;
+  epanechnikovKDE.Train(arma::randu(2, 100));
+  arma::vec estimations;
+  BOOST_REQUIRE_THROW(epanechnikovKDE.Evaluate(arma::randu(2, 10),
+      estimations), std::invalid_argument);
+
+  KDE<> kde;
+  kde.SeriesExpansion() = true;
+  kde.MaxSeriesOrder() = 5;
+  kde.Train(arma::randu(2, 100));
+
+  KDE<> kdeXml, kdeText, kdeBinary;
+  SerializeObjectAll(kde, kdeXml, kdeText, kdeBinary);
+
+  BOOST_REQUIRE_EQUAL(kdeXml.SeriesExpansion(), true);
+  BOOST_REQUIRE_EQUAL(kdeText.SeriesExpansion(), true);
+  BOOST_REQUIRE_EQUAL(kdeBinary.SeriesExpansion(), true);
+  BOOST_REQUIRE_EQUAL(kdeXml.MaxSeriesOrder(), (size_t) 5);
+  BOOST_REQUIRE_EQUAL(kdeText.MaxSeriesOrder(), (size_t) 5);
+  BOOST_REQUIRE_EQUAL(kdeBinary.MaxSeriesOrder(), (size_t) 5);
+}
+
+/**
+ * Make sure that the node combinations beyond the support of finite-support
+ * kernels are pruned, and that the estimations are still exact.
+ */
+BOOST_AUTO_TEST_CASE(FiniteSupportKernelPruneTest)
+{
+  arma::mat reference = arma::randu(2, 2000);
+  arma::mat query = arma::randu(2, 100);
+  const double bandwidth = 0.05;
+
+  typedef KDTree<EuclideanDistance, KDEStat, arma::mat> Tree;
+  std::vector<size_t> oldFromNewReferences;
+  Tree referenceTree(reference, oldFromNewReferences);
+  EuclideanDistance metric;
+
+  // The triangular kernel is zero beyond the bandwidth.
+  TriangularKernel kernel(bandwidth);
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<TriangularKernel>(reference, query, bfEstimations, kernel);
+
+  typedef KDERules<EuclideanDistance, TriangularKernel, Tree> RuleType;
+  arma::vec densities(query.n_cols, arma::fill::zeros);
+  RuleType rules(referenceTree.Dataset(), query, densities, 0.0, 0.0,
+      metric, kernel, false);
+
+  Tree::SingleTreeTraverser<RuleType> traverser(rules);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    traverser.Traverse(i, referenceTree);
+
+  densities /= reference.n_cols;
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    if (bfEstimations[i] == 0.0)
+      BOOST_REQUIRE_SMALL(densities[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(densities[i], bfEstimations[i], 1e-5);
+  }
+
+  // Only the reference points close to each query point are visited.
+  BOOST_REQUIRE_LT(rules.BaseCases(), reference.n_cols * query.n_cols / 10);
+  BOOST_REQUIRE(KernelTraits<TriangularKernel>::HasFiniteSupport);
+  BOOST_REQUIRE(KernelTraits<SphericalKernel>::HasFiniteSupport);
+  BOOST_REQUIRE(KernelTraits<EpanechnikovKernel>::HasFiniteSupport);
+  BOOST_REQUIRE(!KernelTraits<GaussianKernel>::HasFiniteSupport);
+}
+
+/**
+ * Make sure that single-tree KDE with blocks of query points gives the same
+ * estimations as single-tree KDE without them.
+ */
+BOOST_AUTO_TEST_CASE(QueryBlockKDETest)
+{
+  arma::mat reference = arma::randu(2, 1000);
+  arma::mat query = arma::randu(2, 300);
+  const double relError = 0.01;
+
+  GaussianKernel kernel(0.1);
+  arma::vec bfEstimations(query.n_cols, arma::fill::zeros);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  KDE<GaussianKernel, metric::EuclideanDistance, arma::mat, tree::KDTree>
+      kde(relError, 0.0, kernel, KDEMode::SINGLE_TREE_MODE);
+  kde.Train(reference);
+
+  arma::vec estimations, blockEstimations;
+  kde.Evaluate(query, estimations);
+
+  kde.QueryBlockSize() = 16;
+  kde.Evaluate(query, blockEstimations);
+
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(blockEstimations[i], estimations[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(blockEstimations[i], bfEstimations[i], relError * 100);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -20,6 +20,7 @@
 #include <mlpack/core/kernels/spherical_kernel.hpp>
 #include <mlpack/core/kernels/pspectrum_string_kernel.hpp>
 #include <mlpack/core/kernels/cauchy_kernel.hpp>
+#include <mlpack/core/kernels/batch_kernels.hpp>
 #include <mlpack/core/metrics/lmetric.hpp>
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 
@@ -171,6 +172,46 @@ BOOST_AUTO_TEST_CASE(MDRootEyeCovarianceTest)
   BOOST_REQUIRE_CLOSE(md.Evaluate(b, a), sqrt(14.0), 1e-5);
 }
 
+/**
+ * Make sure that the Euclidean distance between transformed points is the
+ * Mahalanobis distance between the original points, for a positive definite
+ * and for a singular covariance matrix.
+ */
+BOOST_AUTO_TEST_CASE(MDTransformTest)
+{
+  arma::mat r = arma::randu<arma::mat>(5, 5);
+  arma::mat lowRank = arma::randu<arma::mat>(5, 2);
+  std::vector<arma::mat> covariances;
+  covariances.push_back(r.t() * r + 0.1 * arma::eye<arma::mat>(5, 5));
+  covariances.push_back(lowRank * lowRank.t());
+
+  arma::mat data = arma::randu<arma::mat>(5, 20);
+
+  for (size_t c = 0; c < covariances.size(); ++c)
+  {
+    MahalanobisDistance<true> md(covariances[c]);
+    MahalanobisDistance<false> mdSquared(covariances[c]);
+
+    arma::mat transformation;
+    md.Transformation(transformation);
+    CheckMatrices(transformation.t() * transformation, covariances[c], 1e-5);
+
+    arma::mat transformedData;
+    md.Transform(data, transformedData);
+    BOOST_REQUIRE_EQUAL(transformedData.n_cols, data.n_cols);
+
+    for (size_t i = 1; i < data.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(transformedData.col(0),
+          transformedData.col(i)), md.Evaluate(data.col(0), data.col(i)),
+          1e-5);
+      BOOST_REQUIRE_CLOSE(SquaredEuclideanDistance::Evaluate(
+          transformedData.col(0), transformedData.col(i)),
+          mdSquared.Evaluate(data.col(0), data.col(i)), 1e-5);
+    }
+  }
+}
+
 /**
  * Simple test with diagonal covariance matrix.
  */
@@ -609,6 +650,79 @@ BOOST_AUTO_TEST_CASE(PSpectrumStringEvaluateTest)
   BOOST_REQUIRE_CLOSE(p.Evaluate(b, a), 11.0, 1e-5);
 }
 
+/**
+ * Make sure that the batch evaluation of the p-spectrum kernel gives the same
+ * kernel values as the evaluation of each pair of strings, and that
+ * KernelMatrix() uses it.
+ */
+BOOST_AUTO_TEST_CASE(PSpectrumStringBatchEvaluateTest)
+{
+  BOOST_REQUIRE_EQUAL(
+      (bool) KernelTraits<PSpectrumStringKernel>::HasBatchEvaluate, true);
+
+  std::vector<std::vector<std::string> > datasets(2);
+  datasets[0].push_back("acgtacgtaa");
+  datasets[0].push_back("ttgacgtacc");
+  datasets[0].push_back("gattaca");
+  datasets[1].push_back("ACGTTTACGA");
+  datasets[1].push_back("cgta cgta");
+
+  PSpectrumStringKernel p(datasets, 3);
+
+  arma::mat a("0 0 0 1 1; 0 1 2 0 1");
+  arma::mat b("1 0; 1 2");
+
+  arma::mat kernels, symmetricKernels, kernelMatrix;
+  p.Evaluate(a, b, kernels);
+  p.Evaluate(a, a, symmetricKernels);
+  KernelMatrix(p, a, a, kernelMatrix);
+
+  BOOST_REQUIRE_EQUAL(kernels.n_rows, 5);
+  BOOST_REQUIRE_EQUAL(kernels.n_cols, 2);
+  for (size_t i = 0; i < a.n_cols; ++i)
+  {
+    for (size_t j = 0; j < b.n_cols; ++j)
+      BOOST_REQUIRE_EQUAL(kernels(i, j), p.Evaluate(a.col(i), b.col(j)));
+
+    for (size_t j = 0; j < a.n_cols; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(symmetricKernels(i, j),
+          p.Evaluate(a.col(i), a.col(j)));
+      BOOST_REQUIRE_EQUAL(kernelMatrix(i, j), symmetricKernels(i, j));
+    }
+  }
+
+  // The substrings are case-insensitive: acg, cgt, gta, tac, acg, cgt, gta, taa
+  // against acg, cgt, gtt, ttt, tta, tac, acg, cga.
+  BOOST_REQUIRE_EQUAL(symmetricKernels(0, 3), 2 * 2 + 2 * 1 + 1 * 1);
+}
+
+/**
+ * Make sure that substrings longer than MaxExactP are hashed correctly.
+ */
+BOOST_AUTO_TEST_CASE(PSpectrumStringLongSubstringTest)
+{
+  std::vector<std::vector<std::string> > datasets(1);
+  datasets[0].push_back("abcdefghijklmnopqrstabcdefghijklmnop");
+  datasets[0].push_back("xxabcdefghijklmnopqrxx");
+
+  // With p = 15, the first string has 22 substrings, and "abcdefghijklmno" and
+  // "bcdefghijklmnop" appear twice.  Four of the eight substrings of the second
+  // string are substrings of the first string: those starting with a, b, c
+  // and d.
+  PSpectrumStringKernel p(datasets, 15);
+  BOOST_REQUIRE_EQUAL(p.Offsets(0)[1], 20);
+  BOOST_REQUIRE_EQUAL(p.Offsets(0)[2] - p.Offsets(0)[1], 8);
+
+  arma::vec a("0 0"), b("0 1");
+  BOOST_REQUIRE_EQUAL(p.Evaluate(a, a), 2 * 2 + 2 * 2 + 18);
+  BOOST_REQUIRE_EQUAL(p.Evaluate(b, b), 8);
+  BOOST_REQUIRE_EQUAL(p.Evaluate(a, b), 2 + 2 + 1 + 1);
+
+  // The hashed substrings can't be decoded.
+  BOOST_REQUIRE_THROW(p.Counts(), std::logic_error);
+}
+
 /**
  * Cauchy Kernel test.
  */
@@ -622,4 +736,112 @@ BOOST_AUTO_TEST_CASE(CauchyKernelTest)
   BOOST_REQUIRE_CLOSE(ck.Evaluate(b, a), 0.92592588, 1e-5);
 }
 
+/**
+ * Check that the kernel matrix of a kernel matches the pairwise evaluations of
+ * the kernel.
+ */
+template<typename KernelType>
+void CheckKernelMatrix(KernelType& kernel)
+{
+  arma::mat a = arma::randu<arma::mat>(4, 30);
+  arma::mat b = arma::randu<arma::mat>(4, 20);
+
+  arma::mat kernels, symmetricKernels;
+  KernelMatrix(kernel, a, b, kernels);
+  KernelMatrix(kernel, a, a, symmetricKernels);
+
+  BOOST_REQUIRE_EQUAL(kernels.n_rows, 30);
+  BOOST_REQUIRE_EQUAL(kernels.n_cols, 20);
+  BOOST_REQUIRE_EQUAL(symmetricKernels.n_rows, 30);
+  BOOST_REQUIRE_EQUAL(symmetricKernels.n_cols, 30);
+
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(kernels(i, j), kernel.Evaluate(a.col(i), b.col(j)),
+          1e-5);
+    }
+  }
+
+  for (size_t j = 0; j < a.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(symmetricKernels(i, j),
+          kernel.Evaluate(a.col(i), a.col(j)), 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that KernelMatrix() gives the same results with the matrix
+ * multiplication of the linear, polynomial and Gaussian kernels, and with the
+ * pairwise evaluation of the other kernels.
+ */
+BOOST_AUTO_TEST_CASE(KernelMatrixTest)
+{
+  LinearKernel lk;
+  CheckKernelMatrix(lk);
+
+  PolynomialKernel pk(3.0, 1.5);
+  CheckKernelMatrix(pk);
+
+  GaussianKernel gk(0.7);
+  CheckKernelMatrix(gk);
+
+  LaplacianKernel lpk(0.7);
+  CheckKernelMatrix(lpk);
+
+  CosineDistance cd;
+  CheckKernelMatrix(cd);
+
+  EpanechnikovKernel ek(2.0);
+  CheckKernelMatrix(ek);
+}
+
+/**
+ * Make sure that the batch evaluation of the cosine distance gives 0 for
+ * points with zero norm, like the evaluation of a single pair of points.
+ */
+BOOST_AUTO_TEST_CASE(CosineDistanceBatchZeroTest)
+{
+  arma::mat a = arma::randu<arma::mat>(3, 4);
+  arma::mat b = arma::randu<arma::mat>(3, 5);
+  a.col(1).zeros();
+  b.col(3).zeros();
+
+  arma::mat kernels;
+  CosineDistance::Evaluate(a, b, kernels);
+
+  for (size_t j = 0; j < b.n_cols; ++j)
+  {
+    for (size_t i = 0; i < a.n_cols; ++i)
+    {
+      if (i == 1 || j == 3)
+        BOOST_REQUIRE_EQUAL(kernels(i, j), 0.0);
+      else
+        BOOST_REQUIRE_CLOSE(kernels(i, j),
+            CosineDistance::Evaluate(a.col(i), b.col(j)), 1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that the kernels with a batch Evaluate() are detected.
+ */
+BOOST_AUTO_TEST_CASE(BatchEvaluateTraitsTest)
+{
+  BOOST_REQUIRE((SupportsBatchKernels<LinearKernel, arma::mat>::value));
+  BOOST_REQUIRE((SupportsBatchKernels<PolynomialKernel, arma::mat>::value));
+  BOOST_REQUIRE((SupportsBatchKernels<GaussianKernel, arma::mat>::value));
+  BOOST_REQUIRE((SupportsBatchKernels<LaplacianKernel, arma::mat>::value));
+  BOOST_REQUIRE((SupportsBatchKernels<CosineDistance, arma::mat>::value));
+
+  BOOST_REQUIRE(!(SupportsBatchKernels<EpanechnikovKernel, arma::mat>::value));
+  BOOST_REQUIRE(!(SupportsBatchKernels<HyperbolicTangentKernel,
+      arma::mat>::value));
+  BOOST_REQUIRE(!(SupportsBatchKernels<GaussianKernel, arma::sp_mat>::value));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -12,12 +12,16 @@
 #include <mlpack/methods/kmeans/kmeans.hpp>
 #include <mlpack/methods/kmeans/allow_empty_clusters.hpp>
 #include <mlpack/methods/kmeans/refined_start.hpp>
+#include <mlpack/methods/kmeans/kmeans_parallel_initialization.hpp>
 #include <mlpack/methods/kmeans/elkan_kmeans.hpp>
 #include <mlpack/methods/kmeans/hamerly_kmeans.hpp>
 #include <mlpack/methods/kmeans/pelleg_moore_kmeans.hpp>
 #include <mlpack/methods/kmeans/dual_tree_kmeans.hpp>
+#include <mlpack/methods/kmeans/mini_batch_kmeans.hpp>
 #include <mlpack/methods/kmeans/sample_initialization.hpp>
+#include <mlpack/methods/kmeans/sparse_hamerly_kmeans.hpp>
 #include <mlpack/methods/kmeans/random_partition.hpp>
+#include <mlpack/methods/kmeans/distributed_kmeans.hpp>
 
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
@@ -26,6 +30,10 @@
 #include <mlpack/methods/kmeans/kill_empty_clusters.hpp>
 #include "test_tools.hpp"
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 using namespace mlpack;
 using namespace mlpack::kmeans;
 using namespace mlpack::metric;
@@ -489,6 +497,86 @@ BOOST_AUTO_TEST_CASE(RefinedStartTest)
   BOOST_REQUIRE_LT(distortion, 14000.0);
 }
 
+/**
+ * Test that the k-means|| initialization picks well-spread initial centroids,
+ * on the same dataset as RefinedStartTest.
+ */
+BOOST_AUTO_TEST_CASE(KMeansParallelInitializationTest)
+{
+  arma::mat data(3, 3000);
+  data.randn();
+
+  arma::mat centroids(" 0  5 -2 -6  1;"
+                      " 0  0 -2  8  6;"
+                      " 0 -2 -2  8  1");
+
+  for (size_t i = 1000; i < 1200; ++i)
+    data.col(i) += centroids.col(1);
+  for (size_t i = 1200; i < 1700; ++i)
+    data.col(i) += centroids.col(2);
+  for (size_t i = 1700; i < 1800; ++i)
+    data.col(i) += centroids.col(3);
+  for (size_t i = 1800; i < 3000; ++i)
+    data.col(i) += centroids.col(4);
+
+  KMeansParallelInitialization kmp;
+  arma::mat initialCentroids;
+  kmp.Cluster(data, 5, initialCentroids);
+
+  BOOST_REQUIRE_EQUAL(initialCentroids.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(initialCentroids.n_cols, 5);
+
+  // Each initial centroid is a point of the dataset.
+  for (size_t i = 0; i < initialCentroids.n_cols; ++i)
+  {
+    size_t j;
+    for (j = 0; j < data.n_cols; ++j)
+    {
+      if (metric::EuclideanDistance::Evaluate(initialCentroids.col(i),
+          data.col(j)) < 1e-10)
+        break;
+    }
+
+    BOOST_REQUIRE_LT(j, data.n_cols);
+  }
+
+  // Running k-means from these centroids should find a good clustering; the
+  // distortion bound is the same as for RefinedStartTest.
+  KMeans<EuclideanDistance, KMeansParallelInitialization> kmeans;
+  arma::Row<size_t> assignments;
+  arma::mat resultingCentroids;
+  kmeans.Cluster(data, 5, assignments, resultingCentroids);
+
+  double distortion = 0;
+  for (size_t i = 0; i < 3000; ++i)
+    distortion += metric::EuclideanDistance::Evaluate(data.col(i),
+        resultingCentroids.col(assignments[i]));
+
+  BOOST_REQUIRE_LT(distortion, 14000.0);
+}
+
+/**
+ * Make sure that k-means|| gives correct assignments and handles more clusters
+ * than candidates.
+ */
+BOOST_AUTO_TEST_CASE(KMeansParallelInitializationAssignmentsTest)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 50);
+
+  // With no rounds, there is only one candidate, so the other centroids are
+  // random points.
+  KMeansParallelInitialization kmp(2.0, 0);
+  arma::Row<size_t> assignments;
+  kmp.Cluster(data, 10, assignments);
+
+  BOOST_REQUIRE_EQUAL(assignments.n_elem, 50);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    BOOST_REQUIRE_LT(assignments[i], (size_t) 10);
+
+  BOOST_REQUIRE_THROW(KMeansParallelInitialization(0.0),
+      std::invalid_argument);
+}
+
 #ifdef ARMA_HAS_SPMAT
 /**
  * Make sure sparse k-means works okay.
@@ -534,6 +622,58 @@ BOOST_AUTO_TEST_CASE(SparseKMeansTest)
   BOOST_REQUIRE_EQUAL(assignments[11], clusterTwo);
 }
 
+/**
+ * Make sure that the sparse Hamerly step gives the same clusters as the naive
+ * step, on sparse data and on the same data stored densely.
+ */
+BOOST_AUTO_TEST_CASE(SparseHamerlyTest)
+{
+  const size_t trials = 3;
+
+  for (size_t t = 0; t < trials; ++t)
+  {
+    arma::sp_mat dataset;
+    dataset.sprandu(200, 1000, 0.05);
+    const arma::mat denseDataset(dataset);
+
+    // Start from some of the points, so that no cluster is empty at first.
+    const size_t k = 5 * (t + 1);
+    arma::mat centroids = denseDataset.cols(0, k - 1);
+
+    arma::mat naiveCentroids(centroids);
+    KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        NaiveKMeans, arma::sp_mat> km;
+    arma::Row<size_t> assignments;
+    km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+    KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        SparseHamerlyKMeans, arma::sp_mat> hamerly;
+    arma::Row<size_t> hamerlyAssignments;
+    arma::mat hamerlyCentroids(centroids);
+    hamerly.Cluster(dataset, k, hamerlyAssignments, hamerlyCentroids, false,
+        true);
+
+    KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        SparseHamerlyKMeans> denseHamerly;
+    arma::Row<size_t> denseAssignments;
+    arma::mat denseCentroids(centroids);
+    denseHamerly.Cluster(denseDataset, k, denseAssignments, denseCentroids,
+        false, true);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(assignments[i], hamerlyAssignments[i]);
+      BOOST_REQUIRE_EQUAL(assignments[i], denseAssignments[i]);
+    }
+
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(naiveCentroids[i], hamerlyCentroids[i], 1e-5);
+      BOOST_REQUIRE_CLOSE(naiveCentroids[i], denseCentroids[i], 1e-5);
+    }
+  }
+}
+
 #endif // ARMA_HAS_SPMAT
 
 BOOST_AUTO_TEST_CASE(ElkanTest)
@@ -703,6 +843,51 @@ BOOST_AUTO_TEST_CASE(DTNNCoverTreeTest)
   }
 }
 
+/**
+ * Make sure that the dual-tree algorithm gives the same clustering as the naive
+ * algorithm when the tree is large enough to be traversed in parallel, and
+ * when the clusters converge slowly enough that in later iterations only a few
+ * centroids move, so the tree on the centroids is refit.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDTNNTest)
+{
+  const size_t numThreads = NumThreads();
+  SetNumThreads(4);
+
+  // Well-separated clusters of different sizes.
+  arma::mat dataset(3, 20000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    dataset.col(i) = arma::randn<arma::vec>(3) +
+        arma::vec(3).fill(10.0 * (i % 7 + i % 3));
+  }
+
+  // Start from distinct points of the dataset.
+  const size_t k = 25;
+  const arma::uvec order = arma::shuffle(arma::linspace<arma::uvec>(0,
+      dataset.n_cols - 1, dataset.n_cols));
+  arma::mat centroids = dataset.cols(order.head(k));
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km;
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      DefaultDualTreeKMeans> dtnn;
+  arma::Row<size_t> dtnnAssignments;
+  arma::mat dtnnCentroids(centroids);
+  dtnn.Cluster(dataset, k, dtnnAssignments, dtnnCentroids, false, true);
+
+  SetNumThreads(numThreads);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], dtnnAssignments[i]);
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(naiveCentroids[i], dtnnCentroids[i], 1e-5);
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
@@ -737,4 +922,302 @@ BOOST_AUTO_TEST_CASE(SampleInitializationTest)
   }
 }
 
+/**
+ * Make sure that mini-batch k-means finds well-separated clusters, with
+ * centroids close to the means of the clusters.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansTest)
+{
+  arma::mat means("0.0 10.0 -10.0; 0.0 10.0 5.0");
+  arma::mat dataset(2, 3000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) = means.col(i / 1000) + 0.5 * arma::randn<arma::vec>(2);
+
+  // Start with one point of each cluster.
+  arma::mat centroids(2, 3);
+  centroids.col(0) = dataset.col(0);
+  centroids.col(1) = dataset.col(1000);
+  centroids.col(2) = dataset.col(2000);
+
+  typedef MiniBatchKMeans<EuclideanDistance, arma::mat> StepType;
+  const size_t prevBatchSize = StepType::DefaultBatchSize();
+  StepType::DefaultBatchSize() = 100;
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      MiniBatchKMeans> kmeans(200);
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(dataset, 3, assignments, centroids, false, true);
+
+  StepType::DefaultBatchSize() = prevBatchSize;
+
+  BOOST_REQUIRE_EQUAL(assignments.n_elem, 3000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], i / 1000);
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    const arma::vec mean = arma::mean(dataset.cols(1000 * i,
+        1000 * i + 999), 1);
+    BOOST_REQUIRE_LT(EuclideanDistance::Evaluate(centroids.col(i), mean), 0.2);
+  }
+}
+
+/**
+ * Make sure that a mini-batch step with a batch as large as the dataset moves
+ * the centroids to the means of their points in the first iteration.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchKMeansIterateTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 200);
+  arma::mat centroids = dataset.cols(0, 4);
+
+  EuclideanDistance metric;
+  MiniBatchKMeans<EuclideanDistance, arma::mat> step(dataset, metric);
+  step.BatchSize() = 2000;
+
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+  step.Iterate(centroids, newCentroids, counts);
+
+  BOOST_REQUIRE_EQUAL(counts.n_elem, 5);
+  BOOST_REQUIRE_EQUAL(arma::accu(counts), (size_t) 2000);
+  BOOST_REQUIRE_EQUAL(step.DistanceCalculations(), (size_t) (2000 * 5 + 5));
+
+  // Each new centroid is the mean of the sampled points closest to its old
+  // centroid, so it is in the bounding box of the dataset.
+  for (size_t i = 0; i < newCentroids.n_elem; ++i)
+  {
+    BOOST_REQUIRE_GE(newCentroids[i], 0.0);
+    BOOST_REQUIRE_LE(newCentroids[i], 1.0);
+  }
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that Elkan's and Hamerly's algorithms give the same clusters with
+ * several threads as the naive algorithm with one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelElkanHamerlyTest)
+{
+  arma::mat dataset(10, 3000);
+  dataset.randu();
+
+  const size_t k = 20;
+  arma::mat centroids(10, k);
+  centroids.randu();
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km;
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+       ElkanKMeans> elkan;
+  arma::Row<size_t> elkanAssignments;
+  arma::mat elkanCentroids(centroids);
+  elkan.Cluster(dataset, k, elkanAssignments, elkanCentroids, false, true);
+
+  KMeans<metric::EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+       HamerlyKMeans> hamerly;
+  arma::Row<size_t> hamerlyAssignments;
+  arma::mat hamerlyCentroids(centroids);
+  hamerly.Cluster(dataset, k, hamerlyAssignments, hamerlyCentroids, false,
+      true);
+
+  omp_set_num_threads(prevNumThreads);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(assignments[i], elkanAssignments[i]);
+    BOOST_REQUIRE_EQUAL(assignments[i], hamerlyAssignments[i]);
+  }
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(naiveCentroids[i], elkanCentroids[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(naiveCentroids[i], hamerlyCentroids[i], 1e-5);
+  }
+}
+#endif
+
+/**
+ * A communicator whose ranks are threads, to test DistributedKMeans without
+ * MPI.
+ */
+class ThreadCommunicator
+{
+ public:
+  //! The state shared by all the ranks.
+  struct SharedState
+  {
+    SharedState(const size_t size) : size(size), arrived(0), generation(0) { }
+
+    size_t size;
+    std::mutex mutex;
+    std::condition_variable condition;
+    size_t arrived;
+    size_t generation;
+    arma::mat buffer;
+  };
+
+  ThreadCommunicator() : rank(0), state(NULL) { }
+
+  ThreadCommunicator(const size_t rank, SharedState& state) :
+      rank(rank), state(&state) { }
+
+  size_t Rank() const { return rank; }
+  size_t Size() const { return state->size; }
+
+  void AllReduceSum(arma::mat& m) const
+  {
+    Barrier();
+    if (rank == 0)
+      state->buffer.zeros(m.n_rows, m.n_cols);
+    Barrier();
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->buffer += m;
+    }
+    Barrier();
+    m = state->buffer;
+  }
+
+  void Broadcast(arma::mat& m) const
+  {
+    Barrier();
+    if (rank == 0)
+      state->buffer = m;
+    Barrier();
+    if (rank != 0)
+      m = state->buffer;
+  }
+
+ private:
+  //! Wait for all the ranks.
+  void Barrier() const
+  {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    const size_t generation = state->generation;
+    if (++state->arrived == state->size)
+    {
+      state->arrived = 0;
+      ++state->generation;
+      state->condition.notify_all();
+    }
+    else
+    {
+      state->condition.wait(lock,
+          [this, generation]() { return state->generation != generation; });
+    }
+  }
+
+  size_t rank;
+  SharedState* state;
+};
+
+/**
+ * Run DistributedKMeans with the given step type on shards of the dataset, one
+ * per thread, and make sure the centroids are the same as with KMeans.
+ */
+template<template<class, class> class LloydStepType>
+void CheckDistributedKMeans(const size_t ranks)
+{
+  arma::mat dataset(5, 1000);
+  dataset.randu();
+
+  const size_t k = 8;
+  arma::mat initialCentroids(5, k);
+  initialCentroids.randu();
+
+  arma::mat centroids(initialCentroids);
+  arma::Row<size_t> assignments;
+  KMeans<> km;
+  km.Cluster(dataset, k, assignments, centroids, false, true);
+
+  typedef DistributedKMeans<ThreadCommunicator, EuclideanDistance,
+      SampleInitialization, MaxVarianceNewCluster, LloydStepType>
+      DistributedType;
+
+  ThreadCommunicator::SharedState state(ranks);
+  std::vector<arma::mat> rankCentroids(ranks);
+  std::vector<arma::Row<size_t>> rankAssignments(ranks);
+  std::vector<std::thread> threads;
+  for (size_t r = 0; r < ranks; ++r)
+  {
+    threads.push_back(std::thread([&, r]()
+    {
+      const size_t begin = r * dataset.n_cols / ranks;
+      const size_t end = (r + 1) * dataset.n_cols / ranks;
+      const arma::mat shard = dataset.cols(begin, end - 1);
+
+      // Only rank 0 needs the initial centroids.
+      if (r == 0)
+        rankCentroids[r] = initialCentroids;
+
+      DistributedType dkm(1000, EuclideanDistance(), SampleInitialization(),
+          MaxVarianceNewCluster(), ThreadCommunicator(r, state));
+      dkm.Cluster(shard, k, rankAssignments[r], rankCentroids[r], true);
+    }));
+  }
+  for (size_t r = 0; r < ranks; ++r)
+    threads[r].join();
+
+  size_t point = 0;
+  for (size_t r = 0; r < ranks; ++r)
+  {
+    BOOST_REQUIRE_EQUAL(rankCentroids[r].n_rows, centroids.n_rows);
+    BOOST_REQUIRE_EQUAL(rankCentroids[r].n_cols, centroids.n_cols);
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(rankCentroids[r][i], centroids[i], 1e-5);
+
+    for (size_t i = 0; i < rankAssignments[r].n_elem; ++i, ++point)
+      BOOST_REQUIRE_EQUAL(rankAssignments[r][i], assignments[point]);
+  }
+  BOOST_REQUIRE_EQUAL(point, dataset.n_cols);
+}
+
+/**
+ * Make sure DistributedKMeans gives the same clustering as KMeans, with one
+ * and several ranks, with the naive and Hamerly steps.
+ */
+BOOST_AUTO_TEST_CASE(DistributedKMeansTest)
+{
+  CheckDistributedKMeans<NaiveKMeans>(1);
+  CheckDistributedKMeans<NaiveKMeans>(4);
+  CheckDistributedKMeans<HamerlyKMeans>(3);
+}
+
+/**
+ * Make sure DistributedKMeans with a LocalCommunicator gives the same clusters
+ * as KMeans, and that the initial partition is computed.
+ */
+BOOST_AUTO_TEST_CASE(LocalDistributedKMeansTest)
+{
+  arma::mat dataset(4, 500);
+  dataset.randu();
+
+  math::RandomSeed(3);
+  arma::mat centroids;
+  arma::Row<size_t> assignments;
+  KMeans<EuclideanDistance, RandomPartition> km;
+  km.Cluster(dataset, 5, assignments, centroids);
+
+  math::RandomSeed(3);
+  arma::mat distributedCentroids;
+  arma::Row<size_t> distributedAssignments;
+  DistributedKMeans<LocalCommunicator, EuclideanDistance, RandomPartition> dkm;
+  dkm.Cluster(dataset, 5, distributedAssignments, distributedCentroids);
+
+  BOOST_REQUIRE_EQUAL(distributedCentroids.n_cols, 5);
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(distributedCentroids[i], centroids[i], 1e-5);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(distributedAssignments[i], assignments[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -12,6 +12,9 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/unmap.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
+#include <mlpack/methods/neighbor_search/ns_query_server.hpp>
+#include <mlpack/methods/neighbor_search/dynamic_neighbor_search.hpp>
+#include <mlpack/methods/neighbor_search/sharded_neighbor_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/example_tree.hpp>
 #include <boost/test/unit_test.hpp>
@@ -980,6 +983,67 @@ BOOST_AUTO_TEST_CASE(DuplicatedSpillSearchTest)
   }
 }
 
+/**
+ * Make sure that defeatist search with spill trees on several threads gives
+ * the same results as on one thread (single-tree search), or as a search with
+ * one query tree built on the whole query set (dual-tree search).
+ */
+BOOST_AUTO_TEST_CASE(SpillSearchThreadsTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 3000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 1000);
+
+  SpillKNN::Tree referenceTree(dataset, 0.05 /* tau */);
+  SpillKNN spillKNN(std::move(referenceTree), SINGLE_TREE_MODE);
+
+  arma::Mat<size_t> neighbors, serialNeighbors;
+  arma::mat distances, serialDistances;
+  spillKNN.Search(querySet, 5, neighbors, distances);
+
+  const size_t numThreads = NumThreads();
+  SetNumThreads(1);
+  spillKNN.Search(querySet, 5, serialNeighbors, serialDistances);
+  SetNumThreads(numThreads);
+
+  CheckMatrices(neighbors, serialNeighbors);
+  CheckMatrices(distances, serialDistances);
+
+  spillKNN.Search(5, neighbors, distances);
+  SetNumThreads(1);
+  spillKNN.Search(5, serialNeighbors, serialDistances);
+  SetNumThreads(numThreads);
+
+  CheckMatrices(neighbors, serialNeighbors);
+  CheckMatrices(distances, serialDistances);
+
+  // On one thread, dual-tree search uses a query tree on the whole query set.
+  spillKNN.SearchMode() = DUAL_TREE_MODE;
+  SpillKNN::Tree queryTree(querySet);
+  spillKNN.Search(queryTree, 5, serialNeighbors, serialDistances);
+
+  SetNumThreads(1);
+  spillKNN.Search(querySet, 5, neighbors, distances);
+  SetNumThreads(numThreads);
+
+  CheckMatrices(neighbors, serialNeighbors);
+  CheckMatrices(distances, serialDistances);
+
+  // On several threads the query trees are different, but each result must
+  // still be a valid list of neighbors.
+  spillKNN.Search(querySet, 5, neighbors, distances);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      BOOST_REQUIRE_LT(neighbors(j, i), dataset.n_cols);
+      BOOST_REQUIRE_CLOSE(distances(j, i), arma::norm(querySet.col(i) -
+          dataset.col(neighbors(j, i))), 1e-5);
+      if (j > 0)
+        BOOST_REQUIRE_GE(distances(j, i), distances(j - 1, i));
+    }
+  }
+}
+
 /**
  * Make sure sparse nearest neighbors works with kd trees.
  */
@@ -1466,4 +1530,729 @@ BOOST_AUTO_TEST_CASE(GreedyTreeSearch)
       0);
 }
 
+/**
+ * Make sure that searching with a compacted kd-tree gives the same results as
+ * naive search.
+ */
+BOOST_AUTO_TEST_CASE(CompactKDTreeSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+
+  std::vector<size_t> oldFromNew;
+  KNN::Tree tree(dataset, oldFromNew);
+  tree.Compact();
+
+  KNN knn(std::move(tree));
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighborsTree, neighborsNaive;
+  arma::mat distancesTree, distancesNaive;
+  knn.Search(dataset, 5, neighborsTree, distancesTree);
+  naive.Search(dataset, 5, neighborsNaive, distancesNaive);
+
+  // The tree was built by us, so reference indices must be mapped.
+  for (size_t i = 0; i < neighborsTree.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(oldFromNew[neighborsTree[i]], neighborsNaive[i]);
+    BOOST_REQUIRE_CLOSE(distancesTree[i], distancesNaive[i], 1e-5);
+  }
+}
+
+/**
+ * In higher dimensions, the base cases between leaves are computed in blocks
+ * with a matrix multiplication.  Make sure the results are still the same as
+ * the naive search, for both monochromatic and bichromatic search.
+ */
+BOOST_AUTO_TEST_CASE(HighDimensionalDualTreeVsNaiveTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(40, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(40, 300);
+
+  KNN knn(dataset);
+  KNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  knn.Search(querySet, 5, neighbors, distances);
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  knn.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure that neighbor search works with single-precision data, for both kd
+ * trees and ball trees.
+ */
+template<template<typename TreeMetricType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FloatSearchTest()
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat,
+      TreeType> FloatKNN;
+
+  arma::fmat dataset = arma::randu<arma::fmat>(3, 1000);
+  arma::fmat querySet = arma::randu<arma::fmat>(3, 200);
+
+  FloatKNN knn(dataset);
+  FloatKNN naive(dataset, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  knn.Search(querySet, 5, neighbors, distances);
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  knn.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+BOOST_AUTO_TEST_CASE(FloatKDTreeSearchTest)
+{
+  FloatSearchTest<KDTree>();
+}
+
+BOOST_AUTO_TEST_CASE(FloatBallTreeSearchTest)
+{
+  FloatSearchTest<BallTree>();
+}
+
+/**
+ * Ensure that searching a stream of query chunks gives the same results as
+ * searching the whole query set at once, in each search mode.  The last chunk
+ * is smaller than the others, and an empty chunk is given in the middle.
+ */
+BOOST_AUTO_TEST_CASE(ChunkedQuerySearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(5, 730);
+
+  const NeighborSearchMode modes[3] = { NAIVE_MODE, SINGLE_TREE_MODE,
+      DUAL_TREE_MODE };
+  for (size_t m = 0; m < 3; ++m)
+  {
+    KNN knn(dataset, modes[m]);
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    knn.Search(querySet, 4, neighbors, distances);
+
+    size_t nextPoint = 0;
+    size_t numChunks = 0;
+    arma::Mat<size_t> chunkedNeighbors(4, querySet.n_cols);
+    arma::mat chunkedDistances(4, querySet.n_cols);
+    chunkedNeighbors.fill(querySet.n_cols);
+
+    knn.Search([&](arma::mat& chunk)
+        {
+          if (nextPoint == querySet.n_cols)
+            return false;
+
+          ++numChunks;
+          if (numChunks == 3)
+          {
+            chunk.reset();
+            return true;
+          }
+
+          const size_t end = std::min(nextPoint + 100,
+              (size_t) querySet.n_cols);
+          chunk = querySet.cols(nextPoint, end - 1);
+          nextPoint = end;
+          return true;
+        },
+        4,
+        [&](const size_t first,
+            const arma::Mat<size_t>& chunkNeighbors,
+            const arma::mat& chunkDistances)
+        {
+          BOOST_REQUIRE_EQUAL(chunkNeighbors.n_rows, 4);
+          BOOST_REQUIRE_EQUAL(chunkDistances.n_cols, chunkNeighbors.n_cols);
+          chunkedNeighbors.cols(first, first + chunkNeighbors.n_cols - 1) =
+              chunkNeighbors;
+          chunkedDistances.cols(first, first + chunkDistances.n_cols - 1) =
+              chunkDistances;
+        });
+
+    BOOST_REQUIRE_EQUAL(numChunks, 9);
+    CheckMatrices(neighbors, chunkedNeighbors);
+    CheckMatrices(distances, chunkedDistances);
+  }
+}
+
+/**
+ * Ensure that NSModel can search a stream of query chunks.
+ */
+BOOST_AUTO_TEST_CASE(KNNModelChunkedQuerySearchTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat dataset = arma::randu<arma::mat>(5, 500);
+  arma::mat querySet = arma::randu<arma::mat>(5, 250);
+
+  KNNModel model(KNNModel::TreeTypes::KD_TREE, true);
+  arma::mat datasetCopy(dataset);
+  model.BuildModel(std::move(datasetCopy), 20, DUAL_TREE_MODE);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  arma::mat queryCopy(querySet);
+  model.Search(std::move(queryCopy), 3, neighbors, distances);
+
+  size_t nextPoint = 0;
+  arma::Mat<size_t> chunkedNeighbors(3, querySet.n_cols);
+  arma::mat chunkedDistances(3, querySet.n_cols);
+
+  model.Search([&](arma::mat& chunk)
+      {
+        if (nextPoint == querySet.n_cols)
+          return false;
+
+        const size_t end = std::min(nextPoint + 60, (size_t) querySet.n_cols);
+        chunk = querySet.cols(nextPoint, end - 1);
+        nextPoint = end;
+        return true;
+      },
+      3,
+      [&](const size_t first,
+          const arma::Mat<size_t>& chunkNeighbors,
+          const arma::mat& chunkDistances)
+      {
+        chunkedNeighbors.cols(first, first + chunkNeighbors.n_cols - 1) =
+            chunkNeighbors;
+        chunkedDistances.cols(first, first + chunkDistances.n_cols - 1) =
+            chunkDistances;
+      });
+
+  CheckMatrices(neighbors, chunkedNeighbors);
+  CheckMatrices(distances, chunkedDistances);
+}
+
+/**
+ * Ensure that ServeQueries() answers each batch of queries like a direct search
+ * with the model, and answers a malformed batch with an error.
+ */
+BOOST_AUTO_TEST_CASE(ServeQueriesTest)
+{
+  typedef NSModel<NearestNeighborSort> KNNModel;
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 300);
+  arma::mat querySet = arma::randu<arma::mat>(3, 25);
+
+  KNNModel model(KNNModel::TreeTypes::KD_TREE, false);
+  arma::mat datasetCopy(dataset);
+  model.BuildModel(std::move(datasetCopy), 20, DUAL_TREE_MODE);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  arma::mat queryCopy(querySet);
+  model.Search(std::move(queryCopy), 2, neighbors, distances);
+
+  // The first batch holds 10 points and the last one 15; the one in between
+  // has a point with the wrong dimensionality.
+  std::stringstream input;
+  input.precision(20);
+  input << std::endl;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    if (i == 10)
+    {
+      input << std::endl << "0.5, 0.5" << std::endl << "0.1 0.2 0.3"
+          << std::endl << std::endl;
+    }
+    input << querySet(0, i) << ", " << querySet(1, i) << " " << querySet(2, i)
+        << std::endl;
+  }
+
+  std::stringstream output;
+  BOOST_REQUIRE_EQUAL(ServeQueries(model, 2, input, output), 2);
+
+  std::string line;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    if (i == 10)
+    {
+      std::getline(output, line);
+      BOOST_REQUIRE(line.empty());
+      std::getline(output, line);
+      BOOST_REQUIRE_EQUAL(line.substr(0, 7), "error: ");
+      std::getline(output, line);
+      BOOST_REQUIRE(line.empty());
+    }
+
+    std::getline(output, line);
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream lineStream(line);
+
+    size_t neighbor;
+    double distance;
+    for (size_t j = 0; j < 2; ++j)
+    {
+      BOOST_REQUIRE(lineStream >> neighbor);
+      BOOST_REQUIRE_EQUAL(neighbor, neighbors(j, i));
+    }
+    for (size_t j = 0; j < 2; ++j)
+    {
+      BOOST_REQUIRE(lineStream >> distance);
+      BOOST_REQUIRE_CLOSE(distance, distances(j, i), 1e-5);
+    }
+  }
+
+  std::getline(output, line);
+  BOOST_REQUIRE(line.empty());
+  BOOST_REQUIRE(!std::getline(output, line));
+}
+
+/**
+ * Ensure that searching a sharded reference set gives the same results as
+ * searching the whole reference set, including when a shard has fewer than k
+ * points.
+ */
+BOOST_AUTO_TEST_CASE(ShardedSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(4, 300);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(querySet, 6, neighbors, distances);
+
+  const NeighborSearchMode modes[3] = { NAIVE_MODE, SINGLE_TREE_MODE,
+      DUAL_TREE_MODE };
+  for (size_t m = 0; m < 3; ++m)
+  {
+    std::vector<arma::mat> shards;
+    shards.push_back(dataset.cols(0, 399));
+    shards.push_back(dataset.cols(400, 402));
+    shards.push_back(dataset.cols(403, 999));
+
+    ShardedNeighborSearch<> sharded(std::move(shards), modes[m]);
+    BOOST_REQUIRE_EQUAL(sharded.NumShards(), 3);
+    BOOST_REQUIRE_EQUAL(sharded.ShardOffset(2), 403);
+
+    arma::Mat<size_t> shardedNeighbors;
+    arma::mat shardedDistances;
+    sharded.Search(querySet, 6, shardedNeighbors, shardedDistances);
+
+    CheckMatrices(neighbors, shardedNeighbors);
+    CheckMatrices(distances, shardedDistances);
+  }
+}
+
+/**
+ * Ensure that shards far away from all of the query points are not searched.
+ */
+BOOST_AUTO_TEST_CASE(ShardedSearchPruningTest)
+{
+  std::vector<arma::mat> shards;
+  arma::mat dataset;
+  for (size_t i = 0; i < 4; ++i)
+  {
+    arma::mat shard = arma::randu<arma::mat>(3, 200);
+    shard.row(0) += 10.0 * i;
+    dataset = arma::join_rows(dataset, shard);
+    shards.push_back(std::move(shard));
+  }
+
+  // All of the query points are inside the region of the third shard.
+  arma::mat querySet = arma::randu<arma::mat>(3, 50);
+  querySet.row(0) += 20.0;
+
+  ShardedNeighborSearch<> sharded(std::move(shards));
+  arma::Mat<size_t> shardedNeighbors;
+  arma::mat shardedDistances;
+  sharded.Search(querySet, 3, shardedNeighbors, shardedDistances);
+
+  BOOST_REQUIRE_EQUAL(sharded.ShardSearches(), 1);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(querySet, 3, neighbors, distances);
+
+  CheckMatrices(neighbors, shardedNeighbors);
+  CheckMatrices(distances, shardedDistances);
+}
+
+/**
+ * Ensure that DynamicNeighborSearch gives the same results as NeighborSearch
+ * built on the points that were inserted and not removed, and that it keeps a
+ * logarithmic number of buckets.
+ */
+BOOST_AUTO_TEST_CASE(DynamicSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+
+  const NeighborSearchMode modes[3] = { NAIVE_MODE, SINGLE_TREE_MODE,
+      DUAL_TREE_MODE };
+  for (size_t m = 0; m < 3; ++m)
+  {
+    DynamicNeighborSearch<> dynamic(modes[m]);
+
+    // Insert the points in batches of different sizes.
+    size_t inserted = 0;
+    for (size_t batch = 1; inserted < dataset.n_cols; batch += 37)
+    {
+      const size_t end = std::min(inserted + batch, (size_t) dataset.n_cols);
+      BOOST_REQUIRE_EQUAL(dynamic.Insert(dataset.cols(inserted, end - 1)),
+          inserted);
+      inserted = end;
+    }
+    BOOST_REQUIRE_EQUAL(dynamic.NumPoints(), dataset.n_cols);
+    BOOST_REQUIRE_LE(dynamic.NumBuckets(), 12);
+
+    // Remove every third point, in two calls, so that some buckets are
+    // rebuilt and others keep removed points.
+    std::vector<size_t> first, second;
+    for (size_t i = 0; i < dataset.n_cols; i += 3)
+      ((i % 2 == 0) ? first : second).push_back(i);
+    dynamic.Remove(first);
+    dynamic.Remove(second);
+
+    std::vector<size_t> live;
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      if (i % 3 != 0)
+        live.push_back(i);
+    BOOST_REQUIRE_EQUAL(dynamic.NumPoints(), live.size());
+
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    dynamic.Search(querySet, 5, neighbors, distances);
+
+    arma::mat liveDataset = dataset.cols(arma::conv_to<arma::uvec>::from(live));
+    KNN knn(liveDataset);
+    arma::Mat<size_t> trueNeighbors;
+    arma::mat trueDistances;
+    knn.Search(querySet, 5, trueNeighbors, trueDistances);
+
+    for (size_t i = 0; i < trueNeighbors.n_elem; ++i)
+    {
+      BOOST_REQUIRE_EQUAL(neighbors[i], live[trueNeighbors[i]]);
+      BOOST_REQUIRE_CLOSE(distances[i], trueDistances[i], 1e-5);
+    }
+  }
+}
+
+/**
+ * Ensure that removing all of the points of DynamicNeighborSearch leaves no
+ * buckets, and that searching then finds no neighbors.
+ */
+BOOST_AUTO_TEST_CASE(DynamicSearchRemoveAllTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 100);
+
+  DynamicNeighborSearch<> dynamic;
+  dynamic.Insert(dataset);
+
+  std::vector<size_t> all(dataset.n_cols);
+  for (size_t i = 0; i < all.size(); ++i)
+    all[i] = i;
+  dynamic.Remove(all);
+
+  BOOST_REQUIRE_EQUAL(dynamic.NumPoints(), 0);
+  BOOST_REQUIRE_EQUAL(dynamic.NumBuckets(), 0);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  dynamic.Search(dataset, 2, neighbors, distances);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], size_t() - 1);
+    BOOST_REQUIRE_EQUAL(distances[i], DBL_MAX);
+  }
+
+  BOOST_REQUIRE_THROW(dynamic.Remove(std::vector<size_t>(1, 100)),
+      std::invalid_argument);
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Ensure that the parallel dual-tree search over query subtrees gives the same
+ * results as the search with a single thread, for both the bichromatic and the
+ * monochromatic case.
+ */
+BOOST_AUTO_TEST_CASE(ParallelDualTreeSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 3000);
+  arma::mat querySet = arma::randu<arma::mat>(4, 2000);
+
+  KNN knn(dataset);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+
+  arma::Mat<size_t> sequentialNeighbors, sequentialMonoNeighbors;
+  arma::mat sequentialDistances, sequentialMonoDistances;
+  knn.Search(querySet, 6, sequentialNeighbors, sequentialDistances);
+  knn.Search(6, sequentialMonoNeighbors, sequentialMonoDistances);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+
+  arma::Mat<size_t> parallelNeighbors, parallelMonoNeighbors;
+  arma::mat parallelDistances, parallelMonoDistances;
+  knn.Search(querySet, 6, parallelNeighbors, parallelDistances);
+  knn.Search(6, parallelMonoNeighbors, parallelMonoDistances);
+
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(sequentialNeighbors, parallelNeighbors);
+  CheckMatrices(sequentialDistances, parallelDistances);
+  CheckMatrices(sequentialMonoNeighbors, parallelMonoNeighbors);
+  CheckMatrices(sequentialMonoDistances, parallelMonoDistances);
+}
+#endif
+
+/**
+ * Ensure that collecting traversal statistics does not change the results, and
+ * that the statistics agree with the counts of the rules, for single-tree and
+ * dual-tree search with kd-trees and cover trees.
+ */
+template<typename KNNType>
+void CheckTraversalStatistics(const NeighborSearchMode mode)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 500);
+
+  KNNType knn(dataset, mode);
+  arma::Mat<size_t> neighbors, instrumentedNeighbors;
+  arma::mat distances, instrumentedDistances;
+  knn.Search(querySet, 5, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(knn.Statistics().Visits(), 0);
+
+  knn.CollectStatistics() = true;
+  knn.Search(querySet, 5, instrumentedNeighbors, instrumentedDistances);
+
+  CheckMatrices(neighbors, instrumentedNeighbors);
+  CheckMatrices(distances, instrumentedDistances);
+
+  const TraversalStatistics& statistics = knn.Statistics();
+  BOOST_REQUIRE_EQUAL(statistics.Visits(), knn.Scores());
+  BOOST_REQUIRE_GE(statistics.BaseCases(), knn.BaseCases());
+  BOOST_REQUIRE_GT(statistics.Prunes(), 0);
+  BOOST_REQUIRE_LE(statistics.Prunes(), statistics.Visits());
+  BOOST_REQUIRE_GT(statistics.Depths(), 1);
+  BOOST_REQUIRE_EQUAL(statistics.VisitsByDepth().size(), statistics.Depths());
+  BOOST_REQUIRE_EQUAL(statistics.PrunesByDepth().size(), statistics.Depths());
+}
+
+BOOST_AUTO_TEST_CASE(TraversalStatisticsTest)
+{
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> CoverTreeKNN;
+
+  CheckTraversalStatistics<KNN>(SINGLE_TREE_MODE);
+  CheckTraversalStatistics<KNN>(DUAL_TREE_MODE);
+  CheckTraversalStatistics<CoverTreeKNN>(SINGLE_TREE_MODE);
+  CheckTraversalStatistics<CoverTreeKNN>(DUAL_TREE_MODE);
+  CheckTraversalStatistics<KNN>(BEST_FIRST_SINGLE_TREE_MODE);
+  CheckTraversalStatistics<CoverTreeKNN>(BEST_FIRST_SINGLE_TREE_MODE);
+}
+
+/**
+ * Make sure that best-first search without a budget gives the same results as
+ * naive search, with the given type of search.
+ */
+template<typename KNNType>
+void CheckBestFirstSearch(KNNType& knn,
+                          const arma::mat& dataset,
+                          const arma::mat& querySet)
+{
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  knn.SearchMode() = BEST_FIRST_SINGLE_TREE_MODE;
+  knn.Search(querySet, 5, neighbors, distances);
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  knn.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+BOOST_AUTO_TEST_CASE(BestFirstSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(5, 200);
+
+  KNN knn(dataset);
+  CheckBestFirstSearch(knn, dataset, querySet);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> coverTreeKNN(dataset);
+  CheckBestFirstSearch(coverTreeKNN, dataset, querySet);
+
+  // Points are shared by overlapping nodes of the spill tree, but they must
+  // only be found once.
+  SpillKNN::Tree referenceTree(dataset, 0.1 /* tau */);
+  SpillKNN spillKNN(std::move(referenceTree));
+  CheckBestFirstSearch(spillKNN, dataset, querySet);
+}
+
+/**
+ * Make sure that best-first search respects the budget of base cases, always
+ * finds k neighbors, and that a larger budget never gives worse neighbors.
+ */
+BOOST_AUTO_TEST_CASE(BestFirstSearchBudgetTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 2000);
+  arma::mat querySet = arma::randu<arma::mat>(5, 200);
+
+  KNN knn(dataset, BEST_FIRST_SINGLE_TREE_MODE);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances, lastDistances;
+
+  const size_t budgets[] = { 5, 20, 100, 500 };
+  for (size_t b = 0; b < 4; ++b)
+  {
+    knn.MaxBaseCases() = budgets[b];
+    knn.Search(querySet, 5, neighbors, distances);
+
+    BOOST_REQUIRE_LE(knn.BaseCases(), budgets[b] * querySet.n_cols);
+    BOOST_REQUIRE_EQUAL(arma::accu(neighbors >= dataset.n_cols), 0);
+
+    // Each traversal computes the same base cases as with a smaller budget,
+    // and then some more.
+    if (b > 0)
+    {
+      for (size_t i = 0; i < distances.n_elem; ++i)
+        BOOST_REQUIRE_LE(distances[i], lastDistances[i]);
+    }
+    lastDistances = distances;
+  }
+
+  // A budget of leaves works the same way.
+  knn.MaxBaseCases() = 0;
+  knn.MaxLeaves() = 1;
+  knn.Search(querySet, 5, neighbors, distances);
+  BOOST_REQUIRE_EQUAL(arma::accu(neighbors >= dataset.n_cols), 0);
+  BOOST_REQUIRE_LT(knn.BaseCases(), dataset.n_cols * querySet.n_cols / 10);
+
+  // Without a budget, the search is exact.
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  knn.MaxLeaves() = 0;
+  knn.Search(querySet, 5, neighbors, distances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure that single-tree search with blocks of query points gives the same
+ * results as naive search, for trees with and without a block traverser.
+ */
+template<typename KNNType>
+void CheckQueryBlockSearch(const arma::mat& dataset, const arma::mat& querySet)
+{
+  KNNType knn(dataset, SINGLE_TREE_MODE);
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+
+  naive.Search(querySet, 5, naiveNeighbors, naiveDistances);
+
+  const size_t blockSizes[] = { 2, 7, 64, 1000 };
+  for (size_t b = 0; b < 4; ++b)
+  {
+    knn.QueryBlockSize() = blockSizes[b];
+    knn.Search(querySet, 5, neighbors, distances);
+
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+  }
+
+  knn.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+BOOST_AUTO_TEST_CASE(QueryBlockSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(4, 300);
+
+  CheckQueryBlockSearch<KNN>(dataset, querySet);
+  CheckQueryBlockSearch<NeighborSearch<NearestNeighborSort, EuclideanDistance,
+      arma::mat, BallTree>>(dataset, querySet);
+  CheckQueryBlockSearch<NeighborSearch<NearestNeighborSort, EuclideanDistance,
+      arma::mat, StandardCoverTree>>(dataset, querySet);
+}
+
+/**
+ * Make sure that the block traverser visits the same base cases as the
+ * single-tree traverser when each block holds a single query point, and fewer
+ * nodes with larger blocks since the nodes are then shared by the block.
+ */
+BOOST_AUTO_TEST_CASE(BlockSingleTreeTraverserTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+
+  typedef KNN::Tree Tree;
+  typedef NeighborSearchRules<NearestNeighborSort, EuclideanDistance, Tree>
+      RuleType;
+  std::vector<size_t> oldFromNew;
+  Tree tree(dataset, oldFromNew);
+  EuclideanDistance metric;
+
+  RuleType rules(tree.Dataset(), querySet, 3, metric);
+  Tree::SingleTreeTraverser<RuleType> traverser(rules);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    traverser.Traverse(i, tree);
+
+  RuleType blockRules(tree.Dataset(), querySet, 3, metric);
+  Tree::BlockSingleTreeTraverser<RuleType> blockTraverser(blockRules);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    blockTraverser.Traverse(std::vector<size_t>(1, i), tree);
+
+  BOOST_REQUIRE_EQUAL(blockRules.BaseCases(), rules.BaseCases());
+  BOOST_REQUIRE_EQUAL(blockRules.Scores(), rules.Scores());
+  BOOST_REQUIRE_EQUAL(blockTraverser.NumPrunes(), traverser.NumPrunes());
+
+  arma::Mat<size_t> neighbors, blockNeighbors;
+  arma::mat distances, blockDistances;
+  rules.GetResults(neighbors, distances);
+  blockRules.GetResults(blockNeighbors, blockDistances);
+  CheckMatrices(neighbors, blockNeighbors);
+  CheckMatrices(distances, blockDistances);
+
+  // All the query points at once.
+  std::vector<size_t> block(querySet.n_cols);
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+    block[i] = i;
+
+  RuleType allRules(tree.Dataset(), querySet, 3, metric);
+  Tree::BlockSingleTreeTraverser<RuleType> allTraverser(allRules);
+  allTraverser.Traverse(block, tree);
+
+  allRules.GetResults(blockNeighbors, blockDistances);
+  CheckMatrices(neighbors, blockNeighbors);
+  CheckMatrices(distances, blockDistances);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
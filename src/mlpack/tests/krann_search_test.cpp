@@ -715,4 +715,80 @@ BOOST_AUTO_TEST_CASE(RAModelTest)
   }
 }
 
+#ifdef HAS_OPENMP
+/**
+ * Ensure that the parallel single-tree search gives the same results for the
+ * same random seed with any number of threads, and that it still gives the
+ * rank-approximation guarantee.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSingleTreeSearchTest)
+{
+  arma::mat refData;
+  arma::mat queryData;
+
+  data::Load("rann_test_r_3_900.csv", refData, true);
+  data::Load("rann_test_q_3_100.csv", queryData, true);
+
+  RASearch<> tssRann(refData, false, true, 1.0, 0.95, false, false);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  arma::Mat<size_t> sequentialNeighbors, sequentialMonoNeighbors;
+  arma::mat sequentialDistances, sequentialMonoDistances;
+  omp_set_num_threads(1);
+  math::RandomSeed(42);
+  tssRann.Search(queryData, 1, sequentialNeighbors, sequentialDistances);
+  tssRann.Search(1, sequentialMonoNeighbors, sequentialMonoDistances);
+
+  // Force multiple threads, even if only one core is available.
+  arma::Mat<size_t> parallelNeighbors, parallelMonoNeighbors;
+  arma::mat parallelDistances, parallelMonoDistances;
+  omp_set_num_threads(4);
+  math::RandomSeed(42);
+  tssRann.Search(queryData, 1, parallelNeighbors, parallelDistances);
+  tssRann.Search(1, parallelMonoNeighbors, parallelMonoDistances);
+
+  CheckMatrices(sequentialNeighbors, parallelNeighbors);
+  CheckMatrices(sequentialDistances, parallelDistances);
+  CheckMatrices(sequentialMonoNeighbors, parallelMonoNeighbors);
+  CheckMatrices(sequentialMonoDistances, parallelMonoDistances);
+
+  // The relative ranks for the given query reference pair.
+  arma::Mat<size_t> qrRanks;
+  data::Load("rann_test_qr_ranks.csv", qrRanks, true, false); // No transpose.
+
+  size_t numRounds = 1000;
+  arma::Col<size_t> numSuccessRounds(queryData.n_cols);
+  numSuccessRounds.fill(0);
+
+  // 1% of 900 is 9, so the rank is expected to be less than 10.
+  size_t expectedRankErrorUB = 10;
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  for (size_t rounds = 0; rounds < numRounds; rounds++)
+  {
+    tssRann.Search(queryData, 1, neighbors, distances);
+
+    for (size_t i = 0; i < queryData.n_cols; i++)
+      if (qrRanks(i, neighbors(0, i)) < expectedRankErrorUB)
+        numSuccessRounds[i]++;
+  }
+
+  omp_set_num_threads(prevNumThreads);
+
+  // Find the 95%-tile threshold so that 95% of the queries should pass this
+  // threshold.
+  size_t threshold = floor(numRounds *
+      (0.95 - (1.96 * sqrt(0.95 * 0.05 / numRounds))));
+  size_t numQueriesFail = 0;
+  for (size_t i = 0; i < queryData.n_cols; i++)
+    if (numSuccessRounds[i] < threshold)
+      numQueriesFail++;
+
+  // Assert that at most 5% of the queries fall out of this threshold.
+  BOOST_REQUIRE_LT(numQueriesFail, (size_t) 6);
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -352,4 +352,99 @@ BOOST_AUTO_TEST_CASE(TrainingConstructorWithNonDefaultsTest)
     BOOST_REQUIRE_CLOSE(beta[i], lars2.Beta()[i], 1e-5);
 }
 
+/**
+ * Make sure that training on several targets at once gives the same solutions
+ * as training on each target separately.
+ */
+BOOST_AUTO_TEST_CASE(MultipleTargetsTest)
+{
+  const size_t nPoints = 200;
+  const size_t nDims = 20;
+  const size_t nTargets = 12;
+
+  arma::mat X = arma::randn(nDims, nPoints);
+  arma::mat y = arma::randn(nTargets, nDims) * X;
+
+  for (size_t useCholesky = 0; useCholesky < 2; ++useCholesky)
+  {
+    LARS lars((useCholesky == 1), 0.5, 0.1);
+    arma::mat betas;
+    lars.Train(X, y, betas);
+
+    BOOST_REQUIRE_EQUAL(betas.n_rows, nDims);
+    BOOST_REQUIRE_EQUAL(betas.n_cols, nTargets);
+
+    for (size_t t = 0; t < nTargets; ++t)
+    {
+      LARS single((useCholesky == 1), 0.5, 0.1);
+      arma::vec beta;
+      single.Train(X, arma::rowvec(y.row(t)), beta);
+
+      CheckMatrices(betas.col(t), beta);
+
+      // The model keeps the path of the last target.
+      if (t == nTargets - 1)
+      {
+        CheckMatrices(lars.Beta(), beta);
+        BOOST_REQUIRE_EQUAL(lars.ActiveSet().size(), single.ActiveSet().size());
+      }
+    }
+  }
+
+  // The number of points in the responses must match the data.
+  LARS lars;
+  arma::mat betas;
+  BOOST_REQUIRE_THROW(lars.Train(X, arma::mat(3, nPoints + 1), betas),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that LARS on sparse data finds the same solution as on the same
+ * data stored densely, with and without regularization, and that the sparse
+ * predictions match.
+ */
+BOOST_AUTO_TEST_CASE(SparseLARSTest)
+{
+  const size_t nPoints = 200;
+  const size_t nDims = 30;
+
+  arma::sp_mat sparseX;
+  sparseX.sprandn(nDims, nPoints, 0.2);
+  const arma::mat X(sparseX);
+  const arma::rowvec y = arma::randn<arma::vec>(nDims).t() * X;
+
+  for (size_t regularization = 0; regularization < 3; ++regularization)
+  {
+    const double lambda1 = (regularization > 0) ? 0.5 : 0.0;
+    const double lambda2 = (regularization > 1) ? 0.1 : 0.0;
+
+    // The sparse path always uses the Cholesky factorization, so compare with
+    // both dense variants.
+    LARS sparseLars(false, lambda1, lambda2);
+    arma::vec sparseBeta;
+    sparseLars.Train(sparseX, y, sparseBeta);
+
+    for (size_t useCholesky = 0; useCholesky < 2; ++useCholesky)
+    {
+      LARS lars((useCholesky == 1), lambda1, lambda2);
+      arma::vec beta;
+      lars.Train(X, y, beta);
+
+      BOOST_REQUIRE_EQUAL(sparseBeta.n_elem, beta.n_elem);
+      for (size_t i = 0; i < beta.n_elem; ++i)
+      {
+        if (std::abs(beta[i]) < 1e-6)
+          BOOST_REQUIRE_SMALL(sparseBeta[i], 1e-6);
+        else
+          BOOST_REQUIRE_CLOSE(sparseBeta[i], beta[i], 1e-4);
+      }
+    }
+
+    arma::rowvec predictions, sparsePredictions;
+    sparseLars.Predict(X, predictions);
+    sparseLars.Predict(sparseX, sparsePredictions);
+    CheckMatrices(predictions, sparsePredictions);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
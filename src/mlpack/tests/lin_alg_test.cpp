@@ -78,6 +78,20 @@ BOOST_AUTO_TEST_CASE(TestCenterB)
       BOOST_REQUIRE_CLOSE(tmp_out(row, col), (double) (col - 2.5) * row, 1e-5);
 }
 
+/**
+ * Make sure that CenterInPlace() gives the same results as Center().
+ */
+BOOST_AUTO_TEST_CASE(TestCenterInPlace)
+{
+  mat tmp = randu<mat>(5, 20);
+  mat tmp_out;
+  Center(tmp, tmp_out);
+
+  CenterInPlace(tmp);
+  for (size_t i = 0; i < tmp.n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(tmp[i], tmp_out[i], 1e-5);
+}
+
 BOOST_AUTO_TEST_CASE(TestWhitenUsingEig)
 {
   // After whitening using eigendecomposition, the covariance of
@@ -109,6 +123,101 @@ BOOST_AUTO_TEST_CASE(TestWhitenUsingEig)
   }
 }
 
+/**
+ * Make sure that the in-place WhitenUsingEig() and WhitenUsingSVD() give the
+ * same results as the ones that write to another matrix.
+ */
+BOOST_AUTO_TEST_CASE(TestWhitenInPlace)
+{
+  mat tmp = randu<mat>(6, 3000);
+  mat whitened, whiteningMatrix, inPlaceWhiteningMatrix;
+
+  WhitenUsingEig(tmp, whitened, whiteningMatrix);
+  mat inPlace(tmp);
+  WhitenUsingEig(inPlace, inPlaceWhiteningMatrix);
+  CheckMatrices(whiteningMatrix, inPlaceWhiteningMatrix);
+  CheckMatrices(whitened, inPlace);
+
+  WhitenUsingSVD(tmp, whitened, whiteningMatrix);
+  inPlace = tmp;
+  WhitenUsingSVD(inPlace, inPlaceWhiteningMatrix);
+  CheckMatrices(whiteningMatrix, inPlaceWhiteningMatrix);
+  CheckMatrices(whitened, inPlace);
+}
+
+/**
+ * Make sure TransformInPlace() gives the same result as a multiplication, for
+ * block sizes that do and don't divide the number of columns.
+ */
+BOOST_AUTO_TEST_CASE(TestTransformInPlace)
+{
+  mat transformation = randu<mat>(4, 4);
+  mat tmp = randu<mat>(4, 100);
+  const mat expected = transformation * tmp;
+
+  for (size_t blockSize = 1; blockSize < 120; blockSize += 17)
+  {
+    mat transformed(tmp);
+    TransformInPlace(transformation, transformed, blockSize);
+    CheckMatrices(expected, transformed);
+  }
+
+  mat wrong = randu<mat>(3, 4);
+  BOOST_REQUIRE_THROW(TransformInPlace(wrong, tmp), std::invalid_argument);
+}
+
+/**
+ * Make sure that the streaming covariance gives the same mean and covariance as
+ * ccov(), for several chunk sizes.
+ */
+BOOST_AUTO_TEST_CASE(TestCovariance)
+{
+  // Offset the points, so that the uncentered outer products are large.
+  mat tmp = randn<mat>(5, 1000) + 100.0;
+  const vec expectedMean = arma::mean(tmp, 1);
+  const mat expected = ccov(tmp);
+  const mat expectedBiased = ccov(tmp, 1);
+
+  const size_t chunkSizes[] = { 1, 7, 100, 1000, 5000 };
+  for (size_t c = 0; c < 5; ++c)
+  {
+    vec mean;
+    mat covariance;
+    Covariance(tmp, mean, covariance, 0, chunkSizes[c]);
+    CheckMatrices(expectedMean, mean, 1e-5);
+    CheckMatrices(expected, covariance, 1e-5);
+
+    Covariance(tmp, mean, covariance, 1, chunkSizes[c]);
+    CheckMatrices(expectedBiased, covariance, 1e-5);
+  }
+}
+
+/**
+ * Make sure that merging two CovarianceAccumulators is the same as adding all
+ * the points to one accumulator.
+ */
+BOOST_AUTO_TEST_CASE(TestCovarianceAccumulatorMerge)
+{
+  mat tmp = randu<mat>(4, 300);
+
+  CovarianceAccumulator all(4), first(4), second(4);
+  all.Update(tmp);
+  first.Update(tmp.cols(0, 99));
+  second.Update(tmp.cols(100, 199));
+  second.Update(tmp.cols(200, 299));
+  first.Merge(second);
+
+  BOOST_REQUIRE_EQUAL(first.Count(), 300);
+  CheckMatrices(all.Mean(), first.Mean(), 1e-5);
+  CheckMatrices(all.CoMoment(), first.CoMoment(), 1e-5);
+
+  mat covariance;
+  first.Covariance(covariance);
+  CheckMatrices(ccov(tmp), covariance, 1e-5);
+
+  BOOST_REQUIRE_THROW(first.Update(randu<mat>(3, 10)), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_CASE(TestOrthogonalize)
 {
   // Generate a random matrix; then, orthogonalize it and test if it's
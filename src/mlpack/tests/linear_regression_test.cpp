@@ -224,4 +224,176 @@ BOOST_AUTO_TEST_CASE(LinearRegressionTest)
       binaryLr.Parameters());
 }
 
+/**
+ * Make sure that a model trained on the normal equations accumulated over
+ * chunks of the data is the same as the model trained on all of the data.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionAccumulatorTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(6, 5000);
+  arma::rowvec responses = arma::randu<arma::rowvec>(5000);
+  arma::rowvec weights = arma::randu<arma::rowvec>(5000);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    for (size_t weighted = 0; weighted < 2; ++weighted)
+    {
+      LinearRegression lr;
+      lr.Lambda() = 0.1;
+      LinearRegressionAccumulator accumulator(dataset.n_rows,
+          (intercept == 1));
+
+      // Chunks of uneven size, some spanning several blocks.
+      for (size_t begin = 0; begin < dataset.n_cols; begin += 1500)
+      {
+        const size_t end = std::min(begin + 1500, (size_t) dataset.n_cols) - 1;
+        if (weighted == 1)
+        {
+          accumulator.Add(dataset.cols(begin, end),
+              responses.subvec(begin, end), weights.subvec(begin, end));
+        }
+        else
+        {
+          accumulator.Add(dataset.cols(begin, end),
+              responses.subvec(begin, end));
+        }
+      }
+
+      if (weighted == 1)
+        lr.Train(dataset, responses, weights, (intercept == 1));
+      else
+        lr.Train(dataset, responses, (intercept == 1));
+
+      BOOST_REQUIRE_CLOSE(accumulator.TotalWeight(), (weighted == 1) ?
+          arma::accu(weights) : 5000.0, 1e-8);
+
+      LinearRegression streamingLr(accumulator, 0.1);
+      BOOST_REQUIRE_EQUAL(streamingLr.Intercept(), (intercept == 1));
+      CheckMatrices(streamingLr.Parameters(), lr.Parameters());
+
+      // Without weights, the error returned by Train() is the training error.
+      if (weighted == 0)
+      {
+        LinearRegression trainLr;
+        trainLr.Lambda() = 0.1;
+        const double error = trainLr.Train(accumulator);
+        BOOST_REQUIRE_CLOSE(error, lr.ComputeError(dataset, responses), 1e-5);
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that merging accumulators gives the same statistics as
+ * accumulating all of the data in one accumulator.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionAccumulatorMergeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 3000);
+  arma::rowvec responses = arma::randu<arma::rowvec>(3000);
+
+  LinearRegressionAccumulator all(4), first(4), second(4);
+  all.Add(dataset, responses);
+  first.Add(dataset.cols(0, 1999), responses.subvec(0, 1999));
+  second.Add(dataset.cols(2000, 2999), responses.subvec(2000, 2999));
+  first.Add(second);
+
+  BOOST_REQUIRE_CLOSE(first.TotalWeight(), all.TotalWeight(), 1e-8);
+  BOOST_REQUIRE_CLOSE(first.SquaredResponses(), all.SquaredResponses(), 1e-8);
+  CheckMatrices(first.Gram(), all.Gram(), 1e-6);
+  CheckMatrices(first.Moment(), all.Moment(), 1e-6);
+
+  // Accumulators with a different shape can't be merged.
+  LinearRegressionAccumulator other(5);
+  BOOST_REQUIRE_THROW(first.Add(other), std::invalid_argument);
+  BOOST_REQUIRE_THROW(first.Add(arma::mat(5, 10), arma::rowvec(10)),
+      std::invalid_argument);
+
+  first.Reset();
+  BOOST_REQUIRE_EQUAL(first.TotalWeight(), 0.0);
+  BOOST_REQUIRE_THROW(LinearRegression lr(first), std::invalid_argument);
+}
+
+/**
+ * Make sure training from MatrixReaders gives the same model as training on
+ * the whole dataset.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionMatrixReaderTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 2500);
+  arma::rowvec responses = arma::randu<arma::rowvec>(2500);
+  data::Save("lr_predictors.bin", dataset);
+  data::Save("lr_responses.bin", responses);
+
+  LinearRegression lr(dataset, responses);
+
+  data::MatrixReader predictorReader("lr_predictors.bin");
+  data::MatrixReader responseReader("lr_responses.bin");
+  LinearRegression streamingLr;
+  streamingLr.Train(predictorReader, responseReader, true, 300);
+
+  BOOST_REQUIRE_EQUAL(streamingLr.Parameters().n_elem,
+      lr.Parameters().n_elem);
+  for (size_t i = 0; i < lr.Parameters().n_elem; ++i)
+    BOOST_REQUIRE_CLOSE(streamingLr.Parameters()[i], lr.Parameters()[i], 1e-5);
+
+  // Readers of different lengths are rejected.
+  data::Save("lr_responses.bin", arma::rowvec(responses.subvec(0, 2000)));
+  data::MatrixReader shortPredictorReader("lr_predictors.bin");
+  data::MatrixReader shortResponseReader("lr_responses.bin");
+  BOOST_REQUIRE_THROW(streamingLr.Train(shortPredictorReader,
+      shortResponseReader), std::runtime_error);
+
+  remove("lr_predictors.bin");
+  remove("lr_responses.bin");
+}
+
+/**
+ * Make sure that training on sparse data with conjugate gradients gives the
+ * same model as training on the same data stored densely.
+ */
+BOOST_AUTO_TEST_CASE(LinearRegressionSparseTest)
+{
+  arma::sp_mat sparseDataset;
+  sparseDataset.sprandu(20, 500, 0.1);
+  const arma::mat dataset(sparseDataset);
+  const arma::rowvec responses = arma::randn<arma::vec>(20).t() * dataset +
+      0.1 * arma::randn<arma::rowvec>(500) + 2.0;
+  const arma::rowvec weights = arma::randu<arma::rowvec>(500) + 0.5;
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    for (size_t lambda = 0; lambda < 2; ++lambda)
+    {
+      LinearRegression lr(dataset, responses, weights, 0.5 * lambda,
+          (intercept == 1));
+
+      LinearRegression sparseLr;
+      sparseLr.Lambda() = 0.5 * lambda;
+      const double error = sparseLr.Train(sparseDataset, responses, weights,
+          (intercept == 1));
+
+      BOOST_REQUIRE_EQUAL(sparseLr.Intercept(), (intercept == 1));
+      CheckMatrices(lr.Parameters(), sparseLr.Parameters(), 1e-4);
+      BOOST_REQUIRE_CLOSE(error, lr.ComputeError(dataset, responses), 1e-4);
+      BOOST_REQUIRE_CLOSE(sparseLr.ComputeError(sparseDataset, responses),
+          error, 1e-8);
+
+      arma::rowvec predictions, sparsePredictions;
+      lr.Predict(dataset, predictions);
+      sparseLr.Predict(sparseDataset, sparsePredictions);
+      CheckMatrices(predictions, sparsePredictions, 1e-4);
+    }
+  }
+
+  // An unweighted sparse model matches the unweighted dense model.
+  LinearRegression lr(dataset, responses, 0.1);
+  LinearRegression sparseLr(sparseDataset, responses, 0.1);
+  CheckMatrices(lr.Parameters(), sparseLr.Parameters(), 1e-4);
+
+  // The responses must match the points.
+  BOOST_REQUIRE_THROW(sparseLr.Train(sparseDataset, arma::rowvec(499)),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -100,6 +100,108 @@ BOOST_AUTO_TEST_CASE(LMNNImpostorsTest)
   BOOST_REQUIRE_EQUAL(impostors(0, 5), 2);
 }
 
+/**
+ * Recalculating the impostors of some points should give the same results as
+ * recalculating the impostors of all points, and should not touch the other
+ * points.
+ */
+BOOST_AUTO_TEST_CASE(LMNNImpostorsSubsetTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 300);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < labels.n_elem; i++)
+    labels[i] = i % 4;
+
+  Constraints<> constraint(dataset, labels, 3);
+
+  arma::vec norm(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; i++)
+    norm(i) = arma::norm(dataset.col(i));
+
+  arma::Mat<size_t> impostors(3, dataset.n_cols);
+  arma::mat distances(3, dataset.n_cols);
+  constraint.Impostors(impostors, distances, dataset, labels, norm);
+
+  // Only recalculate points of two of the classes.
+  arma::Mat<size_t> subImpostors(3, dataset.n_cols, arma::fill::zeros);
+  arma::mat subDistances(3, dataset.n_cols, arma::fill::zeros);
+  arma::uvec points(dataset.n_cols);
+  size_t numPoints = 0;
+  for (size_t i = 0; i < dataset.n_cols; i += 2)
+    points(numPoints++) = i;
+
+  constraint.Impostors(subImpostors, subDistances, dataset, labels, norm,
+      points, numPoints);
+
+  for (size_t i = 0; i < dataset.n_cols; i++)
+  {
+    for (size_t j = 0; j < 3; j++)
+    {
+      if (i % 2 == 0)
+      {
+        BOOST_REQUIRE_EQUAL(subImpostors(j, i), impostors(j, i));
+        BOOST_REQUIRE_CLOSE(subDistances(j, i), distances(j, i), 1e-5);
+      }
+      else
+      {
+        BOOST_REQUIRE_EQUAL(subImpostors(j, i), 0);
+        BOOST_REQUIRE_EQUAL(subDistances(j, i), 0.0);
+      }
+    }
+  }
+
+  // Recalculating no points should not do anything.
+  constraint.Impostors(subImpostors, subDistances, dataset, labels, norm,
+      points, 0);
+  BOOST_REQUIRE_EQUAL(subImpostors(0, 1), 0);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * The target neighbors and impostors should be the same with one thread and
+ * with many threads, including when there are more classes than threads.
+ */
+BOOST_AUTO_TEST_CASE(LMNNParallelConstraintsTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1000);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < labels.n_elem; i++)
+    labels[i] = i % 7;
+
+  Constraints<> constraint(dataset, labels, 3);
+
+  arma::vec norm(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; i++)
+    norm(i) = arma::norm(dataset.col(i));
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  arma::Mat<size_t> serialTargets(3, dataset.n_cols);
+  arma::Mat<size_t> serialImpostors(3, dataset.n_cols);
+  arma::mat serialDistances(3, dataset.n_cols);
+  constraint.TargetNeighbors(serialTargets, dataset, labels, norm);
+  constraint.Impostors(serialImpostors, serialDistances, dataset, labels,
+      norm);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  arma::Mat<size_t> targets(3, dataset.n_cols);
+  arma::Mat<size_t> impostors(3, dataset.n_cols);
+  arma::mat distances(3, dataset.n_cols);
+  constraint.TargetNeighbors(targets, dataset, labels, norm);
+  constraint.Impostors(impostors, distances, dataset, labels, norm);
+
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(targets, serialTargets);
+  CheckMatrices(impostors, serialImpostors);
+  CheckMatrices(distances, serialDistances);
+}
+
+#endif
+
 //
 // Tests for the LMNNFunction
 //
@@ -148,6 +250,26 @@ BOOST_AUTO_TEST_CASE(LMNNInitialEvaluationTest)
   BOOST_REQUIRE_CLOSE(objective, 9.456, 1e-5);
 }
 
+/**
+ * Shuffling the dataset should keep the cached target neighbors valid, so the
+ * objective should not change.
+ */
+BOOST_AUTO_TEST_CASE(LMNNShuffleEvaluationTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 200);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < labels.n_elem; i++)
+    labels[i] = i % 3;
+
+  LMNNFunction<> lmnnfn(dataset, labels, 3, 0.5, 1);
+  LMNNFunction<> shuffledfn(dataset, labels, 3, 0.5, 1);
+  shuffledfn.Shuffle();
+
+  const arma::mat transformation = arma::eye<arma::mat>(3, 3);
+  BOOST_REQUIRE_CLOSE(shuffledfn.Evaluate(transformation),
+      lmnnfn.Evaluate(transformation), 1e-5);
+}
+
 /**
  * Ensure non-seprable gradient function is right.
  */
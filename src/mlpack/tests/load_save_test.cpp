@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <sstream>
+#include <iomanip>
 
 #include <mlpack/core.hpp>
 #include <mlpack/core/data/load_arff.hpp>
@@ -927,6 +928,80 @@ BOOST_AUTO_TEST_CASE(LoadTextTest)
   BOOST_REQUIRE_EQUAL(y.inb.s, x.inb.s);
 }
 
+// A test structure with matrices large enough to get their own blocks in the
+// mapped format, and a small one that stays in the archive.
+class TestMatrices
+{
+ public:
+  TestMatrices() :
+      large(arma::randu<arma::mat>(100, 200)),
+      labels(arma::randi<arma::Row<size_t>>(3000, arma::distr_param(0, 9))),
+      small(arma::randu<arma::vec>(10)),
+      x(3)
+  { }
+
+  template<typename Archive>
+  void serialize(Archive& ar, const unsigned int /* version */)
+  {
+    ar & BOOST_SERIALIZATION_NVP(large);
+    ar & BOOST_SERIALIZATION_NVP(labels);
+    ar & BOOST_SERIALIZATION_NVP(small);
+    ar & BOOST_SERIALIZATION_NVP(x);
+  }
+
+  // Public members for testing.
+  arma::mat large;
+  arma::Row<size_t> labels;
+  arma::vec small;
+  int x;
+};
+
+/**
+ * Make sure we can load and save in the mapped format, and that the loaded
+ * matrices can be modified without modifying the file.
+ */
+BOOST_AUTO_TEST_CASE(LoadMappedTest)
+{
+  TestMatrices x;
+  x.x = 5;
+  BOOST_REQUIRE_EQUAL(data::Save("test.mbin", "x", x, false), true);
+
+  TestMatrices y;
+  BOOST_REQUIRE_EQUAL(data::Load("test.mbin", "x", y, false), true);
+
+  BOOST_REQUIRE_EQUAL(y.x, x.x);
+  BOOST_REQUIRE_EQUAL(y.large.n_rows, x.large.n_rows);
+  BOOST_REQUIRE_EQUAL(y.large.n_cols, x.large.n_cols);
+  BOOST_REQUIRE_EQUAL(y.labels.n_elem, x.labels.n_elem);
+  BOOST_REQUIRE_EQUAL(y.small.n_elem, x.small.n_elem);
+  for (size_t i = 0; i < x.large.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(y.large[i], x.large[i]);
+  for (size_t i = 0; i < x.labels.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(y.labels[i], x.labels[i]);
+  for (size_t i = 0; i < x.small.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(y.small[i], x.small[i]);
+
+  // The large matrices use the memory of the mapping, which is aligned.
+  BOOST_REQUIRE_EQUAL((size_t) y.large.memptr() %
+      data::MatrixBlocks::alignment, 0);
+
+  y.large.fill(3.0);
+  y.labels.set_size(5);
+
+  TestMatrices z;
+  BOOST_REQUIRE_EQUAL(data::Load("test.mbin", "x", z, false), true);
+  for (size_t i = 0; i < x.large.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(z.large[i], x.large[i]);
+
+  // Other archives are not mapped models.
+  BOOST_REQUIRE_EQUAL(data::Save("test.bin", "x", x, false), true);
+  BOOST_REQUIRE_EQUAL(data::Load("test.bin", "x", z, false, format::mapped),
+      false);
+
+  remove("test.mbin");
+  remove("test.bin");
+}
+
 /**
  * Test DatasetInfo by making a map for a dimension.
  */
@@ -1770,6 +1845,61 @@ BOOST_AUTO_TEST_CASE(HarderARFFTest)
   remove("test.arff");
 }
 
+/**
+ * Make sure a large ARFF file, which is parsed in several chunks, maps its
+ * categorical values in the order of the file.
+ */
+BOOST_AUTO_TEST_CASE(LoadARFFChunksTest)
+{
+  const size_t points = 200000;
+  fstream f;
+  f.open("test.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute a numeric" << endl;
+  f << "@attribute b string" << endl;
+  f << "@attribute c real" << endl;
+  f << "@data" << endl;
+  f << setprecision(10);
+  for (size_t i = 0; i < points; ++i)
+  {
+    // The second category only appears in the second half of the file.
+    const std::string category = (i % 3 == 0) ? "\"x, y\"" :
+        ((i % 3 == 1 && i >= points / 2) ? "late" : "early");
+    f << i << ", " << category << ", " << (0.25 * i) << endl;
+    if (i % 1000 == 0)
+      f << "% comment" << endl << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo info;
+  data::LoadARFF("test.arff", dataset, info);
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, points);
+  BOOST_REQUIRE(info.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(info.NumMappings(1), 3);
+
+  // "x, y" is seen first, then "early", then "late".
+  for (size_t i = 0; i < points; ++i)
+  {
+    const double category = (i % 3 == 0) ? 0.0 :
+        ((i % 3 == 1 && i >= points / 2) ? 2.0 : 1.0);
+    BOOST_REQUIRE_EQUAL(dataset(0, i), i);
+    BOOST_REQUIRE_EQUAL(dataset(1, i), category);
+    BOOST_REQUIRE_EQUAL(dataset(2, i), 0.25 * i);
+  }
+
+  // A bad value is reported, even in a later chunk.
+  f.open("test.arff", fstream::out | fstream::app);
+  f << "1, early, x" << endl;
+  f.close();
+  BOOST_REQUIRE_THROW(data::LoadARFF("test.arff", dataset, info),
+      std::runtime_error);
+
+  remove("test.arff");
+}
+
 /**
  * If we pass a bad DatasetInfo, it should throw.
  */
@@ -2006,4 +2136,276 @@ BOOST_AUTO_TEST_CASE(DatasetMapperNonUniqueTest)
   BOOST_REQUIRE_EQUAL(dm.UnmapString(nan, 0, 2), "cheese");
 }
 
+/**
+ * Test that a CSV large enough to be split into several chunks loads the same
+ * as it would line by line, with the numbers of a categorical dimension mapped
+ * in the order of the file.
+ */
+BOOST_AUTO_TEST_CASE(LoadCSVChunksTest)
+{
+  const size_t points = 200000;
+  fstream f;
+  f.open("test.csv", fstream::out);
+  f << setprecision(10);
+  for (size_t i = 0; i < points; ++i)
+  {
+    f << i << ", " << ((i % 3 == 0) ? "10" : ((i % 3 == 1) ? "x" : "20"))
+        << ", " << (0.25 * i) << endl;
+  }
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo di;
+
+  BOOST_REQUIRE(data::Load("test.csv", dataset, di, false));
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, points);
+
+  BOOST_REQUIRE(di.Type(0) == Datatype::numeric);
+  BOOST_REQUIRE(di.Type(1) == Datatype::categorical);
+  BOOST_REQUIRE(di.Type(2) == Datatype::numeric);
+  BOOST_REQUIRE_EQUAL(di.NumMappings(1), 3);
+
+  // "10" is seen first, then "x", then "20".
+  for (size_t i = 0; i < points; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(dataset(0, i), i);
+    BOOST_REQUIRE_EQUAL(dataset(1, i), i % 3);
+    BOOST_REQUIRE_EQUAL(dataset(2, i), 0.25 * i);
+  }
+
+  remove("test.csv");
+}
+
+/**
+ * Test that a number in the missing set of a MissingPolicy is mapped.
+ */
+BOOST_AUTO_TEST_CASE(LoadCSVNumericMissingTest)
+{
+  fstream f;
+  f.open("test.csv", fstream::out);
+  f << "1, -1, 3" << endl;
+  f << "-1, 5, 6" << endl;
+  f.close();
+
+  arma::mat dataset;
+  MissingPolicy policy({"-1"});
+  DatasetMapper<MissingPolicy> info(policy);
+
+  BOOST_REQUIRE(data::Load("test.csv", dataset, info, false));
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, 2);
+
+  BOOST_REQUIRE_EQUAL(dataset(0, 0), 1.0);
+  BOOST_REQUIRE(std::isnan(dataset(1, 0)));
+  BOOST_REQUIRE_EQUAL(dataset(2, 0), 3.0);
+  BOOST_REQUIRE(std::isnan(dataset(0, 1)));
+  BOOST_REQUIRE_EQUAL(dataset(1, 1), 5.0);
+  BOOST_REQUIRE_EQUAL(dataset(2, 1), 6.0);
+
+  remove("test.csv");
+}
+
+/**
+ * Test that a matrix saved in the mapped matrix format is mapped back as it
+ * was, and that modifying the mapped matrix doesn't modify the file.
+ */
+BOOST_AUTO_TEST_CASE(SaveLoadMappedMatrixTest)
+{
+  arma::mat test = arma::randu<arma::mat>(7, 50);
+  BOOST_REQUIRE(data::Save("test.mmat", test) == true);
+
+  arma::mat loaded;
+  BOOST_REQUIRE(data::Load("test.mmat", loaded) == true);
+
+  // The matrix is never transposed.
+  BOOST_REQUIRE_EQUAL(loaded.n_rows, test.n_rows);
+  BOOST_REQUIRE_EQUAL(loaded.n_cols, test.n_cols);
+  for (size_t i = 0; i < test.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(loaded[i], test[i]);
+
+  loaded.fill(3.0);
+
+  arma::mat reloaded;
+  BOOST_REQUIRE(data::Load("test.mmat", reloaded) == true);
+  for (size_t i = 0; i < test.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(reloaded[i], test[i]);
+
+  // A mapped matrix can only be loaded with its own element type.
+  arma::fmat wrongType;
+  BOOST_REQUIRE(data::Load("test.mmat", wrongType) == false);
+
+  remove("test.mmat");
+}
+
+/**
+ * Make sure MatrixReader gives the points of a dataset in batches, in every
+ * format it supports.
+ */
+BOOST_AUTO_TEST_CASE(MatrixReaderTest)
+{
+  arma::mat test = arma::round(100 * arma::randu<arma::mat>(5, 103));
+
+  const char* files[] = { "test.csv", "test.txt", "test.bin", "test.mmat" };
+  for (size_t f = 0; f < 4; ++f)
+  {
+    BOOST_REQUIRE(data::Save(files[f], test) == true);
+
+    data::MatrixReader reader(files[f]);
+    BOOST_REQUIRE_EQUAL(reader.Dimensionality(), test.n_rows);
+
+    // Read the dataset twice, the second time with another batch size.
+    for (size_t pass = 0; pass < 2; ++pass)
+    {
+      const size_t batchSize = (pass == 0) ? 10 : 31;
+      arma::mat batch;
+      size_t col = 0;
+      while (reader.NextBatch(batch, batchSize))
+      {
+        BOOST_REQUIRE_EQUAL(batch.n_rows, test.n_rows);
+        BOOST_REQUIRE_EQUAL(batch.n_cols,
+            std::min(batchSize, size_t(test.n_cols) - col));
+        for (size_t i = 0; i < batch.n_cols; ++i, ++col)
+          for (size_t j = 0; j < batch.n_rows; ++j)
+            BOOST_REQUIRE_CLOSE(batch(j, i), test(j, col), 1e-5);
+      }
+
+      BOOST_REQUIRE_EQUAL(col, test.n_cols);
+      BOOST_REQUIRE(batch.is_empty());
+      reader.Reset();
+    }
+
+    remove(files[f]);
+  }
+
+  BOOST_REQUIRE_THROW(data::MatrixReader("test.unknown"), std::runtime_error);
+}
+
+/**
+ * Make sure MatrixReader maps the string attributes of an ARFF file, and
+ * reports a bad point on the call that would return it.
+ */
+BOOST_AUTO_TEST_CASE(MatrixReaderARFFTest)
+{
+  std::fstream f;
+  f.open("test.arff", std::fstream::out);
+  f << "@relation test" << std::endl;
+  f << std::endl;
+  f << "@attribute one NUMERIC" << std::endl;
+  f << "@attribute two STRING" << std::endl;
+  f << std::endl;
+  f << "@data" << std::endl;
+  f << "1, hello" << std::endl;
+  f << "% a comment" << std::endl;
+  f << "2, goodbye" << std::endl;
+  f << "3, hello" << std::endl;
+  f << "x, hello" << std::endl;
+  f.close();
+
+  data::MatrixReader reader("test.arff");
+  BOOST_REQUIRE_EQUAL(reader.Dimensionality(), 2);
+
+  arma::mat batch;
+  BOOST_REQUIRE(reader.NextBatch(batch, 3));
+  BOOST_REQUIRE_EQUAL(batch.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(batch(0, 2), 3.0);
+  BOOST_REQUIRE_EQUAL(batch(1, 0), batch(1, 2));
+  BOOST_REQUIRE_NE(batch(1, 0), batch(1, 1));
+  BOOST_REQUIRE(reader.Info().Type(1) == data::Datatype::categorical);
+  BOOST_REQUIRE_EQUAL(reader.Info().NumMappings(1), 2);
+
+  BOOST_REQUIRE_THROW(reader.NextBatch(batch, 3), std::runtime_error);
+
+  remove("test.arff");
+}
+
+/**
+ * Load a LibSVM file into a sparse matrix, with and without its labels.
+ */
+BOOST_AUTO_TEST_CASE(LoadLibSVMTest)
+{
+  fstream f;
+  f.open("test.svm", fstream::out);
+  f << "1 1:0.5 4:2 qid:3 6:-1" << endl;
+  f << "# A comment." << endl;
+  f << "-1 2:1.5 3:0 # another comment" << endl;
+  f << endl;
+  f << "2.5" << endl;
+  f.close();
+
+  arma::sp_mat dataset;
+  arma::rowvec labels;
+  BOOST_REQUIRE(data::Load("test.svm", dataset, labels));
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, 6);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(dataset.n_nonzero, 4);
+  BOOST_REQUIRE_EQUAL(dataset(0, 0), 0.5);
+  BOOST_REQUIRE_EQUAL(dataset(3, 0), 2.0);
+  BOOST_REQUIRE_EQUAL(dataset(5, 0), -1.0);
+  BOOST_REQUIRE_EQUAL(dataset(1, 1), 1.5);
+
+  BOOST_REQUIRE_EQUAL(labels.n_elem, 3);
+  BOOST_REQUIRE_EQUAL(labels[0], 1.0);
+  BOOST_REQUIRE_EQUAL(labels[1], -1.0);
+  BOOST_REQUIRE_EQUAL(labels[2], 2.5);
+
+  arma::sp_mat unlabeled;
+  BOOST_REQUIRE(data::Load("test.svm", unlabeled));
+  BOOST_REQUIRE_EQUAL(arma::accu(arma::abs(unlabeled - dataset)), 0.0);
+
+  // The indices must be increasing.
+  f.open("test.svm", fstream::out);
+  f << "1 1:0.5 4:2" << endl;
+  f << "1 4:0.5 2:2" << endl;
+  f.close();
+  BOOST_REQUIRE(!data::Load("test.svm", dataset, labels));
+
+  remove("test.svm");
+}
+
+/**
+ * Load a large coordinate list, which is parsed in several chunks, into a
+ * sparse matrix.
+ */
+BOOST_AUTO_TEST_CASE(LoadCoordinatesTest)
+{
+  arma::sp_mat test;
+  test.sprandu(1000, 3000, 0.05);
+  BOOST_REQUIRE(test.save("test.coo", arma::coord_ascii));
+
+  // Repeated elements are added.
+  fstream f;
+  f.open("test.coo", fstream::out | fstream::app);
+  f << "% A comment." << endl;
+  f << "999, 2999, 1.5" << endl;
+  f << "999 2999 2" << endl;
+  f.close();
+  test(999, 2999) += 3.5;
+
+  arma::sp_mat dataset;
+  BOOST_REQUIRE(data::Load("test.coo", dataset, true, false));
+
+  BOOST_REQUIRE_EQUAL(dataset.n_rows, test.n_rows);
+  BOOST_REQUIRE_EQUAL(dataset.n_cols, test.n_cols);
+  BOOST_REQUIRE_EQUAL(dataset.n_nonzero, test.n_nonzero);
+  BOOST_REQUIRE_SMALL(arma::accu(arma::abs(dataset - test)), 1e-5);
+
+  // By default, the rows of the file are the points.
+  arma::sp_mat transposed;
+  BOOST_REQUIRE(data::Load("test.coo", transposed));
+  BOOST_REQUIRE_EQUAL(transposed.n_rows, test.n_cols);
+  BOOST_REQUIRE_EQUAL(transposed.n_cols, test.n_rows);
+  BOOST_REQUIRE_EQUAL(transposed(2999, 999), dataset(999, 2999));
+
+  f.open("test.coo", fstream::out | fstream::app);
+  f << "1 2" << endl;
+  f.close();
+  BOOST_REQUIRE(!data::Load("test.coo", dataset));
+
+  remove("test.coo");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -165,4 +165,33 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   BOOST_REQUIRE_EQUAL(lcc.MaxIterations(), lccBinary.MaxIterations());
 }
 
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that coding the points in parallel gives the same codes as coding
+ * them with one thread.
+ */
+BOOST_AUTO_TEST_CASE(LocalCoordinateCodingParallelEncodeTest)
+{
+  mat X = randu<mat>(20, 300);
+  LocalCoordinateCoding lcc(X, 10, 0.1, 2);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  mat serialCodes;
+  lcc.Encode(X, serialCodes);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  mat codes;
+  lcc.Encode(X, codes);
+
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(codes, serialCodes);
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
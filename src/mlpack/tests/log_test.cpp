@@ -6,6 +6,8 @@
  **/
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/util/async_log_sink.hpp>
+#include <thread>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -40,4 +42,70 @@ BOOST_AUTO_TEST_CASE(LogAssertConditionTest)
   #endif
 }
 
+/**
+ * Make sure that lines logged by several threads through the asynchronous sink
+ * are all written, whole and prefixed, and that the partial line of the calling
+ * thread is written when the sink is stopped.
+ */
+BOOST_AUTO_TEST_CASE(AsyncLogSinkTest)
+{
+  std::ostringstream output;
+  util::PrefixedOutStream stream(output, "[TEST] ");
+
+  // Use a small ring so that the threads have to wait for the writer.
+  util::AsyncLogSink::Start(4);
+  BOOST_REQUIRE(util::AsyncLogSink::Enabled());
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < 4; ++t)
+  {
+    threads.push_back(std::thread([&stream, t]()
+    {
+      for (size_t i = 0; i < 100; ++i)
+        stream << "thread " << t << ", line " << i << "." << std::endl;
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); ++t)
+    threads[t].join();
+
+  stream << "last";
+  util::AsyncLogSink::Stop();
+  BOOST_REQUIRE(!util::AsyncLogSink::Enabled());
+
+  std::istringstream input(output.str());
+  std::string line;
+  size_t lines = 0;
+  while (std::getline(input, line))
+  {
+    BOOST_REQUIRE_EQUAL(line.substr(0, 7), "[TEST] ");
+    ++lines;
+  }
+  BOOST_REQUIRE_EQUAL(lines, 401);
+  BOOST_REQUIRE_EQUAL(line, "[TEST] last");
+
+  // Once the sink is stopped, lines are written directly.
+  stream << std::endl << "direct" << std::endl;
+  BOOST_REQUIRE_EQUAL(output.str().substr(output.str().size() - 7), "direct\n");
+}
+
+/**
+ * Make sure that the rate limiter lets the first message through and then
+ * suppresses messages until the interval has passed.
+ */
+BOOST_AUTO_TEST_CASE(RateLimiterTest)
+{
+  util::RateLimiter limiter(0.05);
+  BOOST_REQUIRE(limiter.Ready());
+  BOOST_REQUIRE(!limiter.Ready());
+  BOOST_REQUIRE(!limiter.Ready());
+  BOOST_REQUIRE_EQUAL(limiter.Suppressed(), 2);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  BOOST_REQUIRE(limiter.Ready());
+
+  limiter.Reset();
+  BOOST_REQUIRE_EQUAL(limiter.Suppressed(), 0);
+  BOOST_REQUIRE(limiter.Ready());
+}
+
 BOOST_AUTO_TEST_SUITE_END();
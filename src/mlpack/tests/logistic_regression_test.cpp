@@ -482,6 +482,56 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionRegularizationSeparableGradient)
   }
 }
 
+/**
+ * Make sure that the batches cover the whole dataset after Shuffle(), for dense
+ * and sparse data: the objectives and the gradients of the batches must sum to
+ * the objective and the gradient on the whole dataset.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionShuffleTest)
+{
+  const size_t points = 100;
+  const size_t batchSize = 10;
+
+  arma::sp_mat sparseData = arma::sprandu<arma::sp_mat>(6, points, 0.3);
+  arma::mat data(sparseData);
+  arma::Row<size_t> responses = arma::randi<arma::Row<size_t>>(points,
+      arma::distr_param(0, 1));
+  const arma::rowvec parameters(7, arma::fill::randn);
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.1);
+  LogisticRegressionFunction<arma::sp_mat> sparseLrf(sparseData, responses,
+      0.1);
+  const double objective = lrf.Evaluate(parameters);
+  arma::rowvec gradient;
+  lrf.Gradient(parameters, gradient);
+
+  lrf.Shuffle();
+  sparseLrf.Shuffle();
+
+  double batchObjective = 0.0, sparseBatchObjective = 0.0;
+  arma::rowvec batchGradient(7, arma::fill::zeros);
+  arma::rowvec sparseBatchGradient(7, arma::fill::zeros);
+  for (size_t i = 0; i < points; i += batchSize)
+  {
+    batchObjective += lrf.Evaluate(parameters, i, batchSize);
+    sparseBatchObjective += sparseLrf.Evaluate(parameters, i, batchSize);
+
+    arma::rowvec g;
+    lrf.Gradient(parameters, i, g, batchSize);
+    batchGradient += g;
+    sparseLrf.Gradient(parameters, i, g, batchSize);
+    sparseBatchGradient += g;
+  }
+
+  BOOST_REQUIRE_CLOSE(batchObjective, objective, 1e-5);
+  BOOST_REQUIRE_CLOSE(sparseBatchObjective, objective, 1e-5);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(batchGradient[i], gradient[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(sparseBatchGradient[i], gradient[i], 1e-5);
+  }
+}
+
 // Test training of logistic regression on a simple dataset.
 BOOST_AUTO_TEST_CASE(LogisticRegressionLBFGSSimpleTest)
 {
@@ -812,6 +862,81 @@ BOOST_AUTO_TEST_CASE(LogisticRegressionSparseSGDTest)
     BOOST_REQUIRE_CLOSE(lr.Parameters()[i], lrSparse.Parameters()[i], 1e-5);
 }
 
+/**
+ * Make sure that the sparse separable gradient matches the dense separable
+ * gradient on the features that are nonzero in the batch, and is empty
+ * elsewhere.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionFunctionSparseGradient)
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(30, 200, 0.1);
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+    labels[i] = math::RandInt(0, 2);
+
+  LogisticRegressionFunction<arma::sp_mat> lrf(dataset, labels, 0.7);
+  arma::rowvec parameters = arma::randn<arma::rowvec>(31);
+
+  for (size_t batchSize = 1; batchSize <= 5; batchSize += 4)
+  {
+    for (size_t begin = 0; begin + batchSize <= 200; begin += batchSize)
+    {
+      arma::rowvec denseGradient;
+      arma::sp_mat sparseGradient;
+      lrf.Gradient(parameters, begin, denseGradient, batchSize);
+      lrf.Gradient(parameters, begin, sparseGradient, batchSize);
+
+      BOOST_REQUIRE_EQUAL(sparseGradient.n_rows, 1);
+      BOOST_REQUIRE_EQUAL(sparseGradient.n_cols, 31);
+      BOOST_REQUIRE_CLOSE(sparseGradient(0, 0), denseGradient[0], 1e-5);
+
+      const arma::sp_mat batch = dataset.cols(begin, begin + batchSize - 1);
+      for (size_t j = 1; j < 31; ++j)
+      {
+        if (arma::accu(arma::abs(batch.row(j - 1))) > 0.0)
+        {
+          BOOST_REQUIRE_CLOSE(sparseGradient(0, j), denseGradient[j], 1e-5);
+        }
+        else
+        {
+          BOOST_REQUIRE_EQUAL(sparseGradient(0, j), 0.0);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Train logistic regression on sparse data with the Hogwild! parallel SGD
+ * optimizer and make sure that it learns the separating hyperplane.
+ */
+BOOST_AUTO_TEST_CASE(LogisticRegressionParallelSGDTest)
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(100, 2000, 0.1);
+
+  // Label the points by a random hyperplane through their median score.
+  const arma::rowvec w = arma::randn<arma::rowvec>(100);
+  const arma::rowvec scores = w * dataset;
+  const double threshold = arma::median(scores);
+  arma::Row<size_t> labels(2000);
+  for (size_t i = 0; i < 2000; ++i)
+    labels[i] = (scores[i] > threshold) ? 1 : 0;
+
+  LogisticRegression<arma::sp_mat> lr(100, 0.0);
+  ens::ParallelSGD<ens::ConstantStep> optimizer(100,
+      std::ceil((double) dataset.n_cols / NumThreads()), 1e-8, true,
+      ens::ConstantStep(0.1));
+  lr.Train(dataset, labels, optimizer);
+
+  arma::Row<size_t> predictions;
+  lr.Classify(dataset, predictions);
+  const size_t correct = arma::accu(predictions == labels);
+
+  BOOST_REQUIRE_GE(correct, 1800);
+}
+
 /**
  * Test multi-point classification (Classify()).
  */
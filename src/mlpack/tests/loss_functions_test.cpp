@@ -21,6 +21,7 @@
 #include <mlpack/methods/ann/loss_functions/cross_entropy_error.hpp>
 #include <mlpack/methods/ann/loss_functions/reconstruction_loss.hpp>
 #include <mlpack/methods/ann/loss_functions/dice_loss.hpp>
+#include <mlpack/methods/ann/loss_functions/softmax_cross_entropy_error.hpp>
 #include <mlpack/methods/ann/init_rules/nguyen_widrow_init.hpp>
 #include <mlpack/methods/ann/ffn.hpp>
 
@@ -396,4 +397,93 @@ BOOST_AUTO_TEST_CASE(DiceLossTest)
   BOOST_REQUIRE_EQUAL(output.n_cols, input2.n_cols);
 }
 
+/**
+ * Make sure that the softmax cross-entropy matches the negative log likelihood
+ * of the softmax, also for scores that would overflow exp().
+ */
+BOOST_AUTO_TEST_CASE(SimpleSoftmaxCrossEntropyErrorTest)
+{
+  arma::mat input = 5 * arma::randn<arma::mat>(10, 20);
+  input.col(3) += 1000;
+  arma::mat target(1, 20);
+  for (size_t i = 0; i < target.n_elem; ++i)
+    target[i] = (i % 10) + 1;
+
+  // The reference log-probabilities and probabilities.
+  arma::mat logProbabilities = input;
+  arma::mat probabilities = input;
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    const double maxInput = input.col(i).max();
+    const double logSum = std::log(arma::accu(arma::exp(input.col(i) -
+        maxInput))) + maxInput;
+    logProbabilities.col(i) -= logSum;
+    probabilities.col(i) = arma::exp(logProbabilities.col(i));
+  }
+
+  SoftmaxCrossEntropyError<> module;
+  NegativeLogLikelihood<> nll;
+  const double loss = module.Forward(std::move(input), std::move(target));
+  const double nllLoss = nll.Forward(std::move(logProbabilities),
+      std::move(target));
+  BOOST_REQUIRE_CLOSE(loss, nllLoss, 1e-8);
+
+  // The gradient is p - y.
+  arma::mat output;
+  module.Backward(std::move(input), std::move(target), std::move(output));
+  BOOST_REQUIRE_EQUAL(output.n_rows, input.n_rows);
+  BOOST_REQUIRE_EQUAL(output.n_cols, input.n_cols);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      const double y = (j == target[i] - 1) ? 1.0 : 0.0;
+      BOOST_REQUIRE_SMALL(output(j, i) - (probabilities(j, i) - y), 1e-10);
+    }
+  }
+}
+
+/*
+ * Softmax cross-entropy numerical gradient test.
+ */
+BOOST_AUTO_TEST_CASE(GradientSoftmaxCrossEntropyErrorTest)
+{
+  // Linear function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction()
+    {
+      input = arma::randu(10, 1);
+      target = arma::mat("3");
+
+      model = new FFN<SoftmaxCrossEntropyError<>,
+          NguyenWidrowInitialization>();
+      model->Predictors() = input;
+      model->Responses() = target;
+      model->Add<IdentityLayer<> >();
+      model->Add<Linear<> >(10, 4);
+    }
+
+    ~GradientFunction()
+    {
+      delete model;
+    }
+
+    double Gradient(arma::mat& gradient) const
+    {
+      arma::mat output;
+      double error = model->Evaluate(model->Parameters(), 0, 1);
+      model->Gradient(model->Parameters(), 0, gradient, 1);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model->Parameters(); }
+
+    FFN<SoftmaxCrossEntropyError<>, NguyenWidrowInitialization>* model;
+    arma::mat input, target;
+  } function;
+
+  BOOST_REQUIRE_LE(CheckGradient(function), 1e-4);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -839,6 +839,30 @@ BOOST_AUTO_TEST_CASE(ParallelMonochromatic)
       sequentialNeighbors, parallelNeighbors);
   BOOST_REQUIRE_EQUAL(recall, 1);
 }
+
+/**
+ * Test: hashing the tables in parallel gives the same hash table as hashing
+ * them with a single thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelTrain)
+{
+  arma::mat rdata = arma::randu<arma::mat>(5, 2000);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  math::RandomSeed(42);
+  LSHSearch<> sequentialLSH(rdata, 4, 12, 0.5);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  math::RandomSeed(42);
+  LSHSearch<> parallelLSH(rdata, 4, 12, 0.5);
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(sequentialLSH.SecondHashTable(),
+      parallelLSH.SecondHashTable());
+  CheckMatrices(sequentialLSH.BucketOffsets(), parallelLSH.BucketOffsets());
+}
 #endif
 
 // Test the copy constructor and the copy operator.
@@ -912,4 +936,143 @@ BOOST_AUTO_TEST_CASE(MoveOperatorTest)
   CheckMatrices(distances, distances2);
 }
 
+/**
+ * Test: the buckets of the second hash table are stored one after the other,
+ * are no larger than the bucket size, and hold each point at most once per
+ * table.
+ */
+BOOST_AUTO_TEST_CASE(HashTableLayoutTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 3000);
+  const size_t numTables = 8;
+  const size_t bucketSize = 20;
+
+  LSHSearch<> lsh(dataset, 3, numTables, 0.3, 99901, bucketSize);
+
+  const arma::Col<size_t>& offsets = lsh.BucketOffsets();
+  const arma::Col<size_t>& table = lsh.SecondHashTable();
+  BOOST_REQUIRE_GT(offsets.n_elem, 1);
+  BOOST_REQUIRE_EQUAL(offsets[0], 0);
+  BOOST_REQUIRE_EQUAL(offsets[offsets.n_elem - 1], table.n_elem);
+
+  arma::Col<size_t> occurrences(dataset.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i + 1 < offsets.n_elem; ++i)
+  {
+    BOOST_REQUIRE_GT(offsets[i + 1], offsets[i]);
+    BOOST_REQUIRE_LE(offsets[i + 1] - offsets[i], bucketSize);
+    for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+    {
+      BOOST_REQUIRE_LT(table[j], dataset.n_cols);
+      ++occurrences[table[j]];
+    }
+  }
+
+  BOOST_REQUIRE_LE(occurrences.max(), numTables);
+}
+
+/**
+ * Test: the queries are projected in blocks, so searching a large query set at
+ * once must give the same results as searching each query on its own, with and
+ * without multiprobe.
+ */
+BOOST_AUTO_TEST_CASE(BlockedQuerySearchTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(4, 1000);
+  arma::mat qdata = arma::randu<arma::mat>(4, 2500);
+
+  LSHSearch<> lsh(rdata, 4, 6, 0.4);
+
+  for (size_t T = 0; T <= 5; T += 5)
+  {
+    arma::Mat<size_t> neighbors, singleNeighbors;
+    arma::mat distances, singleDistances;
+    lsh.Search(qdata, 3, neighbors, distances, 0, T);
+
+    for (size_t i = 0; i < qdata.n_cols; i += 97)
+    {
+      lsh.Search(qdata.col(i), 3, singleNeighbors, singleDistances, 0, T);
+
+      CheckMatrices(singleNeighbors, arma::Mat<size_t>(neighbors.col(i)));
+      CheckMatrices(singleDistances, arma::mat(distances.col(i)));
+    }
+  }
+}
+
+/**
+ * Test: inserting points in several batches into a model trained on part of
+ * the reference set gives the same results as training on the whole reference
+ * set with the same random projections, and the inserted points are found.
+ */
+BOOST_AUTO_TEST_CASE(InsertTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(4, 1000);
+  arma::mat qdata = arma::randu<arma::mat>(4, 200);
+
+  // The hash width is given so that the random draws only depend on the seed.
+  // The buckets are unbounded, so no point is dropped from a full bucket.
+  math::RandomSeed(17);
+  LSHSearch<> fullLSH(rdata, 3, 8, 0.3, 99901, 0);
+
+  math::RandomSeed(17);
+  LSHSearch<> insertLSH(rdata.cols(0, 299), 3, 8, 0.3, 99901, 0);
+  for (size_t i = 300; i < rdata.n_cols; i += 50)
+    insertLSH.Insert(rdata.cols(i, i + 49));
+
+  BOOST_REQUIRE_EQUAL(insertLSH.ReferenceSet().n_cols, rdata.n_cols);
+  CheckMatrices(insertLSH.ReferenceSet(), rdata);
+
+  arma::Mat<size_t> fullNeighbors, insertNeighbors;
+  arma::mat fullDistances, insertDistances;
+  fullLSH.Search(qdata, 5, fullNeighbors, fullDistances, 0, 2);
+  insertLSH.Search(qdata, 5, insertNeighbors, insertDistances, 0, 2);
+
+  CheckMatrices(fullNeighbors, insertNeighbors);
+  CheckMatrices(fullDistances, insertDistances);
+
+  // Each inserted point is its own nearest neighbor.
+  insertLSH.Search(rdata.cols(900, 999), 1, insertNeighbors, insertDistances);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(insertNeighbors(0, i), 900 + i);
+    BOOST_REQUIRE_SMALL(insertDistances(0, i), 1e-5);
+  }
+}
+
+/**
+ * Test: Insert() respects the bucket size and throws on points of the wrong
+ * dimensionality or on an untrained model.
+ */
+BOOST_AUTO_TEST_CASE(InsertBucketSizeTest)
+{
+  arma::mat rdata = arma::randu<arma::mat>(4, 500);
+  const size_t numTables = 4;
+  const size_t bucketSize = 10;
+
+  LSHSearch<> lsh(rdata.cols(0, 99), 3, numTables, 0.3, 99901, bucketSize);
+  lsh.Insert(rdata.cols(100, 499));
+
+  const arma::Col<size_t>& offsets = lsh.BucketOffsets();
+  const arma::Col<size_t>& table = lsh.SecondHashTable();
+  arma::Col<size_t> occurrences(rdata.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i + 1 < offsets.n_elem; ++i)
+  {
+    BOOST_REQUIRE_LE(offsets[i + 1] - offsets[i], bucketSize);
+    for (size_t j = offsets[i]; j < offsets[i + 1] && table[j] != SIZE_MAX;
+        ++j)
+    {
+      BOOST_REQUIRE_LT(table[j], rdata.n_cols);
+      ++occurrences[table[j]];
+    }
+  }
+
+  BOOST_REQUIRE_LE(occurrences.max(), numTables);
+  BOOST_REQUIRE_GT(arma::accu(occurrences.tail(400)), 0);
+
+  arma::mat wrongData = arma::randu<arma::mat>(3, 10);
+  BOOST_REQUIRE_THROW(lsh.Insert(wrongData), std::invalid_argument);
+
+  LSHSearch<> untrained;
+  BOOST_REQUIRE_THROW(untrained.Insert(rdata), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -204,7 +204,7 @@ BOOST_AUTO_TEST_CASE(HMMTrainToleranceNonNegative)
 }
 
 // Make sure an error is thrown if type is something other than
-// "discrete", "gaussian" or "gmm"
+// "discrete", "gaussian", "gmm" or "diag_gmm"
 BOOST_AUTO_TEST_CASE(HMMTrainTypeTest)
 {
   std::string inputFileName = "hmm_train_obs.csv";
@@ -488,4 +488,33 @@ BOOST_AUTO_TEST_CASE(HMMTrainRetrainTest3)
   BOOST_REQUIRE(h2.Type() != GaussianHMM);
 }
 
+// Make sure that an HMM with diagonal GMM emissions can be trained.
+BOOST_AUTO_TEST_CASE(HMMTrainDiagonalGMMTest)
+{
+  std::string inputObsFileName = "hmm_train_obs.csv";
+  std::string inputLabFileName = "hmm_train_lab.csv";
+  std::string hmmType = "diag_gmm";
+  int states = 3;
+  int gaussians = 2;
+
+  FileExists(inputObsFileName);
+  FileExists(inputLabFileName);
+  SetInputParam("input_file", std::move(inputObsFileName));
+  SetInputParam("labels_file", std::move(inputLabFileName));
+  SetInputParam("type", std::move(hmmType));
+  SetInputParam("states", states);
+  SetInputParam("gaussians", gaussians);
+
+  mlpackMain();
+
+  HMMModel* h = CLI::GetParam<HMMModel*>("output_model");
+  BOOST_REQUIRE(h->Type() == DiagonalGaussianMixtureModelHMM);
+  BOOST_REQUIRE_EQUAL(h->DiagGMMHMM()->Emission().size(), (size_t) states);
+  for (size_t i = 0; i < h->DiagGMMHMM()->Emission().size(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(h->DiagGMMHMM()->Emission()[i].Gaussians(),
+        (size_t) gaussians);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,208 @@
+/**
+ * @file hnsw_test.cpp
+ *
+ * Test mlpackMain() of hnsw_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <string>
+
+#define BINDING_TYPE BINDING_TYPE_TEST
+static const std::string testName = "HNSW";
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+#include "test_helper.hpp"
+#include <mlpack/methods/hnsw/hnsw_main.cpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct HNSWTestFixture
+{
+ public:
+  HNSWTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~HNSWTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(HNSWMainTest, HNSWTestFixture);
+
+/**
+ * Check that output neighbors and distances have valid dimensions.
+ */
+BOOST_AUTO_TEST_CASE(HNSWOutputDimensionTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+  arma::mat query = arma::randu<arma::mat>(5, 40);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("k", (int) 6);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_rows, 6);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_cols,
+                      100);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_rows, 6);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_cols, 100);
+
+  // Now search with a query set, with the trained model.
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+
+  SetInputParam("input_model",
+      CLI::GetParam<neighbor::HNSWSearch<>*>("output_model"));
+  SetInputParam("query", std::move(query));
+  SetInputParam("k", (int) 4);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_rows, 4);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Mat<size_t>>("neighbors").n_cols,
+                      40);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_rows, 4);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("distances").n_cols, 40);
+}
+
+/**
+ * Ensure that k, connections, ef_construction and ef_search are always
+ * positive.
+ */
+BOOST_AUTO_TEST_CASE(HNSWParamValidityTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+
+  const char* params[] = { "connections", "ef_construction", "ef_search",
+      "k" };
+  for (size_t i = 0; i < 4; ++i)
+  {
+    SetInputParam("reference", reference);
+    SetInputParam("k", (int) 6);
+    SetInputParam(params[i], (int) -1);
+
+    Log::Fatal.ignoreInput = true;
+    BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+    Log::Fatal.ignoreInput = false;
+
+    bindings::tests::CleanMemory();
+  }
+
+  // The graph needs at least two connections per point.
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("connections", (int) 1);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Make sure only one of reference data or pre-trained model is passed.
+ */
+BOOST_AUTO_TEST_CASE(HNSWModelValidityTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 100);
+
+  SetInputParam("reference", reference);
+  SetInputParam("k", (int) 6);
+
+  mlpackMain();
+
+  SetInputParam("input_model",
+      CLI::GetParam<neighbor::HNSWSearch<>*>("output_model"));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Make sure that points inserted into a trained model are found.
+ */
+BOOST_AUTO_TEST_CASE(HNSWInsertTest)
+{
+  arma::mat reference = arma::randu<arma::mat>(5, 200);
+  arma::mat newPoints = arma::randu<arma::mat>(5, 100);
+
+  SetInputParam("reference", std::move(reference));
+
+  mlpackMain();
+
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+
+  SetInputParam("input_model",
+      CLI::GetParam<neighbor::HNSWSearch<>*>("output_model"));
+  SetInputParam("insert", newPoints);
+  SetInputParam("query", newPoints);
+  SetInputParam("k", (int) 1);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<neighbor::HNSWSearch<>*>(
+      "output_model")->ReferenceSet().n_cols, 300);
+
+  const arma::Mat<size_t>& neighbors =
+      CLI::GetParam<arma::Mat<size_t>>("neighbors");
+  const arma::mat& distances = CLI::GetParam<arma::mat>("distances");
+  for (size_t i = 0; i < newPoints.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors(0, i), 200 + i);
+    BOOST_REQUIRE_SMALL(distances(0, i), 1e-5);
+  }
+}
+
+/**
+ * Make sure that a higher ef_search gives at least the recall of a lower one.
+ */
+BOOST_AUTO_TEST_CASE(HNSWEfSearchRecallTest)
+{
+  arma::mat reference = arma::randn<arma::mat>(30, 1000);
+  arma::mat query = arma::randn<arma::mat>(30, 100);
+
+  neighbor::KNN knn(reference);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(query, 10, trueNeighbors, trueDistances);
+
+  SetInputParam("reference", std::move(reference));
+  SetInputParam("query", query);
+  SetInputParam("k", (int) 10);
+  SetInputParam("ef_search", (int) 10);
+
+  mlpackMain();
+
+  const double lowRecall = neighbor::HNSWSearch<>::ComputeRecall(
+      CLI::GetParam<arma::Mat<size_t>>("neighbors"), trueNeighbors);
+
+  CLI::GetSingleton().Parameters()["reference"].wasPassed = false;
+
+  SetInputParam("input_model",
+      CLI::GetParam<neighbor::HNSWSearch<>*>("output_model"));
+  SetInputParam("query", std::move(query));
+  SetInputParam("ef_search", (int) 200);
+
+  mlpackMain();
+
+  const double highRecall = neighbor::HNSWSearch<>::ComputeRecall(
+      CLI::GetParam<arma::Mat<size_t>>("neighbors"), trueNeighbors);
+
+  BOOST_REQUIRE_GE(highRecall, lowRecall);
+  BOOST_REQUIRE_GT(highRecall, 0.95);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -353,4 +353,66 @@ BOOST_AUTO_TEST_CASE(KernelPCASamplingSchemeTest)
   BOOST_REQUIRE(arma::any(arma::vectorise(output1 != output3)));
 }
 
+/**
+ * Make sure that random Fourier features give output of the right dimensions.
+ */
+BOOST_AUTO_TEST_CASE(KernelPCARandomFeaturesDimensionTest)
+{
+  std::string kernels[] = { "gaussian", "laplacian" };
+
+  for (std::string& kernel : kernels)
+  {
+    ResetSettings();
+    arma::mat x = arma::randu<arma::mat>(5, 50);
+    SetInputParam("input", std::move(x));
+    SetInputParam("new_dimensionality", (int) 3);
+    SetInputParam("kernel", kernel);
+    SetInputParam("random_features", true);
+    SetInputParam("num_features", (int) 100);
+    mlpackMain();
+
+    BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_rows, 3);
+    BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_cols, 50);
+  }
+}
+
+/**
+ * Make sure that random Fourier features can't be used with kernels that are
+ * not shift-invariant, or with the Nystroem method.
+ */
+BOOST_AUTO_TEST_CASE(KernelPCARandomFeaturesInvalidTest)
+{
+  arma::mat x = arma::randu<arma::mat>(5, 50);
+
+  SetInputParam("input", x);
+  SetInputParam("kernel", (std::string) "polynomial");
+  SetInputParam("random_features", true);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  ResetSettings();
+
+  SetInputParam("input", x);
+  SetInputParam("kernel", (std::string) "gaussian");
+  SetInputParam("random_features", true);
+  SetInputParam("nystroem_method", true);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+
+  ResetSettings();
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("kernel", (std::string) "gaussian");
+  SetInputParam("random_features", true);
+  SetInputParam("num_features", (int) 0);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
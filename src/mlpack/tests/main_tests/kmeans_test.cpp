@@ -394,4 +394,90 @@ BOOST_AUTO_TEST_CASE(AlgorithmsSimilarTest)
   CheckMatrices(naiveCentroid, dualCoverTreeCentroid);
 }
 
+/**
+ * Checking that the mini-batch algorithm gives output of the right size.
+ */
+BOOST_AUTO_TEST_CASE(KmMiniBatchSizeCheck)
+{
+  int c = 2;
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Unable to load train dataset vc2.csv!");
+
+  size_t col = inputData.n_cols;
+  size_t row = inputData.n_rows;
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("clusters", c);
+  SetInputParam("algorithm", std::string("minibatch"));
+  SetInputParam("batch_size", (int) 50);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_rows, row+1);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_cols, col);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("centroid").n_rows, row);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("centroid").n_cols, c);
+}
+
+/**
+ * Checking that the batch size of the mini-batch algorithm must be positive.
+ */
+BOOST_AUTO_TEST_CASE(KmMiniBatchNonPositiveBatchSizeTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Unable to load train dataset vc2.csv!");
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("clusters", (int) 2);
+  SetInputParam("algorithm", std::string("minibatch"));
+  SetInputParam("batch_size", (int) 0); // Invalid.
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Checking that k-means|| initialization gives output of the right size.
+ */
+BOOST_AUTO_TEST_CASE(KmParallelInitializationSizeCheck)
+{
+  int c = 2;
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Unable to load train dataset vc2.csv!");
+
+  size_t row = inputData.n_rows;
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("clusters", c);
+  SetInputParam("kmeans_parallel", true);
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("centroid").n_rows, row);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("centroid").n_cols, c);
+}
+
+/**
+ * Checking that the oversampling factor of k-means|| must be positive.
+ */
+BOOST_AUTO_TEST_CASE(KmParallelInitializationOversamplingTest)
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    BOOST_FAIL("Unable to load train dataset vc2.csv!");
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("clusters", (int) 2);
+  SetInputParam("kmeans_parallel", true);
+  SetInputParam("oversampling", -1.0); // Invalid.
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -9,6 +9,7 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#include <fstream>
 #include <string>
 
 #define BINDING_TYPE BINDING_TYPE_TEST
@@ -285,4 +286,53 @@ BOOST_AUTO_TEST_CASE(LRNoTrainingData)
   Log::Fatal.ignoreInput = false;
 }
 
+/**
+ * Make sure that a model can be trained on a sparse LibSVM file, whose labels
+ * are the responses, and used to predict on sparse test points.
+ */
+BOOST_AUTO_TEST_CASE(LRSparseTraining)
+{
+  // The responses are an exact linear function of the points, so the model
+  // should recover it.
+  arma::mat points = arma::randu<arma::mat>(3, 50);
+  points.elem(arma::find(points < 0.5)).zeros();
+  const arma::rowvec responses = 1.0 + 2.0 * points.row(0) - points.row(2);
+
+  std::ofstream trainFile("lr_sparse_train.svm");
+  std::ofstream testFile("lr_sparse_test.svm");
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    trainFile << responses[i];
+    testFile << 0;
+    for (size_t j = 0; j < points.n_rows; ++j)
+    {
+      if (points(j, i) != 0.0)
+      {
+        trainFile << " " << (j + 1) << ":" << points(j, i);
+        testFile << " " << (j + 1) << ":" << points(j, i);
+      }
+    }
+    trainFile << std::endl;
+    testFile << std::endl;
+  }
+  // Make sure the last dimension is present, so the model has 3 dimensions.
+  trainFile << 0.0 << " 3:1" << std::endl;
+  trainFile.close();
+  testFile.close();
+
+  SetInputParam("sparse_training", std::string("lr_sparse_train.svm"));
+  SetInputParam("sparse_test", std::string("lr_sparse_test.svm"));
+
+  mlpackMain();
+
+  const arma::rowvec predictions =
+      CLI::GetParam<arma::rowvec>("output_predictions");
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    BOOST_REQUIRE_SMALL(predictions[i] - responses[i], 1e-4);
+
+  remove("lr_sparse_train.svm");
+  remove("lr_sparse_test.svm");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
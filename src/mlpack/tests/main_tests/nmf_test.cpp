@@ -177,6 +177,23 @@ BOOST_AUTO_TEST_CASE(NMFMaxIterartionBoundTest)
   Log::Fatal.ignoreInput = false;
 }
 
+/**
+ * Make sure that check_interval must be positive.
+ */
+BOOST_AUTO_TEST_CASE(NMFCheckIntervalBoundTest)
+{
+  mat v = randu<mat>(10, 10);
+  int r = 5;
+
+  SetInputParam("check_interval", int(0));
+  SetInputParam("input", std::move(v));
+  SetInputParam("rank", r);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
 /**
  * Ensure the update rule is one of 
  * {"multdist", "multdiv", "als"}.
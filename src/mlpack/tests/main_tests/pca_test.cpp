@@ -100,6 +100,40 @@ BOOST_AUTO_TEST_CASE(PCANoVarRetainTest)
   BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_cols, 5);
 }
 
+/**
+ * Make sure that the streaming decomposition method can be used.
+ */
+BOOST_AUTO_TEST_CASE(PCAStreamingDimensionTest)
+{
+  arma::mat x = arma::randu<arma::mat>(5, 50);
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("new_dimensionality", (int) 3);
+  SetInputParam("decomposition_method", std::string("streaming"));
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_rows, 3);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_cols, 50);
+}
+
+/**
+ * Make sure that the incremental decomposition method can be used.
+ */
+BOOST_AUTO_TEST_CASE(PCAIncrementalDimensionTest)
+{
+  arma::mat x = arma::randu<arma::mat>(5, 50);
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("new_dimensionality", (int) 3);
+  SetInputParam("decomposition_method", std::string("incremental"));
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_rows, 3);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("output").n_cols, 50);
+}
+
 /**
  * Check that we can't specify an invalid new dimensionality.
  */
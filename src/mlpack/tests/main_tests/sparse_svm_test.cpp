@@ -0,0 +1,206 @@
+/**
+ * @file sparse_svm_test.cpp
+ *
+ * Test mlpackMain() of sparse_svm_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#define BINDING_TYPE BINDING_TYPE_TEST
+
+#include <mlpack/core.hpp>
+static const std::string testName = "SparseSVM";
+
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/methods/sparse_svm/sparse_svm_main.cpp>
+#include "test_helper.hpp"
+
+#include <boost/test/unit_test.hpp>
+#include "../test_tools.hpp"
+
+using namespace mlpack;
+
+struct SparseSVMTestFixture
+{
+ public:
+  SparseSVMTestFixture()
+  {
+    // Cache in the options for this program.
+    CLI::RestoreSettings(testName);
+  }
+
+  ~SparseSVMTestFixture()
+  {
+    // Clear the settings.
+    bindings::tests::CleanMemory();
+    CLI::ClearSettings();
+  }
+};
+
+/**
+ * Generate a simple dataset of three classes, where the points of each class
+ * only have nonzero values in their own block of ten features.
+ */
+static void GenerateData(const size_t points,
+                         arma::mat& data,
+                         arma::Row<size_t>& labels)
+{
+  data.zeros(30, points);
+  labels.set_size(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = i % 3;
+    for (size_t j = 0; j < 3; ++j)
+      data(10 * labels[i] + math::RandInt(10), i) = 1.0 + math::Random();
+  }
+}
+
+BOOST_FIXTURE_TEST_SUITE(SparseSVMMainTest, SparseSVMTestFixture);
+
+/**
+ * Ensure that we get desired dimensions when both training data and labels are
+ * passed.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMOutputDimensionTest)
+{
+  arma::mat inputData, testData;
+  arma::Row<size_t> labels, testLabels;
+  GenerateData(300, inputData, labels);
+  GenerateData(100, testData, testLabels);
+
+  // Input training data.
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+
+  // Input test data.
+  SetInputParam("test", std::move(testData));
+
+  mlpackMain();
+
+  // Check that number of output points are equal to number of input points.
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Row<size_t>>("predictions").n_cols,
+                      100);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Row<size_t>>("predictions").n_rows,
+                      1);
+
+  // There is one row of scores for each class.
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("scores").n_cols, 100);
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::mat>("scores").n_rows, 3);
+}
+
+/**
+ * Ensure that labels are necessarily passed when training.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMLabelsLessDimensionTest)
+{
+  arma::mat inputData;
+  arma::Row<size_t> labels;
+  GenerateData(30, inputData, labels);
+
+  // Input training data.
+  SetInputParam("training", std::move(inputData));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Ensure that saved model can be used again.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMModelReuseTest)
+{
+  arma::mat inputData, testData;
+  arma::Row<size_t> labels, testLabels;
+  GenerateData(300, inputData, labels);
+  GenerateData(100, testData, testLabels);
+
+  // Input training data.
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+
+  // Input test data.
+  SetInputParam("test", testData);
+
+  mlpackMain();
+
+  arma::Row<size_t> predictions;
+  predictions = std::move(CLI::GetParam<arma::Row<size_t>>("predictions"));
+
+  // Reset passed parameters.
+  CLI::GetSingleton().Parameters()["training"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["labels"].wasPassed = false;
+  CLI::GetSingleton().Parameters()["test"].wasPassed = false;
+
+  // Input trained model.
+  SetInputParam("test", std::move(testData));
+  SetInputParam("input_model",
+                CLI::GetParam<svm::SparseSVM*>("output_model"));
+
+  mlpackMain();
+
+  // Check that initial predictions and final predictions using the saved model
+  // are the same.
+  CheckMatrices(predictions, CLI::GetParam<arma::Row<size_t>>("predictions"));
+}
+
+/**
+ * Ensure that the parallel SGD optimizer can be used.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMParallelSGDTest)
+{
+  arma::mat inputData, testData;
+  arma::Row<size_t> labels, testLabels;
+  GenerateData(300, inputData, labels);
+  GenerateData(100, testData, testLabels);
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("optimizer", std::string("psgd"));
+  SetInputParam("test", std::move(testData));
+
+  mlpackMain();
+
+  BOOST_REQUIRE_EQUAL(CLI::GetParam<arma::Row<size_t>>("predictions").n_cols,
+                      100);
+}
+
+/**
+ * Ensure that the optimizer name is checked.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMInvalidOptimizerTest)
+{
+  arma::mat inputData;
+  arma::Row<size_t> labels;
+  GenerateData(30, inputData, labels);
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("optimizer", std::string("sgd"));
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+/**
+ * Ensure that lambda is always non-negative.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMNegativeLambdaTest)
+{
+  arma::mat inputData;
+  arma::Row<size_t> labels;
+  GenerateData(30, inputData, labels);
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("labels", std::move(labels));
+  SetInputParam("lambda", (double) -1.0);
+
+  Log::Fatal.ignoreInput = true;
+  BOOST_REQUIRE_THROW(mlpackMain(), std::runtime_error);
+  Log::Fatal.ignoreInput = false;
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -1009,4 +1009,139 @@ BOOST_AUTO_TEST_CASE(InplaceSparseShuffleWeightsTest)
   }
 }
 
+/**
+ * Make sure ShuffleDataInPlace() shuffles the points, labels and weights
+ * consistently.
+ */
+BOOST_AUTO_TEST_CASE(ShuffleDataInPlaceTest)
+{
+  arma::mat data(3, 100, arma::fill::zeros);
+  arma::Row<size_t> labels(100);
+  arma::rowvec weights(100);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    data(0, i) = i;
+    data(2, i) = 2 * i;
+    labels[i] = i;
+    weights[i] = i;
+  }
+
+  ShuffleDataInPlace(data, labels, weights);
+
+  BOOST_REQUIRE_EQUAL(data.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(data.n_cols, 100);
+  BOOST_REQUIRE_EQUAL(labels.n_elem, 100);
+  BOOST_REQUIRE_EQUAL(weights.n_elem, 100);
+
+  // Make sure we only have each point once.
+  arma::Row<size_t> counts(100, arma::fill::zeros);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    BOOST_REQUIRE_EQUAL((size_t) data(0, i), labels[i]);
+    BOOST_REQUIRE_EQUAL((size_t) data(0, i), (size_t) weights[i]);
+    BOOST_REQUIRE_SMALL(data(1, i), 1e-5);
+    BOOST_REQUIRE_EQUAL((size_t) data(2, i), 2 * labels[i]);
+    counts[labels[i]]++;
+  }
+
+  for (size_t i = 0; i < 100; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+}
+
+/**
+ * Make sure ShuffleDataInPlace() works on sparse data, including empty
+ * columns.
+ */
+BOOST_AUTO_TEST_CASE(SparseShuffleDataInPlaceTest)
+{
+  arma::sp_mat data(3, 100);
+  arma::Row<size_t> labels(100);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    // Every third column is empty.
+    if (i % 3 != 0)
+    {
+      data(0, i) = i;
+      data(2, i) = 2 * i;
+    }
+    labels[i] = i;
+  }
+
+  ShuffleDataInPlace(data, labels);
+
+  BOOST_REQUIRE_EQUAL(data.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(data.n_cols, 100);
+  BOOST_REQUIRE_EQUAL(data.n_nonzero, 2 * 66);
+  BOOST_REQUIRE_EQUAL(labels.n_elem, 100);
+
+  arma::Row<size_t> counts(100, arma::fill::zeros);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const size_t label = labels[i];
+    const double expected = (label % 3 != 0) ? label : 0.0;
+    BOOST_REQUIRE_CLOSE((double) data(0, i) + 1.0, expected + 1.0, 1e-5);
+    BOOST_REQUIRE_SMALL((double) data(1, i), 1e-5);
+    BOOST_REQUIRE_CLOSE((double) data(2, i) + 1.0, 2 * expected + 1.0, 1e-5);
+    counts[label]++;
+  }
+
+  for (size_t i = 0; i < 100; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+}
+
+/**
+ * Make sure PermuteColumns() applies the given permutation, for permutations
+ * with several cycles.
+ */
+BOOST_AUTO_TEST_CASE(PermuteColumnsTest)
+{
+  arma::mat data(4, 50, arma::fill::randu);
+  arma::sp_mat sparseData = arma::sprandu<arma::sp_mat>(4, 50, 0.3);
+  const arma::uvec ordering = arma::shuffle(arma::linspace<arma::uvec>(0, 49,
+      50));
+
+  arma::mat permuted(data);
+  PermuteColumns(permuted, ordering);
+  arma::sp_mat sparsePermuted(sparseData);
+  PermuteColumns(sparsePermuted, ordering);
+
+  BOOST_REQUIRE_EQUAL(sparsePermuted.n_nonzero, sparseData.n_nonzero);
+  for (size_t i = 0; i < 50; ++i)
+  {
+    for (size_t r = 0; r < 4; ++r)
+    {
+      BOOST_REQUIRE_EQUAL(permuted(r, i), data(r, ordering[i]));
+      BOOST_REQUIRE_EQUAL((double) sparsePermuted(r, i),
+          (double) sparseData(r, ordering[i]));
+    }
+  }
+}
+
+/**
+ * Make sure GatherColumns() gives the same columns for dense and sparse
+ * matrices, with repeated indices.
+ */
+BOOST_AUTO_TEST_CASE(GatherColumnsTest)
+{
+  arma::sp_mat sparseData = arma::sprandu<arma::sp_mat>(10, 30, 0.2);
+  arma::mat data(sparseData);
+  const arma::uvec indices = arma::randi<arma::uvec>(40,
+      arma::distr_param(0, 29));
+
+  const arma::mat gathered = GatherColumns(data, indices);
+  const arma::sp_mat sparseGathered = GatherColumns(sparseData, indices);
+
+  BOOST_REQUIRE_EQUAL(sparseGathered.n_rows, 10);
+  BOOST_REQUIRE_EQUAL(sparseGathered.n_cols, 40);
+  BOOST_REQUIRE_EQUAL(gathered.n_cols, 40);
+  for (size_t i = 0; i < 40; ++i)
+  {
+    for (size_t r = 0; r < 10; ++r)
+    {
+      BOOST_REQUIRE_EQUAL(gathered(r, i), data(r, indices[i]));
+      BOOST_REQUIRE_EQUAL((double) sparseGathered(r, i), gathered(r, i));
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
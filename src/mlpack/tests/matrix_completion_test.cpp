@@ -64,4 +64,134 @@ BOOST_AUTO_TEST_CASE(UniformMatrixCompletionSDP)
   }
 }
 
+/**
+ * The same matrix completion test, but optimizing the factors directly instead
+ * of building the SDP.
+ */
+BOOST_AUTO_TEST_CASE(UniformMatrixCompletionFactorized)
+{
+  arma::mat Xorig;
+  arma::vec values;
+  arma::umat indices;
+
+  data::Load("completion_X.csv", Xorig, true, false);
+  data::Load("completion_indices.csv", indices, true, false);
+
+  values.set_size(indices.n_cols);
+  for (size_t i = 0; i < indices.n_cols; ++i)
+    values(i) = Xorig(indices(0, i), indices(1, i));
+
+  // This is the default rank for the problem.
+  MatrixCompletion mc(Xorig.n_rows, Xorig.n_cols, indices, values, 23, true);
+  BOOST_REQUIRE(mc.Factorized());
+
+  arma::mat u, v;
+  mc.Recover(u, v);
+  BOOST_REQUIRE_EQUAL(u.n_rows, Xorig.n_rows);
+  BOOST_REQUIRE_EQUAL(v.n_rows, Xorig.n_cols);
+  BOOST_REQUIRE_EQUAL(u.n_cols, 23);
+  BOOST_REQUIRE_EQUAL(v.n_cols, 23);
+
+  const arma::mat recovered = u * v.t();
+  const double err =
+    arma::norm(Xorig - recovered, "fro") /
+    arma::norm(Xorig, "fro");
+  BOOST_REQUIRE_SMALL(err, 1e-4);
+
+  for (size_t i = 0; i < indices.n_cols; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(
+      recovered(indices(0, i), indices(1, i)),
+      Xorig(indices(0, i), indices(1, i)),
+      1e-3);
+  }
+}
+
+/**
+ * Make sure that the gradient of MatrixCompletionFunction matches a finite
+ * difference approximation, and that the constraints are the errors on the
+ * known entries.
+ */
+BOOST_AUTO_TEST_CASE(MatrixCompletionFunctionGradientTest)
+{
+  const size_t m = 8;
+  const size_t n = 6;
+  const size_t r = 3;
+
+  // Use every other entry of a random matrix.
+  arma::umat indices(2, m * n / 2);
+  arma::vec values(m * n / 2, arma::fill::randu);
+  for (size_t k = 0; k < indices.n_cols; ++k)
+  {
+    indices(0, k) = (2 * k) % m;
+    indices(1, k) = (2 * k) / m;
+  }
+
+  MatrixCompletionFunction f(m, n, indices, values);
+  f.Lambda().randu();
+  f.Sigma() = 3.0;
+
+  arma::mat coordinates(r, m + n, arma::fill::randu);
+
+  arma::vec constraints;
+  const double penalty = f.EvaluateConstraints(coordinates, constraints);
+  BOOST_REQUIRE_EQUAL(constraints.n_elem, indices.n_cols);
+  const arma::mat x = coordinates.cols(0, m - 1).t() *
+      coordinates.cols(m, m + n - 1);
+  for (size_t k = 0; k < indices.n_cols; ++k)
+  {
+    BOOST_REQUIRE_CLOSE(constraints[k],
+        x(indices(0, k), indices(1, k)) - values[k], 1e-5);
+  }
+  BOOST_REQUIRE_CLOSE(penalty, arma::dot(constraints, constraints), 1e-5);
+
+  arma::mat gradient, gradient2;
+  f.Gradient(coordinates, gradient);
+  const double objective = f.EvaluateWithGradient(coordinates, gradient2);
+  BOOST_REQUIRE_CLOSE(objective, f.Evaluate(coordinates), 1e-5);
+  CheckMatrices(gradient, gradient2);
+
+  const double eps = 1e-6;
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+  {
+    arma::mat plus = coordinates, minus = coordinates;
+    plus[i] += eps;
+    minus[i] -= eps;
+    const double numerical = (f.Evaluate(plus) - f.Evaluate(minus)) /
+        (2 * eps);
+    BOOST_REQUIRE_CLOSE(gradient[i], numerical, 1e-3);
+  }
+}
+
+/**
+ * Make sure that the factors recovered from the SDP give the completed matrix.
+ */
+BOOST_AUTO_TEST_CASE(MatrixCompletionSDPFactorsTest)
+{
+  arma::mat Xorig;
+  arma::vec values;
+  arma::umat indices;
+
+  data::Load("completion_X.csv", Xorig, true, false);
+  data::Load("completion_indices.csv", indices, true, false);
+
+  values.set_size(indices.n_cols);
+  for (size_t i = 0; i < indices.n_cols; ++i)
+    values(i) = Xorig(indices(0, i), indices(1, i));
+
+  const arma::mat initialPoint = arma::randu<arma::mat>(Xorig.n_rows +
+      Xorig.n_cols, 23);
+  MatrixCompletion mc(Xorig.n_rows, Xorig.n_cols, indices, values,
+      initialPoint);
+  MatrixCompletion mc2(Xorig.n_rows, Xorig.n_cols, indices, values,
+      initialPoint);
+  BOOST_REQUIRE(!mc.Factorized());
+
+  arma::mat recovered, u, v;
+  mc.Recover(recovered);
+  mc2.Recover(u, v);
+
+  CheckMatrices(recovered, u * v.t(), 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
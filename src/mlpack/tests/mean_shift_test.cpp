@@ -165,4 +165,137 @@ BOOST_AUTO_TEST_CASE(GaussianClustering)
   BOOST_REQUIRE_EQUAL(success, true);
 }
 
+/**
+ * Check that the sampled estimate of the radius is close to the estimate over
+ * all points, that it is the same when the sample covers the dataset, and
+ * that clustering with it assigns the points to their nearest centroid.
+ */
+BOOST_AUTO_TEST_CASE(SampledRadiusEstimateTest)
+{
+  arma::mat dataset = arma::randn(3, 2000);
+  MeanShift<> meanShift;
+  const double radius = meanShift.EstimateRadius(dataset);
+
+  meanShift.RadiusSampleSize() = dataset.n_cols;
+  BOOST_REQUIRE_CLOSE(meanShift.EstimateRadius(dataset), radius, 1e-5);
+
+  meanShift.RadiusSampleSize() = 50;
+  meanShift.RadiusConfidence() = 0.99;
+  meanShift.RadiusTolerance() = 0.02;
+  BOOST_REQUIRE_CLOSE(meanShift.EstimateRadius(dataset), radius, 5.0);
+
+  // The tree of the estimate is reused to assign each point to its nearest
+  // centroid.
+  const arma::mat data = trans(meanShiftData);
+  MeanShift<> sampledMeanShift;
+  sampledMeanShift.RadiusSampleSize() = 10;
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  sampledMeanShift.Cluster(data, assignments, centroids);
+
+  BOOST_REQUIRE_CLOSE(sampledMeanShift.Radius(), meanShift.EstimateRadius(
+      data), 50.0);
+  BOOST_REQUIRE_GT(centroids.n_cols, 1);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    arma::uword nearest;
+    arma::sum(arma::square(centroids.each_col() - data.col(i))).min(nearest);
+    BOOST_REQUIRE_EQUAL(assignments[i], nearest);
+  }
+}
+
+/**
+ * Make sure that mean shift over the bins of the points finds the same three
+ * clusters as mean shift over the points.
+ */
+BOOST_AUTO_TEST_CASE(BinnedMeanShiftTest)
+{
+  GaussianDistribution g1("0.0 0.0", arma::eye<arma::mat>(2, 2));
+  GaussianDistribution g2("10.0 10.0", arma::eye<arma::mat>(2, 2));
+  GaussianDistribution g3("-10.0 5.0", arma::eye<arma::mat>(2, 2));
+  arma::mat dataset(2, 3000);
+  for (size_t i = 0; i < 1000; ++i)
+    dataset.col(i) = g1.Random();
+  for (size_t i = 1000; i < 2000; ++i)
+    dataset.col(i) = g2.Random();
+  for (size_t i = 2000; i < 3000; ++i)
+    dataset.col(i) = g3.Random();
+
+  MeanShift<> meanShift(3.0);
+  arma::Row<size_t> assignments;
+  arma::mat centroids;
+  meanShift.Cluster(dataset, assignments, centroids);
+
+  MeanShift<> binnedMeanShift(3.0);
+  binnedMeanShift.UseBins() = true;
+  arma::Row<size_t> binnedAssignments;
+  arma::mat binnedCentroids;
+  binnedMeanShift.Cluster(dataset, binnedAssignments, binnedCentroids);
+
+  BOOST_REQUIRE_EQUAL(centroids.n_cols, (size_t) 3);
+  BOOST_REQUIRE_EQUAL(binnedCentroids.n_cols, (size_t) 3);
+
+  // Each binned centroid should be close to one of the centroids, and the
+  // points should be assigned to the matching clusters.
+  arma::Col<size_t> matches(3);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    arma::vec centroidDistances(3);
+    for (size_t j = 0; j < 3; ++j)
+    {
+      centroidDistances[j] = metric::EuclideanDistance::Evaluate(
+          binnedCentroids.col(i), centroids.col(j));
+    }
+
+    matches[i] = centroidDistances.index_min();
+    BOOST_REQUIRE_LT(centroidDistances[matches[i]], 1.0);
+  }
+
+  size_t mismatches = 0;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    if (matches[binnedAssignments[i]] != assignments[i])
+      ++mismatches;
+  BOOST_REQUIRE_LT(mismatches, 30);
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that the centroids found with several threads are the same as with
+ * one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelMeanShiftTest)
+{
+  arma::mat dataset = trans(meanShiftData);
+  dataset = arma::join_rows(dataset, dataset + 0.05);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  for (size_t bins = 0; bins < 2; ++bins)
+  {
+    omp_set_num_threads(1);
+    MeanShift<> serialMeanShift(1.0);
+    serialMeanShift.UseBins() = (bins == 1);
+    arma::Row<size_t> serialAssignments;
+    arma::mat serialCentroids;
+    serialMeanShift.Cluster(dataset, serialAssignments, serialCentroids);
+
+    // Force multiple threads, even if only one core is available.
+    omp_set_num_threads(4);
+    MeanShift<> meanShift(1.0);
+    meanShift.UseBins() = (bins == 1);
+    arma::Row<size_t> assignments;
+    arma::mat centroids;
+    meanShift.Cluster(dataset, assignments, centroids);
+
+    BOOST_REQUIRE_EQUAL(centroids.n_cols, serialCentroids.n_cols);
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(centroids[i], serialCentroids[i]);
+    for (size_t i = 0; i < assignments.n_elem; ++i)
+      BOOST_REQUIRE_EQUAL(assignments[i], serialAssignments[i]);
+  }
+
+  omp_set_num_threads(prevNumThreads);
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -64,6 +64,29 @@ BOOST_AUTO_TEST_CASE(L2MetricTest)
                       lMetric.Evaluate(a2, b2), 1e-5);
 }
 
+// Two- and three-dimensional points, and matrix columns, take a separate
+// path for the L2 distance, so check those too.
+BOOST_AUTO_TEST_CASE(L2MetricLowDimensionalTest)
+{
+  for (size_t dim = 1; dim <= 4; ++dim)
+  {
+    arma::mat points(dim, 2, arma::fill::randn);
+    const arma::vec a = points.col(0);
+    const arma::vec b = points.col(1);
+
+    const double distance = sqrt(arma::accu(arma::square(a - b)));
+
+    BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(a, b), distance, 1e-5);
+    BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(points.col(0),
+        points.col(1)), distance, 1e-5);
+    BOOST_REQUIRE_CLOSE(SquaredEuclideanDistance::Evaluate(a, b),
+        distance * distance, 1e-5);
+
+    const arma::sp_vec sa(a);
+    BOOST_REQUIRE_CLOSE(EuclideanDistance::Evaluate(sa, sa), 0.0, 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(LINFMetricTest)
 {
   arma::vec a1(5);
@@ -314,4 +314,124 @@ BOOST_AUTO_TEST_CASE(SeparateTrainIndividualIncrementalTest)
   }
 }
 
+/**
+ * Training in mini-batches with the incremental algorithm should give the same
+ * model as training on all of the data at once.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchIncrementalTrainTest)
+{
+  arma::mat data(4, 3000, arma::fill::randn);
+  arma::Row<size_t> labels(3000);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    labels[i] = math::RandInt(3);
+    data.col(i) += 2.0 * labels[i];
+  }
+
+  NaiveBayesClassifier<> nbc(data, labels, 3, false);
+
+  // Use batches of different sizes, including a single point.
+  NaiveBayesClassifier<> nbcBatch(data.n_rows, 3);
+  nbcBatch.Train(data.cols(0, 0), labels.cols(0, 0), 3);
+  nbcBatch.Train(data.cols(1, 99), labels.cols(1, 99), 3);
+  nbcBatch.Train(data.cols(100, 1799), labels.cols(100, 1799), 3);
+  nbcBatch.Train(data.cols(1800, 2999), labels.cols(1800, 2999), 3);
+
+  for (size_t i = 0; i < nbc.Means().n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(nbc.Means()[i], nbcBatch.Means()[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(nbc.Variances()[i], nbcBatch.Variances()[i], 1e-5);
+  }
+
+  for (size_t i = 0; i < nbc.Probabilities().n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(nbc.Probabilities()[i], nbcBatch.Probabilities()[i],
+        1e-5);
+  }
+}
+
+/**
+ * Classifying many points at once, which handles them in blocks, should give
+ * the same results as classifying them one at a time.
+ */
+BOOST_AUTO_TEST_CASE(BatchClassifyTest)
+{
+  arma::mat data(5, 2000, arma::fill::randn);
+  arma::Row<size_t> labels(2000);
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    labels[i] = math::RandInt(4);
+    data.col(i) += labels[i];
+  }
+
+  // Make one feature constant, so that its variance is tiny.
+  data.row(2).fill(1.0);
+
+  NaiveBayesClassifier<> nbc(data, labels, 4);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  nbc.Classify(data, predictions, probabilities);
+
+  BOOST_REQUIRE_EQUAL(predictions.n_elem, 2000);
+  BOOST_REQUIRE_EQUAL(probabilities.n_rows, 4);
+  BOOST_REQUIRE_EQUAL(probabilities.n_cols, 2000);
+
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    nbc.Classify(data.col(i), prediction, pointProbabilities);
+
+    BOOST_REQUIRE_EQUAL(predictions[i], prediction);
+    BOOST_REQUIRE_EQUAL(nbc.Classify(data.col(i)), prediction);
+    for (size_t j = 0; j < 4; ++j)
+    {
+      if (pointProbabilities[j] < 1e-10)
+        BOOST_REQUIRE_SMALL(probabilities(j, i), 1e-10);
+      else
+        BOOST_REQUIRE_CLOSE(probabilities(j, i), pointProbabilities[j], 1e-5);
+    }
+  }
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Classification with several threads should give the same results as with
+ * one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelClassifyTest)
+{
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  arma::mat data(10, 5000, arma::fill::randn);
+  arma::Row<size_t> labels(5000);
+  for (size_t i = 0; i < 5000; ++i)
+  {
+    labels[i] = math::RandInt(3);
+    data.col(i) += labels[i];
+  }
+
+  NaiveBayesClassifier<> nbc(data, labels, 3);
+
+  omp_set_num_threads(1);
+  arma::Row<size_t> predictions1;
+  arma::mat probabilities1;
+  nbc.Classify(data, predictions1, probabilities1);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  arma::Row<size_t> predictions2;
+  arma::mat probabilities2;
+  nbc.Classify(data, predictions2, probabilities2);
+
+  omp_set_num_threads(prevNumThreads);
+
+  for (size_t i = 0; i < 5000; ++i)
+    BOOST_REQUIRE_EQUAL(predictions1[i], predictions2[i]);
+  for (size_t i = 0; i < probabilities1.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(probabilities1[i], probabilities2[i]);
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
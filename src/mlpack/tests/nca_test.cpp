@@ -249,6 +249,226 @@ BOOST_AUTO_TEST_CASE(SoftmaxSeparableGradient)
   BOOST_REQUIRE_CLOSE(gradient(1, 1), -2.0 * -0.1435886, 0.01);
 }
 
+/**
+ * Compute the objective and gradient of the softmax error function naively,
+ * for comparison.
+ */
+void NaiveSoftmax(const arma::mat& coordinates,
+                  const arma::mat& data,
+                  const arma::Row<size_t>& labels,
+                  double& objective,
+                  arma::mat& gradient)
+{
+  const arma::mat stretched = coordinates * data;
+  arma::mat sum(data.n_rows, data.n_rows, arma::fill::zeros);
+  objective = 0.0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    arma::vec kernel(data.n_cols, arma::fill::zeros);
+    double numerator = 0.0, denominator = 0.0;
+    for (size_t k = 0; k < data.n_cols; ++k)
+    {
+      if (k == i)
+        continue;
+
+      kernel[k] = std::exp(-arma::accu(arma::square(stretched.col(i) -
+          stretched.col(k))));
+      denominator += kernel[k];
+      if (labels[i] == labels[k])
+        numerator += kernel[k];
+    }
+
+    const double p = numerator / denominator;
+    objective -= p;
+    for (size_t k = 0; k < data.n_cols; ++k)
+    {
+      const arma::vec x = data.col(i) - data.col(k);
+      const double same = (labels[i] == labels[k]) ? 1.0 : 0.0;
+      sum += kernel[k] / denominator * (p - same) * x * x.t();
+    }
+  }
+
+  gradient = -2 * coordinates * sum;
+}
+
+/**
+ * Make sure the blocked objective and gradient match a naive computation,
+ * and that the separable objectives and gradients add up to them.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxBlockedNaiveComparison)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 300);
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = i % 3;
+
+  // Keep the distances small enough that no denominator is zero.
+  const arma::mat coordinates = 2.0 * arma::randu<arma::mat>(3, 3);
+
+  double naiveObjective;
+  arma::mat naiveGradient;
+  NaiveSoftmax(coordinates, data, labels, naiveObjective, naiveGradient);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  BOOST_REQUIRE_CLOSE(sef.Evaluate(coordinates), naiveObjective, 1e-5);
+
+  arma::mat gradient;
+  sef.Gradient(coordinates, gradient);
+  CheckMatrices(gradient, naiveGradient, 1e-5);
+
+  BOOST_REQUIRE_CLOSE(sef.EvaluateWithGradient(coordinates, gradient),
+      naiveObjective, 1e-5);
+  CheckMatrices(gradient, naiveGradient, 1e-5);
+
+  // Sum the separable objectives and gradients over batches, the last of
+  // which is smaller.
+  double objective = 0.0;
+  arma::mat gradientSum(3, 3, arma::fill::zeros);
+  arma::mat batchGradient;
+  for (size_t begin = 0; begin < data.n_cols; begin += 7)
+  {
+    const size_t batchSize = std::min((size_t) 7, data.n_cols - begin);
+    objective += sef.EvaluateWithGradient(coordinates, begin, batchGradient,
+        batchSize);
+    gradientSum += batchGradient;
+  }
+
+  BOOST_REQUIRE_CLOSE(objective, naiveObjective, 1e-5);
+  CheckMatrices(gradientSum, naiveGradient, 1e-5);
+}
+
+/**
+ * A generic metric (which does not use matrix products) should give the same
+ * separable and non-separable results.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxGenericMetric)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 100);
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = i % 2;
+
+  SoftmaxErrorFunction<ManhattanDistance> sef(data, labels);
+  const arma::mat coordinates = arma::eye<arma::mat>(3, 3);
+
+  arma::mat gradient, batchGradient;
+  const double objective = sef.EvaluateWithGradient(coordinates, gradient);
+  const double batchObjective = sef.EvaluateWithGradient(coordinates, 0,
+      batchGradient, data.n_cols);
+
+  BOOST_REQUIRE_CLOSE(batchObjective, objective, 1e-5);
+  CheckMatrices(batchGradient, gradient, 1e-5);
+}
+
+/**
+ * Truncating the neighborhoods to all other points should not change the
+ * results, and the truncated gradient should match a finite-difference
+ * approximation.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxTruncatedNeighborhoods)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 100);
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = i % 3;
+
+  arma::mat coordinates = 2.0 * arma::randu<arma::mat>(3, 3);
+
+  SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels);
+  SoftmaxErrorFunction<SquaredEuclideanDistance> allSef(data, labels,
+      SquaredEuclideanDistance(), data.n_cols - 1);
+
+  arma::mat gradient, allGradient;
+  BOOST_REQUIRE_CLOSE(allSef.EvaluateWithGradient(coordinates, allGradient),
+      sef.EvaluateWithGradient(coordinates, gradient), 1e-5);
+  CheckMatrices(allGradient, gradient, 1e-5);
+
+  // Now only use a few neighbors.
+  SoftmaxErrorFunction<SquaredEuclideanDistance> knnSef(data, labels,
+      SquaredEuclideanDistance(), 10);
+  BOOST_REQUIRE_EQUAL(knnSef.NumNeighbors(), 10);
+
+  const double objective = knnSef.EvaluateWithGradient(coordinates, gradient);
+  BOOST_REQUIRE_CLOSE(knnSef.Evaluate(coordinates), objective, 1e-5);
+
+  // The separable objectives (with neighbors searched for the first batch)
+  // should add up to the objective.
+  double batchObjective = 0.0;
+  for (size_t begin = 0; begin < data.n_cols; begin += 10)
+    batchObjective += knnSef.Evaluate(coordinates, begin, 10);
+  BOOST_REQUIRE_CLOSE(batchObjective, objective, 1e-5);
+
+  arma::mat approxGradient(3, 3);
+  const double eps = 1e-6;
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+  {
+    const double original = coordinates[i];
+    coordinates[i] = original + eps;
+    const double upper = knnSef.Evaluate(coordinates);
+    coordinates[i] = original - eps;
+    const double lower = knnSef.Evaluate(coordinates);
+    coordinates[i] = original;
+
+    approxGradient[i] = (upper - lower) / (2 * eps);
+  }
+
+  CheckMatrices(gradient, approxGradient, 1e-3);
+}
+
+/**
+ * Too many neighbors should be rejected.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxTooManyNeighbors)
+{
+  arma::mat data = arma::randu<arma::mat>(3, 10);
+  arma::Row<size_t> labels(data.n_cols, arma::fill::zeros);
+
+  BOOST_REQUIRE_THROW(SoftmaxErrorFunction<SquaredEuclideanDistance>(data,
+      labels, SquaredEuclideanDistance(), 10), std::invalid_argument);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * The objective and gradient should be the same with one thread and with many
+ * threads.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxParallelGradient)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 2000);
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = i % 3;
+
+  const arma::mat coordinates = arma::eye<arma::mat>(4, 4);
+
+  for (size_t numNeighbors = 0; numNeighbors <= 20; numNeighbors += 20)
+  {
+    SoftmaxErrorFunction<SquaredEuclideanDistance> sef(data, labels,
+        SquaredEuclideanDistance(), numNeighbors);
+
+    const size_t prevNumThreads = omp_get_max_threads();
+
+    omp_set_num_threads(1);
+    arma::mat serialGradient;
+    const double serialObjective = sef.EvaluateWithGradient(coordinates, 0,
+        serialGradient, data.n_cols);
+
+    // Force multiple threads, even if only one core is available.
+    omp_set_num_threads(4);
+    arma::mat gradient;
+    const double objective = sef.EvaluateWithGradient(coordinates, 0,
+        gradient, data.n_cols);
+
+    omp_set_num_threads(prevNumThreads);
+
+    BOOST_REQUIRE_CLOSE(objective, serialObjective, 1e-5);
+    CheckMatrices(gradient, serialGradient, 1e-5);
+  }
+}
+
+#endif
+
 //
 // Tests for the NCA algorithm.
 //
@@ -16,6 +16,7 @@
 #include <mlpack/methods/amf/update_rules/nmf_mult_div.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_als.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_mult_dist.hpp>
+#include <mlpack/methods/amf/update_rules/weighted_als.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -295,4 +296,171 @@ BOOST_AUTO_TEST_CASE(NonNegNMFALSTest)
       && arma::all(arma::vectorise(h) >= 0));
 }
 
+
+/**
+ * Solve the weighted ALS problem of each column of h naively, for comparison.
+ */
+void NaiveWeightedALS(const sp_mat& v,
+                      const mat& w,
+                      mat& h,
+                      const double lambda)
+{
+  const mat dv(v);
+  for (size_t j = 0; j < v.n_cols; ++j)
+  {
+    const vec column = dv.col(j);
+    const uvec rows = find(column != 0);
+    if (rows.n_elem == 0)
+    {
+      h.col(j).zeros();
+      continue;
+    }
+
+    const mat local = w.rows(rows);
+    const mat gram = local.t() * local +
+        lambda * rows.n_elem * eye<mat>(w.n_cols, w.n_cols);
+    h.col(j) = solve(gram, local.t() * column.elem(rows));
+  }
+}
+
+/**
+ * Make sure that the sparse weighted ALS updates only fit the nonzero elements
+ * of each row and column.
+ */
+BOOST_AUTO_TEST_CASE(WeightedALSSparseNaiveTest)
+{
+  sp_mat v;
+  v.sprandu(40, 30, 0.2);
+  // Leave one column and one row empty.
+  v.col(3).zeros();
+  v.row(5).zeros();
+
+  mat w = randn<mat>(40, 4);
+  mat h = randn<mat>(4, 30);
+
+  WeightedALSUpdate update(0.1);
+  update.Initialize(v, 4);
+
+  mat naiveH = h;
+  NaiveWeightedALS(v, w, naiveH, 0.1);
+  update.HUpdate(v, w, h);
+  CheckMatrices(h, naiveH, 1e-5);
+
+  mat naiveWt = w.t();
+  NaiveWeightedALS(sp_mat(v.t()), h.t(), naiveWt, 0.1);
+  update.WUpdate(v, w, h);
+  CheckMatrices(w, naiveWt.t(), 1e-5);
+}
+
+/**
+ * Make sure that the sparse and dense weighted ALS updates agree when every
+ * element of the matrix is observed.
+ */
+BOOST_AUTO_TEST_CASE(WeightedALSDenseSparseTest)
+{
+  const mat v = randu<mat>(25, 20) + 0.1;
+  const sp_mat sv(v);
+
+  mat w = randn<mat>(25, 5);
+  mat h = randn<mat>(5, 20);
+  mat sw = w;
+  mat sh = h;
+
+  WeightedALSUpdate update(0.05);
+  update.HUpdate(v, w, h);
+  update.HUpdate(sv, sw, sh);
+  CheckMatrices(h, sh, 1e-5);
+
+  update.WUpdate(v, w, h);
+  update.WUpdate(sv, sw, sh);
+  CheckMatrices(w, sw, 1e-5);
+}
+
+/**
+ * Make sure that as many conjugate gradient steps as the rank solve the least
+ * squares problems just like the Cholesky decomposition.
+ */
+BOOST_AUTO_TEST_CASE(WeightedALSConjugateGradientTest)
+{
+  sp_mat v;
+  v.sprandu(50, 40, 0.3);
+
+  const mat w = randn<mat>(50, 3);
+  mat h = randn<mat>(3, 40);
+  mat cgH = h;
+
+  WeightedALSUpdate update(0.1);
+  WeightedALSUpdate cgUpdate(0.1, true, 3);
+  BOOST_REQUIRE_EQUAL(cgUpdate.ConjugateGradient(), true);
+  BOOST_REQUIRE_EQUAL(cgUpdate.CGIterations(), 3);
+
+  update.HUpdate(v, w, h);
+  cgUpdate.HUpdate(v, w, cgH);
+  CheckMatrices(h, cgH, 1e-3);
+}
+
+/**
+ * Check that the product of the calculated factorization is close to the
+ * input matrix, for the weighted ALS factorizer.
+ */
+BOOST_AUTO_TEST_CASE(WeightedALSFactorizerTest)
+{
+  const mat w = randu<mat>(20, 5);
+  const mat h = randu<mat>(5, 20);
+  const sp_mat v(w * h);
+  const size_t r = 5;
+
+  SimpleResidueTermination srt(1e-12, 1000);
+  WeightedALSFactorizer als(srt, RandomAcolInitialization<>(),
+      WeightedALSUpdate(1e-8));
+
+  mat fw, fh;
+  als.Apply(v, r, fw, fh);
+
+  BOOST_REQUIRE_SMALL(norm(mat(v) - fw * fh, "fro") / norm(mat(v), "fro"),
+      1e-3);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that the sparse weighted ALS updates are the same with one thread
+ * and with many threads.
+ */
+BOOST_AUTO_TEST_CASE(WeightedALSParallelTest)
+{
+  sp_mat v;
+  v.sprandu(300, 200, 0.05);
+
+  const mat w = randn<mat>(300, 6);
+  const mat h = randn<mat>(6, 200);
+
+  for (size_t cg = 0; cg < 2; ++cg)
+  {
+    WeightedALSUpdate update(0.1, cg == 1);
+
+    const size_t prevNumThreads = omp_get_max_threads();
+
+    omp_set_num_threads(1);
+    mat serialW = w;
+    mat serialH = h;
+    update.HUpdate(v, serialW, serialH);
+    update.WUpdate(v, serialW, serialH);
+
+    // Force multiple threads, even if only one core is available.
+    omp_set_num_threads(4);
+    mat parallelW = w;
+    mat parallelH = h;
+    update.HUpdate(v, parallelW, parallelH);
+    update.WUpdate(v, parallelW, parallelH);
+
+    omp_set_num_threads(prevNumThreads);
+
+    CheckMatrices(parallelH, serialH);
+    CheckMatrices(parallelW, serialW);
+  }
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,8 @@
 #include <mlpack/methods/nystroem_method/ordered_selection.hpp>
 #include <mlpack/methods/nystroem_method/random_selection.hpp>
 #include <mlpack/methods/nystroem_method/kmeans_selection.hpp>
+#include <mlpack/methods/nystroem_method/subsampled_kmeans_selection.hpp>
+#include <mlpack/methods/nystroem_method/leverage_score_selection.hpp>
 #include <mlpack/methods/nystroem_method/nystroem_method.hpp>
 
 using namespace mlpack;
@@ -202,4 +204,96 @@ BOOST_AUTO_TEST_CASE(GermanTest)
   }
 }
 
+/**
+ * Make sure that the subsampled k-means selection finds the centers of three
+ * well-separated clusters.
+ */
+BOOST_AUTO_TEST_CASE(SubsampledKMeansSelectionTest)
+{
+  const arma::mat centers("0.0 10.0 -10.0; 0.0 10.0 5.0");
+  arma::mat dataset(2, 3000);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) = centers.col(i % 3) + 0.1 * arma::randn<arma::vec>(2);
+
+  const arma::mat* centroids = SubsampledKMeansSelection<>::Select(dataset, 3);
+  BOOST_REQUIRE_EQUAL(centroids->n_cols, 3);
+
+  arma::Col<size_t> found(3, arma::fill::zeros);
+  for (size_t i = 0; i < 3; ++i)
+  {
+    arma::uword nearest;
+    arma::sum(arma::square(centers.each_col() - centroids->col(i))).min(
+        nearest);
+    BOOST_REQUIRE_SMALL(arma::norm(centers.col(nearest) - centroids->col(i)),
+        0.5);
+    found[nearest] = 1;
+  }
+  BOOST_REQUIRE_EQUAL(arma::accu(found), 3);
+
+  delete centroids;
+}
+
+/**
+ * Check the ridge leverage scores against their definition, and make sure that
+ * the selected points are distinct.
+ */
+BOOST_AUTO_TEST_CASE(LeverageScoreSelectionTest)
+{
+  arma::mat dataset = arma::randn(4, 2500);
+  dataset.row(0) *= 10.0;
+
+  arma::vec scores;
+  LeverageScoreSelection::LeverageScores(dataset, 50, scores);
+  BOOST_REQUIRE_EQUAL(scores.n_elem, dataset.n_cols);
+
+  const arma::mat gram = dataset * dataset.t();
+  const arma::mat ridge = gram + (arma::trace(gram) / 50) *
+      arma::eye<arma::mat>(4, 4);
+  for (size_t i = 0; i < dataset.n_cols; i += 100)
+  {
+    const double score = arma::as_scalar(dataset.col(i).t() *
+        arma::solve(ridge, dataset.col(i)));
+    BOOST_REQUIRE_CLOSE(scores[i], score, 1e-5);
+  }
+
+  const arma::Col<size_t> selected = LeverageScoreSelection::Select(dataset,
+      50);
+  BOOST_REQUIRE_EQUAL(selected.n_elem, 50);
+  BOOST_REQUIRE_EQUAL(arma::Col<size_t>(arma::unique(selected)).n_elem, 50);
+  BOOST_REQUIRE_LT(selected.max(), dataset.n_cols);
+
+  BOOST_REQUIRE_THROW(LeverageScoreSelection::Select(dataset, 2501),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that the Nystroem approximations with the subsampled k-means and
+ * the leverage score selections are better than the zero approximation.
+ */
+BOOST_AUTO_TEST_CASE(LargeScaleSelectionApproximationTest)
+{
+  arma::mat dataset = arma::randu(3, 500);
+  GaussianKernel gk(0.5);
+
+  arma::mat kernel(dataset.n_cols, dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    for (size_t j = 0; j < dataset.n_cols; ++j)
+      kernel(i, j) = gk.Evaluate(dataset.col(i), dataset.col(j));
+
+  arma::mat g;
+  NystroemMethod<GaussianKernel, SubsampledKMeansSelection<>> kmeansNm(dataset,
+      gk, 10);
+  kmeansNm.Apply(g);
+  BOOST_REQUIRE(g.is_finite());
+  BOOST_REQUIRE_LT(arma::norm(kernel - g * g.t(), "fro"),
+      arma::norm(kernel, "fro"));
+
+  NystroemMethod<GaussianKernel, LeverageScoreSelection> leverageNm(dataset,
+      gk, 10);
+  leverageNm.Apply(g);
+  BOOST_REQUIRE(g.is_finite());
+  BOOST_REQUIRE_LT(arma::norm(kernel - g * g.t(), "fro"),
+      arma::norm(kernel, "fro"));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
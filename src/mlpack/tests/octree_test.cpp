@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/core/tree/octree.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -21,6 +22,7 @@ using namespace mlpack::math;
 using namespace mlpack::tree;
 using namespace mlpack::metric;
 using namespace mlpack::bound;
+using namespace mlpack::neighbor;
 
 BOOST_AUTO_TEST_SUITE(OctreeTest);
 
@@ -346,4 +348,122 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   delete textTree;
 }
 
+/**
+ * Make sure that each node built with the Morton-sorted construction has a
+ * tight bound, has more than one child or none, and is a leaf only if it has
+ * few enough points or all of its points are equal.
+ */
+template<typename TreeType>
+void CheckMortonNode(TreeType& node, const size_t maxLeafSize)
+{
+  const arma::mat points = node.Dataset().cols(node.Descendant(0),
+      node.Descendant(0) + node.NumDescendants() - 1);
+  for (size_t d = 0; d < node.Bound().Dim(); ++d)
+  {
+    BOOST_REQUIRE_EQUAL(node.Bound()[d].Lo(), arma::min(points.row(d)));
+    BOOST_REQUIRE_EQUAL(node.Bound()[d].Hi(), arma::max(points.row(d)));
+  }
+
+  BOOST_REQUIRE_NE(node.NumChildren(), 1);
+  if (node.NumChildren() == 0 && node.NumPoints() > maxLeafSize)
+    BOOST_REQUIRE_EQUAL(node.Bound().Diameter(), 0.0);
+
+  size_t descendants = 0;
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(node.Child(i).Descendant(0),
+        node.Descendant(0) + descendants);
+    descendants += node.Child(i).NumDescendants();
+    CheckMortonNode(node.Child(i), maxLeafSize);
+  }
+
+  if (node.NumChildren() > 0)
+    BOOST_REQUIRE_EQUAL(descendants, node.NumDescendants());
+}
+
+/**
+ * Build octrees with the Morton-sorted construction, and check their nodes
+ * and the mapping of the points.
+ */
+BOOST_AUTO_TEST_CASE(MortonBuildTest)
+{
+  for (size_t d = 1; d < 6; ++d)
+  {
+    arma::mat dataset(d, 2000, arma::fill::randu);
+    // Add some duplicate points.
+    dataset.cols(1000, 1099).each_col() = dataset.col(0);
+
+    std::vector<size_t> oldFromNew;
+    Octree<> t(dataset, oldFromNew, MortonBuild(), 10);
+
+    BOOST_REQUIRE_EQUAL(t.NumDescendants(), 2000);
+    BOOST_REQUIRE_EQUAL(oldFromNew.size(), 2000);
+    std::vector<bool> seen(2000, false);
+    for (size_t i = 0; i < 2000; ++i)
+    {
+      BOOST_REQUIRE(!seen[oldFromNew[i]]);
+      seen[oldFromNew[i]] = true;
+      for (size_t j = 0; j < d; ++j)
+        BOOST_REQUIRE_EQUAL(t.Dataset()(j, i), dataset(j, oldFromNew[i]));
+    }
+
+    CheckMortonNode(t, 10);
+    CheckOverlap(t);
+    CheckFurthestDistances(t);
+    CheckNumChildren(t);
+  }
+}
+
+/**
+ * Make sure the Morton-sorted construction works on empty datasets and on
+ * datasets of equal points.
+ */
+BOOST_AUTO_TEST_CASE(MortonBuildDegenerateTest)
+{
+  std::vector<size_t> oldFromNew;
+  arma::mat empty(3, 0);
+  Octree<> t1(std::move(empty), oldFromNew, MortonBuild());
+
+  BOOST_REQUIRE_EQUAL(t1.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(t1.NumDescendants(), 0);
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), 0);
+
+  arma::mat equal(3, 100, arma::fill::ones);
+  Octree<> t2(std::move(equal), oldFromNew, MortonBuild(), 1);
+
+  BOOST_REQUIRE_EQUAL(t2.NumChildren(), 0);
+  BOOST_REQUIRE_EQUAL(t2.NumPoints(), 100);
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), 100);
+}
+
+/**
+ * Make sure that nearest neighbor search with an octree built with the
+ * Morton-sorted construction gives the same results as brute-force search.
+ */
+BOOST_AUTO_TEST_CASE(MortonBuildNeighborSearchTest)
+{
+  arma::mat dataset(3, 3000, arma::fill::randu);
+
+  std::vector<size_t> oldFromNew;
+  Octree<> tree(dataset, oldFromNew, MortonBuild(), 5);
+
+  typedef NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      Octree> OctreeKNN;
+  OctreeKNN knn(std::move(tree));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(dataset, 4, neighbors, distances);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(dataset, 4, naiveNeighbors, naiveDistances);
+
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(oldFromNew[neighbors[i]], naiveNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], naiveDistances[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
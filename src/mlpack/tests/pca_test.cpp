@@ -13,9 +13,11 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/pca/pca.hpp>
 #include <mlpack/methods/pca/decomposition_policies/exact_svd_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/incremental_pca_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/quic_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_svd_method.hpp>
 #include <mlpack/methods/pca/decomposition_policies/randomized_block_krylov_method.hpp>
+#include <mlpack/methods/pca/decomposition_policies/streaming_svd_method.hpp>
 
 #include <boost/test/unit_test.hpp>
 #include "test_tools.hpp"
@@ -207,6 +209,26 @@ BOOST_AUTO_TEST_CASE(ArmaComparisonRandomizedPCATest)
   ArmaComparisonPCA<RandomizedSVDPolicy>();
 }
 
+/**
+ * Compare the output of our streaming-SVD PCA implementation with Armadillo's.
+ * Use small blocks so that the data is processed in several blocks.
+ */
+BOOST_AUTO_TEST_CASE(ArmaComparisonStreamingPCATest)
+{
+  StreamingSVDPolicy decomposition(10, 64);
+  ArmaComparisonPCA<StreamingSVDPolicy>(false, decomposition);
+}
+
+/**
+ * Compare the output of our incremental PCA implementation with Armadillo's.
+ * Use small mini-batches so that the data is processed in several of them.
+ */
+BOOST_AUTO_TEST_CASE(ArmaComparisonIncrementalPCATest)
+{
+  IncrementalPCAPolicy decomposition(64);
+  ArmaComparisonPCA<IncrementalPCAPolicy>(false, decomposition);
+}
+
 /**
  * Test that dimensionality reduction with exact-svd PCA works the same way
  * MATLAB does (which should be correct!).
@@ -236,6 +258,64 @@ BOOST_AUTO_TEST_CASE(RandomizedPCADimensionalityReductionTest)
   PCADimensionalityReduction<RandomizedSVDPolicy>();
 }
 
+/**
+ * Test that dimensionality reduction with streaming-svd PCA works the same way
+ * MATLAB does (which should be correct!).
+ */
+BOOST_AUTO_TEST_CASE(StreamingPCADimensionalityReductionTest)
+{
+  StreamingSVDPolicy decomposition(10, 2);
+  PCADimensionalityReduction<StreamingSVDPolicy>(false, decomposition);
+}
+
+/**
+ * Test that dimensionality reduction with incremental PCA works the same way
+ * MATLAB does (which should be correct!).
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCADimensionalityReductionTest)
+{
+  IncrementalPCAPolicy decomposition(2);
+  PCADimensionalityReduction<IncrementalPCAPolicy>(false, decomposition);
+}
+
+/**
+ * Make sure that the incremental updates track the mean of the points and the
+ * leading principal components of a low-rank dataset.
+ */
+BOOST_AUTO_TEST_CASE(IncrementalPCAUpdateTest)
+{
+  arma::mat U, R;
+  arma::qr_econ(U, R, arma::randn<arma::mat>(20, 3));
+  arma::mat data = U * arma::diagmat(arma::vec("10 5 2")) *
+      arma::randn<arma::mat>(3, 500);
+  data.each_col() += arma::randu<arma::vec>(20);
+
+  IncrementalPCAPolicy ipca(0, 0);
+  ipca.Reset(data.n_rows, 3);
+  for (size_t i = 0; i < data.n_cols; i += 37)
+    ipca.Update(data.cols(i, std::min(i + 37, (size_t) data.n_cols) - 1));
+
+  BOOST_REQUIRE_EQUAL(ipca.NumPoints(), data.n_cols);
+  BOOST_REQUIRE_EQUAL(ipca.Basis().n_cols, 3);
+  CheckMatrices(ipca.Mean(), arma::vec(arma::mean(data, 1)), 1e-5);
+
+  arma::mat centeredData, u, v;
+  arma::vec s;
+  math::Center(data, centeredData);
+  arma::svd_econ(u, s, v, centeredData);
+
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(ipca.SingularValues()[i], s[i], 1e-5);
+
+  // The bases span the same subspace.
+  const arma::mat projection = ipca.Basis() * ipca.Basis().t();
+  CheckMatrices(projection, arma::mat(u.head_cols(3) * u.head_cols(3).t()),
+      1e-3);
+
+  BOOST_REQUIRE_THROW(ipca.Update(arma::randu<arma::mat>(19, 5)),
+      std::invalid_argument);
+}
+
 /**
  * Test that dimensionality reduction with QUIC-SVD PCA works the same way
  * as the Exact-SVD PCA method.
@@ -255,4 +255,157 @@ BOOST_AUTO_TEST_CASE(SecondaryConstructor)
   Perceptron<> p2(p1);
 }
 
+/**
+ * Make sure that the sparse update of SimpleWeightUpdate gives the same result
+ * as the dense update.
+ */
+BOOST_AUTO_TEST_CASE(SimpleWeightUpdateSparse)
+{
+  SimpleWeightUpdate wip;
+
+  vec trainingPoint("0 2 0 4 0");
+  sp_vec sparsePoint(trainingPoint);
+  mat weights = randu<mat>(5, 3);
+  vec biases = randu<vec>(3);
+  mat sparseWeights(weights);
+  vec sparseBiases(biases);
+
+  wip.UpdateWeights(trainingPoint, weights, biases, 0, 2, 0.5);
+  wip.UpdateWeights(sparsePoint, sparseWeights, sparseBiases, 0, 2, 0.5);
+
+  CheckMatrices(sparseWeights, weights);
+  CheckMatrices(sparseBiases, biases);
+}
+
+/**
+ * Make sure that training on sparse data gives the same model as training on
+ * the same dense data.
+ */
+BOOST_AUTO_TEST_CASE(SparseTrain)
+{
+  // Integer-valued data keeps the updates exact.
+  mat trainData = conv_to<mat>::from(randi<imat>(10, 200,
+      distr_param(-3, 3)));
+  trainData.elem(find(randu<mat>(10, 200) < 0.6)).zeros();
+  sp_mat sparseData(trainData);
+
+  Row<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    labels[i] = (trainData(0, i) + trainData(3, i) > 0) ? 1 : 0;
+
+  Perceptron<> p(trainData, labels, 2, 100);
+  Perceptron<SimpleWeightUpdate, ZeroInitialization, sp_mat> sp(sparseData,
+      labels, 2, 100);
+
+  CheckMatrices(sp.Weights(), p.Weights());
+  CheckMatrices(sp.Biases(), p.Biases());
+
+  Row<size_t> predictions, sparsePredictions;
+  p.Classify(trainData, predictions);
+  sp.Classify(sparseData, sparsePredictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(sparsePredictions[i], predictions[i]);
+}
+
+/**
+ * Train an averaged perceptron with mini-batches on three well-separated
+ * Gaussian clusters, and make sure that it classifies new points well.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchAveragedPerceptron)
+{
+  mat centers("0 10 0;"
+              "0 0 10");
+
+  mat trainData(2, 600), testData(2, 300);
+  Row<size_t> labels(600), testLabels(300);
+  for (size_t i = 0; i < 600; ++i)
+  {
+    labels[i] = i % 3;
+    trainData.col(i) = centers.col(labels[i]) + randn<vec>(2);
+  }
+  for (size_t i = 0; i < 300; ++i)
+  {
+    testLabels[i] = i % 3;
+    testData.col(i) = centers.col(testLabels[i]) + randn<vec>(2);
+  }
+
+  Perceptron<> p(3, 2, 50);
+  p.BatchSize() = 32;
+  p.Average() = true;
+  p.Train(trainData, labels, 3);
+
+  BOOST_REQUIRE_EQUAL(p.Weights().n_rows, 2);
+  BOOST_REQUIRE_EQUAL(p.Weights().n_cols, 3);
+
+  Row<size_t> predictions;
+  p.Classify(testData, predictions);
+  const size_t correct = accu(predictions == testLabels);
+  BOOST_REQUIRE_GE((double) correct / testData.n_cols, 0.95);
+
+  // The settings should be copied into models trained from this one.
+  Perceptron<> p2(p, trainData, labels, 3, rowvec());
+  BOOST_REQUIRE_EQUAL(p2.BatchSize(), 32);
+  BOOST_REQUIRE_EQUAL(p2.Average(), true);
+}
+
+/**
+ * Make sure that a batch size of zero is rejected.
+ */
+BOOST_AUTO_TEST_CASE(ZeroBatchSize)
+{
+  mat trainData = randu<mat>(3, 10);
+  Row<size_t> labels = zeros<Row<size_t>>(10);
+
+  Perceptron<> p(2, 3);
+  p.BatchSize() = 0;
+  BOOST_REQUIRE_THROW(p.Train(trainData, labels, 2), std::invalid_argument);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that mini-batch training gives the same model with one thread and
+ * with many threads, on dense and sparse data.
+ */
+BOOST_AUTO_TEST_CASE(MiniBatchParallelTrain)
+{
+  // Integer-valued data keeps the sums of the updates exact.
+  mat trainData = conv_to<mat>::from(randi<imat>(20, 1000,
+      distr_param(-3, 3)));
+  trainData.elem(find(randu<mat>(20, 1000) < 0.7)).zeros();
+  sp_mat sparseData(trainData);
+
+  Row<size_t> labels(trainData.n_cols);
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    labels[i] = (trainData(0, i) - trainData(5, i) > 0) ? 1 :
+        ((trainData(2, i) > 0) ? 2 : 0);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  Perceptron<> serial(3, 20, 20);
+  serial.BatchSize() = 100;
+  serial.Train(trainData, labels, 3);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  Perceptron<> parallel(3, 20, 20);
+  parallel.BatchSize() = 100;
+  parallel.Train(trainData, labels, 3);
+
+  Perceptron<SimpleWeightUpdate, ZeroInitialization, sp_mat> sparse(3, 20,
+      20);
+  sparse.BatchSize() = 100;
+  sparse.Train(sparseData, labels, 3);
+
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(parallel.Weights(), serial.Weights());
+  CheckMatrices(parallel.Biases(), serial.Biases());
+  CheckMatrices(sparse.Weights(), serial.Weights());
+  CheckMatrices(sparse.Biases(), serial.Biases());
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -208,4 +208,89 @@ BOOST_AUTO_TEST_CASE(SparseTest)
   BOOST_REQUIRE_EQUAL(distances.n_cols, 1000);
 }
 
+/**
+ * Make sure that the candidate sets can be stored with floats, and that the
+ * results are then still the distances to the returned neighbors.
+ */
+BOOST_AUTO_TEST_CASE(FloatCandidateSetTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(10, 500);
+  arma::mat querySet = arma::randu<arma::mat>(10, 50);
+
+  math::RandomSeed(42);
+  QDAFN<> qdafn(dataset, 10, 30);
+  math::RandomSeed(42);
+  QDAFN<arma::mat, arma::fmat> floatQdafn(dataset, 10, 30);
+
+  // The candidate sets hold the same points.
+  BOOST_REQUIRE_EQUAL(floatQdafn.NumProjections(), qdafn.NumProjections());
+  for (size_t i = 0; i < qdafn.NumProjections(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(floatQdafn.CandidateSet(i).n_rows, 10);
+    BOOST_REQUIRE_EQUAL(floatQdafn.CandidateSet(i).n_cols, 30);
+    for (size_t j = 0; j < qdafn.CandidateSet(i).n_elem; ++j)
+    {
+      BOOST_REQUIRE_EQUAL(floatQdafn.CandidateSet(i)[j],
+          (float) qdafn.CandidateSet(i)[j]);
+    }
+  }
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  floatQdafn.Search(querySet, 3, neighbors, distances);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, 3);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, 50);
+  for (size_t i = 0; i < neighbors.n_cols; ++i)
+  {
+    for (size_t j = 0; j < neighbors.n_rows; ++j)
+    {
+      BOOST_REQUIRE_LT(neighbors(j, i), (size_t) 500);
+      const double distance = metric::EuclideanDistance::Evaluate(
+          querySet.col(i), dataset.col(neighbors(j, i)));
+      BOOST_REQUIRE_CLOSE(distances(j, i), distance, 1e-3);
+    }
+  }
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Make sure that training and searching with several threads gives the same
+ * results as with one thread.
+ */
+BOOST_AUTO_TEST_CASE(ParallelQDAFNTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(20, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(20, 300);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+
+  omp_set_num_threads(1);
+  math::RandomSeed(42);
+  QDAFN<> serialQdafn(dataset, 15, 40);
+  arma::Mat<size_t> serialNeighbors;
+  arma::mat serialDistances;
+  serialQdafn.Search(querySet, 5, serialNeighbors, serialDistances);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  math::RandomSeed(42);
+  QDAFN<> qdafn(dataset, 15, 40);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  qdafn.Search(querySet, 5, neighbors, distances);
+
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_EQUAL(neighbors.n_rows, serialNeighbors.n_rows);
+  BOOST_REQUIRE_EQUAL(neighbors.n_cols, serialNeighbors.n_cols);
+  for (size_t i = 0; i < neighbors.n_elem; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors[i], serialNeighbors[i]);
+    BOOST_REQUIRE_CLOSE(distances[i], serialDistances[i], 1e-5);
+  }
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -58,4 +58,58 @@ BOOST_AUTO_TEST_CASE(Radical_Test_Radical3D)
   BOOST_REQUIRE_CLOSE(valBest, valEst, 2.0);
 }
 
+/**
+ * Make sure that the unmixing matrix gives the estimated independent
+ * components, Y = W X.
+ */
+BOOST_AUTO_TEST_CASE(RadicalUnmixingMatrixTest)
+{
+  mat matX;
+  data::Load("data_3d_mixed.txt", matX);
+
+  Radical rad(0.175, 5, 100, matX.n_rows - 1);
+
+  mat matY;
+  mat matW;
+  rad.DoRadical(matX, matY, matW);
+
+  BOOST_REQUIRE_EQUAL(matW.n_rows, matX.n_rows);
+  BOOST_REQUIRE_EQUAL(matW.n_cols, matX.n_rows);
+  CheckMatrices(matW * matX, matY, 1e-5);
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that the results don't depend on the number of threads, since the
+ * perturbations of each pair of dimensions are generated from their own seed.
+ */
+BOOST_AUTO_TEST_CASE(RadicalParallelTest)
+{
+  mat matX = randu<mat>(6, 300);
+  matX.row(1) += matX.row(0);
+  matX.row(4) -= 0.5 * matX.row(2);
+
+  Radical rad(0.175, 5, 50, 2);
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  mat matY1, matW1, matY2, matW2;
+  omp_set_num_threads(1);
+  math::RandomSeed(42);
+  rad.DoRadical(matX, matY1, matW1);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  math::RandomSeed(42);
+  rad.DoRadical(matX, matY2, matW2);
+
+  omp_set_num_threads(prevNumThreads);
+
+  CheckMatrices(matW1, matW2, 1e-5);
+  CheckMatrices(matY1, matY2, 1e-5);
+}
+
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();
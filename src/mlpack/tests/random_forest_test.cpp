@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/random_forest/random_forest.hpp>
+#include <mlpack/methods/random_forest/flat_forest.hpp>
 #include <mlpack/methods/decision_tree/random_dimension_select.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -96,6 +97,119 @@ BOOST_AUTO_TEST_CASE(BootstrapWeightsTest)
   }
 }
 
+/**
+ * Make sure bootstrap index sampling produces valid indices with matching
+ * labels and weights.
+ */
+BOOST_AUTO_TEST_CASE(BootstrapIndicesTest)
+{
+  arma::Row<size_t> labels(1000);
+  arma::rowvec weights(1000);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    labels[i] = i;
+    weights[i] = 0.5 * i;
+  }
+
+  for (size_t trial = 0; trial < 5; ++trial)
+  {
+    arma::uvec bootstrapIndices;
+    arma::Row<size_t> bootstrapLabels;
+    arma::rowvec bootstrapWeights;
+
+    BootstrapIndices<true>(1000, labels, weights, bootstrapIndices,
+        bootstrapLabels, bootstrapWeights);
+
+    BOOST_REQUIRE_EQUAL(bootstrapIndices.n_elem, 1000);
+    BOOST_REQUIRE_EQUAL(bootstrapLabels.n_elem, 1000);
+    BOOST_REQUIRE_EQUAL(bootstrapWeights.n_elem, 1000);
+
+    // Each label and weight should be those of the sampled point.
+    for (size_t i = 0; i < 1000; ++i)
+    {
+      BOOST_REQUIRE_LT(bootstrapIndices[i], 1000);
+      BOOST_REQUIRE_EQUAL(bootstrapLabels[i], (size_t) bootstrapIndices[i]);
+      BOOST_REQUIRE_EQUAL(bootstrapWeights[i], 0.5 * bootstrapIndices[i]);
+    }
+
+    // Without weights, the weights are left untouched.
+    arma::rowvec unusedWeights;
+    BootstrapIndices<false>(1000, labels, unusedWeights, bootstrapIndices,
+        bootstrapLabels, bootstrapWeights);
+    BOOST_REQUIRE_EQUAL(bootstrapIndices.n_elem, 1000);
+    BOOST_REQUIRE_EQUAL(bootstrapLabels.n_elem, 1000);
+  }
+}
+
+/**
+ * Make sure that the out-of-bag indices are exactly the points that are not in
+ * the bootstrap sample.
+ */
+BOOST_AUTO_TEST_CASE(OutOfBagIndicesTest)
+{
+  arma::Row<size_t> labels(1000);
+  arma::rowvec weights;
+  arma::uvec bootstrapIndices;
+  arma::Row<size_t> bootstrapLabels;
+  arma::rowvec bootstrapWeights;
+  BootstrapIndices<false>(1000, labels, weights, bootstrapIndices,
+      bootstrapLabels, bootstrapWeights);
+
+  arma::uvec oobIndices;
+  OutOfBagIndices(1000, bootstrapIndices, oobIndices);
+
+  std::vector<bool> inBag(1000, false);
+  for (size_t i = 0; i < bootstrapIndices.n_elem; ++i)
+    inBag[bootstrapIndices[i]] = true;
+
+  size_t numOutOfBag = 0;
+  for (size_t i = 0; i < 1000; ++i)
+    if (!inBag[i])
+      ++numOutOfBag;
+
+  // Roughly 1 / e of the points should be out of bag.
+  BOOST_REQUIRE_EQUAL(oobIndices.n_elem, numOutOfBag);
+  BOOST_REQUIRE_GT(oobIndices.n_elem, 300);
+  BOOST_REQUIRE_LT(oobIndices.n_elem, 440);
+  for (size_t i = 0; i < oobIndices.n_elem; ++i)
+  {
+    BOOST_REQUIRE(!inBag[oobIndices[i]]);
+    if (i > 0)
+      BOOST_REQUIRE_GT(oobIndices[i], oobIndices[i - 1]);
+  }
+}
+
+/**
+ * Make sure that the out-of-bag error of a random forest is a reasonable
+ * estimate of its test error.
+ */
+BOOST_AUTO_TEST_CASE(OOBErrorTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  RandomForest<> empty;
+  BOOST_REQUIRE_EQUAL(empty.OOBError(), 0.0);
+
+  RandomForest<> rf(dataset, labels, 3, 20 /* 20 trees */, 5);
+
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+  arma::Row<size_t> testLabels;
+  data::Load("vc2_test_labels.txt", testLabels);
+
+  arma::Row<size_t> predictions;
+  rf.Classify(testDataset, predictions);
+  const double testError = 1.0 - double(arma::accu(predictions == testLabels)) /
+      testDataset.n_cols;
+
+  BOOST_REQUIRE_GT(rf.OOBError(), 0.0);
+  BOOST_REQUIRE_LT(rf.OOBError(), 0.35);
+  BOOST_REQUIRE_SMALL(rf.OOBError() - testError, 0.15);
+}
+
 /**
  * Make sure an empty forest cannot predict.
  */
@@ -389,6 +503,126 @@ BOOST_AUTO_TEST_CASE(SerializationTest)
   textForest.Classify(dataset, textPredictions, textProbabilities);
   binaryForest.Classify(dataset, binaryPredictions, binaryProbabilities);
 
+  CheckMatrices(beforePredictions, xmlPredictions, textPredictions,
+      binaryPredictions);
+  CheckMatrices(beforeProbabilities, xmlProbabilities, textProbabilities,
+      binaryProbabilities);
+
+  BOOST_REQUIRE_SMALL(xmlForest.OOBError() - rf.OOBError(), 1e-10);
+  BOOST_REQUIRE_SMALL(textForest.OOBError() - rf.OOBError(), 1e-10);
+  BOOST_REQUIRE_SMALL(binaryForest.OOBError() - rf.OOBError(), 1e-10);
+}
+
+/**
+ * Make sure that a FlatForest gives the same predictions as the random forest
+ * and the decision tree it is built from, on numeric data.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestNumericTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+  arma::mat testDataset;
+  data::Load("vc2_test.csv", testDataset);
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 5);
+  DecisionTree<> dt(dataset, labels, 3, 5);
+
+  FlatForest flatForest(rf);
+  FlatForest flatTree(dt);
+
+  BOOST_REQUIRE_EQUAL(flatForest.NumTrees(), (size_t) 10);
+  BOOST_REQUIRE_EQUAL(flatTree.NumTrees(), (size_t) 1);
+  BOOST_REQUIRE_EQUAL(flatForest.NumClasses(), (size_t) 3);
+
+  arma::Row<size_t> rfPredictions, flatForestPredictions;
+  arma::mat rfProbabilities, flatForestProbabilities;
+  rf.Classify(testDataset, rfPredictions, rfProbabilities);
+  flatForest.Classify(testDataset, flatForestPredictions,
+      flatForestProbabilities);
+
+  arma::Row<size_t> dtPredictions, flatTreePredictions;
+  dt.Classify(testDataset, dtPredictions);
+  flatTree.Classify(testDataset, flatTreePredictions);
+
+  CheckMatrices(rfPredictions, flatForestPredictions);
+  CheckMatrices(rfProbabilities, flatForestProbabilities);
+  CheckMatrices(dtPredictions, flatTreePredictions);
+
+  // Single-point classification should give the same results.
+  for (size_t i = 0; i < testDataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(flatForest.Classify(testDataset.col(i)),
+        rfPredictions[i]);
+    BOOST_REQUIRE_EQUAL(flatTree.Classify(testDataset.col(i)),
+        dtPredictions[i]);
+  }
+}
+
+/**
+ * Make sure that a FlatForest gives the same predictions as the random forest
+ * it is built from, on categorical data.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestCategoricalTest)
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+
+  RandomForest<> rf(trainingData, di, trainingLabels, 5, 15 /* 15 trees */, 5);
+  FlatForest flatForest(rf);
+
+  arma::Row<size_t> rfPredictions, flatPredictions;
+  arma::mat rfProbabilities, flatProbabilities;
+  rf.Classify(testData, rfPredictions, rfProbabilities);
+  flatForest.Classify(testData, flatPredictions, flatProbabilities);
+
+  CheckMatrices(rfPredictions, flatPredictions);
+  CheckMatrices(rfProbabilities, flatProbabilities);
+}
+
+/**
+ * Make sure that an empty FlatForest can't classify, and that a FlatForest can
+ * be serialized.
+ */
+BOOST_AUTO_TEST_CASE(FlatForestSerializationTest)
+{
+  arma::mat dataset;
+  data::Load("vc2.csv", dataset);
+  arma::Row<size_t> labels;
+  data::Load("vc2_labels.txt", labels);
+
+  FlatForest empty;
+  arma::Row<size_t> predictions;
+  BOOST_REQUIRE_THROW(empty.Classify(dataset, predictions),
+      std::invalid_argument);
+
+  RandomForest<> rf(dataset, labels, 3, 10 /* 10 trees */, 10);
+  FlatForest flat(rf);
+
+  arma::Row<size_t> beforePredictions;
+  arma::mat beforeProbabilities;
+  flat.Classify(dataset, beforePredictions, beforeProbabilities);
+
+  FlatForest xmlFlat, textFlat, binaryFlat;
+  SerializeObjectAll(flat, xmlFlat, textFlat, binaryFlat);
+
+  BOOST_REQUIRE_EQUAL(xmlFlat.NumNodes(), flat.NumNodes());
+  BOOST_REQUIRE_EQUAL(textFlat.NumNodes(), flat.NumNodes());
+  BOOST_REQUIRE_EQUAL(binaryFlat.NumNodes(), flat.NumNodes());
+
+  arma::Row<size_t> xmlPredictions, textPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, textProbabilities, binaryProbabilities;
+  xmlFlat.Classify(dataset, xmlPredictions, xmlProbabilities);
+  textFlat.Classify(dataset, textPredictions, textProbabilities);
+  binaryFlat.Classify(dataset, binaryPredictions, binaryProbabilities);
+
   CheckMatrices(beforePredictions, xmlPredictions, textPredictions,
       binaryPredictions);
   CheckMatrices(beforeProbabilities, xmlProbabilities, textProbabilities,
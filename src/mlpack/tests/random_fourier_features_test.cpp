@@ -0,0 +1,126 @@
+/**
+ * @file random_fourier_features_test.cpp
+ *
+ * Test the RandomFourierFeatures class, and make sure that the inner products
+ * of the features approximate the kernel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/random_fourier_features/random_fourier_features.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::kernel;
+
+BOOST_AUTO_TEST_SUITE(RandomFourierFeaturesTest);
+
+/**
+ * Compute the mean absolute difference between the exact kernel matrix and its
+ * approximation by random Fourier features.
+ */
+template<typename KernelType>
+double ApproximationError(KernelType& kernel, const size_t numFeatures)
+{
+  arma::mat data = arma::randu<arma::mat>(4, 50);
+
+  RandomFourierFeatures<KernelType> rff(data.n_rows, numFeatures, kernel);
+  arma::mat features;
+  rff.Transform(data, features);
+
+  BOOST_REQUIRE_EQUAL(features.n_rows, numFeatures);
+  BOOST_REQUIRE_EQUAL(features.n_cols, data.n_cols);
+
+  const arma::mat approximation = features.t() * features;
+  double error = 0.0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    for (size_t j = 0; j < data.n_cols; ++j)
+    {
+      error += std::abs(approximation(i, j) -
+          kernel.Evaluate(data.col(i), data.col(j)));
+    }
+  }
+
+  return error / (data.n_cols * data.n_cols);
+}
+
+/**
+ * Make sure that the Gaussian kernel is approximated well.
+ */
+BOOST_AUTO_TEST_CASE(GaussianKernelApproximationTest)
+{
+  GaussianKernel kernel(0.5);
+  BOOST_REQUIRE_LT(ApproximationError(kernel, 5000), 0.03);
+}
+
+/**
+ * Make sure that the Laplacian kernel is approximated well.
+ */
+BOOST_AUTO_TEST_CASE(LaplacianKernelApproximationTest)
+{
+  LaplacianKernel kernel(0.5);
+  BOOST_REQUIRE_LT(ApproximationError(kernel, 5000), 0.03);
+}
+
+/**
+ * Make sure that the Cauchy kernel is approximated well.
+ */
+BOOST_AUTO_TEST_CASE(CauchyKernelApproximationTest)
+{
+  CauchyKernel kernel(0.5);
+  BOOST_REQUIRE_LT(ApproximationError(kernel, 5000), 0.03);
+}
+
+/**
+ * Make sure that more features give a better approximation.
+ */
+BOOST_AUTO_TEST_CASE(MoreFeaturesApproximationTest)
+{
+  GaussianKernel kernel(1.0);
+  const double smallError = ApproximationError(kernel, 20);
+  const double largeError = ApproximationError(kernel, 2000);
+  BOOST_REQUIRE_LT(largeError, smallError);
+}
+
+/**
+ * Make sure that points of the wrong dimensionality are not accepted.
+ */
+BOOST_AUTO_TEST_CASE(WrongDimensionalityTest)
+{
+  RandomFourierFeatures<GaussianKernel> rff(5, 100);
+  BOOST_REQUIRE_EQUAL(rff.Dimensionality(), 5);
+  BOOST_REQUIRE_EQUAL(rff.NumFeatures(), 100);
+
+  arma::mat data = arma::randu<arma::mat>(4, 10);
+  arma::mat features;
+  BOOST_REQUIRE_THROW(rff.Transform(data, features), std::invalid_argument);
+}
+
+/**
+ * Make sure that a serialized feature map gives the same features.
+ */
+BOOST_AUTO_TEST_CASE(RandomFourierFeaturesSerializationTest)
+{
+  RandomFourierFeatures<LaplacianKernel> rff(3, 50);
+  RandomFourierFeatures<LaplacianKernel> xmlRff, textRff, binaryRff;
+
+  SerializeObjectAll(rff, xmlRff, textRff, binaryRff);
+
+  arma::mat data = arma::randu<arma::mat>(3, 20);
+  arma::mat features, xmlFeatures, textFeatures, binaryFeatures;
+  rff.Transform(data, features);
+  xmlRff.Transform(data, xmlFeatures);
+  textRff.Transform(data, textFeatures);
+  binaryRff.Transform(data, binaryFeatures);
+
+  CheckMatrices(features, xmlFeatures, textFeatures, binaryFeatures);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
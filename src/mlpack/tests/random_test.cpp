@@ -97,4 +97,87 @@ BOOST_AUTO_TEST_CASE(WeightedRandomTest)
   }
 }
 
+/**
+ * Make sure that a RandomStream gives the same values for the same seed, and
+ * that the global generator is used again once it is destroyed.
+ */
+BOOST_AUTO_TEST_CASE(RandomStreamTest)
+{
+  RandomSeed(42);
+  const double first = Random();
+  RandomSeed(42);
+
+  arma::vec a(100), b(100);
+  {
+    RandomStream stream(7);
+    for (size_t i = 0; i < a.n_elem; ++i)
+      a[i] = RandNormal();
+  }
+  {
+    RandomStream stream(7);
+    for (size_t i = 0; i < b.n_elem; ++i)
+      b[i] = RandNormal();
+  }
+
+  for (size_t i = 0; i < a.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(a[i], b[i]);
+
+  // The streams did not touch the global generator.
+  BOOST_REQUIRE_EQUAL(Random(), first);
+}
+
+/**
+ * Make sure that parallel regions give reproducible results with a
+ * RandomStream for each unit of work, whatever the schedule.
+ */
+BOOST_AUTO_TEST_CASE(ParallelRandomStreamTest)
+{
+  const size_t units = 64;
+  std::vector<std::mt19937::result_type> seeds(units);
+  for (size_t i = 0; i < units; ++i)
+    seeds[i] = randGen();
+
+  arma::imat a(50, units), b(50, units);
+  #pragma omp parallel for schedule(dynamic)
+  for (omp_size_t i = 0; i < (omp_size_t) units; ++i)
+  {
+    RandomStream stream(seeds[i]);
+    for (size_t j = 0; j < a.n_rows; ++j)
+      a(j, i) = RandInt(1000);
+  }
+
+  #pragma omp parallel for schedule(static, 3)
+  for (omp_size_t i = 0; i < (omp_size_t) units; ++i)
+  {
+    RandomStream stream(seeds[i]);
+    for (size_t j = 0; j < b.n_rows; ++j)
+      b(j, i) = RandInt(1000);
+  }
+
+  BOOST_REQUIRE_EQUAL(arma::accu(a != b), 0);
+}
+
+/**
+ * Make sure that RandomFill() and RandNormalFill() give values with the right
+ * distribution, and the same values for the same seed.
+ */
+BOOST_AUTO_TEST_CASE(RandomFillTest)
+{
+  arma::vec a(100000), b(100000);
+  RandomSeed(13);
+  RandomFill(a, 2.0, 4.0);
+  RandomSeed(13);
+  RandomFill(b, 2.0, 4.0);
+
+  BOOST_REQUIRE_EQUAL(arma::accu(a != b), 0);
+  BOOST_REQUIRE_GE(a.min(), 2.0);
+  BOOST_REQUIRE_LT(a.max(), 4.0);
+  BOOST_REQUIRE_SMALL(arma::mean(a) - 3.0, 0.01);
+
+  arma::fmat c(100, 1000);
+  RandNormalFill(c, 1.0, 2.0);
+  BOOST_REQUIRE_SMALL(arma::mean(arma::vectorise(c)) - 1.0f, 0.05f);
+  BOOST_REQUIRE_SMALL(arma::stddev(arma::vectorise(c)) - 2.0f, 0.05f);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -64,4 +64,59 @@ BOOST_AUTO_TEST_CASE(RandomizedSVDReconstructionError)
   BOOST_REQUIRE_SMALL(error, 1e-5);
 }
 
+/**
+ * The SVD of a sparse matrix should be the same as the SVD of the same matrix
+ * in dense form.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDSparseTest)
+{
+  arma::sp_mat data = arma::sprandu<arma::sp_mat>(50, 300, 0.05);
+  arma::mat denseData(data);
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  svd::RandomizedSVD rSVD(0, 10);
+
+  // Use the same random matrices for both decompositions.
+  math::RandomSeed(42);
+  rSVD.Apply(denseData, U1, s1, V1, 5);
+  math::RandomSeed(42);
+  rSVD.Apply(data, U2, s2, V2, 5);
+
+  // The dense version adds a small value to the mean for stability, so the
+  // results are not exactly the same.
+  CheckMatrices(s1, s2, 1e-2);
+
+  const arma::mat reconstruct = U1 * arma::diagmat(s1) * V1.t();
+  const double error = arma::norm(reconstruct - U2 * arma::diagmat(s2) *
+      V2.t(), "frob") / arma::norm(reconstruct, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-4);
+}
+
+/**
+ * With a zero row mean, the SVD of a sparse matrix is computed without
+ * centering, so the full-rank decomposition should reconstruct the matrix.
+ */
+BOOST_AUTO_TEST_CASE(RandomizedSVDSparseUncenteredTest)
+{
+  arma::sp_mat data = arma::sprandu<arma::sp_mat>(20, 200, 0.1);
+  arma::mat denseData(data);
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  arma::svd_econ(U1, s1, V1, denseData);
+
+  svd::RandomizedSVD rSVD(0, 2);
+  rSVD.Apply(data, U2, s2, V2, 20, arma::sp_mat(data.n_rows, 1));
+
+  BOOST_REQUIRE_EQUAL(s2.n_elem, 20);
+  CheckMatrices(s1, s2, 1e-5);
+
+  const double error = arma::norm(denseData - U2 * arma::diagmat(s2) * V2.t(),
+      "frob") / arma::norm(denseData, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
+#include <mlpack/methods/range_search/grid_range_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/methods/range_search/rs_model.hpp>
 #include <boost/test/unit_test.hpp>
@@ -1696,4 +1697,291 @@ BOOST_AUTO_TEST_CASE(MoveOperatorNaiveTest)
   }
 }
 
+/**
+ * In higher dimensions, the base cases between leaves are computed in blocks
+ * with a matrix multiplication.  Make sure the results are still the same as
+ * the naive search.
+ */
+BOOST_AUTO_TEST_CASE(HighDimensionalDualTreeVsNaiveTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(40, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(40, 300);
+
+  RangeSearch<> rs(dataset);
+  RangeSearch<> naive(dataset, true);
+
+  vector<vector<size_t>> neighborsTree;
+  vector<vector<double>> distancesTree;
+  rs.Search(querySet, Range(2.0, 2.4), neighborsTree, distancesTree);
+  vector<vector<pair<double, size_t>>> sortedTree;
+  SortResults(neighborsTree, distancesTree, sortedTree);
+
+  vector<vector<size_t>> neighborsNaive;
+  vector<vector<double>> distancesNaive;
+  naive.Search(querySet, Range(2.0, 2.4), neighborsNaive, distancesNaive);
+  vector<vector<pair<double, size_t>>> sortedNaive;
+  SortResults(neighborsNaive, distancesNaive, sortedNaive);
+
+  for (size_t i = 0; i < sortedTree.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(sortedTree[i].size(), sortedNaive[i].size());
+
+    for (size_t j = 0; j < sortedTree[i].size(); j++)
+    {
+      BOOST_REQUIRE_EQUAL(sortedTree[i][j].second, sortedNaive[i][j].second);
+      BOOST_REQUIRE_CLOSE(sortedTree[i][j].first, sortedNaive[i][j].first,
+          1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that range search works with single-precision data.
+ */
+BOOST_AUTO_TEST_CASE(FloatKDTreeRangeSearchTest)
+{
+  typedef RangeSearch<EuclideanDistance, arma::fmat, KDTree> FloatRangeSearch;
+
+  arma::fmat dataset = arma::randu<arma::fmat>(3, 1000);
+  arma::fmat querySet = arma::randu<arma::fmat>(3, 200);
+
+  FloatRangeSearch rs(dataset);
+  FloatRangeSearch naive(dataset, true);
+
+  vector<vector<size_t>> neighborsTree;
+  vector<vector<double>> distancesTree;
+  rs.Search(querySet, Range(0.1, 0.3), neighborsTree, distancesTree);
+  vector<vector<pair<double, size_t>>> sortedTree;
+  SortResults(neighborsTree, distancesTree, sortedTree);
+
+  vector<vector<size_t>> neighborsNaive;
+  vector<vector<double>> distancesNaive;
+  naive.Search(querySet, Range(0.1, 0.3), neighborsNaive, distancesNaive);
+  vector<vector<pair<double, size_t>>> sortedNaive;
+  SortResults(neighborsNaive, distancesNaive, sortedNaive);
+
+  for (size_t i = 0; i < sortedTree.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(sortedTree[i].size(), sortedNaive[i].size());
+
+    for (size_t j = 0; j < sortedTree[i].size(); j++)
+    {
+      BOOST_REQUIRE_EQUAL(sortedTree[i][j].second, sortedNaive[i][j].second);
+      BOOST_REQUIRE_CLOSE(sortedTree[i][j].first, sortedNaive[i][j].first,
+          1e-5);
+    }
+  }
+}
+
+/**
+ * Make sure that the CSR results and the counts are the same as the results of
+ * the vector Search(), in each search mode, for bichromatic and monochromatic
+ * search.
+ */
+BOOST_AUTO_TEST_CASE(CSRAndCountSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 800);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+  const Range range(0.05, 0.25);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RangeSearch<> rs(dataset, mode == 0, mode == 1);
+
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      arma::Col<size_t> offsets, csrNeighbors, counts;
+      arma::vec csrDistances;
+      if (mono == 0)
+      {
+        rs.Search(querySet, range, neighbors, distances);
+        rs.Search(querySet, range, offsets, csrNeighbors, csrDistances);
+        rs.Count(querySet, range, counts);
+      }
+      else
+      {
+        rs.Search(range, neighbors, distances);
+        rs.Search(range, offsets, csrNeighbors, csrDistances);
+        rs.Count(range, counts);
+      }
+
+      BOOST_REQUIRE_EQUAL(offsets.n_elem, neighbors.size() + 1);
+      BOOST_REQUIRE_EQUAL(counts.n_elem, neighbors.size());
+      BOOST_REQUIRE_EQUAL(offsets[0], 0);
+      BOOST_REQUIRE_EQUAL(offsets[neighbors.size()], csrNeighbors.n_elem);
+      BOOST_REQUIRE_EQUAL(csrDistances.n_elem, csrNeighbors.n_elem);
+
+      // Convert the CSR results so that they can be sorted the same way.
+      vector<vector<size_t>> convertedNeighbors(neighbors.size());
+      vector<vector<double>> convertedDistances(neighbors.size());
+      for (size_t i = 0; i < neighbors.size(); ++i)
+      {
+        BOOST_REQUIRE_EQUAL(counts[i], neighbors[i].size());
+        for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+        {
+          convertedNeighbors[i].push_back(csrNeighbors[j]);
+          convertedDistances[i].push_back(csrDistances[j]);
+        }
+      }
+
+      vector<vector<pair<double, size_t>>> sorted, sortedCSR;
+      SortResults(neighbors, distances, sorted);
+      SortResults(convertedNeighbors, convertedDistances, sortedCSR);
+
+      for (size_t i = 0; i < sorted.size(); ++i)
+      {
+        BOOST_REQUIRE_EQUAL(sorted[i].size(), sortedCSR[i].size());
+        for (size_t j = 0; j < sorted[i].size(); ++j)
+        {
+          BOOST_REQUIRE_EQUAL(sorted[i][j].second, sortedCSR[i][j].second);
+          BOOST_REQUIRE_CLOSE(sorted[i][j].first, sortedCSR[i][j].first,
+              1e-5);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that GridRangeSearch gives the same results as naive range search,
+ * with cells that are smaller and larger than the radius, with query points
+ * outside of the reference set's bounding box, and in a few dimensions.
+ */
+BOOST_AUTO_TEST_CASE(GridRangeSearchTest)
+{
+  const Range range(0.05, 0.15);
+  const double cellWidths[] = { 0.0, 0.02, 0.15, 0.4 };
+
+  for (size_t d = 1; d <= 3; ++d)
+  {
+    arma::mat dataset = arma::randu<arma::mat>(d, 600);
+    arma::mat querySet = 1.4 * arma::randu<arma::mat>(d, 200) - 0.2;
+
+    RangeSearch<> naive(dataset, true);
+    vector<vector<size_t>> naiveNeighbors;
+    vector<vector<double>> naiveDistances;
+    naive.Search(querySet, range, naiveNeighbors, naiveDistances);
+    vector<vector<pair<double, size_t>>> naiveSorted;
+    SortResults(naiveNeighbors, naiveDistances, naiveSorted);
+
+    for (size_t w = 0; w < 4; ++w)
+    {
+      GridRangeSearch<> grid(dataset, cellWidths[w]);
+      BOOST_REQUIRE_EQUAL(grid.NumPoints(), dataset.n_cols);
+      BOOST_REQUIRE_GT(grid.CellWidth(), 0.0);
+      BOOST_REQUIRE_LE(grid.NumCells(), dataset.n_cols);
+
+      vector<vector<size_t>> neighbors;
+      vector<vector<double>> distances;
+      grid.Search(querySet, range, neighbors, distances);
+
+      // Convert the CSR results so that they can be sorted the same way.
+      arma::Col<size_t> offsets, csrNeighbors;
+      arma::vec csrDistances;
+      grid.Search(querySet, range, offsets, csrNeighbors, csrDistances);
+      BOOST_REQUIRE_EQUAL(offsets.n_elem, querySet.n_cols + 1);
+      vector<vector<size_t>> convertedNeighbors(querySet.n_cols);
+      vector<vector<double>> convertedDistances(querySet.n_cols);
+      for (size_t i = 0; i < querySet.n_cols; ++i)
+      {
+        for (size_t j = offsets[i]; j < offsets[i + 1]; ++j)
+        {
+          convertedNeighbors[i].push_back(csrNeighbors[j]);
+          convertedDistances[i].push_back(csrDistances[j]);
+        }
+      }
+
+      vector<vector<pair<double, size_t>>> sorted, sortedCSR;
+      SortResults(neighbors, distances, sorted);
+      SortResults(convertedNeighbors, convertedDistances, sortedCSR);
+
+      BOOST_REQUIRE_EQUAL(sorted.size(), naiveSorted.size());
+      for (size_t i = 0; i < sorted.size(); ++i)
+      {
+        BOOST_REQUIRE_EQUAL(sorted[i].size(), naiveSorted[i].size());
+        BOOST_REQUIRE_EQUAL(sortedCSR[i].size(), naiveSorted[i].size());
+        for (size_t j = 0; j < sorted[i].size(); ++j)
+        {
+          BOOST_REQUIRE_EQUAL(sorted[i][j].second, naiveSorted[i][j].second);
+          BOOST_REQUIRE_CLOSE(sorted[i][j].first, naiveSorted[i][j].first,
+              1e-5);
+          BOOST_REQUIRE_EQUAL(sortedCSR[i][j].second,
+              naiveSorted[i][j].second);
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that GridRangeSearch rejects invalid parameters and query sets.
+ */
+BOOST_AUTO_TEST_CASE(GridRangeSearchInvalidTest)
+{
+  BOOST_REQUIRE_THROW(GridRangeSearch<>(-1.0), std::invalid_argument);
+
+  arma::mat dataset = arma::randu<arma::mat>(3, 100);
+  arma::mat querySet = arma::randu<arma::mat>(2, 10);
+  GridRangeSearch<> grid(dataset, 0.1);
+
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+  BOOST_REQUIRE_THROW(grid.Search(querySet, Range(0.0, 0.1), neighbors,
+      distances), std::invalid_argument);
+}
+
+/**
+ * Make sure that single-tree search with blocks of query points gives the same
+ * results as naive search, for bichromatic and monochromatic search.
+ */
+BOOST_AUTO_TEST_CASE(QueryBlockRangeSearchTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(3, 200);
+  const Range range(0.05, 0.2);
+
+  RangeSearch<> rs(dataset, false, true);
+  RangeSearch<> naive(dataset, true);
+
+  vector<vector<size_t>> neighbors, naiveNeighbors;
+  vector<vector<double>> distances, naiveDistances;
+  vector<vector<pair<double, size_t>>> sorted, sortedNaive;
+
+  const size_t blockSizes[] = { 3, 32, 500 };
+  for (size_t b = 0; b < 3; ++b)
+  {
+    rs.QueryBlockSize() = blockSizes[b];
+    for (size_t monochromatic = 0; monochromatic < 2; ++monochromatic)
+    {
+      if (monochromatic)
+      {
+        rs.Search(range, neighbors, distances);
+        naive.Search(range, naiveNeighbors, naiveDistances);
+      }
+      else
+      {
+        rs.Search(querySet, range, neighbors, distances);
+        naive.Search(querySet, range, naiveNeighbors, naiveDistances);
+      }
+
+      SortResults(neighbors, distances, sorted);
+      SortResults(naiveNeighbors, naiveDistances, sortedNaive);
+
+      BOOST_REQUIRE_EQUAL(sorted.size(), sortedNaive.size());
+      for (size_t i = 0; i < sorted.size(); i++)
+      {
+        BOOST_REQUIRE_EQUAL(sorted[i].size(), sortedNaive[i].size());
+        for (size_t j = 0; j < sorted[i].size(); j++)
+        {
+          BOOST_REQUIRE_EQUAL(sorted[i][j].second, sortedNaive[i][j].second);
+          BOOST_REQUIRE_CLOSE(sorted[i][j].first, sortedNaive[i][j].first,
+              1e-5);
+        }
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -251,4 +251,32 @@ BOOST_AUTO_TEST_CASE(MiscTest)
   BuildVanillaNetwork<arma::Mat<float>>(X, 2);
 }
 
+/*
+ * Make sure that the units are sampled from their means, and that the samples
+ * only depend on the random seed, not on the number of threads.
+ */
+BOOST_AUTO_TEST_CASE(ParallelSamplingTest)
+{
+  arma::mat data = arma::randu<arma::mat>(20, 50);
+  GaussianInitialization gaussian(0, 0.1);
+  RBM<GaussianInitialization, arma::mat, BinaryRBM> model(data, gaussian, 20,
+      300, 50);
+  model.Reset();
+
+  arma::mat mean, samples, otherSamples;
+  model.HiddenMean(std::move(data), std::move(mean));
+
+  const size_t threads = NumThreads();
+  math::RandomSeed(7);
+  model.SampleHidden(std::move(data), std::move(samples));
+  SetNumThreads(1);
+  math::RandomSeed(7);
+  model.SampleHidden(std::move(data), std::move(otherSamples));
+  SetNumThreads(threads);
+
+  CheckMatrices(samples, otherSamples);
+  BOOST_REQUIRE_EQUAL(arma::accu((samples != 0) % (samples != 1)), 0);
+  BOOST_REQUIRE_SMALL(arma::accu(samples - mean) / samples.n_elem, 0.02);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
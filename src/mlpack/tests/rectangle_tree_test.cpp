@@ -1384,4 +1384,113 @@ BOOST_AUTO_TEST_CASE(RectangleTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Build a tree of the given type with bulk loading, check that it is valid and
+ * as shallow as possible, and compare the results of a search with it to the
+ * results of a naive search.
+ */
+template<template<typename, typename, typename> class TreeType>
+void CheckBulkLoad()
+{
+  typedef TreeType<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> Tree;
+
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  Tree tree(dataset, 20, 6, 5, 2, 0, true);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1000);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckFills(tree);
+  CheckNumDescendants(tree);
+
+  // All leaves must be on the same level, and the leaves must be packed
+  // densely enough that 20 * 5 * 5 < 1000 <= 20 * 5 * 5 * 5 gives a depth of
+  // four.
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+  BOOST_REQUIRE_EQUAL(tree.TreeDepth(), 4);
+
+  arma::Mat<size_t> neighbors1;
+  arma::mat distances1;
+  arma::Mat<size_t> neighbors2;
+  arma::mat distances2;
+
+  NeighborSearch<NearestNeighborSort, metric::LMetric<2, true>, arma::mat,
+      TreeType> knn1(std::move(tree), SINGLE_TREE_MODE);
+  knn1.Search(5, neighbors1, distances1);
+
+  KNN knn2(dataset, NAIVE_MODE);
+  knn2.Search(5, neighbors2, distances2);
+
+  for (size_t i = 0; i < neighbors1.size(); i++)
+  {
+    BOOST_REQUIRE_EQUAL(neighbors1[i], neighbors2[i]);
+    BOOST_REQUIRE_EQUAL(distances1[i], distances2[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(RTreeBulkLoadTest)
+{
+  CheckBulkLoad<RTree>();
+}
+
+BOOST_AUTO_TEST_CASE(RStarTreeBulkLoadTest)
+{
+  CheckBulkLoad<RStarTree>();
+}
+
+BOOST_AUTO_TEST_CASE(XTreeBulkLoadTest)
+{
+  CheckBulkLoad<XTree>();
+}
+
+// Make sure that points can still be inserted into a bulk loaded tree.
+BOOST_AUTO_TEST_CASE(BulkLoadPointInsertionTest)
+{
+  const int numIter = 50;
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef RStarTree<EuclideanDistance, NeighborSearchStat<NearestNeighborSort>,
+      arma::mat> TreeType;
+  TreeType tree(dataset, 20, 6, 5, 2, 0, true);
+
+  tree.Dataset().reshape(8, 1000 + numIter);
+  tree.Dataset().cols(1000, 1000 + numIter - 1).randu();
+  for (int i = 0; i < numIter; i++)
+    tree.InsertPoint(1000 + i);
+
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 1000 + numIter);
+  CheckContainment(tree);
+  CheckExactContainment(tree);
+  CheckHierarchy(tree);
+  CheckNumDescendants(tree);
+  BOOST_REQUIRE_EQUAL(GetMinLevel(tree), GetMaxLevel(tree));
+}
+
+// Trees that can't be bulk loaded must ignore the request and still be valid.
+BOOST_AUTO_TEST_CASE(BulkLoadUnsupportedTest)
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+
+  typedef HilbertRTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> HilbertTreeType;
+  HilbertTreeType hilbertRTree(dataset, 20, 6, 5, 2, 0, true);
+
+  BOOST_REQUIRE_EQUAL(hilbertRTree.NumDescendants(), 1000);
+  CheckHilbertOrdering(hilbertRTree);
+  CheckDiscreteHilbertValueSync(hilbertRTree);
+
+  typedef RPlusTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat> RPlusTreeType;
+  RPlusTreeType rPlusTree(dataset, 20, 6, 5, 2, 0, true);
+
+  BOOST_REQUIRE_EQUAL(rPlusTree.NumDescendants(), 1000);
+  CheckOverlap(rPlusTree);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
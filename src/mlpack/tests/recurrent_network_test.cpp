@@ -1318,4 +1318,123 @@ BOOST_AUTO_TEST_CASE(MultiTimestepTest)
   BOOST_REQUIRE_LE(err, 0.025);
 }
 
+/**
+ * Make sure that truncated BPTT carries the state of the LSTM cells across the
+ * windows, so that a long sequence gets the same outputs and objective as with
+ * a single window, and that training with truncated BPTT works.
+ */
+BOOST_AUTO_TEST_CASE(TruncatedBPTTTest)
+{
+  const size_t rho = 4;
+  const size_t steps = 12;
+  arma::cube input = arma::randu<arma::cube>(3, 5, steps);
+  arma::cube responses = arma::randu<arma::cube>(2, 5, steps);
+
+  RNN<MeanSquaredError<> > full(steps);
+  full.Add<Linear<> >(3, 6);
+  full.Add<LSTM<> >(6, 4);
+  full.Add<Linear<> >(4, 2);
+  full.ResetParameters();
+  full.Predictors() = input;
+  full.Responses() = responses;
+
+  const double objective = full.Evaluate(full.Parameters(), 0, 5, true);
+  arma::cube prediction;
+  full.Predict(input, prediction);
+
+  const size_t strides[] = { 4, 3, 1 };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    RNN<MeanSquaredError<> > truncated(rho);
+    truncated.Add<Linear<> >(3, 6);
+    truncated.Add<LSTM<> >(6, 4);
+    truncated.Add<Linear<> >(4, 2);
+    truncated.ResetParameters();
+    truncated.Parameters() = full.Parameters();
+    truncated.Stride() = strides[i];
+    truncated.Predictors() = input;
+    truncated.Responses() = responses;
+
+    BOOST_REQUIRE_CLOSE(truncated.Evaluate(truncated.Parameters(), 0, 5, true),
+        objective, 1e-5);
+
+    arma::cube truncatedPrediction;
+    truncated.Predict(input, truncatedPrediction);
+    CheckMatrices(truncatedPrediction, prediction, 1e-5);
+
+    arma::mat gradient;
+    truncated.EvaluateWithGradient(truncated.Parameters(), 0, gradient, 5);
+    BOOST_REQUIRE_EQUAL(gradient.n_elem, full.Parameters().n_elem);
+    BOOST_REQUIRE(gradient.is_finite());
+  }
+
+  // Train with windows that overlap by one step.
+  RNN<MeanSquaredError<> > model(rho);
+  model.Add<Linear<> >(3, 6);
+  model.Add<LSTM<> >(6, 4);
+  model.Add<Linear<> >(4, 2);
+  model.ResetParameters();
+  model.Parameters() = full.Parameters();
+  model.Stride() = 3;
+
+  Adam opt(0.01, 5, 0.9, 0.999, 1e-8, 500, -1, false);
+  model.Train(input, responses, opt);
+  BOOST_REQUIRE_LT(model.Evaluate(model.Parameters(), 0, 5, true), objective);
+
+  // The stride can't be larger than the window.
+  model.Stride() = rho + 1;
+  BOOST_REQUIRE_THROW(model.Predict(input, prediction), std::invalid_argument);
+}
+
+/**
+ * Make sure that packed sequences of variable length are sorted by length, and
+ * that each sequence gets the same objective as a network run on that sequence
+ * alone.
+ */
+BOOST_AUTO_TEST_CASE(PackedSequencesTest)
+{
+  const size_t rho = 4;
+  arma::cube input = arma::randu<arma::cube>(3, 5, rho);
+  arma::cube responses = arma::randu<arma::cube>(2, 5, rho);
+  arma::urowvec lengths("2 4 3 4 1");
+
+  RNN<MeanSquaredError<> > model(rho);
+  model.Add<Linear<> >(3, 6);
+  model.Add<LSTM<> >(6, 4);
+  model.Add<Linear<> >(4, 2);
+
+  Adam opt(0.01, 2, 0.9, 0.999, 1e-8, 50, -1, false);
+  model.Train(input, responses, lengths, opt);
+
+  const arma::urowvec& packed = model.SequenceLengths();
+  BOOST_REQUIRE_EQUAL(packed.n_elem, 5);
+  for (size_t i = 1; i < packed.n_elem; ++i)
+    BOOST_REQUIRE_GE(packed[i - 1], packed[i]);
+
+  for (size_t i = 0; i < packed.n_elem; ++i)
+  {
+    RNN<MeanSquaredError<> > single(packed[i]);
+    single.Add<Linear<> >(3, 6);
+    single.Add<LSTM<> >(6, 4);
+    single.Add<Linear<> >(4, 2);
+    single.ResetParameters();
+    single.Parameters() = model.Parameters();
+    single.Predictors() = model.Predictors().tube(0, i, 2, i);
+    single.Responses() = model.Responses().tube(0, i, 1, i);
+
+    BOOST_REQUIRE_CLOSE(model.Evaluate(model.Parameters(), i, 1, true),
+        single.Evaluate(single.Parameters(), 0, 1, true), 1e-5);
+  }
+
+  arma::mat gradient;
+  model.EvaluateWithGradient(model.Parameters(), 0, gradient, 5);
+  BOOST_REQUIRE_EQUAL(gradient.n_elem, model.Parameters().n_elem);
+  BOOST_REQUIRE(gradient.is_finite());
+
+  // The sequences can't be longer than rho.
+  lengths[0] = rho + 1;
+  BOOST_REQUIRE_THROW(model.Train(input, responses, lengths, opt),
+      std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
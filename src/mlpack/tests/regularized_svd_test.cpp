@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/regularized_svd/regularized_svd.hpp>
+#include <mlpack/methods/regularized_svd/rating_strata.hpp>
 
 #include <ensmallen.hpp>
 
@@ -251,6 +252,65 @@ BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimize)
   BOOST_REQUIRE_SMALL(relativeError, 1e-2);
 }
 
+/**
+ * Make sure that every rating is assigned to exactly one stratum, and that the
+ * strata of a sub-epoch share no users and no items.
+ */
+BOOST_AUTO_TEST_CASE(RatingStrataTest)
+{
+  const size_t numUsers = 100;
+  const size_t numItems = 80;
+  const size_t numRatings = 2000;
+  const size_t numBlocks = 4;
+
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  RatingStrata strata(data, numUsers, numItems, numBlocks);
+  BOOST_REQUIRE_EQUAL(strata.NumBlocks(), numBlocks);
+
+  arma::Col<size_t> order = arma::shuffle(arma::linspace<arma::Col<size_t>>(0,
+      numRatings - 1, numRatings));
+  const size_t count = 1500;
+  strata.Assign(order, count);
+  BOOST_REQUIRE_EQUAL(strata.Ratings().n_elem, count);
+
+  // Each of the visited ratings is in exactly one stratum.
+  arma::Col<size_t> visits(numRatings, arma::fill::zeros);
+  for (size_t s = 0; s < numBlocks; ++s)
+  {
+    arma::Col<size_t> userBlock(numUsers), itemBlock(numItems);
+    userBlock.fill(numBlocks);
+    itemBlock.fill(numBlocks);
+
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t c = strata.ItemBlock(b, s);
+      for (size_t k = strata.Begin(b, c); k < strata.End(b, c); ++k)
+      {
+        const size_t j = strata.Ratings()[k];
+        const size_t user = data(0, j);
+        const size_t item = data(1, j);
+        ++visits[j];
+
+        // No other stratum of the sub-epoch has the same user or item.
+        if (userBlock[user] != numBlocks)
+          BOOST_REQUIRE_EQUAL(userBlock[user], b);
+        if (itemBlock[item] != numBlocks)
+          BOOST_REQUIRE_EQUAL(itemBlock[item], b);
+        userBlock[user] = b;
+        itemBlock[item] = b;
+      }
+    }
+  }
+
+  for (size_t j = 0; j < count; ++j)
+    BOOST_REQUIRE_EQUAL(visits[order[j]], 1);
+  for (size_t j = count; j < numRatings; ++j)
+    BOOST_REQUIRE_EQUAL(visits[order[j]], 0);
+}
+
 // The test is only compiled if the user has specified OpenMP to be
 // used.
 #ifdef HAS_OPENMP
@@ -316,6 +376,75 @@ BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimizeHOGWILD)
   BOOST_REQUIRE_SMALL(relativeError, 1e-2);
 }
 
+
+// Test Regularized SVD with the stratified parallel SGD, with multiple threads.
+BOOST_AUTO_TEST_CASE(RegularizedSVDFunctionOptimizeStratified)
+{
+  // Define useful constants.
+  const size_t numUsers = 50;
+  const size_t numItems = 50;
+  const size_t numRatings = 100;
+  const size_t rank = 10;
+  const double alpha = 0.02;
+  const double lambda = 0.01;
+
+  // Force multiple threads, even if only one core is available.
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+
+  // Initiate random parameters.
+  arma::mat parameters = arma::randu(rank, numUsers + numItems);
+
+  // Make a random rating dataset.
+  arma::mat data = arma::randu(3, numRatings);
+  data.row(0) = floor(data.row(0) * numUsers);
+  data.row(1) = floor(data.row(1) * numItems);
+
+  // Manually set last row to maximum user and maximum item.
+  data(0, numRatings - 1) = numUsers - 1;
+  data(1, numRatings - 1) = numItems - 1;
+
+  // Make rating entries based on the parameters.
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    data(2, i) = arma::dot(parameters.col(data(0, i)),
+                           parameters.col(numUsers + data(1, i)));
+  }
+
+  // Make the Reg SVD function and the optimizer.
+  RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
+
+  // The step size is never reduced.
+  ExponentialBackoff decayPolicy(100000, alpha, 0.5);
+
+  // Iterate till convergence; the specialization of the optimizer for the
+  // function is used.
+  ParallelSGD<ExponentialBackoff> optimizer(0,
+      std::ceil((float) rSVDFunc.NumFunctions() / 4), 1e-7, true,
+      decayPolicy);
+
+  // Obtain optimized parameters after training.
+  arma::mat optParameters = arma::randu(rank, numUsers + numItems);
+  optimizer.Optimize(rSVDFunc, optParameters);
+
+  omp_set_num_threads(prevNumThreads);
+
+  // Get predicted ratings from optimized parameters.
+  arma::mat predictedData(1, numRatings);
+  for (size_t i = 0; i < numRatings; i++)
+  {
+    predictedData(0, i) = arma::dot(optParameters.col(data(0, i)),
+                                    optParameters.col(numUsers + data(1, i)));
+  }
+
+  // Calculate relative error.
+  const double relativeError = arma::norm(data.row(2) - predictedData, "frob") /
+                               arma::norm(data, "frob");
+
+  // Relative error should be small.
+  BOOST_REQUIRE_SMALL(relativeError, 1e-2);
+}
+
 #endif
 
 BOOST_AUTO_TEST_SUITE_END();
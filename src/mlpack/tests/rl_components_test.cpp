@@ -19,6 +19,8 @@
 #include <mlpack/methods/reinforcement_learning/environment/acrobot.hpp>
 #include <mlpack/methods/reinforcement_learning/environment/pendulum.hpp>
 #include <mlpack/methods/reinforcement_learning/replay/random_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/prioritized_replay.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/compact_replay.hpp>
 #include <mlpack/methods/reinforcement_learning/policy/greedy_policy.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -166,6 +168,236 @@ BOOST_AUTO_TEST_CASE(RandomReplayTest)
   }
 }
 
+/**
+ * Check the sums and the prefix search of a sum tree, with single and batched
+ * updates.
+ */
+BOOST_AUTO_TEST_CASE(SumTreeTest)
+{
+  SumTree<double> tree(5);
+  BOOST_REQUIRE_EQUAL(tree.Capacity(), 5);
+  BOOST_REQUIRE_SMALL(tree.Sum(), 1e-10);
+
+  tree.Set(0, 1.0);
+  tree.Set(2, 2.0);
+  tree.Set(4, 3.0);
+  BOOST_REQUIRE_CLOSE(tree.Sum(), 6.0, 1e-10);
+
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(0.0), 0);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(0.99), 0);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(1.0), 2);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(2.99), 2);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(3.0), 4);
+  // Masses past the sum still give a nonzero value.
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(6.5), 4);
+
+  // The batched update gives the same sums as the single updates.
+  tree.Set(arma::uvec("1 4 0"), arma::vec("0.5 1.0 2.0"));
+  BOOST_REQUIRE_CLOSE(tree.Sum(), 5.5, 1e-10);
+  BOOST_REQUIRE_CLOSE(tree.Get(1), 0.5, 1e-10);
+  BOOST_REQUIRE_CLOSE(tree.Get(4), 1.0, 1e-10);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(2.2), 1);
+  BOOST_REQUIRE_EQUAL(tree.FindPrefixSum(4.6), 4);
+}
+
+/**
+ * Check that the prioritized replay stores the experiences like the random
+ * replay, and that it samples them according to their priorities after an
+ * update.
+ */
+BOOST_AUTO_TEST_CASE(PrioritizedReplayTest)
+{
+  PrioritizedReplay<MountainCar> replay(2, 3, 1.0, 1.0);
+  MountainCar env;
+  MountainCar::State state = env.InitialSample();
+  MountainCar::Action action = MountainCar::Action::forward;
+  MountainCar::State nextState;
+  double reward = env.Sample(state, action, nextState);
+  replay.Store(state, action, reward, nextState, env.IsTerminal(nextState));
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+
+  //! So far there should be only one record in the memory
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+
+  CheckMatrices(state.Encode(), sampledState.col(0));
+  BOOST_REQUIRE_EQUAL(action, sampledAction[0]);
+  BOOST_REQUIRE_CLOSE(reward, sampledReward[0], 1e-5);
+  CheckMatrices(nextState.Encode(), sampledNextState.col(0));
+  BOOST_REQUIRE_EQUAL(false, sampledTerminal[0]);
+  BOOST_REQUIRE_EQUAL(1, replay.Size());
+
+  replay.Store(nextState, action, reward, state, true);
+  BOOST_REQUIRE_EQUAL(2, replay.Size());
+
+  // Both records have the same priority, so each half of the batch takes one
+  // of them, with the same weight.
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+  BOOST_REQUIRE_EQUAL(replay.SampledIndices()[0], 0);
+  BOOST_REQUIRE_EQUAL(replay.SampledIndices()[1], 1);
+  BOOST_REQUIRE_CLOSE(replay.Weights()[0], 1.0, 1e-5);
+  BOOST_REQUIRE_CLOSE(replay.Weights()[1], 1.0, 1e-5);
+
+  // Give the first record a much smaller temporal difference error than the
+  // second, so that it is almost never sampled anymore.
+  arma::mat actionValues(3, 2, arma::fill::zeros);
+  arma::mat target = actionValues;
+  target(sampledAction[0], 0) = 1e-4;
+  target(sampledAction[1], 1) = 10.0;
+  replay.Update(sampledAction, actionValues, target);
+
+  // The weights are 1, so the targets are unchanged.
+  BOOST_REQUIRE_CLOSE(target(sampledAction[0], 0), 1e-4, 1e-5);
+  BOOST_REQUIRE_CLOSE(target(sampledAction[1], 1), 10.0, 1e-5);
+
+  size_t firstRecord = 0;
+  for (size_t i = 0; i < 50; ++i)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+        sampledTerminal);
+    firstRecord += arma::accu(replay.SampledIndices() == 0);
+  }
+
+  BOOST_REQUIRE_LE(firstRecord, 2);
+  CheckMatrices(nextState.Encode(), sampledState.col(0));
+  BOOST_REQUIRE_EQUAL(true, sampledTerminal[0]);
+}
+
+/**
+ * Check that the compact replay shares the frames of a trajectory, converts
+ * the stored states, and drops the oldest transitions when its frames are
+ * overwritten.
+ */
+BOOST_AUTO_TEST_CASE(CompactReplayTest)
+{
+  CompactReplay<MountainCar, unsigned char> replay(2, 3);
+  MountainCar::Action action = MountainCar::Action::forward;
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+
+  // A trajectory of three transitions takes four frames.
+  for (size_t k = 0; k < 3; ++k)
+  {
+    MountainCar::State state(arma::colvec({ (double) k, 1.0 }));
+    MountainCar::State nextState(arma::colvec({ k + 1.0, 1.0 }));
+    replay.Store(state, action, 1.0, nextState, false);
+  }
+  BOOST_REQUIRE_EQUAL(3, replay.Size());
+  BOOST_REQUIRE_EQUAL(4, replay.Frames().n_cols);
+  for (size_t k = 0; k < 4; ++k)
+    BOOST_REQUIRE_EQUAL((size_t) replay.Frames()(0, k), k);
+
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+  for (size_t i = 0; i < 2; ++i)
+  {
+    const double k = replay.SampledIndices()[i];
+    BOOST_REQUIRE_CLOSE(sampledState(0, i), k, 1e-5);
+    BOOST_REQUIRE_CLOSE(sampledNextState(0, i), k + 1.0, 1e-5);
+    BOOST_REQUIRE_CLOSE(sampledState(1, i), 1.0, 1e-5);
+    BOOST_REQUIRE_EQUAL(action, sampledAction[i]);
+    BOOST_REQUIRE_CLOSE(sampledReward[i], 1.0, 1e-5);
+    BOOST_REQUIRE_EQUAL(false, sampledTerminal[i]);
+  }
+
+  // A transition that does not follow the trajectory takes two frames, so it
+  // overwrites the frames of the first two transitions.
+  MountainCar::State state(arma::colvec({ 7.0, 2.0 }));
+  MountainCar::State nextState(arma::colvec({ 8.0, 2.0 }));
+  replay.Store(state, action, 2.0, nextState, true);
+  BOOST_REQUIRE_EQUAL(2, replay.Size());
+
+  for (size_t i = 0; i < 10; ++i)
+  {
+    replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+        sampledTerminal);
+    for (size_t j = 0; j < 2; ++j)
+    {
+      if (replay.SampledIndices()[j] == 0)
+      {
+        BOOST_REQUIRE_CLOSE(sampledState(0, j), 2.0, 1e-5);
+        BOOST_REQUIRE_CLOSE(sampledNextState(0, j), 3.0, 1e-5);
+        BOOST_REQUIRE_EQUAL(false, sampledTerminal[j]);
+      }
+      else
+      {
+        BOOST_REQUIRE_CLOSE(sampledState(0, j), 7.0, 1e-5);
+        BOOST_REQUIRE_CLOSE(sampledNextState(0, j), 8.0, 1e-5);
+        BOOST_REQUIRE_CLOSE(sampledReward[j], 2.0, 1e-5);
+        BOOST_REQUIRE_EQUAL(true, sampledTerminal[j]);
+      }
+    }
+  }
+}
+
+/**
+ * Check the n-step returns of the compact replay, which stop at the end of
+ * the episodes and at breaks of the trajectories, and the rescaling of the
+ * targets in Update().
+ */
+BOOST_AUTO_TEST_CASE(CompactReplayNStepTest)
+{
+  CompactReplay<MountainCar> replay(20, 10, 3, 0.5);
+  MountainCar::Action action = MountainCar::Action::stop;
+
+  // An episode of four transitions, with rewards 1, 2, 3 and 4, and then a
+  // transition from another trajectory.
+  for (size_t k = 0; k < 4; ++k)
+  {
+    MountainCar::State state(arma::colvec({ (double) k, 0.0 }));
+    MountainCar::State nextState(arma::colvec({ k + 1.0, 0.0 }));
+    replay.Store(state, action, k + 1.0, nextState, k == 3);
+  }
+  MountainCar::State state(arma::colvec({ 10.0, 0.0 }));
+  MountainCar::State nextState(arma::colvec({ 11.0, 0.0 }));
+  replay.Store(state, action, 5.0, nextState, false);
+  BOOST_REQUIRE_EQUAL(5, replay.Size());
+
+  arma::mat sampledState;
+  arma::icolvec sampledAction;
+  arma::colvec sampledReward;
+  arma::mat sampledNextState;
+  arma::icolvec sampledTerminal;
+  replay.Sample(sampledState, sampledAction, sampledReward, sampledNextState,
+      sampledTerminal);
+
+  // Each target is the return plus the value 10 of the next state, discounted
+  // once, as computed by QLearning.
+  arma::mat actionValues(3, 20, arma::fill::zeros);
+  arma::mat target = actionValues;
+  for (size_t i = 0; i < 20; ++i)
+  {
+    target(sampledAction[i], i) = sampledReward[i] +
+        (sampledTerminal[i] ? 0.0 : 0.5 * 10.0);
+  }
+  replay.Update(sampledAction, actionValues, target);
+
+  const arma::vec returns("2.75 4.5 5.0 4.0 5.0");
+  const arma::vec nextStates("3.0 4.0 4.0 4.0 11.0");
+  const arma::vec steps("3.0 3.0 2.0 1.0 1.0");
+  for (size_t i = 0; i < 20; ++i)
+  {
+    const size_t k = replay.SampledIndices()[i];
+    BOOST_REQUIRE_CLOSE(sampledState(0, i), (k < 4) ? k : 10.0, 1e-5);
+    BOOST_REQUIRE_CLOSE(sampledReward[i], returns[k], 1e-5);
+    BOOST_REQUIRE_CLOSE(sampledNextState(0, i), nextStates[k], 1e-5);
+    BOOST_REQUIRE_EQUAL(sampledTerminal[i], (k >= 1 && k < 4));
+
+    const double value = sampledTerminal[i] ? 0.0 :
+        std::pow(0.5, steps[k]) * 10.0;
+    BOOST_REQUIRE_CLOSE(target(sampledAction[i], i), returns[k] + value,
+        1e-5);
+  }
+}
+
 /**
  * Construct a greedy policy instance and check if it works as
  * it should be.
@@ -361,6 +361,58 @@ BOOST_AUTO_TEST_CASE(BinarySpaceTreeOverwriteTest)
   CheckTrees(tree, xmlTree, textTree, binaryTree);
 }
 
+/**
+ * Make sure that a loaded binary space tree holds all of its descendants in a
+ * single block.
+ */
+BOOST_AUTO_TEST_CASE(BinarySpaceTreeCompactLoadTest)
+{
+  arma::mat data;
+  data.randu(3, 1000);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(data);
+
+  TreeType* xmlTree;
+  TreeType* textTree;
+  TreeType* binaryTree;
+
+  SerializePointerObjectAll(&tree, xmlTree, textTree, binaryTree);
+
+  CheckTrees(tree, *xmlTree, *textTree, *binaryTree);
+
+  BOOST_REQUIRE(xmlTree->IsCompact());
+  BOOST_REQUIRE(textTree->IsCompact());
+  BOOST_REQUIRE(binaryTree->IsCompact());
+
+  delete xmlTree;
+  delete textTree;
+  delete binaryTree;
+}
+
+/**
+ * Make sure that vantage point trees, whose bounds depend on their siblings,
+ * are serialized correctly.
+ */
+BOOST_AUTO_TEST_CASE(VPTreeTest)
+{
+  arma::mat data;
+  data.randu(3, 100);
+  typedef VPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(data);
+
+  TreeType* xmlTree;
+  TreeType* textTree;
+  TreeType* binaryTree;
+
+  SerializePointerObjectAll(&tree, xmlTree, textTree, binaryTree);
+
+  CheckTrees(tree, *xmlTree, *textTree, *binaryTree);
+
+  delete xmlTree;
+  delete textTree;
+  delete binaryTree;
+}
+
 BOOST_AUTO_TEST_CASE(CoverTreeTest)
 {
   arma::mat data;
@@ -1055,16 +1107,45 @@ BOOST_AUTO_TEST_CASE(LSHTest)
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), textLsh.BucketSize());
   BOOST_REQUIRE_EQUAL(lsh.BucketSize(), binaryLsh.BucketSize());
 
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      xmlLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      textLsh.SecondHashTable().size());
-  BOOST_REQUIRE_EQUAL(lsh.SecondHashTable().size(),
-      binaryLsh.SecondHashTable().size());
+  CheckMatrices(lsh.SecondHashTable(), xmlLsh.SecondHashTable(),
+      textLsh.SecondHashTable(), binaryLsh.SecondHashTable());
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      textLsh.BucketOffsets(), binaryLsh.BucketOffsets());
+}
+
+/**
+ * Test that an LSH model with inserted points can be serialized and
+ * deserialized, and gives the same results afterwards.
+ */
+BOOST_AUTO_TEST_CASE(LSHInsertTest)
+{
+  arma::mat referenceData = arma::randu<arma::mat>(5, 200);
+  arma::mat queryData = arma::randu<arma::mat>(5, 20);
+
+  LSHSearch<> lsh(referenceData.cols(0, 99), 4, 6, 0.3);
+  lsh.Insert(referenceData.cols(100, 199));
+
+  LSHSearch<> xmlLsh;
+  arma::mat textData = arma::randu<arma::mat>(5, 50);
+  LSHSearch<> textLsh(textData, 4, 5);
+  LSHSearch<> binaryLsh(textData, 15, 2);
 
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      textLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  SerializeObjectAll(lsh, xmlLsh, textLsh, binaryLsh);
+
+  CheckMatrices(lsh.SecondHashTable(), xmlLsh.SecondHashTable(),
+      textLsh.SecondHashTable(), binaryLsh.SecondHashTable());
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      textLsh.BucketOffsets(), binaryLsh.BucketOffsets());
+
+  arma::Mat<size_t> neighbors, xmlNeighbors, textNeighbors, binaryNeighbors;
+  arma::mat distances, xmlDistances, textDistances, binaryDistances;
+  lsh.Search(queryData, 3, neighbors, distances);
+  xmlLsh.Search(queryData, 3, xmlNeighbors, xmlDistances);
+  textLsh.Search(queryData, 3, textNeighbors, textDistances);
+  binaryLsh.Search(queryData, 3, binaryNeighbors, binaryDistances);
+
+  CheckMatrices(neighbors, xmlNeighbors, textNeighbors, binaryNeighbors);
+  CheckMatrices(distances, xmlDistances, textDistances, binaryDistances);
 }
 
 // Make sure serialization works for the decision stump.
@@ -38,7 +38,7 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionEvaluate)
     labels(i) = math::RandInt(0, numClasses);
 
   // Create a SoftmaxRegressionFunction. Regularization term ignored.
-  SoftmaxRegressionFunction srf(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -83,9 +83,9 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionRegularizationEvaluate)
     labels(i) = math::RandInt(0, numClasses);
 
   // 3 objects for comparing regularization costs.
-  SoftmaxRegressionFunction srfNoReg(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srfSmallReg(data, labels, numClasses, 1);
-  SoftmaxRegressionFunction srfBigReg(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srfNoReg(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srfSmallReg(data, labels, numClasses, 1);
+  SoftmaxRegressionFunction<> srfBigReg(data, labels, numClasses, 20);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -125,8 +125,8 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionGradient)
 
   // 2 objects for 2 terms in the cost function. Each term contributes towards
   // the gradient and thus need to be checked independently.
-  SoftmaxRegressionFunction srf1(data, labels, numClasses, 0);
-  SoftmaxRegressionFunction srf2(data, labels, numClasses, 20);
+  SoftmaxRegressionFunction<> srf1(data, labels, numClasses, 0);
+  SoftmaxRegressionFunction<> srf2(data, labels, numClasses, 20);
 
   // Create a random set of parameters.
   arma::mat parameters;
@@ -171,6 +171,110 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionGradient)
   }
 }
 
+/**
+ * Make sure that the batches cover the whole dataset after Shuffle(), for dense
+ * and sparse data: the mean of the objectives and the gradients of the batches
+ * must be the objective and the gradient on the whole dataset.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionShuffleTest)
+{
+  const size_t points = 100;
+  const size_t inputSize = 8;
+  const size_t numClasses = 4;
+  const size_t batchSize = 10;
+
+  arma::sp_mat sparseData = arma::sprandu<arma::sp_mat>(inputSize, points,
+      0.3);
+  arma::mat data(sparseData);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; i++)
+    labels(i) = math::RandInt(0, numClasses);
+
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0.01, true);
+  SoftmaxRegressionFunction<arma::sp_mat> sparseSrf(sparseData, labels,
+      numClasses, 0.01, true);
+  const arma::mat parameters = srf.GetInitialPoint();
+  const double objective = srf.Evaluate(parameters);
+  arma::mat gradient;
+  srf.Gradient(parameters, gradient);
+
+  srf.Shuffle();
+  sparseSrf.Shuffle();
+
+  double batchObjective = 0.0, sparseBatchObjective = 0.0;
+  arma::mat batchGradient(arma::size(parameters), arma::fill::zeros);
+  arma::mat sparseBatchGradient(arma::size(parameters), arma::fill::zeros);
+  for (size_t i = 0; i < points; i += batchSize)
+  {
+    batchObjective += srf.Evaluate(parameters, i, batchSize);
+    sparseBatchObjective += sparseSrf.Evaluate(parameters, i, batchSize);
+
+    arma::mat g;
+    srf.Gradient(parameters, i, g, batchSize);
+    batchGradient += g;
+    sparseSrf.Gradient(parameters, i, g, batchSize);
+    sparseBatchGradient += g;
+  }
+
+  const size_t batches = points / batchSize;
+  BOOST_REQUIRE_CLOSE(batchObjective / batches, objective, 1e-5);
+  BOOST_REQUIRE_CLOSE(sparseBatchObjective / batches, objective, 1e-5);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(batchGradient[i] / batches, gradient[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(sparseBatchGradient[i] / batches, gradient[i], 1e-5);
+  }
+}
+
+/**
+ * Make sure that EvaluateWithGradient() matches Evaluate() and Gradient(), and
+ * that the objective, which is computed over several blocks of points, matches
+ * a direct computation.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionEvaluateWithGradientTest)
+{
+  const size_t points = 2500;
+  const size_t inputSize = 5;
+  const size_t numClasses = 3;
+
+  arma::mat data(inputSize, points, arma::fill::randu);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; i++)
+    labels(i) = math::RandInt(0, numClasses);
+
+  SoftmaxRegressionFunction<> srf(data, labels, numClasses, 0.01, true);
+  const arma::mat parameters(numClasses, inputSize + 1, arma::fill::randn);
+
+  // Compute the objective directly.
+  arma::mat hypothesis = arma::exp(parameters.cols(1, inputSize) * data);
+  hypothesis.each_col() %= arma::exp(parameters.col(0));
+  double logLikelihood = 0.0;
+  for (size_t i = 0; i < points; ++i)
+  {
+    logLikelihood += std::log(hypothesis(labels[i], i) /
+        arma::accu(hypothesis.col(i)));
+  }
+  const double objective = -logLikelihood / points +
+      0.5 * 0.01 * arma::accu(parameters % parameters);
+
+  arma::mat gradient, gradient2, batchGradient, batchGradient2;
+  srf.Gradient(parameters, gradient);
+  const double objective2 = srf.EvaluateWithGradient(parameters, gradient2);
+  srf.Gradient(parameters, 100, batchGradient, 2000);
+  const double batchObjective = srf.EvaluateWithGradient(parameters, 100,
+      batchGradient2, 2000);
+
+  BOOST_REQUIRE_CLOSE(srf.Evaluate(parameters), objective, 1e-5);
+  BOOST_REQUIRE_CLOSE(objective2, objective, 1e-5);
+  BOOST_REQUIRE_CLOSE(batchObjective, srf.Evaluate(parameters, 100, 2000),
+      1e-5);
+  for (size_t i = 0; i < gradient.n_elem; ++i)
+  {
+    BOOST_REQUIRE_CLOSE(gradient2[i], gradient[i], 1e-5);
+    BOOST_REQUIRE_CLOSE(batchGradient2[i], batchGradient[i], 1e-5);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(SoftmaxRegressionTwoClasses)
 {
   const size_t points = 1000;
@@ -668,4 +772,147 @@ BOOST_AUTO_TEST_CASE(SoftmaxRegressionComputeProbabilitiesAndLabelsTest)
   }
 }
 
+/**
+ * Make sure that the objective and gradient on sparse and single-precision data
+ * match those on the equivalent dense data.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFunctionSparseAndFloatTest)
+{
+  const size_t points = 500;
+  const size_t inputSize = 50;
+  const size_t numClasses = 4;
+
+  arma::sp_mat sparseData;
+  sparseData.sprandu(inputSize, points, 0.1);
+  const arma::mat denseData(sparseData);
+  const arma::fmat floatData = arma::conv_to<arma::fmat>::from(denseData);
+
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; i++)
+    labels(i) = math::RandInt(0, numClasses);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    SoftmaxRegressionFunction<> dense(denseData, labels, numClasses, 0.1,
+        (intercept == 1));
+    SoftmaxRegressionFunction<arma::sp_mat> sparse(sparseData, labels,
+        numClasses, 0.1, (intercept == 1));
+    SoftmaxRegressionFunction<arma::fmat> single(floatData, labels,
+        numClasses, 0.1, (intercept == 1));
+
+    arma::mat parameters;
+    parameters.randu(numClasses, inputSize + intercept);
+
+    BOOST_REQUIRE_CLOSE(sparse.Evaluate(parameters),
+        dense.Evaluate(parameters), 1e-5);
+    BOOST_REQUIRE_CLOSE(single.Evaluate(parameters),
+        dense.Evaluate(parameters), 1e-3);
+    BOOST_REQUIRE_CLOSE(sparse.Evaluate(parameters, 100, 50),
+        dense.Evaluate(parameters, 100, 50), 1e-5);
+
+    arma::mat denseGradient, sparseGradient, floatGradient;
+    dense.Gradient(parameters, denseGradient);
+    sparse.Gradient(parameters, sparseGradient);
+    single.Gradient(parameters, floatGradient);
+
+    BOOST_REQUIRE_EQUAL(sparseGradient.n_rows, denseGradient.n_rows);
+    BOOST_REQUIRE_EQUAL(sparseGradient.n_cols, denseGradient.n_cols);
+    BOOST_REQUIRE_EQUAL(floatGradient.n_rows, denseGradient.n_rows);
+    BOOST_REQUIRE_EQUAL(floatGradient.n_cols, denseGradient.n_cols);
+    for (size_t i = 0; i < denseGradient.n_elem; ++i)
+    {
+      BOOST_REQUIRE_CLOSE(sparseGradient[i], denseGradient[i], 1e-5);
+      BOOST_REQUIRE_CLOSE(floatGradient[i], denseGradient[i], 1e-2);
+    }
+
+    dense.Gradient(parameters, 100, denseGradient, 50);
+    sparse.Gradient(parameters, 100, sparseGradient, 50);
+    for (size_t i = 0; i < denseGradient.n_elem; ++i)
+      BOOST_REQUIRE_CLOSE(sparseGradient[i], denseGradient[i], 1e-5);
+  }
+}
+
+/**
+ * Train the same model on sparse and dense versions of the same data, and make
+ * sure the models are the same.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionSparseTrainTest)
+{
+  const size_t points = 1000;
+  const size_t inputSize = 100;
+
+  // Each class has its own block of nonzero dimensions.
+  arma::sp_mat sparseData(inputSize, points);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = i % 2;
+    for (size_t j = 0; j < 5; ++j)
+    {
+      const size_t dim = math::RandInt(0, inputSize / 2) +
+          labels[i] * (inputSize / 2);
+      sparseData(dim, i) = math::Random();
+    }
+  }
+  const arma::mat denseData(sparseData);
+
+  SoftmaxRegression sr(inputSize, 2, true);
+  SoftmaxRegression sparseSr(inputSize, 2, true);
+  sparseSr.Parameters() = sr.Parameters();
+
+  sr.Train(denseData, labels, 2);
+  sparseSr.Train(sparseData, labels, 2);
+
+  BOOST_REQUIRE_EQUAL(sr.Parameters().n_rows, sparseSr.Parameters().n_rows);
+  BOOST_REQUIRE_EQUAL(sr.Parameters().n_cols, sparseSr.Parameters().n_cols);
+  for (size_t i = 0; i < sr.Parameters().n_elem; ++i)
+  {
+    if (std::abs(sr.Parameters()[i]) < 1e-4)
+      BOOST_REQUIRE_SMALL(sparseSr.Parameters()[i], 1e-4);
+    else
+      BOOST_REQUIRE_CLOSE(sr.Parameters()[i], sparseSr.Parameters()[i], 1e-3);
+  }
+
+  // The classes are separable, and sparse and dense points should get the same
+  // predictions.
+  arma::Row<size_t> predictions, sparsePredictions;
+  sr.Classify(denseData, predictions);
+  sparseSr.Classify(sparseData, sparsePredictions);
+  for (size_t i = 0; i < points; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], sparsePredictions[i]);
+  BOOST_REQUIRE_GT(sparseSr.ComputeAccuracy(sparseData, labels), 99.0);
+}
+
+/**
+ * Make sure a model can be trained on single-precision data.
+ */
+BOOST_AUTO_TEST_CASE(SoftmaxRegressionFloatTrainTest)
+{
+  const size_t points = 1000;
+  const size_t inputSize = 3;
+
+  GaussianDistribution g1(arma::vec("1.0 9.0 1.0"), arma::eye<arma::mat>(3, 3));
+  GaussianDistribution g2(arma::vec("4.0 3.0 4.0"), arma::eye<arma::mat>(3, 3));
+
+  arma::mat data(inputSize, points);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points / 2; ++i)
+  {
+    data.col(i) = g1.Random();
+    labels(i) = 0;
+  }
+  for (size_t i = points / 2; i < points; ++i)
+  {
+    data.col(i) = g2.Random();
+    labels(i) = 1;
+  }
+  const arma::fmat floatData = arma::conv_to<arma::fmat>::from(data);
+
+  SoftmaxRegression sr(floatData, labels, 2, 0.001, true);
+
+  // The model holds double parameters, but can classify float and double data.
+  BOOST_REQUIRE_GT(sr.ComputeAccuracy(floatData, labels), 99.0);
+  BOOST_REQUIRE_GT(sr.ComputeAccuracy(data, labels), 99.0);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -38,7 +38,7 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionEvaluate)
 
   // Create a SparseAutoencoderFunction. Regularization and KL divergence terms
   // ignored.
-  SparseAutoencoderFunction saf1(data1, vSize, hSize, 0, 0);
+  SparseAutoencoderFunction<> saf1(data1, vSize, hSize, 0, 0);
 
   // Test using first dataset. Values were calculated using Octave.
   BOOST_REQUIRE_CLOSE(saf1.Evaluate(arma::ones(r, c)), 1.190472606540, 1e-5);
@@ -47,7 +47,7 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionEvaluate)
 
   // Create a SparseAutoencoderFunction. Regularization and KL divergence terms
   // ignored.
-  SparseAutoencoderFunction saf2(data2, vSize, hSize, 0, 0);
+  SparseAutoencoderFunction<> saf2(data2, vSize, hSize, 0, 0);
 
   // Test using second dataset. Values were calculated using Octave.
   BOOST_REQUIRE_CLOSE(saf2.Evaluate(arma::ones(r, c)), 1.197585812647, 1e-5);
@@ -71,7 +71,7 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionRandomEvaluate)
 
   // Create a SparseAutoencoderFunction. Regularization and KL divergence terms
   // ignored.
-  SparseAutoencoderFunction saf(data, vSize, hSize, 0, 0);
+  SparseAutoencoderFunction<> saf(data, vSize, hSize, 0, 0);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -118,9 +118,9 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionRegularizationEvaluate)
   data.randu(vSize, points);
 
   // 3 objects for comparing regularization costs.
-  SparseAutoencoderFunction safNoReg(data, vSize, hSize, 0, 0);
-  SparseAutoencoderFunction safSmallReg(data, vSize, hSize, 0.5, 0);
-  SparseAutoencoderFunction safBigReg(data, vSize, hSize, 20, 0);
+  SparseAutoencoderFunction<> safNoReg(data, vSize, hSize, 0, 0);
+  SparseAutoencoderFunction<> safSmallReg(data, vSize, hSize, 0.5, 0);
+  SparseAutoencoderFunction<> safBigReg(data, vSize, hSize, 20, 0);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -162,9 +162,9 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionKLDivergenceEvaluate)
   data.randu(vSize, points);
 
   // 3 objects for comparing divergence costs.
-  SparseAutoencoderFunction safNoDiv(data, vSize, hSize, 0, 0, rho);
-  SparseAutoencoderFunction safSmallDiv(data, vSize, hSize, 0, 5, rho);
-  SparseAutoencoderFunction safBigDiv(data, vSize, hSize, 0, 20, rho);
+  SparseAutoencoderFunction<> safNoDiv(data, vSize, hSize, 0, 0, rho);
+  SparseAutoencoderFunction<> safSmallDiv(data, vSize, hSize, 0, 5, rho);
+  SparseAutoencoderFunction<> safBigDiv(data, vSize, hSize, 0, 20, rho);
 
   // Run a number of trials.
   for (size_t i = 0; i < trials; i++)
@@ -215,9 +215,9 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionGradient)
 
   // 3 objects for 3 terms in the cost function. Each term contributes towards
   // the gradient and thus need to be checked independently.
-  SparseAutoencoderFunction saf1(data, vSize, hSize, 0, 0);
-  SparseAutoencoderFunction saf2(data, vSize, hSize, 20, 0);
-  SparseAutoencoderFunction saf3(data, vSize, hSize, 20, 20);
+  SparseAutoencoderFunction<> saf1(data, vSize, hSize, 0, 0);
+  SparseAutoencoderFunction<> saf2(data, vSize, hSize, 20, 0);
+  SparseAutoencoderFunction<> saf3(data, vSize, hSize, 20, 20);
 
   // Create a random set of parameters.
   arma::mat parameters;
@@ -268,4 +268,52 @@ BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionGradient)
   }
 }
 
+/**
+ * Make sure that the objective function and its gradient are the same for
+ * sparse data and for the same data stored densely.
+ */
+BOOST_AUTO_TEST_CASE(SparseAutoencoderFunctionSparseData)
+{
+  const size_t points = 500;
+  const size_t vSize = 60;
+  const size_t hSize = 10;
+
+  arma::sp_mat sparseData;
+  sparseData.sprandu(vSize, points, 0.05);
+  const arma::mat denseData(sparseData);
+
+  SparseAutoencoderFunction<> denseFunction(denseData, vSize, hSize, 0.5, 3);
+  SparseAutoencoderFunction<arma::sp_mat> sparseFunction(sparseData, vSize,
+      hSize, 0.5, 3);
+
+  const arma::mat parameters = denseFunction.GetInitialPoint();
+
+  BOOST_REQUIRE_CLOSE(sparseFunction.Evaluate(parameters),
+      denseFunction.Evaluate(parameters), 1e-8);
+
+  arma::mat denseGradient, sparseGradient;
+  denseFunction.Gradient(parameters, denseGradient);
+  const double objective = sparseFunction.EvaluateWithGradient(parameters,
+      sparseGradient);
+
+  BOOST_REQUIRE_CLOSE(objective, denseFunction.Evaluate(parameters), 1e-8);
+  BOOST_REQUIRE_EQUAL(sparseGradient.n_rows, denseGradient.n_rows);
+  BOOST_REQUIRE_EQUAL(sparseGradient.n_cols, denseGradient.n_cols);
+  for (size_t i = 0; i < denseGradient.n_elem; ++i)
+  {
+    if (std::abs(denseGradient[i]) < 1e-10)
+      BOOST_REQUIRE_SMALL(sparseGradient[i], 1e-10);
+    else
+      BOOST_REQUIRE_CLOSE(sparseGradient[i], denseGradient[i], 1e-6);
+  }
+
+  // The features of the trained model are the same too.
+  SparseAutoencoder encoder(sparseData, vSize, hSize, 0.5, 3, 0.01,
+      ens::L_BFGS(5, 10));
+  arma::mat sparseFeatures, denseFeatures;
+  encoder.GetNewFeatures(sparseData, sparseFeatures);
+  encoder.GetNewFeatures(denseData, denseFeatures);
+  CheckMatrices(sparseFeatures, denseFeatures, 1e-5);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,262 @@
+/**
+ * @file sparse_svm_test.cpp
+ *
+ * Tests for the SparseSVMFunction and SparseSVM classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/sparse_svm/sparse_svm.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+using namespace mlpack::svm;
+
+BOOST_AUTO_TEST_SUITE(SparseSVMTest);
+
+/**
+ * Generate sparse points of three classes.  The points of class c have most of
+ * their nonzero elements in the features [10c, 10c + 10), and a few nonzero
+ * elements in the shared features [30, 50).
+ */
+void GenerateSparseData(const size_t points,
+                        arma::sp_mat& data,
+                        arma::Row<size_t>& labels)
+{
+  arma::mat dense(50, points, arma::fill::zeros);
+  labels.set_size(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    labels[i] = i % 3;
+    for (size_t j = 0; j < 4; ++j)
+      dense(10 * labels[i] + math::RandInt(10), i) = 1.0 + math::Random();
+    dense(30 + math::RandInt(20), i) = math::Random();
+  }
+
+  data = arma::sp_mat(dense);
+}
+
+/**
+ * Compute the objective function naively, for comparison.
+ */
+double NaiveObjective(const arma::mat& parameters,
+                      const arma::mat& data,
+                      const arma::Row<size_t>& labels,
+                      const double lambda,
+                      const double delta,
+                      const bool fitIntercept)
+{
+  arma::mat scores;
+  if (fitIntercept)
+  {
+    scores = parameters * arma::join_cols(arma::ones<arma::rowvec>(
+        data.n_cols), data);
+  }
+  else
+  {
+    scores = parameters * data;
+  }
+
+  double loss = 0.0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    for (size_t j = 0; j < parameters.n_rows; ++j)
+    {
+      if (j != labels[i])
+        loss += std::max(0.0, scores(j, i) - scores(labels[i], i) + delta);
+    }
+  }
+
+  const arma::mat weights = fitIntercept ?
+      arma::mat(parameters.cols(1, parameters.n_cols - 1)) : parameters;
+  return loss + 0.5 * lambda * arma::accu(arma::square(weights));
+}
+
+/**
+ * Make sure the objective function matches a naive computation, with and
+ * without an intercept, and that the separable objectives add up to it.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMFunctionEvaluate)
+{
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+  GenerateSparseData(500, data, labels);
+
+  for (size_t intercept = 0; intercept < 2; ++intercept)
+  {
+    SparseSVMFunction f(data, labels, 3, 0.01, 1.0, intercept == 1);
+    const arma::mat parameters = arma::randn<arma::mat>(
+        arma::size(f.InitialPoint()));
+
+    const double objective = f.Evaluate(parameters);
+    BOOST_REQUIRE_CLOSE(objective, NaiveObjective(parameters,
+        arma::mat(data), labels, 0.01, 1.0, intercept == 1), 1e-5);
+
+    double sum = 0.0;
+    for (size_t i = 0; i < data.n_cols; i += 50)
+      sum += f.Evaluate(parameters, i, 50);
+    BOOST_REQUIRE_CLOSE(sum, objective, 1e-5);
+  }
+}
+
+/**
+ * Check the gradient against a finite-difference approximation.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMFunctionGradient)
+{
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+  GenerateSparseData(300, data, labels);
+
+  SparseSVMFunction f(data, labels, 3, 0.01, 1.0, true);
+  arma::mat parameters = arma::randn<arma::mat>(arma::size(f.InitialPoint()));
+
+  arma::mat gradient;
+  const double objective = f.EvaluateWithGradient(parameters, gradient);
+  BOOST_REQUIRE_CLOSE(objective, f.Evaluate(parameters), 1e-5);
+
+  arma::mat approxGradient(arma::size(parameters));
+  const double eps = 1e-6;
+  for (size_t i = 0; i < parameters.n_elem; ++i)
+  {
+    const double original = parameters[i];
+    parameters[i] = original + eps;
+    const double upper = f.Evaluate(parameters);
+    parameters[i] = original - eps;
+    const double lower = f.Evaluate(parameters);
+    parameters[i] = original;
+
+    approxGradient[i] = (upper - lower) / (2 * eps);
+  }
+
+  CheckMatrices(gradient, approxGradient, 1e-3);
+}
+
+/**
+ * Make sure that the sparse separable gradient matches the dense separable
+ * gradient when there is no regularization.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMFunctionSparseGradient)
+{
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+  GenerateSparseData(200, data, labels);
+
+  SparseSVMFunction f(data, labels, 3, 0.0, 1.0, true);
+  const arma::mat parameters = arma::randn<arma::mat>(
+      arma::size(f.InitialPoint()));
+
+  for (size_t i = 0; i < data.n_cols; i += 20)
+  {
+    arma::mat gradient;
+    arma::sp_mat sparseGradient;
+    f.Gradient(parameters, i, gradient, 20);
+    f.Gradient(parameters, i, sparseGradient, 20);
+
+    CheckMatrices(arma::mat(sparseGradient), gradient);
+  }
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that the objective and gradient are the same with one thread and
+ * with many threads.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMFunctionParallelGradient)
+{
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+  GenerateSparseData(3000, data, labels);
+
+  SparseSVMFunction f(data, labels, 3, 0.01, 1.0, true);
+  const arma::mat parameters = arma::randn<arma::mat>(
+      arma::size(f.InitialPoint()));
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  omp_set_num_threads(1);
+  arma::mat serialGradient;
+  const double serialObjective = f.EvaluateWithGradient(parameters,
+      serialGradient);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+  arma::mat gradient;
+  const double objective = f.EvaluateWithGradient(parameters, gradient);
+
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_CLOSE(objective, serialObjective, 1e-5);
+  CheckMatrices(gradient, serialGradient);
+}
+
+#endif
+
+/**
+ * Train the SVM with L-BFGS on separable data, and make sure it classifies new
+ * points well, whether they are given as sparse or dense matrices.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMTrainLBFGS)
+{
+  arma::sp_mat data, testData;
+  arma::Row<size_t> labels, testLabels;
+  GenerateSparseData(600, data, labels);
+  GenerateSparseData(300, testData, testLabels);
+
+  SparseSVM svm(data, labels, 3, 0.0001, 1.0, true);
+
+  BOOST_REQUIRE_EQUAL(svm.Parameters().n_rows, 3);
+  BOOST_REQUIRE_EQUAL(svm.Parameters().n_cols, 51);
+  BOOST_REQUIRE_EQUAL(svm.FeatureSize(), 50);
+
+  BOOST_REQUIRE_GE(svm.ComputeAccuracy(testData, testLabels), 95.0);
+
+  arma::Row<size_t> predictions, densePredictions;
+  svm.Classify(testData, predictions);
+  svm.Classify(arma::mat(testData), densePredictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(predictions[i], densePredictions[i]);
+
+  BOOST_REQUIRE_EQUAL(svm.Classify(arma::vec(testData.col(0))),
+      predictions[0]);
+}
+
+/**
+ * Train the SVM with parallel SGD (Hogwild!) on separable data.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMTrainParallelSGD)
+{
+  arma::sp_mat data, testData;
+  arma::Row<size_t> labels, testLabels;
+  GenerateSparseData(600, data, labels);
+  GenerateSparseData(300, testData, testLabels);
+
+  SparseSVM svm(data.n_rows, 3, 0.0001);
+  ens::ParallelSGD<ens::ConstantStep> optimizer(10 * data.n_cols,
+      std::ceil((double) data.n_cols / NumThreads()), 1e-10, true,
+      ens::ConstantStep(0.01));
+  svm.Train(data, labels, 3, optimizer);
+
+  BOOST_REQUIRE_GE(svm.ComputeAccuracy(testData, testLabels), 95.0);
+}
+
+/**
+ * Make sure that labels outside of the range of classes are rejected.
+ */
+BOOST_AUTO_TEST_CASE(SparseSVMInvalidLabels)
+{
+  arma::sp_mat data;
+  arma::Row<size_t> labels;
+  GenerateSparseData(30, data, labels);
+
+  BOOST_REQUIRE_THROW(SparseSVMFunction(data, labels, 2),
+      std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -308,4 +308,89 @@ BOOST_AUTO_TEST_CASE(SpillTreeMoveDatasetTest)
   BOOST_REQUIRE_EQUAL(tree.Dataset().n_cols, 1000);
 }
 
+/**
+ * Check that two spill trees have the same structure and hold the same points.
+ */
+template<typename TreeType>
+void CheckSameSpillTree(TreeType& a, TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.NumDescendants(), b.NumDescendants());
+  BOOST_REQUIRE_EQUAL(a.NumPoints(), b.NumPoints());
+  BOOST_REQUIRE_EQUAL(a.Overlap(), b.Overlap());
+  BOOST_REQUIRE_EQUAL(a.IsLeaf(), b.IsLeaf());
+  BOOST_REQUIRE_CLOSE(a.FurthestDescendantDistance(),
+      b.FurthestDescendantDistance(), 1e-5);
+
+  for (size_t i = 0; i < a.NumPoints(); ++i)
+    BOOST_REQUIRE_EQUAL(a.Point(i), b.Point(i));
+
+  if (!a.IsLeaf())
+  {
+    CheckSameSpillTree(*a.Left(), *b.Left());
+    CheckSameSpillTree(*a.Right(), *b.Right());
+  }
+}
+
+/**
+ * Create a spill tree large enough that its children are built in parallel,
+ * and make sure it's the same as when it is built on one thread, and that its
+ * copies are too.
+ */
+BOOST_AUTO_TEST_CASE(SpillTreeParallelConstructionTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 30000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType tree(dataset, 0.02);
+
+  const size_t numThreads = NumThreads();
+  SetNumThreads(1);
+  TreeType serialTree(dataset, 0.02);
+  SetNumThreads(numThreads);
+
+  CheckSameSpillTree(tree, serialTree);
+
+  // Every point must be in some leaf.
+  arma::Col<size_t> counts(dataset.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < tree.NumDescendants(); ++i)
+    ++counts[tree.Descendant(i)];
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_GE(counts[i], 1);
+
+  TreeType copy(tree);
+  CheckSameSpillTree(tree, copy);
+
+  TreeType moved(std::move(copy));
+  CheckSameSpillTree(tree, moved);
+}
+
+/**
+ * Build a tree on some of the points of a dataset, and make sure it holds
+ * exactly those points.
+ */
+BOOST_AUTO_TEST_CASE(SpillTreePointsConstructorTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  typedef SPTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  arma::Col<size_t> points(400);
+  for (size_t i = 0; i < points.n_elem; ++i)
+    points[i] = 300 + i;
+
+  // When overlapping buffer is 0, there shouldn't be repeated points.
+  TreeType tree(dataset, points);
+  BOOST_REQUIRE_EQUAL(tree.NumDescendants(), 400);
+  BOOST_REQUIRE_EQUAL(&tree.Dataset(), &dataset);
+
+  arma::Col<size_t> counts(dataset.n_cols, arma::fill::zeros);
+  for (size_t i = 0; i < tree.NumDescendants(); ++i)
+    ++counts[tree.Descendant(i)];
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], (i >= 300 && i < 700) ? 1 : 0);
+
+  // The bound of the root must contain those points.
+  for (size_t i = 300; i < 700; ++i)
+    BOOST_REQUIRE(tree.Bound().Contains(dataset.col(i)));
+}
+
 BOOST_AUTO_TEST_SUITE_END();
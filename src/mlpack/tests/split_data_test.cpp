@@ -170,4 +170,49 @@ BOOST_AUTO_TEST_CASE(SplitLabeledDataLargerTest)
   CheckDuplication(std::get<2>(value), std::get<3>(value));
 }
 
+/**
+ * Check that SplitInPlace() gives the same split as Split() with the same
+ * seed, without copying the points.
+ */
+BOOST_AUTO_TEST_CASE(SplitLabeledDataInPlaceTest)
+{
+  mat input(10, 497);
+  input.randu();
+  const mat original(input);
+
+  // Set the labels to the column ID.
+  Row<size_t> labels = arma::linspace<Row<size_t>>(0, input.n_cols - 1,
+      input.n_cols);
+
+  math::RandomSeed(42);
+  const auto value = Split(input, labels, 0.3);
+
+  mat trainData, testData;
+  Row<size_t> trainLabels, testLabels;
+  math::RandomSeed(42);
+  SplitInPlace(input, labels, trainData, testData, trainLabels, testLabels,
+      0.3);
+
+  BOOST_REQUIRE_EQUAL(trainData.n_cols, 497 - size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(testData.n_cols, size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(trainLabels.n_cols, 497 - size_t(0.3 * 497));
+  BOOST_REQUIRE_EQUAL(testLabels.n_cols, size_t(0.3 * 497));
+
+  // The outputs are aliases of the shuffled input.
+  BOOST_REQUIRE_EQUAL(trainData.memptr(), input.memptr());
+  BOOST_REQUIRE_EQUAL(testData.memptr(), input.colptr(trainData.n_cols));
+  BOOST_REQUIRE_EQUAL(trainLabels.memptr(), labels.memptr());
+
+  CompareData(original, trainData, trainLabels);
+  CompareData(original, testData, testLabels);
+  CheckDuplication(trainLabels, testLabels);
+
+  CheckMatrices(trainData, std::get<0>(value));
+  CheckMatrices(testData, std::get<1>(value));
+  for (size_t i = 0; i < trainLabels.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(trainLabels[i], std::get<2>(value)[i]);
+  for (size_t i = 0; i < testLabels.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(testLabels[i], std::get<3>(value)[i]);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
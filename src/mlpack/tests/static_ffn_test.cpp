@@ -0,0 +1,211 @@
+/**
+ * @file static_ffn_test.cpp
+ *
+ * Tests the StaticFFN class, a feed forward network whose layers are fixed at
+ * compile time.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#include <mlpack/methods/ann/layer/layer.hpp>
+#include <mlpack/methods/ann/loss_functions/mean_squared_error.hpp>
+#include <mlpack/methods/ann/ffn.hpp>
+#include <mlpack/methods/ann/static_ffn.hpp>
+
+#include <ensmallen.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::ann;
+
+BOOST_AUTO_TEST_SUITE(StaticFFNTest);
+
+//! The statically composed network used by the tests.
+template<typename OutputLayerType = NegativeLogLikelihood<> >
+using StaticNetwork = StaticFFN<OutputLayerType, RandomInitialization,
+    Linear<>, SigmoidLayer<>, Linear<>, LogSoftMax<> >;
+
+//! Create the statically composed network with the given sizes.
+template<typename OutputLayerType = NegativeLogLikelihood<> >
+StaticNetwork<OutputLayerType> BuildStaticNetwork(const size_t inputSize,
+                                                  const size_t hiddenSize,
+                                                  const size_t outputSize)
+{
+  return StaticNetwork<OutputLayerType>(Linear<>(inputSize, hiddenSize),
+      SigmoidLayer<>(), Linear<>(hiddenSize, outputSize), LogSoftMax<>());
+}
+
+/**
+ * Make sure that the objective, the gradient and the predictions of a
+ * StaticFFN are the same as those of an FFN with the same layers and
+ * parameters.
+ */
+template<typename OutputLayerType>
+void CheckStaticNetwork(const arma::mat& data, const arma::mat& responses)
+{
+  FFN<OutputLayerType> model;
+  model.Add<Linear<> >(data.n_rows, 7);
+  model.Add<SigmoidLayer<> >();
+  model.Add<Linear<> >(7, 3);
+  model.Add<LogSoftMax<> >();
+
+  model.Predictors() = data;
+  model.Responses() = responses;
+  model.ResetParameters();
+
+  StaticNetwork<OutputLayerType> staticModel =
+      BuildStaticNetwork<OutputLayerType>(data.n_rows, 7, 3);
+  staticModel.Predictors() = data;
+  staticModel.Responses() = responses;
+  staticModel.ResetParameters();
+
+  // The layers use the memory of the parameters, so they have to be copied
+  // element-wise.
+  BOOST_REQUIRE_EQUAL(staticModel.Parameters().n_elem,
+      model.Parameters().n_elem);
+  for (size_t i = 0; i < model.Parameters().n_elem; ++i)
+    staticModel.Parameters()[i] = model.Parameters()[i];
+
+  // A batch that doesn't start at the first point.
+  arma::mat gradient, staticGradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 2,
+      gradient, 5);
+  const double staticObjective = staticModel.EvaluateWithGradient(
+      staticModel.Parameters(), 2, staticGradient, 5);
+  BOOST_REQUIRE_CLOSE(staticObjective, objective, 1e-5);
+  CheckMatrices(staticGradient, gradient, 1e-5);
+
+  // The whole dataset.
+  BOOST_REQUIRE_CLOSE(staticModel.Evaluate(staticModel.Parameters(), 0,
+      data.n_cols), model.Evaluate(model.Parameters(), 0, data.n_cols), 1e-5);
+
+  arma::mat prediction, staticPrediction;
+  model.Predict(data, prediction, 5);
+  staticModel.Predict(data, staticPrediction, 5);
+  CheckMatrices(staticPrediction, prediction, 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(StaticFFNGradientTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 12);
+  arma::mat labels(1, 12);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = math::RandInt(1, 4);
+
+  CheckStaticNetwork<NegativeLogLikelihood<> >(data, labels);
+
+  arma::mat responses = arma::randu<arma::mat>(3, 12);
+  CheckStaticNetwork<MeanSquaredError<> >(data, responses);
+}
+
+/**
+ * Train the statically composed vanilla network on the thyroid dataset.
+ */
+BOOST_AUTO_TEST_CASE(StaticFFNVanillaNetworkTest)
+{
+  arma::mat trainData;
+  data::Load("thyroid_train.csv", trainData, true);
+
+  arma::mat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+
+  arma::mat testData;
+  data::Load("thyroid_test.csv", testData, true);
+
+  arma::mat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+
+  StaticNetwork<> model = BuildStaticNetwork<>(trainData.n_rows, 8, 3);
+
+  ens::RMSProp opt(0.01, 32, 0.88, 1e-8, 10 * trainData.n_cols, -1);
+  model.Train(trainData, trainLabels, opt);
+
+  arma::mat predictionTemp;
+  model.Predict(testData, predictionTemp);
+
+  size_t correct = 0;
+  for (size_t i = 0; i < predictionTemp.n_cols; ++i)
+  {
+    arma::uword prediction;
+    predictionTemp.col(i).max(prediction);
+    if (prediction + 1 == size_t(testLabels(i)))
+      ++correct;
+  }
+
+  // Because 92 percent of the patients are not hyperthyroid the neural
+  // network must be significant better than 92%.
+  const double classificationError = 1 - double(correct) / testData.n_cols;
+  BOOST_REQUIRE_LE(classificationError, 0.1);
+}
+
+/**
+ * Make sure that a copy of a network uses its own parameters.
+ */
+BOOST_AUTO_TEST_CASE(StaticFFNCopyTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 10);
+
+  StaticNetwork<> model = BuildStaticNetwork<>(data.n_rows, 4, 3);
+  model.ResetParameters();
+
+  arma::mat prediction;
+  model.Predict(data, prediction);
+
+  StaticNetwork<> copy(model);
+  arma::mat copyPrediction;
+  copy.Predict(data, copyPrediction);
+  CheckMatrices(copyPrediction, prediction);
+
+  // Changing the parameters of the copy must not change the original network.
+  copy.Parameters().zeros();
+  arma::mat newPrediction;
+  model.Predict(data, newPrediction);
+  CheckMatrices(newPrediction, prediction);
+
+  copy.Predict(data, copyPrediction);
+  BOOST_REQUIRE_GT(arma::abs(copyPrediction - prediction).max(), 1e-5);
+
+  // The same for a moved network.
+  StaticNetwork<> moved(std::move(copy));
+  arma::mat movedPrediction;
+  moved.Predict(data, movedPrediction);
+  CheckMatrices(movedPrediction, copyPrediction);
+}
+
+/**
+ * Serialize a network and make sure that the predictions don't change.
+ */
+BOOST_AUTO_TEST_CASE(StaticFFNSerializationTest)
+{
+  arma::mat data = arma::randu<arma::mat>(5, 10);
+
+  StaticNetwork<> model = BuildStaticNetwork<>(data.n_rows, 4, 3);
+  StaticNetwork<> xmlModel = BuildStaticNetwork<>(data.n_rows, 4, 3);
+  StaticNetwork<> textModel = BuildStaticNetwork<>(data.n_rows, 4, 3);
+  StaticNetwork<> binaryModel = BuildStaticNetwork<>(data.n_rows, 4, 3);
+  model.ResetParameters();
+  xmlModel.ResetParameters();
+  textModel.ResetParameters();
+  binaryModel.ResetParameters();
+
+  SerializeObjectAll(model, xmlModel, textModel, binaryModel);
+
+  arma::mat prediction, xmlPrediction, textPrediction, binaryPrediction;
+  model.Predict(data, prediction);
+  xmlModel.Predict(data, xmlPrediction);
+  textModel.Predict(data, textPrediction);
+  binaryModel.Predict(data, binaryPrediction);
+
+  CheckMatrices(prediction, xmlPrediction);
+  CheckMatrices(prediction, textPrediction);
+  CheckMatrices(prediction, binaryPrediction);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,149 @@
+/**
+ * @file streaming_svd_test.cpp
+ *
+ * Test file for the StreamingSVD class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/streaming_svd/streaming_svd.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+BOOST_AUTO_TEST_SUITE(StreamingSVDTest);
+
+using namespace mlpack;
+
+/**
+ * Create a random matrix of the given rank, with the given singular values.
+ */
+static arma::mat CreateLowRankMatrix(const size_t rows,
+                                     const size_t cols,
+                                     const arma::vec& s)
+{
+  arma::mat U, V, R;
+  arma::qr_econ(U, R, arma::randn<arma::mat>(rows, s.n_elem));
+  arma::qr_econ(V, R, arma::randn<arma::mat>(cols, s.n_elem));
+
+  return U * arma::diagmat(s) * V.t();
+}
+
+/**
+ * The reconstruction and singular value error of the SVD of a low-rank matrix
+ * should be small.
+ */
+BOOST_AUTO_TEST_CASE(StreamingSVDReconstructionError)
+{
+  const arma::mat data = CreateLowRankMatrix(20, 100, arma::vec("1 0.1 0.01"));
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  arma::svd_econ(U1, s1, V1, data);
+
+  // Use small blocks, so that the data is processed in several blocks.
+  svd::StreamingSVD sSVD(5, 7);
+  sSVD.Apply(data, U2, s2, V2, 3);
+
+  BOOST_REQUIRE_EQUAL(s2.n_elem, 3);
+  BOOST_REQUIRE_EQUAL(U2.n_rows, 20);
+  BOOST_REQUIRE_EQUAL(U2.n_cols, 3);
+  BOOST_REQUIRE_EQUAL(V2.n_rows, 100);
+  BOOST_REQUIRE_EQUAL(V2.n_cols, 3);
+
+  // The singular value error should be small.
+  double error = arma::norm(s2 - s1.subvec(0, 2), "frob") /
+      arma::norm(s2, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+
+  const arma::mat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+
+  // The relative reconstruction error should be small.
+  error = arma::norm(data - reconstruct, "frob") / arma::norm(data, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+}
+
+/**
+ * Make sure that the centered factorization, computed in a single pass, is the
+ * factorization of the centered matrix.
+ */
+BOOST_AUTO_TEST_CASE(StreamingSVDCenteredTest)
+{
+  arma::mat centeredData = CreateLowRankMatrix(30, 200,
+      arma::vec("5 2 1 0.5"));
+  centeredData.each_col() -= arma::mean(centeredData, 1);
+
+  arma::mat data = centeredData;
+  data.each_col() += 10.0 * arma::randu<arma::vec>(30);
+
+  svd::StreamingSVD sSVD;
+  sSVD.Reset(data.n_rows, 4);
+
+  // Use blocks of different sizes.
+  sSVD.Update(data.cols(0, 9));
+  sSVD.Update(data.cols(10, 10));
+  sSVD.Update(data.cols(11, 149));
+  sSVD.Update(data.cols(150, 199));
+  BOOST_REQUIRE_EQUAL(sSVD.NumColumns(), 200);
+
+  arma::mat U, V;
+  arma::vec s;
+  sSVD.Factorize(U, s, V, true);
+
+  arma::mat U1, V1;
+  arma::vec s1;
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  for (size_t i = 0; i < 3; ++i)
+    BOOST_REQUIRE_CLOSE(s[i], s1[i], 1e-3);
+
+  const double error = arma::norm(centeredData - U * arma::diagmat(s) * V.t(),
+      "frob") / arma::norm(centeredData, "frob");
+  BOOST_REQUIRE_SMALL(error, 1e-5);
+}
+
+/**
+ * Check that the method approximates the leading singular values of a noisy
+ * low-rank matrix.
+ */
+BOOST_AUTO_TEST_CASE(StreamingSVDNoisyLowRankTest)
+{
+  const size_t rank = 5;
+  arma::mat data = CreateLowRankMatrix(200, 1000,
+      arma::vec("10 8 6 4 2"));
+  data += 0.01 * arma::randn<arma::mat>(200, 1000);
+
+  arma::mat U1, U2, V1, V2;
+  arma::vec s1, s2;
+
+  arma::svd_econ(U1, s1, V1, data);
+
+  svd::StreamingSVD sSVD(20, 100);
+  sSVD.Apply(data, U2, s2, V2, rank);
+
+  const double error = arma::max(arma::abs(s1.subvec(0, rank - 1) - s2) /
+      s1.subvec(0, rank - 1));
+  BOOST_REQUIRE_SMALL(error, 1e-2);
+}
+
+/**
+ * Make sure that invalid blocks are rejected.
+ */
+BOOST_AUTO_TEST_CASE(StreamingSVDInvalidBlockTest)
+{
+  svd::StreamingSVD sSVD;
+  sSVD.Reset(10, 3);
+
+  arma::mat U, V;
+  arma::vec s;
+  BOOST_REQUIRE_THROW(sSVD.Factorize(U, s, V), std::invalid_argument);
+  BOOST_REQUIRE_THROW(sSVD.Update(arma::randu<arma::mat>(9, 5)),
+      std::invalid_argument);
+  BOOST_REQUIRE_THROW(sSVD.Reset(10, 0), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
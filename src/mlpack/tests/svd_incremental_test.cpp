@@ -2,8 +2,8 @@
  * @file svd_incremental_test.cpp
  * @author Sumedh Ghaisas
  *
- * Tests for SVDIncompleteIncrementalLearning and
- * SVDCompleteIncrementalLearning.
+ * Tests for SVDIncompleteIncrementalLearning,
+ * SVDCompleteIncrementalLearning and SVDParallelIncrementalLearning.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -14,9 +14,11 @@
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/update_rules/svd_incomplete_incremental_learning.hpp>
 #include <mlpack/methods/amf/update_rules/svd_complete_incremental_learning.hpp>
+#include <mlpack/methods/amf/update_rules/svd_parallel_incremental_learning.hpp>
 #include <mlpack/methods/amf/init_rules/random_init.hpp>
 #include <mlpack/methods/amf/termination_policies/incomplete_incremental_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/complete_incremental_termination.hpp>
+#include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/simple_tolerance_termination.hpp>
 #include <mlpack/methods/amf/termination_policies/validation_rmse_termination.hpp>
 
@@ -146,4 +148,105 @@ BOOST_AUTO_TEST_CASE(SVDIncompleteIncrementalRegularizationTest)
   BOOST_REQUIRE_LT(regularizedRMSE, regularRMSE + 0.105);
 }
 
+/**
+ * With one thread, the parallel update rules must give the same result as the
+ * serial ones, once they have been through the same elements.
+ */
+BOOST_AUTO_TEST_CASE(SVDParallelIncrementalOneThreadTest)
+{
+  const size_t numThreads = NumThreads();
+  SetNumThreads(1);
+
+  sp_mat data;
+  data.sprandu(60, 50, 0.2);
+  SpecificRandomInitialization sri(data.n_rows, 3, data.n_cols);
+
+  // AMF updates one time less than the iteration limit, so this makes two
+  // passes over the data.
+  MaxIterationTermination serialCompleteTermination(2 * data.n_nonzero + 1);
+  AMF<MaxIterationTermination, SpecificRandomInitialization,
+      SVDCompleteIncrementalLearning<sp_mat>> serialComplete(
+      serialCompleteTermination, sri,
+      SVDCompleteIncrementalLearning<sp_mat>(0.01, 0.02, 0.02));
+  mat w1, h1;
+  serialComplete.Apply(data, 3, w1, h1);
+
+  AMF<MaxIterationTermination, SpecificRandomInitialization,
+      SVDParallelIncrementalLearning> parallelComplete(
+      MaxIterationTermination(3), sri,
+      SVDParallelIncrementalLearning(0.01, 0.02, 0.02, true));
+  mat w2, h2;
+  parallelComplete.Apply(data, 3, w2, h2);
+
+  BOOST_REQUIRE_EQUAL(parallelComplete.Update().Strata(), 1);
+  CheckMatrices(w1, w2, 1e-5);
+  CheckMatrices(h1, h2, 1e-5);
+
+  MaxIterationTermination serialIncompleteTermination(2 * data.n_cols + 1);
+  AMF<MaxIterationTermination, SpecificRandomInitialization,
+      SVDIncompleteIncrementalLearning> serialIncomplete(
+      serialIncompleteTermination, sri,
+      SVDIncompleteIncrementalLearning(0.01, 0.02, 0));
+  mat w3, h3;
+  serialIncomplete.Apply(data, 3, w3, h3);
+
+  AMF<MaxIterationTermination, SpecificRandomInitialization,
+      SVDParallelIncrementalLearning> parallelIncomplete(
+      MaxIterationTermination(3), sri,
+      SVDParallelIncrementalLearning(0.01, 0.02, 0, false));
+  mat w4, h4;
+  parallelIncomplete.Apply(data, 3, w4, h4);
+
+  CheckMatrices(w3, w4, 1e-5);
+  CheckMatrices(h3, h4, 1e-5);
+
+  SetNumThreads(numThreads);
+}
+
+/**
+ * Make sure that the parallel update rules reduce the training error with
+ * several threads.
+ */
+BOOST_AUTO_TEST_CASE(SVDParallelIncrementalConvergenceTest)
+{
+  const size_t numThreads = NumThreads();
+  SetNumThreads(4);
+
+  // Build a sparse matrix of low rank.
+  const mat w = randu<mat>(80, 2);
+  const mat h = randu<mat>(2, 70);
+  sp_mat data;
+  data.sprandu(80, 70, 0.3);
+  for (sp_mat::iterator it = data.begin(); it != data.end(); ++it)
+    *it = dot(w.row(it.row()), h.col(it.col()));
+
+  SpecificRandomInitialization sri(data.n_rows, 2, data.n_cols);
+  mat w0, h0;
+  sri.Initialize(data, 2, w0, h0);
+
+  for (size_t complete = 0; complete < 2; ++complete)
+  {
+    AMF<MaxIterationTermination, SpecificRandomInitialization,
+        SVDParallelIncrementalLearning> amf(MaxIterationTermination(100), sri,
+        SVDParallelIncrementalLearning(0.05, 0, 0, complete == 1));
+    mat w1, h1;
+    amf.Apply(data, 2, w1, h1);
+
+    BOOST_REQUIRE_EQUAL(amf.Update().Strata(), 4);
+
+    double initialError = 0.0;
+    double error = 0.0;
+    for (sp_mat::const_iterator it = data.begin(); it != data.end(); ++it)
+    {
+      initialError += std::pow(*it - dot(w0.row(it.row()),
+          h0.col(it.col())), 2.0);
+      error += std::pow(*it - dot(w1.row(it.row()), h1.col(it.col())), 2.0);
+    }
+
+    BOOST_REQUIRE_LT(error, 0.1 * initialError);
+  }
+
+  SetNumThreads(numThreads);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
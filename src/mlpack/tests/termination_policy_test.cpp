@@ -12,6 +12,8 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/amf/amf.hpp>
 #include <mlpack/methods/amf/termination_policies/max_iteration_termination.hpp>
+#include <mlpack/methods/amf/termination_policies/simple_residue_termination.hpp>
+#include <mlpack/methods/amf/termination_policies/validation_rmse_termination.hpp>
 #include <mlpack/methods/amf/update_rules/nmf_mult_div.hpp>
 
 #include <boost/test/unit_test.hpp>
@@ -63,4 +65,90 @@ BOOST_AUTO_TEST_CASE(AMFMaxIterationTerminationTest)
   BOOST_REQUIRE_EQUAL(nmf.TerminationPolicy().Iteration(), 10);
 }
 
+/**
+ * Make sure that the residue of SimpleResidueTermination is the change of the
+ * sum of the column norms of WH.
+ */
+BOOST_AUTO_TEST_CASE(SimpleResidueTerminationNormTest)
+{
+  mat v = randu<mat>(30, 25);
+  mat w = randu<mat>(30, 4);
+  mat h = randu<mat>(4, 25);
+
+  SimpleResidueTermination srt(1e-10, 100);
+  srt.Initialize(v);
+  srt.IsConverged(w, h);
+
+  // Compute the norm the expensive way.
+  const mat wh = w * h;
+  double norm = 0.0;
+  for (size_t j = 0; j < wh.n_cols; ++j)
+    norm += arma::norm(wh.col(j));
+  BOOST_REQUIRE_CLOSE(srt.normOld, norm, 1e-8);
+
+  // Now change W and check the residue.
+  mat w2 = 2 * w;
+  srt.IsConverged(w2, h);
+  BOOST_REQUIRE_CLOSE(srt.Index(), 1.0, 1e-8);
+}
+
+/**
+ * Make sure that SimpleResidueTermination only computes the residue every
+ * checkInterval iterations, but still stops at the maximum iteration.
+ */
+BOOST_AUTO_TEST_CASE(SimpleResidueTerminationCheckIntervalTest)
+{
+  mat v = randu<mat>(20, 20);
+  mat w = randu<mat>(20, 3);
+  mat h = randu<mat>(3, 20);
+
+  // The factorization doesn't change, so the residue is 0 at the second check.
+  SimpleResidueTermination srt(1e-5, 100, 5);
+  BOOST_REQUIRE_EQUAL(srt.CheckInterval(), 5);
+  srt.Initialize(v);
+  for (size_t i = 0; i < 9; ++i)
+    BOOST_REQUIRE_EQUAL(srt.IsConverged(w, h), false);
+  BOOST_REQUIRE_EQUAL(srt.IsConverged(w, h), true);
+  BOOST_REQUIRE_EQUAL(srt.Iteration(), 10);
+
+  // The iteration limit is reached between checks.
+  SimpleResidueTermination srt2(1e-5, 7, 5);
+  srt2.Initialize(v);
+  for (size_t i = 0; i < 6; ++i)
+    BOOST_REQUIRE_EQUAL(srt2.IsConverged(w, h), false);
+  BOOST_REQUIRE_EQUAL(srt2.IsConverged(w, h), true);
+}
+
+/**
+ * Make sure that the RMSE of ValidationRMSETermination is computed correctly
+ * from the validation entries.
+ */
+BOOST_AUTO_TEST_CASE(ValidationRMSETerminationRMSETest)
+{
+  mat v = randu<mat>(20, 20) + 0.1;
+  const mat original = v;
+  mat w = randu<mat>(20, 3);
+  mat h = randu<mat>(3, 20);
+
+  ValidationRMSETermination<mat> vrt(v, 15);
+  vrt.Initialize(v);
+  vrt.IsConverged(w, h);
+
+  // Every zeroed entry is a validation entry, and they are all different.
+  const mat wh = w * h;
+  double sum = 0.0;
+  size_t count = 0;
+  for (size_t i = 0; i < v.n_elem; ++i)
+  {
+    if (v[i] == 0)
+    {
+      sum += std::pow(original[i] - wh[i], 2.0);
+      ++count;
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(count, vrt.NumTestPoints());
+  BOOST_REQUIRE_CLOSE(vrt.Index(), std::sqrt(sum / count), 1e-8);
+}
+
 BOOST_AUTO_TEST_SUITE_END();
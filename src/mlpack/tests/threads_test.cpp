@@ -0,0 +1,137 @@
+/**
+ * @file threads_test.cpp
+ *
+ * Tests for the functions that control the number of threads used by mlpack.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/numa.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+
+using namespace mlpack;
+
+BOOST_AUTO_TEST_SUITE(ThreadsTest);
+
+/**
+ * Make sure that SetNumThreads() controls the number of threads of parallel
+ * regions, and that nested regions don't start more threads.
+ */
+BOOST_AUTO_TEST_CASE(SetNumThreadsTest)
+{
+  const size_t prevNumThreads = NumThreads();
+
+  BOOST_REQUIRE(!InParallel());
+
+#ifdef HAS_OPENMP
+  SetNumThreads(3);
+  BOOST_REQUIRE_EQUAL(NumThreads(), 3);
+
+  size_t outerThreads = 0;
+  size_t innerThreads = 0;
+  #pragma omp parallel
+  {
+    #pragma omp single
+    {
+      outerThreads = omp_get_num_threads();
+      BOOST_REQUIRE(InParallel());
+
+      #pragma omp parallel
+      {
+        #pragma omp single
+        innerThreads = omp_get_num_threads();
+      }
+    }
+  }
+
+  BOOST_REQUIRE_LE(outerThreads, 3);
+  BOOST_REQUIRE_EQUAL(innerThreads, 1);
+
+  SetNumThreads(0);
+  BOOST_REQUIRE_EQUAL(NumThreads(), (size_t) omp_get_num_procs());
+#else
+  SetNumThreads(3);
+  BOOST_REQUIRE_EQUAL(NumThreads(), 1);
+#endif
+
+  SetNumThreads(prevNumThreads);
+}
+
+/**
+ * Make sure that PlaceMatrix() keeps the contents of the matrix with every
+ * policy, and leaves matrices that don't own their memory alone.
+ */
+BOOST_AUTO_TEST_CASE(PlaceMatrixTest)
+{
+  const arma::mat data = arma::randu<arma::mat>(7, 3000);
+  const MemoryPlacement placements[] = { MemoryPlacement::DEFAULT,
+      MemoryPlacement::FIRST_TOUCH, MemoryPlacement::INTERLEAVE };
+
+  const size_t prevThreshold = HugePageThreshold();
+  for (size_t t = 0; t < 2; ++t)
+  {
+    // The second time around, back the copies with huge pages.
+    SetHugePageThreshold(t);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+      arma::mat placed(data);
+      PlaceMatrix(placed, placements[i]);
+
+      BOOST_REQUIRE_EQUAL(placed.n_rows, data.n_rows);
+      BOOST_REQUIRE_EQUAL(placed.n_cols, data.n_cols);
+      BOOST_REQUIRE_EQUAL(arma::accu(placed != data), 0);
+
+      // A single large column, and a matrix smaller than a page.
+      arma::vec column = arma::vectorise(data);
+      PlaceMatrix(column, placements[i]);
+      BOOST_REQUIRE_EQUAL(arma::accu(column != arma::vectorise(data)), 0);
+
+      arma::mat small = data.cols(0, 1);
+      PlaceMatrix(small, placements[i]);
+      BOOST_REQUIRE_EQUAL(arma::accu(small != data.cols(0, 1)), 0);
+    }
+  }
+  SetHugePageThreshold(prevThreshold);
+
+  // An alias must keep pointing at the memory it was given.
+  arma::mat memory(data);
+  arma::mat alias(memory.memptr(), memory.n_rows, memory.n_cols, false, true);
+  PlaceMatrix(alias, MemoryPlacement::INTERLEAVE);
+  BOOST_REQUIRE_EQUAL(alias.memptr(), memory.memptr());
+}
+
+/**
+ * Make sure that the threads can be pinned and unpinned, and that parallel
+ * regions still work afterwards.
+ */
+BOOST_AUTO_TEST_CASE(SetThreadAffinityTest)
+{
+  const bool compact = SetThreadAffinity(ThreadAffinity::COMPACT);
+  const bool spread = SetThreadAffinity(ThreadAffinity::SPREAD);
+  const bool none = SetThreadAffinity(ThreadAffinity::NONE);
+
+#ifdef __linux__
+  BOOST_REQUIRE(compact);
+  BOOST_REQUIRE(spread);
+  BOOST_REQUIRE(none);
+#else
+  BOOST_REQUIRE(!compact);
+  BOOST_REQUIRE(!spread);
+  BOOST_REQUIRE(!none);
+#endif
+
+  size_t sum = 0;
+  #pragma omp parallel for reduction(+:sum)
+  for (omp_size_t i = 0; i < 1000; ++i)
+    sum += (size_t) i;
+
+  BOOST_REQUIRE_EQUAL(sum, 499500);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
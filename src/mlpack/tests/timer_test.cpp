@@ -147,4 +147,150 @@ BOOST_AUTO_TEST_CASE(DisabledTimingTest)
   BOOST_REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
 
+//! Find the statistics of the scoped timers with the given path.
+static const TimerStatistics* FindStatistics(
+    const std::vector<TimerStatistics>& statistics,
+    const std::string& path)
+{
+  for (size_t i = 0; i < statistics.size(); ++i)
+    if (statistics[i].path == path)
+      return &statistics[i];
+  return NULL;
+}
+
+/**
+ * Make sure nested scoped timers are aggregated by path.
+ */
+BOOST_AUTO_TEST_CASE(NestedScopedTimerTest)
+{
+  Timer::EnableTiming();
+  Timer::ResetAll();
+
+  const TimerHandle outer("scoped_outer");
+  const TimerHandle inner("scoped_inner");
+  {
+    ScopedTimer outerTimer(outer);
+    for (size_t i = 0; i < 3; ++i)
+    {
+      ScopedTimer innerTimer(inner);
+      #ifdef _WIN32
+      Sleep(2);
+      #else
+      usleep(2000);
+      #endif
+    }
+  }
+  {
+    // This one is not nested.
+    ScopedTimer innerTimer(inner);
+  }
+  Timer::DisableTiming();
+
+  const std::vector<TimerStatistics> statistics = Timer::Statistics();
+  BOOST_REQUIRE_EQUAL(statistics.size(), 3);
+
+  const TimerStatistics* o = FindStatistics(statistics, "scoped_outer");
+  const TimerStatistics* n = FindStatistics(statistics,
+      "scoped_outer/scoped_inner");
+  const TimerStatistics* i = FindStatistics(statistics, "scoped_inner");
+  BOOST_REQUIRE(o != NULL);
+  BOOST_REQUIRE(n != NULL);
+  BOOST_REQUIRE(i != NULL);
+
+  BOOST_REQUIRE_EQUAL(o->count, 1);
+  BOOST_REQUIRE_EQUAL(n->count, 3);
+  BOOST_REQUIRE_EQUAL(i->count, 1);
+  BOOST_REQUIRE_EQUAL(n->threads, 1);
+  BOOST_REQUIRE(n->min >= std::chrono::milliseconds(2));
+  BOOST_REQUIRE(n->min <= n->max);
+  BOOST_REQUIRE(n->total >= 3 * n->min);
+  BOOST_REQUIRE(o->total >= n->total);
+
+  Timer::ResetAll();
+  BOOST_REQUIRE(Timer::Statistics().empty());
+}
+
+/**
+ * Make sure the scoped timers of several threads are aggregated, also after
+ * the threads exit.
+ */
+BOOST_AUTO_TEST_CASE(MultithreadScopedTimerTest)
+{
+  Timer::EnableTiming();
+  Timer::ResetAll();
+
+  const TimerHandle handle("scoped_thread_timer");
+  std::thread threads[3];
+  for (size_t i = 0; i < 3; ++i)
+  {
+    threads[i] = std::thread([&handle]()
+        {
+          for (size_t j = 0; j < 2; ++j)
+          {
+            ScopedTimer timer(handle);
+            #ifdef _WIN32
+            Sleep(2);
+            #else
+            usleep(2000);
+            #endif
+          }
+        });
+  }
+
+  for (size_t i = 0; i < 3; ++i)
+    threads[i].join();
+  Timer::DisableTiming();
+
+  const std::vector<TimerStatistics> statistics = Timer::Statistics();
+  const TimerStatistics* s = FindStatistics(statistics,
+      "scoped_thread_timer");
+  BOOST_REQUIRE(s != NULL);
+  BOOST_REQUIRE_EQUAL(s->count, 6);
+  BOOST_REQUIRE_EQUAL(s->threads, 3);
+  BOOST_REQUIRE(s->total >= std::chrono::milliseconds(12));
+
+  Timer::ResetAll();
+}
+
+/**
+ * Make sure the JSON output contains the named and the scoped timers.
+ */
+BOOST_AUTO_TEST_CASE(TimerJSONTest)
+{
+  Timer::EnableTiming();
+  Timer::ResetAll();
+
+  Timer::Start("json_timer");
+  {
+    ScopedTimer timer(TimerHandle("json_scoped_timer"));
+  }
+  Timer::Stop("json_timer");
+  Timer::DisableTiming();
+
+  std::ostringstream stream;
+  Timer::WriteJSON(stream);
+  const std::string json = stream.str();
+  BOOST_REQUIRE(json.find("\"json_timer\": ") != std::string::npos);
+  BOOST_REQUIRE(json.find("\"path\": \"json_scoped_timer\"") !=
+      std::string::npos);
+  BOOST_REQUIRE(json.find("\"count\": 1") != std::string::npos);
+
+  Timer::ResetAll();
+}
+
+/**
+ * Make sure scoped timers record nothing when timing is disabled.
+ */
+BOOST_AUTO_TEST_CASE(DisabledScopedTimerTest)
+{
+  Timer::DisableTiming();
+  Timer::ResetAll();
+
+  {
+    ScopedTimer timer(TimerHandle("disabled_scoped_timer"));
+  }
+
+  BOOST_REQUIRE(Timer::Statistics().empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END();
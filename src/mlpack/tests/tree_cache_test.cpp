@@ -0,0 +1,156 @@
+/**
+ * @file tree_cache_test.cpp
+ *
+ * Tests for the process-wide cache of tree structures (TreeCache).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/core/tree/tree_cache.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/range_search/range_search.hpp>
+#include <mlpack/methods/kde/kde.hpp>
+#include <mlpack/methods/dbscan/dbscan.hpp>
+#include <mlpack/methods/emst/dtb.hpp>
+#include <boost/test/unit_test.hpp>
+#include "test_tools.hpp"
+#include "serialization.hpp"
+
+using namespace mlpack;
+using namespace mlpack::tree;
+using namespace mlpack::neighbor;
+using namespace mlpack::range;
+using namespace mlpack::kde;
+using namespace mlpack::dbscan;
+using namespace mlpack::emst;
+
+BOOST_AUTO_TEST_SUITE(TreeCacheTest);
+
+/**
+ * Run KNN, range search, KDE, DBSCAN and EMST on the given dataset, and store
+ * their results.
+ */
+void RunAlgorithms(const arma::mat& dataset,
+                   arma::Mat<size_t>& neighbors,
+                   std::vector<std::vector<size_t>>& rangeNeighbors,
+                   arma::vec& estimations,
+                   arma::Row<size_t>& assignments,
+                   arma::mat& mst)
+{
+  arma::mat distances;
+  KNN knn(dataset);
+  knn.Search(5, neighbors, distances);
+
+  std::vector<std::vector<double>> rangeDistances;
+  RangeSearch<> rangeSearch(dataset);
+  rangeSearch.Search(math::Range(0.0, 0.1), rangeNeighbors, rangeDistances);
+
+  KDE<> kde(0.0, 0.0 /* exact */);
+  kde.Train(dataset);
+  kde.Evaluate(estimations);
+
+  DBSCAN<> dbscan(0.1, 3);
+  dbscan.Cluster(dataset, assignments);
+
+  DualTreeBoruvka<> dtb(dataset);
+  dtb.ComputeMST(mst);
+}
+
+/**
+ * Make sure that the algorithms give the same results with and without the
+ * cache, and that with the cache the tree is only built once.
+ */
+BOOST_AUTO_TEST_CASE(TreeCacheAlgorithmsTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+
+  arma::Mat<size_t> neighbors, cachedNeighbors;
+  std::vector<std::vector<size_t>> rangeNeighbors, cachedRangeNeighbors;
+  arma::vec estimations, cachedEstimations;
+  arma::Row<size_t> assignments, cachedAssignments;
+  arma::mat mst, cachedMst;
+
+  RunAlgorithms(dataset, neighbors, rangeNeighbors, estimations, assignments,
+      mst);
+
+  TreeCache::Enable();
+  TreeCache::Clear();
+  RunAlgorithms(dataset, cachedNeighbors, cachedRangeNeighbors,
+      cachedEstimations, cachedAssignments, cachedMst);
+
+  // All the trees have the same structure (a kd-tree) on the same dataset.
+  BOOST_REQUIRE_EQUAL(TreeCache::NumTrees(), 1);
+  BOOST_REQUIRE_EQUAL(TreeCache::Misses(), 1);
+  BOOST_REQUIRE_GE(TreeCache::Hits(), 4);
+
+  TreeCache::Disable();
+  BOOST_REQUIRE_EQUAL(TreeCache::NumTrees(), 0);
+
+  CheckMatrices(neighbors, cachedNeighbors);
+  CheckMatrices(estimations, cachedEstimations);
+  CheckMatrices(mst, cachedMst);
+  BOOST_REQUIRE_EQUAL(rangeNeighbors.size(), cachedRangeNeighbors.size());
+  for (size_t i = 0; i < rangeNeighbors.size(); ++i)
+  {
+    std::sort(rangeNeighbors[i].begin(), rangeNeighbors[i].end());
+    std::sort(cachedRangeNeighbors[i].begin(), cachedRangeNeighbors[i].end());
+    BOOST_REQUIRE(rangeNeighbors[i] == cachedRangeNeighbors[i]);
+  }
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+    BOOST_REQUIRE_EQUAL(assignments[i], cachedAssignments[i]);
+}
+
+/**
+ * Make sure that datasets that are modified or have other dimensions don't get
+ * a cached tree, and that the least recently used tree is evicted.
+ */
+BOOST_AUTO_TEST_CASE(TreeCacheDatasetTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 500);
+  arma::mat otherDataset = arma::randu<arma::mat>(3, 500);
+
+  TreeCache::Enable(2);
+  TreeCache::Clear();
+
+  KNN knn(dataset);
+  RangeSearch<> rangeSearch(dataset);
+  BOOST_REQUIRE_EQUAL(TreeCache::Misses(), 1);
+  BOOST_REQUIRE_EQUAL(TreeCache::Hits(), 1);
+
+  // Changing one point changes the tree.
+  dataset(1, 200) += 0.5;
+  KNN modifiedKNN(dataset);
+  BOOST_REQUIRE_EQUAL(TreeCache::Misses(), 2);
+  BOOST_REQUIRE_EQUAL(TreeCache::NumTrees(), 2);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  modifiedKNN.Search(3, neighbors, distances);
+  KNN naive(dataset, NAIVE_MODE);
+  naive.Search(3, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // The first tree is the least recently used one, so it is evicted.
+  KNN otherKNN(otherDataset);
+  BOOST_REQUIRE_EQUAL(TreeCache::Misses(), 3);
+  BOOST_REQUIRE_EQUAL(TreeCache::NumTrees(), 2);
+
+  // Trees of another structure aren't shared with kd-trees.
+  NeighborSearch<NearestNeighborSort, metric::EuclideanDistance, arma::mat,
+      BallTree> ballKNN(otherDataset);
+  BOOST_REQUIRE_EQUAL(TreeCache::Misses(), 4);
+
+  TreeCache::Disable();
+  BOOST_REQUIRE(!TreeCache::Enabled());
+
+  // With the cache disabled, nothing is counted.
+  KNN uncachedKNN(otherDataset);
+  BOOST_REQUIRE_EQUAL(TreeCache::Misses(), 4);
+  TreeCache::Clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END();
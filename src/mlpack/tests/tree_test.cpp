@@ -15,6 +15,7 @@
 #include <mlpack/core/metrics/mahalanobis_distance.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
+#include <mlpack/core/tree/space_filling_curves.hpp>
 
 #include <queue>
 #include <stack>
@@ -1042,6 +1043,56 @@ BOOST_AUTO_TEST_CASE(HRectBoundDiameter)
   BOOST_REQUIRE_SMALL(d.Diameter(), 1e-5);
 }
 
+/**
+ * Two- and three-dimensional bounds use separate implementations of the
+ * distance calculations with a fixed number of dimensions.  Make sure that they
+ * give the same results as a higher-dimensional bound which has the same
+ * extent in the first dimensions and is flat in the others.
+ */
+BOOST_AUTO_TEST_CASE(HRectBoundFixedDimensionTest)
+{
+  for (size_t dim = 2; dim <= 3; ++dim)
+  {
+    for (size_t trial = 0; trial < 10; ++trial)
+    {
+      HRectBound<EuclideanDistance> a(dim), b(dim);
+      HRectBound<EuclideanDistance> paddedA(dim + 2), paddedB(dim + 2);
+      arma::vec point(dim, arma::fill::randn);
+      arma::vec paddedPoint(dim + 2, arma::fill::zeros);
+      paddedPoint.subvec(0, dim - 1) = point;
+
+      for (size_t j = 0; j < dim; ++j)
+      {
+        const double loA = math::Random(-1.0, 1.0);
+        const double loB = math::Random(-1.0, 1.0);
+        a[j] = paddedA[j] = Range(loA, loA + math::Random());
+        b[j] = paddedB[j] = Range(loB, loB + math::Random());
+      }
+      for (size_t j = dim; j < dim + 2; ++j)
+        paddedA[j] = paddedB[j] = Range(0.0, 0.0);
+
+      BOOST_REQUIRE_CLOSE(a.MinDistance(b) + 1.0,
+          paddedA.MinDistance(paddedB) + 1.0, 1e-5);
+      BOOST_REQUIRE_CLOSE(a.MaxDistance(b), paddedA.MaxDistance(paddedB),
+          1e-5);
+      BOOST_REQUIRE_CLOSE(a.MinDistance(point) + 1.0,
+          paddedA.MinDistance(paddedPoint) + 1.0, 1e-5);
+      BOOST_REQUIRE_CLOSE(a.MaxDistance(point),
+          paddedA.MaxDistance(paddedPoint), 1e-5);
+
+      const Range r = a.RangeDistance(b);
+      const Range paddedR = paddedA.RangeDistance(paddedB);
+      BOOST_REQUIRE_CLOSE(r.Lo() + 1.0, paddedR.Lo() + 1.0, 1e-5);
+      BOOST_REQUIRE_CLOSE(r.Hi(), paddedR.Hi(), 1e-5);
+
+      const Range pr = a.RangeDistance(point);
+      const Range paddedPR = paddedA.RangeDistance(paddedPoint);
+      BOOST_REQUIRE_CLOSE(pr.Lo() + 1.0, paddedPR.Lo() + 1.0, 1e-5);
+      BOOST_REQUIRE_CLOSE(pr.Hi(), paddedPR.Hi(), 1e-5);
+    }
+  }
+}
+
 /**
  * It seems as though Bill has stumbled across a bug where
  * BinarySpaceTree<>::count() returns something different than
@@ -1951,6 +2002,51 @@ BOOST_AUTO_TEST_CASE(CoverTreeConstructionTest)
   // implementation.
 }
 
+/**
+ * Check that two cover trees have the same structure.
+ */
+template<typename TreeType>
+void CheckSameCoverTree(TreeType& a, TreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Point(), b.Point());
+  BOOST_REQUIRE_EQUAL(a.Scale(), b.Scale());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_EQUAL(a.NumDescendants(), b.NumDescendants());
+  BOOST_REQUIRE_CLOSE(a.FurthestDescendantDistance(),
+      b.FurthestDescendantDistance(), 1e-5);
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameCoverTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Create a cover tree large enough that its distances are computed by several
+ * threads, and make sure it's the same as when it is built on one thread.
+ */
+BOOST_AUTO_TEST_CASE(CoverTreeParallelConstructionTest)
+{
+  arma::mat dataset;
+  dataset.randu(5, 20000);
+
+  typedef StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>
+      TreeType;
+  TreeType tree(dataset);
+
+  const size_t numThreads = NumThreads();
+  SetNumThreads(1);
+  TreeType serialTree(dataset);
+  SetNumThreads(numThreads);
+
+  BOOST_REQUIRE_EQUAL(tree.DistanceComps(), serialTree.DistanceComps());
+  CheckSameCoverTree(tree, serialTree);
+
+  arma::vec counts;
+  counts.zeros(20000);
+  RecurseTreeCountLeaves(tree, counts);
+  for (size_t i = 0; i < 20000; ++i)
+    BOOST_REQUIRE_EQUAL(counts[i], 1);
+}
+
 /**
  * Create a cover tree on sparse data and make sure it's accurate.
  */
@@ -2277,4 +2373,310 @@ BOOST_AUTO_TEST_CASE(CoverTreeDescendantTest)
   CheckDescendants(&tree);
 }
 
+//! Check that two binary space trees have the same structure.
+template<typename TreeType, typename OtherTreeType>
+void CheckSameStructure(const TreeType& a, const OtherTreeType& b)
+{
+  BOOST_REQUIRE_EQUAL(a.Begin(), b.Begin());
+  BOOST_REQUIRE_EQUAL(a.Count(), b.Count());
+  BOOST_REQUIRE_EQUAL(a.NumChildren(), b.NumChildren());
+  BOOST_REQUIRE_CLOSE(a.ParentDistance() + 1.0, b.ParentDistance() + 1.0,
+      1e-5);
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+  {
+    BOOST_REQUIRE_EQUAL(a.Child(i).Parent(), &a);
+    BOOST_REQUIRE_EQUAL(b.Child(i).Parent(), &b);
+    CheckSameStructure(a.Child(i), b.Child(i));
+  }
+}
+
+/**
+ * Make sure that the nodes of a kd-tree are allocated next to each other in
+ * the order they are built, and that the tree can be copied and destroyed.
+ */
+BOOST_AUTO_TEST_CASE(KDTreeNodeBlockTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType* tree = new TreeType(dataset, 10);
+
+  // Each left child is built right after its parent.
+  BOOST_REQUIRE(!tree->IsLeaf());
+  const TreeType* node = tree->Left();
+  while (!node->IsLeaf())
+  {
+    BOOST_REQUIRE_EQUAL(node->Left(), node + 1);
+    node = node->Left();
+  }
+
+  // A copy allocates its nodes individually.
+  TreeType* copy = new TreeType(*tree);
+  CheckSameStructure(*tree, *copy);
+
+  delete tree;
+  BOOST_REQUIRE(!copy->IsCompact());
+  delete copy;
+}
+
+/**
+ * Make sure that compacting a kd-tree keeps its structure and places the nodes
+ * contiguously in depth-first order.
+ */
+BOOST_AUTO_TEST_CASE(CompactKDTreeTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  TreeType tree(dataset, 10);
+  TreeType copy(tree);
+
+  tree.Compact();
+  BOOST_REQUIRE(tree.IsCompact());
+  BOOST_REQUIRE(!copy.IsCompact());
+  CheckSameStructure(tree, copy);
+
+  // The first child of each node directly follows it.
+  BOOST_REQUIRE(!tree.IsLeaf());
+  const TreeType* node = tree.Left();
+  while (!node->IsLeaf())
+  {
+    BOOST_REQUIRE_EQUAL(node->Left(), node + 1);
+    node = node->Left();
+  }
+
+  // Compacting twice and moving the tree should still work.
+  tree.Compact();
+  TreeType moved(std::move(tree));
+  BOOST_REQUIRE(moved.IsCompact());
+  BOOST_REQUIRE(!tree.IsCompact());
+  CheckSameStructure(moved, copy);
+}
+
+/**
+ * A statistic that holds the number of descendants of its node, computed from
+ * the statistics of the children, to check that they are built first.
+ */
+class DescendantCountStat
+{
+ public:
+  DescendantCountStat() : count(0) { }
+
+  template<typename TreeType>
+  DescendantCountStat(TreeType& node) : count(0)
+  {
+    if (node.IsLeaf())
+      count = node.NumPoints();
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+      count += node.Child(i).Stat().Count();
+
+    // The dataset must be set when the statistic is built.
+    for (size_t i = 0; i < node.NumPoints(); ++i)
+      BOOST_REQUIRE_LT(node.Point(i), node.Dataset().n_cols);
+  }
+
+  size_t Count() const { return count; }
+
+ private:
+  size_t count;
+};
+
+/**
+ * Make sure that a kd-tree built from a tree with another statistic has the
+ * same structure, its own statistics and its own copy of the dataset.
+ */
+BOOST_AUTO_TEST_CASE(RebindKDTreeStatisticTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  typedef KDTree<EuclideanDistance, DescendantCountStat, arma::mat>
+      CountTreeType;
+
+  std::vector<size_t> oldFromNew;
+  TreeType* tree = new TreeType(dataset, oldFromNew, 10);
+  CountTreeType countTree(*tree);
+
+  CheckSameStructure(*tree, countTree);
+  BOOST_REQUIRE_NE(&tree->Dataset(), &countTree.Dataset());
+  CheckMatrices(tree->Dataset(), countTree.Dataset());
+
+  // The new tree must not depend on the original tree.
+  delete tree;
+
+  BOOST_REQUIRE_EQUAL(countTree.Stat().Count(), 1000);
+  std::stack<const CountTreeType*> nodes;
+  nodes.push(&countTree);
+  while (!nodes.empty())
+  {
+    const CountTreeType* node = nodes.top();
+    nodes.pop();
+
+    BOOST_REQUIRE_EQUAL(&node->Dataset(), &countTree.Dataset());
+    BOOST_REQUIRE_EQUAL(node->Stat().Count(), node->NumDescendants());
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      nodes.push(&node->Child(i));
+  }
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(arma::accu(countTree.Dataset().col(i) ==
+        dataset.col(oldFromNew[i])), 3);
+  }
+}
+
+#ifdef HAS_OPENMP
+
+/**
+ * Make sure that a kd-tree built with multiple threads is identical to one
+ * built with a single thread, including the oldFromNew mapping.
+ */
+BOOST_AUTO_TEST_CASE(ParallelKDTreeConstructionTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 50000);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+
+  const size_t prevNumThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+
+  std::vector<size_t> sequentialOldFromNew;
+  TreeType sequentialTree(dataset, sequentialOldFromNew);
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+
+  std::vector<size_t> parallelOldFromNew;
+  TreeType parallelTree(dataset, parallelOldFromNew);
+
+  omp_set_num_threads(prevNumThreads);
+
+  BOOST_REQUIRE_EQUAL(sequentialOldFromNew.size(), parallelOldFromNew.size());
+  for (size_t i = 0; i < sequentialOldFromNew.size(); ++i)
+    BOOST_REQUIRE_EQUAL(sequentialOldFromNew[i], parallelOldFromNew[i]);
+
+  CheckMatrices(sequentialTree.Dataset(), parallelTree.Dataset());
+  CheckSameStructure(sequentialTree, parallelTree);
+}
+#endif
+
+//! Refit the bounds of every node of the tree, children first.
+template<typename TreeType>
+void RefitTree(TreeType& node)
+{
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    RefitTree(node.Child(i));
+  node.RefitBound();
+}
+
+/**
+ * Make sure that RefitBound() gives each node the tightest bound of its points
+ * after they have moved, along with the matching distances.
+ */
+BOOST_AUTO_TEST_CASE(RefitKDTreeBoundTest)
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 1000);
+  typedef KDTree<EuclideanDistance, EmptyStatistic, arma::mat> TreeType;
+  TreeType tree(dataset);
+
+  // Move the points, without changing their order in the tree.
+  tree.Dataset() += 0.1 * arma::randn<arma::mat>(3, 1000);
+  RefitTree(tree);
+
+  std::stack<TreeType*> stack;
+  stack.push(&tree);
+  while (!stack.empty())
+  {
+    TreeType* node = stack.top();
+    stack.pop();
+
+    HRectBound<EuclideanDistance> bound(3);
+    bound |= tree.Dataset().cols(node->Begin(),
+        node->Begin() + node->Count() - 1);
+    for (size_t d = 0; d < 3; ++d)
+    {
+      BOOST_REQUIRE_EQUAL(node->Bound()[d].Lo(), bound[d].Lo());
+      BOOST_REQUIRE_EQUAL(node->Bound()[d].Hi(), bound[d].Hi());
+    }
+    BOOST_REQUIRE_CLOSE(node->FurthestDescendantDistance(),
+        0.5 * bound.Diameter(), 1e-10);
+
+    if (node->NumChildren() > 0)
+    {
+      arma::vec center, childCenter;
+      node->Center(center);
+      for (size_t i = 0; i < node->NumChildren(); ++i)
+      {
+        node->Child(i).Center(childCenter);
+        BOOST_REQUIRE_CLOSE(node->Child(i).ParentDistance(),
+            arma::norm(center - childCenter), 1e-10);
+        stack.push(&node->Child(i));
+      }
+    }
+  }
+}
+
+/**
+ * Check that the reordered dataset holds the points of the original dataset in
+ * the order given by oldFromNew.
+ */
+void CheckReordering(const arma::mat& original,
+                     const arma::mat& reordered,
+                     const std::vector<size_t>& oldFromNew)
+{
+  BOOST_REQUIRE_EQUAL(reordered.n_cols, original.n_cols);
+  BOOST_REQUIRE_EQUAL(oldFromNew.size(), original.n_cols);
+
+  std::vector<size_t> sorted(oldFromNew);
+  std::sort(sorted.begin(), sorted.end());
+  for (size_t i = 0; i < sorted.size(); ++i)
+    BOOST_REQUIRE_EQUAL(sorted[i], i);
+
+  for (size_t i = 0; i < reordered.n_cols; ++i)
+    for (size_t d = 0; d < reordered.n_rows; ++d)
+      BOOST_REQUIRE_EQUAL(reordered(d, i), original(d, oldFromNew[i]));
+}
+
+/**
+ * Make sure MortonOrder() sorts the points by their addresses.
+ */
+BOOST_AUTO_TEST_CASE(MortonOrderTest)
+{
+  arma::mat original = arma::randn<arma::mat>(3, 1000);
+  arma::mat dataset(original);
+  std::vector<size_t> oldFromNew;
+  MortonOrder(dataset, oldFromNew);
+
+  CheckReordering(original, dataset, oldFromNew);
+
+  arma::Col<uint64_t> last(3), address(3);
+  bound::addr::PointToAddress(last, dataset.col(0));
+  for (size_t i = 1; i < dataset.n_cols; ++i)
+  {
+    bound::addr::PointToAddress(address, dataset.col(i));
+    BOOST_REQUIRE_LE(bound::addr::CompareAddresses(last, address), 0);
+    last = address;
+  }
+}
+
+/**
+ * Make sure HilbertOrder() sorts the points by their Hilbert values.
+ */
+BOOST_AUTO_TEST_CASE(HilbertOrderTest)
+{
+  arma::mat original = arma::randu<arma::mat>(4, 1000);
+  arma::mat dataset(original);
+  std::vector<size_t> oldFromNew;
+  HilbertOrder(dataset, oldFromNew);
+
+  CheckReordering(original, dataset, oldFromNew);
+
+  typedef DiscreteHilbertValue<double> HilbertValueType;
+  for (size_t i = 1; i < dataset.n_cols; ++i)
+  {
+    BOOST_REQUIRE_LE(HilbertValueType::CompareValues(
+        HilbertValueType::CalculateValue(dataset.col(i - 1)),
+        HilbertValueType::CalculateValue(dataset.col(i))), 0);
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -10,6 +10,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 
 #include <mlpack/core.hpp>
 #include <boost/test/unit_test.hpp>
@@ -51,4 +52,86 @@ BOOST_AUTO_TEST_CASE(TestUnion)
   BOOST_REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
 
+/**
+ * Make sure ConcurrentUnionFind joins components, and that the index of each
+ * component is its smallest element.
+ */
+BOOST_AUTO_TEST_CASE(TestConcurrentUnion)
+{
+  static const size_t testSize = 10;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  for (size_t i = 0; i < testSize; i++)
+    BOOST_REQUIRE(testUnionFind.Find(i) == i);
+
+  BOOST_REQUIRE(testUnionFind.Union(0, 1));
+  BOOST_REQUIRE(testUnionFind.Union(2, 3));
+  BOOST_REQUIRE(testUnionFind.Union(3, 0));
+  BOOST_REQUIRE(testUnionFind.Union(6, 5));
+  BOOST_REQUIRE(testUnionFind.Union(5, 1));
+  BOOST_REQUIRE(!testUnionFind.Union(1, 6));
+
+  BOOST_REQUIRE_EQUAL(testUnionFind.Find(0), (size_t) 0);
+  BOOST_REQUIRE_EQUAL(testUnionFind.Find(1), (size_t) 0);
+  BOOST_REQUIRE_EQUAL(testUnionFind.Find(2), (size_t) 0);
+  BOOST_REQUIRE_EQUAL(testUnionFind.Find(3), (size_t) 0);
+  BOOST_REQUIRE_EQUAL(testUnionFind.Find(5), (size_t) 0);
+  BOOST_REQUIRE_EQUAL(testUnionFind.Find(6), (size_t) 0);
+  BOOST_REQUIRE_EQUAL(testUnionFind.Find(4), (size_t) 4);
+  BOOST_REQUIRE_EQUAL(testUnionFind.Find(7), (size_t) 7);
+}
+
+#ifdef HAS_OPENMP
+/**
+ * Join random pairs of elements from several threads at once, and make sure
+ * the components are the same as with UnionFind.
+ */
+BOOST_AUTO_TEST_CASE(TestParallelConcurrentUnion)
+{
+  static const size_t testSize = 10000;
+  arma::Mat<size_t> pairs = arma::randi<arma::Mat<size_t>>(2, testSize / 2,
+      arma::distr_param(0, testSize - 1));
+
+  UnionFind serialUnionFind(testSize);
+  for (size_t i = 0; i < pairs.n_cols; ++i)
+    serialUnionFind.Union(pairs(0, i), pairs(1, i));
+
+  const size_t prevNumThreads = omp_get_max_threads();
+
+  // Force multiple threads, even if only one core is available.
+  omp_set_num_threads(4);
+
+  ConcurrentUnionFind testUnionFind(testSize);
+  size_t unions = 0;
+  #pragma omp parallel for reduction(+:unions)
+  for (omp_size_t i = 0; i < (omp_size_t) pairs.n_cols; ++i)
+  {
+    if (testUnionFind.Union(pairs(0, i), pairs(1, i)))
+      ++unions;
+  }
+
+  omp_set_num_threads(prevNumThreads);
+
+  // Each successful union joins two components.
+  size_t components = 0;
+  for (size_t i = 0; i < testSize; ++i)
+  {
+    if (testUnionFind.Find(i) == i)
+      ++components;
+  }
+  BOOST_REQUIRE_EQUAL(components, testSize - unions);
+
+  for (size_t i = 0; i < pairs.n_cols; ++i)
+    BOOST_REQUIRE_EQUAL(testUnionFind.Find(pairs(0, i)),
+        testUnionFind.Find(pairs(1, i)));
+
+  for (size_t i = 0; i + 1 < testSize; ++i)
+  {
+    BOOST_REQUIRE_EQUAL(testUnionFind.Find(i) == testUnionFind.Find(i + 1),
+        serialUnionFind.Find(i) == serialUnionFind.Find(i + 1));
+    BOOST_REQUIRE_LE(testUnionFind.Find(i), i);
+  }
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END();